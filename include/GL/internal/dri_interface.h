@@ -991,6 +991,33 @@ struct __DRIswrastExtensionRec {
 
 };
 
+/**
+ * Damage-region swaps for software rasterizers.
+ *
+ * Only the damaged rectangles of the back buffer are handed to the
+ * loader's putImage.  The back buffer keeps its contents across the swap,
+ * so a loader can report a buffer age of 1 afterwards, until the drawable
+ * is resized.
+ */
+#define __DRI_SWRAST_SWAP_DAMAGE "DRI_SWRastSwapDamage"
+#define __DRI_SWRAST_SWAP_DAMAGE_VERSION 1
+
+typedef struct __DRIswrastSwapDamageExtensionRec __DRIswrastSwapDamageExtension;
+struct __DRIswrastSwapDamageExtensionRec {
+   __DRIextension base;
+
+   /**
+    * Swap with a list of damaged rectangles.
+    *
+    * \param rects  \p nrects rectangles as x, y, width, height with the
+    *               origin in the lower left corner, as in
+    *               EGL_KHR_swap_buffers_with_damage.  With no rectangles,
+    *               the whole drawable is presented.
+    */
+   void (*swapBuffersWithDamage)(__DRIdrawable *drawable,
+                                 int nrects, const int *rects);
+};
+
 /** Common DRI function definitions, shared among DRI2 and Image extensions
  */
 
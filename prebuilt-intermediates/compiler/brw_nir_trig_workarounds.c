@@ -4,6 +4,7 @@
 #include "nir_builder.h"
 #include "nir_search.h"
 #include "nir_search_helpers.h"
+#include "util/u_dynarray.h"
 
 #ifndef NIR_OPT_ALGEBRAIC_STRUCT_DEFS
 #define NIR_OPT_ALGEBRAIC_STRUCT_DEFS
@@ -125,59 +126,74 @@ static const struct per_op_table brw_nir_apply_trig_workarounds_table[nir_num_se
 };
 
 static void
-brw_nir_apply_trig_workarounds_pre_block(nir_block *block, uint16_t *states)
+brw_nir_apply_trig_workarounds_compute_state(nir_instr *instr, uint16_t *states)
 {
-   nir_foreach_instr(instr, block) {
-      switch (instr->type) {
-      case nir_instr_type_alu: {
-         nir_alu_instr *alu = nir_instr_as_alu(instr);
-         nir_op op = alu->op;
-         uint16_t search_op = nir_search_op_for_nir_op(op);
-         const struct per_op_table *tbl = &brw_nir_apply_trig_workarounds_table[search_op];
-         if (tbl->num_filtered_states == 0)
-            continue;
-
-         /* Calculate the index into the transition table. Note the index
-          * calculated must match the iteration order of Python's
-          * itertools.product(), which was used to emit the transition
-          * table.
-          */
-         uint16_t index = 0;
-         for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
-            index *= tbl->num_filtered_states;
-            index += tbl->filter[states[alu->src[i].src.ssa->index]];
-         }
-         states[alu->dest.dest.ssa.index] = tbl->table[index];
-         break;
+   switch (instr->type) {
+   case nir_instr_type_alu: {
+      nir_alu_instr *alu = nir_instr_as_alu(instr);
+      nir_op op = alu->op;
+      uint16_t search_op = nir_search_op_for_nir_op(op);
+      const struct per_op_table *tbl = &brw_nir_apply_trig_workarounds_table[search_op];
+      if (tbl->num_filtered_states == 0)
+         return;
+
+      /* Calculate the index into the transition table. Note the index
+       * calculated must match the iteration order of Python's
+       * itertools.product(), which was used to emit the transition
+       * table.
+       */
+      uint16_t index = 0;
+      for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
+         index *= tbl->num_filtered_states;
+         index += tbl->filter[states[alu->src[i].src.ssa->index]];
       }
+      states[alu->dest.dest.ssa.index] = tbl->table[index];
+      break;
+   }
 
-      case nir_instr_type_load_const: {
-         nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
-         states[load_const->def.index] = CONST_STATE;
-         break;
-      }
+   case nir_instr_type_load_const: {
+      nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
+      states[load_const->def.index] = CONST_STATE;
+      break;
+   }
 
-      default:
-         break;
-      }
+   default:
+      break;
    }
 }
 
+static void
+brw_nir_apply_trig_workarounds_pre_block(nir_block *block, uint16_t *states)
+{
+   nir_foreach_instr(instr, block)
+      brw_nir_apply_trig_workarounds_compute_state(instr, states);
+}
+
 static bool
 brw_nir_apply_trig_workarounds_block(nir_builder *build, nir_block *block,
-                   const uint16_t *states, const bool *condition_flags)
+                   struct util_dynarray *states, const bool *condition_flags)
 {
    bool progress = false;
 
-   nir_foreach_instr_reverse_safe(instr, block) {
-      if (instr->type != nir_instr_type_alu)
+   nir_instr *instr = nir_block_last_instr(block);
+   while (instr) {
+      nir_instr *prev = nir_instr_prev(instr);
+      nir_instr *next = nir_instr_next(instr);
+
+      if (instr->type != nir_instr_type_alu) {
+         instr = prev;
          continue;
+      }
 
       nir_alu_instr *alu = nir_instr_as_alu(instr);
-      if (!alu->dest.dest.is_ssa)
+      if (!alu->dest.dest.is_ssa) {
+         instr = prev;
          continue;
+      }
 
-      switch (states[alu->dest.dest.ssa.index]) {
+      bool replaced = false;
+      const uint16_t *s = util_dynarray_begin(states);
+      switch (s[alu->dest.dest.ssa.index]) {
       case 0:
          break;
       case 1:
@@ -187,7 +203,7 @@ brw_nir_apply_trig_workarounds_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &brw_nir_apply_trig_workarounds_state2_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -197,13 +213,44 @@ brw_nir_apply_trig_workarounds_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &brw_nir_apply_trig_workarounds_state3_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
          break;
       default: assert(0);
       }
+
+      if (!replaced) {
+         instr = prev;
+         continue;
+      }
+
+      progress = true;
+
+      /* The replacement was inserted right where the old instruction used
+       * to be.  Give the new SSA values their automaton states and keep
+       * walking backwards from the last of them, so that the expressions
+       * we just built get matched in this same pass instead of waiting for
+       * the caller's next optimization loop iteration.
+       */
+      unsigned old_size = states->size / sizeof(uint16_t);
+      unsigned new_size = build->impl->ssa_alloc;
+      if (new_size > old_size) {
+         uint16_t *grown = util_dynarray_grow(states,
+                                              (new_size - old_size) *
+                                              sizeof(uint16_t));
+         memset(grown, 0, (new_size - old_size) * sizeof(uint16_t));
+      }
+
+      nir_instr *first = prev ? nir_instr_next(prev) :
+                                nir_block_first_instr(block);
+      nir_instr *last = prev;
+      for (nir_instr *n = first; n != next; n = nir_instr_next(n)) {
+         brw_nir_apply_trig_workarounds_compute_state(n, util_dynarray_begin(states));
+         last = n;
+      }
+      instr = last;
    }
 
    return progress;
@@ -217,21 +264,24 @@ brw_nir_apply_trig_workarounds_impl(nir_function_impl *impl, const bool *conditi
    nir_builder build;
    nir_builder_init(&build, impl);
 
-   /* Note: it's important here that we're allocating a zeroed array, since
-    * state 0 is the default state, which means we don't have to visit
+   /* Note: it's important here that we're starting from a zeroed array,
+    * since state 0 is the default state, which means we don't have to visit
     * anything other than constants and ALU instructions.
     */
-   uint16_t *states = calloc(impl->ssa_alloc, sizeof(*states));
+   struct util_dynarray states;
+   util_dynarray_init(&states, NULL);
+   memset(util_dynarray_resize(&states, impl->ssa_alloc * sizeof(uint16_t)),
+          0, impl->ssa_alloc * sizeof(uint16_t));
 
    nir_foreach_block(block, impl) {
-      brw_nir_apply_trig_workarounds_pre_block(block, states);
+      brw_nir_apply_trig_workarounds_pre_block(block, util_dynarray_begin(&states));
    }
 
    nir_foreach_block_reverse(block, impl) {
-      progress |= brw_nir_apply_trig_workarounds_block(&build, block, states, condition_flags);
+      progress |= brw_nir_apply_trig_workarounds_block(&build, block, &states, condition_flags);
    }
 
-   free(states);
+   util_dynarray_fini(&states);
 
    if (progress) {
       nir_metadata_preserve(impl, nir_metadata_block_index |
@@ -3,6 +3,7 @@
 #include "nir_builder.h"
 #include "nir_search.h"
 #include "nir_search_helpers.h"
+#include "util/u_dynarray.h"
 
 #ifndef NIR_OPT_ALGEBRAIC_STRUCT_DEFS
 #define NIR_OPT_ALGEBRAIC_STRUCT_DEFS
@@ -153764,59 +153765,74 @@ static const struct per_op_table nir_opt_algebraic_table[nir_num_search_ops] = {
 };
 
 static void
-nir_opt_algebraic_pre_block(nir_block *block, uint16_t *states)
+nir_opt_algebraic_compute_state(nir_instr *instr, uint16_t *states)
 {
-   nir_foreach_instr(instr, block) {
-      switch (instr->type) {
-      case nir_instr_type_alu: {
-         nir_alu_instr *alu = nir_instr_as_alu(instr);
-         nir_op op = alu->op;
-         uint16_t search_op = nir_search_op_for_nir_op(op);
-         const struct per_op_table *tbl = &nir_opt_algebraic_table[search_op];
-         if (tbl->num_filtered_states == 0)
-            continue;
-
-         /* Calculate the index into the transition table. Note the index
-          * calculated must match the iteration order of Python's
-          * itertools.product(), which was used to emit the transition
-          * table.
-          */
-         uint16_t index = 0;
-         for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
-            index *= tbl->num_filtered_states;
-            index += tbl->filter[states[alu->src[i].src.ssa->index]];
-         }
-         states[alu->dest.dest.ssa.index] = tbl->table[index];
-         break;
+   switch (instr->type) {
+   case nir_instr_type_alu: {
+      nir_alu_instr *alu = nir_instr_as_alu(instr);
+      nir_op op = alu->op;
+      uint16_t search_op = nir_search_op_for_nir_op(op);
+      const struct per_op_table *tbl = &nir_opt_algebraic_table[search_op];
+      if (tbl->num_filtered_states == 0)
+         return;
+
+      /* Calculate the index into the transition table. Note the index
+       * calculated must match the iteration order of Python's
+       * itertools.product(), which was used to emit the transition
+       * table.
+       */
+      uint16_t index = 0;
+      for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
+         index *= tbl->num_filtered_states;
+         index += tbl->filter[states[alu->src[i].src.ssa->index]];
       }
+      states[alu->dest.dest.ssa.index] = tbl->table[index];
+      break;
+   }
 
-      case nir_instr_type_load_const: {
-         nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
-         states[load_const->def.index] = CONST_STATE;
-         break;
-      }
+   case nir_instr_type_load_const: {
+      nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
+      states[load_const->def.index] = CONST_STATE;
+      break;
+   }
 
-      default:
-         break;
-      }
+   default:
+      break;
    }
 }
 
+static void
+nir_opt_algebraic_pre_block(nir_block *block, uint16_t *states)
+{
+   nir_foreach_instr(instr, block)
+      nir_opt_algebraic_compute_state(instr, states);
+}
+
 static bool
 nir_opt_algebraic_block(nir_builder *build, nir_block *block,
-                   const uint16_t *states, const bool *condition_flags)
+                   struct util_dynarray *states, const bool *condition_flags)
 {
    bool progress = false;
 
-   nir_foreach_instr_reverse_safe(instr, block) {
-      if (instr->type != nir_instr_type_alu)
+   nir_instr *instr = nir_block_last_instr(block);
+   while (instr) {
+      nir_instr *prev = nir_instr_prev(instr);
+      nir_instr *next = nir_instr_next(instr);
+
+      if (instr->type != nir_instr_type_alu) {
+         instr = prev;
          continue;
+      }
 
       nir_alu_instr *alu = nir_instr_as_alu(instr);
-      if (!alu->dest.dest.is_ssa)
+      if (!alu->dest.dest.is_ssa) {
+         instr = prev;
          continue;
+      }
 
-      switch (states[alu->dest.dest.ssa.index]) {
+      bool replaced = false;
+      const uint16_t *s = util_dynarray_begin(states);
+      switch (s[alu->dest.dest.ssa.index]) {
       case 0:
          break;
       case 1:
@@ -153828,7 +153844,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state3_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153840,7 +153856,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state5_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153850,7 +153866,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state6_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153860,7 +153876,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state7_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153870,7 +153886,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state8_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153880,7 +153896,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state9_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153890,7 +153906,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state10_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153900,7 +153916,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state11_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153910,7 +153926,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state12_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153928,7 +153944,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state17_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153940,7 +153956,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state19_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153952,7 +153968,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state21_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153962,7 +153978,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state22_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153974,7 +153990,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state24_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153984,7 +154000,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state25_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -153994,7 +154010,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state26_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154004,7 +154020,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state27_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154014,7 +154030,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state28_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154024,7 +154040,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state29_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154034,7 +154050,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state30_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154044,7 +154060,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state31_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154054,7 +154070,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state32_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154064,7 +154080,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state33_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154074,7 +154090,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state34_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154084,7 +154100,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state35_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154094,7 +154110,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state36_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154104,7 +154120,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state37_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154114,7 +154130,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state38_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154124,7 +154140,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state39_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154134,7 +154150,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state40_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154144,7 +154160,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state41_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154154,7 +154170,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state42_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154166,7 +154182,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state44_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154176,7 +154192,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state45_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154186,7 +154202,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state46_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154196,7 +154212,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state47_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154206,7 +154222,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state48_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154216,7 +154232,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state49_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154238,7 +154254,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state56_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154248,7 +154264,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state57_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154258,7 +154274,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state58_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154292,7 +154308,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state71_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154302,7 +154318,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state72_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154312,7 +154328,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state73_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154322,7 +154338,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state74_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154332,7 +154348,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state75_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154342,7 +154358,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state76_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154352,7 +154368,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state77_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154362,7 +154378,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state78_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154372,7 +154388,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state79_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154382,7 +154398,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state80_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154392,7 +154408,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state81_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154402,7 +154418,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state82_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154412,7 +154428,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state83_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154422,7 +154438,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state84_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154432,7 +154448,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state85_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154442,7 +154458,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state86_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154452,7 +154468,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state87_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154462,7 +154478,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state88_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154472,7 +154488,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state89_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154482,7 +154498,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state90_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154492,7 +154508,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state91_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154502,7 +154518,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state92_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154514,7 +154530,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state94_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154524,7 +154540,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state95_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154534,7 +154550,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state96_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154544,7 +154560,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state97_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154554,7 +154570,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state98_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154564,7 +154580,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state99_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154574,7 +154590,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state100_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154584,7 +154600,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state101_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154594,7 +154610,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state102_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154604,7 +154620,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state103_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154614,7 +154630,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state104_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154624,7 +154640,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state105_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154636,7 +154652,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state107_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154646,7 +154662,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state108_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154656,7 +154672,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state109_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154666,7 +154682,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state110_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154676,7 +154692,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state111_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154686,7 +154702,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state112_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154696,7 +154712,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state113_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154706,7 +154722,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state114_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154716,7 +154732,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state115_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154726,7 +154742,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state116_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154736,7 +154752,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state117_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154746,7 +154762,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state118_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154756,7 +154772,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state119_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154766,7 +154782,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state120_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154776,7 +154792,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state121_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154786,7 +154802,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state122_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154800,7 +154816,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state125_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154810,7 +154826,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state126_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154820,7 +154836,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state127_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154830,7 +154846,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state128_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154840,7 +154856,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state129_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154854,7 +154870,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state132_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154864,7 +154880,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state133_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154874,7 +154890,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state134_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154890,7 +154906,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state138_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154900,7 +154916,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state139_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154910,7 +154926,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state140_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154920,7 +154936,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state141_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154930,7 +154946,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state142_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154940,7 +154956,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state143_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154950,7 +154966,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state144_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154960,7 +154976,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state145_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154972,7 +154988,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state147_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154982,7 +154998,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state148_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -154992,7 +155008,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state149_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155002,7 +155018,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state150_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155012,7 +155028,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state151_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155022,7 +155038,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state152_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155032,7 +155048,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state153_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155042,7 +155058,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state154_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155052,7 +155068,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state155_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155062,7 +155078,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state156_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155072,7 +155088,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state157_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155082,7 +155098,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state158_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155092,7 +155108,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state159_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155102,7 +155118,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state160_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155112,7 +155128,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state161_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155122,7 +155138,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state162_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155132,7 +155148,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state163_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155142,7 +155158,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state164_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155152,7 +155168,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state165_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155162,7 +155178,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state166_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155172,7 +155188,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state167_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155182,7 +155198,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state168_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155192,7 +155208,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state169_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155202,7 +155218,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state170_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155212,7 +155228,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state171_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155222,7 +155238,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state172_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155232,7 +155248,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state173_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155242,7 +155258,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state174_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155252,7 +155268,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state175_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155262,7 +155278,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state176_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155272,7 +155288,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state177_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155282,7 +155298,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state178_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155292,7 +155308,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state179_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155302,7 +155318,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state180_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155312,7 +155328,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state181_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155322,7 +155338,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state182_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155332,7 +155348,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state183_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155342,7 +155358,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state184_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155352,7 +155368,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state185_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155362,7 +155378,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state186_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155372,7 +155388,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state187_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155382,7 +155398,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state188_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155392,7 +155408,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state189_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155402,7 +155418,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state190_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155412,7 +155428,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state191_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155422,7 +155438,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state192_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155432,7 +155448,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state193_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155442,7 +155458,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state194_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155452,7 +155468,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state195_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155462,7 +155478,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state196_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155472,7 +155488,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state197_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155482,7 +155498,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state198_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155492,7 +155508,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state199_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155502,7 +155518,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state200_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155512,7 +155528,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state201_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155522,7 +155538,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state202_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155532,7 +155548,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state203_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155542,7 +155558,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state204_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155552,7 +155568,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state205_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155562,7 +155578,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state206_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155572,7 +155588,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state207_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155582,7 +155598,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state208_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155592,7 +155608,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state209_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155602,7 +155618,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state210_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155612,7 +155628,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state211_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155622,7 +155638,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state212_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155632,7 +155648,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state213_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155642,7 +155658,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state214_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155652,7 +155668,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state215_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155662,7 +155678,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state216_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155672,7 +155688,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state217_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155682,7 +155698,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state218_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155692,7 +155708,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state219_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155702,7 +155718,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state220_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155714,7 +155730,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state222_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155724,7 +155740,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state223_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155734,7 +155750,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state224_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155744,7 +155760,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state225_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155754,7 +155770,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state226_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155764,7 +155780,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state227_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155774,7 +155790,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state228_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155784,7 +155800,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state229_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155794,7 +155810,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state230_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155804,7 +155820,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state231_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155814,7 +155830,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state232_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155824,7 +155840,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state233_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155834,7 +155850,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state234_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155844,7 +155860,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state235_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155854,7 +155870,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state236_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155864,7 +155880,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state237_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155876,7 +155892,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state239_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155892,7 +155908,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state243_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155902,7 +155918,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state244_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155912,7 +155928,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state245_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155922,7 +155938,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state246_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155932,7 +155948,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state247_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155942,7 +155958,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state248_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155952,7 +155968,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state249_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155962,7 +155978,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state250_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155972,7 +155988,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state251_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155982,7 +155998,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state252_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -155992,7 +156008,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state253_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156006,7 +156022,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state256_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156018,7 +156034,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state258_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156028,7 +156044,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state259_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156038,7 +156054,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state260_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156048,7 +156064,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state261_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156058,7 +156074,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state262_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156068,7 +156084,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state263_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156078,7 +156094,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state264_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156088,7 +156104,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state265_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156098,7 +156114,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state266_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156108,7 +156124,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state267_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156118,7 +156134,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state268_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156128,7 +156144,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state269_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156138,7 +156154,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state270_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156148,7 +156164,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state271_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156158,7 +156174,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state272_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156168,7 +156184,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state273_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156178,7 +156194,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state274_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156188,7 +156204,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state275_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156198,7 +156214,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state276_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156208,7 +156224,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state277_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156218,7 +156234,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state278_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156228,7 +156244,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state279_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156238,7 +156254,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state280_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156248,7 +156264,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state281_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156258,7 +156274,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state282_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156268,7 +156284,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state283_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156278,7 +156294,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state284_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156288,7 +156304,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state285_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156298,7 +156314,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state286_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156308,7 +156324,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state287_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156318,7 +156334,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state288_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156328,7 +156344,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state289_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156338,7 +156354,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state290_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156348,7 +156364,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state291_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156358,7 +156374,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state292_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156368,7 +156384,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state293_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156378,7 +156394,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state294_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156388,7 +156404,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state295_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156398,7 +156414,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state296_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156408,7 +156424,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state297_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156418,7 +156434,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state298_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156428,7 +156444,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state299_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156438,7 +156454,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state300_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156448,7 +156464,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state301_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156458,7 +156474,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state302_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156468,7 +156484,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state303_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156478,7 +156494,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state304_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156488,7 +156504,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state305_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156498,7 +156514,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state306_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156508,7 +156524,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state307_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156518,7 +156534,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state308_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156528,7 +156544,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state309_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156538,7 +156554,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state310_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156548,7 +156564,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state311_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156558,7 +156574,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state312_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156568,7 +156584,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state313_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156578,7 +156594,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state314_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156588,7 +156604,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state315_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156598,7 +156614,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state316_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156608,7 +156624,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state317_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156618,7 +156634,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state318_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156628,7 +156644,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state319_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156638,7 +156654,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state320_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156648,7 +156664,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state321_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156658,7 +156674,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state322_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156668,7 +156684,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state323_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156678,7 +156694,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state324_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156688,7 +156704,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state325_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156698,7 +156714,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state326_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156708,7 +156724,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state327_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156718,7 +156734,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state328_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156728,7 +156744,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state329_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156738,7 +156754,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state330_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156748,7 +156764,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state331_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156758,7 +156774,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state332_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156768,7 +156784,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state333_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156778,7 +156794,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state334_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156788,7 +156804,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state335_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156798,7 +156814,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state336_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156808,7 +156824,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state337_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156818,7 +156834,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state338_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156828,7 +156844,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state339_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156838,7 +156854,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state340_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156848,7 +156864,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state341_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156858,7 +156874,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state342_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156868,7 +156884,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state343_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156878,7 +156894,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state344_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156888,7 +156904,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state345_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156898,7 +156914,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state346_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156908,7 +156924,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state347_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156918,7 +156934,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state348_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156928,7 +156944,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state349_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156938,7 +156954,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state350_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156948,7 +156964,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state351_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156958,7 +156974,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state352_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156968,7 +156984,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state353_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156978,7 +156994,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state354_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156988,7 +157004,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state355_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -156998,7 +157014,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state356_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157008,7 +157024,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state357_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157018,7 +157034,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state358_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157028,7 +157044,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state359_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157038,7 +157054,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state360_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157048,7 +157064,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state361_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157058,7 +157074,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state362_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157068,7 +157084,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state363_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157078,7 +157094,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state364_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157088,7 +157104,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state365_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157098,7 +157114,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state366_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157108,7 +157124,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state367_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157118,7 +157134,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state368_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157128,7 +157144,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state369_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157138,7 +157154,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state370_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157148,7 +157164,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state371_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157158,7 +157174,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state372_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157168,7 +157184,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state373_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157178,7 +157194,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state374_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157188,7 +157204,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state375_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157198,7 +157214,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state376_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157208,7 +157224,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state377_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157218,7 +157234,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state378_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157228,7 +157244,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state379_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157238,7 +157254,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state380_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157248,7 +157264,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state381_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157258,7 +157274,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state382_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157268,7 +157284,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state383_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157278,7 +157294,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state384_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157288,7 +157304,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state385_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157298,7 +157314,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state386_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157308,7 +157324,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state387_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157318,7 +157334,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state388_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157328,7 +157344,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state389_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157338,7 +157354,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state390_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157348,7 +157364,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state391_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157358,7 +157374,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state392_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157368,7 +157384,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state393_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157378,7 +157394,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state394_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157388,7 +157404,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state395_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157398,7 +157414,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state396_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157408,7 +157424,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state397_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157418,7 +157434,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state398_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157428,7 +157444,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state399_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157438,7 +157454,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state400_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157448,7 +157464,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state401_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157460,7 +157476,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state403_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157470,7 +157486,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state404_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157480,7 +157496,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state405_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157490,7 +157506,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state406_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157500,7 +157516,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state407_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157510,7 +157526,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state408_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157520,7 +157536,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state409_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157530,7 +157546,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state410_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157540,7 +157556,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state411_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157550,7 +157566,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state412_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157560,7 +157576,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state413_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157570,7 +157586,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state414_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157580,7 +157596,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state415_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157590,7 +157606,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state416_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157600,7 +157616,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state417_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157610,7 +157626,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state418_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157620,7 +157636,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state419_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157630,7 +157646,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state420_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157640,7 +157656,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state421_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157650,7 +157666,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state422_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157660,7 +157676,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state423_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157670,7 +157686,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state424_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157680,7 +157696,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state425_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157690,7 +157706,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state426_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157700,7 +157716,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state427_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157710,7 +157726,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state428_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157720,7 +157736,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state429_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157730,7 +157746,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state430_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157740,7 +157756,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state431_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157750,7 +157766,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state432_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157760,7 +157776,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state433_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157770,7 +157786,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state434_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157780,7 +157796,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state435_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157790,7 +157806,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state436_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157800,7 +157816,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state437_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157810,7 +157826,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state438_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157820,7 +157836,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state439_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157830,7 +157846,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state440_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157840,7 +157856,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state441_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157850,7 +157866,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state442_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157860,7 +157876,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state443_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157870,7 +157886,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state444_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157880,7 +157896,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state445_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157890,7 +157906,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state446_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157900,7 +157916,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state447_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157910,7 +157926,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state448_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157920,7 +157936,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state449_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157930,7 +157946,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state450_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157940,7 +157956,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state451_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157950,7 +157966,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state452_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157960,7 +157976,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state453_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157970,7 +157986,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state454_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157980,7 +157996,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state455_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -157990,7 +158006,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state456_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158000,7 +158016,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state457_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158010,7 +158026,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state458_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158020,7 +158036,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state459_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158030,7 +158046,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state460_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158040,7 +158056,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state461_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158050,7 +158066,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state462_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158060,7 +158076,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state463_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158070,7 +158086,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state464_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158080,7 +158096,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state465_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158090,7 +158106,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state466_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158100,7 +158116,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state467_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158110,7 +158126,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state468_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158120,7 +158136,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state469_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158130,7 +158146,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state470_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158140,7 +158156,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state471_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158150,7 +158166,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state472_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158160,7 +158176,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state473_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158170,7 +158186,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state474_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158180,7 +158196,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state475_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158190,7 +158206,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state476_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158200,7 +158216,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state477_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158210,7 +158226,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state478_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158220,7 +158236,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state479_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158230,7 +158246,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state480_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158240,7 +158256,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state481_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158250,7 +158266,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state482_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158260,7 +158276,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state483_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158270,7 +158286,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state484_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158280,7 +158296,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state485_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158290,7 +158306,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state486_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158300,7 +158316,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state487_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158310,7 +158326,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state488_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158320,7 +158336,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state489_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158330,7 +158346,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state490_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158340,7 +158356,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state491_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158350,7 +158366,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state492_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158360,7 +158376,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state493_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158370,7 +158386,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state494_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158380,7 +158396,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state495_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158390,7 +158406,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state496_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158400,7 +158416,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state497_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158410,7 +158426,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state498_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158420,7 +158436,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state499_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158430,7 +158446,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state500_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158440,7 +158456,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state501_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158450,7 +158466,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state502_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158460,7 +158476,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state503_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158470,7 +158486,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state504_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158480,7 +158496,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state505_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158490,7 +158506,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state506_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158500,7 +158516,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state507_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158510,7 +158526,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state508_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158520,7 +158536,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state509_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158530,7 +158546,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state510_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158540,7 +158556,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state511_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158550,7 +158566,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state512_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158560,7 +158576,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state513_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158570,7 +158586,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state514_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158580,7 +158596,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state515_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158590,7 +158606,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state516_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158600,7 +158616,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state517_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158610,7 +158626,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state518_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158620,7 +158636,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state519_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158630,7 +158646,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state520_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158640,7 +158656,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state521_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158650,7 +158666,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state522_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158660,7 +158676,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state523_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158670,7 +158686,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state524_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158680,7 +158696,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state525_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158690,7 +158706,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state526_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158700,7 +158716,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state527_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158710,7 +158726,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state528_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158720,7 +158736,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state529_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158730,7 +158746,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state530_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158740,7 +158756,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state531_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158750,7 +158766,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state532_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158760,7 +158776,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state533_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158770,7 +158786,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state534_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158780,7 +158796,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state535_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158790,7 +158806,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state536_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158800,7 +158816,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state537_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158810,7 +158826,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state538_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158820,7 +158836,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state539_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158830,7 +158846,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state540_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158840,7 +158856,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state541_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158850,7 +158866,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state542_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158860,7 +158876,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state543_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158870,7 +158886,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state544_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158880,7 +158896,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state545_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158890,7 +158906,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state546_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158900,7 +158916,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state547_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158910,7 +158926,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state548_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158920,7 +158936,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state549_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158930,7 +158946,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state550_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158940,7 +158956,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state551_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158950,7 +158966,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state552_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158960,7 +158976,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state553_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158970,7 +158986,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state554_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158980,7 +158996,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state555_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -158990,7 +159006,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state556_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159000,7 +159016,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state557_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159010,7 +159026,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state558_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159020,7 +159036,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state559_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159030,7 +159046,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state560_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159040,7 +159056,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state561_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159050,7 +159066,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state562_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159060,7 +159076,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state563_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159070,7 +159086,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state564_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159080,7 +159096,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state565_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159090,7 +159106,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state566_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159100,7 +159116,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state567_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159110,7 +159126,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state568_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159120,7 +159136,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state569_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159130,7 +159146,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state570_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159140,7 +159156,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state571_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159150,7 +159166,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state572_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159160,7 +159176,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state573_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159170,7 +159186,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state574_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159180,7 +159196,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state575_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159190,7 +159206,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state576_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159200,7 +159216,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state577_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159210,7 +159226,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state578_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159220,7 +159236,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state579_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159230,7 +159246,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state580_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159240,7 +159256,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state581_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159250,7 +159266,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state582_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159260,7 +159276,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state583_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159270,7 +159286,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state584_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159280,7 +159296,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state585_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159290,7 +159306,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state586_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159300,7 +159316,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state587_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159310,7 +159326,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state588_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159320,7 +159336,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state589_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159330,7 +159346,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state590_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159346,7 +159362,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state594_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159356,7 +159372,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state595_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159366,7 +159382,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state596_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159376,7 +159392,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state597_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159386,7 +159402,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state598_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159396,7 +159412,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state599_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159406,7 +159422,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state600_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159416,7 +159432,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state601_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159426,7 +159442,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state602_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159436,7 +159452,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state603_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159446,7 +159462,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state604_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159456,7 +159472,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state605_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159466,7 +159482,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state606_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159476,7 +159492,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state607_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159486,7 +159502,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state608_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159496,7 +159512,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state609_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159506,7 +159522,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state610_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159516,7 +159532,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state611_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159526,7 +159542,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state612_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159536,7 +159552,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state613_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159546,7 +159562,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state614_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159556,7 +159572,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state615_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159566,7 +159582,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state616_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159576,7 +159592,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state617_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159586,7 +159602,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state618_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159596,7 +159612,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state619_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159606,7 +159622,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state620_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159616,7 +159632,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state621_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159626,7 +159642,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state622_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159636,7 +159652,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state623_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159646,7 +159662,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state624_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159656,7 +159672,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state625_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159666,7 +159682,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state626_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159676,7 +159692,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state627_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159686,7 +159702,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state628_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159696,7 +159712,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state629_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159706,7 +159722,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state630_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159716,7 +159732,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state631_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159726,7 +159742,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state632_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159736,7 +159752,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state633_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159746,7 +159762,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state634_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159756,7 +159772,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state635_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159766,7 +159782,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state636_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159776,7 +159792,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state637_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159786,7 +159802,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state638_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159796,7 +159812,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state639_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159806,7 +159822,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state640_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159816,7 +159832,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state641_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159826,7 +159842,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state642_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159836,7 +159852,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state643_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159846,7 +159862,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state644_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159856,7 +159872,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state645_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159866,7 +159882,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state646_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159876,7 +159892,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state647_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159886,7 +159902,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state648_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159896,7 +159912,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state649_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159906,7 +159922,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state650_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159916,7 +159932,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state651_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159926,7 +159942,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state652_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159936,7 +159952,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state653_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159946,7 +159962,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state654_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159956,7 +159972,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state655_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159966,7 +159982,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state656_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159976,7 +159992,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state657_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159986,7 +160002,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state658_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -159996,7 +160012,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state659_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160006,7 +160022,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state660_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160016,7 +160032,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state661_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160026,7 +160042,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state662_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160036,7 +160052,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state663_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160046,7 +160062,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state664_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160056,7 +160072,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state665_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160066,7 +160082,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state666_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160076,7 +160092,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state667_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160086,7 +160102,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state668_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160096,7 +160112,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state669_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160106,7 +160122,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state670_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160116,7 +160132,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state671_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160126,7 +160142,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state672_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160136,7 +160152,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state673_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160146,7 +160162,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state674_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160156,7 +160172,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state675_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160166,7 +160182,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state676_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160176,7 +160192,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state677_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160186,7 +160202,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state678_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160196,7 +160212,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state679_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160206,7 +160222,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state680_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160216,7 +160232,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state681_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160226,7 +160242,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state682_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160236,7 +160252,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state683_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160246,7 +160262,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state684_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160256,7 +160272,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state685_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160266,7 +160282,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state686_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160276,7 +160292,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state687_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160286,7 +160302,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state688_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160296,7 +160312,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state689_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160306,7 +160322,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state690_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160316,7 +160332,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state691_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160326,7 +160342,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state692_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160336,7 +160352,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state693_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160346,7 +160362,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state694_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160356,7 +160372,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state695_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160366,7 +160382,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state696_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160376,7 +160392,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state697_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160386,7 +160402,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state698_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160396,7 +160412,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state699_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160406,7 +160422,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state700_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160416,7 +160432,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state701_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160426,7 +160442,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state702_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160436,7 +160452,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state703_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160446,7 +160462,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state704_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160456,7 +160472,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state705_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160466,7 +160482,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state706_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160476,7 +160492,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state707_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160486,7 +160502,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state708_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160496,7 +160512,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state709_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160506,7 +160522,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state710_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160516,7 +160532,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state711_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160526,7 +160542,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state712_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160536,7 +160552,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state713_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160546,7 +160562,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state714_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160556,7 +160572,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state715_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160566,7 +160582,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state716_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160576,7 +160592,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state717_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160586,7 +160602,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state718_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160596,7 +160612,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state719_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160606,7 +160622,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state720_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160616,7 +160632,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state721_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160626,7 +160642,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state722_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160636,7 +160652,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state723_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160646,7 +160662,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state724_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160656,7 +160672,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state725_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160666,7 +160682,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state726_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160676,7 +160692,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state727_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160686,7 +160702,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state728_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160696,7 +160712,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state729_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160706,7 +160722,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state730_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160716,7 +160732,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state731_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160726,7 +160742,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state732_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160736,7 +160752,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state733_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160746,7 +160762,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state734_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160756,7 +160772,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state735_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160766,7 +160782,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state736_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160776,7 +160792,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state737_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160786,7 +160802,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state738_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160796,7 +160812,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state739_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160806,7 +160822,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state740_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160816,7 +160832,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state741_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160826,7 +160842,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state742_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160836,7 +160852,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state743_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160846,7 +160862,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state744_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160856,7 +160872,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state745_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160866,7 +160882,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state746_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160876,7 +160892,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state747_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160886,7 +160902,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state748_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160896,7 +160912,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state749_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160906,7 +160922,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state750_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160916,7 +160932,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state751_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160926,7 +160942,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state752_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160936,7 +160952,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state753_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160946,7 +160962,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state754_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160956,7 +160972,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state755_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160966,7 +160982,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state756_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160976,7 +160992,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state757_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160986,7 +161002,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state758_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -160996,7 +161012,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state759_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161006,7 +161022,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state760_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161020,7 +161036,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state763_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161030,7 +161046,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state764_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161040,7 +161056,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state765_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161050,7 +161066,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state766_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161060,7 +161076,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state767_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161070,7 +161086,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state768_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161080,7 +161096,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state769_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161090,7 +161106,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state770_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161104,7 +161120,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state773_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161118,7 +161134,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state776_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161132,7 +161148,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state779_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161142,7 +161158,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state780_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161152,7 +161168,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state781_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161162,7 +161178,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state782_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161172,7 +161188,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state783_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161182,7 +161198,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state784_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161192,7 +161208,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state785_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161202,7 +161218,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state786_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161212,7 +161228,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state787_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161222,7 +161238,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state788_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161232,7 +161248,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state789_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161242,7 +161258,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state790_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161252,7 +161268,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state791_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161262,7 +161278,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state792_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161272,7 +161288,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state793_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161282,7 +161298,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state794_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161292,7 +161308,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state795_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161302,7 +161318,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state796_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161312,7 +161328,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state797_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161322,7 +161338,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state798_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161332,7 +161348,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state799_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161342,7 +161358,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state800_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161352,7 +161368,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state801_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161362,7 +161378,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state802_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161372,7 +161388,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state803_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161382,7 +161398,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state804_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161392,7 +161408,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state805_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161402,7 +161418,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state806_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161412,7 +161428,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state807_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161422,7 +161438,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state808_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161432,7 +161448,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state809_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161442,7 +161458,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state810_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161452,7 +161468,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state811_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161462,7 +161478,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state812_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161472,7 +161488,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state813_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161482,7 +161498,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state814_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161492,7 +161508,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state815_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161502,7 +161518,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state816_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161512,7 +161528,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state817_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161522,7 +161538,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state818_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161532,7 +161548,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state819_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161542,7 +161558,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state820_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161552,7 +161568,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state821_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161562,7 +161578,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state822_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161572,7 +161588,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state823_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161582,7 +161598,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state824_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161592,7 +161608,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state825_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161602,7 +161618,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state826_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161612,7 +161628,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state827_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161622,7 +161638,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state828_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161632,7 +161648,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state829_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161642,7 +161658,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state830_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161652,7 +161668,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state831_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161662,7 +161678,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state832_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161672,7 +161688,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state833_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161682,7 +161698,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state834_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161692,7 +161708,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state835_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161702,7 +161718,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state836_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161712,7 +161728,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state837_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161722,7 +161738,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state838_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161732,7 +161748,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state839_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161742,7 +161758,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state840_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161752,7 +161768,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state841_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161762,7 +161778,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state842_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161772,7 +161788,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state843_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161782,7 +161798,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state844_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161792,7 +161808,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state845_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161802,7 +161818,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state846_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161812,7 +161828,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state847_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161822,7 +161838,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state848_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161832,7 +161848,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state849_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161842,7 +161858,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state850_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161852,7 +161868,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state851_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161862,7 +161878,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state852_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161872,7 +161888,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state853_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161884,7 +161900,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state855_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161894,7 +161910,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state856_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161910,7 +161926,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state860_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161920,7 +161936,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state861_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161930,7 +161946,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state862_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161940,7 +161956,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state863_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161950,7 +161966,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state864_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161960,7 +161976,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state865_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161970,7 +161986,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state866_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161980,7 +161996,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state867_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -161990,7 +162006,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state868_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162000,7 +162016,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state869_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162010,7 +162026,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state870_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162020,7 +162036,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state871_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162030,7 +162046,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state872_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162040,7 +162056,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state873_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162050,7 +162066,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state874_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162060,7 +162076,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state875_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162070,7 +162086,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state876_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162080,7 +162096,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state877_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162090,7 +162106,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state878_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162100,7 +162116,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state879_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162110,7 +162126,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state880_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162120,7 +162136,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state881_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162130,7 +162146,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state882_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162140,7 +162156,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state883_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162150,7 +162166,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state884_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162160,7 +162176,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state885_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162170,7 +162186,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state886_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162180,7 +162196,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state887_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162190,7 +162206,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state888_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162200,7 +162216,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state889_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162210,7 +162226,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state890_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162220,7 +162236,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state891_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162230,7 +162246,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state892_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162240,7 +162256,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state893_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162250,7 +162266,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state894_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162260,7 +162276,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state895_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162270,7 +162286,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state896_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162280,7 +162296,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state897_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162290,7 +162306,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state898_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162300,7 +162316,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state899_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162310,7 +162326,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state900_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162320,7 +162336,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state901_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162332,7 +162348,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state903_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162342,7 +162358,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state904_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162352,7 +162368,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state905_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162362,7 +162378,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state906_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162372,7 +162388,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state907_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162382,7 +162398,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state908_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162392,7 +162408,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state909_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162402,7 +162418,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state910_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162412,7 +162428,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state911_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162422,7 +162438,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state912_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162432,7 +162448,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state913_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162442,7 +162458,7 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state914_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -162452,13 +162468,44 @@ nir_opt_algebraic_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_state915_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
          break;
       default: assert(0);
       }
+
+      if (!replaced) {
+         instr = prev;
+         continue;
+      }
+
+      progress = true;
+
+      /* The replacement was inserted right where the old instruction used
+       * to be.  Give the new SSA values their automaton states and keep
+       * walking backwards from the last of them, so that the expressions
+       * we just built get matched in this same pass instead of waiting for
+       * the caller's next optimization loop iteration.
+       */
+      unsigned old_size = states->size / sizeof(uint16_t);
+      unsigned new_size = build->impl->ssa_alloc;
+      if (new_size > old_size) {
+         uint16_t *grown = util_dynarray_grow(states,
+                                              (new_size - old_size) *
+                                              sizeof(uint16_t));
+         memset(grown, 0, (new_size - old_size) * sizeof(uint16_t));
+      }
+
+      nir_instr *first = prev ? nir_instr_next(prev) :
+                                nir_block_first_instr(block);
+      nir_instr *last = prev;
+      for (nir_instr *n = first; n != next; n = nir_instr_next(n)) {
+         nir_opt_algebraic_compute_state(n, util_dynarray_begin(states));
+         last = n;
+      }
+      instr = last;
    }
 
    return progress;
@@ -162472,21 +162519,24 @@ nir_opt_algebraic_impl(nir_function_impl *impl, const bool *condition_flags)
    nir_builder build;
    nir_builder_init(&build, impl);
 
-   /* Note: it's important here that we're allocating a zeroed array, since
-    * state 0 is the default state, which means we don't have to visit
+   /* Note: it's important here that we're starting from a zeroed array,
+    * since state 0 is the default state, which means we don't have to visit
     * anything other than constants and ALU instructions.
     */
-   uint16_t *states = calloc(impl->ssa_alloc, sizeof(*states));
+   struct util_dynarray states;
+   util_dynarray_init(&states, NULL);
+   memset(util_dynarray_resize(&states, impl->ssa_alloc * sizeof(uint16_t)),
+          0, impl->ssa_alloc * sizeof(uint16_t));
 
    nir_foreach_block(block, impl) {
-      nir_opt_algebraic_pre_block(block, states);
+      nir_opt_algebraic_pre_block(block, util_dynarray_begin(&states));
    }
 
    nir_foreach_block_reverse(block, impl) {
-      progress |= nir_opt_algebraic_block(&build, block, states, condition_flags);
+      progress |= nir_opt_algebraic_block(&build, block, &states, condition_flags);
    }
 
-   free(states);
+   util_dynarray_fini(&states);
 
    if (progress) {
       nir_metadata_preserve(impl, nir_metadata_block_index |
@@ -162580,6 +162630,7 @@ nir_opt_algebraic(nir_shader *shader)
 #include "nir_builder.h"
 #include "nir_search.h"
 #include "nir_search_helpers.h"
+#include "util/u_dynarray.h"
 
 #ifndef NIR_OPT_ALGEBRAIC_STRUCT_DEFS
 #define NIR_OPT_ALGEBRAIC_STRUCT_DEFS
@@ -163678,59 +163729,74 @@ static const struct per_op_table nir_opt_algebraic_before_ffma_table[nir_num_sea
 };
 
 static void
-nir_opt_algebraic_before_ffma_pre_block(nir_block *block, uint16_t *states)
+nir_opt_algebraic_before_ffma_compute_state(nir_instr *instr, uint16_t *states)
 {
-   nir_foreach_instr(instr, block) {
-      switch (instr->type) {
-      case nir_instr_type_alu: {
-         nir_alu_instr *alu = nir_instr_as_alu(instr);
-         nir_op op = alu->op;
-         uint16_t search_op = nir_search_op_for_nir_op(op);
-         const struct per_op_table *tbl = &nir_opt_algebraic_before_ffma_table[search_op];
-         if (tbl->num_filtered_states == 0)
-            continue;
-
-         /* Calculate the index into the transition table. Note the index
-          * calculated must match the iteration order of Python's
-          * itertools.product(), which was used to emit the transition
-          * table.
-          */
-         uint16_t index = 0;
-         for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
-            index *= tbl->num_filtered_states;
-            index += tbl->filter[states[alu->src[i].src.ssa->index]];
-         }
-         states[alu->dest.dest.ssa.index] = tbl->table[index];
-         break;
+   switch (instr->type) {
+   case nir_instr_type_alu: {
+      nir_alu_instr *alu = nir_instr_as_alu(instr);
+      nir_op op = alu->op;
+      uint16_t search_op = nir_search_op_for_nir_op(op);
+      const struct per_op_table *tbl = &nir_opt_algebraic_before_ffma_table[search_op];
+      if (tbl->num_filtered_states == 0)
+         return;
+
+      /* Calculate the index into the transition table. Note the index
+       * calculated must match the iteration order of Python's
+       * itertools.product(), which was used to emit the transition
+       * table.
+       */
+      uint16_t index = 0;
+      for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
+         index *= tbl->num_filtered_states;
+         index += tbl->filter[states[alu->src[i].src.ssa->index]];
       }
+      states[alu->dest.dest.ssa.index] = tbl->table[index];
+      break;
+   }
 
-      case nir_instr_type_load_const: {
-         nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
-         states[load_const->def.index] = CONST_STATE;
-         break;
-      }
+   case nir_instr_type_load_const: {
+      nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
+      states[load_const->def.index] = CONST_STATE;
+      break;
+   }
 
-      default:
-         break;
-      }
+   default:
+      break;
    }
 }
 
+static void
+nir_opt_algebraic_before_ffma_pre_block(nir_block *block, uint16_t *states)
+{
+   nir_foreach_instr(instr, block)
+      nir_opt_algebraic_before_ffma_compute_state(instr, states);
+}
+
 static bool
 nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
-                   const uint16_t *states, const bool *condition_flags)
+                   struct util_dynarray *states, const bool *condition_flags)
 {
    bool progress = false;
 
-   nir_foreach_instr_reverse_safe(instr, block) {
-      if (instr->type != nir_instr_type_alu)
+   nir_instr *instr = nir_block_last_instr(block);
+   while (instr) {
+      nir_instr *prev = nir_instr_prev(instr);
+      nir_instr *next = nir_instr_next(instr);
+
+      if (instr->type != nir_instr_type_alu) {
+         instr = prev;
          continue;
+      }
 
       nir_alu_instr *alu = nir_instr_as_alu(instr);
-      if (!alu->dest.dest.is_ssa)
+      if (!alu->dest.dest.is_ssa) {
+         instr = prev;
          continue;
+      }
 
-      switch (states[alu->dest.dest.ssa.index]) {
+      bool replaced = false;
+      const uint16_t *s = util_dynarray_begin(states);
+      switch (s[alu->dest.dest.ssa.index]) {
       case 0:
          break;
       case 1:
@@ -163760,7 +163826,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state12_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163770,7 +163836,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state13_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163780,7 +163846,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state14_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163790,7 +163856,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state15_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163800,7 +163866,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state16_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163810,7 +163876,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state17_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163820,7 +163886,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state18_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163830,7 +163896,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state19_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163840,7 +163906,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state20_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163850,7 +163916,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state21_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163860,7 +163926,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state22_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163870,7 +163936,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state23_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163880,7 +163946,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state24_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163890,7 +163956,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state25_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163900,7 +163966,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state26_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163910,7 +163976,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state27_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163920,7 +163986,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state28_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163930,7 +163996,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state29_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163940,7 +164006,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state30_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163950,7 +164016,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state31_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163960,7 +164026,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state32_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163970,7 +164036,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state33_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163980,7 +164046,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state34_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -163990,7 +164056,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state35_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -164000,7 +164066,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state36_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -164010,7 +164076,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state37_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -164020,7 +164086,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state38_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -164030,7 +164096,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state39_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -164040,7 +164106,7 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state40_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -164050,13 +164116,44 @@ nir_opt_algebraic_before_ffma_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_before_ffma_state41_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
          break;
       default: assert(0);
       }
+
+      if (!replaced) {
+         instr = prev;
+         continue;
+      }
+
+      progress = true;
+
+      /* The replacement was inserted right where the old instruction used
+       * to be.  Give the new SSA values their automaton states and keep
+       * walking backwards from the last of them, so that the expressions
+       * we just built get matched in this same pass instead of waiting for
+       * the caller's next optimization loop iteration.
+       */
+      unsigned old_size = states->size / sizeof(uint16_t);
+      unsigned new_size = build->impl->ssa_alloc;
+      if (new_size > old_size) {
+         uint16_t *grown = util_dynarray_grow(states,
+                                              (new_size - old_size) *
+                                              sizeof(uint16_t));
+         memset(grown, 0, (new_size - old_size) * sizeof(uint16_t));
+      }
+
+      nir_instr *first = prev ? nir_instr_next(prev) :
+                                nir_block_first_instr(block);
+      nir_instr *last = prev;
+      for (nir_instr *n = first; n != next; n = nir_instr_next(n)) {
+         nir_opt_algebraic_before_ffma_compute_state(n, util_dynarray_begin(states));
+         last = n;
+      }
+      instr = last;
    }
 
    return progress;
@@ -164070,21 +164167,24 @@ nir_opt_algebraic_before_ffma_impl(nir_function_impl *impl, const bool *conditio
    nir_builder build;
    nir_builder_init(&build, impl);
 
-   /* Note: it's important here that we're allocating a zeroed array, since
-    * state 0 is the default state, which means we don't have to visit
+   /* Note: it's important here that we're starting from a zeroed array,
+    * since state 0 is the default state, which means we don't have to visit
     * anything other than constants and ALU instructions.
     */
-   uint16_t *states = calloc(impl->ssa_alloc, sizeof(*states));
+   struct util_dynarray states;
+   util_dynarray_init(&states, NULL);
+   memset(util_dynarray_resize(&states, impl->ssa_alloc * sizeof(uint16_t)),
+          0, impl->ssa_alloc * sizeof(uint16_t));
 
    nir_foreach_block(block, impl) {
-      nir_opt_algebraic_before_ffma_pre_block(block, states);
+      nir_opt_algebraic_before_ffma_pre_block(block, util_dynarray_begin(&states));
    }
 
    nir_foreach_block_reverse(block, impl) {
-      progress |= nir_opt_algebraic_before_ffma_block(&build, block, states, condition_flags);
+      progress |= nir_opt_algebraic_before_ffma_block(&build, block, &states, condition_flags);
    }
 
-   free(states);
+   util_dynarray_fini(&states);
 
    if (progress) {
       nir_metadata_preserve(impl, nir_metadata_block_index |
@@ -164178,6 +164278,7 @@ nir_opt_algebraic_before_ffma(nir_shader *shader)
 #include "nir_builder.h"
 #include "nir_search.h"
 #include "nir_search_helpers.h"
+#include "util/u_dynarray.h"
 
 #ifndef NIR_OPT_ALGEBRAIC_STRUCT_DEFS
 #define NIR_OPT_ALGEBRAIC_STRUCT_DEFS
@@ -165459,59 +165560,74 @@ static const struct per_op_table nir_opt_algebraic_late_table[nir_num_search_ops
 };
 
 static void
-nir_opt_algebraic_late_pre_block(nir_block *block, uint16_t *states)
+nir_opt_algebraic_late_compute_state(nir_instr *instr, uint16_t *states)
 {
-   nir_foreach_instr(instr, block) {
-      switch (instr->type) {
-      case nir_instr_type_alu: {
-         nir_alu_instr *alu = nir_instr_as_alu(instr);
-         nir_op op = alu->op;
-         uint16_t search_op = nir_search_op_for_nir_op(op);
-         const struct per_op_table *tbl = &nir_opt_algebraic_late_table[search_op];
-         if (tbl->num_filtered_states == 0)
-            continue;
-
-         /* Calculate the index into the transition table. Note the index
-          * calculated must match the iteration order of Python's
-          * itertools.product(), which was used to emit the transition
-          * table.
-          */
-         uint16_t index = 0;
-         for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
-            index *= tbl->num_filtered_states;
-            index += tbl->filter[states[alu->src[i].src.ssa->index]];
-         }
-         states[alu->dest.dest.ssa.index] = tbl->table[index];
-         break;
+   switch (instr->type) {
+   case nir_instr_type_alu: {
+      nir_alu_instr *alu = nir_instr_as_alu(instr);
+      nir_op op = alu->op;
+      uint16_t search_op = nir_search_op_for_nir_op(op);
+      const struct per_op_table *tbl = &nir_opt_algebraic_late_table[search_op];
+      if (tbl->num_filtered_states == 0)
+         return;
+
+      /* Calculate the index into the transition table. Note the index
+       * calculated must match the iteration order of Python's
+       * itertools.product(), which was used to emit the transition
+       * table.
+       */
+      uint16_t index = 0;
+      for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
+         index *= tbl->num_filtered_states;
+         index += tbl->filter[states[alu->src[i].src.ssa->index]];
       }
+      states[alu->dest.dest.ssa.index] = tbl->table[index];
+      break;
+   }
 
-      case nir_instr_type_load_const: {
-         nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
-         states[load_const->def.index] = CONST_STATE;
-         break;
-      }
+   case nir_instr_type_load_const: {
+      nir_load_const_instr *load_const = nir_instr_as_load_const(instr);
+      states[load_const->def.index] = CONST_STATE;
+      break;
+   }
 
-      default:
-         break;
-      }
+   default:
+      break;
    }
 }
 
+static void
+nir_opt_algebraic_late_pre_block(nir_block *block, uint16_t *states)
+{
+   nir_foreach_instr(instr, block)
+      nir_opt_algebraic_late_compute_state(instr, states);
+}
+
 static bool
 nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
-                   const uint16_t *states, const bool *condition_flags)
+                   struct util_dynarray *states, const bool *condition_flags)
 {
    bool progress = false;
 
-   nir_foreach_instr_reverse_safe(instr, block) {
-      if (instr->type != nir_instr_type_alu)
+   nir_instr *instr = nir_block_last_instr(block);
+   while (instr) {
+      nir_instr *prev = nir_instr_prev(instr);
+      nir_instr *next = nir_instr_next(instr);
+
+      if (instr->type != nir_instr_type_alu) {
+         instr = prev;
          continue;
+      }
 
       nir_alu_instr *alu = nir_instr_as_alu(instr);
-      if (!alu->dest.dest.is_ssa)
+      if (!alu->dest.dest.is_ssa) {
+         instr = prev;
          continue;
+      }
 
-      switch (states[alu->dest.dest.ssa.index]) {
+      bool replaced = false;
+      const uint16_t *s = util_dynarray_begin(states);
+      switch (s[alu->dest.dest.ssa.index]) {
       case 0:
          break;
       case 1:
@@ -165525,7 +165641,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state4_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165535,7 +165651,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state5_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165545,7 +165661,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state6_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165555,7 +165671,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state7_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165567,7 +165683,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state9_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165579,7 +165695,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state11_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165589,7 +165705,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state12_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165599,7 +165715,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state13_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165611,7 +165727,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state15_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165621,7 +165737,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state16_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165633,7 +165749,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state18_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165643,7 +165759,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state19_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165653,7 +165769,7 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state20_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
@@ -165663,13 +165779,44 @@ nir_opt_algebraic_late_block(nir_builder *build, nir_block *block,
             const struct transform *xform = &nir_opt_algebraic_late_state21_xforms[i];
             if (condition_flags[xform->condition_offset] &&
                 nir_replace_instr(build, alu, xform->search, xform->replace)) {
-               progress = true;
+               replaced = true;
                break;
             }
          }
          break;
       default: assert(0);
       }
+
+      if (!replaced) {
+         instr = prev;
+         continue;
+      }
+
+      progress = true;
+
+      /* The replacement was inserted right where the old instruction used
+       * to be.  Give the new SSA values their automaton states and keep
+       * walking backwards from the last of them, so that the expressions
+       * we just built get matched in this same pass instead of waiting for
+       * the caller's next optimization loop iteration.
+       */
+      unsigned old_size = states->size / sizeof(uint16_t);
+      unsigned new_size = build->impl->ssa_alloc;
+      if (new_size > old_size) {
+         uint16_t *grown = util_dynarray_grow(states,
+                                              (new_size - old_size) *
+                                              sizeof(uint16_t));
+         memset(grown, 0, (new_size - old_size) * sizeof(uint16_t));
+      }
+
+      nir_instr *first = prev ? nir_instr_next(prev) :
+                                nir_block_first_instr(block);
+      nir_instr *last = prev;
+      for (nir_instr *n = first; n != next; n = nir_instr_next(n)) {
+         nir_opt_algebraic_late_compute_state(n, util_dynarray_begin(states));
+         last = n;
+      }
+      instr = last;
    }
 
    return progress;
@@ -165683,21 +165830,24 @@ nir_opt_algebraic_late_impl(nir_function_impl *impl, const bool *condition_flags
    nir_builder build;
    nir_builder_init(&build, impl);
 
-   /* Note: it's important here that we're allocating a zeroed array, since
-    * state 0 is the default state, which means we don't have to visit
+   /* Note: it's important here that we're starting from a zeroed array,
+    * since state 0 is the default state, which means we don't have to visit
     * anything other than constants and ALU instructions.
     */
-   uint16_t *states = calloc(impl->ssa_alloc, sizeof(*states));
+   struct util_dynarray states;
+   util_dynarray_init(&states, NULL);
+   memset(util_dynarray_resize(&states, impl->ssa_alloc * sizeof(uint16_t)),
+          0, impl->ssa_alloc * sizeof(uint16_t));
 
    nir_foreach_block(block, impl) {
-      nir_opt_algebraic_late_pre_block(block, states);
+      nir_opt_algebraic_late_pre_block(block, util_dynarray_begin(&states));
    }
 
    nir_foreach_block_reverse(block, impl) {
-      progress |= nir_opt_algebraic_late_block(&build, block, states, condition_flags);
+      progress |= nir_opt_algebraic_late_block(&build, block, &states, condition_flags);
    }
 
-   free(states);
+   util_dynarray_fini(&states);
 
    if (progress) {
       nir_metadata_preserve(impl, nir_metadata_block_index |
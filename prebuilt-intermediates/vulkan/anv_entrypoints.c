@@ -530,8 +530,10 @@ static const char device_strings[] =
     "vkGetMemoryFdKHR\0"
     "vkGetMemoryFdPropertiesKHR\0"
     "vkGetMemoryHostPointerPropertiesEXT\0"
+    "vkGetPastPresentationTimingGOOGLE\0"
     "vkGetPipelineCacheData\0"
     "vkGetQueryPoolResults\0"
+    "vkGetRefreshCycleDurationGOOGLE\0"
     "vkGetRenderAreaGranularity\0"
     "vkGetSemaphoreFdKHR\0"
     "vkGetSwapchainCounterEXT\0"
@@ -566,7 +568,7 @@ static const char device_strings[] =
 ;
 
 static const struct string_map_entry device_string_map_entries[] = {
-    { 0, 0x6bf780dd, 176 }, /* vkAcquireImageANDROID */
+    { 0, 0x6bf780dd, 178 }, /* vkAcquireImageANDROID */
     { 22, 0x82860572, 152 }, /* vkAcquireNextImage2KHR */
     { 45, 0xc3fedb2e, 127 }, /* vkAcquireNextImageKHR */
     { 67, 0x8c0c811a, 73 }, /* vkAllocateCommandBuffers */
@@ -581,14 +583,14 @@ static const struct string_map_entry device_string_map_entries[] = {
     { 254, 0xf18729ad, 147 }, /* vkBindImageMemory2KHR */
     { 276, 0xe561c19f, 114 }, /* vkCmdBeginConditionalRenderingEXT */
     { 310, 0xf5064ea4, 112 }, /* vkCmdBeginQuery */
-    { 326, 0x73251a2c, 191 }, /* vkCmdBeginQueryIndexedEXT */
+    { 326, 0x73251a2c, 193 }, /* vkCmdBeginQueryIndexedEXT */
     { 352, 0xcb7a58e3, 120 }, /* vkCmdBeginRenderPass */
-    { 373, 0x8b6b4de6, 181 }, /* vkCmdBeginRenderPass2KHR */
-    { 398, 0xb217c94, 189 }, /* vkCmdBeginTransformFeedbackEXT */
+    { 373, 0x8b6b4de6, 183 }, /* vkCmdBeginRenderPass2KHR */
+    { 398, 0xb217c94, 191 }, /* vkCmdBeginTransformFeedbackEXT */
     { 429, 0x28c7a5da, 88 }, /* vkCmdBindDescriptorSets */
     { 453, 0x4c22d870, 89 }, /* vkCmdBindIndexBuffer */
     { 474, 0x3af9fd84, 78 }, /* vkCmdBindPipeline */
-    { 492, 0x98fdb5cd, 188 }, /* vkCmdBindTransformFeedbackBuffersEXT */
+    { 492, 0x98fdb5cd, 190 }, /* vkCmdBindTransformFeedbackBuffersEXT */
     { 529, 0xa9c83f1d, 90 }, /* vkCmdBindVertexBuffers */
     { 552, 0x331ebf89, 99 }, /* vkCmdBlitImage */
     { 567, 0x93cb5cb8, 106 }, /* vkCmdClearAttachments */
@@ -606,20 +608,20 @@ static const struct string_map_entry device_string_map_entries[] = {
     { 816, 0x9912c1a1, 91 }, /* vkCmdDraw */
     { 826, 0xbe5a8058, 92 }, /* vkCmdDrawIndexed */
     { 843, 0x94e7ed36, 94 }, /* vkCmdDrawIndexedIndirect */
-    { 868, 0xda9e8a2c, 187 }, /* vkCmdDrawIndexedIndirectCountKHR */
+    { 868, 0xda9e8a2c, 189 }, /* vkCmdDrawIndexedIndirectCountKHR */
     { 901, 0xe9ac41bf, 93 }, /* vkCmdDrawIndirect */
-    { 919, 0x80c3b089, 193 }, /* vkCmdDrawIndirectByteCountEXT */
-    { 949, 0xf7dd01f5, 186 }, /* vkCmdDrawIndirectCountKHR */
+    { 919, 0x80c3b089, 195 }, /* vkCmdDrawIndirectByteCountEXT */
+    { 949, 0xf7dd01f5, 188 }, /* vkCmdDrawIndirectCountKHR */
     { 975, 0x18c8217d, 115 }, /* vkCmdEndConditionalRenderingEXT */
     { 1007, 0xd556fd22, 113 }, /* vkCmdEndQuery */
-    { 1021, 0xd5c2f48a, 192 }, /* vkCmdEndQueryIndexedEXT */
+    { 1021, 0xd5c2f48a, 194 }, /* vkCmdEndQueryIndexedEXT */
     { 1045, 0xdcdb0235, 122 }, /* vkCmdEndRenderPass */
-    { 1064, 0x57eebe78, 183 }, /* vkCmdEndRenderPass2KHR */
-    { 1087, 0xf008d706, 190 }, /* vkCmdEndTransformFeedbackEXT */
+    { 1064, 0x57eebe78, 185 }, /* vkCmdEndRenderPass2KHR */
+    { 1087, 0xf008d706, 192 }, /* vkCmdEndTransformFeedbackEXT */
     { 1116, 0x9eaabe40, 123 }, /* vkCmdExecuteCommands */
     { 1137, 0x5bdd2ae0, 103 }, /* vkCmdFillBuffer */
     { 1153, 0x2eeec2f9, 121 }, /* vkCmdNextSubpass */
-    { 1170, 0x25b621bc, 182 }, /* vkCmdNextSubpass2KHR */
+    { 1170, 0x25b621bc, 184 }, /* vkCmdNextSubpass2KHR */
     { 1191, 0x97fccfe8, 111 }, /* vkCmdPipelineBarrier */
     { 1212, 0xb1c6b468, 119 }, /* vkCmdPushConstants */
     { 1231, 0xf17232a1, 129 }, /* vkCmdPushDescriptorSetKHR */
@@ -650,7 +652,7 @@ static const struct string_map_entry device_string_map_entries[] = {
     { 1749, 0x3c14cc74, 57 }, /* vkCreateDescriptorSetLayout */
     { 1777, 0xad3ce733, 155 }, /* vkCreateDescriptorUpdateTemplate */
     { 1810, 0x5189488a, 156 }, /* vkCreateDescriptorUpdateTemplateKHR */
-    { 1846, 0x6392dfa7, 196 }, /* vkCreateDmaBufImageINTEL */
+    { 1846, 0x6392dfa7, 198 }, /* vkCreateDmaBufImageINTEL */
     { 1871, 0xe7188731, 26 }, /* vkCreateEvent */
     { 1885, 0x958af968, 19 }, /* vkCreateFence */
     { 1899, 0x887a38c4, 65 }, /* vkCreateFramebuffer */
@@ -661,10 +663,10 @@ static const struct string_map_entry device_string_map_entries[] = {
     { 1999, 0x451ef1ed, 53 }, /* vkCreatePipelineLayout */
     { 2022, 0x5edcd92b, 31 }, /* vkCreateQueryPool */
     { 2040, 0x109a9c18, 67 }, /* vkCreateRenderPass */
-    { 2059, 0xfa16043b, 180 }, /* vkCreateRenderPass2KHR */
+    { 2059, 0xfa16043b, 182 }, /* vkCreateRenderPass2KHR */
     { 2082, 0x13cf03f, 55 }, /* vkCreateSampler */
-    { 2098, 0xe6a58c26, 168 }, /* vkCreateSamplerYcbcrConversion */
-    { 2129, 0x7482104f, 169 }, /* vkCreateSamplerYcbcrConversionKHR */
+    { 2098, 0xe6a58c26, 170 }, /* vkCreateSamplerYcbcrConversion */
+    { 2129, 0x7482104f, 171 }, /* vkCreateSamplerYcbcrConversionKHR */
     { 2163, 0xf2065e5b, 24 }, /* vkCreateSemaphore */
     { 2181, 0xa0d3cea2, 44 }, /* vkCreateShaderModule */
     { 2202, 0xcdefcaa8, 124 }, /* vkCreateSwapchainKHR */
@@ -687,8 +689,8 @@ static const struct string_map_entry device_string_map_entries[] = {
     { 2570, 0x37819a7f, 32 }, /* vkDestroyQueryPool */
     { 2589, 0x16f14324, 68 }, /* vkDestroyRenderPass */
     { 2609, 0x3b645153, 56 }, /* vkDestroySampler */
-    { 2626, 0x20f261b2, 170 }, /* vkDestroySamplerYcbcrConversion */
-    { 2658, 0xaaa623a3, 171 }, /* vkDestroySamplerYcbcrConversionKHR */
+    { 2626, 0x20f261b2, 172 }, /* vkDestroySamplerYcbcrConversion */
+    { 2658, 0xaaa623a3, 173 }, /* vkDestroySamplerYcbcrConversionKHR */
     { 2693, 0xcaab1faf, 25 }, /* vkDestroySemaphore */
     { 2712, 0x2d77af6e, 45 }, /* vkDestroyShaderModule */
     { 2734, 0x5a93ab74, 125 }, /* vkDestroySwapchainKHR */
@@ -699,76 +701,78 @@ static const struct string_map_entry device_string_map_entries[] = {
     { 2843, 0xb9db2b91, 74 }, /* vkFreeCommandBuffers */
     { 2864, 0x7a1347b1, 63 }, /* vkFreeDescriptorSets */
     { 2885, 0x8f6f838a, 7 }, /* vkFreeMemory */
-    { 2898, 0xb891b5e, 184 }, /* vkGetAndroidHardwareBufferPropertiesANDROID */
-    { 2942, 0x3703280c, 194 }, /* vkGetBufferDeviceAddressEXT */
+    { 2898, 0xb891b5e, 186 }, /* vkGetAndroidHardwareBufferPropertiesANDROID */
+    { 2942, 0x3703280c, 196 }, /* vkGetBufferDeviceAddressEXT */
     { 2970, 0xab98422a, 13 }, /* vkGetBufferMemoryRequirements */
-    { 3000, 0xd1fd0638, 162 }, /* vkGetBufferMemoryRequirements2 */
-    { 3031, 0x78dbe98d, 163 }, /* vkGetBufferMemoryRequirements2KHR */
-    { 3065, 0xcf3070fe, 178 }, /* vkGetCalibratedTimestampsEXT */
-    { 3094, 0xfeac9573, 173 }, /* vkGetDescriptorSetLayoutSupport */
-    { 3126, 0xd7e44a, 174 }, /* vkGetDescriptorSetLayoutSupportKHR */
+    { 3000, 0xd1fd0638, 164 }, /* vkGetBufferMemoryRequirements2 */
+    { 3031, 0x78dbe98d, 165 }, /* vkGetBufferMemoryRequirements2KHR */
+    { 3065, 0xcf3070fe, 180 }, /* vkGetCalibratedTimestampsEXT */
+    { 3094, 0xfeac9573, 175 }, /* vkGetDescriptorSetLayoutSupport */
+    { 3126, 0xd7e44a, 176 }, /* vkGetDescriptorSetLayoutSupportKHR */
     { 3161, 0x2e218c10, 142 }, /* vkGetDeviceGroupPeerMemoryFeatures */
     { 3196, 0xa3809375, 143 }, /* vkGetDeviceGroupPeerMemoryFeaturesKHR */
     { 3234, 0xf72c87d4, 150 }, /* vkGetDeviceGroupPresentCapabilitiesKHR */
-    { 3273, 0x41b28e81, 195 }, /* vkGetDeviceGroupSurfacePresentModes2EXT */
+    { 3273, 0x41b28e81, 197 }, /* vkGetDeviceGroupSurfacePresentModes2EXT */
     { 3313, 0x6b9448c3, 151 }, /* vkGetDeviceGroupSurfacePresentModesKHR */
     { 3352, 0x46e38db5, 12 }, /* vkGetDeviceMemoryCommitment */
     { 3380, 0xba013486, 0 }, /* vkGetDeviceProcAddr */
     { 3400, 0xcc920d9a, 2 }, /* vkGetDeviceQueue */
-    { 3417, 0xb11a6348, 172 }, /* vkGetDeviceQueue2 */
+    { 3417, 0xb11a6348, 174 }, /* vkGetDeviceQueue2 */
     { 3435, 0x96d834b, 28 }, /* vkGetEventStatus */
     { 3452, 0x69a5d6af, 136 }, /* vkGetFenceFdKHR */
     { 3468, 0x5f391892, 22 }, /* vkGetFenceStatus */
     { 3485, 0x916f1e63, 15 }, /* vkGetImageMemoryRequirements */
-    { 3514, 0x56e213f7, 164 }, /* vkGetImageMemoryRequirements2 */
-    { 3544, 0x8de28366, 165 }, /* vkGetImageMemoryRequirements2KHR */
+    { 3514, 0x56e213f7, 166 }, /* vkGetImageMemoryRequirements2 */
+    { 3544, 0x8de28366, 167 }, /* vkGetImageMemoryRequirements2KHR */
     { 3577, 0x15855f5b, 17 }, /* vkGetImageSparseMemoryRequirements */
-    { 3612, 0xbd4e3d3f, 166 }, /* vkGetImageSparseMemoryRequirements2 */
-    { 3648, 0x3df40f5e, 167 }, /* vkGetImageSparseMemoryRequirements2KHR */
+    { 3612, 0xbd4e3d3f, 168 }, /* vkGetImageSparseMemoryRequirements2 */
+    { 3648, 0x3df40f5e, 169 }, /* vkGetImageSparseMemoryRequirements2KHR */
     { 3687, 0x9163b686, 41 }, /* vkGetImageSubresourceLayout */
-    { 3715, 0x71220e82, 185 }, /* vkGetMemoryAndroidHardwareBufferANDROID */
+    { 3715, 0x71220e82, 187 }, /* vkGetMemoryAndroidHardwareBufferANDROID */
     { 3755, 0x503c14c5, 132 }, /* vkGetMemoryFdKHR */
     { 3772, 0xb028a792, 133 }, /* vkGetMemoryFdPropertiesKHR */
-    { 3799, 0x7030ee5b, 179 }, /* vkGetMemoryHostPointerPropertiesEXT */
-    { 3835, 0x2092a349, 48 }, /* vkGetPipelineCacheData */
-    { 3858, 0xbf3f2cb3, 33 }, /* vkGetQueryPoolResults */
-    { 3880, 0xa9820d22, 69 }, /* vkGetRenderAreaGranularity */
-    { 3907, 0x3e0e9884, 134 }, /* vkGetSemaphoreFdKHR */
-    { 3927, 0xa4aeb5a, 141 }, /* vkGetSwapchainCounterEXT */
-    { 3952, 0x4979c9a3, 175 }, /* vkGetSwapchainGrallocUsageANDROID */
-    { 3986, 0x57695f28, 126 }, /* vkGetSwapchainImagesKHR */
-    { 4010, 0x51df0390, 137 }, /* vkImportFenceFdKHR */
-    { 4029, 0x36337c05, 135 }, /* vkImportSemaphoreFdKHR */
-    { 4052, 0x1e115cca, 11 }, /* vkInvalidateMappedMemoryRanges */
-    { 4083, 0xcb977bd8, 8 }, /* vkMapMemory */
-    { 4095, 0xc3499606, 49 }, /* vkMergePipelineCaches */
-    { 4117, 0xc3628a09, 18 }, /* vkQueueBindSparse */
-    { 4135, 0xfc5fb6ce, 128 }, /* vkQueuePresentKHR */
-    { 4153, 0xa0313eef, 177 }, /* vkQueueSignalReleaseImageANDROID */
-    { 4186, 0xfa4713ec, 3 }, /* vkQueueSubmit */
-    { 4200, 0x6f8fc2a5, 4 }, /* vkQueueWaitIdle */
-    { 4216, 0x26cc78f5, 139 }, /* vkRegisterDeviceEventEXT */
-    { 4241, 0x4a0bd849, 140 }, /* vkRegisterDisplayEventEXT */
-    { 4267, 0x847dc731, 77 }, /* vkResetCommandBuffer */
-    { 4288, 0x6da9f7fd, 72 }, /* vkResetCommandPool */
-    { 4307, 0x9bd85f5, 61 }, /* vkResetDescriptorPool */
-    { 4329, 0x6d373ba8, 30 }, /* vkResetEvent */
-    { 4342, 0x684781dc, 21 }, /* vkResetFences */
-    { 4356, 0xe6701e5f, 34 }, /* vkResetQueryPoolEXT */
-    { 4376, 0x592ae5f5, 29 }, /* vkSetEvent */
-    { 4387, 0xfef2fb38, 130 }, /* vkTrimCommandPool */
-    { 4405, 0x51177c8d, 131 }, /* vkTrimCommandPoolKHR */
-    { 4426, 0x1a1a0e2f, 9 }, /* vkUnmapMemory */
-    { 4440, 0x5349c9d, 159 }, /* vkUpdateDescriptorSetWithTemplate */
-    { 4474, 0x214ad230, 160 }, /* vkUpdateDescriptorSetWithTemplateKHR */
-    { 4511, 0xbfd090ae, 64 }, /* vkUpdateDescriptorSets */
-    { 4534, 0x19d64c81, 23 }, /* vkWaitForFences */
+    { 3799, 0x7030ee5b, 181 }, /* vkGetMemoryHostPointerPropertiesEXT */
+    { 3835, 0x19616a98, 163 }, /* vkGetPastPresentationTimingGOOGLE */
+    { 3869, 0x2092a349, 48 }, /* vkGetPipelineCacheData */
+    { 3892, 0xbf3f2cb3, 33 }, /* vkGetQueryPoolResults */
+    { 3914, 0x85a9d101, 162 }, /* vkGetRefreshCycleDurationGOOGLE */
+    { 3946, 0xa9820d22, 69 }, /* vkGetRenderAreaGranularity */
+    { 3973, 0x3e0e9884, 134 }, /* vkGetSemaphoreFdKHR */
+    { 3993, 0xa4aeb5a, 141 }, /* vkGetSwapchainCounterEXT */
+    { 4018, 0x4979c9a3, 177 }, /* vkGetSwapchainGrallocUsageANDROID */
+    { 4052, 0x57695f28, 126 }, /* vkGetSwapchainImagesKHR */
+    { 4076, 0x51df0390, 137 }, /* vkImportFenceFdKHR */
+    { 4095, 0x36337c05, 135 }, /* vkImportSemaphoreFdKHR */
+    { 4118, 0x1e115cca, 11 }, /* vkInvalidateMappedMemoryRanges */
+    { 4149, 0xcb977bd8, 8 }, /* vkMapMemory */
+    { 4161, 0xc3499606, 49 }, /* vkMergePipelineCaches */
+    { 4183, 0xc3628a09, 18 }, /* vkQueueBindSparse */
+    { 4201, 0xfc5fb6ce, 128 }, /* vkQueuePresentKHR */
+    { 4219, 0xa0313eef, 179 }, /* vkQueueSignalReleaseImageANDROID */
+    { 4252, 0xfa4713ec, 3 }, /* vkQueueSubmit */
+    { 4266, 0x6f8fc2a5, 4 }, /* vkQueueWaitIdle */
+    { 4282, 0x26cc78f5, 139 }, /* vkRegisterDeviceEventEXT */
+    { 4307, 0x4a0bd849, 140 }, /* vkRegisterDisplayEventEXT */
+    { 4333, 0x847dc731, 77 }, /* vkResetCommandBuffer */
+    { 4354, 0x6da9f7fd, 72 }, /* vkResetCommandPool */
+    { 4373, 0x9bd85f5, 61 }, /* vkResetDescriptorPool */
+    { 4395, 0x6d373ba8, 30 }, /* vkResetEvent */
+    { 4408, 0x684781dc, 21 }, /* vkResetFences */
+    { 4422, 0xe6701e5f, 34 }, /* vkResetQueryPoolEXT */
+    { 4442, 0x592ae5f5, 29 }, /* vkSetEvent */
+    { 4453, 0xfef2fb38, 130 }, /* vkTrimCommandPool */
+    { 4471, 0x51177c8d, 131 }, /* vkTrimCommandPoolKHR */
+    { 4492, 0x1a1a0e2f, 9 }, /* vkUnmapMemory */
+    { 4506, 0x5349c9d, 159 }, /* vkUpdateDescriptorSetWithTemplate */
+    { 4540, 0x214ad230, 160 }, /* vkUpdateDescriptorSetWithTemplateKHR */
+    { 4577, 0xbfd090ae, 64 }, /* vkUpdateDescriptorSets */
+    { 4600, 0x19d64c81, 23 }, /* vkWaitForFences */
 };
 
 /* Hash table stats:
- * size 197 entries
+ * size 199 entries
  * collisions entries:
- *     0      122
+ *     0      124
  *     1      37
  *     2      10
  *     3      6
@@ -783,7 +787,7 @@ static const struct string_map_entry device_string_map_entries[] = {
 #define none 0xffff
 static const uint16_t device_string_map[256] = {
     0x005c,
-    none,
+    0x00a7,
     none,
     none,
     0x00a2,
@@ -791,7 +795,7 @@ static const uint16_t device_string_map[256] = {
     0x0031,
     0x003e,
     0x001a,
-    0x00b0,
+    0x00b2,
     0x0068,
     none,
     0x0086,
@@ -799,13 +803,13 @@ static const uint16_t device_string_map[256] = {
     0x0097,
     none,
     0x008d,
-    0x00ae,
+    0x00b0,
     none,
     none,
     none,
     none,
     none,
-    0x00b4,
+    0x00b6,
     0x000b,
     0x0090,
     0x0003,
@@ -817,7 +821,7 @@ static const uint16_t device_string_map[256] = {
     0x0022,
     0x0099,
     0x002d,
-    0x00b8,
+    0x00ba,
     0x0046,
     0x0080,
     0x0061,
@@ -829,7 +833,7 @@ static const uint16_t device_string_map[256] = {
     0x000f,
     none,
     0x0002,
-    0x00c0,
+    0x00c2,
     0x0069,
     0x0055,
     none,
@@ -847,37 +851,37 @@ static const uint16_t device_string_map[256] = {
     0x005d,
     0x0028,
     0x0032,
-    0x00b5,
-    none,
-    0x00c2,
     0x00b7,
+    none,
+    0x00c4,
+    0x00b9,
     0x0066,
     none,
     none,
     0x0095,
-    0x00a4,
+    0x00a5,
     0x000a,
     0x0096,
     0x004b,
     none,
-    0x00aa,
+    0x00ac,
     0x0008,
     none,
     0x005e,
     0x0060,
     0x0072,
-    0x00b9,
+    0x00bb,
     none,
     0x0041,
     none,
     0x0026,
     none,
-    0x00a8,
+    0x00aa,
     0x0063,
-    0x00b6,
+    0x00b8,
     0x007e,
     0x0049,
-    0x00bc,
+    0x00be,
     none,
     none,
     0x0062,
@@ -893,7 +897,7 @@ static const uint16_t device_string_map[256] = {
     none,
     0x0058,
     0x007c,
-    0x00c4,
+    0x00c6,
     0x0014,
     0x0085,
     0x0001,
@@ -904,7 +908,7 @@ static const uint16_t device_string_map[256] = {
     0x007f,
     0x0030,
     0x0075,
-    0x00bd,
+    0x00bf,
     0x0056,
     none,
     0x002c,
@@ -926,7 +930,7 @@ static const uint16_t device_string_map[256] = {
     0x0089,
     none,
     none,
-    0x00ab,
+    0x00ad,
     0x0082,
     0x006b,
     none,
@@ -934,7 +938,7 @@ static const uint16_t device_string_map[256] = {
     0x00a0,
     0x0071,
     0x009e,
-    none,
+    0x00a4,
     0x0093,
     0x007d,
     0x008e,
@@ -942,7 +946,7 @@ static const uint16_t device_string_map[256] = {
     0x0053,
     0x009d,
     0x000d,
-    0x00bf,
+    0x00c1,
     0x0025,
     0x0064,
     0x007a,
@@ -952,11 +956,11 @@ static const uint16_t device_string_map[256] = {
     0x003c,
     0x0065,
     0x001e,
-    0x00a7,
+    0x00a9,
     none,
     0x001f,
     0x000c,
-    0x00c3,
+    0x00c5,
     0x0073,
     0x0081,
     0x0083,
@@ -964,14 +968,14 @@ static const uint16_t device_string_map[256] = {
     0x004a,
     0x0038,
     0x0092,
-    0x00a9,
+    0x00ab,
     0x0050,
     0x0019,
     0x004c,
     0x001b,
-    0x00ba,
+    0x00bc,
     0x0035,
-    0x00be,
+    0x00c0,
     none,
     0x0029,
     0x0094,
@@ -980,11 +984,11 @@ static const uint16_t device_string_map[256] = {
     0x0084,
     0x0057,
     0x0079,
-    0x00a5,
+    0x00a6,
     none,
     none,
     none,
-    0x00ad,
+    0x00af,
     0x0007,
     none,
     0x0016,
@@ -1002,12 +1006,12 @@ static const uint16_t device_string_map[256] = {
     none,
     0x0013,
     none,
-    0x00bb,
+    0x00bd,
     0x0000,
     0x006d,
     none,
     0x0033,
-    0x00b1,
+    0x00b3,
     0x0045,
     0x0010,
     none,
@@ -1015,13 +1019,13 @@ static const uint16_t device_string_map[256] = {
     0x0011,
     0x008f,
     0x0036,
-    0x00ac,
-    0x00a6,
+    0x00ae,
+    0x00a8,
     0x004f,
-    0x00b3,
+    0x00b5,
     0x001c,
     none,
-    0x00b2,
+    0x00b4,
     none,
     0x0098,
     none,
@@ -1034,8 +1038,8 @@ static const uint16_t device_string_map[256] = {
     0x0034,
     none,
     0x003d,
-    0x00c1,
-    0x00af,
+    0x00c3,
+    0x00b1,
     0x008a,
     0x005a,
 };
@@ -2161,6 +2165,18 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
           ANV_FROM_HANDLE(anv_cmd_buffer, anv_cmd_buffer, commandBuffer);
           return anv_cmd_buffer->device->dispatch.vkCmdPushDescriptorSetWithTemplateKHR(commandBuffer, descriptorUpdateTemplate, layout, set, pData);
       }
+      VkResult __attribute__ ((weak))
+      anv_GetRefreshCycleDurationGOOGLE(VkDevice device, VkSwapchainKHR swapchain, VkRefreshCycleDurationGOOGLE* pDisplayTimingProperties)
+      {
+          ANV_FROM_HANDLE(anv_device, anv_device, device);
+          return anv_device->dispatch.vkGetRefreshCycleDurationGOOGLE(device, swapchain, pDisplayTimingProperties);
+      }
+      VkResult __attribute__ ((weak))
+      anv_GetPastPresentationTimingGOOGLE(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pPresentationTimingCount, VkPastPresentationTimingGOOGLE* pPresentationTimings)
+      {
+          ANV_FROM_HANDLE(anv_device, anv_device, device);
+          return anv_device->dispatch.vkGetPastPresentationTimingGOOGLE(device, swapchain, pPresentationTimingCount, pPresentationTimings);
+      }
       void __attribute__ ((weak))
       anv_GetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements)
       {
@@ -2511,6 +2527,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
     .vkUpdateDescriptorSetWithTemplate = anv_UpdateDescriptorSetWithTemplate,
     .vkUpdateDescriptorSetWithTemplateKHR = anv_UpdateDescriptorSetWithTemplate,
     .vkCmdPushDescriptorSetWithTemplateKHR = anv_CmdPushDescriptorSetWithTemplateKHR,
+    .vkGetRefreshCycleDurationGOOGLE = anv_GetRefreshCycleDurationGOOGLE,
+    .vkGetPastPresentationTimingGOOGLE = anv_GetPastPresentationTimingGOOGLE,
     .vkGetBufferMemoryRequirements2 = anv_GetBufferMemoryRequirements2,
     .vkGetBufferMemoryRequirements2KHR = anv_GetBufferMemoryRequirements2,
     .vkGetImageMemoryRequirements2 = anv_GetImageMemoryRequirements2,
@@ -2712,6 +2730,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
             void gen7_DestroyDescriptorUpdateTemplate(VkDevice device, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const VkAllocationCallbacks* pAllocator) __attribute__ ((weak));
             void gen7_UpdateDescriptorSetWithTemplate(VkDevice device, VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const void* pData) __attribute__ ((weak));
             void gen7_CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer, VkDescriptorUpdateTemplate descriptorUpdateTemplate, VkPipelineLayout layout, uint32_t set, const void* pData) __attribute__ ((weak));
+      VkResult gen7_GetRefreshCycleDurationGOOGLE(VkDevice device, VkSwapchainKHR swapchain, VkRefreshCycleDurationGOOGLE* pDisplayTimingProperties) __attribute__ ((weak));
+      VkResult gen7_GetPastPresentationTimingGOOGLE(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pPresentationTimingCount, VkPastPresentationTimingGOOGLE* pPresentationTimings) __attribute__ ((weak));
       void gen7_GetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen7_GetImageMemoryRequirements2(VkDevice device, const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen7_GetImageSparseMemoryRequirements2(VkDevice device, const VkImageSparseMemoryRequirementsInfo2* pInfo, uint32_t* pSparseMemoryRequirementCount, VkSparseImageMemoryRequirements2* pSparseMemoryRequirements) __attribute__ ((weak));
@@ -2917,6 +2937,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
     .vkUpdateDescriptorSetWithTemplate = gen7_UpdateDescriptorSetWithTemplate,
     .vkUpdateDescriptorSetWithTemplateKHR = gen7_UpdateDescriptorSetWithTemplate,
     .vkCmdPushDescriptorSetWithTemplateKHR = gen7_CmdPushDescriptorSetWithTemplateKHR,
+    .vkGetRefreshCycleDurationGOOGLE = gen7_GetRefreshCycleDurationGOOGLE,
+    .vkGetPastPresentationTimingGOOGLE = gen7_GetPastPresentationTimingGOOGLE,
     .vkGetBufferMemoryRequirements2 = gen7_GetBufferMemoryRequirements2,
     .vkGetBufferMemoryRequirements2KHR = gen7_GetBufferMemoryRequirements2,
     .vkGetImageMemoryRequirements2 = gen7_GetImageMemoryRequirements2,
@@ -3118,6 +3140,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
             void gen75_DestroyDescriptorUpdateTemplate(VkDevice device, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const VkAllocationCallbacks* pAllocator) __attribute__ ((weak));
             void gen75_UpdateDescriptorSetWithTemplate(VkDevice device, VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const void* pData) __attribute__ ((weak));
             void gen75_CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer, VkDescriptorUpdateTemplate descriptorUpdateTemplate, VkPipelineLayout layout, uint32_t set, const void* pData) __attribute__ ((weak));
+      VkResult gen75_GetRefreshCycleDurationGOOGLE(VkDevice device, VkSwapchainKHR swapchain, VkRefreshCycleDurationGOOGLE* pDisplayTimingProperties) __attribute__ ((weak));
+      VkResult gen75_GetPastPresentationTimingGOOGLE(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pPresentationTimingCount, VkPastPresentationTimingGOOGLE* pPresentationTimings) __attribute__ ((weak));
       void gen75_GetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen75_GetImageMemoryRequirements2(VkDevice device, const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen75_GetImageSparseMemoryRequirements2(VkDevice device, const VkImageSparseMemoryRequirementsInfo2* pInfo, uint32_t* pSparseMemoryRequirementCount, VkSparseImageMemoryRequirements2* pSparseMemoryRequirements) __attribute__ ((weak));
@@ -3323,6 +3347,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
     .vkUpdateDescriptorSetWithTemplate = gen75_UpdateDescriptorSetWithTemplate,
     .vkUpdateDescriptorSetWithTemplateKHR = gen75_UpdateDescriptorSetWithTemplate,
     .vkCmdPushDescriptorSetWithTemplateKHR = gen75_CmdPushDescriptorSetWithTemplateKHR,
+    .vkGetRefreshCycleDurationGOOGLE = gen75_GetRefreshCycleDurationGOOGLE,
+    .vkGetPastPresentationTimingGOOGLE = gen75_GetPastPresentationTimingGOOGLE,
     .vkGetBufferMemoryRequirements2 = gen75_GetBufferMemoryRequirements2,
     .vkGetBufferMemoryRequirements2KHR = gen75_GetBufferMemoryRequirements2,
     .vkGetImageMemoryRequirements2 = gen75_GetImageMemoryRequirements2,
@@ -3524,6 +3550,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
             void gen8_DestroyDescriptorUpdateTemplate(VkDevice device, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const VkAllocationCallbacks* pAllocator) __attribute__ ((weak));
             void gen8_UpdateDescriptorSetWithTemplate(VkDevice device, VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const void* pData) __attribute__ ((weak));
             void gen8_CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer, VkDescriptorUpdateTemplate descriptorUpdateTemplate, VkPipelineLayout layout, uint32_t set, const void* pData) __attribute__ ((weak));
+      VkResult gen8_GetRefreshCycleDurationGOOGLE(VkDevice device, VkSwapchainKHR swapchain, VkRefreshCycleDurationGOOGLE* pDisplayTimingProperties) __attribute__ ((weak));
+      VkResult gen8_GetPastPresentationTimingGOOGLE(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pPresentationTimingCount, VkPastPresentationTimingGOOGLE* pPresentationTimings) __attribute__ ((weak));
       void gen8_GetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen8_GetImageMemoryRequirements2(VkDevice device, const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen8_GetImageSparseMemoryRequirements2(VkDevice device, const VkImageSparseMemoryRequirementsInfo2* pInfo, uint32_t* pSparseMemoryRequirementCount, VkSparseImageMemoryRequirements2* pSparseMemoryRequirements) __attribute__ ((weak));
@@ -3729,6 +3757,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
     .vkUpdateDescriptorSetWithTemplate = gen8_UpdateDescriptorSetWithTemplate,
     .vkUpdateDescriptorSetWithTemplateKHR = gen8_UpdateDescriptorSetWithTemplate,
     .vkCmdPushDescriptorSetWithTemplateKHR = gen8_CmdPushDescriptorSetWithTemplateKHR,
+    .vkGetRefreshCycleDurationGOOGLE = gen8_GetRefreshCycleDurationGOOGLE,
+    .vkGetPastPresentationTimingGOOGLE = gen8_GetPastPresentationTimingGOOGLE,
     .vkGetBufferMemoryRequirements2 = gen8_GetBufferMemoryRequirements2,
     .vkGetBufferMemoryRequirements2KHR = gen8_GetBufferMemoryRequirements2,
     .vkGetImageMemoryRequirements2 = gen8_GetImageMemoryRequirements2,
@@ -3930,6 +3960,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
             void gen9_DestroyDescriptorUpdateTemplate(VkDevice device, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const VkAllocationCallbacks* pAllocator) __attribute__ ((weak));
             void gen9_UpdateDescriptorSetWithTemplate(VkDevice device, VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const void* pData) __attribute__ ((weak));
             void gen9_CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer, VkDescriptorUpdateTemplate descriptorUpdateTemplate, VkPipelineLayout layout, uint32_t set, const void* pData) __attribute__ ((weak));
+      VkResult gen9_GetRefreshCycleDurationGOOGLE(VkDevice device, VkSwapchainKHR swapchain, VkRefreshCycleDurationGOOGLE* pDisplayTimingProperties) __attribute__ ((weak));
+      VkResult gen9_GetPastPresentationTimingGOOGLE(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pPresentationTimingCount, VkPastPresentationTimingGOOGLE* pPresentationTimings) __attribute__ ((weak));
       void gen9_GetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen9_GetImageMemoryRequirements2(VkDevice device, const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen9_GetImageSparseMemoryRequirements2(VkDevice device, const VkImageSparseMemoryRequirementsInfo2* pInfo, uint32_t* pSparseMemoryRequirementCount, VkSparseImageMemoryRequirements2* pSparseMemoryRequirements) __attribute__ ((weak));
@@ -4135,6 +4167,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
     .vkUpdateDescriptorSetWithTemplate = gen9_UpdateDescriptorSetWithTemplate,
     .vkUpdateDescriptorSetWithTemplateKHR = gen9_UpdateDescriptorSetWithTemplate,
     .vkCmdPushDescriptorSetWithTemplateKHR = gen9_CmdPushDescriptorSetWithTemplateKHR,
+    .vkGetRefreshCycleDurationGOOGLE = gen9_GetRefreshCycleDurationGOOGLE,
+    .vkGetPastPresentationTimingGOOGLE = gen9_GetPastPresentationTimingGOOGLE,
     .vkGetBufferMemoryRequirements2 = gen9_GetBufferMemoryRequirements2,
     .vkGetBufferMemoryRequirements2KHR = gen9_GetBufferMemoryRequirements2,
     .vkGetImageMemoryRequirements2 = gen9_GetImageMemoryRequirements2,
@@ -4336,6 +4370,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
             void gen10_DestroyDescriptorUpdateTemplate(VkDevice device, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const VkAllocationCallbacks* pAllocator) __attribute__ ((weak));
             void gen10_UpdateDescriptorSetWithTemplate(VkDevice device, VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const void* pData) __attribute__ ((weak));
             void gen10_CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer, VkDescriptorUpdateTemplate descriptorUpdateTemplate, VkPipelineLayout layout, uint32_t set, const void* pData) __attribute__ ((weak));
+      VkResult gen10_GetRefreshCycleDurationGOOGLE(VkDevice device, VkSwapchainKHR swapchain, VkRefreshCycleDurationGOOGLE* pDisplayTimingProperties) __attribute__ ((weak));
+      VkResult gen10_GetPastPresentationTimingGOOGLE(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pPresentationTimingCount, VkPastPresentationTimingGOOGLE* pPresentationTimings) __attribute__ ((weak));
       void gen10_GetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen10_GetImageMemoryRequirements2(VkDevice device, const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen10_GetImageSparseMemoryRequirements2(VkDevice device, const VkImageSparseMemoryRequirementsInfo2* pInfo, uint32_t* pSparseMemoryRequirementCount, VkSparseImageMemoryRequirements2* pSparseMemoryRequirements) __attribute__ ((weak));
@@ -4541,6 +4577,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
     .vkUpdateDescriptorSetWithTemplate = gen10_UpdateDescriptorSetWithTemplate,
     .vkUpdateDescriptorSetWithTemplateKHR = gen10_UpdateDescriptorSetWithTemplate,
     .vkCmdPushDescriptorSetWithTemplateKHR = gen10_CmdPushDescriptorSetWithTemplateKHR,
+    .vkGetRefreshCycleDurationGOOGLE = gen10_GetRefreshCycleDurationGOOGLE,
+    .vkGetPastPresentationTimingGOOGLE = gen10_GetPastPresentationTimingGOOGLE,
     .vkGetBufferMemoryRequirements2 = gen10_GetBufferMemoryRequirements2,
     .vkGetBufferMemoryRequirements2KHR = gen10_GetBufferMemoryRequirements2,
     .vkGetImageMemoryRequirements2 = gen10_GetImageMemoryRequirements2,
@@ -4742,6 +4780,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
             void gen11_DestroyDescriptorUpdateTemplate(VkDevice device, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const VkAllocationCallbacks* pAllocator) __attribute__ ((weak));
             void gen11_UpdateDescriptorSetWithTemplate(VkDevice device, VkDescriptorSet descriptorSet, VkDescriptorUpdateTemplate descriptorUpdateTemplate, const void* pData) __attribute__ ((weak));
             void gen11_CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer, VkDescriptorUpdateTemplate descriptorUpdateTemplate, VkPipelineLayout layout, uint32_t set, const void* pData) __attribute__ ((weak));
+      VkResult gen11_GetRefreshCycleDurationGOOGLE(VkDevice device, VkSwapchainKHR swapchain, VkRefreshCycleDurationGOOGLE* pDisplayTimingProperties) __attribute__ ((weak));
+      VkResult gen11_GetPastPresentationTimingGOOGLE(VkDevice device, VkSwapchainKHR swapchain, uint32_t* pPresentationTimingCount, VkPastPresentationTimingGOOGLE* pPresentationTimings) __attribute__ ((weak));
       void gen11_GetBufferMemoryRequirements2(VkDevice device, const VkBufferMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen11_GetImageMemoryRequirements2(VkDevice device, const VkImageMemoryRequirementsInfo2* pInfo, VkMemoryRequirements2* pMemoryRequirements) __attribute__ ((weak));
             void gen11_GetImageSparseMemoryRequirements2(VkDevice device, const VkImageSparseMemoryRequirementsInfo2* pInfo, uint32_t* pSparseMemoryRequirementCount, VkSparseImageMemoryRequirements2* pSparseMemoryRequirements) __attribute__ ((weak));
@@ -4947,6 +4987,8 @@ const struct anv_instance_dispatch_table anv_instance_dispatch_table = {
     .vkUpdateDescriptorSetWithTemplate = gen11_UpdateDescriptorSetWithTemplate,
     .vkUpdateDescriptorSetWithTemplateKHR = gen11_UpdateDescriptorSetWithTemplate,
     .vkCmdPushDescriptorSetWithTemplateKHR = gen11_CmdPushDescriptorSetWithTemplateKHR,
+    .vkGetRefreshCycleDurationGOOGLE = gen11_GetRefreshCycleDurationGOOGLE,
+    .vkGetPastPresentationTimingGOOGLE = gen11_GetPastPresentationTimingGOOGLE,
     .vkGetBufferMemoryRequirements2 = gen11_GetBufferMemoryRequirements2,
     .vkGetBufferMemoryRequirements2KHR = gen11_GetBufferMemoryRequirements2,
     .vkGetImageMemoryRequirements2 = gen11_GetImageMemoryRequirements2,
@@ -5810,135 +5852,143 @@ anv_device_entrypoint_is_enabled(int index, uint32_t core_version,
       if (!device || device->KHR_descriptor_update_template) return true;
       return false;
    case 162:
+      /* vkGetRefreshCycleDurationGOOGLE */
+      if (!device || device->GOOGLE_display_timing) return true;
+      return false;
+   case 163:
+      /* vkGetPastPresentationTimingGOOGLE */
+      if (!device || device->GOOGLE_display_timing) return true;
+      return false;
+   case 164:
       /* vkGetBufferMemoryRequirements2 */
       return VK_MAKE_VERSION(1, 1, 0) <= core_version;
-   case 163:
+   case 165:
       /* vkGetBufferMemoryRequirements2KHR */
       if (!device || device->KHR_get_memory_requirements2) return true;
       return false;
-   case 164:
+   case 166:
       /* vkGetImageMemoryRequirements2 */
       return VK_MAKE_VERSION(1, 1, 0) <= core_version;
-   case 165:
+   case 167:
       /* vkGetImageMemoryRequirements2KHR */
       if (!device || device->KHR_get_memory_requirements2) return true;
       return false;
-   case 166:
+   case 168:
       /* vkGetImageSparseMemoryRequirements2 */
       return VK_MAKE_VERSION(1, 1, 0) <= core_version;
-   case 167:
+   case 169:
       /* vkGetImageSparseMemoryRequirements2KHR */
       if (!device || device->KHR_get_memory_requirements2) return true;
       return false;
-   case 168:
+   case 170:
       /* vkCreateSamplerYcbcrConversion */
       return VK_MAKE_VERSION(1, 1, 0) <= core_version;
-   case 169:
+   case 171:
       /* vkCreateSamplerYcbcrConversionKHR */
       if (!device || device->KHR_sampler_ycbcr_conversion) return true;
       return false;
-   case 170:
+   case 172:
       /* vkDestroySamplerYcbcrConversion */
       return VK_MAKE_VERSION(1, 1, 0) <= core_version;
-   case 171:
+   case 173:
       /* vkDestroySamplerYcbcrConversionKHR */
       if (!device || device->KHR_sampler_ycbcr_conversion) return true;
       return false;
-   case 172:
+   case 174:
       /* vkGetDeviceQueue2 */
       return VK_MAKE_VERSION(1, 1, 0) <= core_version;
-   case 173:
+   case 175:
       /* vkGetDescriptorSetLayoutSupport */
       return VK_MAKE_VERSION(1, 1, 0) <= core_version;
-   case 174:
+   case 176:
       /* vkGetDescriptorSetLayoutSupportKHR */
       if (!device || device->KHR_maintenance3) return true;
       return false;
-   case 175:
+   case 177:
       /* vkGetSwapchainGrallocUsageANDROID */
       if (!device || device->ANDROID_native_buffer) return true;
       return false;
-   case 176:
+   case 178:
       /* vkAcquireImageANDROID */
       if (!device || device->ANDROID_native_buffer) return true;
       return false;
-   case 177:
+   case 179:
       /* vkQueueSignalReleaseImageANDROID */
       if (!device || device->ANDROID_native_buffer) return true;
       return false;
-   case 178:
+   case 180:
       /* vkGetCalibratedTimestampsEXT */
       if (!device || device->EXT_calibrated_timestamps) return true;
       return false;
-   case 179:
+   case 181:
       /* vkGetMemoryHostPointerPropertiesEXT */
       if (!device || device->EXT_external_memory_host) return true;
       return false;
-   case 180:
+   case 182:
       /* vkCreateRenderPass2KHR */
       if (!device || device->KHR_create_renderpass2) return true;
       return false;
-   case 181:
+   case 183:
       /* vkCmdBeginRenderPass2KHR */
       if (!device || device->KHR_create_renderpass2) return true;
       return false;
-   case 182:
+   case 184:
       /* vkCmdNextSubpass2KHR */
       if (!device || device->KHR_create_renderpass2) return true;
       return false;
-   case 183:
+   case 185:
       /* vkCmdEndRenderPass2KHR */
       if (!device || device->KHR_create_renderpass2) return true;
       return false;
-   case 184:
+   case 186:
       /* vkGetAndroidHardwareBufferPropertiesANDROID */
       if (!device || device->ANDROID_external_memory_android_hardware_buffer) return true;
       return false;
-   case 185:
+   case 187:
       /* vkGetMemoryAndroidHardwareBufferANDROID */
       if (!device || device->ANDROID_external_memory_android_hardware_buffer) return true;
       return false;
-   case 186:
+   case 188:
       /* vkCmdDrawIndirectCountKHR */
       if (!device || device->KHR_draw_indirect_count) return true;
       return false;
-   case 187:
+   case 189:
       /* vkCmdDrawIndexedIndirectCountKHR */
       if (!device || device->KHR_draw_indirect_count) return true;
       return false;
-   case 188:
+   case 190:
       /* vkCmdBindTransformFeedbackBuffersEXT */
       if (!device || device->EXT_transform_feedback) return true;
       return false;
-   case 189:
+   case 191:
       /* vkCmdBeginTransformFeedbackEXT */
       if (!device || device->EXT_transform_feedback) return true;
       return false;
-   case 190:
+   case 192:
       /* vkCmdEndTransformFeedbackEXT */
       if (!device || device->EXT_transform_feedback) return true;
       return false;
-   case 191:
+   case 193:
       /* vkCmdBeginQueryIndexedEXT */
       if (!device || device->EXT_transform_feedback) return true;
       return false;
-   case 192:
+   case 194:
       /* vkCmdEndQueryIndexedEXT */
       if (!device || device->EXT_transform_feedback) return true;
       return false;
-   case 193:
+   case 195:
       /* vkCmdDrawIndirectByteCountEXT */
       if (!device || device->EXT_transform_feedback) return true;
       return false;
-   case 194:
+   case 196:
       /* vkGetBufferDeviceAddressEXT */
       if (!device || device->EXT_buffer_device_address) return true;
       return false;
-   case 195:
+   case 197:
       /* vkGetDeviceGroupSurfacePresentModes2EXT */
       if (!device || device->KHR_device_group) return true;
       return false;
-   case 196:
+   case 198:
       /* vkCreateDmaBufImageINTEL */
       return true;
    default:
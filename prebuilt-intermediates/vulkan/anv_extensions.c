@@ -203,6 +203,7 @@ const VkExtensionProperties anv_device_extensions[ANV_DEVICE_EXTENSION_COUNT] =
    {"VK_ANDROID_external_memory_android_hardware_buffer", 3},
    {"VK_ANDROID_native_buffer", 5},
    {"VK_GOOGLE_decorate_string", 1},
+   {"VK_GOOGLE_display_timing", 1},
    {"VK_GOOGLE_hlsl_functionality1", 1},
    {"VK_NV_compute_shader_derivatives", 1},
 };
@@ -271,6 +272,7 @@ anv_physical_device_get_supported_extensions(const struct anv_physical_device *d
       .ANDROID_external_memory_android_hardware_buffer = ANDROID,
       .ANDROID_native_buffer = ANDROID,
       .GOOGLE_decorate_string = true,
+      .GOOGLE_display_timing = ANV_HAS_SURFACE,
       .GOOGLE_hlsl_functionality1 = true,
       .NV_compute_shader_derivatives = true,
    };
@@ -60,7 +60,7 @@ struct anv_instance_extension_table {
 extern const struct anv_instance_extension_table anv_instance_extensions_supported;
 
 
-#define ANV_DEVICE_EXTENSION_COUNT 61
+#define ANV_DEVICE_EXTENSION_COUNT 62
 
 extern const VkExtensionProperties anv_device_extensions[];
 
@@ -127,6 +127,7 @@ struct anv_device_extension_table {
         bool ANDROID_external_memory_android_hardware_buffer;
         bool ANDROID_native_buffer;
         bool GOOGLE_decorate_string;
+        bool GOOGLE_display_timing;
         bool GOOGLE_hlsl_functionality1;
         bool NV_compute_shader_derivatives;
       };
@@ -176,7 +176,7 @@ static LLVMTargetMachineRef ac_create_target_machine(enum radeon_family family,
 }
 
 static LLVMPassManagerRef ac_create_passmgr(LLVMTargetLibraryInfoRef target_library_info,
-					    bool check_ir)
+					    bool check_ir, bool low_opt)
 {
 	LLVMPassManagerRef passmgr = LLVMCreatePassManager();
 	if (!passmgr)
@@ -198,6 +198,16 @@ static LLVMPassManagerRef ac_create_passmgr(LLVMTargetLibraryInfoRef target_libr
 	ac_llvm_add_barrier_noop_pass(passmgr);
 	/* This pass should eliminate all the load and store instructions. */
 	LLVMAddPromoteMemoryToRegisterPass(passmgr);
+
+	/* Only do the cheap clean-ups when compile time matters more than
+	 * the quality of the code. The backend has its own CSE and DCE.
+	 */
+	if (low_opt) {
+		LLVMAddEarlyCSEMemSSAPass(passmgr);
+		LLVMAddCFGSimplificationPass(passmgr);
+		return passmgr;
+	}
+
 	LLVMAddScalarReplAggregatesPass(passmgr);
 	LLVMAddLICMPass(passmgr);
 	LLVMAddAggressiveDCEPass(passmgr);
@@ -328,10 +338,18 @@ ac_init_llvm_compiler(struct ac_llvm_compiler *compiler,
 		goto fail;
 
 	compiler->passmgr = ac_create_passmgr(compiler->target_library_info,
-					      tm_options & AC_TM_CHECK_IR);
+					      tm_options & AC_TM_CHECK_IR, false);
 	if (!compiler->passmgr)
 		goto fail;
 
+	if (tm_options & AC_TM_CREATE_LOW_OPT) {
+		compiler->low_opt_passmgr =
+			ac_create_passmgr(compiler->target_library_info,
+					  tm_options & AC_TM_CHECK_IR, true);
+		if (!compiler->low_opt_passmgr)
+			goto fail;
+	}
+
 	return true;
 fail:
 	ac_destroy_llvm_compiler(compiler);
@@ -343,6 +361,8 @@ ac_destroy_llvm_compiler(struct ac_llvm_compiler *compiler)
 {
 	if (compiler->passmgr)
 		LLVMDisposePassManager(compiler->passmgr);
+	if (compiler->low_opt_passmgr)
+		LLVMDisposePassManager(compiler->low_opt_passmgr);
 	if (compiler->target_library_info)
 		ac_dispose_target_library_info(compiler->target_library_info);
 	if (compiler->low_opt_tm)
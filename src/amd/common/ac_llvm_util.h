@@ -88,6 +88,7 @@ struct ac_llvm_compiler {
 	 */
 	LLVMTargetMachineRef		low_opt_tm; /* uses -O1 instead of -O2 */
 	struct ac_compiler_passes	*low_opt_passes;
+	LLVMPassManagerRef		low_opt_passmgr; /* fewer IR passes */
 };
 
 const char *ac_get_llvm_processor_name(enum radeon_family family);
@@ -9176,6 +9176,9 @@
 #define    CIK_SDMA_PACKET_FENCE                   0x5
 #define    CIK_SDMA_PACKET_TRAP                    0x6
 #define    CIK_SDMA_PACKET_SEMAPHORE               0x7
+#define    CIK_SDMA_OPCODE_POLL_REGMEM             0x8
+#define        S_SDMA_POLL_REGMEM_FUNC(x)                 (((unsigned)(x) & 0x7) << 28)
+#define        S_SDMA_POLL_REGMEM_MEM(x)                  (((unsigned)(x) & 0x1) << 31)
 #define    CIK_SDMA_PACKET_CONSTANT_FILL           0xb
 #define    CIK_SDMA_OPCODE_TIMESTAMP               0xd
 #define        SDMA_TS_SUB_OPCODE_SET_LOCAL_TIMESTAMP     0x0
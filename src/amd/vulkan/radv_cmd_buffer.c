@@ -298,16 +298,76 @@ radv_cmd_buffer_destroy(struct radv_cmd_buffer *cmd_buffer)
 	vk_free(&cmd_buffer->pool->alloc, cmd_buffer);
 }
 
+static void
+radv_cmd_pool_put_upload(struct radv_device *device,
+			 struct radv_cmd_pool *pool,
+			 struct radv_cmd_buffer_upload *up)
+{
+	if (pool->num_upload_bos == RADV_CMD_POOL_MAX_UPLOAD_BOS) {
+		struct radv_cmd_buffer_upload *oldest =
+			list_last_entry(&pool->upload_bos,
+					struct radv_cmd_buffer_upload, list);
+
+		list_del(&oldest->list);
+		device->ws->buffer_destroy(oldest->upload_bo);
+		free(oldest);
+		pool->num_upload_bos--;
+	}
+
+	list_add(&up->list, &pool->upload_bos);
+	pool->num_upload_bos++;
+}
+
+static struct radv_cmd_buffer_upload *
+radv_cmd_pool_get_upload(struct radv_cmd_pool *pool, uint64_t min_size)
+{
+	struct radv_cmd_buffer_upload *best = NULL;
+
+	list_for_each_entry(struct radv_cmd_buffer_upload, up,
+			    &pool->upload_bos, list) {
+		if (up->size >= min_size && (!best || up->size < best->size))
+			best = up;
+	}
+
+	if (best) {
+		list_del(&best->list);
+		pool->num_upload_bos--;
+	}
+
+	return best;
+}
+
+static void
+radv_cmd_pool_free_uploads(struct radv_device *device,
+			   struct radv_cmd_pool *pool)
+{
+	list_for_each_entry_safe(struct radv_cmd_buffer_upload, up,
+				 &pool->upload_bos, list) {
+		device->ws->buffer_destroy(up->upload_bo);
+		list_del(&up->list);
+		free(up);
+	}
+	pool->num_upload_bos = 0;
+}
+
 static VkResult
 radv_reset_cmd_buffer(struct radv_cmd_buffer *cmd_buffer)
 {
 	cmd_buffer->device->ws->cs_reset(cmd_buffer->cs);
 
+	/* The command buffer can't be pending anymore, so its retired upload
+	 * buffers go to the pool for the next recordings to reuse.
+	 */
 	list_for_each_entry_safe(struct radv_cmd_buffer_upload, up,
 				 &cmd_buffer->upload.list, list) {
-		cmd_buffer->device->ws->buffer_destroy(up->upload_bo);
 		list_del(&up->list);
-		free(up);
+		if (cmd_buffer->pool) {
+			radv_cmd_pool_put_upload(cmd_buffer->device,
+						 cmd_buffer->pool, up);
+		} else {
+			cmd_buffer->device->ws->buffer_destroy(up->upload_bo);
+			free(up);
+		}
 	}
 
 	cmd_buffer->push_constant_stages = 0;
@@ -331,6 +391,8 @@ radv_reset_cmd_buffer(struct radv_cmd_buffer *cmd_buffer)
 		cmd_buffer->descriptors[i].dirty = 0;
 		cmd_buffer->descriptors[i].valid = 0;
 		cmd_buffer->descriptors[i].push_dirty = false;
+		cmd_buffer->descriptors[i].indirect_descriptor_sets_dirty = true;
+		cmd_buffer->descriptors[i].push_constants_dirty = true;
 	}
 
 	if (cmd_buffer->device->physical_device->rad_info.chip_class >= GFX9 &&
@@ -366,27 +428,39 @@ radv_cmd_buffer_resize_upload_buf(struct radv_cmd_buffer *cmd_buffer,
 	uint64_t new_size;
 	struct radeon_winsys_bo *bo;
 	struct radv_cmd_buffer_upload *upload;
+	struct radv_cmd_buffer_upload *cached = NULL;
 	struct radv_device *device = cmd_buffer->device;
+	uint8_t *map = NULL;
 
 	new_size = MAX2(min_needed, 16 * 1024);
 	new_size = MAX2(new_size, 2 * cmd_buffer->upload.size);
 
-	bo = device->ws->buffer_create(device->ws,
-				       new_size, 4096,
-				       RADEON_DOMAIN_GTT,
-				       RADEON_FLAG_CPU_ACCESS|
-				       RADEON_FLAG_NO_INTERPROCESS_SHARING |
-				       RADEON_FLAG_32BIT,
-				       RADV_BO_PRIORITY_UPLOAD_BUFFER);
+	if (cmd_buffer->pool)
+		cached = radv_cmd_pool_get_upload(cmd_buffer->pool, new_size);
 
-	if (!bo) {
-		cmd_buffer->record_result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
-		return false;
+	if (cached) {
+		bo = cached->upload_bo;
+		new_size = cached->size;
+		map = cached->map;
+	} else {
+		bo = device->ws->buffer_create(device->ws,
+					       new_size, 4096,
+					       RADEON_DOMAIN_GTT,
+					       RADEON_FLAG_CPU_ACCESS|
+					       RADEON_FLAG_NO_INTERPROCESS_SHARING |
+					       RADEON_FLAG_32BIT,
+					       RADV_BO_PRIORITY_UPLOAD_BUFFER);
+
+		if (!bo) {
+			cmd_buffer->record_result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+			return false;
+		}
 	}
 
 	radv_cs_add_buffer(device->ws, cmd_buffer->cs, bo);
 	if (cmd_buffer->upload.upload_bo) {
-		upload = malloc(sizeof(*upload));
+		/* Reuse the entry of the cached buffer for the current one. */
+		upload = cached ? cached : malloc(sizeof(*upload));
 
 		if (!upload) {
 			cmd_buffer->record_result = VK_ERROR_OUT_OF_HOST_MEMORY;
@@ -396,12 +470,14 @@ radv_cmd_buffer_resize_upload_buf(struct radv_cmd_buffer *cmd_buffer,
 
 		memcpy(upload, &cmd_buffer->upload, sizeof(*upload));
 		list_add(&upload->list, &cmd_buffer->upload.list);
+	} else {
+		free(cached);
 	}
 
 	cmd_buffer->upload.upload_bo = bo;
 	cmd_buffer->upload.size = new_size;
 	cmd_buffer->upload.offset = 0;
-	cmd_buffer->upload.map = device->ws->buffer_map(cmd_buffer->upload.upload_bo);
+	cmd_buffer->upload.map = map ? map : device->ws->buffer_map(cmd_buffer->upload.upload_bo);
 
 	if (!cmd_buffer->upload.map) {
 		cmd_buffer->record_result = VK_ERROR_OUT_OF_DEVICE_MEMORY;
@@ -550,6 +626,7 @@ void radv_set_descriptor_set(struct radv_cmd_buffer *cmd_buffer,
 
 	descriptors_state->valid |= (1u << idx); /* active descriptors */
 	descriptors_state->dirty |= (1u << idx);
+	descriptors_state->indirect_descriptor_sets_dirty = true;
 }
 
 static void
@@ -1805,22 +1882,34 @@ radv_flush_indirect_descriptor_sets(struct radv_cmd_buffer *cmd_buffer,
 	uint32_t size = MAX_SETS * 4;
 	uint32_t offset;
 	void *ptr;
-	
-	if (!radv_cmd_buffer_upload_alloc(cmd_buffer, size,
-					  256, &offset, &ptr))
-		return;
+	uint64_t va;
 
-	for (unsigned i = 0; i < MAX_SETS; i++) {
-		uint32_t *uptr = ((uint32_t *)ptr) + i;
-		uint64_t set_va = 0;
-		struct radv_descriptor_set *set = descriptors_state->sets[i];
-		if (descriptors_state->valid & (1u << i))
-			set_va = set->va;
-		uptr[0] = set_va & 0xffffffff;
-	}
+	/* Only upload the pointers again when a set changed, a new pipeline
+	 * can use the previous upload.
+	 */
+	if (descriptors_state->indirect_descriptor_sets_dirty ||
+	    descriptors_state->push_dirty) {
+		if (!radv_cmd_buffer_upload_alloc(cmd_buffer, size,
+						  256, &offset, &ptr))
+			return;
+
+		for (unsigned i = 0; i < MAX_SETS; i++) {
+			uint32_t *uptr = ((uint32_t *)ptr) + i;
+			uint64_t set_va = 0;
+			struct radv_descriptor_set *set = descriptors_state->sets[i];
+			if (descriptors_state->valid & (1u << i))
+				set_va = set->va;
+			uptr[0] = set_va & 0xffffffff;
+		}
 
-	uint64_t va = radv_buffer_get_va(cmd_buffer->upload.upload_bo);
-	va += offset;
+		va = radv_buffer_get_va(cmd_buffer->upload.upload_bo);
+		va += offset;
+
+		descriptors_state->indirect_descriptor_sets_va = va;
+		descriptors_state->indirect_descriptor_sets_dirty = false;
+	} else {
+		va = descriptors_state->indirect_descriptor_sets_va;
+	}
 
 	if (cmd_buffer->state.pipeline) {
 		if (cmd_buffer->state.pipeline->shaders[MESA_SHADER_VERTEX])
@@ -1949,18 +2038,32 @@ radv_flush_constants(struct radv_cmd_buffer *cmd_buffer,
 	}
 
 	if (need_push_constants) {
-		if (!radv_cmd_buffer_upload_alloc(cmd_buffer, layout->push_constant_size +
-						  16 * layout->dynamic_offset_count,
-						  256, &offset, &ptr))
-			return;
-
-		memcpy(ptr, cmd_buffer->push_constants, layout->push_constant_size);
-		memcpy((char*)ptr + layout->push_constant_size,
-		       descriptors_state->dynamic_buffers,
-		       16 * layout->dynamic_offset_count);
-
-		va = radv_buffer_get_va(cmd_buffer->upload.upload_bo);
-		va += offset;
+		/* Reuse the previous upload if neither the values nor the way
+		 * the layout places them changed.
+		 */
+		if (descriptors_state->push_constants_dirty ||
+		    descriptors_state->push_constants_size != layout->push_constant_size ||
+		    descriptors_state->push_constants_dynamic_offset_count != layout->dynamic_offset_count) {
+			if (!radv_cmd_buffer_upload_alloc(cmd_buffer, layout->push_constant_size +
+							  16 * layout->dynamic_offset_count,
+							  256, &offset, &ptr))
+				return;
+
+			memcpy(ptr, cmd_buffer->push_constants, layout->push_constant_size);
+			memcpy((char*)ptr + layout->push_constant_size,
+			       descriptors_state->dynamic_buffers,
+			       16 * layout->dynamic_offset_count);
+
+			va = radv_buffer_get_va(cmd_buffer->upload.upload_bo);
+			va += offset;
+
+			descriptors_state->push_constants_va = va;
+			descriptors_state->push_constants_size = layout->push_constant_size;
+			descriptors_state->push_constants_dynamic_offset_count = layout->dynamic_offset_count;
+			descriptors_state->push_constants_dirty = false;
+		} else {
+			va = descriptors_state->push_constants_va;
+		}
 
 		MAYBE_UNUSED unsigned cdw_max =
 			radeon_check_space(cmd_buffer->device->ws,
@@ -2661,7 +2764,8 @@ VkResult radv_BeginCommandBuffer(
 		radv_cmd_buffer_set_subpass(cmd_buffer, subpass);
 	}
 
-	if (unlikely(cmd_buffer->device->trace_bo)) {
+	if (unlikely(cmd_buffer->device->trace_bo) &&
+	    cmd_buffer->queue_family_index != RADV_QUEUE_TRANSFER) {
 		struct radv_device *device = cmd_buffer->device;
 
 		radv_cs_add_buffer(device->ws, cmd_buffer->cs,
@@ -2806,6 +2910,7 @@ void radv_CmdBindDescriptorSets(
 			         S_008F0C_DATA_FORMAT(V_008F0C_BUF_DATA_FORMAT_32);
 			cmd_buffer->push_constant_stages |=
 			                     set->layout->dynamic_shader_stages;
+			descriptors_state->push_constants_dirty = true;
 		}
 	}
 }
@@ -2939,6 +3044,7 @@ void radv_CmdPushConstants(VkCommandBuffer commandBuffer,
 {
 	RADV_FROM_HANDLE(radv_cmd_buffer, cmd_buffer, commandBuffer);
 	memcpy(cmd_buffer->push_constants + offset, pValues, size);
+	radv_invalidate_push_constants(cmd_buffer);
 	cmd_buffer->push_constant_stages |= stageFlags;
 }
 
@@ -3272,6 +3378,7 @@ void radv_CmdExecuteCommands(
 	const VkCommandBuffer*                      pCmdBuffers)
 {
 	RADV_FROM_HANDLE(radv_cmd_buffer, primary, commandBuffer);
+	bool emitted_graphics = false, emitted_compute = false;
 
 	assert(commandBufferCount > 0);
 
@@ -3295,6 +3402,9 @@ void radv_CmdExecuteCommands(
 		if (secondary->sample_positions_needed)
 			primary->sample_positions_needed = true;
 
+		/* With IB BOs, the secondary is executed by reference as an
+		 * IB2, so this doesn't depend on how much it recorded.
+		 */
 		primary->device->ws->cs_execute_secondary(primary->cs, secondary->cs);
 
 
@@ -3304,6 +3414,7 @@ void radv_CmdExecuteCommands(
 		if (secondary->state.emitted_pipeline) {
 			primary->state.emitted_pipeline =
 				secondary->state.emitted_pipeline;
+			emitted_graphics = true;
 		}
 
 		/* When the secondary command buffer is graphics only we don't
@@ -3312,6 +3423,7 @@ void radv_CmdExecuteCommands(
 		if (secondary->state.emitted_compute_pipeline) {
 			primary->state.emitted_compute_pipeline =
 				secondary->state.emitted_compute_pipeline;
+			emitted_compute = true;
 		}
 
 		/* Only re-emit the draw packets when needed. */
@@ -3341,13 +3453,19 @@ void radv_CmdExecuteCommands(
 	}
 
 	/* After executing commands from secondary buffers we have to dirty
-	 * some states.
+	 * the states they may have overwritten. Draws and dispatches, which
+	 * are the only commands emitting those states, always emit their
+	 * pipeline first, so secondaries that didn't emit a pipeline of a
+	 * bind point left its states alone.
 	 */
-	primary->state.dirty |= RADV_CMD_DIRTY_PIPELINE |
-				RADV_CMD_DIRTY_INDEX_BUFFER |
-				RADV_CMD_DIRTY_DYNAMIC_ALL;
-	radv_mark_descriptor_sets_dirty(primary, VK_PIPELINE_BIND_POINT_GRAPHICS);
-	radv_mark_descriptor_sets_dirty(primary, VK_PIPELINE_BIND_POINT_COMPUTE);
+	if (emitted_graphics) {
+		primary->state.dirty |= RADV_CMD_DIRTY_PIPELINE |
+					RADV_CMD_DIRTY_INDEX_BUFFER |
+					RADV_CMD_DIRTY_DYNAMIC_ALL;
+		radv_mark_descriptor_sets_dirty(primary, VK_PIPELINE_BIND_POINT_GRAPHICS);
+	}
+	if (emitted_compute)
+		radv_mark_descriptor_sets_dirty(primary, VK_PIPELINE_BIND_POINT_COMPUTE);
 }
 
 VkResult radv_CreateCommandPool(
@@ -3371,6 +3489,8 @@ VkResult radv_CreateCommandPool(
 
 	list_inithead(&pool->cmd_buffers);
 	list_inithead(&pool->free_cmd_buffers);
+	list_inithead(&pool->upload_bos);
+	pool->num_upload_bos = 0;
 
 	pool->queue_family_index = pCreateInfo->queueFamilyIndex;
 
@@ -3401,14 +3521,17 @@ void radv_DestroyCommandPool(
 		radv_cmd_buffer_destroy(cmd_buffer);
 	}
 
+	radv_cmd_pool_free_uploads(device, pool);
+
 	vk_free2(&device->alloc, pAllocator, pool);
 }
 
 VkResult radv_ResetCommandPool(
-	VkDevice                                    device,
+	VkDevice                                    _device,
 	VkCommandPool                               commandPool,
 	VkCommandPoolResetFlags                     flags)
 {
+	RADV_FROM_HANDLE(radv_device, device, _device);
 	RADV_FROM_HANDLE(radv_cmd_pool, pool, commandPool);
 	VkResult result;
 
@@ -3419,14 +3542,18 @@ VkResult radv_ResetCommandPool(
 			return result;
 	}
 
+	if (flags & VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT)
+		radv_cmd_pool_free_uploads(device, pool);
+
 	return VK_SUCCESS;
 }
 
 void radv_TrimCommandPool(
-    VkDevice                                    device,
+    VkDevice                                    _device,
     VkCommandPool                               commandPool,
     VkCommandPoolTrimFlags                      flags)
 {
+	RADV_FROM_HANDLE(radv_device, device, _device);
 	RADV_FROM_HANDLE(radv_cmd_pool, pool, commandPool);
 
 	if (!pool)
@@ -3436,6 +3563,8 @@ void radv_TrimCommandPool(
 				 &pool->free_cmd_buffers, pool_link) {
 		radv_cmd_buffer_destroy(cmd_buffer);
 	}
+
+	radv_cmd_pool_free_uploads(device, pool);
 }
 
 static uint32_t
@@ -4720,6 +4849,21 @@ radv_barrier(struct radv_cmd_buffer *cmd_buffer,
 	enum radv_cmd_flush_bits src_flush_bits = 0;
 	enum radv_cmd_flush_bits dst_flush_bits = 0;
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		/* SDMA executes packets in order and has no caches, so only
+		 * the event waits have to be emitted. Images usable on the
+		 * transfer queue are linear and don't need transitions.
+		 */
+		for (unsigned i = 0; i < info->eventCount; ++i) {
+			RADV_FROM_HANDLE(radv_event, event, info->pEvents[i]);
+
+			radv_cs_add_buffer(cmd_buffer->device->ws, cs, event->bo);
+			radv_sdma_wait_mem(cmd_buffer, radv_buffer_get_va(event->bo),
+					   1, 0xffffffff);
+		}
+		return;
+	}
+
 	for (unsigned i = 0; i < info->eventCount; ++i) {
 		RADV_FROM_HANDLE(radv_event, event, info->pEvents[i]);
 		uint64_t va = radv_buffer_get_va(event->bo);
@@ -4824,6 +4968,12 @@ static void write_event(struct radv_cmd_buffer *cmd_buffer,
 	struct radeon_cmdbuf *cs = cmd_buffer->cs;
 	uint64_t va = radv_buffer_get_va(event->bo);
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		radv_cs_add_buffer(cmd_buffer->device->ws, cs, event->bo);
+		radv_sdma_write_data(cmd_buffer, va, 1, &value);
+		return;
+	}
+
 	si_emit_cache_flush(cmd_buffer);
 
 	radv_cs_add_buffer(cmd_buffer->device->ws, cs, event->bo);
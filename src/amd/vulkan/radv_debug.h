@@ -52,6 +52,8 @@ enum {
 	RADV_DEBUG_NOTHREADLLVM      = 0x400000,
 	RADV_DEBUG_NOBINNING         = 0x800000,
 	RADV_DEBUG_NO_LOAD_STORE_OPT = 0x1000000,
+	RADV_DEBUG_NOTHREADPIPELINES = 0x2000000,
+	RADV_DEBUG_PRECOMPILE_META   = 0x4000000,
 };
 
 enum {
@@ -61,6 +63,7 @@ enum {
 	RADV_PERFTEST_OUT_OF_ORDER   =   0x8,
 	RADV_PERFTEST_DCC_MSAA       =  0x10,
 	RADV_PERFTEST_BO_LIST        =  0x20,
+	RADV_PERFTEST_SDMA           =  0x40,
 };
 
 bool
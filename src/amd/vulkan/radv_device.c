@@ -35,6 +35,7 @@
 #include "radv_cs.h"
 #include "util/disk_cache.h"
 #include "util/strtod.h"
+#include "util/u_cpu_detect.h"
 #include "vk_util.h"
 #include <xf86drm.h>
 #include <amdgpu.h>
@@ -465,6 +466,8 @@ static const struct debug_control radv_debug_options[] = {
 	{"nothreadllvm", RADV_DEBUG_NOTHREADLLVM},
 	{"nobinning", RADV_DEBUG_NOBINNING},
 	{"noloadstoreopt", RADV_DEBUG_NO_LOAD_STORE_OPT},
+	{"nothreadpipelines", RADV_DEBUG_NOTHREADPIPELINES},
+	{"precompilemeta", RADV_DEBUG_PRECOMPILE_META},
 	{NULL, 0}
 };
 
@@ -481,6 +484,7 @@ static const struct debug_control radv_perftest_options[] = {
 	{"localbos", RADV_PERFTEST_LOCAL_BOS},
 	{"dccmsaa", RADV_PERFTEST_DCC_MSAA},
 	{"bolist", RADV_PERFTEST_BO_LIST},
+	{"sdma", RADV_PERFTEST_SDMA},
 	{NULL, 0}
 };
 
@@ -1368,6 +1372,20 @@ void radv_GetPhysicalDeviceProperties2(
 	}
 }
 
+/* The transfer queue runs on SDMA, which is still missing copies of tiled
+ * images, so it's only exposed on request.  Queue family indices are fixed,
+ * so it also needs the compute queue.
+ */
+static bool
+radv_has_transfer_queue(struct radv_physical_device *pdevice)
+{
+	return (pdevice->instance->perftest_flags & RADV_PERFTEST_SDMA) &&
+	       pdevice->rad_info.chip_class >= CIK &&
+	       pdevice->rad_info.num_sdma_rings > 0 &&
+	       pdevice->rad_info.num_compute_rings > 0 &&
+	       !(pdevice->instance->debug_flags & RADV_DEBUG_NO_COMPUTE_QUEUE);
+}
+
 static void radv_get_physical_device_queue_family_properties(
 	struct radv_physical_device*                pdevice,
 	uint32_t*                                   pCount,
@@ -1378,6 +1396,8 @@ static void radv_get_physical_device_queue_family_properties(
 	if (pdevice->rad_info.num_compute_rings > 0 &&
 	    !(pdevice->instance->debug_flags & RADV_DEBUG_NO_COMPUTE_QUEUE))
 		num_queue_families++;
+	if (radv_has_transfer_queue(pdevice))
+		num_queue_families++;
 
 	if (pQueueFamilyProperties == NULL) {
 		*pCount = num_queue_families;
@@ -1415,6 +1435,18 @@ static void radv_get_physical_device_queue_family_properties(
 			idx++;
 		}
 	}
+
+	if (radv_has_transfer_queue(pdevice)) {
+		if (*pCount > idx) {
+			*pQueueFamilyProperties[idx] = (VkQueueFamilyProperties) {
+				.queueFlags = VK_QUEUE_TRANSFER_BIT,
+				.queueCount = pdevice->rad_info.num_sdma_rings,
+				.timestampValidBits = 64,
+				.minImageTransferGranularity = (VkExtent3D) { 1, 1, 1 },
+			};
+			idx++;
+		}
+	}
 	*pCount = idx;
 }
 
@@ -1955,6 +1987,19 @@ VkResult radv_CreateDevice(
 			1 << util_logbase2(device->force_aniso));
 	}
 
+	/* Application allocators may only be called from the thread of the
+	 * command, so the pipeline threads need the default one.
+	 */
+	util_cpu_detect();
+	if (!(device->instance->debug_flags & RADV_DEBUG_NOTHREADPIPELINES) &&
+	    device->alloc.pfnAllocation == default_alloc_func &&
+	    util_cpu_caps.nr_cpus > 1) {
+		/* If this fails, pipelines are just built by the calling thread. */
+		util_queue_init(&device->pipeline_queue, "radv_pipeline", 64,
+				MIN2(util_cpu_caps.nr_cpus, 16),
+				UTIL_QUEUE_INIT_RESIZE_IF_FULL);
+	}
+
 	*pDevice = radv_device_to_handle(device);
 	return VK_SUCCESS;
 
@@ -1989,6 +2034,9 @@ void radv_DestroyDevice(
 	if (!device)
 		return;
 
+	if (util_queue_is_initialized(&device->pipeline_queue))
+		util_queue_destroy(&device->pipeline_queue);
+
 	if (device->trace_bo)
 		device->ws->buffer_destroy(device->trace_bo);
 
@@ -2468,6 +2516,15 @@ radv_get_preamble_cs(struct radv_queue *queue,
 	unsigned hs_offchip_param = 0;
 	unsigned tess_offchip_ring_offset;
 	uint32_t ring_bo_flags = RADEON_FLAG_NO_CPU_ACCESS | RADEON_FLAG_NO_INTERPROCESS_SHARING;
+
+	/* SDMA has no state to set up. */
+	if (queue->queue_family_index == RADV_QUEUE_TRANSFER) {
+		*initial_full_flush_preamble_cs = NULL;
+		*initial_preamble_cs = NULL;
+		*continue_preamble_cs = NULL;
+		return VK_SUCCESS;
+	}
+
 	if (!queue->has_tess_rings) {
 		if (needs_tess_rings)
 			add_tess_rings = true;
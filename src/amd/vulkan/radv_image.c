@@ -1167,7 +1167,7 @@ radv_image_view_make_descriptor(struct radv_image_view *iview,
 				       blk_w, is_stencil, is_storage_image, descriptor->plane_descriptors[descriptor_plane_id]);
 }
 
-static unsigned
+unsigned
 radv_plane_from_aspect(VkImageAspectFlags mask)
 {
 	switch(mask) {
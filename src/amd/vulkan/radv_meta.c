@@ -145,6 +145,7 @@ radv_meta_restore(const struct radv_meta_saved_state *state,
 	if (state->flags & RADV_META_SAVE_CONSTANTS) {
 		memcpy(cmd_buffer->push_constants, state->push_constants,
 		       MAX_PUSH_CONSTANTS_SIZE);
+		radv_invalidate_push_constants(cmd_buffer);
 		cmd_buffer->push_constant_stages |= VK_SHADER_STAGE_COMPUTE_BIT;
 
 		if (state->flags & RADV_META_SAVE_GRAPHICS_PIPELINE) {
@@ -255,17 +256,34 @@ radv_builtin_cache_path(char *path)
 	return ret > 0 && ret < PATH_MAX + 1;
 }
 
+#ifndef DATADIR
+#define DATADIR "/usr/share"
+#endif
+
+/* Builtin shaders shipped with the driver, one file per GPU family.
+ *
+ * Packagers and container images can generate them by running any
+ * Vulkan application once with RADV_DEBUG=precompilemeta, which compiles
+ * every meta pipeline at device creation, and installing the resulting
+ * $XDG_CACHE_HOME/radv_builtin_shaders<bits> file here. The pipeline cache
+ * UUID check rejects files from another build of the driver.
+ */
 static bool
-radv_load_meta_pipeline(struct radv_device *device)
+radv_system_builtin_cache_path(struct radv_device *device, char *path)
+{
+	int ret = snprintf(path, PATH_MAX + 1, "%s/radv/builtin_shaders%zd_%s",
+			   DATADIR, sizeof(void *) * 8,
+			   device->physical_device->rad_info.name);
+	return ret > 0 && ret < PATH_MAX + 1;
+}
+
+static bool
+radv_load_meta_pipeline_file(struct radv_device *device, const char *path)
 {
-	char path[PATH_MAX + 1];
 	struct stat st;
 	void *data = NULL;
 	bool ret = false;
 
-	if (!radv_builtin_cache_path(path))
-		return false;
-
 	int fd = open(path, O_RDONLY);
 	if (fd < 0)
 		return false;
@@ -284,6 +302,19 @@ fail:
 	return ret;
 }
 
+static bool
+radv_load_meta_pipeline(struct radv_device *device)
+{
+	char path[PATH_MAX + 1];
+
+	if (radv_builtin_cache_path(path) &&
+	    radv_load_meta_pipeline_file(device, path))
+		return true;
+
+	return radv_system_builtin_cache_path(device, path) &&
+	       radv_load_meta_pipeline_file(device, path);
+}
+
 static void
 radv_store_meta_pipeline(struct radv_device *device)
 {
@@ -342,7 +373,8 @@ radv_device_init_meta(struct radv_device *device)
 	device->meta_state.cache.alloc = device->meta_state.alloc;
 	radv_pipeline_cache_init(&device->meta_state.cache, device);
 	bool loaded_cache = radv_load_meta_pipeline(device);
-	bool on_demand = !loaded_cache;
+	bool on_demand = !loaded_cache &&
+		!(device->instance->debug_flags & RADV_DEBUG_PRECOMPILE_META);
 
 	mtx_init(&device->meta_state.mtx, mtx_plain);
 
@@ -156,6 +156,27 @@ void radv_meta_buffer_to_image_cs(struct radv_cmd_buffer *cmd_buffer,
 				  struct radv_meta_blit2d_surf *dst,
 				  unsigned num_rects,
 				  struct radv_meta_blit2d_rect *rects);
+
+/* One rectangle of a batched buffer to image copy, as read by the shader */
+struct radv_meta_btoi_region {
+	uint32_t dst_x;
+	uint32_t dst_y;
+	uint32_t dst_z; /* layer, or depth slice for 3D images */
+	uint32_t pitch;
+	uint32_t buf_offset; /* in texels, from src->offset */
+	uint32_t width;
+	uint32_t height;
+	uint32_t pad;
+};
+
+#define RADV_META_BTOI_BATCH_MAX 256
+
+void radv_meta_buffer_to_image_cs_batch(struct radv_cmd_buffer *cmd_buffer,
+					struct radv_meta_blit2d_buffer *src,
+					struct radv_meta_blit2d_surf *dst,
+					unsigned num_regions,
+					const struct radv_meta_btoi_region *regions);
+
 void radv_meta_image_to_image_cs(struct radv_cmd_buffer *cmd_buffer,
 				 struct radv_meta_blit2d_surf *src,
 				 struct radv_meta_blit2d_surf *dst,
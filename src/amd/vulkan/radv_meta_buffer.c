@@ -412,6 +412,15 @@ uint32_t radv_fill_buffer(struct radv_cmd_buffer *cmd_buffer,
 	assert(!(offset & 3));
 	assert(!(size & 3));
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		if (size) {
+			radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, bo);
+			radv_sdma_fill_buffer(cmd_buffer, radv_buffer_get_va(bo) + offset,
+					      size, value);
+		}
+		return 0;
+	}
+
 	if (size >= RADV_BUFFER_OPS_CS_THRESHOLD) {
 		fill_buffer_shader(cmd_buffer, bo, offset, size, value);
 		flush_bits = RADV_CMD_FLAG_CS_PARTIAL_FLUSH |
@@ -434,7 +443,8 @@ void radv_copy_buffer(struct radv_cmd_buffer *cmd_buffer,
 		      uint64_t src_offset, uint64_t dst_offset,
 		      uint64_t size)
 {
-	if (size >= RADV_BUFFER_OPS_CS_THRESHOLD && !(size & 3) && !(src_offset & 3) && !(dst_offset & 3))
+	if (size >= RADV_BUFFER_OPS_CS_THRESHOLD && !(size & 3) && !(src_offset & 3) && !(dst_offset & 3) &&
+	    cmd_buffer->queue_family_index != RADV_QUEUE_TRANSFER)
 		copy_buffer_shader(cmd_buffer, src_bo, dst_bo,
 				   src_offset, dst_offset, size);
 	else if (size) {
@@ -446,7 +456,10 @@ void radv_copy_buffer(struct radv_cmd_buffer *cmd_buffer,
 		radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, src_bo);
 		radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, dst_bo);
 
-		si_cp_dma_buffer_copy(cmd_buffer, src_va, dst_va, size);
+		if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER)
+			radv_sdma_copy_buffer(cmd_buffer, src_va, dst_va, size);
+		else
+			si_cp_dma_buffer_copy(cmd_buffer, src_va, dst_va, size);
 	}
 }
 
@@ -518,7 +531,11 @@ void radv_CmdUpdateBuffer(
 	if (!dataSize)
 		return;
 
-	if (dataSize < RADV_BUFFER_UPDATE_THRESHOLD) {
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER &&
+	    dataSize < RADV_BUFFER_UPDATE_THRESHOLD) {
+		radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, dst_buffer->bo);
+		radv_sdma_write_data(cmd_buffer, va, words, pData);
+	} else if (dataSize < RADV_BUFFER_UPDATE_THRESHOLD) {
 		si_emit_cache_flush(cmd_buffer);
 
 		radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, dst_buffer->bo);
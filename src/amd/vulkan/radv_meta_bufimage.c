@@ -483,6 +483,258 @@ radv_device_finish_meta_btoi_state(struct radv_device *device)
 			     state->btoi.pipeline_3d, &state->alloc);
 }
 
+/* Buffer to image - batched variant.
+ *
+ * Every work group row along Z copies one region, whose origin, pitch and
+ * size are read from a table in a storage buffer.  This lets all regions
+ * and slices of a vkCmdCopyBufferToImage go out as a single dispatch
+ * instead of one dispatch per region and slice.
+ */
+static nir_ssa_def *
+load_btoi_region(nir_builder *b, nir_ssa_def *table, nir_ssa_def *offset)
+{
+	nir_intrinsic_instr *load = nir_intrinsic_instr_create(b->shader, nir_intrinsic_load_ssbo);
+	load->src[0] = nir_src_for_ssa(table);
+	load->src[1] = nir_src_for_ssa(offset);
+	nir_ssa_dest_init(&load->instr, &load->dest, 4, 32, NULL);
+	load->num_components = 4;
+	nir_builder_instr_insert(b, &load->instr);
+	return &load->dest.ssa;
+}
+
+static nir_shader *
+build_nir_btoi_batch_compute_shader(struct radv_device *dev, bool is_3d)
+{
+	nir_builder b;
+	enum glsl_sampler_dim dim = is_3d ? GLSL_SAMPLER_DIM_3D : GLSL_SAMPLER_DIM_2D;
+	const struct glsl_type *buf_type = glsl_sampler_type(GLSL_SAMPLER_DIM_BUF,
+							     false,
+							     false,
+							     GLSL_TYPE_FLOAT);
+	const struct glsl_type *img_type = glsl_sampler_type(dim,
+							     false,
+							     !is_3d,
+							     GLSL_TYPE_FLOAT);
+	nir_builder_init_simple_shader(&b, NULL, MESA_SHADER_COMPUTE, NULL);
+	b.shader->info.name = ralloc_strdup(b.shader, is_3d ? "meta_btoi_batch_cs_3d" : "meta_btoi_batch_cs");
+	b.shader->info.cs.local_size[0] = 16;
+	b.shader->info.cs.local_size[1] = 16;
+	b.shader->info.cs.local_size[2] = 1;
+	nir_variable *input_img = nir_variable_create(b.shader, nir_var_uniform,
+						      buf_type, "s_tex");
+	input_img->data.descriptor_set = 0;
+	input_img->data.binding = 0;
+
+	nir_variable *output_img = nir_variable_create(b.shader, nir_var_uniform,
+						       img_type, "out_img");
+	output_img->data.descriptor_set = 0;
+	output_img->data.binding = 1;
+
+	nir_intrinsic_instr *table = nir_intrinsic_instr_create(b.shader,
+								nir_intrinsic_vulkan_resource_index);
+	table->src[0] = nir_src_for_ssa(nir_imm_int(&b, 0));
+	table->num_components = 1;
+	nir_intrinsic_set_desc_set(table, 0);
+	nir_intrinsic_set_binding(table, 2);
+	nir_ssa_dest_init(&table->instr, &table->dest, table->num_components, 32, NULL);
+	nir_builder_instr_insert(&b, &table->instr);
+
+	nir_ssa_def *invoc_id = nir_load_local_invocation_id(&b);
+	nir_ssa_def *wg_id = nir_load_work_group_id(&b);
+	nir_ssa_def *block_size = nir_imm_ivec4(&b,
+						b.shader->info.cs.local_size[0],
+						b.shader->info.cs.local_size[1],
+						b.shader->info.cs.local_size[2], 0);
+
+	nir_ssa_def *global_id = nir_iadd(&b, nir_imul(&b, wg_id, block_size), invoc_id);
+
+	nir_ssa_def *region_offset = nir_imul(&b, nir_channel(&b, wg_id, 2),
+					      nir_imm_int(&b, sizeof(struct radv_meta_btoi_region)));
+	/* dst_x, dst_y, dst_z, pitch */
+	nir_ssa_def *region0 = load_btoi_region(&b, &table->dest.ssa, region_offset);
+	/* buf_offset, width, height */
+	nir_ssa_def *region1 = load_btoi_region(&b, &table->dest.ssa,
+						nir_iadd(&b, region_offset, nir_imm_int(&b, 16)));
+
+	nir_ssa_def *pos_x = nir_channel(&b, global_id, 0);
+	nir_ssa_def *pos_y = nir_channel(&b, global_id, 1);
+
+	/* Regions don't all have the size of the dispatch. */
+	nir_ssa_def *in_bounds = nir_iand(&b, nir_ult(&b, pos_x, nir_channel(&b, region1, 1)),
+					      nir_ult(&b, pos_y, nir_channel(&b, region1, 2)));
+	nir_if *nif = nir_push_if(&b, in_bounds);
+
+	nir_ssa_def *tmp = nir_imul(&b, pos_y, nir_channel(&b, region0, 3));
+	tmp = nir_iadd(&b, tmp, pos_x);
+	tmp = nir_iadd(&b, tmp, nir_channel(&b, region1, 0));
+
+	nir_ssa_def *img_coord = nir_vec4(&b,
+					  nir_iadd(&b, pos_x, nir_channel(&b, region0, 0)),
+					  nir_iadd(&b, pos_y, nir_channel(&b, region0, 1)),
+					  nir_channel(&b, region0, 2),
+					  nir_ssa_undef(&b, 1, 32));
+	nir_ssa_def *input_img_deref = &nir_build_deref_var(&b, input_img)->dest.ssa;
+
+	nir_tex_instr *tex = nir_tex_instr_create(b.shader, 3);
+	tex->sampler_dim = GLSL_SAMPLER_DIM_BUF;
+	tex->op = nir_texop_txf;
+	tex->src[0].src_type = nir_tex_src_coord;
+	tex->src[0].src = nir_src_for_ssa(tmp);
+	tex->src[1].src_type = nir_tex_src_lod;
+	tex->src[1].src = nir_src_for_ssa(nir_imm_int(&b, 0));
+	tex->src[2].src_type = nir_tex_src_texture_deref;
+	tex->src[2].src = nir_src_for_ssa(input_img_deref);
+	tex->dest_type = nir_type_float;
+	tex->is_array = false;
+	tex->coord_components = 1;
+
+	nir_ssa_dest_init(&tex->instr, &tex->dest, 4, 32, "tex");
+	nir_builder_instr_insert(&b, &tex->instr);
+
+	nir_ssa_def *outval = &tex->dest.ssa;
+	nir_intrinsic_instr *store = nir_intrinsic_instr_create(b.shader, nir_intrinsic_image_deref_store);
+	store->num_components = 4;
+	store->src[0] = nir_src_for_ssa(&nir_build_deref_var(&b, output_img)->dest.ssa);
+	store->src[1] = nir_src_for_ssa(img_coord);
+	store->src[2] = nir_src_for_ssa(nir_ssa_undef(&b, 1, 32));
+	store->src[3] = nir_src_for_ssa(outval);
+	nir_builder_instr_insert(&b, &store->instr);
+
+	nir_pop_if(&b, nif);
+	return b.shader;
+}
+
+static VkResult
+radv_device_init_meta_btoi_batch_state(struct radv_device *device)
+{
+	VkResult result;
+	struct radv_shader_module cs = { .nir = NULL };
+	struct radv_shader_module cs_3d = { .nir = NULL };
+	cs.nir = build_nir_btoi_batch_compute_shader(device, false);
+	if (device->physical_device->rad_info.chip_class >= GFX9)
+		cs_3d.nir = build_nir_btoi_batch_compute_shader(device, true);
+
+	VkDescriptorSetLayoutCreateInfo ds_create_info = {
+		.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+		.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+		.bindingCount = 3,
+		.pBindings = (VkDescriptorSetLayoutBinding[]) {
+			{
+				.binding = 0,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+				.pImmutableSamplers = NULL
+			},
+			{
+				.binding = 1,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+				.pImmutableSamplers = NULL
+			},
+			{
+				.binding = 2,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+				.pImmutableSamplers = NULL
+			},
+		}
+	};
+
+	result = radv_CreateDescriptorSetLayout(radv_device_to_handle(device),
+						&ds_create_info,
+						&device->meta_state.alloc,
+						&device->meta_state.btoi.batch_ds_layout);
+	if (result != VK_SUCCESS)
+		goto fail;
+
+	VkPipelineLayoutCreateInfo pl_create_info = {
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+		.setLayoutCount = 1,
+		.pSetLayouts = &device->meta_state.btoi.batch_ds_layout,
+		.pushConstantRangeCount = 0,
+	};
+
+	result = radv_CreatePipelineLayout(radv_device_to_handle(device),
+					  &pl_create_info,
+					  &device->meta_state.alloc,
+					  &device->meta_state.btoi.batch_p_layout);
+	if (result != VK_SUCCESS)
+		goto fail;
+
+	VkPipelineShaderStageCreateInfo pipeline_shader_stage = {
+		.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+		.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+		.module = radv_shader_module_to_handle(&cs),
+		.pName = "main",
+		.pSpecializationInfo = NULL,
+	};
+
+	VkComputePipelineCreateInfo vk_pipeline_info = {
+		.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+		.stage = pipeline_shader_stage,
+		.flags = 0,
+		.layout = device->meta_state.btoi.batch_p_layout,
+	};
+
+	result = radv_CreateComputePipelines(radv_device_to_handle(device),
+					     radv_pipeline_cache_to_handle(&device->meta_state.cache),
+					     1, &vk_pipeline_info, NULL,
+					     &device->meta_state.btoi.batch_pipeline);
+	if (result != VK_SUCCESS)
+		goto fail;
+
+	if (device->physical_device->rad_info.chip_class >= GFX9) {
+		VkPipelineShaderStageCreateInfo pipeline_shader_stage_3d = {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+			.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+			.module = radv_shader_module_to_handle(&cs_3d),
+			.pName = "main",
+			.pSpecializationInfo = NULL,
+		};
+
+		VkComputePipelineCreateInfo vk_pipeline_info_3d = {
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.stage = pipeline_shader_stage_3d,
+			.flags = 0,
+			.layout = device->meta_state.btoi.batch_p_layout,
+		};
+
+		result = radv_CreateComputePipelines(radv_device_to_handle(device),
+						     radv_pipeline_cache_to_handle(&device->meta_state.cache),
+						     1, &vk_pipeline_info_3d, NULL,
+						     &device->meta_state.btoi.batch_pipeline_3d);
+		if (result != VK_SUCCESS)
+			goto fail;
+	}
+
+	ralloc_free(cs_3d.nir);
+	ralloc_free(cs.nir);
+	return VK_SUCCESS;
+fail:
+	ralloc_free(cs_3d.nir);
+	ralloc_free(cs.nir);
+	return result;
+}
+
+static void
+radv_device_finish_meta_btoi_batch_state(struct radv_device *device)
+{
+	struct radv_meta_state *state = &device->meta_state;
+
+	radv_DestroyPipelineLayout(radv_device_to_handle(device),
+				   state->btoi.batch_p_layout, &state->alloc);
+	radv_DestroyDescriptorSetLayout(radv_device_to_handle(device),
+				        state->btoi.batch_ds_layout,
+					&state->alloc);
+	radv_DestroyPipeline(radv_device_to_handle(device),
+			     state->btoi.batch_pipeline, &state->alloc);
+	radv_DestroyPipeline(radv_device_to_handle(device),
+			     state->btoi.batch_pipeline_3d, &state->alloc);
+}
+
 /* Buffer to image - special path for R32G32B32 */
 static nir_shader *
 build_nir_btoi_r32g32b32_compute_shader(struct radv_device *dev)
@@ -1474,6 +1726,7 @@ radv_device_finish_meta_bufimage_state(struct radv_device *device)
 {
 	radv_device_finish_meta_itob_state(device);
 	radv_device_finish_meta_btoi_state(device);
+	radv_device_finish_meta_btoi_batch_state(device);
 	radv_device_finish_meta_btoi_r32g32b32_state(device);
 	radv_device_finish_meta_itoi_state(device);
 	radv_device_finish_meta_itoi_r32g32b32_state(device);
@@ -1494,6 +1747,10 @@ radv_device_init_meta_bufimage_state(struct radv_device *device)
 	if (result != VK_SUCCESS)
 		goto fail_btoi;
 
+	result = radv_device_init_meta_btoi_batch_state(device);
+	if (result != VK_SUCCESS)
+		goto fail_btoi_batch;
+
 	result = radv_device_init_meta_btoi_r32g32b32_state(device);
 	if (result != VK_SUCCESS)
 		goto fail_btoi_r32g32b32;
@@ -1525,6 +1782,8 @@ fail_itoi:
 	radv_device_finish_meta_itoi_state(device);
 fail_btoi_r32g32b32:
 	radv_device_finish_meta_btoi_r32g32b32_state(device);
+fail_btoi_batch:
+	radv_device_finish_meta_btoi_batch_state(device);
 fail_btoi:
 	radv_device_finish_meta_btoi_state(device);
 fail_itob:
@@ -1897,6 +2156,109 @@ radv_meta_buffer_to_image_cs(struct radv_cmd_buffer *cmd_buffer,
 	}
 }
 
+void
+radv_meta_buffer_to_image_cs_batch(struct radv_cmd_buffer *cmd_buffer,
+				   struct radv_meta_blit2d_buffer *src,
+				   struct radv_meta_blit2d_surf *dst,
+				   unsigned num_regions,
+				   const struct radv_meta_btoi_region *regions)
+{
+	struct radv_device *device = cmd_buffer->device;
+	bool is_3d = dst->image->type == VK_IMAGE_TYPE_3D;
+	VkPipeline pipeline = is_3d ? device->meta_state.btoi.batch_pipeline_3d :
+				      device->meta_state.btoi.batch_pipeline;
+	unsigned table_size = num_regions * sizeof(*regions);
+	struct radv_buffer_view src_view;
+	struct radv_image_view dst_view;
+	unsigned max_width = 0, max_height = 0;
+	unsigned table_offset;
+	void *table_ptr;
+
+	assert(num_regions <= RADV_META_BTOI_BATCH_MAX);
+	assert(!is_3d || device->physical_device->rad_info.chip_class >= GFX9);
+
+	if (!radv_cmd_buffer_upload_alloc(cmd_buffer, table_size, 16,
+					  &table_offset, &table_ptr))
+		return;
+
+	memcpy(table_ptr, regions, table_size);
+	for (unsigned r = 0; r < num_regions; ++r) {
+		max_width = MAX2(max_width, regions[r].width);
+		max_height = MAX2(max_height, regions[r].height);
+	}
+
+	struct radv_buffer table = {
+		.bo = cmd_buffer->upload.upload_bo,
+		.offset = table_offset,
+		.size = table_size,
+	};
+
+	/* All layers are bound at once, the shader picks one per region. */
+	create_bview(cmd_buffer, src->buffer, src->offset, src->format, &src_view);
+	radv_image_view_init(&dst_view, device,
+			     &(VkImageViewCreateInfo) {
+				     .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+				     .image = radv_image_to_handle(dst->image),
+				     .viewType = is_3d ? VK_IMAGE_VIEW_TYPE_3D :
+							 VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+				     .format = dst->format,
+				     .subresourceRange = {
+					     .aspectMask = dst->aspect_mask,
+					     .baseMipLevel = dst->level,
+					     .levelCount = 1,
+					     .baseArrayLayer = 0,
+					     .layerCount = is_3d ? 1 : dst->image->info.array_size,
+				     },
+			     });
+
+	radv_meta_push_descriptor_set(cmd_buffer,
+				      VK_PIPELINE_BIND_POINT_COMPUTE,
+				      device->meta_state.btoi.batch_p_layout,
+				      0, /* set */
+				      3, /* descriptorWriteCount */
+				      (VkWriteDescriptorSet[]) {
+				              {
+				                      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				                      .dstBinding = 0,
+				                      .dstArrayElement = 0,
+				                      .descriptorCount = 1,
+				                      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,
+				                      .pTexelBufferView = (VkBufferView[])  { radv_buffer_view_to_handle(&src_view) },
+				              },
+				              {
+				                      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				                      .dstBinding = 1,
+				                      .dstArrayElement = 0,
+				                      .descriptorCount = 1,
+				                      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+				                      .pImageInfo = (VkDescriptorImageInfo[]) {
+				                              {
+				                                      .sampler = VK_NULL_HANDLE,
+				                                      .imageView = radv_image_view_to_handle(&dst_view),
+				                                      .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+				                              },
+				                      }
+				              },
+				              {
+				                      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				                      .dstBinding = 2,
+				                      .dstArrayElement = 0,
+				                      .descriptorCount = 1,
+				                      .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				                      .pBufferInfo = &(VkDescriptorBufferInfo) {
+				                              .buffer = radv_buffer_to_handle(&table),
+				                              .offset = 0,
+				                              .range = table_size,
+				                      }
+				              }
+				      });
+
+	radv_CmdBindPipeline(radv_cmd_buffer_to_handle(cmd_buffer),
+			     VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+	radv_unaligned_dispatch(cmd_buffer, max_width, max_height, num_regions);
+}
+
 static void
 itoi_r32g32b32_bind_descriptors(struct radv_cmd_buffer *cmd_buffer,
 				struct radv_buffer_view *src,
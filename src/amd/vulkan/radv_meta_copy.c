@@ -120,6 +120,46 @@ image_is_renderable(struct radv_device *device, struct radv_image *image)
 	return true;
 }
 
+/* Whether all the regions of a compute buffer to image copy can go out as
+ * a single radv_meta_buffer_to_image_cs_batch() dispatch.
+ */
+static bool
+can_batch_buffer_to_image(struct radv_cmd_buffer *cmd_buffer,
+			  struct radv_image *image,
+			  uint32_t regionCount,
+			  const VkBufferImageCopy* pRegions)
+{
+	bool cs = cmd_buffer->queue_family_index == RADV_QUEUE_COMPUTE;
+	unsigned num_slices = 0;
+
+	if (!cs && image_is_renderable(cmd_buffer->device, image))
+		return false;
+
+	/* R32G32B32 goes through its own linear path. */
+	if (image->vk_format == VK_FORMAT_R32G32B32_UINT ||
+	    image->vk_format == VK_FORMAT_R32G32B32_SINT ||
+	    image->vk_format == VK_FORMAT_R32G32B32_SFLOAT)
+		return false;
+
+	if (image->type != VK_IMAGE_TYPE_2D &&
+	    (image->type != VK_IMAGE_TYPE_3D ||
+	     cmd_buffer->device->physical_device->rad_info.chip_class < GFX9))
+		return false;
+
+	for (unsigned r = 0; r < regionCount; r++) {
+		if (pRegions[r].imageSubresource.mipLevel != pRegions[0].imageSubresource.mipLevel ||
+		    pRegions[r].imageSubresource.aspectMask != pRegions[0].imageSubresource.aspectMask)
+			return false;
+
+		num_slices += image->type == VK_IMAGE_TYPE_3D ?
+			meta_region_extent_el(image, image->type, &pRegions[r].imageExtent).depth :
+			pRegions[r].imageSubresource.layerCount;
+	}
+
+	/* A single rectangle is better served by the plain path. */
+	return num_slices > 1;
+}
+
 static void
 meta_copy_buffer_to_image(struct radv_cmd_buffer *cmd_buffer,
                           struct radv_buffer* buffer,
@@ -130,13 +170,32 @@ meta_copy_buffer_to_image(struct radv_cmd_buffer *cmd_buffer,
 {
 	bool cs = cmd_buffer->queue_family_index == RADV_QUEUE_COMPUTE;
 	struct radv_meta_saved_state saved_state;
+	struct radv_meta_btoi_region batch[RADV_META_BTOI_BATCH_MAX];
+	struct radv_meta_blit2d_buffer batch_buf;
+	struct radv_meta_blit2d_surf batch_surf;
+	unsigned num_batched = 0;
+	uint64_t batch_offset = UINT64_MAX;
 	bool old_predicating;
+	bool batched;
 
 	/* The Vulkan 1.0 spec says "dstImage must have a sample count equal to
 	 * VK_SAMPLE_COUNT_1_BIT."
 	 */
 	assert(image->info.samples == 1);
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		for (unsigned r = 0; r < regionCount; r++)
+			radv_sdma_copy_buffer_image(cmd_buffer, buffer, image,
+						    &pRegions[r], true);
+		return;
+	}
+
+	batched = can_batch_buffer_to_image(cmd_buffer, image, regionCount, pRegions);
+	if (batched) {
+		for (unsigned r = 0; r < regionCount; r++)
+			batch_offset = MIN2(batch_offset, pRegions[r].bufferOffset);
+	}
+
 	radv_meta_save(&saved_state, cmd_buffer,
 		       (cs ? RADV_META_SAVE_COMPUTE_PIPELINE :
 			RADV_META_SAVE_GRAPHICS_PIPELINE) |
@@ -227,8 +286,28 @@ meta_copy_buffer_to_image(struct radv_cmd_buffer *cmd_buffer,
 
 
 			/* Perform Blit */
-			if (cs ||
-			    !image_is_renderable(cmd_buffer->device, img_bsurf.image)) {
+			if (batched &&
+			    (buf_bsurf.offset - batch_offset) % buf_bsurf.bs == 0) {
+				if (num_batched == RADV_META_BTOI_BATCH_MAX) {
+					radv_meta_buffer_to_image_cs_batch(cmd_buffer, &batch_buf, &batch_surf,
+									   num_batched, batch);
+					num_batched = 0;
+				}
+
+				batch_buf = buf_bsurf;
+				batch_buf.offset = batch_offset;
+				batch_surf = img_bsurf;
+				batch[num_batched++] = (struct radv_meta_btoi_region) {
+					.dst_x = rect.dst_x,
+					.dst_y = rect.dst_y,
+					.dst_z = img_bsurf.layer,
+					.pitch = buf_bsurf.pitch,
+					.buf_offset = (buf_bsurf.offset - batch_offset) / buf_bsurf.bs,
+					.width = rect.width,
+					.height = rect.height,
+				};
+			} else if (cs ||
+				   !image_is_renderable(cmd_buffer->device, img_bsurf.image)) {
 				radv_meta_buffer_to_image_cs(cmd_buffer, &buf_bsurf, &img_bsurf, 1, &rect);
 			} else {
 				radv_meta_blit2d(cmd_buffer, NULL, &buf_bsurf, &img_bsurf, 1, &rect);
@@ -249,6 +328,11 @@ meta_copy_buffer_to_image(struct radv_cmd_buffer *cmd_buffer,
 		}
 	}
 
+	if (num_batched) {
+		radv_meta_buffer_to_image_cs_batch(cmd_buffer, &batch_buf, &batch_surf,
+						   num_batched, batch);
+	}
+
 	/* Restore conditional rendering. */
 	cmd_buffer->state.predicating = old_predicating;
 
@@ -282,6 +366,13 @@ meta_copy_image_to_buffer(struct radv_cmd_buffer *cmd_buffer,
 	struct radv_meta_saved_state saved_state;
 	bool old_predicating;
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		for (unsigned r = 0; r < regionCount; r++)
+			radv_sdma_copy_buffer_image(cmd_buffer, buffer, image,
+						    &pRegions[r], false);
+		return;
+	}
+
 	radv_meta_save(&saved_state, cmd_buffer,
 		       RADV_META_SAVE_COMPUTE_PIPELINE |
 		       RADV_META_SAVE_CONSTANTS |
@@ -419,6 +510,13 @@ meta_copy_image(struct radv_cmd_buffer *cmd_buffer,
 	struct radv_meta_saved_state saved_state;
 	bool old_predicating;
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		for (unsigned r = 0; r < regionCount; r++)
+			radv_sdma_copy_image(cmd_buffer, src_image, dest_image,
+					     &pRegions[r]);
+		return;
+	}
+
 	/* From the Vulkan 1.0 spec:
 	 *
 	 *    vkCmdCopyImage can be used to copy image data between multisample
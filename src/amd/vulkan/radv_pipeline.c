@@ -2137,6 +2137,16 @@ void radv_create_shaders(struct radv_pipeline *pipeline,
 	if (radv_create_shader_variants_from_pipeline_cache(device, cache, hash, pipeline->shaders,
 	                                                    &found_in_application_cache) &&
 	    (!modules[MESA_SHADER_GEOMETRY] || pipeline->gs_copy_shader)) {
+		/* Report the cache hit on every stage too, so that applications
+		 * can tell which shaders their cache warmup covered.
+		 */
+		for (unsigned i = 0; i < MESA_SHADER_STAGES; ++i) {
+			if (modules[i]) {
+				radv_start_feedback(stage_feedbacks[i]);
+				radv_stop_feedback(stage_feedbacks[i], found_in_application_cache);
+			}
+		}
+
 		radv_stop_feedback(pipeline_feedback, found_in_application_cache);
 		return;
 	}
@@ -3827,6 +3837,117 @@ radv_graphics_pipeline_create(
 	return VK_SUCCESS;
 }
 
+typedef VkResult (*radv_pipeline_create_func)(VkDevice device,
+					      VkPipelineCache cache,
+					      const void *create_info,
+					      const VkAllocationCallbacks *alloc,
+					      VkPipeline *pipeline);
+
+struct radv_pipeline_job {
+	struct util_queue_fence fence;
+	radv_pipeline_create_func create;
+	VkDevice device;
+	VkPipelineCache cache;
+	const void *create_info;
+	VkPipeline *pipeline;
+	VkResult result;
+};
+
+static void
+radv_pipeline_job_execute(void *data, int thread_index)
+{
+	struct radv_pipeline_job *job = data;
+
+	job->result = job->create(job->device, job->cache, job->create_info,
+				  NULL, job->pipeline);
+}
+
+/* Creates the pipelines of a vkCreate*Pipelines call. When there is more
+ * than one, they are built by the device's pipeline queue, with the calling
+ * thread taking the first one. Application allocators may only be called
+ * from the calling thread, so pipelines created with one, or with a cache
+ * that has one, are built one after the other.
+ */
+static VkResult
+radv_create_pipelines(VkDevice _device,
+		      VkPipelineCache pipelineCache,
+		      uint32_t count,
+		      const void *pCreateInfos,
+		      size_t create_info_size,
+		      const VkAllocationCallbacks *pAllocator,
+		      VkPipeline *pPipelines,
+		      radv_pipeline_create_func create)
+{
+	RADV_FROM_HANDLE(radv_device, device, _device);
+	RADV_FROM_HANDLE(radv_pipeline_cache, cache, pipelineCache);
+	struct radv_pipeline_job *jobs = NULL;
+	VkResult result = VK_SUCCESS;
+
+	if (count > 1 && !pAllocator &&
+	    (!cache || cache->alloc.pfnAllocation == device->alloc.pfnAllocation) &&
+	    util_queue_is_initialized(&device->pipeline_queue))
+		jobs = calloc(count, sizeof(*jobs));
+
+	for (unsigned i = 0; i < count; i++) {
+		const void *create_info =
+			(const char *)pCreateInfos + i * create_info_size;
+
+		if (!jobs) {
+			VkResult r = create(_device, pipelineCache, create_info,
+					    pAllocator, &pPipelines[i]);
+			if (r != VK_SUCCESS) {
+				result = r;
+				pPipelines[i] = VK_NULL_HANDLE;
+			}
+			continue;
+		}
+
+		jobs[i].create = create;
+		jobs[i].device = _device;
+		jobs[i].cache = pipelineCache;
+		jobs[i].create_info = create_info;
+		jobs[i].pipeline = &pPipelines[i];
+
+		if (i > 0) {
+			util_queue_fence_init(&jobs[i].fence);
+			util_queue_add_job(&device->pipeline_queue, &jobs[i],
+					   &jobs[i].fence,
+					   radv_pipeline_job_execute, NULL);
+		}
+	}
+
+	if (!jobs)
+		return result;
+
+	radv_pipeline_job_execute(&jobs[0], 0);
+
+	for (unsigned i = 0; i < count; i++) {
+		if (i > 0) {
+			util_queue_fence_wait(&jobs[i].fence);
+			util_queue_fence_destroy(&jobs[i].fence);
+		}
+
+		if (jobs[i].result != VK_SUCCESS) {
+			result = jobs[i].result;
+			pPipelines[i] = VK_NULL_HANDLE;
+		}
+	}
+
+	free(jobs);
+	return result;
+}
+
+static VkResult
+radv_graphics_pipeline_create_cb(VkDevice device,
+				 VkPipelineCache cache,
+				 const void *create_info,
+				 const VkAllocationCallbacks *alloc,
+				 VkPipeline *pipeline)
+{
+	return radv_graphics_pipeline_create(device, cache, create_info,
+					     NULL, alloc, pipeline);
+}
+
 VkResult radv_CreateGraphicsPipelines(
 	VkDevice                                    _device,
 	VkPipelineCache                             pipelineCache,
@@ -3835,22 +3956,10 @@ VkResult radv_CreateGraphicsPipelines(
 	const VkAllocationCallbacks*                pAllocator,
 	VkPipeline*                                 pPipelines)
 {
-	VkResult result = VK_SUCCESS;
-	unsigned i = 0;
-
-	for (; i < count; i++) {
-		VkResult r;
-		r = radv_graphics_pipeline_create(_device,
-						  pipelineCache,
-						  &pCreateInfos[i],
-						  NULL, pAllocator, &pPipelines[i]);
-		if (r != VK_SUCCESS) {
-			result = r;
-			pPipelines[i] = VK_NULL_HANDLE;
-		}
-	}
-
-	return result;
+	return radv_create_pipelines(_device, pipelineCache, count,
+				     pCreateInfos, sizeof(*pCreateInfos),
+				     pAllocator, pPipelines,
+				     radv_graphics_pipeline_create_cb);
 }
 
 
@@ -3965,6 +4074,17 @@ static VkResult radv_compute_pipeline_create(
 	return VK_SUCCESS;
 }
 
+static VkResult
+radv_compute_pipeline_create_cb(VkDevice device,
+				VkPipelineCache cache,
+				const void *create_info,
+				const VkAllocationCallbacks *alloc,
+				VkPipeline *pipeline)
+{
+	return radv_compute_pipeline_create(device, cache, create_info,
+					    alloc, pipeline);
+}
+
 VkResult radv_CreateComputePipelines(
 	VkDevice                                    _device,
 	VkPipelineCache                             pipelineCache,
@@ -3973,19 +4093,8 @@ VkResult radv_CreateComputePipelines(
 	const VkAllocationCallbacks*                pAllocator,
 	VkPipeline*                                 pPipelines)
 {
-	VkResult result = VK_SUCCESS;
-
-	unsigned i = 0;
-	for (; i < count; i++) {
-		VkResult r;
-		r = radv_compute_pipeline_create(_device, pipelineCache,
-						 &pCreateInfos[i],
-						 pAllocator, &pPipelines[i]);
-		if (r != VK_SUCCESS) {
-			result = r;
-			pPipelines[i] = VK_NULL_HANDLE;
-		}
-	}
-
-	return result;
+	return radv_create_pipelines(_device, pipelineCache, count,
+				     pCreateInfos, sizeof(*pCreateInfos),
+				     pAllocator, pPipelines,
+				     radv_compute_pipeline_create_cb);
 }
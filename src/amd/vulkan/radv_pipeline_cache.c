@@ -52,40 +52,49 @@ radv_pipeline_cache_init(struct radv_pipeline_cache *cache,
 			 struct radv_device *device)
 {
 	cache->device = device;
-	pthread_mutex_init(&cache->mutex, NULL);
-
 	cache->modified = false;
-	cache->kernel_count = 0;
-	cache->total_size = 0;
-	cache->table_size = 1024;
-	const size_t byte_size = cache->table_size * sizeof(cache->hash_table[0]);
-	cache->hash_table = malloc(byte_size);
-
-	/* We don't consider allocation failure fatal, we just start with a 0-sized
-	 * cache. Disable caching when we want to keep shader debug info, since
-	 * we don't get the debug info on cached shaders. */
-	if (cache->hash_table == NULL ||
-	    (device->instance->debug_flags & RADV_DEBUG_NO_CACHE) ||
-	    device->keep_shader_info)
-		cache->table_size = 0;
-	else
-		memset(cache->hash_table, 0, byte_size);
+
+	for (unsigned s = 0; s < RADV_PIPELINE_CACHE_SHARDS; ++s) {
+		struct radv_pipeline_cache_shard *shard = &cache->shards[s];
+
+		pthread_mutex_init(&shard->mutex, NULL);
+
+		shard->kernel_count = 0;
+		shard->total_size = 0;
+		shard->table_size = 1024 / RADV_PIPELINE_CACHE_SHARDS;
+		const size_t byte_size = shard->table_size * sizeof(shard->hash_table[0]);
+		shard->hash_table = malloc(byte_size);
+
+		/* We don't consider allocation failure fatal, we just start with a 0-sized
+		 * cache. Disable caching when we want to keep shader debug info, since
+		 * we don't get the debug info on cached shaders. */
+		if (shard->hash_table == NULL ||
+		    (device->instance->debug_flags & RADV_DEBUG_NO_CACHE) ||
+		    device->keep_shader_info)
+			shard->table_size = 0;
+		else
+			memset(shard->hash_table, 0, byte_size);
+	}
 }
 
 void
 radv_pipeline_cache_finish(struct radv_pipeline_cache *cache)
 {
-	for (unsigned i = 0; i < cache->table_size; ++i)
-		if (cache->hash_table[i]) {
-			for(int j = 0; j < MESA_SHADER_STAGES; ++j)  {
-				if (cache->hash_table[i]->variants[j])
-					radv_shader_variant_destroy(cache->device,
-								    cache->hash_table[i]->variants[j]);
+	for (unsigned s = 0; s < RADV_PIPELINE_CACHE_SHARDS; ++s) {
+		struct radv_pipeline_cache_shard *shard = &cache->shards[s];
+
+		for (unsigned i = 0; i < shard->table_size; ++i)
+			if (shard->hash_table[i]) {
+				for(int j = 0; j < MESA_SHADER_STAGES; ++j)  {
+					if (shard->hash_table[i]->variants[j])
+						radv_shader_variant_destroy(cache->device,
+									    shard->hash_table[i]->variants[j]);
+				}
+				vk_free(&cache->alloc, shard->hash_table[i]);
 			}
-			vk_free(&cache->alloc, cache->hash_table[i]);
-		}
-	pthread_mutex_destroy(&cache->mutex);
-	free(cache->hash_table);
+		pthread_mutex_destroy(&shard->mutex);
+		free(shard->hash_table);
+	}
 }
 
 static uint32_t
@@ -131,20 +140,29 @@ radv_hash_shaders(unsigned char *hash,
 	_mesa_sha1_final(&ctx, hash);
 }
 
+/* The first dword of the hash picks the slot in the shard's table, so use
+ * another byte to pick the shard.
+ */
+static struct radv_pipeline_cache_shard *
+radv_pipeline_cache_get_shard(struct radv_pipeline_cache *cache,
+			      const unsigned char *sha1)
+{
+	return &cache->shards[sha1[4] % RADV_PIPELINE_CACHE_SHARDS];
+}
 
 static struct cache_entry *
-radv_pipeline_cache_search_unlocked(struct radv_pipeline_cache *cache,
+radv_pipeline_cache_search_unlocked(struct radv_pipeline_cache_shard *shard,
 				    const unsigned char *sha1)
 {
-	const uint32_t mask = cache->table_size - 1;
+	const uint32_t mask = shard->table_size - 1;
 	const uint32_t start = (*(uint32_t *) sha1);
 
-	if (cache->table_size == 0)
+	if (shard->table_size == 0)
 		return NULL;
 
-	for (uint32_t i = 0; i < cache->table_size; i++) {
+	for (uint32_t i = 0; i < shard->table_size; i++) {
 		const uint32_t index = (start + i) & mask;
-		struct cache_entry *entry = cache->hash_table[index];
+		struct cache_entry *entry = shard->hash_table[index];
 
 		if (!entry)
 			return NULL;
@@ -157,69 +175,55 @@ radv_pipeline_cache_search_unlocked(struct radv_pipeline_cache *cache,
 	unreachable("hash table should never be full");
 }
 
-static struct cache_entry *
-radv_pipeline_cache_search(struct radv_pipeline_cache *cache,
-			   const unsigned char *sha1)
-{
-	struct cache_entry *entry;
-
-	pthread_mutex_lock(&cache->mutex);
-
-	entry = radv_pipeline_cache_search_unlocked(cache, sha1);
-
-	pthread_mutex_unlock(&cache->mutex);
-
-	return entry;
-}
-
 static void
-radv_pipeline_cache_set_entry(struct radv_pipeline_cache *cache,
+radv_pipeline_cache_set_entry(struct radv_pipeline_cache_shard *shard,
 			      struct cache_entry *entry)
 {
-	const uint32_t mask = cache->table_size - 1;
+	const uint32_t mask = shard->table_size - 1;
 	const uint32_t start = entry->sha1_dw[0];
 
 	/* We'll always be able to insert when we get here. */
-	assert(cache->kernel_count < cache->table_size / 2);
+	assert(shard->kernel_count < shard->table_size / 2);
 
-	for (uint32_t i = 0; i < cache->table_size; i++) {
+	for (uint32_t i = 0; i < shard->table_size; i++) {
 		const uint32_t index = (start + i) & mask;
-		if (!cache->hash_table[index]) {
-			cache->hash_table[index] = entry;
+		if (!shard->hash_table[index]) {
+			shard->hash_table[index] = entry;
 			break;
 		}
 	}
 
-	cache->total_size += entry_size(entry);
-	cache->kernel_count++;
+	shard->total_size += entry_size(entry);
+	shard->kernel_count++;
 }
 
 
 static VkResult
-radv_pipeline_cache_grow(struct radv_pipeline_cache *cache)
+radv_pipeline_cache_grow(struct radv_pipeline_cache *cache,
+			 struct radv_pipeline_cache_shard *shard)
 {
-	const uint32_t table_size = cache->table_size * 2;
-	const uint32_t old_table_size = cache->table_size;
-	const size_t byte_size = table_size * sizeof(cache->hash_table[0]);
+	const uint32_t table_size = shard->table_size * 2;
+	const uint32_t old_table_size = shard->table_size;
+	const size_t byte_size = table_size * sizeof(shard->hash_table[0]);
 	struct cache_entry **table;
-	struct cache_entry **old_table = cache->hash_table;
+	struct cache_entry **old_table = shard->hash_table;
 
 	table = malloc(byte_size);
 	if (table == NULL)
 		return vk_error(cache->device->instance, VK_ERROR_OUT_OF_HOST_MEMORY);
 
-	cache->hash_table = table;
-	cache->table_size = table_size;
-	cache->kernel_count = 0;
-	cache->total_size = 0;
+	shard->hash_table = table;
+	shard->table_size = table_size;
+	shard->kernel_count = 0;
+	shard->total_size = 0;
 
-	memset(cache->hash_table, 0, byte_size);
+	memset(shard->hash_table, 0, byte_size);
 	for (uint32_t i = 0; i < old_table_size; i++) {
 		struct cache_entry *entry = old_table[i];
 		if (!entry)
 			continue;
 
-		radv_pipeline_cache_set_entry(cache, entry);
+		radv_pipeline_cache_set_entry(shard, entry);
 	}
 
 	free(old_table);
@@ -231,14 +235,17 @@ static void
 radv_pipeline_cache_add_entry(struct radv_pipeline_cache *cache,
 			      struct cache_entry *entry)
 {
-	if (cache->kernel_count == cache->table_size / 2)
-		radv_pipeline_cache_grow(cache);
+	struct radv_pipeline_cache_shard *shard =
+		radv_pipeline_cache_get_shard(cache, entry->sha1);
+
+	if (shard->kernel_count == shard->table_size / 2)
+		radv_pipeline_cache_grow(cache, shard);
 
 	/* Failing to grow that hash table isn't fatal, but may mean we don't
 	 * have enough space to add this new kernel. Only add it if there's room.
 	 */
-	if (cache->kernel_count < cache->table_size / 2)
-		radv_pipeline_cache_set_entry(cache, entry);
+	if (shard->kernel_count < shard->table_size / 2)
+		radv_pipeline_cache_set_entry(shard, entry);
 }
 
 static bool
@@ -265,20 +272,26 @@ radv_create_shader_variants_from_pipeline_cache(struct radv_device *device,
 		*found_in_application_cache = false;
 	}
 
-	pthread_mutex_lock(&cache->mutex);
+	struct radv_pipeline_cache_shard *shard =
+		radv_pipeline_cache_get_shard(cache, sha1);
+
+	pthread_mutex_lock(&shard->mutex);
 
-	entry = radv_pipeline_cache_search_unlocked(cache, sha1);
+	entry = radv_pipeline_cache_search_unlocked(shard, sha1);
 
 	if (!entry) {
 		*found_in_application_cache = false;
 
+		/* Reading the disk cache can take a while, so don't block the
+		 * other users of the shard meanwhile.
+		 */
+		pthread_mutex_unlock(&shard->mutex);
+
 		/* Don't cache when we want debug info, since this isn't
 		 * present in the cache.
 		 */
-		if (radv_is_cache_disabled(device) || !device->physical_device->disk_cache) {
-			pthread_mutex_unlock(&cache->mutex);
+		if (radv_is_cache_disabled(device) || !device->physical_device->disk_cache)
 			return false;
-		}
 
 		uint8_t disk_sha1[20];
 		disk_cache_compute_key(device->physical_device->disk_cache,
@@ -286,23 +299,28 @@ radv_create_shader_variants_from_pipeline_cache(struct radv_device *device,
 		entry = (struct cache_entry *)
 			disk_cache_get(device->physical_device->disk_cache,
 				       disk_sha1, NULL);
-		if (!entry) {
-			pthread_mutex_unlock(&cache->mutex);
+		if (!entry)
 			return false;
-		} else {
-			size_t size = entry_size(entry);
-			struct cache_entry *new_entry = vk_alloc(&cache->alloc, size, 8,
-								 VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
-			if (!new_entry) {
-				free(entry);
-				pthread_mutex_unlock(&cache->mutex);
-				return false;
-			}
 
-			memcpy(new_entry, entry, entry_size(entry));
+		size_t size = entry_size(entry);
+		struct cache_entry *new_entry = vk_alloc(&cache->alloc, size, 8,
+							 VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
+		if (!new_entry) {
 			free(entry);
-			entry = new_entry;
+			return false;
+		}
+
+		memcpy(new_entry, entry, entry_size(entry));
+		free(entry);
+
+		pthread_mutex_lock(&shard->mutex);
 
+		/* Another thread may have added the entry in the meantime. */
+		entry = radv_pipeline_cache_search_unlocked(shard, sha1);
+		if (entry) {
+			vk_free(&cache->alloc, new_entry);
+		} else {
+			entry = new_entry;
 			radv_pipeline_cache_add_entry(cache, new_entry);
 		}
 	}
@@ -315,7 +333,7 @@ radv_create_shader_variants_from_pipeline_cache(struct radv_device *device,
 
 			variant = calloc(1, sizeof(struct radv_shader_variant));
 			if (!variant) {
-				pthread_mutex_unlock(&cache->mutex);
+				pthread_mutex_unlock(&shard->mutex);
 				return false;
 			}
 
@@ -345,7 +363,7 @@ radv_create_shader_variants_from_pipeline_cache(struct radv_device *device,
 			p_atomic_inc(&entry->variants[i]->ref_count);
 
 	memcpy(variants, entry->variants, sizeof(entry->variants));
-	pthread_mutex_unlock(&cache->mutex);
+	pthread_mutex_unlock(&shard->mutex);
 	return true;
 }
 
@@ -360,8 +378,11 @@ radv_pipeline_cache_insert_shaders(struct radv_device *device,
 	if (!cache)
 		cache = device->mem_cache;
 
-	pthread_mutex_lock(&cache->mutex);
-	struct cache_entry *entry = radv_pipeline_cache_search_unlocked(cache, sha1);
+	struct radv_pipeline_cache_shard *shard =
+		radv_pipeline_cache_get_shard(cache, sha1);
+
+	pthread_mutex_lock(&shard->mutex);
+	struct cache_entry *entry = radv_pipeline_cache_search_unlocked(shard, sha1);
 	if (entry) {
 		for (int i = 0; i < MESA_SHADER_STAGES; ++i) {
 			if (entry->variants[i]) {
@@ -373,7 +394,7 @@ radv_pipeline_cache_insert_shaders(struct radv_device *device,
 			if (variants[i])
 				p_atomic_inc(&variants[i]->ref_count);
 		}
-		pthread_mutex_unlock(&cache->mutex);
+		pthread_mutex_unlock(&shard->mutex);
 		return;
 	}
 
@@ -381,7 +402,7 @@ radv_pipeline_cache_insert_shaders(struct radv_device *device,
 	 * present in the cache.
 	 */
 	if (radv_is_cache_disabled(device)) {
-		pthread_mutex_unlock(&cache->mutex);
+		pthread_mutex_unlock(&shard->mutex);
 		return;
 	}
 
@@ -394,7 +415,7 @@ radv_pipeline_cache_insert_shaders(struct radv_device *device,
 	entry = vk_alloc(&cache->alloc, size, 8,
 			   VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
 	if (!entry) {
-		pthread_mutex_unlock(&cache->mutex);
+		pthread_mutex_unlock(&shard->mutex);
 		return;
 	}
 
@@ -448,7 +469,7 @@ radv_pipeline_cache_insert_shaders(struct radv_device *device,
 	radv_pipeline_cache_add_entry(cache, entry);
 
 	cache->modified = true;
-	pthread_mutex_unlock(&cache->mutex);
+	pthread_mutex_unlock(&shard->mutex);
 	return;
 }
 
@@ -556,6 +577,13 @@ void radv_DestroyPipelineCache(
 	vk_free2(&device->alloc, pAllocator, cache);
 }
 
+static void
+radv_pipeline_cache_unlock_all(struct radv_pipeline_cache *cache)
+{
+	for (unsigned s = 0; s < RADV_PIPELINE_CACHE_SHARDS; ++s)
+		pthread_mutex_unlock(&cache->shards[s].mutex);
+}
+
 VkResult radv_GetPipelineCacheData(
 	VkDevice                                    _device,
 	VkPipelineCache                             _cache,
@@ -567,16 +595,20 @@ VkResult radv_GetPipelineCacheData(
 	struct cache_header *header;
 	VkResult result = VK_SUCCESS;
 
-	pthread_mutex_lock(&cache->mutex);
+	/* Shards are always locked in the same order, so this can't deadlock. */
+	size_t size = sizeof(*header);
+	for (unsigned s = 0; s < RADV_PIPELINE_CACHE_SHARDS; ++s) {
+		pthread_mutex_lock(&cache->shards[s].mutex);
+		size += cache->shards[s].total_size;
+	}
 
-	const size_t size = sizeof(*header) + cache->total_size;
 	if (pData == NULL) {
-		pthread_mutex_unlock(&cache->mutex);
+		radv_pipeline_cache_unlock_all(cache);
 		*pDataSize = size;
 		return VK_SUCCESS;
 	}
 	if (*pDataSize < sizeof(*header)) {
-		pthread_mutex_unlock(&cache->mutex);
+		radv_pipeline_cache_unlock_all(cache);
 		*pDataSize = 0;
 		return VK_INCOMPLETE;
 	}
@@ -590,24 +622,29 @@ VkResult radv_GetPipelineCacheData(
 	p += header->header_size;
 
 	struct cache_entry *entry;
-	for (uint32_t i = 0; i < cache->table_size; i++) {
-		if (!cache->hash_table[i])
-			continue;
-		entry = cache->hash_table[i];
-		const uint32_t size = entry_size(entry);
-		if (end < p + size) {
-			result = VK_INCOMPLETE;
-			break;
-		}
+	for (unsigned s = 0; s < RADV_PIPELINE_CACHE_SHARDS &&
+			     result == VK_SUCCESS; ++s) {
+		struct radv_pipeline_cache_shard *shard = &cache->shards[s];
+
+		for (uint32_t i = 0; i < shard->table_size; i++) {
+			if (!shard->hash_table[i])
+				continue;
+			entry = shard->hash_table[i];
+			const uint32_t size = entry_size(entry);
+			if (end < p + size) {
+				result = VK_INCOMPLETE;
+				break;
+			}
 
-		memcpy(p, entry, size);
-		for(int j = 0; j < MESA_SHADER_STAGES; ++j)
-			((struct cache_entry*)p)->variants[j] = NULL;
-		p += size;
+			memcpy(p, entry, size);
+			for(int j = 0; j < MESA_SHADER_STAGES; ++j)
+				((struct cache_entry*)p)->variants[j] = NULL;
+			p += size;
+		}
 	}
 	*pDataSize = p - pData;
 
-	pthread_mutex_unlock(&cache->mutex);
+	radv_pipeline_cache_unlock_all(cache);
 	return result;
 }
 
@@ -615,14 +652,23 @@ static void
 radv_pipeline_cache_merge(struct radv_pipeline_cache *dst,
 			  struct radv_pipeline_cache *src)
 {
-	for (uint32_t i = 0; i < src->table_size; i++) {
-		struct cache_entry *entry = src->hash_table[i];
-		if (!entry || radv_pipeline_cache_search(dst, entry->sha1))
-			continue;
+	for (unsigned s = 0; s < RADV_PIPELINE_CACHE_SHARDS; ++s) {
+		struct radv_pipeline_cache_shard *src_shard = &src->shards[s];
+		struct radv_pipeline_cache_shard *dst_shard = &dst->shards[s];
+
+		pthread_mutex_lock(&dst_shard->mutex);
 
-		radv_pipeline_cache_add_entry(dst, entry);
+		for (uint32_t i = 0; i < src_shard->table_size; i++) {
+			struct cache_entry *entry = src_shard->hash_table[i];
+			if (!entry || radv_pipeline_cache_search_unlocked(dst_shard, entry->sha1))
+				continue;
+
+			radv_pipeline_cache_add_entry(dst, entry);
+
+			src_shard->hash_table[i] = NULL;
+		}
 
-		src->hash_table[i] = NULL;
+		pthread_mutex_unlock(&dst_shard->mutex);
 	}
 }
 
@@ -48,6 +48,7 @@
 #include "compiler/shader_enums.h"
 #include "util/macros.h"
 #include "util/list.h"
+#include "util/u_queue.h"
 #include "util/xmlconfig.h"
 #include "main/macros.h"
 #include "vk_alloc.h"
@@ -355,14 +356,23 @@ bool radv_physical_device_extension_supported(struct radv_physical_device *dev,
 
 struct cache_entry;
 
-struct radv_pipeline_cache {
-	struct radv_device *                          device;
+/* Pipeline caches are split into shards by hash, each with its own lock, so
+ * that threads looking up different pipelines don't wait for each other.
+ */
+#define RADV_PIPELINE_CACHE_SHARDS 16
+
+struct radv_pipeline_cache_shard {
 	pthread_mutex_t                              mutex;
 
 	uint32_t                                     total_size;
 	uint32_t                                     table_size;
 	uint32_t                                     kernel_count;
 	struct cache_entry **                        hash_table;
+};
+
+struct radv_pipeline_cache {
+	struct radv_device *                          device;
+	struct radv_pipeline_cache_shard             shards[RADV_PIPELINE_CACHE_SHARDS];
 	bool                                         modified;
 
 	VkAllocationCallbacks                        alloc;
@@ -527,6 +537,10 @@ struct radv_meta_state {
 		VkDescriptorSetLayout                     img_ds_layout;
 		VkPipeline pipeline;
 		VkPipeline pipeline_3d;
+		VkPipelineLayout                          batch_p_layout;
+		VkDescriptorSetLayout                     batch_ds_layout;
+		VkPipeline batch_pipeline;
+		VkPipeline batch_pipeline_3d;
 	} btoi;
 	struct {
 		VkPipelineLayout                          img_p_layout;
@@ -736,6 +750,12 @@ struct radv_device {
 
 	/* Whether anisotropy is forced with RADV_TEX_ANISO (-1 is disabled). */
 	int force_aniso;
+
+	/* Threads that build the pipelines of vkCreate*Pipelines calls which
+	 * create more than one pipeline. Not initialized with
+	 * RADV_DEBUG=nothreadpipelines or on single core systems.
+	 */
+	struct util_queue pipeline_queue;
 };
 
 struct radv_device_memory {
@@ -1019,6 +1039,17 @@ struct radv_descriptor_state {
 	struct radv_push_descriptor_set push_set;
 	bool push_dirty;
 	uint32_t dynamic_buffers[4 * MAX_DYNAMIC_BUFFERS];
+
+	/* The last uploads of the indirect descriptor set pointers and of the
+	 * push constants, which are only uploaded again once their contents
+	 * change. Binding a new pipeline just emits the old addresses.
+	 */
+	uint64_t indirect_descriptor_sets_va;
+	bool indirect_descriptor_sets_dirty;
+	uint64_t push_constants_va;
+	uint32_t push_constants_size;
+	uint32_t push_constants_dynamic_offset_count;
+	bool push_constants_dirty;
 };
 
 struct radv_cmd_state {
@@ -1075,11 +1106,19 @@ struct radv_cmd_state {
 	bool context_roll_without_scissor_emitted;
 };
 
+#define RADV_CMD_POOL_MAX_UPLOAD_BOS 8
+
 struct radv_cmd_pool {
 	VkAllocationCallbacks                        alloc;
 	struct list_head                             cmd_buffers;
 	struct list_head                             free_cmd_buffers;
 	uint32_t queue_family_index;
+
+	/* Upload buffers retired by command buffer resets, most recent
+	 * first, handed out again when a command buffer needs to grow.
+	 */
+	struct list_head                             upload_bos;
+	unsigned                                     num_upload_bos;
 };
 
 struct radv_cmd_buffer_upload {
@@ -1191,6 +1230,25 @@ void si_cp_dma_clear_buffer(struct radv_cmd_buffer *cmd_buffer, uint64_t va,
 			    uint64_t size, unsigned value);
 void si_cp_dma_wait_for_idle(struct radv_cmd_buffer *cmd_buffer);
 
+void radv_sdma_copy_buffer(struct radv_cmd_buffer *cmd_buffer,
+			   uint64_t src_va, uint64_t dst_va, uint64_t size);
+void radv_sdma_fill_buffer(struct radv_cmd_buffer *cmd_buffer,
+			   uint64_t va, uint64_t size, uint32_t value);
+void radv_sdma_write_data(struct radv_cmd_buffer *cmd_buffer, uint64_t va,
+			  unsigned count, const uint32_t *data);
+void radv_sdma_write_timestamp(struct radv_cmd_buffer *cmd_buffer, uint64_t va);
+void radv_sdma_wait_mem(struct radv_cmd_buffer *cmd_buffer, uint64_t va,
+			uint32_t ref, uint32_t mask);
+void radv_sdma_copy_buffer_image(struct radv_cmd_buffer *cmd_buffer,
+				 struct radv_buffer *buffer,
+				 struct radv_image *image,
+				 const VkBufferImageCopy *region,
+				 bool to_image);
+void radv_sdma_copy_image(struct radv_cmd_buffer *cmd_buffer,
+			  struct radv_image *src_image,
+			  struct radv_image *dst_image,
+			  const VkImageCopy *region);
+
 void radv_set_db_count_control(struct radv_cmd_buffer *cmd_buffer);
 bool
 radv_cmd_buffer_upload_alloc(struct radv_cmd_buffer *cmd_buffer,
@@ -1282,6 +1340,13 @@ radv_get_descriptors_state(struct radv_cmd_buffer *cmd_buffer,
 	return &cmd_buffer->descriptors[bind_point];
 }
 
+static inline void
+radv_invalidate_push_constants(struct radv_cmd_buffer *cmd_buffer)
+{
+	for (unsigned i = 0; i < VK_PIPELINE_BIND_POINT_RANGE_SIZE; i++)
+		cmd_buffer->descriptors[i].push_constants_dirty = true;
+}
+
 /*
  * Takes x,y,z as exact numbers of invocations, instead of blocks.
  *
@@ -1729,6 +1794,7 @@ void radv_image_view_init(struct radv_image_view *view,
 			  const VkImageViewCreateInfo* pCreateInfo);
 
 VkFormat radv_get_aspect_format(struct radv_image *image, VkImageAspectFlags mask);
+unsigned radv_plane_from_aspect(VkImageAspectFlags mask);
 
 struct radv_sampler_ycbcr_conversion {
 	VkFormat format;
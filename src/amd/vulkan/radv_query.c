@@ -1302,6 +1302,11 @@ void radv_CmdCopyQueryPoolResults(
 	uint64_t dest_va = radv_buffer_get_va(dst_buffer->bo);
 	dest_va += dst_buffer->offset + dstOffset;
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		radv_finishme("vkCmdCopyQueryPoolResults on the transfer queue");
+		return;
+	}
+
 	radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, pool->bo);
 	radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, dst_buffer->bo);
 
@@ -1718,6 +1723,11 @@ void radv_CmdWriteTimestamp(
 
 	radv_cs_add_buffer(cmd_buffer->device->ws, cs, pool->bo);
 
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		radv_sdma_write_timestamp(cmd_buffer, query_va);
+		return;
+	}
+
 	emit_query_flush(cmd_buffer, pool);
 
 	int num_queries = 1;
@@ -0,0 +1,392 @@
+/*
+ * based on cik_sdma.c
+ * Copyright 2010 Jerome Glisse <glisse@freedesktop.org>
+ * Copyright 2014,2015 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* Command emission for the transfer queue, which runs on the async DMA
+ * (SDMA) engines of CIK+.  None of the PM4 packets are available there,
+ * so everything the transfer queue supports is implemented here.
+ */
+
+#include "radv_private.h"
+#include "radv_cs.h"
+#include "sid.h"
+#include "vk_format.h"
+#include "util/u_math.h"
+
+/* A linear surface in units of elements: texels or compressed blocks. */
+struct radv_sdma_linear {
+	uint64_t va;
+	unsigned bpe;
+	unsigned pitch;
+	unsigned slice_pitch;
+};
+
+static unsigned
+radv_sdma_count(struct radv_cmd_buffer *cmd_buffer, unsigned count)
+{
+	/* SDMA 4 encodes all counts minus one. */
+	return cmd_buffer->device->physical_device->rad_info.chip_class >= GFX9 ?
+	       count - 1 : count;
+}
+
+void
+radv_sdma_copy_buffer(struct radv_cmd_buffer *cmd_buffer,
+		      uint64_t src_va, uint64_t dst_va, uint64_t size)
+{
+	struct radeon_cmdbuf *cs = cmd_buffer->cs;
+	unsigned ncopy = DIV_ROUND_UP(size, CIK_SDMA_COPY_MAX_SIZE);
+
+	radeon_check_space(cmd_buffer->device->ws, cs, ncopy * 7);
+
+	for (unsigned i = 0; i < ncopy; i++) {
+		unsigned csize = MIN2(size, CIK_SDMA_COPY_MAX_SIZE);
+
+		radeon_emit(cs, CIK_SDMA_PACKET(CIK_SDMA_OPCODE_COPY,
+						CIK_SDMA_COPY_SUB_OPCODE_LINEAR, 0));
+		radeon_emit(cs, radv_sdma_count(cmd_buffer, csize));
+		radeon_emit(cs, 0); /* src/dst endian swap */
+		radeon_emit(cs, src_va);
+		radeon_emit(cs, src_va >> 32);
+		radeon_emit(cs, dst_va);
+		radeon_emit(cs, dst_va >> 32);
+
+		src_va += csize;
+		dst_va += csize;
+		size -= csize;
+	}
+}
+
+void
+radv_sdma_fill_buffer(struct radv_cmd_buffer *cmd_buffer,
+		      uint64_t va, uint64_t size, uint32_t value)
+{
+	struct radeon_cmdbuf *cs = cmd_buffer->cs;
+	unsigned nfill = DIV_ROUND_UP(size, CIK_SDMA_COPY_MAX_SIZE);
+
+	assert(!(va & 3));
+	assert(!(size & 3));
+
+	radeon_check_space(cmd_buffer->device->ws, cs, nfill * 5);
+
+	for (unsigned i = 0; i < nfill; i++) {
+		unsigned csize = MIN2(size, CIK_SDMA_COPY_MAX_SIZE);
+
+		radeon_emit(cs, CIK_SDMA_PACKET(CIK_SDMA_PACKET_CONSTANT_FILL, 0,
+						0x8000 /* dword fill */));
+		radeon_emit(cs, va);
+		radeon_emit(cs, va >> 32);
+		radeon_emit(cs, value);
+		radeon_emit(cs, radv_sdma_count(cmd_buffer, csize));
+
+		va += csize;
+		size -= csize;
+	}
+}
+
+void
+radv_sdma_write_data(struct radv_cmd_buffer *cmd_buffer, uint64_t va,
+		     unsigned count, const uint32_t *data)
+{
+	struct radeon_cmdbuf *cs = cmd_buffer->cs;
+
+	assert(count);
+	radeon_check_space(cmd_buffer->device->ws, cs, count + 4);
+
+	radeon_emit(cs, CIK_SDMA_PACKET(CIK_SDMA_OPCODE_WRITE,
+					SDMA_WRITE_SUB_OPCODE_LINEAR, 0));
+	radeon_emit(cs, va);
+	radeon_emit(cs, va >> 32);
+	radeon_emit(cs, radv_sdma_count(cmd_buffer, count));
+	radeon_emit_array(cs, data, count);
+}
+
+void
+radv_sdma_write_timestamp(struct radv_cmd_buffer *cmd_buffer, uint64_t va)
+{
+	struct radeon_cmdbuf *cs = cmd_buffer->cs;
+
+	radeon_check_space(cmd_buffer->device->ws, cs, 3);
+
+	radeon_emit(cs, CIK_SDMA_PACKET(CIK_SDMA_OPCODE_TIMESTAMP,
+					SDMA_TS_SUB_OPCODE_GET_GLOBAL_TIMESTAMP, 0));
+	radeon_emit(cs, va);
+	radeon_emit(cs, va >> 32);
+}
+
+void
+radv_sdma_wait_mem(struct radv_cmd_buffer *cmd_buffer, uint64_t va,
+		   uint32_t ref, uint32_t mask)
+{
+	struct radeon_cmdbuf *cs = cmd_buffer->cs;
+
+	radeon_check_space(cmd_buffer->device->ws, cs, 6);
+
+	radeon_emit(cs, CIK_SDMA_PACKET(CIK_SDMA_OPCODE_POLL_REGMEM, 0, 0) |
+			S_SDMA_POLL_REGMEM_FUNC(3) | /* equal */
+			S_SDMA_POLL_REGMEM_MEM(1));
+	radeon_emit(cs, va);
+	radeon_emit(cs, va >> 32);
+	radeon_emit(cs, ref);
+	radeon_emit(cs, mask);
+	radeon_emit(cs, (0xfff << 16) | 10); /* retry count, poll interval */
+}
+
+static bool
+radv_sdma_get_image_surf(struct radv_cmd_buffer *cmd_buffer,
+			 struct radv_image *image,
+			 const VkImageSubresourceLayers *subres,
+			 struct radv_sdma_linear *surf)
+{
+	unsigned plane_id = radv_plane_from_aspect(subres->aspectMask);
+	struct radeon_surf *surface = &image->planes[plane_id].surface;
+	unsigned level = subres->mipLevel;
+	uint64_t slice_size;
+
+	if (!surface->is_linear)
+		return false;
+
+	surf->va = radv_buffer_get_va(image->bo) + image->offset +
+		   image->planes[plane_id].offset;
+	surf->bpe = surface->bpe;
+
+	if (cmd_buffer->device->physical_device->rad_info.chip_class >= GFX9) {
+		surf->va += surface->u.gfx9.offset[level];
+		surf->pitch = surface->u.gfx9.surf_pitch;
+		slice_size = surface->u.gfx9.surf_slice_size;
+	} else {
+		surf->va += surface->u.legacy.level[level].offset;
+		surf->pitch = surface->u.legacy.level[level].nblk_x;
+		slice_size = (uint64_t)surface->u.legacy.level[level].slice_size_dw * 4;
+	}
+	surf->slice_pitch = slice_size / surf->bpe;
+
+	radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, image->bo);
+	return true;
+}
+
+static bool
+radv_sdma_fits_sub_window(struct radv_cmd_buffer *cmd_buffer,
+			  const struct radv_sdma_linear *surf,
+			  const VkOffset3D *offset,
+			  const VkExtent3D *extent)
+{
+	enum radeon_family family = cmd_buffer->device->physical_device->rad_info.family;
+	enum chip_class chip_class = cmd_buffer->device->physical_device->rad_info.chip_class;
+
+	if (surf->va % 4 || (surf->pitch * surf->bpe) % 4)
+		return false;
+
+	/* Everything has to fit into the bitfields. */
+	if (surf->pitch > (1 << 14) || surf->slice_pitch > (1 << 28) ||
+	    offset->x + extent->width > (1 << 14) ||
+	    offset->y + extent->height > (1 << 14) ||
+	    offset->z + extent->depth > (1 << 11))
+		return false;
+
+	if (chip_class == CIK &&
+	    (extent->width == (1 << 14) || extent->height == (1 << 14) ||
+	     extent->depth == (1 << 11)))
+		return false;
+
+	/* Hang on some CIK parts when the rectangle touches the limit. */
+	if ((family == CHIP_BONAIRE || family == CHIP_KAVERI) &&
+	    (offset->x + extent->width == (1 << 14) ||
+	     offset->y + extent->height == (1 << 14)))
+		return false;
+
+	return true;
+}
+
+static void
+radv_sdma_copy_linear(struct radv_cmd_buffer *cmd_buffer,
+		      struct radv_sdma_linear src, VkOffset3D src_offset,
+		      struct radv_sdma_linear dst, VkOffset3D dst_offset,
+		      VkExtent3D extent)
+{
+	struct radeon_cmdbuf *cs = cmd_buffer->cs;
+
+	assert(src.bpe == dst.bpe);
+
+	/* The sub-window packet takes power of two element sizes, copy
+	 * 96-bit and 48-bit formats as three times as many smaller elements.
+	 */
+	if (!util_is_power_of_two_nonzero(src.bpe)) {
+		unsigned bpe = src.bpe & -src.bpe;
+		unsigned scale = src.bpe / bpe;
+
+		src.bpe = dst.bpe = bpe;
+		src.pitch *= scale;
+		src.slice_pitch *= scale;
+		dst.pitch *= scale;
+		dst.slice_pitch *= scale;
+		src_offset.x *= scale;
+		dst_offset.x *= scale;
+		extent.width *= scale;
+	}
+
+	if (!radv_sdma_fits_sub_window(cmd_buffer, &src, &src_offset, &extent) ||
+	    !radv_sdma_fits_sub_window(cmd_buffer, &dst, &dst_offset, &extent)) {
+		/* Row by row, which works for any layout. */
+		for (unsigned z = 0; z < extent.depth; z++) {
+			for (unsigned y = 0; y < extent.height; y++) {
+				uint64_t src_el = (uint64_t)(src_offset.z + z) * src.slice_pitch +
+						  (uint64_t)(src_offset.y + y) * src.pitch +
+						  src_offset.x;
+				uint64_t dst_el = (uint64_t)(dst_offset.z + z) * dst.slice_pitch +
+						  (uint64_t)(dst_offset.y + y) * dst.pitch +
+						  dst_offset.x;
+
+				radv_sdma_copy_buffer(cmd_buffer,
+						      src.va + src_el * src.bpe,
+						      dst.va + dst_el * dst.bpe,
+						      extent.width * src.bpe);
+			}
+		}
+		return;
+	}
+
+	radeon_check_space(cmd_buffer->device->ws, cs, 13);
+
+	radeon_emit(cs, CIK_SDMA_PACKET(CIK_SDMA_OPCODE_COPY,
+					CIK_SDMA_COPY_SUB_OPCODE_LINEAR_SUB_WINDOW, 0) |
+			(util_logbase2(src.bpe) << 29));
+	radeon_emit(cs, src.va);
+	radeon_emit(cs, src.va >> 32);
+	radeon_emit(cs, src_offset.x | (src_offset.y << 16));
+	radeon_emit(cs, src_offset.z | ((src.pitch - 1) << 16));
+	radeon_emit(cs, src.slice_pitch - 1);
+	radeon_emit(cs, dst.va);
+	radeon_emit(cs, dst.va >> 32);
+	radeon_emit(cs, dst_offset.x | (dst_offset.y << 16));
+	radeon_emit(cs, dst_offset.z | ((dst.pitch - 1) << 16));
+	radeon_emit(cs, dst.slice_pitch - 1);
+	if (cmd_buffer->device->physical_device->rad_info.chip_class == CIK) {
+		radeon_emit(cs, extent.width | (extent.height << 16));
+		radeon_emit(cs, extent.depth);
+	} else {
+		radeon_emit(cs, (extent.width - 1) | ((extent.height - 1) << 16));
+		radeon_emit(cs, extent.depth - 1);
+	}
+}
+
+/* Returns the image offset and extent of a region in elements, with
+ * array layers folded into Z.
+ */
+static void
+radv_sdma_image_region_el(struct radv_image *image,
+			  const VkImageSubresourceLayers *subres,
+			  const VkOffset3D *offset,
+			  const VkExtent3D *extent,
+			  VkOffset3D *offset_el,
+			  VkExtent3D *extent_el)
+{
+	VkFormat format = radv_get_aspect_format(image, subres->aspectMask);
+	unsigned bw = vk_format_get_blockwidth(format);
+	unsigned bh = vk_format_get_blockheight(format);
+
+	*offset_el = (VkOffset3D) {
+		.x = offset->x / bw,
+		.y = offset->y / bh,
+		.z = image->type == VK_IMAGE_TYPE_3D ? offset->z : subres->baseArrayLayer,
+	};
+	*extent_el = (VkExtent3D) {
+		.width = DIV_ROUND_UP(extent->width, bw),
+		.height = DIV_ROUND_UP(extent->height, bh),
+		.depth = image->type == VK_IMAGE_TYPE_3D ? extent->depth : subres->layerCount,
+	};
+}
+
+void
+radv_sdma_copy_buffer_image(struct radv_cmd_buffer *cmd_buffer,
+			    struct radv_buffer *buffer,
+			    struct radv_image *image,
+			    const VkBufferImageCopy *region,
+			    bool to_image)
+{
+	struct radv_sdma_linear img, buf;
+	VkOffset3D img_offset, buf_offset = {0};
+	VkExtent3D extent;
+
+	if (!radv_sdma_get_image_surf(cmd_buffer, image,
+				      &region->imageSubresource, &img)) {
+		radv_finishme("SDMA copies of tiled images");
+		return;
+	}
+
+	radv_sdma_image_region_el(image, &region->imageSubresource,
+				  &region->imageOffset, &region->imageExtent,
+				  &img_offset, &extent);
+
+	VkFormat format = radv_get_aspect_format(image, region->imageSubresource.aspectMask);
+	unsigned row_length = region->bufferRowLength ?
+			      region->bufferRowLength : region->imageExtent.width;
+	unsigned image_height = region->bufferImageHeight ?
+				region->bufferImageHeight : region->imageExtent.height;
+
+	buf.va = radv_buffer_get_va(buffer->bo) + buffer->offset + region->bufferOffset;
+	buf.bpe = img.bpe;
+	buf.pitch = DIV_ROUND_UP(row_length, vk_format_get_blockwidth(format));
+	buf.slice_pitch = buf.pitch *
+			  DIV_ROUND_UP(image_height, vk_format_get_blockheight(format));
+
+	radv_cs_add_buffer(cmd_buffer->device->ws, cmd_buffer->cs, buffer->bo);
+
+	if (to_image)
+		radv_sdma_copy_linear(cmd_buffer, buf, buf_offset, img, img_offset, extent);
+	else
+		radv_sdma_copy_linear(cmd_buffer, img, img_offset, buf, buf_offset, extent);
+}
+
+void
+radv_sdma_copy_image(struct radv_cmd_buffer *cmd_buffer,
+		     struct radv_image *src_image,
+		     struct radv_image *dst_image,
+		     const VkImageCopy *region)
+{
+	struct radv_sdma_linear src, dst;
+	VkOffset3D src_offset, dst_offset;
+	VkExtent3D src_extent, dst_extent;
+
+	if (!radv_sdma_get_image_surf(cmd_buffer, src_image,
+				      &region->srcSubresource, &src) ||
+	    !radv_sdma_get_image_surf(cmd_buffer, dst_image,
+				      &region->dstSubresource, &dst)) {
+		radv_finishme("SDMA copies of tiled images");
+		return;
+	}
+
+	radv_sdma_image_region_el(src_image, &region->srcSubresource,
+				  &region->srcOffset, &region->extent,
+				  &src_offset, &src_extent);
+	radv_sdma_image_region_el(dst_image, &region->dstSubresource,
+				  &region->dstOffset, &region->extent,
+				  &dst_offset, &dst_extent);
+
+	/* Copies between compressed and uncompressed formats give the extent
+	 * in units of the source, and a 2D array can be copied to a 3D image.
+	 */
+	src_extent.depth = MAX2(src_extent.depth, dst_extent.depth);
+
+	radv_sdma_copy_linear(cmd_buffer, src, src_offset, dst, dst_offset, src_extent);
+}
@@ -964,6 +964,14 @@ si_emit_cache_flush(struct radv_cmd_buffer *cmd_buffer)
 {
 	bool is_compute = cmd_buffer->queue_family_index == RADV_QUEUE_COMPUTE;
 
+	/* SDMA reads and writes memory directly, there are no caches to
+	 * flush and PM4 packets can't be executed anyway.
+	 */
+	if (cmd_buffer->queue_family_index == RADV_QUEUE_TRANSFER) {
+		cmd_buffer->state.flush_bits = 0;
+		return;
+	}
+
 	if (is_compute)
 		cmd_buffer->state.flush_bits &= ~(RADV_CMD_FLAG_FLUSH_AND_INV_CB |
 	                                          RADV_CMD_FLAG_FLUSH_AND_INV_CB_META |
@@ -59,6 +59,11 @@ struct radv_amdgpu_cs {
 	bool                        failed;
 	bool                        is_chained;
 
+	/* SDMA can't chain IBs with PM4 packets, DMA rings always take the
+	 * sysmem path.
+	 */
+	bool                        use_ib;
+
 	int                         buffer_hash_table[1024];
 	unsigned                    hw_ip;
 
@@ -277,6 +282,7 @@ static void radv_amdgpu_init_cs(struct radv_amdgpu_cs *cs,
 		cs->buffer_hash_table[i] = -1;
 
 	cs->hw_ip = ring_to_hw_ip(ring_type);
+	cs->use_ib = cs->ws->use_ib_bos && ring_type != RING_DMA;
 }
 
 static struct radeon_cmdbuf *
@@ -292,7 +298,7 @@ radv_amdgpu_cs_create(struct radeon_winsys *ws,
 	cs->ws = radv_amdgpu_winsys(ws);
 	radv_amdgpu_init_cs(cs, ring_type);
 
-	if (cs->ws->use_ib_bos) {
+	if (cs->use_ib) {
 		cs->ib_buffer = ws->buffer_create(ws, ib_size, 0,
 						  RADEON_DOMAIN_GTT,
 						  RADEON_FLAG_CPU_ACCESS |
@@ -339,7 +345,7 @@ static void radv_amdgpu_cs_grow(struct radeon_cmdbuf *_cs, size_t min_size)
 		return;
 	}
 
-	if (!cs->ws->use_ib_bos) {
+	if (!cs->use_ib) {
 		const uint64_t limit_dws = 0xffff8;
 		uint64_t ib_dws = MAX2(cs->base.cdw + min_size,
 				       MIN2(cs->base.max_dw * 2, limit_dws));
@@ -449,7 +455,7 @@ static bool radv_amdgpu_cs_finalize(struct radeon_cmdbuf *_cs)
 {
 	struct radv_amdgpu_cs *cs = radv_amdgpu_cs(_cs);
 
-	if (cs->ws->use_ib_bos) {
+	if (cs->use_ib) {
 		while (!cs->base.cdw || (cs->base.cdw & 7) != 0)
 			radeon_emit(&cs->base, 0xffff1000);
 
@@ -481,7 +487,7 @@ static void radv_amdgpu_cs_reset(struct radeon_cmdbuf *_cs)
 	cs->num_buffers = 0;
 	cs->num_virtual_buffers = 0;
 
-	if (cs->ws->use_ib_bos) {
+	if (cs->use_ib) {
 		cs->ws->base.cs_add_buffer(&cs->base, cs->ib_buffer);
 
 		for (unsigned i = 0; i < cs->num_old_ib_buffers; ++i)
@@ -620,7 +626,7 @@ static void radv_amdgpu_cs_execute_secondary(struct radeon_cmdbuf *_parent,
 		radv_amdgpu_cs_add_buffer(&parent->base, child->virtual_buffers[i]);
 	}
 
-	if (parent->ws->use_ib_bos) {
+	if (parent->use_ib) {
 		if (parent->base.cdw + 4 > parent->base.max_dw)
 			radv_amdgpu_cs_grow(&parent->base, 4);
 
@@ -1011,7 +1017,9 @@ static int radv_amdgpu_winsys_cs_submit_sysmem(struct radeon_winsys_ctx *_ctx,
 	uint32_t pad_word = 0xffff1000U;
 	bool emit_signal_sem = sem_info->cs_emit_signal;
 
-	if (radv_amdgpu_winsys(ws)->info.chip_class == SI)
+	if (cs0->hw_ip == AMDGPU_HW_IP_DMA)
+		pad_word = CIK_SDMA_PACKET(CIK_SDMA_OPCODE_NOP, 0, 0);
+	else if (radv_amdgpu_winsys(ws)->info.chip_class == SI)
 		pad_word = 0x80000000;
 
 	assert(cs_count);
@@ -1208,7 +1216,7 @@ static int radv_amdgpu_winsys_cs_submit(struct radeon_winsys_ctx *_ctx,
 	int ret;
 
 	assert(sem_info);
-	if (!cs->ws->use_ib_bos) {
+	if (!cs->use_ib) {
 		ret = radv_amdgpu_winsys_cs_submit_sysmem(_ctx, queue_idx, sem_info, bo_list, cs_array,
 							   cs_count, initial_preamble_cs, continue_preamble_cs, _fence);
 	} else if (can_patch && cs->ws->batchchain) {
@@ -1264,7 +1272,7 @@ static void radv_amdgpu_winsys_cs_dump(struct radeon_cmdbuf *_cs,
 	void *ib = cs->base.buf;
 	int num_dw = cs->base.cdw;
 
-	if (cs->ws->use_ib_bos) {
+	if (cs->use_ib) {
 		ib = radv_amdgpu_winsys_get_cpu_addr(cs, cs->ib.ib_mc_address);
 		num_dw = cs->ib.size;
 	}
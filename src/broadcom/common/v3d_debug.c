@@ -55,6 +55,7 @@ static const struct debug_control debug_control[] = {
         { "cs",          V3D_DEBUG_CS},
         { "always_flush", V3D_DEBUG_ALWAYS_FLUSH},
         { "precompile",  V3D_DEBUG_PRECOMPILE},
+        { "no_tmu_pipelining", V3D_DEBUG_NO_TMU_PIPELINING},
         { NULL,    0 }
 };
 
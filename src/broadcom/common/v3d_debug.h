@@ -56,6 +56,7 @@ extern uint32_t V3D_DEBUG;
 #define V3D_DEBUG_ALWAYS_FLUSH		(1 << 12)
 #define V3D_DEBUG_CLIF			(1 << 13)
 #define V3D_DEBUG_PRECOMPILE		(1 << 14)
+#define V3D_DEBUG_NO_TMU_PIPELINING	(1 << 15)
 
 #ifdef HAVE_ANDROID_PLATFORM
 #define LOG_TAG "BROADCOM-MESA"
@@ -113,17 +113,104 @@ vir_emit_thrsw(struct v3d_compile *c)
         if (c->threads == 1)
                 return;
 
-        /* Always thread switch after each texture operation for now.
-         *
-         * We could do better by batching a bunch of texture fetches up and
-         * then doing one thread switch and collecting all their results
-         * afterward.
-         */
         c->last_thrsw = vir_NOP(c);
         c->last_thrsw->qpu.sig.thrsw = true;
         c->last_thrsw_at_top_level = !c->in_control_flow;
 }
 
+/**
+ * Texture lookups are pipelined: each one is sent to the TMU as it's
+ * emitted, but its results are only collected when something reads them,
+ * so that independent lookups share a single thread switch and their
+ * latencies overlap.  This collects the results of all the outstanding
+ * lookups.
+ */
+void
+ntq_flush_tmu(struct v3d_compile *c)
+{
+        if (!c->tmu.flush_count)
+                return;
+
+        vir_emit_thrsw(c);
+
+        for (int i = 0; i < c->tmu.flush_count; i++) {
+                for (int j = 0; j < 4; j++) {
+                        if (c->tmu.flush[i].component_mask & (1 << j)) {
+                                ntq_store_dest(c, c->tmu.flush[i].dest, j,
+                                               vir_LDTMU(c));
+                        }
+                }
+        }
+
+        if (c->tmu.flush_count > 1)
+                c->tmu_pipelined = true;
+
+        c->tmu.input_fifo_size = 0;
+        c->tmu.output_fifo_size = 0;
+        c->tmu.flush_count = 0;
+}
+
+static bool
+ntq_def_is_pending_tmu(struct v3d_compile *c, nir_ssa_def *def)
+{
+        for (int i = 0; i < c->tmu.flush_count; i++) {
+                if (&c->tmu.flush[i].dest->ssa == def)
+                        return true;
+        }
+
+        return false;
+}
+
+static bool
+ntq_src_is_pending_tmu(nir_src *src, void *state)
+{
+        struct v3d_compile *c = state;
+
+        /* Stop the iteration at the first pending source. */
+        return !(src->is_ssa && ntq_def_is_pending_tmu(c, src->ssa));
+}
+
+/**
+ * Returns whether the outstanding TMU lookups need to be collected before
+ * sending a new one for \p instr, either because it reads their results or
+ * because it wouldn't fit in the TMU FIFOs along with them.
+ */
+bool
+ntq_tmu_lookup_needs_flush(struct v3d_compile *c, nir_instr *instr,
+                           uint32_t input_words, uint32_t output_words)
+{
+        if (!c->tmu.flush_count)
+                return false;
+
+        uint32_t fifo_size = V3D_TMU_FIFO_SIZE / c->threads;
+
+        return (c->tmu.flush_count + 1 > V3D_MAX_TMU_LOOKUPS / c->threads ||
+                c->tmu.input_fifo_size + input_words > fifo_size ||
+                c->tmu.output_fifo_size + output_words > fifo_size ||
+                !nir_foreach_src(instr, ntq_src_is_pending_tmu, c));
+}
+
+/**
+ * Records a lookup that was just sent to the TMU, whose \p component_mask
+ * results will be collected into \p dest by the next ntq_flush_tmu().
+ */
+void
+ntq_add_pending_tmu_flush(struct v3d_compile *c, nir_dest *dest,
+                          uint32_t component_mask, uint32_t input_words)
+{
+        assert(dest->is_ssa);
+        assert(c->tmu.flush_count < ARRAY_SIZE(c->tmu.flush));
+
+        c->tmu.input_fifo_size += input_words;
+        c->tmu.output_fifo_size += util_bitcount(component_mask);
+        c->tmu.flush[c->tmu.flush_count].dest = dest;
+        c->tmu.flush[c->tmu.flush_count].component_mask = component_mask;
+        c->tmu.flush_count++;
+
+        if (c->disable_tmu_pipelining)
+                ntq_flush_tmu(c);
+}
+
 static uint32_t
 v3d_general_tmu_op(nir_intrinsic_instr *instr)
 {
@@ -181,6 +268,11 @@ static void
 ntq_emit_tmu_general(struct v3d_compile *c, nir_intrinsic_instr *instr,
                      bool is_shared_or_scratch)
 {
+        /* General TMU operations aren't pipelined, so they go in the TMU
+         * FIFOs after all the outstanding texture lookups.
+         */
+        ntq_flush_tmu(c);
+
         /* XXX perf: We should turn add/sub of 1 to inc/dec.  Perhaps NIR
          * wants to have support for inc/dec?
          */
@@ -423,6 +515,10 @@ struct qreg
 ntq_get_src(struct v3d_compile *c, nir_src src, int i)
 {
         struct hash_entry *entry;
+
+        if (src.is_ssa && ntq_def_is_pending_tmu(c, src.ssa))
+                ntq_flush_tmu(c);
+
         if (src.is_ssa) {
                 entry = _mesa_hash_table_search(c->def_ht, src.ssa);
                 assert(i < src.ssa->num_components);
@@ -526,10 +622,12 @@ ntq_emit_tex(struct v3d_compile *c, nir_tex_instr *instr)
                 break;
         }
 
-        if (c->devinfo->ver >= 40)
+        if (c->devinfo->ver >= 40) {
                 v3d40_vir_emit_tex(c, instr);
-        else
+        } else {
+                ntq_flush_tmu(c);
                 v3d33_vir_emit_tex(c, instr);
+        }
 }
 
 static struct qreg
@@ -1663,6 +1761,7 @@ ntq_emit_intrinsic(struct v3d_compile *c, nir_intrinsic_instr *instr)
         case nir_intrinsic_image_deref_atomic_xor:
         case nir_intrinsic_image_deref_atomic_exchange:
         case nir_intrinsic_image_deref_atomic_comp_swap:
+                ntq_flush_tmu(c);
                 v3d40_vir_emit_image_load_store(c, instr);
                 break;
 
@@ -1852,11 +1951,15 @@ ntq_emit_intrinsic(struct v3d_compile *c, nir_intrinsic_instr *instr)
                  * sure that the TMU operations before the barrier are flushed
                  * before the ones after the barrier.  That is currently
                  * handled by having a THRSW in each of them and a LDTMU
-                 * series or a TMUWT after.
+                 * series or a TMUWT after, once any pipelined texture
+                 * lookups are collected.
                  */
+                ntq_flush_tmu(c);
                 break;
 
         case nir_intrinsic_barrier:
+                ntq_flush_tmu(c);
+
                 /* Emit a TSY op to get all invocations in the workgroup
                  * (actually supergroup) to block until the last invocation
                  * reaches the TSY op.
@@ -2158,6 +2261,9 @@ ntq_emit_block(struct v3d_compile *c, nir_block *block)
         nir_foreach_instr(instr, block) {
                 ntq_emit_instr(c, instr);
         }
+
+        /* Don't keep texture lookups outstanding across blocks. */
+        ntq_flush_tmu(c);
 }
 
 static void ntq_emit_cf_list(struct v3d_compile *c, struct exec_list *list);
@@ -2504,13 +2610,11 @@ v3d_nir_to_vir(struct v3d_compile *c)
 
         vir_check_payload_w(c);
 
-        /* XXX perf: On VC4, we do a VIR-level instruction scheduling here.
-         * We used that on that platform to pipeline TMU writes and reduce the
-         * number of thread switches, as well as try (mostly successfully) to
-         * reduce maximum register pressure to allow more threads.  We should
-         * do something of that sort for V3D -- either instruction scheduling
-         * here, or delay the the THRSW and LDTMUs from our texture
-         * instructions until the results are needed.
+        /* Unlike VC4, there's no VIR-level instruction scheduling here.
+         * Texture lookups are pipelined as we emit them instead, with the
+         * THRSW and LDTMUs delayed until the results are needed (see
+         * ntq_flush_tmu()).  If that costs us threads or spills,
+         * v3d_compile() retries with pipelining disabled.
          */
 
         if (V3D_DEBUG & (V3D_DEBUG_VIR |
@@ -2537,14 +2641,20 @@ v3d_nir_to_vir(struct v3d_compile *c)
                         break;
 
                 if (c->threads == min_threads) {
+                        c->failed = true;
+
+                        /* v3d_compile() will retry without pipelining. */
+                        if (c->tmu_pipelined)
+                                return;
+
                         fprintf(stderr, "Failed to register allocate at %d threads:\n",
                                 c->threads);
                         vir_dump(c);
-                        c->failed = true;
                         return;
                 }
 
                 c->threads /= 2;
+                c->ra_reduced_threads = true;
 
                 if (c->threads == 1)
                         vir_remove_thrsw(c);
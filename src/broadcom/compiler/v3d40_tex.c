@@ -87,6 +87,27 @@ v3d40_vir_emit_tex(struct v3d_compile *c, nir_tex_instr *instr)
                 .disable_autolod = instr->op == nir_texop_tg4
         };
 
+        /* Limit the number of channels returned to both how many the NIR
+         * instruction writes and how many the instruction could produce.
+         */
+        assert(instr->dest.is_ssa);
+        p0_unpacked.return_words_of_texture_data =
+                nir_ssa_def_components_read(&instr->dest.ssa);
+
+        /* Collect the results of the outstanding lookups before we start
+         * writing this one's parameters, if it needs them or there isn't
+         * room for it.  Each source takes at most one TMU write per
+         * component.
+         */
+        uint32_t max_tmu_writes = 0;
+        for (unsigned i = 0; i < instr->num_srcs; i++)
+                max_tmu_writes += nir_src_num_components(instr->src[i].src);
+
+        if (ntq_tmu_lookup_needs_flush(c, &instr->instr, max_tmu_writes,
+                                       util_bitcount(p0_unpacked.return_words_of_texture_data))) {
+                ntq_flush_tmu(c);
+        }
+
         int non_array_components = instr->coord_components - instr->is_array;
         struct qreg s;
 
@@ -168,13 +189,6 @@ v3d40_vir_emit_tex(struct v3d_compile *c, nir_tex_instr *instr)
                 }
         }
 
-        /* Limit the number of channels returned to both how many the NIR
-         * instruction writes and how many the instruction could produce.
-         */
-        assert(instr->dest.is_ssa);
-        p0_unpacked.return_words_of_texture_data =
-                nir_ssa_def_components_read(&instr->dest.ssa);
-
         /* Word enables can't ask for more channels than the output type could
          * provide (2 for f16, 4 for 32-bit).
          */
@@ -222,18 +236,18 @@ v3d40_vir_emit_tex(struct v3d_compile *c, nir_tex_instr *instr)
                 vir_TMU_WRITE(c, V3D_QPU_WADDR_TMUS, s, &tmu_writes);
         }
 
-        vir_emit_thrsw(c);
-
         /* The input FIFO has 16 slots across all threads, so make sure we
          * don't overfill our allocation.
          */
         while (tmu_writes > 16 / c->threads)
                 c->threads /= 2;
 
-        for (int i = 0; i < 4; i++) {
-                if (p0_unpacked.return_words_of_texture_data & (1 << i))
-                        ntq_store_dest(c, &instr->dest, i, vir_LDTMU(c));
-        }
+        /* The THRSW and LDTMUs are emitted once something needs the
+         * results, letting later lookups be sent in the meantime.
+         */
+        ntq_add_pending_tmu_flush(c, &instr->dest,
+                                  p0_unpacked.return_words_of_texture_data,
+                                  tmu_writes);
 }
 
 static void
@@ -466,6 +466,13 @@ struct v3d_compiler {
         unsigned int reg_class_phys_or_acc[3];
 };
 
+/* The TMU input and output FIFOs have 16 entries and the config FIFO has 8
+ * (one per lookup), shared between the threads, so when running at 1 thread
+ * at most 8 lookups can be in flight.
+ */
+#define V3D_TMU_FIFO_SIZE 16
+#define V3D_MAX_TMU_LOOKUPS 8
+
 struct v3d_compile {
         const struct v3d_device_info *devinfo;
         nir_shader *s;
@@ -624,6 +631,33 @@ struct v3d_compile {
         struct qinst *last_thrsw;
         bool last_thrsw_at_top_level;
 
+        /* Texture lookups that have been sent to the TMU but whose results
+         * haven't been collected with LDTMU yet, in FIFO order, along with
+         * how much of the TMU FIFOs they take up.  See ntq_flush_tmu().
+         */
+        struct {
+                uint32_t input_fifo_size;
+                uint32_t output_fifo_size;
+
+                struct {
+                        nir_dest *dest;
+                        uint8_t component_mask;
+                } flush[V3D_MAX_TMU_LOOKUPS];
+                uint32_t flush_count;
+        } tmu;
+
+        /* Set to collect the results of each TMU lookup right after sending
+         * it, used to retry compiling a program for which batching lookups
+         * resulted in too much register pressure.
+         */
+        bool disable_tmu_pipelining;
+
+        /* Whether any texture lookups were batched up, and whether register
+         * allocation had to reduce the thread count.
+         */
+        bool tmu_pipelined;
+        bool ra_reduced_threads;
+
         bool failed;
 };
 
@@ -779,6 +813,11 @@ struct qreg ntq_get_src(struct v3d_compile *c, nir_src src, int i);
 void ntq_store_dest(struct v3d_compile *c, nir_dest *dest, int chan,
                     struct qreg result);
 void vir_emit_thrsw(struct v3d_compile *c);
+bool ntq_tmu_lookup_needs_flush(struct v3d_compile *c, nir_instr *instr,
+                                uint32_t input_words, uint32_t output_words);
+void ntq_add_pending_tmu_flush(struct v3d_compile *c, nir_dest *dest,
+                               uint32_t component_mask, uint32_t input_words);
+void ntq_flush_tmu(struct v3d_compile *c);
 
 void vir_dump(struct v3d_compile *c);
 void vir_dump_inst(struct v3d_compile *c, struct qinst *inst);
@@ -871,33 +871,30 @@ vir_get_max_temps(struct v3d_compile *c)
         return max_temps;
 }
 
-uint64_t *v3d_compile(const struct v3d_compiler *compiler,
-                      struct v3d_key *key,
-                      struct v3d_prog_data **out_prog_data,
-                      nir_shader *s,
-                      void (*debug_output)(const char *msg,
-                                           void *debug_output_data),
-                      void *debug_output_data,
-                      int program_id, int variant_id,
-                      uint32_t *final_assembly_size)
+static struct v3d_compile *
+vir_compile_nir(const struct v3d_compiler *compiler,
+                struct v3d_key *key,
+                nir_shader *s,
+                void (*debug_output)(const char *msg,
+                                     void *debug_output_data),
+                void *debug_output_data,
+                int program_id, int variant_id,
+                bool disable_tmu_pipelining)
 {
-        struct v3d_prog_data *prog_data;
         struct v3d_compile *c = vir_compile_init(compiler, key, s,
                                                  debug_output, debug_output_data,
                                                  program_id, variant_id);
 
+        c->disable_tmu_pipelining = disable_tmu_pipelining;
+
         switch (c->s->info.stage) {
         case MESA_SHADER_VERTEX:
                 c->vs_key = (struct v3d_vs_key *)key;
-                prog_data = rzalloc_size(NULL, sizeof(struct v3d_vs_prog_data));
                 break;
         case MESA_SHADER_FRAGMENT:
                 c->fs_key = (struct v3d_fs_key *)key;
-                prog_data = rzalloc_size(NULL, sizeof(struct v3d_fs_prog_data));
                 break;
         case MESA_SHADER_COMPUTE:
-                prog_data = rzalloc_size(NULL,
-                                         sizeof(struct v3d_compute_prog_data));
                 break;
         default:
                 unreachable("unsupported shader stage");
@@ -926,10 +923,85 @@ uint64_t *v3d_compile(const struct v3d_compiler *compiler,
 
         v3d_optimize_nir(c->s);
         NIR_PASS_V(c->s, nir_lower_bool_to_int32);
+
+        /* Schedule for latency until we'd risk losing threads or
+         * spilling, in which case keep pressure down instead.
+         */
+        static const struct nir_schedule_options schedule_options_4 = {
+                .threshold = 24,
+                .stages_with_shared_io_memory = (1 << MESA_SHADER_VERTEX),
+        };
+        static const struct nir_schedule_options schedule_options_2 = {
+                .threshold = 48,
+                .stages_with_shared_io_memory = (1 << MESA_SHADER_VERTEX),
+        };
+        NIR_PASS_V(c->s, nir_schedule,
+                   c->threads == 4 ? &schedule_options_4 : &schedule_options_2);
+
         NIR_PASS_V(c->s, nir_convert_from_ssa, true);
 
         v3d_nir_to_vir(c);
 
+        return c;
+}
+
+uint64_t *v3d_compile(const struct v3d_compiler *compiler,
+                      struct v3d_key *key,
+                      struct v3d_prog_data **out_prog_data,
+                      nir_shader *s,
+                      void (*debug_output)(const char *msg,
+                                           void *debug_output_data),
+                      void *debug_output_data,
+                      int program_id, int variant_id,
+                      uint32_t *final_assembly_size)
+{
+        struct v3d_prog_data *prog_data;
+
+        switch (s->info.stage) {
+        case MESA_SHADER_VERTEX:
+                prog_data = rzalloc_size(NULL, sizeof(struct v3d_vs_prog_data));
+                break;
+        case MESA_SHADER_FRAGMENT:
+                prog_data = rzalloc_size(NULL, sizeof(struct v3d_fs_prog_data));
+                break;
+        case MESA_SHADER_COMPUTE:
+                prog_data = rzalloc_size(NULL,
+                                         sizeof(struct v3d_compute_prog_data));
+                break;
+        default:
+                unreachable("unsupported shader stage");
+        }
+
+        bool disable_tmu_pipelining = V3D_DEBUG & V3D_DEBUG_NO_TMU_PIPELINING;
+        struct v3d_compile *c = vir_compile_nir(compiler, key, s,
+                                                debug_output,
+                                                debug_output_data,
+                                                program_id, variant_id,
+                                                disable_tmu_pipelining);
+
+        /* Batching up texture lookups keeps more values live at the same
+         * time.  If that cost us threads or spills, see if the program does
+         * better with each lookup's results collected right away.
+         */
+        if (c->tmu_pipelined &&
+            (c->failed || c->spills || c->ra_reduced_threads)) {
+                struct v3d_compile *retry =
+                        vir_compile_nir(compiler, key, s,
+                                        debug_output, debug_output_data,
+                                        program_id, variant_id, true);
+
+                if (!retry->failed &&
+                    (c->failed ||
+                     retry->threads > c->threads ||
+                     (retry->threads == c->threads &&
+                      retry->spills < c->spills))) {
+                        vir_compile_destroy(c);
+                        c = retry;
+                } else {
+                        vir_compile_destroy(retry);
+                }
+        }
+
         v3d_set_prog_data(c, prog_data);
 
         *out_prog_data = prog_data;
@@ -83,6 +83,7 @@
 #include <math.h>
 #include "builtin_functions.h"
 #include "util/hash_table.h"
+#include "util/set.h"
 
 #define M_PIf   ((float) M_PI)
 #define M_PI_2f ((float) M_PI_2)
@@ -818,6 +819,7 @@ public:
    void release();
    ir_function_signature *find(_mesa_glsl_parse_state *state,
                                const char *name, exec_list *actual_parameters);
+   ir_function *get_function(const char *name);
 
    /**
     * A shader to hold all the built-in signatures; created by this module.
@@ -831,6 +833,20 @@ public:
 private:
    void *mem_ctx;
 
+   /**
+    * Built-in functions are only generated the first time a shader asks for
+    * them by name.  While create_builtins() runs for such a request,
+    * \c wanted_name is the name being generated and every other
+    * add_function() call in it is skipped.
+    */
+   const char *wanted_name;
+   struct set *materialized_names;
+
+   bool want_function(const char *name) const
+   {
+      return wanted_name == NULL || strcmp(name, wanted_name) == 0;
+   }
+
    void create_shader();
    void create_intrinsics();
    void create_builtins();
@@ -1186,7 +1202,7 @@ enum image_function_flags {
  *  @{
  */
 builtin_builder::builtin_builder()
-   : shader(NULL)
+   : shader(NULL), wanted_name(NULL), materialized_names(NULL)
 {
    mem_ctx = NULL;
 }
@@ -1209,7 +1225,7 @@ builtin_builder::find(_mesa_glsl_parse_state *state,
     */
    state->uses_builtin_functions = true;
 
-   ir_function *f = shader->symbols->get_function(name);
+   ir_function *f = get_function(name);
    if (f == NULL)
       return NULL;
 
@@ -1229,9 +1245,31 @@ builtin_builder::initialize()
       return;
 
    mem_ctx = ralloc_context(NULL);
+   materialized_names = _mesa_set_create(mem_ctx, _mesa_key_hash_string,
+                                         _mesa_key_string_equal);
    create_shader();
    create_intrinsics();
-   create_builtins();
+}
+
+/**
+ * Look up the built-in function called \p name, generating the IR for all of
+ * its signatures if this is the first time it has been asked for.
+ *
+ * Once generated, a function is never modified again, so the IR can be
+ * shared by every context in the process.
+ */
+ir_function *
+builtin_builder::get_function(const char *name)
+{
+   if (_mesa_set_search(materialized_names, name) == NULL) {
+      _mesa_set_add(materialized_names, ralloc_strdup(mem_ctx, name));
+
+      wanted_name = name;
+      create_builtins();
+      wanted_name = NULL;
+   }
+
+   return shader->symbols->get_function(name);
 }
 
 void
@@ -1239,6 +1277,7 @@ builtin_builder::release()
 {
    ralloc_free(mem_ctx);
    mem_ctx = NULL;
+   materialized_names = NULL;
 
    ralloc_free(shader);
    shader = NULL;
@@ -1468,6 +1507,13 @@ builtin_builder::create_intrinsics()
  *
  * Contains a list of every available built-in.
  */
+/* Only evaluate the signature generators of the function being asked for. */
+#define add_function(NAME, ...)                       \
+   do {                                               \
+      if (want_function(NAME))                        \
+         this->add_function(NAME, __VA_ARGS__);       \
+   } while (0)
+
 void
 builtin_builder::create_builtins()
 {
@@ -4220,6 +4266,8 @@ builtin_builder::create_builtins()
 #undef FIU2_MIXED
 }
 
+#undef add_function
+
 void
 builtin_builder::add_function(const char *name, ...)
 {
@@ -4254,6 +4302,9 @@ builtin_builder::add_image_function(const char *name,
                                     unsigned flags,
                                     enum ir_intrinsic_id intrinsic_id)
 {
+   if (!want_function(name))
+      return;
+
    static const glsl_type *const types[] = {
       glsl_type::image1D_type,
       glsl_type::image2D_type,
@@ -7251,7 +7302,7 @@ _mesa_glsl_has_builtin_function(_mesa_glsl_parse_state *state, const char *name)
    ir_function *f;
    bool ret = false;
    mtx_lock(&builtins_lock);
-   f = builtins.shader->symbols->get_function(name);
+   f = builtins.get_function(name);
    if (f != NULL) {
       foreach_in_list(ir_function_signature, sig, &f->signatures) {
          if (sig->is_builtin_available(state)) {
@@ -7271,6 +7322,17 @@ _mesa_glsl_get_builtin_function_shader()
    return builtins.shader;
 }
 
+ir_function *
+_mesa_glsl_get_builtin_function(const char *name)
+{
+   ir_function *f;
+   mtx_lock(&builtins_lock);
+   f = builtins.get_function(name);
+   mtx_unlock(&builtins_lock);
+
+   return f;
+}
+
 
 /**
  * Get the function signature for main from a shader
@@ -54,6 +54,10 @@ static void
 _string_list_append_item(glcpp_parser_t *parser, string_list_t *list,
                          const char *str);
 
+static void
+_string_list_append_list(glcpp_parser_t *parser, string_list_t *list,
+                         string_list_t *tail);
+
 static int
 _string_list_contains(string_list_t *list, const char *member, int *index);
 
@@ -107,6 +111,9 @@ _parser_active_list_pop(glcpp_parser_t *parser);
 static int
 _parser_active_list_contains(glcpp_parser_t *parser, const char *identifier);
 
+static int
+_parser_active_list_contains_any(glcpp_parser_t *parser, string_list_t *list);
+
 typedef enum {
    EXPANSION_MODE_IGNORE_DEFINED,
    EXPANSION_MODE_EVALUATE_DEFINED
@@ -321,6 +328,7 @@ control_line_success:
 		entry = _mesa_hash_table_search (parser->defines, $3);
 		if (entry) {
 			_mesa_hash_table_remove (parser->defines, entry);
+			parser->macro_generation++;
 		}
 	}
 |	HASH_TOKEN IF pp_tokens NEWLINE {
@@ -794,6 +802,16 @@ _string_list_append_item(glcpp_parser_t *parser, string_list_t *list,
    list->tail = node;
 }
 
+static void
+_string_list_append_list(glcpp_parser_t *parser, string_list_t *list,
+                         string_list_t *tail)
+{
+   string_node_t *node;
+
+   for (node = tail->head; node; node = node->next)
+      _string_list_append_item(parser, list, node->str);
+}
+
 int
 _string_list_contains(string_list_t *list, const char *member, int *index)
 {
@@ -1369,6 +1387,9 @@ glcpp_parser_create(const struct gl_extensions *extension_list,
                                              _mesa_key_string_equal);
    parser->linalloc = linear_alloc_parent(parser, 0);
    parser->active = NULL;
+   parser->macro_generation = 1;
+   parser->expansion_deps = NULL;
+   parser->expansion_cacheable = false;
    parser->lexing_directive = 0;
    parser->lexing_version_directive = 0;
    parser->space_tokens = 1;
@@ -1818,6 +1839,74 @@ _glcpp_parser_expand_function(glcpp_parser_t *parser, token_node_t *node,
    return substituted;
 }
 
+/* Whether the fully expanded replacement list of an object-like macro can
+ * be reused wherever the macro appears.  Pasting and "defined" are left to
+ * the regular path, as is a trailing space, which the expansion would trim.
+ */
+static bool
+_token_list_can_cache_expansion(token_list_t *list)
+{
+   token_node_t *node;
+
+   if (list->non_space_tail != list->tail)
+      return false;
+
+   for (node = list->head; node; node = node->next) {
+      if (node->token->type == PASTE || node->token->type == DEFINED)
+         return false;
+   }
+
+   return true;
+}
+
+/* Return the replacement list of the object-like \p macro with every macro
+ * it references already expanded, building and caching it on first use, or
+ * NULL if the expansion depends on where the macro appears: it involves
+ * __LINE__ or __FILE__, a function-like macro, or a macro that is being
+ * expanded already.
+ *
+ * Macros expanded while building the cached list are recorded in
+ * expansion_deps; the caller must not use the list while any of them is
+ * active, since they wouldn't have been expanded there.
+ */
+static token_list_t *
+_glcpp_parser_object_macro_expansion(glcpp_parser_t *parser, macro_t *macro)
+{
+   string_list_t *outer_deps = parser->expansion_deps;
+   bool outer_cacheable = parser->expansion_cacheable;
+   token_list_t *expansion;
+
+   if (macro->expansion_generation == parser->macro_generation)
+      return macro->expansion;
+
+   macro->expansion_generation = parser->macro_generation;
+   macro->expansion = NULL;
+   macro->expansion_deps = NULL;
+
+   if (!_token_list_can_cache_expansion(macro->replacements))
+      return NULL;
+
+   expansion = _token_list_copy(parser, macro->replacements);
+
+   parser->expansion_deps = _string_list_create(parser);
+   parser->expansion_cacheable = true;
+
+   _parser_active_list_push(parser, macro->identifier, NULL);
+   _glcpp_parser_expand_token_list(parser, expansion,
+                                   EXPANSION_MODE_IGNORE_DEFINED);
+   _parser_active_list_pop(parser);
+
+   if (parser->expansion_cacheable) {
+      macro->expansion = expansion;
+      macro->expansion_deps = parser->expansion_deps;
+   }
+
+   parser->expansion_deps = outer_deps;
+   parser->expansion_cacheable = outer_cacheable;
+
+   return macro->expansion;
+}
+
 /* Compute the complete expansion of node, (and subsequent nodes after
  * 'node' in the case that 'node' is a function-like macro and
  * subsequent nodes are arguments).
@@ -1856,6 +1945,14 @@ _glcpp_parser_expand_node(glcpp_parser_t *parser, token_node_t *node,
    /* Special handling for __LINE__ and __FILE__, (not through
     * the hash table). */
    if (*identifier == '_') {
+      if (strcmp(identifier, "__LINE__") == 0 ||
+          strcmp(identifier, "__FILE__") == 0) {
+         if (parser->expansion_deps) {
+            parser->expansion_cacheable = false;
+            return NULL;
+         }
+      }
+
       if (strcmp(identifier, "__LINE__") == 0)
          return _token_list_create_with_one_integer(parser,
                                                     node->token->location.first_line);
@@ -1882,6 +1979,11 @@ _glcpp_parser_expand_node(glcpp_parser_t *parser, token_node_t *node,
       token_list_t *expansion;
       token_t *final;
 
+      if (parser->expansion_deps) {
+         parser->expansion_cacheable = false;
+         return NULL;
+      }
+
       str = linear_strdup(parser->linalloc, token->value.str);
       final = _token_create_str(parser, OTHER, str);
       expansion = _token_list_create(parser);
@@ -1896,11 +1998,36 @@ _glcpp_parser_expand_node(glcpp_parser_t *parser, token_node_t *node,
       if (macro->replacements == NULL)
          return _token_list_create_with_one_space(parser);
 
+      replacement = _glcpp_parser_object_macro_expansion(parser, macro);
+      if (replacement &&
+          !_parser_active_list_contains_any(parser, macro->expansion_deps)) {
+         if (parser->expansion_deps) {
+            _string_list_append_item(parser, parser->expansion_deps,
+                                     macro->identifier);
+            _string_list_append_list(parser, parser->expansion_deps,
+                                     macro->expansion_deps);
+         }
+         return _token_list_copy(parser, replacement);
+      }
+
+      if (parser->expansion_deps) {
+         parser->expansion_cacheable = false;
+         return NULL;
+      }
+
       replacement = _token_list_copy(parser, macro->replacements);
       _glcpp_parser_apply_pastes(parser, replacement);
       return replacement;
    }
 
+   /* Whether a function-like macro is invoked depends on the tokens that
+    * follow the expansion being cached.
+    */
+   if (parser->expansion_deps) {
+      parser->expansion_cacheable = false;
+      return NULL;
+   }
+
    return _glcpp_parser_expand_function(parser, node, last, mode);
 }
 
@@ -1917,8 +2044,11 @@ _parser_active_list_push(glcpp_parser_t *parser, const char *identifier,
 {
    active_list_t *node;
 
+   /* Identifiers come from tokens or macros, which live as long as the
+    * parser does, so there's no need to copy them.
+    */
    node = linear_alloc_child(parser->linalloc, sizeof(active_list_t));
-   node->identifier = linear_strdup(parser->linalloc, identifier);
+   node->identifier = identifier;
    node->marker = marker;
    node->next = parser->active;
 
@@ -1954,6 +2084,21 @@ _parser_active_list_contains(glcpp_parser_t *parser, const char *identifier)
    return 0;
 }
 
+static int
+_parser_active_list_contains_any(glcpp_parser_t *parser, string_list_t *list)
+{
+   string_node_t *node;
+
+   if (parser->active == NULL)
+      return 0;
+
+   for (node = list->head; node; node = node->next)
+      if (_parser_active_list_contains(parser, node->str))
+         return 1;
+
+   return 0;
+}
+
 /* Walk over the token list replacing nodes with their expansion.
  * Whenever nodes are expanded the walking will walk over the new
  * nodes, continuing to expand as necessary. The results are placed in
@@ -2129,6 +2274,9 @@ _define_object_macro(glcpp_parser_t *parser, YYLTYPE *loc,
    macro->parameters = NULL;
    macro->identifier = linear_strdup(parser->linalloc, identifier);
    macro->replacements = replacements;
+   macro->expansion_generation = 0;
+   macro->expansion = NULL;
+   macro->expansion_deps = NULL;
 
    entry = _mesa_hash_table_search(parser->defines, identifier);
    previous = entry ? entry->data : NULL;
@@ -2140,6 +2288,7 @@ _define_object_macro(glcpp_parser_t *parser, YYLTYPE *loc,
    }
 
    _mesa_hash_table_insert (parser->defines, identifier, macro);
+   parser->macro_generation++;
 }
 
 void
@@ -2164,6 +2313,9 @@ _define_function_macro(glcpp_parser_t *parser, YYLTYPE *loc,
    macro->parameters = parameters;
    macro->identifier = linear_strdup(parser->linalloc, identifier);
    macro->replacements = replacements;
+   macro->expansion_generation = 0;
+   macro->expansion = NULL;
+   macro->expansion_deps = NULL;
 
    entry = _mesa_hash_table_search(parser->defines, identifier);
    previous = entry ? entry->data : NULL;
@@ -2175,6 +2327,7 @@ _define_function_macro(glcpp_parser_t *parser, YYLTYPE *loc,
    }
 
    _mesa_hash_table_insert(parser->defines, identifier, macro);
+   parser->macro_generation++;
 }
 
 static int
@@ -148,6 +148,16 @@ typedef struct {
 	string_list_t *parameters;
 	const char *identifier;
 	token_list_t *replacements;
+
+	/* For object-like macros, the replacement list with every nested
+	 * macro already expanded, valid while expansion_generation matches
+	 * the parser's macro_generation.  NULL if the expansion depends on
+	 * the context it appears in.  expansion_deps names every macro that
+	 * was expanded to build it.
+	 */
+	unsigned expansion_generation;
+	token_list_t *expansion;
+	string_list_t *expansion_deps;
 } macro_t;
 
 typedef struct expansion_node {
@@ -189,6 +199,18 @@ struct glcpp_parser {
 	yyscan_t scanner;
 	struct hash_table *defines;
 	active_list_t *active;
+
+	/* Bumped whenever a macro is defined or undefined, invalidating
+	 * the cached expansions of object-like macros.
+	 */
+	unsigned macro_generation;
+
+	/* Non-NULL while a cached expansion is being built: collects the
+	 * names of the macros expanded into it.  expansion_cacheable is
+	 * cleared if anything context dependent turns up.
+	 */
+	string_list_t *expansion_deps;
+	bool expansion_cacheable;
 	int lexing_directive;
 	int lexing_version_directive;
 	int space_tokens;
@@ -0,0 +1,11 @@
+#define foo bar
+#define bar 1
+foo
+#undef bar
+#define bar 2
+foo
+#define baz foo bar
+baz
+#define f(x) (x)
+#define g f
+g(3)
@@ -2039,9 +2039,12 @@ opt_shader_and_create_symbol_table(struct gl_context *ctx,
       &ctx->Const.ShaderCompilerOptions[shader->Stage];
 
    /* Do some optimization at compile time to reduce shader IR size
-    * and reduce later work if the same shader is linked multiple times
+    * and reduce later work if the same shader is linked multiple times.
+    * Drivers asking for OptimizeAtLinkOnly leave it all to the linker.
     */
-   if (ctx->Const.GLSLOptimizeConservatively) {
+   if (options->OptimizeAtLinkOnly) {
+      /* Nothing to do. */
+   } else if (ctx->Const.GLSLOptimizeConservatively) {
       /* Run it just once. */
       do_common_optimization(shader->ir, false, false, options,
                              ctx->Const.NativeIntegers);
@@ -85,6 +85,7 @@
 #include "shader_cache.h"
 #include "util/u_string.h"
 #include "util/u_math.h"
+#include "c11/threads.h"
 
 #include "main/imports.h"
 #include "main/shaderobj.h"
@@ -4895,6 +4896,77 @@ linker_optimisation_loop(struct gl_context *ctx, exec_list *ir,
       }
 }
 
+struct linker_optimisation_job {
+   struct gl_context *ctx;
+   struct gl_linked_shader *shader;
+   unsigned stage;
+};
+
+/**
+ * The optimisation of a linked stage before storage gets assigned.  It only
+ * touches the IR of that stage, so it can run concurrently for several
+ * stages.
+ */
+static int
+linker_optimise_stage(void *data)
+{
+   struct linker_optimisation_job *job =
+      (struct linker_optimisation_job *) data;
+   exec_list *ir = job->shader->ir;
+
+   /* Call opts before lowering const arrays to uniforms so we can const
+    * propagate any elements accessed directly.
+    */
+   linker_optimisation_loop(job->ctx, ir, job->stage);
+
+   /* Call opts after lowering const arrays to copy propagate things. */
+   if (lower_const_arrays_to_uniforms(ir, job->stage))
+      linker_optimisation_loop(job->ctx, ir, job->stage);
+
+   propagate_invariance(ir);
+
+   return 0;
+}
+
+/**
+ * Optimise all linked stages, each additional stage on its own thread.
+ * The stages are optimised one after the other if a thread can't be
+ * created.
+ */
+static void
+linker_optimise_stages(struct gl_context *ctx, struct gl_shader_program *prog)
+{
+   struct linker_optimisation_job jobs[MESA_SHADER_STAGES];
+   thrd_t threads[MESA_SHADER_STAGES];
+   bool threaded[MESA_SHADER_STAGES] = { false };
+   unsigned num_jobs = 0;
+
+   for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
+      if (prog->_LinkedShaders[i] == NULL)
+         continue;
+
+      jobs[num_jobs].ctx = ctx;
+      jobs[num_jobs].shader = prog->_LinkedShaders[i];
+      jobs[num_jobs].stage = i;
+      num_jobs++;
+   }
+
+   for (unsigned i = 1; i < num_jobs; i++) {
+      threaded[i] = thrd_create(&threads[i], linker_optimise_stage,
+                                &jobs[i]) == thrd_success;
+   }
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      if (!threaded[i])
+         linker_optimise_stage(&jobs[i]);
+   }
+
+   for (unsigned i = 1; i < num_jobs; i++) {
+      if (threaded[i])
+         thrd_join(threads[i], NULL);
+   }
+}
+
 void
 link_shaders(struct gl_context *ctx, struct gl_shader_program *prog)
 {
@@ -5193,6 +5265,10 @@ link_shaders(struct gl_context *ctx, struct gl_shader_program *prog)
    /* Do common optimization before assigning storage for attributes,
     * uniforms, and varyings.  Later optimization could possibly make
     * some of that unused.
+    *
+    * The checks and lowering which can report link errors come first, as
+    * they write to the shared info log; the optimisation itself then runs
+    * for all stages concurrently.
     */
    for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
       if (prog->_LinkedShaders[i] == NULL)
@@ -5230,19 +5306,10 @@ link_shaders(struct gl_context *ctx, struct gl_shader_program *prog)
             goto done;
          }
       }
-
-      /* Call opts before lowering const arrays to uniforms so we can const
-       * propagate any elements accessed directly.
-       */
-      linker_optimisation_loop(ctx, prog->_LinkedShaders[i]->ir, i);
-
-      /* Call opts after lowering const arrays to copy propagate things. */
-      if (lower_const_arrays_to_uniforms(prog->_LinkedShaders[i]->ir, i))
-         linker_optimisation_loop(ctx, prog->_LinkedShaders[i]->ir, i);
-
-      propagate_invariance(prog->_LinkedShaders[i]->ir);
    }
 
+   linker_optimise_stages(ctx, prog);
+
    /* Validation for special cases where we allow sampler array indexing
     * with loop induction variable. This check emits a warning or error
     * depending if backend can handle dynamic indexing.
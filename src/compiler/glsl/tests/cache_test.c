@@ -439,6 +439,13 @@ test_put_and_get(void)
                "disk_cache_put eviction last file == MAX_SIZE (1MB)");
    expect_equal(count, 1, "eviction after overflow with MAX_SIZE=1M");
 
+   struct disk_cache_stats stats;
+   disk_cache_get_stats(cache, &stats);
+   expect_equal(stats.puts, 3, "disk_cache_get_stats counts puts");
+   expect_equal(stats.dropped, 0, "disk_cache_get_stats with nothing dropped");
+   expect_true(stats.decoded > 0 && stats.decoded_size > 0,
+               "disk_cache_get_stats counts decompressed entries");
+
    disk_cache_destroy(cache);
 }
 
@@ -493,6 +500,67 @@ test_put_key_and_get_key(void)
 
    disk_cache_destroy(cache);
 }
+
+static void
+test_packed_put_and_get(void)
+{
+   struct disk_cache *cache;
+   char blob[] = "This is a blob of thirty-seven bytes";
+   uint8_t blob_key[20];
+   char string[] = "While this string has thirty-four";
+   uint8_t string_key[20];
+   struct stat sb;
+   char *result;
+   size_t size;
+
+   setenv("MESA_GLSL_CACHE_PACKED", "true", 1);
+   cache = disk_cache_create("test", "make_check", 0);
+
+   disk_cache_compute_key(cache, blob, sizeof(blob), blob_key);
+   disk_cache_compute_key(cache, string, sizeof(string), string_key);
+
+   result = disk_cache_get(cache, blob_key, &size);
+   expect_null(result, "packed disk_cache_get with non-existent item (pointer)");
+   expect_equal(size, 0, "packed disk_cache_get with non-existent item (size)");
+
+   disk_cache_put(cache, blob_key, blob, sizeof(blob), NULL);
+   disk_cache_put(cache, string_key, string, sizeof(string), NULL);
+
+   /* disk_cache_put() hands things off to a thread give it some time to
+    * finish.
+    */
+   wait_until_file_written(cache, blob_key);
+   wait_until_file_written(cache, string_key);
+
+   result = disk_cache_get(cache, blob_key, &size);
+   expect_equal_str(blob, result, "packed disk_cache_get of existing item (pointer)");
+   expect_equal(size, sizeof(blob), "packed disk_cache_get of existing item (size)");
+   free(result);
+
+   expect_true(stat(CACHE_TEST_TMP "/mesa-glsl-cache-dir/" CACHE_DIR_NAME
+                    "/packed/index", &sb) == 0,
+               "packed disk_cache_put creates the packed index");
+
+   /* Entries have to survive re-opening the cache. */
+   disk_cache_destroy(cache);
+   cache = disk_cache_create("test", "make_check", 0);
+
+   result = disk_cache_get(cache, string_key, &size);
+   expect_equal_str(string, result, "packed disk_cache_get after re-opening "
+                    "the cache (pointer)");
+   expect_equal(size, sizeof(string), "packed disk_cache_get after re-opening "
+                "the cache (size)");
+   free(result);
+
+   disk_cache_remove(cache, string_key);
+   expect_true(!does_cache_contain(cache, string_key),
+               "packed disk_cache_remove removes the item");
+   expect_true(does_cache_contain(cache, blob_key),
+               "packed disk_cache_remove keeps other items");
+
+   disk_cache_destroy(cache);
+   unsetenv("MESA_GLSL_CACHE_PACKED");
+}
 #endif /* ENABLE_SHADER_CACHE */
 
 int
@@ -507,6 +575,8 @@ main(void)
 
    test_put_key_and_get_key();
 
+   test_packed_put_and_get();
+
    err = rmrf_local(CACHE_TEST_TMP);
    expect_equal(err, 0, "Removing " CACHE_TEST_TMP " again");
 #endif /* ENABLE_SHADER_CACHE */
@@ -41,7 +41,10 @@ nir_shader_create(void *mem_ctx,
                   const nir_shader_compiler_options *options,
                   shader_info *si)
 {
-   nir_shader *shader = rzalloc(mem_ctx, nir_shader);
+   /* Instructions, blocks and everything else in the shader are allocated
+    * from a pool instead of one malloc each.
+    */
+   nir_shader *shader = rzalloc_pool(mem_ctx, nir_shader);
 
    exec_list_make_empty(&shader->uniforms);
    exec_list_make_empty(&shader->inputs);
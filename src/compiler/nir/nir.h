@@ -41,10 +41,7 @@
 #include "compiler/shader_enums.h"
 #include "compiler/shader_info.h"
 #include <stdio.h>
-
-#ifndef NDEBUG
 #include "util/debug.h"
-#endif /* NDEBUG */
 
 #include "nir_opcodes.h"
 
@@ -2551,6 +2548,13 @@ typedef struct nir_shader_compiler_options {
 
    unsigned max_unroll_iterations;
 
+   /**
+    * If greater than 1, loops whose trip count isn't known at compile time
+    * (e.g. bounded by a uniform) are unrolled in place by this factor.  Each
+    * copy of the body keeps its exit tests, so no remainder loop is needed.
+    */
+   unsigned loop_partial_unroll_factor;
+
    nir_lower_int64_options lower_int64_options;
    nir_lower_doubles_options lower_doubles_options;
 } nir_shader_compiler_options;
@@ -3140,6 +3144,32 @@ static inline bool should_serialize_deserialize_nir(void) { return false; }
 static inline bool should_print_nir(void) { return false; }
 #endif /* NDEBUG */
 
+/* Compile time profiling of NIR_PASS and NIR_PASS_V, see nir_profile.c.
+ * This is available in release builds too.
+ */
+struct nir_profile_pass {
+   const char *pass;
+   int64_t start_ns;
+   unsigned instrs_before;
+};
+
+void nir_profile_pass_start(struct nir_profile_pass *prof,
+                            const nir_shader *shader);
+void nir_profile_pass_finish(struct nir_profile_pass *prof,
+                             const nir_shader *shader, int progress);
+
+static inline bool
+should_profile_nir(void)
+{
+   static int should_profile = -1;
+   if (should_profile < 0) {
+      should_profile = env_var_as_boolean("NIR_PROFILE", false) ||
+                       getenv("NIR_PROFILE_TRACE") != NULL;
+   }
+
+   return should_profile;
+}
+
 #define _PASS(pass, nir, do_pass) do {                               \
    if (should_skip_nir(#pass)) {                                     \
       printf("skipping %s\n", #pass);                                \
@@ -3162,7 +3192,13 @@ static inline bool should_print_nir(void) { return false; }
    nir_metadata_set_validation_flag(nir);                            \
    if (should_print_nir())                                           \
       printf("%s\n", #pass);                                         \
-   if (pass(nir, ##__VA_ARGS__)) {                                   \
+   struct nir_profile_pass _profile = { #pass };                     \
+   if (should_profile_nir())                                         \
+      nir_profile_pass_start(&_profile, nir);                        \
+   bool _progress = pass(nir, ##__VA_ARGS__);                        \
+   if (should_profile_nir())                                         \
+      nir_profile_pass_finish(&_profile, nir, _progress);            \
+   if (_progress) {                                                  \
       progress = true;                                               \
       if (should_print_nir())                                        \
          nir_print_shader(nir, stdout);                              \
@@ -3173,13 +3209,138 @@ static inline bool should_print_nir(void) { return false; }
 #define NIR_PASS_V(nir, pass, ...) _PASS(pass, nir,                  \
    if (should_print_nir())                                           \
       printf("%s\n", #pass);                                         \
+   struct nir_profile_pass _profile = { #pass };                     \
+   if (should_profile_nir())                                         \
+      nir_profile_pass_start(&_profile, nir);                        \
    pass(nir, ##__VA_ARGS__);                                         \
+   if (should_profile_nir())                                         \
+      nir_profile_pass_finish(&_profile, nir, -1);                   \
    if (should_print_nir())                                           \
       nir_print_shader(nir, stdout);                                 \
 )
 
 #define NIR_SKIP(name) should_skip_nir(#name)
 
+/**
+ * State of an optimization loop that doesn't rerun passes which can't make
+ * progress.
+ *
+ * A pass that made no progress is skipped until another pass has changed
+ * the shader, and the loop ends as soon as an iteration changed nothing:
+ *
+ * \code
+ *    struct nir_opt_loop loop;
+ *    nir_opt_loop_init(&loop);
+ *    while (nir_opt_loop_continue(&loop)) {
+ *       NIR_LOOP_PASS(&loop, nir, nir_copy_prop);
+ *       NIR_LOOP_PASS(&loop, nir, nir_opt_dce);
+ *    }
+ * \endcode
+ *
+ * Passes are told apart by where NIR_LOOP_PASS is used, so each one has to
+ * be run with the same arguments in every iteration.  Changes made to the
+ * shader in the loop without NIR_LOOP_PASS must be reported with
+ * nir_opt_loop_progress().  nir_opt_loop_last_progress() tells whether the
+ * last NIR_LOOP_PASS made progress.
+ */
+#define NIR_OPT_LOOP_MAX_PASSES 64
+
+struct nir_opt_loop {
+   /* Incremented every time the shader is changed. */
+   unsigned generation;
+
+   /* The generation at the start of the current iteration. */
+   unsigned iteration_generation;
+   bool started;
+
+   bool last_progress;
+
+   unsigned num_passes;
+   struct {
+      const void *site;
+      /* One more than the generation in which the pass made no progress,
+       * or 0 if it never did.
+       */
+      unsigned clean_generation;
+   } passes[NIR_OPT_LOOP_MAX_PASSES];
+};
+
+static inline void
+nir_opt_loop_init(struct nir_opt_loop *loop)
+{
+   loop->generation = 0;
+   loop->iteration_generation = 0;
+   loop->started = false;
+   loop->last_progress = false;
+   loop->num_passes = 0;
+}
+
+/** Returns whether another iteration of the loop is needed. */
+static inline bool
+nir_opt_loop_continue(struct nir_opt_loop *loop)
+{
+   if (loop->started && loop->generation == loop->iteration_generation)
+      return false;
+
+   loop->started = true;
+   loop->iteration_generation = loop->generation;
+   return true;
+}
+
+static inline void
+nir_opt_loop_progress(struct nir_opt_loop *loop)
+{
+   loop->generation++;
+}
+
+static inline bool
+nir_opt_loop_last_progress(const struct nir_opt_loop *loop)
+{
+   return loop->last_progress;
+}
+
+static inline bool
+nir_opt_loop_should_run(struct nir_opt_loop *loop, const void *site,
+                        unsigned *slot)
+{
+   unsigned i;
+   for (i = 0; i < loop->num_passes; i++) {
+      if (loop->passes[i].site == site)
+         break;
+   }
+
+   *slot = i;
+   if (i == NIR_OPT_LOOP_MAX_PASSES)
+      return true;
+
+   if (i == loop->num_passes) {
+      loop->passes[i].site = site;
+      loop->passes[i].clean_generation = 0;
+      loop->num_passes++;
+   }
+
+   return loop->passes[i].clean_generation != loop->generation + 1;
+}
+
+static inline void
+nir_opt_loop_ran(struct nir_opt_loop *loop, unsigned slot)
+{
+   if (loop->last_progress)
+      loop->generation++;
+   else if (slot < NIR_OPT_LOOP_MAX_PASSES)
+      loop->passes[slot].clean_generation = loop->generation + 1;
+}
+
+#define NIR_LOOP_PASS(loop, nir, pass, ...) do {                     \
+   static char _site;                                                \
+   unsigned _slot;                                                   \
+   (loop)->last_progress = false;                                    \
+   if (nir_opt_loop_should_run(loop, &_site, &_slot)) {              \
+      NIR_PASS((loop)->last_progress, nir, pass, ##__VA_ARGS__);     \
+      nir_opt_loop_ran(loop, _slot);                                 \
+   }                                                                 \
+} while (0)
+
 void nir_calc_dominance_impl(nir_function_impl *impl);
 void nir_calc_dominance(nir_shader *shader);
 
@@ -3709,6 +3870,8 @@ bool nir_opt_find_array_copies(nir_shader *shader);
 
 bool nir_opt_gcm(nir_shader *shader, bool value_number);
 
+bool nir_opt_hoist_common(nir_shader *shader);
+
 bool nir_opt_idiv_const(nir_shader *shader, unsigned min_bit_size);
 
 bool nir_opt_if(nir_shader *shader, bool aggressive_last_continue);
@@ -3719,6 +3882,14 @@ bool nir_opt_large_constants(nir_shader *shader,
                              glsl_type_size_align_func size_align,
                              unsigned threshold);
 
+typedef bool (*nir_should_vectorize_mem_func)(unsigned align, unsigned bit_size,
+                                              unsigned num_components,
+                                              nir_intrinsic_instr *low,
+                                              nir_intrinsic_instr *high);
+
+bool nir_opt_load_store_vectorize(nir_shader *shader, nir_variable_mode modes,
+                                  nir_should_vectorize_mem_func callback);
+
 bool nir_opt_loop_unroll(nir_shader *shader, nir_variable_mode indirect_mask);
 
 bool nir_opt_move_comparisons(nir_shader *shader);
@@ -3733,6 +3904,27 @@ bool nir_opt_remove_phis_block(nir_block *block);
 
 bool nir_opt_shrink_load(nir_shader *shader);
 
+typedef struct nir_schedule_options {
+   /* Number of 32-bit values live at which nir_schedule stops scheduling
+    * for latency and starts scheduling to reduce register pressure.
+    */
+   unsigned threshold;
+
+   /* Bitmask of (1 << stage) for stages whose inputs are read from the
+    * same memory outputs are written to, so that input loads have to stay
+    * in order with output stores.
+    */
+   unsigned stages_with_shared_io_memory;
+
+   /* Optional latency of an instruction's result in the backend, in
+    * whatever unit the backend likes.  A rough default is used if NULL.
+    */
+   unsigned (*instr_delay)(nir_instr *instr, void *data);
+   void *data;
+} nir_schedule_options;
+
+bool nir_schedule(nir_shader *shader, const nir_schedule_options *options);
+
 bool nir_opt_trivial_continues(nir_shader *shader);
 
 bool nir_opt_undef(nir_shader *shader);
@@ -3742,6 +3934,20 @@ bool nir_opt_conditional_discard(nir_shader *shader);
 void nir_strip(nir_shader *shader);
 
 void nir_sweep(nir_shader *shader);
+void nir_steal_impl(nir_shader *nir, nir_function_impl *impl);
+
+typedef bool (*nir_impl_pass_func)(nir_function_impl *impl, void *data);
+
+/**
+ * Runs \p pass on every function impl of \p shader, using several threads
+ * when there is more than one impl.
+ *
+ * The pass may only touch the impl it's given: it can allocate instructions,
+ * locals and registers, but must not change the shader's variables, info or
+ * other functions.  Returns true if the pass made progress on any impl.
+ */
+bool nir_shader_impls_parallel(nir_shader *shader, nir_impl_pass_func pass,
+                               void *data);
 
 void nir_remap_dual_slot_attributes(nir_shader *shader,
                                     uint64_t *dual_slot_inputs);
@@ -854,15 +854,14 @@ nir_opt_deref_impl(nir_function_impl *impl)
    return progress;
 }
 
+static bool
+opt_deref_impl_cb(nir_function_impl *impl, void *data)
+{
+   return nir_opt_deref_impl(impl);
+}
+
 bool
 nir_opt_deref(nir_shader *shader)
 {
-   bool progress = false;
-
-   nir_foreach_function(func, shader) {
-      if (func->impl && nir_opt_deref_impl(func->impl))
-         progress = true;
-   }
-
-   return progress;
+   return nir_shader_impls_parallel(shader, opt_deref_impl_cb, NULL);
 }
@@ -183,7 +183,10 @@ inline_function_impl(nir_function_impl *impl, struct set *inlined)
  *  3. nir_inline_functions(shader)
  *
  *     This does the actual function inlining and the resulting shader will
- *     contain no call instructions.
+ *     contain no call instructions reachable from an entrypoint.  If any
+ *     function is flagged with is_entrypoint, functions not reachable from
+ *     one are left alone since they are going to be deleted in step 5.
+ *     Otherwise, calls are inlined into every function.
  *
  *  4. nir_opt_deref(shader)
  *
@@ -229,9 +232,26 @@ nir_inline_functions(nir_shader *shader)
    struct set *inlined = _mesa_pointer_set_create(NULL);
    bool progress = false;
 
+   /* If we know the entrypoints, only they and whatever they transitively
+    * call need to be processed.  Everything else is about to be deleted
+    * anyway and, for shaders linked against big helper libraries, inlining
+    * into every unreferenced library function is most of the work and
+    * memory this pass would otherwise spend.
+    */
+   bool has_entrypoint = false;
+   nir_foreach_function(function, shader) {
+      if (function->is_entrypoint && function->impl)
+         has_entrypoint = true;
+   }
+
    nir_foreach_function(function, shader) {
-      if (function->impl)
-         progress = inline_function_impl(function->impl, inlined) || progress;
+      if (!function->impl)
+         continue;
+
+      if (has_entrypoint && !function->is_entrypoint)
+         continue;
+
+      progress = inline_function_impl(function->impl, inlined) || progress;
    }
 
    _mesa_set_destroy(inlined, NULL);
@@ -809,6 +809,23 @@ nir_instr_set_destroy(struct set *instr_set)
    _mesa_set_destroy(instr_set, NULL);
 }
 
+static void
+rewrite_to_match(nir_instr *instr, nir_instr *match)
+{
+   nir_ssa_def *def = nir_instr_get_dest_ssa_def(instr);
+   nir_ssa_def *new_def = nir_instr_get_dest_ssa_def(match);
+
+   /* It's safe to replace an exact instruction with an inexact one as
+    * long as we make it exact.  If we got here, the two instructions are
+    * exactly identical in every other way so, once we've set the exact
+    * bit, they are the same.
+    */
+   if (instr->type == nir_instr_type_alu && nir_instr_as_alu(instr)->exact)
+      nir_instr_as_alu(match)->exact = true;
+
+   nir_ssa_def_rewrite_uses(def, nir_src_for_ssa(new_def));
+}
+
 bool
 nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr)
 {
@@ -818,19 +835,7 @@ nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr)
    uint32_t hash = hash_instr(instr);
    struct set_entry *e = _mesa_set_search_pre_hashed(instr_set, hash, instr);
    if (e) {
-      nir_ssa_def *def = nir_instr_get_dest_ssa_def(instr);
-      nir_instr *match = (nir_instr *) e->key;
-      nir_ssa_def *new_def = nir_instr_get_dest_ssa_def(match);
-
-      /* It's safe to replace an exact instruction with an inexact one as
-       * long as we make it exact.  If we got here, the two instructions are
-       * exactly identical in every other way so, once we've set the exact
-       * bit, they are the same.
-       */
-      if (instr->type == nir_instr_type_alu && nir_instr_as_alu(instr)->exact)
-         nir_instr_as_alu(match)->exact = true;
-
-      nir_ssa_def_rewrite_uses(def, nir_src_for_ssa(new_def));
+      rewrite_to_match(instr, (nir_instr *) e->key);
       return true;
    }
 
@@ -838,6 +843,21 @@ nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr)
    return false;
 }
 
+nir_instr *
+nir_instr_set_search_and_rewrite(struct set *instr_set, nir_instr *instr)
+{
+   if (!instr_can_rewrite(instr))
+      return NULL;
+
+   struct set_entry *e = _mesa_set_search(instr_set, instr);
+   if (!e)
+      return NULL;
+
+   nir_instr *match = (nir_instr *) e->key;
+   rewrite_to_match(instr, match);
+   return match;
+}
+
 void
 nir_instr_set_remove(struct set *instr_set, nir_instr *instr)
 {
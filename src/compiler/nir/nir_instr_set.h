@@ -53,6 +53,14 @@ void nir_instr_set_destroy(struct set *instr_set);
  */
 bool nir_instr_set_add_or_rewrite(struct set *instr_set, nir_instr *instr);
 
+/**
+ * Looks for an instruction equal to the given one in the set.  If there is
+ * one, rewrites all uses of the given instruction to point to it and returns
+ * it, otherwise returns NULL.  The given instruction is never added.
+ */
+nir_instr *nir_instr_set_search_and_rewrite(struct set *instr_set,
+                                            nir_instr *instr);
+
 /**
  * Removes an instruction from an instruction set, so that other instructions
  * won't be merged with it.
@@ -25,6 +25,7 @@
 #include "nir_builder.h"
 #include "util/set.h"
 #include "util/hash_table.h"
+#include "util/u_dynarray.h"
 
 /* This file contains various little helpers for doing simple linking in
  * NIR.  Eventually, we'll probably want a full-blown varying packing
@@ -772,22 +773,67 @@ nir_link_xfb_varyings(nir_shader *producer, nir_shader *consumer)
    }
 }
 
+/* The consumer inputs which can be replaced, and the instructions loading
+ * them, indexed by generic slot and component.  Gathering them once keeps
+ * nir_link_opt_varyings() from walking the whole consumer for every output.
+ */
+struct consumer_input_loads {
+   nir_variable *vars[MAX_VARYING][4];
+   struct util_dynarray loads[MAX_VARYING][4];
+};
+
 static bool
-does_varying_match(nir_variable *out_var, nir_variable *in_var)
+get_input_slot(nir_variable *var, unsigned *slot, unsigned *comp)
 {
-   return in_var->data.location == out_var->data.location &&
-          in_var->data.location_frac == out_var->data.location_frac;
+   if (var->data.location < VARYING_SLOT_VAR0 ||
+       var->data.location - VARYING_SLOT_VAR0 >= MAX_VARYING)
+      return false;
+
+   *slot = var->data.location - VARYING_SLOT_VAR0;
+   *comp = var->data.location_frac;
+   return true;
 }
 
-static nir_variable *
-get_matching_input_var(nir_shader *consumer, nir_variable *out_var)
+static void
+gather_consumer_input_loads(nir_shader *consumer,
+                            struct consumer_input_loads *info,
+                            void *mem_ctx)
 {
+   unsigned slot, comp;
+
+   for (slot = 0; slot < MAX_VARYING; slot++) {
+      for (comp = 0; comp < 4; comp++) {
+         info->vars[slot][comp] = NULL;
+         util_dynarray_init(&info->loads[slot][comp], mem_ctx);
+      }
+   }
+
    nir_foreach_variable(var, &consumer->inputs) {
-      if (does_varying_match(out_var, var))
-         return var;
+      if (get_input_slot(var, &slot, &comp) && !info->vars[slot][comp])
+         info->vars[slot][comp] = var;
    }
 
-   return NULL;
+   nir_function_impl *impl = nir_shader_get_entrypoint(consumer);
+
+   nir_foreach_block(block, impl) {
+      nir_foreach_instr(instr, block) {
+         if (instr->type != nir_instr_type_intrinsic)
+            continue;
+
+         nir_intrinsic_instr *intr = nir_instr_as_intrinsic(instr);
+         if (intr->intrinsic != nir_intrinsic_load_deref)
+            continue;
+
+         nir_deref_instr *in_deref = nir_src_as_deref(intr->src[0]);
+         if (in_deref->mode != nir_var_shader_in)
+            continue;
+
+         nir_variable *in_var = nir_deref_instr_get_variable(in_deref);
+         if (get_input_slot(in_var, &slot, &comp))
+            util_dynarray_append(&info->loads[slot][comp],
+                                 nir_intrinsic_instr *, intr);
+      }
+   }
 }
 
 static bool
@@ -816,7 +862,9 @@ can_replace_varying(nir_variable *out_var)
 }
 
 static bool
-replace_constant_input(nir_shader *shader, nir_intrinsic_instr *store_intr)
+replace_constant_input(nir_shader *shader,
+                       struct consumer_input_loads *info,
+                       nir_intrinsic_instr *store_intr)
 {
    nir_function_impl *impl = nir_shader_get_entrypoint(shader);
 
@@ -825,48 +873,39 @@ replace_constant_input(nir_shader *shader, nir_intrinsic_instr *store_intr)
 
    nir_variable *out_var =
       nir_deref_instr_get_variable(nir_src_as_deref(store_intr->src[0]));
+   unsigned slot, comp;
 
-   bool progress = false;
-   nir_foreach_block(block, impl) {
-      nir_foreach_instr(instr, block) {
-         if (instr->type != nir_instr_type_intrinsic)
-            continue;
-
-         nir_intrinsic_instr *intr = nir_instr_as_intrinsic(instr);
-         if (intr->intrinsic != nir_intrinsic_load_deref)
-            continue;
-
-         nir_deref_instr *in_deref = nir_src_as_deref(intr->src[0]);
-         if (in_deref->mode != nir_var_shader_in)
-            continue;
-
-         nir_variable *in_var = nir_deref_instr_get_variable(in_deref);
+   if (!get_input_slot(out_var, &slot, &comp))
+      return false;
 
-         if (!does_varying_match(out_var, in_var))
-            continue;
+   bool progress = false;
+   util_dynarray_foreach(&info->loads[slot][comp], nir_intrinsic_instr *,
+                         load) {
+      nir_intrinsic_instr *intr = *load;
 
-         b.cursor = nir_before_instr(instr);
+      b.cursor = nir_before_instr(&intr->instr);
 
-         nir_load_const_instr *out_const =
-            nir_instr_as_load_const(store_intr->src[1].ssa->parent_instr);
+      nir_load_const_instr *out_const =
+         nir_instr_as_load_const(store_intr->src[1].ssa->parent_instr);
 
-         /* Add new const to replace the input */
-         nir_ssa_def *nconst = nir_build_imm(&b, store_intr->num_components,
-                                             intr->dest.ssa.bit_size,
-                                             out_const->value);
+      /* Add new const to replace the input */
+      nir_ssa_def *nconst = nir_build_imm(&b, store_intr->num_components,
+                                          intr->dest.ssa.bit_size,
+                                          out_const->value);
 
-         nir_ssa_def_rewrite_uses(&intr->dest.ssa, nir_src_for_ssa(nconst));
+      nir_ssa_def_rewrite_uses(&intr->dest.ssa, nir_src_for_ssa(nconst));
 
-         progress = true;
-      }
+      progress = true;
    }
 
    return progress;
 }
 
 static bool
-replace_duplicate_input(nir_shader *shader, nir_variable *input_var,
-                         nir_intrinsic_instr *dup_store_intr)
+replace_duplicate_input(nir_shader *shader,
+                        struct consumer_input_loads *info,
+                        nir_variable *input_var,
+                        nir_intrinsic_instr *dup_store_intr)
 {
    assert(input_var);
 
@@ -877,35 +916,42 @@ replace_duplicate_input(nir_shader *shader, nir_variable *input_var,
 
    nir_variable *dup_out_var =
       nir_deref_instr_get_variable(nir_src_as_deref(dup_store_intr->src[0]));
+   unsigned slot, comp, input_slot, input_comp;
 
-   bool progress = false;
-   nir_foreach_block(block, impl) {
-      nir_foreach_instr(instr, block) {
-         if (instr->type != nir_instr_type_intrinsic)
-            continue;
-
-         nir_intrinsic_instr *intr = nir_instr_as_intrinsic(instr);
-         if (intr->intrinsic != nir_intrinsic_load_deref)
-            continue;
+   if (!get_input_slot(dup_out_var, &slot, &comp) ||
+       !get_input_slot(input_var, &input_slot, &input_comp))
+      return false;
 
-         nir_deref_instr *in_deref = nir_src_as_deref(intr->src[0]);
-         if (in_deref->mode != nir_var_shader_in)
-            continue;
+   /* The loads added below are appended to the input's list, which may be
+    * this one, so only walk the loads that were there to begin with.
+    */
+   unsigned num_loads =
+      util_dynarray_num_elements(&info->loads[slot][comp],
+                                 nir_intrinsic_instr *);
 
-         nir_variable *in_var = nir_deref_instr_get_variable(in_deref);
+   bool progress = false;
+   for (unsigned i = 0; i < num_loads; i++) {
+      nir_intrinsic_instr *intr =
+         *util_dynarray_element(&info->loads[slot][comp],
+                                nir_intrinsic_instr *, i);
+      nir_variable *in_var =
+         nir_deref_instr_get_variable(nir_src_as_deref(intr->src[0]));
+
+      if (in_var->data.interpolation != input_var->data.interpolation ||
+          get_interp_loc(in_var) != get_interp_loc(input_var))
+         continue;
 
-         if (!does_varying_match(dup_out_var, in_var) ||
-             in_var->data.interpolation != input_var->data.interpolation ||
-             get_interp_loc(in_var) != get_interp_loc(input_var))
-            continue;
+      b.cursor = nir_before_instr(&intr->instr);
 
-         b.cursor = nir_before_instr(instr);
+      nir_ssa_def *load = nir_load_var(&b, input_var);
+      nir_ssa_def_rewrite_uses(&intr->dest.ssa, nir_src_for_ssa(load));
 
-         nir_ssa_def *load = nir_load_var(&b, input_var);
-         nir_ssa_def_rewrite_uses(&intr->dest.ssa, nir_src_for_ssa(load));
+      /* Later outputs may be replaced by this input again. */
+      util_dynarray_append(&info->loads[input_slot][input_comp],
+                           nir_intrinsic_instr *,
+                           nir_instr_as_intrinsic(load->parent_instr));
 
-         progress = true;
-      }
+      progress = true;
    }
 
    return progress;
@@ -925,6 +971,10 @@ nir_link_opt_varyings(nir_shader *producer, nir_shader *consumer)
    nir_function_impl *impl = nir_shader_get_entrypoint(producer);
 
    struct hash_table *varying_values = _mesa_pointer_hash_table_create(NULL);
+   struct consumer_input_loads *input_loads =
+      ralloc(varying_values, struct consumer_input_loads);
+
+   gather_consumer_input_loads(consumer, input_loads, varying_values);
 
    /* If we find a store in the last block of the producer we can be sure this
     * is the only possible value for this output.
@@ -948,16 +998,18 @@ nir_link_opt_varyings(nir_shader *producer, nir_shader *consumer)
          continue;
 
       if (intr->src[1].ssa->parent_instr->type == nir_instr_type_load_const) {
-         progress |= replace_constant_input(consumer, intr);
+         progress |= replace_constant_input(consumer, input_loads, intr);
       } else {
          struct hash_entry *entry =
                _mesa_hash_table_search(varying_values, intr->src[1].ssa);
          if (entry) {
-            progress |= replace_duplicate_input(consumer,
+            progress |= replace_duplicate_input(consumer, input_loads,
                                                 (nir_variable *) entry->data,
                                                 intr);
          } else {
-            nir_variable *in_var = get_matching_input_var(consumer, out_var);
+            nir_variable *in_var =
+               input_loads->vars[out_var->data.location - VARYING_SLOT_VAR0]
+                                [out_var->data.location_frac];
             if (in_var) {
                _mesa_hash_table_insert(varying_values, intr->src[1].ssa,
                                        in_var);
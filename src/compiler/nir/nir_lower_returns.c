@@ -283,15 +283,14 @@ nir_lower_returns_impl(nir_function_impl *impl)
    return progress;
 }
 
+static bool
+lower_returns_impl_cb(nir_function_impl *impl, void *data)
+{
+   return nir_lower_returns_impl(impl);
+}
+
 bool
 nir_lower_returns(nir_shader *shader)
 {
-   bool progress = false;
-
-   nir_foreach_function(function, shader) {
-      if (function->impl)
-         progress = nir_lower_returns_impl(function->impl) || progress;
-   }
-
-   return progress;
+   return nir_shader_impls_parallel(shader, lower_returns_impl_cb, NULL);
 }
@@ -0,0 +1,161 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "nir_instr_set.h"
+
+/**
+ * \file nir_opt_hoist_common.c
+ *
+ * Hoists values computed by both sides of an if out of it.
+ *
+ * nir_opt_cse only merges an instruction into an equal one that dominates
+ * it, so the same UBO load or ALU expression computed at the top of both
+ * the then and the else branch survives CSE.  Instructions in the first
+ * block of a branch run whenever that branch is taken, so when the first
+ * blocks of both branches compute the same value from sources available
+ * before the if, the computation can be moved in front of the if without
+ * executing anything speculatively.
+ *
+ * Ifs are visited innermost first, so values hoisted out of a nested if
+ * can continue to be hoisted out of the enclosing one.
+ */
+
+static bool
+src_is_available(nir_src *src, void *state)
+{
+   nir_block *before = state;
+
+   return src->is_ssa &&
+          nir_block_dominates(src->ssa->parent_instr->block, before);
+}
+
+static bool
+hoist_if(nir_if *nif, struct set *instr_set)
+{
+   nir_block *before = nir_cf_node_as_block(nir_cf_node_prev(&nif->cf_node));
+   bool progress = false;
+
+   _mesa_set_clear(instr_set, NULL);
+
+   nir_foreach_instr_safe(instr, nir_if_first_then_block(nif)) {
+      if (instr->type == nir_instr_type_phi)
+         continue;
+
+      /* Duplicates within the branch are cleaned up on the way. */
+      if (nir_instr_set_add_or_rewrite(instr_set, instr)) {
+         nir_instr_remove(instr);
+         progress = true;
+      }
+   }
+
+   /* Walk the else block in order: once an instruction is hoisted, the
+    * uses of its else copy point at the hoisted value and the instructions
+    * depending on it can match their then counterparts in turn.
+    */
+   nir_foreach_instr_safe(instr, nir_if_first_else_block(nif)) {
+      if (instr->type == nir_instr_type_phi ||
+          !nir_foreach_src(instr, src_is_available, before))
+         continue;
+
+      nir_instr *match = nir_instr_set_search_and_rewrite(instr_set, instr);
+      if (!match)
+         continue;
+
+      nir_instr_set_remove(instr_set, match);
+      nir_instr_remove(match);
+      nir_instr_insert(nir_after_block(before), match);
+
+      nir_instr_remove(instr);
+      progress = true;
+   }
+
+   return progress;
+}
+
+static bool
+hoist_cf_list(struct exec_list *cf_list, struct set *instr_set)
+{
+   bool progress = false;
+
+   foreach_list_typed(nir_cf_node, node, node, cf_list) {
+      switch (node->type) {
+      case nir_cf_node_block:
+         break;
+
+      case nir_cf_node_if: {
+         nir_if *nif = nir_cf_node_as_if(node);
+         progress |= hoist_cf_list(&nif->then_list, instr_set);
+         progress |= hoist_cf_list(&nif->else_list, instr_set);
+         progress |= hoist_if(nif, instr_set);
+         break;
+      }
+
+      case nir_cf_node_loop: {
+         nir_loop *loop = nir_cf_node_as_loop(node);
+         progress |= hoist_cf_list(&loop->body, instr_set);
+         break;
+      }
+
+      default:
+         unreachable("Invalid CF node type");
+      }
+   }
+
+   return progress;
+}
+
+static bool
+nir_opt_hoist_common_impl(nir_function_impl *impl)
+{
+   struct set *instr_set = nir_instr_set_create(NULL);
+
+   nir_metadata_require(impl, nir_metadata_block_index |
+                              nir_metadata_dominance);
+
+   bool progress = hoist_cf_list(&impl->body, instr_set);
+
+   if (progress) {
+      nir_metadata_preserve(impl, nir_metadata_block_index |
+                                  nir_metadata_dominance);
+   } else {
+#ifndef NDEBUG
+      impl->valid_metadata &= ~nir_metadata_not_properly_reset;
+#endif
+   }
+
+   nir_instr_set_destroy(instr_set);
+   return progress;
+}
+
+bool
+nir_opt_hoist_common(nir_shader *shader)
+{
+   bool progress = false;
+
+   nir_foreach_function(function, shader) {
+      if (function->impl)
+         progress |= nir_opt_hoist_common_impl(function->impl);
+   }
+
+   return progress;
+}
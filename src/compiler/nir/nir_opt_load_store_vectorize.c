@@ -0,0 +1,452 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "nir.h"
+#include "nir_builder.h"
+#include "util/u_dynarray.h"
+
+/**
+ * \file nir_opt_load_store_vectorize.c
+ *
+ * Combines UBO and SSBO accesses to adjacent addresses of the same buffer
+ * into wider ones, so that e.g. the four scalar loads nir_lower_io emits
+ * for the members of a struct become a single vec4 load.
+ *
+ * Only accesses within a block are combined.  Two accesses are adjacent
+ * when they use the same buffer index and the same offset SSA value plus
+ * constants that differ by exactly the size of the lower access.
+ *
+ * Loads are combined at the position of the earlier of the two; SSBO loads
+ * aren't combined across anything that may write memory.  Stores are only
+ * combined with the SSBO store immediately before them, at the position of
+ * the later one, so that no other memory access is reordered with either.
+ *
+ * The driver decides through a callback which combined accesses it wants.
+ */
+
+struct mem_access {
+   nir_intrinsic_instr *intrin;
+
+   /** Position in the block, to find which of two accesses comes first. */
+   unsigned index;
+
+   nir_ssa_def *resource;
+
+   /** offset = base + offset_const, base is NULL for constant offsets. */
+   nir_ssa_def *base;
+   uint64_t offset_const;
+};
+
+struct vectorize_state {
+   nir_builder b;
+   nir_variable_mode modes;
+   nir_should_vectorize_mem_func callback;
+   struct util_dynarray loads;
+   struct mem_access prev_store;
+   bool have_prev_store;
+};
+
+static bool
+is_load(nir_intrinsic_instr *intrin, nir_variable_mode modes)
+{
+   switch (intrin->intrinsic) {
+   case nir_intrinsic_load_ubo:
+      return modes & nir_var_mem_ubo;
+   case nir_intrinsic_load_ssbo:
+      return modes & nir_var_mem_ssbo;
+   default:
+      return false;
+   }
+}
+
+static bool
+is_store(nir_intrinsic_instr *intrin, nir_variable_mode modes)
+{
+   return intrin->intrinsic == nir_intrinsic_store_ssbo &&
+          (modes & nir_var_mem_ssbo);
+}
+
+static void
+parse_access(struct mem_access *access, nir_intrinsic_instr *intrin,
+             unsigned index)
+{
+   const unsigned res_src = intrin->intrinsic == nir_intrinsic_store_ssbo;
+   nir_ssa_def *offset = intrin->src[res_src + 1].ssa;
+
+   access->intrin = intrin;
+   access->index = index;
+   access->resource = intrin->src[res_src].ssa;
+   access->base = offset;
+   access->offset_const = 0;
+
+   if (offset->parent_instr->type == nir_instr_type_load_const) {
+      access->base = NULL;
+      access->offset_const = nir_src_as_uint(intrin->src[res_src + 1]);
+      return;
+   }
+
+   if (offset->parent_instr->type != nir_instr_type_alu)
+      return;
+
+   nir_alu_instr *alu = nir_instr_as_alu(offset->parent_instr);
+   if (alu->op != nir_op_iadd)
+      return;
+
+   for (unsigned i = 0; i < 2; i++) {
+      nir_alu_src *other = &alu->src[1 - i];
+
+      if (!nir_src_is_const(alu->src[i].src) || !other->src.is_ssa ||
+          other->src.ssa->num_components != 1 ||
+          other->negate || other->abs)
+         continue;
+
+      access->base = other->src.ssa;
+      access->offset_const =
+         nir_src_comp_as_uint(alu->src[i].src, alu->src[i].swizzle[0]);
+      return;
+   }
+}
+
+static unsigned
+access_num_components(const struct mem_access *access)
+{
+   return access->intrin->num_components;
+}
+
+static unsigned
+access_bit_size(const struct mem_access *access)
+{
+   if (access->intrin->intrinsic == nir_intrinsic_store_ssbo)
+      return nir_src_bit_size(access->intrin->src[0]);
+   return nir_dest_bit_size(access->intrin->dest);
+}
+
+static unsigned
+access_align(const struct mem_access *access)
+{
+   if (nir_intrinsic_align_mul(access->intrin))
+      return nir_intrinsic_align(access->intrin);
+
+   if (!access->base && access->offset_const)
+      return MIN2(access->offset_const & -access->offset_const, 16);
+
+   return access_bit_size(access) / 8;
+}
+
+/**
+ * Returns whether \p low and \p high can be combined, \p low covering the
+ * lower addresses.
+ */
+static bool
+can_combine(struct vectorize_state *state,
+            const struct mem_access *low, const struct mem_access *high)
+{
+   if (low->intrin->intrinsic != high->intrin->intrinsic ||
+       low->resource != high->resource ||
+       low->base != high->base)
+      return false;
+
+   if (nir_intrinsic_access(low->intrin) != nir_intrinsic_access(high->intrin) ||
+       (nir_intrinsic_access(low->intrin) & ACCESS_VOLATILE))
+      return false;
+
+   const unsigned bit_size = access_bit_size(low);
+   if (bit_size != access_bit_size(high))
+      return false;
+
+   const unsigned num_components =
+      access_num_components(low) + access_num_components(high);
+   if (num_components > 4)
+      return false;
+
+   if (high->offset_const !=
+       low->offset_const + access_num_components(low) * bit_size / 8)
+      return false;
+
+   return state->callback(access_align(low), bit_size, num_components,
+                          low->intrin, high->intrin);
+}
+
+static nir_ssa_def *
+build_offset(nir_builder *b, const struct mem_access *low)
+{
+   if (!low->base)
+      return nir_imm_int(b, low->offset_const);
+
+   return nir_iadd(b, low->base, nir_imm_int(b, low->offset_const));
+}
+
+static void
+combine_loads(struct vectorize_state *state, struct mem_access *first,
+              const struct mem_access *second)
+{
+   nir_builder *b = &state->b;
+   const struct mem_access *low, *high;
+
+   if (first->offset_const < second->offset_const) {
+      low = first;
+      high = second;
+   } else {
+      low = second;
+      high = first;
+   }
+
+   const unsigned low_components = access_num_components(low);
+   const unsigned high_components = access_num_components(high);
+   const unsigned bit_size = access_bit_size(low);
+
+   b->cursor = nir_before_instr(&first->intrin->instr);
+
+   nir_intrinsic_instr *load =
+      nir_intrinsic_instr_create(b->shader, low->intrin->intrinsic);
+   load->num_components = low_components + high_components;
+   load->src[0] = nir_src_for_ssa(low->resource);
+   load->src[1] = nir_src_for_ssa(build_offset(b, low));
+   memcpy(load->const_index, low->intrin->const_index,
+          sizeof(load->const_index));
+   nir_ssa_dest_init(&load->instr, &load->dest, load->num_components,
+                     bit_size, NULL);
+   nir_builder_instr_insert(b, &load->instr);
+
+   nir_ssa_def *low_val =
+      nir_channels(b, &load->dest.ssa, (1 << low_components) - 1);
+   nir_ssa_def *high_val =
+      nir_channels(b, &load->dest.ssa,
+                   ((1 << high_components) - 1) << low_components);
+
+   nir_ssa_def_rewrite_uses(&low->intrin->dest.ssa, nir_src_for_ssa(low_val));
+   nir_ssa_def_rewrite_uses(&high->intrin->dest.ssa, nir_src_for_ssa(high_val));
+   nir_instr_remove(&low->intrin->instr);
+   nir_instr_remove(&high->intrin->instr);
+
+   parse_access(first, load, first->index);
+}
+
+static bool
+add_load(struct vectorize_state *state, struct mem_access *access)
+{
+   bool progress = false;
+   bool retry;
+
+   do {
+      retry = false;
+
+      util_dynarray_foreach(&state->loads, struct mem_access, other) {
+         const struct mem_access *low, *high;
+
+         if (other->offset_const < access->offset_const) {
+            low = other;
+            high = access;
+         } else {
+            low = access;
+            high = other;
+         }
+
+         if (!can_combine(state, low, high))
+            continue;
+
+         /* The combined load takes the place of the earlier one. */
+         struct mem_access combined;
+         if (other->index < access->index) {
+            combined = *other;
+            combine_loads(state, &combined, access);
+         } else {
+            combined = *access;
+            combine_loads(state, &combined, other);
+         }
+
+         *other = *util_dynarray_top_ptr(&state->loads, struct mem_access);
+         (void) util_dynarray_pop(&state->loads, struct mem_access);
+         *access = combined;
+
+         progress = retry = true;
+         break;
+      }
+   } while (retry);
+
+   util_dynarray_append(&state->loads, struct mem_access, *access);
+   return progress;
+}
+
+static bool
+add_store(struct vectorize_state *state, struct mem_access *access)
+{
+   struct mem_access *prev = &state->prev_store;
+   const struct mem_access *low, *high;
+
+   if (!state->have_prev_store) {
+      *prev = *access;
+      state->have_prev_store = true;
+      return false;
+   }
+
+   if (prev->offset_const < access->offset_const) {
+      low = prev;
+      high = access;
+   } else {
+      low = access;
+      high = prev;
+   }
+
+   const unsigned low_components = access_num_components(low);
+   const unsigned high_components = access_num_components(high);
+
+   if (nir_intrinsic_write_mask(low->intrin) != (1 << low_components) - 1 ||
+       nir_intrinsic_write_mask(high->intrin) != (1 << high_components) - 1 ||
+       !can_combine(state, low, high)) {
+      *prev = *access;
+      return false;
+   }
+
+   nir_builder *b = &state->b;
+   b->cursor = nir_before_instr(&access->intrin->instr);
+
+   nir_ssa_def *comps[4];
+   for (unsigned i = 0; i < low_components; i++)
+      comps[i] = nir_channel(b, low->intrin->src[0].ssa, i);
+   for (unsigned i = 0; i < high_components; i++)
+      comps[low_components + i] = nir_channel(b, high->intrin->src[0].ssa, i);
+
+   nir_intrinsic_instr *store =
+      nir_intrinsic_instr_create(b->shader, nir_intrinsic_store_ssbo);
+   store->num_components = low_components + high_components;
+   store->src[0] = nir_src_for_ssa(nir_vec(b, comps, store->num_components));
+   store->src[1] = nir_src_for_ssa(low->resource);
+   store->src[2] = nir_src_for_ssa(build_offset(b, low));
+   memcpy(store->const_index, low->intrin->const_index,
+          sizeof(store->const_index));
+   nir_intrinsic_set_write_mask(store, (1 << store->num_components) - 1);
+   nir_builder_instr_insert(b, &store->instr);
+
+   nir_instr_remove(&prev->intrin->instr);
+   nir_instr_remove(&access->intrin->instr);
+
+   parse_access(prev, store, access->index);
+   return true;
+}
+
+static bool
+vectorize_block(struct vectorize_state *state, nir_block *block)
+{
+   bool progress = false;
+   unsigned index = 0;
+
+   util_dynarray_clear(&state->loads);
+   state->have_prev_store = false;
+
+   nir_foreach_instr_safe(instr, block) {
+      index++;
+
+      if (instr->type == nir_instr_type_call) {
+         util_dynarray_clear(&state->loads);
+         state->have_prev_store = false;
+         continue;
+      }
+
+      if (instr->type != nir_instr_type_intrinsic)
+         continue;
+
+      nir_intrinsic_instr *intrin = nir_instr_as_intrinsic(instr);
+      const unsigned flags = nir_intrinsic_infos[intrin->intrinsic].flags;
+      struct mem_access access;
+
+      if (is_load(intrin, state->modes) && intrin->dest.is_ssa) {
+         parse_access(&access, intrin, index);
+         progress |= add_load(state, &access);
+         if (intrin->intrinsic == nir_intrinsic_load_ssbo)
+            state->have_prev_store = false;
+         continue;
+      }
+
+      if (is_store(intrin, state->modes) && intrin->src[0].is_ssa) {
+         parse_access(&access, intrin, index);
+         progress |= add_store(state, &access);
+      } else if (!(flags & NIR_INTRINSIC_CAN_REORDER)) {
+         /* Anything that may touch memory ends the store sequence. */
+         state->have_prev_store = false;
+      }
+
+      /* SSBO loads can't be combined across possible writes.  UBOs are
+       * read-only, so keep those.
+       */
+      if (!(flags & NIR_INTRINSIC_CAN_ELIMINATE)) {
+         unsigned i = 0;
+         while (i < util_dynarray_num_elements(&state->loads, struct mem_access)) {
+            struct mem_access *load =
+               util_dynarray_element(&state->loads, struct mem_access, i);
+
+            if (load->intrin->intrinsic == nir_intrinsic_load_ssbo) {
+               *load = *util_dynarray_top_ptr(&state->loads, struct mem_access);
+               (void) util_dynarray_pop(&state->loads, struct mem_access);
+            } else {
+               i++;
+            }
+         }
+      }
+   }
+
+   return progress;
+}
+
+static bool
+nir_opt_load_store_vectorize_impl(nir_function_impl *impl,
+                                  nir_variable_mode modes,
+                                  nir_should_vectorize_mem_func callback)
+{
+   struct vectorize_state state = {
+      .modes = modes,
+      .callback = callback,
+   };
+   bool progress = false;
+
+   nir_builder_init(&state.b, impl);
+   util_dynarray_init(&state.loads, NULL);
+
+   nir_foreach_block(block, impl)
+      progress |= vectorize_block(&state, block);
+
+   util_dynarray_fini(&state.loads);
+
+   if (progress) {
+      nir_metadata_preserve(impl, nir_metadata_block_index |
+                                  nir_metadata_dominance);
+   }
+
+   return progress;
+}
+
+bool
+nir_opt_load_store_vectorize(nir_shader *shader, nir_variable_mode modes,
+                             nir_should_vectorize_mem_func callback)
+{
+   bool progress = false;
+
+   nir_foreach_function(function, shader) {
+      if (function->impl) {
+         progress |= nir_opt_load_store_vectorize_impl(function->impl, modes,
+                                                       callback);
+      }
+   }
+
+   return progress;
+}
@@ -770,6 +770,73 @@ partial_unroll(nir_shader *shader, nir_loop *loop, unsigned trip_count)
    _mesa_hash_table_destroy(remap_table, NULL);
 }
 
+/**
+ * Unrolls a loop with an unknown trip count in place, keeping the loop:
+ *
+ *     loop {
+ *         ...instrs...
+ *     }
+ *
+ * becomes, for a factor of 2:
+ *
+ *     loop {
+ *         ...instrs...
+ *         ...instrs...
+ *     }
+ *
+ * Every copy keeps its own breaks, so the loop still leaves after the right
+ * number of iterations without a remainder loop, but only takes the back
+ * edge (and runs the phi copies) once every factor iterations.  Induction
+ * variable updates of consecutive copies chain up, and later algebraic
+ * passes fold them into independent additions to the loop's phi value.
+ */
+static void
+partial_unroll_in_place(nir_loop *loop, unsigned factor)
+{
+   loop_prepare_for_unroll(loop);
+
+   /* With the phis at the top of the loop lowered to registers, values
+    * only flow between iterations through registers, so copies of the
+    * body can simply be appended to it.
+    */
+   nir_cf_list body;
+   nir_cf_list_extract(&body, &loop->body);
+
+   struct hash_table *remap_table = _mesa_pointer_hash_table_create(NULL);
+
+   for (unsigned i = 1; i < factor; i++) {
+      nir_cf_list_clone_and_reinsert(&body, &loop->cf_node,
+                                     nir_after_cf_list(&loop->body),
+                                     remap_table);
+   }
+
+   nir_cf_reinsert(&body, nir_before_cf_list(&loop->body));
+
+   loop->partially_unrolled = true;
+
+   _mesa_hash_table_destroy(remap_table, NULL);
+}
+
+static bool
+should_partially_unroll_in_place(nir_shader *shader, nir_loop *loop)
+{
+   const unsigned factor = shader->options->loop_partial_unroll_factor;
+
+   if (factor < 2 || loop->partially_unrolled ||
+       loop->control == nir_loop_control_dont_unroll)
+      return false;
+
+   /* Leave loops with a (guessable) trip count to the other strategies. */
+   if (loop->info->limiting_terminator || loop->info->guessed_trip_count)
+      return false;
+
+   /* do { } while (false) style loops only run once anyway. */
+   if (nir_block_ends_in_break(nir_loop_last_block(loop)))
+      return false;
+
+   return loop->info->instr_cost * factor <= LOOP_UNROLL_LIMIT;
+}
+
 /*
  * Returns true if we should unroll the loop, otherwise false.
  */
@@ -863,6 +930,13 @@ process_loops(nir_shader *sh, nir_cf_node *cf_node, bool *has_nested_loop_out)
          }
       }
 
+      if (!has_nested_loop && !progress &&
+          should_partially_unroll_in_place(sh, loop)) {
+         partial_unroll_in_place(loop, sh->options->loop_partial_unroll_factor);
+         progress = true;
+         goto exit;
+      }
+
       if (has_nested_loop || !loop->info->limiting_terminator)
          goto exit;
 
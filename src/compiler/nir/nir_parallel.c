@@ -0,0 +1,208 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/**
+ * \file nir_parallel.c
+ *
+ * Runs a function-local pass on all the impls of a shader at the same time.
+ *
+ * Instructions are allocated with the shader as their ralloc parent, and a
+ * ralloc context can only be used by one thread at a time.  So before the
+ * threads start, every impl is moved into a temporary shader of its own
+ * with nir_steal_impl, and its function is pointed at that shader so that
+ * the builder and the instruction constructors allocate from it too.  Once
+ * all the threads are done, the memory of the temporary shaders is moved
+ * back into the real one.
+ *
+ * The work is handed to a queue on the process-wide thread pool that is
+ * created on first use.  Only impls with at least MIN_PARALLEL_SSA_DEFS SSA
+ * values are moved to other threads, the calling thread runs the pass on
+ * the smaller ones in place, and a shader with fewer than two large impls
+ * is processed without any threading at all.
+ *
+ * Use NIR_THREADS=<n> to limit the number of threads, NIR_THREADS=1 runs
+ * the pass on one impl after the other.
+ */
+
+#include "nir.h"
+#include "c11/threads.h"
+#include "util/u_atomic.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_queue.h"
+
+/* Besides moving the memory of an impl, which costs a few times as much as
+ * a cheap pass like nir_opt_deref over it, handing an impl to the pool has a
+ * fixed cost of a few microseconds.  That only pays off for large impls.
+ */
+#define MIN_PARALLEL_SSA_DEFS 1024
+
+struct parallel_impl {
+   nir_function_impl *impl;
+   nir_shader *mem_ctx;
+   bool progress;
+};
+
+struct parallel_state {
+   struct parallel_impl *impls;
+   unsigned num_impls;
+   unsigned next_impl;
+
+   nir_impl_pass_func pass;
+   void *data;
+};
+
+static void
+parallel_thread(struct parallel_state *state)
+{
+   while (true) {
+      unsigned i = p_atomic_inc_return(&state->next_impl) - 1;
+      if (i >= state->num_impls)
+         break;
+
+      struct parallel_impl *pimpl = &state->impls[i];
+      pimpl->progress = state->pass(pimpl->impl, state->data);
+   }
+}
+
+static void
+parallel_job(void *data, int thread_index)
+{
+   parallel_thread(data);
+}
+
+static struct util_queue parallel_queue;
+static once_flag parallel_queue_once = ONCE_FLAG_INIT;
+
+static void
+parallel_queue_init(void)
+{
+   util_cpu_detect();
+
+   /* The calling thread works on the impls too. */
+   unsigned num_threads =
+      env_var_as_unsigned("NIR_THREADS", util_cpu_caps.nr_cpus);
+   if (num_threads <= 1)
+      return;
+
+   util_queue_init(&parallel_queue, "nir", 8, MIN2(num_threads - 1, 32),
+                   UTIL_QUEUE_INIT_SHARED |
+                   UTIL_QUEUE_INIT_HIGH_PRIORITY |
+                   UTIL_QUEUE_INIT_RESIZE_IF_FULL);
+}
+
+static inline bool
+is_large_impl(nir_function_impl *impl)
+{
+   return impl && impl->ssa_alloc >= MIN_PARALLEL_SSA_DEFS;
+}
+
+bool
+nir_shader_impls_parallel(nir_shader *shader, nir_impl_pass_func pass,
+                          void *data)
+{
+   unsigned num_impls = 0;
+   nir_foreach_function(function, shader) {
+      if (is_large_impl(function->impl))
+         num_impls++;
+   }
+
+   bool progress = false;
+
+   if (num_impls >= 2)
+      call_once(&parallel_queue_once, parallel_queue_init);
+
+   if (num_impls < 2 || !util_queue_is_initialized(&parallel_queue)) {
+      nir_foreach_function(function, shader) {
+         if (function->impl)
+            progress |= pass(function->impl, data);
+      }
+      return progress;
+   }
+
+   struct parallel_state state = {
+      .impls = calloc(num_impls, sizeof(struct parallel_impl)),
+      .num_impls = num_impls,
+      .pass = pass,
+      .data = data,
+   };
+
+   unsigned i = 0;
+   nir_foreach_function(function, shader) {
+      if (!is_large_impl(function->impl))
+         continue;
+
+      nir_shader *mem_ctx = nir_shader_create(NULL, shader->info.stage,
+                                              shader->options, NULL);
+      mem_ctx->info = shader->info;
+      nir_steal_impl(mem_ctx, function->impl);
+      function->shader = mem_ctx;
+
+      state.impls[i].impl = function->impl;
+      state.impls[i].mem_ctx = mem_ctx;
+      i++;
+   }
+
+   unsigned num_jobs = MIN2(num_impls - 1, parallel_queue.num_threads);
+   struct util_queue_fence *fences =
+      calloc(num_jobs, sizeof(struct util_queue_fence));
+
+   for (i = 0; i < num_jobs; i++) {
+      util_queue_fence_init(&fences[i]);
+      util_queue_add_job(&parallel_queue, &state, &fences[i], parallel_job,
+                         NULL);
+   }
+
+   /* The small impls still belong to the shader, run the pass on them here
+    * while the pool threads start.  The large impls can't be looked at any
+    * more, they were moved to their temporary shaders.
+    */
+   nir_foreach_function(function, shader) {
+      if (function->impl && function->shader == shader)
+         progress |= pass(function->impl, data);
+   }
+
+   parallel_thread(&state);
+
+   /* The pool may be busy with jobs that wait for this thread, so don't
+    * wait for jobs that haven't started.  There is nothing left for them.
+    */
+   for (i = 0; i < num_jobs; i++) {
+      util_queue_drop_job(&parallel_queue, &fences[i]);
+      util_queue_fence_destroy(&fences[i]);
+   }
+
+   for (i = 0; i < num_impls; i++) {
+      struct parallel_impl *pimpl = &state.impls[i];
+
+      pimpl->impl->function->shader = shader;
+      ralloc_adopt(shader, pimpl->mem_ctx);
+      ralloc_free(pimpl->mem_ctx);
+
+      progress |= pimpl->progress;
+   }
+
+   free(fences);
+   free(state.impls);
+
+   return progress;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/**
+ * \file nir_profile.c
+ *
+ * Compile time profiling of the passes run with NIR_PASS and NIR_PASS_V.
+ *
+ * With NIR_PROFILE=true, the time spent in each pass, how often it made
+ * progress and how it changed the number of instructions are summed up per
+ * pass and printed to stderr at exit.
+ *
+ * With NIR_PROFILE_TRACE=<file>, every pass invocation is also written to
+ * <file> as one line of comma separated values:
+ *
+ *    stage,shader,pass,time_ns,instrs_before,instrs_after,progress
+ *
+ * where progress is -1 for passes run with NIR_PASS_V.
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "nir.h"
+#include "c11/threads.h"
+#include "util/os_time.h"
+
+struct nir_profile_entry {
+   const char *pass;
+   uint64_t calls;
+   uint64_t progress_calls;
+   uint64_t unknown_progress_calls;
+   int64_t total_ns;
+   int64_t max_ns;
+   int64_t instr_delta;
+};
+
+static once_flag profile_once_flag = ONCE_FLAG_INIT;
+static mtx_t profile_mutex = _MTX_INITIALIZER_NP;
+static struct hash_table *profile_entries;
+static FILE *profile_trace;
+static bool profile_report;
+
+static int
+compare_entries(const void *a, const void *b)
+{
+   const struct nir_profile_entry *ea = *(const struct nir_profile_entry **)a;
+   const struct nir_profile_entry *eb = *(const struct nir_profile_entry **)b;
+
+   if (ea->total_ns != eb->total_ns)
+      return ea->total_ns < eb->total_ns ? 1 : -1;
+   return strcmp(ea->pass, eb->pass);
+}
+
+static void
+nir_profile_print_report(void)
+{
+   mtx_lock(&profile_mutex);
+
+   unsigned num_entries = profile_entries->entries;
+   struct nir_profile_entry **sorted =
+      malloc(num_entries * sizeof(*sorted));
+   if (!sorted) {
+      mtx_unlock(&profile_mutex);
+      return;
+   }
+
+   unsigned i = 0;
+   int64_t total_ns = 0;
+   hash_table_foreach(profile_entries, hentry) {
+      sorted[i] = hentry->data;
+      total_ns += sorted[i]->total_ns;
+      i++;
+   }
+   qsort(sorted, num_entries, sizeof(*sorted), compare_entries);
+
+   fprintf(stderr, "NIR pass profile (%.3f ms total):\n", total_ns / 1e6);
+   fprintf(stderr, "%-40s %10s %10s %12s %10s %12s\n",
+           "pass", "calls", "progress", "total ms", "max ms", "instrs +/-");
+
+   for (i = 0; i < num_entries; i++) {
+      const struct nir_profile_entry *entry = sorted[i];
+      char progress[32];
+
+      if (entry->unknown_progress_calls == entry->calls)
+         snprintf(progress, sizeof(progress), "-");
+      else
+         snprintf(progress, sizeof(progress), "%" PRIu64,
+                  entry->progress_calls);
+
+      fprintf(stderr, "%-40s %10" PRIu64 " %10s %12.3f %10.3f %+12" PRId64 "\n",
+              entry->pass, entry->calls, progress, entry->total_ns / 1e6,
+              entry->max_ns / 1e6, entry->instr_delta);
+   }
+
+   free(sorted);
+   mtx_unlock(&profile_mutex);
+}
+
+static void
+nir_profile_atexit(void)
+{
+   if (profile_report)
+      nir_profile_print_report();
+
+   if (profile_trace)
+      fclose(profile_trace);
+}
+
+static void
+nir_profile_init(void)
+{
+   profile_report = env_var_as_boolean("NIR_PROFILE", false);
+   profile_entries = _mesa_hash_table_create(NULL, _mesa_key_hash_string,
+                                             _mesa_key_string_equal);
+
+   const char *trace = getenv("NIR_PROFILE_TRACE");
+   if (trace && trace[0]) {
+      profile_trace = fopen(trace, "w");
+      if (!profile_trace)
+         fprintf(stderr, "NIR: failed to open profile trace %s\n", trace);
+   }
+
+   atexit(nir_profile_atexit);
+}
+
+static unsigned
+count_instrs(const nir_shader *shader)
+{
+   unsigned count = 0;
+
+   nir_foreach_function(function, shader) {
+      if (!function->impl)
+         continue;
+
+      nir_foreach_block(block, function->impl) {
+         nir_foreach_instr(instr, block)
+            count++;
+      }
+   }
+
+   return count;
+}
+
+void
+nir_profile_pass_start(struct nir_profile_pass *prof, const nir_shader *shader)
+{
+   prof->instrs_before = count_instrs(shader);
+   prof->start_ns = os_time_get_nano();
+}
+
+void
+nir_profile_pass_finish(struct nir_profile_pass *prof, const nir_shader *shader,
+                        int progress)
+{
+   int64_t time_ns = os_time_get_nano() - prof->start_ns;
+   unsigned instrs_after = count_instrs(shader);
+
+   call_once(&profile_once_flag, nir_profile_init);
+
+   mtx_lock(&profile_mutex);
+
+   struct hash_entry *hentry =
+      _mesa_hash_table_search(profile_entries, prof->pass);
+   struct nir_profile_entry *entry;
+
+   if (hentry) {
+      entry = hentry->data;
+   } else {
+      entry = rzalloc(profile_entries, struct nir_profile_entry);
+      entry->pass = prof->pass;
+      _mesa_hash_table_insert(profile_entries, entry->pass, entry);
+   }
+
+   entry->calls++;
+   if (progress < 0)
+      entry->unknown_progress_calls++;
+   else if (progress)
+      entry->progress_calls++;
+   entry->total_ns += time_ns;
+   entry->max_ns = MAX2(entry->max_ns, time_ns);
+   entry->instr_delta += (int64_t)instrs_after - prof->instrs_before;
+
+   if (profile_trace) {
+      fprintf(profile_trace, "%s,%s,%s,%" PRId64 ",%u,%u,%d\n",
+              gl_shader_stage_name(shader->info.stage),
+              shader->info.name ? shader->info.name : "",
+              prof->pass, time_ns, prof->instrs_before, instrs_after,
+              progress);
+   }
+
+   mtx_unlock(&profile_mutex);
+}
@@ -0,0 +1,477 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "nir.h"
+#include "util/set.h"
+#include "util/u_dynarray.h"
+
+/**
+ * \file nir_schedule.c
+ *
+ * A bottom-up list scheduler for the instructions of each block, meant to
+ * be run on SSA right before a backend translates NIR to its own IR.
+ *
+ * While the number of live values stays below the driver's threshold, the
+ * scheduler tries to hide latency: an instruction is placed only once the
+ * instructions using it can have its result without stalling, and among
+ * those the one heading the longest dependency chain goes first.  Once the
+ * threshold is crossed, it picks whatever keeps the fewest values live.
+ *
+ * Only SSA dependencies and the order of instructions with side effects
+ * constrain the schedule.  Phis stay at the top of the block and jumps at
+ * the bottom.  Blocks still containing registers are left alone.
+ */
+
+struct sched_node {
+   nir_instr *instr;
+
+   /** Instructions that must come before this one. */
+   struct util_dynarray parents;
+
+   /** Number of edges to instructions that must come after this one and
+    * haven't been scheduled yet.
+    */
+   unsigned unscheduled_children;
+
+   /** Latency of the instruction's result. */
+   unsigned delay;
+
+   /** Longest latency chain from the top of the block to this node. */
+   unsigned max_delay;
+
+   /** Earliest (bottom-up) time at which the node can be scheduled without
+    * its users stalling.
+    */
+   unsigned ready_time;
+
+   struct list_head ready_link;
+};
+
+struct sched_state {
+   const nir_schedule_options *options;
+   gl_shader_stage stage;
+
+   nir_block *block;
+   struct hash_table *nodes;
+
+   struct list_head ready;
+
+   /** SSA defs live below the current scheduling point. */
+   struct set *live;
+   unsigned pressure;
+
+   unsigned time;
+};
+
+static unsigned
+def_size(const nir_ssa_def *def)
+{
+   return def->num_components * DIV_ROUND_UP(def->bit_size, 32);
+}
+
+static bool
+src_is_ssa(nir_src *src, void *state)
+{
+   return src->is_ssa;
+}
+
+static bool
+dest_is_ssa(nir_dest *dest, void *state)
+{
+   return dest->is_ssa;
+}
+
+static nir_ssa_def *
+instr_def(nir_instr *instr)
+{
+   switch (instr->type) {
+   case nir_instr_type_alu:
+      return &nir_instr_as_alu(instr)->dest.dest.ssa;
+   case nir_instr_type_deref:
+      return &nir_instr_as_deref(instr)->dest.ssa;
+   case nir_instr_type_tex:
+      return &nir_instr_as_tex(instr)->dest.ssa;
+   case nir_instr_type_load_const:
+      return &nir_instr_as_load_const(instr)->def;
+   case nir_instr_type_ssa_undef:
+      return &nir_instr_as_ssa_undef(instr)->def;
+   case nir_instr_type_intrinsic: {
+      nir_intrinsic_instr *intrin = nir_instr_as_intrinsic(instr);
+      if (nir_intrinsic_infos[intrin->intrinsic].has_dest)
+         return &intrin->dest.ssa;
+      return NULL;
+   }
+   default:
+      return NULL;
+   }
+}
+
+/**
+ * Returns whether the instruction has to stay in order with the other
+ * instructions for which this returns true.
+ */
+static bool
+has_side_effects(struct sched_state *state, nir_instr *instr)
+{
+   if (instr->type == nir_instr_type_call)
+      return true;
+
+   if (instr->type != nir_instr_type_intrinsic)
+      return false;
+
+   nir_intrinsic_instr *intrin = nir_instr_as_intrinsic(instr);
+
+   /* Some backends read inputs from the memory outputs get written to. */
+   if ((state->options->stages_with_shared_io_memory & (1 << state->stage)) &&
+       (intrin->intrinsic == nir_intrinsic_load_input ||
+        intrin->intrinsic == nir_intrinsic_load_per_vertex_input))
+      return true;
+
+   return !nir_intrinsic_can_reorder(intrin);
+}
+
+static unsigned
+instr_delay(struct sched_state *state, nir_instr *instr)
+{
+   if (state->options->instr_delay)
+      return state->options->instr_delay(instr, state->options->data);
+
+   switch (instr->type) {
+   case nir_instr_type_tex:
+      return 20;
+   case nir_instr_type_intrinsic:
+      return nir_intrinsic_infos[nir_instr_as_intrinsic(instr)->intrinsic].has_dest ?
+         10 : 1;
+   default:
+      return 1;
+   }
+}
+
+static void
+add_edge(struct sched_node *parent, struct sched_node *child)
+{
+   util_dynarray_append(&child->parents, struct sched_node *, parent);
+   parent->unscheduled_children++;
+}
+
+struct add_src_edge_state {
+   struct sched_state *state;
+   struct sched_node *node;
+};
+
+static bool
+add_src_edge(nir_src *src, void *data)
+{
+   struct add_src_edge_state *s = data;
+   nir_instr *parent_instr = src->ssa->parent_instr;
+
+   if (parent_instr->block != s->state->block ||
+       parent_instr->type == nir_instr_type_phi)
+      return true;
+
+   struct hash_entry *entry = _mesa_hash_table_search(s->state->nodes,
+                                                      parent_instr);
+   add_edge(entry->data, s->node);
+   return true;
+}
+
+static bool
+def_used_outside_block(nir_ssa_def *def, nir_block *block)
+{
+   if (!list_empty(&def->if_uses))
+      return true;
+
+   nir_foreach_use(use, def) {
+      if (use->parent_instr->block != block ||
+          use->parent_instr->type == nir_instr_type_phi)
+         return true;
+   }
+
+   return false;
+}
+
+struct pressure_state {
+   struct sched_state *state;
+   int delta;
+   struct set *seen;
+};
+
+static bool
+count_new_live_src(nir_src *src, void *data)
+{
+   struct pressure_state *p = data;
+
+   if (!_mesa_set_search(p->state->live, src->ssa) &&
+       !_mesa_set_search(p->seen, src->ssa)) {
+      _mesa_set_add(p->seen, src->ssa);
+      p->delta += def_size(src->ssa);
+   }
+   return true;
+}
+
+/** Change in pressure (above this point) from scheduling the node. */
+static int
+pressure_delta(struct sched_state *state, struct sched_node *n,
+               struct set *seen)
+{
+   struct pressure_state p = { state, 0, seen };
+   nir_ssa_def *def = instr_def(n->instr);
+
+   if (def && _mesa_set_search(state->live, def))
+      p.delta -= def_size(def);
+
+   _mesa_set_clear(seen, NULL);
+   nir_foreach_src(n->instr, count_new_live_src, &p);
+
+   return p.delta;
+}
+
+static bool
+mark_src_live(nir_src *src, void *data)
+{
+   struct sched_state *state = data;
+
+   if (!_mesa_set_search(state->live, src->ssa)) {
+      _mesa_set_add(state->live, src->ssa);
+      state->pressure += def_size(src->ssa);
+   }
+   return true;
+}
+
+static struct sched_node *
+choose_node(struct sched_state *state, struct set *seen)
+{
+   struct sched_node *best = NULL;
+
+   if (state->pressure >= state->options->threshold) {
+      int best_delta = INT_MAX;
+
+      list_for_each_entry(struct sched_node, n, &state->ready, ready_link) {
+         int delta = pressure_delta(state, n, seen);
+
+         if (delta < best_delta ||
+             (delta == best_delta && n->max_delay > best->max_delay)) {
+            best = n;
+            best_delta = delta;
+         }
+      }
+
+      return best;
+   }
+
+   /* Prefer nodes whose users won't stall on them, then the longest chain
+    * above.
+    */
+   list_for_each_entry(struct sched_node, n, &state->ready, ready_link) {
+      if (!best) {
+         best = n;
+         continue;
+      }
+
+      bool n_ready = n->ready_time <= state->time;
+      bool best_ready = best->ready_time <= state->time;
+
+      if (n_ready != best_ready) {
+         if (n_ready)
+            best = n;
+      } else if (n_ready) {
+         if (n->max_delay > best->max_delay)
+            best = n;
+      } else if (n->ready_time < best->ready_time) {
+         best = n;
+      }
+   }
+
+   return best;
+}
+
+static void
+schedule_node(struct sched_state *state, struct sched_node *n)
+{
+   nir_ssa_def *def = instr_def(n->instr);
+
+   list_del(&n->ready_link);
+
+   state->time = MAX2(state->time, n->ready_time) + 1;
+
+   if (def) {
+      struct set_entry *entry = _mesa_set_search(state->live, def);
+      if (entry) {
+         _mesa_set_remove(state->live, entry);
+         state->pressure -= def_size(def);
+      }
+   }
+   nir_foreach_src(n->instr, mark_src_live, state);
+
+   util_dynarray_foreach(&n->parents, struct sched_node *, parent_p) {
+      struct sched_node *parent = *parent_p;
+
+      parent->ready_time = MAX2(parent->ready_time,
+                                state->time + parent->delay);
+      if (--parent->unscheduled_children == 0)
+         list_addtail(&parent->ready_link, &state->ready);
+   }
+}
+
+static bool
+schedule_block(struct sched_state *state, nir_block *block)
+{
+   void *mem_ctx = ralloc_context(NULL);
+   struct util_dynarray nodes;
+   nir_instr *jump = NULL;
+   bool progress = false;
+
+   util_dynarray_init(&nodes, mem_ctx);
+
+   nir_foreach_instr(instr, block) {
+      if (!nir_foreach_src(instr, src_is_ssa, NULL) ||
+          !nir_foreach_dest(instr, dest_is_ssa, NULL)) {
+         ralloc_free(mem_ctx);
+         return false;
+      }
+   }
+
+   if (nir_block_ends_in_jump(block))
+      jump = nir_block_last_instr(block);
+
+   state->block = block;
+   state->nodes = _mesa_pointer_hash_table_create(mem_ctx);
+   state->live = _mesa_pointer_set_create(mem_ctx);
+   state->pressure = 0;
+   state->time = 0;
+   list_inithead(&state->ready);
+
+   struct sched_node *last_side_effect = NULL;
+
+   nir_foreach_instr(instr, block) {
+      if (instr->type == nir_instr_type_phi || instr == jump)
+         continue;
+
+      struct sched_node *n = rzalloc(mem_ctx, struct sched_node);
+      n->instr = instr;
+      n->delay = instr_delay(state, instr);
+      util_dynarray_init(&n->parents, mem_ctx);
+      _mesa_hash_table_insert(state->nodes, instr, n);
+      util_dynarray_append(&nodes, struct sched_node *, n);
+
+      struct add_src_edge_state s = { state, n };
+      nir_foreach_src(instr, add_src_edge, &s);
+
+      if (has_side_effects(state, instr)) {
+         if (last_side_effect)
+            add_edge(last_side_effect, n);
+         last_side_effect = n;
+      }
+
+      nir_ssa_def *def = instr_def(instr);
+      if (def && def_used_outside_block(def, block)) {
+         _mesa_set_add(state->live, def);
+         state->pressure += def_size(def);
+      }
+   }
+
+   util_dynarray_foreach(&nodes, struct sched_node *, n_p) {
+      struct sched_node *n = *n_p;
+
+      /* Parents come first in program order, so theirs are known. */
+      n->max_delay = n->delay;
+      util_dynarray_foreach(&n->parents, struct sched_node *, parent_p) {
+         n->max_delay = MAX2(n->max_delay, (*parent_p)->max_delay + n->delay);
+      }
+
+      if (n->unscheduled_children == 0)
+         list_addtail(&n->ready_link, &state->ready);
+   }
+
+   /* Schedule bottom-up, collecting the new order back to front. */
+   const unsigned num_nodes =
+      util_dynarray_num_elements(&nodes, struct sched_node *);
+   nir_instr **order = ralloc_array(mem_ctx, nir_instr *, num_nodes);
+   struct set *seen = _mesa_pointer_set_create(mem_ctx);
+   unsigned count = num_nodes;
+
+   while (!list_empty(&state->ready)) {
+      struct sched_node *n = choose_node(state, seen);
+      schedule_node(state, n);
+      order[--count] = n->instr;
+   }
+   assert(count == 0);
+
+   for (unsigned i = 0; i < num_nodes; i++) {
+      struct sched_node *n =
+         *util_dynarray_element(&nodes, struct sched_node *, i);
+      if (order[i] != n->instr)
+         progress = true;
+   }
+
+   if (progress) {
+      for (unsigned i = 0; i < num_nodes; i++)
+         exec_node_remove(&order[i]->node);
+
+      for (unsigned i = 0; i < num_nodes; i++) {
+         if (jump)
+            exec_node_insert_node_before(&jump->node, &order[i]->node);
+         else
+            exec_list_push_tail(&block->instr_list, &order[i]->node);
+      }
+   }
+
+   ralloc_free(mem_ctx);
+   return progress;
+}
+
+static bool
+nir_schedule_impl(nir_function_impl *impl, const nir_schedule_options *options,
+                  gl_shader_stage stage)
+{
+   struct sched_state state = {
+      .options = options,
+      .stage = stage,
+   };
+   bool progress = false;
+
+   nir_foreach_block(block, impl)
+      progress |= schedule_block(&state, block);
+
+   if (progress) {
+      nir_metadata_preserve(impl, nir_metadata_block_index |
+                                  nir_metadata_dominance);
+   }
+
+   return progress;
+}
+
+bool
+nir_schedule(nir_shader *shader, const nir_schedule_options *options)
+{
+   bool progress = false;
+
+   nir_foreach_function(function, shader) {
+      if (function->impl) {
+         progress |= nir_schedule_impl(function->impl, options,
+                                       shader->info.stage);
+      }
+   }
+
+   return progress;
+}
@@ -46,6 +46,12 @@ typedef struct {
     * be resolved in the second pass.
     */
    struct util_dynarray phi_fixups;
+
+   /* maps glsl_type pointer to its index in the type table, plus one */
+   struct hash_table *type_table;
+
+   /* Don't write the names of variables, registers and SSA values. */
+   bool strip;
 } write_ctx;
 
 typedef struct {
@@ -65,8 +71,94 @@ typedef struct {
    /* List of phi sources. */
    struct list_head phi_srcs;
 
+   /* Types read so far, in the order they were written. */
+   struct util_dynarray types;
 } read_ctx;
 
+/* Integers are written as variable-length quantities, 7 bits per byte with
+ * the high bit set on all but the last byte, so that the small values which
+ * make up most of a shader take a single byte.
+ */
+static void
+write_uvarint(write_ctx *ctx, uint32_t val)
+{
+   uint8_t buf[5];
+   unsigned size = 0;
+
+   do {
+      buf[size] = val & 0x7f;
+      val >>= 7;
+      if (val)
+         buf[size] |= 0x80;
+      size++;
+   } while (val);
+
+   blob_write_bytes(ctx->blob, buf, size);
+}
+
+static uint32_t
+read_uvarint(read_ctx *ctx)
+{
+   struct blob_reader *blob = ctx->blob;
+   uint32_t val = 0;
+
+   for (unsigned shift = 0; shift < 35; shift += 7) {
+      if (blob->current >= blob->end)
+         break;
+
+      uint8_t byte = *blob->current++;
+      val |= (uint32_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+         return val;
+   }
+
+   blob->overrun = true;
+   return 0;
+}
+
+/* Each type is only encoded the first time it's used, later uses refer to
+ * it by its index in the type table. 0 is the NULL type.
+ */
+static void
+write_type(write_ctx *ctx, const struct glsl_type *type)
+{
+   if (type == NULL) {
+      write_uvarint(ctx, 0);
+      return;
+   }
+
+   struct hash_entry *entry = _mesa_hash_table_search(ctx->type_table, type);
+   if (entry) {
+      write_uvarint(ctx, (uintptr_t) entry->data);
+      return;
+   }
+
+   uintptr_t index = ctx->type_table->entries + 1;
+   _mesa_hash_table_insert(ctx->type_table, type, (void *) index);
+   write_uvarint(ctx, index);
+   encode_type_to_blob(ctx->blob, type);
+}
+
+static const struct glsl_type *
+read_type(read_ctx *ctx)
+{
+   uint32_t index = read_uvarint(ctx);
+   unsigned num_types =
+      util_dynarray_num_elements(&ctx->types, const struct glsl_type *);
+
+   if (index == 0)
+      return NULL;
+
+   if (index <= num_types)
+      return *util_dynarray_element(&ctx->types, const struct glsl_type *,
+                                    index - 1);
+
+   assert(index == num_types + 1);
+   const struct glsl_type *type = decode_type_from_blob(ctx->blob);
+   util_dynarray_append(&ctx->types, const struct glsl_type *, type);
+   return type;
+}
+
 static void
 write_add_object(write_ctx *ctx, const void *obj)
 {
@@ -85,7 +177,7 @@ write_lookup_object(write_ctx *ctx, const void *obj)
 static void
 write_object(write_ctx *ctx, const void *obj)
 {
-   blob_write_intptr(ctx->blob, write_lookup_object(ctx, obj));
+   write_uvarint(ctx, write_lookup_object(ctx, obj));
 }
 
 static void
@@ -105,14 +197,14 @@ read_lookup_object(read_ctx *ctx, uintptr_t idx)
 static void *
 read_object(read_ctx *ctx)
 {
-   return read_lookup_object(ctx, blob_read_intptr(ctx->blob));
+   return read_lookup_object(ctx, read_uvarint(ctx));
 }
 
 static void
 write_constant(write_ctx *ctx, const nir_constant *c)
 {
    blob_write_bytes(ctx->blob, c->values, sizeof(c->values));
-   blob_write_uint32(ctx->blob, c->num_elements);
+   write_uvarint(ctx, c->num_elements);
    for (unsigned i = 0; i < c->num_elements; i++)
       write_constant(ctx, c->elements[i]);
 }
@@ -123,7 +215,7 @@ read_constant(read_ctx *ctx, nir_variable *nvar)
    nir_constant *c = ralloc(nvar, nir_constant);
 
    blob_copy_bytes(ctx->blob, (uint8_t *)c->values, sizeof(c->values));
-   c->num_elements = blob_read_uint32(ctx->blob);
+   c->num_elements = read_uvarint(ctx);
    c->elements = ralloc_array(nvar, nir_constant *, c->num_elements);
    for (unsigned i = 0; i < c->num_elements; i++)
       c->elements[i] = read_constant(ctx, nvar);
@@ -135,24 +227,25 @@ static void
 write_variable(write_ctx *ctx, const nir_variable *var)
 {
    write_add_object(ctx, var);
-   encode_type_to_blob(ctx->blob, var->type);
-   blob_write_uint32(ctx->blob, !!(var->name));
-   if (var->name)
+   write_type(ctx, var->type);
+   bool has_name = var->name && !ctx->strip;
+   write_uvarint(ctx, has_name);
+   if (has_name)
       blob_write_string(ctx->blob, var->name);
    blob_write_bytes(ctx->blob, (uint8_t *) &var->data, sizeof(var->data));
-   blob_write_uint32(ctx->blob, var->num_state_slots);
+   write_uvarint(ctx, var->num_state_slots);
    for (unsigned i = 0; i < var->num_state_slots; i++) {
       for (unsigned j = 0; j < STATE_LENGTH; j++)
-         blob_write_uint32(ctx->blob, var->state_slots[i].tokens[j]);
-      blob_write_uint32(ctx->blob, var->state_slots[i].swizzle);
+         write_uvarint(ctx, var->state_slots[i].tokens[j]);
+      write_uvarint(ctx, var->state_slots[i].swizzle);
    }
-   blob_write_uint32(ctx->blob, !!(var->constant_initializer));
+   write_uvarint(ctx, !!(var->constant_initializer));
    if (var->constant_initializer)
       write_constant(ctx, var->constant_initializer);
-   blob_write_uint32(ctx->blob, !!(var->interface_type));
+   write_uvarint(ctx, !!(var->interface_type));
    if (var->interface_type)
-      encode_type_to_blob(ctx->blob, var->interface_type);
-   blob_write_uint32(ctx->blob, var->num_members);
+      write_type(ctx, var->interface_type);
+   write_uvarint(ctx, var->num_members);
    if (var->num_members > 0) {
       blob_write_bytes(ctx->blob, (uint8_t *) var->members,
                        var->num_members * sizeof(*var->members));
@@ -165,8 +258,8 @@ read_variable(read_ctx *ctx)
    nir_variable *var = rzalloc(ctx->nir, nir_variable);
    read_add_object(ctx, var);
 
-   var->type = decode_type_from_blob(ctx->blob);
-   bool has_name = blob_read_uint32(ctx->blob);
+   var->type = read_type(ctx);
+   bool has_name = read_uvarint(ctx);
    if (has_name) {
       const char *name = blob_read_string(ctx->blob);
       var->name = ralloc_strdup(var, name);
@@ -174,27 +267,27 @@ read_variable(read_ctx *ctx)
       var->name = NULL;
    }
    blob_copy_bytes(ctx->blob, (uint8_t *) &var->data, sizeof(var->data));
-   var->num_state_slots = blob_read_uint32(ctx->blob);
+   var->num_state_slots = read_uvarint(ctx);
    if (var->num_state_slots != 0) {
       var->state_slots = ralloc_array(var, nir_state_slot,
                                       var->num_state_slots);
       for (unsigned i = 0; i < var->num_state_slots; i++) {
          for (unsigned j = 0; j < STATE_LENGTH; j++)
-            var->state_slots[i].tokens[j] = blob_read_uint32(ctx->blob);
-         var->state_slots[i].swizzle = blob_read_uint32(ctx->blob);
+            var->state_slots[i].tokens[j] = read_uvarint(ctx);
+         var->state_slots[i].swizzle = read_uvarint(ctx);
       }
    }
-   bool has_const_initializer = blob_read_uint32(ctx->blob);
+   bool has_const_initializer = read_uvarint(ctx);
    if (has_const_initializer)
       var->constant_initializer = read_constant(ctx, var);
    else
       var->constant_initializer = NULL;
-   bool has_interface_type = blob_read_uint32(ctx->blob);
+   bool has_interface_type = read_uvarint(ctx);
    if (has_interface_type)
-      var->interface_type = decode_type_from_blob(ctx->blob);
+      var->interface_type = read_type(ctx);
    else
       var->interface_type = NULL;
-   var->num_members = blob_read_uint32(ctx->blob);
+   var->num_members = read_uvarint(ctx);
    if (var->num_members > 0) {
       var->members = ralloc_array(var, struct nir_variable_data,
                                   var->num_members);
@@ -208,7 +301,7 @@ read_variable(read_ctx *ctx)
 static void
 write_var_list(write_ctx *ctx, const struct exec_list *src)
 {
-   blob_write_uint32(ctx->blob, exec_list_length(src));
+   write_uvarint(ctx, exec_list_length(src));
    foreach_list_typed(nir_variable, var, node, src) {
       write_variable(ctx, var);
    }
@@ -218,7 +311,7 @@ static void
 read_var_list(read_ctx *ctx, struct exec_list *dst)
 {
    exec_list_make_empty(dst);
-   unsigned num_vars = blob_read_uint32(ctx->blob);
+   unsigned num_vars = read_uvarint(ctx);
    for (unsigned i = 0; i < num_vars; i++) {
       nir_variable *var = read_variable(ctx);
       exec_list_push_tail(dst, &var->node);
@@ -229,12 +322,13 @@ static void
 write_register(write_ctx *ctx, const nir_register *reg)
 {
    write_add_object(ctx, reg);
-   blob_write_uint32(ctx->blob, reg->num_components);
-   blob_write_uint32(ctx->blob, reg->bit_size);
-   blob_write_uint32(ctx->blob, reg->num_array_elems);
-   blob_write_uint32(ctx->blob, reg->index);
-   blob_write_uint32(ctx->blob, !!(reg->name));
-   if (reg->name)
+   write_uvarint(ctx, reg->num_components);
+   write_uvarint(ctx, reg->bit_size);
+   write_uvarint(ctx, reg->num_array_elems);
+   write_uvarint(ctx, reg->index);
+   bool has_name = reg->name && !ctx->strip;
+   write_uvarint(ctx, has_name);
+   if (has_name)
       blob_write_string(ctx->blob, reg->name);
 }
 
@@ -243,11 +337,11 @@ read_register(read_ctx *ctx)
 {
    nir_register *reg = ralloc(ctx->nir, nir_register);
    read_add_object(ctx, reg);
-   reg->num_components = blob_read_uint32(ctx->blob);
-   reg->bit_size = blob_read_uint32(ctx->blob);
-   reg->num_array_elems = blob_read_uint32(ctx->blob);
-   reg->index = blob_read_uint32(ctx->blob);
-   bool has_name = blob_read_uint32(ctx->blob);
+   reg->num_components = read_uvarint(ctx);
+   reg->bit_size = read_uvarint(ctx);
+   reg->num_array_elems = read_uvarint(ctx);
+   reg->index = read_uvarint(ctx);
+   bool has_name = read_uvarint(ctx);
    if (has_name) {
       const char *name = blob_read_string(ctx->blob);
       reg->name = ralloc_strdup(reg, name);
@@ -265,7 +359,7 @@ read_register(read_ctx *ctx)
 static void
 write_reg_list(write_ctx *ctx, const struct exec_list *src)
 {
-   blob_write_uint32(ctx->blob, exec_list_length(src));
+   write_uvarint(ctx, exec_list_length(src));
    foreach_list_typed(nir_register, reg, node, src)
       write_register(ctx, reg);
 }
@@ -274,7 +368,7 @@ static void
 read_reg_list(read_ctx *ctx, struct exec_list *dst)
 {
    exec_list_make_empty(dst);
-   unsigned num_regs = blob_read_uint32(ctx->blob);
+   unsigned num_regs = read_uvarint(ctx);
    for (unsigned i = 0; i < num_regs; i++) {
       nir_register *reg = read_register(ctx);
       exec_list_push_tail(dst, &reg->node);
@@ -293,13 +387,13 @@ write_src(write_ctx *ctx, const nir_src *src)
    if (src->is_ssa) {
       uintptr_t idx = write_lookup_object(ctx, src->ssa) << 2;
       idx |= 1;
-      blob_write_intptr(ctx->blob, idx);
+      write_uvarint(ctx, idx);
    } else {
       uintptr_t idx = write_lookup_object(ctx, src->reg.reg) << 2;
       if (src->reg.indirect)
          idx |= 2;
-      blob_write_intptr(ctx->blob, idx);
-      blob_write_uint32(ctx->blob, src->reg.base_offset);
+      write_uvarint(ctx, idx);
+      write_uvarint(ctx, src->reg.base_offset);
       if (src->reg.indirect) {
          write_src(ctx, src->reg.indirect);
       }
@@ -309,7 +403,7 @@ write_src(write_ctx *ctx, const nir_src *src)
 static void
 read_src(read_ctx *ctx, nir_src *src, void *mem_ctx)
 {
-   uintptr_t val = blob_read_intptr(ctx->blob);
+   uintptr_t val = read_uvarint(ctx);
    uintptr_t idx = val >> 2;
    src->is_ssa = val & 0x1;
    if (src->is_ssa) {
@@ -317,7 +411,7 @@ read_src(read_ctx *ctx, nir_src *src, void *mem_ctx)
    } else {
       bool is_indirect = val & 0x2;
       src->reg.reg = read_lookup_object(ctx, idx);
-      src->reg.base_offset = blob_read_uint32(ctx->blob);
+      src->reg.base_offset = read_uvarint(ctx);
       if (is_indirect) {
          src->reg.indirect = ralloc(mem_ctx, nir_src);
          read_src(ctx, src->reg.indirect, mem_ctx);
@@ -330,22 +424,23 @@ read_src(read_ctx *ctx, nir_src *src, void *mem_ctx)
 static void
 write_dest(write_ctx *ctx, const nir_dest *dst)
 {
+   bool has_name = dst->is_ssa && dst->ssa.name && !ctx->strip;
    uint32_t val = dst->is_ssa;
    if (dst->is_ssa) {
-      val |= !!(dst->ssa.name) << 1;
+      val |= has_name << 1;
       val |= dst->ssa.num_components << 2;
       val |= dst->ssa.bit_size << 5;
    } else {
       val |= !!(dst->reg.indirect) << 1;
    }
-   blob_write_uint32(ctx->blob, val);
+   write_uvarint(ctx, val);
    if (dst->is_ssa) {
       write_add_object(ctx, &dst->ssa);
-      if (dst->ssa.name)
+      if (has_name)
          blob_write_string(ctx->blob, dst->ssa.name);
    } else {
-      blob_write_intptr(ctx->blob, write_lookup_object(ctx, dst->reg.reg));
-      blob_write_uint32(ctx->blob, dst->reg.base_offset);
+      write_object(ctx, dst->reg.reg);
+      write_uvarint(ctx, dst->reg.base_offset);
       if (dst->reg.indirect)
          write_src(ctx, dst->reg.indirect);
    }
@@ -354,7 +449,7 @@ write_dest(write_ctx *ctx, const nir_dest *dst)
 static void
 read_dest(read_ctx *ctx, nir_dest *dst, nir_instr *instr)
 {
-   uint32_t val = blob_read_uint32(ctx->blob);
+   uint32_t val = read_uvarint(ctx);
    bool is_ssa = val & 0x1;
    if (is_ssa) {
       bool has_name = val & 0x2;
@@ -366,7 +461,7 @@ read_dest(read_ctx *ctx, nir_dest *dst, nir_instr *instr)
    } else {
       bool is_indirect = val & 0x2;
       dst->reg.reg = read_object(ctx);
-      dst->reg.base_offset = blob_read_uint32(ctx->blob);
+      dst->reg.base_offset = read_uvarint(ctx);
       if (is_indirect) {
          dst->reg.indirect = ralloc(instr, nir_src);
          read_src(ctx, dst->reg.indirect, instr);
@@ -377,11 +472,11 @@ read_dest(read_ctx *ctx, nir_dest *dst, nir_instr *instr)
 static void
 write_alu(write_ctx *ctx, const nir_alu_instr *alu)
 {
-   blob_write_uint32(ctx->blob, alu->op);
+   write_uvarint(ctx, alu->op);
    uint32_t flags = alu->exact;
    flags |= alu->dest.saturate << 1;
    flags |= alu->dest.write_mask << 2;
-   blob_write_uint32(ctx->blob, flags);
+   write_uvarint(ctx, flags);
 
    write_dest(ctx, &alu->dest.dest);
 
@@ -391,17 +486,17 @@ write_alu(write_ctx *ctx, const nir_alu_instr *alu)
       flags |= alu->src[i].abs << 1;
       for (unsigned j = 0; j < 4; j++)
          flags |= alu->src[i].swizzle[j] << (2 + 2 * j);
-      blob_write_uint32(ctx->blob, flags);
+      write_uvarint(ctx, flags);
    }
 }
 
 static nir_alu_instr *
 read_alu(read_ctx *ctx)
 {
-   nir_op op = blob_read_uint32(ctx->blob);
+   nir_op op = read_uvarint(ctx);
    nir_alu_instr *alu = nir_alu_instr_create(ctx->nir, op);
 
-   uint32_t flags = blob_read_uint32(ctx->blob);
+   uint32_t flags = read_uvarint(ctx);
    alu->exact = flags & 1;
    alu->dest.saturate = flags & 2;
    alu->dest.write_mask = flags >> 2;
@@ -410,7 +505,7 @@ read_alu(read_ctx *ctx)
 
    for (unsigned i = 0; i < nir_op_infos[op].num_inputs; i++) {
       read_src(ctx, &alu->src[i].src, &alu->instr);
-      flags = blob_read_uint32(ctx->blob);
+      flags = read_uvarint(ctx);
       alu->src[i].negate = flags & 1;
       alu->src[i].abs = flags & 2;
       for (unsigned j = 0; j < 4; j++)
@@ -423,10 +518,10 @@ read_alu(read_ctx *ctx)
 static void
 write_deref(write_ctx *ctx, const nir_deref_instr *deref)
 {
-   blob_write_uint32(ctx->blob, deref->deref_type);
+   write_uvarint(ctx, deref->deref_type);
 
-   blob_write_uint32(ctx->blob, deref->mode);
-   encode_type_to_blob(ctx->blob, deref->type);
+   write_uvarint(ctx, deref->mode);
+   write_type(ctx, deref->type);
 
    write_dest(ctx, &deref->dest);
 
@@ -439,7 +534,7 @@ write_deref(write_ctx *ctx, const nir_deref_instr *deref)
 
    switch (deref->deref_type) {
    case nir_deref_type_struct:
-      blob_write_uint32(ctx->blob, deref->strct.index);
+      write_uvarint(ctx, deref->strct.index);
       break;
 
    case nir_deref_type_array:
@@ -448,7 +543,7 @@ write_deref(write_ctx *ctx, const nir_deref_instr *deref)
       break;
 
    case nir_deref_type_cast:
-      blob_write_uint32(ctx->blob, deref->cast.ptr_stride);
+      write_uvarint(ctx, deref->cast.ptr_stride);
       break;
 
    case nir_deref_type_array_wildcard:
@@ -463,11 +558,11 @@ write_deref(write_ctx *ctx, const nir_deref_instr *deref)
 static nir_deref_instr *
 read_deref(read_ctx *ctx)
 {
-   nir_deref_type deref_type = blob_read_uint32(ctx->blob);
+   nir_deref_type deref_type = read_uvarint(ctx);
    nir_deref_instr *deref = nir_deref_instr_create(ctx->nir, deref_type);
 
-   deref->mode = blob_read_uint32(ctx->blob);
-   deref->type = decode_type_from_blob(ctx->blob);
+   deref->mode = read_uvarint(ctx);
+   deref->type = read_type(ctx);
 
    read_dest(ctx, &deref->dest, &deref->instr);
 
@@ -480,7 +575,7 @@ read_deref(read_ctx *ctx)
 
    switch (deref->deref_type) {
    case nir_deref_type_struct:
-      deref->strct.index = blob_read_uint32(ctx->blob);
+      deref->strct.index = read_uvarint(ctx);
       break;
 
    case nir_deref_type_array:
@@ -489,7 +584,7 @@ read_deref(read_ctx *ctx)
       break;
 
    case nir_deref_type_cast:
-      deref->cast.ptr_stride = blob_read_uint32(ctx->blob);
+      deref->cast.ptr_stride = read_uvarint(ctx);
       break;
 
    case nir_deref_type_array_wildcard:
@@ -506,12 +601,12 @@ read_deref(read_ctx *ctx)
 static void
 write_intrinsic(write_ctx *ctx, const nir_intrinsic_instr *intrin)
 {
-   blob_write_uint32(ctx->blob, intrin->intrinsic);
+   write_uvarint(ctx, intrin->intrinsic);
 
    unsigned num_srcs = nir_intrinsic_infos[intrin->intrinsic].num_srcs;
    unsigned num_indices = nir_intrinsic_infos[intrin->intrinsic].num_indices;
 
-   blob_write_uint32(ctx->blob, intrin->num_components);
+   write_uvarint(ctx, intrin->num_components);
 
    if (nir_intrinsic_infos[intrin->intrinsic].has_dest)
       write_dest(ctx, &intrin->dest);
@@ -520,20 +615,20 @@ write_intrinsic(write_ctx *ctx, const nir_intrinsic_instr *intrin)
       write_src(ctx, &intrin->src[i]);
 
    for (unsigned i = 0; i < num_indices; i++)
-      blob_write_uint32(ctx->blob, intrin->const_index[i]);
+      write_uvarint(ctx, intrin->const_index[i]);
 }
 
 static nir_intrinsic_instr *
 read_intrinsic(read_ctx *ctx)
 {
-   nir_intrinsic_op op = blob_read_uint32(ctx->blob);
+   nir_intrinsic_op op = read_uvarint(ctx);
 
    nir_intrinsic_instr *intrin = nir_intrinsic_instr_create(ctx->nir, op);
 
    unsigned num_srcs = nir_intrinsic_infos[op].num_srcs;
    unsigned num_indices = nir_intrinsic_infos[op].num_indices;
 
-   intrin->num_components = blob_read_uint32(ctx->blob);
+   intrin->num_components = read_uvarint(ctx);
 
    if (nir_intrinsic_infos[op].has_dest)
       read_dest(ctx, &intrin->dest, &intrin->instr);
@@ -542,7 +637,7 @@ read_intrinsic(read_ctx *ctx)
       read_src(ctx, &intrin->src[i], &intrin->instr);
 
    for (unsigned i = 0; i < num_indices; i++)
-      intrin->const_index[i] = blob_read_uint32(ctx->blob);
+      intrin->const_index[i] = read_uvarint(ctx);
 
    return intrin;
 }
@@ -552,7 +647,7 @@ write_load_const(write_ctx *ctx, const nir_load_const_instr *lc)
 {
    uint32_t val = lc->def.num_components;
    val |= lc->def.bit_size << 3;
-   blob_write_uint32(ctx->blob, val);
+   write_uvarint(ctx, val);
    blob_write_bytes(ctx->blob, lc->value, sizeof(*lc->value) * lc->def.num_components);
    write_add_object(ctx, &lc->def);
 }
@@ -560,7 +655,7 @@ write_load_const(write_ctx *ctx, const nir_load_const_instr *lc)
 static nir_load_const_instr *
 read_load_const(read_ctx *ctx)
 {
-   uint32_t val = blob_read_uint32(ctx->blob);
+   uint32_t val = read_uvarint(ctx);
 
    nir_load_const_instr *lc =
       nir_load_const_instr_create(ctx->nir, val & 0x7, val >> 3);
@@ -575,14 +670,14 @@ write_ssa_undef(write_ctx *ctx, const nir_ssa_undef_instr *undef)
 {
    uint32_t val = undef->def.num_components;
    val |= undef->def.bit_size << 3;
-   blob_write_uint32(ctx->blob, val);
+   write_uvarint(ctx, val);
    write_add_object(ctx, &undef->def);
 }
 
 static nir_ssa_undef_instr *
 read_ssa_undef(read_ctx *ctx)
 {
-   uint32_t val = blob_read_uint32(ctx->blob);
+   uint32_t val = read_uvarint(ctx);
 
    nir_ssa_undef_instr *undef =
       nir_ssa_undef_instr_create(ctx->nir, val & 0x7, val >> 3);
@@ -608,11 +703,11 @@ union packed_tex_data {
 static void
 write_tex(write_ctx *ctx, const nir_tex_instr *tex)
 {
-   blob_write_uint32(ctx->blob, tex->num_srcs);
-   blob_write_uint32(ctx->blob, tex->op);
-   blob_write_uint32(ctx->blob, tex->texture_index);
-   blob_write_uint32(ctx->blob, tex->texture_array_size);
-   blob_write_uint32(ctx->blob, tex->sampler_index);
+   write_uvarint(ctx, tex->num_srcs);
+   write_uvarint(ctx, tex->op);
+   write_uvarint(ctx, tex->texture_index);
+   write_uvarint(ctx, tex->texture_array_size);
+   write_uvarint(ctx, tex->sampler_index);
    blob_write_bytes(ctx->blob, tex->tg4_offsets, sizeof(tex->tg4_offsets));
 
    STATIC_ASSERT(sizeof(union packed_tex_data) == sizeof(uint32_t));
@@ -625,11 +720,11 @@ write_tex(write_ctx *ctx, const nir_tex_instr *tex)
       .u.is_new_style_shadow = tex->is_new_style_shadow,
       .u.component = tex->component,
    };
-   blob_write_uint32(ctx->blob, packed.u32);
+   write_uvarint(ctx, packed.u32);
 
    write_dest(ctx, &tex->dest);
    for (unsigned i = 0; i < tex->num_srcs; i++) {
-      blob_write_uint32(ctx->blob, tex->src[i].src_type);
+      write_uvarint(ctx, tex->src[i].src_type);
       write_src(ctx, &tex->src[i].src);
    }
 }
@@ -637,17 +732,17 @@ write_tex(write_ctx *ctx, const nir_tex_instr *tex)
 static nir_tex_instr *
 read_tex(read_ctx *ctx)
 {
-   unsigned num_srcs = blob_read_uint32(ctx->blob);
+   unsigned num_srcs = read_uvarint(ctx);
    nir_tex_instr *tex = nir_tex_instr_create(ctx->nir, num_srcs);
 
-   tex->op = blob_read_uint32(ctx->blob);
-   tex->texture_index = blob_read_uint32(ctx->blob);
-   tex->texture_array_size = blob_read_uint32(ctx->blob);
-   tex->sampler_index = blob_read_uint32(ctx->blob);
+   tex->op = read_uvarint(ctx);
+   tex->texture_index = read_uvarint(ctx);
+   tex->texture_array_size = read_uvarint(ctx);
+   tex->sampler_index = read_uvarint(ctx);
    blob_copy_bytes(ctx->blob, tex->tg4_offsets, sizeof(tex->tg4_offsets));
 
    union packed_tex_data packed;
-   packed.u32 = blob_read_uint32(ctx->blob);
+   packed.u32 = read_uvarint(ctx);
    tex->sampler_dim = packed.u.sampler_dim;
    tex->dest_type = packed.u.dest_type;
    tex->coord_components = packed.u.coord_components;
@@ -658,7 +753,7 @@ read_tex(read_ctx *ctx)
 
    read_dest(ctx, &tex->dest, &tex->instr);
    for (unsigned i = 0; i < tex->num_srcs; i++) {
-      tex->src[i].src_type = blob_read_uint32(ctx->blob);
+      tex->src[i].src_type = read_uvarint(ctx);
       read_src(ctx, &tex->src[i].src, &tex->instr);
    }
 
@@ -669,19 +764,18 @@ static void
 write_phi(write_ctx *ctx, const nir_phi_instr *phi)
 {
    /* Phi nodes are special, since they may reference SSA definitions and
-    * basic blocks that don't exist yet. We leave two empty uintptr_t's here,
+    * basic blocks that don't exist yet. We leave two empty uint32_t's here,
     * and then store enough information so that a later fixup pass can fill
     * them in correctly.
     */
    write_dest(ctx, &phi->dest);
 
-   blob_write_uint32(ctx->blob, exec_list_length(&phi->srcs));
+   write_uvarint(ctx, exec_list_length(&phi->srcs));
 
    nir_foreach_phi_src(src, phi) {
       assert(src->src.is_ssa);
-      size_t blob_offset = blob_reserve_intptr(ctx->blob);
-      MAYBE_UNUSED size_t blob_offset2 = blob_reserve_intptr(ctx->blob);
-      assert(blob_offset + sizeof(uintptr_t) == blob_offset2);
+      size_t blob_offset =
+         blob_reserve_bytes(ctx->blob, 2 * sizeof(uint32_t));
       write_phi_fixup fixup = {
          .blob_offset = blob_offset,
          .src = src->src.ssa,
@@ -695,9 +789,12 @@ static void
 write_fixup_phis(write_ctx *ctx)
 {
    util_dynarray_foreach(&ctx->phi_fixups, write_phi_fixup, fixup) {
-      uintptr_t *blob_ptr = (uintptr_t *)(ctx->blob->data + fixup->blob_offset);
-      blob_ptr[0] = write_lookup_object(ctx, fixup->src);
-      blob_ptr[1] = write_lookup_object(ctx, fixup->block);
+      uint32_t indices[2] = {
+         write_lookup_object(ctx, fixup->src),
+         write_lookup_object(ctx, fixup->block),
+      };
+      blob_overwrite_bytes(ctx->blob, fixup->blob_offset, indices,
+                           sizeof(indices));
    }
 
    util_dynarray_clear(&ctx->phi_fixups);
@@ -710,7 +807,7 @@ read_phi(read_ctx *ctx, nir_block *blk)
 
    read_dest(ctx, &phi->dest, &phi->instr);
 
-   unsigned num_srcs = blob_read_uint32(ctx->blob);
+   unsigned num_srcs = read_uvarint(ctx);
 
    /* For similar reasons as before, we just store the index directly into the
     * pointer, and let a later pass resolve the phi sources.
@@ -725,9 +822,12 @@ read_phi(read_ctx *ctx, nir_block *blk)
    for (unsigned i = 0; i < num_srcs; i++) {
       nir_phi_src *src = ralloc(phi, nir_phi_src);
 
+      uint32_t indices[2];
+      blob_copy_bytes(ctx->blob, indices, sizeof(indices));
+
       src->src.is_ssa = true;
-      src->src.ssa = (nir_ssa_def *) blob_read_intptr(ctx->blob);
-      src->pred = (nir_block *) blob_read_intptr(ctx->blob);
+      src->src.ssa = (nir_ssa_def *)(uintptr_t) indices[0];
+      src->pred = (nir_block *)(uintptr_t) indices[1];
 
       /* Since we're not letting nir_insert_instr handle use/def stuff for us,
        * we have to set the parent_instr manually.  It doesn't really matter
@@ -764,13 +864,13 @@ read_fixup_phis(read_ctx *ctx)
 static void
 write_jump(write_ctx *ctx, const nir_jump_instr *jmp)
 {
-   blob_write_uint32(ctx->blob, jmp->type);
+   write_uvarint(ctx, jmp->type);
 }
 
 static nir_jump_instr *
 read_jump(read_ctx *ctx)
 {
-   nir_jump_type type = blob_read_uint32(ctx->blob);
+   nir_jump_type type = read_uvarint(ctx);
    nir_jump_instr *jmp = nir_jump_instr_create(ctx->nir, type);
    return jmp;
 }
@@ -778,7 +878,7 @@ read_jump(read_ctx *ctx)
 static void
 write_call(write_ctx *ctx, const nir_call_instr *call)
 {
-   blob_write_intptr(ctx->blob, write_lookup_object(ctx, call->callee));
+   write_object(ctx, call->callee);
 
    for (unsigned i = 0; i < call->num_params; i++)
       write_src(ctx, &call->params[i]);
@@ -799,7 +899,7 @@ read_call(read_ctx *ctx)
 static void
 write_instr(write_ctx *ctx, const nir_instr *instr)
 {
-   blob_write_uint32(ctx->blob, instr->type);
+   write_uvarint(ctx, instr->type);
    switch (instr->type) {
    case nir_instr_type_alu:
       write_alu(ctx, nir_instr_as_alu(instr));
@@ -838,7 +938,7 @@ write_instr(write_ctx *ctx, const nir_instr *instr)
 static void
 read_instr(read_ctx *ctx, nir_block *block)
 {
-   nir_instr_type type = blob_read_uint32(ctx->blob);
+   nir_instr_type type = read_uvarint(ctx);
    nir_instr *instr;
    switch (type) {
    case nir_instr_type_alu:
@@ -886,7 +986,7 @@ static void
 write_block(write_ctx *ctx, const nir_block *block)
 {
    write_add_object(ctx, block);
-   blob_write_uint32(ctx->blob, exec_list_length(&block->instr_list));
+   write_uvarint(ctx, exec_list_length(&block->instr_list));
    nir_foreach_instr(instr, block)
       write_instr(ctx, instr);
 }
@@ -902,7 +1002,7 @@ read_block(read_ctx *ctx, struct exec_list *cf_list)
       exec_node_data(nir_block, exec_list_get_tail(cf_list), cf_node.node);
 
    read_add_object(ctx, block);
-   unsigned num_instrs = blob_read_uint32(ctx->blob);
+   unsigned num_instrs = read_uvarint(ctx);
    for (unsigned i = 0; i < num_instrs; i++) {
       read_instr(ctx, block);
    }
@@ -955,7 +1055,7 @@ read_loop(read_ctx *ctx, struct exec_list *cf_list)
 static void
 write_cf_node(write_ctx *ctx, nir_cf_node *cf)
 {
-   blob_write_uint32(ctx->blob, cf->type);
+   write_uvarint(ctx, cf->type);
 
    switch (cf->type) {
    case nir_cf_node_block:
@@ -975,7 +1075,7 @@ write_cf_node(write_ctx *ctx, nir_cf_node *cf)
 static void
 read_cf_node(read_ctx *ctx, struct exec_list *list)
 {
-   nir_cf_node_type type = blob_read_uint32(ctx->blob);
+   nir_cf_node_type type = read_uvarint(ctx);
 
    switch (type) {
    case nir_cf_node_block:
@@ -995,7 +1095,7 @@ read_cf_node(read_ctx *ctx, struct exec_list *list)
 static void
 write_cf_list(write_ctx *ctx, const struct exec_list *cf_list)
 {
-   blob_write_uint32(ctx->blob, exec_list_length(cf_list));
+   write_uvarint(ctx, exec_list_length(cf_list));
    foreach_list_typed(nir_cf_node, cf, node, cf_list) {
       write_cf_node(ctx, cf);
    }
@@ -1004,7 +1104,7 @@ write_cf_list(write_ctx *ctx, const struct exec_list *cf_list)
 static void
 read_cf_list(read_ctx *ctx, struct exec_list *cf_list)
 {
-   uint32_t num_cf_nodes = blob_read_uint32(ctx->blob);
+   uint32_t num_cf_nodes = read_uvarint(ctx);
    for (unsigned i = 0; i < num_cf_nodes; i++)
       read_cf_node(ctx, cf_list);
 }
@@ -1014,7 +1114,7 @@ write_function_impl(write_ctx *ctx, const nir_function_impl *fi)
 {
    write_var_list(ctx, &fi->locals);
    write_reg_list(ctx, &fi->registers);
-   blob_write_uint32(ctx->blob, fi->reg_alloc);
+   write_uvarint(ctx, fi->reg_alloc);
 
    write_cf_list(ctx, &fi->body);
    write_fixup_phis(ctx);
@@ -1028,7 +1128,7 @@ read_function_impl(read_ctx *ctx, nir_function *fxn)
 
    read_var_list(ctx, &fi->locals);
    read_reg_list(ctx, &fi->registers);
-   fi->reg_alloc = blob_read_uint32(ctx->blob);
+   fi->reg_alloc = read_uvarint(ctx);
 
    read_cf_list(ctx, &fi->body);
    read_fixup_phis(ctx);
@@ -1041,21 +1141,21 @@ read_function_impl(read_ctx *ctx, nir_function *fxn)
 static void
 write_function(write_ctx *ctx, const nir_function *fxn)
 {
-   blob_write_uint32(ctx->blob, !!(fxn->name));
+   write_uvarint(ctx, !!(fxn->name));
    if (fxn->name)
       blob_write_string(ctx->blob, fxn->name);
 
    write_add_object(ctx, fxn);
 
-   blob_write_uint32(ctx->blob, fxn->num_params);
+   write_uvarint(ctx, fxn->num_params);
    for (unsigned i = 0; i < fxn->num_params; i++) {
       uint32_t val =
          ((uint32_t)fxn->params[i].num_components) |
          ((uint32_t)fxn->params[i].bit_size) << 8;
-      blob_write_uint32(ctx->blob, val);
+      write_uvarint(ctx, val);
    }
 
-   blob_write_uint32(ctx->blob, fxn->is_entrypoint);
+   write_uvarint(ctx, fxn->is_entrypoint);
 
    /* At first glance, it looks like we should write the function_impl here.
     * However, call instructions need to be able to reference at least the
@@ -1067,26 +1167,26 @@ write_function(write_ctx *ctx, const nir_function *fxn)
 static void
 read_function(read_ctx *ctx)
 {
-   bool has_name = blob_read_uint32(ctx->blob);
+   bool has_name = read_uvarint(ctx);
    char *name = has_name ? blob_read_string(ctx->blob) : NULL;
 
    nir_function *fxn = nir_function_create(ctx->nir, name);
 
    read_add_object(ctx, fxn);
 
-   fxn->num_params = blob_read_uint32(ctx->blob);
+   fxn->num_params = read_uvarint(ctx);
    fxn->params = ralloc_array(fxn, nir_parameter, fxn->num_params);
    for (unsigned i = 0; i < fxn->num_params; i++) {
-      uint32_t val = blob_read_uint32(ctx->blob);
+      uint32_t val = read_uvarint(ctx);
       fxn->params[i].num_components = val & 0xff;
       fxn->params[i].bit_size = (val >> 8) & 0xff;
    }
 
-   fxn->is_entrypoint = blob_read_uint32(ctx->blob);
+   fxn->is_entrypoint = read_uvarint(ctx);
 }
 
 void
-nir_serialize(struct blob *blob, const nir_shader *nir)
+nir_serialize(struct blob *blob, const nir_shader *nir, bool strip)
 {
    write_ctx ctx;
    ctx.remap_table = _mesa_pointer_hash_table_create(NULL);
@@ -1094,16 +1194,21 @@ nir_serialize(struct blob *blob, const nir_shader *nir)
    ctx.blob = blob;
    ctx.nir = nir;
    util_dynarray_init(&ctx.phi_fixups, NULL);
+   ctx.type_table = _mesa_pointer_hash_table_create(NULL);
+   ctx.strip = strip;
 
-   size_t idx_size_offset = blob_reserve_intptr(blob);
+   size_t idx_size_offset = blob_reserve_uint32(blob);
 
    struct shader_info info = nir->info;
+   if (strip)
+      info.name = info.label = NULL;
+
    uint32_t strings = 0;
    if (info.name)
       strings |= 0x1;
    if (info.label)
       strings |= 0x2;
-   blob_write_uint32(blob, strings);
+   write_uvarint(&ctx, strings);
    if (info.name)
       blob_write_string(blob, info.name);
    if (info.label)
@@ -1118,13 +1223,13 @@ nir_serialize(struct blob *blob, const nir_shader *nir)
    write_var_list(&ctx, &nir->globals);
    write_var_list(&ctx, &nir->system_values);
 
-   blob_write_uint32(blob, nir->num_inputs);
-   blob_write_uint32(blob, nir->num_uniforms);
-   blob_write_uint32(blob, nir->num_outputs);
-   blob_write_uint32(blob, nir->num_shared);
-   blob_write_uint32(blob, nir->scratch_size);
+   write_uvarint(&ctx, nir->num_inputs);
+   write_uvarint(&ctx, nir->num_uniforms);
+   write_uvarint(&ctx, nir->num_outputs);
+   write_uvarint(&ctx, nir->num_shared);
+   write_uvarint(&ctx, nir->scratch_size);
 
-   blob_write_uint32(blob, exec_list_length(&nir->functions));
+   write_uvarint(&ctx, exec_list_length(&nir->functions));
    nir_foreach_function(fxn, nir) {
       write_function(&ctx, fxn);
    }
@@ -1133,13 +1238,14 @@ nir_serialize(struct blob *blob, const nir_shader *nir)
       write_function_impl(&ctx, fxn->impl);
    }
 
-   blob_write_uint32(blob, nir->constant_data_size);
+   write_uvarint(&ctx, nir->constant_data_size);
    if (nir->constant_data_size > 0)
       blob_write_bytes(blob, nir->constant_data, nir->constant_data_size);
 
-   *(uintptr_t *)(blob->data + idx_size_offset) = ctx.next_idx;
+   blob_overwrite_uint32(blob, idx_size_offset, ctx.next_idx);
 
    _mesa_hash_table_destroy(ctx.remap_table, NULL);
+   _mesa_hash_table_destroy(ctx.type_table, NULL);
    util_dynarray_fini(&ctx.phi_fixups);
 }
 
@@ -1151,11 +1257,12 @@ nir_deserialize(void *mem_ctx,
    read_ctx ctx;
    ctx.blob = blob;
    list_inithead(&ctx.phi_srcs);
-   ctx.idx_table_len = blob_read_intptr(blob);
+   ctx.idx_table_len = read_uvarint(&ctx);
    ctx.idx_table = calloc(ctx.idx_table_len, sizeof(uintptr_t));
    ctx.next_idx = 0;
+   util_dynarray_init(&ctx.types, NULL);
 
-   uint32_t strings = blob_read_uint32(blob);
+   uint32_t strings = read_uvarint(&ctx);
    char *name = (strings & 0x1) ? blob_read_string(blob) : NULL;
    char *label = (strings & 0x2) ? blob_read_string(blob) : NULL;
 
@@ -1176,20 +1283,20 @@ nir_deserialize(void *mem_ctx,
    read_var_list(&ctx, &ctx.nir->globals);
    read_var_list(&ctx, &ctx.nir->system_values);
 
-   ctx.nir->num_inputs = blob_read_uint32(blob);
-   ctx.nir->num_uniforms = blob_read_uint32(blob);
-   ctx.nir->num_outputs = blob_read_uint32(blob);
-   ctx.nir->num_shared = blob_read_uint32(blob);
-   ctx.nir->scratch_size = blob_read_uint32(blob);
+   ctx.nir->num_inputs = read_uvarint(&ctx);
+   ctx.nir->num_uniforms = read_uvarint(&ctx);
+   ctx.nir->num_outputs = read_uvarint(&ctx);
+   ctx.nir->num_shared = read_uvarint(&ctx);
+   ctx.nir->scratch_size = read_uvarint(&ctx);
 
-   unsigned num_functions = blob_read_uint32(blob);
+   unsigned num_functions = read_uvarint(&ctx);
    for (unsigned i = 0; i < num_functions; i++)
       read_function(&ctx);
 
    nir_foreach_function(fxn, ctx.nir)
       fxn->impl = read_function_impl(&ctx, fxn);
 
-   ctx.nir->constant_data_size = blob_read_uint32(blob);
+   ctx.nir->constant_data_size = read_uvarint(&ctx);
    if (ctx.nir->constant_data_size > 0) {
       ctx.nir->constant_data =
          ralloc_size(ctx.nir, ctx.nir->constant_data_size);
@@ -1198,6 +1305,7 @@ nir_deserialize(void *mem_ctx,
    }
 
    free(ctx.idx_table);
+   util_dynarray_fini(&ctx.types);
 
    return ctx.nir;
 }
@@ -1209,7 +1317,7 @@ nir_shader_serialize_deserialize(void *mem_ctx, nir_shader *s)
 
    struct blob writer;
    blob_init(&writer);
-   nir_serialize(&writer, s);
+   nir_serialize(&writer, s, false);
    ralloc_free(s);
 
    struct blob_reader reader;
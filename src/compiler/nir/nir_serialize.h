@@ -31,7 +31,10 @@
 extern "C" {
 #endif
 
-void nir_serialize(struct blob *blob, const nir_shader *nir);
+/* If strip is set, the names of the shader, its variables, registers and SSA
+ * values are left out, which makes the blob smaller for caching.
+ */
+void nir_serialize(struct blob *blob, const nir_shader *nir, bool strip);
 nir_shader *nir_deserialize(void *mem_ctx,
                             const struct nir_shader_compiler_options *options,
                             struct blob_reader *blob);
@@ -33,6 +33,9 @@
  * The expectation is that drivers should call this when finished compiling the shader
  * (after any optimization, lowering, and so on).  However, it's also fine to call it
  * earlier, and even many times, trading CPU cycles for memory savings.
+ *
+ * The shader's memory comes from a pool (see nir_shader_create), so the memory
+ * freed here is reused by later allocations in the shader.
  */
 
 #define steal_list(mem_ctx, type, list) \
@@ -63,15 +66,6 @@ sweep_block(nir_shader *nir, nir_block *block)
 {
    ralloc_steal(nir, block);
 
-   /* sweep_impl will mark all metadata invalid.  We can safely release all of
-    * this here.
-    */
-   ralloc_free(block->live_in);
-   block->live_in = NULL;
-
-   ralloc_free(block->live_out);
-   block->live_out = NULL;
-
    nir_foreach_instr(instr, block) {
       ralloc_steal(nir, instr);
 
@@ -122,8 +116,14 @@ sweep_cf_node(nir_shader *nir, nir_cf_node *cf_node)
    }
 }
 
-static void
-sweep_impl(nir_shader *nir, nir_function_impl *impl)
+/**
+ * Moves all the memory of \p impl into \p nir, keeping its metadata.
+ *
+ * This is used to give an impl a memory context of its own, see
+ * nir_shader_impls_parallel.
+ */
+void
+nir_steal_impl(nir_shader *nir, nir_function_impl *impl)
 {
    ralloc_steal(nir, impl);
 
@@ -135,6 +135,29 @@ sweep_impl(nir_shader *nir, nir_function_impl *impl)
    }
 
    sweep_block(nir, impl->end_block);
+}
+
+static void
+free_live_sets(nir_block *block)
+{
+   ralloc_free(block->live_in);
+   block->live_in = NULL;
+
+   ralloc_free(block->live_out);
+   block->live_out = NULL;
+}
+
+static void
+sweep_impl(nir_shader *nir, nir_function_impl *impl)
+{
+   nir_steal_impl(nir, impl);
+
+   /* We're about to mark all metadata invalid.  We can safely release all of
+    * this here.
+    */
+   nir_foreach_block(block, impl)
+      free_live_sets(block);
+   free_live_sets(impl->end_block);
 
    /* Wipe out all the metadata, if any. */
    nir_metadata_preserve(impl, nir_metadata_none);
@@ -0,0 +1,413 @@
+/*
+ * Copyright © 2019 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include <gtest/gtest.h>
+#include <map>
+#include <utility>
+#include "nir.h"
+#include "nir_builder.h"
+extern "C" {
+#include "nir_constant_expressions.h"
+}
+
+namespace {
+
+class nir_loop_unroll_test : public ::testing::Test {
+protected:
+   nir_loop_unroll_test();
+   ~nir_loop_unroll_test();
+
+   nir_shader_compiler_options options;
+   nir_builder b;
+   nir_variable *n;
+   nir_variable *out;
+};
+
+nir_loop_unroll_test::nir_loop_unroll_test()
+{
+   glsl_type_singleton_init_or_ref();
+
+   memset(&options, 0, sizeof(options));
+   options.max_unroll_iterations = 32;
+   options.loop_partial_unroll_factor = 2;
+
+   nir_builder_init_simple_shader(&b, NULL, MESA_SHADER_COMPUTE, &options);
+
+   n = nir_variable_create(b.shader, nir_var_uniform, glsl_uint_type(), "n");
+   out = nir_variable_create(b.shader, nir_var_shader_out, glsl_uint_type(),
+                             "out");
+}
+
+nir_loop_unroll_test::~nir_loop_unroll_test()
+{
+   ralloc_free(b.shader);
+   glsl_type_singleton_decref();
+}
+
+/* Just enough of an evaluator to run the scalar integer shaders below:
+ * ALU instructions go through nir_eval_const_opcode, "n" is the only
+ * uniform and local arrays live in a map.
+ */
+class evaluator {
+public:
+   evaluator(nir_variable *n, uint32_t n_value) :
+      n(n), n_value(n_value), out(0), prev(NULL), steps(0) { }
+
+   uint32_t run(nir_function_impl *impl)
+   {
+      prev = NULL;
+      run_cf_list(&impl->body);
+      return out;
+   }
+
+private:
+   enum result { NEXT, BREAK, CONTINUE };
+
+   nir_const_value get(nir_src *src)
+   {
+      return ssa[src->ssa->index];
+   }
+
+   std::pair<nir_variable *, uint64_t> address(nir_deref_instr *deref)
+   {
+      if (deref->deref_type == nir_deref_type_var)
+         return std::make_pair(deref->var, 0);
+
+      assert(deref->deref_type == nir_deref_type_array);
+      std::pair<nir_variable *, uint64_t> addr =
+         address(nir_deref_instr_parent(deref));
+      addr.second = get(&deref->arr.index).u32;
+      return addr;
+   }
+
+   result run_block(nir_block *block)
+   {
+      EXPECT_LT(++steps, 10000u) << "the loop doesn't terminate";
+      if (steps >= 10000)
+         return BREAK;
+
+      /* All phis read their sources before any of them is written. */
+      std::map<unsigned, nir_const_value> phis;
+      nir_foreach_instr(instr, block) {
+         if (instr->type != nir_instr_type_phi)
+            break;
+
+         nir_phi_instr *phi = nir_instr_as_phi(instr);
+         nir_foreach_phi_src(src, phi) {
+            if (src->pred == prev)
+               phis[phi->dest.ssa.index] = get(&src->src);
+         }
+      }
+      for (auto &phi : phis)
+         ssa[phi.first] = phi.second;
+
+      prev = block;
+
+      nir_foreach_instr(instr, block) {
+         switch (instr->type) {
+         case nir_instr_type_load_const: {
+            nir_load_const_instr *load = nir_instr_as_load_const(instr);
+            ssa[load->def.index] = load->value[0];
+            break;
+         }
+
+         case nir_instr_type_alu: {
+            nir_alu_instr *alu = nir_instr_as_alu(instr);
+            const nir_op_info *info = &nir_op_infos[alu->op];
+            nir_const_value src[NIR_MAX_VEC_COMPONENTS];
+            nir_const_value *srcs[NIR_MAX_VEC_COMPONENTS];
+            unsigned bit_size = 0;
+
+            if (!nir_alu_type_get_type_size(info->output_type))
+               bit_size = alu->dest.dest.ssa.bit_size;
+
+            for (unsigned i = 0; i < info->num_inputs; i++) {
+               if (bit_size == 0 &&
+                   !nir_alu_type_get_type_size(info->input_types[i]))
+                  bit_size = alu->src[i].src.ssa->bit_size;
+
+               src[i] = get(&alu->src[i].src);
+               srcs[i] = &src[i];
+            }
+
+            nir_const_value dest;
+            memset(&dest, 0, sizeof(dest));
+            nir_eval_const_opcode(alu->op, &dest, 1,
+                                  bit_size ? bit_size : 32, srcs);
+            ssa[alu->dest.dest.ssa.index] = dest;
+            break;
+         }
+
+         case nir_instr_type_intrinsic: {
+            nir_intrinsic_instr *intrin = nir_instr_as_intrinsic(instr);
+            nir_deref_instr *deref = nir_src_as_deref(intrin->src[0]);
+            std::pair<nir_variable *, uint64_t> addr = address(deref);
+
+            if (intrin->intrinsic == nir_intrinsic_load_deref) {
+               nir_const_value value;
+               if (addr.first == n)
+                  value.u32 = n_value;
+               else
+                  value = memory[addr];
+               ssa[intrin->dest.ssa.index] = value;
+            } else {
+               assert(intrin->intrinsic == nir_intrinsic_store_deref);
+               memory[addr] = get(&intrin->src[1]);
+               if (addr.first->data.mode == nir_var_shader_out)
+                  out = memory[addr].u32;
+            }
+            break;
+         }
+
+         case nir_instr_type_jump:
+            if (nir_instr_as_jump(instr)->type == nir_jump_break)
+               return BREAK;
+            return CONTINUE;
+
+         case nir_instr_type_ssa_undef: {
+            nir_ssa_undef_instr *undef = nir_instr_as_ssa_undef(instr);
+            memset(&ssa[undef->def.index], 0, sizeof(nir_const_value));
+            break;
+         }
+
+         case nir_instr_type_deref:
+         case nir_instr_type_phi:
+            break;
+
+         default:
+            ADD_FAILURE() << "unexpected instruction";
+            return BREAK;
+         }
+      }
+
+      return NEXT;
+   }
+
+   result run_cf_list(struct exec_list *list)
+   {
+      foreach_list_typed(nir_cf_node, node, node, list) {
+         result res = NEXT;
+
+         switch (node->type) {
+         case nir_cf_node_block:
+            res = run_block(nir_cf_node_as_block(node));
+            break;
+
+         case nir_cf_node_if: {
+            nir_if *nif = nir_cf_node_as_if(node);
+            res = run_cf_list(get(&nif->condition).b ? &nif->then_list
+                                                      : &nif->else_list);
+            break;
+         }
+
+         case nir_cf_node_loop: {
+            nir_loop *loop = nir_cf_node_as_loop(node);
+            while (run_cf_list(&loop->body) != BREAK && steps < 10000)
+               ;
+            break;
+         }
+
+         default:
+            unreachable("unknown cf node type");
+         }
+
+         if (res != NEXT)
+            return res;
+      }
+
+      return NEXT;
+   }
+
+   nir_variable *n;
+   uint32_t n_value;
+   uint32_t out;
+
+   nir_block *prev;
+   unsigned steps;
+   std::map<unsigned, nir_const_value> ssa;
+   std::map<std::pair<nir_variable *, uint64_t>, nir_const_value> memory;
+};
+
+static unsigned
+count_breaks(nir_loop *loop)
+{
+   unsigned count = 0;
+
+   nir_foreach_block_in_cf_node(block, &loop->cf_node) {
+      nir_foreach_instr(instr, block) {
+         if (instr->type == nir_instr_type_jump &&
+             nir_instr_as_jump(instr)->type == nir_jump_break)
+            count++;
+      }
+   }
+
+   return count;
+}
+
+static nir_loop *
+first_loop(nir_function_impl *impl)
+{
+   foreach_list_typed(nir_cf_node, node, node, &impl->body) {
+      if (node->type == nir_cf_node_loop)
+         return nir_cf_node_as_loop(node);
+   }
+
+   return NULL;
+}
+
+} /* namespace */
+
+TEST_F(nir_loop_unroll_test, partial_unroll_in_place)
+{
+   /* uint sum = 0;
+    * for (uint i = 0; i < n; i++)
+    *    sum += i + 1;
+    * out = sum;
+    */
+   nir_variable *i = nir_local_variable_create(b.impl, glsl_uint_type(), "i");
+   nir_variable *sum =
+      nir_local_variable_create(b.impl, glsl_uint_type(), "sum");
+
+   nir_store_var(&b, i, nir_imm_int(&b, 0), 1);
+   nir_store_var(&b, sum, nir_imm_int(&b, 0), 1);
+
+   nir_loop *loop = nir_push_loop(&b);
+   {
+      nir_ssa_def *iv = nir_load_var(&b, i);
+
+      nir_if *nif = nir_push_if(&b, nir_uge(&b, iv, nir_load_var(&b, n)));
+      nir_jump(&b, nir_jump_break);
+      nir_pop_if(&b, nif);
+
+      nir_ssa_def *next = nir_iadd(&b, iv, nir_imm_int(&b, 1));
+      nir_store_var(&b, sum, nir_iadd(&b, nir_load_var(&b, sum), next), 1);
+      nir_store_var(&b, i, next, 1);
+   }
+   nir_pop_loop(&b, loop);
+
+   nir_store_var(&b, out, nir_load_var(&b, sum), 1);
+
+   nir_lower_vars_to_ssa(b.shader);
+   nir_copy_prop(b.shader);
+   nir_opt_dce(b.shader);
+   nir_validate_shader(b.shader, NULL);
+
+   ASSERT_EQ(1u, count_breaks(loop));
+
+   ASSERT_TRUE(nir_opt_loop_unroll(b.shader, nir_var_function_temp));
+   nir_validate_shader(b.shader, NULL);
+
+   /* The loop is kept, with the body and its exit test repeated. */
+   ASSERT_EQ(loop, first_loop(b.impl));
+   EXPECT_TRUE(loop->partially_unrolled);
+   EXPECT_EQ(2u, count_breaks(loop));
+
+   /* Odd trip counts leave the loop from the first copy of the body. */
+   for (uint32_t n_value = 0; n_value <= 7; n_value++) {
+      evaluator eval(n, n_value);
+      EXPECT_EQ(n_value * (n_value + 1) / 2, eval.run(b.impl))
+         << "n = " << n_value;
+   }
+
+   /* Running the pass again doesn't unroll the loop any further. */
+   EXPECT_FALSE(nir_opt_loop_unroll(b.shader, nir_var_function_temp));
+   EXPECT_EQ(2u, count_breaks(loop));
+}
+
+TEST_F(nir_loop_unroll_test, partial_unroll_leaves_remainder_loop)
+{
+   /* uint arr[3] = { 5, 6, 7 };
+    * uint sum = 0;
+    * for (uint i = 0; i < n; i++)
+    *    sum += arr[i];
+    * out = sum;
+    *
+    * The array access makes loop analysis guess a trip count of 3, so
+    * the loop is unrolled three times with the loop cloned after the
+    * copies.  The clone is marked as partially unrolled, and mustn't be
+    * unrolled in place on top of that.
+    */
+   nir_variable *arr =
+      nir_local_variable_create(b.impl, glsl_array_type(glsl_uint_type(), 3, 0),
+                                "arr");
+   nir_variable *i = nir_local_variable_create(b.impl, glsl_uint_type(), "i");
+   nir_variable *sum =
+      nir_local_variable_create(b.impl, glsl_uint_type(), "sum");
+
+   nir_deref_instr *arr_deref = nir_build_deref_var(&b, arr);
+   for (unsigned j = 0; j < 3; j++) {
+      nir_store_deref(&b, nir_build_deref_array_imm(&b, arr_deref, j),
+                      nir_imm_int(&b, 5 + j), 1);
+   }
+   nir_store_var(&b, i, nir_imm_int(&b, 0), 1);
+   nir_store_var(&b, sum, nir_imm_int(&b, 0), 1);
+
+   nir_loop *loop = nir_push_loop(&b);
+   {
+      nir_ssa_def *iv = nir_load_var(&b, i);
+
+      nir_if *nif = nir_push_if(&b, nir_uge(&b, iv, nir_load_var(&b, n)));
+      nir_jump(&b, nir_jump_break);
+      nir_pop_if(&b, nif);
+
+      nir_ssa_def *elem =
+         nir_load_deref(&b, nir_build_deref_array(&b, nir_build_deref_var(&b, arr), iv));
+      nir_store_var(&b, sum, nir_iadd(&b, nir_load_var(&b, sum), elem), 1);
+      nir_store_var(&b, i, nir_iadd(&b, iv, nir_imm_int(&b, 1)), 1);
+   }
+   nir_pop_loop(&b, loop);
+
+   nir_store_var(&b, out, nir_load_var(&b, sum), 1);
+
+   nir_lower_vars_to_ssa(b.shader);
+   nir_copy_prop(b.shader);
+   nir_opt_dce(b.shader);
+   nir_validate_shader(b.shader, NULL);
+
+   ASSERT_TRUE(nir_opt_loop_unroll(b.shader, nir_var_function_temp));
+   nir_validate_shader(b.shader, NULL);
+
+   nir_loop *remainder = NULL;
+   nir_foreach_block(block, b.impl) {
+      nir_cf_node *parent = block->cf_node.parent;
+      if (parent->type == nir_cf_node_loop) {
+         EXPECT_TRUE(remainder == NULL ||
+                     remainder == nir_cf_node_as_loop(parent));
+         remainder = nir_cf_node_as_loop(parent);
+      }
+   }
+   ASSERT_NE(nullptr, remainder);
+   EXPECT_TRUE(remainder->partially_unrolled);
+   EXPECT_EQ(1u, count_breaks(remainder));
+
+   for (uint32_t n_value = 0; n_value <= 3; n_value++) {
+      evaluator eval(n, n_value);
+      EXPECT_EQ(n_value * (n_value + 9) / 2, eval.run(b.impl))
+         << "n = " << n_value;
+   }
+
+   /* Neither the in-place nor the guessed trip count unrolling touch the
+    * remainder loop again.
+    */
+   EXPECT_FALSE(nir_opt_loop_unroll(b.shader, nir_var_function_temp));
+   EXPECT_EQ(1u, count_breaks(remainder));
+}
@@ -33,7 +33,7 @@ vtn_load_param_pointer(struct vtn_builder *b,
    if (param_type->base_type != vtn_base_type_pointer) {
       assert(param_type->base_type == vtn_base_type_image ||
              param_type->base_type == vtn_base_type_sampler);
-      ptr_type = rzalloc(b, struct vtn_type);
+      ptr_type = vtn_zalloc(b, struct vtn_type);
       ptr_type->base_type = vtn_base_type_pointer;
       ptr_type->deref = param_type;
       ptr_type->storage_class = SpvStorageClassUniformConstant;
@@ -240,6 +240,12 @@ static bool
 vtn_cfg_handle_prepass_instruction(struct vtn_builder *b, SpvOp opcode,
                                    const uint32_t *w, unsigned count)
 {
+   /* This is the first walk over the function bodies, so it's also where
+    * every result gets its type.  Every type is known by now since all of
+    * them are declared ahead of the first OpFunction.
+    */
+   vtn_set_instruction_result_type(b, opcode, w, count);
+
    switch (opcode) {
    case SpvOpFunction: {
       vtn_assert(b->func == NULL);
@@ -317,7 +323,7 @@ vtn_cfg_handle_prepass_instruction(struct vtn_builder *b, SpvOp opcode,
          val->sampled_image = ralloc(b, struct vtn_sampled_image);
          val->sampled_image->type = type;
 
-         struct vtn_type *sampler_type = rzalloc(b, struct vtn_type);
+         struct vtn_type *sampler_type = vtn_zalloc(b, struct vtn_type);
          sampler_type->base_type = vtn_base_type_sampler;
          sampler_type->type = glsl_bare_sampler_type();
 
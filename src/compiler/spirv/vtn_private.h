@@ -607,6 +607,9 @@ struct vtn_builder {
    unsigned value_id_bound;
    struct vtn_value *values;
 
+   /* Linear arena for the small, never individually freed vtn_* objects */
+   void *lin_ctx;
+
    /* True if we should watch out for GLSLang issue #179 */
    bool wa_glslang_179;
 
@@ -631,6 +634,11 @@ struct vtn_builder {
    bool physical_ptrs;
 };
 
+#define vtn_alloc(b, type) \
+   ((type *) linear_alloc_child((b)->lin_ctx, sizeof(type)))
+#define vtn_zalloc(b, type) \
+   ((type *) linear_zalloc_child((b)->lin_ctx, sizeof(type)))
+
 nir_ssa_def *
 vtn_pointer_to_ssa(struct vtn_builder *b, struct vtn_pointer *ptr);
 struct vtn_pointer *
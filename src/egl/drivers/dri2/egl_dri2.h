@@ -174,6 +174,7 @@ struct dri2_egl_display
    const __DRIimageDriverExtension *image_driver;
    const __DRIdri2Extension       *dri2;
    const __DRIswrastExtension     *swrast;
+   const __DRIswrastSwapDamageExtension *swrast_swap_damage;
    const __DRI2flushExtension     *flush;
    const __DRI2flushControlExtension *flush_control;
    const __DRItexBufferExtension  *tex_buffer;
@@ -274,6 +275,8 @@ struct dri2_egl_surface
    int                  bytes_per_pixel;
    xcb_gcontext_t       gc;
    xcb_gcontext_t       swapgc;
+   /* for swrast, whose back buffer survives swaps */
+   int                  swrast_age;
 #endif
 
 #ifdef HAVE_WAYLAND_PLATFORM
@@ -142,17 +142,28 @@ swrastGetDrawableInfo(__DRIdrawable * draw,
                       int *x, int *y, int *w, int *h,
                       void *loaderPrivate)
 {
+   struct dri2_egl_surface *dri2_surf = loaderPrivate;
+
    *x = *y = *w = *h = 0;
    x11_get_drawable_info(draw, x, y, w, h, loaderPrivate);
+
+   /* The driver reallocates the back buffer when the size changes */
+   if (*w != dri2_surf->base.Width || *h != dri2_surf->base.Height) {
+      dri2_surf->base.Width = *w;
+      dri2_surf->base.Height = *h;
+      dri2_surf->swrast_age = 0;
+   }
 }
 
 static void
-swrastPutImage(__DRIdrawable * draw, int op,
-               int x, int y, int w, int h,
-               char *data, void *loaderPrivate)
+swrastPutImage2(__DRIdrawable * draw, int op,
+                int x, int y, int w, int h, int stride,
+                char *data, void *loaderPrivate)
 {
    struct dri2_egl_surface *dri2_surf = loaderPrivate;
    struct dri2_egl_display *dri2_dpy = dri2_egl_display(dri2_surf->base.Resource.Display);
+   int row_size = w * dri2_surf->bytes_per_pixel;
+   char *packed = NULL;
 
    xcb_gcontext_t gc;
 
@@ -167,9 +178,35 @@ swrastPutImage(__DRIdrawable * draw, int op,
       return;
    }
 
+   /* Sub-rectangles of the back buffer have to be packed, so that only the
+    * damaged pixels go over the wire.
+    */
+   if (stride != row_size) {
+      packed = malloc(row_size * h);
+      if (!packed)
+         return;
+
+      for (int i = 0; i < h; i++)
+         memcpy(packed + i * row_size, data + i * stride, row_size);
+      data = packed;
+   }
+
    xcb_put_image(dri2_dpy->conn, XCB_IMAGE_FORMAT_Z_PIXMAP, dri2_surf->drawable,
                  gc, w, h, x, y, 0, dri2_surf->depth,
-                 w*h*dri2_surf->bytes_per_pixel, (const uint8_t *)data);
+                 row_size * h, (const uint8_t *)data);
+
+   free(packed);
+}
+
+static void
+swrastPutImage(__DRIdrawable * draw, int op,
+               int x, int y, int w, int h,
+               char *data, void *loaderPrivate)
+{
+   struct dri2_egl_surface *dri2_surf = loaderPrivate;
+
+   swrastPutImage2(draw, op, x, y, w, h, w * dri2_surf->bytes_per_pixel,
+                   data, loaderPrivate);
 }
 
 static void
@@ -450,6 +487,8 @@ dri2_query_surface(_EGLDriver *drv, _EGLDisplay *disp,
    case EGL_WIDTH:
    case EGL_HEIGHT:
       if (x11_get_drawable_info(drawable, &x, &y, &w, &h, dri2_surf)) {
+         if (w != surf->Width || h != surf->Height)
+            dri2_surf->swrast_age = 0;
          surf->Width = w;
          surf->Height = h;
       }
@@ -1208,6 +1247,61 @@ dri2_x11_get_sync_values(_EGLDisplay *display, _EGLSurface *surface,
    return EGL_TRUE;
 }
 
+static EGLBoolean
+dri2_x11_swrast_swap_buffers_with_damage(_EGLDriver *drv, _EGLDisplay *disp,
+                                         _EGLSurface *draw,
+                                         const EGLint *rects, EGLint n_rects)
+{
+   struct dri2_egl_display *dri2_dpy = dri2_egl_display(disp);
+   struct dri2_egl_surface *dri2_surf = dri2_egl_surface(draw);
+
+   dri2_dpy->swrast_swap_damage->swapBuffersWithDamage(dri2_surf->dri_drawable,
+                                                       n_rects, rects);
+   if (draw->Type == EGL_WINDOW_BIT)
+      dri2_surf->swrast_age = 1;
+
+   return EGL_TRUE;
+}
+
+static EGLBoolean
+dri2_x11_swrast_swap_buffers(_EGLDriver *drv, _EGLDisplay *disp,
+                             _EGLSurface *draw)
+{
+   return dri2_x11_swrast_swap_buffers_with_damage(drv, disp, draw, NULL, 0);
+}
+
+static EGLint
+dri2_x11_swrast_query_buffer_age(_EGLDriver *drv, _EGLDisplay *disp,
+                                 _EGLSurface *surf)
+{
+   struct dri2_egl_surface *dri2_surf = dri2_egl_surface(surf);
+
+   return dri2_surf->swrast_age;
+}
+
+/* The back buffer of the software rasterizer is kept across swaps, so with
+ * damage rectangles only the changed parts of the window have to be put.
+ */
+static const struct dri2_egl_display_vtbl dri2_x11_swrast_damage_display_vtbl = {
+   .authenticate = NULL,
+   .create_window_surface = dri2_x11_create_window_surface,
+   .create_pixmap_surface = dri2_x11_create_pixmap_surface,
+   .create_pbuffer_surface = dri2_x11_create_pbuffer_surface,
+   .destroy_surface = dri2_x11_destroy_surface,
+   .create_image = dri2_create_image_khr,
+   .swap_buffers = dri2_x11_swrast_swap_buffers,
+   .swap_buffers_with_damage = dri2_x11_swrast_swap_buffers_with_damage,
+   .set_damage_region = dri2_fallback_set_damage_region,
+   .swap_buffers_region = dri2_fallback_swap_buffers_region,
+   .post_sub_buffer = dri2_fallback_post_sub_buffer,
+   .copy_buffers = dri2_fallback_copy_buffers,
+   .query_buffer_age = dri2_x11_swrast_query_buffer_age,
+   .query_surface = dri2_query_surface,
+   .create_wayland_buffer_from_image = dri2_fallback_create_wayland_buffer_from_image,
+   .get_sync_values = dri2_fallback_get_sync_values,
+   .get_dri_drawable = dri2_surface_get_dri_drawable,
+};
+
 static const struct dri2_egl_display_vtbl dri2_x11_swrast_display_vtbl = {
    .authenticate = NULL,
    .create_window_surface = dri2_x11_create_window_surface,
@@ -1250,11 +1344,12 @@ static const struct dri2_egl_display_vtbl dri2_x11_display_vtbl = {
 };
 
 static const __DRIswrastLoaderExtension swrast_loader_extension = {
-   .base = { __DRI_SWRAST_LOADER, 1 },
+   .base = { __DRI_SWRAST_LOADER, 2 },
 
    .getDrawableInfo = swrastGetDrawableInfo,
    .putImage        = swrastPutImage,
    .getImage        = swrastGetImage,
+   .putImage2       = swrastPutImage2,
 };
 
 static const __DRIextension *swrast_loader_extensions[] = {
@@ -1348,7 +1443,13 @@ dri2_initialize_x11_swrast(_EGLDriver *drv, _EGLDisplay *disp)
    /* Fill vtbl last to prevent accidentally calling virtual function during
     * initialization.
     */
-   dri2_dpy->vtbl = &dri2_x11_swrast_display_vtbl;
+   if (dri2_dpy->swrast_swap_damage) {
+      disp->Extensions.EXT_buffer_age = EGL_TRUE;
+      disp->Extensions.EXT_swap_buffers_with_damage = EGL_TRUE;
+      dri2_dpy->vtbl = &dri2_x11_swrast_damage_display_vtbl;
+   } else {
+      dri2_dpy->vtbl = &dri2_x11_swrast_display_vtbl;
+   }
 
    return EGL_TRUE;
 
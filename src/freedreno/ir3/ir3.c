@@ -42,7 +42,7 @@
  */
 void * ir3_alloc(struct ir3 *shader, int sz)
 {
-	return rzalloc_size(shader, sz); /* TODO: don't use rzalloc */
+	return linear_zalloc_child(shader->lin_ctx, sz);
 }
 
 struct ir3 * ir3_create(struct ir3_compiler *compiler,
@@ -52,6 +52,7 @@ struct ir3 * ir3_create(struct ir3_compiler *compiler,
 
 	shader->compiler = compiler;
 	shader->type = type;
+	shader->lin_ctx = linear_alloc_parent(shader, 0);
 	shader->ninputs = nin;
 	shader->inputs = ir3_alloc(shader, sizeof(shader->inputs[0]) * nin);
 
@@ -1012,7 +1013,7 @@ struct ir3_instruction * ir3_instr_clone(struct ir3_instruction *instr)
 /* Add a false dependency to instruction, to ensure it is scheduled first: */
 void ir3_instr_add_dep(struct ir3_instruction *instr, struct ir3_instruction *dep)
 {
-	array_insert(instr, instr->deps, dep);
+	array_insert(instr->block->shader, instr->deps, dep);
 }
 
 struct ir3_register * ir3_reg_create(struct ir3_instruction *instr,
@@ -450,6 +450,13 @@ struct ir3 {
 
 	unsigned max_sun;   /* max Sethi–Ullman number */
 
+	/* Linear arena that ir3_alloc() carves instructions, registers and
+	 * blocks out of.  None of those are freed individually, so they
+	 * don't need a ralloc header each.  Note that this means they can't
+	 * be used as ralloc parents either, use the ir3 itself for that.
+	 */
+	void *lin_ctx;
+
 #ifdef DEBUG
 	unsigned block_count, instr_count;
 #endif
@@ -24,6 +24,7 @@
  *    Rob Clark <robclark@freedesktop.org>
  */
 
+#include "util/disk_cache.h"
 #include "util/ralloc.h"
 
 #include "ir3_compiler.h"
@@ -36,6 +37,7 @@ static const struct debug_named_value shader_debug_options[] = {
 	{"optmsgs",    IR3_DBG_OPTMSGS,    "Enable optimizer debug messages"},
 	{"forces2en",  IR3_DBG_FORCES2EN,  "Force s2en mode for tex sampler instructions"},
 	{"nouboopt",   IR3_DBG_NOUBOOPT,   "Disable lowering UBO to uniform"},
+	{"nocache",    IR3_DBG_NOCACHE,    "Disable the shader variant disk cache"},
 	DEBUG_NAMED_VALUE_END
 };
 
@@ -75,3 +77,10 @@ struct ir3_compiler * ir3_compiler_create(struct fd_device *dev, uint32_t gpu_id
 
 	return compiler;
 }
+
+void ir3_compiler_destroy(struct ir3_compiler *compiler)
+{
+	if (compiler->disk_cache)
+		disk_cache_destroy(compiler->disk_cache);
+	ralloc_free(compiler);
+}
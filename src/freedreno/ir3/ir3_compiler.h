@@ -30,6 +30,7 @@
 #include "ir3_shader.h"
 
 struct ir3_ra_reg_set;
+struct disk_cache;
 
 struct ir3_compiler {
 	struct fd_device *dev;
@@ -67,9 +68,21 @@ struct ir3_compiler {
 	/* on a6xx, rewrite samgp to sequence of samgq0-3 in vertex shaders:
 	 */
 	bool samgq_workaround;
+
+	/* on-disk cache of compiled variants, NULL if disabled: */
+	struct disk_cache *disk_cache;
 };
 
 struct ir3_compiler * ir3_compiler_create(struct fd_device *dev, uint32_t gpu_id);
+void ir3_compiler_destroy(struct ir3_compiler *compiler);
+
+void ir3_disk_cache_init(struct ir3_compiler *compiler);
+void ir3_disk_cache_init_shader_key(struct ir3_compiler *compiler,
+		struct ir3_shader *shader);
+void * ir3_disk_cache_retrieve(struct ir3_compiler *compiler,
+		struct ir3_shader_variant *v);
+void ir3_disk_cache_store(struct ir3_compiler *compiler,
+		struct ir3_shader_variant *v, const void *bin);
 
 int ir3_compile_shader_nir(struct ir3_compiler *compiler,
 		struct ir3_shader_variant *so);
@@ -82,6 +95,7 @@ enum ir3_shader_debug {
 	IR3_DBG_OPTMSGS   = 0x10,
 	IR3_DBG_FORCES2EN = 0x20,
 	IR3_DBG_NOUBOOPT  = 0x40,
+	IR3_DBG_NOCACHE   = 0x80,
 };
 
 extern enum ir3_shader_debug ir3_shader_debug;
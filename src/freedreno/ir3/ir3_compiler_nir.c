@@ -817,7 +817,7 @@ emit_intrinsic_store_shared(struct ir3_context *ctx, nir_intrinsic_instr *intr)
 		stl->barrier_class = IR3_BARRIER_SHARED_W;
 		stl->barrier_conflict = IR3_BARRIER_SHARED_R | IR3_BARRIER_SHARED_W;
 
-		array_insert(b, b->keeps, stl);
+		array_insert(b->shader, b->keeps, stl);
 
 		/* Clear the bits in the writemask that we just wrote, then try
 		 * again to see if more channels are left.
@@ -901,7 +901,7 @@ emit_intrinsic_atomic_shared(struct ir3_context *ctx, nir_intrinsic_instr *intr)
 	atomic->barrier_conflict = IR3_BARRIER_SHARED_R | IR3_BARRIER_SHARED_W;
 
 	/* even if nothing consume the result, we can't DCE the instruction: */
-	array_insert(b, b->keeps, atomic);
+	array_insert(b->shader, b->keeps, atomic);
 
 	return atomic;
 }
@@ -1100,7 +1100,7 @@ emit_intrinsic_barrier(struct ir3_context *ctx, nir_intrinsic_instr *intr)
 	}
 
 	/* make sure barrier doesn't get DCE'd */
-	array_insert(b, b->keeps, barrier);
+	array_insert(b->shader, b->keeps, barrier);
 }
 
 static void add_sysval_input_compmask(struct ir3_context *ctx,
@@ -1555,7 +1555,7 @@ emit_intrinsic(struct ir3_context *ctx, nir_intrinsic_instr *intr)
 		kill = ir3_KILL(b, cond, 0);
 		array_insert(ctx->ir, ctx->ir->predicates, kill);
 
-		array_insert(b, b->keeps, kill);
+		array_insert(b->shader, b->keeps, kill);
 		ctx->so->no_earlyz = true;
 
 		break;
@@ -2107,7 +2107,7 @@ get_block(struct ir3_context *ctx, const nir_block *nblock)
 	_mesa_hash_table_insert(ctx->block_ht, nblock, block);
 
 	block->predecessors_count = nblock->predecessors->entries;
-	block->predecessors = ralloc_array_size(block,
+	block->predecessors = ralloc_array_size(ctx->ir,
 		sizeof(block->predecessors[0]), block->predecessors_count);
 	i = 0;
 	set_foreach(nblock->predecessors, sentry) {
@@ -2311,7 +2311,7 @@ emit_stream_out(struct ir3_context *ctx)
 			stg->cat6.type = TYPE_U32;
 			stg->cat6.dst_offset = (strmout->output[i].dst_offset + j) * 4;
 
-			array_insert(ctx->block, ctx->block->keeps, stg);
+			array_insert(ctx->ir, ctx->block->keeps, stg);
 		}
 	}
 
@@ -592,7 +592,7 @@ ir3_create_array_store(struct ir3_context *ctx, struct ir3_array *arr, int n,
 
 		arr->last_write = src;
 
-		array_insert(block, block->keeps, src);
+		array_insert(block->shader, block->keeps, src);
 
 		return;
 	}
@@ -619,5 +619,5 @@ ir3_create_array_store(struct ir3_context *ctx, struct ir3_array *arr, int n,
 	 * block (ie. loops), but since arrays are not in SSA, depth
 	 * pass won't know this.. so keep all array stores:
 	 */
-	array_insert(block, block->keeps, mov);
+	array_insert(block->shader, block->keeps, mov);
 }
@@ -0,0 +1,216 @@
+/*
+ * Copyright © 2019 Google, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "compiler/blob.h"
+#include "compiler/nir/nir_serialize.h"
+#include "util/disk_cache.h"
+#include "util/mesa-sha1.h"
+#include "util/u_string.h"
+
+#include "ir3_compiler.h"
+#include "ir3_shader.h"
+
+/*
+ * Shader variant disk cache.
+ *
+ * The cache key of a variant is the hash of the NIR it is compiled from
+ * (computed once per ir3_shader), the shader key and whether it is the
+ * binning pass variant.  The gpu_id is part of the cache name, so each
+ * generation gets its own entries.
+ *
+ * The cached object is the variant struct itself (the layout only changes
+ * together with the build-id, which invalidates the cache), followed by
+ * the immediates and the assembled binary.
+ */
+
+void
+ir3_disk_cache_init(struct ir3_compiler *compiler)
+{
+	if (ir3_shader_debug & IR3_DBG_NOCACHE)
+		return;
+
+	struct mesa_sha1 ctx;
+	unsigned char sha1[20];
+	char cache_id[20 * 2 + 1];
+	char renderer[16];
+
+	_mesa_sha1_init(&ctx);
+	if (!disk_cache_get_function_identifier(ir3_disk_cache_init, &ctx))
+		return;
+
+	_mesa_sha1_final(&ctx, sha1);
+	disk_cache_format_hex_id(cache_id, sha1, 20 * 2);
+
+	util_snprintf(renderer, sizeof(renderer), "FD%03d", compiler->gpu_id);
+
+	compiler->disk_cache = disk_cache_create(renderer, cache_id, 0);
+}
+
+void
+ir3_disk_cache_init_shader_key(struct ir3_compiler *compiler,
+		struct ir3_shader *shader)
+{
+	if (!compiler->disk_cache)
+		return;
+
+	struct mesa_sha1 ctx;
+	struct blob blob;
+
+	_mesa_sha1_init(&ctx);
+
+	blob_init(&blob);
+	nir_serialize(&blob, shader->nir, true);
+	_mesa_sha1_update(&ctx, blob.data, blob.size);
+	blob_finish(&blob);
+
+	/* stream outputs are set after the shader is created, so they are
+	 * hashed into the variant key instead.
+	 */
+	_mesa_sha1_final(&ctx, shader->cache_key);
+}
+
+static void
+compute_variant_key(struct ir3_compiler *compiler,
+		struct ir3_shader_variant *v, cache_key cache_key)
+{
+	struct ir3_shader *shader = v->shader;
+	struct blob blob;
+
+	blob_init(&blob);
+	blob_write_bytes(&blob, shader->cache_key, sizeof(shader->cache_key));
+	blob_write_bytes(&blob, &shader->stream_output,
+			sizeof(shader->stream_output));
+	blob_write_bytes(&blob, &v->key, sizeof(v->key));
+	blob_write_bytes(&blob, &v->binning_pass, sizeof(v->binning_pass));
+
+	disk_cache_compute_key(compiler->disk_cache, blob.data, blob.size,
+			cache_key);
+
+	blob_finish(&blob);
+}
+
+/**
+ * Look up the variant in the disk cache.  On a hit, the variant is filled
+ * in and the binary (to be freed by the caller) is returned.
+ */
+void *
+ir3_disk_cache_retrieve(struct ir3_compiler *compiler,
+		struct ir3_shader_variant *v)
+{
+	if (!compiler->disk_cache)
+		return NULL;
+
+	/* the disassembly needs the ir: */
+	if ((ir3_shader_debug & IR3_DBG_DISASM) || shader_debug_enabled(v->type))
+		return NULL;
+
+	cache_key cache_key;
+	size_t size;
+
+	compute_variant_key(compiler, v, cache_key);
+
+	void *buffer = disk_cache_get(compiler->disk_cache, cache_key, &size);
+	if (!buffer)
+		return NULL;
+
+	struct blob_reader blob;
+	struct ir3_shader_variant cached;
+	void *bin = NULL;
+
+	blob_reader_init(&blob, buffer, size);
+	blob_copy_bytes(&blob, &cached, sizeof(cached));
+
+	if (blob.overrun || cached.type != v->type ||
+			!ir3_shader_key_equal(&cached.key, &v->key) ||
+			cached.binning_pass != v->binning_pass)
+		goto out;
+
+	struct {
+		uint32_t val[4];
+	} *immediates = NULL;
+	unsigned immediates_size = cached.immediates_count * sizeof(*immediates);
+	unsigned bin_size = cached.info.sizedwords * 4;
+
+	if (cached.immediates_count) {
+		immediates = malloc(immediates_size);
+		if (!immediates)
+			goto out;
+		blob_copy_bytes(&blob, immediates, immediates_size);
+	}
+
+	bin = malloc(bin_size);
+	if (bin)
+		blob_copy_bytes(&blob, bin, bin_size);
+
+	if (!bin || blob.overrun || blob.current != blob.end) {
+		free(immediates);
+		free(bin);
+		bin = NULL;
+		goto out;
+	}
+
+	/* Keep everything identifying the variant and its place in the
+	 * shader, take the rest from the cache:
+	 */
+	cached.bo = NULL;
+	cached.id = v->id;
+	cached.binning = NULL;
+	cached.ir = NULL;
+	cached.next = NULL;
+	cached.shader = v->shader;
+	cached.immediates = (void *)immediates;
+	cached.immediates_size = cached.immediates_count;
+
+	*v = cached;
+
+out:
+	free(buffer);
+	return bin;
+}
+
+void
+ir3_disk_cache_store(struct ir3_compiler *compiler,
+		struct ir3_shader_variant *v, const void *bin)
+{
+	if (!compiler->disk_cache)
+		return;
+
+	cache_key cache_key;
+	struct blob blob;
+
+	compute_variant_key(compiler, v, cache_key);
+
+	blob_init(&blob);
+	blob_write_bytes(&blob, v, sizeof(*v));
+	if (v->immediates_count) {
+		blob_write_bytes(&blob, v->immediates,
+				v->immediates_count * sizeof(v->immediates[0]));
+	}
+	blob_write_bytes(&blob, bin, v->info.sizedwords * 4);
+
+	if (!blob.out_of_memory)
+		disk_cache_put(compiler->disk_cache, cache_key, blob.data, blob.size,
+				NULL);
+
+	blob_finish(&blob);
+}
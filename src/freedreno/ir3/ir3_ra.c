@@ -880,6 +880,79 @@ print_bitset(const char *name, BITSET_WORD *bs, unsigned cnt)
 	debug_printf("\n");
 }
 
+struct ir3_ra_range {
+	unsigned start, end, name;
+};
+
+static int
+range_cmp(const void *_a, const void *_b)
+{
+	const struct ir3_ra_range *a = _a, *b = _b;
+	if (a->start != b->start)
+		return a->start < b->start ? -1 : 1;
+	return (int)a->name - (int)b->name;
+}
+
+/* Add interference between all names with intersecting live ranges.
+ *
+ * Comparing every pair of names is quadratic in the number of names,
+ * which dominated RA time for large shaders.  Instead, visit the ranges
+ * in order of their start, keeping a list of the ones still live: a
+ * range can only intersect the ones that are live at its start.
+ *
+ * Ranges which end before they start can still intersect ranges which
+ * span them, so those few are compared against every name.
+ */
+static void
+ra_add_range_interference(struct ir3_ra_ctx *ctx)
+{
+	unsigned n = ctx->alloc_count;
+	struct ir3_ra_range *ranges = malloc(n * sizeof(*ranges));
+	unsigned *active = malloc(n * sizeof(*active));
+	unsigned num_ranges = 0, num_active = 0;
+
+	for (unsigned i = 0; i < n; i++) {
+		if (ctx->def[i] < ctx->use[i]) {
+			ranges[num_ranges++] = (struct ir3_ra_range){
+				.start = ctx->def[i],
+				.end = ctx->use[i],
+				.name = i,
+			};
+			continue;
+		}
+
+		for (unsigned j = 0; j < n; j++) {
+			if (intersects(ctx->def[i], ctx->use[i],
+					ctx->def[j], ctx->use[j])) {
+				ra_add_node_interference(ctx->g, i, j);
+			}
+		}
+	}
+
+	qsort(ranges, num_ranges, sizeof(*ranges), range_cmp);
+
+	for (unsigned i = 0; i < num_ranges; i++) {
+		const struct ir3_ra_range *r = &ranges[i];
+		unsigned still_active = 0;
+
+		for (unsigned j = 0; j < num_active; j++) {
+			const struct ir3_ra_range *a = &ranges[active[j]];
+
+			if (a->end <= r->start)
+				continue;
+
+			ra_add_node_interference(ctx->g, a->name, r->name);
+			active[still_active++] = active[j];
+		}
+
+		active[still_active++] = i;
+		num_active = still_active;
+	}
+
+	free(active);
+	free(ranges);
+}
+
 static void
 ra_add_interference(struct ir3_ra_ctx *ctx)
 {
@@ -958,14 +1031,7 @@ ra_add_interference(struct ir3_ra_ctx *ctx)
 		ctx->use[name] = ctx->instr_cnt;
 	}
 
-	for (unsigned i = 0; i < ctx->alloc_count; i++) {
-		for (unsigned j = 0; j < ctx->alloc_count; j++) {
-			if (intersects(ctx->def[i], ctx->use[i],
-					ctx->def[j], ctx->use[j])) {
-				ra_add_node_interference(ctx->g, i, j);
-			}
-		}
-	}
+	ra_add_range_interference(ctx);
 }
 
 /* some instructions need fix-up if dst register is half precision: */
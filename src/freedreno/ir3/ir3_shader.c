@@ -139,15 +139,11 @@ void * ir3_shader_assemble(struct ir3_shader_variant *v, uint32_t gpu_id)
 }
 
 static void
-assemble_variant(struct ir3_shader_variant *v)
+upload_variant(struct ir3_shader_variant *v, const uint32_t *bin)
 {
 	struct ir3_compiler *compiler = v->shader->compiler;
 	struct shader_info *info = &v->shader->nir->info;
-	uint32_t gpu_id = compiler->gpu_id;
-	uint32_t sz, *bin;
-
-	bin = ir3_shader_assemble(v, gpu_id);
-	sz = v->info.sizedwords * 4;
+	uint32_t sz = v->info.sizedwords * 4;
 
 	v->bo = fd_bo_new(compiler->dev, sz,
 			DRM_FREEDRENO_GEM_CACHE_WCOMBINE |
@@ -155,6 +151,19 @@ assemble_variant(struct ir3_shader_variant *v)
 			"%s:%s", ir3_shader_stage(v->shader), info->name);
 
 	memcpy(fd_bo_map(v->bo), bin, sz);
+}
+
+static void
+assemble_variant(struct ir3_shader_variant *v)
+{
+	struct ir3_compiler *compiler = v->shader->compiler;
+	uint32_t gpu_id = compiler->gpu_id;
+	uint32_t *bin;
+
+	bin = ir3_shader_assemble(v, gpu_id);
+
+	upload_variant(v, bin);
+	ir3_disk_cache_store(compiler, v, bin);
 
 	if (ir3_shader_debug & IR3_DBG_DISASM) {
 		struct ir3_shader_key key = v->key;
@@ -195,6 +204,13 @@ create_variant(struct ir3_shader *shader, struct ir3_shader_key *key,
 	v->key = *key;
 	v->type = shader->type;
 
+	void *bin = ir3_disk_cache_retrieve(shader->compiler, v);
+	if (bin) {
+		upload_variant(v, bin);
+		free(bin);
+		return v;
+	}
+
 	ret = ir3_compile_shader_nir(shader->compiler, v);
 	if (ret) {
 		debug_error("compile failed!");
@@ -292,6 +308,8 @@ ir3_shader_from_nir(struct ir3_compiler *compiler, nir_shader *nir)
 
 	/* do first pass optimization, ignoring the key: */
 	shader->nir = ir3_optimize_nir(shader, nir, NULL);
+
+	ir3_disk_cache_init_shader_key(compiler, shader);
 	if (ir3_shader_debug & IR3_DBG_DISASM) {
 		printf("dump nir%d: type=%d", shader->id, shader->type);
 		nir_print_shader(shader->nir, stdout);
@@ -519,6 +519,9 @@ struct ir3_shader {
 	struct nir_shader *nir;
 	struct ir3_stream_output_info stream_output;
 
+	/* hash of the nir, for the variant disk cache: */
+	uint8_t cache_key[20];
+
 	struct ir3_shader_variant *variants;
 };
 
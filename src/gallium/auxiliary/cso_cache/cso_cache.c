@@ -44,36 +44,31 @@ struct cso_cache {
    void                 *sanitize_data;
 };
 
-#if 1
 static unsigned hash_key(const void *key, unsigned key_size)
 {
-   unsigned *ikey = (unsigned *)key;
-   unsigned hash = 0, i;
+   const uint32_t *ikey = (const uint32_t *)key;
+   uint32_t hash = key_size;
+   unsigned i;
 
    assert(key_size % 4 == 0);
 
-   /* I'm sure this can be improved on:
+   /* Murmur3-style word mixing.  The states hashed here are mostly zeros
+    * and small enums, which a plain XOR of the words folds onto a handful
+    * of buckets; mixing each word first spreads them over the whole table.
     */
-   for (i = 0; i < key_size/4; i++)
-      hash ^= ikey[i];
+   for (i = 0; i < key_size/4; i++) {
+      uint32_t k = ikey[i] * 0xcc9e2d51;
+      k = (k << 15) | (k >> 17);
+      hash ^= k * 0x1b873593;
+      hash = (hash << 13) | (hash >> 19);
+      hash = hash * 5 + 0xe6546b64;
+   }
 
+   hash ^= hash >> 16;
+   hash *= 0x85ebca6b;
+   hash ^= hash >> 13;
    return hash;
 }
-#else
-static unsigned hash_key(const unsigned char *p, int n)
-{
-   unsigned h = 0;
-   unsigned g;
-
-   while (n--) {
-      h = (h << 4) + *p++;
-      if ((g = (h & 0xf0000000)) != 0)
-         h ^= g >> 23;
-      h &= ~g;
-   }
-   return h;
-}
-#endif
 
 unsigned cso_construct_key(void *item, int item_size)
 {
@@ -254,6 +254,26 @@ void draw_set_zs_format(struct draw_context *draw, enum pipe_format format)
 }
 
 
+/**
+ * Install the driver's hooks for caching the LLVM-generated vertex and
+ * geometry shader variants on disk.
+ */
+void
+draw_set_disk_cache_callbacks(struct draw_context *draw,
+                              void *data_cookie,
+                              void (*find_shader)(void *cookie,
+                                                  struct lp_cached_code *cache,
+                                                  unsigned char ir_sha1_cache_key[20]),
+                              void (*insert_shader)(void *cookie,
+                                                    struct lp_cached_code *cache,
+                                                    unsigned char ir_sha1_cache_key[20]))
+{
+   draw->disk_cache_find_shader = find_shader;
+   draw->disk_cache_insert_shader = insert_shader;
+   draw->disk_cache_cookie = data_cookie;
+}
+
+
 static bool
 draw_is_vs_window_space(struct draw_context *draw)
 {
@@ -70,6 +70,7 @@ struct tgsi_image;
 struct tgsi_buffer;
 struct draw_pt_front_end;
 struct draw_assembler;
+struct lp_cached_code;
 struct draw_llvm;
 
 
@@ -326,6 +327,15 @@ struct draw_context
 
    struct draw_llvm *llvm;
 
+   /** Driver hooks to look up / store variant object code on disk */
+   void *disk_cache_cookie;
+   void (*disk_cache_find_shader)(void *cookie,
+                                  struct lp_cached_code *cache,
+                                  unsigned char ir_sha1_cache_key[20]);
+   void (*disk_cache_insert_shader)(void *cookie,
+                                    struct lp_cached_code *cache,
+                                    unsigned char ir_sha1_cache_key[20]);
+
    /** Texture sampler and sampler view state.
     * Note that we have arrays indexed by shader type.  At this time
     * we only handle vertex and geometry shaders in the draw module, but
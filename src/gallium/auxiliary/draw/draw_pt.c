@@ -148,6 +148,9 @@ draw_pt_arrays(struct draw_context *draw,
 
    frontend->run( frontend, start, count );
 
+   if (middle->end_run)
+      middle->end_run(middle);
+
    return TRUE;
 }
 
@@ -124,6 +124,12 @@ struct draw_pt_middle_end {
 
    int (*get_max_vertex_count)( struct draw_pt_middle_end * );
 
+   /**
+    * Called when the front end is done running a draw, for middle ends
+    * which hold on to work between the run calls.  Optional.
+    */
+   void (*end_run)( struct draw_pt_middle_end * );
+
    void (*finish)( struct draw_pt_middle_end * );
    void (*destroy)( struct draw_pt_middle_end * );
 };
@@ -25,9 +25,12 @@
  *
  **************************************************************************/
 
+#include "util/u_cpu_detect.h"
+#include "util/u_debug.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
 #include "util/u_prim.h"
+#include "util/u_queue.h"
 #include "draw/draw_context.h"
 #include "draw/draw_gs.h"
 #include "draw/draw_vbuf.h"
@@ -40,6 +43,41 @@
 #include "gallivm/lp_bld_debug.h"
 
 
+/** Max number of vertex shading threads */
+#define LLVM_MAX_THREADS 8
+
+/** Max number of chunks of a draw in flight */
+#define LLVM_MAX_CHUNKS 32
+
+
+struct llvm_middle_end;
+
+/**
+ * A set of vertices handed to us by the front end, along with the
+ * primitives using them.
+ */
+struct llvm_chunk {
+   struct llvm_middle_end *fpme;
+
+   struct draw_fetch_info fetch_info;
+   struct draw_prim_info prim_info;
+   struct draw_vertex_info vert_info;
+   unsigned prim_length;
+   unsigned start_or_maxelt;
+   unsigned vid_base;
+   boolean clipped;
+
+   /* Copies of the front end's elements, which get reused */
+   unsigned *fetch_elts;
+   unsigned max_fetch_elts;
+   ushort *draw_elts;
+   unsigned max_draw_elts;
+
+   boolean queued;
+   struct util_queue_fence fence;
+};
+
+
 struct llvm_middle_end {
    struct draw_pt_middle_end base;
    struct draw_context *draw;
@@ -57,6 +95,21 @@ struct llvm_middle_end {
 
    struct draw_llvm *llvm;
    struct draw_llvm_variant *current_variant;
+
+   /*
+    * The vertex shader runs on the chunks of a draw in worker threads,
+    * while the rest of the pipeline processes them in order here.
+    */
+   unsigned num_threads;
+   boolean queue_created;
+   struct util_queue queue;
+   struct llvm_chunk chunks[LLVM_MAX_CHUNKS];
+   unsigned first_chunk;
+   unsigned num_chunks;
+
+   /* Elements of the triangles left by llvm_reject_tris() */
+   ushort *reject_elts;
+   unsigned max_reject_elts;
 };
 
 
@@ -347,37 +400,114 @@ emit(struct pt_emit *emit,
 }
 
 
-static void
-llvm_pipeline_generic(struct draw_pt_middle_end *middle,
-                      const struct draw_fetch_info *fetch_info,
-                      const struct draw_prim_info *in_prim_info)
+/**
+ * Trivially reject the triangles of a list which have all their vertices
+ * outside of the same clip plane, which is what the clip stage would do
+ * one triangle at a time.  The clip masks of a batch of triangles are
+ * gathered first, so the tests themselves run in a tight loop.
+ *
+ * \param out_prim_info  returns the remaining triangles, as elements
+ * \return whether some of the remaining triangles need clipping
+ */
+static boolean
+llvm_reject_tris(struct llvm_middle_end *fpme,
+                 const struct draw_vertex_info *vert_info,
+                 const struct draw_prim_info *prim_info,
+                 struct draw_prim_info *out_prim_info)
+{
+#define REJECT_BATCH 16
+   const char *verts = (const char *) vert_info->verts;
+   const unsigned stride = vert_info->stride;
+   const unsigned count = prim_info->count - prim_info->count % 3;
+   unsigned and_mask[REJECT_BATCH], or_mask[REJECT_BATCH];
+   ushort idx[REJECT_BATCH][3];
+   unsigned straddle = 0;
+   unsigned num_elts = 0;
+   unsigned i, j, k, n;
+
+   if (count > fpme->max_reject_elts) {
+      FREE(fpme->reject_elts);
+      fpme->reject_elts = MALLOC(count * sizeof(ushort));
+      fpme->max_reject_elts = fpme->reject_elts ? count : 0;
+   }
+
+   *out_prim_info = *prim_info;
+   if (!fpme->reject_elts)
+      return TRUE;
+
+   for (i = 0; i < count; i += n * 3) {
+      n = MIN2((count - i) / 3, REJECT_BATCH);
+
+      for (j = 0; j < n; j++) {
+         for (k = 0; k < 3; k++) {
+            idx[j][k] = prim_info->linear ? i + j * 3 + k :
+                                            prim_info->elts[i + j * 3 + k];
+         }
+      }
+
+      for (j = 0; j < n; j++) {
+         const struct vertex_header *v0 =
+            (const struct vertex_header *) (verts + idx[j][0] * stride);
+         const struct vertex_header *v1 =
+            (const struct vertex_header *) (verts + idx[j][1] * stride);
+         const struct vertex_header *v2 =
+            (const struct vertex_header *) (verts + idx[j][2] * stride);
+
+         and_mask[j] = v0->clipmask & v1->clipmask & v2->clipmask;
+         or_mask[j] = v0->clipmask | v1->clipmask | v2->clipmask;
+      }
+
+      for (j = 0; j < n; j++) {
+         if (!and_mask[j]) {
+            straddle |= or_mask[j];
+            fpme->reject_elts[num_elts++] = idx[j][0];
+            fpme->reject_elts[num_elts++] = idx[j][1];
+            fpme->reject_elts[num_elts++] = idx[j][2];
+         }
+      }
+   }
+#undef REJECT_BATCH
+
+   out_prim_info->linear = FALSE;
+   out_prim_info->start = 0;
+   out_prim_info->elts = fpme->reject_elts;
+   out_prim_info->count = num_elts;
+   out_prim_info->primitive_count = 1;
+   out_prim_info->primitive_lengths = &out_prim_info->count;
+
+   return straddle != 0;
+}
+
+
+/**
+ * Set up a chunk for the given fetch and draw elements, and allocate its
+ * vertices.
+ */
+static boolean
+llvm_chunk_init(struct llvm_middle_end *fpme,
+                struct llvm_chunk *chunk,
+                const struct draw_fetch_info *fetch_info,
+                const struct draw_prim_info *prim_info)
 {
-   struct llvm_middle_end *fpme = llvm_middle_end(middle);
    struct draw_context *draw = fpme->draw;
-   struct draw_geometry_shader *gshader = draw->gs.geometry_shader;
-   struct draw_prim_info gs_prim_info[TGSI_MAX_VERTEX_STREAMS];
-   struct draw_vertex_info llvm_vert_info;
-   struct draw_vertex_info gs_vert_info[TGSI_MAX_VERTEX_STREAMS];
-   struct draw_vertex_info *vert_info;
-   struct draw_prim_info ia_prim_info;
-   struct draw_vertex_info ia_vert_info;
-   const struct draw_prim_info *prim_info = in_prim_info;
-   boolean free_prim_info = FALSE;
-   unsigned opt = fpme->opt;
-   boolean clipped = 0;
-   unsigned start_or_maxelt, vid_base;
-   const unsigned *elts;
 
    assert(fetch_info->count > 0);
-   llvm_vert_info.count = fetch_info->count;
-   llvm_vert_info.vertex_size = fpme->vertex_size;
-   llvm_vert_info.stride = fpme->vertex_size;
-   llvm_vert_info.verts = (struct vertex_header *)
+
+   chunk->fpme = fpme;
+   chunk->fetch_info = *fetch_info;
+   chunk->prim_info = *prim_info;
+   chunk->prim_length = prim_info->primitive_lengths[0];
+   chunk->prim_info.primitive_lengths = &chunk->prim_length;
+
+   chunk->vert_info.count = fetch_info->count;
+   chunk->vert_info.vertex_size = fpme->vertex_size;
+   chunk->vert_info.stride = fpme->vertex_size;
+   chunk->vert_info.verts = (struct vertex_header *)
       MALLOC(fpme->vertex_size *
              align(fetch_info->count, lp_native_vector_width / 32));
-   if (!llvm_vert_info.verts) {
+   if (!chunk->vert_info.verts) {
       assert(0);
-      return;
+      return FALSE;
    }
 
    if (draw->collect_statistics) {
@@ -388,31 +518,77 @@ llvm_pipeline_generic(struct draw_pt_middle_end *middle,
    }
 
    if (fetch_info->linear) {
-      start_or_maxelt = fetch_info->start;
-      vid_base = draw->start_index;
-      elts = NULL;
+      chunk->start_or_maxelt = fetch_info->start;
+      chunk->vid_base = draw->start_index;
    }
    else {
-      start_or_maxelt = draw->pt.user.eltMax;
-      vid_base = draw->pt.user.eltBias;
-      elts = fetch_info->elts;
+      chunk->start_or_maxelt = draw->pt.user.eltMax;
+      chunk->vid_base = draw->pt.user.eltBias;
    }
-   clipped = fpme->current_variant->jit_func(&fpme->llvm->jit_context,
-                                             llvm_vert_info.verts,
-                                             draw->pt.user.vbuffer,
-                                             fetch_info->count,
-                                             start_or_maxelt,
-                                             fpme->vertex_size,
-                                             draw->pt.vertex_buffer,
-                                             draw->instance_id,
-                                             vid_base,
-                                             draw->start_instance,
-                                             elts);
-
-   /* Finished with fetch and vs:
-    */
-   fetch_info = NULL;
-   vert_info = &llvm_vert_info;
+
+   return TRUE;
+}
+
+
+/**
+ * Fetch and shade the vertices of a chunk.
+ */
+static void
+llvm_chunk_shade(struct llvm_chunk *chunk)
+{
+   struct llvm_middle_end *fpme = chunk->fpme;
+   struct draw_context *draw = fpme->draw;
+
+   chunk->clipped =
+      fpme->current_variant->jit_func(&fpme->llvm->jit_context,
+                                      chunk->vert_info.verts,
+                                      draw->pt.user.vbuffer,
+                                      chunk->fetch_info.count,
+                                      chunk->start_or_maxelt,
+                                      fpme->vertex_size,
+                                      draw->pt.vertex_buffer,
+                                      draw->instance_id,
+                                      chunk->vid_base,
+                                      draw->start_instance,
+                                      chunk->fetch_info.linear ?
+                                      NULL : chunk->fetch_info.elts);
+}
+
+
+/**
+ * Thread function shading a queued chunk.
+ */
+static void
+llvm_chunk_execute(void *job, int thread_index)
+{
+   /* Same as draw_vbo() does for the calling thread */
+   util_fpstate_set_denorms_to_zero(util_fpstate_get());
+
+   llvm_chunk_shade((struct llvm_chunk *) job);
+}
+
+
+/**
+ * Run the shaded vertices of a chunk through the rest of the pipeline
+ * and free them.
+ */
+static void
+llvm_chunk_finish(struct llvm_chunk *chunk)
+{
+   struct llvm_middle_end *fpme = chunk->fpme;
+   struct draw_context *draw = fpme->draw;
+   struct draw_geometry_shader *gshader = draw->gs.geometry_shader;
+   struct draw_prim_info gs_prim_info[TGSI_MAX_VERTEX_STREAMS];
+   struct draw_vertex_info gs_vert_info[TGSI_MAX_VERTEX_STREAMS];
+   struct draw_vertex_info *vert_info = &chunk->vert_info;
+   struct draw_prim_info ia_prim_info;
+   struct draw_vertex_info ia_vert_info;
+   struct draw_prim_info reject_prim_info;
+   const struct draw_prim_info *prim_info = &chunk->prim_info;
+   boolean free_prim_info = FALSE;
+   unsigned *free_prim_lengths = NULL;
+   unsigned opt = fpme->opt;
+   boolean clipped = chunk->clipped;
 
    if ((opt & PT_SHADE) && gshader) {
       struct draw_vertex_shader *vshader = draw->vs.vertex_shader;
@@ -447,6 +623,7 @@ llvm_pipeline_generic(struct draw_pt_middle_end *middle,
             vert_info = &ia_vert_info;
             prim_info = &ia_prim_info;
             free_prim_info = TRUE;
+            free_prim_lengths = ia_prim_info.primitive_lengths;
          }
       }
    }
@@ -474,6 +651,20 @@ llvm_pipeline_generic(struct draw_pt_middle_end *middle,
                                draw->vs.vertex_shader->info.writes_viewport_index)) {
          clipped = draw_pt_post_vs_run( fpme->post_vs, vert_info, prim_info );
       }
+      /* Most triangles of a clipped triangle list usually are either
+       * entirely visible or entirely outside.  Drop the latter here and,
+       * if there are only the former left, skip the pipeline.
+       */
+      if (clipped && !(opt & PT_PIPELINE) &&
+          prim_info->prim == PIPE_PRIM_TRIANGLES &&
+          prim_info->primitive_count == 1) {
+         clipped = llvm_reject_tris(fpme, vert_info, prim_info,
+                                    &reject_prim_info);
+         prim_info = &reject_prim_info;
+         if (!prim_info->count)
+            goto done;
+      }
+
       /* "clipped" also includes non-one edgeflag */
       if (clipped) {
          opt |= PT_PIPELINE;
@@ -488,9 +679,158 @@ llvm_pipeline_generic(struct draw_pt_middle_end *middle,
          emit( fpme->emit, vert_info, prim_info );
       }
    }
+done:
    FREE(vert_info->verts);
    if (free_prim_info) {
-      FREE(prim_info->primitive_lengths);
+      FREE(free_prim_lengths);
+   }
+}
+
+
+/**
+ * Copy the elements of a chunk, which are only valid during the call
+ * from the front end.
+ */
+static boolean
+llvm_chunk_copy_elts(struct llvm_chunk *chunk)
+{
+   if (!chunk->fetch_info.linear) {
+      const unsigned count = chunk->fetch_info.count;
+
+      if (count > chunk->max_fetch_elts) {
+         FREE(chunk->fetch_elts);
+         chunk->fetch_elts = MALLOC(count * sizeof(unsigned));
+         chunk->max_fetch_elts = chunk->fetch_elts ? count : 0;
+         if (!chunk->fetch_elts)
+            return FALSE;
+      }
+      memcpy(chunk->fetch_elts, chunk->fetch_info.elts,
+             count * sizeof(unsigned));
+      chunk->fetch_info.elts = chunk->fetch_elts;
+   }
+
+   if (!chunk->prim_info.linear) {
+      const unsigned count = chunk->prim_info.count;
+
+      if (count > chunk->max_draw_elts) {
+         FREE(chunk->draw_elts);
+         chunk->draw_elts = MALLOC(count * sizeof(ushort));
+         chunk->max_draw_elts = chunk->draw_elts ? count : 0;
+         if (!chunk->draw_elts)
+            return FALSE;
+      }
+      memcpy(chunk->draw_elts, chunk->prim_info.elts,
+             count * sizeof(ushort));
+      chunk->prim_info.elts = chunk->draw_elts;
+   }
+
+   return TRUE;
+}
+
+
+/**
+ * Hand a chunk to the vertex shading threads.
+ */
+static void
+llvm_middle_end_queue_chunk(struct llvm_middle_end *fpme,
+                            struct llvm_chunk *chunk)
+{
+   if (!fpme->num_threads)
+      return;
+
+   if (!fpme->queue_created) {
+      if (!util_queue_init(&fpme->queue, "drawvs", LLVM_MAX_CHUNKS,
+                           fpme->num_threads, 0)) {
+         /* Shade it when it's retired */
+         fpme->num_threads = 0;
+         return;
+      }
+      fpme->queue_created = TRUE;
+   }
+
+   chunk->queued = TRUE;
+   util_queue_add_job(&fpme->queue, chunk, &chunk->fence,
+                      llvm_chunk_execute, NULL);
+}
+
+
+/**
+ * Finish the oldest chunk in flight.
+ */
+static void
+llvm_middle_end_retire_chunk(struct llvm_middle_end *fpme)
+{
+   struct llvm_chunk *chunk = &fpme->chunks[fpme->first_chunk];
+
+   assert(fpme->num_chunks);
+   fpme->first_chunk = (fpme->first_chunk + 1) % LLVM_MAX_CHUNKS;
+   fpme->num_chunks--;
+
+   if (chunk->queued) {
+      util_queue_fence_wait(&chunk->fence);
+      chunk->queued = FALSE;
+   }
+   else {
+      llvm_chunk_shade(chunk);
+   }
+
+   llvm_chunk_finish(chunk);
+}
+
+
+/**
+ * Finish all the chunks in flight, in order.
+ */
+static void
+llvm_middle_end_flush_chunks(struct llvm_middle_end *fpme)
+{
+   while (fpme->num_chunks)
+      llvm_middle_end_retire_chunk(fpme);
+}
+
+
+static void
+llvm_pipeline_generic(struct draw_pt_middle_end *middle,
+                      const struct draw_fetch_info *fetch_info,
+                      const struct draw_prim_info *prim_info)
+{
+   struct llvm_middle_end *fpme = llvm_middle_end(middle);
+   struct llvm_chunk *chunk;
+
+   if (!fpme->num_threads) {
+      struct llvm_chunk local;
+
+      llvm_middle_end_flush_chunks(fpme);
+      if (llvm_chunk_init(fpme, &local, fetch_info, prim_info)) {
+         llvm_chunk_shade(&local);
+         llvm_chunk_finish(&local);
+      }
+      return;
+   }
+
+   if (fpme->num_chunks == LLVM_MAX_CHUNKS)
+      llvm_middle_end_retire_chunk(fpme);
+
+   chunk = &fpme->chunks[(fpme->first_chunk + fpme->num_chunks) %
+                         LLVM_MAX_CHUNKS];
+   if (!llvm_chunk_init(fpme, chunk, fetch_info, prim_info))
+      return;
+   if (!llvm_chunk_copy_elts(chunk)) {
+      FREE(chunk->vert_info.verts);
+      return;
+   }
+   fpme->num_chunks++;
+
+   /* Draws which fit in a single chunk, the common case, are shaded on
+    * the calling thread when the draw ends.  As soon as a second chunk
+    * shows up, both go to the threads.
+    */
+   if (fpme->num_chunks > 1) {
+      struct llvm_chunk *first = &fpme->chunks[fpme->first_chunk];
+
+      if (!first->queued)
+         llvm_middle_end_queue_chunk(fpme, first);
+      llvm_middle_end_queue_chunk(fpme, chunk);
    }
 }
 
@@ -595,10 +935,17 @@ llvm_middle_end_linear_run_elts(struct draw_pt_middle_end *middle,
 }
 
 
+static void
+llvm_middle_end_end_run(struct draw_pt_middle_end *middle)
+{
+   llvm_middle_end_flush_chunks(llvm_middle_end(middle));
+}
+
+
 static void
 llvm_middle_end_finish(struct draw_pt_middle_end *middle)
 {
-   /* nothing to do */
+   llvm_middle_end_flush_chunks(llvm_middle_end(middle));
 }
 
 
@@ -606,6 +953,19 @@ static void
 llvm_middle_end_destroy(struct draw_pt_middle_end *middle)
 {
    struct llvm_middle_end *fpme = llvm_middle_end(middle);
+   unsigned i;
+
+   assert(!fpme->num_chunks);
+
+   if (fpme->queue_created)
+      util_queue_destroy(&fpme->queue);
+
+   for (i = 0; i < LLVM_MAX_CHUNKS; i++) {
+      util_queue_fence_destroy(&fpme->chunks[i].fence);
+      FREE(fpme->chunks[i].fetch_elts);
+      FREE(fpme->chunks[i].draw_elts);
+   }
+   FREE(fpme->reject_elts);
 
    if (fpme->fetch)
       draw_pt_fetch_destroy( fpme->fetch );
@@ -627,6 +987,7 @@ struct draw_pt_middle_end *
 draw_pt_fetch_pipeline_or_emit_llvm(struct draw_context *draw)
 {
    struct llvm_middle_end *fpme = 0;
+   unsigned i;
 
    if (!draw->llvm)
       return NULL;
@@ -640,11 +1001,22 @@ draw_pt_fetch_pipeline_or_emit_llvm(struct draw_context *draw)
    fpme->base.run             = llvm_middle_end_run;
    fpme->base.run_linear      = llvm_middle_end_linear_run;
    fpme->base.run_linear_elts = llvm_middle_end_linear_run_elts;
+   fpme->base.end_run         = llvm_middle_end_end_run;
    fpme->base.finish          = llvm_middle_end_finish;
    fpme->base.destroy         = llvm_middle_end_destroy;
 
    fpme->draw = draw;
 
+   for (i = 0; i < LLVM_MAX_CHUNKS; i++)
+      util_queue_fence_init(&fpme->chunks[i].fence);
+
+   /* The threads only get started by the first draw big enough to use them */
+   fpme->num_threads =
+      debug_get_num_option("DRAW_NUM_THREADS",
+                           util_cpu_caps.nr_cpus > 1 ?
+                           MIN2(util_cpu_caps.nr_cpus, LLVM_MAX_THREADS) : 0);
+   fpme->num_threads = MIN2(fpme->num_threads, LLVM_MAX_THREADS);
+
    fpme->fetch = draw_pt_fetch_create( draw );
    if (!fpme->fetch)
       goto fail;
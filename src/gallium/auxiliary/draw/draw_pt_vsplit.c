@@ -23,6 +23,9 @@
  * DEALINGS IN THE SOFTWARE.
  */
 
+#include <inttypes.h>
+
+#include "util/u_debug.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
 
@@ -31,7 +34,18 @@
 #include "draw/draw_pt.h"
 
 #define SEGMENT_SIZE 1024
-#define MAP_SIZE     256
+
+/* Size of the map from fetch to draw elements, a power of two.  The map
+ * gets reset for each segment, so there's no point in it being much
+ * larger than SEGMENT_SIZE.
+ */
+#define MIN_MAP_SIZE     64
+#define DEFAULT_MAP_SIZE 1024
+#define MAX_MAP_SIZE     (4 * SEGMENT_SIZE)
+
+DEBUG_GET_ONCE_NUM_OPTION(draw_vsplit_cache_size, "DRAW_VSPLIT_CACHE_SIZE",
+                          DEFAULT_MAP_SIZE)
+DEBUG_GET_ONCE_BOOL_OPTION(draw_vsplit_stats, "DRAW_VSPLIT_STATS", FALSE)
 
 /* The largest possible index within an index buffer */
 #define MAX_ELT_IDX 0xffffffff
@@ -54,20 +68,27 @@ struct vsplit_frontend {
 
    struct {
       /* map a fetch element to a draw element */
-      unsigned fetches[MAP_SIZE];
-      ushort draws[MAP_SIZE];
+      unsigned fetches[MAX_MAP_SIZE];
+      ushort draws[MAX_MAP_SIZE];
+      unsigned mask;
       boolean has_max_fetch;
 
       ushort num_fetch_elts;
       ushort num_draw_elts;
    } cache;
+
+   /* cache statistics, for DRAW_VSPLIT_STATS */
+   uint64_t num_draw_elts;
+   uint64_t num_fetch_elts;
 };
 
 
+/**
+ * Start a new segment.  The map entries are reset by vsplit_flush_cache().
+ */
 static void
 vsplit_clear_cache(struct vsplit_frontend *vsplit)
 {
-   memset(vsplit->cache.fetches, 0xff, sizeof(vsplit->cache.fetches));
    vsplit->cache.has_max_fetch = FALSE;
    vsplit->cache.num_fetch_elts = 0;
    vsplit->cache.num_draw_elts = 0;
@@ -76,9 +97,23 @@ vsplit_clear_cache(struct vsplit_frontend *vsplit)
 static void
 vsplit_flush_cache(struct vsplit_frontend *vsplit, unsigned flags)
 {
+   unsigned i;
+
    vsplit->middle->run(vsplit->middle,
          vsplit->fetch_elts, vsplit->cache.num_fetch_elts,
          vsplit->draw_elts, vsplit->cache.num_draw_elts, flags);
+
+   vsplit->num_draw_elts += vsplit->cache.num_draw_elts;
+   vsplit->num_fetch_elts += vsplit->cache.num_fetch_elts;
+
+   /* Only the entries of the fetched elements were written, resetting
+    * just those is much cheaper than clearing the whole map for short
+    * segments.
+    */
+   for (i = 0; i < vsplit->cache.num_fetch_elts; i++) {
+      const unsigned hash = vsplit->fetch_elts[i] & vsplit->cache.mask;
+      vsplit->cache.fetches[hash] = DRAW_MAX_FETCH_IDX;
+   }
 }
 
 /**
@@ -89,7 +124,7 @@ vsplit_add_cache(struct vsplit_frontend *vsplit, unsigned fetch)
 {
    unsigned hash;
 
-   hash = fetch % MAP_SIZE;
+   hash = fetch & vsplit->cache.mask;
 
    /* If the value isn't in the cache or it's an overflow due to the
     * element bias */
@@ -127,7 +162,7 @@ vsplit_add_cache_ubyte(struct vsplit_frontend *vsplit, const ubyte *elts,
    elt_idx = (unsigned)((int)(DRAW_GET_IDX(elts, elt_idx)) + elt_bias);
    /* unlike the uint case this can only happen with elt_bias */
    if (elt_bias && elt_idx == DRAW_MAX_FETCH_IDX && !vsplit->cache.has_max_fetch) {
-      unsigned hash = elt_idx % MAP_SIZE;
+      unsigned hash = elt_idx & vsplit->cache.mask;
       vsplit->cache.fetches[hash] = 0;
       vsplit->cache.has_max_fetch = TRUE;
    }
@@ -144,7 +179,7 @@ vsplit_add_cache_ushort(struct vsplit_frontend *vsplit, const ushort *elts,
    elt_idx = (unsigned)((int)(DRAW_GET_IDX(elts, elt_idx)) + elt_bias);
    /* unlike the uint case this can only happen with elt_bias */
    if (elt_bias && elt_idx == DRAW_MAX_FETCH_IDX && !vsplit->cache.has_max_fetch) {
-      unsigned hash = elt_idx % MAP_SIZE;
+      unsigned hash = elt_idx & vsplit->cache.mask;
       vsplit->cache.fetches[hash] = 0;
       vsplit->cache.has_max_fetch = TRUE;
    }
@@ -169,7 +204,7 @@ vsplit_add_cache_uint(struct vsplit_frontend *vsplit, const uint *elts,
    elt_idx = (unsigned)((int)(DRAW_GET_IDX(elts, elt_idx)) + elt_bias);
    /* Take care for DRAW_MAX_FETCH_IDX (since cache is initialized to -1). */
    if (elt_idx == DRAW_MAX_FETCH_IDX && !vsplit->cache.has_max_fetch) {
-      unsigned hash = elt_idx % MAP_SIZE;
+      unsigned hash = elt_idx & vsplit->cache.mask;
       /* force update - any value will do except DRAW_MAX_FETCH_IDX */
       vsplit->cache.fetches[hash] = 0;
       vsplit->cache.has_max_fetch = TRUE;
@@ -245,6 +280,16 @@ static void vsplit_flush(struct draw_pt_front_end *frontend, unsigned flags)
 
 static void vsplit_destroy(struct draw_pt_front_end *frontend)
 {
+   struct vsplit_frontend *vsplit = (struct vsplit_frontend *) frontend;
+
+   if (debug_get_option_draw_vsplit_stats() && vsplit->num_draw_elts) {
+      debug_printf("draw: vsplit cache: %" PRIu64 " elements, "
+                   "%" PRIu64 " fetched, %.1f%% reused\n",
+                   vsplit->num_draw_elts, vsplit->num_fetch_elts,
+                   100.0 * (vsplit->num_draw_elts - vsplit->num_fetch_elts) /
+                   vsplit->num_draw_elts);
+   }
+
    FREE(frontend);
 }
 
@@ -252,11 +297,18 @@ static void vsplit_destroy(struct draw_pt_front_end *frontend)
 struct draw_pt_front_end *draw_pt_vsplit(struct draw_context *draw)
 {
    struct vsplit_frontend *vsplit = CALLOC_STRUCT(vsplit_frontend);
+   unsigned map_size;
    ushort i;
 
    if (!vsplit)
       return NULL;
 
+   map_size = debug_get_option_draw_vsplit_cache_size();
+   map_size = util_next_power_of_two(CLAMP(map_size, MIN_MAP_SIZE,
+                                           MAX_MAP_SIZE));
+   vsplit->cache.mask = map_size - 1;
+   memset(vsplit->cache.fetches, 0xff, sizeof(vsplit->cache.fetches));
+
    vsplit->base.prepare = vsplit_prepare;
    vsplit->base.run     = NULL;
    vsplit->base.flush   = vsplit_flush;
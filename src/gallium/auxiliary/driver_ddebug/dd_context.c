@@ -27,6 +27,7 @@
 
 #include "dd_pipe.h"
 #include "tgsi/tgsi_parse.h"
+#include "util/hash_table.h"
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 
@@ -263,6 +264,14 @@ DD_CSO_DELETE(vertex_elements)
  * shaders
  */
 
+/* Identifies shaders in DD_DUMP_RING dumps across runs */
+static uint32_t
+dd_hash_tokens(const struct tgsi_token *tokens)
+{
+   return _mesa_hash_data(tokens, tgsi_num_tokens(tokens) *
+                                  sizeof(struct tgsi_token));
+}
+
 #define DD_SHADER_NOCREATE(NAME, name) \
    static void \
    dd_context_bind_##name##_state(struct pipe_context *_pipe, void *state) \
@@ -300,8 +309,10 @@ DD_CSO_DELETE(vertex_elements)
          return NULL; \
       hstate->cso = pipe->create_##name##_state(pipe, state); \
       hstate->state.shader = *state; \
-      if (hstate->state.shader.type == PIPE_SHADER_IR_TGSI) \
+      if (hstate->state.shader.type == PIPE_SHADER_IR_TGSI) { \
          hstate->state.shader.tokens = tgsi_dup_tokens(state->tokens); \
+         hstate->hash = dd_hash_tokens(state->tokens); \
+      } \
       return hstate; \
    } \
     \
@@ -326,8 +337,10 @@ dd_context_create_compute_state(struct pipe_context *_pipe,
 
    hstate->state.shader.type = state->ir_type;
 
-   if (state->ir_type == PIPE_SHADER_IR_TGSI)
+   if (state->ir_type == PIPE_SHADER_IR_TGSI) {
       hstate->state.shader.tokens = tgsi_dup_tokens(state->prog);
+      hstate->hash = dd_hash_tokens(state->prog);
+   }
 
    return hstate;
 }
@@ -638,6 +651,7 @@ dd_context_destroy(struct pipe_context *_pipe)
       }
    }
    u_log_context_destroy(&dctx->log);
+   FREE(dctx->ring);
 
    pipe->destroy(pipe);
    FREE(dctx);
@@ -716,9 +730,15 @@ dd_context_invalidate_resource(struct pipe_context *_pipe,
 static enum pipe_reset_status
 dd_context_get_device_reset_status(struct pipe_context *_pipe)
 {
-   struct pipe_context *pipe = dd_context(_pipe)->pipe;
+   struct dd_context *dctx = dd_context(_pipe);
+   struct pipe_context *pipe = dctx->pipe;
+   enum pipe_reset_status status = pipe->get_device_reset_status(pipe);
+
+   if (status != PIPE_NO_RESET &&
+       dd_screen(dctx->base.screen)->dump_mode == DD_DUMP_RING)
+      dd_dump_ring(dctx, "GPU reset");
 
-   return pipe->get_device_reset_status(pipe);
+   return status;
 }
 
 static void
@@ -924,8 +944,15 @@ dd_context_create(struct dd_screen *dscreen, struct pipe_context *pipe)
    dd_init_draw_functions(dctx);
 
    u_log_context_init(&dctx->log);
-   if (pipe->set_log_context)
+
+   if (dscreen->dump_mode == DD_DUMP_RING) {
+      /* Driver logs are too expensive to leave on. */
+      dctx->ring = CALLOC(dscreen->ring_size, sizeof(*dctx->ring));
+      if (!dctx->ring)
+         goto fail;
+   } else if (pipe->set_log_context) {
       pipe->set_log_context(pipe, &dctx->log);
+   }
 
    dctx->draw_state.sample_mask = ~0;
 
@@ -941,6 +968,8 @@ dd_context_create(struct dd_screen *dscreen, struct pipe_context *pipe)
    return &dctx->base;
 
 fail:
+   if (dctx)
+      FREE(dctx->ring);
    FREE(dctx);
    pipe->destroy(pipe);
    return NULL;
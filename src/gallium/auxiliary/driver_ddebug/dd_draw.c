@@ -34,6 +34,7 @@
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 #include "util/u_process.h"
+#include "util/u_prim.h"
 #include "tgsi/tgsi_parse.h"
 #include "tgsi/tgsi_scan.h"
 #include "util/os_time.h"
@@ -968,6 +969,7 @@ static void
 dd_maybe_dump_record(struct dd_screen *dscreen, struct dd_draw_record *record)
 {
    if (dscreen->dump_mode == DD_DUMP_ONLY_HANGS ||
+       dscreen->dump_mode == DD_DUMP_RING ||
        (dscreen->dump_mode == DD_DUMP_APITRACE_CALL &&
         dscreen->apitrace_dump_call != record->draw_state.base.apitrace_call_number))
       return;
@@ -1002,7 +1004,7 @@ dd_fence_state(struct pipe_screen *screen, struct pipe_fence_handle *fence,
 }
 
 static void
-dd_report_hang(struct dd_context *dctx)
+dd_report_hung_records(struct dd_context *dctx)
 {
    struct dd_screen *dscreen = dd_screen(dctx->base.screen);
    struct pipe_screen *screen = dscreen->screen;
@@ -1010,8 +1012,6 @@ dd_report_hang(struct dd_context *dctx)
    bool stop_output = false;
    unsigned num_later = 0;
 
-   fprintf(stderr, "GPU hang detected, collecting information...\n\n");
-
    fprintf(stderr, "Draw #   driver  prev BOP  TOP  BOP  dump file\n"
                    "-------------------------------------------------------------\n");
 
@@ -1059,6 +1059,19 @@ dd_report_hang(struct dd_context *dctx)
 
    if (num_later)
       fprintf(stderr, "... and %u additional draws.\n", num_later);
+}
+
+static void
+dd_report_hang(struct dd_context *dctx)
+{
+   struct dd_screen *dscreen = dd_screen(dctx->base.screen);
+
+   fprintf(stderr, "GPU hang detected, collecting information...\n\n");
+
+   if (dscreen->dump_mode == DD_DUMP_RING)
+      dd_dump_ring(dctx, "GPU hang");
+   else
+      dd_report_hung_records(dctx);
 
    char name[512];
    dd_get_debug_filename_and_mkdir(name, sizeof(name), false);
@@ -1265,6 +1278,181 @@ dd_after_draw(struct dd_context *dctx, struct dd_draw_record *record)
               dctx->num_draw_calls);
 }
 
+/********************************************************************
+ * ring
+ */
+
+static const char *
+dd_call_type_name(enum call_type type)
+{
+   switch (type) {
+   case CALL_FLUSH: return "flush";
+   case CALL_DRAW_VBO: return "draw_vbo";
+   case CALL_LAUNCH_GRID: return "launch_grid";
+   case CALL_RESOURCE_COPY_REGION: return "resource_copy_region";
+   case CALL_BLIT: return "blit";
+   case CALL_FLUSH_RESOURCE: return "flush_resource";
+   case CALL_CLEAR: return "clear";
+   case CALL_CLEAR_BUFFER: return "clear_buffer";
+   case CALL_CLEAR_TEXTURE: return "clear_texture";
+   case CALL_CLEAR_RENDER_TARGET: return "clear_render_target";
+   case CALL_CLEAR_DEPTH_STENCIL: return "clear_depth_stencil";
+   case CALL_GENERATE_MIPMAP: return "generate_mipmap";
+   case CALL_GET_QUERY_RESULT_RESOURCE: return "get_query_result_resource";
+   case CALL_TRANSFER_MAP: return "transfer_map";
+   case CALL_TRANSFER_FLUSH_REGION: return "transfer_flush_region";
+   case CALL_TRANSFER_UNMAP: return "transfer_unmap";
+   case CALL_BUFFER_SUBDATA: return "buffer_subdata";
+   case CALL_TEXTURE_SUBDATA: return "texture_subdata";
+   }
+   return "unknown";
+}
+
+static inline bool
+dd_use_ring(struct dd_context *dctx)
+{
+   return dd_screen(dctx->base.screen)->dump_mode == DD_DUMP_RING;
+}
+
+/* Fill the next ring entry with the current state. It's only visible to
+ * dd_dump_ring after dd_ring_end.
+ */
+static struct dd_ring_entry *
+dd_ring_begin(struct dd_context *dctx, enum call_type type)
+{
+   struct dd_screen *dscreen = dd_screen(dctx->base.screen);
+   struct dd_draw_state *dstate = &dctx->draw_state;
+   struct dd_ring_entry *entry =
+      &dctx->ring[dctx->ring_head & (dscreen->ring_size - 1)];
+
+   entry->time = os_time_get_nano();
+   entry->call_number = dctx->num_draw_calls;
+   entry->apitrace_call_number = dstate->apitrace_call_number;
+   entry->type = type;
+
+   for (unsigned i = 0; i < PIPE_SHADER_TYPES; i++) {
+      struct dd_state *shader = dstate->shaders[i];
+
+      entry->shaders[i] = shader ? shader->cso : NULL;
+      entry->shader_hashes[i] = shader ? shader->hash : 0;
+   }
+   entry->velems = dstate->velems ? dstate->velems->cso : NULL;
+   entry->rs = dstate->rs ? dstate->rs->cso : NULL;
+   entry->dsa = dstate->dsa ? dstate->dsa->cso : NULL;
+   entry->blend = dstate->blend ? dstate->blend->cso : NULL;
+
+   memset(&entry->info, 0, sizeof(entry->info));
+   return entry;
+}
+
+static void
+dd_ring_end(struct dd_context *dctx, struct dd_ring_entry *entry)
+{
+   if (entry->type != CALL_FLUSH)
+      dctx->num_draw_calls++;
+
+   /* Publish the entry. This is a full barrier. */
+   p_atomic_inc(&dctx->ring_head);
+}
+
+static void
+dd_write_ring_entry(FILE *f, struct dd_ring_entry *entry, int64_t now)
+{
+   static const char *shader_names[PIPE_SHADER_TYPES] = {
+      [PIPE_SHADER_VERTEX] = "vs",
+      [PIPE_SHADER_FRAGMENT] = "fs",
+      [PIPE_SHADER_GEOMETRY] = "gs",
+      [PIPE_SHADER_TESS_CTRL] = "tcs",
+      [PIPE_SHADER_TESS_EVAL] = "tes",
+      [PIPE_SHADER_COMPUTE] = "cs",
+   };
+
+   fprintf(f, "%-9u %-9u %10.3f  %s", entry->call_number,
+           entry->apitrace_call_number, (now - entry->time) / 1000000.0,
+           dd_call_type_name(entry->type));
+
+   switch (entry->type) {
+   case CALL_DRAW_VBO:
+      fprintf(f, " %s%s index_size=%u start=%u count=%u index_bias=%i "
+              "start_instance=%u instance_count=%u",
+              u_prim_name(entry->info.draw.mode),
+              entry->info.draw.indirect ? " indirect" : "",
+              entry->info.draw.index_size, entry->info.draw.start,
+              entry->info.draw.count, entry->info.draw.index_bias,
+              entry->info.draw.start_instance,
+              entry->info.draw.instance_count);
+      break;
+   case CALL_LAUNCH_GRID:
+      fprintf(f, "%s block=%ux%ux%u grid=%ux%ux%u",
+              entry->info.grid.indirect ? " indirect" : "",
+              entry->info.grid.block[0], entry->info.grid.block[1],
+              entry->info.grid.block[2], entry->info.grid.grid[0],
+              entry->info.grid.grid[1], entry->info.grid.grid[2]);
+      break;
+   case CALL_FLUSH:
+   case CALL_CLEAR:
+      fprintf(f, " 0x%x", entry->info.flags);
+      break;
+   default:
+      break;
+   }
+   fprintf(f, "\n");
+
+   if (entry->type != CALL_DRAW_VBO && entry->type != CALL_LAUNCH_GRID)
+      return;
+
+   fprintf(f, "         ");
+   for (unsigned i = 0; i < PIPE_SHADER_TYPES; i++) {
+      if ((entry->type == CALL_LAUNCH_GRID) != (i == PIPE_SHADER_COMPUTE) ||
+          !entry->shaders[i])
+         continue;
+      fprintf(f, " %s=%p:%08x", shader_names[i], entry->shaders[i],
+              entry->shader_hashes[i]);
+   }
+   if (entry->type == CALL_DRAW_VBO) {
+      fprintf(f, " velems=%p rs=%p dsa=%p blend=%p",
+              entry->velems, entry->rs, entry->dsa, entry->blend);
+   }
+   fprintf(f, "\n");
+}
+
+/* Write the last calls recorded in the ring to a new dump file. This may
+ * be called from any thread.
+ */
+void
+dd_dump_ring(struct dd_context *dctx, const char *reason)
+{
+   struct dd_screen *dscreen = dd_screen(dctx->base.screen);
+   unsigned head = p_atomic_read(&dctx->ring_head);
+   /* The entry at head may be in the middle of being overwritten. */
+   unsigned num = MIN2(head, dscreen->ring_size - 1);
+   int64_t now = os_time_get_nano();
+
+   if (dctx->ring_dumped)
+      return;
+   dctx->ring_dumped = true;
+
+   char name[512];
+   dd_get_debug_filename_and_mkdir(name, sizeof(name), false);
+   FILE *f = fopen(name, "w");
+   if (!f) {
+      fprintf(stderr, "dd: failed to open %s\n", name);
+      return;
+   }
+
+   dd_write_header(f, dscreen->screen, 0);
+   fprintf(f, "%s, last %u calls of context %p, oldest first:\n\n",
+           reason, num, (void *)dctx->pipe);
+   fprintf(f, "Call #    apitrace  ms before  call\n"
+              "-------------------------------------------------------------\n");
+
+   for (unsigned i = head - num; i != head; i++)
+      dd_write_ring_entry(f, &dctx->ring[i & (dscreen->ring_size - 1)], now);
+
+   fclose(f);
+   fprintf(stderr, "dd: %s, last %u calls written to %s\n", reason, num, name);
+}
+
 static void
 dd_context_flush(struct pipe_context *_pipe,
                  struct pipe_fence_handle **fence, unsigned flags)
@@ -1277,6 +1465,12 @@ dd_context_flush(struct pipe_context *_pipe,
    record->call.type = CALL_FLUSH;
    record->call.info.flush.flags = flags;
 
+   if (dd_use_ring(dctx)) {
+      struct dd_ring_entry *entry = dd_ring_begin(dctx, CALL_FLUSH);
+      entry->info.flags = flags;
+      dd_ring_end(dctx, entry);
+   }
+
    record->time_before = os_time_get_nano();
 
    dd_add_record(dctx, record);
@@ -1298,6 +1492,23 @@ dd_context_draw_vbo(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      struct dd_ring_entry *entry = dd_ring_begin(dctx, CALL_DRAW_VBO);
+      entry->info.draw.mode = info->mode;
+      entry->info.draw.index_size = info->index_size;
+      entry->info.draw.start = info->start;
+      entry->info.draw.count = info->count;
+      entry->info.draw.index_bias = info->index_bias;
+      entry->info.draw.start_instance = info->start_instance;
+      entry->info.draw.instance_count = info->instance_count;
+      entry->info.draw.indirect = info->indirect != NULL;
+      dd_ring_end(dctx, entry);
+
+      pipe->draw_vbo(pipe, info);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_DRAW_VBO;
@@ -1336,6 +1547,18 @@ dd_context_launch_grid(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      struct dd_ring_entry *entry = dd_ring_begin(dctx, CALL_LAUNCH_GRID);
+      memcpy(entry->info.grid.block, info->block, sizeof(info->block));
+      memcpy(entry->info.grid.grid, info->grid, sizeof(info->grid));
+      entry->info.grid.indirect = info->indirect != NULL;
+      dd_ring_end(dctx, entry);
+
+      pipe->launch_grid(pipe, info);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_LAUNCH_GRID;
@@ -1357,6 +1580,15 @@ dd_context_resource_copy_region(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_RESOURCE_COPY_REGION));
+      pipe->resource_copy_region(pipe,
+                                 dst, dst_level, dstx, dsty, dstz,
+                                 src, src_level, src_box);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_RESOURCE_COPY_REGION;
@@ -1383,6 +1615,13 @@ dd_context_blit(struct pipe_context *_pipe, const struct pipe_blit_info *info)
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_BLIT));
+      pipe->blit(pipe, info);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_BLIT;
@@ -1408,6 +1647,13 @@ dd_context_generate_mipmap(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_GENERATE_MIPMAP));
+      return pipe->generate_mipmap(pipe, res, format, base_level, last_level,
+                                   first_layer, last_layer);
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
    boolean result;
 
@@ -1439,6 +1685,14 @@ dd_context_get_query_result_resource(struct pipe_context *_pipe,
    struct dd_context *dctx = dd_context(_pipe);
    struct dd_query *dquery = dd_query(query);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_GET_QUERY_RESULT_RESOURCE));
+      pipe->get_query_result_resource(pipe, dquery->query, wait,
+                                      result_type, index, resource, offset);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_GET_QUERY_RESULT_RESOURCE;
@@ -1466,6 +1720,13 @@ dd_context_flush_resource(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_FLUSH_RESOURCE));
+      pipe->flush_resource(pipe, resource);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_FLUSH_RESOURCE;
@@ -1484,6 +1745,16 @@ dd_context_clear(struct pipe_context *_pipe, unsigned buffers,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      struct dd_ring_entry *entry = dd_ring_begin(dctx, CALL_CLEAR);
+      entry->info.flags = buffers;
+      dd_ring_end(dctx, entry);
+
+      pipe->clear(pipe, buffers, color, depth, stencil);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_CLEAR;
@@ -1507,6 +1778,14 @@ dd_context_clear_render_target(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_CLEAR_RENDER_TARGET));
+      pipe->clear_render_target(pipe, dst, color, dstx, dsty, width, height,
+                                render_condition_enabled);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_CLEAR_RENDER_TARGET;
@@ -1526,6 +1805,15 @@ dd_context_clear_depth_stencil(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_CLEAR_DEPTH_STENCIL));
+      pipe->clear_depth_stencil(pipe, dst, clear_flags, depth, stencil,
+                                dstx, dsty, width, height,
+                                render_condition_enabled);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_CLEAR_DEPTH_STENCIL;
@@ -1544,6 +1832,14 @@ dd_context_clear_buffer(struct pipe_context *_pipe, struct pipe_resource *res,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_CLEAR_BUFFER));
+      pipe->clear_buffer(pipe, res, offset, size, clear_value,
+                         clear_value_size);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_CLEAR_BUFFER;
@@ -1568,6 +1864,13 @@ dd_context_clear_texture(struct pipe_context *_pipe,
 {
    struct dd_context *dctx = dd_context(_pipe);
    struct pipe_context *pipe = dctx->pipe;
+
+   if (dd_use_ring(dctx)) {
+      dd_ring_end(dctx, dd_ring_begin(dctx, CALL_CLEAR_TEXTURE));
+      pipe->clear_texture(pipe, res, level, box, data);
+      return;
+   }
+
    struct dd_draw_record *record = dd_create_record(dctx);
 
    record->call.type = CALL_CLEAR_TEXTURE;
@@ -43,6 +43,7 @@ enum dd_dump_mode {
    DD_DUMP_ONLY_HANGS,
    DD_DUMP_ALL_CALLS,
    DD_DUMP_APITRACE_CALL,
+   DD_DUMP_RING,
 };
 
 struct dd_screen
@@ -56,6 +57,7 @@ struct dd_screen
    bool verbose;
    unsigned skip_count;
    unsigned apitrace_dump_call;
+   unsigned ring_size; /* power of two, for DD_DUMP_RING */
 };
 
 enum call_type
@@ -202,6 +204,7 @@ struct dd_query
 struct dd_state
 {
    void *cso;
+   uint32_t hash; /* of the TGSI tokens of shaders, 0 otherwise */
 
    union {
       struct pipe_blend_state blend;
@@ -272,6 +275,44 @@ struct dd_draw_state_copy
    struct dd_state blend;
 };
 
+/* Compact description of a call, recorded into dd_context::ring in
+ * DD_DUMP_RING mode instead of a full dd_draw_record.
+ */
+struct dd_ring_entry
+{
+   int64_t time;
+   unsigned call_number;
+   unsigned apitrace_call_number;
+   enum call_type type;
+
+   /* Driver CSOs bound at the time of the call */
+   void *shaders[PIPE_SHADER_TYPES];
+   uint32_t shader_hashes[PIPE_SHADER_TYPES];
+   void *velems;
+   void *rs;
+   void *dsa;
+   void *blend;
+
+   union {
+      struct {
+         unsigned mode;
+         unsigned index_size;
+         unsigned start;
+         unsigned count;
+         int index_bias;
+         unsigned start_instance;
+         unsigned instance_count;
+         bool indirect;
+      } draw;
+      struct {
+         unsigned block[3];
+         unsigned grid[3];
+         bool indirect;
+      } grid;
+      unsigned flags; /* flush flags or cleared buffers */
+   } info;
+};
+
 struct dd_draw_record {
    struct list_head list;
    struct dd_context *dctx;
@@ -320,6 +361,14 @@ struct dd_context
    unsigned num_records;
    bool kill_thread;
    bool api_stalled;
+
+   /* DD_DUMP_RING: the last ring_size calls. Only the API thread writes
+    * entries, and ring_head is only incremented once an entry is complete,
+    * so the ring can be dumped from any thread without locking.
+    */
+   struct dd_ring_entry *ring;
+   unsigned ring_head;
+   bool ring_dumped;
 };
 
 
@@ -329,6 +378,9 @@ dd_context_create(struct dd_screen *dscreen, struct pipe_context *pipe);
 void
 dd_init_draw_functions(struct dd_context *dctx);
 
+void
+dd_dump_ring(struct dd_context *dctx, const char *reason);
+
 void
 dd_thread_join(struct dd_context *dctx);
 int
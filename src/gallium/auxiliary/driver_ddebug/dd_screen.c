@@ -28,6 +28,7 @@
 #include "dd_pipe.h"
 #include "dd_public.h"
 #include "util/u_memory.h"
+#include "util/u_math.h"
 #include <ctype.h>
 #include <stdio.h>
 
@@ -464,8 +465,9 @@ ddebug_screen_create(struct pipe_screen *screen)
       puts("");
       puts("Usage:");
       puts("");
-      puts("  GALLIUM_DDEBUG=\"[<timeout in ms>] [(always|apitrace <call#)] [flush] [transfers] [verbose]\"");
+      puts("  GALLIUM_DDEBUG=\"[<timeout in ms>] [(always|apitrace <call#>|ring)] [flush] [transfers] [verbose]\"");
       puts("  GALLIUM_DDEBUG_SKIP=[count]");
+      puts("  GALLIUM_DDEBUG_RING_SIZE=[count]");
       puts("");
       puts("Dump context and driver information of draw calls into");
       puts("$HOME/"DD_DIR"/. By default, watch for GPU hangs and only dump information");
@@ -485,6 +487,13 @@ ddebug_screen_create(struct pipe_screen *screen)
       puts("  Dump information about the draw call corresponding to the given");
       puts("  apitrace call number and exit.");
       puts("");
+      puts("ring");
+      puts("  Only record a compact description of each call (shader hashes, state");
+      puts("  objects and draw parameters) into a ring buffer, cheap enough to");
+      puts("  leave enabled. The ring is dumped when a GPU hang is detected or");
+      puts("  when a GPU reset is reported to the application. 'flush' and");
+      puts("  'transfers' are ignored.");
+      puts("");
       puts("flush");
       puts("  Flush after every draw call.");
       puts("");
@@ -494,6 +503,9 @@ ddebug_screen_create(struct pipe_screen *screen)
       puts("GALLIUM_DDEBUG_SKIP=count");
       puts("  Skip dumping on the first count draw calls (only relevant with 'always').");
       puts("");
+      puts("GALLIUM_DDEBUG_RING_SIZE=count");
+      puts("  Number of calls kept in the ring (only relevant with 'ring', default=4096).");
+      puts("");
       exit(0);
    }
 
@@ -509,6 +521,13 @@ ddebug_screen_create(struct pipe_screen *screen)
          }
 
          mode = DD_DUMP_ALL_CALLS;
+      } else if (match_word(&option, "ring")) {
+         if (mode != DD_DUMP_ONLY_HANGS) {
+            printf("ddebug: 'ring' can't be mixed with 'always' or 'apitrace'\n");
+            exit(1);
+         }
+
+         mode = DD_DUMP_RING;
       } else if (match_word(&option, "flush")) {
          flush = true;
       } else if (match_word(&option, "transfers")) {
@@ -590,6 +609,14 @@ ddebug_screen_create(struct pipe_screen *screen)
    dscreen->verbose = verbose;
    dscreen->apitrace_dump_call = apitrace_dump_call;
 
+   if (dscreen->dump_mode == DD_DUMP_RING) {
+      /* Everything but flushes goes into the ring. */
+      dscreen->flush_always = false;
+      dscreen->transfers = false;
+      dscreen->ring_size = util_next_power_of_two(
+         MAX2(debug_get_num_option("GALLIUM_DDEBUG_RING_SIZE", 4096), 2));
+   }
+
    switch (dscreen->dump_mode) {
    case DD_DUMP_ALL_CALLS:
       fprintf(stderr, "Gallium debugger active. Logging all calls.\n");
@@ -597,6 +624,10 @@ ddebug_screen_create(struct pipe_screen *screen)
    case DD_DUMP_APITRACE_CALL:
       fprintf(stderr, "Gallium debugger active. Going to dump an apitrace call.\n");
       break;
+   case DD_DUMP_RING:
+      fprintf(stderr, "Gallium debugger active. Recording the last %u calls.\n",
+              dscreen->ring_size);
+      break;
    default:
       fprintf(stderr, "Gallium debugger active.\n");
       break;
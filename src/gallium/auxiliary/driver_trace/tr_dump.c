@@ -45,9 +45,12 @@
 
 #include "pipe/p_compiler.h"
 #include "os/os_thread.h"
+#include "util/hash_table.h"
+#include "util/mesa-sha1.h"
 #include "util/os_time.h"
 #include "util/u_debug.h"
 #include "util/u_memory.h"
+#include "util/u_queue.h"
 #include "util/u_string.h"
 #include "util/u_math.h"
 #include "util/u_format.h"
@@ -64,11 +67,120 @@ static long unsigned call_no = 0;
 static boolean dumping = FALSE;
 
 
+/*
+ * Asynchronous writer.
+ *
+ * Unless GALLIUM_TRACE_SYNC is set, the trace is collected into a few large
+ * buffers, which a writer thread writes out while the next one fills up.
+ * The trace then no longer survives a crash of the traced application,
+ * which is what GALLIUM_TRACE_SYNC is for.
+ */
+
+#define TRACE_BUFFER_SIZE (1024 * 1024)
+#define TRACE_NUM_BUFFERS 4
+
+struct trace_buffer {
+   struct util_queue_fence fence;
+   size_t size;
+   char data[TRACE_BUFFER_SIZE];
+};
+
+static boolean writer_async = FALSE;
+static struct util_queue writer_queue;
+static struct trace_buffer *buffers[TRACE_NUM_BUFFERS];
+static unsigned current_buffer = 0;
+
+
+static void
+trace_buffer_write(void *job, int thread_index)
+{
+   struct trace_buffer *buf = job;
+
+   fwrite(buf->data, buf->size, 1, stream);
+}
+
+
+static boolean
+trace_writer_init(void)
+{
+   unsigned i;
+
+   for (i = 0; i < TRACE_NUM_BUFFERS; ++i) {
+      buffers[i] = MALLOC_STRUCT(trace_buffer);
+      if (!buffers[i])
+         goto fail;
+      buffers[i]->size = 0;
+      util_queue_fence_init(&buffers[i]->fence);
+   }
+
+   if (!util_queue_init(&writer_queue, "trace", TRACE_NUM_BUFFERS, 1,
+                        UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY))
+      goto fail;
+
+   return TRUE;
+
+fail:
+   for (i = 0; i < TRACE_NUM_BUFFERS; ++i) {
+      FREE(buffers[i]);
+      buffers[i] = NULL;
+   }
+   return FALSE;
+}
+
+
+/* Hand the current buffer to the writer thread and switch to the next one */
+static void
+trace_writer_submit(void)
+{
+   struct trace_buffer *buf = buffers[current_buffer];
+
+   if (!buf->size)
+      return;
+
+   util_queue_add_job(&writer_queue, buf, &buf->fence,
+                      trace_buffer_write, NULL);
+
+   current_buffer = (current_buffer + 1) % TRACE_NUM_BUFFERS;
+   buf = buffers[current_buffer];
+   util_queue_fence_wait(&buf->fence);
+   buf->size = 0;
+}
+
+
+static void
+trace_writer_finish(void)
+{
+   unsigned i;
+
+   trace_writer_submit();
+
+   for (i = 0; i < TRACE_NUM_BUFFERS; ++i)
+      util_queue_fence_wait(&buffers[i]->fence);
+}
+
+
 static inline void
 trace_dump_write(const char *buf, size_t size)
 {
-   if (stream) {
+   if (!stream)
+      return;
+
+   if (!writer_async) {
       fwrite(buf, size, 1, stream);
+      return;
+   }
+
+   while (size) {
+      struct trace_buffer *cur = buffers[current_buffer];
+      size_t n = MIN2(size, TRACE_BUFFER_SIZE - cur->size);
+
+      memcpy(cur->data + cur->size, buf, n);
+      cur->size += n;
+      buf += n;
+      size -= n;
+
+      if (cur->size == TRACE_BUFFER_SIZE)
+         trace_writer_submit();
    }
 }
 
@@ -166,7 +278,10 @@ trace_dump_tag_end(const char *name)
 void
 trace_dump_trace_flush(void)
 {
-   if (stream) {
+   /* Flushing is for catching the calls before a crash, which the
+    * asynchronous writer gives up on anyway.
+    */
+   if (stream && !writer_async) {
       fflush(stream);
    }
 }
@@ -176,6 +291,10 @@ trace_dump_trace_close(void)
 {
    if (stream) {
       trace_dump_writes("</trace>\n");
+      if (writer_async) {
+         trace_writer_finish();
+         fflush(stream);
+      }
       if (close_stream) {
          fclose(stream);
          close_stream = FALSE;
@@ -225,6 +344,9 @@ trace_dump_trace_begin(void)
             return FALSE;
       }
 
+      if (!debug_get_bool_option("GALLIUM_TRACE_SYNC", FALSE))
+         writer_async = trace_writer_init();
+
       trace_dump_writes("<?xml version='1.0' encoding='UTF-8'?>\n");
       trace_dump_writes("<?xml-stylesheet type='text/xsl' href='trace.xsl'?>\n");
       trace_dump_writes("<trace version='0.1'>\n");
@@ -338,7 +460,8 @@ void trace_dump_call_end_locked(void)
    trace_dump_indent(1);
    trace_dump_tag_end("call");
    trace_dump_newline();
-   fflush(stream);
+   if (!writer_async)
+      fflush(stream);
 }
 
 void trace_dump_call_begin(const char *klass, const char *method)
@@ -421,17 +544,83 @@ void trace_dump_float(double value)
    trace_dump_writef("<float>%g</float>", value);
 }
 
+/*
+ * Blobs of at least this size are dumped only once, later dumps of the same
+ * contents refer back to the first one by id.
+ */
+#define TRACE_BLOB_DEDUP_SIZE 64
+
+static struct hash_table *blob_ids = NULL;
+static unsigned blob_count = 0;
+
+static uint32_t
+blob_key_hash(const void *key)
+{
+   return *(const uint32_t *)key;
+}
+
+static bool
+blob_key_equal(const void *a, const void *b)
+{
+   return memcmp(a, b, 20) == 0;
+}
+
+/* Returns the id of an earlier blob with the same contents, or 0 after
+ * assigning a new id in *id.
+ */
+static unsigned
+trace_dump_blob_lookup(const void *data, size_t size, unsigned *id)
+{
+   struct hash_entry *entry;
+   unsigned char sha1[20];
+   unsigned char *key;
+
+   if (!blob_ids) {
+      blob_ids = _mesa_hash_table_create(NULL, blob_key_hash, blob_key_equal);
+      if (!blob_ids)
+         return 0;
+   }
+
+   _mesa_sha1_compute(data, size, sha1);
+
+   entry = _mesa_hash_table_search(blob_ids, sha1);
+   if (entry)
+      return (unsigned)(uintptr_t)entry->data;
+
+   key = MALLOC(sizeof(sha1));
+   if (!key)
+      return 0;
+
+   memcpy(key, sha1, sizeof(sha1));
+   *id = ++blob_count;
+   _mesa_hash_table_insert(blob_ids, key, (void *)(uintptr_t)*id);
+   return 0;
+}
+
 void trace_dump_bytes(const void *data,
                       size_t size)
 {
    static const char hex_table[16] = "0123456789ABCDEF";
    const uint8_t *p = data;
+   unsigned id = 0;
    size_t i;
 
    if (!dumping)
       return;
 
-   trace_dump_writes("<bytes>");
+   if (size >= TRACE_BLOB_DEDUP_SIZE) {
+      unsigned ref = trace_dump_blob_lookup(data, size, &id);
+
+      if (ref) {
+         trace_dump_writef("<bytes ref='%u'/>", ref);
+         return;
+      }
+   }
+
+   if (id)
+      trace_dump_writef("<bytes id='%u'>", id);
+   else
+      trace_dump_writes("<bytes>");
    for(i = 0; i < size; ++i) {
       uint8_t byte = *p++;
       char hex[2];
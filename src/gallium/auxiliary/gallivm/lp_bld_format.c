@@ -26,6 +26,8 @@
  **************************************************************************/
 
 
+#include "util/u_format.h"
+
 #include "lp_bld_format.h"
 
 
@@ -54,3 +56,41 @@ lp_build_format_cache_type(struct gallivm_state *gallivm)
 
    return s;
 }
+
+
+/**
+ * Whether a block compressed format other than S3TC can be fetched through
+ * the block cache, that is unpacked a 4x4 block at a time to RGBA8 without
+ * losing precision.
+ *
+ * sRGB formats are not, callers can fetch them as their linear variant and
+ * do the sRGB conversion themselves.  This keeps cached blocks the same no
+ * matter which of the formats a texture is viewed as.
+ */
+boolean
+lp_build_format_cacheable(const struct util_format_description *format_desc)
+{
+   if (format_desc->block.width != 4 ||
+       format_desc->block.height != 4 ||
+       format_desc->colorspace == UTIL_FORMAT_COLORSPACE_SRGB ||
+       !format_desc->unpack_rgba_8unorm)
+      return FALSE;
+
+   switch (format_desc->layout) {
+   case UTIL_FORMAT_LAYOUT_RGTC:
+   case UTIL_FORMAT_LAYOUT_BPTC:
+      return util_format_fits_8unorm(format_desc);
+   case UTIL_FORMAT_LAYOUT_ETC:
+      switch (format_desc->format) {
+      case PIPE_FORMAT_ETC1_RGB8:
+      case PIPE_FORMAT_ETC2_RGB8:
+      case PIPE_FORMAT_ETC2_RGB8A1:
+      case PIPE_FORMAT_ETC2_RGBA8:
+         return TRUE;
+      default:
+         return FALSE;
+      }
+   default:
+      return FALSE;
+   }
+}
@@ -36,6 +36,7 @@
 
 #include "util/u_format.h"
 #include "util/u_math.h"
+#include "util/u_pointer.h"
 #include "util/u_string.h"
 #include "util/u_cpu_detect.h"
 #include "util/u_debug.h"
@@ -1993,6 +1994,71 @@ update_cached_block(struct gallivm_state *gallivm,
    LLVMSetInstructionCallConv(inst, LLVMFastCallConv);
 }
 
+/**
+ * Fill a cache entry for formats without a JIT block decoder.  util_format
+ * unpacks the whole block in one call, which is what makes this worthwhile
+ * compared to fetching texels one by one, and the rows it returns are
+ * transposed to the column-major layout the cache uses.
+ */
+static void
+update_cached_block_unpack(struct gallivm_state *gallivm,
+                           const struct util_format_description *format_desc,
+                           LLVMValueRef ptr_addr,
+                           LLVMValueRef hash_index,
+                           LLVMValueRef cache)
+{
+   LLVMBuilderRef builder = gallivm->builder;
+   LLVMTypeRef i8t = LLVMInt8TypeInContext(gallivm->context);
+   LLVMTypeRef pi8t = LLVMPointerType(i8t, 0);
+   LLVMTypeRef i32t = LLVMInt32TypeInContext(gallivm->context);
+   LLVMTypeRef i32x4t = LLVMVectorType(i32t, 4);
+   LLVMTypeRef arg_types[6];
+   LLVMValueRef function, tmp_ptr, rows_ptr, tag_value;
+   LLVMValueRef args[6], rows[4], col[4];
+   unsigned k;
+
+   /*
+    * Function to call looks like:
+    *   unpack(uint8_t *dst, unsigned dst_stride,
+    *          const uint8_t *src, unsigned src_stride,
+    *          unsigned width, unsigned height)
+    */
+   arg_types[0] = pi8t;
+   arg_types[1] = i32t;
+   arg_types[2] = pi8t;
+   arg_types[3] = i32t;
+   arg_types[4] = i32t;
+   arg_types[5] = i32t;
+   function = lp_build_const_func_pointer(gallivm,
+                                          func_to_pointer((func_pointer) format_desc->unpack_rgba_8unorm),
+                                          LLVMVoidTypeInContext(gallivm->context),
+                                          arg_types, ARRAY_SIZE(arg_types),
+                                          format_desc->short_name);
+
+   tmp_ptr = lp_build_alloca(gallivm, LLVMArrayType(i32x4t, 4), "");
+
+   args[0] = LLVMBuildBitCast(builder, tmp_ptr, pi8t, "");
+   args[1] = lp_build_const_int32(gallivm, 4 * sizeof(uint32_t));
+   args[2] = ptr_addr;
+   args[3] = lp_build_const_int32(gallivm, format_desc->block.bits / 8);
+   args[4] = lp_build_const_int32(gallivm, format_desc->block.width);
+   args[5] = lp_build_const_int32(gallivm, format_desc->block.height);
+   LLVMBuildCall(builder, function, args, ARRAY_SIZE(args), "");
+
+   rows_ptr = LLVMBuildBitCast(builder, tmp_ptr,
+                               LLVMPointerType(i32x4t, 0), "");
+   for (k = 0; k < 4; k++) {
+      LLVMValueRef index = lp_build_const_int32(gallivm, k);
+      LLVMValueRef ptr = LLVMBuildGEP(builder, rows_ptr, &index, 1, "");
+      rows[k] = LLVMBuildLoad(builder, ptr, "");
+   }
+   lp_build_transpose_aos(gallivm, lp_type_uint_vec(32, 128), rows, col);
+
+   tag_value = LLVMBuildPtrToInt(builder, ptr_addr,
+                                 LLVMInt64TypeInContext(gallivm->context), "");
+   s3tc_store_cached_block(gallivm, col, tag_value, hash_index, cache);
+}
+
 /*
  * cached lookup
  */
@@ -2016,6 +2082,13 @@ compressed_fetch_cached(struct gallivm_state *gallivm,
    LLVMTypeRef i64t = LLVMInt64TypeInContext(gallivm->context);
    struct lp_type type;
    struct lp_build_context bld32;
+   void (*update_block)(struct gallivm_state *,
+                        const struct util_format_description *,
+                        LLVMValueRef, LLVMValueRef, LLVMValueRef);
+
+   update_block = format_desc->layout == UTIL_FORMAT_LAYOUT_S3TC ?
+                  update_cached_block : update_cached_block_unpack;
+
    memset(&type, 0, sizeof type);
    type.width = 32;
    type.length = n;
@@ -2080,7 +2153,7 @@ compressed_fetch_cached(struct gallivm_state *gallivm,
          {
             ptr_addrx = LLVMBuildIntToPtr(builder, addrx,
                                           LLVMPointerType(i8t, 0), "");
-            update_cached_block(gallivm, format_desc, ptr_addrx, hash_indexx, cache);
+            update_block(gallivm, format_desc, ptr_addrx, hash_indexx, cache);
 #if LP_BUILD_FORMAT_CACHE_DEBUG
             s3tc_update_cache_access(gallivm, cache, 1,
                                      LP_BUILD_FORMAT_CACHE_MEMBER_ACCESS_MISS);
@@ -2106,7 +2179,7 @@ compressed_fetch_cached(struct gallivm_state *gallivm,
       lp_build_if(&if_ctx, gallivm, cond);
       {
          tmp = LLVMBuildIntToPtr(builder, addr, LLVMPointerType(i8t, 0), "");
-         update_cached_block(gallivm, format_desc, tmp, hash_index, cache);
+         update_block(gallivm, format_desc, tmp, hash_index, cache);
 #if LP_BUILD_FORMAT_CACHE_DEBUG
          s3tc_update_cache_access(gallivm, cache, 1,
                                   LP_BUILD_FORMAT_CACHE_MEMBER_ACCESS_MISS);
@@ -2124,6 +2197,34 @@ compressed_fetch_cached(struct gallivm_state *gallivm,
 }
 
 
+/**
+ * Fetch texels of a block compressed format through the decoded block cache.
+ * Misses decode a whole block into the cache, with JIT code for S3TC and
+ * with util_format's unpack_rgba_8unorm for everything else.
+ *
+ * @param n  number of pixels processed
+ * @param offset <n x i32> vector with the relative offsets of the blocks
+ * @param i, j  <n x i32> vectors with the x and y coordinates within the block
+ * @return  a <4*n x i8> vector with the pixel RGBA values in AoS
+ */
+LLVMValueRef
+lp_build_fetch_cached_texels(struct gallivm_state *gallivm,
+                             const struct util_format_description *format_desc,
+                             unsigned n,
+                             LLVMValueRef base_ptr,
+                             LLVMValueRef offset,
+                             LLVMValueRef i,
+                             LLVMValueRef j,
+                             LLVMValueRef cache)
+{
+   assert(format_desc->layout == UTIL_FORMAT_LAYOUT_S3TC ||
+          lp_build_format_cacheable(format_desc));
+
+   return compressed_fetch_cached(gallivm, format_desc, n,
+                                  base_ptr, offset, i, j, cache);
+}
+
+
 static LLVMValueRef
 s3tc_dxt5_to_rgba_aos(struct gallivm_state *gallivm,
                       unsigned n,
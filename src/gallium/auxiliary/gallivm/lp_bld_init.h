@@ -39,6 +39,22 @@
 extern "C" {
 #endif
 
+/**
+ * Object code of a compiled module, to be stored in / loaded from a
+ * shader cache.
+ *
+ * If data_size is non-zero when creating the gallivm state, the object
+ * code is loaded from data instead of optimizing and compiling the
+ * module.  Otherwise data receives the object code once compiled, unless
+ * dont_cache gets set because the IR refers to process-specific addresses.
+ */
+struct lp_cached_code {
+   void *data;
+   size_t data_size;
+   boolean dont_cache;
+   void *jit_obj_cache;
+};
+
 struct gallivm_state
 {
    char *module_name;
@@ -50,6 +66,8 @@ struct gallivm_state
    LLVMBuilderRef builder;
    LLVMMCJITMemoryManagerRef memorymgr;
    struct lp_generated_code *code;
+   struct lp_cached_code *cache;
+   boolean no_opt;    /**< skip the optimization passes, quick codegen */
    unsigned compiled;
 };
 
@@ -59,7 +77,11 @@ lp_build_init(void);
 
 
 struct gallivm_state *
-gallivm_create(const char *name, LLVMContextRef context);
+gallivm_create(const char *name, LLVMContextRef context,
+               struct lp_cached_code *cache);
+
+struct gallivm_state *
+gallivm_create_no_opt(const char *name, LLVMContextRef context);
 
 void
 gallivm_destroy(struct gallivm_state *gallivm);
@@ -118,6 +118,7 @@ lp_sampler_static_texture_state(struct lp_static_texture_state *state,
    state->pot_height        = util_is_power_of_two_or_zero(texture->height0);
    state->pot_depth         = util_is_power_of_two_or_zero(texture->depth0);
    state->level_zero_only   = !view->u.tex.last_level;
+   state->tiled             = !!(texture->flags & LP_RESOURCE_FLAG_TILED);
 
    /*
     * the layer / element / level parameters are all either dynamic
@@ -196,6 +197,19 @@ lp_sampler_static_sampler_state(struct lp_static_sampler_state *state,
    }
 
    state->normalized_coords = sampler->normalized_coords;
+
+   /*
+    * Anisotropic filtering only changes anything if there's a lod to
+    * compute, and is only done on top of linear minification.
+    */
+   if (sampler->max_anisotropy > 1 &&
+       sampler->normalized_coords &&
+       state->min_img_filter == PIPE_TEX_FILTER_LINEAR &&
+       (state->min_mip_filter != PIPE_TEX_MIPFILTER_NONE ||
+        state->min_img_filter != state->mag_img_filter) &&
+       !state->min_max_lod_equal) {
+      state->aniso = MIN2(sampler->max_anisotropy, 16);
+   }
 }
 
 
@@ -680,6 +694,101 @@ lp_build_ilog2_sqrt(struct lp_build_context *bld,
 }
 
 
+/**
+ * Generate code to compute the footprint for anisotropic filtering of a
+ * (non-cube) 2d texture.
+ * The pixel footprint is approximated by the ellipse spanned by the x and y
+ * derivative vectors. The ratio of the longer (major) to the shorter one,
+ * capped at the sampler's max anisotropy, gives the number of probes taken
+ * along the major axis, and the lod is chosen for the length of the major
+ * axis divided by the number of probes.
+ *
+ * Sets bld->aniso_taps and bld->aniso_axis, returns rho squared in
+ * bld->lodf format.
+ */
+static LLVMValueRef
+lp_build_aniso_rho(struct lp_build_sample_context *bld,
+                   unsigned texture_unit,
+                   LLVMValueRef s,
+                   LLVMValueRef t,
+                   const struct lp_derivatives *derivs)
+{
+   struct gallivm_state *gallivm = bld->gallivm;
+   struct lp_build_context *int_size_bld = &bld->int_size_in_bld;
+   struct lp_build_context *coord_bld = &bld->coord_bld;
+   LLVMValueRef first_level, first_level_vec, int_size, float_size;
+   LLVMValueRef width, height;
+   LLVMValueRef dsdx, dtdx, dsdy, dtdy;
+   LLVMValueRef tmps, tmpt, px2, py2, pmax2, pmin2;
+   LLVMValueRef x_major, taps, max_aniso, rho;
+
+   first_level = bld->dynamic_state->first_level(bld->dynamic_state, bld->gallivm,
+                                                 bld->context_ptr, texture_unit);
+   first_level_vec = lp_build_broadcast_scalar(int_size_bld, first_level);
+   int_size = lp_build_minify(int_size_bld, bld->int_size, first_level_vec, TRUE);
+   float_size = lp_build_int_to_float(&bld->float_size_in_bld, int_size);
+   width = lp_build_extract_broadcast(gallivm, bld->float_size_in_type,
+                                      coord_bld->type, float_size,
+                                      lp_build_const_int32(gallivm, 0));
+   height = lp_build_extract_broadcast(gallivm, bld->float_size_in_type,
+                                       coord_bld->type, float_size,
+                                       lp_build_const_int32(gallivm, 1));
+
+   if (derivs) {
+      dsdx = derivs->ddx[0];
+      dtdx = derivs->ddx[1];
+      dsdy = derivs->ddy[0];
+      dtdy = derivs->ddy[1];
+   }
+   else {
+      dsdx = lp_build_ddx(coord_bld, s);
+      dtdx = lp_build_ddx(coord_bld, t);
+      dsdy = lp_build_ddy(coord_bld, s);
+      dtdy = lp_build_ddy(coord_bld, t);
+   }
+
+   /* squared lengths of the derivative vectors, in texels */
+   tmps = lp_build_mul(coord_bld, dsdx, width);
+   tmpt = lp_build_mul(coord_bld, dtdx, height);
+   px2 = lp_build_add(coord_bld, lp_build_mul(coord_bld, tmps, tmps),
+                      lp_build_mul(coord_bld, tmpt, tmpt));
+   tmps = lp_build_mul(coord_bld, dsdy, width);
+   tmpt = lp_build_mul(coord_bld, dtdy, height);
+   py2 = lp_build_add(coord_bld, lp_build_mul(coord_bld, tmps, tmps),
+                      lp_build_mul(coord_bld, tmpt, tmpt));
+
+   x_major = lp_build_cmp(coord_bld, PIPE_FUNC_GREATER, px2, py2);
+   pmax2 = lp_build_select(coord_bld, x_major, px2, py2);
+   pmin2 = lp_build_select(coord_bld, x_major, py2, px2);
+
+   /*
+    * Minor axis is clamped to one texel, so magnified or barely minified
+    * footprints don't spend probes all within the same texel (this also
+    * avoids the division by zero).
+    */
+   pmin2 = lp_build_max(coord_bld, pmin2, coord_bld->one);
+   max_aniso = lp_build_const_vec(gallivm, coord_bld->type,
+                                  (float)bld->static_sampler_state->aniso);
+   taps = lp_build_sqrt(coord_bld, lp_build_div(coord_bld, pmax2, pmin2));
+   taps = lp_build_ceil(coord_bld, taps);
+   taps = lp_build_clamp(coord_bld, taps, coord_bld->one, max_aniso);
+
+   /* skipping sqrt hence returning rho squared */
+   rho = lp_build_div(coord_bld, pmax2, lp_build_mul(coord_bld, taps, taps));
+
+   bld->aniso_taps = taps;
+   bld->aniso_axis[0] = lp_build_select(coord_bld, x_major, dsdx, dsdy);
+   bld->aniso_axis[1] = lp_build_select(coord_bld, x_major, dtdx, dtdy);
+
+   if (bld->lodf_bld.type.length != coord_bld->type.length) {
+      rho = lp_build_pack_aos_scalars(gallivm, coord_bld->type,
+                                      bld->lodf_bld.type, rho, 0);
+   }
+
+   return rho;
+}
+
+
 /**
  * Generate code to compute texture level of detail (lambda).
  * \param derivs  partial derivatives of (s, t, r, q) with respect to X and Y
@@ -758,10 +867,19 @@ lp_build_lod_selector(struct lp_build_sample_context *bld,
       }
       else {
          LLVMValueRef rho;
+         boolean aniso = bld->static_sampler_state->aniso &&
+                         bld->dims == 2 && !cube_rho &&
+                         bld->static_texture_state->target != PIPE_TEXTURE_CUBE &&
+                         bld->static_texture_state->target != PIPE_TEXTURE_CUBE_ARRAY;
          boolean rho_squared = (bld->no_rho_approx &&
-                                (bld->dims > 1)) || cube_rho;
+                                (bld->dims > 1)) || cube_rho || aniso;
 
-         rho = lp_build_rho(bld, texture_unit, s, t, r, cube_rho, derivs);
+         if (aniso) {
+            rho = lp_build_aniso_rho(bld, texture_unit, s, t, derivs);
+         }
+         else {
+            rho = lp_build_rho(bld, texture_unit, s, t, r, cube_rho, derivs);
+         }
 
          /*
           * Compute lod = log2(rho)
@@ -2023,6 +2141,78 @@ lp_build_sample_partial_offset(struct lp_build_context *bld,
 }
 
 
+/**
+ * Same as lp_build_sample_partial_offset(), but for textures using the
+ * tiled layout (see LP_TEXTURE_TILE_WIDTH).
+ *
+ * The tiled offset of a texel is still the sum of a part depending only on
+ * x and a part depending only on y, which is what makes this possible.
+ *
+ * @param axis  0 for x, 1 for y
+ */
+void
+lp_build_sample_partial_offset_tiled(struct lp_build_context *bld,
+                                     unsigned axis,
+                                     unsigned block_length,
+                                     LLVMValueRef coord,
+                                     LLVMValueRef stride,
+                                     LLVMValueRef *out_offset,
+                                     LLVMValueRef *out_subcoord)
+{
+   LLVMBuilderRef builder = bld->gallivm->builder;
+   const unsigned tile_width_shift = util_logbase2(LP_TEXTURE_TILE_WIDTH);
+   const unsigned tile_height_shift = util_logbase2(LP_TEXTURE_TILE_HEIGHT);
+   LLVMValueRef offset, tile, within;
+
+   assert(axis < 2);
+
+   if (axis == 0) {
+      /* byte offset in the row -> (x / 16) * 64 + x % 16 */
+      lp_build_sample_partial_offset(bld, block_length, coord, stride,
+                                     &offset, out_subcoord);
+      tile = LLVMBuildLShr(builder, offset,
+                           lp_build_const_int_vec(bld->gallivm, bld->type,
+                                                  tile_width_shift), "");
+      tile = LLVMBuildShl(builder, tile,
+                          lp_build_const_int_vec(bld->gallivm, bld->type,
+                                                 tile_width_shift +
+                                                 tile_height_shift), "");
+      within = LLVMBuildAnd(builder, offset,
+                            lp_build_const_int_vec(bld->gallivm, bld->type,
+                                                   LP_TEXTURE_TILE_WIDTH - 1), "");
+      *out_offset = LLVMBuildOr(builder, tile, within, "");
+      return;
+   }
+
+   if (block_length == 1) {
+      *out_subcoord = bld->zero;
+   }
+   else {
+      unsigned logbase2 = util_logbase2(block_length);
+      LLVMValueRef block_shift = lp_build_const_int_vec(bld->gallivm, bld->type, logbase2);
+      LLVMValueRef block_mask = lp_build_const_int_vec(bld->gallivm, bld->type, block_length - 1);
+      *out_subcoord = LLVMBuildAnd(builder, coord, block_mask, "");
+      coord = LLVMBuildLShr(builder, coord, block_shift, "");
+   }
+
+   /* row -> (y / 4) * 4 * stride + (y % 4) * 16 */
+   tile = LLVMBuildLShr(builder, coord,
+                        lp_build_const_int_vec(bld->gallivm, bld->type,
+                                               tile_height_shift), "");
+   stride = LLVMBuildShl(builder, stride,
+                         lp_build_const_int_vec(bld->gallivm, bld->type,
+                                                tile_height_shift), "");
+   tile = lp_build_mul(bld, tile, stride);
+   within = LLVMBuildAnd(builder, coord,
+                         lp_build_const_int_vec(bld->gallivm, bld->type,
+                                                LP_TEXTURE_TILE_HEIGHT - 1), "");
+   within = LLVMBuildShl(builder, within,
+                         lp_build_const_int_vec(bld->gallivm, bld->type,
+                                                tile_width_shift), "");
+   *out_offset = LLVMBuildAdd(builder, tile, within, "");
+}
+
+
 /**
  * Compute the offset of a pixel block.
  *
@@ -2033,6 +2223,7 @@ lp_build_sample_partial_offset(struct lp_build_context *bld,
 void
 lp_build_sample_offset(struct lp_build_context *bld,
                        const struct util_format_description *format_desc,
+                       boolean tiled,
                        LLVMValueRef x,
                        LLVMValueRef y,
                        LLVMValueRef z,
@@ -2048,17 +2239,33 @@ lp_build_sample_offset(struct lp_build_context *bld,
    x_stride = lp_build_const_vec(bld->gallivm, bld->type,
                                  format_desc->block.bits/8);
 
-   lp_build_sample_partial_offset(bld,
-                                  format_desc->block.width,
-                                  x, x_stride,
-                                  &offset, out_i);
+   if (tiled) {
+      lp_build_sample_partial_offset_tiled(bld, 0,
+                                           format_desc->block.width,
+                                           x, x_stride,
+                                           &offset, out_i);
+   }
+   else {
+      lp_build_sample_partial_offset(bld,
+                                     format_desc->block.width,
+                                     x, x_stride,
+                                     &offset, out_i);
+   }
 
    if (y && y_stride) {
       LLVMValueRef y_offset;
-      lp_build_sample_partial_offset(bld,
-                                     format_desc->block.height,
-                                     y, y_stride,
-                                     &y_offset, out_j);
+      if (tiled) {
+         lp_build_sample_partial_offset_tiled(bld, 1,
+                                              format_desc->block.height,
+                                              y, y_stride,
+                                              &y_offset, out_j);
+      }
+      else {
+         lp_build_sample_partial_offset(bld,
+                                        format_desc->block.height,
+                                        y, y_stride,
+                                        &y_offset, out_j);
+      }
       offset = lp_build_add(bld, offset, y_offset);
    }
    else {
@@ -122,6 +122,27 @@ struct lp_sampler_size_query_params
    LLVMValueRef explicit_lod;
    LLVMValueRef *sizes_out;
 };
+/**
+ * Layout of textures with LP_RESOURCE_FLAG_TILED set.
+ *
+ * Each 2D image (mip level, layer, cube face or 3D slice) is stored as
+ * tiles of LP_TEXTURE_TILE_WIDTH bytes by LP_TEXTURE_TILE_HEIGHT rows, so
+ * the texels of a 2x2 filter footprint mostly share a cache line.  Tiles are
+ * stored in row-major order, and so are the bytes within a tile.  The row
+ * stride is still that of the linear layout, so a row of tiles takes
+ * LP_TEXTURE_TILE_HEIGHT row strides.  Only formats whose blocks evenly
+ * divide the tile width can use it.
+ */
+#define LP_TEXTURE_TILE_WIDTH  16
+#define LP_TEXTURE_TILE_HEIGHT 4
+
+/*
+ * Set by the driver on resources using the tiled layout.  swr uses
+ * PIPE_RESOURCE_FLAG_DRV_PRIV << 0 for its own purposes, so don't clash.
+ */
+#define LP_RESOURCE_FLAG_TILED (PIPE_RESOURCE_FLAG_DRV_PRIV << 1)
+
+
 /**
  * Texture static state.
  *
@@ -143,6 +164,7 @@ struct lp_static_texture_state
    unsigned pot_height:1;
    unsigned pot_depth:1;
    unsigned level_zero_only:1;
+   unsigned tiled:1;         /**< LP_RESOURCE_FLAG_TILED layout */
 };
 
 
@@ -170,6 +192,7 @@ struct lp_static_sampler_state
    unsigned apply_min_lod:1;  /**< min_lod > 0 ? */
    unsigned apply_max_lod:1;  /**< max_lod < last_level ? */
    unsigned seamless_cube_map:1;
+   unsigned aniso:5;  /**< max_anisotropy if > 1, otherwise 0 */
 
    /* Hacks */
    unsigned force_nearest_s:1;
@@ -394,6 +417,14 @@ struct lp_build_sample_context
 
    LLVMValueRef border_color_clamped;
 
+   /**
+    * Anisotropic footprint computed by lp_build_lod_selector(): number of
+    * probes (float, per element) and major axis in normalized coords.
+    * NULL if not filtering anisotropically.
+    */
+   LLVMValueRef aniso_taps;
+   LLVMValueRef aniso_axis[2];
+
    LLVMValueRef context_ptr;
 };
 
@@ -590,9 +621,20 @@ lp_build_sample_partial_offset(struct lp_build_context *bld,
                                LLVMValueRef *out_i);
 
 
+void
+lp_build_sample_partial_offset_tiled(struct lp_build_context *bld,
+                                     unsigned axis,
+                                     unsigned block_length,
+                                     LLVMValueRef coord,
+                                     LLVMValueRef stride,
+                                     LLVMValueRef *out_offset,
+                                     LLVMValueRef *out_i);
+
+
 void
 lp_build_sample_offset(struct lp_build_context *bld,
                        const struct util_format_description *format_desc,
+                       boolean tiled,
                        LLVMValueRef x,
                        LLVMValueRef y,
                        LLVMValueRef z,
@@ -59,9 +59,36 @@
 #include "lp_bld_quad.h"
 
 
+/**
+ * Compute the partial offset along one axis, taking the tiled layout
+ * into account.
+ * \param axis  0, 1 or 2 for x, y or z
+ */
+static void
+lp_build_sample_partial_offset_aos(struct lp_build_sample_context *bld,
+                                   unsigned axis,
+                                   unsigned block_length,
+                                   LLVMValueRef coord,
+                                   LLVMValueRef stride,
+                                   LLVMValueRef *out_offset,
+                                   LLVMValueRef *out_i)
+{
+   if (bld->static_texture_state->tiled && axis < 2) {
+      lp_build_sample_partial_offset_tiled(&bld->int_coord_bld, axis,
+                                           block_length, coord, stride,
+                                           out_offset, out_i);
+   }
+   else {
+      lp_build_sample_partial_offset(&bld->int_coord_bld, block_length,
+                                     coord, stride, out_offset, out_i);
+   }
+}
+
+
 /**
  * Build LLVM code for texture coord wrapping, for nearest filtering,
  * for scaled integer texcoords.
+ * \param axis  0, 1 or 2 for s, t or r
  * \param block_length  is the length of the pixel block along the
  *                      coordinate axis
  * \param coord  the incoming texcoord (s,t or r) scaled to the texture size
@@ -76,6 +103,7 @@
  */
 static void
 lp_build_sample_wrap_nearest_int(struct lp_build_sample_context *bld,
+                                 unsigned axis,
                                  unsigned block_length,
                                  LLVMValueRef coord,
                                  LLVMValueRef coord_f,
@@ -126,8 +154,8 @@ lp_build_sample_wrap_nearest_int(struct lp_build_sample_context *bld,
       assert(0);
    }
 
-   lp_build_sample_partial_offset(int_coord_bld, block_length, coord, stride,
-                                  out_offset, out_i);
+   lp_build_sample_partial_offset_aos(bld, axis, block_length, coord, stride,
+                                      out_offset, out_i);
 }
 
 
@@ -196,6 +224,7 @@ lp_build_coord_repeat_npot_linear_int(struct lp_build_sample_context *bld,
 /**
  * Build LLVM code for texture coord wrapping, for linear filtering,
  * for scaled integer texcoords.
+ * \param axis  0, 1 or 2 for s, t or r
  * \param block_length  is the length of the pixel block along the
  *                      coordinate axis
  * \param coord0  the incoming texcoord (s,t or r) scaled to the texture size
@@ -212,6 +241,7 @@ lp_build_coord_repeat_npot_linear_int(struct lp_build_sample_context *bld,
  */
 static void
 lp_build_sample_wrap_linear_int(struct lp_build_sample_context *bld,
+                                unsigned axis,
                                 unsigned block_length,
                                 LLVMValueRef coord0,
                                 LLVMValueRef *weight_i,
@@ -232,15 +262,16 @@ lp_build_sample_wrap_linear_int(struct lp_build_sample_context *bld,
    LLVMValueRef lmask, umask, mask;
 
    /*
-    * If the pixel block covers more than one pixel then there is no easy
-    * way to calculate offset1 relative to offset0. Instead, compute them
-    * independently. Otherwise, try to compute offset0 and offset1 with
-    * a single stride multiplication.
+    * If the pixel block covers more than one pixel, or the texture is
+    * tiled, then there is no easy way to calculate offset1 relative to
+    * offset0. Instead, compute them independently. Otherwise, try to
+    * compute offset0 and offset1 with a single stride multiplication.
     */
 
    length_minus_one = lp_build_sub(int_coord_bld, length, int_coord_bld->one);
 
-   if (block_length != 1) {
+   if (block_length != 1 ||
+       (bld->static_texture_state->tiled && axis < 2)) {
       LLVMValueRef coord1;
       switch(wrap_mode) {
       case PIPE_TEX_WRAP_REPEAT:
@@ -289,10 +320,10 @@ lp_build_sample_wrap_linear_int(struct lp_build_sample_context *bld,
          coord1 = int_coord_bld->zero;
          break;
       }
-      lp_build_sample_partial_offset(int_coord_bld, block_length, coord0, stride,
-                                     offset0, i0);
-      lp_build_sample_partial_offset(int_coord_bld, block_length, coord1, stride,
-                                     offset1, i1);
+      lp_build_sample_partial_offset_aos(bld, axis, block_length, coord0,
+                                         stride, offset0, i0);
+      lp_build_sample_partial_offset_aos(bld, axis, block_length, coord1,
+                                         stride, offset1, i1);
       return;
    }
 
@@ -505,7 +536,7 @@ lp_build_sample_image_nearest(struct lp_build_sample_context *bld,
                                  bld->format_desc->block.bits/8);
 
    /* Do texcoord wrapping, compute texel offset */
-   lp_build_sample_wrap_nearest_int(bld,
+   lp_build_sample_wrap_nearest_int(bld, 0,
                                     bld->format_desc->block.width,
                                     s_ipart, s_float,
                                     width_vec, x_stride, offsets[0],
@@ -515,7 +546,7 @@ lp_build_sample_image_nearest(struct lp_build_sample_context *bld,
    offset = x_offset;
    if (dims >= 2) {
       LLVMValueRef y_offset;
-      lp_build_sample_wrap_nearest_int(bld,
+      lp_build_sample_wrap_nearest_int(bld, 1,
                                        bld->format_desc->block.height,
                                        t_ipart, t_float,
                                        height_vec, row_stride_vec, offsets[1],
@@ -525,7 +556,7 @@ lp_build_sample_image_nearest(struct lp_build_sample_context *bld,
       offset = lp_build_add(&bld->int_coord_bld, offset, y_offset);
       if (dims >= 3) {
          LLVMValueRef z_offset;
-         lp_build_sample_wrap_nearest_int(bld,
+         lp_build_sample_wrap_nearest_int(bld, 2,
                                           1, /* block length (depth) */
                                           r_ipart, r_float,
                                           depth_vec, img_stride_vec, offsets[2],
@@ -862,7 +893,7 @@ lp_build_sample_image_linear(struct lp_build_sample_context *bld,
    z_stride = img_stride_vec;
 
    /* do texcoord wrapping and compute texel offsets */
-   lp_build_sample_wrap_linear_int(bld,
+   lp_build_sample_wrap_linear_int(bld, 0,
                                    bld->format_desc->block.width,
                                    s_ipart, &s_fpart, s_float,
                                    width_vec, x_stride, offsets[0],
@@ -892,7 +923,7 @@ lp_build_sample_image_linear(struct lp_build_sample_context *bld,
    }
 
    if (dims >= 2) {
-      lp_build_sample_wrap_linear_int(bld,
+      lp_build_sample_wrap_linear_int(bld, 1,
                                       bld->format_desc->block.height,
                                       t_ipart, &t_fpart, t_float,
                                       height_vec, y_stride, offsets[1],
@@ -912,7 +943,7 @@ lp_build_sample_image_linear(struct lp_build_sample_context *bld,
    }
 
    if (dims >= 3) {
-      lp_build_sample_wrap_linear_int(bld,
+      lp_build_sample_wrap_linear_int(bld, 2,
                                       1, /* block length (depth) */
                                       r_ipart, &r_fpart, r_float,
                                       depth_vec, z_stride, offsets[2],
@@ -139,6 +139,7 @@ lp_build_sample_texel_soa(struct lp_build_sample_context *bld,
    /* convert x,y,z coords to linear offset from start of texture, in bytes */
    lp_build_sample_offset(&bld->int_coord_bld,
                           bld->format_desc,
+                          bld->static_texture_state->tiled,
                           x, y, z, y_stride, z_stride,
                           &offset, &i, &j);
    if (mipoffsets) {
@@ -2570,6 +2571,96 @@ lp_build_sample_general(struct lp_build_sample_context *bld,
    }
 }
 
+/**
+ * Anisotropic filtering: average bld->aniso_taps probes spread evenly
+ * along the major axis of the pixel footprint, each of them filtered
+ * with the ordinary min/mag/mip filters at the lod chosen for a single
+ * probe (see lp_build_lod_selector()).
+ */
+static void
+lp_build_sample_aniso(struct lp_build_sample_context *bld,
+                      unsigned sampler_unit,
+                      const LLVMValueRef *coords,
+                      const LLVMValueRef *offsets,
+                      LLVMValueRef lod_positive,
+                      LLVMValueRef lod_fpart,
+                      LLVMValueRef ilevel0,
+                      LLVMValueRef ilevel1,
+                      LLVMValueRef *colors_out)
+{
+   struct gallivm_state *gallivm = bld->gallivm;
+   LLVMBuilderRef builder = gallivm->builder;
+   struct lp_build_context *coord_bld = &bld->coord_bld;
+   struct lp_build_context *texel_bld = &bld->texel_bld;
+   LLVMValueRef taps = bld->aniso_taps;
+   LLVMValueRef half = lp_build_const_vec(gallivm, coord_bld->type, 0.5);
+   LLVMValueRef sum[4], tap_coords[5], texels[4];
+   LLVMValueRef k, active, delta, rcp_taps;
+   struct lp_build_for_loop_state loop_state;
+   struct lp_build_if_state if_ctx;
+   unsigned chan, i;
+
+   assert(texel_bld->type.floating);
+   assert(texel_bld->type.length == coord_bld->type.length);
+
+   for (chan = 0; chan < 4; chan++) {
+      sum[chan] = lp_build_alloca(gallivm, texel_bld->vec_type, "aniso_sum");
+   }
+
+   lp_build_for_loop_begin(&loop_state, gallivm,
+                           lp_build_const_int32(gallivm, 0), LLVMIntULT,
+                           lp_build_const_int32(gallivm,
+                                                bld->static_sampler_state->aniso),
+                           lp_build_const_int32(gallivm, 1));
+
+   k = LLVMBuildUIToFP(builder, loop_state.counter, coord_bld->elem_type, "");
+   k = lp_build_broadcast_scalar(coord_bld, k);
+   active = lp_build_cmp(coord_bld, PIPE_FUNC_LESS, k, taps);
+
+   /* the number of probes varies per element, skip once all are done */
+   lp_build_if(&if_ctx, gallivm,
+               lp_build_any_true_range(coord_bld, coord_bld->type.length,
+                                       active));
+   {
+      /* probe k is at (k + 0.5) / taps - 0.5 along the major axis */
+      delta = lp_build_add(coord_bld, k, half);
+      delta = lp_build_div(coord_bld, delta, taps);
+      delta = lp_build_sub(coord_bld, delta, half);
+
+      for (i = 0; i < 5; i++) {
+         tap_coords[i] = coords[i];
+      }
+      for (i = 0; i < 2; i++) {
+         tap_coords[i] = lp_build_mad(coord_bld, bld->aniso_axis[i], delta,
+                                      coords[i]);
+      }
+
+      lp_build_sample_general(bld, sampler_unit, FALSE,
+                              tap_coords, offsets,
+                              lod_positive, lod_fpart,
+                              ilevel0, ilevel1,
+                              texels);
+
+      for (chan = 0; chan < 4; chan++) {
+         LLVMValueRef acc = LLVMBuildLoad(builder, sum[chan], "");
+         texels[chan] = lp_build_select(texel_bld, active, texels[chan],
+                                        texel_bld->zero);
+         acc = lp_build_add(texel_bld, acc, texels[chan]);
+         LLVMBuildStore(builder, acc, sum[chan]);
+      }
+   }
+   lp_build_endif(&if_ctx);
+
+   lp_build_for_loop_end(&loop_state);
+
+   rcp_taps = lp_build_rcp(coord_bld, taps);
+   for (chan = 0; chan < 4; chan++) {
+      colors_out[chan] = lp_build_mul(texel_bld,
+                                      LLVMBuildLoad(builder, sum[chan], ""),
+                                      rcp_taps);
+   }
+}
+
 
 /**
  * Texel fetch function.
@@ -2673,6 +2764,7 @@ lp_build_fetch_texel(struct lp_build_sample_context *bld,
 
    lp_build_sample_offset(int_coord_bld,
                           bld->format_desc,
+                          bld->static_texture_state->tiled,
                           x, y, z, row_stride_vec, img_stride_vec,
                           &offset, &i, &j);
 
@@ -3161,6 +3253,11 @@ lp_build_sample_soa_code(struct gallivm_state *gallivm,
          return;
       }
 
+      /* anisotropic filtering is only done by the soa path */
+      if (bld.aniso_taps) {
+         use_aos = FALSE;
+      }
+
       if (use_aos && static_texture_state->target == PIPE_TEXTURE_CUBE_ARRAY) {
          /* The aos path doesn't do seamless filtering so simply add cube layer
           * to face now.
@@ -3186,6 +3283,14 @@ lp_build_sample_soa_code(struct gallivm_state *gallivm,
                                 texel_out);
          }
 
+         else if (bld.aniso_taps && op_type == LP_SAMPLER_OP_TEXTURE) {
+            lp_build_sample_aniso(&bld, sampler_index,
+                                  newcoords, offsets,
+                                  lod_positive, lod_fpart,
+                                  ilevel0, ilevel1,
+                                  texel_out);
+         }
+
          else {
             lp_build_sample_general(&bld, sampler_index,
                                     op_type == LP_SAMPLER_OP_GATHER,
@@ -1270,9 +1270,27 @@ hud_parse_env_var(struct hud_context *hud, struct pipe_screen *screen,
       else if (strcmp(name, "API-thread-num-syncs") == 0) {
          hud_thread_counter_install(pane, name, HUD_COUNTER_SYNCS);
       }
+      else if (strcmp(name, "API-thread-num-batches") == 0) {
+         hud_thread_counter_install(pane, name, HUD_COUNTER_BATCHES);
+      }
+      else if (strcmp(name, "API-thread-num-full-batches") == 0) {
+         hud_thread_counter_install(pane, name, HUD_COUNTER_FULL_BATCHES);
+      }
+      else if (strcmp(name, "API-thread-batch-fill") == 0) {
+         hud_thread_counter_install(pane, name, HUD_COUNTER_BATCH_FILL);
+      }
+      else if (strcmp(name, "API-thread-batch-size") == 0) {
+         hud_thread_counter_install(pane, name, HUD_COUNTER_BATCH_SIZE);
+      }
       else if (strcmp(name, "main-thread-busy") == 0) {
          hud_thread_busy_install(pane, name, true);
       }
+      else if (strcmp(name, "process-busy") == 0) {
+         hud_process_busy_install(pane, name);
+      }
+      else if (strncmp(name, "queue-busy-", 11) == 0 && name[11]) {
+         hud_queue_busy_install(pane, name, name + 11);
+      }
 #ifdef HAVE_GALLIUM_EXTRA_HUD
       else if (sscanf(name, "nic-rx-%s", arg_name) == 1) {
          hud_nic_graph_install(pane, arg_name, NIC_DIRECTION_RX);
@@ -1569,6 +1587,12 @@ print_help(struct pipe_screen *screen)
    for (i = 0; i < num_cpus; i++)
       printf("    cpu%i\n", i);
 
+   puts("    main-thread-busy");
+   puts("    API-thread-busy");
+   puts("    process-busy");
+   puts("    queue-busy-[queue name] (e.g. queue-busy-sh for radeonsi shader");
+   puts("                             compiler threads)");
+
    if (has_occlusion_query(screen))
       puts("    samples-passed");
    if (has_streamout(screen))
@@ -35,6 +35,7 @@
 #include "util/u_queue.h"
 #include <stdio.h>
 #include <inttypes.h>
+#include <time.h>
 #ifdef PIPE_OS_WINDOWS
 #include <windows.h>
 #endif
@@ -277,12 +278,67 @@ hud_get_num_cpus(void)
    return i;
 }
 
+/* CPU time used by the whole process, all threads included */
+static int64_t
+get_process_time_nano(void)
+{
+#if defined(PIPE_OS_WINDOWS)
+   FILETIME creation, exit, kernel, user;
+
+   if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+      return 0;
+
+   /* 100ns units */
+   return (filetime_to_scalar(kernel) + filetime_to_scalar(user)) * 100;
+#elif defined(PIPE_OS_UNIX)
+   struct timespec ts;
+
+   if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts))
+      return 0;
+
+   return ts.tv_sec * INT64_C(1000000000) + ts.tv_nsec;
+#else
+   return 0;
+#endif
+}
+
+enum thread_source {
+   THREAD_SOURCE_MAIN,
+   THREAD_SOURCE_API,
+   THREAD_SOURCE_PROCESS,
+   THREAD_SOURCE_QUEUE,
+};
+
 struct thread_info {
-   bool main_thread;
+   enum thread_source source;
+   char queue_name[16]; /* for THREAD_SOURCE_QUEUE */
    int64_t last_time;
    int64_t last_thread_time;
 };
 
+static int64_t
+get_thread_time(struct hud_graph *gr, struct thread_info *info)
+{
+   switch (info->source) {
+   case THREAD_SOURCE_MAIN:
+      return pipe_current_thread_get_time_nano();
+   case THREAD_SOURCE_API: {
+      struct util_queue_monitoring *mon = gr->pane->hud->monitored_queue;
+
+      if (mon && mon->queue)
+         return util_queue_get_thread_time_nano(mon->queue, 0);
+      return 0;
+   }
+   case THREAD_SOURCE_PROCESS:
+      return get_process_time_nano();
+   case THREAD_SOURCE_QUEUE:
+      return util_queue_get_named_threads_time_nano(info->queue_name);
+   default:
+      assert(0);
+      return 0;
+   }
+}
+
 static void
 query_api_thread_busy_status(struct hud_graph *gr, struct pipe_context *pipe)
 {
@@ -291,28 +347,26 @@ query_api_thread_busy_status(struct hud_graph *gr, struct pipe_context *pipe)
 
    if (info->last_time) {
       if (info->last_time + gr->pane->period*1000 <= now) {
-         int64_t thread_now;
-
-         if (info->main_thread) {
-            thread_now = pipe_current_thread_get_time_nano();
-         } else {
-            struct util_queue_monitoring *mon = gr->pane->hud->monitored_queue;
-
-            if (mon && mon->queue)
-               thread_now = util_queue_get_thread_time_nano(mon->queue, 0);
-            else
-               thread_now = 0;
-         }
+         int64_t thread_now = get_thread_time(gr, info);
 
          double percent = (thread_now - info->last_thread_time) * 100.0 /
                             (now - info->last_time);
 
-         /* Check if the context changed a thread, so that we don't show
-          * a random value. When a thread is changed, the new thread clock
-          * is different, which can result in "percent" being very high.
-          */
-         if (percent > 100.0)
-            percent = 0.0;
+         if (info->source == THREAD_SOURCE_MAIN ||
+             info->source == THREAD_SOURCE_API) {
+            /* Check if the context changed a thread, so that we don't show
+             * a random value. When a thread is changed, the new thread clock
+             * is different, which can result in "percent" being very high.
+             */
+            if (percent > 100.0)
+               percent = 0.0;
+         } else {
+            /* Several threads may be busy at the same time, so this can go
+             * above 100%, but it goes down when queue threads exit.
+             */
+            if (percent < 0.0)
+               percent = 0.0;
+         }
          hud_graph_add_value(gr, percent);
 
          info->last_thread_time = thread_now;
@@ -321,14 +375,16 @@ query_api_thread_busy_status(struct hud_graph *gr, struct pipe_context *pipe)
    } else {
       /* initialize */
       info->last_time = now;
-      info->last_thread_time = pipe_current_thread_get_time_nano();
+      info->last_thread_time = get_thread_time(gr, info);
    }
 }
 
-void
-hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main)
+static void
+thread_busy_install(struct hud_pane *pane, const char *name,
+                    enum thread_source source, const char *queue_name)
 {
    struct hud_graph *gr;
+   struct thread_info *info;
 
    gr = CALLOC_STRUCT(hud_graph);
    if (!gr)
@@ -342,7 +398,10 @@ hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main)
       return;
    }
 
-   ((struct thread_info*)gr->query_data)->main_thread = main;
+   info = gr->query_data;
+   info->source = source;
+   if (queue_name)
+      snprintf(info->queue_name, sizeof(info->queue_name), "%s", queue_name);
    gr->query_new_value = query_api_thread_busy_status;
 
    /* Don't use free() as our callback as that messes up Gallium's
@@ -354,9 +413,30 @@ hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main)
    hud_pane_set_max_value(pane, 100);
 }
 
+void
+hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main)
+{
+   thread_busy_install(pane, name,
+                       main ? THREAD_SOURCE_MAIN : THREAD_SOURCE_API, NULL);
+}
+
+void
+hud_process_busy_install(struct hud_pane *pane, const char *name)
+{
+   thread_busy_install(pane, name, THREAD_SOURCE_PROCESS, NULL);
+}
+
+void
+hud_queue_busy_install(struct hud_pane *pane, const char *name,
+                       const char *queue_name)
+{
+   thread_busy_install(pane, name, THREAD_SOURCE_QUEUE, queue_name);
+}
+
 struct counter_info {
    enum hud_counter counter;
    unsigned last_value;
+   unsigned last_capacity; /* for HUD_COUNTER_BATCH_FILL */
    int64_t last_time;
 };
 
@@ -374,12 +454,27 @@ static unsigned get_counter(struct hud_graph *gr, enum hud_counter counter)
       return mon->num_direct_items;
    case HUD_COUNTER_SYNCS:
       return mon->num_syncs;
+   case HUD_COUNTER_BATCHES:
+      return mon->num_batches;
+   case HUD_COUNTER_FULL_BATCHES:
+      return mon->num_full_batches;
+   case HUD_COUNTER_BATCH_FILL:
+      return mon->num_offloaded_items;
+   case HUD_COUNTER_BATCH_SIZE:
+      return mon->batch_size;
    default:
       assert(0);
       return 0;
    }
 }
 
+static unsigned get_batch_capacity(struct hud_graph *gr)
+{
+   struct util_queue_monitoring *mon = gr->pane->hud->monitored_queue;
+
+   return mon && mon->queue ? mon->num_offloaded_capacity : 0;
+}
+
 static void
 query_thread_counter(struct hud_graph *gr, struct pipe_context *pipe)
 {
@@ -390,13 +485,34 @@ query_thread_counter(struct hud_graph *gr, struct pipe_context *pipe)
       if (info->last_time + gr->pane->period*1000 <= now) {
          unsigned current_value = get_counter(gr, info->counter);
 
-         hud_graph_add_value(gr, current_value - info->last_value);
+         switch (info->counter) {
+         case HUD_COUNTER_BATCH_FILL: {
+            /* The percentage of the capacity of the submitted batches that
+             * was used.
+             */
+            unsigned capacity = get_batch_capacity(gr);
+            unsigned used_capacity = capacity - info->last_capacity;
+
+            hud_graph_add_value(gr, used_capacity ?
+                                (current_value - info->last_value) * 100.0 /
+                                used_capacity : 0);
+            info->last_capacity = capacity;
+            break;
+         }
+         case HUD_COUNTER_BATCH_SIZE:
+            hud_graph_add_value(gr, current_value);
+            break;
+         default:
+            hud_graph_add_value(gr, current_value - info->last_value);
+            break;
+         }
          info->last_value = current_value;
          info->last_time = now;
       }
    } else {
       /* initialize */
       info->last_value = get_counter(gr, info->counter);
+      info->last_capacity = get_batch_capacity(gr);
       info->last_time = now;
    }
 }
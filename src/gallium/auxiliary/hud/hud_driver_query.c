@@ -28,7 +28,9 @@
 /* This file contains code for reading values from pipe queries
  * for displaying on the HUD. To prevent stalls when reading queries, we
  * keep a list of busy queries in a ring. We read only those queries which
- * are idle.
+ * are idle and which ended at least HUD_QUERY_LATENCY frames ago, so that
+ * reading them never waits for the GPU nor makes the driver flush a
+ * command buffer that still references them.
  */
 
 #include "hud/hud_private.h"
@@ -41,6 +43,9 @@
 // Must be a power of two
 #define NUM_QUERIES 8
 
+/* Number of frames a query is left alone after it ends */
+#define HUD_QUERY_LATENCY 2
+
 struct hud_batch_query_context {
    unsigned num_query_types;
    unsigned allocated_query_types;
@@ -64,7 +69,8 @@ hud_batch_query_update(struct hud_batch_query_context *bq,
 
    bq->results = 0;
 
-   while (bq->pending) {
+   /* The query that just ended is the last of the pending ones. */
+   while (bq->pending > HUD_QUERY_LATENCY) {
       unsigned idx = (bq->head - bq->pending + 1) % NUM_QUERIES;
       struct pipe_query *query = bq->query[idx];
 
@@ -236,13 +242,17 @@ query_new_value_normal(struct query_info *info, struct pipe_context *pipe)
       if (info->query[info->head])
          pipe->end_query(pipe, info->query[info->head]);
 
-      /* read query results */
-      while (1) {
+      /* read the results of the queries old enough, oldest first */
+      while ((info->head - info->tail) % NUM_QUERIES >= HUD_QUERY_LATENCY) {
          struct pipe_query *query = info->query[info->tail];
          union pipe_query_result result;
          uint64_t *res64 = (uint64_t *)&result;
 
-         if (query && pipe->get_query_result(pipe, query, FALSE, &result)) {
+         if (query) {
+            /* the oldest query is busy */
+            if (!pipe->get_query_result(pipe, query, FALSE, &result))
+               break;
+
             if (info->type == PIPE_DRIVER_QUERY_TYPE_FLOAT) {
                assert(info->result_index == 0);
                info->results_cumulative += (uint64_t) (result.f * 1000.0f);
@@ -251,37 +261,25 @@ query_new_value_normal(struct query_info *info, struct pipe_context *pipe)
                info->results_cumulative += res64[info->result_index];
             }
             info->num_results++;
+         }
 
-            if (info->tail == info->head)
-               break;
+         info->tail = (info->tail+1) % NUM_QUERIES;
+      }
 
-            info->tail = (info->tail+1) % NUM_QUERIES;
-         }
-         else {
-            /* the oldest query is busy */
-            if ((info->head+1) % NUM_QUERIES == info->tail) {
-               /* all queries are busy, throw away the last query and create
-                * a new one */
-               fprintf(stderr,
-                       "gallium_hud: all queries are busy after %i frames, "
-                       "can't add another query\n",
-                       NUM_QUERIES);
-               if (info->query[info->head])
-                  pipe->destroy_query(pipe, info->query[info->head]);
-               info->query[info->head] =
-                     pipe->create_query(pipe, info->query_type, 0);
-            }
-            else {
-               /* the last query is busy, we need to add a new one we can use
-                * for this frame */
-               info->head = (info->head+1) % NUM_QUERIES;
-               if (!info->query[info->head]) {
-                  info->query[info->head] =
-                        pipe->create_query(pipe, info->query_type, 0);
-               }
-            }
-            break;
-         }
+      if ((info->head+1) % NUM_QUERIES == info->tail) {
+         /* all queries are busy, throw away the oldest one and reuse it */
+         fprintf(stderr,
+                 "gallium_hud: all queries are busy after %i frames, "
+                 "dropping data\n",
+                 NUM_QUERIES);
+         info->tail = (info->tail+1) % NUM_QUERIES;
+      }
+
+      /* use the next query for the next frame */
+      info->head = (info->head+1) % NUM_QUERIES;
+      if (!info->query[info->head]) {
+         info->query[info->head] =
+               pipe->create_query(pipe, info->query_type, 0);
       }
    }
    else {
@@ -37,6 +37,10 @@ enum hud_counter {
    HUD_COUNTER_OFFLOADED,
    HUD_COUNTER_DIRECT,
    HUD_COUNTER_SYNCS,
+   HUD_COUNTER_BATCHES,
+   HUD_COUNTER_FULL_BATCHES,
+   HUD_COUNTER_BATCH_FILL,
+   HUD_COUNTER_BATCH_SIZE,
 };
 
 struct hud_context {
@@ -160,6 +164,9 @@ void hud_fps_graph_install(struct hud_pane *pane);
 void hud_frametime_graph_install(struct hud_pane *pane);
 void hud_cpu_graph_install(struct hud_pane *pane, unsigned cpu_index);
 void hud_thread_busy_install(struct hud_pane *pane, const char *name, bool main);
+void hud_process_busy_install(struct hud_pane *pane, const char *name);
+void hud_queue_busy_install(struct hud_pane *pane, const char *name,
+                            const char *queue_name);
 void hud_thread_counter_install(struct hud_pane *pane, const char *name,
                                 enum hud_counter counter);
 void hud_pipe_query_install(struct hud_batch_query_context **pbq,
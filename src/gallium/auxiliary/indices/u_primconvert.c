@@ -49,11 +49,51 @@
 #include "indices/u_indices.h"
 #include "indices/u_primconvert.h"
 
+/* Number of translated index buffers kept around for re-use */
+#define PRIMCONVERT_CACHE_SIZE 16
+
+/* Below this, translating again is cheaper than looking the draw up */
+#define PRIMCONVERT_CACHE_MIN_COUNT 256
+
+/**
+ * A translated index buffer.  Static meshes keep drawing the same range of
+ * the same index buffer, so rather than translating and uploading the
+ * indices on every draw, the result of the last translations is kept.
+ *
+ * Gallium doesn't tell us when a buffer is written (by the CPU or the
+ * GPU), so a copy of the source indices is kept as well and compared on
+ * lookup.  Comparing only reads the source, which is still a lot cheaper
+ * than translating it and writing out a new index buffer.
+ */
+struct primconvert_cache_entry
+{
+   /* key: */
+   struct pipe_resource *src;
+   unsigned start;
+   unsigned count;
+   unsigned index_size;
+   enum pipe_prim_type mode;
+   bool primitive_restart;
+   unsigned restart_index;
+   unsigned api_pv;
+
+   void *src_indices;
+
+   /* translated draw: */
+   struct pipe_resource *dst;
+   enum pipe_prim_type dst_mode;
+   unsigned dst_index_size;
+   unsigned dst_count;
+};
+
 struct primconvert_context
 {
    struct pipe_context *pipe;
    uint32_t primtypes_mask;
    unsigned api_pv;
+
+   struct primconvert_cache_entry cache[PRIMCONVERT_CACHE_SIZE];
+   unsigned cache_next;
 };
 
 
@@ -68,12 +108,105 @@ util_primconvert_create(struct pipe_context *pipe, uint32_t primtypes_mask)
    return pc;
 }
 
+static void
+primconvert_cache_entry_clear(struct primconvert_cache_entry *entry)
+{
+   pipe_resource_reference(&entry->src, NULL);
+   pipe_resource_reference(&entry->dst, NULL);
+   FREE(entry->src_indices);
+   memset(entry, 0, sizeof(*entry));
+}
+
 void
 util_primconvert_destroy(struct primconvert_context *pc)
 {
+   for (unsigned i = 0; i < PRIMCONVERT_CACHE_SIZE; i++)
+      primconvert_cache_entry_clear(&pc->cache[i]);
    FREE(pc);
 }
 
+static struct primconvert_cache_entry *
+primconvert_cache_find(struct primconvert_context *pc,
+                       const struct pipe_draw_info *info)
+{
+   for (unsigned i = 0; i < PRIMCONVERT_CACHE_SIZE; i++) {
+      struct primconvert_cache_entry *entry = &pc->cache[i];
+
+      if (entry->src == info->index.resource &&
+          entry->start == info->start &&
+          entry->count == info->count &&
+          entry->index_size == info->index_size &&
+          entry->mode == info->mode &&
+          entry->primitive_restart == info->primitive_restart &&
+          entry->restart_index == info->restart_index &&
+          entry->api_pv == pc->api_pv)
+         return entry;
+   }
+
+   return NULL;
+}
+
+/**
+ * Translate the indices of the draw into a buffer of their own, and
+ * remember it in the cache, replacing @entry if it is a stale translation
+ * of the same draw.  Returns NULL if that didn't work out, in which case
+ * the draw is translated the usual way.
+ */
+static struct primconvert_cache_entry *
+primconvert_cache_add(struct primconvert_context *pc,
+                      struct primconvert_cache_entry *entry,
+                      const struct pipe_draw_info *info,
+                      struct pipe_draw_info *new_info,
+                      u_translate_func trans_func,
+                      const uint8_t *src)
+{
+   unsigned src_size = info->count * info->index_size;
+   unsigned dst_size = new_info->count * new_info->index_size;
+   struct pipe_transfer *dst_transfer;
+   void *dst;
+
+   if (!entry) {
+      entry = &pc->cache[pc->cache_next];
+      pc->cache_next = (pc->cache_next + 1) % PRIMCONVERT_CACHE_SIZE;
+   }
+   primconvert_cache_entry_clear(entry);
+
+   entry->src_indices = MALLOC(src_size);
+   entry->dst = pipe_buffer_create(pc->pipe->screen, PIPE_BIND_INDEX_BUFFER,
+                                   PIPE_USAGE_DEFAULT, dst_size);
+   if (!entry->src_indices || !entry->dst)
+      goto fail;
+
+   dst = pipe_buffer_map(pc->pipe, entry->dst,
+                         PIPE_TRANSFER_WRITE |
+                         PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE, &dst_transfer);
+   if (!dst)
+      goto fail;
+
+   trans_func(src, info->start, info->count, new_info->count,
+              info->restart_index, dst);
+   pipe_buffer_unmap(pc->pipe, dst_transfer);
+
+   memcpy(entry->src_indices, src + info->start * info->index_size, src_size);
+
+   pipe_resource_reference(&entry->src, info->index.resource);
+   entry->start = info->start;
+   entry->count = info->count;
+   entry->index_size = info->index_size;
+   entry->mode = info->mode;
+   entry->primitive_restart = info->primitive_restart;
+   entry->restart_index = info->restart_index;
+   entry->api_pv = pc->api_pv;
+   entry->dst_mode = new_info->mode;
+   entry->dst_index_size = new_info->index_size;
+   entry->dst_count = new_info->count;
+   return entry;
+
+fail:
+   primconvert_cache_entry_clear(entry);
+   return NULL;
+}
+
 void
 util_primconvert_save_rasterizer_state(struct primconvert_context *pc,
                                        const struct pipe_rasterizer_state
@@ -97,6 +230,7 @@ util_primconvert_draw_vbo(struct primconvert_context *pc,
    const void *src = NULL;
    void *dst;
    unsigned ib_offset;
+   bool cacheable = false;
 
    util_draw_init_info(&new_info);
    new_info.min_index = info->min_index;
@@ -122,6 +256,7 @@ util_primconvert_draw_vbo(struct primconvert_context *pc,
       if (!src) {
          src = pipe_buffer_map(pc->pipe, info->index.resource,
                                PIPE_TRANSFER_READ, &src_transfer);
+         cacheable = info->count >= PRIMCONVERT_CACHE_MIN_COUNT;
       }
       src = (const uint8_t *)src;
    }
@@ -138,6 +273,33 @@ util_primconvert_draw_vbo(struct primconvert_context *pc,
       new_info.index_size = index_size;
    }
 
+   if (cacheable) {
+      struct primconvert_cache_entry *entry = primconvert_cache_find(pc, info);
+      const uint8_t *src_indices =
+         (const uint8_t *)src + info->start * info->index_size;
+
+      if (!entry ||
+          memcmp(entry->src_indices, src_indices,
+                 info->count * info->index_size) != 0)
+         entry = primconvert_cache_add(pc, entry, info, &new_info,
+                                       trans_func, src);
+
+      if (entry) {
+         pipe_buffer_unmap(pc->pipe, src_transfer);
+
+         assert(entry->dst_mode == new_info.mode &&
+                entry->dst_index_size == new_info.index_size &&
+                entry->dst_count == new_info.count);
+         pipe_resource_reference(&new_info.index.resource, entry->dst);
+         new_info.start = 0;
+
+         pc->pipe->draw_vbo(pc->pipe, &new_info);
+
+         pipe_resource_reference(&new_info.index.resource, NULL);
+         return;
+      }
+   }
+
    u_upload_alloc(pc->pipe->stream_uploader, 0, new_info.index_size * new_info.count, 4,
                   &ib_offset, &new_info.index.resource, &dst);
    new_info.start = ib_offset / new_info.index_size;
@@ -27,10 +27,18 @@
  **************************************************************************/
 
 #include "pb_cache.h"
+#include "util/u_atomic.h"
+#include "util/u_math.h"
 #include "util/u_memory.h"
 #include "util/os_time.h"
 
 
+static inline unsigned
+pb_cache_size_class(pb_size size)
+{
+   return size ? util_logbase2_64(size) : 0;
+}
+
 /**
  * Actually destroy the buffer.
  */
@@ -43,9 +51,9 @@ destroy_buffer_locked(struct pb_cache_entry *entry)
    assert(!pipe_is_referenced(&buf->reference));
    if (entry->head.next) {
       LIST_DEL(&entry->head);
-      assert(mgr->num_buffers);
-      --mgr->num_buffers;
-      mgr->cache_size -= buf->size;
+      assert(p_atomic_read(&mgr->num_buffers));
+      p_atomic_dec(&mgr->num_buffers);
+      p_atomic_add(&mgr->cache_size, -(int64_t)buf->size);
    }
    mgr->destroy_buffer(buf);
 }
@@ -75,6 +83,35 @@ release_expired_buffers_locked(struct list_head *cache,
    }
 }
 
+/**
+ * Free the expired buffers of all buckets, at most a few times per expiry
+ * period unless \p force is set.  Whoever gets here first does the work,
+ * everybody else goes on.  Must be called without holding a bucket lock.
+ */
+static void
+release_expired_buffers(struct pb_cache *mgr, int64_t current_time,
+                        bool force)
+{
+   int64_t next_sweep = p_atomic_read(&mgr->next_sweep);
+
+   if (!force && current_time < next_sweep)
+      return;
+
+   if (p_atomic_cmpxchg(&mgr->next_sweep, next_sweep,
+                        current_time + mgr->usecs / 4) != next_sweep)
+      return;
+
+   for (unsigned i = 0; i < mgr->num_heaps; i++) {
+      struct pb_cache_bucket *bucket = &mgr->buckets[i];
+
+      mtx_lock(&bucket->mutex);
+      for (unsigned c = 0; c < PB_CACHE_NUM_SIZE_CLASSES; c++)
+         release_expired_buffers_locked(&bucket->size_classes[c],
+                                        current_time);
+      mtx_unlock(&bucket->mutex);
+   }
+}
+
 /**
  * Add a buffer to the cache. This is typically done when the buffer is
  * being released.
@@ -83,31 +120,36 @@ void
 pb_cache_add_buffer(struct pb_cache_entry *entry)
 {
    struct pb_cache *mgr = entry->mgr;
-   struct list_head *cache = &mgr->buckets[entry->bucket_index];
+   struct pb_cache_bucket *bucket = &mgr->buckets[entry->bucket_index];
    struct pb_buffer *buf = entry->buffer;
-   unsigned i;
+   struct list_head *cache =
+      &bucket->size_classes[pb_cache_size_class(buf->size)];
 
-   mtx_lock(&mgr->mutex);
    assert(!pipe_is_referenced(&buf->reference));
 
    int64_t current_time = os_time_get();
 
-   for (i = 0; i < mgr->num_heaps; i++)
-      release_expired_buffers_locked(&mgr->buckets[i], current_time);
+   /* Under memory pressure, make room by dropping everything that has
+    * expired before giving up on caching this buffer.
+    */
+   bool full = p_atomic_read(&mgr->cache_size) + buf->size > mgr->max_cache_size;
+   release_expired_buffers(mgr, current_time, full);
 
    /* Directly release any buffer that exceeds the limit. */
-   if (mgr->cache_size + buf->size > mgr->max_cache_size) {
+   if (p_atomic_read(&mgr->cache_size) + buf->size > mgr->max_cache_size) {
       mgr->destroy_buffer(buf);
-      mtx_unlock(&mgr->mutex);
       return;
    }
 
-   entry->start = os_time_get();
+   mtx_lock(&bucket->mutex);
+   release_expired_buffers_locked(cache, current_time);
+
+   entry->start = current_time;
    entry->end = entry->start + mgr->usecs;
    LIST_ADDTAIL(&entry->head, cache);
-   ++mgr->num_buffers;
-   mgr->cache_size += buf->size;
-   mtx_unlock(&mgr->mutex);
+   p_atomic_inc(&mgr->num_buffers);
+   p_atomic_add(&mgr->cache_size, buf->size);
+   mtx_unlock(&bucket->mutex);
 }
 
 /**
@@ -127,7 +169,7 @@ pb_cache_is_buffer_compat(struct pb_cache_entry *entry,
 
    /* be lenient with size */
    if (buf->size < size ||
-       buf->size > (unsigned) (mgr->size_factor * size))
+       buf->size > (pb_size) (mgr->size_factor * size))
       return 0;
 
    if (usage & mgr->bypass_usage)
@@ -140,31 +182,23 @@ pb_cache_is_buffer_compat(struct pb_cache_entry *entry,
 }
 
 /**
- * Find a compatible buffer in the cache, return it, and remove it
- * from the cache.
+ * Find a compatible buffer in one size class, freeing expired buffers on
+ * the way.
  */
-struct pb_buffer *
-pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
-                        unsigned alignment, unsigned usage,
-                        unsigned bucket_index)
+static struct pb_cache_entry *
+pb_cache_search_locked(struct list_head *cache, pb_size size,
+                       unsigned alignment, unsigned usage, int64_t now)
 {
    struct pb_cache_entry *entry;
    struct pb_cache_entry *cur_entry;
    struct list_head *cur, *next;
-   int64_t now;
    int ret = 0;
 
-   assert(bucket_index < mgr->num_heaps);
-   struct list_head *cache = &mgr->buckets[bucket_index];
-
-   mtx_lock(&mgr->mutex);
-
    entry = NULL;
    cur = cache->next;
    next = cur->next;
 
    /* search in the expired buffers, freeing them in the process */
-   now = os_time_get();
    while (cur != cache) {
       cur_entry = LIST_ENTRY(struct pb_cache_entry, cur, head);
 
@@ -203,20 +237,56 @@ pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
       }
    }
 
+   return entry;
+}
+
+/**
+ * Find a compatible buffer in the cache, return it, and remove it
+ * from the cache.
+ */
+struct pb_buffer *
+pb_cache_reclaim_buffer(struct pb_cache *mgr, pb_size size,
+                        unsigned alignment, unsigned usage,
+                        unsigned bucket_index)
+{
+   struct pb_cache_entry *entry = NULL;
+   unsigned first_class, last_class;
+   int64_t now;
+
+   assert(bucket_index < mgr->num_heaps);
+   struct pb_cache_bucket *bucket = &mgr->buckets[bucket_index];
+
+   /* Only the size classes which can hold buffers within size_factor of
+    * the requested size need to be looked at.
+    */
+   first_class = pb_cache_size_class(size);
+   last_class = MIN2(pb_cache_size_class((pb_size) (mgr->size_factor * size)),
+                     PB_CACHE_NUM_SIZE_CLASSES - 1);
+
+   now = os_time_get();
+   release_expired_buffers(mgr, now, false);
+
+   mtx_lock(&bucket->mutex);
+
+   for (unsigned c = first_class; c <= last_class && !entry; c++) {
+      entry = pb_cache_search_locked(&bucket->size_classes[c], size,
+                                     alignment, usage, now);
+   }
+
    /* found a compatible buffer, return it */
    if (entry) {
       struct pb_buffer *buf = entry->buffer;
 
-      mgr->cache_size -= buf->size;
+      p_atomic_add(&mgr->cache_size, -(int64_t)buf->size);
       LIST_DEL(&entry->head);
-      --mgr->num_buffers;
-      mtx_unlock(&mgr->mutex);
+      p_atomic_dec(&mgr->num_buffers);
+      mtx_unlock(&bucket->mutex);
       /* Increase refcount */
       pipe_reference_init(&buf->reference, 1);
       return buf;
    }
 
-   mtx_unlock(&mgr->mutex);
+   mtx_unlock(&bucket->mutex);
    return NULL;
 }
 
@@ -228,22 +298,26 @@ pb_cache_release_all_buffers(struct pb_cache *mgr)
 {
    struct list_head *curr, *next;
    struct pb_cache_entry *buf;
-   unsigned i;
+   unsigned i, c;
 
-   mtx_lock(&mgr->mutex);
    for (i = 0; i < mgr->num_heaps; i++) {
-      struct list_head *cache = &mgr->buckets[i];
+      struct pb_cache_bucket *bucket = &mgr->buckets[i];
 
-      curr = cache->next;
-      next = curr->next;
-      while (curr != cache) {
-         buf = LIST_ENTRY(struct pb_cache_entry, curr, head);
-         destroy_buffer_locked(buf);
-         curr = next;
+      mtx_lock(&bucket->mutex);
+      for (c = 0; c < PB_CACHE_NUM_SIZE_CLASSES; c++) {
+         struct list_head *cache = &bucket->size_classes[c];
+
+         curr = cache->next;
          next = curr->next;
+         while (curr != cache) {
+            buf = LIST_ENTRY(struct pb_cache_entry, curr, head);
+            destroy_buffer_locked(buf);
+            curr = next;
+            next = curr->next;
+         }
       }
+      mtx_unlock(&bucket->mutex);
    }
-   mtx_unlock(&mgr->mutex);
 }
 
 void
@@ -283,18 +357,21 @@ pb_cache_init(struct pb_cache *mgr, uint num_heaps,
               void (*destroy_buffer)(struct pb_buffer *buf),
               bool (*can_reclaim)(struct pb_buffer *buf))
 {
-   unsigned i;
+   unsigned i, c;
 
-   mgr->buckets = CALLOC(num_heaps, sizeof(struct list_head));
+   mgr->buckets = CALLOC(num_heaps, sizeof(struct pb_cache_bucket));
    if (!mgr->buckets)
       return;
 
-   for (i = 0; i < num_heaps; i++)
-      LIST_INITHEAD(&mgr->buckets[i]);
+   for (i = 0; i < num_heaps; i++) {
+      (void) mtx_init(&mgr->buckets[i].mutex, mtx_plain);
+      for (c = 0; c < PB_CACHE_NUM_SIZE_CLASSES; c++)
+         LIST_INITHEAD(&mgr->buckets[i].size_classes[c]);
+   }
 
-   (void) mtx_init(&mgr->mutex, mtx_plain);
    mgr->cache_size = 0;
    mgr->max_cache_size = maximum_cache_size;
+   mgr->next_sweep = 0;
    mgr->num_heaps = num_heaps;
    mgr->usecs = usecs;
    mgr->num_buffers = 0;
@@ -311,7 +388,8 @@ void
 pb_cache_deinit(struct pb_cache *mgr)
 {
    pb_cache_release_all_buffers(mgr);
-   mtx_destroy(&mgr->mutex);
+   for (unsigned i = 0; i < mgr->num_heaps; i++)
+      mtx_destroy(&mgr->buckets[i].mutex);
    FREE(mgr->buckets);
    mgr->buckets = NULL;
 }
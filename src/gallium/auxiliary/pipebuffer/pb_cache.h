@@ -45,19 +45,30 @@ struct pb_cache_entry
    unsigned bucket_index;
 };
 
+/* Buffers of size [2^i, 2^(i+1)) are in size class i */
+#define PB_CACHE_NUM_SIZE_CLASSES 64
+
+struct pb_cache_bucket
+{
+   mtx_t mutex;
+   /* Each list is sorted by the time the buffers were added */
+   struct list_head size_classes[PB_CACHE_NUM_SIZE_CLASSES];
+};
+
 struct pb_cache
 {
    /* The cache is divided into buckets for minimizing cache misses.
-    * The driver controls which buffer goes into which bucket.
+    * The driver controls which buffer goes into which bucket.  Each bucket
+    * has its own lock.
     */
-   struct list_head *buckets;
+   struct pb_cache_bucket *buckets;
 
-   mtx_t mutex;
-   uint64_t cache_size;
+   uint64_t cache_size; /**< atomic */
    uint64_t max_cache_size;
+   int64_t next_sweep; /**< atomic, when to release expired buffers next */
    unsigned num_heaps;
    unsigned usecs;
-   unsigned num_buffers;
+   unsigned num_buffers; /**< atomic */
    unsigned bypass_usage;
    float size_factor;
 
@@ -78,6 +78,7 @@ bool pp_celshade_init(struct pp_queue_t *, unsigned int, unsigned int);
 bool pp_nored_init(struct pp_queue_t *, unsigned int, unsigned int);
 bool pp_nogreen_init(struct pp_queue_t *, unsigned int, unsigned int);
 bool pp_noblue_init(struct pp_queue_t *, unsigned int, unsigned int);
+bool pp_nocolor_init_mask(struct pp_queue_t *, unsigned int, unsigned int);
 
 bool pp_jimenezmlaa_init(struct pp_queue_t *, unsigned int, unsigned int);
 bool pp_jimenezmlaa_init_color(struct pp_queue_t *, unsigned int,
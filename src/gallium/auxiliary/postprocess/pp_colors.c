@@ -30,6 +30,8 @@
 #include "postprocess/pp_filters.h"
 #include "postprocess/pp_private.h"
 
+#include "util/u_string.h"
+
 /** The run function of the color filters */
 void
 pp_nocolor(struct pp_queue_t *ppq, struct pipe_resource *in,
@@ -58,33 +60,55 @@ pp_nocolor(struct pp_queue_t *ppq, struct pipe_resource *in,
 
 /* Init functions */
 
+/**
+ * Init a filter zeroing the channels of mask (TGSI_WRITEMASK_*).  Runs of
+ * channel filters in the queue are merged into one of these, so that they
+ * take a single pass over the frame.
+ */
 bool
-pp_nored_init(struct pp_queue_t *ppq, unsigned int n, unsigned int val)
+pp_nocolor_init_mask(struct pp_queue_t *ppq, unsigned int n, unsigned int mask)
 {
+   char text[sizeof(nocolor) + 4];
+   char channels[4];
+   unsigned int i = 0;
+
+   assert(mask && !(mask & ~(TGSI_WRITEMASK_XYZ)));
+
+   if (mask & TGSI_WRITEMASK_X)
+      channels[i++] = 'x';
+   if (mask & TGSI_WRITEMASK_Y)
+      channels[i++] = 'y';
+   if (mask & TGSI_WRITEMASK_Z)
+      channels[i++] = 'z';
+   channels[i] = 0;
+
+   util_snprintf(text, sizeof(text), nocolor, channels);
+
    ppq->shaders[n][1] =
-      pp_tgsi_to_state(ppq->p->pipe, nored, false, "nored");
+      pp_tgsi_to_state(ppq->p->pipe, text, false, "nocolor");
 
    return (ppq->shaders[n][1] != NULL) ? TRUE : FALSE;
 }
 
 
 bool
-pp_nogreen_init(struct pp_queue_t *ppq, unsigned int n, unsigned int val)
+pp_nored_init(struct pp_queue_t *ppq, unsigned int n, unsigned int val)
 {
-   ppq->shaders[n][1] =
-      pp_tgsi_to_state(ppq->p->pipe, nogreen, false, "nogreen");
+   return pp_nocolor_init_mask(ppq, n, TGSI_WRITEMASK_X);
+}
 
-   return (ppq->shaders[n][1] != NULL) ? TRUE : FALSE;
+
+bool
+pp_nogreen_init(struct pp_queue_t *ppq, unsigned int n, unsigned int val)
+{
+   return pp_nocolor_init_mask(ppq, n, TGSI_WRITEMASK_Y);
 }
 
 
 bool
 pp_noblue_init(struct pp_queue_t *ppq, unsigned int n, unsigned int val)
 {
-   ppq->shaders[n][1] =
-      pp_tgsi_to_state(ppq->p->pipe, noblue, false, "noblue");
-
-   return (ppq->shaders[n][1] != NULL) ? TRUE : FALSE;
+   return pp_nocolor_init_mask(ppq, n, TGSI_WRITEMASK_Z);
 }
 
 /* Free functions */
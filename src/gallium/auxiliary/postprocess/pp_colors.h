@@ -28,7 +28,8 @@
 #ifndef PP_COLORS_H
 #define PP_COLORS_H
 
-static const char nored[] = "FRAG\n"
+/* Zeroes the channels in the %s writemask */
+static const char nocolor[] = "FRAG\n"
    "PROPERTY FS_COLOR0_WRITES_ALL_CBUFS 1\n"
    "DCL IN[0], GENERIC[0], PERSPECTIVE\n"
    "DCL OUT[0], COLOR\n"
@@ -37,35 +38,7 @@ static const char nored[] = "FRAG\n"
    "DCL TEMP[0]\n"
    "IMM FLT32 {    0.0000,     0.0000,     0.0000,     0.0000}\n"
    "  0: TEX TEMP[0], IN[0].xyyy, SAMP[0], 2D\n"
-   "  1: MOV TEMP[0].x, IMM[0].xxxx\n"
-   "  2: MOV OUT[0], TEMP[0]\n"
-   "  3: END\n";
-
-
-static const char nogreen[] = "FRAG\n"
-   "PROPERTY FS_COLOR0_WRITES_ALL_CBUFS 1\n"
-   "DCL IN[0], GENERIC[0], PERSPECTIVE\n"
-   "DCL OUT[0], COLOR\n"
-   "DCL SAMP[0]\n"
-   "DCL SVIEW[0], 2D, FLOAT\n"
-   "DCL TEMP[0]\n"
-   "IMM FLT32 {    0.0000,     0.0000,     0.0000,     0.0000}\n"
-   "  0: TEX TEMP[0], IN[0].xyyy, SAMP[0], 2D\n"
-   "  1: MOV TEMP[0].y, IMM[0].xxxx\n"
-   "  2: MOV OUT[0], TEMP[0]\n"
-   "  3: END\n";
-
-
-static const char noblue[] = "FRAG\n"
-   "PROPERTY FS_COLOR0_WRITES_ALL_CBUFS 1\n"
-   "DCL IN[0], GENERIC[0], PERSPECTIVE\n"
-   "DCL OUT[0], COLOR\n"
-   "DCL SAMP[0]\n"
-   "DCL SVIEW[0], 2D, FLOAT\n"
-   "DCL TEMP[0]\n"
-   "IMM FLT32 {    0.0000,     0.0000,     0.0000,     0.0000}\n"
-   "  0: TEX TEMP[0], IN[0].xyyy, SAMP[0], 2D\n"
-   "  1: MOV TEMP[0].z, IMM[0].xxxx\n"
+   "  1: MOV TEMP[0].%s, IMM[0].xxxx\n"
    "  2: MOV OUT[0], TEMP[0]\n"
    "  3: END\n";
 
@@ -37,6 +37,19 @@
 #include "util/u_memory.h"
 #include "cso_cache/cso_context.h"
 
+/** The channels filter i zeroes, 0 if it isn't one of the channel filters. */
+static unsigned int
+pp_filter_channels(unsigned int i)
+{
+   if (pp_filters[i].init == pp_nored_init)
+      return TGSI_WRITEMASK_X;
+   if (pp_filters[i].init == pp_nogreen_init)
+      return TGSI_WRITEMASK_Y;
+   if (pp_filters[i].init == pp_noblue_init)
+      return TGSI_WRITEMASK_Z;
+   return 0;
+}
+
 /** Initialize the post-processing queue. */
 struct pp_queue_t *
 pp_init(struct pipe_context *pipe, const unsigned int *enabled,
@@ -88,6 +101,17 @@ pp_init(struct pipe_context *pipe, const unsigned int *enabled,
    curpos = 0;
    for (i = 0; i < PP_FILTERS; i++) {
       if (enabled[i]) {
+         unsigned int channels = pp_filter_channels(i);
+         unsigned int last = i;
+         bool ok;
+
+         /* Channel filters only touch their own pixel, so a run of them
+          * is folded into a single pass zeroing all their channels.
+          */
+         while (channels && last + 1 < PP_FILTERS && enabled[last + 1] &&
+                pp_filter_channels(last + 1))
+            channels |= pp_filter_channels(++last);
+
          ppq->pp_queue[curpos] = pp_filters[i].main;
          tmp_req = MAX2(tmp_req, pp_filters[i].inner_tmps);
          ppq->filters[curpos] = i;
@@ -102,11 +126,18 @@ pp_init(struct pipe_context *pipe, const unsigned int *enabled,
          }
 
          /* Call the initialization function for the filter. */
-         if (!pp_filters[i].init(ppq, curpos, enabled[i])) {
+         if (channels)
+            ok = pp_nocolor_init_mask(ppq, curpos, channels);
+         else
+            ok = pp_filters[i].init(ppq, curpos, enabled[i]);
+
+         if (!ok) {
             pp_debug("Initialization for filter %u failed.\n", i);
             goto error;
-         }           
+         }
 
+         /* Skip the filters merged into this one. */
+         i = last;
          curpos++;
       }
    }
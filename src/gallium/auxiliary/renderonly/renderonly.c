@@ -37,6 +37,9 @@
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 
+/* Number of freed dumb buffers kept for reuse */
+#define RENDERONLY_CACHE_SIZE 8
+
 struct renderonly *
 renderonly_dup(const struct renderonly *ro)
 {
@@ -48,12 +51,16 @@ renderonly_dup(const struct renderonly *ro)
 
    memcpy(copy, ro, sizeof(*ro));
 
+   (void) mtx_init(&copy->cache_lock, mtx_plain);
+   list_inithead(&copy->cache);
+   copy->cache_count = 0;
+
    return copy;
 }
 
-void
-renderonly_scanout_destroy(struct renderonly_scanout *scanout,
-			   struct renderonly *ro)
+static void
+renderonly_scanout_free(struct renderonly_scanout *scanout,
+                        struct renderonly *ro)
 {
    struct drm_mode_destroy_dumb destroy_dumb = { };
 
@@ -64,6 +71,69 @@ renderonly_scanout_destroy(struct renderonly_scanout *scanout,
    FREE(scanout);
 }
 
+void
+renderonly_destroy(struct renderonly *ro)
+{
+   list_for_each_entry_safe(struct renderonly_scanout, scanout,
+                            &ro->cache, cache_link) {
+      list_del(&scanout->cache_link);
+      renderonly_scanout_free(scanout, ro);
+   }
+
+   mtx_destroy(&ro->cache_lock);
+   FREE(ro);
+}
+
+void
+renderonly_scanout_destroy(struct renderonly_scanout *scanout,
+			   struct renderonly *ro)
+{
+   struct renderonly_scanout *evict = NULL;
+
+   /* Compositors reallocate their surfaces on every resize, and creating
+    * a dumb buffer means allocating and clearing contiguous memory in the
+    * KMS driver.  Keep a few of them around instead.
+    */
+   if (!scanout->bpp || ro->kms_fd == -1) {
+      renderonly_scanout_free(scanout, ro);
+      return;
+   }
+
+   mtx_lock(&ro->cache_lock);
+   list_add(&scanout->cache_link, &ro->cache);
+   if (++ro->cache_count > RENDERONLY_CACHE_SIZE) {
+      evict = LIST_ENTRY(struct renderonly_scanout, ro->cache.prev, cache_link);
+      list_del(&evict->cache_link);
+      ro->cache_count--;
+   }
+   mtx_unlock(&ro->cache_lock);
+
+   if (evict)
+      renderonly_scanout_free(evict, ro);
+}
+
+static struct renderonly_scanout *
+renderonly_cache_lookup(struct renderonly *ro, uint32_t width,
+                        uint32_t height, uint32_t bpp)
+{
+   struct renderonly_scanout *found = NULL;
+
+   mtx_lock(&ro->cache_lock);
+   list_for_each_entry(struct renderonly_scanout, scanout, &ro->cache,
+                       cache_link) {
+      if (scanout->width == width && scanout->height == height &&
+          scanout->bpp == bpp) {
+         list_del(&scanout->cache_link);
+         ro->cache_count--;
+         found = scanout;
+         break;
+      }
+   }
+   mtx_unlock(&ro->cache_lock);
+
+   return found;
+}
+
 struct renderonly_scanout *
 renderonly_create_kms_dumb_buffer_for_resource(struct pipe_resource *rsc,
                                                struct renderonly *ro,
@@ -76,48 +146,47 @@ renderonly_create_kms_dumb_buffer_for_resource(struct pipe_resource *rsc,
       .height = rsc->height0,
       .bpp = util_format_get_blocksizebits(rsc->format),
    };
-   struct drm_mode_destroy_dumb destroy_dumb = { };
-
-   scanout = CALLOC_STRUCT(renderonly_scanout);
-   if (!scanout)
-      return NULL;
 
-   /* create dumb buffer at scanout GPU */
-   err = drmIoctl(ro->kms_fd, DRM_IOCTL_MODE_CREATE_DUMB, &create_dumb);
-   if (err < 0) {
-      fprintf(stderr, "DRM_IOCTL_MODE_CREATE_DUMB failed: %s\n",
-            strerror(errno));
-      goto free_scanout;
+   scanout = renderonly_cache_lookup(ro, create_dumb.width, create_dumb.height,
+                                     create_dumb.bpp);
+   if (!scanout) {
+      scanout = CALLOC_STRUCT(renderonly_scanout);
+      if (!scanout)
+         return NULL;
+
+      /* create dumb buffer at scanout GPU */
+      err = drmIoctl(ro->kms_fd, DRM_IOCTL_MODE_CREATE_DUMB, &create_dumb);
+      if (err < 0) {
+         fprintf(stderr, "DRM_IOCTL_MODE_CREATE_DUMB failed: %s\n",
+               strerror(errno));
+         FREE(scanout);
+         return NULL;
+      }
+
+      scanout->handle = create_dumb.handle;
+      scanout->stride = create_dumb.pitch;
+      scanout->width = create_dumb.width;
+      scanout->height = create_dumb.height;
+      scanout->bpp = create_dumb.bpp;
    }
 
-   scanout->handle = create_dumb.handle;
-   scanout->stride = create_dumb.pitch;
-
    if (!out_handle)
       return scanout;
 
    /* fill in winsys handle */
    memset(out_handle, 0, sizeof(*out_handle));
    out_handle->type = WINSYS_HANDLE_TYPE_FD;
-   out_handle->stride = create_dumb.pitch;
+   out_handle->stride = scanout->stride;
 
-   err = drmPrimeHandleToFD(ro->kms_fd, create_dumb.handle, O_CLOEXEC,
+   err = drmPrimeHandleToFD(ro->kms_fd, scanout->handle, O_CLOEXEC,
          (int *)&out_handle->handle);
    if (err < 0) {
       fprintf(stderr, "failed to export dumb buffer: %s\n", strerror(errno));
-      goto free_dumb;
+      renderonly_scanout_free(scanout, ro);
+      return NULL;
    }
 
    return scanout;
-
-free_dumb:
-   destroy_dumb.handle = scanout->handle;
-   drmIoctl(ro->kms_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy_dumb);
-
-free_scanout:
-   FREE(scanout);
-
-   return NULL;
 }
 
 struct renderonly_scanout *
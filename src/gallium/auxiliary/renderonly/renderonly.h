@@ -28,12 +28,18 @@
 #define RENDERONLY_H
 
 #include <stdint.h>
+#include "c11/threads.h"
 #include "state_tracker/drm_driver.h"
 #include "pipe/p_state.h"
+#include "util/list.h"
 
 struct renderonly_scanout {
    uint32_t handle;
    uint32_t stride;
+
+   /* Dumb buffer parameters, bpp is 0 for imported GPU buffers. */
+   uint32_t width, height, bpp;
+   struct list_head cache_link;
 };
 
 struct renderonly {
@@ -61,11 +67,21 @@ struct renderonly {
                                                      struct winsys_handle *out_handle);
    int kms_fd;
    int gpu_fd;
+
+   /* Recently freed dumb buffers, reused for new scanout resources of the
+    * same size and format.  Only valid in copies made by renderonly_dup().
+    */
+   mtx_t cache_lock;
+   struct list_head cache;
+   unsigned cache_count;
 };
 
 struct renderonly *
 renderonly_dup(const struct renderonly *ro);
 
+void
+renderonly_destroy(struct renderonly *ro);
+
 static inline struct renderonly_scanout *
 renderonly_scanout_for_resource(struct pipe_resource *rsc,
                                 struct renderonly *ro,
@@ -63,6 +63,10 @@
 #include "util/u_math.h"
 #include "util/rounding.h"
 
+#if defined(PIPE_ARCH_SSE)
+#include <xmmintrin.h>
+#endif
+
 
 #define DEBUG_EXECUTION 0
 
@@ -90,10 +94,15 @@ static void
 micro_abs(union tgsi_exec_channel *dst,
           const union tgsi_exec_channel *src)
 {
+#if defined(PIPE_ARCH_SSE)
+   const __m128 sign = _mm_set1_ps(-0.0f);
+   _mm_storeu_ps(dst->f, _mm_andnot_ps(sign, _mm_loadu_ps(src->f)));
+#else
    dst->f[0] = fabsf(src->f[0]);
    dst->f[1] = fabsf(src->f[1]);
    dst->f[2] = fabsf(src->f[2]);
    dst->f[3] = fabsf(src->f[3]);
+#endif
 }
 
 static void
@@ -508,10 +517,16 @@ micro_mad(union tgsi_exec_channel *dst,
           const union tgsi_exec_channel *src1,
           const union tgsi_exec_channel *src2)
 {
+#if defined(PIPE_ARCH_SSE)
+   _mm_storeu_ps(dst->f, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(src0->f),
+                                               _mm_loadu_ps(src1->f)),
+                                    _mm_loadu_ps(src2->f)));
+#else
    dst->f[0] = src0->f[0] * src1->f[0] + src2->f[0];
    dst->f[1] = src0->f[1] * src1->f[1] + src2->f[1];
    dst->f[2] = src0->f[2] * src1->f[2] + src2->f[2];
    dst->f[3] = src0->f[3] * src1->f[3] + src2->f[3];
+#endif
 }
 
 static void
@@ -1384,10 +1399,14 @@ micro_add(union tgsi_exec_channel *dst,
           const union tgsi_exec_channel *src0,
           const union tgsi_exec_channel *src1)
 {
+#if defined(PIPE_ARCH_SSE)
+   _mm_storeu_ps(dst->f, _mm_add_ps(_mm_loadu_ps(src0->f), _mm_loadu_ps(src1->f)));
+#else
    dst->f[0] = src0->f[0] + src1->f[0];
    dst->f[1] = src0->f[1] + src1->f[1];
    dst->f[2] = src0->f[2] + src1->f[2];
    dst->f[3] = src0->f[3] + src1->f[3];
+#endif
 }
 
 static void
@@ -1429,10 +1448,15 @@ micro_max(union tgsi_exec_channel *dst,
           const union tgsi_exec_channel *src0,
           const union tgsi_exec_channel *src1)
 {
+#if defined(PIPE_ARCH_SSE)
+   /* _mm_max_ps returns the second operand for NaNs, like the C below. */
+   _mm_storeu_ps(dst->f, _mm_max_ps(_mm_loadu_ps(src0->f), _mm_loadu_ps(src1->f)));
+#else
    dst->f[0] = src0->f[0] > src1->f[0] ? src0->f[0] : src1->f[0];
    dst->f[1] = src0->f[1] > src1->f[1] ? src0->f[1] : src1->f[1];
    dst->f[2] = src0->f[2] > src1->f[2] ? src0->f[2] : src1->f[2];
    dst->f[3] = src0->f[3] > src1->f[3] ? src0->f[3] : src1->f[3];
+#endif
 }
 
 static void
@@ -1440,10 +1464,15 @@ micro_min(union tgsi_exec_channel *dst,
           const union tgsi_exec_channel *src0,
           const union tgsi_exec_channel *src1)
 {
+#if defined(PIPE_ARCH_SSE)
+   /* _mm_min_ps returns the second operand for NaNs, like the C below. */
+   _mm_storeu_ps(dst->f, _mm_min_ps(_mm_loadu_ps(src0->f), _mm_loadu_ps(src1->f)));
+#else
    dst->f[0] = src0->f[0] < src1->f[0] ? src0->f[0] : src1->f[0];
    dst->f[1] = src0->f[1] < src1->f[1] ? src0->f[1] : src1->f[1];
    dst->f[2] = src0->f[2] < src1->f[2] ? src0->f[2] : src1->f[2];
    dst->f[3] = src0->f[3] < src1->f[3] ? src0->f[3] : src1->f[3];
+#endif
 }
 
 static void
@@ -1451,10 +1480,14 @@ micro_mul(union tgsi_exec_channel *dst,
           const union tgsi_exec_channel *src0,
           const union tgsi_exec_channel *src1)
 {
+#if defined(PIPE_ARCH_SSE)
+   _mm_storeu_ps(dst->f, _mm_mul_ps(_mm_loadu_ps(src0->f), _mm_loadu_ps(src1->f)));
+#else
    dst->f[0] = src0->f[0] * src1->f[0];
    dst->f[1] = src0->f[1] * src1->f[1];
    dst->f[2] = src0->f[2] * src1->f[2];
    dst->f[3] = src0->f[3] * src1->f[3];
+#endif
 }
 
 static void
@@ -1462,10 +1495,15 @@ micro_neg(
    union tgsi_exec_channel *dst,
    const union tgsi_exec_channel *src )
 {
+#if defined(PIPE_ARCH_SSE)
+   const __m128 sign = _mm_set1_ps(-0.0f);
+   _mm_storeu_ps(dst->f, _mm_xor_ps(sign, _mm_loadu_ps(src->f)));
+#else
    dst->f[0] = -src->f[0];
    dst->f[1] = -src->f[1];
    dst->f[2] = -src->f[2];
    dst->f[3] = -src->f[3];
+#endif
 }
 
 static void
@@ -1503,10 +1541,14 @@ micro_sub(union tgsi_exec_channel *dst,
           const union tgsi_exec_channel *src0,
           const union tgsi_exec_channel *src1)
 {
+#if defined(PIPE_ARCH_SSE)
+   _mm_storeu_ps(dst->f, _mm_sub_ps(_mm_loadu_ps(src0->f), _mm_loadu_ps(src1->f)));
+#else
    dst->f[0] = src0->f[0] - src1->f[0];
    dst->f[1] = src0->f[1] - src1->f[1];
    dst->f[2] = src0->f[2] - src1->f[2];
    dst->f[3] = src0->f[3] - src1->f[3];
+#endif
 }
 
 static void
@@ -1767,10 +1809,70 @@ fetch_source_d(const struct tgsi_exec_machine *mach,
    union tgsi_exec_channel index2D;
    uint swizzle;
 
-   get_index_registers(mach, reg, &index, &index2D);
+   swizzle = tgsi_util_get_full_src_register_swizzle( reg, chan_index );
 
+   /* Directly addressed registers are the same for all four pixels, so
+    * copy the whole channel instead of building per-pixel index vectors.
+    */
+   if (!reg->Register.Indirect) {
+      const int index1D = reg->Register.Index;
+
+      switch (reg->Register.File) {
+      case TGSI_FILE_TEMPORARY:
+         if (reg->Register.Dimension)
+            break;
+         assert(index1D >= 0 && index1D < TGSI_EXEC_NUM_TEMPS);
+         *chan = mach->Temps[index1D].xyzw[swizzle];
+         return;
+
+      case TGSI_FILE_IMMEDIATE:
+         if (reg->Register.Dimension)
+            break;
+         assert(index1D >= 0 && index1D < (int)mach->ImmLimit);
+         chan->f[0] =
+         chan->f[1] =
+         chan->f[2] =
+         chan->f[3] = mach->Imms[index1D][swizzle];
+         return;
+
+      case TGSI_FILE_INPUT:
+         if (reg->Register.Dimension)
+            break;
+         assert(index1D >= 0);
+         *chan = mach->Inputs[index1D].xyzw[swizzle];
+         return;
+
+      case TGSI_FILE_CONSTANT:
+         if (reg->Register.Dimension && reg->Dimension.Indirect)
+            break;
+         else {
+            const uint constbuf =
+               reg->Register.Dimension ? reg->Dimension.Index : 0;
+            const int pos = index1D * 4 + swizzle;
+
+            assert(constbuf < PIPE_MAX_CONSTANT_BUFFERS);
+            assert(mach->Consts[constbuf]);
+
+            /* same bounds check as fetch_src_file_channel() */
+            if (index1D < 0 || pos >= (int) mach->ConstsSize[constbuf]) {
+               chan->u[0] = chan->u[1] = chan->u[2] = chan->u[3] = 0;
+            } else {
+               const uint *buf = (const uint *)mach->Consts[constbuf];
+               chan->u[0] =
+               chan->u[1] =
+               chan->u[2] =
+               chan->u[3] = buf[pos];
+            }
+         }
+         return;
+
+      default:
+         break;
+      }
+   }
+
+   get_index_registers(mach, reg, &index, &index2D);
 
-   swizzle = tgsi_util_get_full_src_register_swizzle( reg, chan_index );
    fetch_src_file_channel(mach,
                           reg->Register.File,
                           swizzle,
@@ -2010,6 +2112,10 @@ store_dest(struct tgsi_exec_machine *mach,
       return;
 
    if (!inst->Instruction.Saturate) {
+      if (execmask == (1 << TGSI_QUAD_SIZE) - 1) {
+         *dst = *chan;
+         return;
+      }
       for (i = 0; i < TGSI_QUAD_SIZE; i++)
          if (execmask & (1 << i))
             dst->i[i] = chan->i[i];
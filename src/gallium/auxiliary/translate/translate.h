@@ -112,6 +112,12 @@ struct translate {
 
    void (*release)( struct translate * );
 
+   /**
+    * Create a copy with its own buffer state, sharing the generated code.
+    * The copy must be released before the original.
+    */
+   struct translate *(*clone)( const struct translate * );
+
    void (*set_buffer)( struct translate *,
 		       unsigned i,
 		       const void *ptr,
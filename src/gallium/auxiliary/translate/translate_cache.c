@@ -25,6 +25,7 @@
  *
  **************************************************************************/
 
+#include "c11/threads.h"
 #include "util/u_memory.h"
 #include "pipe/p_state.h"
 #include "translate.h"
@@ -37,21 +38,20 @@ struct translate_cache {
    struct cso_hash *hash;
 };
 
-struct translate_cache * translate_cache_create( void )
-{
-   struct translate_cache *cache = MALLOC_STRUCT(translate_cache);
-   if (!cache) {
-      return NULL;
-   }
-
-   cache->hash = cso_hash_create();
-   return cache;
-}
+/*
+ * The translates are generated once for the whole process, in the shared
+ * hash, and each cache gets its own clones of them: the clones share the
+ * generated code but have their own buffer state, so they can be used by
+ * different contexts at the same time.  The shared translates live as
+ * long as there's a cache.
+ */
+static mtx_t shared_mutex = _MTX_INITIALIZER_NP;
+static struct cso_hash *shared_hash;
+static unsigned shared_refcount;
 
 
-static inline void delete_translates(struct translate_cache *cache)
+static inline void delete_translates(struct cso_hash *hash)
 {
-   struct cso_hash *hash = cache->hash;
    struct cso_hash_iter iter = cso_hash_first_node(hash);
    while (!cso_hash_iter_is_null(iter)) {
       struct translate *state = (struct translate*)cso_hash_iter_data(iter);
@@ -62,11 +62,38 @@ static inline void delete_translates(struct translate_cache *cache)
    }
 }
 
+struct translate_cache * translate_cache_create( void )
+{
+   struct translate_cache *cache = MALLOC_STRUCT(translate_cache);
+   if (!cache) {
+      return NULL;
+   }
+
+   cache->hash = cso_hash_create();
+
+   mtx_lock(&shared_mutex);
+   if (!shared_refcount++)
+      shared_hash = cso_hash_create();
+   mtx_unlock(&shared_mutex);
+
+   return cache;
+}
+
+
 void translate_cache_destroy(struct translate_cache *cache)
 {
-   delete_translates(cache);
+   /* The clones go before what they were cloned from */
+   delete_translates(cache->hash);
    cso_hash_delete(cache->hash);
    FREE(cache);
+
+   mtx_lock(&shared_mutex);
+   if (!--shared_refcount) {
+      delete_translates(shared_hash);
+      cso_hash_delete(shared_hash);
+      shared_hash = NULL;
+   }
+   mtx_unlock(&shared_mutex);
 }
 
 
@@ -97,8 +124,22 @@ struct translate * translate_cache_find(struct translate_cache *cache,
                                        key, sizeof(*key));
 
    if (!translate) {
-      /* create/insert */
-      translate = translate_create(key);
+      struct translate *shared;
+
+      /* find or create/insert the shared one, and clone it */
+      mtx_lock(&shared_mutex);
+      shared = (struct translate*)
+         cso_hash_find_data_from_template(shared_hash,
+                                          hash_key,
+                                          key, sizeof(*key));
+      if (!shared) {
+         shared = translate_create(key);
+         if (shared)
+            cso_hash_insert(shared_hash, hash_key, shared);
+      }
+      translate = shared ? shared->clone(shared) : NULL;
+      mtx_unlock(&shared_mutex);
+
       cso_hash_insert(cache->hash, hash_key, translate);
    }
 
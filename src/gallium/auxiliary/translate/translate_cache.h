@@ -29,7 +29,8 @@
  * Translate cache.
  * Simply used to cache created translates. Avoids unecessary creation of
  * translate's if one suitable for a given translate_key has already been
- * created.
+ * created.  The generated code is shared between all the caches of the
+ * process, the caches themselves aren't thread-safe.
  *
  * Note: this functionality depends and requires the CSO module.
  */
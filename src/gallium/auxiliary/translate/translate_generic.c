@@ -756,6 +756,17 @@ generic_release(struct translate *translate)
    FREE(translate);
 }
 
+static struct translate *
+generic_clone(const struct translate *translate)
+{
+   struct translate_generic *tg = MALLOC_STRUCT(translate_generic);
+
+   if (tg)
+      memcpy(tg, translate, sizeof(*tg));
+
+   return tg ? &tg->translate : NULL;
+}
+
 static boolean
 is_legal_int_format_combo(const struct util_format_description *src,
                           const struct util_format_description *dst)
@@ -790,6 +801,7 @@ translate_generic_create(const struct translate_key *key)
 
    tg->translate.key = *key;
    tg->translate.release = generic_release;
+   tg->translate.clone = generic_clone;
    tg->translate.set_buffer = generic_set_buffer;
    tg->translate.run_elts = generic_run_elts;
    tg->translate.run_elts16 = generic_run_elts16;
@@ -1475,6 +1475,32 @@ translate_sse_release(struct translate *translate)
 }
 
 
+/** Release a clone, which doesn't own the code */
+static void
+translate_sse_release_clone(struct translate *translate)
+{
+   os_free_aligned(translate);
+}
+
+
+static struct translate *
+translate_sse_clone(const struct translate *translate)
+{
+   struct translate_sse *p = os_malloc_aligned(sizeof(struct translate_sse),
+                                               16);
+   if (!p)
+      return NULL;
+
+   /* The generated code only addresses the machine through its first
+    * argument, so the copy can run it on its own state.
+    */
+   memcpy(p, translate, sizeof(*p));
+   p->translate.release = translate_sse_release_clone;
+
+   return &p->translate;
+}
+
+
 struct translate *
 translate_sse2_create(const struct translate_key *key)
 {
@@ -1494,6 +1520,7 @@ translate_sse2_create(const struct translate_key *key)
 
    p->translate.key = *key;
    p->translate.release = translate_sse_release;
+   p->translate.clone = translate_sse_clone;
    p->translate.set_buffer = translate_sse_set_buffer;
 
    assert(key->nr_elements <= TRANSLATE_MAX_ATTRIBS);
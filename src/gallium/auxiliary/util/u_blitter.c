@@ -763,8 +763,10 @@ static void blitter_set_rectangle(struct blitter_context_priv *ctx,
 
    for (i = 0; i < 4; i++)
       ctx->vertices[i][0][2] = depth; /*z*/
+}
 
-   /* viewport */
+static void blitter_set_viewport(struct blitter_context_priv *ctx)
+{
    struct pipe_viewport_state viewport;
    viewport.scale[0] = 0.5f * ctx->dst_width;
    viewport.scale[1] = 0.5f * ctx->dst_height;
@@ -1257,6 +1259,7 @@ static void blitter_draw(struct blitter_context_priv *ctx,
    struct pipe_vertex_buffer vb = {0};
 
    blitter_set_rectangle(ctx, x1, y1, x2, y2, depth);
+   blitter_set_viewport(ctx);
 
    vb.stride = 8 * sizeof(float);
 
@@ -1286,6 +1289,64 @@ static void blitter_draw(struct blitter_context_priv *ctx,
    pipe_resource_reference(&vb.buffer.resource, NULL);
 }
 
+/* Batched rectangles: each one is written to ctx->vertices as usual and
+ * then appended to a triangle list, so that N rectangles take a single
+ * vertex upload and a single draw instead of N of each.
+ */
+static float *blitter_map_rect_list(struct blitter_context_priv *ctx,
+                                    unsigned num_rects,
+                                    struct pipe_vertex_buffer *vb)
+{
+   void *map = NULL;
+
+   memset(vb, 0, sizeof(*vb));
+   vb->stride = 8 * sizeof(float);
+
+   u_upload_alloc(ctx->base.pipe->stream_uploader, 0,
+                  num_rects * 6 * vb->stride, 4,
+                  &vb->buffer_offset, &vb->buffer.resource, &map);
+   return map;
+}
+
+static void blitter_add_rect(struct blitter_context_priv *ctx,
+                             float *map, unsigned index)
+{
+   /* Same vertex order as the indexed draw in blitter_draw(). */
+   static const unsigned order[6] = { 0, 1, 2, 0, 3, 2 };
+   float *out = map + index * 6 * 8;
+
+   for (unsigned i = 0; i < 6; i++)
+      memcpy(out + i * 8, ctx->vertices[order[i]], sizeof(ctx->vertices[0]));
+}
+
+static void blitter_draw_rect_list(struct blitter_context_priv *ctx,
+                                   void *vertex_elements_cso,
+                                   blitter_get_vs_func get_vs,
+                                   struct pipe_vertex_buffer *vb,
+                                   unsigned num_rects, unsigned num_instances)
+{
+   struct pipe_context *pipe = ctx->base.pipe;
+
+   u_upload_unmap(pipe->stream_uploader);
+
+   blitter_set_viewport(ctx);
+   pipe->set_vertex_buffers(pipe, ctx->base.vb_slot, 1, vb);
+   pipe->bind_vertex_elements_state(pipe, vertex_elements_cso);
+   pipe->bind_vs_state(pipe, get_vs(&ctx->base));
+
+   util_draw_arrays_instanced(pipe, PIPE_PRIM_TRIANGLES, 0, num_rects * 6,
+                              0, num_instances);
+   pipe_resource_reference(&vb->buffer.resource, NULL);
+}
+
+/* Drivers overriding draw_rectangle get one call per rectangle. */
+static bool blitter_can_batch_rects(struct blitter_context_priv *ctx,
+                                    unsigned num_rects)
+{
+   return num_rects > 1 &&
+          ctx->base.draw_rectangle == util_blitter_draw_rectangle;
+}
+
 void util_blitter_draw_rectangle(struct blitter_context *blitter,
                                  void *vertex_elements_cso,
                                  blitter_get_vs_func get_vs,
@@ -1805,6 +1866,83 @@ static void do_blits(struct blitter_context_priv *ctx,
    }
 }
 
+static void do_blit_regions(struct blitter_context_priv *ctx,
+                            struct pipe_surface *dst,
+                            struct pipe_sampler_view *src,
+                            unsigned src_width0,
+                            unsigned src_height0,
+                            unsigned num_regions,
+                            const struct pipe_box *dstboxes,
+                            const struct pipe_box *srcboxes,
+                            bool is_zsbuf,
+                            bool uses_txf)
+{
+   struct pipe_context *pipe = ctx->base.pipe;
+   enum pipe_texture_target src_target = src->target;
+   struct pipe_framebuffer_state fb_state = {0};
+   struct pipe_vertex_buffer vb;
+   float *map;
+   unsigned i;
+
+   /* Only plain 2D blits are batched, layered and multisample blits need
+    * state changes between the rectangles anyway.
+    */
+   if (!blitter_can_batch_rects(ctx, num_regions) ||
+       (src_target != PIPE_TEXTURE_1D &&
+        src_target != PIPE_TEXTURE_2D &&
+        src_target != PIPE_TEXTURE_RECT) ||
+       src->texture->nr_samples > 1) {
+      for (i = 0; i < num_regions; i++) {
+         do_blits(ctx, dst, &dstboxes[i], src, src_width0, src_height0,
+                  &srcboxes[i], is_zsbuf, uses_txf);
+      }
+      return;
+   }
+
+   fb_state.width = dst->width;
+   fb_state.height = dst->height;
+   fb_state.nr_cbufs = is_zsbuf ? 0 : 1;
+   if (is_zsbuf) {
+      fb_state.zsbuf = dst;
+   } else {
+      fb_state.cbufs[0] = dst;
+   }
+   pipe->set_framebuffer_state(pipe, &fb_state);
+   pipe->set_sample_mask(pipe, ~0);
+
+   blitter_set_dst_dimensions(ctx, fb_state.width, fb_state.height);
+
+   map = blitter_map_rect_list(ctx, num_regions, &vb);
+   if (!map)
+      return;
+
+   for (i = 0; i < num_regions; i++) {
+      const struct pipe_box *dstbox = &dstboxes[i];
+      const struct pipe_box *srcbox = &srcboxes[i];
+      union blitter_attrib coord;
+
+      get_texcoords(src, src_width0, src_height0,
+                    srcbox->x, srcbox->y,
+                    srcbox->x + srcbox->width, srcbox->y + srcbox->height,
+                    0, 0, uses_txf, &coord);
+
+      blitter_set_rectangle(ctx, dstbox->x, dstbox->y,
+                            dstbox->x + dstbox->width,
+                            dstbox->y + dstbox->height, 0);
+      set_texcoords_in_vertices(&coord, &ctx->vertices[0][1][0], 8);
+      for (unsigned v = 0; v < 4; v++) {
+         ctx->vertices[v][1][2] = coord.texcoord.z;
+         ctx->vertices[v][1][3] = coord.texcoord.w;
+      }
+
+      blitter_add_rect(ctx, map, i);
+   }
+
+   blitter_draw_rect_list(ctx, ctx->velem_state,
+                          get_vs_passthrough_pos_generic, &vb,
+                          num_regions, 1);
+}
+
 void util_blitter_blit_generic(struct blitter_context *blitter,
                                struct pipe_surface *dst,
                                const struct pipe_box *dstbox,
@@ -1814,6 +1952,57 @@ void util_blitter_blit_generic(struct blitter_context *blitter,
                                unsigned mask, unsigned filter,
                                const struct pipe_scissor_state *scissor,
                                bool alpha_blend)
+{
+   util_blitter_blit_generic_regions(blitter, dst, src,
+                                     src_width0, src_height0,
+                                     1, dstbox, srcbox, mask, filter,
+                                     scissor, alpha_blend);
+}
+
+/* Whether the TXF shaders can be used for the blit of srcbox. */
+static bool blitter_srcbox_fits_txf(struct pipe_sampler_view *src,
+                                    unsigned src_width0, unsigned src_height0,
+                                    const struct pipe_box *srcbox)
+{
+   int src_width = u_minify(src_width0, src->u.tex.first_level);
+   int src_height = u_minify(src_height0, src->u.tex.first_level);
+   int src_depth = src->u.tex.last_layer + 1;
+   struct pipe_box box = *srcbox;
+
+   /* Eliminate negative width/height/depth. */
+   if (box.width < 0) {
+      box.x += box.width;
+      box.width *= -1;
+   }
+   if (box.height < 0) {
+      box.y += box.height;
+      box.height *= -1;
+   }
+   if (box.depth < 0) {
+      box.z += box.depth;
+      box.depth *= -1;
+   }
+
+   /* See if srcbox is in bounds. TXF doesn't clamp the coordinates. */
+   return box.x >= 0 && box.x < src_width &&
+          box.y >= 0 && box.y < src_height &&
+          box.z >= 0 && box.z < src_depth &&
+          box.x + box.width > 0 && box.x + box.width <= src_width &&
+          box.y + box.height > 0 && box.y + box.height <= src_height &&
+          box.z + box.depth > 0 && box.z + box.depth <= src_depth;
+}
+
+void util_blitter_blit_generic_regions(struct blitter_context *blitter,
+                                       struct pipe_surface *dst,
+                                       struct pipe_sampler_view *src,
+                                       unsigned src_width0,
+                                       unsigned src_height0,
+                                       unsigned num_regions,
+                                       const struct pipe_box *dstboxes,
+                                       const struct pipe_box *srcboxes,
+                                       unsigned mask, unsigned filter,
+                                       const struct pipe_scissor_state *scissor,
+                                       bool alpha_blend)
 {
    struct blitter_context_priv *ctx = (struct blitter_context_priv*)blitter;
    struct pipe_context *pipe = ctx->base.pipe;
@@ -1844,8 +2033,17 @@ void util_blitter_blit_generic(struct blitter_context *blitter,
       return;
    }
 
-   bool is_scaled = dstbox->width != abs(srcbox->width) ||
-                    dstbox->height != abs(srcbox->height);
+   if (!num_regions)
+      return;
+
+   /* The regions share the shaders, so a single scaled region makes the
+    * whole batch scaled.
+    */
+   bool is_scaled = false;
+   for (unsigned i = 0; i < num_regions; i++) {
+      is_scaled |= dstboxes[i].width != abs(srcboxes[i].width) ||
+                   dstboxes[i].height != abs(srcboxes[i].height);
+   }
 
    if (blit_stencil || !is_scaled)
       filter = PIPE_TEX_FILTER_NEAREST;
@@ -1858,33 +2056,11 @@ void util_blitter_blit_generic(struct blitter_context *blitter,
        filter == PIPE_TEX_FILTER_NEAREST &&
        src->target != PIPE_TEXTURE_CUBE &&
        src->target != PIPE_TEXTURE_CUBE_ARRAY) {
-      int src_width = u_minify(src_width0, src->u.tex.first_level);
-      int src_height = u_minify(src_height0, src->u.tex.first_level);
-      int src_depth = src->u.tex.last_layer + 1;
-      struct pipe_box box = *srcbox;
-
-      /* Eliminate negative width/height/depth. */
-      if (box.width < 0) {
-         box.x += box.width;
-         box.width *= -1;
+      use_txf = true;
+      for (unsigned i = 0; i < num_regions && use_txf; i++) {
+         use_txf = blitter_srcbox_fits_txf(src, src_width0, src_height0,
+                                           &srcboxes[i]);
       }
-      if (box.height < 0) {
-         box.y += box.height;
-         box.height *= -1;
-      }
-      if (box.depth < 0) {
-         box.z += box.depth;
-         box.depth *= -1;
-      }
-
-      /* See if srcbox is in bounds. TXF doesn't clamp the coordinates. */
-      use_txf =
-         box.x >= 0 && box.x < src_width &&
-         box.y >= 0 && box.y < src_height &&
-         box.z >= 0 && box.z < src_depth &&
-         box.x + box.width > 0 && box.x + box.width <= src_width &&
-         box.y + box.height > 0 && box.y + box.height <= src_height &&
-         box.z + box.depth > 0 && box.z + box.depth <= src_depth;
    }
 
    /* Check whether the states are properly saved. */
@@ -1990,8 +2166,9 @@ void util_blitter_blit_generic(struct blitter_context *blitter,
 
    blitter_set_common_draw_rect_state(ctx, scissor != NULL);
 
-   do_blits(ctx, dst, dstbox, src, src_width0, src_height0,
-            srcbox, blit_depth || blit_stencil, use_txf);
+   do_blit_regions(ctx, dst, src, src_width0, src_height0,
+                   num_regions, dstboxes, srcboxes,
+                   blit_depth || blit_stencil, use_txf);
 
    util_blitter_restore_vertex_states(blitter);
    util_blitter_restore_fragment_states(blitter);
@@ -2149,6 +2326,19 @@ void util_blitter_clear_render_target(struct blitter_context *blitter,
                                       const union pipe_color_union *color,
                                       unsigned dstx, unsigned dsty,
                                       unsigned width, unsigned height)
+{
+   struct pipe_box rect;
+
+   u_box_2d(dstx, dsty, width, height, &rect);
+   util_blitter_clear_render_target_rects(blitter, dstsurf, color, 1, &rect);
+}
+
+/* Clear several regions of a color surface to a constant value. */
+void util_blitter_clear_render_target_rects(struct blitter_context *blitter,
+                                            struct pipe_surface *dstsurf,
+                                            const union pipe_color_union *color,
+                                            unsigned num_rects,
+                                            const struct pipe_box *rects)
 {
    struct blitter_context_priv *ctx = (struct blitter_context_priv*)blitter;
    struct pipe_context *pipe = ctx->base.pipe;
@@ -2185,18 +2375,40 @@ void util_blitter_clear_render_target(struct blitter_context *blitter,
    union blitter_attrib attrib;
    memcpy(attrib.color, color->ui, sizeof(color->ui));
 
+   blitter_get_vs_func get_vs = get_vs_passthrough_pos_generic;
+
    num_layers = dstsurf->u.tex.last_layer - dstsurf->u.tex.first_layer + 1;
-   if (num_layers > 1 && ctx->has_layered) {
-      blitter_set_common_draw_rect_state(ctx, false);
-      blitter->draw_rectangle(blitter, ctx->velem_state, get_vs_layered,
-                              dstx, dsty, dstx+width, dsty+height, 0,
-                              num_layers, UTIL_BLITTER_ATTRIB_COLOR, &attrib);
+   if (num_layers > 1 && ctx->has_layered)
+      get_vs = get_vs_layered;
+   else
+      num_layers = 1;
+
+   blitter_set_common_draw_rect_state(ctx, false);
+
+   if (blitter_can_batch_rects(ctx, num_rects)) {
+      struct pipe_vertex_buffer vb;
+      float *map = blitter_map_rect_list(ctx, num_rects, &vb);
+
+      if (map) {
+         blitter_set_clear_color(ctx, attrib.color);
+         for (unsigned i = 0; i < num_rects; i++) {
+            blitter_set_rectangle(ctx, rects[i].x, rects[i].y,
+                                  rects[i].x + rects[i].width,
+                                  rects[i].y + rects[i].height, 0);
+            blitter_add_rect(ctx, map, i);
+         }
+         blitter_draw_rect_list(ctx, ctx->velem_state, get_vs, &vb,
+                                num_rects, num_layers);
+      }
    } else {
-      blitter_set_common_draw_rect_state(ctx, false);
-      blitter->draw_rectangle(blitter, ctx->velem_state,
-                              get_vs_passthrough_pos_generic,
-                              dstx, dsty, dstx+width, dsty+height, 0,
-                              1, UTIL_BLITTER_ATTRIB_COLOR, &attrib);
+      for (unsigned i = 0; i < num_rects; i++) {
+         blitter->draw_rectangle(blitter, ctx->velem_state, get_vs,
+                                 rects[i].x, rects[i].y,
+                                 rects[i].x + rects[i].width,
+                                 rects[i].y + rects[i].height, 0,
+                                 num_layers, UTIL_BLITTER_ATTRIB_COLOR,
+                                 &attrib);
+      }
    }
 
    util_blitter_restore_vertex_states(blitter);
@@ -267,6 +267,25 @@ void util_blitter_blit_generic(struct blitter_context *blitter,
                                const struct pipe_scissor_state *scissor,
                                bool alpha_blend);
 
+/**
+ * Like util_blitter_blit_generic, but blits num_regions regions between the
+ * same views.  The state is set up once for all of them, and 2D
+ * single-sample blits are done with a single draw.
+ *
+ * If any of the regions is scaled, the filter applies to all of them.
+ */
+void util_blitter_blit_generic_regions(struct blitter_context *blitter,
+                                       struct pipe_surface *dst,
+                                       struct pipe_sampler_view *src,
+                                       unsigned src_width0,
+                                       unsigned src_height0,
+                                       unsigned num_regions,
+                                       const struct pipe_box *dstboxes,
+                                       const struct pipe_box *srcboxes,
+                                       unsigned mask, unsigned filter,
+                                       const struct pipe_scissor_state *scissor,
+                                       bool alpha_blend);
+
 void util_blitter_blit(struct blitter_context *blitter,
 		       const struct pipe_blit_info *info);
 
@@ -337,6 +356,18 @@ void util_blitter_clear_render_target(struct blitter_context *blitter,
                                       unsigned dstx, unsigned dsty,
                                       unsigned width, unsigned height);
 
+/**
+ * Clear num_rects regions of a (color) surface to a constant value, with
+ * a single draw.  Only x, y, width and height of the boxes are used.
+ *
+ * The same states as for util_blitter_clear_render_target must be saved.
+ */
+void util_blitter_clear_render_target_rects(struct blitter_context *blitter,
+                                            struct pipe_surface *dst,
+                                            const union pipe_color_union *color,
+                                            unsigned num_rects,
+                                            const struct pipe_box *rects);
+
 /**
  * Clear a region of a depth-stencil surface, both stencil and depth
  * or only one of them if this is a combined depth-stencil surface.
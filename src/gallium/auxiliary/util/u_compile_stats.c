@@ -0,0 +1,108 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "pipe/p_state.h"
+#include "util/disk_cache.h"
+#include "util/u_queue.h"
+
+#include "u_compile_stats.h"
+
+uint64_t
+u_compile_stats_read(struct u_compile_stats *stats, unsigned query_type)
+{
+   struct disk_cache_stats cache_stats;
+   uint64_t depth = 0;
+
+   switch (query_type) {
+   case PIPE_QUERY_SHADER_COMPILES:
+      return p_atomic_read(&stats->compiles);
+   case PIPE_QUERY_SHADER_COMPILE_TIME:
+      return p_atomic_read(&stats->compile_time_ns);
+   case PIPE_QUERY_SHADER_CACHE_HITS:
+   case PIPE_QUERY_SHADER_CACHE_MISSES:
+      if (!stats->disk_cache)
+         return 0;
+      disk_cache_get_stats(stats->disk_cache, &cache_stats);
+      return query_type == PIPE_QUERY_SHADER_CACHE_HITS ?
+             cache_stats.hits : cache_stats.misses;
+   case PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH:
+      /* Unlocked read, a sample is all we need */
+      for (unsigned i = 0; i < U_COMPILE_STATS_MAX_QUEUES; i++) {
+         if (stats->queues[i])
+            depth += p_atomic_read(&stats->queues[i]->num_queued);
+      }
+      return depth;
+   default:
+      unreachable("not a compile stats query");
+   }
+}
+
+uint64_t
+u_compile_stats_result(unsigned query_type, uint64_t begin, uint64_t end)
+{
+   switch (query_type) {
+   case PIPE_QUERY_SHADER_COMPILE_TIME:
+      return (end - begin) / 1000;
+   case PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH:
+      return end;
+   default:
+      return end - begin;
+   }
+}
+
+void
+u_compile_stats_query_info(unsigned index, unsigned group_id,
+                           struct pipe_driver_query_info *info)
+{
+   static const struct {
+      const char *name;
+      unsigned query_type;
+      enum pipe_driver_query_type type;
+      enum pipe_driver_query_result_type result_type;
+   } queries[U_COMPILE_STATS_NUM_QUERIES] = {
+      { "shader-compiles", PIPE_QUERY_SHADER_COMPILES,
+        PIPE_DRIVER_QUERY_TYPE_UINT64,
+        PIPE_DRIVER_QUERY_RESULT_TYPE_CUMULATIVE },
+      { "shader-compile-time", PIPE_QUERY_SHADER_COMPILE_TIME,
+        PIPE_DRIVER_QUERY_TYPE_MICROSECONDS,
+        PIPE_DRIVER_QUERY_RESULT_TYPE_CUMULATIVE },
+      { "shader-cache-hits", PIPE_QUERY_SHADER_CACHE_HITS,
+        PIPE_DRIVER_QUERY_TYPE_UINT64,
+        PIPE_DRIVER_QUERY_RESULT_TYPE_CUMULATIVE },
+      { "shader-cache-misses", PIPE_QUERY_SHADER_CACHE_MISSES,
+        PIPE_DRIVER_QUERY_TYPE_UINT64,
+        PIPE_DRIVER_QUERY_RESULT_TYPE_CUMULATIVE },
+      { "shader-compile-queue-depth", PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH,
+        PIPE_DRIVER_QUERY_TYPE_UINT64,
+        PIPE_DRIVER_QUERY_RESULT_TYPE_AVERAGE },
+   };
+
+   assert(index < U_COMPILE_STATS_NUM_QUERIES);
+
+   memset(info, 0, sizeof(*info));
+   info->name = queries[index].name;
+   info->query_type = queries[index].query_type;
+   info->type = queries[index].type;
+   info->result_type = queries[index].result_type;
+   info->group_id = group_id;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/**
+ * Screen-wide shader compiler counters.
+ *
+ * Drivers embed a u_compile_stats in their screen, bracket each backend
+ * compile with u_compile_stats_begin/end and point it at their disk cache
+ * and compiler queues.  The PIPE_QUERY_SHADER_* queries then read the same
+ * counters on every driver, so the HUD, GL_AMD_performance_monitor and
+ * other tools can graph shader stutter without knowing about the driver.
+ *
+ * All counters are updated atomically and may be bumped from compiler
+ * threads.
+ */
+
+#ifndef U_COMPILE_STATS_H
+#define U_COMPILE_STATS_H
+
+#include "pipe/p_defines.h"
+#include "util/u_atomic.h"
+#include "util/os_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define U_COMPILE_STATS_MAX_QUEUES 2
+#define U_COMPILE_STATS_NUM_QUERIES 5
+
+struct disk_cache;
+struct pipe_driver_query_info;
+struct util_queue;
+
+struct u_compile_stats {
+   unsigned compiles;
+   uint64_t compile_time_ns;
+
+   /* Set by the driver, may be NULL */
+   struct disk_cache *disk_cache;
+   struct util_queue *queues[U_COMPILE_STATS_MAX_QUEUES];
+};
+
+static inline int64_t
+u_compile_stats_begin(void)
+{
+   return os_time_get_nano();
+}
+
+static inline void
+u_compile_stats_end(struct u_compile_stats *stats, int64_t begin)
+{
+   p_atomic_inc(&stats->compiles);
+   p_atomic_add(&stats->compile_time_ns, os_time_get_nano() - begin);
+}
+
+static inline bool
+u_compile_stats_is_query(unsigned query_type)
+{
+   return query_type >= PIPE_QUERY_SHADER_COMPILES &&
+          query_type <= PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH;
+}
+
+/* Current value of a counter, for the begin and end of a query */
+uint64_t
+u_compile_stats_read(struct u_compile_stats *stats, unsigned query_type);
+
+/* Result of a query from the values read at its begin and end */
+uint64_t
+u_compile_stats_result(unsigned query_type, uint64_t begin, uint64_t end);
+
+/* Fill in the info of query "index", for get_driver_query_info */
+void
+u_compile_stats_query_info(unsigned index, unsigned group_id,
+                           struct pipe_driver_query_info *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* U_COMPILE_STATS_H */
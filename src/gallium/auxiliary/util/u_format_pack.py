@@ -621,6 +621,40 @@ def generate_pack_kernel(format, src_channel, src_native_type):
         print_channels(format, pack_into_union)
 
 
+# Conversions with a hand-written SSE2 row kernel in u_format_sse.c.  The
+# kernels convert the bulk of each row and the scalar code below does the rest.
+sse2_kernels = set([
+    ('r8g8b8a8_unorm', 'unpack', 'rgba_float'),
+    ('r8g8b8a8_unorm', 'pack', 'rgba_float'),
+    ('b8g8r8a8_unorm', 'unpack', 'rgba_float'),
+    ('b8g8r8a8_unorm', 'pack', 'rgba_float'),
+    ('b8g8r8a8_unorm', 'unpack', 'rgba_8unorm'),
+    ('b8g8r8a8_unorm', 'pack', 'rgba_8unorm'),
+    ('r10g10b10a2_unorm', 'unpack', 'rgba_float'),
+    ('r16g16b16a16_float', 'unpack', 'rgba_float'),
+])
+
+
+def generate_sse2_kernel_call(format, direction, suffix, src_step, dst_step):
+    '''Generate the call into the SSE2 kernel for a row, if there is one,
+    leaving the number of converted pixels in x'''
+
+    name = format.short_name()
+
+    if (name, direction, suffix) not in sse2_kernels:
+        print('      x = 0;')
+        return
+
+    print('      x = 0;')
+    print('#ifdef PIPE_ARCH_SSE')
+    print('      if (util_cpu_caps.has_sse2) {')
+    print('         x = util_format_%s_%s_%s_sse2(dst, src, width);' % (name, direction, suffix))
+    print('         src += x * %u;' % src_step)
+    print('         dst += x * %u;' % dst_step)
+    print('      }')
+    print('#endif')
+
+
 def generate_format_unpack(format, dst_channel, dst_native_type, dst_suffix):
     '''Generate the function to unpack pixels from a particular format'''
 
@@ -635,7 +669,8 @@ def generate_format_unpack(format, dst_channel, dst_native_type, dst_suffix):
         print('   for(y = 0; y < height; y += %u) {' % (format.block_height,))
         print('      %s *dst = dst_row;' % (dst_native_type))
         print('      const uint8_t *src = src_row;')
-        print('      for(x = 0; x < width; x += %u) {' % (format.block_width,))
+        generate_sse2_kernel_call(format, 'unpack', dst_suffix, format.block_size() / 8, 4)
+        print('      for(; x < width; x += %u) {' % (format.block_width,))
         
         generate_unpack_kernel(format, dst_channel, dst_native_type)
     
@@ -664,7 +699,8 @@ def generate_format_pack(format, src_channel, src_native_type, src_suffix):
         print('   for(y = 0; y < height; y += %u) {' % (format.block_height,))
         print('      const %s *src = src_row;' % (src_native_type))
         print('      uint8_t *dst = dst_row;')
-        print('      for(x = 0; x < width; x += %u) {' % (format.block_width,))
+        generate_sse2_kernel_call(format, 'pack', src_suffix, 4, format.block_size() / 8)
+        print('      for(; x < width; x += %u) {' % (format.block_width,))
     
         generate_pack_kernel(format, src_channel, src_native_type)
             
@@ -702,10 +738,12 @@ def is_format_hand_written(format):
 def generate(formats):
     print()
     print('#include "pipe/p_compiler.h"')
+    print('#include "util/u_cpu_detect.h"')
     print('#include "util/u_math.h"')
     print('#include "u_half.h"')
     print('#include "u_format.h"')
     print('#include "u_format_other.h"')
+    print('#include "u_format_sse.h"')
     print('#include "util/format_srgb.h"')
     print('#include "u_format_yuv.h"')
     print('#include "u_format_zs.h"')
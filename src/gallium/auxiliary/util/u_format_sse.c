@@ -0,0 +1,281 @@
+/**************************************************************************
+ *
+ * Copyright 2019 VMware, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE COPYRIGHT HOLDERS, AUTHORS AND/OR ITS SUPPLIERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ **************************************************************************/
+
+
+/**
+ * @file
+ * SSE2 row kernels for the most common formats.  See u_format_sse.h.
+ *
+ * The conversions mirror the scalar ones in u_format_table.c operation for
+ * operation (ubyte_to_float(), float_to_ubyte(), util_half_to_float()), so
+ * that results don't depend on which path converted a pixel.
+ */
+
+#include "u_format_sse.h"
+
+#if defined(PIPE_ARCH_SSE)
+
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+
+/**
+ * Swap the R and B bytes of four packed 8-bit RGBA pixels.
+ */
+static inline __m128i
+swap_rb_8unorm(__m128i v)
+{
+   const __m128i ga_mask = _mm_set1_epi32(0xff00ff00);
+   const __m128i byte_mask = _mm_set1_epi32(0xff);
+   __m128i ga = _mm_and_si128(v, ga_mask);
+   __m128i r = _mm_and_si128(_mm_srli_epi32(v, 16), byte_mask);
+   __m128i b = _mm_slli_epi32(_mm_and_si128(v, byte_mask), 16);
+
+   return _mm_or_si128(ga, _mm_or_si128(r, b));
+}
+
+
+/**
+ * float_to_ubyte() on four floats, leaving the result in the low byte of
+ * each 32-bit lane.
+ */
+static inline __m128i
+float_to_ubyte_sse2(__m128 f)
+{
+   const __m128i byte_mask = _mm_set1_epi32(0xff);
+   __m128 positive = _mm_cmpgt_ps(f, _mm_setzero_ps());
+   __m128 saturate = _mm_cmpge_ps(f, _mm_set1_ps(1.0f));
+   __m128 tmp;
+   __m128i v;
+
+   tmp = _mm_mul_ps(f, _mm_set1_ps(255.0f/256.0f));
+   tmp = _mm_add_ps(tmp, _mm_set1_ps(32768.0f));
+   v = _mm_and_si128(_mm_castps_si128(tmp), byte_mask);
+
+   /* NaN fails both comparisons and ends up as 0, like in the scalar code */
+   v = _mm_and_si128(v, _mm_castps_si128(positive));
+   v = _mm_or_si128(v, _mm_and_si128(_mm_castps_si128(saturate), byte_mask));
+   return v;
+}
+
+
+/**
+ * util_half_to_float() on four halves, zero extended to 32-bit lanes.
+ */
+static inline __m128
+half_to_float_sse2(__m128i h)
+{
+   const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(0xef << 23));
+   const __m128 infnan = _mm_castsi128_ps(_mm_set1_epi32(0xff << 23));
+   __m128i bits = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7fff)), 13);
+   __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+   __m128 f;
+
+   /* Exponent / Mantissa */
+   f = _mm_mul_ps(_mm_castsi128_ps(bits), magic);
+
+   /* Inf / NaN */
+   f = _mm_or_ps(f, _mm_and_ps(_mm_cmpge_ps(f, _mm_set1_ps(65536.0f)),
+                               infnan));
+
+   return _mm_or_ps(f, _mm_castsi128_ps(sign));
+}
+
+
+static inline unsigned
+unpack_8unorm_rgba_float(float *dst, const uint8_t *src, unsigned width,
+                         boolean swap_rb)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+   unsigned x;
+
+   for (x = 0; x + 4 <= width; x += 4) {
+      __m128i p = _mm_loadu_si128((const __m128i *)src);
+      __m128i lo, hi;
+
+      if (swap_rb)
+         p = swap_rb_8unorm(p);
+
+      lo = _mm_unpacklo_epi8(p, zero);
+      hi = _mm_unpackhi_epi8(p, zero);
+
+      _mm_storeu_ps(dst + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+      _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+      _mm_storeu_ps(dst + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+      _mm_storeu_ps(dst + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+
+      src += 16;
+      dst += 16;
+   }
+
+   return x;
+}
+
+
+static inline unsigned
+pack_8unorm_rgba_float(uint8_t *dst, const float *src, unsigned width,
+                       boolean swap_rb)
+{
+   unsigned x;
+
+   for (x = 0; x + 4 <= width; x += 4) {
+      __m128i p[4];
+      unsigned i;
+
+      for (i = 0; i < 4; i++) {
+         __m128 f = _mm_loadu_ps(src + 4 * i);
+         if (swap_rb)
+            f = _mm_shuffle_ps(f, f, _MM_SHUFFLE(3, 0, 1, 2));
+         p[i] = float_to_ubyte_sse2(f);
+      }
+
+      _mm_storeu_si128((__m128i *)dst,
+                       _mm_packus_epi16(_mm_packs_epi32(p[0], p[1]),
+                                        _mm_packs_epi32(p[2], p[3])));
+
+      src += 16;
+      dst += 16;
+   }
+
+   return x;
+}
+
+
+unsigned
+util_format_r8g8b8a8_unorm_unpack_rgba_float_sse2(float *dst, const uint8_t *src, unsigned width)
+{
+   return unpack_8unorm_rgba_float(dst, src, width, FALSE);
+}
+
+
+unsigned
+util_format_r8g8b8a8_unorm_pack_rgba_float_sse2(uint8_t *dst, const float *src, unsigned width)
+{
+   return pack_8unorm_rgba_float(dst, src, width, FALSE);
+}
+
+
+unsigned
+util_format_b8g8r8a8_unorm_unpack_rgba_float_sse2(float *dst, const uint8_t *src, unsigned width)
+{
+   return unpack_8unorm_rgba_float(dst, src, width, TRUE);
+}
+
+
+unsigned
+util_format_b8g8r8a8_unorm_pack_rgba_float_sse2(uint8_t *dst, const float *src, unsigned width)
+{
+   return pack_8unorm_rgba_float(dst, src, width, TRUE);
+}
+
+
+unsigned
+util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_sse2(uint8_t *dst, const uint8_t *src, unsigned width)
+{
+   unsigned x;
+
+   for (x = 0; x + 4 <= width; x += 4) {
+      __m128i p = _mm_loadu_si128((const __m128i *)src);
+      _mm_storeu_si128((__m128i *)dst, swap_rb_8unorm(p));
+      src += 16;
+      dst += 16;
+   }
+
+   return x;
+}
+
+
+unsigned
+util_format_b8g8r8a8_unorm_pack_rgba_8unorm_sse2(uint8_t *dst, const uint8_t *src, unsigned width)
+{
+   /* Swapping R and B is its own inverse. */
+   return util_format_b8g8r8a8_unorm_unpack_rgba_8unorm_sse2(dst, src, width);
+}
+
+
+unsigned
+util_format_r10g10b10a2_unorm_unpack_rgba_float_sse2(float *dst, const uint8_t *src, unsigned width)
+{
+   const __m128i mask = _mm_set1_epi32(0x3ff);
+   const __m128 scale = _mm_set1_ps(1.0f/0x3ff);
+   const __m128 scale_a = _mm_set1_ps(1.0f/0x3);
+   unsigned x;
+
+   for (x = 0; x + 4 <= width; x += 4) {
+      __m128i v = _mm_loadu_si128((const __m128i *)src);
+      __m128 r, g, b, a;
+
+      r = _mm_cvtepi32_ps(_mm_and_si128(v, mask));
+      g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 10), mask));
+      b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, 20), mask));
+      a = _mm_cvtepi32_ps(_mm_srli_epi32(v, 30));
+
+      r = _mm_mul_ps(r, scale);
+      g = _mm_mul_ps(g, scale);
+      b = _mm_mul_ps(b, scale);
+      a = _mm_mul_ps(a, scale_a);
+
+      /* SoA -> AoS */
+      _MM_TRANSPOSE4_PS(r, g, b, a);
+
+      _mm_storeu_ps(dst + 0, r);
+      _mm_storeu_ps(dst + 4, g);
+      _mm_storeu_ps(dst + 8, b);
+      _mm_storeu_ps(dst + 12, a);
+
+      src += 16;
+      dst += 16;
+   }
+
+   return x;
+}
+
+
+unsigned
+util_format_r16g16b16a16_float_unpack_rgba_float_sse2(float *dst, const uint8_t *src, unsigned width)
+{
+   const __m128i zero = _mm_setzero_si128();
+   unsigned x;
+
+   for (x = 0; x + 4 <= width; x += 4) {
+      __m128i p0 = _mm_loadu_si128((const __m128i *)src);
+      __m128i p1 = _mm_loadu_si128((const __m128i *)(src + 16));
+
+      _mm_storeu_ps(dst + 0, half_to_float_sse2(_mm_unpacklo_epi16(p0, zero)));
+      _mm_storeu_ps(dst + 4, half_to_float_sse2(_mm_unpackhi_epi16(p0, zero)));
+      _mm_storeu_ps(dst + 8, half_to_float_sse2(_mm_unpacklo_epi16(p1, zero)));
+      _mm_storeu_ps(dst + 12, half_to_float_sse2(_mm_unpackhi_epi16(p1, zero)));
+
+      src += 32;
+      dst += 16;
+   }
+
+   return x;
+}
+
+#endif /* PIPE_ARCH_SSE */
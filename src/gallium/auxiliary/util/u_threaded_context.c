@@ -29,6 +29,7 @@
 #include "util/u_format.h"
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
+#include "util/u_trace.h"
 #include "util/u_upload_mgr.h"
 
 /* 0 = disabled, 1 = assertions, 2 = printfs */
@@ -85,6 +86,7 @@ tc_batch_execute(void *job, UNUSED int thread_index)
    struct tc_batch *batch = job;
    struct pipe_context *pipe = batch->pipe;
    struct tc_call *last = &batch->call[batch->num_total_call_slots];
+   MESA_TRACE_FUNC();
 
    tc_batch_check(batch);
 
@@ -551,6 +553,27 @@ tc_create_vertex_elements_state(struct pipe_context *_pipe, unsigned count,
    return pipe->create_vertex_elements_state(pipe, count, elems);
 }
 
+/* Like CSO creation, these don't depend on the context state, so they're
+ * called directly.
+ */
+static void *
+tc_get_shader_binary(struct pipe_context *_pipe, enum pipe_shader_type shader,
+                     void *shader_state, unsigned *size)
+{
+   struct pipe_context *pipe = threaded_context(_pipe)->pipe;
+
+   return pipe->get_shader_binary(pipe, shader, shader_state, size);
+}
+
+static void
+tc_add_shader_binary(struct pipe_context *_pipe, const void *binary,
+                     unsigned size)
+{
+   struct pipe_context *pipe = threaded_context(_pipe)->pipe;
+
+   pipe->add_shader_binary(pipe, binary, size);
+}
+
 struct tc_sampler_states {
    ubyte shader, start, count;
    void *slot[0]; /* more will be allocated if needed */
@@ -1672,6 +1695,10 @@ struct tc_texture_subdata {
    struct pipe_resource *resource;
    unsigned level, usage, stride, layer_stride;
    struct pipe_box box;
+   /* Big uploads are staged here instead of in slot. */
+   struct threaded_context *tc;
+   void *staging;
+   unsigned staging_size;
    char slot[0]; /* more will be allocated if needed */
 };
 
@@ -1681,8 +1708,39 @@ tc_call_texture_subdata(struct pipe_context *pipe, union tc_payload *payload)
    struct tc_texture_subdata *p = (struct tc_texture_subdata *)payload;
 
    pipe->texture_subdata(pipe, p->resource, p->level, p->usage, &p->box,
-                         p->slot, p->stride, p->layer_stride);
+                         p->staging ? p->staging : p->slot,
+                         p->stride, p->layer_stride);
    pipe_resource_reference(&p->resource, NULL);
+
+   if (p->staging) {
+      free(p->staging);
+      p_atomic_add(&p->tc->staged_texture_bytes, -(int)p->staging_size);
+   }
+}
+
+/**
+ * Returns a staging allocation for a big texture upload that is enqueued
+ * instead of synchronizing with the driver thread, which would wait for
+ * all queued draws to be executed before the upload.
+ */
+static void *
+tc_alloc_texture_staging(struct threaded_context *tc, unsigned size)
+{
+   /* There is nothing to wait for if the driver thread is idle. */
+   if (tc_is_sync(tc) || size > TC_MAX_STAGED_TEXTURE_BYTES)
+      return NULL;
+
+   /* Only this thread adds to the counter, so the limit can't be exceeded
+    * between the check and the addition.
+    */
+   if (p_atomic_read(&tc->staged_texture_bytes) + size >
+       TC_MAX_STAGED_TEXTURE_BYTES)
+      return NULL;
+
+   void *staging = malloc(size);
+   if (staging)
+      p_atomic_add(&tc->staged_texture_bytes, size);
+   return staging;
 }
 
 static void
@@ -1705,10 +1763,14 @@ tc_texture_subdata(struct pipe_context *_pipe,
    if (!size)
       return;
 
-   /* Small uploads can be enqueued, big uploads must sync. */
-   if (size <= TC_MAX_SUBDATA_BYTES) {
+   /* Small uploads can be enqueued, big uploads are staged or sync. */
+   void *staging = NULL;
+
+   if (size <= TC_MAX_SUBDATA_BYTES ||
+       (staging = tc_alloc_texture_staging(tc, size))) {
       struct tc_texture_subdata *p =
-         tc_add_slot_based_call(tc, TC_CALL_texture_subdata, tc_texture_subdata, size);
+         tc_add_slot_based_call(tc, TC_CALL_texture_subdata, tc_texture_subdata,
+                                staging ? 0 : size);
 
       tc_set_resource_reference(&p->resource, resource);
       p->level = level;
@@ -1716,7 +1778,10 @@ tc_texture_subdata(struct pipe_context *_pipe,
       p->box = *box;
       p->stride = stride;
       p->layer_stride = layer_stride;
-      memcpy(p->slot, data, size);
+      p->tc = tc;
+      p->staging = staging;
+      p->staging_size = staging ? size : 0;
+      memcpy(staging ? staging : p->slot, data, size);
    } else {
       struct pipe_context *pipe = tc->pipe;
 
@@ -2677,6 +2742,8 @@ threaded_context_create(struct pipe_context *pipe,
    CTX_INIT(create_tes_state);
    CTX_INIT(bind_tes_state);
    CTX_INIT(delete_tes_state);
+   CTX_INIT(get_shader_binary);
+   CTX_INIT(add_shader_binary);
    CTX_INIT(create_compute_state);
    CTX_INIT(bind_compute_state);
    CTX_INIT(delete_compute_state);
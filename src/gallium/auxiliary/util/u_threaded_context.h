@@ -228,10 +228,17 @@ struct tc_unflushed_batch_token;
 /* Threshold for when to enqueue buffer/texture_subdata as-is.
  * If the upload size is greater than this, it will do instead:
  * - for buffers: DISCARD_RANGE is done by the threaded context
- * - for textures: sync and call the driver directly
+ * - for textures: copy the data to a staging allocation and enqueue the
+ *   upload, or sync and call the driver directly if the driver thread is
+ *   idle or too much staged data is already waiting
  */
 #define TC_MAX_SUBDATA_BYTES        320
 
+/* The maximum amount of texture upload data that can be waiting in the
+ * queue in staging allocations.
+ */
+#define TC_MAX_STAGED_TEXTURE_BYTES (64 * 1024 * 1024)
+
 typedef void (*tc_replace_buffer_storage_func)(struct pipe_context *ctx,
                                                struct pipe_resource *dst,
                                                struct pipe_resource *src);
@@ -361,6 +368,11 @@ struct threaded_context {
    unsigned num_direct_slots;
    unsigned num_syncs;
 
+   /* Bytes of texture uploads waiting in the queue, see
+    * TC_MAX_STAGED_TEXTURE_BYTES.
+    */
+   int staged_texture_bytes;
+
    struct util_queue queue;
    struct util_queue_fence *fence;
 
@@ -29,7 +29,9 @@
  * coalescing small buffers into larger ones.
  */
 
+#include "c11/threads.h"
 #include "pipe/p_defines.h"
+#include "util/u_atomic.h"
 #include "util/u_inlines.h"
 #include "pipe/p_context.h"
 #include "util/u_memory.h"
@@ -38,6 +40,27 @@
 #include "u_upload_mgr.h"
 
 
+/**
+ * A buffer suballocated by several upload managers.
+ */
+struct u_upload_shared_buffer {
+   struct pipe_reference reference;
+   struct pipe_resource *buffer;
+   unsigned offset; /* First unused byte, bumped atomically. */
+};
+
+/**
+ * State shared by the upload managers created by u_upload_create_shared()
+ * and their clones.  Each of them maps the current buffer through its own
+ * context, only the allocation of a new buffer takes the lock.
+ */
+struct u_upload_shared {
+   mtx_t lock;
+   unsigned refcount;                      /* Number of upload managers. */
+   struct u_upload_shared_buffer *current; /* Protected by the lock. */
+};
+
+
 struct u_upload_mgr {
    struct pipe_context *pipe;
 
@@ -54,9 +77,28 @@ struct u_upload_mgr {
    unsigned offset; /* Aligned offset to the upload buffer, pointing
                      * at the first unused byte. */
    unsigned flushed_size; /* Size we have flushed by transfer_flush_region. */
+
+   /* For shared upload managers, the buffer being suballocated. */
+   struct u_upload_shared *shared;
+   struct u_upload_shared_buffer *shared_buffer;
 };
 
 
+static void
+u_upload_shared_buffer_reference(struct u_upload_shared_buffer **dst,
+                                 struct u_upload_shared_buffer *src)
+{
+   struct u_upload_shared_buffer *old = *dst;
+
+   if (pipe_reference(old ? &old->reference : NULL,
+                      src ? &src->reference : NULL)) {
+      pipe_resource_reference(&old->buffer, NULL);
+      FREE(old);
+   }
+   *dst = src;
+}
+
+
 struct u_upload_mgr *
 u_upload_create(struct pipe_context *pipe, unsigned default_size,
                 unsigned bind, enum pipe_resource_usage usage, unsigned flags)
@@ -100,12 +142,43 @@ u_upload_create_default(struct pipe_context *pipe)
                           PIPE_USAGE_STREAM, 0);
 }
 
+struct u_upload_mgr *
+u_upload_create_shared(struct pipe_context *pipe, unsigned default_size,
+                       unsigned bind, enum pipe_resource_usage usage,
+                       unsigned flags)
+{
+   struct u_upload_mgr *upload = u_upload_create(pipe, default_size, bind,
+                                                 usage, flags);
+
+   /* Other threads may write to the buffers as long as they like. */
+   if (!upload || !upload->map_persistent)
+      return upload;
+
+   upload->shared = CALLOC_STRUCT(u_upload_shared);
+   if (!upload->shared) {
+      FREE(upload);
+      return NULL;
+   }
+
+   (void) mtx_init(&upload->shared->lock, mtx_plain);
+   upload->shared->refcount = 1;
+   return upload;
+}
+
 struct u_upload_mgr *
 u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload)
 {
    struct u_upload_mgr *result = u_upload_create(pipe, upload->default_size,
                                                  upload->bind, upload->usage,
                                                  upload->flags);
+   if (result && upload->shared) {
+      mtx_lock(&upload->shared->lock);
+      upload->shared->refcount++;
+      mtx_unlock(&upload->shared->lock);
+      result->shared = upload->shared;
+      return result;
+   }
+
    if (upload->map_persistent &&
        upload->map_flags & PIPE_TRANSFER_FLUSH_EXPLICIT)
       u_upload_enable_flush_explicit(result);
@@ -117,6 +190,7 @@ void
 u_upload_enable_flush_explicit(struct u_upload_mgr *upload)
 {
    assert(upload->map_persistent);
+   assert(!upload->shared);
    upload->map_flags &= ~PIPE_TRANSFER_COHERENT;
    upload->map_flags |= PIPE_TRANSFER_FLUSH_EXPLICIT;
 }
@@ -161,30 +235,42 @@ u_upload_release_buffer(struct u_upload_mgr *upload)
    /* Unmap and unreference the upload buffer. */
    upload_unmap_internal(upload, TRUE);
    pipe_resource_reference(&upload->buffer, NULL);
+   u_upload_shared_buffer_reference(&upload->shared_buffer, NULL);
 }
 
 
 void
 u_upload_destroy(struct u_upload_mgr *upload)
 {
+   struct u_upload_shared *shared = upload->shared;
+
    u_upload_release_buffer(upload);
+
+   if (shared) {
+      mtx_lock(&shared->lock);
+      if (--shared->refcount) {
+         shared = NULL;
+      }
+      mtx_unlock(&upload->shared->lock);
+
+      if (shared) {
+         u_upload_shared_buffer_reference(&shared->current, NULL);
+         mtx_destroy(&shared->lock);
+         FREE(shared);
+      }
+   }
+
    FREE(upload);
 }
 
 
-static void
-u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
+static struct pipe_resource *
+u_upload_create_buffer(struct u_upload_mgr *upload, unsigned min_size)
 {
    struct pipe_screen *screen = upload->pipe->screen;
    struct pipe_resource buffer;
    unsigned size;
 
-   /* Release the old buffer, if present:
-    */
-   u_upload_release_buffer(upload);
-
-   /* Allocate a new one:
-    */
    size = align(MAX2(upload->default_size, min_size), 4096);
 
    memset(&buffer, 0, sizeof buffer);
@@ -203,23 +289,137 @@ u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
                       PIPE_RESOURCE_FLAG_MAP_COHERENT;
    }
 
-   upload->buffer = screen->resource_create(screen, &buffer);
-   if (upload->buffer == NULL)
-      return;
+   return screen->resource_create(screen, &buffer);
+}
 
-   /* Map the new buffer. */
+/**
+ * Map the upload buffer for the whole time it's used.
+ */
+static void
+u_upload_map_buffer(struct u_upload_mgr *upload)
+{
    upload->map = pipe_buffer_map_range(upload->pipe, upload->buffer,
-                                       0, size, upload->map_flags,
+                                       0, upload->buffer->width0,
+                                       upload->map_flags,
                                        &upload->transfer);
    if (upload->map == NULL) {
       upload->transfer = NULL;
       pipe_resource_reference(&upload->buffer, NULL);
-      return;
+      u_upload_shared_buffer_reference(&upload->shared_buffer, NULL);
    }
+}
+
+static void
+u_upload_alloc_buffer(struct u_upload_mgr *upload, unsigned min_size)
+{
+   /* Release the old buffer, if present:
+    */
+   u_upload_release_buffer(upload);
+
+   /* Allocate a new one:
+    */
+   upload->buffer = u_upload_create_buffer(upload, min_size);
+   if (upload->buffer == NULL)
+      return;
+
+   /* Map the new buffer. */
+   u_upload_map_buffer(upload);
 
    upload->offset = 0;
 }
 
+/**
+ * Switch to the current shared buffer, after allocating a new one if
+ * \p full is still the current one.
+ */
+static void
+u_upload_next_shared_buffer(struct u_upload_mgr *upload,
+                            struct u_upload_shared_buffer *full,
+                            unsigned min_size)
+{
+   struct u_upload_shared *shared = upload->shared;
+   struct u_upload_shared_buffer *next = NULL;
+
+   u_upload_release_buffer(upload);
+
+   mtx_lock(&shared->lock);
+   if (!shared->current || shared->current == full ||
+       shared->current->buffer->width0 < min_size) {
+      struct u_upload_shared_buffer *sbuf =
+         CALLOC_STRUCT(u_upload_shared_buffer);
+
+      if (sbuf) {
+         pipe_reference_init(&sbuf->reference, 1);
+         sbuf->buffer = u_upload_create_buffer(upload, min_size);
+         if (sbuf->buffer) {
+            u_upload_shared_buffer_reference(&shared->current, NULL);
+            shared->current = sbuf;
+         } else {
+            FREE(sbuf);
+         }
+      }
+   }
+   u_upload_shared_buffer_reference(&next, shared->current);
+   mtx_unlock(&shared->lock);
+
+   if (!next)
+      return;
+
+   upload->shared_buffer = next;
+   pipe_resource_reference(&upload->buffer, next->buffer);
+   u_upload_map_buffer(upload);
+}
+
+/**
+ * Suballocate from the shared buffer, which other threads may do at the
+ * same time.
+ */
+static void
+u_upload_alloc_shared(struct u_upload_mgr *upload,
+                      unsigned min_out_offset,
+                      unsigned size,
+                      unsigned alignment,
+                      unsigned *out_offset,
+                      struct pipe_resource **outbuf,
+                      void **ptr)
+{
+   struct u_upload_shared_buffer *sbuf = upload->shared_buffer;
+   unsigned offset;
+
+   min_out_offset = align(min_out_offset, alignment);
+
+   for (;;) {
+      if (sbuf) {
+         unsigned old = p_atomic_read(&sbuf->offset);
+
+         offset = MAX2(align(old, alignment), min_out_offset);
+         if (offset + size <= sbuf->buffer->width0) {
+            if (p_atomic_cmpxchg(&sbuf->offset, old, offset + size) == old)
+               break;
+            continue;
+         }
+      }
+
+      u_upload_next_shared_buffer(upload, sbuf, min_out_offset + size);
+
+      if (unlikely(!upload->shared_buffer) ||
+          upload->shared_buffer == sbuf) {
+         *out_offset = ~0;
+         pipe_resource_reference(outbuf, NULL);
+         *ptr = NULL;
+         return;
+      }
+      sbuf = upload->shared_buffer;
+   }
+
+   assert(size);
+
+   /* Emit the return values: */
+   *ptr = upload->map + offset;
+   pipe_resource_reference(outbuf, upload->buffer);
+   *out_offset = offset;
+}
+
 void
 u_upload_alloc(struct u_upload_mgr *upload,
                unsigned min_out_offset,
@@ -232,6 +432,12 @@ u_upload_alloc(struct u_upload_mgr *upload,
    unsigned buffer_size = upload->buffer ? upload->buffer->width0 : 0;
    unsigned offset;
 
+   if (upload->shared) {
+      u_upload_alloc_shared(upload, min_out_offset, size, alignment,
+                            out_offset, outbuf, ptr);
+      return;
+   }
+
    min_out_offset = align(min_out_offset, alignment);
 
    offset = align(upload->offset, alignment);
@@ -62,9 +62,25 @@ u_upload_create(struct pipe_context *pipe, unsigned default_size,
 struct u_upload_mgr *
 u_upload_create_default(struct pipe_context *pipe);
 
+/**
+ * Create an upload manager whose buffers are shared with the upload
+ * managers cloned from it with u_upload_clone(), which may be used from
+ * other threads, e.g. by a threaded context.  Suballocations only take an
+ * atomic compare-and-swap, and there are no partially used buffers per
+ * manager.  Each manager maps the buffers through its own context.
+ *
+ * This requires persistent coherent mappings, without them a regular
+ * upload manager is returned.
+ */
+struct u_upload_mgr *
+u_upload_create_shared(struct pipe_context *pipe, unsigned default_size,
+                       unsigned bind, enum pipe_resource_usage usage,
+                       unsigned flags);
+
 /**
  * Create an uploader with identical parameters as another one, but using
- * the given pipe_context instead.
+ * the given pipe_context instead.  The clone of a shared upload manager
+ * shares the same buffers.
  */
 struct u_upload_mgr *
 u_upload_clone(struct pipe_context *pipe, struct u_upload_mgr *upload);
@@ -73,6 +73,11 @@
  * operations where the [min_index, max_index] range is not being way bigger
  * than the vertex count.
  *
+ * The last uploaded range of each user buffer is remembered along with a
+ * copy of its contents: if the next draw uses the same client array and
+ * its contents didn't change, the previous upload is used again.  This
+ * saves the writes to GPU memory for static client arrays.
+ *
  * If the range is too big (e.g. one triangle with indices {0, 1, 10000}),
  * the per-vertex attribs are uploaded via the translate module, all packed
  * into one vertex buffer, and the indexed draw call is turned into
@@ -133,6 +138,22 @@ struct u_vbuf_elements {
    void *driver_cso;
 };
 
+/* Ranges of user buffers compared with their previous upload. */
+#define U_VBUF_UPLOAD_CACHE_MIN_SIZE 256
+#define U_VBUF_UPLOAD_CACHE_MAX_SIZE (4 * 1024 * 1024)
+
+/* The last upload of a user vertex buffer. */
+struct u_vbuf_user_upload {
+   const uint8_t *ptr;
+   unsigned start, end;
+   struct pipe_resource *resource;
+   unsigned buffer_offset;
+
+   /* Copy of the uploaded data, to tell whether it changed. */
+   uint8_t *shadow;
+   unsigned shadow_size;
+};
+
 enum {
    VB_VERTEX = 0,
    VB_INSTANCE = 1,
@@ -180,6 +201,9 @@ struct u_vbuf {
    uint32_t incompatible_vb_mask; /* each bit describes a corresp. buffer */
    /* Which buffer has a non-zero stride. */
    uint32_t nonzero_stride_vb_mask; /* each bit describes a corresp. buffer */
+
+   /* The last upload of each user buffer. */
+   struct u_vbuf_user_upload user_upload[PIPE_MAX_ATTRIBS];
 };
 
 static void *
@@ -380,6 +404,11 @@ void u_vbuf_destroy(struct u_vbuf *mgr)
 
    pipe_vertex_buffer_unreference(&mgr->vertex_buffer0_saved);
 
+   for (i = 0; i < PIPE_MAX_ATTRIBS; i++) {
+      pipe_resource_reference(&mgr->user_upload[i].resource, NULL);
+      FREE(mgr->user_upload[i].shadow);
+   }
+
    translate_cache_destroy(mgr->translate_cache);
    cso_cache_delete(mgr->cso_cache);
    FREE(mgr);
@@ -897,6 +926,64 @@ void u_vbuf_set_vertex_buffers(struct u_vbuf *mgr,
    mgr->dirty_real_vb_mask |= ~mask;
 }
 
+/**
+ * Try to use the previous upload of user buffer \p index for the range
+ * [start, end) of \p ptr, which is possible if it covered the range and
+ * the data didn't change since.
+ */
+static boolean
+u_vbuf_reuse_upload(struct u_vbuf *mgr, unsigned index,
+                    const uint8_t *ptr, unsigned start, unsigned end)
+{
+   struct u_vbuf_user_upload *upload = &mgr->user_upload[index];
+   struct pipe_vertex_buffer *real_vb = &mgr->real_vertex_buffer[index];
+
+   if (upload->ptr != ptr || !upload->resource ||
+       start < upload->start || end > upload->end ||
+       memcmp(upload->shadow + (start - upload->start), ptr + start,
+              end - start))
+      return FALSE;
+
+   pipe_resource_reference(&real_vb->buffer.resource, upload->resource);
+   real_vb->buffer_offset = upload->buffer_offset;
+   return TRUE;
+}
+
+/**
+ * Remember the upload of user buffer \p index just done.
+ */
+static void
+u_vbuf_record_upload(struct u_vbuf *mgr, unsigned index,
+                     const uint8_t *ptr, unsigned start, unsigned end)
+{
+   struct u_vbuf_user_upload *upload = &mgr->user_upload[index];
+   const struct pipe_vertex_buffer *real_vb = &mgr->real_vertex_buffer[index];
+   const unsigned size = end - start;
+
+   if (size < U_VBUF_UPLOAD_CACHE_MIN_SIZE ||
+       size > U_VBUF_UPLOAD_CACHE_MAX_SIZE) {
+      pipe_resource_reference(&upload->resource, NULL);
+      return;
+   }
+
+   if (size > upload->shadow_size) {
+      FREE(upload->shadow);
+      upload->shadow = MALLOC(size);
+      upload->shadow_size = upload->shadow ? size : 0;
+      if (!upload->shadow) {
+         pipe_resource_reference(&upload->resource, NULL);
+         return;
+      }
+   }
+
+   memcpy(upload->shadow, ptr + start, size);
+   upload->ptr = ptr;
+   upload->start = start;
+   upload->end = end;
+   upload->buffer_offset = real_vb->buffer_offset;
+   pipe_resource_reference(&upload->resource, real_vb->buffer.resource);
+}
+
 static enum pipe_error
 u_vbuf_upload_buffers(struct u_vbuf *mgr,
                       int start_vertex, unsigned num_vertices,
@@ -985,6 +1072,9 @@ u_vbuf_upload_buffers(struct u_vbuf *mgr,
       real_vb = &mgr->real_vertex_buffer[i];
       ptr = mgr->vertex_buffer[i].buffer.user;
 
+      if (u_vbuf_reuse_upload(mgr, i, ptr, start, end))
+         continue;
+
       u_upload_data(mgr->pipe->stream_uploader,
                     mgr->has_signed_vb_offset ? 0 : start,
                     end - start, 4,
@@ -993,6 +1083,8 @@ u_vbuf_upload_buffers(struct u_vbuf *mgr,
          return PIPE_ERROR_OUT_OF_MEMORY;
 
       real_vb->buffer_offset -= start;
+
+      u_vbuf_record_upload(mgr, i, ptr, start, end);
    }
 
    return PIPE_OK;
@@ -36,8 +36,8 @@ struct cs_viewport {
    float scale_x;
    float scale_y;
    struct u_rect area;
-   int translate_x;
-   int translate_y;
+   float translate_x;
+   float translate_y;
    float sampler0_w;
    float sampler0_h;
 };
@@ -72,8 +72,8 @@ const char *compute_shader_video_buffer =
 
       "UIF TEMP[1]\n"
          /* Translate */
-         "UADD TEMP[2].xy, TEMP[0], -CONST[5].xyxy\n"
-         "U2F TEMP[2], TEMP[2]\n"
+         "U2F TEMP[2], TEMP[0]\n"
+         "ADD TEMP[2].xy, TEMP[2], -CONST[5].xyxy\n"
          "DIV TEMP[3], TEMP[2], IMM[1].yyyy\n"
 
          /* Scale */
@@ -134,12 +134,11 @@ const char *compute_shader_weave =
       "AND TEMP[1].x, TEMP[1].xxxx, TEMP[1].wwww\n"
 
       "UIF TEMP[1]\n"
-         "MOV TEMP[2], TEMP[0]\n"
          /* Translate */
-         "UADD TEMP[2].xy, TEMP[2], -CONST[5].xyxy\n"
+         "U2F TEMP[2], TEMP[0]\n"
+         "ADD TEMP[2].xy, TEMP[2], -CONST[5].xyxy\n"
 
          /* Top Y */
-         "U2F TEMP[2], TEMP[2]\n"
          "DIV TEMP[2].y, TEMP[2].yyyy, IMM[1].yyyy\n"
          /* Down Y */
          "MOV TEMP[12], TEMP[2]\n"
@@ -250,8 +249,8 @@ const char *compute_shader_rgba =
 
       "UIF TEMP[1]\n"
          /* Translate */
-         "UADD TEMP[2].xy, TEMP[0], -CONST[5].xyxy\n"
-         "U2F TEMP[2], TEMP[2]\n"
+         "U2F TEMP[2], TEMP[0]\n"
+         "ADD TEMP[2].xy, TEMP[2], -CONST[5].xyxy\n"
 
          /* Scale */
          "DIV TEMP[2], TEMP[2], CONST[3].zwzw\n"
@@ -324,23 +323,15 @@ calc_drawn_area(struct vl_compositor_state *s,
    return result;
 }
 
-static bool
+static void
 set_viewport(struct vl_compositor_state *s,
              struct cs_viewport         *drawn)
 {
-   struct pipe_transfer *buf_transfer;
+   uint32_t data[10];
 
    assert(s && drawn);
 
-   void *ptr = pipe_buffer_map(s->pipe, s->shader_params,
-                               PIPE_TRANSFER_READ | PIPE_TRANSFER_WRITE,
-                               &buf_transfer);
-
-   if (!ptr)
-     return false;
-
-   float *ptr_float = (float *)ptr;
-   ptr_float += sizeof(vl_csc_matrix)/sizeof(float) + 2;
+   float *ptr_float = (float *)data;
    *ptr_float++ = drawn->scale_x;
    *ptr_float++ = drawn->scale_y;
 
@@ -349,15 +340,20 @@ set_viewport(struct vl_compositor_state *s,
    *ptr_int++ = drawn->area.y0;
    *ptr_int++ = drawn->area.x1;
    *ptr_int++ = drawn->area.y1;
-   *ptr_int++ = drawn->translate_x;
-   *ptr_int++ = drawn->translate_y;
 
    ptr_float = (float *)ptr_int;
+   *ptr_float++ = drawn->translate_x;
+   *ptr_float++ = drawn->translate_y;
    *ptr_float++ = drawn->sampler0_w;
    *ptr_float = drawn->sampler0_h;
-   pipe_buffer_unmap(s->pipe, buf_transfer);
 
-   return true;
+   /* The previous layer's dispatch may still be reading the constants,
+    * only update our part of them instead of mapping the buffer, which
+    * would wait for it.
+    */
+   pipe_buffer_write(s->pipe, s->shader_params,
+                     sizeof(vl_csc_matrix) + 2 * sizeof(float),
+                     sizeof(data), data);
 }
 
 static void
@@ -374,16 +370,42 @@ draw_layers(struct vl_compositor       *c,
          struct vl_compositor_layer *layer = &s->layers[i];
          struct pipe_sampler_view **samplers = &layer->sampler_views[0];
          unsigned num_sampler_views = !samplers[1] ? 1 : !samplers[2] ? 2 : 3;
+         struct pipe_resource *tex = layer->sampler_views[0]->texture;
          struct cs_viewport drawn;
 
+         if (!layer->viewport_valid) {
+            layer->viewport.scale[0] = c->fb_state.width;
+            layer->viewport.scale[1] = c->fb_state.height;
+            layer->viewport.translate[0] = 0;
+            layer->viewport.translate[1] = 0;
+         }
+
+         /* Weave reads both fields, so its source rectangle is in frame
+          * lines, everything else samples a single layer.
+          */
+         float tex_w = tex->width0;
+         float tex_h = tex->height0 *
+                       (layer->cs == c->cs_weave_rgb ? tex->array_size : 1);
+         float dst_x = layer->dst.tl.x * layer->viewport.scale[0] +
+                       layer->viewport.translate[0];
+         float dst_y = layer->dst.tl.y * layer->viewport.scale[1] +
+                       layer->viewport.translate[1];
+
+         /* Map the destination rectangle onto the source rectangle, so
+          * that cropping and scaling in both directions happen in the
+          * same dispatch as the color conversion.
+          */
          drawn.area = calc_drawn_area(s, layer);
-         drawn.scale_x = layer->viewport.scale[0] /
-                  (float)layer->sampler_views[0]->texture->width0;
-         drawn.scale_y = drawn.scale_x;
-         drawn.translate_x = (int)layer->viewport.translate[0];
-         drawn.translate_y = (int)layer->viewport.translate[1];
-         drawn.sampler0_w = (float)layer->sampler_views[0]->texture->width0;
-         drawn.sampler0_h = (float)layer->sampler_views[0]->texture->height0;
+         drawn.scale_x = (layer->dst.br.x - layer->dst.tl.x) *
+                         layer->viewport.scale[0] /
+                         ((layer->src.br.x - layer->src.tl.x) * tex_w);
+         drawn.scale_y = (layer->dst.br.y - layer->dst.tl.y) *
+                         layer->viewport.scale[1] /
+                         ((layer->src.br.y - layer->src.tl.y) * tex_h);
+         drawn.translate_x = dst_x - layer->src.tl.x * tex_w * drawn.scale_x;
+         drawn.translate_y = dst_y - layer->src.tl.y * tex_h * drawn.scale_y;
+         drawn.sampler0_w = (float)tex->width0;
+         drawn.sampler0_h = (float)tex->height0;
          set_viewport(s, &drawn);
 
          c->pipe->bind_sampler_states(c->pipe, PIPE_SHADER_COMPUTE, 0,
@@ -396,7 +418,7 @@ draw_layers(struct vl_compositor       *c,
          /* Unbind. */
          c->pipe->set_shader_images(c->pipe, PIPE_SHADER_COMPUTE, 0, 1, NULL);
          c->pipe->set_constant_buffer(c->pipe, PIPE_SHADER_COMPUTE, 0, NULL);
-         c->pipe->set_sampler_views(c->pipe, PIPE_SHADER_FRAGMENT, 0,
+         c->pipe->set_sampler_views(c->pipe, PIPE_SHADER_COMPUTE, 0,
                         num_sampler_views, NULL);
          c->pipe->bind_compute_state(c->pipe, NULL);
          c->pipe->bind_sampler_states(c->pipe, PIPE_SHADER_COMPUTE, 0,
@@ -63,6 +63,8 @@
 #include "tgsi/tgsi_lowering.h"
 #include "tgsi/tgsi_strings.h"
 #include "tgsi/tgsi_util.h"
+#include "util/ralloc.h"
+#include "util/register_allocate.h"
 #include "util/u_math.h"
 #include "util/u_memory.h"
 
@@ -168,6 +170,15 @@ struct etna_compile {
    /* Next free native register, for register allocation */
    uint32_t next_free_native;
 
+   /* TEMPs are accessed indirectly, so they must stay contiguous */
+   bool temps_indirect;
+
+   /* Union of the live ranges of the TEMPs assigned to each native temp
+    * register, used for sharing them with inputs and outputs.
+    */
+   struct etna_reg_desc native_temp[ETNA_MAX_TEMPS];
+   struct etna_compile_file native_temp_file;
+
    /* Temporary register for use within translated TGSI instruction,
     * only allocated when needed.
     */
@@ -296,10 +307,63 @@ alloc_new_native_reg(struct etna_compile *c)
    return etna_native_temp(c->next_free_native++);
 }
 
-/* assign TEMPs to native registers */
+/* Do the live ranges of two registers overlap? Ranges that only touch at one
+ * instruction are considered to overlap, as the translation of a single TGSI
+ * instruction may read its sources after writing part of its destination.
+ */
+static bool
+etna_reg_ranges_overlap(const struct etna_reg_desc *a,
+                        const struct etna_reg_desc *b)
+{
+   return a->first_use <= b->last_use && b->first_use <= a->last_use;
+}
+
+/* Record the union of the live ranges of the TEMPs assigned to each native
+ * register.
+ */
 static void
-assign_temporaries_to_native(struct etna_compile *c,
-                             struct etna_compile_file *file)
+gather_native_temp_ranges(struct etna_compile *c,
+                          struct etna_compile_file *file)
+{
+   struct etna_reg_desc *temps = file->reg;
+
+   for (int id = 0; id < ETNA_MAX_TEMPS; ++id) {
+      c->native_temp[id] = (struct etna_reg_desc) {
+         .file = TGSI_FILE_TEMPORARY,
+         .idx = id,
+         .first_use = -1,
+         .last_use = -1,
+      };
+   }
+
+   for (int idx = 0; idx < file->reg_size; ++idx) {
+      struct etna_reg_desc *native_temp;
+
+      if (!temps[idx].active || !temps[idx].native.valid)
+         continue;
+
+      native_temp = &c->native_temp[temps[idx].native.id];
+      if (!native_temp->active) {
+         native_temp->active = true;
+         native_temp->native = temps[idx].native;
+         native_temp->first_use = temps[idx].first_use;
+         native_temp->last_use = temps[idx].last_use;
+      } else {
+         native_temp->first_use = MIN2(native_temp->first_use,
+                                       temps[idx].first_use);
+         native_temp->last_use = MAX2(native_temp->last_use,
+                                      temps[idx].last_use);
+      }
+   }
+
+   c->native_temp_file.reg = c->native_temp;
+   c->native_temp_file.reg_size = ETNA_MAX_TEMPS;
+}
+
+/* assign TEMPs to native registers, one native register per TEMP */
+static void
+assign_temporaries_to_native_linear(struct etna_compile *c,
+                                    struct etna_compile_file *file)
 {
    struct etna_reg_desc *temps = file->reg;
 
@@ -307,11 +371,86 @@ assign_temporaries_to_native(struct etna_compile *c,
       temps[idx].native = alloc_new_native_reg(c);
 }
 
+/* assign TEMPs to native registers
+ * TEMPs whose live ranges don't overlap share a native register. The live
+ * ranges are intervals over the instruction stream (extended over loops by
+ * etna_compile_pass_check_usage), so the graph colors without spilling
+ * whenever the registers live at any one point fit in the hardware.
+ */
+static void
+assign_temporaries_to_native(struct etna_compile *c,
+                             struct etna_compile_file *file)
+{
+   struct etna_reg_desc *temps = file->reg;
+   int num_nodes = 0;
+
+   /* Indirectly addressed TEMPs are arrays, keep them in order */
+   if (c->temps_indirect) {
+      assign_temporaries_to_native_linear(c, file);
+      gather_native_temp_ranges(c, file);
+      return;
+   }
+
+   void *mem_ctx = ralloc_context(NULL);
+   int *node_to_temp = ralloc_array(mem_ctx, int, file->reg_size);
+
+   for (int idx = 0; idx < file->reg_size; ++idx) {
+      if (temps[idx].active)
+         node_to_temp[num_nodes++] = idx;
+   }
+
+   struct ra_regs *regs = ra_alloc_reg_set(mem_ctx, ETNA_MAX_TEMPS, false);
+   unsigned int reg_class = ra_alloc_reg_class(regs);
+
+   /* Registers below next_free_native are already spoken for */
+   for (unsigned int r = c->next_free_native; r < ETNA_MAX_TEMPS; ++r)
+      ra_class_add_reg(regs, reg_class, r);
+
+   ra_set_finalize(regs, NULL);
+
+   struct ra_graph *g = ra_alloc_interference_graph(regs, num_nodes);
+
+   for (int i = 0; i < num_nodes; ++i) {
+      ra_set_node_class(g, i, reg_class);
+
+      for (int j = 0; j < i; ++j) {
+         if (etna_reg_ranges_overlap(&temps[node_to_temp[i]],
+                                     &temps[node_to_temp[j]]))
+            ra_add_node_interference(g, i, j);
+      }
+   }
+
+   if (!ra_allocate(g)) {
+      DBG("Failed to allocate %d temporaries, falling back to linear",
+          num_nodes);
+      ralloc_free(mem_ctx);
+      assign_temporaries_to_native_linear(c, file);
+      gather_native_temp_ranges(c, file);
+      return;
+   }
+
+   uint32_t next_free_native = c->next_free_native;
+
+   for (int i = 0; i < num_nodes; ++i) {
+      unsigned int r = ra_get_node_reg(g, i);
+
+      temps[node_to_temp[i]].native = etna_native_temp(r);
+      next_free_native = MAX2(next_free_native, r + 1);
+   }
+
+   c->next_free_native = next_free_native;
+
+   ralloc_free(mem_ctx);
+
+   gather_native_temp_ranges(c, file);
+}
+
 /* assign inputs and outputs to temporaries
  * Gallium assumes that the hardware has separate registers for taking input and
  * output, however Vivante GPUs use temporaries both for passing in inputs and
  * passing back outputs.
- * Try to re-use temporary registers where possible. */
+ * Try to re-use temporary registers where possible, going by the combined live
+ * range of the TEMPs sharing each native register. */
 static void
 assign_inouts_to_temporaries(struct etna_compile *c, uint file)
 {
@@ -322,7 +461,7 @@ assign_inouts_to_temporaries(struct etna_compile *c, uint file)
    struct sort_rec temps_order[ETNA_MAX_TEMPS];
    num_inouts = sort_registers(inout_order, &c->file[file],
                                mode_inputs ? LAST_USE_ASC : FIRST_USE_ASC);
-   num_temps = sort_registers(temps_order, &c->file[TGSI_FILE_TEMPORARY],
+   num_temps = sort_registers(temps_order, &c->native_temp_file,
                               mode_inputs ? FIRST_USE_ASC : LAST_USE_ASC);
 
    while (inout_ptr < num_inouts && temp_ptr < num_temps) {
@@ -524,6 +663,21 @@ etna_allocate_decls(struct etna_compile *c)
    c->total_decls = idx;
 }
 
+/* Extend the ranges of all registers used within a loop over the whole loop */
+static void
+extend_ranges_over_loop(struct etna_compile *c, int loop_begin, int loop_end)
+{
+   for (int idx = 0; idx < c->total_decls; ++idx) {
+      struct etna_reg_desc *reg = &c->decl[idx];
+
+      if (!reg->active || reg->last_use < loop_begin)
+         continue;
+
+      reg->first_use = MIN2(reg->first_use, loop_begin);
+      reg->last_use = loop_end;
+   }
+}
+
 /* Pass -- check and record usage of temporaries, inputs, outputs */
 static void
 etna_compile_pass_check_usage(struct etna_compile *c)
@@ -537,30 +691,24 @@ etna_compile_pass_check_usage(struct etna_compile *c)
       c->decl[idx].first_use = c->decl[idx].last_use = -1;
    }
 
+   c->temps_indirect = false;
+
    int inst_idx = 0;
+   int loop_depth = 0, loop_begin = -1;
    while (!tgsi_parse_end_of_tokens(&ctx)) {
       tgsi_parse_token(&ctx);
       /* find out max register #s used
        * For every register mark first and last instruction index where it's
        * used this allows finding ranges where the temporary can be borrowed
-       * as input and/or output register
-       *
-       * XXX in the case of loops this needs special care, or even be completely
-       * disabled, as
-       * the last usage of a register inside a loop means it can still be used
-       * on next loop
-       * iteration (execution is no longer * chronological). The register can
-       * only be
-       * declared "free" after the loop finishes.
+       * as input and/or output register, or shared with other temporaries.
        *
-       * Same for inputs: the first usage of a register inside a loop doesn't
-       * mean that the register
-       * won't have been overwritten in previous iteration. The register can
-       * only be declared free before the loop
-       * starts.
-       * The proper way would be to do full dominator / post-dominator analysis
-       * (especially with more complicated
-       * control flow such as direct branch instructions) but not for now...
+       * Loops need special care, as the last usage of a register inside a
+       * loop doesn't mean that it is free: it can still be used on the next
+       * iteration. Likewise the first usage of a register inside a loop
+       * doesn't mean that it won't have been written in a previous
+       * iteration. Rather than doing a full liveness analysis, the range of
+       * every register used in a loop is extended over the whole of the
+       * outermost loop when it ends.
        */
       switch (ctx.FullToken.Token.Type) {
       case TGSI_TOKEN_TYPE_DECLARATION: {
@@ -604,6 +752,28 @@ etna_compile_pass_check_usage(struct etna_compile *c)
              * should be allocated */
             reg_desc->usage_mask |= tgsi_util_get_inst_usage_mask(inst, idx);
          }
+
+         for (int idx = 0; idx < inst->Instruction.NumDstRegs; ++idx) {
+            if (inst->Dst[idx].Register.File == TGSI_FILE_TEMPORARY &&
+                inst->Dst[idx].Register.Indirect)
+               c->temps_indirect = true;
+         }
+
+         for (int idx = 0; idx < inst->Instruction.NumSrcRegs; ++idx) {
+            if (inst->Src[idx].Register.File == TGSI_FILE_TEMPORARY &&
+                inst->Src[idx].Register.Indirect)
+               c->temps_indirect = true;
+         }
+
+         if (inst->Instruction.Opcode == TGSI_OPCODE_BGNLOOP) {
+            if (loop_depth++ == 0)
+               loop_begin = inst_idx;
+         } else if (inst->Instruction.Opcode == TGSI_OPCODE_ENDLOOP) {
+            assert(loop_depth > 0);
+            if (--loop_depth == 0)
+               extend_ranges_over_loop(c, loop_begin, inst_idx);
+         }
+
          inst_idx += 1;
       } break;
       default:
@@ -652,7 +822,8 @@ etna_mov_check_no_swizzle(const struct tgsi_dst_register dst,
  *   MOV OUT[2], TEMP[1]
  * Recognize if
  * a) there is only a single assignment to an output register and
- * b) the temporary is not used after that
+ * b) the temporary, and any other temporary sharing its native register, is
+ *    not used after that
  * Also recognize direct assignment of IN to OUT (passthrough)
  **/
 static void
@@ -695,11 +866,13 @@ etna_compile_pass_optimize_outputs(struct etna_compile *c)
              */
             if (inst->Src[0].Register.File == TGSI_FILE_TEMPORARY &&
                 !c->file[TGSI_FILE_OUTPUT].reg[out_idx].native.valid &&
-                c->file[TGSI_FILE_TEMPORARY].reg[in_idx].last_use == inst_idx) {
+                c->file[TGSI_FILE_TEMPORARY].reg[in_idx].last_use == inst_idx &&
+                c->native_temp[c->file[TGSI_FILE_TEMPORARY].reg[in_idx].native.id].last_use == inst_idx) {
                c->file[TGSI_FILE_OUTPUT].reg[out_idx].native =
                   c->file[TGSI_FILE_TEMPORARY].reg[in_idx].native;
                /* prevent temp from being re-used for the rest of the shader */
                c->file[TGSI_FILE_TEMPORARY].reg[in_idx].last_use = ETNA_MAX_TOKENS;
+               c->native_temp[c->file[TGSI_FILE_TEMPORARY].reg[in_idx].native.id].last_use = ETNA_MAX_TOKENS;
                /* mark this MOV instruction as a no-op */
                c->dead_inst[inst_idx] = true;
             }
@@ -96,7 +96,7 @@ etna_screen_destroy(struct pipe_screen *pscreen)
       etna_gpu_del(screen->gpu);
 
    if (screen->ro)
-      FREE(screen->ro);
+      renderonly_destroy(screen->ro);
 
    if (screen->dev)
       etna_device_del(screen->dev);
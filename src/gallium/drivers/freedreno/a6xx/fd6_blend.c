@@ -27,6 +27,7 @@
 
 #include "pipe/p_state.h"
 #include "util/u_blend.h"
+#include "util/u_format.h"
 #include "util/u_string.h"
 #include "util/u_memory.h"
 
@@ -90,6 +91,7 @@ fd6_blend_state_create(struct pipe_context *pctx,
 		return NULL;
 
 	so->base = *cso;
+	list_inithead(&so->variants);
 
 	for (i = 0; i < ARRAY_SIZE(so->rb_mrt); i++) {
 		const struct pipe_rt_blend_state *rt;
@@ -146,3 +148,100 @@ fd6_blend_state_create(struct pipe_context *pctx,
 
 	return so;
 }
+
+void
+fd6_blend_state_delete(struct pipe_context *pctx, void *hwcso)
+{
+	struct fd6_blend_stateobj *so = hwcso;
+
+	list_for_each_entry_safe(struct fd6_blend_variant, variant,
+			&so->variants, node) {
+		fd_ringbuffer_del(variant->stateobj);
+		free(variant);
+	}
+
+	FREE(hwcso);
+}
+
+static uint32_t
+blend_variant_key(const struct pipe_framebuffer_state *pfb)
+{
+	uint32_t int_mask = 0, no_alpha_mask = 0;
+
+	for (unsigned i = 0; i < pfb->nr_cbufs; i++) {
+		enum pipe_format format = pipe_surface_format(pfb->cbufs[i]);
+
+		if (util_format_is_pure_integer(format))
+			int_mask |= (1 << i);
+		if (!util_format_has_alpha(format))
+			no_alpha_mask |= (1 << i);
+	}
+
+	return pfb->nr_cbufs | (int_mask << 8) | (no_alpha_mask << 16);
+}
+
+static struct fd_ringbuffer *
+build_blend_variant(struct fd6_blend_stateobj *blend, struct fd_context *ctx,
+		uint32_t key)
+{
+	unsigned nr_cbufs = key & 0xff;
+	struct fd_ringbuffer *ring =
+		fd_ringbuffer_new_object(ctx->pipe, (4 * nr_cbufs + 2) * 4);
+
+	for (unsigned i = 0; i < nr_cbufs; i++) {
+		bool is_int = key & (1 << (i + 8));
+		bool has_alpha = !(key & (1 << (i + 16)));
+		uint32_t control = blend->rb_mrt[i].control;
+		uint32_t blend_control = blend->rb_mrt[i].blend_control_alpha;
+
+		if (is_int) {
+			control &= A6XX_RB_MRT_CONTROL_COMPONENT_ENABLE__MASK;
+			control |= A6XX_RB_MRT_CONTROL_ROP_CODE(ROP_COPY);
+		}
+
+		if (has_alpha) {
+			blend_control |= blend->rb_mrt[i].blend_control_rgb;
+		} else {
+			blend_control |= blend->rb_mrt[i].blend_control_no_alpha_rgb;
+			control &= ~A6XX_RB_MRT_CONTROL_BLEND2;
+		}
+
+		OUT_PKT4(ring, REG_A6XX_RB_MRT_CONTROL(i), 1);
+		OUT_RING(ring, control);
+
+		OUT_PKT4(ring, REG_A6XX_RB_MRT_BLEND_CONTROL(i), 1);
+		OUT_RING(ring, blend_control);
+	}
+
+	OUT_PKT4(ring, REG_A6XX_SP_BLEND_CNTL, 1);
+	OUT_RING(ring, blend->sp_blend_cntl);
+
+	return ring;
+}
+
+/**
+ * Returns the prebuilt MRT blend state for the current color buffers,
+ * building it on first use.  The state object is owned by the CSO.
+ */
+struct fd_ringbuffer *
+fd6_blend_get_stateobj(struct fd6_blend_stateobj *blend, struct fd_context *ctx,
+		const struct pipe_framebuffer_state *pfb)
+{
+	uint32_t key = blend_variant_key(pfb);
+	struct fd6_blend_variant *variant;
+
+	list_for_each_entry(struct fd6_blend_variant, v, &blend->variants, node) {
+		if (v->key == key)
+			return v->stateobj;
+	}
+
+	variant = malloc(sizeof(*variant));
+	if (!variant)
+		return NULL;
+
+	variant->key = key;
+	variant->stateobj = build_blend_variant(blend, ctx, key);
+	list_add(&variant->node, &blend->variants);
+
+	return variant->stateobj;
+}
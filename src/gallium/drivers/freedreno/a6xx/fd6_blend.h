@@ -32,6 +32,20 @@
 #include "pipe/p_context.h"
 
 #include "freedreno_util.h"
+#include "util/list.h"
+
+struct fd_context;
+
+/* The MRT blend state depends on the formats of the bound color buffers
+ * (pure integer formats can't blend, formats without alpha need the dst
+ * alpha factors fixed up), so a blend CSO keeps one prebuilt state object
+ * per combination of formats it has been used with.
+ */
+struct fd6_blend_variant {
+	struct list_head node;
+	uint32_t key;
+	struct fd_ringbuffer *stateobj;
+};
 
 struct fd6_blend_stateobj {
 	struct pipe_blend_state base;
@@ -48,6 +62,7 @@ struct fd6_blend_stateobj {
 	} rb_mrt[A6XX_MAX_RENDER_TARGETS];
 	uint32_t rb_blend_cntl;
 	uint32_t sp_blend_cntl;
+	struct list_head variants;
 };
 
 static inline struct fd6_blend_stateobj *
@@ -56,7 +71,11 @@ fd6_blend_stateobj(struct pipe_blend_state *blend)
 	return (struct fd6_blend_stateobj *)blend;
 }
 
+struct fd_ringbuffer * fd6_blend_get_stateobj(struct fd6_blend_stateobj *blend,
+		struct fd_context *ctx, const struct pipe_framebuffer_state *pfb);
+
 void * fd6_blend_state_create(struct pipe_context *pctx,
 		const struct pipe_blend_state *cso);
+void fd6_blend_state_delete(struct pipe_context *, void *hwcso);
 
 #endif /* FD6_BLEND_H_ */
@@ -107,10 +107,11 @@ fd6_context_create(struct pipe_screen *pscreen, void *priv, unsigned flags)
 
 	util_blitter_set_texture_multisample(fd6_ctx->base.blitter, true);
 
-	/* fd_context_init overwrites delete_rasterizer_state, so set this
+	/* fd_context_init overwrites delete_rasterizer_state, so set these
 	 * here. */
 	pctx->delete_rasterizer_state = fd6_rasterizer_state_delete;
 	pctx->delete_depth_stencil_alpha_state = fd6_depth_stencil_alpha_state_delete;
+	pctx->delete_blend_state = fd6_blend_state_delete;
 
 	fd6_ctx->vsc_data = fd_bo_new(screen->dev,
 			(A6XX_VSC_DATA_PITCH * 32) + 0x100,
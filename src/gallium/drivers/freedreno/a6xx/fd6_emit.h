@@ -56,6 +56,7 @@ enum fd6_state_id {
 	FD6_GROUP_IBO,
 	FD6_GROUP_RASTERIZER,
 	FD6_GROUP_ZSA,
+	FD6_GROUP_BLEND,
 };
 
 struct fd6_state_group {
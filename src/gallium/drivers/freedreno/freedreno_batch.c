@@ -432,13 +432,19 @@ fd_batch_add_dep(struct fd_batch *batch, struct fd_batch *dep)
 }
 
 static void
-flush_write_batch(struct fd_resource *rsc)
+flush_write_batch(struct fd_batch *batch, struct fd_resource *rsc)
 {
 	struct fd_batch *b = NULL;
 	fd_batch_reference_locked(&b, rsc->write_batch);
 
+	/* The batches of a context are submitted in order by its flush_queue,
+	 * so we only have to wait for the writer's submit (and tile passes)
+	 * if it belongs to another context:
+	 */
+	bool sync = b->ctx != batch->ctx;
+
 	mtx_unlock(&b->ctx->screen->lock);
-	fd_batch_flush(b, true, false);
+	fd_batch_flush(b, sync, false);
 	mtx_lock(&b->ctx->screen->lock);
 
 	fd_bc_invalidate_batch(b, false);
@@ -469,7 +475,7 @@ fd_batch_resource_used(struct fd_batch *batch, struct fd_resource *rsc, bool wri
 			struct fd_batch *dep;
 
 			if (rsc->write_batch && rsc->write_batch != batch)
-				flush_write_batch(rsc);
+				flush_write_batch(batch, rsc);
 
 			foreach_batch(dep, cache, rsc->batch_mask) {
 				struct fd_batch *b = NULL;
@@ -492,7 +498,7 @@ fd_batch_resource_used(struct fd_batch *batch, struct fd_resource *rsc, bool wri
 		 * flush the current batch in _resource_used()
 		 */
 		if (rsc->write_batch && rsc->write_batch != batch)
-			flush_write_batch(rsc);
+			flush_write_batch(batch, rsc);
 	}
 
 	if (rsc->batch_mask & (1 << batch->idx)) {
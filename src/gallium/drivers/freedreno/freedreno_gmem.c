@@ -102,6 +102,78 @@ total_size(uint8_t cbuf_cpp[], uint8_t zsbuf_cpp[2],
 	return total;
 }
 
+#define div_round_up(v, a)  (((v) + (a) - 1) / (a))
+
+/* Find the tile layout with the fewest bins that fits in GMEM.
+ *
+ * The bins partition the render area and are clipped at its edges, so
+ * every layout restores and resolves exactly the same pixels.  What does
+ * differ is the per-bin cost of setting up the tile and replaying the
+ * draw cmds, so the cheapest layout is the one with the fewest bins.
+ * Between layouts with the same number of bins, the one with squarer
+ * bins is picked, since it tends to let the visibility stream skip more
+ * draws per bin.
+ */
+static void
+find_tile_layout(uint8_t cbuf_cpp[], uint8_t zsbuf_cpp[2],
+		uint32_t width, uint32_t height, uint32_t alignw, uint32_t alignh,
+		uint32_t max_width, uint32_t gmem_align, uint32_t gmem_size,
+		struct fd_gmem_stateobj *gmem,
+		uint32_t *nbins_x, uint32_t *nbins_y,
+		uint32_t *bin_w, uint32_t *bin_h)
+{
+	uint32_t max_nbins_x = div_round_up(MAX2(width, 1), alignw);
+	uint32_t max_h = align(MAX2(height, 1), alignh) / alignh;
+	uint32_t best = ~0;
+
+	/* in case nothing fits, fall back to the smallest possible bins: */
+	*nbins_x = max_nbins_x;
+	*nbins_y = max_h;
+	*bin_w = alignw;
+	*bin_h = alignh;
+
+	for (uint32_t nx = 1; nx <= max_nbins_x && nx <= best; nx++) {
+		uint32_t bw = align(div_round_up(MAX2(width, 1), nx), alignw);
+
+		if (bw > max_width)
+			continue;
+
+		/* a smaller nx already gave the same bin width: */
+		if (div_round_up(MAX2(width, 1), bw) != nx)
+			continue;
+
+		/* binary search for the tallest bin that fits, in units of the
+		 * alignment:
+		 */
+		uint32_t lo = 0, hi = max_h;
+		while (lo < hi) {
+			uint32_t mid = (lo + hi + 1) / 2;
+			if (total_size(cbuf_cpp, zsbuf_cpp, bw, mid * alignh,
+					gmem_align, gmem) <= gmem_size)
+				lo = mid;
+			else
+				hi = mid - 1;
+		}
+
+		if (!lo)
+			continue;
+
+		uint32_t ny = div_round_up(max_h, lo);
+		uint32_t bh = align(div_round_up(MAX2(height, 1), ny), alignh);
+		ny = div_round_up(MAX2(height, 1), bh);
+
+		uint32_t nbins = nx * ny;
+		if (nbins < best ||
+				(nbins == best && MAX2(bw, bh) < MAX2(*bin_w, *bin_h))) {
+			best = nbins;
+			*nbins_x = nx;
+			*nbins_y = ny;
+			*bin_w = bw;
+			*bin_h = bh;
+		}
+	}
+}
+
 static void
 calculate_tiles(struct fd_batch *batch)
 {
@@ -115,7 +187,7 @@ calculate_tiles(struct fd_batch *batch)
 	const unsigned npipes = screen->num_vsc_pipes;
 	const uint32_t gmem_size = screen->gmemsize_bytes;
 	uint32_t minx, miny, width, height;
-	uint32_t nbins_x = 1, nbins_y = 1;
+	uint32_t nbins_x, nbins_y;
 	uint32_t bin_w, bin_h;
 	uint32_t gmem_align = 0x4000;
 	uint32_t max_width = bin_width(screen);
@@ -165,17 +237,6 @@ calculate_tiles(struct fd_batch *batch)
 		height = scissor->maxy - miny;
 	}
 
-	bin_w = align(width, gmem_alignw);
-	bin_h = align(height, gmem_alignh);
-
-	/* first, find a bin width that satisfies the maximum width
-	 * restrictions:
-	 */
-	while (bin_w > max_width) {
-		nbins_x++;
-		bin_w = align(width / nbins_x, gmem_alignw);
-	}
-
 	if (fd_mesa_debug & FD_DBG_MSGS) {
 		debug_printf("binning input: cbuf cpp:");
 		for (i = 0; i < pfb->nr_cbufs; i++)
@@ -191,22 +252,22 @@ calculate_tiles(struct fd_batch *batch)
 		gmem_align = 0x8000;
 	}
 
-	/* then find a bin width/height that satisfies the memory
-	 * constraints:
-	 */
-	while (total_size(cbuf_cpp, zsbuf_cpp, bin_w, bin_h, gmem_align, gmem) >
-		   gmem_size) {
-		if (bin_w > bin_h) {
-			nbins_x++;
-			bin_w = align(width / nbins_x, gmem_alignw);
-		} else {
-			nbins_y++;
-			bin_h = align(height / nbins_y, gmem_alignh);
-		}
-	}
+	find_tile_layout(cbuf_cpp, zsbuf_cpp, width, height,
+			gmem_alignw, gmem_alignh, max_width, gmem_align, gmem_size,
+			gmem, &nbins_x, &nbins_y, &bin_w, &bin_h);
+
+	/* update the buffer offsets for the chosen bin size: */
+	total_size(cbuf_cpp, zsbuf_cpp, bin_w, bin_h, gmem_align, gmem);
 
 	DBG("using %d bins of size %dx%d", nbins_x*nbins_y, bin_w, bin_h);
 
+	if (fd_mesa_debug & FD_DBG_GMEM) {
+		debug_printf("gmem: %ux%u bins of %ux%u for %ux%u+%u+%u, "
+				"restore=0x%x resolve=0x%x zs=%d draws=%u\n",
+				nbins_x, nbins_y, bin_w, bin_h, width, height, minx, miny,
+				batch->restore, batch->resolve, has_zs, batch->num_draws);
+	}
+
 	gmem->scissor = *scissor;
 	memcpy(gmem->cbuf_cpp, cbuf_cpp, sizeof(cbuf_cpp));
 	memcpy(gmem->zsbuf_cpp, zsbuf_cpp, sizeof(zsbuf_cpp));
@@ -227,7 +288,6 @@ calculate_tiles(struct fd_batch *batch)
 	 * performance.
 	 */
 
-#define div_round_up(v, a)  (((v) + (a) - 1) / (a))
 	/* figure out number of tiles per pipe: */
 	if (is_a20x(ctx->screen)) {
 		/* for a20x we want to minimize the number of "pipes"
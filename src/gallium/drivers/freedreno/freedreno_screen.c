@@ -58,6 +58,7 @@
 #include "a6xx/fd6_screen.h"
 
 
+#include "ir3/ir3_compiler.h"
 #include "ir3/ir3_nir.h"
 #include "a2xx/ir2.h"
 
@@ -89,6 +90,7 @@ static const struct debug_named_value debug_options[] = {
 		{"perfcntrs", FD_DBG_PERFC,  "Expose performance counters"},
 		{"softpin",   FD_DBG_SOFTPIN,"Enable softpin command submission (experimental)"},
 		{"ubwc",      FD_DBG_UBWC,   "Enable UBWC for all internal buffers (experimental)"},
+		{"gmem",      FD_DBG_GMEM,   "Print the chosen GMEM tile layout"},
 		DEBUG_NAMED_VALUE_END
 };
 
@@ -149,7 +151,7 @@ fd_screen_destroy(struct pipe_screen *pscreen)
 		fd_device_del(screen->dev);
 
 	if (screen->ro)
-		FREE(screen->ro);
+		renderonly_destroy(screen->ro);
 
 	fd_bc_fini(&screen->batch_cache);
 
@@ -157,7 +159,8 @@ fd_screen_destroy(struct pipe_screen *pscreen)
 
 	mtx_destroy(&screen->lock);
 
-	ralloc_free(screen->compiler);
+	if (screen->compiler)
+		ir3_compiler_destroy(screen->compiler);
 
 	free(screen->perfcntr_queries);
 	free(screen);
@@ -890,6 +893,9 @@ fd_screen_create(struct fd_device *dev, struct renderonly *ro)
 		goto fail;
 	}
 
+	if (screen->compiler)
+		ir3_disk_cache_init(screen->compiler);
+
 	if (screen->gpu_id >= 600) {
 		screen->gmem_alignw = 32;
 		screen->gmem_alignh = 32;
@@ -86,6 +86,7 @@ enum adreno_stencil_op fd_stencil_op(unsigned op);
 #define FD_DBG_PERFC  0x400000
 #define FD_DBG_SOFTPIN 0x800000
 #define FD_DBG_UBWC  0x1000000
+#define FD_DBG_GMEM  0x2000000
 extern int fd_mesa_debug;
 extern bool fd_binning_enabled;
 
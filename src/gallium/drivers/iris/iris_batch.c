@@ -46,6 +46,7 @@
 
 #include "util/hash_table.h"
 #include "util/set.h"
+#include "util/u_trace.h"
 #include "main/macros.h"
 
 #include <errno.h>
@@ -185,6 +186,7 @@ iris_init_batch(struct iris_batch *batch,
 
    util_dynarray_init(&batch->exec_fences, ralloc_context(NULL));
    util_dynarray_init(&batch->syncpts, ralloc_context(NULL));
+   util_dynarray_init(&batch->slab_bos, NULL);
 
    batch->exec_count = 0;
    batch->exec_array_size = 100;
@@ -239,6 +241,49 @@ find_validation_entry(struct iris_batch *batch, struct iris_bo *bo)
    return NULL;
 }
 
+static bool
+find_slab_bo(struct iris_batch *batch, struct iris_bo *bo)
+{
+   struct iris_bo **slab_bos = util_dynarray_begin(&batch->slab_bos);
+   unsigned count =
+      util_dynarray_num_elements(&batch->slab_bos, struct iris_bo *);
+   unsigned index = READ_ONCE(bo->index);
+
+   if (index < count && slab_bos[index] == bo)
+      return true;
+
+   for (index = 0; index < count; index++) {
+      if (slab_bos[index] == bo)
+         return true;
+   }
+
+   return false;
+}
+
+/**
+ * Remember a suballocated BO used by the batch, so that we can track when
+ * the GPU is done with it.
+ *
+ * Unlike the validation list, this may end up with duplicates if the BO is
+ * used by several batches at once.  That's harmless, so we only check the
+ * index hint rather than walking the whole list.
+ */
+static void
+add_slab_bo(struct iris_batch *batch, struct iris_bo *bo)
+{
+   struct iris_bo **slab_bos = util_dynarray_begin(&batch->slab_bos);
+   unsigned count =
+      util_dynarray_num_elements(&batch->slab_bos, struct iris_bo *);
+   unsigned index = READ_ONCE(bo->index);
+
+   if (index < count && slab_bos[index] == bo)
+      return;
+
+   iris_bo_reference(bo);
+   util_dynarray_append(&batch->slab_bos, struct iris_bo *, bo);
+   bo->index = count;
+}
+
 /**
  * Add a buffer to the current batch's validation list.
  *
@@ -252,6 +297,12 @@ iris_use_pinned_bo(struct iris_batch *batch,
 {
    assert(bo->kflags & EXEC_OBJECT_PINNED);
 
+   /* Suballocated buffers are validated through their slab BO. */
+   if (bo->real) {
+      add_slab_bo(batch, bo);
+      bo = bo->real;
+   }
+
    /* Never mark the workaround BO with EXEC_OBJECT_WRITE.  We don't care
     * about the order of any writes to that buffer, and marking it writable
     * would introduce data dependencies between multiple batches which share
@@ -375,12 +426,22 @@ iris_batch_free(struct iris_batch *batch)
    free(batch->exec_bos);
    free(batch->validation_list);
 
+   util_dynarray_foreach(&batch->slab_bos, struct iris_bo *, bo)
+      iris_bo_unreference(*bo);
+   util_dynarray_fini(&batch->slab_bos);
+
    ralloc_free(batch->exec_fences.mem_ctx);
 
    util_dynarray_foreach(&batch->syncpts, struct iris_syncpt *, s)
       iris_syncpt_reference(screen, s, NULL);
    ralloc_free(batch->syncpts.mem_ctx);
 
+   /* Suballocated BOs remember which hardware context their batches ran
+    * on, and the kernel may hand out our context ID again once we destroy
+    * it.  Make sure our last batch is done, so a later batch with the same
+    * ID can safely supersede it.
+    */
+   iris_wait_syncpt(&screen->base, batch->last_syncpt, INT64_MAX);
    iris_syncpt_reference(screen, &batch->last_syncpt, NULL);
 
    iris_bo_unreference(batch->bo);
@@ -503,6 +564,19 @@ submit_batch(struct iris_batch *batch)
       DBG("execbuf succeeded\n");
    }
 
+   /* Record our batch in the suballocated BOs before the validation list
+    * drops its reference on it.
+    */
+   util_dynarray_foreach(&batch->slab_bos, struct iris_bo *, bo_ptr) {
+      struct iris_bo *bo = *bo_ptr;
+
+      iris_bo_add_slab_user(bo, batch->exec_bos[0], batch->hw_ctx_id);
+      bo->index = -1;
+
+      iris_bo_unreference(bo);
+   }
+   util_dynarray_clear(&batch->slab_bos);
+
    for (int i = 0; i < batch->exec_count; i++) {
       struct iris_bo *bo = batch->exec_bos[i];
 
@@ -543,6 +617,8 @@ _iris_batch_flush(struct iris_batch *batch, const char *file, int line)
    if (iris_batch_bytes_used(batch) == 0)
       return;
 
+   MESA_TRACE_FUNC();
+
    iris_finish_batch(batch);
 
    if (unlikely(INTEL_DEBUG & (DEBUG_BATCH | DEBUG_SUBMIT))) {
@@ -611,5 +687,8 @@ _iris_batch_flush(struct iris_batch *batch, const char *file, int line)
 bool
 iris_batch_references(struct iris_batch *batch, struct iris_bo *bo)
 {
+   if (bo->real)
+      return find_slab_bo(batch, bo);
+
    return find_validation_entry(batch, bo) != NULL;
 }
@@ -83,6 +83,13 @@ struct iris_batch {
    int exec_count;
    int exec_array_size;
 
+   /**
+    * Suballocated BOs used by this batch (see iris_bo::real).  Only their
+    * slab BOs are in the validation list; this list holds a reference on
+    * them until submission, when we record that the batch is using them.
+    */
+   struct util_dynarray slab_bos;
+
    /**
     * A list of iris_syncpts associated with this batch.
     *
@@ -45,10 +45,21 @@
  *
  * This does mean that we have to emit STATE_BASE_ADDRESS and stall when
  * we run out of space in the binder, which hopefully won't happen too often.
+ *
+ * Binding tables only contain offsets from the binder's base address, so
+ * any table with the right contents will do.  We keep the tables uploaded
+ * to the current binder in a set hashed by their contents, and point
+ * draws with the same bindings back at the existing table rather than
+ * writing a new copy.  This saves binder space (and so STATE_BASE_ADDRESS
+ * stalls) as well as bytes written when apps switch between a few sets of
+ * bindings.
  */
 
 #include <stdlib.h>
 #include "util/u_math.h"
+#include "util/hash_table.h"
+#include "util/ralloc.h"
+#include "util/set.h"
 #include "iris_binder.h"
 #include "iris_bufmgr.h"
 #include "iris_context.h"
@@ -58,6 +69,28 @@
 /* Avoid using offset 0, tools consider it NULL */
 #define INIT_INSERT_POINT BTP_ALIGNMENT
 
+/** A binding table in the binder, see iris_binder::bt_cache */
+struct iris_binding_table {
+   const uint32_t *entries;
+   unsigned size;
+   uint32_t offset;
+};
+
+static uint32_t
+binding_table_hash(const void *key)
+{
+   const struct iris_binding_table *bt = key;
+   return _mesa_hash_data(bt->entries, bt->size);
+}
+
+static bool
+binding_table_equals(const void *a, const void *b)
+{
+   const struct iris_binding_table *bt_a = a, *bt_b = b;
+   return bt_a->size == bt_b->size &&
+          memcmp(bt_a->entries, bt_b->entries, bt_a->size) == 0;
+}
+
 static bool
 binder_has_space(struct iris_binder *binder, unsigned size)
 {
@@ -91,6 +124,11 @@ binder_realloc(struct iris_context *ice)
    binder->map = iris_bo_map(NULL, binder->bo, MAP_WRITE);
    binder->insert_point = INIT_INSERT_POINT;
 
+   /* The cached tables live in the old binder. */
+   _mesa_set_destroy(binder->bt_cache, NULL);
+   binder->bt_cache = _mesa_set_create(NULL, binding_table_hash,
+                                       binding_table_equals);
+
    /* Allocating a new binder requires changing Surface State Base Address,
     * which also invalidates all our previous binding tables - each entry
     * in those tables is an offset from the old base.
@@ -128,10 +166,13 @@ iris_binder_reserve(struct iris_context *ice,
 }
 
 /**
- * Reserve and record binder space for 3D pipeline shader stages.
+ * Make sure the binder has space for the binding tables of all 3D pipeline
+ * shader stages whose bindings are dirty.
  *
- * Note that you must actually populate the new binding tables after
- * calling this command - the new area is uninitialized.
+ * This must happen before emitting any state for the draw, as running out
+ * of space means moving to a new binder, and Surface State Base Address
+ * along with it.  The tables themselves are uploaded with
+ * iris_binder_upload_bt() while emitting the draw's state.
  */
 void
 iris_binder_reserve_3d(struct iris_context *ice)
@@ -157,7 +198,7 @@ iris_binder_reserve_3d(struct iris_context *ice)
       sizes[stage] = align(prog_data->binding_table.size_bytes, BTP_ALIGNMENT);
    }
 
-   /* Make space for the new binding tables...this may take two tries. */
+   /* Check for space for the new binding tables...this may take two tries. */
    while (true) {
       total_size = 0;
       for (int stage = 0; stage <= MESA_SHADER_FRAGMENT; stage++) {
@@ -179,16 +220,6 @@ iris_binder_reserve_3d(struct iris_context *ice)
        */
       binder_realloc(ice);
    }
-
-   /* Assign space and record the new binding table offsets. */
-   uint32_t offset = binder_insert(binder, total_size);
-
-   for (int stage = 0; stage <= MESA_SHADER_FRAGMENT; stage++) {
-      if (ice->state.dirty & (IRIS_DIRTY_BINDINGS_VS << stage)) {
-         binder->bt_offset[stage] = sizes[stage] > 0 ? offset : 0;
-         offset += sizes[stage];
-      }
-   }
 }
 
 void
@@ -203,10 +234,56 @@ iris_binder_reserve_compute(struct iris_context *ice)
 
    unsigned size = prog_data->binding_table.size_bytes;
 
-   if (size == 0)
+   if (!binder_has_space(binder, size))
+      binder_realloc(ice);
+}
+
+/**
+ * Upload the binding table for a shader stage and record its offset,
+ * reusing an identical table already in the binder if there is one.
+ *
+ * The binder must have space for the table, see iris_binder_reserve_3d()
+ * and iris_binder_reserve_compute().
+ */
+void
+iris_binder_upload_bt(struct iris_context *ice, gl_shader_stage stage,
+                      const uint32_t *bt, unsigned size)
+{
+   struct iris_binder *binder = &ice->state.binder;
+
+   if (size == 0) {
+      binder->bt_offset[stage] = 0;
+      return;
+   }
+
+   struct iris_binding_table key = { .entries = bt, .size = size };
+   uint32_t hash = binding_table_hash(&key);
+
+   struct set_entry *entry =
+      _mesa_set_search_pre_hashed(binder->bt_cache, hash, &key);
+
+   if (entry) {
+      const struct iris_binding_table *cached = entry->key;
+      binder->bt_offset[stage] = cached->offset;
       return;
+   }
+
+   assert(binder_has_space(binder, size));
+
+   uint32_t offset = binder_insert(binder, size);
+   memcpy(binder->map + offset, bt, size);
+
+   struct iris_binding_table *cached =
+      ralloc(binder->bt_cache, struct iris_binding_table);
+   uint32_t *entries = ralloc_size(cached, size);
+   memcpy(entries, bt, size);
+
+   cached->entries = entries;
+   cached->size = size;
+   cached->offset = offset;
+   _mesa_set_add_pre_hashed(binder->bt_cache, hash, cached);
 
-   binder->bt_offset[MESA_SHADER_COMPUTE] = iris_binder_reserve(ice, size);
+   binder->bt_offset[stage] = offset;
 }
 
 void
@@ -219,5 +296,6 @@ iris_init_binder(struct iris_context *ice)
 void
 iris_destroy_binder(struct iris_binder *binder)
 {
+   _mesa_set_destroy(binder->bt_cache, NULL);
    iris_bo_unreference(binder->bo);
 }
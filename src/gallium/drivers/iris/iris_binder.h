@@ -33,6 +33,13 @@ struct iris_batch;
 struct iris_bufmgr;
 struct iris_compiled_shader;
 struct iris_context;
+struct set;
+
+/**
+ * The largest binding table we may need to build, in entries.  This is the
+ * maximum the hardware's BindingTableEntryCount fields can describe.
+ */
+#define IRIS_MAX_BINDING_TABLE_ENTRIES 256
 
 struct iris_binder
 {
@@ -47,6 +54,12 @@ struct iris_binder
     * Zero is considered invalid and means there's no binding table.
     */
    uint32_t bt_offset[MESA_SHADER_STAGES];
+
+   /**
+    * The binding tables uploaded to this binder, hashed by their contents,
+    * so that draws with identical bindings can share a table.
+    */
+   struct set *bt_cache;
 };
 
 void iris_init_binder(struct iris_context *ice);
@@ -54,5 +67,7 @@ void iris_destroy_binder(struct iris_binder *binder);
 uint32_t iris_binder_reserve(struct iris_context *ice, unsigned size);
 void iris_binder_reserve_3d(struct iris_context *ice);
 void iris_binder_reserve_compute(struct iris_context *ice);
+void iris_binder_upload_bt(struct iris_context *ice, gl_shader_stage stage,
+                           const uint32_t *bt, unsigned size);
 
 #endif
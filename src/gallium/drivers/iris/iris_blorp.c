@@ -364,6 +364,7 @@ genX(init_blorp)(struct iris_context *ice)
 
    blorp_init(&ice->blorp, ice, &screen->isl_dev);
    ice->blorp.compiler = screen->compiler;
+   ice->blorp.disk_cache = screen->disk_cache;
    ice->blorp.lookup_shader = iris_blorp_lookup_shader;
    ice->blorp.upload_shader = iris_blorp_upload_shader;
    ice->blorp.exec = iris_blorp_exec;
@@ -155,10 +155,21 @@ struct iris_bufmgr {
 
    struct util_vma_heap vma_allocator[IRIS_MEMZONE_COUNT];
 
+   /** Suballocator for small buffers, see iris_bo_alloc_suballoc() */
+   struct pb_slabs slabs;
+
    bool has_llc:1;
    bool bo_reuse:1;
 };
 
+/**
+ * Buffers of up to 16KB are suballocated from 128KB slabs, in power of two
+ * sized entries of at least 256B.
+ */
+#define IRIS_SLAB_MIN_ORDER 8
+#define IRIS_SLAB_MAX_ORDER 14
+#define IRIS_SLAB_SIZE (128 * 1024)
+
 static int bo_set_tiling_internal(struct iris_bo *bo, uint32_t tiling_mode,
                                   uint32_t stride);
 
@@ -308,10 +319,52 @@ vma_free(struct iris_bufmgr *bufmgr,
    util_vma_heap_free(&bufmgr->vma_allocator[memzone], address, size);
 }
 
+/**
+ * Returns whether a batch using the suballocated BO may still be executing,
+ * and forgets about the batches which are known to be done.
+ *
+ * Must be called with bo->slab.lock held.
+ */
+static bool
+slab_bo_busy_locked(struct iris_bo *bo)
+{
+   if (bo->slab.overflow) {
+      if (iris_bo_busy(bo->real))
+         return true;
+
+      bo->slab.overflow = false;
+   }
+
+   unsigned num_users = 0;
+
+   for (unsigned i = 0; i < bo->slab.num_users; i++) {
+      struct iris_bo *batch_bo = bo->slab.users[i].batch_bo;
+
+      if (!batch_bo->idle && iris_bo_busy(batch_bo)) {
+         bo->slab.users[num_users++] = bo->slab.users[i];
+      } else {
+         iris_bo_unreference(batch_bo);
+      }
+   }
+
+   bo->slab.num_users = num_users;
+
+   return num_users > 0;
+}
+
 int
 iris_bo_busy(struct iris_bo *bo)
 {
    struct iris_bufmgr *bufmgr = bo->bufmgr;
+
+   if (bo->real) {
+      simple_mtx_lock(&bo->slab.lock);
+      bool busy = slab_bo_busy_locked(bo);
+      simple_mtx_unlock(&bo->slab.lock);
+
+      bo->idle = !busy;
+      return busy;
+   }
    struct drm_i915_gem_busy busy = { .handle = bo->gem_handle };
 
    int ret = drm_ioctl(bufmgr->fd, DRM_IOCTL_I915_GEM_BUSY, &busy);
@@ -552,6 +605,38 @@ iris_bo_alloc_tiled(struct iris_bufmgr *bufmgr, const char *name,
                             flags, tiling_mode, pitch);
 }
 
+struct iris_bo *
+iris_bo_alloc_suballoc(struct iris_bufmgr *bufmgr,
+                       const char *name,
+                       uint64_t size,
+                       enum iris_memory_zone memzone)
+{
+   if (memzone != IRIS_MEMZONE_OTHER ||
+       size > (1 << IRIS_SLAB_MAX_ORDER))
+      return iris_bo_alloc(bufmgr, name, size, memzone);
+
+   struct pb_slab_entry *entry =
+      pb_slab_alloc(&bufmgr->slabs, MAX2(size, 1), 0);
+   if (!entry)
+      return iris_bo_alloc(bufmgr, name, size, memzone);
+
+   struct iris_bo *bo = NULL;
+   bo = container_of(entry, bo, slab.entry);
+
+   /* pb_slab only hands out entries that can_reclaim_slab found idle. */
+   assert(bo->slab.num_users == 0 && !bo->slab.overflow);
+
+   bo->name = name;
+   bo->idle = true;
+   p_atomic_set(&bo->refcount, 1);
+
+   DBG("bo_create: buf %d (%s) suballocated at 0x%llx %llub\n",
+       bo->gem_handle, bo->name, (unsigned long long) bo->gtt_offset,
+       (unsigned long long) size);
+
+   return bo;
+}
+
 struct iris_bo *
 iris_bo_create_userptr(struct iris_bufmgr *bufmgr, const char *name,
                        void *ptr, size_t size,
@@ -785,6 +870,16 @@ iris_bo_unreference(struct iris_bo *bo)
 
    assert(p_atomic_read(&bo->refcount) > 0);
 
+   if (bo->real) {
+      /* Suballocated BOs never appear in the handle tables, so unlike
+       * below, nobody can revive them while we drop the last reference.
+       * The entry isn't reused until can_reclaim_slab says it's idle.
+       */
+      if (p_atomic_dec_zero(&bo->refcount))
+         pb_slab_free(&bo->bufmgr->slabs, &bo->slab.entry);
+      return;
+   }
+
    if (atomic_add_unless(&bo->refcount, -1, 1)) {
       struct iris_bufmgr *bufmgr = bo->bufmgr;
       struct timespec time;
@@ -1059,6 +1154,15 @@ void *
 iris_bo_map(struct pipe_debug_callback *dbg,
             struct iris_bo *bo, unsigned flags)
 {
+   if (bo->real) {
+      /* Only wait for our own part of the slab, not for our neighbours. */
+      if (!(flags & MAP_ASYNC))
+         bo_wait_with_stall_warning(dbg, bo, "slab mapping");
+
+      char *map = iris_bo_map(dbg, bo->real, flags | MAP_ASYNC);
+      return map ? map + (bo->gtt_offset - bo->real->gtt_offset) : NULL;
+   }
+
    if (bo->tiling_mode != I915_TILING_NONE && !(flags & MAP_RAW))
       return iris_bo_map_gtt(dbg, bo, flags);
 
@@ -1099,6 +1203,191 @@ iris_bo_wait_rendering(struct iris_bo *bo)
    iris_bo_wait(bo, -1);
 }
 
+/**
+ * Waits for the batches using a suballocated BO.
+ *
+ * The batch BOs are waited on with the lock dropped, so that the batches
+ * can keep submitting work using the buffer meanwhile.  Each wait gets the
+ * full timeout, so the total wait may take longer than timeout_ns.
+ */
+static int
+slab_bo_wait(struct iris_bo *bo, int64_t timeout_ns)
+{
+   struct iris_bo *wait_bos[IRIS_SLAB_MAX_USERS + 1];
+   unsigned count = 0;
+
+   simple_mtx_lock(&bo->slab.lock);
+
+   if (bo->slab.overflow)
+      wait_bos[count++] = bo->real;
+
+   for (unsigned i = 0; i < bo->slab.num_users; i++)
+      wait_bos[count++] = bo->slab.users[i].batch_bo;
+
+   for (unsigned i = 0; i < count; i++)
+      iris_bo_reference(wait_bos[i]);
+
+   simple_mtx_unlock(&bo->slab.lock);
+
+   int ret = 0;
+
+   for (unsigned i = 0; i < count; i++) {
+      if (ret == 0)
+         ret = iris_bo_wait(wait_bos[i], timeout_ns);
+
+      iris_bo_unreference(wait_bos[i]);
+   }
+
+   return ret;
+}
+
+/**
+ * Records that a batch using the suballocated BO has been submitted.
+ *
+ * \param batch_bo   a batch buffer of that execbuf, whose busy state tells
+ *                   whether the batch is done
+ * \param hw_ctx_id  the hardware context the batch was submitted on
+ */
+void
+iris_bo_add_slab_user(struct iris_bo *bo, struct iris_bo *batch_bo,
+                      uint32_t hw_ctx_id)
+{
+   assert(bo->real);
+
+   iris_bo_reference(batch_bo);
+
+   simple_mtx_lock(&bo->slab.lock);
+
+   struct iris_slab_user *user = NULL;
+
+   /* Batches on one hardware context complete in order, so the new batch
+    * supersedes any earlier one from the same context.
+    */
+   for (unsigned i = 0; i < bo->slab.num_users; i++) {
+      if (bo->slab.users[i].hw_ctx_id == hw_ctx_id) {
+         user = &bo->slab.users[i];
+         iris_bo_unreference(user->batch_bo);
+         break;
+      }
+   }
+
+   if (!user && bo->slab.num_users == IRIS_SLAB_MAX_USERS)
+      slab_bo_busy_locked(bo);
+
+   if (!user && bo->slab.num_users < IRIS_SLAB_MAX_USERS)
+      user = &bo->slab.users[bo->slab.num_users++];
+
+   if (user) {
+      user->batch_bo = batch_bo;
+      user->hw_ctx_id = hw_ctx_id;
+   } else {
+      /* The slab BO is in the validation list of every batch using us. */
+      bo->slab.overflow = true;
+      iris_bo_unreference(batch_bo);
+   }
+
+   bo->idle = false;
+
+   simple_mtx_unlock(&bo->slab.lock);
+}
+
+static bool
+can_reclaim_slab(void *priv, struct pb_slab_entry *entry)
+{
+   struct iris_bo *bo = NULL;
+   bo = container_of(entry, bo, slab.entry);
+
+   simple_mtx_lock(&bo->slab.lock);
+   bool busy = slab_bo_busy_locked(bo);
+   simple_mtx_unlock(&bo->slab.lock);
+
+   return !busy;
+}
+
+struct iris_slab {
+   struct pb_slab base;
+
+   /** The BO backing the slab */
+   struct iris_bo *bo;
+
+   /** The suballocated BOs, one per entry */
+   struct iris_bo *entries;
+};
+
+static struct pb_slab *
+iris_slab_alloc(void *priv, unsigned heap, unsigned entry_size,
+                unsigned group_index)
+{
+   struct iris_bufmgr *bufmgr = priv;
+   struct iris_slab *slab = calloc(1, sizeof(*slab));
+
+   if (!slab)
+      return NULL;
+
+   slab->bo = iris_bo_alloc(bufmgr, "slab", IRIS_SLAB_SIZE,
+                            IRIS_MEMZONE_OTHER);
+   if (!slab->bo)
+      goto fail;
+
+   slab->base.num_entries = slab->bo->size / entry_size;
+   slab->base.num_free = slab->base.num_entries;
+   slab->entries = calloc(slab->base.num_entries, sizeof(*slab->entries));
+   if (!slab->entries)
+      goto fail_bo;
+
+   list_inithead(&slab->base.free);
+
+   for (unsigned i = 0; i < slab->base.num_entries; i++) {
+      struct iris_bo *bo = &slab->entries[i];
+
+      bo->size = entry_size;
+      bo->bufmgr = bufmgr;
+      bo->gem_handle = slab->bo->gem_handle;
+      bo->gtt_offset = slab->bo->gtt_offset + i * entry_size;
+      bo->index = -1;
+      bo->idle = true;
+      bo->kflags = slab->bo->kflags;
+      bo->tiling_mode = I915_TILING_NONE;
+      bo->swizzle_mode = I915_BIT_6_SWIZZLE_NONE;
+      bo->cache_coherent = slab->bo->cache_coherent;
+      bo->hash = _mesa_hash_pointer(bo);
+      bo->real = slab->bo;
+
+      simple_mtx_init(&bo->slab.lock, mtx_plain);
+      bo->slab.entry.slab = &slab->base;
+      bo->slab.entry.group_index = group_index;
+      list_addtail(&bo->slab.entry.head, &slab->base.free);
+   }
+
+   return &slab->base;
+
+fail_bo:
+   iris_bo_unreference(slab->bo);
+fail:
+   free(slab);
+   return NULL;
+}
+
+static void
+iris_slab_free(void *priv, struct pb_slab *pslab)
+{
+   struct iris_slab *slab = (struct iris_slab *) pslab;
+
+   for (unsigned i = 0; i < slab->base.num_entries; i++) {
+      struct iris_bo *bo = &slab->entries[i];
+
+      /* Only pb_slabs_deinit frees slabs with entries that may be busy. */
+      for (unsigned u = 0; u < bo->slab.num_users; u++)
+         iris_bo_unreference(bo->slab.users[u].batch_bo);
+
+      simple_mtx_destroy(&bo->slab.lock);
+   }
+
+   free(slab->entries);
+   iris_bo_unreference(slab->bo);
+   free(slab);
+}
+
 /**
  * Waits on a BO for the given amount of time.
  *
@@ -1135,6 +1424,14 @@ iris_bo_wait(struct iris_bo *bo, int64_t timeout_ns)
    if (bo->idle && !bo->external)
       return 0;
 
+   if (bo->real) {
+      int ret = slab_bo_wait(bo, timeout_ns);
+      if (ret == 0)
+         bo->idle = true;
+
+      return ret;
+   }
+
    struct drm_i915_gem_wait wait = {
       .bo_handle = bo->gem_handle,
       .timeout_ns = timeout_ns,
@@ -1151,6 +1448,9 @@ iris_bo_wait(struct iris_bo *bo, int64_t timeout_ns)
 void
 iris_bufmgr_destroy(struct iris_bufmgr *bufmgr)
 {
+   /* This unreferences the slab BOs, so it needs the lock. */
+   pb_slabs_deinit(&bufmgr->slabs);
+
    mtx_destroy(&bufmgr->lock);
 
    /* Free any cached buffer objects we were going to reuse */
@@ -1314,6 +1614,10 @@ iris_bo_export_dmabuf(struct iris_bo *bo, int *prime_fd)
 {
    struct iris_bufmgr *bufmgr = bo->bufmgr;
 
+   /* The GEM handle belongs to the whole slab. */
+   if (bo->real)
+      return -EINVAL;
+
    iris_bo_make_external(bo);
 
    if (drmPrimeHandleToFD(bufmgr->fd, bo->gem_handle,
@@ -1328,6 +1632,8 @@ iris_bo_export_dmabuf(struct iris_bo *bo, int *prime_fd)
 uint32_t
 iris_bo_export_gem_handle(struct iris_bo *bo)
 {
+   assert(!bo->real);
+
    iris_bo_make_external(bo);
 
    return bo->gem_handle;
@@ -1338,6 +1644,9 @@ iris_bo_flink(struct iris_bo *bo, uint32_t *name)
 {
    struct iris_bufmgr *bufmgr = bo->bufmgr;
 
+   if (bo->real)
+      return -EINVAL;
+
    if (!bo->global_name) {
       struct drm_gem_flink flink = { .handle = bo->gem_handle };
 
@@ -1533,6 +1842,13 @@ iris_bufmgr_init(struct gen_device_info *devinfo, int fd)
 
    init_cache_buckets(bufmgr);
 
+   if (!pb_slabs_init(&bufmgr->slabs,
+                      IRIS_SLAB_MIN_ORDER, IRIS_SLAB_MAX_ORDER, 1, bufmgr,
+                      can_reclaim_slab, iris_slab_alloc, iris_slab_free)) {
+      free(bufmgr);
+      return NULL;
+   }
+
    bufmgr->name_table =
       _mesa_hash_table_create(NULL, key_hash_uint, key_uint_equal);
    bufmgr->handle_table =
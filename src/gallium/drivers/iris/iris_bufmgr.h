@@ -31,7 +31,9 @@
 #include "util/macros.h"
 #include "util/u_atomic.h"
 #include "util/list.h"
+#include "util/simple_mtx.h"
 #include "pipe/p_defines.h"
+#include "pipebuffer/pb_slab.h"
 
 struct gen_device_info;
 struct pipe_debug_callback;
@@ -88,6 +90,8 @@ enum iris_memory_zone {
 #define IRIS_BORDER_COLOR_POOL_ADDRESS IRIS_MEMZONE_DYNAMIC_START
 #define IRIS_BORDER_COLOR_POOL_SIZE (64 * 1024)
 
+#define IRIS_SLAB_MAX_USERS 4
+
 struct iris_bo {
    /**
     * Size in bytes of the buffer object.
@@ -188,6 +192,42 @@ struct iris_bo {
 
    /** Pre-computed hash using _mesa_hash_pointer for cache tracking sets */
    uint32_t hash;
+
+   /**
+    * For buffers suballocated from a slab, the BO backing the whole slab.
+    * NULL for buffers with a GEM object of their own.
+    *
+    * Suballocated buffers use the slab BO's GEM handle, and their
+    * gtt_offset points at their part of the slab.  The slab BO is what
+    * goes in the validation list, so the kernel's busy tracking only
+    * covers the slab as a whole; we track the batches using each
+    * suballocation ourselves, in \c slab.
+    */
+   struct iris_bo *real;
+
+   struct {
+      struct pb_slab_entry entry;
+
+      /** Protects users, num_users and overflow */
+      simple_mtx_t lock;
+
+      /**
+       * The last submitted batch using this buffer on each hardware
+       * context.  Batches on the same hardware context complete in order,
+       * so one entry per context is enough.
+       */
+      struct iris_slab_user {
+         struct iris_bo *batch_bo;
+         uint32_t hw_ctx_id;
+      } users[IRIS_SLAB_MAX_USERS];
+      unsigned num_users;
+
+      /**
+       * Set when more hardware contexts used the buffer than we have
+       * room for, in which case we fall back to the slab BO's busy state.
+       */
+      bool overflow;
+   } slab;
 };
 
 #define BO_ALLOC_ZEROED     (1<<0)
@@ -224,6 +264,19 @@ struct iris_bo *iris_bo_alloc_tiled(struct iris_bufmgr *bufmgr,
                                     uint32_t pitch,
                                     unsigned flags);
 
+/**
+ * Allocate a buffer object for a small buffer resource.
+ *
+ * Small enough requests are suballocated from a larger slab BO, saving a
+ * GEM object and a validation list entry per buffer.  Suballocated buffers
+ * share their GEM handle with the slab, so they can't be exported and
+ * must not be used as batch buffers.
+ */
+struct iris_bo *iris_bo_alloc_suballoc(struct iris_bufmgr *bufmgr,
+                                       const char *name,
+                                       uint64_t size,
+                                       enum iris_memory_zone memzone);
+
 struct iris_bo *
 iris_bo_create_userptr(struct iris_bufmgr *bufmgr, const char *name,
                        void *ptr, size_t size,
@@ -330,6 +383,9 @@ void iris_bufmgr_enable_reuse(struct iris_bufmgr *bufmgr);
 
 int iris_bo_wait(struct iris_bo *bo, int64_t timeout_ns);
 
+void iris_bo_add_slab_user(struct iris_bo *bo, struct iris_bo *batch_bo,
+                           uint32_t hw_ctx_id);
+
 uint32_t iris_create_hw_context(struct iris_bufmgr *bufmgr);
 
 #define IRIS_CONTEXT_LOW_PRIORITY    ((I915_CONTEXT_MIN_USER_PRIORITY-1)/2)
@@ -310,7 +310,7 @@ clear_color(struct iris_context *ice,
    }
 
    if (p_res->target == PIPE_BUFFER)
-      util_range_add(&res->valid_buffer_range, box->x, box->x + box->width);
+      util_range_add(&res->base.valid_buffer_range, box->x, box->x + box->width);
 
    iris_batch_maybe_flush(batch, 1500);
 
@@ -527,7 +527,7 @@ clear_depth_stencil(struct iris_context *ice,
 
    if (z_res) {
       iris_resource_prepare_depth(ice, batch, z_res, level, box->z, box->depth);
-      iris_blorp_surf_for_resource(&ice->vtbl, &z_surf, &z_res->base,
+      iris_blorp_surf_for_resource(&ice->vtbl, &z_surf, &z_res->base.b,
                                    z_res->aux.usage, level, true);
    }
 
@@ -536,7 +536,7 @@ clear_depth_stencil(struct iris_context *ice,
 
    if (stencil_res) {
       iris_blorp_surf_for_resource(&ice->vtbl, &stencil_surf,
-                                   &stencil_res->base, stencil_res->aux.usage,
+                                   &stencil_res->base.b, stencil_res->aux.usage,
                                    level, true);
    }
 
@@ -443,6 +443,15 @@ struct iris_context {
    /** Slab allocator for iris_transfer_map objects. */
    struct slab_child_pool transfer_pool;
 
+   /**
+    * Slab allocator for the unsynchronized maps u_threaded_context does on
+    * the application thread.
+    */
+   struct slab_child_pool transfer_pool_unsync;
+
+   /** The u_threaded_context wrapping this context, if any. */
+   struct threaded_context *thrctx;
+
    struct iris_vtable vtbl;
 
    struct blorp_context blorp;
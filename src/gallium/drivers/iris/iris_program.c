@@ -1485,6 +1485,22 @@ iris_create_uncompiled_shader(struct pipe_context *ctx,
    return ish;
 }
 
+/**
+ * Returns whether the create hooks should compile a guessed variant of the
+ * shader right away.
+ *
+ * With u_threaded_context the create hooks run on the application thread,
+ * while the program cache and its uploader are used by the driver thread,
+ * so the first draw using the shader compiles it there instead.
+ */
+static bool
+should_precompile(struct iris_context *ice)
+{
+   struct iris_screen *screen = (void *) ice->ctx.screen;
+
+   return screen->precompile && !ice->thrctx;
+}
+
 static struct iris_uncompiled_shader *
 iris_create_shader_state(struct pipe_context *ctx,
                          const struct pipe_shader_state *state)
@@ -1511,7 +1527,7 @@ iris_create_vs_state(struct pipe_context *ctx,
    if (ish->nir->info.clip_distance_array_size == 0)
       ish->nos |= (1ull << IRIS_NOS_RASTERIZER);
 
-   if (screen->precompile) {
+   if (should_precompile(ice)) {
       const struct gen_device_info *devinfo = &screen->devinfo;
       struct brw_vs_prog_key key = { KEY_INIT(devinfo->gen) };
 
@@ -1532,7 +1548,7 @@ iris_create_tcs_state(struct pipe_context *ctx,
 
    // XXX: NOS?
 
-   if (screen->precompile) {
+   if (should_precompile(ice)) {
       const unsigned _GL_TRIANGLES = 0x0004;
       const struct gen_device_info *devinfo = &screen->devinfo;
       struct brw_tcs_prog_key key = {
@@ -1562,7 +1578,7 @@ iris_create_tes_state(struct pipe_context *ctx,
 
    // XXX: NOS?
 
-   if (screen->precompile) {
+   if (should_precompile(ice)) {
       const struct gen_device_info *devinfo = &screen->devinfo;
       struct brw_tes_prog_key key = {
          KEY_INIT(devinfo->gen),
@@ -1587,7 +1603,7 @@ iris_create_gs_state(struct pipe_context *ctx,
 
    // XXX: NOS?
 
-   if (screen->precompile) {
+   if (should_precompile(ice)) {
       const struct gen_device_info *devinfo = &screen->devinfo;
       struct brw_gs_prog_key key = { KEY_INIT(devinfo->gen) };
 
@@ -1617,7 +1633,7 @@ iris_create_fs_state(struct pipe_context *ctx,
       ish->nos |= (1ull << IRIS_NOS_LAST_VUE_MAP);
    }
 
-   if (screen->precompile) {
+   if (should_precompile(ice)) {
       const uint64_t color_outputs = info->outputs_written &
          ~(BITFIELD64_BIT(FRAG_RESULT_DEPTH) |
            BITFIELD64_BIT(FRAG_RESULT_STENCIL) |
@@ -1654,7 +1670,7 @@ iris_create_compute_state(struct pipe_context *ctx,
 
    // XXX: disallow more than 64KB of shared variables
 
-   if (screen->precompile) {
+   if (should_precompile(ice)) {
       const struct gen_device_info *devinfo = &screen->devinfo;
       struct brw_cs_prog_key key = { KEY_INIT(devinfo->gen) };
 
@@ -100,6 +100,8 @@
 #define emit_lrr32 ice->vtbl.load_register_reg32
 
 struct iris_query {
+   struct threaded_query b;
+
    enum pipe_query_type type;
    int index;
 
@@ -875,7 +877,11 @@ iris_get_query_result(struct pipe_context *ctx,
    struct iris_bo *bo = iris_resource_bo(q->query_state_ref.res);
 
    if (!q->ready) {
-      if (iris_batch_references(&ice->batches[q->batch_idx], bo))
+      /* u_threaded_context calls this on the application thread once it
+       * has flushed the query, so the batch can't be touched then.
+       */
+      if (!q->b.flushed &&
+          iris_batch_references(&ice->batches[q->batch_idx], bo))
          iris_batch_flush(&ice->batches[q->batch_idx]);
 
       while (!READ_ONCE(q->map->snapshots_landed)) {
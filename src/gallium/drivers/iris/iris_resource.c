@@ -257,8 +257,7 @@ iris_resource_destroy(struct pipe_screen *screen,
 {
    struct iris_resource *res = (struct iris_resource *)resource;
 
-   if (resource->target == PIPE_BUFFER)
-      util_range_destroy(&res->valid_buffer_range);
+   threaded_resource_deinit(resource);
 
    iris_resource_disable_aux(res);
 
@@ -274,16 +273,14 @@ iris_alloc_resource(struct pipe_screen *pscreen,
    if (!res)
       return NULL;
 
-   res->base = *templ;
-   res->base.screen = pscreen;
-   pipe_reference_init(&res->base.reference, 1);
+   res->base.b = *templ;
+   res->base.b.screen = pscreen;
+   pipe_reference_init(&res->base.b.reference, 1);
+   threaded_resource_init(&res->base.b);
 
    res->aux.possible_usages = 1 << ISL_AUX_USAGE_NONE;
    res->aux.sampler_usages = 1 << ISL_AUX_USAGE_NONE;
 
-   if (templ->target == PIPE_BUFFER)
-      util_range_init(&res->valid_buffer_range);
-
    return res;
 }
 
@@ -537,13 +534,17 @@ iris_resource_create_for_buffer(struct pipe_screen *pscreen,
       name = "dynamic state";
    }
 
-   res->bo = iris_bo_alloc(screen->bufmgr, name, templ->width0, memzone);
+   if (templ->bind & PIPE_BIND_SHARED)
+      res->bo = iris_bo_alloc(screen->bufmgr, name, templ->width0, memzone);
+   else
+      res->bo = iris_bo_alloc_suballoc(screen->bufmgr, name, templ->width0,
+                                       memzone);
    if (!res->bo) {
-      iris_resource_destroy(pscreen, &res->base);
+      iris_resource_destroy(pscreen, &res->base.b);
       return NULL;
    }
 
-   return &res->base;
+   return &res->base.b;
 }
 
 static struct pipe_resource *
@@ -686,11 +687,11 @@ iris_resource_create_with_modifiers(struct pipe_screen *pscreen,
    if (!iris_resource_alloc_aux(screen, res))
       goto fail;
 
-   return &res->base;
+   return &res->base.b;
 
 fail:
    fprintf(stderr, "XXX: resource creation failed\n");
-   iris_resource_destroy(pscreen, &res->base);
+   iris_resource_destroy(pscreen, &res->base.b);
    return NULL;
 
 }
@@ -737,13 +738,14 @@ iris_resource_from_user_memory(struct pipe_screen *pscreen,
                                     user_memory, templ->width0,
                                     IRIS_MEMZONE_OTHER);
    if (!res->bo) {
-      free(res);
+      iris_resource_destroy(pscreen, &res->base.b);
       return NULL;
    }
 
-   util_range_add(&res->valid_buffer_range, 0, templ->width0);
+   res->base.is_user_ptr = true;
+   util_range_add(&res->base.valid_buffer_range, 0, templ->width0);
 
-   return &res->base;
+   return &res->base.b;
 }
 
 static struct pipe_resource *
@@ -777,7 +779,9 @@ iris_resource_from_handle(struct pipe_screen *pscreen,
       unreachable("invalid winsys handle type");
    }
    if (!res->bo)
-      return NULL;
+      goto fail;
+
+   res->base.is_shared = true;
 
    uint64_t modifier = whandle->modifier;
    if (modifier == DRM_FORMAT_MOD_INVALID) {
@@ -817,10 +821,10 @@ iris_resource_from_handle(struct pipe_screen *pscreen,
          goto fail;
    }
 
-   return &res->base;
+   return &res->base.b;
 
 fail:
-   iris_resource_destroy(pscreen, &res->base);
+   iris_resource_destroy(pscreen, &res->base.b);
    return NULL;
 }
 
@@ -848,6 +852,12 @@ iris_resource_get_handle(struct pipe_screen *pscreen,
 {
    struct iris_resource *res = (struct iris_resource *)resource;
 
+   /* Suballocated buffers share their GEM object with other buffers. */
+   if (res->bo->real)
+      return false;
+
+   res->base.is_shared = true;
+
    /* Disable aux usage if explicit flush not set and this is the
     * first time we are dealing with this resource.
     */
@@ -913,7 +923,7 @@ iris_invalidate_resource(struct pipe_context *ctx,
       /* The resource is idle, so just mark that it contains no data and
        * keep using the same underlying buffer object.
        */
-      util_range_set_empty(&res->valid_buffer_range);
+      util_range_set_empty(&res->base.valid_buffer_range);
       return;
    }
 
@@ -928,9 +938,15 @@ iris_invalidate_resource(struct pipe_context *ctx,
       return;
 
    struct iris_bo *old_bo = res->bo;
-   struct iris_bo *new_bo =
-      iris_bo_alloc(screen->bufmgr, res->bo->name, resource->width0,
-                    iris_memzone_for_address(old_bo->gtt_offset));
+   struct iris_bo *new_bo;
+
+   if (old_bo->real) {
+      new_bo = iris_bo_alloc_suballoc(screen->bufmgr, res->bo->name,
+                                      resource->width0, IRIS_MEMZONE_OTHER);
+   } else {
+      new_bo = iris_bo_alloc(screen->bufmgr, res->bo->name, resource->width0,
+                             iris_memzone_for_address(old_bo->gtt_offset));
+   }
    if (!new_bo)
       return;
 
@@ -942,7 +958,39 @@ iris_invalidate_resource(struct pipe_context *ctx,
     */
    ice->vtbl.rebind_buffer(ice, res, old_bo->gtt_offset);
 
-   util_range_set_empty(&res->valid_buffer_range);
+   util_range_set_empty(&res->base.valid_buffer_range);
+
+   iris_bo_unreference(old_bo);
+}
+
+/**
+ * The u_threaded_context replace_buffer_storage() callback.
+ *
+ * u_threaded_context invalidates buffers by creating a new resource on the
+ * application thread and queueing this, which moves the new storage into the
+ * original resource.
+ */
+void
+iris_replace_buffer_storage(struct pipe_context *ctx,
+                            struct pipe_resource *p_dst,
+                            struct pipe_resource *p_src)
+{
+   struct iris_context *ice = (void *) ctx;
+   struct iris_resource *dst = (void *) p_dst;
+   struct iris_resource *src = (void *) p_src;
+
+   assert(p_dst->target == PIPE_BUFFER && p_src->target == PIPE_BUFFER);
+
+   struct iris_bo *old_bo = dst->bo;
+
+   /* Swap out the backing storage */
+   iris_bo_reference(src->bo);
+   dst->bo = src->bo;
+
+   /* Rebind the buffer, replacing any state referring to the old BO's
+    * address, and marking state dirty so it's reemitted.
+    */
+   ice->vtbl.rebind_buffer(ice, dst, old_bo->gtt_offset);
 
    iris_bo_unreference(old_bo);
 }
@@ -988,7 +1036,7 @@ static void
 iris_map_copy_region(struct iris_transfer *map)
 {
    struct pipe_screen *pscreen = &map->batch->screen->base;
-   struct pipe_transfer *xfer = &map->base;
+   struct pipe_transfer *xfer = &map->base.b;
    struct pipe_box *box = &xfer->box;
    struct iris_resource *res = (void *) xfer->resource;
 
@@ -1127,7 +1175,7 @@ s8_offset(uint32_t stride, uint32_t x, uint32_t y, bool swizzled)
 static void
 iris_unmap_s8(struct iris_transfer *map)
 {
-   struct pipe_transfer *xfer = &map->base;
+   struct pipe_transfer *xfer = &map->base.b;
    const struct pipe_box *box = &xfer->box;
    struct iris_resource *res = (struct iris_resource *) xfer->resource;
    struct isl_surf *surf = &res->surf;
@@ -1161,7 +1209,7 @@ iris_unmap_s8(struct iris_transfer *map)
 static void
 iris_map_s8(struct iris_transfer *map)
 {
-   struct pipe_transfer *xfer = &map->base;
+   struct pipe_transfer *xfer = &map->base.b;
    const struct pipe_box *box = &xfer->box;
    struct iris_resource *res = (struct iris_resource *) xfer->resource;
    struct isl_surf *surf = &res->surf;
@@ -1236,7 +1284,7 @@ tile_extents(const struct isl_surf *surf,
 static void
 iris_unmap_tiled_memcpy(struct iris_transfer *map)
 {
-   struct pipe_transfer *xfer = &map->base;
+   struct pipe_transfer *xfer = &map->base.b;
    const struct pipe_box *box = &xfer->box;
    struct iris_resource *res = (struct iris_resource *) xfer->resource;
    struct isl_surf *surf = &res->surf;
@@ -1265,7 +1313,7 @@ iris_unmap_tiled_memcpy(struct iris_transfer *map)
 static void
 iris_map_tiled_memcpy(struct iris_transfer *map)
 {
-   struct pipe_transfer *xfer = &map->base;
+   struct pipe_transfer *xfer = &map->base.b;
    const struct pipe_box *box = &xfer->box;
    struct iris_resource *res = (struct iris_resource *) xfer->resource;
    struct isl_surf *surf = &res->surf;
@@ -1311,13 +1359,13 @@ iris_map_tiled_memcpy(struct iris_transfer *map)
 static void
 iris_map_direct(struct iris_transfer *map)
 {
-   struct pipe_transfer *xfer = &map->base;
+   struct pipe_transfer *xfer = &map->base.b;
    struct pipe_box *box = &xfer->box;
    struct iris_resource *res = (struct iris_resource *) xfer->resource;
 
    void *ptr = iris_bo_map(map->dbg, res->bo, xfer->usage & MAP_FLAGS);
 
-   if (res->base.target == PIPE_BUFFER) {
+   if (res->base.b.target == PIPE_BUFFER) {
       xfer->stride = 0;
       xfer->layer_stride = 0;
 
@@ -1347,9 +1395,9 @@ can_promote_to_async(const struct iris_resource *res,
     * initialized with useful data, then we can safely promote this write
     * to be unsynchronized.  This helps the common pattern of appending data.
     */
-   return res->base.target == PIPE_BUFFER && (usage & PIPE_TRANSFER_WRITE) &&
+   return res->base.b.target == PIPE_BUFFER && (usage & PIPE_TRANSFER_WRITE) &&
           !(usage & TC_TRANSFER_MAP_NO_INFER_UNSYNCHRONIZED) &&
-          !util_ranges_intersect(&res->valid_buffer_range, box->x,
+          !util_ranges_intersect(&res->base.valid_buffer_range, box->x,
                                  box->x + box->width);
 }
 
@@ -1400,8 +1448,14 @@ iris_transfer_map(struct pipe_context *ctx,
        (usage & PIPE_TRANSFER_MAP_DIRECTLY))
       return NULL;
 
-   struct iris_transfer *map = slab_alloc(&ice->transfer_pool);
-   struct pipe_transfer *xfer = &map->base;
+   /* Unsynchronized maps from u_threaded_context come from the application
+    * thread, so they can't use the pool the driver thread allocates from.
+    */
+   struct iris_transfer *map =
+      usage & TC_TRANSFER_MAP_THREADED_UNSYNC ?
+      slab_alloc(&ice->transfer_pool_unsync) :
+      slab_alloc(&ice->transfer_pool);
+   struct pipe_transfer *xfer = &map->base.b;
 
    if (!map)
       return NULL;
@@ -1416,7 +1470,7 @@ iris_transfer_map(struct pipe_context *ctx,
    *ptransfer = xfer;
 
    if (usage & PIPE_TRANSFER_WRITE)
-      util_range_add(&res->valid_buffer_range, box->x, box->x + box->width);
+      util_range_add(&res->base.valid_buffer_range, box->x, box->x + box->width);
 
    /* Avoid using GPU copies for persistent/coherent buffers, as the idea
     * there is to access them simultaneously on the CPU & GPU.  This also
@@ -1518,7 +1572,11 @@ iris_transfer_unmap(struct pipe_context *ctx, struct pipe_transfer *xfer)
       map->unmap(map);
 
    pipe_resource_reference(&xfer->resource, NULL);
-   slab_free(&ice->transfer_pool, map);
+
+   if (xfer->usage & TC_TRANSFER_MAP_THREADED_UNSYNC)
+      slab_free(&ice->transfer_pool_unsync, map);
+   else
+      slab_free(&ice->transfer_pool, map);
 }
 
 /**
@@ -1574,7 +1632,7 @@ iris_flush_and_dirty_for_history(struct iris_context *ice,
                                  struct iris_batch *batch,
                                  struct iris_resource *res)
 {
-   if (res->base.target != PIPE_BUFFER)
+   if (res->base.b.target != PIPE_BUFFER)
       return;
 
    uint32_t flush = iris_flush_bits_for_history(res);
@@ -26,6 +26,7 @@
 #include "pipe/p_state.h"
 #include "util/u_inlines.h"
 #include "util/u_range.h"
+#include "util/u_threaded_context.h"
 #include "intel/isl/isl.h"
 
 struct iris_batch;
@@ -53,7 +54,7 @@ enum gen9_astc5x5_wa_tex_type {
  * They contain the storage (BO) and layout information (ISL surface).
  */
 struct iris_resource {
-   struct pipe_resource base;
+   struct threaded_resource base;
    enum pipe_format internal_format;
 
    /**
@@ -74,16 +75,6 @@ struct iris_resource {
     */
    unsigned bind_history;
 
-   /**
-    * For PIPE_BUFFER resources, a range which may contain valid data.
-    *
-    * This is a conservative estimate of what part of the buffer contains
-    * valid data that we have to preserve.  The rest of the buffer is
-    * considered invalid, and we can promote writes to that region to
-    * be unsynchronized writes, avoiding blit copies.
-    */
-   struct util_range valid_buffer_range;
-
    /**
     * Auxiliary buffer information (CCS, MCS, or HiZ).
     */
@@ -185,6 +176,16 @@ struct iris_sampler_view {
 
    /** The resource (BO) holding our SURFACE_STATE. */
    struct iris_state_ref surface_state;
+
+   /**
+    * SURFACE_STATEs filled out by the create hook and not uploaded yet.
+    *
+    * With u_threaded_context the create hook runs on the application
+    * thread, where we can't use the context's uploaders, so the states
+    * are uploaded to surface_state on first use instead.
+    */
+   void *pending_surface_states;
+   unsigned pending_surface_states_size;
 };
 
 /**
@@ -210,13 +211,17 @@ struct iris_surface {
 
    /** The resource (BO) holding our SURFACE_STATE. */
    struct iris_state_ref surface_state;
+
+   /** See iris_sampler_view::pending_surface_states. */
+   void *pending_surface_states;
+   unsigned pending_surface_states_size;
 };
 
 /**
  * Transfer object - information about a buffer mapping.
  */
 struct iris_transfer {
-   struct pipe_transfer base;
+   struct threaded_transfer base;
    struct pipe_debug_callback *dbg;
    void *buffer;
    void *ptr;
@@ -258,6 +263,10 @@ iris_resource_get_clear_color(const struct iris_resource *res,
 
 void iris_init_screen_resource_functions(struct pipe_screen *pscreen);
 
+void iris_replace_buffer_storage(struct pipe_context *ctx,
+                                 struct pipe_resource *dst,
+                                 struct pipe_resource *src);
+
 void iris_dirty_for_history(struct iris_context *ice,
                             struct iris_resource *res);
 uint32_t iris_flush_bits_for_history(struct iris_resource *res);
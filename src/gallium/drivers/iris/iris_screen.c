@@ -38,6 +38,7 @@
 #include "pipe/p_context.h"
 #include "pipe/p_screen.h"
 #include "util/debug.h"
+#include "util/disk_cache.h"
 #include "util/u_inlines.h"
 #include "util/u_format.h"
 #include "util/u_transfer_helper.h"
@@ -476,6 +477,7 @@ iris_destroy_screen(struct pipe_screen *pscreen)
    iris_bo_unreference(screen->workaround_bo);
    u_transfer_helper_destroy(pscreen->transfer_helper);
    iris_bufmgr_destroy(screen->bufmgr);
+   disk_cache_destroy(screen->disk_cache);
    ralloc_free(screen);
 }
 
@@ -556,6 +558,32 @@ iris_shader_perf_log(void *data, const char *fmt, ...)
    va_end(args);
 }
 
+static void
+iris_disk_cache_init(struct iris_screen *screen)
+{
+#ifdef ENABLE_SHADER_CACHE
+   /* array length: print length + null char + 1 extra to verify it is unused */
+   char renderer[11];
+   MAYBE_UNUSED int len = snprintf(renderer, sizeof(renderer), "iris_%04x",
+                                   screen->pci_id);
+   assert(len == sizeof(renderer) - 2);
+
+   struct mesa_sha1 ctx;
+   unsigned char sha1[20];
+   char timestamp[41];
+
+   _mesa_sha1_init(&ctx);
+   if (!disk_cache_get_function_identifier(iris_disk_cache_init, &ctx))
+      return;
+   _mesa_sha1_final(&ctx, sha1);
+   _mesa_sha1_format(timestamp, sha1);
+
+   const uint64_t driver_flags =
+      brw_get_compiler_config_value(screen->compiler);
+   screen->disk_cache = disk_cache_create(renderer, timestamp, driver_flags);
+#endif
+}
+
 struct pipe_screen *
 iris_screen_create(int fd, const struct pipe_screen_config *config)
 {
@@ -601,6 +629,8 @@ iris_screen_create(int fd, const struct pipe_screen_config *config)
    screen->compiler->shader_perf_log = iris_shader_perf_log;
    screen->compiler->supports_pull_constants = false;
 
+   iris_disk_cache_init(screen);
+
    slab_create_parent(&screen->transfer_pool,
                       sizeof(struct iris_transfer), 64);
 
@@ -73,6 +73,9 @@ struct iris_screen {
    struct iris_bufmgr *bufmgr;
    struct brw_compiler *compiler;
 
+   /** On-disk cache for BLORP shaders, NULL if disabled */
+   struct disk_cache *disk_cache;
+
    /**
     * A buffer containing nothing useful, for hardware workarounds that
     * require scratch writes or reads from some unimportant memory.
@@ -1681,6 +1681,18 @@ fill_buffer_surface_state(struct isl_device *isl_dev,
 
 #define SURFACE_STATE_ALIGNMENT 64
 
+static void *
+alloc_surface_states_size(struct u_upload_mgr *mgr,
+                          struct iris_state_ref *ref,
+                          unsigned size)
+{
+   void *map = upload_state(mgr, ref, size, SURFACE_STATE_ALIGNMENT);
+
+   ref->offset += iris_bo_offset_from_base_address(iris_resource_bo(ref->res));
+
+   return map;
+}
+
 /**
  * Allocate several contiguous SURFACE_STATE structures, one for each
  * supported auxiliary surface mode.
@@ -1697,13 +1709,45 @@ alloc_surface_states(struct u_upload_mgr *mgr,
 
    assert(aux_usages != 0);
 
-   void *map =
-      upload_state(mgr, ref, util_bitcount(aux_usages) * surf_size,
-                   SURFACE_STATE_ALIGNMENT);
+   return alloc_surface_states_size(mgr, ref,
+                                    util_bitcount(aux_usages) * surf_size);
+}
 
-   ref->offset += iris_bo_offset_from_base_address(iris_resource_bo(ref->res));
+/**
+ * Allocate CPU memory for the SURFACE_STATEs of a view, which
+ * upload_pending_surface_states() moves to a state buffer later.
+ */
+static void *
+alloc_pending_surface_states(void **pending, unsigned *size,
+                             unsigned aux_usages)
+{
+   const unsigned surf_size = 4 * GENX(RENDER_SURFACE_STATE_length);
 
-   return map;
+   assert(aux_usages != 0);
+
+   *size = util_bitcount(aux_usages) * surf_size;
+   *pending = calloc(1, *size);
+
+   return *pending;
+}
+
+/**
+ * Upload the SURFACE_STATEs from alloc_pending_surface_states(), if they
+ * haven't been uploaded yet.
+ */
+static void
+upload_pending_surface_states(struct u_upload_mgr *mgr,
+                              struct iris_state_ref *ref,
+                              void **pending, unsigned size)
+{
+   if (!*pending)
+      return;
+
+   void *map = alloc_surface_states_size(mgr, ref, size);
+   memcpy(map, *pending, size);
+
+   free(*pending);
+   *pending = NULL;
 }
 
 static void
@@ -1746,7 +1790,6 @@ iris_create_sampler_view(struct pipe_context *ctx,
                          struct pipe_resource *tex,
                          const struct pipe_sampler_view *tmpl)
 {
-   struct iris_context *ice = (struct iris_context *) ctx;
    struct iris_screen *screen = (struct iris_screen *)ctx->screen;
    const struct gen_device_info *devinfo = &screen->devinfo;
    struct iris_sampler_view *isv = calloc(1, sizeof(struct iris_sampler_view));
@@ -1768,14 +1811,15 @@ iris_create_sampler_view(struct pipe_context *ctx,
 
       iris_get_depth_stencil_resources(tex, &zres, &sres);
 
-      tex = util_format_has_depth(desc) ? &zres->base : &sres->base;
+      tex = util_format_has_depth(desc) ? &zres->base.b : &sres->base.b;
    }
 
    isv->res = (struct iris_resource *) tex;
 
-   void *map = alloc_surface_states(ice->state.surface_uploader,
-                                    &isv->surface_state,
-                                    isv->res->aux.sampler_usages);
+   void *map =
+      alloc_pending_surface_states(&isv->pending_surface_states,
+                                   &isv->pending_surface_states_size,
+                                   isv->res->aux.sampler_usages);
    if (!unlikely(map))
       return NULL;
 
@@ -1838,6 +1882,7 @@ iris_sampler_view_destroy(struct pipe_context *ctx,
    struct iris_sampler_view *isv = (void *) state;
    pipe_resource_reference(&state->texture, NULL);
    pipe_resource_reference(&isv->surface_state.res, NULL);
+   free(isv->pending_surface_states);
    free(isv);
 }
 
@@ -1852,7 +1897,6 @@ iris_create_surface(struct pipe_context *ctx,
                     struct pipe_resource *tex,
                     const struct pipe_surface *tmpl)
 {
-   struct iris_context *ice = (struct iris_context *) ctx;
    struct iris_screen *screen = (struct iris_screen *)ctx->screen;
    const struct gen_device_info *devinfo = &screen->devinfo;
    struct iris_surface *surf = calloc(1, sizeof(struct iris_surface));
@@ -1913,9 +1957,10 @@ iris_create_surface(struct pipe_context *ctx,
       return psurf;
 
 
-   void *map = alloc_surface_states(ice->state.surface_uploader,
-                                    &surf->surface_state,
-                                    res->aux.possible_usages);
+   void *map =
+      alloc_pending_surface_states(&surf->pending_surface_states,
+                                   &surf->pending_surface_states_size,
+                                   res->aux.possible_usages);
    if (!unlikely(map))
       return NULL;
 
@@ -2081,7 +2126,7 @@ iris_set_shader_images(struct pipe_context *ctx,
 
          iv->base = *img;
          iv->base.resource = NULL;
-         pipe_resource_reference(&iv->base.resource, &res->base);
+         pipe_resource_reference(&iv->base.resource, &res->base.b);
 
          shs->bound_image_views |= 1 << (start_slot + i);
 
@@ -2107,7 +2152,7 @@ iris_set_shader_images(struct pipe_context *ctx,
                isl_fmt = isl_lower_storage_image_format(devinfo, isl_fmt);
          }
 
-         if (res->base.target != PIPE_BUFFER) {
+         if (res->base.b.target != PIPE_BUFFER) {
             struct isl_view view = {
                .format = isl_fmt,
                .base_level = img->u.tex.level,
@@ -2138,7 +2183,7 @@ iris_set_shader_images(struct pipe_context *ctx,
                                       &image_params[start_slot + i],
                                       &res->surf, &view);
          } else {
-            util_range_add(&res->valid_buffer_range, img->u.buf.offset,
+            util_range_add(&res->base.valid_buffer_range, img->u.buf.offset,
                            img->u.buf.offset + img->u.buf.size);
 
             fill_buffer_surface_state(&screen->isl_dev, res->bo, map,
@@ -2223,6 +2268,7 @@ iris_surface_destroy(struct pipe_context *ctx, struct pipe_surface *p_surf)
    struct iris_surface *surf = (void *) p_surf;
    pipe_resource_reference(&p_surf->texture, NULL);
    pipe_resource_reference(&surf->surface_state.res, NULL);
+   free(surf->pending_surface_states);
    free(surf);
 }
 
@@ -2748,7 +2794,7 @@ iris_set_shader_buffers(struct pipe_context *ctx,
          struct pipe_shader_buffer *ssbo = &shs->ssbo[start_slot + i];
          struct iris_state_ref *surf_state =
             &shs->ssbo_surf_state[start_slot + i];
-         pipe_resource_reference(&ssbo->buffer, &res->base);
+         pipe_resource_reference(&ssbo->buffer, &res->base.b);
          ssbo->buffer_offset = buffers[i].buffer_offset;
          ssbo->buffer_size =
             MIN2(buffers[i].buffer_size, res->bo->size - ssbo->buffer_offset);
@@ -2759,7 +2805,7 @@ iris_set_shader_buffers(struct pipe_context *ctx,
 
          res->bind_history |= PIPE_BIND_SHADER_BUFFER;
 
-         util_range_add(&res->valid_buffer_range, ssbo->buffer_offset,
+         util_range_add(&res->base.valid_buffer_range, ssbo->buffer_offset,
                         ssbo->buffer_offset + ssbo->buffer_size);
       } else {
          pipe_resource_reference(&shs->ssbo[start_slot + i].buffer, NULL);
@@ -2995,13 +3041,19 @@ iris_create_stream_output_target(struct pipe_context *ctx,
 
    res->bind_history |= PIPE_BIND_STREAM_OUTPUT;
 
+   /* iris_rebind_buffer() can't update streamout buffers yet, which is why
+    * iris_invalidate_resource() skips them.  Keep u_threaded_context from
+    * replacing their storage too.
+    */
+   res->base.is_shared = true;
+
    pipe_reference_init(&cso->base.reference, 1);
    pipe_resource_reference(&cso->base.buffer, p_res);
    cso->base.buffer_offset = buffer_offset;
    cso->base.buffer_size = buffer_size;
    cso->base.context = ctx;
 
-   util_range_add(&res->valid_buffer_range, buffer_offset,
+   util_range_add(&res->base.valid_buffer_range, buffer_offset,
                   buffer_offset + buffer_size);
 
    upload_state(ctx->stream_uploader, &cso->offset, sizeof(uint32_t), 4);
@@ -4020,6 +4072,11 @@ use_surface(struct iris_context *ice,
    struct iris_surface *surf = (void *) p_surf;
    struct iris_resource *res = (void *) p_surf->texture;
 
+   upload_pending_surface_states(ice->state.surface_uploader,
+                                 &surf->surface_state,
+                                 &surf->pending_surface_states,
+                                 surf->pending_surface_states_size);
+
    iris_use_pinned_bo(batch, iris_resource_bo(p_surf->texture), writeable);
    iris_use_pinned_bo(batch, iris_resource_bo(surf->surface_state.res), false);
 
@@ -4049,6 +4106,11 @@ use_sampler_view(struct iris_context *ice,
    enum isl_aux_usage aux_usage =
       iris_resource_texture_aux_usage(ice, isv->res, isv->view.format, 0);
 
+   upload_pending_surface_states(ice->state.surface_uploader,
+                                 &isv->surface_state,
+                                 &isv->pending_surface_states,
+                                 isv->pending_surface_states_size);
+
    iris_use_pinned_bo(batch, isv->res->bo, false);
    iris_use_pinned_bo(batch, iris_resource_bo(isv->surface_state.res), false);
 
@@ -4121,6 +4183,9 @@ use_image(struct iris_batch *batch, struct iris_context *ice,
  * This fills out the table of pointers to surfaces required by the shader,
  * and also adds those buffers to the validation list so the kernel can make
  * resident before running our batch.
+ *
+ * The table is built on the CPU and then handed to iris_binder_upload_bt(),
+ * which reuses an identical table from an earlier draw when it can.
  */
 static void
 iris_populate_binding_table(struct iris_context *ice,
@@ -4128,23 +4193,33 @@ iris_populate_binding_table(struct iris_context *ice,
                             gl_shader_stage stage,
                             bool pin_only)
 {
-   const struct iris_binder *binder = &ice->state.binder;
+   struct iris_binder *binder = &ice->state.binder;
    struct iris_compiled_shader *shader = ice->shaders.prog[stage];
-   if (!shader)
+   if (!shader) {
+      if (!pin_only)
+         binder->bt_offset[stage] = 0;
       return;
+   }
 
-   UNUSED struct brw_stage_prog_data *prog_data = shader->prog_data;
+   struct brw_stage_prog_data *prog_data = shader->prog_data;
    struct iris_shader_state *shs = &ice->state.shaders[stage];
    uint32_t binder_addr = binder->bo->gtt_offset;
 
-   //struct brw_stage_prog_data *prog_data = (void *) shader->prog_data;
-   uint32_t *bt_map = binder->map + binder->bt_offset[stage];
+   /* Entries past the ones we fill in (for YUV planes) are never used by
+    * the shader, but zero them so that they don't affect the cache lookup.
+    */
+   uint32_t bt_map[IRIS_MAX_BINDING_TABLE_ENTRIES];
+   assert(prog_data->binding_table.size_bytes <= sizeof(bt_map));
+   if (!pin_only)
+      memset(bt_map, 0, prog_data->binding_table.size_bytes);
    int s = 0;
 
    const struct shader_info *info = iris_get_shader_info(ice, stage);
    if (!info) {
       /* TCS passthrough doesn't need a binding table. */
       assert(stage == MESA_SHADER_TESS_CTRL);
+      if (!pin_only)
+         binder->bt_offset[stage] = 0;
       return;
    }
 
@@ -4224,6 +4299,11 @@ iris_populate_binding_table(struct iris_context *ice,
       bt_assert(plane_start[1], ...);
       bt_assert(plane_start[2], ...);
 #endif
+
+   if (!pin_only) {
+      iris_binder_upload_bt(ice, stage, bt_map,
+                            prog_data->binding_table.size_bytes);
+   }
 }
 
 static void
@@ -4709,18 +4789,19 @@ iris_upload_dirty_render_state(struct iris_context *ice,
       }
    }
 
+   /* Populating the binding tables assigns their binder offsets. */
    for (int stage = 0; stage <= MESA_SHADER_FRAGMENT; stage++) {
       if (dirty & (IRIS_DIRTY_BINDINGS_VS << stage)) {
-         iris_emit_cmd(batch, GENX(3DSTATE_BINDING_TABLE_POINTERS_VS), ptr) {
-            ptr._3DCommandSubOpcode = 38 + stage;
-            ptr.PointertoVSBindingTable = binder->bt_offset[stage];
-         }
+         iris_populate_binding_table(ice, batch, stage, false);
       }
    }
 
    for (int stage = 0; stage <= MESA_SHADER_FRAGMENT; stage++) {
       if (dirty & (IRIS_DIRTY_BINDINGS_VS << stage)) {
-         iris_populate_binding_table(ice, batch, stage, false);
+         iris_emit_cmd(batch, GENX(3DSTATE_BINDING_TABLE_POINTERS_VS), ptr) {
+            ptr._3DCommandSubOpcode = 38 + stage;
+            ptr.PointertoVSBindingTable = binder->bt_offset[stage];
+         }
       }
    }
 
@@ -5656,7 +5737,7 @@ iris_rebind_buffer(struct iris_context *ice,
    struct iris_screen *screen = (void *) ctx->screen;
    struct iris_genx_state *genx = ice->state.genx;
 
-   assert(res->base.target == PIPE_BUFFER);
+   assert(res->base.b.target == PIPE_BUFFER);
 
    /* Buffers can't be framebuffer attachments, nor display related,
     * and we don't have upstream Clover support.
@@ -5725,7 +5806,7 @@ iris_rebind_buffer(struct iris_context *ice,
 
             if (res->bo == iris_resource_bo(ssbo->buffer)) {
                struct pipe_shader_buffer buf = {
-                  .buffer = &res->base,
+                  .buffer = &res->base.b,
                   .buffer_offset = ssbo->buffer_offset,
                   .buffer_size = ssbo->buffer_size,
                };
@@ -5742,6 +5823,10 @@ iris_rebind_buffer(struct iris_context *ice,
             struct iris_sampler_view *isv = shs->textures[i];
 
             if (res->bo == iris_resource_bo(isv->base.texture)) {
+               /* The pending states have the old address. */
+               free(isv->pending_surface_states);
+               isv->pending_surface_states = NULL;
+
                void *map = alloc_surface_states(ice->state.surface_uploader,
                                                 &isv->surface_state,
                                                 isv->res->aux.sampler_usages);
@@ -359,6 +359,29 @@ static int gpir_glsl_type_size(enum glsl_base_type type)
    return 4;
 }
 
+static void gpir_print_shader_db(gpir_compiler *comp)
+{
+   int num_instr = 0, num_alu_slot = 0, num_reg = 0;
+
+   list_for_each_entry(gpir_block, block, &comp->block_list, list) {
+      list_for_each_entry(gpir_instr, instr, &block->instr_list, list) {
+         num_instr++;
+         for (int i = GPIR_INSTR_SLOT_ALU_BEGIN; i <= GPIR_INSTR_SLOT_ALU_END; i++) {
+            if (instr->slots[i])
+               num_alu_slot++;
+         }
+      }
+   }
+
+   list_for_each_entry(gpir_reg, reg, &comp->reg_list, list) {
+      if (reg->index + 1 > num_reg)
+         num_reg = reg->index + 1;
+   }
+
+   fprintf(stderr, "SHADER-DB: VS: %d instructions, %d ALU slots used, "
+           "%d physical regs\n", num_instr, num_alu_slot, num_reg);
+}
+
 bool gpir_compile_nir(struct lima_vs_shader_state *prog, struct nir_shader *nir)
 {
    nir_function_impl *func = nir_shader_get_entrypoint(nir);
@@ -409,6 +432,9 @@ bool gpir_compile_nir(struct lima_vs_shader_state *prog, struct nir_shader *nir)
       v->components += glsl_get_components(var->type);
    }
 
+   if (lima_debug & LIMA_DEBUG_SHADERDB)
+      gpir_print_shader_db(comp);
+
    ralloc_free(comp);
    return true;
 
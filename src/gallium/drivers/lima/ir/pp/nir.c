@@ -450,6 +450,29 @@ static ppir_compiler *ppir_compiler_create(void *prog, unsigned num_reg, unsigne
    return comp;
 }
 
+static void ppir_print_shader_db(ppir_compiler *comp)
+{
+   int num_instr = 0, num_slot = 0, num_spill = 0;
+
+   list_for_each_entry(ppir_block, block, &comp->block_list, list) {
+      list_for_each_entry(ppir_instr, instr, &block->instr_list, list) {
+         num_instr++;
+         for (int i = 0; i < PPIR_INSTR_SLOT_NUM; i++) {
+            if (instr->slots[i])
+               num_slot++;
+         }
+      }
+   }
+
+   list_for_each_entry(ppir_reg, reg, &comp->reg_list, list) {
+      if (reg->spilled)
+         num_spill++;
+   }
+
+   fprintf(stderr, "SHADER-DB: FS: %d instructions, %d slots used, "
+           "%d spills\n", num_instr, num_slot, num_spill);
+}
+
 bool ppir_compile_nir(struct lima_fs_shader_state *prog, struct nir_shader *nir,
                       struct ra_regs *ra)
 {
@@ -492,6 +515,9 @@ bool ppir_compile_nir(struct lima_fs_shader_state *prog, struct nir_shader *nir,
    if (!ppir_codegen_prog(comp))
       goto err_out0;
 
+   if (lima_debug & LIMA_DEBUG_SHADERDB)
+      ppir_print_shader_db(comp);
+
    ralloc_free(comp);
    return true;
 
@@ -286,6 +286,7 @@ typedef struct ppir_instr {
    float reg_pressure;
    int est; /* earliest start time */
    int parent_index;
+   int height; /* longest path to a root, for combining */
    bool scheduled;
 } ppir_instr;
 
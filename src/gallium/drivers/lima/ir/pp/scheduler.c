@@ -150,6 +150,122 @@ static void ppir_schedule_ready_list(ppir_block *block,
    ppir_schedule_ready_list(block, ready_list);
 }
 
+/* Height of an instr in the dependency graph: the longest path from it to a
+ * root. Two instrs with the same height can't depend on each other, and
+ * merging them doesn't change the height of any other instr.
+ */
+static int ppir_combine_calc_height(ppir_instr *instr)
+{
+   if (instr->height >= 0)
+      return instr->height;
+
+   int height = 0;
+   ppir_instr_foreach_succ(instr, dep) {
+      int h = ppir_combine_calc_height(dep->succ) + 1;
+      if (h > height)
+         height = h;
+   }
+
+   instr->height = height;
+   return height;
+}
+
+static bool ppir_combine_instr_uses_texld(ppir_instr *instr)
+{
+   return instr->slots[PPIR_INSTR_SLOT_VARYING] ||
+          instr->slots[PPIR_INSTR_SLOT_TEXLD];
+}
+
+/* Check whether the nodes of src fit into the free slots of dst */
+static bool ppir_combine_can_merge(ppir_instr *dst, ppir_instr *src)
+{
+   if (dst->is_end || src->is_end)
+      return false;
+
+   for (int i = 0; i < PPIR_INSTR_SLOT_NUM; i++) {
+      if (dst->slots[i] && src->slots[i])
+         return false;
+   }
+
+   /* the texture unit takes its coords from the varying unit */
+   if ((dst->slots[PPIR_INSTR_SLOT_TEXLD] && ppir_combine_instr_uses_texld(src)) ||
+       (src->slots[PPIR_INSTR_SLOT_TEXLD] && ppir_combine_instr_uses_texld(dst)))
+      return false;
+
+   /* srcs already refer to the const pipeline reg by index */
+   for (int i = 0; i < 2; i++) {
+      if (dst->constant[i].num && src->constant[i].num)
+         return false;
+   }
+
+   return true;
+}
+
+static void ppir_combine_merge(ppir_block *block, ppir_instr *dst, ppir_instr *src)
+{
+   ppir_debug("combine instr %d into %d\n", src->index, dst->index);
+
+   for (int i = 0; i < PPIR_INSTR_SLOT_NUM; i++) {
+      ppir_node *node = src->slots[i];
+      if (!node)
+         continue;
+
+      dst->slots[i] = node;
+      node->instr = dst;
+   }
+
+   for (int i = 0; i < 2; i++) {
+      if (src->constant[i].num)
+         dst->constant[i] = src->constant[i];
+   }
+
+   /* nodes without a slot (dups of const nodes) still point to src */
+   list_for_each_entry(ppir_node, node, &block->node_list, list) {
+      if (node->instr == src)
+         node->instr = dst;
+   }
+
+   ppir_instr_foreach_pred_safe(src, dep) {
+      ppir_instr_add_dep(dst, dep->pred);
+      list_del(&dep->pred_link);
+      list_del(&dep->succ_link);
+   }
+
+   ppir_instr_foreach_succ_safe(src, dep) {
+      ppir_instr_add_dep(dep->succ, dst);
+      list_del(&dep->pred_link);
+      list_del(&dep->succ_link);
+   }
+
+   list_del(&src->list);
+}
+
+/* node_to_instr only puts dependent nodes in the same instr, which leaves
+ * most VLIW slots empty. Pack independent instrs together so each
+ * instr does more work.
+ */
+static void ppir_combine_block(ppir_block *block)
+{
+   list_for_each_entry(ppir_instr, instr, &block->instr_list, list)
+      instr->height = -1;
+
+   list_for_each_entry(ppir_instr, instr, &block->instr_list, list)
+      ppir_combine_calc_height(instr);
+
+   list_for_each_entry(ppir_instr, instr, &block->instr_list, list) {
+      ppir_instr *next = LIST_ENTRY(ppir_instr, instr->list.next, list);
+
+      while (&next->list != &block->instr_list) {
+         ppir_instr *cand = next;
+         next = LIST_ENTRY(ppir_instr, next->list.next, list);
+
+         if (cand->height == instr->height &&
+             ppir_combine_can_merge(instr, cand))
+            ppir_combine_merge(block, instr, cand);
+      }
+   }
+}
+
 /* Register sensitive schedule algorithm from paper:
  * "Register-Sensitive Selection, Duplication, and Sequencing of Instructions"
  * Author: Vivek Sarkar,  Mauricio J. Serrano,  Barbara B. Simons
@@ -189,6 +305,11 @@ static void ppir_schedule_block(ppir_block *block)
 
 bool ppir_schedule_prog(ppir_compiler *comp)
 {
+   list_for_each_entry(ppir_block, block, &comp->block_list, list) {
+      ppir_combine_block(block);
+   }
+   ppir_instr_print_list(comp);
+
    list_for_each_entry(ppir_block, block, &comp->block_list, list) {
       ppir_schedule_block(block);
    }
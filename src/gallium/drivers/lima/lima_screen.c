@@ -55,7 +55,7 @@ lima_screen_destroy(struct pipe_screen *pscreen)
    slab_destroy_parent(&screen->transfer_pool);
 
    if (screen->ro)
-      free(screen->ro);
+      renderonly_destroy(screen->ro);
 
    if (screen->pp_buffer)
       lima_bo_free(screen->pp_buffer);
@@ -402,6 +402,8 @@ static const struct debug_named_value debug_options[] = {
           "print PP shader compiler result of each stage" },
         { "dump",     LIMA_DEBUG_DUMP,
           "dump GPU command stream to $PWD/lima.dump" },
+        { "shaderdb", LIMA_DEBUG_SHADERDB,
+          "print shader-db style stats of each compiled shader" },
         { NULL }
 };
 
@@ -34,11 +34,21 @@
 
 
 /**
- * Tile size (width and height). This needs to be a power of two.
+ * Default tile size (width and height). This needs to be a power of two.
+ * Resources are laid out with this alignment.
  */
 #define TILE_ORDER 6
 #define TILE_SIZE (1 << TILE_ORDER)
 
+/**
+ * Range of tile sizes a scene may pick from, depending on the framebuffer
+ * size and the number of rasterizer threads (see lp_setup.c).  Tiles must
+ * be at least 16x16 pixels, the size of the rasterizer's blocks.
+ */
+#define LP_MIN_TILE_ORDER 5
+#define LP_MAX_TILE_ORDER 7
+#define LP_MAX_TILE_SIZE (1 << LP_MAX_TILE_ORDER)
+
 
 /**
  * Max texture sizes
@@ -61,7 +71,20 @@
 #define LP_MAX_WIDTH  (1 << (LP_MAX_TEXTURE_LEVELS - 1))
 
 
-#define LP_MAX_THREADS 16
+/**
+ * Sanity limit on the number of rasterizer threads.  The actual number is
+ * determined at runtime from the number of CPUs (or LP_NUM_THREADS), and
+ * all the per-thread data is allocated accordingly.
+ */
+#define LP_MAX_THREADS 256
+
+
+/**
+ * Number of threads compiling the optimized fragment shader variants in the
+ * background.  These run at minimum priority so as not to compete with the
+ * rasterizer threads.
+ */
+#define LP_MAX_COMPILE_THREADS 2
 
 
 /**
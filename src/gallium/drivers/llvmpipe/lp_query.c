@@ -53,6 +53,8 @@ llvmpipe_create_query(struct pipe_context *pipe,
                       unsigned type,
                       unsigned index)
 {
+   struct llvmpipe_screen *screen = llvmpipe_screen(pipe->screen);
+   unsigned num_threads = MAX2(1, screen->num_threads);
    struct llvmpipe_query *pq;
 
    assert(type < PIPE_QUERY_TYPES);
@@ -61,6 +63,14 @@ llvmpipe_create_query(struct pipe_context *pipe,
 
    if (pq) {
       pq->type = type;
+
+      /* one start/end counter pair per rasterizer thread */
+      pq->start = CALLOC(2 * num_threads, sizeof(*pq->start));
+      if (!pq->start) {
+         FREE(pq);
+         return NULL;
+      }
+      pq->end = pq->start + num_threads;
    }
 
    return (struct pipe_query *) pq;
@@ -85,6 +95,7 @@ llvmpipe_destroy_query(struct pipe_context *pipe, struct pipe_query *q)
       lp_fence_reference(&pq->fence, NULL);
    }
 
+   FREE(pq->start);
    FREE(pq);
 }
 
@@ -190,19 +201,21 @@ static boolean
 llvmpipe_begin_query(struct pipe_context *pipe, struct pipe_query *q)
 {
    struct llvmpipe_context *llvmpipe = llvmpipe_context( pipe );
+   struct llvmpipe_screen *screen = llvmpipe_screen(pipe->screen);
+   unsigned num_threads = MAX2(1, screen->num_threads);
    struct llvmpipe_query *pq = llvmpipe_query(q);
 
-   /* Check if the query is already in the scene.  If so, we need to
-    * flush the scene now.  Real apps shouldn't re-use a query in a
-    * frame of rendering.
+   /* Check if the query is still in a scene.  If so, we need to flush
+    * the scene now and wait for the rasterizer to be done with it.
+    * Real apps shouldn't re-use a query in a frame of rendering.
     */
-   if (pq->fence && !lp_fence_issued(pq->fence)) {
+   if (pq->fence && !lp_fence_signalled(pq->fence)) {
       llvmpipe_finish(pipe, __FUNCTION__);
    }
 
 
-   memset(pq->start, 0, sizeof(pq->start));
-   memset(pq->end, 0, sizeof(pq->end));
+   memset(pq->start, 0, num_threads * sizeof(*pq->start));
+   memset(pq->end, 0, num_threads * sizeof(*pq->end));
    lp_setup_begin_query(llvmpipe->setup, pq);
 
    switch (pq->type) {
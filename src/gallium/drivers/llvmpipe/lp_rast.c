@@ -33,6 +33,7 @@
 #include "util/u_pack_color.h"
 #include "util/u_string.h"
 #include "util/u_thread.h"
+#include "util/u_cpu_detect.h"
 
 #include "util/os_time.h"
 
@@ -49,6 +50,10 @@
 #include "lp_scene.h"
 #include "lp_tex_sample.h"
 
+#if defined(PIPE_ARCH_SSE)
+#include <emmintrin.h>
+#endif
+
 
 #ifdef DEBUG
 int jit_line = 0;
@@ -74,12 +79,53 @@ lp_rast_begin( struct lp_rasterizer *rast,
 }
 
 
+/**
+ * Finish rasterizing the current scene and signal its fence.
+ * Called once per scene by one thread, after all threads are done with
+ * the scene.  The scene must not be touched after the fence is signalled,
+ * as setup may immediately start reusing it.
+ */
 static void
 lp_rast_end( struct lp_rasterizer *rast )
 {
-   lp_scene_end_rasterization( rast->curr_scene );
+   struct lp_scene *scene = rast->curr_scene;
+
+   lp_scene_end_rasterization( scene );
 
    rast->curr_scene = NULL;
+
+   if (scene->fence) {
+      lp_fence_signal(scene->fence);
+   }
+}
+
+
+/**
+ * Reset the coarse depth for a new tile.
+ */
+static void
+lp_rast_hiz_begin(struct lp_rasterizer_task *task)
+{
+   const struct pipe_surface *zsbuf = task->scene->fb.zsbuf;
+   struct lp_rast_hiz *hiz = &task->hiz;
+
+   hiz->valid = 0;
+   hiz->stale = 0;
+   hiz->enabled = FALSE;
+
+   if (zsbuf) {
+      const struct util_format_description *desc =
+         util_format_description(zsbuf->format);
+
+      if (util_format_has_depth(desc)) {
+         const struct util_format_channel_description *chan =
+            &desc->channel[desc->swizzle[0]];
+
+         hiz->enabled = TRUE;
+         hiz->ulp = chan->type == UTIL_FORMAT_TYPE_FLOAT ? 0.0f :
+                    (float)(1.0 / (double)((1ULL << chan->size) - 1));
+      }
+   }
 }
 
 
@@ -99,12 +145,10 @@ lp_rast_tile_begin(struct lp_rasterizer_task *task,
    LP_DBG(DEBUG_RAST, "%s %d,%d\n", __FUNCTION__, x, y);
 
    task->bin = bin;
-   task->x = x * TILE_SIZE;
-   task->y = y * TILE_SIZE;
-   task->width = TILE_SIZE + x * TILE_SIZE > task->scene->fb.width ?
-                    task->scene->fb.width - x * TILE_SIZE : TILE_SIZE;
-   task->height = TILE_SIZE + y * TILE_SIZE > task->scene->fb.height ?
-                    task->scene->fb.height - y * TILE_SIZE : TILE_SIZE;
+   task->x = x * scene->tile_size;
+   task->y = y * scene->tile_size;
+   task->width = MIN2(scene->tile_size, scene->fb.width - task->x);
+   task->height = MIN2(scene->tile_size, scene->fb.height - task->y);
 
    task->thread_data.vis_counter = 0;
    task->thread_data.ps_invocations = 0;
@@ -121,6 +165,61 @@ lp_rast_tile_begin(struct lp_rasterizer_task *task,
                          scene->zsbuf.stride * task->y +
                          scene->zsbuf.format_bytes * task->x;
    }
+
+   task->pending_clears = 0;
+
+   lp_rast_hiz_begin(task);
+}
+
+
+/**
+ * Fill a rectangle of all bound layers with a 4, 8 or 16 byte value using
+ * non-temporal stores, which don't pull the destination into the cache.
+ * Returns FALSE if the value size or alignment don't allow it.
+ */
+static boolean
+lp_rast_stream_fill(uint8_t *dst, unsigned stride, unsigned layer_stride,
+                    unsigned num_layers, unsigned width, unsigned height,
+                    unsigned bytes, const void *value)
+{
+#if defined(PIPE_ARCH_SSE)
+   const unsigned row_bytes = width * bytes;
+   unsigned layer, i, j;
+   __m128i v;
+
+   if ((bytes != 4 && bytes != 8 && bytes != 16) ||
+       (((uintptr_t)dst | stride | row_bytes) & 15) ||
+       (num_layers > 1 && (layer_stride & 15))) {
+      return FALSE;
+   }
+
+   switch (bytes) {
+   case 4:
+      v = _mm_set1_epi32(*(const int32_t *)value);
+      break;
+   case 8:
+      v = _mm_set1_epi64x(*(const int64_t *)value);
+      break;
+   default:
+      v = _mm_loadu_si128((const __m128i *)value);
+      break;
+   }
+
+   for (layer = 0; layer < num_layers; layer++) {
+      uint8_t *row = dst + layer * layer_stride;
+      for (i = 0; i < height; i++) {
+         for (j = 0; j < row_bytes; j += 16) {
+            _mm_stream_si128((__m128i *)(row + j), v);
+         }
+         row += stride;
+      }
+   }
+   _mm_sfence();
+
+   return TRUE;
+#else
+   return FALSE;
+#endif
 }
 
 
@@ -128,30 +227,58 @@ lp_rast_tile_begin(struct lp_rasterizer_task *task,
  * Clear the rasterizer's current color tile.
  * This is a bin command called during bin processing.
  * Clear commands always clear all bound layers.
+ *
+ * The clear is only recorded here, and written to the tile once something
+ * else touches it, or when the tile is done (see lp_rast_resolve_clears()).
+ * If the tile gets fully overwritten first, it's never written at all.
  */
 static void
 lp_rast_clear_color(struct lp_rasterizer_task *task,
                     const union lp_rast_cmd_arg arg)
 {
-   const struct lp_scene *scene = task->scene;
    unsigned cbuf = arg.clear_rb->cbuf;
-   union util_color uc;
-   enum pipe_format format;
 
    /* we never bin clear commands for non-existing buffers */
-   assert(cbuf < scene->fb.nr_cbufs);
-   assert(scene->fb.cbufs[cbuf]);
-
-   format = scene->fb.cbufs[cbuf]->format;
-   uc = arg.clear_rb->color_val;
+   assert(cbuf < task->scene->fb.nr_cbufs);
+   assert(task->scene->fb.cbufs[cbuf]);
 
    /*
     * this is pretty rough since we have target format (bunch of bytes...) here.
     * dump it as raw 4 dwords.
     */
    LP_DBG(DEBUG_RAST, "%s clear value (target format %d) raw 0x%x,0x%x,0x%x,0x%x\n",
-          __FUNCTION__, format, uc.ui[0], uc.ui[1], uc.ui[2], uc.ui[3]);
+          __FUNCTION__, task->scene->fb.cbufs[cbuf]->format,
+          arg.clear_rb->color_val.ui[0], arg.clear_rb->color_val.ui[1],
+          arg.clear_rb->color_val.ui[2], arg.clear_rb->color_val.ui[3]);
+
+   task->clear_color[cbuf] = arg.clear_rb->color_val;
+   task->pending_clears |= 1 << cbuf;
+
+   /* this will increase for each rb which probably doesn't mean much */
+   LP_COUNT(nr_color_tile_clear);
+}
+
 
+/**
+ * Write a pending color clear to the tile.
+ */
+static void
+lp_rast_fill_color(struct lp_rasterizer_task *task, unsigned cbuf,
+                   boolean stream)
+{
+   const struct lp_scene *scene = task->scene;
+   enum pipe_format format = scene->fb.cbufs[cbuf]->format;
+
+   if (stream &&
+       lp_rast_stream_fill(task->color_tiles[cbuf],
+                           scene->cbufs[cbuf].stride,
+                           scene->cbufs[cbuf].layer_stride,
+                           scene->fb_max_layer + 1,
+                           task->width, task->height,
+                           scene->cbufs[cbuf].format_bytes,
+                           &task->clear_color[cbuf])) {
+      return;
+   }
 
    util_fill_box(scene->cbufs[cbuf].map,
                  format,
@@ -163,10 +290,7 @@ lp_rast_clear_color(struct lp_rasterizer_task *task,
                  task->width,
                  task->height,
                  scene->fb_max_layer + 1,
-                 &uc);
-
-   /* this will increase for each rb which probably doesn't mean much */
-   LP_COUNT(nr_color_tile_clear);
+                 &task->clear_color[cbuf]);
 }
 
 
@@ -174,14 +298,47 @@ lp_rast_clear_color(struct lp_rasterizer_task *task,
  * Clear the rasterizer's current z/stencil tile.
  * This is a bin command called during bin processing.
  * Clear commands always clear all bound layers.
+ * Deferred just like color clears.
  */
 static void
 lp_rast_clear_zstencil(struct lp_rasterizer_task *task,
                        const union lp_rast_cmd_arg arg)
 {
-   const struct lp_scene *scene = task->scene;
    uint64_t clear_value64 = arg.clear_zstencil.value;
    uint64_t clear_mask64 = arg.clear_zstencil.mask;
+
+   LP_DBG(DEBUG_RAST, "%s: value=0x%08x, mask=0x%08x\n",
+           __FUNCTION__, (uint32_t) clear_value64, (uint32_t) clear_mask64);
+
+   task->hiz.valid = 0;
+
+   if (!task->scene->fb.zsbuf) {
+      return;
+   }
+
+   /* a depth only clear may be followed by a stencil only one etc. */
+   if (task->pending_clears & LP_RAST_PENDING_ZS) {
+      task->clear_zs_value = (task->clear_zs_value & ~clear_mask64) |
+                             (clear_value64 & clear_mask64);
+      task->clear_zs_mask |= clear_mask64;
+   }
+   else {
+      task->clear_zs_value = clear_value64 & clear_mask64;
+      task->clear_zs_mask = clear_mask64;
+   }
+   task->pending_clears |= LP_RAST_PENDING_ZS;
+}
+
+
+/**
+ * Write a pending z/stencil clear to the tile.
+ */
+static void
+lp_rast_fill_zstencil(struct lp_rasterizer_task *task, boolean stream)
+{
+   const struct lp_scene *scene = task->scene;
+   uint64_t clear_value64 = task->clear_zs_value;
+   uint64_t clear_mask64 = task->clear_zs_mask;
    uint32_t clear_value = (uint32_t) clear_value64;
    uint32_t clear_mask = (uint32_t) clear_mask64;
    const unsigned height = task->height;
@@ -191,9 +348,6 @@ lp_rast_clear_zstencil(struct lp_rasterizer_task *task,
    unsigned i, j;
    unsigned block_size;
 
-   LP_DBG(DEBUG_RAST, "%s: value=0x%08x, mask=0x%08x\n",
-           __FUNCTION__, clear_value, clear_mask);
-
    /*
     * Clear the area of the depth/depth buffer matching this tile.
     */
@@ -203,7 +357,18 @@ lp_rast_clear_zstencil(struct lp_rasterizer_task *task,
       uint8_t *dst_layer = task->depth_tile;
       block_size = util_format_get_blocksize(scene->fb.zsbuf->format);
 
-      clear_value &= clear_mask;
+      /* the X24 bits of Z32_FLOAT_S8X24_UINT are never part of the mask */
+      if (stream &&
+          clear_mask64 == (block_size == 8 ? 0xffffffffffULL :
+                           (1ULL << (block_size * 8)) - 1) &&
+          lp_rast_stream_fill(task->depth_tile, dst_stride,
+                              scene->zsbuf.layer_stride,
+                              scene->fb_max_layer + 1,
+                              width, height, block_size,
+                              block_size == 8 ? (const void *)&clear_value64 :
+                                                (const void *)&clear_value)) {
+         return;
+      }
 
       for (layer = 0; layer <= scene->fb_max_layer; layer++) {
          dst = dst_layer;
@@ -286,6 +451,54 @@ lp_rast_clear_zstencil(struct lp_rasterizer_task *task,
 
 
 
+/**
+ * Write the clears still pending for the tile.
+ * \param discard  bitmask of pending clears to drop rather than write, as
+ *                 the buffers are about to be fully overwritten
+ * \param stream  use non-temporal stores, as the tile is done
+ */
+static void
+lp_rast_resolve_clears(struct lp_rasterizer_task *task,
+                       unsigned discard, boolean stream)
+{
+   unsigned pending = task->pending_clears & ~discard;
+
+   if (!pending) {
+      task->pending_clears = 0;
+      return;
+   }
+
+   task->pending_clears = 0;
+
+   while (pending) {
+      unsigned i = u_bit_scan(&pending);
+
+      if (i == PIPE_MAX_COLOR_BUFS) {
+         lp_rast_fill_zstencil(task, stream);
+      }
+      else {
+         lp_rast_fill_color(task, i, stream);
+      }
+   }
+}
+
+
+/**
+ * Pending clears which a fully covered, opaque tile command makes
+ * pointless: it overwrites every pixel of the single color buffer.
+ * With layered rendering it only covers one of the layers cleared.
+ */
+static inline unsigned
+lp_rast_overwritten_clears(const struct lp_rasterizer_task *task,
+                           const struct lp_rast_shader_inputs *inputs)
+{
+   if (inputs->disable || task->scene->fb_max_layer != 0) {
+      return 0;
+   }
+   return 1 << 0;
+}
+
+
 /**
  * Run the shader on all blocks in a tile.  This is used when a tile is
  * completely contained inside a triangle.
@@ -316,7 +529,12 @@ lp_rast_shade_tile(struct lp_rasterizer_task *task,
    }
    variant = state->variant;
 
-   /* render the whole 64x64 tile in 4x4 chunks */
+   if (lp_rast_hiz_cull(task, inputs, tile_x, tile_y,
+                        task->width, task->height)) {
+      return;
+   }
+
+   /* render the whole tile in 4x4 chunks */
    for (y = 0; y < task->height; y += 4){
       for (x = 0; x < task->width; x += 4) {
          uint8_t *color[PIPE_MAX_COLOR_BUFS];
@@ -365,6 +583,9 @@ lp_rast_shade_tile(struct lp_rasterizer_task *task,
          END_JIT_CALL();
       }
    }
+
+   lp_rast_hiz_written(task, inputs, tile_x, tile_y,
+                       task->width, task->height);
 }
 
 
@@ -384,6 +605,78 @@ lp_rast_shade_tile_opaque(struct lp_rasterizer_task *task,
       return;
    }
 
+   lp_rast_resolve_clears(task, lp_rast_overwritten_clears(task, arg.shade_tile),
+                          FALSE);
+
+   lp_rast_shade_tile(task, arg);
+}
+
+
+/**
+ * Shade a tile fully covered by a blit shader's triangle.  When the
+ * texels map 1:1 onto the tile's pixels this is just a copy from the
+ * texture, which is much cheaper than running the shader.  Otherwise
+ * fall back to the shader.
+ * This is a bin command called during bin processing.
+ */
+static void
+lp_rast_blit_tile(struct lp_rasterizer_task *task,
+                  const union lp_rast_cmd_arg arg)
+{
+   const struct lp_scene *scene = task->scene;
+   const struct lp_rast_shader_inputs *inputs = arg.shade_tile;
+   const struct lp_rast_state *state = task->state;
+   const struct lp_jit_texture *texture;
+   unsigned slot;
+   float s, t;
+   int src_x, src_y;
+
+   LP_DBG(DEBUG_RAST, "%s\n", __FUNCTION__);
+
+   if (inputs->disable) {
+      /* This command was partially binned and has been disabled */
+      return;
+   }
+
+   assert(state);
+   if (!state) {
+      return;
+   }
+
+   lp_rast_resolve_clears(task, lp_rast_overwritten_clears(task, inputs),
+                          FALSE);
+
+   texture = &state->jit_context.textures[0];
+   slot = state->variant->shader->blit_input + 1;
+
+   if (inputs->layer == 0 && texture->first_level == 0) {
+      /* Texel coordinates of the center of the tile's first pixel */
+      s = (GET_A0(inputs)[slot][0] +
+           GET_DADX(inputs)[slot][0] * task->x +
+           GET_DADY(inputs)[slot][0] * task->y) * texture->width;
+      t = (GET_A0(inputs)[slot][1] +
+           GET_DADX(inputs)[slot][1] * task->x +
+           GET_DADY(inputs)[slot][1] * task->y) * texture->height;
+      src_x = (int)floorf(s);
+      src_y = (int)floorf(t);
+
+      /* Stay clear of texel edges, where the shader could round to the
+       * neighbouring texel, and of the texture borders, where wrapping
+       * would kick in.
+       */
+      if (s - src_x > 1.0f / 32 && s - src_x < 31.0f / 32 &&
+          t - src_y > 1.0f / 32 && t - src_y < 31.0f / 32 &&
+          src_x >= 0 && src_x + task->width <= texture->width &&
+          src_y >= 0 && src_y + task->height <= texture->height) {
+         util_copy_rect(task->color_tiles[0], scene->fb.cbufs[0]->format,
+                        scene->cbufs[0].stride, 0, 0,
+                        task->width, task->height,
+                        (const ubyte *)texture->base + texture->mip_offsets[0],
+                        texture->row_stride[0], src_x, src_y);
+         return;
+      }
+   }
+
    lp_rast_shade_tile(task, arg);
 }
 
@@ -412,8 +705,8 @@ lp_rast_shade_quads_mask(struct lp_rasterizer_task *task,
    assert(state);
 
    /* Sanity checks */
-   assert(x < scene->tiles_x * TILE_SIZE);
-   assert(y < scene->tiles_y * TILE_SIZE);
+   assert(x < scene->tiles_x * scene->tile_size);
+   assert(y < scene->tiles_y * scene->tile_size);
    assert(x % TILE_VECTOR_WIDTH == 0);
    assert(y % TILE_VECTOR_HEIGHT == 0);
 
@@ -445,7 +738,7 @@ lp_rast_shade_quads_mask(struct lp_rasterizer_task *task,
     * The rasterizer may produce fragments outside our
     * allocated 4x4 blocks hence need to filter them out here.
     */
-   if ((x % TILE_SIZE) < task->width && (y % TILE_SIZE) < task->height) {
+   if ((x - task->x) < task->width && (y - task->y) < task->height) {
       /* Propagate non-interpolated raster state. */
       task->thread_data.raster_state.viewport_index = inputs->viewport_index;
 
@@ -469,6 +762,151 @@ lp_rast_shade_quads_mask(struct lp_rasterizer_task *task,
 
 
 
+/**
+ * Compute the largest depth value of a HiZ chunk, as window z.
+ */
+static float
+lp_rast_hiz_chunk_zmax(const struct lp_rasterizer_task *task,
+                       unsigned chunk)
+{
+   const struct lp_scene *scene = task->scene;
+   const struct util_format_description *desc =
+      util_format_description(scene->fb.zsbuf->format);
+   const struct util_format_channel_description *chan =
+      &desc->channel[desc->swizzle[0]];
+   const unsigned px = (chunk % LP_HIZ_CHUNKS_X) * LP_HIZ_CHUNK_SIZE;
+   const unsigned py = (chunk / LP_HIZ_CHUNKS_X) * LP_HIZ_CHUNK_SIZE;
+   const unsigned width = MIN2(LP_HIZ_CHUNK_SIZE, task->width - px);
+   const unsigned height = MIN2(LP_HIZ_CHUNK_SIZE, task->height - py);
+   const unsigned bytes = scene->zsbuf.format_bytes;
+   const uint8_t *row = task->depth_tile + py * scene->zsbuf.stride +
+                        px * bytes;
+   unsigned i, j;
+
+   if (chan->type == UTIL_FORMAT_TYPE_FLOAT) {
+      /* Z32_FLOAT or Z32_FLOAT_S8X24_UINT, depth comes first */
+      float zmax = -FLT_MAX;
+
+      for (i = 0; i < height; i++) {
+         for (j = 0; j < width; j++) {
+            zmax = MAX2(zmax, *(const float *)(row + j * bytes));
+         }
+         row += scene->zsbuf.stride;
+      }
+      return zmax;
+   }
+   else {
+      const uint32_t mask = (uint32_t)((1ULL << chan->size) - 1);
+      uint32_t zmax = 0;
+
+      for (i = 0; i < height; i++) {
+         if (bytes == 2) {
+            const uint16_t *z = (const uint16_t *)row;
+            for (j = 0; j < width; j++) {
+               zmax = MAX2(zmax, z[j]);
+            }
+         }
+         else {
+            const uint32_t *z = (const uint32_t *)row;
+            for (j = 0; j < width; j++) {
+               zmax = MAX2(zmax, (z[j] >> chan->shift) & mask);
+            }
+         }
+         row += scene->zsbuf.stride;
+      }
+
+      /* round up, the division may well be inexact */
+      return (float)((double)zmax / (double)mask) * (1.0f + 1.0f / (1 << 22));
+   }
+}
+
+
+static void
+lp_rast_hiz_update(struct lp_rasterizer_task *task, unsigned chunk)
+{
+   const uint64_t bit = 1ULL << chunk;
+
+   task->hiz.zmax[chunk] = lp_rast_hiz_chunk_zmax(task, chunk);
+   task->hiz.valid |= bit;
+   task->hiz.stale &= ~bit;
+}
+
+
+/**
+ * Check whether the current triangle is behind the depth buffer in all of
+ * the HiZ chunks touched by a rectangle, so the shader needn't run there.
+ *
+ * Only done for LESS and LEQUAL depth tests without stencil, see
+ * lp_fragment_shader_variant::hiz.  The smallest depth of the triangle over
+ * the rectangle comes from its z plane, less some slack for the rounding in
+ * the shader's interpolation.
+ * \param x, y  position of the rectangle in window coords
+ */
+boolean
+lp_rast_hiz_cull(struct lp_rasterizer_task *task,
+                 const struct lp_rast_shader_inputs *inputs,
+                 unsigned x, unsigned y,
+                 unsigned width, unsigned height)
+{
+   const struct lp_fragment_shader_variant *variant = task->state->variant;
+   struct lp_rast_hiz *hiz = &task->hiz;
+   const float a0 = GET_A0(inputs)[0][2];
+   const float dzdx = GET_DADX(inputs)[0][2];
+   const float dzdy = GET_DADY(inputs)[0][2];
+   const float x0 = (float)x, x1 = (float)(x + width);
+   const float y0 = (float)y, y1 = (float)(y + height);
+   boolean less;
+   float zmin, slack;
+   uint64_t mask;
+
+   if (!variant->hiz || !hiz->enabled || inputs->layer) {
+      return FALSE;
+   }
+
+   less = variant->key.depth.func == PIPE_FUNC_LESS;
+
+   zmin = a0 + dzdx * (dzdx < 0.0f ? x1 : x0) + dzdy * (dzdy < 0.0f ? y1 : y0);
+   slack = (fabsf(a0) + fabsf(dzdx) * x1 + fabsf(dzdy) * y1) * (1.0f / (1 << 20));
+   zmin -= slack;
+
+   /*
+    * LESS fails wherever z >= zmax, LEQUAL needs z to be larger than zmax
+    * after conversion to the depth format.
+    */
+   if (variant->key.depth.func == PIPE_FUNC_LEQUAL) {
+      zmin -= hiz->ulp;
+   }
+
+   mask = lp_rast_hiz_chunk_mask(task, x, y, width, height);
+   while (mask) {
+      const unsigned chunk = u_bit_scan64(&mask);
+      const uint64_t bit = 1ULL << chunk;
+
+      if (!(hiz->valid & bit)) {
+         lp_rast_hiz_update(task, chunk);
+      }
+
+      if (!(less ? zmin >= hiz->zmax[chunk] : zmin > hiz->zmax[chunk])) {
+         if (!(hiz->stale & bit)) {
+            return FALSE;
+         }
+
+         /* the depth may have dropped since, recompute before giving up */
+         lp_rast_hiz_update(task, chunk);
+         if (!(less ? zmin >= hiz->zmax[chunk] : zmin > hiz->zmax[chunk])) {
+            return FALSE;
+         }
+      }
+   }
+
+   LP_COUNT_ADD(nr_hiz_culled_16,
+                util_bitcount64(lp_rast_hiz_chunk_mask(task, x, y,
+                                                       width, height)));
+   return TRUE;
+}
+
+
+
 /**
  * Begin a new occlusion query.
  * This is a bin command put in all bins.
@@ -551,6 +989,9 @@ lp_rast_tile_end(struct lp_rasterizer_task *task)
       lp_rast_end_query(task, lp_rast_arg_query(task->scene->active_queries[i]));
    }
 
+   /* clears nothing else touched, the tile won't be read back here */
+   lp_rast_resolve_clears(task, 0, TRUE);
+
    /* debug */
    memset(task->color_tiles, 0, sizeof(task->color_tiles));
    task->depth_tile = NULL;
@@ -588,10 +1029,34 @@ static lp_rast_cmd_func dispatch[LP_RAST_OP_MAX] =
    lp_rast_triangle_32_8,
    lp_rast_triangle_32_3_4,
    lp_rast_triangle_32_3_16,
-   lp_rast_triangle_32_4_16
+   lp_rast_triangle_32_4_16,
+   lp_rast_blit_tile
 };
 
 
+/**
+ * Whether the command reads or partially writes the tile, so that
+ * pending clears must be written first.  The opaque tile commands sort
+ * out pending clears themselves.
+ */
+static inline boolean
+lp_rast_cmd_needs_clears(unsigned cmd)
+{
+   switch (cmd) {
+   case LP_RAST_OP_CLEAR_COLOR:
+   case LP_RAST_OP_CLEAR_ZSTENCIL:
+   case LP_RAST_OP_BEGIN_QUERY:
+   case LP_RAST_OP_END_QUERY:
+   case LP_RAST_OP_SET_STATE:
+   case LP_RAST_OP_SHADE_TILE_OPAQUE:
+   case LP_RAST_OP_BLIT:
+      return FALSE;
+   default:
+      return TRUE;
+   }
+}
+
+
 static void
 do_rasterize_bin(struct lp_rasterizer_task *task,
                  const struct cmd_bin *bin,
@@ -601,10 +1066,14 @@ do_rasterize_bin(struct lp_rasterizer_task *task,
    unsigned k;
 
    if (0)
-      lp_debug_bin(bin, x, y);
+      lp_debug_bin(bin, x, y, task->scene->tile_size);
 
    for (block = bin->head; block; block = block->next) {
       for (k = 0; k < block->count; k++) {
+         if (task->pending_clears &&
+             lp_rast_cmd_needs_clears(block->cmd[k])) {
+            lp_rast_resolve_clears(task, 0, FALSE);
+         }
          dispatch[block->cmd[k]]( task, block->arg[k] );
       }
    }
@@ -704,10 +1173,6 @@ rasterize_scene(struct lp_rasterizer_task *task,
    }
 #endif
 
-   if (scene->fence) {
-      lp_fence_signal(scene->fence);
-   }
-
    task->scene = NULL;
 }
 
@@ -737,8 +1202,6 @@ lp_rast_queue_scene( struct lp_rasterizer *rast,
       lp_rast_end( rast );
 
       util_fpstate_set(fpstate);
-
-      rast->curr_scene = NULL;
    }
    else {
       /* threaded rendering! */
@@ -756,29 +1219,12 @@ lp_rast_queue_scene( struct lp_rasterizer *rast,
 }
 
 
-void
-lp_rast_finish( struct lp_rasterizer *rast )
-{
-   if (rast->num_threads == 0) {
-      /* nothing to do */
-   }
-   else {
-      int i;
-
-      /* wait for work to complete */
-      for (i = 0; i < rast->num_threads; i++) {
-         pipe_semaphore_wait(&rast->tasks[i].work_done);
-      }
-   }
-}
-
-
 /**
  * This is the thread's main entrypoint.
  * It's a simple loop:
  *   1. wait for work
  *   2. do work
- *   3. signal that we're done
+ *   3. signal the scene's fence when all threads are done
  */
 static int
 thread_function(void *init_data)
@@ -831,17 +1277,16 @@ thread_function(void *init_data)
       /* wait for all threads to finish with this scene */
       util_barrier_wait( &rast->barrier );
 
-      /* XXX: shouldn't be necessary:
+      /* thread[0]:
+       *  - unmap the framebuffer surfaces
+       *  - signal the scene's fence
        */
       if (task->thread_index == 0) {
          lp_rast_end( rast );
       }
 
-      /* signal done with work */
       if (debug)
          debug_printf("thread %d done working\n", task->thread_index);
-
-      pipe_semaphore_signal(&task->work_done);
    }
 
 #ifdef _WIN32
@@ -854,18 +1299,35 @@ thread_function(void *init_data)
 
 /**
  * Initialize semaphores and spawn the threads.
+ *
+ * On hosts with several L3 domains (multiple CCXs / sockets), the threads
+ * are spread evenly and pinned to them, so that each thread's private data
+ * (e.g. the texture cache, first touched by the thread itself) ends up in
+ * memory local to the cores running it.
  */
 static void
 create_rast_threads(struct lp_rasterizer *rast)
 {
+   unsigned cores_per_L3 = util_cpu_caps.cores_per_L3;
+   unsigned num_L3_caches = 0;
    unsigned i;
 
+   if (cores_per_L3 && cores_per_L3 < util_cpu_caps.nr_cpus &&
+       debug_get_bool_option("LP_PIN_THREADS", TRUE))
+      num_L3_caches = util_cpu_caps.nr_cpus / cores_per_L3;
+
    /* NOTE: if num_threads is zero, we won't use any threads */
    for (i = 0; i < rast->num_threads; i++) {
       pipe_semaphore_init(&rast->tasks[i].work_ready, 0);
       pipe_semaphore_init(&rast->tasks[i].work_done, 0);
       rast->threads[i] = u_thread_create(thread_function,
                                             (void *) &rast->tasks[i]);
+
+      if (num_L3_caches > 1) {
+         util_pin_thread_to_L3(rast->threads[i],
+                               i * num_L3_caches / rast->num_threads,
+                               cores_per_L3);
+      }
    }
 }
 
@@ -887,6 +1349,18 @@ lp_rast_create( unsigned num_threads )
       goto no_rast;
    }
 
+   rast->tasks = CALLOC(MAX2(1, num_threads), sizeof(*rast->tasks));
+   if (!rast->tasks) {
+      goto no_tasks;
+   }
+
+   if (num_threads > 0) {
+      rast->threads = CALLOC(num_threads, sizeof(*rast->threads));
+      if (!rast->threads) {
+         goto no_threads;
+      }
+   }
+
    rast->full_scenes = lp_scene_queue_create();
    if (!rast->full_scenes) {
       goto no_full_scenes;
@@ -919,7 +1393,7 @@ lp_rast_create( unsigned num_threads )
    return rast;
 
 no_thread_data_cache:
-   for (i = 0; i < MAX2(1, rast->num_threads); i++) {
+   for (i = 0; i < MAX2(1, num_threads); i++) {
       if (rast->tasks[i].thread_data.cache) {
          align_free(rast->tasks[i].thread_data.cache);
       }
@@ -927,6 +1401,10 @@ no_thread_data_cache:
 
    lp_scene_queue_destroy(rast->full_scenes);
 no_full_scenes:
+   FREE(rast->threads);
+no_threads:
+   FREE(rast->tasks);
+no_tasks:
    FREE(rast);
 no_rast:
    return NULL;
@@ -975,6 +1453,8 @@ void lp_rast_destroy( struct lp_rasterizer *rast )
 
    lp_scene_queue_destroy(rast->full_scenes);
 
+   FREE(rast->threads);
+   FREE(rast->tasks);
    FREE(rast);
 }
 
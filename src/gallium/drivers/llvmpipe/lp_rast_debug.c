@@ -7,7 +7,8 @@ struct tile {
    int coverage;
    int overdraw;
    const struct lp_rast_state *state;
-   char data[TILE_SIZE][TILE_SIZE];
+   unsigned size;
+   char data[LP_MAX_TILE_SIZE][LP_MAX_TILE_SIZE];
 };
 
 static char get_label( int i )
@@ -54,6 +55,7 @@ static const char *cmd_names[LP_RAST_OP_MAX] =
    "triangle_32_3_4",
    "triangle_32_3_16",
    "triangle_32_4_16",
+   "blit",
 };
 
 static const char *cmd_name(unsigned cmd)
@@ -72,6 +74,7 @@ get_variant( const struct lp_rast_state *state,
 
    if (block->cmd[k] == LP_RAST_OP_SHADE_TILE ||
        block->cmd[k] == LP_RAST_OP_SHADE_TILE_OPAQUE ||
+       block->cmd[k] == LP_RAST_OP_BLIT ||
        block->cmd[k] == LP_RAST_OP_TRIANGLE_1 ||
        block->cmd[k] == LP_RAST_OP_TRIANGLE_2 ||
        block->cmd[k] == LP_RAST_OP_TRIANGLE_3 ||
@@ -159,11 +162,11 @@ debug_shade_tile(int x, int y,
    if (inputs->disable)
       return 0;
 
-   for (i = 0; i < TILE_SIZE; i++)
-      for (j = 0; j < TILE_SIZE; j++)
+   for (i = 0; i < tile->size; i++)
+      for (j = 0; j < tile->size; j++)
          plot(tile, i, j, val, blend);
 
-   return TILE_SIZE * TILE_SIZE;
+   return tile->size * tile->size;
 }
 
 static int
@@ -174,11 +177,11 @@ debug_clear_tile(int x, int y,
 {
    unsigned i,j;
 
-   for (i = 0; i < TILE_SIZE; i++)
-      for (j = 0; j < TILE_SIZE; j++)
+   for (i = 0; i < tile->size; i++)
+      for (j = 0; j < tile->size; j++)
          plot(tile, i, j, val, FALSE);
 
-   return TILE_SIZE * TILE_SIZE;
+   return tile->size * tile->size;
 
 }
 
@@ -211,9 +214,9 @@ debug_triangle(int tilex, int tiley,
       nr_planes++;
    }
 
-   for(y = 0; y < TILE_SIZE; y++)
+   for(y = 0; y < tile->size; y++)
    {
-      for(x = 0; x < TILE_SIZE; x++)
+      for(x = 0; x < tile->size; x++)
       {
          for (i = 0; i < nr_planes; i++)
             if (plane[i].c <= 0)
@@ -228,7 +231,7 @@ debug_triangle(int tilex, int tiley,
       }
 
       for (i = 0; i < nr_planes; i++) {
-         plane[i].c += IMUL64(plane[i].dcdx, TILE_SIZE);
+         plane[i].c += IMUL64(plane[i].dcdx, tile->size);
          plane[i].c += plane[i].dcdy;
       }
    }
@@ -243,15 +246,17 @@ static void
 do_debug_bin( struct tile *tile,
               const struct cmd_bin *bin,
               int x, int y,
+              unsigned tile_size,
               boolean print_cmds)
 {
    unsigned k, j = 0;
    const struct cmd_block *block;
 
-   int tx = x * TILE_SIZE;
-   int ty = y * TILE_SIZE;
+   int tx = x * tile_size;
+   int ty = y * tile_size;
 
    memset(tile->data, ' ', sizeof tile->data);
+   tile->size = tile_size;
    tile->coverage = 0;
    tile->overdraw = 0;
    tile->state = NULL;
@@ -273,7 +278,8 @@ do_debug_bin( struct tile *tile,
             count = debug_clear_tile(tx, ty, block->arg[k], tile, val);
 
          if (block->cmd[k] == LP_RAST_OP_SHADE_TILE ||
-             block->cmd[k] == LP_RAST_OP_SHADE_TILE_OPAQUE)
+             block->cmd[k] == LP_RAST_OP_SHADE_TILE_OPAQUE ||
+             block->cmd[k] == LP_RAST_OP_BLIT)
             count = debug_shade_tile(tx, ty, block->arg[k], tile, val);
 
          if (block->cmd[k] == LP_RAST_OP_TRIANGLE_1 ||
@@ -298,17 +304,17 @@ do_debug_bin( struct tile *tile,
 }
 
 void
-lp_debug_bin( const struct cmd_bin *bin, int i, int j)
+lp_debug_bin( const struct cmd_bin *bin, int i, int j, unsigned tile_size)
 {
    struct tile tile;
    int x,y;
 
    if (bin->head) {
-      do_debug_bin(&tile, bin, i, j, TRUE);
+      do_debug_bin(&tile, bin, i, j, tile_size, TRUE);
 
       debug_printf("------------------------------------------------------------------\n");
-      for (y = 0; y < TILE_SIZE; y++) {
-         for (x = 0; x < TILE_SIZE; x++) {
+      for (y = 0; y < tile_size; y++) {
+         for (x = 0; x < tile_size; x++) {
             debug_printf("%c", tile.data[y][x]);
          }
          debug_printf("|\n");
@@ -361,17 +367,18 @@ lp_debug_draw_bins_by_coverage( struct lp_scene *scene )
          struct tile tile;
 
          if (bin->head) {
-            //lp_debug_bin(bin, x, y);
+            //lp_debug_bin(bin, x, y, scene->tile_size);
 
-            do_debug_bin(&tile, bin, x, y, FALSE);
+            do_debug_bin(&tile, bin, x, y, scene->tile_size, FALSE);
 
             total += tile.coverage;
-            possible += 64*64;
+            possible += scene->tile_size * scene->tile_size;
 
-            if (tile.coverage == 64*64)
+            if (tile.coverage == scene->tile_size * scene->tile_size)
                debug_printf("*");
             else if (tile.coverage) {
-               int bit = tile.coverage/(64.0*64.0)*10;
+               int bit = tile.coverage /
+                  (float)(scene->tile_size * scene->tile_size) * 10;
                debug_printf("%c", bits[MIN2(bit,10)]);
             }
             else
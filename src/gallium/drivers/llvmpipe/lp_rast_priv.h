@@ -76,9 +76,35 @@ extern const struct lp_rasterizer_task *jit_task;
 struct lp_rasterizer;
 struct cmd_bin;
 
+/**
+ * Coarse depth ("HiZ") of the tile being rasterized, kept per 16x16 chunk
+ * as an upper bound of the depth values in the chunk (layer 0 only).
+ * Lets triangles entirely behind the depth buffer be skipped chunk by chunk
+ * before running their shader, see lp_rast_hiz_cull().
+ *
+ * A chunk's zmax is computed from the depth buffer the first time it's
+ * needed.  Depth writes which can only lower the depth just mark it stale
+ * (still an upper bound, but it's worth recomputing it before giving up
+ * on culling), any other depth writes invalidate it.
+ */
+#define LP_HIZ_CHUNK_ORDER 4
+#define LP_HIZ_CHUNK_SIZE (1 << LP_HIZ_CHUNK_ORDER)
+#define LP_HIZ_CHUNKS_X (LP_MAX_TILE_SIZE / LP_HIZ_CHUNK_SIZE)
+
+struct lp_rast_hiz
+{
+   boolean enabled;     /**< depth buffer has a depth component */
+   float ulp;           /**< depth buffer resolution, 0 for float depth */
+   uint64_t valid;      /**< chunks with a known zmax */
+   uint64_t stale;      /**< chunks whose zmax may be too large */
+   float zmax[LP_HIZ_CHUNKS_X * LP_HIZ_CHUNKS_X];
+};
+
 /**
  * Per-thread rasterization state
  */
+#define LP_RAST_PENDING_ZS (1 << PIPE_MAX_COLOR_BUFS)
+
 struct lp_rasterizer_task
 {
    const struct cmd_bin *bin;
@@ -100,6 +126,16 @@ struct lp_rasterizer_task
    /** Non-interpolated passthru state and occlude counter for visible pixels */
    struct lp_jit_thread_data thread_data;
 
+   struct lp_rast_hiz hiz;
+
+   /**
+    * Clears of the current tile not written yet, one bit per color buffer
+    * plus LP_RAST_PENDING_ZS.
+    */
+   unsigned pending_clears;
+   union util_color clear_color[PIPE_MAX_COLOR_BUFS];
+   uint64_t clear_zs_value, clear_zs_mask;
+
    pipe_semaphore work_ready;
    pipe_semaphore work_done;
 };
@@ -108,7 +144,7 @@ struct lp_rasterizer_task
 /**
  * This is the state required while rasterizing tiles.
  * Note that this contains per-thread information too.
- * The tile size is TILE_SIZE x TILE_SIZE pixels.
+ * The tile size is chosen per scene, see lp_scene::tile_size.
  */
 struct lp_rasterizer
 {
@@ -121,11 +157,11 @@ struct lp_rasterizer
    /** The scene currently being rasterized by the threads */
    struct lp_scene *curr_scene;
 
-   /** A task object for each rasterization thread */
-   struct lp_rasterizer_task tasks[LP_MAX_THREADS];
+   /** A task object for each rasterization thread (at least one) */
+   struct lp_rasterizer_task *tasks;
 
    unsigned num_threads;
-   thrd_t threads[LP_MAX_THREADS];
+   thrd_t *threads;
 
    /** For synchronizing the rasterization threads */
    util_barrier barrier;
@@ -138,9 +174,74 @@ lp_rast_shade_quads_mask(struct lp_rasterizer_task *task,
                          unsigned x, unsigned y,
                          unsigned mask);
 
+boolean
+lp_rast_hiz_cull(struct lp_rasterizer_task *task,
+                 const struct lp_rast_shader_inputs *inputs,
+                 unsigned x, unsigned y,
+                 unsigned width, unsigned height);
+
+
+/**
+ * Mask of the HiZ chunks touched by a rectangle within the tile.
+ * \param x, y  position of the rectangle in window coords
+ */
+static inline uint64_t
+lp_rast_hiz_chunk_mask(const struct lp_rasterizer_task *task,
+                       unsigned x, unsigned y,
+                       unsigned width, unsigned height)
+{
+   unsigned x0 = (x - task->x) >> LP_HIZ_CHUNK_ORDER;
+   unsigned y0 = (y - task->y) >> LP_HIZ_CHUNK_ORDER;
+   unsigned x1 = (MIN2(x - task->x + width, task->width) - 1) >> LP_HIZ_CHUNK_ORDER;
+   unsigned y1 = (MIN2(y - task->y + height, task->height) - 1) >> LP_HIZ_CHUNK_ORDER;
+   uint64_t row = ((2ULL << x1) - 1) & ~((1ULL << x0) - 1);
+   uint64_t mask = 0;
+   unsigned i;
+
+   for (i = y0; i <= y1; i++) {
+      mask |= row << (i * LP_HIZ_CHUNKS_X);
+   }
+   return mask;
+}
+
+
+/**
+ * Update the HiZ state after the current shader ran on (part of) a
+ * rectangle within the tile.
+ * \param x, y  position of the rectangle in window coords
+ */
+static inline void
+lp_rast_hiz_written(struct lp_rasterizer_task *task,
+                    const struct lp_rast_shader_inputs *inputs,
+                    unsigned x, unsigned y,
+                    unsigned width, unsigned height)
+{
+   const struct pipe_depth_state *depth = &task->state->variant->key.depth;
+   uint64_t mask;
+
+   if (!depth->enabled || !depth->writemask || inputs->layer ||
+       !task->hiz.valid) {
+      return;
+   }
+
+   mask = lp_rast_hiz_chunk_mask(task, x, y, width, height);
+
+   switch (depth->func) {
+   case PIPE_FUNC_NEVER:
+   case PIPE_FUNC_LESS:
+   case PIPE_FUNC_EQUAL:
+   case PIPE_FUNC_LEQUAL:
+      task->hiz.stale |= mask;
+      break;
+   default:
+      task->hiz.valid &= ~mask;
+      break;
+   }
+}
+
 
 /**
- * Get the pointer to a 4x4 color block (within a 64x64 tile).
+ * Get the pointer to a 4x4 color block (within a tile).
  * \param x, y location of 4x4 block in window coords
  */
 static inline uint8_t *
@@ -151,8 +252,8 @@ lp_rast_get_color_block_pointer(struct lp_rasterizer_task *task,
    unsigned px, py, pixel_offset;
    uint8_t *color;
 
-   assert(x < task->scene->tiles_x * TILE_SIZE);
-   assert(y < task->scene->tiles_y * TILE_SIZE);
+   assert(x < task->scene->tiles_x * task->scene->tile_size);
+   assert(y < task->scene->tiles_y * task->scene->tile_size);
    assert((x % TILE_VECTOR_WIDTH) == 0);
    assert((y % TILE_VECTOR_HEIGHT) == 0);
    assert(buf < task->scene->fb.nr_cbufs);
@@ -164,8 +265,8 @@ lp_rast_get_color_block_pointer(struct lp_rasterizer_task *task,
     * it's just extra work - the mul/add would be exactly the same anyway.
     * Fortunately the extra work (modulo) here is very cheap at least...
     */
-   px = x % TILE_SIZE;
-   py = y % TILE_SIZE;
+   px = x - task->x;
+   py = y - task->y;
 
    pixel_offset = px * task->scene->cbufs[buf].format_bytes +
                   py * task->scene->cbufs[buf].stride;
@@ -181,7 +282,7 @@ lp_rast_get_color_block_pointer(struct lp_rasterizer_task *task,
 
 
 /**
- * Get the pointer to a 4x4 depth block (within a 64x64 tile).
+ * Get the pointer to a 4x4 depth block (within a tile).
  * \param x, y location of 4x4 block in window coords
  */
 static inline uint8_t *
@@ -191,15 +292,15 @@ lp_rast_get_depth_block_pointer(struct lp_rasterizer_task *task,
    unsigned px, py, pixel_offset;
    uint8_t *depth;
 
-   assert(x < task->scene->tiles_x * TILE_SIZE);
-   assert(y < task->scene->tiles_y * TILE_SIZE);
+   assert(x < task->scene->tiles_x * task->scene->tile_size);
+   assert(y < task->scene->tiles_y * task->scene->tile_size);
    assert((x % TILE_VECTOR_WIDTH) == 0);
    assert((y % TILE_VECTOR_HEIGHT) == 0);
 
    assert(task->depth_tile);
 
-   px = x % TILE_SIZE;
-   py = y % TILE_SIZE;
+   px = x - task->x;
+   py = y - task->y;
 
    pixel_offset = px * task->scene->zsbuf.format_bytes +
                   py * task->scene->zsbuf.stride;
@@ -256,7 +357,7 @@ lp_rast_shade_quads_all( struct lp_rasterizer_task *task,
     * The rasterizer may produce fragments outside our
     * allocated 4x4 blocks hence need to filter them out here.
     */
-   if ((x % TILE_SIZE) < task->width && (y % TILE_SIZE) < task->height) {
+   if ((x - task->x) < task->width && (y - task->y) < task->height) {
       /* Propagate non-interpolated raster state. */
       task->thread_data.raster_state.viewport_index = inputs->viewport_index;
 
@@ -336,6 +437,6 @@ lp_rast_set_state(struct lp_rasterizer_task *task,
                   const union lp_rast_cmd_arg arg);
  
 void
-lp_debug_bin( const struct cmd_bin *bin, int x, int y );
+lp_debug_bin( const struct cmd_bin *bin, int x, int y, unsigned tile_size );
 
 #endif
@@ -342,12 +342,17 @@ lp_rast_triangle_32_3_16(struct lp_rasterizer_task *task,
       c = _mm_add_epi32(c, _mm_slli_epi32(dcdy, 2));
    }
 
+   if (nr == 0 || lp_rast_hiz_cull(task, &tri->inputs, x, y, 16, 16))
+      return;
+
    for (i = 0; i < nr; i++)
       lp_rast_shade_quads_mask(task,
                                &tri->inputs,
                                x + 4 * out[i].j,
                                y + 4 * out[i].i,
                                0xffff & ~out[i].mask);
+
+   lp_rast_hiz_written(task, &tri->inputs, x, y, 16, 16);
 }
 
 void
@@ -423,12 +428,15 @@ lp_rast_triangle_32_3_4(struct lp_rasterizer_task *task,
 
       unsigned mask = _mm_movemask_epi8(c_0123);
 
-      if (mask != 0xffff)
+      if (mask != 0xffff &&
+          !lp_rast_hiz_cull(task, &tri->inputs, x, y, 4, 4)) {
          lp_rast_shade_quads_mask(task,
                                   &tri->inputs,
                                   x,
                                   y,
                                   0xffff & ~mask);
+         lp_rast_hiz_written(task, &tri->inputs, x, y, 4, 4);
+      }
    }
 }
 
@@ -640,12 +648,17 @@ lp_rast_triangle_32_3_16(struct lp_rasterizer_task *task,
       c = vec_add_epi32(c, vec_slli_epi32(dcdy, 2));
    }
 
+   if (nr == 0 || lp_rast_hiz_cull(task, &tri->inputs, x, y, 16, 16))
+      return;
+
    for (i = 0; i < nr; i++)
       lp_rast_shade_quads_mask(task,
                                &tri->inputs,
                                x + 4 * out[i].j,
                                y + 4 * out[i].i,
                                0xffff & ~out[i].mask);
+
+   lp_rast_hiz_written(task, &tri->inputs, x, y, 16, 16);
 }
 
 #undef NR_PLANES
@@ -170,36 +170,26 @@ TAG(do_block_16)(struct lp_rasterizer_task *task,
 
 
 /**
- * Scan the tile in chunks and figure out which pixels to rasterize
- * for this triangle.
+ * Scan a 64x64 block of the tile in 16x16 chunks and figure out which
+ * pixels to rasterize for this triangle.
+ * \param c  the plane values at the block origin
+ * \param block_mask  mask of the 16x16 chunks lying within the tile
  */
-void
-TAG(lp_rast_triangle)(struct lp_rasterizer_task *task,
-                      const union lp_rast_cmd_arg arg)
+static void
+TAG(do_block_64)(struct lp_rasterizer_task *task,
+                 const struct lp_rast_triangle *tri,
+                 const struct lp_rast_plane *plane,
+                 int x, int y,
+                 const int64_t *c,
+                 unsigned block_mask)
 {
-   const struct lp_rast_triangle *tri = arg.triangle.tri;
-   unsigned plane_mask = arg.triangle.plane_mask;
-   const struct lp_rast_plane *tri_plane = GET_PLANES(tri);
-   const int x = task->x, y = task->y;
-   struct lp_rast_plane plane[NR_PLANES];
-   int64_t c[NR_PLANES];
    unsigned outmask, inmask, partmask, partial_mask;
-   unsigned j = 0;
-
-   if (tri->inputs.disable) {
-      /* This triangle was partially binned and has been disabled */
-      return;
-   }
+   unsigned j;
 
    outmask = 0;                 /* outside one or more trivial reject planes */
    partmask = 0;                /* outside one or more trivial accept planes */
 
-   while (plane_mask) {
-      int i = ffs(plane_mask) - 1;
-      plane[j] = tri_plane[i];
-      plane_mask &= ~(1 << i);
-      c[j] = plane[j].c + IMUL64(plane[j].dcdy, y) - IMUL64(plane[j].dcdx, x);
-
+   for (j = 0; j < NR_PLANES; j++) {
       {
 #ifdef RASTER_64
          /*
@@ -222,9 +212,11 @@ TAG(lp_rast_triangle)(struct lp_rasterizer_task *task,
          int32_t cdiff;
          /*
           * Plausibility check to ensure the 32bit math works.
-          * Note that within a tile, the max we can move the edge function
-          * is essentially dcdx * TILE_SIZE + dcdy * TILE_SIZE.
-          * TILE_SIZE is 64, dcdx/dcdy are nominally 21 bit (for 8192 max size
+          * Note that within a block, the max we can move the edge function
+          * is essentially dcdx * 64 + dcdy * 64 (larger tiles are scanned
+          * as several 64x64 blocks), and the block origin is at most one
+          * more 64 away in each direction from where the plane crosses the
+          * tile.  dcdx/dcdy are nominally 21 bit (for 8192 max size
           * and 8 subpixel bits), I'd be happy with 2 bits more too (1 for
           * increasing fb size to 16384, the required d3d11 value, another one
           * because I'm not quite sure we can't be _just_ above the max value
@@ -264,16 +256,17 @@ TAG(lp_rast_triangle)(struct lp_rasterizer_task *task,
                      &outmask,   /* sign bits from c[i][0..15] + cox */
                      &partmask); /* sign bits from c[i][0..15] + cio */
       }
-
-      j++;
    }
 
+   /* Chunks beyond the tile are none of this tile's business */
+   outmask |= ~block_mask & 0xffff;
+
    if (outmask == 0xffff)
       return;
 
    /* Mask of sub-blocks which are inside all trivial accept planes:
     */
-   inmask = ~partmask & 0xffff;
+   inmask = ~partmask & block_mask;
 
    /* Mask of sub-blocks which are inside all trivial reject planes,
     * but outside at least one trivial accept plane:
@@ -282,7 +275,25 @@ TAG(lp_rast_triangle)(struct lp_rasterizer_task *task,
 
    assert((partial_mask & inmask) == 0);
 
-   LP_COUNT_ADD(nr_empty_16, util_bitcount(0xffff & ~(partial_mask | inmask)));
+   LP_COUNT_ADD(nr_empty_16, util_bitcount(block_mask & ~(partial_mask | inmask)));
+
+   /* Drop chunks where the triangle is behind the depth buffer:
+    */
+   if (task->state->variant->hiz) {
+      unsigned mask = partial_mask | inmask;
+
+      while (mask) {
+         int i = ffs(mask) - 1;
+
+         mask &= ~(1 << i);
+
+         if (lp_rast_hiz_cull(task, &tri->inputs,
+                              x + (i & 3) * 16, y + (i >> 2) * 16, 16, 16)) {
+            partial_mask &= ~(1 << i);
+            inmask &= ~(1 << i);
+         }
+      }
+   }
 
    /* Iterate over partials:
     */
@@ -303,6 +314,7 @@ TAG(lp_rast_triangle)(struct lp_rasterizer_task *task,
 
       LP_COUNT(nr_partially_covered_16);
       TAG(do_block_16)(task, tri, plane, px, py, cx);
+      lp_rast_hiz_written(task, &tri->inputs, px, py, 16, 16);
    }
 
    /* Iterate over fulls: 
@@ -318,6 +330,61 @@ TAG(lp_rast_triangle)(struct lp_rasterizer_task *task,
 
       LP_COUNT(nr_fully_covered_16);
       block_full_16(task, tri, px, py);
+      lp_rast_hiz_written(task, &tri->inputs, px, py, 16, 16);
+   }
+}
+
+
+/**
+ * Scan the tile in chunks and figure out which pixels to rasterize
+ * for this triangle.
+ */
+void
+TAG(lp_rast_triangle)(struct lp_rasterizer_task *task,
+                      const union lp_rast_cmd_arg arg)
+{
+   const struct lp_rast_triangle *tri = arg.triangle.tri;
+   unsigned plane_mask = arg.triangle.plane_mask;
+   const struct lp_rast_plane *tri_plane = GET_PLANES(tri);
+   const int x = task->x, y = task->y;
+   const unsigned tile_size = task->scene->tile_size;
+   struct lp_rast_plane plane[NR_PLANES];
+   int64_t c[NR_PLANES];
+   unsigned j = 0;
+
+   if (tri->inputs.disable) {
+      /* This triangle was partially binned and has been disabled */
+      return;
+   }
+
+   while (plane_mask) {
+      int i = ffs(plane_mask) - 1;
+      plane[j] = tri_plane[i];
+      plane_mask &= ~(1 << i);
+      c[j] = plane[j].c + IMUL64(plane[j].dcdy, y) - IMUL64(plane[j].dcdx, x);
+      j++;
+   }
+
+   if (tile_size <= 64) {
+      /* 32x32 tiles only span the top-left 2x2 chunks of the block */
+      TAG(do_block_64)(task, tri, plane, x, y, c,
+                       tile_size == 64 ? 0xffff : 0x0033);
+   }
+   else {
+      unsigned ix, iy;
+
+      for (iy = 0; iy < task->height; iy += 64) {
+         for (ix = 0; ix < task->width; ix += 64) {
+            int64_t cx[NR_PLANES];
+
+            for (j = 0; j < NR_PLANES; j++)
+               cx[j] = (c[j]
+                        - IMUL64(plane[j].dcdx, ix)
+                        + IMUL64(plane[j].dcdy, iy));
+
+            TAG(do_block_64)(task, tri, plane, x + ix, y + iy, cx, 0xffff);
+         }
+      }
    }
 }
 
@@ -345,6 +412,9 @@ TRI_16(struct lp_rasterizer_task *task,
    x += task->x;
    y += task->y;
 
+   if (lp_rast_hiz_cull(task, &tri->inputs, x, y, 16, 16))
+      return;
+
    for (j = 0; j < NR_PLANES; j++) {
       const int dcdx = -plane[j].dcdx * 4;
       const int dcdy = plane[j].dcdy * 4;
@@ -395,6 +465,8 @@ TRI_16(struct lp_rasterizer_task *task,
       if (mask)
 	 lp_rast_shade_quads_mask(task, &tri->inputs, px, py, mask);
    }
+
+   lp_rast_hiz_written(task, &tri->inputs, x, y, 16, 16);
 }
 #endif
 
@@ -410,6 +482,9 @@ TRI_4(struct lp_rasterizer_task *task,
    const int y = task->y + (mask >> 8);
    unsigned j;
 
+   if (lp_rast_hiz_cull(task, &tri->inputs, x, y, 4, 4))
+      return;
+
    /* Iterate over partials:
     */
    {
@@ -441,6 +516,8 @@ TRI_4(struct lp_rasterizer_task *task,
       if (mask)
 	 lp_rast_shade_quads_mask(task, &tri->inputs, x, y, mask);
    }
+
+   lp_rast_hiz_written(task, &tri->inputs, x, y, 4, 4);
 }
 #endif
 
@@ -204,7 +204,11 @@ lp_scene_begin_rasterization(struct lp_scene *scene)
 
 
 /**
- * Free all the temporary data in a scene.
+ * Unmap the framebuffer surfaces and empty the bins of a scene.
+ * Called by the rasterizer once all threads are done with the scene.
+ * The remaining scene data is released later by lp_scene_reset(), from
+ * the setup side, so that setup may keep inspecting a scene which is
+ * still being rasterized.
  */
 void
 lp_scene_end_rasterization(struct lp_scene *scene )
@@ -248,7 +252,17 @@ lp_scene_end_rasterization(struct lp_scene *scene )
     * they will be caught (on debug builds at least) by this assert:
     */
    assert(lp_scene_is_empty(scene));
+}
+
 
+/**
+ * Free all the temporary data in a scene.
+ * Must only be called once the rasterizer is done with the scene, i.e.
+ * after its fence has signalled (or if it was never queued).
+ */
+void
+lp_scene_reset(struct lp_scene *scene)
+{
    /* Decrement texture ref counts
     */
    {
@@ -508,7 +522,8 @@ end:
 
 
 void lp_scene_begin_binning(struct lp_scene *scene,
-                            struct pipe_framebuffer_state *fb)
+                            struct pipe_framebuffer_state *fb,
+                            unsigned tile_order)
 {
    int i;
    unsigned max_layer = ~0;
@@ -517,8 +532,11 @@ void lp_scene_begin_binning(struct lp_scene *scene,
 
    util_copy_framebuffer_state(&scene->fb, fb);
 
-   scene->tiles_x = align(fb->width, TILE_SIZE) / TILE_SIZE;
-   scene->tiles_y = align(fb->height, TILE_SIZE) / TILE_SIZE;
+   assert(tile_order >= LP_MIN_TILE_ORDER && tile_order <= LP_MAX_TILE_ORDER);
+   scene->tile_order = tile_order;
+   scene->tile_size = 1 << tile_order;
+   scene->tiles_x = align(fb->width, scene->tile_size) >> tile_order;
+   scene->tiles_y = align(fb->height, scene->tile_size) >> tile_order;
    assert(scene->tiles_x <= TILES_X);
    assert(scene->tiles_y <= TILES_Y);
 
@@ -561,3 +579,23 @@ void lp_scene_end_binning( struct lp_scene *scene )
          lp_debug_bins( scene );
    }
 }
+
+
+/**
+ * Return the number of bins with commands, which tells how much of the
+ * scene's work can be spread across the rasterizer threads.
+ */
+unsigned
+lp_scene_num_occupied_bins(const struct lp_scene *scene)
+{
+   unsigned x, y, count = 0;
+
+   for (y = 0; y < scene->tiles_y; y++) {
+      for (x = 0; x < scene->tiles_x; x++) {
+         if (scene->tile[x][y].head)
+            count++;
+      }
+   }
+
+   return count;
+}
@@ -45,8 +45,8 @@ struct lp_rast_state;
 /* We're limited to 2K by 2K for 32bit fixed point rasterization.
  * Will need a 64-bit version for larger framebuffers.
  */
-#define TILES_X (LP_MAX_WIDTH / TILE_SIZE)
-#define TILES_Y (LP_MAX_HEIGHT / TILE_SIZE)
+#define TILES_X (LP_MAX_WIDTH >> LP_MIN_TILE_ORDER)
+#define TILES_Y (LP_MAX_HEIGHT >> LP_MIN_TILE_ORDER)
 
 
 /* Commands per command block (ideally so sizeof(cmd_block) is a power of
@@ -166,6 +166,12 @@ struct lp_scene {
    unsigned resource_reference_size;
 
    boolean alloc_failed;
+
+   /**
+    * Size of the tiles for this scene, chosen at begin_binning time.
+    */
+   unsigned tile_order, tile_size;
+
    /**
     * Number of active tiles in each dimension.
     * This basically the framebuffer size divided by tile size
@@ -389,7 +395,11 @@ lp_scene_bin_iter_next( struct lp_scene *scene, int *x, int *y );
  */
 void
 lp_scene_begin_binning(struct lp_scene *scene,
-                       struct pipe_framebuffer_state *fb);
+                       struct pipe_framebuffer_state *fb,
+                       unsigned tile_order);
+
+unsigned
+lp_scene_num_occupied_bins(const struct lp_scene *scene);
 
 void
 lp_scene_end_binning(struct lp_scene *scene);
@@ -403,6 +413,9 @@ lp_scene_begin_rasterization(struct lp_scene *scene);
 void
 lp_scene_end_rasterization(struct lp_scene *scene);
 
+void
+lp_scene_reset(struct lp_scene *scene);
+
 
 
 
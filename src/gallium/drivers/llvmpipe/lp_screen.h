@@ -37,10 +37,14 @@
 #include "pipe/p_screen.h"
 #include "pipe/p_defines.h"
 #include "os/os_thread.h"
+#include "util/u_queue.h"
 #include "gallivm/lp_bld.h"
 
 
 struct sw_winsys;
+struct lp_fence;
+struct lp_cached_code;
+struct disk_cache;
 
 
 struct llvmpipe_screen
@@ -57,6 +61,20 @@ struct llvmpipe_screen
 
    struct lp_rasterizer *rast;
    mtx_t rast_mutex;
+
+   /** Fence of the last scene queued to the rasterizer (protected by
+    * rast_mutex).  Scenes are rasterized in order, so this signals once
+    * all rendering queued so far is done.
+    */
+   struct lp_fence *last_fence;
+
+   /** On-disk cache of the shader variants' object code */
+   struct disk_cache *disk_shader_cache;
+
+   /** Queue compiling optimized fragment shader variants in the
+    * background, uninitialized when compiling synchronously.
+    */
+   struct util_queue fs_compile_queue;
 };
 
 
@@ -70,4 +88,15 @@ llvmpipe_screen( struct pipe_screen *pipe )
 
 
 
+void
+lp_disk_cache_find_shader(struct llvmpipe_screen *screen,
+                          struct lp_cached_code *cache,
+                          unsigned char ir_sha1_cache_key[20]);
+
+void
+lp_disk_cache_insert_shader(struct llvmpipe_screen *screen,
+                            struct lp_cached_code *cache,
+                            unsigned char ir_sha1_cache_key[20]);
+
+
 #endif /* LP_SCREEN_H */
@@ -64,6 +64,57 @@ static boolean set_scene_state( struct lp_setup_context *, enum setup_state,
 static boolean try_update_scene_state( struct lp_setup_context *setup );
 
 
+/*
+ * A scene gets smaller tiles when it would have fewer than
+ * LP_MIN_TILES_PER_THREAD tiles with work per rasterizer thread, and larger
+ * ones as long as that still leaves LP_MAX_TILES_PER_THREAD of them.
+ */
+#define LP_MIN_TILES_PER_THREAD 4
+#define LP_MAX_TILES_PER_THREAD 16
+
+
+/** Estimate how many tiles of the given order will receive commands */
+static unsigned
+busy_tiles(const struct lp_setup_context *setup, unsigned order)
+{
+   unsigned size = 1 << order;
+   unsigned tiles = ((setup->fb.width + size - 1) >> order) *
+                    ((setup->fb.height + size - 1) >> order);
+
+   return (tiles * setup->bin_occupancy) >> 8;
+}
+
+
+/**
+ * Pick the tile size of a new scene.  Small framebuffers, or scenes only
+ * touching a small part of it, are split into smaller tiles so they don't
+ * end up serialized on a couple of threads, while large ones use larger
+ * tiles to cut the per-tile binning and rasterization overhead.
+ */
+static unsigned
+choose_tile_order(const struct lp_setup_context *setup)
+{
+   unsigned num_threads = MAX2(setup->num_threads, 1);
+   unsigned order = TILE_ORDER;
+
+   if (setup->tile_order_override)
+      return setup->tile_order_override;
+
+   while (order > LP_MIN_TILE_ORDER &&
+          busy_tiles(setup, order) < LP_MIN_TILES_PER_THREAD * num_threads)
+      order--;
+
+   if (order == TILE_ORDER) {
+      while (order < LP_MAX_TILE_ORDER &&
+             busy_tiles(setup, order + 1) >=
+             LP_MAX_TILES_PER_THREAD * num_threads)
+         order++;
+   }
+
+   return order;
+}
+
+
 static void
 lp_setup_get_empty_scene(struct lp_setup_context *setup)
 {
@@ -80,9 +131,11 @@ lp_setup_get_empty_scene(struct lp_setup_context *setup)
                       __FUNCTION__, setup->scene->fence->id);
 
       lp_fence_wait(setup->scene->fence);
+      lp_scene_reset(setup->scene);
    }
 
-   lp_scene_begin_binning(setup->scene, &setup->fb);
+   lp_scene_begin_binning(setup->scene, &setup->fb,
+                          choose_tile_order(setup));
 
 }
 
@@ -160,28 +213,28 @@ lp_setup_rasterize_scene( struct lp_setup_context *setup )
 
    lp_scene_end_binning(scene);
 
+   /* Must be done before queuing, the rasterizer resets the bins */
+   if (scene->tiles_x && scene->tiles_y) {
+      setup->bin_occupancy = (lp_scene_num_occupied_bins(scene) << 8) /
+                             (scene->tiles_x * scene->tiles_y);
+      setup->bin_occupancy = MAX2(setup->bin_occupancy, 1);
+   }
+
    lp_fence_reference(&setup->last_fence, scene->fence);
 
    if (setup->last_fence)
       setup->last_fence->issued = TRUE;
 
-   mtx_lock(&screen->rast_mutex);
-
-   /* FIXME: We enqueue the scene then wait on the rasterizer to finish.
-    * This means we never actually run any vertex stuff in parallel to
-    * rasterization (not in the same context at least) which is what the
-    * multiple scenes per setup is about - when we get a new empty scene
-    * any old one is already empty again because we waited here for
-    * raster tasks to be finished. Ideally, we shouldn't need to wait here
-    * and rely on fences elsewhere when waiting is necessary.
-    * Certainly, lp_scene_end_rasterization() would need to be deferred too
-    * and there's probably other bits why this doesn't actually work.
+   /* Don't wait for the rasterizer here: the scene's fence signals when
+    * it is done, and lp_setup_get_empty_scene() waits on it before the
+    * scene gets reused, so binning of the next scenes can overlap with
+    * rasterization of this one.
     */
+   mtx_lock(&screen->rast_mutex);
    lp_rast_queue_scene(screen->rast, scene);
-   lp_rast_finish(screen->rast);
+   lp_fence_reference(&screen->last_fence, scene->fence);
    mtx_unlock(&screen->rast_mutex);
 
-   lp_scene_end_rasterization(setup->scene);
    lp_setup_reset( setup );
 
    LP_DBG(DEBUG_SETUP, "%s done \n", __FUNCTION__);
@@ -199,9 +252,10 @@ begin_binning( struct lp_setup_context *setup )
    assert(scene);
    assert(scene->fence == NULL);
 
-   /* Always create a fence:
+   /* Always create a fence.  It is signalled once, by the rasterizer,
+    * when all threads are done with the scene:
     */
-   scene->fence = lp_fence_create(MAX2(1, setup->num_threads));
+   scene->fence = lp_fence_create(1);
    if (!scene->fence)
       return FALSE;
 
@@ -343,6 +397,7 @@ set_scene_state( struct lp_setup_context *setup,
 fail:
    if (setup->scene) {
       lp_scene_end_rasterization(setup->scene);
+      lp_scene_reset(setup->scene);
       setup->scene = NULL;
    }
 
@@ -985,9 +1040,24 @@ lp_setup_is_resource_referenced( const struct lp_setup_context *setup,
       return LP_REFERENCED_FOR_READ | LP_REFERENCED_FOR_WRITE;
    }
 
-   /* check textures referenced by the scene */
+   /* check the scenes still being binned or rasterized */
    for (i = 0; i < ARRAY_SIZE(setup->scenes); i++) {
-      if (lp_scene_is_resource_referenced(setup->scenes[i], texture)) {
+      struct lp_scene *scene = setup->scenes[i];
+      unsigned j;
+
+      if (scene != setup->scene &&
+          (!scene->fence || lp_fence_signalled(scene->fence)))
+         continue;
+
+      for (j = 0; j < scene->fb.nr_cbufs; j++) {
+         if (scene->fb.cbufs[j] && scene->fb.cbufs[j]->texture == texture)
+            return LP_REFERENCED_FOR_READ | LP_REFERENCED_FOR_WRITE;
+      }
+      if (scene->fb.zsbuf && scene->fb.zsbuf->texture == texture) {
+         return LP_REFERENCED_FOR_READ | LP_REFERENCED_FOR_WRITE;
+      }
+
+      if (lp_scene_is_resource_referenced(scene, texture)) {
          return LP_REFERENCED_FOR_READ;
       }
    }
@@ -1291,8 +1361,10 @@ lp_setup_destroy( struct lp_setup_context *setup )
    for (i = 0; i < ARRAY_SIZE(setup->scenes); i++) {
       struct lp_scene *scene = setup->scenes[i];
 
-      if (scene->fence)
+      if (scene->fence) {
          lp_fence_wait(scene->fence);
+         lp_scene_reset(scene);
+      }
 
       lp_scene_destroy(scene);
    }
@@ -1329,6 +1401,11 @@ lp_setup_create( struct pipe_context *pipe,
 
 
    setup->num_threads = screen->num_threads;
+   setup->bin_occupancy = 256;
+   setup->tile_order_override = debug_get_num_option("LP_TILE_ORDER", 0);
+   if (setup->tile_order_override)
+      setup->tile_order_override = CLAMP(setup->tile_order_override,
+                                         LP_MIN_TILE_ORDER, LP_MAX_TILE_ORDER);
    setup->vbuf = draw_vbuf_stage(draw, &setup->base);
    if (!setup->vbuf) {
       goto no_vbuf;
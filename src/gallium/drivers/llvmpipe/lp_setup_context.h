@@ -54,9 +54,13 @@
 struct lp_setup_variant;
 
 
-/** Max number of scenes */
-/* XXX: make multiple scenes per context work, see lp_setup_rasterize_scene */
-#define MAX_SCENES 1
+/**
+ * Max number of scenes.
+ * Setup bins into the next scene while the rasterizer threads are still
+ * busy with the previous ones, only waiting for a scene's fence when it
+ * comes around again.
+ */
+#define MAX_SCENES 4
 
 
 
@@ -88,6 +92,13 @@ struct lp_setup_context
    struct draw_stage *vbuf;
    unsigned num_threads;
    unsigned scene_idx;
+
+   /** Share of the last scene's bins which got commands, in 1/256ths.
+    * Used along with the framebuffer size to pick the next tile size.
+    */
+   unsigned bin_occupancy;
+   /** Fixed tile order from LP_TILE_ORDER, or zero to pick it per scene */
+   unsigned tile_order_override;
    struct lp_scene *scenes[MAX_SCENES];  /**< all the scenes */
    struct lp_scene *scene;               /**< current scene being built */
 
@@ -214,6 +225,13 @@ lp_setup_alloc_triangle(struct lp_scene *scene,
                         unsigned nr_planes,
                         unsigned *tri_size);
 
+boolean
+lp_setup_rect(struct lp_setup_context *setup,
+              const float (*v0)[4],
+              const float (*v1)[4],
+              const float (*v2)[4],
+              const float (*v3)[4]);
+
 boolean
 lp_setup_bin_triangle(struct lp_setup_context *setup,
                       struct lp_rast_triangle *tri,
@@ -206,6 +206,39 @@ lp_rast_32_tri_tab[MAX_PLANES+1] = {
 
 
 
+/**
+ * Whether the blit shader's texture coordinates step by exactly one
+ * texel per pixel along x and y, so that fully covered tiles can be
+ * copied from the texture by lp_rast_blit_tile().
+ */
+static boolean
+lp_setup_is_blit(const struct lp_setup_context *setup,
+                 const struct lp_rast_shader_inputs *inputs)
+{
+   const struct lp_fragment_shader *shader = setup->fs.current.variant->shader;
+   const struct lp_jit_texture *texture =
+      &setup->fs.current.jit_context.textures[0];
+   const unsigned slot = shader->blit_input + 1;
+   const float eps = 1.0f / LP_MAX_WIDTH;
+   float dsdx, dsdy, dtdx, dtdy;
+
+   /* Perspective interpolation only matches if w is 1 everywhere */
+   if (shader->inputs[shader->blit_input].interp == LP_INTERP_PERSPECTIVE &&
+       (GET_A0(inputs)[0][3] != 1.0f ||
+        GET_DADX(inputs)[0][3] != 0.0f ||
+        GET_DADY(inputs)[0][3] != 0.0f))
+      return FALSE;
+
+   dsdx = GET_DADX(inputs)[slot][0] * texture->width;
+   dsdy = GET_DADY(inputs)[slot][0] * texture->width;
+   dtdx = GET_DADX(inputs)[slot][1] * texture->height;
+   dtdy = GET_DADY(inputs)[slot][1] * texture->height;
+
+   return fabsf(dsdx - 1.0f) < eps && fabsf(dsdy) < eps &&
+          fabsf(dtdx) < eps && fabsf(dtdy - 1.0f) < eps;
+}
+
+
 /**
  * The primitive covers the whole tile- shade whole tile.
  *
@@ -242,6 +275,16 @@ lp_setup_whole_tile(struct lp_setup_context *setup,
       }
 
       LP_COUNT(nr_shade_opaque_64);
+
+      if (setup->fs.current.variant->blit &&
+          lp_setup_is_blit(setup, inputs)) {
+         LP_COUNT(nr_blit_64);
+         return lp_scene_bin_cmd_with_state( scene, tx, ty,
+                                             setup->fs.stored,
+                                             LP_RAST_OP_BLIT,
+                                             lp_rast_arg_inputs(inputs) );
+      }
+
       return lp_scene_bin_cmd_with_state( scene, tx, ty,
                                           setup->fs.stored,
                                           LP_RAST_OP_SHADE_TILE_OPAQUE,
@@ -256,6 +299,101 @@ lp_setup_whole_tile(struct lp_setup_context *setup,
 }
 
 
+/**
+ * Finish setting up an edge plane whose dcdx/dcdy have been set from the
+ * edge's fixed point deltas, given one of the edge's vertices.
+ */
+static inline void
+init_edge_plane(const struct lp_setup_context *setup,
+                struct lp_rast_plane *plane,
+                int32_t x, int32_t y)
+{
+   /* half-edge constants, will be iterated over the whole render
+    * target.
+    */
+   plane->c = IMUL64(plane->dcdx, x) - IMUL64(plane->dcdy, y);
+
+   /* correct for top-left vs. bottom-left fill convention.
+    */
+   if (plane->dcdx < 0) {
+      /* both fill conventions want this - adjust for left edges */
+      plane->c++;
+   }
+   else if (plane->dcdx == 0) {
+      if (setup->bottom_edge_rule == 0){
+         /* correct for top-left fill convention:
+          */
+         if (plane->dcdy > 0) plane->c++;
+      }
+      else {
+         /* correct for bottom-left fill convention:
+          */
+         if (plane->dcdy < 0) plane->c++;
+      }
+   }
+
+   /* Scale up to match c:
+    */
+   assert((plane->dcdx << FIXED_ORDER) >> FIXED_ORDER == plane->dcdx);
+   assert((plane->dcdy << FIXED_ORDER) >> FIXED_ORDER == plane->dcdy);
+   plane->dcdx <<= FIXED_ORDER;
+   plane->dcdy <<= FIXED_ORDER;
+
+   /* find trivial reject offsets for each edge for a single-pixel
+    * sized block.  These will be scaled up at each recursive level to
+    * match the active blocksize.  Scaling in this way works best if
+    * the blocks are square.
+    */
+   plane->eo = 0;
+   if (plane->dcdx < 0) plane->eo -= plane->dcdx;
+   if (plane->dcdy > 0) plane->eo += plane->dcdy;
+}
+
+
+/**
+ * Fill in the scissor planes selected by scissor_planes_needed().
+ */
+static void
+init_scissor_planes(struct lp_rast_plane *plane_s,
+                    const boolean s_planes[4],
+                    const struct u_rect *scissor,
+                    int nr_planes)
+{
+   MAYBE_UNUSED const struct lp_rast_plane *end = plane_s + nr_planes;
+
+   /* why not just use draw_regions */
+   if (s_planes[0]) {
+      plane_s->dcdx = -1 << 8;
+      plane_s->dcdy = 0;
+      plane_s->c = (1-scissor->x0) << 8;
+      plane_s->eo = 1 << 8;
+      plane_s++;
+   }
+   if (s_planes[1]) {
+      plane_s->dcdx = 1 << 8;
+      plane_s->dcdy = 0;
+      plane_s->c = (scissor->x1+1) << 8;
+      plane_s->eo = 0 << 8;
+      plane_s++;
+   }
+   if (s_planes[2]) {
+      plane_s->dcdx = 0;
+      plane_s->dcdy = 1 << 8;
+      plane_s->c = (1-scissor->y0) << 8;
+      plane_s->eo = 1 << 8;
+      plane_s++;
+   }
+   if (s_planes[3]) {
+      plane_s->dcdx = 0;
+      plane_s->dcdy = -1 << 8;
+      plane_s->c = (scissor->y1+1) << 8;
+      plane_s->eo = 0;
+      plane_s++;
+   }
+   assert(plane_s == end);
+}
+
+
 /**
  * Do basic setup for triangle rasterization and determine which
  * framebuffer tiles are touched.  Put the triangle in the scene's
@@ -596,48 +734,8 @@ do_triangle_ccw(struct lp_setup_context *setup,
       plane[1].dcdx = position->y[1] - position->y[2];
       plane[2].dcdx = position->dy20;
   
-      for (i = 0; i < 3; i++) {
-         /* half-edge constants, will be iterated over the whole render
-          * target.
-          */
-         plane[i].c = IMUL64(plane[i].dcdx, position->x[i]) -
-                      IMUL64(plane[i].dcdy, position->y[i]);
-
-         /* correct for top-left vs. bottom-left fill convention.
-          */
-         if (plane[i].dcdx < 0) {
-            /* both fill conventions want this - adjust for left edges */
-            plane[i].c++;
-         }
-         else if (plane[i].dcdx == 0) {
-            if (setup->bottom_edge_rule == 0){
-               /* correct for top-left fill convention:
-                */
-               if (plane[i].dcdy > 0) plane[i].c++;
-            }
-            else {
-               /* correct for bottom-left fill convention:
-                */
-               if (plane[i].dcdy < 0) plane[i].c++;
-            }
-         }
-
-         /* Scale up to match c:
-          */
-         assert((plane[i].dcdx << FIXED_ORDER) >> FIXED_ORDER == plane[i].dcdx);
-         assert((plane[i].dcdy << FIXED_ORDER) >> FIXED_ORDER == plane[i].dcdy);
-         plane[i].dcdx <<= FIXED_ORDER;
-         plane[i].dcdy <<= FIXED_ORDER;
-
-         /* find trivial reject offsets for each edge for a single-pixel
-          * sized block.  These will be scaled up at each recursive level to
-          * match the active blocksize.  Scaling in this way works best if
-          * the blocks are square.
-          */
-         plane[i].eo = 0;
-         if (plane[i].dcdx < 0) plane[i].eo -= plane[i].dcdx;
-         if (plane[i].dcdy > 0) plane[i].eo += plane[i].dcdy;
-      }
+      for (i = 0; i < 3; i++)
+         init_edge_plane(setup, &plane[i], position->x[i], position->y[i]);
    }
 
    if (0) {
@@ -682,40 +780,8 @@ do_triangle_ccw(struct lp_setup_context *setup,
     * scissor edge this is, so rasterization would treat them differently
     * (easier to evaluate) to ordinary planes.)
     */
-   if (nr_planes > 3) {
-      /* why not just use draw_regions */
-      struct lp_rast_plane *plane_s = &plane[3];
-
-      if (s_planes[0]) {
-         plane_s->dcdx = -1 << 8;
-         plane_s->dcdy = 0;
-         plane_s->c = (1-scissor->x0) << 8;
-         plane_s->eo = 1 << 8;
-         plane_s++;
-      }
-      if (s_planes[1]) {
-         plane_s->dcdx = 1 << 8;
-         plane_s->dcdy = 0;
-         plane_s->c = (scissor->x1+1) << 8;
-         plane_s->eo = 0 << 8;
-         plane_s++;
-      }
-      if (s_planes[2]) {
-         plane_s->dcdx = 0;
-         plane_s->dcdy = 1 << 8;
-         plane_s->c = (1-scissor->y0) << 8;
-         plane_s->eo = 1 << 8;
-         plane_s++;
-      }
-      if (s_planes[3]) {
-         plane_s->dcdx = 0;
-         plane_s->dcdy = -1 << 8;
-         plane_s->c = (scissor->y1+1) << 8;
-         plane_s->eo = 0;
-         plane_s++;
-      }
-      assert(plane_s == &plane[nr_planes]);
-   }
+   if (nr_planes > 3)
+      init_scissor_planes(&plane[3], s_planes, scissor, nr_planes - 3);
 
    return lp_setup_bin_triangle(setup, tri, &bbox, &bboxpos, nr_planes, viewport_index);
 }
@@ -758,6 +824,8 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
 {
    struct lp_scene *scene = setup->scene;
    struct u_rect trimmed_box = *bbox;   
+   const int tile_order = scene->tile_order;
+   const int tile_size = scene->tile_size;
    int i;
    /* What is the largest power-of-two boundary this triangle crosses:
     */
@@ -781,6 +849,12 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
                      (bboxorig->y1 - (bboxorig->y0 & ~3)));
    boolean use_32bits = max_szorig <= MAX_FIXED_LENGTH32;
 
+   /* The 32bit rasterization functions' plane math only has enough
+    * headroom for the distances within tiles up to TILE_SIZE.
+    */
+   if (tile_order > TILE_ORDER)
+      use_32bits = FALSE;
+
    /* Now apply scissor, etc to the bounding box.  Could do this
     * earlier, but it confuses the logic for tri-16 and would force
     * the rasterizer to also respect scissor, etc, just for the rare
@@ -791,23 +865,23 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
 
    /* Determine which tile(s) intersect the triangle's bounding box
     */
-   if (dx < TILE_SIZE)
+   if (dx < tile_size)
    {
-      int ix0 = bbox->x0 / TILE_SIZE;
-      int iy0 = bbox->y0 / TILE_SIZE;
-      unsigned px = bbox->x0 & 63 & ~3;
-      unsigned py = bbox->y0 & 63 & ~3;
+      int ix0 = bbox->x0 >> tile_order;
+      int iy0 = bbox->y0 >> tile_order;
+      unsigned px = bbox->x0 & (tile_size - 1) & ~3;
+      unsigned py = bbox->y0 & (tile_size - 1) & ~3;
 
-      assert(iy0 == bbox->y1 / TILE_SIZE &&
-	     ix0 == bbox->x1 / TILE_SIZE);
+      assert(iy0 == bbox->y1 >> tile_order &&
+	     ix0 == bbox->x1 >> tile_order);
 
       if (nr_planes == 3) {
          if (sz < 4)
          {
             /* Triangle is contained in a single 4x4 stamp:
              */
-            assert(px + 4 <= TILE_SIZE);
-            assert(py + 4 <= TILE_SIZE);
+            assert(px + 4 <= tile_size);
+            assert(py + 4 <= tile_size);
             return lp_scene_bin_cmd_with_state( scene, ix0, iy0,
                                                 setup->fs.stored,
                                                 use_32bits ?
@@ -826,11 +900,11 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
              * dimensions if the triangle is 16 pixels in one dimension but 4
              * in the other. So budge the 16x16 back inside the tile.
              */
-            px = MIN2(px, TILE_SIZE - 16);
-            py = MIN2(py, TILE_SIZE - 16);
+            px = MIN2(px, tile_size - 16);
+            py = MIN2(py, tile_size - 16);
 
-            assert(px + 16 <= TILE_SIZE);
-            assert(py + 16 <= TILE_SIZE);
+            assert(px + 16 <= tile_size);
+            assert(py + 16 <= tile_size);
 
             return lp_scene_bin_cmd_with_state( scene, ix0, iy0,
                                                 setup->fs.stored,
@@ -842,11 +916,11 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
       }
       else if (nr_planes == 4 && sz < 16) 
       {
-         px = MIN2(px, TILE_SIZE - 16);
-         py = MIN2(py, TILE_SIZE - 16);
+         px = MIN2(px, tile_size - 16);
+         py = MIN2(py, tile_size - 16);
 
-         assert(px + 16 <= TILE_SIZE);
-         assert(py + 16 <= TILE_SIZE);
+         assert(px + 16 <= tile_size);
+         assert(py + 16 <= tile_size);
 
          return lp_scene_bin_cmd_with_state(scene, ix0, iy0,
                                             setup->fs.stored,
@@ -875,23 +949,23 @@ lp_setup_bin_triangle(struct lp_setup_context *setup,
       int64_t ystep[MAX_PLANES];
       int x, y;
 
-      int ix0 = trimmed_box.x0 / TILE_SIZE;
-      int iy0 = trimmed_box.y0 / TILE_SIZE;
-      int ix1 = trimmed_box.x1 / TILE_SIZE;
-      int iy1 = trimmed_box.y1 / TILE_SIZE;
+      int ix0 = trimmed_box.x0 >> tile_order;
+      int iy0 = trimmed_box.y0 >> tile_order;
+      int ix1 = trimmed_box.x1 >> tile_order;
+      int iy1 = trimmed_box.y1 >> tile_order;
       
       for (i = 0; i < nr_planes; i++) {
          c[i] = (plane[i].c + 
-                 IMUL64(plane[i].dcdy, iy0) * TILE_SIZE -
-                 IMUL64(plane[i].dcdx, ix0) * TILE_SIZE);
+                 IMUL64(plane[i].dcdy, iy0) * tile_size -
+                 IMUL64(plane[i].dcdx, ix0) * tile_size);
 
          ei[i] = (plane[i].dcdy - 
                   plane[i].dcdx - 
-                  (int64_t)plane[i].eo) << TILE_ORDER;
+                  (int64_t)plane[i].eo) << tile_order;
 
-         eo[i] = (int64_t)plane[i].eo << TILE_ORDER;
-         xstep[i] = -(((int64_t)plane[i].dcdx) << TILE_ORDER);
-         ystep[i] = ((int64_t)plane[i].dcdy) << TILE_ORDER;
+         eo[i] = (int64_t)plane[i].eo << tile_order;
+         xstep[i] = -(((int64_t)plane[i].dcdx) << tile_order);
+         ystep[i] = ((int64_t)plane[i].dcdy) << tile_order;
       }
 
 
@@ -1214,6 +1288,222 @@ static void triangle_noop(struct lp_setup_context *setup,
 }
 
 
+/**
+ * Setup and bin a screen-aligned rectangle, given its corners in
+ * counter-clockwise order.  This covers the same pixels as the two
+ * triangles it's made of, but without the diagonal edge, so the tiles
+ * along the diagonal don't need coverage tests and the whole interior
+ * is binned as fully covered tiles.
+ */
+static boolean
+do_rect_ccw(struct lp_setup_context *setup,
+            const int32_t x[4],
+            const int32_t y[4],
+            const float (*v0)[4],
+            const float (*v1)[4],
+            const float (*v2)[4],
+            boolean frontfacing)
+{
+   struct lp_scene *scene = setup->scene;
+   const struct lp_setup_variant_key *key = &setup->setup.variant->key;
+   const struct u_rect *scissor = &setup->scissors[0];
+   struct lp_rast_triangle *tri;
+   struct lp_rast_plane *plane;
+   struct u_rect bbox, bboxpos;
+   boolean s_planes[4];
+   unsigned tri_bytes;
+   int nr_planes = 4;
+   int adj = (setup->bottom_edge_rule != 0) ? 1 : 0;
+   int i;
+
+   /* Opposite corners hold both the min and max coordinates. */
+   bbox.x0 =  MIN2(x[0], x[2]) >> FIXED_ORDER;
+   bbox.x1 = (MAX2(x[0], x[2]) - 1) >> FIXED_ORDER;
+   bbox.y0 = (MIN2(y[0], y[2]) + adj) >> FIXED_ORDER;
+   bbox.y1 = (MAX2(y[0], y[2]) - 1 + adj) >> FIXED_ORDER;
+
+   if (bbox.x1 < bbox.x0 ||
+       bbox.y1 < bbox.y0) {
+      LP_COUNT(nr_culled_tris);
+      return TRUE;
+   }
+
+   if (!u_rect_test_intersection(&setup->draw_regions[0], &bbox)) {
+      LP_COUNT(nr_culled_tris);
+      return TRUE;
+   }
+
+   bboxpos = bbox;
+   bboxpos.x0 = MAX2(bboxpos.x0, 0);
+   bboxpos.y0 = MAX2(bboxpos.y0, 0);
+
+   if (setup->scissor_test) {
+      scissor_planes_needed(s_planes, &bboxpos, scissor);
+      nr_planes += s_planes[0] + s_planes[1] + s_planes[2] + s_planes[3];
+   }
+
+   tri = lp_setup_alloc_triangle(scene,
+                                 key->num_inputs,
+                                 nr_planes,
+                                 &tri_bytes);
+   if (!tri)
+      return FALSE;
+
+#ifdef DEBUG
+   tri->v[0][0] = v0[0][0];
+   tri->v[1][0] = v1[0][0];
+   tri->v[2][0] = v2[0][0];
+   tri->v[0][1] = v0[0][1];
+   tri->v[1][1] = v1[0][1];
+   tri->v[2][1] = v2[0][1];
+#endif
+
+   LP_COUNT(nr_rects);
+
+   /* The attributes are planar across the rectangle, so the interpolants
+    * of either of its triangles are good for all of it.
+    */
+   setup->setup.variant->jit_function(v0, v1, v2,
+                                      frontfacing,
+                                      GET_A0(&tri->inputs),
+                                      GET_DADX(&tri->inputs),
+                                      GET_DADY(&tri->inputs));
+
+   tri->inputs.frontfacing = frontfacing;
+   tri->inputs.disable = FALSE;
+   tri->inputs.opaque = setup->fs.current.variant->opaque;
+   tri->inputs.layer = 0;
+   tri->inputs.viewport_index = 0;
+
+   plane = GET_PLANES(tri);
+   for (i = 0; i < 4; i++) {
+      int j = (i + 1) & 3;
+      plane[i].dcdx = y[i] - y[j];
+      plane[i].dcdy = x[i] - x[j];
+      init_edge_plane(setup, &plane[i], x[i], y[i]);
+   }
+
+   if (nr_planes > 4)
+      init_scissor_planes(&plane[4], s_planes, scissor, nr_planes - 4);
+
+   return lp_setup_bin_triangle(setup, tri, &bbox, &bboxpos, nr_planes, 0);
+}
+
+
+/**
+ * Try to draw the quad v0 v1 v2 v3, given in perimeter order, as a single
+ * rectangle instead of as two triangles.
+ *
+ * This only works for screen-aligned rectangles whose attributes are
+ * planar across the whole quad, which is the common case for blits, UI
+ * and post-processing passes.  Returns FALSE without drawing anything
+ * otherwise, in which case the caller should draw the triangles.
+ */
+boolean
+lp_setup_rect(struct lp_setup_context *setup,
+              const float (*v0)[4],
+              const float (*v1)[4],
+              const float (*v2)[4],
+              const float (*v3)[4])
+{
+   const struct lp_setup_variant_key *key = &setup->setup.variant->key;
+   const unsigned nr_attribs = setup->vertex_info->size / 4;
+   struct llvmpipe_context *lp_context = (struct llvmpipe_context *)setup->pipe;
+   PIPE_ALIGN_VAR(16) struct fixed_position position;
+   int32_t x[4], y[4];
+   boolean front;
+   unsigned i, j;
+
+   /* Layer and viewport index would have to match as well */
+   if (setup->triangle == triangle_noop ||
+       setup->viewport_index_slot > 0 ||
+       setup->layer_slot > 0)
+      return FALSE;
+
+   if (!(v0[0][0] == v1[0][0] && v1[0][1] == v2[0][1] &&
+         v2[0][0] == v3[0][0] && v3[0][1] == v0[0][1]) &&
+       !(v0[0][1] == v1[0][1] && v1[0][0] == v2[0][0] &&
+         v2[0][1] == v3[0][1] && v3[0][0] == v0[0][0]))
+      return FALSE;
+
+   /* Perspective interpolation is only planar if w is constant. */
+   if (v0[0][3] != v1[0][3] ||
+       v0[0][3] != v2[0][3] ||
+       v0[0][3] != v3[0][3])
+      return FALSE;
+
+   /* Every attribute must be affine in screen space, that is v0 - v1 must
+    * equal v3 - v2.  Compare exactly, anything else draws the triangles.
+    */
+   for (i = 0; i < nr_attribs; i++) {
+      for (j = 0; j < 4; j++) {
+         if (v0[i][j] + v2[i][j] != v1[i][j] + v3[i][j])
+            return FALSE;
+      }
+   }
+
+   /* The two triangles have different provoking vertices, so flat inputs
+    * must not vary at all.
+    */
+   for (i = 0; i < key->num_inputs; i++) {
+      const unsigned src = key->inputs[i].src_index;
+
+      if (key->inputs[i].cyl_wrap)
+         return FALSE;
+
+      if (key->inputs[i].interp == LP_INTERP_CONSTANT &&
+          (memcmp(v0[src], v1[src], sizeof v0[src]) ||
+           memcmp(v0[src], v2[src], sizeof v0[src]) ||
+           memcmp(v0[src], v3[src], sizeof v0[src])))
+         return FALSE;
+   }
+
+   calc_fixed_position(setup, &position, v0, v1, v2);
+   if (position.area == 0)
+      return FALSE;
+
+   if (lp_context->active_statistics_queries) {
+      lp_context->pipeline_statistics.c_primitives += 2;
+   }
+
+   /* The fourth corner shares its coordinates with its neighbours */
+   if (v0[0][0] == v1[0][0]) {
+      position.x[3] = position.x[2];
+      position.y[3] = position.y[0];
+   } else {
+      position.x[3] = position.x[0];
+      position.y[3] = position.y[2];
+   }
+
+   if (position.area > 0) {
+      if (setup->triangle == triangle_cw)
+         return TRUE;
+      front = setup->ccw_is_frontface;
+      for (i = 0; i < 4; i++) {
+         x[i] = position.x[i];
+         y[i] = position.y[i];
+      }
+   } else {
+      if (setup->triangle == triangle_ccw)
+         return TRUE;
+      front = !setup->ccw_is_frontface;
+      for (i = 0; i < 4; i++) {
+         x[i] = position.x[(4 - i) & 3];
+         y[i] = position.y[(4 - i) & 3];
+      }
+   }
+
+   if (!do_rect_ccw(setup, x, y, v0, v1, v2, front)) {
+      if (!lp_setup_flush_and_restart(setup))
+         return TRUE;
+
+      do_rect_ccw(setup, x, y, v0, v1, v2, front);
+   }
+
+   return TRUE;
+}
+
+
 void 
 lp_setup_choose_triangle(struct lp_setup_context *setup)
 {
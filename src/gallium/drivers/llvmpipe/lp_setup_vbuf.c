@@ -129,6 +129,47 @@ static inline const_float4_ptr get_vert( const void *vertex_buffer,
    return (const_float4_ptr)((char *)vertex_buffer + index * stride);
 }
 
+static inline boolean
+same_vert( const_float4_ptr a, const_float4_ptr b, int stride )
+{
+   return a == b || memcmp(a, b, stride) == 0;
+}
+
+/**
+ * Draw the triangles a b c and d e f as a single rectangle, if they share
+ * an edge and together form a screen-aligned rectangle.
+ */
+static boolean
+rect_from_tri_pair( struct lp_setup_context *setup, int stride,
+                    const_float4_ptr a, const_float4_ptr b, const_float4_ptr c,
+                    const_float4_ptr d, const_float4_ptr e, const_float4_ptr f )
+{
+   const_float4_ptr t0[3] = { a, b, c };
+   const_float4_ptr t1[3] = { d, e, f };
+   unsigned i, j;
+
+   /* Cheap reject for anything that isn't a right triangle with its legs
+    * along the axes.
+    */
+   if (!((a[0][0] == b[0][0] || b[0][0] == c[0][0] || c[0][0] == a[0][0]) &&
+         (a[0][1] == b[0][1] || b[0][1] == c[0][1] || c[0][1] == a[0][1])))
+      return FALSE;
+
+   /* With the same winding, the shared edge runs the opposite way in the
+    * second triangle, and its third vertex goes between the edge's ends.
+    */
+   for (i = 0; i < 3; i++) {
+      for (j = 0; j < 3; j++) {
+         if (same_vert(t0[i], t1[(j + 1) % 3], stride) &&
+             same_vert(t0[(i + 1) % 3], t1[j], stride))
+            return lp_setup_rect(setup, t0[i], t1[(j + 2) % 3],
+                                 t0[(i + 1) % 3], t0[(i + 2) % 3]);
+      }
+   }
+
+   return FALSE;
+}
+
 /**
  * draw elements / indexed primitives
  */
@@ -185,6 +226,17 @@ lp_setup_draw_elements(struct vbuf_render *vbr, const ushort *indices, uint nr)
 
    case PIPE_PRIM_TRIANGLES:
       for (i = 2; i < nr; i += 3) {
+         if (i + 3 < nr &&
+             rect_from_tri_pair( setup, stride,
+                                 get_vert(vertex_buffer, indices[i-2], stride),
+                                 get_vert(vertex_buffer, indices[i-1], stride),
+                                 get_vert(vertex_buffer, indices[i-0], stride),
+                                 get_vert(vertex_buffer, indices[i+1], stride),
+                                 get_vert(vertex_buffer, indices[i+2], stride),
+                                 get_vert(vertex_buffer, indices[i+3], stride) )) {
+            i += 3;
+            continue;
+         }
          setup->triangle( setup,
                           get_vert(vertex_buffer, indices[i-2], stride),
                           get_vert(vertex_buffer, indices[i-1], stride),
@@ -193,6 +245,14 @@ lp_setup_draw_elements(struct vbuf_render *vbr, const ushort *indices, uint nr)
       break;
 
    case PIPE_PRIM_TRIANGLE_STRIP:
+      if (nr == 4 &&
+          lp_setup_rect( setup,
+                         get_vert(vertex_buffer, indices[0], stride),
+                         get_vert(vertex_buffer, indices[1], stride),
+                         get_vert(vertex_buffer, indices[3], stride),
+                         get_vert(vertex_buffer, indices[2], stride) ))
+         break;
+
       if (flatshade_first) {
          for (i = 2; i < nr; i += 1) {
             /* emit first triangle vertex as first triangle vertex */
@@ -215,6 +275,14 @@ lp_setup_draw_elements(struct vbuf_render *vbr, const ushort *indices, uint nr)
       break;
 
    case PIPE_PRIM_TRIANGLE_FAN:
+      if (nr == 4 &&
+          lp_setup_rect( setup,
+                         get_vert(vertex_buffer, indices[0], stride),
+                         get_vert(vertex_buffer, indices[1], stride),
+                         get_vert(vertex_buffer, indices[2], stride),
+                         get_vert(vertex_buffer, indices[3], stride) ))
+         break;
+
       if (flatshade_first) {
          for (i = 2; i < nr; i += 1) {
             /* emit first non-spoke vertex as first vertex */
@@ -240,6 +308,13 @@ lp_setup_draw_elements(struct vbuf_render *vbr, const ushort *indices, uint nr)
       if (flatshade_first) { 
          /* emit last quad vertex as first triangle vertex */
          for (i = 3; i < nr; i += 4) {
+            if (lp_setup_rect( setup,
+                               get_vert(vertex_buffer, indices[i-3], stride),
+                               get_vert(vertex_buffer, indices[i-2], stride),
+                               get_vert(vertex_buffer, indices[i-1], stride),
+                               get_vert(vertex_buffer, indices[i-0], stride) ))
+               continue;
+
             setup->triangle( setup,
                              get_vert(vertex_buffer, indices[i-0], stride),
                              get_vert(vertex_buffer, indices[i-3], stride),
@@ -254,6 +329,13 @@ lp_setup_draw_elements(struct vbuf_render *vbr, const ushort *indices, uint nr)
       else {
          /* emit last quad vertex as last triangle vertex */
          for (i = 3; i < nr; i += 4) {
+            if (lp_setup_rect( setup,
+                               get_vert(vertex_buffer, indices[i-3], stride),
+                               get_vert(vertex_buffer, indices[i-2], stride),
+                               get_vert(vertex_buffer, indices[i-1], stride),
+                               get_vert(vertex_buffer, indices[i-0], stride) ))
+               continue;
+
             setup->triangle( setup,
                           get_vert(vertex_buffer, indices[i-3], stride),
                           get_vert(vertex_buffer, indices[i-2], stride),
@@ -383,6 +465,17 @@ lp_setup_draw_arrays(struct vbuf_render *vbr, uint start, uint nr)
 
    case PIPE_PRIM_TRIANGLES:
       for (i = 2; i < nr; i += 3) {
+         if (i + 3 < nr &&
+             rect_from_tri_pair( setup, stride,
+                                 get_vert(vertex_buffer, i-2, stride),
+                                 get_vert(vertex_buffer, i-1, stride),
+                                 get_vert(vertex_buffer, i-0, stride),
+                                 get_vert(vertex_buffer, i+1, stride),
+                                 get_vert(vertex_buffer, i+2, stride),
+                                 get_vert(vertex_buffer, i+3, stride) )) {
+            i += 3;
+            continue;
+         }
          setup->triangle( setup,
                           get_vert(vertex_buffer, i-2, stride),
                           get_vert(vertex_buffer, i-1, stride),
@@ -391,6 +484,14 @@ lp_setup_draw_arrays(struct vbuf_render *vbr, uint start, uint nr)
       break;
 
    case PIPE_PRIM_TRIANGLE_STRIP:
+      if (nr == 4 &&
+          lp_setup_rect( setup,
+                         get_vert(vertex_buffer, 0, stride),
+                         get_vert(vertex_buffer, 1, stride),
+                         get_vert(vertex_buffer, 3, stride),
+                         get_vert(vertex_buffer, 2, stride) ))
+         break;
+
       if (flatshade_first) {
          for (i = 2; i < nr; i++) {
             /* emit first triangle vertex as first triangle vertex */
@@ -412,6 +513,14 @@ lp_setup_draw_arrays(struct vbuf_render *vbr, uint start, uint nr)
       break;
 
    case PIPE_PRIM_TRIANGLE_FAN:
+      if (nr == 4 &&
+          lp_setup_rect( setup,
+                         get_vert(vertex_buffer, 0, stride),
+                         get_vert(vertex_buffer, 1, stride),
+                         get_vert(vertex_buffer, 2, stride),
+                         get_vert(vertex_buffer, 3, stride) ))
+         break;
+
       if (flatshade_first) {
          for (i = 2; i < nr; i += 1) {
             /* emit first non-spoke vertex as first vertex */
@@ -437,6 +546,13 @@ lp_setup_draw_arrays(struct vbuf_render *vbr, uint start, uint nr)
       if (flatshade_first) { 
          /* emit last quad vertex as first triangle vertex */
          for (i = 3; i < nr; i += 4) {
+            if (lp_setup_rect( setup,
+                               get_vert(vertex_buffer, i-3, stride),
+                               get_vert(vertex_buffer, i-2, stride),
+                               get_vert(vertex_buffer, i-1, stride),
+                               get_vert(vertex_buffer, i-0, stride) ))
+               continue;
+
             setup->triangle( setup,
                              get_vert(vertex_buffer, i-0, stride),
                              get_vert(vertex_buffer, i-3, stride),
@@ -450,6 +566,13 @@ lp_setup_draw_arrays(struct vbuf_render *vbr, uint start, uint nr)
       else {
          /* emit last quad vertex as last triangle vertex */
          for (i = 3; i < nr; i += 4) {
+            if (lp_setup_rect( setup,
+                               get_vert(vertex_buffer, i-3, stride),
+                               get_vert(vertex_buffer, i-2, stride),
+                               get_vert(vertex_buffer, i-1, stride),
+                               get_vert(vertex_buffer, i-0, stride) ))
+               continue;
+
             setup->triangle( setup,
                              get_vert(vertex_buffer, i-3, stride),
                              get_vert(vertex_buffer, i-2, stride),
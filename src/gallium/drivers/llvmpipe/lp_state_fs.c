@@ -68,6 +68,7 @@
 #include "util/simple_list.h"
 #include "util/u_dual_blend.h"
 #include "util/os_time.h"
+#include "util/mesa-sha1.h"
 #include "pipe/p_shader_tokens.h"
 #include "draw/draw_context.h"
 #include "tgsi/tgsi_dump.h"
@@ -94,6 +95,7 @@
 #include "lp_bld_depth.h"
 #include "lp_bld_interp.h"
 #include "lp_context.h"
+#include "lp_screen.h"
 #include "lp_debug.h"
 #include "lp_perf.h"
 #include "lp_setup.h"
@@ -113,7 +115,7 @@ static unsigned fs_no = 0;
  * n*four pixels in n 2x2 quads.  This will set the n*four elements of the
  * quad mask vector to 0 or ~0.
  * Grouping is 01, 23 for 2 quad mode hence only 0 and 2 are valid
- * quad arguments with fs length 8.
+ * quad arguments with fs length 8, and only 0 with fs length 16.
  *
  * \param first_quad  which quad(s) of the quad group to test, in [0,3]
  * \param mask_input  bitwise mask for the whole 4x4 stamp
@@ -150,6 +152,7 @@ generate_quad_mask(struct gallivm_state *gallivm,
       shift = 2;
       break;
    case 2:
+      assert(fs_type.length <= 8);
       shift = 8;
       break;
    case 3:
@@ -1819,7 +1822,9 @@ generate_unswizzled_blend(struct gallivm_state *gallivm,
    undef_src_val = lp_build_undef(gallivm, fs_type);
 
    row_type.length = fs_type.length;
-   vector_width    = dst_type.floating ? lp_native_vector_width : lp_integer_vector_width;
+   /* fs_type is at most 8 wide here, see generate_fragment */
+   vector_width    = dst_type.floating ? MIN2(lp_native_vector_width, 256) :
+                                         lp_integer_vector_width;
 
    /* Compute correct swizzle and count channels */
    memset(swizzle, LP_BLD_SWIZZLE_DONTCARE, TGSI_NUM_CHANNELS);
@@ -2397,8 +2402,7 @@ generate_unswizzled_blend(struct gallivm_state *gallivm,
  * 2x2 pixels.
  */
 static void
-generate_fragment(struct llvmpipe_context *lp,
-                  struct lp_fragment_shader *shader,
+generate_fragment(struct lp_fragment_shader *shader,
                   struct lp_fragment_shader_variant *variant,
                   unsigned partial_mask)
 {
@@ -2434,7 +2438,8 @@ generate_fragment(struct llvmpipe_context *lp,
    LLVMValueRef fs_out_color[PIPE_MAX_COLOR_BUFS][TGSI_NUM_CHANNELS][16 / 4];
    LLVMValueRef function;
    LLVMValueRef facing;
-   unsigned num_fs;
+   struct lp_type blend_fs_type;
+   unsigned num_fs, num_blend_fs;
    unsigned i;
    unsigned chan;
    unsigned cbuf;
@@ -2469,6 +2474,9 @@ generate_fragment(struct llvmpipe_context *lp,
    fs_type.norm = FALSE;         /* values are not limited to [0,1] or [-1,1] */
    fs_type.width = 32;           /* 32-bit float */
    fs_type.length = MIN2(lp_native_vector_width / 32, 16); /* n*4 elements per vector */
+   /* 1d resources only run the upper half of the stamp */
+   if (key->resource_1d)
+      fs_type.length = MIN2(fs_type.length, 8);
 
    memset(&blend_type, 0, sizeof blend_type);
    blend_type.floating = FALSE; /* values are integers */
@@ -2486,8 +2494,12 @@ generate_fragment(struct llvmpipe_context *lp,
 
    blend_vec_type = lp_build_vec_type(gallivm, blend_type);
 
-   util_snprintf(func_name, sizeof(func_name), "fs%u_variant%u_%s",
-                 shader->no, variant->no, partial_mask ? "partial" : "whole");
+   /*
+    * The name must not depend on the shader or variant counters, as it is
+    * looked up again when the object code comes from the disk cache.
+    */
+   util_snprintf(func_name, sizeof(func_name), "fs_variant_%s",
+                 partial_mask ? "partial" : "whole");
 
    arg_types[0] = variant->jit_context_ptr_type;       /* context */
    arg_types[1] = int32_type;                          /* x */
@@ -2664,6 +2676,40 @@ generate_fragment(struct llvmpipe_context *lp,
 
    sampler->destroy(sampler);
 
+   /*
+    * Blending (the fs twiddle in particular) only knows how to deal with
+    * 4 and 8 wide vectors, so hand it a 16-wide stamp as two 8-wide halves,
+    * which is the same layout the 8-wide shader would have produced.
+    */
+   blend_fs_type = fs_type;
+   num_blend_fs = num_fs;
+   if (fs_type.length == 16) {
+      LLVMTypeRef half_ptr_type;
+      LLVMValueRef index1 = lp_build_const_int32(gallivm, 1);
+      /* dual source blending uses fs_out_color[1] with a single cbuf */
+      unsigned num_out = key->nr_cbufs;
+      if (dual_source_blend && num_out)
+         num_out = 2;
+
+      assert(num_fs == 1);
+      blend_fs_type.length = 8;
+      num_blend_fs = 2;
+      half_ptr_type = LLVMPointerType(lp_build_vec_type(gallivm, blend_fs_type), 0);
+
+      fs_mask[1] = lp_build_extract_range(gallivm, fs_mask[0], 8, 8);
+      fs_mask[0] = lp_build_extract_range(gallivm, fs_mask[0], 0, 8);
+      for (cbuf = 0; cbuf < num_out; cbuf++) {
+         for (chan = 0; chan < TGSI_NUM_CHANNELS; ++chan) {
+            LLVMValueRef ptr = LLVMBuildBitCast(builder,
+                                                fs_out_color[cbuf][chan][0],
+                                                half_ptr_type, "");
+            fs_out_color[cbuf][chan][0] = ptr;
+            fs_out_color[cbuf][chan][1] = LLVMBuildGEP(builder, ptr,
+                                                       &index1, 1, "");
+         }
+      }
+   }
+
    /* Loop over color outputs / color buffers to do blending.
     */
    for(cbuf = 0; cbuf < key->nr_cbufs; cbuf++) {
@@ -2690,7 +2736,8 @@ generate_fragment(struct llvmpipe_context *lp,
 
          generate_unswizzled_blend(gallivm, cbuf, variant,
                                    key->cbuf_format[cbuf],
-                                   num_fs, fs_type, fs_mask, fs_out_color,
+                                   num_blend_fs, blend_fs_type,
+                                   fs_mask, fs_out_color,
                                    context_ptr, color_ptr, stride,
                                    partial_mask, do_branch);
       }
@@ -2803,10 +2850,116 @@ lp_debug_fs_variant(const struct lp_fragment_shader_variant *variant)
    tgsi_dump(variant->shader->base.tokens, 0);
    dump_fs_variant_key(&variant->key);
    debug_printf("variant->opaque = %u\n", variant->opaque);
+   debug_printf("variant->blit = %u\n", variant->blit);
+   debug_printf("variant->hiz = %u\n", variant->hiz);
    debug_printf("\n");
 }
 
 
+/**
+ * Generate the LLVM IR of a variant and compile it with variant->gallivm.
+ * Doesn't touch any context state, so it may run on any thread as long as
+ * variant->gallivm has its own LLVM context.
+ */
+static void
+compile_variant(struct lp_fragment_shader *shader,
+                struct lp_fragment_shader_variant *variant)
+{
+   lp_jit_init_types(variant);
+
+   if (variant->jit_function[RAST_EDGE_TEST] == NULL)
+      generate_fragment(shader, variant, RAST_EDGE_TEST);
+
+   if (variant->jit_function[RAST_WHOLE] == NULL) {
+      if (variant->opaque) {
+         /* Specialized shader, which doesn't need to read the color buffer. */
+         generate_fragment(shader, variant, RAST_WHOLE);
+      }
+   }
+
+   /*
+    * Compile everything
+    */
+
+   gallivm_compile_module(variant->gallivm);
+
+   variant->nr_instrs += lp_build_count_ir_module(variant->gallivm->module);
+
+   if (variant->function[RAST_EDGE_TEST]) {
+      variant->jit_function[RAST_EDGE_TEST] = (lp_jit_frag_func)
+            gallivm_jit_function(variant->gallivm,
+                                 variant->function[RAST_EDGE_TEST]);
+   }
+
+   if (variant->function[RAST_WHOLE]) {
+         variant->jit_function[RAST_WHOLE] = (lp_jit_frag_func)
+               gallivm_jit_function(variant->gallivm,
+                                    variant->function[RAST_WHOLE]);
+   } else if (!variant->jit_function[RAST_WHOLE]) {
+      variant->jit_function[RAST_WHOLE] = variant->jit_function[RAST_EDGE_TEST];
+   }
+
+   gallivm_free_ir(variant->gallivm);
+}
+
+
+/**
+ * util_queue job compiling the optimized code of a variant, which is bound
+ * with its unoptimized code meanwhile.
+ *
+ * The work happens on a scratch copy of the variant, in a private LLVM
+ * context.  The optimized functions then replace the unoptimized ones; as
+ * both are equivalent, scenes already binned may use either.  The
+ * unoptimized code is kept around until the variant is destroyed.
+ */
+static void
+generate_variant_async(void *data, int thread_index)
+{
+   struct lp_fragment_shader_variant *variant = data;
+   struct lp_fragment_shader *shader = variant->shader;
+   struct lp_fragment_shader_variant *opt;
+   struct lp_cached_code cached = { 0 };
+   LLVMContextRef context;
+   char module_name[64];
+
+   opt = CALLOC_STRUCT(lp_fragment_shader_variant);
+   if (!opt)
+      return;
+
+   context = LLVMContextCreate();
+   if (!context) {
+      FREE(opt);
+      return;
+   }
+
+   util_snprintf(module_name, sizeof(module_name), "fs%u_variant%u_opt",
+                 shader->no, variant->no);
+
+   opt->gallivm = gallivm_create(module_name, context, &cached);
+   if (opt->gallivm) {
+      memcpy(&opt->key, &variant->key, shader->variant_key_size);
+      opt->shader = shader;
+      opt->opaque = variant->opaque;
+      opt->no = variant->no;
+
+      compile_variant(shader, opt);
+
+      lp_disk_cache_insert_shader(variant->screen, &cached,
+                                  variant->ir_sha1_cache_key);
+
+      variant->async_gallivm = opt->gallivm;
+      p_atomic_set(&variant->jit_function[RAST_EDGE_TEST],
+                   opt->jit_function[RAST_EDGE_TEST]);
+      p_atomic_set(&variant->jit_function[RAST_WHOLE],
+                   opt->jit_function[RAST_WHOLE]);
+   }
+
+   free(cached.data);
+   LLVMContextDispose(context);
+   FREE(opt);
+}
+
+
 /**
  * Generate a new fragment shader variant from the shader code and
  * other state indicated by the key.
@@ -2820,6 +2973,11 @@ generate_variant(struct llvmpipe_context *lp,
    const struct util_format_description *cbuf0_format_desc = NULL;
    boolean fullcolormask;
    char module_name[64];
+   unsigned char ir_sha1_cache_key[20];
+   struct lp_cached_code cached = { 0 };
+   bool needs_caching = false;
+   struct llvmpipe_screen *screen = llvmpipe_screen(lp->pipe.screen);
+   boolean async;
 
    variant = CALLOC_STRUCT(lp_fragment_shader_variant);
    if (!variant)
@@ -2828,12 +2986,39 @@ generate_variant(struct llvmpipe_context *lp,
    util_snprintf(module_name, sizeof(module_name), "fs%u_variant%u",
                  shader->no, shader->variants_created);
 
-   variant->gallivm = gallivm_create(module_name, lp->context);
+   if (shader->base.tokens) {
+      /* Hash the shader tokens along with the variant key */
+      struct mesa_sha1 ctx;
+      _mesa_sha1_init(&ctx);
+      _mesa_sha1_update(&ctx, key, shader->variant_key_size);
+      _mesa_sha1_update(&ctx, shader->base.tokens,
+                        tgsi_num_tokens(shader->base.tokens) *
+                        sizeof(struct tgsi_token));
+      _mesa_sha1_final(&ctx, ir_sha1_cache_key);
+
+      lp_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
+      needs_caching = !cached.data_size;
+   }
+
+   /*
+    * Unless the object code comes from the disk cache, just do a quick,
+    * unoptimized compile now when the optimized code can be compiled in the
+    * background.
+    */
+   async = util_queue_is_initialized(&screen->fs_compile_queue) &&
+           !cached.data_size;
+   if (async)
+      variant->gallivm = gallivm_create_no_opt(module_name, lp->context);
+   else
+      variant->gallivm = gallivm_create(module_name, lp->context, &cached);
    if (!variant->gallivm) {
+      free(cached.data);
       FREE(variant);
       return NULL;
    }
 
+   util_queue_fence_init(&variant->async_fence);
+
    variant->shader = shader;
    variant->list_item_global.base = variant;
    variant->list_item_local.base = variant;
@@ -2862,47 +3047,129 @@ generate_variant(struct llvmpipe_context *lp,
          !shader->info.base.writes_samplemask
       ? TRUE : FALSE;
 
+   /*
+    * Fully covered tiles of a blit may be copied directly from the
+    * texture, which is only equivalent if sampling and writing the
+    * color buffer don't change the texels.
+    */
+   variant->blit =
+         shader->blit &&
+         variant->opaque &&
+         !key->occlusion_count &&
+         key->state[0].texture_state.format == key->cbuf_format[0] &&
+         key->state[0].texture_state.target == PIPE_TEXTURE_2D &&
+         !key->state[0].texture_state.tiled &&
+         key->state[0].texture_state.swizzle_r == PIPE_SWIZZLE_X &&
+         key->state[0].texture_state.swizzle_g == PIPE_SWIZZLE_Y &&
+         key->state[0].texture_state.swizzle_b == PIPE_SWIZZLE_Z &&
+         key->state[0].texture_state.swizzle_a == PIPE_SWIZZLE_W &&
+         key->state[0].sampler_state.min_img_filter == PIPE_TEX_FILTER_NEAREST &&
+         key->state[0].sampler_state.mag_img_filter == PIPE_TEX_FILTER_NEAREST &&
+         key->state[0].sampler_state.normalized_coords &&
+         !key->state[0].sampler_state.compare_mode &&
+         !key->state[0].sampler_state.lod_bias_non_zero &&
+         !key->state[0].sampler_state.apply_min_lod
+      ? TRUE : FALSE;
+
+   /*
+    * Skipping fragments which fail the depth test is only invisible if
+    * the test is the only thing they'd change (no stencil ops), and if
+    * their depth is the interpolated one.  The coarse depth only tracks
+    * upper bounds, hence just LESS and LEQUAL.
+    */
+   variant->hiz =
+         key->depth.enabled &&
+         (key->depth.func == PIPE_FUNC_LESS ||
+          key->depth.func == PIPE_FUNC_LEQUAL) &&
+         !key->stencil[0].enabled &&
+         !key->depth_clamp &&
+         !shader->info.base.writes_z
+      ? TRUE : FALSE;
+
    if ((LP_DEBUG & DEBUG_FS) || (gallivm_debug & GALLIVM_DEBUG_IR)) {
       lp_debug_fs_variant(variant);
    }
 
-   lp_jit_init_types(variant);
-   
-   if (variant->jit_function[RAST_EDGE_TEST] == NULL)
-      generate_fragment(lp, shader, variant, RAST_EDGE_TEST);
+   compile_variant(shader, variant);
 
-   if (variant->jit_function[RAST_WHOLE] == NULL) {
-      if (variant->opaque) {
-         /* Specialized shader, which doesn't need to read the color buffer. */
-         generate_fragment(lp, shader, variant, RAST_WHOLE);
-      }
+   if (async) {
+      /* Bound to the unoptimized code until the optimized one replaces it */
+      variant->screen = screen;
+      memcpy(variant->ir_sha1_cache_key, ir_sha1_cache_key,
+             sizeof(variant->ir_sha1_cache_key));
+      util_queue_add_job(&screen->fs_compile_queue, variant,
+                         &variant->async_fence,
+                         generate_variant_async, NULL);
+   }
+   else if (needs_caching) {
+      lp_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
    }
 
-   /*
-    * Compile everything
-    */
+   free(cached.data);
 
-   gallivm_compile_module(variant->gallivm);
+   return variant;
+}
 
-   variant->nr_instrs += lp_build_count_ir_module(variant->gallivm->module);
 
-   if (variant->function[RAST_EDGE_TEST]) {
-      variant->jit_function[RAST_EDGE_TEST] = (lp_jit_frag_func)
-            gallivm_jit_function(variant->gallivm,
-                                 variant->function[RAST_EDGE_TEST]);
+/**
+ * Detect shaders which do nothing but sample 2D texture 0 at an
+ * interpolated coordinate and write the result to color buffer 0,
+ * as used by blits and 2D compositors.
+ */
+static boolean
+is_blit_shader(const struct lp_fragment_shader *shader)
+{
+   const struct lp_tgsi_info *info = &shader->info;
+   const struct lp_tgsi_texture_info *tex = &info->tex[0];
+   struct tgsi_parse_context parse;
+   boolean blit = FALSE;
+
+   /* TEX + END */
+   if (info->base.num_instructions != 2 ||
+       info->base.opcode_count[TGSI_OPCODE_TEX] != 1 ||
+       info->base.num_outputs != 1 ||
+       info->base.output_semantic_name[0] != TGSI_SEMANTIC_COLOR ||
+       info->base.output_semantic_index[0] != 0 ||
+       info->num_texs != 1 ||
+       info->indirect_textures ||
+       tex->target != TGSI_TEXTURE_2D ||
+       tex->sampler_unit != 0 ||
+       tex->texture_unit != 0 ||
+       tex->coord[0].file != TGSI_FILE_INPUT ||
+       tex->coord[1].file != TGSI_FILE_INPUT ||
+       tex->coord[0].u.index != tex->coord[1].u.index ||
+       tex->coord[0].swizzle != PIPE_SWIZZLE_X ||
+       tex->coord[1].swizzle != PIPE_SWIZZLE_Y)
+      return FALSE;
+
+   switch (shader->inputs[tex->coord[0].u.index].interp) {
+   case LP_INTERP_LINEAR:
+   case LP_INTERP_PERSPECTIVE:
+      break;
+   default:
+      return FALSE;
    }
 
-   if (variant->function[RAST_WHOLE]) {
-         variant->jit_function[RAST_WHOLE] = (lp_jit_frag_func)
-               gallivm_jit_function(variant->gallivm,
-                                    variant->function[RAST_WHOLE]);
-   } else if (!variant->jit_function[RAST_WHOLE]) {
-      variant->jit_function[RAST_WHOLE] = variant->jit_function[RAST_EDGE_TEST];
-   }
+   /* The texel must go straight to the output */
+   tgsi_parse_init(&parse, shader->base.tokens);
+   while (!tgsi_parse_end_of_tokens(&parse)) {
+      const struct tgsi_full_instruction *inst;
 
-   gallivm_free_ir(variant->gallivm);
+      tgsi_parse_token(&parse);
+      if (parse.FullToken.Token.Type != TGSI_TOKEN_TYPE_INSTRUCTION)
+         continue;
 
-   return variant;
+      inst = &parse.FullToken.FullInstruction;
+      if (inst->Instruction.Opcode == TGSI_OPCODE_TEX) {
+         blit = !inst->Instruction.Saturate &&
+                inst->Dst[0].Register.File == TGSI_FILE_OUTPUT &&
+                !inst->Dst[0].Register.Indirect &&
+                inst->Dst[0].Register.WriteMask == TGSI_WRITEMASK_XYZW;
+      }
+   }
+   tgsi_parse_free(&parse);
+
+   return blit;
 }
 
 
@@ -2980,6 +3247,9 @@ llvmpipe_create_fs_state(struct pipe_context *pipe,
       shader->inputs[i].src_index = i+1;
    }
 
+   shader->blit = is_blit_shader(shader);
+   shader->blit_input = shader->info.tex[0].coord[0].u.index;
+
    if (LP_DEBUG & DEBUG_TGSI) {
       unsigned attrib;
       debug_printf("llvmpipe: Create fragment shader #%u %p:\n",
@@ -3036,7 +3306,14 @@ llvmpipe_remove_shader_variant(struct llvmpipe_context *lp,
                    lp->nr_fs_variants, variant->nr_instrs, lp->nr_fs_instrs);
    }
 
+   /* Wait for, or cancel, the compilation of the optimized code */
+   util_queue_drop_job(&llvmpipe_screen(lp->pipe.screen)->fs_compile_queue,
+                       &variant->async_fence);
+   util_queue_fence_destroy(&variant->async_fence);
+
    gallivm_destroy(variant->gallivm);
+   if (variant->async_gallivm)
+      gallivm_destroy(variant->async_gallivm);
 
    /* remove from shader's list */
    remove_from_list(&variant->list_item_local);
@@ -32,6 +32,7 @@
 
 #include "pipe/p_compiler.h"
 #include "pipe/p_state.h"
+#include "util/u_queue.h"
 #include "tgsi/tgsi_scan.h" /* for tgsi_shader_info */
 #include "gallivm/lp_bld_sample.h" /* for struct lp_sampler_static_state */
 #include "gallivm/lp_bld_tgsi.h" /* for lp_tgsi_info */
@@ -40,6 +41,7 @@
 
 struct tgsi_token;
 struct lp_fragment_shader;
+struct llvmpipe_screen;
 
 
 /** Indexes into jit_function[] array */
@@ -99,6 +101,16 @@ struct lp_fragment_shader_variant
 
    boolean opaque;
 
+   /* Fully covered tiles can be copied from the texture, see
+    * lp_rast_blit_tile().
+    */
+   boolean blit;
+
+   /* Triangles entirely behind the depth buffer may be skipped, see
+    * lp_rast_hiz_cull().
+    */
+   boolean hiz;
+
    struct gallivm_state *gallivm;
 
    LLVMTypeRef jit_context_ptr_type;
@@ -117,6 +129,16 @@ struct lp_fragment_shader_variant
 
    /* For debugging/profiling purposes */
    unsigned no;
+
+   /*
+    * Background compilation of the optimized code, when the variant was
+    * first compiled without optimizations.  async_gallivm holds the
+    * optimized code once async_fence is signalled.
+    */
+   struct util_queue_fence async_fence;
+   struct gallivm_state *async_gallivm;
+   struct llvmpipe_screen *screen;
+   unsigned char ir_sha1_cache_key[20];
 };
 
 
@@ -139,6 +161,12 @@ struct lp_fragment_shader
 
    /** Fragment shader input interpolation info */
    struct lp_shader_input inputs[PIPE_MAX_SHADER_INPUTS];
+
+   /* The shader only samples texture 0 at IN[blit_input].xy and writes
+    * the result to color buffer 0.
+    */
+   boolean blit;
+   unsigned blit_input;
 };
 
 
@@ -42,11 +42,13 @@
 #include "util/u_memory.h"
 #include "util/simple_list.h"
 #include "util/u_transfer.h"
+#include "gallivm/lp_bld_sample.h"
 
 #include "lp_context.h"
 #include "lp_flush.h"
 #include "lp_screen.h"
 #include "lp_texture.h"
+#include "lp_debug.h"
 #include "lp_setup.h"
 #include "lp_state.h"
 #include "lp_rast.h"
@@ -60,6 +62,46 @@ static struct llvmpipe_resource resource_list;
 static unsigned id_counter = 0;
 
 
+/**
+ * Whether the texture can use the tiled layout described in lp_bld_sample.h.
+ * That's only worth it, and only safe, for textures which are never
+ * accessed other than by the samplers and through transfers.
+ */
+static boolean
+llvmpipe_texture_can_tile(const struct pipe_resource *pt)
+{
+   const struct util_format_description *desc =
+      util_format_description(pt->format);
+   unsigned block_size;
+
+   if (LP_PERF & PERF_NO_TILED_TEX)
+      return FALSE;
+
+   if (pt->bind != PIPE_BIND_SAMPLER_VIEW ||
+       pt->nr_samples > 1)
+      return FALSE;
+
+   switch (pt->target) {
+   case PIPE_TEXTURE_2D:
+   case PIPE_TEXTURE_2D_ARRAY:
+   case PIPE_TEXTURE_RECT:
+   case PIPE_TEXTURE_3D:
+   case PIPE_TEXTURE_CUBE:
+   case PIPE_TEXTURE_CUBE_ARRAY:
+      break;
+   default:
+      return FALSE;
+   }
+
+   if (!desc || desc->block.width != 1 || desc->block.height != 1)
+      return FALSE;
+
+   block_size = desc->block.bits / 8;
+   return util_is_power_of_two_nonzero(block_size) &&
+          block_size <= LP_TEXTURE_TILE_WIDTH;
+}
+
+
 /**
  * Conventional allocation path for non-display textures:
  * Compute strides and allocate data (unless asked not to).
@@ -112,6 +154,9 @@ llvmpipe_texture_layout(struct llvmpipe_screen *screen,
             align_y = LP_RASTER_BLOCK_SIZE;
       }
 
+      if (pt->flags & LP_RESOURCE_FLAG_TILED)
+         align_y = MAX2(align_y, LP_TEXTURE_TILE_HEIGHT);
+
       nblocksx = util_format_get_nblocksx(pt->format,
                                           align(width, align_x));
       nblocksy = util_format_get_nblocksy(pt->format,
@@ -123,6 +168,10 @@ llvmpipe_texture_layout(struct llvmpipe_screen *screen,
       else
          lpr->row_stride[level] = align(nblocksx * block_size, util_cpu_caps.cacheline);
 
+      if (pt->flags & LP_RESOURCE_FLAG_TILED)
+         lpr->row_stride[level] = align(lpr->row_stride[level],
+                                        LP_TEXTURE_TILE_WIDTH);
+
       /* if row_stride * height > LP_MAX_TEXTURE_SIZE */
       if ((uint64_t)lpr->row_stride[level] * nblocksy > LP_MAX_TEXTURE_SIZE) {
          /* image too large */
@@ -247,6 +296,7 @@ llvmpipe_resource_create_front(struct pipe_screen *_screen,
       return NULL;
 
    lpr->base = *templat;
+   lpr->base.flags &= ~LP_RESOURCE_FLAG_TILED;
    pipe_reference_init(&lpr->base.reference, 1);
    lpr->base.screen = &screen->base;
 
@@ -262,6 +312,9 @@ llvmpipe_resource_create_front(struct pipe_screen *_screen,
       }
       else {
          /* texture map */
+         if (llvmpipe_texture_can_tile(&lpr->base))
+            lpr->base.flags |= LP_RESOURCE_FLAG_TILED;
+
          if (!llvmpipe_texture_layout(screen, lpr, true))
             goto fail;
       }
@@ -313,6 +366,62 @@ llvmpipe_resource_create(struct pipe_screen *_screen,
 }
 
 
+/**
+ * Wrap caller-provided memory as a single-level 2D texture.
+ *
+ * The memory has to use exactly the layout llvmpipe_texture_layout() picks,
+ * callers can check the stride and address with a transfer map.  Render
+ * targets are written in whole LP_RASTER_BLOCK_SIZE blocks, so their size
+ * has to be a multiple of that, or the padding would end up outside the
+ * caller's memory.
+ */
+static struct pipe_resource *
+llvmpipe_resource_from_user_memory(struct pipe_screen *_screen,
+                                   const struct pipe_resource *templat,
+                                   void *user_memory)
+{
+   struct llvmpipe_screen *screen = llvmpipe_screen(_screen);
+   struct llvmpipe_resource *lpr;
+
+   if ((templat->target != PIPE_TEXTURE_2D &&
+        templat->target != PIPE_TEXTURE_RECT) ||
+       templat->last_level != 0 ||
+       templat->depth0 != 1 ||
+       templat->array_size != 1 ||
+       util_format_is_compressed(templat->format))
+      return NULL;
+
+   if ((templat->bind & (PIPE_BIND_RENDER_TARGET | PIPE_BIND_DEPTH_STENCIL)) &&
+       (templat->width0 % LP_RASTER_BLOCK_SIZE ||
+        templat->height0 % LP_RASTER_BLOCK_SIZE))
+      return NULL;
+
+   lpr = CALLOC_STRUCT(llvmpipe_resource);
+   if (!lpr)
+      return NULL;
+
+   lpr->base = *templat;
+   lpr->base.flags &= ~LP_RESOURCE_FLAG_TILED;
+   pipe_reference_init(&lpr->base.reference, 1);
+   lpr->base.screen = &screen->base;
+
+   if (!llvmpipe_texture_layout(screen, lpr, FALSE)) {
+      FREE(lpr);
+      return NULL;
+   }
+
+   lpr->tex_data = user_memory;
+   lpr->userBuffer = TRUE;
+   lpr->id = id_counter++;
+
+#ifdef DEBUG
+   insert_at_tail(&resource_list, lpr);
+#endif
+
+   return &lpr->base;
+}
+
+
 static void
 llvmpipe_resource_destroy(struct pipe_screen *pscreen,
                           struct pipe_resource *pt)
@@ -327,7 +436,7 @@ llvmpipe_resource_destroy(struct pipe_screen *pscreen,
    }
    else if (llvmpipe_resource_is_texture(pt)) {
       /* free linear image data */
-      if (lpr->tex_data) {
+      if (lpr->tex_data && !lpr->userBuffer) {
          align_free(lpr->tex_data);
          lpr->tex_data = NULL;
       }
@@ -451,6 +560,7 @@ llvmpipe_resource_from_handle(struct pipe_screen *screen,
    }
 
    lpr->base = *template;
+   lpr->base.flags &= ~LP_RESOURCE_FLAG_TILED;
    pipe_reference_init(&lpr->base.reference, 1);
    lpr->base.screen = screen;
 
@@ -504,6 +614,57 @@ llvmpipe_resource_get_handle(struct pipe_screen *screen,
 }
 
 
+/**
+ * Copy a box of a texture using the tiled layout from or to linear memory.
+ */
+static void
+llvmpipe_tiled_copy_box(struct llvmpipe_resource *lpr,
+                        unsigned level,
+                        const struct pipe_box *box,
+                        ubyte *linear,
+                        unsigned linear_stride,
+                        unsigned linear_layer_stride,
+                        boolean to_tiled)
+{
+   const unsigned block_size = util_format_get_blocksize(lpr->base.format);
+   const unsigned row_stride = lpr->row_stride[level];
+   unsigned x, y, z;
+
+   for (z = 0; z < box->depth; z++) {
+      ubyte *image = llvmpipe_get_texture_image_address(lpr, box->z + z,
+                                                        level);
+
+      for (y = 0; y < box->height; y++) {
+         unsigned row = box->y + y;
+         ubyte *tiled_row = image +
+            row / LP_TEXTURE_TILE_HEIGHT * row_stride * LP_TEXTURE_TILE_HEIGHT +
+            row % LP_TEXTURE_TILE_HEIGHT * LP_TEXTURE_TILE_WIDTH;
+         ubyte *linear_row = linear + z * linear_layer_stride +
+                             y * linear_stride;
+         unsigned end = (box->x + box->width) * block_size;
+
+         /* Texels never straddle tiles, copy a tile's worth at a time */
+         for (x = box->x * block_size; x < end; ) {
+            unsigned n = MIN2(LP_TEXTURE_TILE_WIDTH - x % LP_TEXTURE_TILE_WIDTH,
+                              end - x);
+            ubyte *tiled = tiled_row +
+               x / LP_TEXTURE_TILE_WIDTH *
+                  LP_TEXTURE_TILE_WIDTH * LP_TEXTURE_TILE_HEIGHT +
+               x % LP_TEXTURE_TILE_WIDTH;
+
+            if (to_tiled)
+               memcpy(tiled, linear_row, n);
+            else
+               memcpy(linear_row, tiled, n);
+
+            linear_row += n;
+            x += n;
+         }
+      }
+   }
+}
+
+
 static void *
 llvmpipe_transfer_map( struct pipe_context *pipe,
                        struct pipe_resource *resource,
@@ -596,6 +757,39 @@ llvmpipe_transfer_map( struct pipe_context *pipe,
 
    format = lpr->base.format;
 
+   if (lpr->base.flags & LP_RESOURCE_FLAG_TILED) {
+      /*
+       * Hand out a linear copy of the box, which gets written back on
+       * unmap.
+       */
+      if (usage & PIPE_TRANSFER_MAP_DIRECTLY) {
+         pipe_resource_reference(&pt->resource, NULL);
+         FREE(lpt);
+         return NULL;
+      }
+
+      pt->stride = box->width * util_format_get_blocksize(format);
+      pt->layer_stride = pt->stride * box->height;
+
+      lpt->staging = MALLOC(pt->layer_stride * box->depth);
+      if (!lpt->staging) {
+         pipe_resource_reference(&pt->resource, NULL);
+         FREE(lpt);
+         return NULL;
+      }
+
+      if (!(usage & (PIPE_TRANSFER_DISCARD_RANGE |
+                     PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE))) {
+         llvmpipe_tiled_copy_box(lpr, level, box, lpt->staging,
+                                 pt->stride, pt->layer_stride, FALSE);
+      }
+
+      if (usage & PIPE_TRANSFER_WRITE)
+         screen->timestamp++;
+
+      return lpt->staging;
+   }
+
    map = llvmpipe_resource_map(resource,
                                level,
                                box->z,
@@ -623,8 +817,20 @@ static void
 llvmpipe_transfer_unmap(struct pipe_context *pipe,
                         struct pipe_transfer *transfer)
 {
+   struct llvmpipe_transfer *lpt = llvmpipe_transfer(transfer);
+
    assert(transfer->resource);
 
+   if (lpt->staging) {
+      if (transfer->usage & PIPE_TRANSFER_WRITE) {
+         llvmpipe_tiled_copy_box(llvmpipe_resource(transfer->resource),
+                                 transfer->level, &transfer->box,
+                                 lpt->staging, transfer->stride,
+                                 transfer->layer_stride, TRUE);
+      }
+      FREE(lpt->staging);
+   }
+
    llvmpipe_resource_unmap(transfer->resource,
                            transfer->level,
                            transfer->box.z);
@@ -808,6 +1014,7 @@ llvmpipe_init_screen_resource_funcs(struct pipe_screen *screen)
 /*   screen->resource_create_front = llvmpipe_resource_create_front; */
    screen->resource_destroy = llvmpipe_resource_destroy;
    screen->resource_from_handle = llvmpipe_resource_from_handle;
+   screen->resource_from_user_memory = llvmpipe_resource_from_user_memory;
    screen->resource_get_handle = llvmpipe_resource_get_handle;
    screen->can_create_resource = llvmpipe_can_create_resource;
 }
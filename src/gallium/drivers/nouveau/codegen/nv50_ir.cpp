@@ -1208,6 +1208,8 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info)
    int ret = 0;
 
    nv50_ir::Program::Type type;
+   nv50_ir::ScopeTimer timer(info->dbgFlags & NV50_IR_DEBUG_TIMING,
+                             "nv50_ir_generate_code");
 
    nv50_ir_init_prog_info(info);
 
@@ -1241,12 +1243,18 @@ nv50_ir_generate_code(struct nv50_ir_prog_info *info)
    prog->optLevel = info->optLevel;
 
    switch (info->bin.sourceRep) {
-   case PIPE_SHADER_IR_NIR:
+   case PIPE_SHADER_IR_NIR: {
+      nv50_ir::ScopeTimer timer(prog->dbgFlags & NV50_IR_DEBUG_TIMING,
+                                "makeFromNIR");
       ret = prog->makeFromNIR(info) ? 0 : -2;
       break;
-   case PIPE_SHADER_IR_TGSI:
+   }
+   case PIPE_SHADER_IR_TGSI: {
+      nv50_ir::ScopeTimer timer(prog->dbgFlags & NV50_IR_DEBUG_TIMING,
+                                "makeFromTGSI");
       ret = prog->makeFromTGSI(info) ? 0 : -2;
       break;
+   }
    default:
       ret = -1;
       break;
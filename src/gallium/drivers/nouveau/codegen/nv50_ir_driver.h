@@ -58,10 +58,12 @@ struct nv50_ir_varying
 # define NV50_IR_DEBUG_BASIC     (1 << 0)
 # define NV50_IR_DEBUG_VERBOSE   (2 << 0)
 # define NV50_IR_DEBUG_REG_ALLOC (1 << 2)
+# define NV50_IR_DEBUG_TIMING    (1 << 3)
 #else
 # define NV50_IR_DEBUG_BASIC     0
 # define NV50_IR_DEBUG_VERBOSE   0
 # define NV50_IR_DEBUG_REG_ALLOC 0
+# define NV50_IR_DEBUG_TIMING    0
 #endif
 
 struct nv50_ir_prog_symbol
@@ -216,6 +218,19 @@ nv50_ir_apply_fixups(void *fixupData, uint32_t *code,
 extern void nv50_ir_get_target_library(uint32_t chipset,
                                        const uint32_t **code, uint32_t *size);
 
+/* (De)serialize relocation and fixup data, which may be NULL, for caching
+ * programs on disk.  Fixups refer to functions of this library, so the data
+ * can only be read back by the build which wrote it.  The deserialize
+ * functions return NULL if the data is missing or truncated.
+ */
+struct blob;
+struct blob_reader;
+
+extern void nv50_ir_serialize_relocs(struct blob *, const void *relocData);
+extern void *nv50_ir_deserialize_relocs(struct blob_reader *);
+extern void nv50_ir_serialize_fixups(struct blob *, const void *fixupData);
+extern void *nv50_ir_deserialize_fixups(struct blob_reader *);
+
 #ifdef __cplusplus
 }
 #endif
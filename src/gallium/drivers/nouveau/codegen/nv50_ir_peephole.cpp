@@ -3985,13 +3985,14 @@ DeadCodeElim::checkSplitLoad(Instruction *ld1)
 
 // =============================================================================
 
-#define RUN_PASS(l, n, f)                       \
-   if (level >= (l)) {                          \
-      if (dbgFlags & NV50_IR_DEBUG_VERBOSE)     \
-         INFO("PEEPHOLE: %s\n", #n);            \
-      n pass;                                   \
-      if (!pass.f(this))                        \
-         return false;                          \
+#define RUN_PASS(l, n, f)                                    \
+   if (level >= (l)) {                                       \
+      if (dbgFlags & NV50_IR_DEBUG_VERBOSE)                  \
+         INFO("PEEPHOLE: %s\n", #n);                         \
+      ScopeTimer timer(dbgFlags & NV50_IR_DEBUG_TIMING, #n); \
+      n pass;                                                \
+      if (!pass.f(this))                                     \
+         return false;                                       \
    }
 
 bool
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <stack>
 #include <limits>
+#include <vector>
 #if __cplusplus >= 201103L
 #include <unordered_map>
 #else
@@ -786,8 +787,7 @@ private:
 
    inline void checkInterference(const RIG_Node *, Graph::EdgeIterator&);
 
-   inline void insertOrderedTail(std::list<RIG_Node *>&, RIG_Node *);
-   void checkList(std::list<RIG_Node *>&);
+   static bool liveBeginLess(const RIG_Node *, const RIG_Node *);
 
 private:
    std::stack<uint32_t> stack;
@@ -1177,70 +1177,56 @@ GCRA::~GCRA()
       delete[] nodes;
 }
 
-void
-GCRA::checkList(std::list<RIG_Node *>& lst)
+bool
+GCRA::liveBeginLess(const RIG_Node *a, const RIG_Node *b)
 {
-   GCRA::RIG_Node *prev = NULL;
-
-   for (std::list<RIG_Node *>::iterator it = lst.begin();
-        it != lst.end();
-        ++it) {
-      assert((*it)->getValue()->join == (*it)->getValue());
-      if (prev)
-         assert(prev->livei.begin() <= (*it)->livei.begin());
-      prev = *it;
-   }
-}
-
-void
-GCRA::insertOrderedTail(std::list<RIG_Node *>& list, RIG_Node *node)
-{
-   if (node->livei.isEmpty())
-      return;
-   // only the intervals of joined values don't necessarily arrive in order
-   std::list<RIG_Node *>::iterator prev, it;
-   for (it = list.end(); it != list.begin(); it = prev) {
-      prev = it;
-      --prev;
-      if ((*prev)->livei.begin() <= node->livei.begin())
-         break;
-   }
-   list.insert(it, node);
+   return a->livei.begin() < b->livei.begin();
 }
 
 void
 GCRA::buildRIG(ArrayList& insns)
 {
-   std::list<RIG_Node *> values, active;
+   std::vector<RIG_Node *> values, active;
 
    for (std::deque<ValueDef>::iterator it = func->ins.begin();
-        it != func->ins.end(); ++it)
-      insertOrderedTail(values, getNode(it->get()->asLValue()));
+        it != func->ins.end(); ++it) {
+      RIG_Node *node = getNode(it->get()->asLValue());
+      if (!node->livei.isEmpty())
+         values.push_back(node);
+   }
 
    for (int i = 0; i < insns.getSize(); ++i) {
       Instruction *insn = reinterpret_cast<Instruction *>(insns.get(i));
-      for (int d = 0; insn->defExists(d); ++d)
-         if (insn->getDef(d)->rep() == insn->getDef(d))
-            insertOrderedTail(values, getNode(insn->getDef(d)->asLValue()));
+      for (int d = 0; insn->defExists(d); ++d) {
+         if (insn->getDef(d)->rep() != insn->getDef(d))
+            continue;
+         RIG_Node *node = getNode(insn->getDef(d)->asLValue());
+         if (!node->livei.isEmpty())
+            values.push_back(node);
+      }
    }
-   checkList(values);
 
-   while (!values.empty()) {
-      RIG_Node *cur = values.front();
+   // Only the intervals of joined values don't necessarily arrive in order.
+   // The sort is stable so that values starting at the same point, and thus
+   // the interference edges, keep the order they would get from inserting
+   // each value behind the last one starting no later.
+   std::stable_sort(values.begin(), values.end(), liveBeginLess);
 
-      for (std::list<RIG_Node *>::iterator it = active.begin();
-           it != active.end();) {
-         RIG_Node *node = *it;
+   for (size_t v = 0; v < values.size(); ++v) {
+      RIG_Node *cur = values[v];
+      size_t n = 0;
 
-         if (node->livei.end() <= cur->livei.begin()) {
-            it = active.erase(it);
-         } else {
-            if (node->f == cur->f && node->livei.overlaps(cur->livei))
-               cur->addInterference(node);
-            ++it;
-         }
+      // drop the values which have died, keeping the others in order
+      for (size_t i = 0; i < active.size(); ++i) {
+         RIG_Node *node = active[i];
+
+         if (node->livei.end() <= cur->livei.begin())
+            continue;
+         if (node->f == cur->f && node->livei.overlaps(cur->livei))
+            cur->addInterference(node);
+         active[n++] = node;
       }
-      values.pop_front();
+      active.resize(n);
       active.push_back(cur);
    }
 }
@@ -1522,20 +1508,32 @@ GCRA::allocateRegisters(ArrayList& insns)
    }
 
    // coalesce first, we use only 1 RIG node for a group of joined values
-   ret = coalesce(insns);
+   {
+      ScopeTimer timer(prog->dbgFlags & NV50_IR_DEBUG_TIMING, "RA: coalesce");
+      ret = coalesce(insns);
+   }
    if (!ret)
       goto out;
 
    if (func->getProgram()->dbgFlags & NV50_IR_DEBUG_REG_ALLOC)
       func->printLiveIntervals();
 
-   buildRIG(insns);
-   calculateSpillWeights();
-   ret = simplify();
+   {
+      ScopeTimer timer(prog->dbgFlags & NV50_IR_DEBUG_TIMING, "RA: buildRIG");
+      buildRIG(insns);
+      calculateSpillWeights();
+   }
+   {
+      ScopeTimer timer(prog->dbgFlags & NV50_IR_DEBUG_TIMING, "RA: simplify");
+      ret = simplify();
+   }
    if (!ret)
       goto out;
 
-   ret = selectRegisters();
+   {
+      ScopeTimer timer(prog->dbgFlags & NV50_IR_DEBUG_TIMING, "RA: select");
+      ret = selectRegisters();
+   }
    if (!ret) {
       INFO_DBG(prog->dbgFlags, REG_ALLOC,
                "selectRegisters failed, inserting spill code ...\n");
@@ -1884,20 +1882,23 @@ RegAlloc::execFunc()
          func->print();
 
       // spilling to registers may add live ranges, need to rebuild everything
-      ret = true;
-      for (sequence = func->cfg.nextSequence(), i = 0;
-           ret && i <= func->loopNestingBound;
-           sequence = func->cfg.nextSequence(), ++i)
-         ret = buildLiveSets(BasicBlock::get(func->cfg.getRoot()));
-      // reset marker
-      for (ArrayList::Iterator bi = func->allBBlocks.iterator();
-           !bi.end(); bi.next())
-         BasicBlock::get(bi)->liveSet.marker = false;
-      if (!ret)
-         break;
-      func->orderInstructions(this->insns);
-
-      ret = buildIntervals.run(func);
+      {
+         ScopeTimer timer(prog->dbgFlags & NV50_IR_DEBUG_TIMING,
+                          "RA: liveness");
+         ret = true;
+         for (sequence = func->cfg.nextSequence(), i = 0;
+              ret && i <= func->loopNestingBound;
+              sequence = func->cfg.nextSequence(), ++i)
+            ret = buildLiveSets(BasicBlock::get(func->cfg.getRoot()));
+         // reset marker
+         for (ArrayList::Iterator bi = func->allBBlocks.iterator();
+              !bi.end(); bi.next())
+            BasicBlock::get(bi)->liveSet.marker = false;
+         if (ret) {
+            func->orderInstructions(this->insns);
+            ret = buildIntervals.run(func);
+         }
+      }
       if (!ret)
          break;
       ret = gcra.allocateRegisters(insns);
@@ -1956,6 +1957,7 @@ GCRA::resolveSplitsAndMerges()
 
 bool Program::registerAllocation()
 {
+   ScopeTimer timer(dbgFlags & NV50_IR_DEBUG_TIMING, "registerAllocation");
    RegAlloc ra(this);
    return ra.exec();
 }
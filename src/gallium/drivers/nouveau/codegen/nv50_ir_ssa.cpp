@@ -305,6 +305,8 @@ private:
 bool
 Program::convertToSSA()
 {
+   ScopeTimer timer(dbgFlags & NV50_IR_DEBUG_TIMING, "convertToSSA");
+
    for (ArrayList::Iterator fi = allFuncs.iterator(); !fi.end(); fi.next()) {
       Function *fn = reinterpret_cast<Function *>(fi.get());
       if (!fn->convertToSSA())
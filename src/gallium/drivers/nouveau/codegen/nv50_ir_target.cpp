@@ -367,6 +367,8 @@ Program::emitSymbolTable(struct nv50_ir_prog_info *info)
 bool
 Program::emitBinary(struct nv50_ir_prog_info *info)
 {
+   ScopeTimer timer(dbgFlags & NV50_IR_DEBUG_TIMING, "emitBinary");
+
    CodeEmitter *emit = target->getCodeEmitter(progType);
 
    emit->prepareEmission(this);
@@ -488,6 +490,7 @@ RelocEntry::apply(uint32_t *binary, const RelocInfo *info) const
 
 
 #include "codegen/nv50_ir_driver.h"
+#include "compiler/blob.h"
 
 extern "C" {
 
@@ -532,4 +535,79 @@ nv50_ir_get_target_library(uint32_t chipset,
    nv50_ir::Target::destroy(targ);
 }
 
+void
+nv50_ir_serialize_relocs(struct blob *blob, const void *relocData)
+{
+   const nv50_ir::RelocInfo *info =
+      reinterpret_cast<const nv50_ir::RelocInfo *>(relocData);
+   const uint32_t count = info ? info->count : 0;
+
+   blob_write_uint32(blob, count);
+   if (count)
+      blob_write_bytes(blob, info, sizeof(*info) + count * sizeof(info->entry[0]));
+}
+
+void *
+nv50_ir_deserialize_relocs(struct blob_reader *blob)
+{
+   const uint32_t count = blob_read_uint32(blob);
+   if (!count || blob->overrun)
+      return NULL;
+
+   const size_t size =
+      sizeof(nv50_ir::RelocInfo) + count * sizeof(nv50_ir::RelocEntry);
+   const void *data = blob_read_bytes(blob, size);
+   if (blob->overrun)
+      return NULL;
+
+   void *relocData = MALLOC(size);
+   if (relocData)
+      memcpy(relocData, data, size);
+   return relocData;
+}
+
+// The apply functions are stored as their distance to a function of this
+// library, which doesn't change with the load address.
+void
+nv50_ir_serialize_fixups(struct blob *blob, const void *fixupData)
+{
+   const nv50_ir::FixupInfo *info =
+      reinterpret_cast<const nv50_ir::FixupInfo *>(fixupData);
+   const uint32_t count = info ? info->count : 0;
+
+   blob_write_uint32(blob, count);
+   for (unsigned i = 0; i < count; ++i) {
+      blob_write_uint64(blob, (uintptr_t)info->entry[i].apply -
+                              (uintptr_t)nv50_ir_apply_fixups);
+      blob_write_uint32(blob, info->entry[i].val);
+   }
+}
+
+void *
+nv50_ir_deserialize_fixups(struct blob_reader *blob)
+{
+   const uint32_t count = blob_read_uint32(blob);
+   if (!count || blob->overrun)
+      return NULL;
+
+   nv50_ir::FixupInfo *info = reinterpret_cast<nv50_ir::FixupInfo *>(
+      MALLOC(sizeof(*info) + count * sizeof(info->entry[0])));
+   if (!info)
+      return NULL;
+
+   info->count = count;
+   for (unsigned i = 0; i < count; ++i) {
+      nv50_ir::FixupApply apply = (nv50_ir::FixupApply)
+         ((uintptr_t)nv50_ir_apply_fixups + blob_read_uint64(blob));
+
+      info->entry[i] = nv50_ir::FixupEntry(apply, 0, 0, 0);
+      info->entry[i].val = blob_read_uint32(blob);
+   }
+   if (blob->overrun) {
+      FREE(info);
+      return NULL;
+   }
+   return info;
+}
+
 }
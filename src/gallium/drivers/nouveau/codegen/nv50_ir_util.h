@@ -33,6 +33,7 @@
 # include <typeinfo>
 #endif
 
+#include "util/os_time.h"
 #include "util/u_inlines.h"
 #include "util/u_memory.h"
 
@@ -100,6 +101,25 @@ typedef std::unique_ptr<Iterator> IteratorRef;
 typedef std::auto_ptr<Iterator> IteratorRef;
 #endif
 
+// Prints the time spent in its scope, for NV50_IR_DEBUG_TIMING.
+class ScopeTimer
+{
+public:
+   ScopeTimer(bool enable, const char *name)
+      : name(name), start(enable ? os_time_get_nano() : 0) { }
+
+   ~ScopeTimer()
+   {
+      if (start)
+         INFO("TIME: %-24s %9.3f ms\n", name,
+              (os_time_get_nano() - start) / 1000000.0);
+   }
+
+private:
+   const char *name;
+   const int64_t start;
+};
+
 class ManipIterator : public Iterator
 {
 public:
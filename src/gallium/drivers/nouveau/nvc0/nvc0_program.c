@@ -22,8 +22,12 @@
 
 #include "pipe/p_defines.h"
 
+#include "compiler/blob.h"
 #include "compiler/nir/nir.h"
+#include "compiler/nir/nir_serialize.h"
+#include "tgsi/tgsi_parse.h"
 #include "tgsi/tgsi_ureg.h"
+#include "util/disk_cache.h"
 
 #include "nvc0/nvc0_context.h"
 
@@ -570,11 +574,157 @@ nvc0_program_dump(struct nvc0_program *prog)
 }
 #endif
 
+/* The disk cache holds the translated programs, keyed by their source and
+ * by everything else nvc0_program_translate() looks at.
+ */
+static bool
+nvc0_program_cache_key(struct disk_cache *cache,
+                       const struct nvc0_program *prog,
+                       const struct nv50_ir_prog_info *info,
+                       cache_key key)
+{
+   struct blob blob;
+   bool ok;
+
+   blob_init(&blob);
+   blob_write_uint32(&blob, info->target);
+   blob_write_uint32(&blob, info->optLevel);
+   blob_write_uint32(&blob, prog->type);
+   blob_write_uint32(&blob, prog->vp.num_ucps);
+   blob_write_uint32(&blob, prog->cp.smem_size);
+   blob_write_bytes(&blob, &prog->pipe.stream_output,
+                    sizeof(prog->pipe.stream_output));
+   blob_write_uint32(&blob, prog->pipe.type);
+
+   if (prog->pipe.type == PIPE_SHADER_IR_NIR) {
+      nir_serialize(&blob, prog->pipe.ir.nir, false);
+   } else {
+      blob_write_bytes(&blob, prog->pipe.tokens,
+                       tgsi_num_tokens(prog->pipe.tokens) *
+                       sizeof(struct tgsi_token));
+   }
+
+   ok = !blob.out_of_memory;
+   if (ok)
+      disk_cache_compute_key(cache, blob.data, blob.size, key);
+   blob_finish(&blob);
+
+   return ok;
+}
+
+static void
+nvc0_program_cache_store(struct disk_cache *cache,
+                         const struct nvc0_program *prog,
+                         const cache_key key)
+{
+   struct blob blob;
+
+   blob_init(&blob);
+   blob_write_uint32(&blob, prog->need_tls);
+   blob_write_uint32(&blob, prog->num_gprs);
+   blob_write_uint32(&blob, prog->code_size);
+   blob_write_bytes(&blob, prog->code, prog->code_size);
+   blob_write_bytes(&blob, prog->hdr, sizeof(prog->hdr));
+   blob_write_bytes(&blob, prog->flags, sizeof(prog->flags));
+   blob_write_bytes(&blob, &prog->vp, sizeof(prog->vp));
+   blob_write_bytes(&blob, &prog->fp, sizeof(prog->fp));
+   blob_write_bytes(&blob, &prog->tp, sizeof(prog->tp));
+   blob_write_uint32(&blob, prog->cp.smem_size);
+   blob_write_uint32(&blob, prog->cp.num_syms);
+   blob_write_bytes(&blob, prog->cp.syms,
+                    prog->cp.num_syms * sizeof(struct nv50_ir_prog_symbol));
+   blob_write_uint32(&blob, prog->num_barriers);
+   nv50_ir_serialize_relocs(&blob, prog->relocs);
+   nv50_ir_serialize_fixups(&blob, prog->fixups);
+   blob_write_uint32(&blob, prog->tfb != NULL);
+   if (prog->tfb)
+      blob_write_bytes(&blob, prog->tfb, sizeof(*prog->tfb));
+
+   if (!blob.out_of_memory)
+      disk_cache_put(cache, key, blob.data, blob.size, NULL);
+   blob_finish(&blob);
+}
+
+static void *
+nvc0_program_cache_read_copy(struct blob_reader *blob, size_t size)
+{
+   const void *data = blob_read_bytes(blob, size);
+   void *copy;
+
+   if (!size || blob->overrun)
+      return NULL;
+
+   copy = MALLOC(size);
+   if (copy)
+      memcpy(copy, data, size);
+   return copy;
+}
+
+static bool
+nvc0_program_cache_load(struct disk_cache *cache, struct nvc0_program *prog,
+                        const cache_key key)
+{
+   /* These follow the rasterizer state, not the translation. */
+   const bool force_persample_interp = prog->fp.force_persample_interp;
+   const bool flatshade = prog->fp.flatshade;
+   struct blob_reader blob;
+   size_t size;
+   void *data;
+
+   data = disk_cache_get(cache, key, &size);
+   if (!data)
+      return false;
+
+   blob_reader_init(&blob, data, size);
+   prog->need_tls = blob_read_uint32(&blob);
+   prog->num_gprs = blob_read_uint32(&blob);
+   prog->code_size = blob_read_uint32(&blob);
+   prog->code = nvc0_program_cache_read_copy(&blob, prog->code_size);
+   blob_copy_bytes(&blob, prog->hdr, sizeof(prog->hdr));
+   blob_copy_bytes(&blob, prog->flags, sizeof(prog->flags));
+   blob_copy_bytes(&blob, &prog->vp, sizeof(prog->vp));
+   blob_copy_bytes(&blob, &prog->fp, sizeof(prog->fp));
+   blob_copy_bytes(&blob, &prog->tp, sizeof(prog->tp));
+   prog->fp.force_persample_interp = force_persample_interp;
+   prog->fp.flatshade = flatshade;
+   prog->cp.smem_size = blob_read_uint32(&blob);
+   prog->cp.num_syms = blob_read_uint32(&blob);
+   prog->cp.syms = nvc0_program_cache_read_copy(&blob,
+      prog->cp.num_syms * sizeof(struct nv50_ir_prog_symbol));
+   prog->num_barriers = blob_read_uint32(&blob);
+   prog->relocs = nv50_ir_deserialize_relocs(&blob);
+   prog->fixups = nv50_ir_deserialize_fixups(&blob);
+   if (blob_read_uint32(&blob))
+      prog->tfb = nvc0_program_cache_read_copy(&blob, sizeof(*prog->tfb));
+
+   free(data);
+
+   if (blob.overrun || blob.current != blob.end ||
+       (prog->code_size && !prog->code)) {
+      FREE(prog->code);
+      FREE(prog->cp.syms);
+      FREE(prog->relocs);
+      FREE(prog->fixups);
+      FREE(prog->tfb);
+      prog->code = NULL;
+      prog->code_size = 0;
+      prog->cp.syms = NULL;
+      prog->cp.num_syms = 0;
+      prog->relocs = NULL;
+      prog->fixups = NULL;
+      prog->tfb = NULL;
+      return false;
+   }
+   return true;
+}
+
 bool
 nvc0_program_translate(struct nvc0_program *prog, uint16_t chipset,
+                       struct disk_cache *disk_shader_cache,
                        struct pipe_debug_callback *debug)
 {
    struct nv50_ir_prog_info *info;
+   cache_key key;
    int ret;
 
    info = CALLOC_STRUCT(nv50_ir_prog_info);
@@ -584,6 +734,27 @@ nvc0_program_translate(struct nvc0_program *prog, uint16_t chipset,
    info->type = prog->type;
    info->target = chipset;
 
+#ifdef DEBUG
+   info->target = debug_get_num_option("NV50_PROG_CHIPSET", chipset);
+   info->optLevel = debug_get_num_option("NV50_PROG_OPTIMIZE", 3);
+   info->dbgFlags = debug_get_num_option("NV50_PROG_DEBUG", 0);
+   info->omitLineNum = debug_get_num_option("NV50_PROG_DEBUG_OMIT_LINENUM", 0);
+#else
+   info->optLevel = 3;
+#endif
+
+   /* Debug output wants to see the compile actually happen. */
+   if (info->dbgFlags ||
+       (disk_shader_cache &&
+        !nvc0_program_cache_key(disk_shader_cache, prog, info, key)))
+      disk_shader_cache = NULL;
+
+   if (disk_shader_cache &&
+       nvc0_program_cache_load(disk_shader_cache, prog, key)) {
+      FREE(info);
+      return true;
+   }
+
    info->bin.sourceRep = prog->pipe.type;
    switch (prog->pipe.type) {
    case PIPE_SHADER_IR_TGSI:
@@ -598,15 +769,6 @@ nvc0_program_translate(struct nvc0_program *prog, uint16_t chipset,
       return false;
    }
 
-#ifdef DEBUG
-   info->target = debug_get_num_option("NV50_PROG_CHIPSET", chipset);
-   info->optLevel = debug_get_num_option("NV50_PROG_OPTIMIZE", 3);
-   info->dbgFlags = debug_get_num_option("NV50_PROG_DEBUG", 0);
-   info->omitLineNum = debug_get_num_option("NV50_PROG_DEBUG_OMIT_LINENUM", 0);
-#else
-   info->optLevel = 3;
-#endif
-
    info->bin.smemSize = prog->cp.smem_size;
    info->io.genUserClip = prog->vp.num_ucps;
    info->io.auxCBSlot = 15;
@@ -723,6 +885,9 @@ nvc0_program_translate(struct nvc0_program *prog, uint16_t chipset,
       nvc0_program_dump(prog);
 #endif
 
+   if (disk_shader_cache)
+      nvc0_program_cache_store(disk_shader_cache, prog, key);
+
 out:
    if (info->bin.sourceRep == PIPE_SHADER_IR_NIR)
       ralloc_free((void *)info->bin.source);
@@ -56,8 +56,34 @@ panfrost_allocate_chunk(struct panfrost_context *ctx, size_t size, unsigned heap
 }
 
 /* Transient command stream pooling: command stream uploads try to simply copy
- * into whereever we left off. If there isn't space, we allocate a new entry
- * into the pool and copy there */
+ * into whereever we left off. If there isn't space, we move on to a new entry,
+ * preferably one a completed job has given back, or else a fresh one from the
+ * slab allocator. The entries end up owned by the job they were recorded for
+ * and come back here once it is done, so memory scales with the complexity of
+ * the frames in flight and recording doesn't have to wait on the GPU */
+
+static struct panfrost_memory_entry *
+panfrost_get_transient_entry(struct panfrost_context *ctx)
+{
+        struct panfrost_transient_pool *pool = &ctx->transient_pool;
+
+        /* Submitted jobs might have completed since we last looked */
+        if (!util_dynarray_contains(&pool->free_entries, struct panfrost_memory_entry *))
+                panfrost_job_retire_completed(ctx);
+
+        if (util_dynarray_contains(&pool->free_entries, struct panfrost_memory_entry *))
+                return util_dynarray_pop(&pool->free_entries, struct panfrost_memory_entry *);
+
+        struct pipe_context *gallium = (struct pipe_context *) ctx;
+        struct panfrost_screen *screen = pan_screen(gallium->screen);
+        struct panfrost_memory_entry *entry = (struct panfrost_memory_entry *)
+                pb_slab_alloc(&screen->slabs, pool->entry_size, HEAP_TRANSIENT);
+
+        /* The entry may have been reclaimed from an earlier release */
+        entry->freed = false;
+
+        return entry;
+}
 
 struct panfrost_transfer
 panfrost_allocate_transient(struct panfrost_context *ctx, size_t sz)
@@ -66,34 +92,21 @@ panfrost_allocate_transient(struct panfrost_context *ctx, size_t sz)
         sz = ALIGN(sz, ALIGNMENT);
 
         /* Check if there is room in the current entry */
-        struct panfrost_transient_pool *pool = &ctx->transient_pools[ctx->cmdstream_i];
+        struct panfrost_transient_pool *pool = &ctx->transient_pool;
 
         if ((pool->entry_offset + sz) > pool->entry_size) {
-                /* Don't overflow this entry -- advance to the next */
+                /* Make sure we won't overflow a whole entry either */
+                assert(sz <= pool->entry_size);
 
+                /* Don't overflow this entry -- advance to the next */
+                util_dynarray_append(&pool->entries, struct panfrost_memory_entry *,
+                                     panfrost_get_transient_entry(ctx));
                 pool->entry_offset = 0;
-
-                pool->entry_index++;
-                assert(pool->entry_index < PANFROST_MAX_TRANSIENT_ENTRIES);
-
-                /* Check if this entry exists */
-                
-                if (pool->entry_index >= pool->entry_count) {
-                        /* Don't overflow the pool -- allocate a new one */
-                        struct pipe_context *gallium = (struct pipe_context *) ctx;
-                        struct panfrost_screen *screen = pan_screen(gallium->screen);
-                        struct pb_slab_entry *entry = pb_slab_alloc(&screen->slabs, pool->entry_size, HEAP_TRANSIENT);
-
-                        pool->entry_count++;
-                        pool->entries[pool->entry_index] = (struct panfrost_memory_entry *) entry;
-                }
-
-                /* Make sure we -still- won't overflow */
-                assert(sz < pool->entry_size);
         }
 
         /* We have an entry we can write to, so do the upload! */
-        struct panfrost_memory_entry *p_entry = pool->entries[pool->entry_index];
+        struct panfrost_memory_entry *p_entry =
+                util_dynarray_top(&pool->entries, struct panfrost_memory_entry *);
         struct panfrost_memory *backing = (struct panfrost_memory *) p_entry->base.slab;
 
         struct panfrost_transfer ret = {
@@ -108,6 +121,53 @@ panfrost_allocate_transient(struct panfrost_context *ctx, size_t sz)
 
 }
 
+/* Give back the transient entries of a job the GPU is done with. A few are
+ * kept around for the next jobs; the rest go back to the slab allocator, so
+ * memory is returned after an unusually complex frame */
+
+void
+panfrost_release_transient(struct panfrost_context *ctx, struct util_dynarray *entries)
+{
+        struct pipe_context *gallium = (struct pipe_context *) ctx;
+        struct panfrost_screen *screen = pan_screen(gallium->screen);
+        struct panfrost_transient_pool *pool = &ctx->transient_pool;
+
+        util_dynarray_foreach(entries, struct panfrost_memory_entry *, entry) {
+                unsigned free_count = util_dynarray_num_elements(&pool->free_entries,
+                                                                 struct panfrost_memory_entry *);
+
+                if (free_count < PANFROST_MAX_FREE_TRANSIENT_ENTRIES) {
+                        util_dynarray_append(&pool->free_entries,
+                                             struct panfrost_memory_entry *, *entry);
+                } else {
+                        (*entry)->freed = true;
+                        pb_slab_free(&screen->slabs, &(*entry)->base);
+                }
+        }
+
+        util_dynarray_fini(entries);
+}
+
+/* Return all of the transient memory of a context being destroyed, which
+ * must have no jobs in flight */
+
+void
+panfrost_destroy_transient(struct panfrost_context *ctx)
+{
+        struct pipe_context *gallium = (struct pipe_context *) ctx;
+        struct panfrost_screen *screen = pan_screen(gallium->screen);
+        struct panfrost_transient_pool *pool = &ctx->transient_pool;
+
+        panfrost_release_transient(ctx, &pool->entries);
+
+        util_dynarray_foreach(&pool->free_entries, struct panfrost_memory_entry *, entry) {
+                (*entry)->freed = true;
+                pb_slab_free(&screen->slabs, &(*entry)->base);
+        }
+
+        util_dynarray_fini(&pool->free_entries);
+}
+
 mali_ptr
 panfrost_upload_transient(struct panfrost_context *ctx, const void *data, size_t sz)
 {
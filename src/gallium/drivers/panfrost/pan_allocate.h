@@ -33,6 +33,7 @@
 #include <panfrost-misc.h>
 
 struct panfrost_context;
+struct util_dynarray;
 
 /* Texture memory */
 
@@ -102,6 +103,12 @@ panfrost_allocate_transient(struct panfrost_context *ctx, size_t sz);
 mali_ptr
 panfrost_upload_transient(struct panfrost_context *ctx, const void *data, size_t sz);
 
+void
+panfrost_release_transient(struct panfrost_context *ctx, struct util_dynarray *entries);
+
+void
+panfrost_destroy_transient(struct panfrost_context *ctx);
+
 void *
 panfrost_allocate_transfer(struct panfrost_memory *mem, size_t sz, mali_ptr *gpu);
 
@@ -303,6 +303,7 @@ panfrost_clear(
         }
 
         job->clear |= buffers;
+        panfrost_job_add_fbo_writes(ctx, job);
 }
 
 static mali_ptr
@@ -355,13 +356,14 @@ panfrost_attach_vt_framebuffer(struct panfrost_context *ctx)
 static void
 panfrost_invalidate_frame(struct panfrost_context *ctx)
 {
-        unsigned transient_count = ctx->transient_pools[ctx->cmdstream_i].entry_index*ctx->transient_pools[0].entry_size + ctx->transient_pools[ctx->cmdstream_i].entry_offset;
-	DBG("Uploaded transient %d bytes\n", transient_count);
-
         /* Rotate cmdstream */
-        if ((++ctx->cmdstream_i) == (sizeof(ctx->transient_pools) / sizeof(ctx->transient_pools[0])))
+        if ((++ctx->cmdstream_i) == ARRAY_SIZE(ctx->submitted_jobs))
                 ctx->cmdstream_i = 0;
 
+        /* Throttle the CPU to the number of jobs we allow in flight */
+        if (ctx->submitted_jobs[ctx->cmdstream_i])
+                panfrost_job_wait(ctx, ctx->submitted_jobs[ctx->cmdstream_i]);
+
         if (ctx->require_sfbd)
                 ctx->vt_framebuffer_sfbd = panfrost_emit_sfbd(ctx);
         else
@@ -370,12 +372,6 @@ panfrost_invalidate_frame(struct panfrost_context *ctx)
         /* Reset varyings allocated */
         ctx->varying_height = 0;
 
-        /* The transient cmdstream is dirty every frame; the only bits worth preserving
-         * (textures, shaders, etc) are in other buffers anyways */
-
-        ctx->transient_pools[ctx->cmdstream_i].entry_index = 0;
-        ctx->transient_pools[ctx->cmdstream_i].entry_offset = 0;
-
         /* Regenerate payloads */
         panfrost_attach_vt_framebuffer(ctx);
 
@@ -905,6 +901,8 @@ panfrost_emit_for_draw(struct panfrost_context *ctx, bool with_vertex_data)
         if (ctx->depth_stencil->depth.writemask)
                 job->requirements |= PAN_REQ_DEPTH_WRITE;
 
+        panfrost_job_add_fbo_writes(ctx, job);
+
         if (ctx->occlusion_query) {
                 ctx->payload_tiler.gl_enables |= MALI_OCCLUSION_QUERY | MALI_OCCLUSION_PRECISE;
                 ctx->payload_tiler.postfix.occlusion_counter = ctx->occlusion_query->transfer.gpu;
@@ -1106,6 +1104,8 @@ panfrost_emit_for_draw(struct panfrost_context *ctx, bool with_vertex_data)
                                 struct pipe_resource *tex_rsrc = ctx->sampler_views[t][i]->base.texture;
                                 struct panfrost_resource *rsrc = (struct panfrost_resource *) tex_rsrc;
 
+                                panfrost_job_add_bo(job, rsrc->bo);
+
                                 /* Inject the addresses in, interleaving cube
                                  * faces and mip levels appropriately. */
 
@@ -1359,18 +1359,15 @@ panfrost_submit_frame(struct panfrost_context *ctx, bool flush_immediate,
 #ifndef DRY_RUN
         
         bool is_scanout = panfrost_is_scanout(ctx);
-        screen->driver->submit_vs_fs_job(ctx, has_draws, is_scanout);
+        screen->driver->submit_vs_fs_job(ctx, job, has_draws, is_scanout);
 
-        /* If visual, we can stall a frame */
+        /* The job is in flight; it gets waited on before its transient pool
+         * is reused, so the CPU can build the next job in the meantime. */
+        panfrost_job_mark_submitted(ctx, job);
 
-        if (!flush_immediate)
-                screen->driver->force_flush_fragment(ctx, fence);
-
-        screen->last_fragment_flushed = false;
-        screen->last_job = job;
-
-        /* If readback, flush now (hurts the pipelined performance) */
-        if (flush_immediate)
+        /* If readback or a fence was asked for, flush now (hurts the
+         * pipelined performance) */
+        if (flush_immediate || fence)
                 screen->driver->force_flush_fragment(ctx, fence);
 
         if (screen->driver->dump_counters && pan_counters_base) {
@@ -1393,14 +1390,20 @@ panfrost_flush(
         unsigned flags)
 {
         struct panfrost_context *ctx = pan_context(pipe);
+        struct panfrost_screen *screen = pan_screen(pipe->screen);
         struct panfrost_job *job = panfrost_get_job_for_fbo(ctx);
 
-        /* Nothing to do! */
-        if (!ctx->draw_count && !job->clear) return;
-
         /* Whether to stall the pipeline for immediately correct results */
         bool flush_immediate = flags & PIPE_FLUSH_END_OF_FRAME;
 
+        /* Nothing new to submit, but there may still be jobs in flight */
+        if (!ctx->draw_count && !job->clear) {
+                if (flush_immediate || fence)
+                        screen->driver->force_flush_fragment(ctx, fence);
+
+                return;
+        }
+
         /* Submit the frame itself */
         panfrost_submit_frame(ctx, flush_immediate, fence, job);
 
@@ -1466,6 +1469,7 @@ panfrost_get_index_buffer_mapped(struct panfrost_context *ctx, const struct pipe
 
         if (!info->has_user_indices) {
                 /* Only resources can be directly mapped */
+                panfrost_job_add_bo(panfrost_get_job_for_fbo(ctx), rsrc->bo);
                 return rsrc->bo->gpu + offset;
         } else {
                 /* Otherwise, we need to upload to transient memory */
@@ -2349,6 +2353,11 @@ panfrost_destroy(struct pipe_context *pipe)
         if (panfrost->blitter)
                 util_blitter_destroy(panfrost->blitter);
 
+        /* Wait for the jobs in flight, which also gives their transient
+         * memory back */
+        screen->driver->force_flush_fragment(panfrost, NULL);
+        panfrost_destroy_transient(panfrost);
+
         screen->driver->free_slab(screen, &panfrost->scratchpad);
         screen->driver->free_slab(screen, &panfrost->varying_mem);
         screen->driver->free_slab(screen, &panfrost->shaders);
@@ -2494,15 +2503,13 @@ panfrost_setup_hardware(struct panfrost_context *ctx)
         struct pipe_context *gallium = (struct pipe_context *) ctx;
         struct panfrost_screen *screen = pan_screen(gallium->screen);
 
-        for (int i = 0; i < ARRAY_SIZE(ctx->transient_pools); ++i) {
-                /* Allocate the beginning of the transient pool */
-                int entry_size = (1 << 22); /* 4MB */
-
-                ctx->transient_pools[i].entry_size = entry_size;
-                ctx->transient_pools[i].entry_count = 1;
-
-                ctx->transient_pools[i].entries[0] = (struct panfrost_memory_entry *) pb_slab_alloc(&screen->slabs, entry_size, HEAP_TRANSIENT);
-        }
+        /* The transient pool starts out empty and is filled on demand, 4MB
+         * at a time. Marking the (missing) current entry full makes the first
+         * allocation fetch one */
+        util_dynarray_init(&ctx->transient_pool.entries, NULL);
+        util_dynarray_init(&ctx->transient_pool.free_entries, NULL);
+        ctx->transient_pool.entry_size = (1 << 22); /* 4MB */
+        ctx->transient_pool.entry_offset = ctx->transient_pool.entry_size;
 
         screen->driver->allocate_slab(screen, &ctx->scratchpad, 64, false, 0, 0, 0);
         screen->driver->allocate_slab(screen, &ctx->varying_mem, 16384, false, PAN_ALLOCATE_INVISIBLE | PAN_ALLOCATE_COHERENT_LOCAL, 0, 0);
@@ -87,17 +87,21 @@ struct panfrost_fence {
         int fd;
 };
 
-#define PANFROST_MAX_TRANSIENT_ENTRIES 64
+/* Number of jobs the CPU can have in flight before it waits on the GPU */
+#define PANFROST_MAX_SUBMITTED_JOBS 3
 
-struct panfrost_transient_pool {
-        /* Memory blocks in the pool */
-        struct panfrost_memory_entry *entries[PANFROST_MAX_TRANSIENT_ENTRIES];
+/* Number of retired transient entries kept around for reuse; beyond that,
+ * they are handed back to the slab allocator */
+#define PANFROST_MAX_FREE_TRANSIENT_ENTRIES 8
 
-        /* Number of entries we own */
-        unsigned entry_count;
+struct panfrost_transient_pool {
+        /* Memory blocks (struct panfrost_memory_entry *) of the job being
+         * recorded, in allocation order. The last one is being written to.
+         * They are handed over to the job when it is submitted */
+        struct util_dynarray entries;
 
-        /* Current entry that we are writing to, zero-indexed, strictly less than entry_count */
-        unsigned entry_index;
+        /* Blocks of completed jobs, ready to be written to again */
+        struct util_dynarray free_entries;
 
         /* Number of bytes into the current entry we are */
         off_t entry_offset;
@@ -122,10 +126,16 @@ struct panfrost_context {
 
         struct pipe_framebuffer_state pipe_framebuffer;
 
-        /* The number of concurrent FBOs allowed depends on the number of pools
-         * used; pools are ringed for parallelism opportunities */
+        /* Transient cmdstream memory, which grows with the job being
+         * recorded and is recycled as submitted jobs complete */
+
+        struct panfrost_transient_pool transient_pool;
 
-        struct panfrost_transient_pool transient_pools[2];
+        /* Jobs in flight are ringed; before a slot is reused, the job last
+         * submitted out of it has to finish. out_syncs are the syncobjs each
+         * slot's job signals */
+        struct panfrost_job *submitted_jobs[PANFROST_MAX_SUBMITTED_JOBS];
+        uint32_t out_syncs[PANFROST_MAX_SUBMITTED_JOBS];
         int cmdstream_i;
 
         struct panfrost_memory cmdstream_persistent;
@@ -220,6 +230,7 @@ struct panfrost_context {
          * there's no real advantage to doing so */
         bool require_sfbd;
 
+        /* Syncobj of the last submission, which the next one waits on */
 	uint32_t out_sync;
 };
 
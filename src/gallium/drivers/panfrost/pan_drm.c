@@ -211,10 +211,13 @@ panfrost_drm_submit_job(struct panfrost_context *ctx, u64 job_desc, int reqs, st
         struct drm_panfrost_submit submit = {0,};
         int bo_handles[7];
 
+        /* Keep submissions in order, since they share the tiler heap and
+         * varyings, but signal the syncobj of the job's slot so its
+         * transient memory can be recycled as soon as this job is done */
         submit.in_syncs = (u64) (uintptr_t) &ctx->out_sync;
         submit.in_sync_count = 1;
 
-        submit.out_sync = ctx->out_sync;
+        submit.out_sync = ctx->out_syncs[ctx->cmdstream_i];
 
 	submit.jc = job_desc;
 	submit.requirements = reqs;
@@ -245,6 +248,8 @@ panfrost_drm_submit_job(struct panfrost_context *ctx, u64 job_desc, int reqs, st
 	        return errno;
 	}
 
+        ctx->out_sync = submit.out_sync;
+
         /* Trace the job if we're doing that and do a memory dump. We may
          * want to adjust this logic once we're ready to trace FBOs */
         pantrace_submit_job(submit.jc, submit.requirements, FALSE);
@@ -253,7 +258,7 @@ panfrost_drm_submit_job(struct panfrost_context *ctx, u64 job_desc, int reqs, st
 }
 
 static int
-panfrost_drm_submit_vs_fs_job(struct panfrost_context *ctx, bool has_draws, bool is_scanout)
+panfrost_drm_submit_vs_fs_job(struct panfrost_context *ctx, struct panfrost_job *job, bool has_draws, bool is_scanout)
 {
         struct pipe_surface *surf = ctx->pipe_framebuffer.cbufs[0];
 	int ret;
@@ -265,6 +270,8 @@ panfrost_drm_submit_vs_fs_job(struct panfrost_context *ctx, bool has_draws, bool
 
 	ret = panfrost_drm_submit_job(ctx, panfrost_fragment_job(ctx), PANFROST_JD_REQ_FS, surf);
 
+        job->out_sync = ctx->out_syncs[ctx->cmdstream_i];
+
         return ret;
 }
 
@@ -303,13 +310,13 @@ panfrost_drm_force_flush_fragment(struct panfrost_context *ctx,
         struct panfrost_screen *screen = pan_screen(gallium->screen);
         struct panfrost_drm *drm = (struct panfrost_drm *)screen->driver;
 
-        if (!screen->last_fragment_flushed) {
-		drmSyncobjWait(drm->fd, &ctx->out_sync, 1, INT64_MAX, 0, NULL);
-                screen->last_fragment_flushed = true;
+        /* Submissions complete in order, so waiting for the last one waits
+         * for every job in flight */
+	drmSyncobjWait(drm->fd, &ctx->out_sync, 1, INT64_MAX, 0, NULL);
 
-                /* The job finished up, so we're safe to clean it up now */
-                panfrost_free_job(ctx, screen->last_job);
-	}
+        /* The jobs finished up, so we're safe to clean them up now */
+        for (unsigned i = 0; i < ARRAY_SIZE(ctx->submitted_jobs); ++i)
+                panfrost_free_job(ctx, ctx->submitted_jobs[i]);
 
         if (fence) {
                 struct panfrost_fence *f = panfrost_fence_create(ctx);
@@ -318,6 +325,27 @@ panfrost_drm_force_flush_fragment(struct panfrost_context *ctx,
         }
 }
 
+static void
+panfrost_drm_wait_job(struct panfrost_context *ctx, struct panfrost_job *job)
+{
+        struct pipe_context *gallium = (struct pipe_context *) ctx;
+        struct panfrost_screen *screen = pan_screen(gallium->screen);
+        struct panfrost_drm *drm = (struct panfrost_drm *)screen->driver;
+
+	drmSyncobjWait(drm->fd, &job->out_sync, 1, INT64_MAX, 0, NULL);
+}
+
+static bool
+panfrost_drm_job_done(struct panfrost_context *ctx, struct panfrost_job *job)
+{
+        struct pipe_context *gallium = (struct pipe_context *) ctx;
+        struct panfrost_screen *screen = pan_screen(gallium->screen);
+        struct panfrost_drm *drm = (struct panfrost_drm *)screen->driver;
+
+        /* A zero timeout just polls the syncobj */
+        return !drmSyncobjWait(drm->fd, &job->out_sync, 1, 0, 0, NULL);
+}
+
 static void
 panfrost_drm_enable_counters(struct panfrost_screen *screen)
 {
@@ -351,8 +379,16 @@ panfrost_drm_init_context(struct panfrost_context *ctx)
         struct panfrost_screen *screen = pan_screen(gallium->screen);
 	struct panfrost_drm *drm = (struct panfrost_drm *)screen->driver;
 
-        return drmSyncobjCreate(drm->fd, DRM_SYNCOBJ_CREATE_SIGNALED,
-                                &ctx->out_sync);
+        for (unsigned i = 0; i < ARRAY_SIZE(ctx->out_syncs); ++i) {
+                int ret = drmSyncobjCreate(drm->fd, DRM_SYNCOBJ_CREATE_SIGNALED,
+                                           &ctx->out_syncs[i]);
+                if (ret)
+                        return ret;
+        }
+
+        ctx->out_sync = ctx->out_syncs[0];
+
+        return 0;
 }
 
 static void
@@ -418,6 +454,8 @@ panfrost_create_drm_driver(int fd)
 	driver->base.free_imported_bo = panfrost_drm_free_imported_bo;
 	driver->base.submit_vs_fs_job = panfrost_drm_submit_vs_fs_job;
 	driver->base.force_flush_fragment = panfrost_drm_force_flush_fragment;
+	driver->base.wait_job = panfrost_drm_wait_job;
+	driver->base.job_done = panfrost_drm_job_done;
 	driver->base.allocate_slab = panfrost_drm_allocate_slab;
 	driver->base.free_slab = panfrost_drm_free_slab;
 	driver->base.enable_counters = panfrost_drm_enable_counters;
@@ -38,6 +38,8 @@ panfrost_create_job(struct panfrost_context *ctx)
         job->bos = _mesa_set_create(job,
                                     _mesa_hash_pointer,
                                     _mesa_key_pointer_equal);
+
+        util_dynarray_init(&job->transient_entries, NULL);
  
         return job;
 }
@@ -53,7 +55,27 @@ panfrost_free_job(struct panfrost_context *ctx, struct panfrost_job *job)
                 panfrost_bo_unreference(ctx->base.screen, bo);
         }
 
-        _mesa_hash_table_remove_key(ctx->jobs, &job->key);
+        /* Jobs are only freed once they are done on the GPU, so their
+         * transient memory can be written to again */
+        panfrost_release_transient(ctx, &job->transient_entries);
+
+        /* A job that was already submitted might have been replaced by a
+         * newer one for the same FBO */
+
+        struct hash_entry *entry = _mesa_hash_table_search(ctx->jobs, &job->key);
+
+        if (entry && entry->data == job)
+                _mesa_hash_table_remove(ctx->jobs, entry);
+
+        hash_table_foreach(ctx->write_jobs, wentry) {
+                if (wentry->data == job)
+                        _mesa_hash_table_remove(ctx->write_jobs, wentry);
+        }
+
+        for (unsigned i = 0; i < ARRAY_SIZE(ctx->submitted_jobs); ++i) {
+                if (ctx->submitted_jobs[i] == job)
+                        ctx->submitted_jobs[i] = NULL;
+        }
 
         if (ctx->job == job)
                 ctx->job = NULL;
@@ -126,19 +148,105 @@ panfrost_job_add_bo(struct panfrost_job *job, struct panfrost_bo *bo)
         _mesa_set_add(job->bos, bo);
 }
 
+/* Record the render targets of the current FBO as written by the job, so
+ * reads of them know which job to flush or wait for */
+
+void
+panfrost_job_add_fbo_writes(struct panfrost_context *ctx,
+                            struct panfrost_job *job)
+{
+        struct pipe_framebuffer_state *fb = &ctx->pipe_framebuffer;
+
+        for (unsigned i = 0; i < fb->nr_cbufs; ++i) {
+                if (!fb->cbufs[i])
+                        continue;
+
+                struct pipe_resource *prsc = fb->cbufs[i]->texture;
+                panfrost_job_add_bo(job, pan_resource(prsc)->bo);
+                _mesa_hash_table_insert(ctx->write_jobs, prsc, job);
+        }
+
+        if (fb->zsbuf) {
+                struct pipe_resource *prsc = fb->zsbuf->texture;
+                panfrost_job_add_bo(job, pan_resource(prsc)->bo);
+                _mesa_hash_table_insert(ctx->write_jobs, prsc, job);
+        }
+}
+
+/* Once a job is handed to the kernel, further draws to the same FBO go into
+ * a new job. The submitted one is kept around, holding its BOs and the
+ * transient memory it was recorded into, until its slot comes around again,
+ * until it is found to be done, or until something waits on it explicitly */
+
+void
+panfrost_job_mark_submitted(struct panfrost_context *ctx,
+                            struct panfrost_job *job)
+{
+        struct hash_entry *entry = _mesa_hash_table_search(ctx->jobs, &job->key);
+
+        if (entry && entry->data == job)
+                _mesa_hash_table_remove(ctx->jobs, entry);
+
+        if (ctx->job == job)
+                ctx->job = NULL;
+
+        assert(!ctx->submitted_jobs[ctx->cmdstream_i]);
+
+        job->submitted = true;
+        ctx->submitted_jobs[ctx->cmdstream_i] = job;
+
+        /* Everything recorded so far belongs to this job; the next one
+         * starts over with fresh entries */
+        util_dynarray_fini(&job->transient_entries);
+        job->transient_entries = ctx->transient_pool.entries;
+        util_dynarray_init(&ctx->transient_pool.entries, NULL);
+        ctx->transient_pool.entry_offset = ctx->transient_pool.entry_size;
+}
+
+/* Wait for a submitted job to finish on the GPU and clean it up */
+
+void
+panfrost_job_wait(struct panfrost_context *ctx, struct panfrost_job *job)
+{
+        struct panfrost_screen *screen = pan_screen(ctx->base.screen);
+
+        assert(job->submitted);
+
+        screen->driver->wait_job(ctx, job);
+        panfrost_free_job(ctx, job);
+}
+
+/* Clean up the submitted jobs the GPU is already done with, without
+ * waiting on the others */
+
+void
+panfrost_job_retire_completed(struct panfrost_context *ctx)
+{
+        struct panfrost_screen *screen = pan_screen(ctx->base.screen);
+
+        for (unsigned i = 0; i < ARRAY_SIZE(ctx->submitted_jobs); ++i) {
+                struct panfrost_job *job = ctx->submitted_jobs[i];
+
+                if (job && screen->driver->job_done(ctx, job))
+                        panfrost_free_job(ctx, job);
+        }
+}
+
 void
 panfrost_flush_jobs_writing_resource(struct panfrost_context *panfrost,
                                 struct pipe_resource *prsc)
 {
-#if 0
         struct hash_entry *entry = _mesa_hash_table_search(panfrost->write_jobs,
                                                            prsc);
-        if (entry) {
-                struct panfrost_job *job = entry->data;
-                panfrost_job_submit(panfrost, job);
-        }
-#endif
-        /* TODO stub */
+        if (!entry)
+                return;
+
+        struct panfrost_job *job = entry->data;
+
+        if (job->submitted)
+                panfrost_job_wait(panfrost, job);
+        else
+                panfrost_flush(&panfrost->base, NULL, PIPE_FLUSH_END_OF_FRAME);
 }
 
 void
@@ -149,15 +257,26 @@ panfrost_flush_jobs_reading_resource(struct panfrost_context *panfrost,
 
         panfrost_flush_jobs_writing_resource(panfrost, prsc);
 
+        /* The draws of every open job are in the same cmdstream, so flushing
+         * takes care of all of them, as well as of the jobs still in
+         * flight */
+
         hash_table_foreach(panfrost->jobs, entry) {
                 struct panfrost_job *job = entry->data;
 
                 if (_mesa_set_search(job->bos, rsc->bo)) {
-                        printf("TODO: submit job for flush\n");
-                        //panfrost_job_submit(panfrost, job);
-                        continue;
+                        panfrost_flush(&panfrost->base, NULL,
+                                       PIPE_FLUSH_END_OF_FRAME);
+                        return;
                 }
         }
+
+        for (unsigned i = 0; i < ARRAY_SIZE(panfrost->submitted_jobs); ++i) {
+                struct panfrost_job *job = panfrost->submitted_jobs[i];
+
+                if (job && _mesa_set_search(job->bos, rsc->bo))
+                        panfrost_job_wait(panfrost, job);
+        }
 }
 
 static bool
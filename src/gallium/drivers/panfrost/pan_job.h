@@ -26,6 +26,8 @@
 #ifndef __PAN_JOB_H__
 #define __PAN_JOB_H__
 
+#include "util/u_dynarray.h"
+
 /* Used as a hash table key */
 
 struct panfrost_job_key {
@@ -57,6 +59,16 @@ struct panfrost_job {
 
         /* BOs referenced -- will be used for flushing logic */
         struct set *bos;
+
+        /* Set once the job has been handed to the kernel, at which point it
+         * is no longer looked up by FBO. out_sync is signalled when the job
+         * completes on the GPU */
+        bool submitted;
+        uint32_t out_sync;
+
+        /* Transient memory entries the job was recorded into, recycled once
+         * the job completes */
+        struct util_dynarray transient_entries;
 };
 
 /* Functions for managing the above */
@@ -80,6 +92,20 @@ panfrost_job_init(struct panfrost_context *ctx);
 void
 panfrost_job_add_bo(struct panfrost_job *job, struct panfrost_bo *bo);
 
+void
+panfrost_job_add_fbo_writes(struct panfrost_context *ctx,
+                            struct panfrost_job *job);
+
+void
+panfrost_job_mark_submitted(struct panfrost_context *ctx,
+                            struct panfrost_job *job);
+
+void
+panfrost_job_wait(struct panfrost_context *ctx, struct panfrost_job *job);
+
+void
+panfrost_job_retire_completed(struct panfrost_context *ctx);
+
 void
 panfrost_flush_jobs_writing_resource(struct panfrost_context *panfrost,
                                 struct pipe_resource *prsc);
@@ -395,6 +395,33 @@ panfrost_resource_destroy(struct pipe_screen *screen,
 	FREE(rsrc);
 }
 
+/* Give a buffer whose contents are being discarded fresh storage, rather
+ * than waiting for the jobs still using the old one. Those jobs hold
+ * references to the old BO, which keep it alive until they are done. */
+
+static void
+panfrost_buffer_realloc(struct pipe_context *pctx, struct panfrost_resource *rsrc)
+{
+        struct panfrost_screen *screen = pan_screen(pctx->screen);
+
+        panfrost_bo_unreference(pctx->screen, rsrc->bo);
+        rsrc->bo = panfrost_create_bo(screen, &rsrc->base);
+        util_range_set_empty(&rsrc->valid_buffer_range);
+}
+
+/* Buffers are only referenced by their resource and the jobs using them.
+ * Vertex and index buffer addresses are emitted at draw time, and constant
+ * buffers are copied when bound, so swapping out the BO is invisible to
+ * draws recorded afterwards. */
+
+static bool
+panfrost_buffer_can_realloc(struct panfrost_resource *rsrc)
+{
+        return rsrc->base.target == PIPE_BUFFER &&
+               !rsrc->scanout && !rsrc->bo->imported &&
+               p_atomic_read(&rsrc->bo->reference.count) > 1;
+}
+
 static void *
 panfrost_transfer_map(struct pipe_context *pctx,
                       struct pipe_resource *resource,
@@ -405,7 +432,7 @@ panfrost_transfer_map(struct pipe_context *pctx,
 {
         int bytes_per_pixel = util_format_get_blocksize(resource->format);
         struct panfrost_resource *rsrc = pan_resource(resource);
-        struct panfrost_bo *bo = rsrc->bo;
+        struct panfrost_bo *bo;
 
         struct panfrost_gtransfer *transfer = CALLOC_STRUCT(panfrost_gtransfer);
         transfer->base.level = level;
@@ -435,25 +462,25 @@ panfrost_transfer_map(struct pipe_context *pctx,
 
         /* TODO: Respect usage flags */
 
-        if (usage & PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE) {
-                /* TODO: reallocate */
-                //printf("debug: Missed reallocate\n");
-        } else if ((usage & PIPE_TRANSFER_WRITE)
+        if ((usage & PIPE_TRANSFER_WRITE)
                         && resource->target == PIPE_BUFFER
                         && !util_ranges_intersect(&rsrc->valid_buffer_range, box->x, box->x + box->width)) {
                 /* No flush for writes to uninitialized */
         } else if (!(usage & PIPE_TRANSFER_UNSYNCHRONIZED)) {
-                if (usage & PIPE_TRANSFER_WRITE) {
-                        /* STUB: flush reading */
-                        //printf("debug: missed reading flush %d\n", resource->target);
+                if ((usage & PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE) &&
+                    panfrost_buffer_can_realloc(rsrc)) {
+                        panfrost_buffer_realloc(pctx, rsrc);
+                } else if (usage & PIPE_TRANSFER_WRITE) {
+                        panfrost_flush_jobs_reading_resource(ctx, resource);
                 } else if (usage & PIPE_TRANSFER_READ) {
-                        /* STUB: flush writing */
-                        //printf("debug: missed writing flush %d (%d-%d)\n", resource->target, box->x, box->x + box->width);
+                        panfrost_flush_jobs_writing_resource(ctx, resource);
                 } else {
                         /* Why are you even mapping?! */
                 }
         }
 
+        bo = rsrc->bo;
+
         if (bo->layout != PAN_LINEAR) {
                 /* Non-linear resources need to be indirectly mapped */
 
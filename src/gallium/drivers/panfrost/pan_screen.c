@@ -503,6 +503,11 @@ panfrost_is_format_supported( struct pipe_screen *screen,
 static void
 panfrost_destroy_screen( struct pipe_screen *screen )
 {
+        struct panfrost_screen *pscreen = pan_screen(screen);
+
+        if (pscreen->ro)
+                renderonly_destroy(pscreen->ro);
+
         FREE(screen);
 }
 
@@ -599,9 +604,6 @@ panfrost_create_screen(int fd, struct renderonly *ro)
         screen->base.fence_reference = panfrost_fence_reference;
         screen->base.fence_finish = panfrost_fence_finish;
 
-	screen->last_fragment_flushed = true;
-        screen->last_job = NULL;
-
         panfrost_resource_screen_init(screen);
 
         return &screen->base;
@@ -38,6 +38,7 @@
 #include "pan_trace.h"
 
 struct panfrost_context;
+struct panfrost_job;
 struct panfrost_resource;
 struct panfrost_screen;
 
@@ -51,9 +52,11 @@ struct panfrost_driver {
 	struct panfrost_bo * (*import_bo) (struct panfrost_screen *screen, struct winsys_handle *whandle);
 	int (*export_bo) (struct panfrost_screen *screen, int gem_handle, unsigned int stride, struct winsys_handle *whandle);
 
-	int (*submit_vs_fs_job) (struct panfrost_context *ctx, bool has_draws, bool is_scanout);
+	int (*submit_vs_fs_job) (struct panfrost_context *ctx, struct panfrost_job *job, bool has_draws, bool is_scanout);
 	void (*force_flush_fragment) (struct panfrost_context *ctx,
 				      struct pipe_fence_handle **fence);
+	void (*wait_job) (struct panfrost_context *ctx, struct panfrost_job *job);
+	bool (*job_done) (struct panfrost_context *ctx, struct panfrost_job *job);
 	void (*allocate_slab) (struct panfrost_screen *screen,
 		               struct panfrost_memory *mem,
 		               size_t pages,
@@ -91,12 +94,6 @@ struct panfrost_screen {
         
         /* TODO: Where? */
         struct panfrost_resource *display_target;
-
-        /* While we're busy building up the job for frame N, the GPU is
-         * still busy executing frame N-1. So hold a reference to
-         * yesterjob */
-	int last_fragment_flushed;
-        struct panfrost_job *last_job;
 };
 
 #endif /* PAN_SCREEN_H */
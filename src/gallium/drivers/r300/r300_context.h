@@ -387,6 +387,17 @@ struct r300_texture_desc {
     unsigned cmask_stride_in_pixels;
 };
 
+/* An index buffer translated from a buffer resource, see
+ * r300_translate_index_buffer. */
+struct r300_translated_indices
+{
+    struct pipe_resource *buffer;
+    unsigned index_size, index_offset, start, count;
+    unsigned out_index_size;
+};
+
+#define R300_MAX_TRANSLATED_INDICES 4
+
 struct r300_resource
 {
     struct u_resource b;
@@ -405,6 +416,15 @@ struct r300_resource
     /* This is the level tiling flags were last time set for.
      * It's used to prevent redundant tiling-flags changes from happening.*/
     unsigned surface_level;
+
+    /* Index buffers translated from this buffer. They are dropped
+     * whenever the buffer is mapped for writing, which also bumps
+     * write_count. translate_write_count is the write_count seen by the
+     * last translation, to tell static buffers from streamed ones. */
+    struct r300_translated_indices translated[R300_MAX_TRANSLATED_INDICES];
+    unsigned num_translated;
+    unsigned write_count;
+    unsigned translate_write_count;
 };
 
 struct r300_vertex_element_state {
@@ -22,60 +22,150 @@
 
 #include "r300_context.h"
 #include "util/u_index_modify.h"
+#include "util/u_inlines.h"
 #include "util/u_upload_mgr.h"
 
 
+/* Look for indices translated from the same buffer range before. */
+static struct pipe_resource *
+r300_find_translated_indices(struct r300_resource *rbuf,
+                             unsigned index_size, unsigned index_offset,
+                             unsigned start, unsigned count,
+                             unsigned *out_index_size)
+{
+    unsigned i;
+
+    for (i = 0; i < rbuf->num_translated; i++) {
+        struct r300_translated_indices *t = &rbuf->translated[i];
+
+        if (t->index_size == index_size && t->index_offset == index_offset &&
+            t->start == start && t->count == count) {
+            *out_index_size = t->out_index_size;
+            return t->buffer;
+        }
+    }
+    return NULL;
+}
+
+static void
+r300_add_translated_indices(struct r300_resource *rbuf,
+                            struct pipe_resource *buffer,
+                            unsigned index_size, unsigned index_offset,
+                            unsigned start, unsigned count,
+                            unsigned out_index_size)
+{
+    struct r300_translated_indices *t;
+
+    if (rbuf->num_translated == R300_MAX_TRANSLATED_INDICES) {
+        pipe_resource_reference(&rbuf->translated[0].buffer, NULL);
+        memmove(&rbuf->translated[0], &rbuf->translated[1],
+                (R300_MAX_TRANSLATED_INDICES - 1) * sizeof(*t));
+        rbuf->num_translated--;
+    }
+
+    t = &rbuf->translated[rbuf->num_translated++];
+    t->buffer = NULL;
+    pipe_resource_reference(&t->buffer, buffer);
+    t->index_size = index_size;
+    t->index_offset = index_offset;
+    t->start = start;
+    t->count = count;
+    t->out_index_size = out_index_size;
+}
+
+/* Ubyte indices and index bias emulation need the indices to be rewritten.
+ *
+ * Rewriting a static index buffer for every draw is a waste, so when the
+ * source buffer hasn't been written to since the last translation, the
+ * result goes to a buffer of its own which is kept with the source buffer
+ * until it's mapped for writing again. Everything else, i.e. user indices
+ * and streamed buffers, goes through the upload buffer. */
 void r300_translate_index_buffer(struct r300_context *r300,
                                  const struct pipe_draw_info *info,
                                  struct pipe_resource **out_buffer,
                                  unsigned *index_size, unsigned index_offset,
                                  unsigned *start, unsigned count)
 {
-    unsigned out_offset;
-    void *ptr;
+    struct r300_resource *rbuf = NULL;
+    struct pipe_transfer *transfer = NULL;
+    struct pipe_resource *cached;
+    unsigned out_index_size, out_offset;
+    void *ptr = NULL;
 
-    switch (*index_size) {
-    case 1:
-        *out_buffer = NULL;
-        u_upload_alloc(r300->uploader, 0, count * 2, 4,
+    if (*index_size != 1 && !index_offset)
+        return;
+
+    out_index_size = *index_size == 1 ? 2 : *index_size;
+
+    if (!info->has_user_indices) {
+        rbuf = r300_resource(info->index.resource);
+
+        cached = r300_find_translated_indices(rbuf, *index_size, index_offset,
+                                              *start, count,
+                                              &out_index_size);
+        if (cached) {
+            *out_buffer = NULL;
+            pipe_resource_reference(out_buffer, cached);
+            *index_size = out_index_size;
+            *start = 0;
+            return;
+        }
+    }
+
+    *out_buffer = NULL;
+
+    if (rbuf && rbuf->write_count == rbuf->translate_write_count) {
+        *out_buffer = pipe_buffer_create(r300->context.screen,
+                                         PIPE_BIND_CUSTOM,
+                                         PIPE_USAGE_IMMUTABLE,
+                                         count * out_index_size);
+        if (*out_buffer) {
+            ptr = pipe_buffer_map(&r300->context, *out_buffer,
+                                  PIPE_TRANSFER_WRITE |
+                                  PIPE_TRANSFER_UNSYNCHRONIZED, &transfer);
+            if (!ptr)
+                pipe_resource_reference(out_buffer, NULL);
+        }
+        out_offset = 0;
+    }
+
+    if (!ptr) {
+        u_upload_alloc(r300->uploader, 0, count * out_index_size, 4,
                        &out_offset, out_buffer, &ptr);
+    }
 
+    if (rbuf)
+        rbuf->translate_write_count = rbuf->write_count;
+
+    switch (*index_size) {
+    case 1:
         util_shorten_ubyte_elts_to_userptr(
                 &r300->context, info, PIPE_TRANSFER_UNSYNCHRONIZED, index_offset,
                 *start, count, ptr);
-
-        *index_size = 2;
-        *start = out_offset / 2;
         break;
 
     case 2:
-        if (index_offset) {
-            *out_buffer = NULL;
-            u_upload_alloc(r300->uploader, 0, count * 2, 4,
-                           &out_offset, out_buffer, &ptr);
-
-            util_rebuild_ushort_elts_to_userptr(&r300->context, info,
-                                                PIPE_TRANSFER_UNSYNCHRONIZED,
-                                                index_offset, *start,
-                                                count, ptr);
-
-            *start = out_offset / 2;
-        }
+        util_rebuild_ushort_elts_to_userptr(&r300->context, info,
+                                            PIPE_TRANSFER_UNSYNCHRONIZED,
+                                            index_offset, *start,
+                                            count, ptr);
         break;
 
     case 4:
-        if (index_offset) {
-            *out_buffer = NULL;
-            u_upload_alloc(r300->uploader, 0, count * 4, 4,
-                           &out_offset, out_buffer, &ptr);
-
-            util_rebuild_uint_elts_to_userptr(&r300->context, info,
-                                              PIPE_TRANSFER_UNSYNCHRONIZED,
-                                              index_offset, *start,
-                                              count, ptr);
-
-            *start = out_offset / 4;
-        }
+        util_rebuild_uint_elts_to_userptr(&r300->context, info,
+                                          PIPE_TRANSFER_UNSYNCHRONIZED,
+                                          index_offset, *start,
+                                          count, ptr);
         break;
     }
+
+    if (transfer) {
+        pipe_buffer_unmap(&r300->context, transfer);
+        r300_add_translated_indices(rbuf, *out_buffer, *index_size,
+                                    index_offset, *start, count,
+                                    out_index_size);
+    }
+
+    *index_size = out_index_size;
+    *start = out_offset / out_index_size;
 }
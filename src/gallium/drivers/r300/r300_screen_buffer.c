@@ -50,11 +50,21 @@ void r300_upload_index_buffer(struct r300_context *r300,
     *start = index_offset / index_size;
 }
 
+void r300_buffer_release_translated(struct r300_resource *rbuf)
+{
+    unsigned i;
+
+    for (i = 0; i < rbuf->num_translated; i++)
+        pipe_resource_reference(&rbuf->translated[i].buffer, NULL);
+    rbuf->num_translated = 0;
+}
+
 static void r300_buffer_destroy(struct pipe_screen *screen,
 				struct pipe_resource *buf)
 {
     struct r300_resource *rbuf = r300_resource(buf);
 
+    r300_buffer_release_translated(rbuf);
     align_free(rbuf->malloced_buffer);
 
     if (rbuf->buf)
@@ -85,6 +95,11 @@ r300_buffer_transfer_map( struct pipe_context *context,
     transfer->stride = 0;
     transfer->layer_stride = 0;
 
+    if (usage & PIPE_TRANSFER_WRITE) {
+        r300_buffer_release_translated(rbuf);
+        rbuf->write_count++;
+    }
+
     if (rbuf->malloced_buffer) {
         *ptransfer = transfer;
         return rbuf->malloced_buffer + box->x;
@@ -161,7 +176,7 @@ struct pipe_resource *r300_buffer_create(struct pipe_screen *screen,
     struct r300_screen *r300screen = r300_screen(screen);
     struct r300_resource *rbuf;
 
-    rbuf = MALLOC_STRUCT(r300_resource);
+    rbuf = CALLOC_STRUCT(r300_resource);
 
     rbuf->b.b = *templ;
     rbuf->b.vtbl = &r300_buffer_vtbl;
@@ -44,6 +44,8 @@ void r300_upload_index_buffer(struct r300_context *r300,
 struct pipe_resource *r300_buffer_create(struct pipe_screen *screen,
 					 const struct pipe_resource *templ);
 
+void r300_buffer_release_translated(struct r300_resource *rbuf);
+
 /* Inline functions. */
 
 static inline struct r300_buffer *r300_buffer(struct pipe_resource *buffer)
@@ -28,6 +28,8 @@
 
 #include "sb/sb_public.h"
 
+#include "compiler/blob.h"
+
 #include "pipe/p_shader_tokens.h"
 #include "tgsi/tgsi_info.h"
 #include "tgsi/tgsi_parse.h"
@@ -36,6 +38,7 @@
 #include "util/u_bitcast.h"
 #include "util/u_memory.h"
 #include "util/u_math.h"
+#include "util/disk_cache.h"
 #include <stdio.h>
 #include <errno.h>
 
@@ -157,33 +160,173 @@ static int store_shader(struct pipe_context *ctx,
 	return 0;
 }
 
-int r600_pipe_shader_create(struct pipe_context *ctx,
-			    struct r600_pipe_shader *shader,
-			    union r600_shader_key key)
+/*
+ * Disk cache of the final bytecode.
+ *
+ * Translating from TGSI and running the sb optimizer is the bulk of the
+ * time spent in r600_pipe_shader_create, so the result of both is stored
+ * in the screen's disk cache, keyed by the TGSI tokens, the stream output
+ * info and the shader key.  A hit only needs the upload and the register
+ * state to be built.
+ */
+static bool r600_shader_cache_key(struct r600_context *rctx,
+				  struct r600_pipe_shader *shader,
+				  union r600_shader_key key,
+				  cache_key hash)
 {
-	struct r600_context *rctx = (struct r600_context *)ctx;
+	struct disk_cache *cache = rctx->screen->b.disk_shader_cache;
 	struct r600_pipe_shader_selector *sel = shader->selector;
-	int r;
-	bool dump = r600_can_dump_shader(&rctx->screen->b,
-					 tgsi_get_processor_type(sel->tokens));
-	unsigned use_sb = !(rctx->screen->b.debug_flags & DBG_NO_SB);
-	unsigned sb_disasm;
-	unsigned export_shader;
+	struct blob blob;
+	bool ok;
 
-	shader->shader.bc.isa = rctx->isa;
+	blob_init(&blob);
+	blob_write_uint64(&blob, rctx->screen->b.debug_flags);
+	blob_write_uint32(&blob, rctx->screen->has_compressed_msaa_texturing);
+	blob_write_bytes(&blob, &key, sizeof(key));
+	blob_write_bytes(&blob, &sel->so, sizeof(sel->so));
+	blob_write_bytes(&blob, sel->tokens,
+			 tgsi_num_tokens(sel->tokens) * sizeof(struct tgsi_token));
 
-	if (dump) {
-		fprintf(stderr, "--------------------------------------------------------------\n");
-		tgsi_dump(sel->tokens, 0);
+	ok = !blob.out_of_memory;
+	if (ok)
+		disk_cache_compute_key(cache, blob.data, blob.size, hash);
+	blob_finish(&blob);
+	return ok;
+}
 
-		if (sel->so.num_outputs) {
-			r600_dump_streamout(&sel->so);
+static void r600_shader_cache_write(struct blob *blob,
+				    const struct r600_pipe_shader *shader)
+{
+	const struct r600_bytecode *bc = &shader->shader.bc;
+	struct r600_shader tmp;
+
+	/* Everything but the bytecode is plain data; the sb-only register
+	 * arrays aren't needed once the bytecode is final. */
+	memcpy(&tmp, &shader->shader, sizeof(tmp));
+	memset(&tmp.bc, 0, sizeof(tmp.bc));
+	tmp.arrays = NULL;
+	tmp.num_arrays = tmp.max_arrays = 0;
+	blob_write_bytes(blob, &tmp, sizeof(tmp));
+
+	blob_write_uint32(blob, bc->type);
+	blob_write_uint32(blob, bc->ngpr);
+	blob_write_uint32(blob, bc->nstack);
+	blob_write_uint32(blob, bc->nlds_dw);
+	blob_write_uint32(blob, bc->nresource);
+	blob_write_uint32(blob, bc->ndw);
+	blob_write_bytes(blob, bc->bytecode, bc->ndw * 4);
+
+	blob_write_uint32(blob, shader->enabled_stream_buffers_mask);
+	blob_write_uint32(blob, shader->scratch_space_needed);
+}
+
+static bool r600_shader_cache_read(struct r600_context *rctx,
+				   struct blob_reader *blob,
+				   struct r600_pipe_shader *shader)
+{
+	struct r600_bytecode *bc = &shader->shader.bc;
+	unsigned ndw;
+
+	blob_copy_bytes(blob, &shader->shader, sizeof(shader->shader));
+
+	r600_bytecode_init(bc, rctx->b.chip_class, rctx->b.family,
+			   rctx->screen->has_compressed_msaa_texturing);
+	bc->isa = rctx->isa;
+	bc->type = blob_read_uint32(blob);
+	bc->ngpr = blob_read_uint32(blob);
+	bc->nstack = blob_read_uint32(blob);
+	bc->nlds_dw = blob_read_uint32(blob);
+	bc->nresource = blob_read_uint32(blob);
+	ndw = blob_read_uint32(blob);
+	if (blob->overrun || !ndw)
+		return false;
+
+	bc->bytecode = malloc(ndw * 4);
+	if (!bc->bytecode)
+		return false;
+	blob_copy_bytes(blob, bc->bytecode, ndw * 4);
+	bc->ndw = ndw;
+
+	shader->enabled_stream_buffers_mask = blob_read_uint32(blob);
+	shader->scratch_space_needed = blob_read_uint32(blob);
+	return !blob->overrun;
+}
+
+static void r600_shader_cache_store(struct r600_context *rctx,
+				    struct r600_pipe_shader *shader,
+				    const cache_key hash)
+{
+	struct blob blob;
+
+	blob_init(&blob);
+	blob_write_uint32(&blob, shader->gs_copy_shader != NULL);
+	r600_shader_cache_write(&blob, shader);
+	if (shader->gs_copy_shader)
+		r600_shader_cache_write(&blob, shader->gs_copy_shader);
+
+	if (!blob.out_of_memory)
+		disk_cache_put(rctx->screen->b.disk_shader_cache, hash,
+			       blob.data, blob.size, NULL);
+	blob_finish(&blob);
+}
+
+static bool r600_shader_cache_load(struct r600_context *rctx,
+				   struct r600_pipe_shader *shader,
+				   const cache_key hash)
+{
+	struct blob_reader blob;
+	bool ok = false;
+	size_t size;
+	void *data;
+
+	data = disk_cache_get(rctx->screen->b.disk_shader_cache, hash, &size);
+	if (!data)
+		return false;
+
+	blob_reader_init(&blob, data, size);
+	if (blob_read_uint32(&blob)) {
+		shader->gs_copy_shader = calloc(1, sizeof(struct r600_pipe_shader));
+		if (!shader->gs_copy_shader)
+			goto out;
+	}
+
+	ok = r600_shader_cache_read(rctx, &blob, shader);
+	if (ok && shader->gs_copy_shader)
+		ok = r600_shader_cache_read(rctx, &blob, shader->gs_copy_shader);
+	ok = ok && blob.current == blob.end;
+
+out:
+	free(data);
+
+	if (!ok) {
+		/* Leave the shader as the translator expects to find it. */
+		free(shader->shader.bc.bytecode);
+		memset(&shader->shader, 0, sizeof(shader->shader));
+		shader->shader.bc.isa = rctx->isa;
+		shader->enabled_stream_buffers_mask = 0;
+		shader->scratch_space_needed = 0;
+		if (shader->gs_copy_shader) {
+			free(shader->gs_copy_shader->shader.bc.bytecode);
+			free(shader->gs_copy_shader);
+			shader->gs_copy_shader = NULL;
 		}
 	}
+	return ok;
+}
+
+static int r600_pipe_shader_compile(struct r600_context *rctx,
+				    struct r600_pipe_shader *shader,
+				    union r600_shader_key key,
+				    bool dump)
+{
+	unsigned use_sb = !(rctx->screen->b.debug_flags & DBG_NO_SB);
+	unsigned sb_disasm;
+	int r;
+
 	r = r600_shader_from_tgsi(rctx, shader, key);
 	if (r) {
 		R600_ERR("translation from TGSI failed !\n");
-		goto error;
+		return r;
 	}
 	if (shader->shader.processor_type == PIPE_SHADER_VERTEX) {
 		/* only disable for vertex shaders in tess paths */
@@ -206,7 +349,7 @@ int r600_pipe_shader_create(struct pipe_context *ctx,
 		r = r600_bytecode_build(&shader->shader.bc);
 		if (r) {
 			R600_ERR("building bytecode failed !\n");
-			goto error;
+			return r;
 		}
 	}
 
@@ -220,19 +363,62 @@ int r600_pipe_shader_create(struct pipe_context *ctx,
 		                             dump, use_sb);
 		if (r) {
 			R600_ERR("r600_sb_bytecode_process failed !\n");
-			goto error;
+			return r;
 		}
 	}
 
-	if (shader->gs_copy_shader) {
-		if (dump) {
-			// dump copy shader
-			r = r600_sb_bytecode_process(rctx, &shader->gs_copy_shader->shader.bc,
-						     &shader->gs_copy_shader->shader, dump, 0);
-			if (r)
-				goto error;
+	if (shader->gs_copy_shader && dump) {
+		// dump copy shader
+		r = r600_sb_bytecode_process(rctx, &shader->gs_copy_shader->shader.bc,
+					     &shader->gs_copy_shader->shader, dump, 0);
+		if (r)
+			return r;
+	}
+	return 0;
+}
+
+int r600_pipe_shader_create(struct pipe_context *ctx,
+			    struct r600_pipe_shader *shader,
+			    union r600_shader_key key)
+{
+	struct r600_context *rctx = (struct r600_context *)ctx;
+	struct r600_pipe_shader_selector *sel = shader->selector;
+	unsigned type = tgsi_get_processor_type(sel->tokens);
+	int r;
+	bool dump = r600_can_dump_shader(&rctx->screen->b, type);
+	bool use_cache = rctx->screen->b.disk_shader_cache && !dump;
+	unsigned export_shader;
+	cache_key hash;
+
+	shader->shader.bc.isa = rctx->isa;
+
+	if (dump) {
+		fprintf(stderr, "--------------------------------------------------------------\n");
+		tgsi_dump(sel->tokens, 0);
+
+		if (sel->so.num_outputs) {
+			r600_dump_streamout(&sel->so);
 		}
+	}
 
+	/* Export shaders depend on the inputs of the bound GS as well. */
+	if ((type == PIPE_SHADER_VERTEX && key.vs.as_es) ||
+	    (type == PIPE_SHADER_TESS_EVAL && key.tes.as_es))
+		use_cache = false;
+
+	if (use_cache)
+		use_cache = r600_shader_cache_key(rctx, shader, key, hash);
+
+	if (!use_cache || !r600_shader_cache_load(rctx, shader, hash)) {
+		r = r600_pipe_shader_compile(rctx, shader, key, dump);
+		if (r)
+			goto error;
+
+		if (use_cache)
+			r600_shader_cache_store(rctx, shader, hash);
+	}
+
+	if (shader->gs_copy_shader) {
 		if ((r = store_shader(ctx, shader->gs_copy_shader)))
 			goto error;
 	}
@@ -344,10 +344,7 @@ static void *si_buffer_get_transfer(struct pipe_context *ctx,
 	struct si_context *sctx = (struct si_context*)ctx;
 	struct si_transfer *transfer;
 
-	if (usage & TC_TRANSFER_MAP_THREADED_UNSYNC)
-		transfer = slab_alloc(&sctx->pool_transfers_unsync);
-	else
-		transfer = slab_alloc(&sctx->pool_transfers);
+	transfer = slab_alloc_mt(&sctx->screen->pool_transfers);
 
 	transfer->b.b.resource = NULL;
 	pipe_resource_reference(&transfer->b.b.resource, resource);
@@ -585,9 +582,28 @@ static void si_buffer_do_flush_region(struct pipe_context *ctx,
 			return;
 		}
 
-		/* Copy the staging buffer into the original one. */
-		si_copy_buffer(sctx, transfer->resource, &stransfer->staging->b.b,
-			       box->x, src_offset, box->width);
+		/* Copy large uploads with SDMA, so that they can overlap with
+		 * the rendering on the gfx ring. The winsys makes gfx wait for
+		 * the copy when the buffer is used. Skip it if the buffer is
+		 * used by the current gfx IB, because SDMA would have to wait
+		 * for that IB to be flushed.
+		 */
+		if (sctx->dma_cs &&
+		    box->width >= SI_SDMA_BUFFER_UPLOAD_MIN_SIZE &&
+		    !(buf->flags & RADEON_FLAG_SPARSE) &&
+		    !sctx->ws->cs_is_buffer_referenced(sctx->gfx_cs, buf->buf,
+						       RADEON_USAGE_READWRITE)) {
+			struct pipe_box src_box;
+
+			u_box_1d(src_offset, box->width, &src_box);
+			sctx->dma_copy(ctx, transfer->resource, 0, box->x, 0, 0,
+				       &stransfer->staging->b.b, 0, &src_box);
+		} else {
+			/* Copy the staging buffer into the original one. */
+			si_copy_buffer(sctx, transfer->resource,
+				       &stransfer->staging->b.b,
+				       box->x, src_offset, box->width);
+		}
 	}
 
 	util_range_add(&buf->valid_buffer_range, box->x,
@@ -623,9 +639,7 @@ static void si_buffer_transfer_unmap(struct pipe_context *ctx,
 	assert(stransfer->b.staging == NULL); /* for threaded context only */
 	pipe_resource_reference(&transfer->resource, NULL);
 
-	/* Don't use pool_transfers_unsync. We are always in the driver
-	 * thread. */
-	slab_free(&sctx->pool_transfers, transfer);
+	slab_free_mt(&sctx->screen->pool_transfers, transfer);
 }
 
 static void si_buffer_subdata(struct pipe_context *ctx,
@@ -59,14 +59,14 @@ unsigned si_get_flush_flags(struct si_context *sctx, enum si_coherency coher,
 	}
 }
 
-static void si_compute_internal_begin(struct si_context *sctx)
+void si_compute_internal_begin(struct si_context *sctx)
 {
 	sctx->flags &= ~SI_CONTEXT_START_PIPELINE_STATS;
 	sctx->flags |= SI_CONTEXT_STOP_PIPELINE_STATS;
 	sctx->render_cond_force_off = true;
 }
 
-static void si_compute_internal_end(struct si_context *sctx)
+void si_compute_internal_end(struct si_context *sctx)
 {
 	sctx->flags &= ~SI_CONTEXT_STOP_PIPELINE_STATS;
 	sctx->flags |= SI_CONTEXT_START_PIPELINE_STATS;
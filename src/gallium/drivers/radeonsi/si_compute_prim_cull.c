@@ -0,0 +1,316 @@
+/*
+ * Copyright 2019 Advanced Micro Devices, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * on the rights to use, copy, modify, merge, publish, distribute, sub
+ * license, and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHOR(S) AND/OR THEIR SUPPLIERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+ * USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Compute-based primitive culling (AMD_DEBUG=primcull).
+ *
+ * Large triangle list draws are first run through a compute shader, which
+ * removes triangles that are culled by the rasterizer state, have zero area
+ * or lie entirely outside of one of the X/Y clip planes, and appends the
+ * other triangles to a new index buffer. The draw is then executed as an
+ * indirect draw with the index count written by the compute shader. This
+ * helps when the fixed-function primitive pipeline is the bottleneck.
+ *
+ * The compute shader can't execute the vertex shader, so this is only done
+ * for vertex shaders copying an R32G32B32A32_FLOAT input to the position.
+ * Triangles are appended in an undefined order, so the draw must not depend
+ * on primitive order.
+ */
+
+#include "si_pipe.h"
+#include "tgsi/tgsi_info.h"
+#include "tgsi/tgsi_parse.h"
+#include "util/u_suballoc.h"
+#include "util/u_upload_mgr.h"
+
+/* Smaller draws aren't worth the compute dispatch and the wait for idle. */
+#define SI_PRIM_CULL_MIN_TRIANGLES	(16 * 1024)
+/* Larger draws are split, so that the output fits into the suballocator. */
+#define SI_PRIM_CULL_MAX_TRIANGLES	(256 * 1024)
+
+/* Return the VS input that is written to the position unmodified, or -1. */
+int si_get_vs_position_passthrough_input(const struct tgsi_token *tokens)
+{
+	struct tgsi_parse_context parse;
+	int pos_output = -1, input = -1;
+	unsigned num_pos_writes = 0;
+	bool in_control_flow = false;
+	bool ok = true;
+
+	if (tgsi_parse_init(&parse, tokens) != TGSI_PARSE_OK)
+		return -1;
+
+	while (ok && !tgsi_parse_end_of_tokens(&parse)) {
+		tgsi_parse_token(&parse);
+
+		if (parse.FullToken.Token.Type == TGSI_TOKEN_TYPE_DECLARATION) {
+			const struct tgsi_full_declaration *decl =
+				&parse.FullToken.FullDeclaration;
+
+			if (decl->Declaration.File == TGSI_FILE_OUTPUT &&
+			    decl->Declaration.Semantic &&
+			    decl->Semantic.Name == TGSI_SEMANTIC_POSITION)
+				pos_output = decl->Range.First;
+			continue;
+		}
+
+		if (parse.FullToken.Token.Type != TGSI_TOKEN_TYPE_INSTRUCTION)
+			continue;
+
+		const struct tgsi_full_instruction *inst =
+			&parse.FullToken.FullInstruction;
+
+		if (tgsi_get_opcode_info(inst->Instruction.Opcode)->post_indent)
+			in_control_flow = true;
+
+		for (unsigned i = 0; i < inst->Instruction.NumDstRegs; i++) {
+			const struct tgsi_full_dst_register *dst = &inst->Dst[i];
+			const struct tgsi_full_src_register *src = &inst->Src[0];
+
+			if (dst->Register.File != TGSI_FILE_OUTPUT)
+				continue;
+
+			if (dst->Register.Indirect) {
+				ok = false;
+				break;
+			}
+
+			if (dst->Register.Index != pos_output)
+				continue;
+
+			num_pos_writes++;
+
+			if (in_control_flow ||
+			    inst->Instruction.Opcode != TGSI_OPCODE_MOV ||
+			    inst->Instruction.Saturate ||
+			    dst->Register.WriteMask != TGSI_WRITEMASK_XYZW ||
+			    src->Register.File != TGSI_FILE_INPUT ||
+			    src->Register.Indirect ||
+			    src->Register.Absolute ||
+			    src->Register.Negate ||
+			    src->Register.SwizzleX != TGSI_SWIZZLE_X ||
+			    src->Register.SwizzleY != TGSI_SWIZZLE_Y ||
+			    src->Register.SwizzleZ != TGSI_SWIZZLE_Z ||
+			    src->Register.SwizzleW != TGSI_SWIZZLE_W) {
+				ok = false;
+				break;
+			}
+
+			input = src->Register.Index;
+		}
+	}
+	tgsi_parse_free(&parse);
+
+	return ok && num_pos_writes == 1 ? input : -1;
+}
+
+/* Cull the triangles of a draw in a compute shader and draw the rest.
+ * Return false if the draw wasn't handled.
+ */
+bool si_prim_cull_draw(struct si_context *sctx,
+		       const struct pipe_draw_info *info)
+{
+	struct pipe_context *ctx = &sctx->b;
+	struct si_shader_selector *vs = sctx->vs_shader.cso;
+	struct si_shader_selector *ps = sctx->ps_shader.cso;
+	struct si_state_rasterizer *rs = sctx->queued.named.rasterizer;
+	struct si_vertex_elements *velems = sctx->vertex_elements;
+	struct pipe_resource *indexbuf = info->index.resource;
+	unsigned index_size = info->index_size;
+	unsigned num_triangles = info->count / 3;
+
+	if (sctx->in_prim_cull ||
+	    info->mode != PIPE_PRIM_TRIANGLES ||
+	    (index_size != 2 && index_size != 4) ||
+	    info->has_user_indices ||
+	    info->indirect ||
+	    info->count_from_stream_output ||
+	    info->primitive_restart ||
+	    info->instance_count != 1 ||
+	    num_triangles < SI_PRIM_CULL_MIN_TRIANGLES ||
+	    (info->start * index_size) % 4 ||
+	    info->start * index_size >= indexbuf->width0)
+		return false;
+
+	/* Culling mustn't be observable, other than by fewer VS invocations. */
+	if (!vs || !rs || !velems ||
+	    sctx->tes_shader.cso ||
+	    sctx->gs_shader.cso ||
+	    vs->pos_passthrough_input < 0 ||
+	    vs->info.writes_memory ||
+	    vs->info.writes_viewport_index ||
+	    vs->info.properties[TGSI_PROPERTY_VS_WINDOW_SPACE_POSITION] ||
+	    rs->rasterizer_discard ||
+	    rs->polygon_mode_enabled ||
+	    (ps && ps->info.uses_primid) ||
+	    si_get_strmout_en(sctx) ||
+	    sctx->num_pipeline_stat_queries ||
+	    !si_primitive_order_invariant(sctx))
+		return false;
+
+	unsigned input = vs->pos_passthrough_input;
+	if (input >= velems->count ||
+	    !(velems->is_xyzw_float & (1u << input)))
+		return false;
+
+	struct pipe_vertex_buffer *vb =
+		&sctx->vertex_buffer[velems->vertex_buffer_index[input]];
+	unsigned pos_offset = vb->buffer_offset + velems->src_offset[input];
+
+	if (vb->is_user_buffer ||
+	    !vb->buffer.resource ||
+	    vb->stride % 4 ||
+	    pos_offset % 4 ||
+	    pos_offset >= vb->buffer.resource->width0)
+		return false;
+
+	unsigned variant = index_size == 4;
+	if (!sctx->cs_prim_cull[variant]) {
+		sctx->cs_prim_cull[variant] = si_create_prim_cull_cs(ctx, index_size);
+		if (!sctx->cs_prim_cull[variant])
+			return false;
+	}
+
+	if (!sctx->prim_cull_allocator) {
+		sctx->prim_cull_allocator =
+			u_suballocator_create(ctx, SI_PRIM_CULL_MAX_TRIANGLES * 12 * 4,
+					      PIPE_BIND_INDEX_BUFFER |
+					      PIPE_BIND_SHADER_BUFFER,
+					      PIPE_USAGE_DEFAULT, 0, false);
+		if (!sctx->prim_cull_allocator)
+			return false;
+	}
+
+	/* A positive determinant means counter-clockwise in NDC, which
+	 * becomes clockwise if the viewport mirrors one axis.
+	 */
+	const struct pipe_viewport_state *vp = &sctx->viewports.states[0];
+	bool pos_det_is_front = (vp->scale[0] * vp->scale[1] >= 0) == rs->front_ccw;
+	unsigned cull_flags =
+		((pos_det_is_front ? rs->cull_front : rs->cull_back) ? 0x1 : 0) |
+		((pos_det_is_front ? rs->cull_back : rs->cull_front) ? 0x2 : 0);
+
+	/* Save states. */
+	void *saved_cs = sctx->cs_shader_state.program;
+	struct pipe_shader_buffer saved_sb[4] = {};
+	unsigned saved_writable_mask = 0;
+
+	si_get_shader_buffers(sctx, PIPE_SHADER_COMPUTE, 0, 4, saved_sb);
+	for (unsigned i = 0; i < 4; i++) {
+		if (sctx->const_and_shader_buffers[PIPE_SHADER_COMPUTE].writable_mask &
+		    (1u << si_get_shaderbuf_slot(i)))
+			saved_writable_mask |= 1 << i;
+	}
+
+	struct pipe_draw_indirect_info indirect = {};
+	struct pipe_draw_info draw = *info;
+	draw.index_size = 4;
+	draw.indirect = &indirect;
+
+	for (unsigned first = 0; first < num_triangles;
+	     first += SI_PRIM_CULL_MAX_TRIANGLES) {
+		unsigned count = MIN2(num_triangles - first, SI_PRIM_CULL_MAX_TRIANGLES);
+		unsigned index_offset = (info->start + first * 3) * index_size;
+		/* count, instance_count, start, index_bias, start_instance */
+		uint32_t args[5] = {0, 1, 0, info->index_bias, info->start_instance};
+		struct pipe_resource *out = NULL, *args_buf = NULL;
+		unsigned out_offset, args_offset;
+
+		u_suballocator_alloc(sctx->prim_cull_allocator, count * 12, 256,
+				     &out_offset, &out);
+		u_upload_data(sctx->cached_gtt_allocator, 0, sizeof(args), 4,
+			      args, &args_offset, &args_buf);
+		if (!out || !args_buf) {
+			pipe_resource_reference(&out, NULL);
+			pipe_resource_reference(&args_buf, NULL);
+
+			/* Draw the remaining triangles without culling. */
+			draw = *info;
+			draw.start += first * 3;
+			draw.count = (num_triangles - first) * 3;
+			sctx->in_prim_cull = true;
+			ctx->draw_vbo(ctx, &draw);
+			sctx->in_prim_cull = false;
+			break;
+		}
+
+		struct pipe_shader_buffer sb[4] = {};
+		sb[0].buffer = indexbuf;
+		sb[0].buffer_offset = index_offset;
+		sb[0].buffer_size = indexbuf->width0 - index_offset;
+		sb[1].buffer = vb->buffer.resource;
+		sb[1].buffer_offset = pos_offset;
+		sb[1].buffer_size = vb->buffer.resource->width0 - pos_offset;
+		sb[2].buffer = out;
+		sb[2].buffer_offset = out_offset;
+		sb[2].buffer_size = count * 12;
+		sb[3].buffer = args_buf;
+		sb[3].buffer_offset = args_offset;
+		sb[3].buffer_size = sizeof(args);
+
+		struct pipe_grid_info grid = {};
+		grid.block[0] = 64;
+		grid.block[1] = 1;
+		grid.block[2] = 1;
+		grid.grid[0] = DIV_ROUND_UP(count, 64);
+		grid.grid[1] = 1;
+		grid.grid[2] = 1;
+
+		sctx->cs_user_data[0] = count;
+		sctx->cs_user_data[1] = vb->stride;
+		sctx->cs_user_data[2] = info->index_bias;
+		sctx->cs_user_data[3] = cull_flags;
+
+		si_compute_internal_begin(sctx);
+		ctx->set_shader_buffers(ctx, PIPE_SHADER_COMPUTE, 0, 4, sb, 0xc);
+		ctx->bind_compute_state(ctx, sctx->cs_prim_cull[variant]);
+		ctx->launch_grid(ctx, &grid);
+		si_compute_internal_end(sctx);
+
+		/* The draw reads the results through the index fetch and
+		 * the CP, which don't use TC L2 on older chips. This is
+		 * handled by draw_vbo.
+		 */
+		sctx->flags |= SI_CONTEXT_CS_PARTIAL_FLUSH;
+		si_resource(out)->TC_L2_dirty = true;
+		si_resource(args_buf)->TC_L2_dirty = true;
+
+		draw.index.resource = out;
+		draw.start = out_offset / 4;
+		indirect.buffer = args_buf;
+		indirect.offset = args_offset;
+		ctx->draw_vbo(ctx, &draw);
+
+		pipe_resource_reference(&out, NULL);
+		pipe_resource_reference(&args_buf, NULL);
+	}
+
+	/* Restore states. */
+	ctx->bind_compute_state(ctx, saved_cs);
+	ctx->set_shader_buffers(ctx, PIPE_SHADER_COMPUTE, 0, 4, saved_sb,
+				saved_writable_mask);
+	for (unsigned i = 0; i < 4; i++)
+		pipe_resource_reference(&saved_sb[i].buffer, NULL);
+
+	return true;
+}
@@ -138,6 +138,25 @@ static void si_release_descriptors(struct si_descriptors *desc)
 	FREE(desc->list);
 }
 
+/* Queue a bindless slot for upload. Only the changed slots are written into
+ * the current bindless buffer before the next draw, unless the whole array
+ * has to be re-uploaded anyway.
+ */
+static void si_mark_bindless_descriptor_dirty(struct si_context *sctx,
+					      unsigned desc_slot,
+					      bool *desc_dirty,
+					      bool wait_idle)
+{
+	sctx->bindless_descriptors_dirty = true;
+	sctx->bindless_descriptors_wait_idle |= wait_idle;
+
+	if (*desc_dirty)
+		return;
+
+	*desc_dirty = true;
+	util_dynarray_append(&sctx->bindless_dirty_slots, unsigned, desc_slot);
+}
+
 static bool si_upload_descriptors(struct si_context *sctx,
 				  struct si_descriptors *desc)
 {
@@ -1789,8 +1808,9 @@ void si_rebind_buffer(struct si_context *sctx, struct pipe_resource *buf)
 							descs->list +
 							desc_slot * 16 + 4);
 
-				(*tex_handle)->desc_dirty = true;
-				sctx->bindless_descriptors_dirty = true;
+				si_mark_bindless_descriptor_dirty(sctx, desc_slot,
+								  &(*tex_handle)->desc_dirty,
+								  true);
 
 				radeon_add_to_gfx_buffer_list_check_mem(
 					sctx, si_resource(buffer),
@@ -1820,8 +1840,9 @@ void si_rebind_buffer(struct si_context *sctx, struct pipe_resource *buf)
 							descs->list +
 							desc_slot * 16 + 4);
 
-				(*img_handle)->desc_dirty = true;
-				sctx->bindless_descriptors_dirty = true;
+				si_mark_bindless_descriptor_dirty(sctx, desc_slot,
+								  &(*img_handle)->desc_dirty,
+								  true);
 
 				radeon_add_to_gfx_buffer_list_check_mem(
 					sctx, si_resource(buffer),
@@ -1845,61 +1866,88 @@ void si_rebind_buffer(struct si_context *sctx, struct pipe_resource *buf)
 	}
 }
 
-static void si_upload_bindless_descriptor(struct si_context *sctx,
-					  unsigned desc_slot,
-					  unsigned num_dwords)
+static bool *si_get_bindless_desc_dirty(struct si_context *sctx,
+					unsigned desc_slot)
 {
-	struct si_descriptors *desc = &sctx->bindless_descriptors;
-	unsigned desc_slot_offset = desc_slot * 16;
-	uint32_t *data;
-	uint64_t va;
+	struct hash_entry *entry;
+
+	entry = _mesa_hash_table_search(sctx->tex_handles,
+					(void *)(uintptr_t)desc_slot);
+	if (entry)
+		return &((struct si_texture_handle *)entry->data)->desc_dirty;
 
-	data = desc->list + desc_slot_offset;
-	va = desc->gpu_address + desc_slot_offset * 4;
+	entry = _mesa_hash_table_search(sctx->img_handles,
+					(void *)(uintptr_t)desc_slot);
+	if (entry)
+		return &((struct si_image_handle *)entry->data)->desc_dirty;
 
-	si_cp_write_data(sctx, desc->buffer, va - desc->buffer->gpu_address,
-			 num_dwords * 4, V_370_TC_L2, V_370_ME, data);
+	return NULL;
 }
 
-static void si_upload_bindless_descriptors(struct si_context *sctx)
+static bool si_upload_bindless_descriptors(struct si_context *sctx)
 {
+	struct si_descriptors *desc = &sctx->bindless_descriptors;
+
 	if (!sctx->bindless_descriptors_dirty)
-		return;
+		return true;
 
-	/* Wait for graphics/compute to be idle before updating the resident
-	 * descriptors directly in memory, in case the GPU is using them.
-	 */
-	sctx->flags |= SI_CONTEXT_PS_PARTIAL_FLUSH |
-			 SI_CONTEXT_CS_PARTIAL_FLUSH;
-	si_emit_cache_flush(sctx);
+	if (sctx->bindless_descriptors_realloc) {
+		/* Re-upload the whole array of bindless descriptors into a
+		 * new buffer, which includes all dirty slots.
+		 */
+		if (!si_upload_descriptors(sctx, desc))
+			return false;
 
-	util_dynarray_foreach(&sctx->resident_tex_handles,
-			      struct si_texture_handle *, tex_handle) {
-		unsigned desc_slot = (*tex_handle)->desc_slot;
+		sctx->bindless_num_uploaded_slots = desc->num_elements;
+		sctx->bindless_descriptors_realloc = false;
 
-		if (!(*tex_handle)->desc_dirty)
-			continue;
+		/* Make sure to re-emit the shader pointers for all stages. */
+		sctx->graphics_bindless_pointer_dirty = true;
+		sctx->compute_bindless_pointer_dirty = true;
+	} else {
+		/* Wait for graphics/compute to be idle before updating the
+		 * resident descriptors directly in memory, in case the GPU
+		 * is using them. Slots which have never been handed out
+		 * before can't be in use.
+		 */
+		if (sctx->bindless_descriptors_wait_idle) {
+			sctx->flags |= SI_CONTEXT_PS_PARTIAL_FLUSH |
+					 SI_CONTEXT_CS_PARTIAL_FLUSH;
+			si_emit_cache_flush(sctx);
+		}
 
-		si_upload_bindless_descriptor(sctx, desc_slot, 16);
-		(*tex_handle)->desc_dirty = false;
-	}
+		util_dynarray_foreach(&sctx->bindless_dirty_slots,
+				      unsigned, desc_slot) {
+			unsigned desc_slot_offset = *desc_slot * 16;
 
-	util_dynarray_foreach(&sctx->resident_img_handles,
-			      struct si_image_handle *, img_handle) {
-		unsigned desc_slot = (*img_handle)->desc_slot;
+			/* The handle has been deleted since. */
+			if (!si_get_bindless_desc_dirty(sctx, *desc_slot))
+				continue;
 
-		if (!(*img_handle)->desc_dirty)
-			continue;
+			si_cp_write_data(sctx, desc->buffer,
+					 desc->gpu_address + desc_slot_offset * 4 -
+					 desc->buffer->gpu_address,
+					 16 * 4, V_370_TC_L2, V_370_ME,
+					 desc->list + desc_slot_offset);
+		}
 
-		si_upload_bindless_descriptor(sctx, desc_slot, 8);
-		(*img_handle)->desc_dirty = false;
+		/* Invalidate L1 because it doesn't know that L2 changed. */
+		sctx->flags |= SI_CONTEXT_INV_SMEM_L1;
+		si_emit_cache_flush(sctx);
 	}
 
-	/* Invalidate L1 because it doesn't know that L2 changed. */
-	sctx->flags |= SI_CONTEXT_INV_SMEM_L1;
-	si_emit_cache_flush(sctx);
+	util_dynarray_foreach(&sctx->bindless_dirty_slots,
+			      unsigned, desc_slot) {
+		bool *desc_dirty = si_get_bindless_desc_dirty(sctx, *desc_slot);
 
+		if (desc_dirty)
+			*desc_dirty = false;
+	}
+
+	util_dynarray_clear(&sctx->bindless_dirty_slots);
+	sctx->bindless_descriptors_wait_idle = false;
 	sctx->bindless_descriptors_dirty = false;
+	return true;
 }
 
 /* Update mutable image descriptor fields of all resident textures. */
@@ -1920,8 +1968,8 @@ static void si_update_bindless_texture_descriptor(struct si_context *sctx,
 
 	if (memcmp(desc_list, desc->list + desc_slot_offset,
 		   sizeof(desc_list))) {
-		tex_handle->desc_dirty = true;
-		sctx->bindless_descriptors_dirty = true;
+		si_mark_bindless_descriptor_dirty(sctx, tex_handle->desc_slot,
+						  &tex_handle->desc_dirty, true);
 	}
 }
 
@@ -1943,8 +1991,8 @@ static void si_update_bindless_image_descriptor(struct si_context *sctx,
 
 	if (memcmp(desc_list, desc->list + desc_slot_offset,
 		   sizeof(desc_list))) {
-		img_handle->desc_dirty = true;
-		sctx->bindless_descriptors_dirty = true;
+		si_mark_bindless_descriptor_dirty(sctx, img_handle->desc_slot,
+						  &img_handle->desc_dirty, true);
 	}
 }
 
@@ -2289,7 +2337,7 @@ static unsigned si_get_first_free_bindless_slot(struct si_context *sctx)
 
 static unsigned
 si_create_bindless_descriptor(struct si_context *sctx, uint32_t *desc_list,
-			      unsigned size)
+			      unsigned size, bool *desc_dirty)
 {
 	struct si_descriptors *desc = &sctx->bindless_descriptors;
 	unsigned desc_slot, desc_slot_offset;
@@ -2306,14 +2354,19 @@ si_create_bindless_descriptor(struct si_context *sctx, uint32_t *desc_list,
 	/* Copy the descriptor into the array. */
 	memcpy(desc->list + desc_slot_offset, desc_list, size);
 
-	/* Re-upload the whole array of bindless descriptors into a new buffer.
+	/* The slot doesn't fit into the current buffer, re-upload the whole
+	 * array of bindless descriptors into a new one before the next draw.
+	 * Otherwise, only upload this slot. A slot which has never been used
+	 * can't be referenced by in-flight work, so it doesn't need the wait
+	 * for idle.
 	 */
-	if (!si_upload_descriptors(sctx, desc))
-		return 0;
+	if (desc_slot >= sctx->bindless_num_uploaded_slots)
+		sctx->bindless_descriptors_realloc = true;
 
-	/* Make sure to re-emit the shader pointers for all stages. */
-	sctx->graphics_bindless_pointer_dirty = true;
-	sctx->compute_bindless_pointer_dirty = true;
+	si_mark_bindless_descriptor_dirty(sctx, desc_slot, desc_dirty,
+					  desc_slot <= sctx->bindless_max_used_slot);
+	sctx->bindless_max_used_slot = MAX2(sctx->bindless_max_used_slot,
+					    desc_slot);
 
 	return desc_slot;
 }
@@ -2341,7 +2394,8 @@ static void si_update_bindless_buffer_descriptor(struct si_context *sctx,
 		 */
 		si_set_buf_desc_address(buf, offset, &desc_list[0]);
 
-		*desc_dirty = true;
+		si_mark_bindless_descriptor_dirty(sctx, desc_slot, desc_dirty,
+						  true);
 	}
 }
 
@@ -2374,7 +2428,8 @@ static uint64_t si_create_texture_handle(struct pipe_context *ctx,
 	ctx->delete_sampler_state(ctx, sstate);
 
 	tex_handle->desc_slot = si_create_bindless_descriptor(sctx, desc_list,
-							      sizeof(desc_list));
+							      sizeof(desc_list),
+							      &tex_handle->desc_dirty);
 	if (!tex_handle->desc_slot) {
 		FREE(tex_handle);
 		return 0;
@@ -2465,12 +2520,6 @@ static void si_make_texture_handle_resident(struct pipe_context *ctx,
 							     &tex_handle->desc_dirty);
 		}
 
-		/* Re-upload the descriptor if it has been updated while it
-		 * wasn't resident.
-		 */
-		if (tex_handle->desc_dirty)
-			sctx->bindless_descriptors_dirty = true;
-
 		/* Add the texture handle to the per-context list. */
 		util_dynarray_append(&sctx->resident_tex_handles,
 				     struct si_texture_handle *, tex_handle);
@@ -2520,7 +2569,8 @@ static uint64_t si_create_image_handle(struct pipe_context *ctx,
 	si_set_shader_image_desc(sctx, view, false, &desc_list[0], NULL);
 
 	img_handle->desc_slot = si_create_bindless_descriptor(sctx, desc_list,
-							      sizeof(desc_list));
+							      sizeof(desc_list),
+							      &img_handle->desc_dirty);
 	if (!img_handle->desc_slot) {
 		FREE(img_handle);
 		return 0;
@@ -2604,12 +2654,6 @@ static void si_make_image_handle_resident(struct pipe_context *ctx,
 							     &img_handle->desc_dirty);
 		}
 
-		/* Re-upload the descriptor if it has been updated while it
-		 * wasn't resident.
-		 */
-		if (img_handle->desc_dirty)
-			sctx->bindless_descriptors_dirty = true;
-
 		/* Add the image handle to the per-context list. */
 		util_dynarray_append(&sctx->resident_img_handles,
 				     struct si_image_handle *, img_handle);
@@ -2800,9 +2844,7 @@ static bool si_upload_shader_descriptors(struct si_context *sctx, unsigned mask)
 
 	sctx->descriptors_dirty &= ~mask;
 
-	si_upload_bindless_descriptors(sctx);
-
-	return true;
+	return si_upload_bindless_descriptors(sctx);
 }
 
 bool si_upload_graphics_shader_descriptors(struct si_context *sctx)
@@ -499,6 +499,7 @@ static const struct nir_shader_compiler_options nir_options = {
 	.lower_extract_word = true,
 	.optimize_sample_mask_in = true,
 	.max_unroll_iterations = 32,
+	.loop_partial_unroll_factor = 2,
 	.native_integers = true,
 };
 
@@ -95,6 +95,7 @@ static const struct debug_named_value debug_options[] = {
 	{ "nodccfb", DBG(NO_DCC_FB), "Disable separate DCC on the main framebuffer" },
 	{ "nodccmsaa", DBG(NO_DCC_MSAA), "Disable DCC for MSAA" },
 	{ "nofmask", DBG(NO_FMASK), "Disable MSAA compression" },
+	{ "primcull", DBG(PRIM_CULL), "Cull large triangle list draws in a compute shader (only for pass-through position VS)." },
 
 	/* Tests: */
 	{ "testdma", DBG(TEST_DMA), "Invoke SDMA tests and exit." },
@@ -214,6 +215,10 @@ static void si_destroy_context(struct pipe_context *context)
 		sctx->b.delete_compute_state(&sctx->b, sctx->cs_clear_render_target_1d_array);
 	if (sctx->cs_dcc_retile)
 		sctx->b.delete_compute_state(&sctx->b, sctx->cs_dcc_retile);
+	for (unsigned i = 0; i < ARRAY_SIZE(sctx->cs_prim_cull); i++) {
+		if (sctx->cs_prim_cull[i])
+			sctx->b.delete_compute_state(&sctx->b, sctx->cs_prim_cull[i]);
+	}
 
 	if (sctx->blitter)
 		util_blitter_destroy(sctx->blitter);
@@ -247,11 +252,10 @@ static void si_destroy_context(struct pipe_context *context)
 	if (sctx->cached_gtt_allocator)
 		u_upload_destroy(sctx->cached_gtt_allocator);
 
-	slab_destroy_child(&sctx->pool_transfers);
-	slab_destroy_child(&sctx->pool_transfers_unsync);
-
 	if (sctx->allocator_zeroed_memory)
 		u_suballocator_destroy(sctx->allocator_zeroed_memory);
+	if (sctx->prim_cull_allocator)
+		u_suballocator_destroy(sctx->prim_cull_allocator);
 
 	sctx->ws->fence_reference(&sctx->last_gfx_fence, NULL);
 	sctx->ws->fence_reference(&sctx->last_sdma_fence, NULL);
@@ -264,6 +268,7 @@ static void si_destroy_context(struct pipe_context *context)
 	_mesa_hash_table_destroy(sctx->tex_handles, NULL);
 	_mesa_hash_table_destroy(sctx->img_handles, NULL);
 
+	util_dynarray_fini(&sctx->bindless_dirty_slots);
 	util_dynarray_fini(&sctx->resident_tex_handles);
 	util_dynarray_fini(&sctx->resident_img_handles);
 	util_dynarray_fini(&sctx->resident_tex_needs_color_decompress);
@@ -406,9 +411,6 @@ static struct pipe_context *si_create_context(struct pipe_screen *screen,
 	sctx->screen = sscreen; /* Easy accessing of screen/winsys. */
 	sctx->is_debug = (flags & PIPE_CONTEXT_DEBUG) != 0;
 
-	slab_create_child(&sctx->pool_transfers, &sscreen->pool_transfers);
-	slab_create_child(&sctx->pool_transfers_unsync, &sscreen->pool_transfers);
-
 	sctx->ws = sscreen->ws;
 	sctx->family = sscreen->info.family;
 	sctx->chip_class = sscreen->info.chip_class;
@@ -438,9 +440,13 @@ static struct pipe_context *si_create_context(struct pipe_screen *screen,
 	if (!sctx->allocator_zeroed_memory)
 		goto fail;
 
-	sctx->b.stream_uploader = u_upload_create(&sctx->b, 1024 * 1024,
-						    0, PIPE_USAGE_STREAM,
-						    SI_RESOURCE_FLAG_READ_ONLY);
+	/* The threaded context clones the stream uploader for the application
+	 * thread. Sharing the upload buffers with the clone avoids keeping a
+	 * partially used buffer on each side.
+	 */
+	sctx->b.stream_uploader = u_upload_create_shared(&sctx->b, 1024 * 1024,
+							   0, PIPE_USAGE_STREAM,
+							   SI_RESOURCE_FLAG_READ_ONLY);
 	if (!sctx->b.stream_uploader)
 		goto fail;
 
@@ -621,6 +627,7 @@ static struct pipe_context *si_create_context(struct pipe_screen *screen,
 	sctx->img_handles = _mesa_hash_table_create(NULL, _mesa_hash_pointer,
 						    _mesa_key_pointer_equal);
 
+	util_dynarray_init(&sctx->bindless_dirty_slots, NULL);
 	util_dynarray_init(&sctx->resident_tex_handles, NULL);
 	util_dynarray_init(&sctx->resident_img_handles, NULL);
 	util_dynarray_init(&sctx->resident_tex_needs_color_decompress, NULL);
@@ -678,7 +685,7 @@ static struct pipe_context *si_pipe_create_context(struct pipe_screen *screen,
 
 	/* Use asynchronous flushes only on amdgpu, since the radeon
 	 * implementation for fence_server_sync is incomplete. */
-	return threaded_context_create(ctx, &sscreen->pool_transfers,
+	return threaded_context_create(ctx, &sscreen->pool_transfers.parent,
 				       si_replace_buffer_storage,
 				       sscreen->info.drm_major >= 3 ? si_create_fence : NULL,
 				       &((struct si_context*)ctx)->tc);
@@ -740,7 +747,7 @@ static void si_destroy_screen(struct pipe_screen* pscreen)
 
 	mtx_destroy(&sscreen->gpu_load_mutex);
 
-	slab_destroy_parent(&sscreen->pool_transfers);
+	slab_destroy_mt(&sscreen->pool_transfers);
 
 	disk_cache_destroy(sscreen->disk_shader_cache);
 	sscreen->ws->destroy(sscreen->ws);
@@ -944,8 +951,8 @@ struct pipe_screen *radeonsi_screen_create(struct radeon_winsys *ws,
 	if (sscreen->debug_flags & DBG(INFO))
 		ac_print_gpu_info(&sscreen->info);
 
-	slab_create_parent(&sscreen->pool_transfers,
-			   sizeof(struct si_transfer), 64);
+	slab_create_mt(&sscreen->pool_transfers,
+		       sizeof(struct si_transfer), 64);
 
 	sscreen->force_aniso = MIN2(16, debug_get_num_option("R600_TEX_ANISO", -1));
 	if (sscreen->force_aniso >= 0) {
@@ -990,7 +997,9 @@ struct pipe_screen *radeonsi_screen_create(struct radeon_winsys *ws,
 	if (!util_queue_init(&sscreen->shader_compiler_queue, "sh",
 			     64, num_comp_hi_threads,
 			     UTIL_QUEUE_INIT_RESIZE_IF_FULL |
-			     UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY)) {
+			     UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY |
+			     UTIL_QUEUE_INIT_SHARED |
+			     UTIL_QUEUE_INIT_HIGH_PRIORITY)) {
 		si_destroy_shader_cache(sscreen);
 		FREE(sscreen);
 		return NULL;
@@ -1001,12 +1010,18 @@ struct pipe_screen *radeonsi_screen_create(struct radeon_winsys *ws,
 			     64, num_comp_lo_threads,
 			     UTIL_QUEUE_INIT_RESIZE_IF_FULL |
 			     UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY |
-			     UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY)) {
+			     UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY |
+			     UTIL_QUEUE_INIT_SHARED)) {
 	       si_destroy_shader_cache(sscreen);
 	       FREE(sscreen);
 	       return NULL;
 	}
 
+	sscreen->compile_stats.disk_cache = sscreen->disk_shader_cache;
+	sscreen->compile_stats.queues[0] = &sscreen->shader_compiler_queue;
+	sscreen->compile_stats.queues[1] =
+		&sscreen->shader_compiler_queue_low_priority;
+
 	if (!debug_get_bool_option("RADEON_DISABLE_PERFCOUNTERS", false))
 		si_init_perfcounters(sscreen);
 
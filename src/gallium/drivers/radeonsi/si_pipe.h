@@ -28,6 +28,7 @@
 #include "si_shader.h"
 #include "si_state.h"
 
+#include "util/u_compile_stats.h"
 #include "util/u_dynarray.h"
 #include "util/u_idalloc.h"
 #include "util/u_threaded_context.h"
@@ -100,6 +101,8 @@
 #define SI_MAX_VIEWPORTS		16
 #define SIX_BITS			0x3F
 #define SI_MAP_BUFFER_ALIGNMENT		64
+/* Staging buffer uploads at least this large are copied with SDMA. */
+#define SI_SDMA_BUFFER_UPLOAD_MIN_SIZE	(256 * 1024)
 #define SI_MAX_VARIABLE_THREADS_PER_BLOCK 1024
 
 #define SI_RESOURCE_FLAG_TRANSFER	(PIPE_RESOURCE_FLAG_DRV_PRIV << 0)
@@ -180,6 +183,7 @@ enum {
 	DBG_NO_DCC_FB,
 	DBG_NO_DCC_MSAA,
 	DBG_NO_FMASK,
+	DBG_PRIM_CULL,
 
 	/* Tests: */
 	DBG_TEST_DMA,
@@ -489,7 +493,10 @@ struct si_screen {
 	bool				dcc_msaa_allowed;
 	bool				cpdma_prefetch_writes_memory;
 
-	struct slab_parent_pool		pool_transfers;
+	/* Buffer transfers of all contexts. Each thread, such as the driver
+	 * and application threads of a threaded context, allocates from its
+	 * own cache. */
+	struct slab_mt_pool		pool_transfers;
 
 	/* Texture filter settings. */
 	int				force_aniso; /* -1 = disabled */
@@ -508,6 +515,8 @@ struct si_screen {
 	 */
 	unsigned			num_shaders_created;
 	unsigned			num_shader_cache_hits;
+	/* Shared PIPE_QUERY_SHADER_* counters. */
+	struct u_compile_stats		compile_stats;
 
 	/* GPU load thread. */
 	mtx_t				gpu_load_mutex;
@@ -813,8 +822,6 @@ struct si_context {
 	struct u_upload_mgr		*cached_gtt_allocator;
 	struct threaded_context		*tc;
 	struct u_suballocator		*allocator_zeroed_memory;
-	struct slab_child_pool		pool_transfers;
-	struct slab_child_pool		pool_transfers_unsync; /* for threaded_context */
 	struct pipe_device_reset_callback device_reset_callback;
 	struct u_log_context		*log;
 	void				*query_result_shader;
@@ -836,6 +843,9 @@ struct si_context {
 	void				*cs_clear_render_target;
 	void				*cs_clear_render_target_1d_array;
 	void				*cs_dcc_retile;
+	void				*cs_prim_cull[2]; /* 16-bit, 32-bit indices */
+	struct u_suballocator		*prim_cull_allocator;
+	bool				in_prim_cull;
 	struct si_screen		*screen;
 	struct pipe_debug_callback	debug;
 	struct ac_llvm_compiler		compiler; /* only non-threaded compilation */
@@ -1019,6 +1029,16 @@ struct si_context {
 	struct util_idalloc	bindless_used_slots;
 	unsigned		num_bindless_descriptors;
 	bool			bindless_descriptors_dirty;
+	/* Slots which changed since the last upload (unsigned). */
+	struct util_dynarray	bindless_dirty_slots;
+	/* The dirty slots may be in use by the GPU, wait for idle first. */
+	bool			bindless_descriptors_wait_idle;
+	/* The whole array must be re-uploaded into a new buffer. */
+	bool			bindless_descriptors_realloc;
+	/* The number of slots in the current bindless buffer. */
+	unsigned		bindless_num_uploaded_slots;
+	/* Slots above this have never been handed out. */
+	unsigned		bindless_max_used_slot;
 	bool			graphics_bindless_pointer_dirty;
 	bool			compute_bindless_pointer_dirty;
 
@@ -1077,6 +1097,7 @@ struct si_context {
 	/* Maintain the list of active queries for pausing between IBs. */
 	int				num_occlusion_queries;
 	int				num_perfect_occlusion_queries;
+	int				num_pipeline_stat_queries;
 	struct list_head		active_queries;
 	unsigned			num_cs_dw_queries_suspend;
 
@@ -1187,6 +1208,8 @@ void vi_dcc_clear_level(struct si_context *sctx,
 void si_init_clear_functions(struct si_context *sctx);
 
 /* si_compute_blit.c */
+void si_compute_internal_begin(struct si_context *sctx);
+void si_compute_internal_end(struct si_context *sctx);
 unsigned si_get_flush_flags(struct si_context *sctx, enum si_coherency coher,
 			    enum si_cache_policy cache_policy);
 void si_clear_buffer(struct si_context *sctx, struct pipe_resource *dst,
@@ -1210,6 +1233,11 @@ void si_compute_clear_render_target(struct pipe_context *ctx,
                                     unsigned width, unsigned height,
 				    bool render_condition_enabled);
 void si_retile_dcc(struct si_context *sctx, struct si_texture *tex);
+
+/* si_compute_prim_cull.c */
+int si_get_vs_position_passthrough_input(const struct tgsi_token *tokens);
+bool si_prim_cull_draw(struct si_context *sctx,
+		       const struct pipe_draw_info *info);
 void si_init_compute_blit_functions(struct si_context *sctx);
 
 /* si_cp_dma.c */
@@ -1332,6 +1360,7 @@ void *si_create_copy_image_compute_shader_1d_array(struct pipe_context *ctx);
 void *si_clear_render_target_shader(struct pipe_context *ctx);
 void *si_clear_render_target_shader_1d_array(struct pipe_context *ctx);
 void *si_create_dcc_retile_cs(struct pipe_context *ctx);
+void *si_create_prim_cull_cs(struct pipe_context *ctx, unsigned index_size);
 void *si_create_query_result_cs(struct si_context *sctx);
 
 /* si_test_dma.c */
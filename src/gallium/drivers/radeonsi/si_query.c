@@ -30,6 +30,7 @@
 #include "util/u_upload_mgr.h"
 #include "util/os_time.h"
 #include "util/u_suballoc.h"
+#include "util/u_compile_stats.h"
 #include "amd/common/sid.h"
 
 #define SI_MAX_STREAMS 4
@@ -117,6 +118,15 @@ static bool si_query_sw_begin(struct si_context *sctx,
 	case PIPE_QUERY_TIMESTAMP_DISJOINT:
 	case PIPE_QUERY_GPU_FINISHED:
 		break;
+	case PIPE_QUERY_SHADER_COMPILES:
+	case PIPE_QUERY_SHADER_COMPILE_TIME:
+	case PIPE_QUERY_SHADER_CACHE_HITS:
+	case PIPE_QUERY_SHADER_CACHE_MISSES:
+	case PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH:
+		query->begin_result =
+			u_compile_stats_read(&sctx->screen->compile_stats,
+					     query->b.type);
+		break;
 	case SI_QUERY_TIME_ELAPSED_SDMA_SI:
 		query->begin_result = si_finish_dma_get_cpu_time(sctx);
 		break;
@@ -280,6 +290,15 @@ static bool si_query_sw_end(struct si_context *sctx,
 	case PIPE_QUERY_GPU_FINISHED:
 		sctx->b.flush(&sctx->b, &query->fence, PIPE_FLUSH_DEFERRED);
 		break;
+	case PIPE_QUERY_SHADER_COMPILES:
+	case PIPE_QUERY_SHADER_COMPILE_TIME:
+	case PIPE_QUERY_SHADER_CACHE_HITS:
+	case PIPE_QUERY_SHADER_CACHE_MISSES:
+	case PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH:
+		query->end_result =
+			u_compile_stats_read(&sctx->screen->compile_stats,
+					     query->b.type);
+		break;
 	case SI_QUERY_TIME_ELAPSED_SDMA_SI:
 		query->end_result = si_finish_dma_get_cpu_time(sctx);
 		break;
@@ -456,6 +475,15 @@ static bool si_query_sw_get_result(struct si_context *sctx,
 		return result->b;
 	}
 
+	case PIPE_QUERY_SHADER_COMPILES:
+	case PIPE_QUERY_SHADER_COMPILE_TIME:
+	case PIPE_QUERY_SHADER_CACHE_HITS:
+	case PIPE_QUERY_SHADER_CACHE_MISSES:
+	case PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH:
+		result->u64 = u_compile_stats_result(query->b.type,
+						     query->begin_result,
+						     query->end_result);
+		return true;
 	case SI_QUERY_GFX_BO_LIST_SIZE:
 		result->u64 = (query->end_result - query->begin_result) /
 			      (query->end_time - query->begin_time);
@@ -850,6 +878,9 @@ static void si_query_hw_emit_start(struct si_context *sctx,
 	si_update_occlusion_query_state(sctx, query->b.type, 1);
 	si_update_prims_generated_query_state(sctx, query->b.type, 1);
 
+	if (query->b.type == PIPE_QUERY_PIPELINE_STATISTICS)
+		sctx->num_pipeline_stat_queries++;
+
 	if (query->b.type != SI_QUERY_TIME_ELAPSED_SDMA)
 		si_need_gfx_cs_space(sctx);
 
@@ -954,6 +985,9 @@ static void si_query_hw_emit_stop(struct si_context *sctx,
 
 	si_update_occlusion_query_state(sctx, query->b.type, -1);
 	si_update_prims_generated_query_state(sctx, query->b.type, -1);
+
+	if (query->b.type == PIPE_QUERY_PIPELINE_STATISTICS)
+		sctx->num_pipeline_stat_queries--;
 }
 
 static void emit_set_predicate(struct si_context *ctx,
@@ -1063,6 +1097,7 @@ static struct pipe_query *si_create_query(struct pipe_context *ctx, unsigned que
 
 	if (query_type == PIPE_QUERY_TIMESTAMP_DISJOINT ||
 	    query_type == PIPE_QUERY_GPU_FINISHED ||
+	    u_compile_stats_is_query(query_type) ||
 	    (query_type >= PIPE_QUERY_DRIVER_SPECIFIC &&
 	     query_type != SI_QUERY_TIME_ELAPSED_SDMA))
 		return si_query_sw_create(query_type);
@@ -1814,11 +1849,20 @@ static int si_get_driver_query_info(struct pipe_screen *screen,
 		unsigned num_perfcounters =
 			si_get_perfcounter_info(sscreen, 0, NULL);
 
-		return num_queries + num_perfcounters;
+		return num_queries + U_COMPILE_STATS_NUM_QUERIES +
+		       num_perfcounters;
 	}
 
-	if (index >= num_queries)
-		return si_get_perfcounter_info(sscreen, index - num_queries, info);
+	if (index >= num_queries + U_COMPILE_STATS_NUM_QUERIES)
+		return si_get_perfcounter_info(sscreen,
+					       index - num_queries -
+					       U_COMPILE_STATS_NUM_QUERIES, info);
+
+	if (index >= num_queries) {
+		u_compile_stats_query_info(index - num_queries, ~(unsigned)0,
+					   info);
+		return 1;
+	}
 
 	*info = si_driver_query_list[index];
 
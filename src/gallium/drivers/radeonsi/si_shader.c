@@ -5528,8 +5528,11 @@ static int si_compile_llvm(struct si_screen *sscreen,
 	}
 
 	if (!si_replace_shader(count, binary)) {
+		int64_t begin = u_compile_stats_begin();
+
 		r = si_llvm_compile(mod, binary, compiler, debug,
 				    less_optimized);
+		u_compile_stats_end(&sscreen->compile_stats, begin);
 		if (r)
 			return r;
 	}
@@ -5740,7 +5743,7 @@ si_generate_gs_copy_shader(struct si_screen *sscreen,
 	LLVMBuildRetVoid(ctx.ac.builder);
 
 	ctx.type = PIPE_SHADER_GEOMETRY; /* override for shader dumping */
-	si_llvm_optimize_module(&ctx);
+	si_llvm_optimize_module(&ctx, false);
 
 	r = si_compile_llvm(sscreen, &ctx.shader->binary,
 			    &ctx.shader->config, ctx.compiler,
@@ -6676,6 +6679,7 @@ int si_compile_tgsi_shader(struct si_screen *sscreen,
 {
 	struct si_shader_selector *sel = shader->selector;
 	struct si_shader_context ctx;
+	bool less_optimized = si_should_optimize_less(compiler, sel);
 	int r = -1;
 
 	/* Dump TGSI code before doing TGSI->LLVM conversion in case the
@@ -6884,7 +6888,7 @@ int si_compile_tgsi_shader(struct si_screen *sscreen,
 					  need_prolog ? 1 : 0, 0);
 	}
 
-	si_llvm_optimize_module(&ctx);
+	si_llvm_optimize_module(&ctx, less_optimized);
 
 	/* Post-optimization transformations and analysis. */
 	si_optimize_vs_outputs(&ctx);
@@ -6903,7 +6907,7 @@ int si_compile_tgsi_shader(struct si_screen *sscreen,
 	r = si_compile_llvm(sscreen, &shader->binary, &shader->config, compiler,
 			    ctx.ac.module, debug, ctx.type,
 			    si_get_shader_name(shader, ctx.type),
-			    si_should_optimize_less(compiler, shader->selector));
+			    less_optimized);
 	si_llvm_dispose(&ctx);
 	if (r) {
 		fprintf(stderr, "LLVM failed to compile shader\n");
@@ -7067,7 +7071,7 @@ si_get_shader_part(struct si_screen *sscreen,
 	build(&ctx, key);
 
 	/* Compile. */
-	si_llvm_optimize_module(&ctx);
+	si_llvm_optimize_module(&ctx, false);
 
 	if (si_compile_llvm(sscreen, &result->binary, &result->config, compiler,
 			    ctx.ac.module, debug, ctx.type, name, false)) {
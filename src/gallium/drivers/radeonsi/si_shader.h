@@ -347,6 +347,9 @@ struct si_shader_selector {
 	ubyte		clipdist_mask;
 	ubyte		culldist_mask;
 
+	/* VS parameters. */
+	int		pos_passthrough_input; /* copied to POSITION as is, or -1 */
+
 	/* ES parameters. */
 	unsigned	esgs_itemsize; /* vertex stride */
 	unsigned	lshs_vertex_stride;
@@ -811,45 +811,59 @@ void si_nir_scan_shader(const struct nir_shader *nir,
 	}
 }
 
+static bool
+si_should_vectorize_mem(unsigned align, unsigned bit_size,
+			unsigned num_components,
+			nir_intrinsic_instr *low, nir_intrinsic_instr *high)
+{
+	/* Buffer loads and stores take up to 4 dwords. */
+	return bit_size == 32 && align >= 4 && num_components <= 4;
+}
+
 void
 si_nir_opts(struct nir_shader *nir)
 {
-	bool progress;
-	do {
-		progress = false;
+	struct nir_opt_loop loop;
+	nir_opt_loop_init(&loop);
 
-		NIR_PASS_V(nir, nir_lower_vars_to_ssa);
+	while (nir_opt_loop_continue(&loop)) {
+		NIR_LOOP_PASS(&loop, nir, nir_lower_vars_to_ssa);
 
-		NIR_PASS(progress, nir, nir_opt_copy_prop_vars);
-		NIR_PASS(progress, nir, nir_opt_dead_write_vars);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_copy_prop_vars);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_dead_write_vars);
 
-		NIR_PASS_V(nir, nir_lower_alu_to_scalar);
-		NIR_PASS_V(nir, nir_lower_phis_to_scalar);
+		NIR_LOOP_PASS(&loop, nir, nir_lower_alu_to_scalar);
+		NIR_LOOP_PASS(&loop, nir, nir_lower_phis_to_scalar);
 
 		/* (Constant) copy propagation is needed for txf with offsets. */
-		NIR_PASS(progress, nir, nir_copy_prop);
-		NIR_PASS(progress, nir, nir_opt_remove_phis);
-		NIR_PASS(progress, nir, nir_opt_dce);
-		if (nir_opt_trivial_continues(nir)) {
-			progress = true;
-			NIR_PASS(progress, nir, nir_copy_prop);
-			NIR_PASS(progress, nir, nir_opt_dce);
+		NIR_LOOP_PASS(&loop, nir, nir_copy_prop);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_remove_phis);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_dce);
+
+		NIR_LOOP_PASS(&loop, nir, nir_opt_trivial_continues);
+		if (nir_opt_loop_last_progress(&loop)) {
+			NIR_LOOP_PASS(&loop, nir, nir_copy_prop);
+			NIR_LOOP_PASS(&loop, nir, nir_opt_dce);
 		}
-		NIR_PASS(progress, nir, nir_opt_if, true);
-		NIR_PASS(progress, nir, nir_opt_dead_cf);
-		NIR_PASS(progress, nir, nir_opt_cse);
-		NIR_PASS(progress, nir, nir_opt_peephole_select, 8, true, true);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_if, true);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_dead_cf);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_hoist_common);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_load_store_vectorize,
+			      nir_var_mem_ubo | nir_var_mem_ssbo,
+			      si_should_vectorize_mem);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_cse);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_peephole_select, 8, true, true);
 
 		/* Needed for algebraic lowering */
-		NIR_PASS(progress, nir, nir_opt_algebraic);
-		NIR_PASS(progress, nir, nir_opt_constant_folding);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_algebraic);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_constant_folding);
 
-		NIR_PASS(progress, nir, nir_opt_undef);
-		NIR_PASS(progress, nir, nir_opt_conditional_discard);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_undef);
+		NIR_LOOP_PASS(&loop, nir, nir_opt_conditional_discard);
 		if (nir->options->max_unroll_iterations) {
-			NIR_PASS(progress, nir, nir_opt_loop_unroll, 0);
+			NIR_LOOP_PASS(&loop, nir, nir_opt_loop_unroll, 0);
 		}
-	} while (progress);
+	}
 }
 
 /**
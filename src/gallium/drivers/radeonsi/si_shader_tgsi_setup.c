@@ -1146,15 +1146,20 @@ void si_llvm_create_func(struct si_shader_context *ctx,
 	LLVMSetFunctionCallConv(ctx->main_fn, call_conv);
 }
 
-void si_llvm_optimize_module(struct si_shader_context *ctx)
+void si_llvm_optimize_module(struct si_shader_context *ctx,
+			     bool less_optimized)
 {
+	LLVMPassManagerRef passmgr =
+		less_optimized && ctx->compiler->low_opt_passmgr ?
+			ctx->compiler->low_opt_passmgr : ctx->compiler->passmgr;
+
 	/* Dump LLVM IR before any optimization passes */
 	if (ctx->screen->debug_flags & DBG(PREOPT_IR) &&
 	    si_can_dump_shader(ctx->screen, ctx->type))
 		LLVMDumpModule(ctx->gallivm.module);
 
 	/* Run the pass */
-	LLVMRunPassManager(ctx->compiler->passmgr, ctx->gallivm.module);
+	LLVMRunPassManager(passmgr, ctx->gallivm.module);
 	LLVMDisposeBuilder(ctx->ac.builder);
 }
 
@@ -660,3 +660,232 @@ void *si_clear_render_target_shader_1d_array(struct pipe_context *ctx)
 
 	return ctx->create_compute_state(ctx, &state);
 }
+
+/* Create the compute shader culling triangles for si_prim_cull_draw.
+ * Each thread handles one triangle of a triangle list.
+ *
+ * buffer[0]: index buffer, 16 or 32 bits per index
+ * buffer[1]: clip-space positions, 4 floats at (index + index_bias) * stride
+ * buffer[2]: output index buffer, 32 bits per index
+ * buffer[3]: indirect draw arguments, the index count is incremented
+ * user data: num_triangles, stride, index_bias, cull flags
+ *
+ * Cull flags: bit 0 culls triangles with a positive determinant (which are
+ * counter-clockwise in NDC), bit 1 with a negative determinant.
+ */
+void *si_create_prim_cull_cs(struct pipe_context *ctx, unsigned index_size)
+{
+	struct ureg_program *ureg = ureg_create(PIPE_SHADER_COMPUTE);
+	if (!ureg)
+		return NULL;
+
+	ureg_property(ureg, TGSI_PROPERTY_CS_FIXED_BLOCK_WIDTH, 64);
+	ureg_property(ureg, TGSI_PROPERTY_CS_FIXED_BLOCK_HEIGHT, 1);
+	ureg_property(ureg, TGSI_PROPERTY_CS_FIXED_BLOCK_DEPTH, 1);
+	ureg_property(ureg, TGSI_PROPERTY_CS_USER_DATA_DWORDS, 4);
+
+	struct ureg_src user_data = ureg_DECL_system_value(ureg, TGSI_SEMANTIC_CS_USER_DATA, 0);
+	struct ureg_src tid = ureg_DECL_system_value(ureg, TGSI_SEMANTIC_THREAD_ID, 0);
+	struct ureg_src blk = ureg_DECL_system_value(ureg, TGSI_SEMANTIC_BLOCK_ID, 0);
+	struct ureg_src index_buf = ureg_DECL_buffer(ureg, 0, false);
+	struct ureg_src pos_buf = ureg_DECL_buffer(ureg, 1, false);
+	struct ureg_dst out_buf = ureg_dst(ureg_DECL_buffer(ureg, 2, false));
+	struct ureg_src args_buf = ureg_DECL_buffer(ureg, 3, false);
+	struct ureg_dst tri = ureg_writemask(ureg_DECL_temporary(ureg), TGSI_WRITEMASK_X);
+	struct ureg_dst tmp = ureg_DECL_temporary(ureg);
+	struct ureg_dst tmp2 = ureg_DECL_temporary(ureg);
+	struct ureg_dst indices = ureg_DECL_temporary(ureg);
+	struct ureg_dst outside = ureg_DECL_temporary(ureg);
+	struct ureg_dst cull = ureg_DECL_temporary(ureg);
+	struct ureg_src p[3];
+	unsigned in_range_label, visible_label;
+
+	ureg_UMAD(ureg, tri, blk, ureg_imm1u(ureg, 64), tid);
+
+	ureg_USLT(ureg, ureg_writemask(tmp, TGSI_WRITEMASK_X), ureg_src(tri),
+		  ureg_scalar(user_data, TGSI_SWIZZLE_X));
+	ureg_UIF(ureg, ureg_scalar(ureg_src(tmp), TGSI_SWIZZLE_X), &in_range_label);
+
+	/* Load the 3 indices. */
+	if (index_size == 4) {
+		struct ureg_dst addr = ureg_writemask(tmp, TGSI_WRITEMASK_X);
+		struct ureg_dst dst = ureg_writemask(indices, TGSI_WRITEMASK_XYZ);
+		struct ureg_src srcs[] = {index_buf, ureg_src(addr)};
+
+		ureg_UMUL(ureg, addr, ureg_src(tri), ureg_imm1u(ureg, 12));
+		ureg_memory_insn(ureg, TGSI_OPCODE_LOAD, &dst, 1, srcs, 2,
+				 TGSI_MEMORY_RESTRICT, TGSI_TEXTURE_BUFFER, 0);
+	} else {
+		/* The 6 bytes start at a 2 or 4 byte boundary, so load the
+		 * 2 dwords around them and extract the indices.
+		 */
+		struct ureg_dst addr = ureg_writemask(tmp, TGSI_WRITEMASK_X);
+		struct ureg_dst dwords = ureg_writemask(tmp2, TGSI_WRITEMASK_XY);
+		struct ureg_dst odd = ureg_writemask(tmp, TGSI_WRITEMASK_Y);
+		struct ureg_dst shift = ureg_writemask(tmp, TGSI_WRITEMASK_Z);
+		struct ureg_dst shift1 = ureg_writemask(tmp, TGSI_WRITEMASK_W);
+		struct ureg_src srcs[] = {index_buf, ureg_src(addr)};
+
+		ureg_UMUL(ureg, addr, ureg_src(tri), ureg_imm1u(ureg, 6));
+		ureg_AND(ureg, addr, ureg_src(addr), ureg_imm1u(ureg, ~3u));
+		ureg_memory_insn(ureg, TGSI_OPCODE_LOAD, &dwords, 1, srcs, 2,
+				 TGSI_MEMORY_RESTRICT, TGSI_TEXTURE_BUFFER, 0);
+
+		ureg_AND(ureg, odd, ureg_src(tri), ureg_imm1u(ureg, 1));
+		ureg_SHL(ureg, shift, ureg_scalar(ureg_src(odd), TGSI_SWIZZLE_Y),
+			 ureg_imm1u(ureg, 4));
+		ureg_XOR(ureg, shift1, ureg_scalar(ureg_src(shift), TGSI_SWIZZLE_Z),
+			 ureg_imm1u(ureg, 16));
+
+		/* even: d0.lo, d0.hi, d1.lo
+		 * odd:  d0.hi, d1.lo, d1.hi
+		 */
+		ureg_USHR(ureg, ureg_writemask(indices, TGSI_WRITEMASK_X),
+			  ureg_scalar(ureg_src(dwords), TGSI_SWIZZLE_X),
+			  ureg_scalar(ureg_src(shift), TGSI_SWIZZLE_Z));
+		ureg_UCMP(ureg, ureg_writemask(indices, TGSI_WRITEMASK_Y),
+			  ureg_scalar(ureg_src(odd), TGSI_SWIZZLE_Y),
+			  ureg_scalar(ureg_src(dwords), TGSI_SWIZZLE_Y),
+			  ureg_scalar(ureg_src(dwords), TGSI_SWIZZLE_X));
+		ureg_USHR(ureg, ureg_writemask(indices, TGSI_WRITEMASK_Y),
+			  ureg_scalar(ureg_src(indices), TGSI_SWIZZLE_Y),
+			  ureg_scalar(ureg_src(shift1), TGSI_SWIZZLE_W));
+		ureg_USHR(ureg, ureg_writemask(indices, TGSI_WRITEMASK_Z),
+			  ureg_scalar(ureg_src(dwords), TGSI_SWIZZLE_Y),
+			  ureg_scalar(ureg_src(shift), TGSI_SWIZZLE_Z));
+		ureg_AND(ureg, ureg_writemask(indices, TGSI_WRITEMASK_XYZ),
+			 ureg_src(indices), ureg_imm1u(ureg, 0xffff));
+	}
+
+	/* Load the positions. */
+	for (unsigned i = 0; i < 3; i++) {
+		struct ureg_dst addr = ureg_writemask(tmp, TGSI_WRITEMASK_X);
+		struct ureg_dst pos = ureg_DECL_temporary(ureg);
+		struct ureg_src srcs[] = {pos_buf, ureg_src(addr)};
+
+		ureg_UADD(ureg, addr, ureg_scalar(ureg_src(indices), i),
+			  ureg_scalar(user_data, TGSI_SWIZZLE_Z));
+		ureg_UMUL(ureg, addr, ureg_src(addr),
+			  ureg_scalar(user_data, TGSI_SWIZZLE_Y));
+		ureg_memory_insn(ureg, TGSI_OPCODE_LOAD, &pos, 1, srcs, 2,
+				 TGSI_MEMORY_RESTRICT, TGSI_TEXTURE_BUFFER, 0);
+		p[i] = ureg_src(pos);
+	}
+
+	/* Cull triangles with all vertices outside the same X or Y clip plane:
+	 *   outside.xy = w < x, w < y
+	 *   outside.zw = x < -w, y < -w
+	 */
+	for (unsigned i = 0; i < 3; i++) {
+		struct ureg_dst dst = i ? tmp : outside;
+		struct ureg_src w = ureg_scalar(p[i], TGSI_SWIZZLE_W);
+		struct ureg_src xy = ureg_swizzle(p[i], TGSI_SWIZZLE_X, TGSI_SWIZZLE_Y,
+						  TGSI_SWIZZLE_X, TGSI_SWIZZLE_Y);
+
+		ureg_FSLT(ureg, ureg_writemask(dst, TGSI_WRITEMASK_XY), w, xy);
+		ureg_FSLT(ureg, ureg_writemask(dst, TGSI_WRITEMASK_ZW), xy,
+			  ureg_negate(w));
+		if (i)
+			ureg_AND(ureg, outside, ureg_src(outside), ureg_src(tmp));
+	}
+	ureg_OR(ureg, ureg_writemask(cull, TGSI_WRITEMASK_XY), ureg_src(outside),
+		ureg_swizzle(ureg_src(outside), TGSI_SWIZZLE_Z, TGSI_SWIZZLE_W,
+			     TGSI_SWIZZLE_Z, TGSI_SWIZZLE_W));
+	ureg_OR(ureg, ureg_writemask(cull, TGSI_WRITEMASK_X),
+		ureg_scalar(ureg_src(cull), TGSI_SWIZZLE_X),
+		ureg_scalar(ureg_src(cull), TGSI_SWIZZLE_Y));
+
+	/* det = | x0 y0 w0 |
+	 *       | x1 y1 w1 |
+	 *       | x2 y2 w2 |
+	 *
+	 * If all w are positive, its sign is the orientation of the triangle
+	 * in NDC and it's 0 for zero-area triangles.
+	 */
+	for (unsigned i = 0; i < 3; i++) {
+		struct ureg_dst dst = ureg_writemask(tmp, TGSI_WRITEMASK_X << i);
+		struct ureg_src a = p[(i + 1) % 3], b = p[(i + 2) % 3];
+
+		ureg_MUL(ureg, dst, ureg_scalar(a, TGSI_SWIZZLE_Y),
+			 ureg_scalar(b, TGSI_SWIZZLE_W));
+		ureg_MAD(ureg, dst, ureg_negate(ureg_scalar(b, TGSI_SWIZZLE_Y)),
+			 ureg_scalar(a, TGSI_SWIZZLE_W), ureg_scalar(ureg_src(tmp), i));
+	}
+	struct ureg_dst det = ureg_writemask(tmp, TGSI_WRITEMASK_W);
+	ureg_MUL(ureg, det, ureg_scalar(p[0], TGSI_SWIZZLE_X),
+		 ureg_scalar(ureg_src(tmp), TGSI_SWIZZLE_X));
+	ureg_MAD(ureg, det, ureg_scalar(p[1], TGSI_SWIZZLE_X),
+		 ureg_scalar(ureg_src(tmp), TGSI_SWIZZLE_Y), ureg_src(det));
+	ureg_MAD(ureg, det, ureg_scalar(p[2], TGSI_SWIZZLE_X),
+		 ureg_scalar(ureg_src(tmp), TGSI_SWIZZLE_Z), ureg_src(det));
+
+	/* tmp2.x = 0 < det && (flags & 1)
+	 * tmp2.y = det < 0 && (flags & 2)
+	 * tmp2.z = det == 0
+	 */
+	ureg_FSLT(ureg, ureg_writemask(tmp2, TGSI_WRITEMASK_X), ureg_imm1f(ureg, 0),
+		  ureg_scalar(ureg_src(det), TGSI_SWIZZLE_W));
+	ureg_FSLT(ureg, ureg_writemask(tmp2, TGSI_WRITEMASK_Y),
+		  ureg_scalar(ureg_src(det), TGSI_SWIZZLE_W), ureg_imm1f(ureg, 0));
+	ureg_FSEQ(ureg, ureg_writemask(tmp2, TGSI_WRITEMASK_Z),
+		  ureg_scalar(ureg_src(det), TGSI_SWIZZLE_W), ureg_imm1f(ureg, 0));
+	ureg_AND(ureg, ureg_writemask(tmp, TGSI_WRITEMASK_XY),
+		 ureg_scalar(user_data, TGSI_SWIZZLE_W), ureg_imm2u(ureg, 1, 2));
+	ureg_USNE(ureg, ureg_writemask(tmp, TGSI_WRITEMASK_XY), ureg_src(tmp),
+		  ureg_imm1u(ureg, 0));
+	ureg_AND(ureg, ureg_writemask(tmp2, TGSI_WRITEMASK_XY), ureg_src(tmp2),
+		 ureg_src(tmp));
+	ureg_OR(ureg, ureg_writemask(tmp2, TGSI_WRITEMASK_X),
+		ureg_scalar(ureg_src(tmp2), TGSI_SWIZZLE_X),
+		ureg_scalar(ureg_src(tmp2), TGSI_SWIZZLE_Y));
+	ureg_OR(ureg, ureg_writemask(tmp2, TGSI_WRITEMASK_X),
+		ureg_scalar(ureg_src(tmp2), TGSI_SWIZZLE_X),
+		ureg_scalar(ureg_src(tmp2), TGSI_SWIZZLE_Z));
+
+	/* The determinant is only meaningful if all w are positive. */
+	for (unsigned i = 0; i < 3; i++) {
+		ureg_FSLT(ureg, ureg_writemask(tmp, TGSI_WRITEMASK_X),
+			  ureg_imm1f(ureg, 0), ureg_scalar(p[i], TGSI_SWIZZLE_W));
+		ureg_AND(ureg, ureg_writemask(tmp2, TGSI_WRITEMASK_X),
+			 ureg_scalar(ureg_src(tmp2), TGSI_SWIZZLE_X),
+			 ureg_scalar(ureg_src(tmp), TGSI_SWIZZLE_X));
+	}
+	ureg_OR(ureg, ureg_writemask(cull, TGSI_WRITEMASK_X),
+		ureg_scalar(ureg_src(cull), TGSI_SWIZZLE_X),
+		ureg_scalar(ureg_src(tmp2), TGSI_SWIZZLE_X));
+
+	/* Append the triangle if it's visible. */
+	ureg_NOT(ureg, ureg_writemask(tmp, TGSI_WRITEMASK_X),
+		 ureg_scalar(ureg_src(cull), TGSI_SWIZZLE_X));
+	ureg_UIF(ureg, ureg_scalar(ureg_src(tmp), TGSI_SWIZZLE_X), &visible_label);
+	{
+		struct ureg_dst offset = ureg_writemask(tmp, TGSI_WRITEMASK_X);
+		struct ureg_src atomic_srcs[] =
+			{args_buf, ureg_imm1u(ureg, 0), ureg_imm1u(ureg, 3)};
+
+		ureg_memory_insn(ureg, TGSI_OPCODE_ATOMUADD, &offset, 1,
+				 atomic_srcs, 3, 0, TGSI_TEXTURE_BUFFER, 0);
+		ureg_SHL(ureg, offset, ureg_src(offset), ureg_imm1u(ureg, 2));
+
+		struct ureg_dst dst = ureg_writemask(out_buf, TGSI_WRITEMASK_XYZ);
+		struct ureg_src store_srcs[] = {ureg_src(offset), ureg_src(indices)};
+
+		ureg_memory_insn(ureg, TGSI_OPCODE_STORE, &dst, 1, store_srcs, 2,
+				 TGSI_MEMORY_RESTRICT, TGSI_TEXTURE_BUFFER, 0);
+	}
+	ureg_fixup_label(ureg, visible_label, ureg_get_instruction_number(ureg));
+	ureg_ENDIF(ureg);
+
+	ureg_fixup_label(ureg, in_range_label, ureg_get_instruction_number(ureg));
+	ureg_ENDIF(ureg);
+	ureg_END(ureg);
+
+	struct pipe_compute_state state = {};
+	state.ir_type = PIPE_SHADER_IR_TGSI;
+	state.prog = ureg_get_tokens(ureg, NULL);
+
+	void *cs = ctx->create_compute_state(ctx, &state);
+	ureg_destroy(ureg);
+	ureg_free_tokens(state.prog);
+	return cs;
+}
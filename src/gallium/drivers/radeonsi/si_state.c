@@ -876,6 +876,11 @@ static void *si_create_rs_state(struct pipe_context *ctx,
 	rs->flatshade = state->flatshade;
 	rs->sprite_coord_enable = state->sprite_coord_enable;
 	rs->rasterizer_discard = state->rasterizer_discard;
+	rs->cull_front = !!(state->cull_face & PIPE_FACE_FRONT);
+	rs->cull_back = !!(state->cull_face & PIPE_FACE_BACK);
+	rs->front_ccw = state->front_ccw;
+	rs->polygon_mode_enabled = state->fill_front != PIPE_POLYGON_MODE_FILL ||
+				   state->fill_back != PIPE_POLYGON_MODE_FILL;
 	rs->pa_sc_line_stipple = state->line_stipple_enable ?
 				S_028A0C_LINE_PATTERN(state->line_stipple_pattern) |
 				S_028A0C_REPEAT_COUNT(state->line_stipple_factor) : 0;
@@ -3336,14 +3341,13 @@ static void si_emit_msaa_sample_locs(struct si_context *sctx)
 				   S_02882C_YMAX_BOTTOM_EXCLUSION(exclusion));
 }
 
-static bool si_out_of_order_rasterization(struct si_context *sctx)
+/* Whether the result of drawing doesn't depend on the order in which
+ * primitives are rasterized.
+ */
+bool si_primitive_order_invariant(struct si_context *sctx)
 {
 	struct si_state_blend *blend = sctx->queued.named.blend;
 	struct si_state_dsa *dsa = sctx->queued.named.dsa;
-
-	if (!sctx->screen->has_out_of_order_rast)
-		return false;
-
 	unsigned colormask = sctx->framebuffer.colorbuf_enabled_4bit;
 
 	if (blend) {
@@ -3403,6 +3407,12 @@ static bool si_out_of_order_rasterization(struct si_context *sctx)
 	return true;
 }
 
+static bool si_out_of_order_rasterization(struct si_context *sctx)
+{
+	return sctx->screen->has_out_of_order_rast &&
+	       si_primitive_order_invariant(sctx);
+}
+
 static void si_emit_msaa_config(struct si_context *sctx)
 {
 	struct radeon_cmdbuf *cs = sctx->gfx_cs;
@@ -4495,6 +4505,9 @@ static void *si_create_vertex_elements(struct pipe_context *ctx,
 		memcpy(swizzle, desc->swizzle, sizeof(swizzle));
 
 		v->format_size[i] = desc->block.bits / 8;
+		if (elements[i].src_format == PIPE_FORMAT_R32G32B32A32_FLOAT &&
+		    !instance_divisor)
+			v->is_xyzw_float |= 1u << i;
 		v->src_offset[i] = elements[i].src_offset;
 		v->vertex_buffer_index[i] = vbo_index;
 
@@ -86,6 +86,10 @@ struct si_state_rasterizer {
 	unsigned		rasterizer_discard:1;
 	unsigned		scissor_enable:1;
 	unsigned		clip_halfz:1;
+	unsigned		cull_front:1;
+	unsigned		cull_back:1;
+	unsigned		front_ccw:1;
+	unsigned		polygon_mode_enabled:1;
 };
 
 struct si_dsa_stencil_ref_part {
@@ -147,6 +151,7 @@ struct si_vertex_elements
 	uint16_t			desc_list_byte_size;
 	uint16_t			instance_divisor_is_one; /* bitmask of inputs */
 	uint16_t			instance_divisor_is_fetched;  /* bitmask of inputs */
+	uint16_t			is_xyzw_float; /* bitmask of per-vertex R32G32B32A32_FLOAT inputs */
 };
 
 union si_state {
@@ -493,6 +498,7 @@ void si_rebind_buffer(struct si_context *sctx, struct pipe_resource *buf);
 void si_init_state_compute_functions(struct si_context *sctx);
 void si_init_state_functions(struct si_context *sctx);
 void si_init_screen_state_functions(struct si_screen *sscreen);
+bool si_primitive_order_invariant(struct si_context *sctx);
 void
 si_make_buffer_descriptor(struct si_screen *screen, struct si_resource *buf,
 			  enum pipe_format format,
@@ -1273,6 +1273,10 @@ static void si_draw_vbo(struct pipe_context *ctx, const struct pipe_draw_info *i
 			return;
 	}
 
+	if (unlikely(sctx->screen->debug_flags & DBG(PRIM_CULL)) &&
+	    si_prim_cull_draw(sctx, info))
+		return;
+
 	if (unlikely(!sctx->vs_shader.cso ||
 		     !rs ||
 		     (!sctx->ps_shader.cso && !rs->rasterizer_discard) ||
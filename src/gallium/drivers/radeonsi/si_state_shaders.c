@@ -58,7 +58,7 @@ void *si_get_ir_binary(struct si_shader_selector *sel)
 		assert(sel->nir);
 
 		blob_init(&blob);
-		nir_serialize(&blob, sel->nir);
+		nir_serialize(&blob, sel->nir, true);
 		ir_binary = blob.data;
 		ir_size = blob.size;
 	}
@@ -334,6 +334,92 @@ void si_destroy_shader_cache(struct si_screen *sscreen)
 	mtx_destroy(&sscreen->shader_cache_mutex);
 }
 
+/**
+ * Return the shader cache entry of the main shader part of a selector, i.e.
+ * its IR binary followed by the shader binary, for program binaries.
+ */
+static void *si_export_shader_binary(struct pipe_context *ctx,
+				     enum pipe_shader_type type,
+				     void *state, unsigned *size)
+{
+	struct si_screen *sscreen = ((struct si_context*)ctx)->screen;
+	struct si_shader_selector *sel = state;
+	struct hash_entry *entry;
+	void *ir_binary, *result = NULL;
+
+	/* Compute states aren't selectors, and monolithic shaders don't go
+	 * through the shader cache. */
+	if (type == PIPE_SHADER_COMPUTE || sscreen->use_monolithic_shaders)
+		return NULL;
+
+	util_queue_fence_wait(&sel->ready);
+
+	ir_binary = si_get_ir_binary(sel);
+	if (!ir_binary)
+		return NULL;
+
+	mtx_lock(&sscreen->shader_cache_mutex);
+	entry = _mesa_hash_table_search(sscreen->shader_cache, ir_binary);
+	if (entry) {
+		uint32_t ir_size = *(uint32_t*)ir_binary;
+		uint32_t hw_size = *(uint32_t*)entry->data;
+
+		result = MALLOC(ir_size + hw_size);
+		if (result) {
+			memcpy(result, ir_binary, ir_size);
+			memcpy((char*)result + ir_size, entry->data, hw_size);
+			*size = ir_size + hw_size;
+		}
+	}
+	mtx_unlock(&sscreen->shader_cache_mutex);
+
+	FREE(ir_binary);
+	return result;
+}
+
+/**
+ * Put a shader cache entry from si_export_shader_binary back into the shader
+ * cache, so that creating the same selector loads the main shader part from
+ * it.
+ */
+static void si_import_shader_binary(struct pipe_context *ctx,
+				    const void *binary, unsigned size)
+{
+	struct si_screen *sscreen = ((struct si_context*)ctx)->screen;
+	uint32_t ir_size, hw_size;
+	void *ir_binary, *hw_binary;
+
+	/* The shader binary is checked against its CRC32 when it's loaded,
+	 * only the framing has to be validated here. */
+	if (size < 12)
+		return;
+	memcpy(&ir_size, binary, 4);
+	if (ir_size < 4 || ir_size > size - 8)
+		return;
+	memcpy(&hw_size, (const char*)binary + ir_size, 4);
+	if (hw_size < 8 || hw_size != size - ir_size)
+		return;
+
+	ir_binary = MALLOC(ir_size);
+	hw_binary = MALLOC(hw_size);
+	if (!ir_binary || !hw_binary) {
+		FREE(ir_binary);
+		FREE(hw_binary);
+		return;
+	}
+	memcpy(ir_binary, binary, ir_size);
+	memcpy(hw_binary, (const char*)binary + ir_size, hw_size);
+
+	mtx_lock(&sscreen->shader_cache_mutex);
+	if (_mesa_hash_table_search(sscreen->shader_cache, ir_binary) ||
+	    !_mesa_hash_table_insert(sscreen->shader_cache, ir_binary,
+				     hw_binary)) {
+		FREE(ir_binary);
+		FREE(hw_binary);
+	}
+	mtx_unlock(&sscreen->shader_cache_mutex);
+}
+
 /* SHADER STATES */
 
 static void si_set_tesseval_regs(struct si_screen *sscreen,
@@ -1736,6 +1822,15 @@ static void si_build_shader_variant_low_priority(void *job, int thread_index)
 	si_build_shader_variant(shader, thread_index, true);
 }
 
+static void si_build_shader_variant_async(void *job, int thread_index)
+{
+	struct si_shader *shader = (struct si_shader *)job;
+
+	assert(thread_index >= 0);
+
+	si_build_shader_variant(shader, thread_index, false);
+}
+
 static const struct si_shader_key zeroed;
 
 static bool si_check_missing_main_part(struct si_screen *sscreen,
@@ -1771,12 +1866,18 @@ static bool si_check_missing_main_part(struct si_screen *sscreen,
 	return true;
 }
 
-/* Select the hw shader variant depending on the current state. */
+/* Select the hw shader variant depending on the current state.
+ *
+ * If "start_only" is set, this only starts compiling the variant on a
+ * compiler thread if it doesn't exist yet, and doesn't wait for it or
+ * change the current shader.
+ */
 static int si_shader_select_with_key(struct si_screen *sscreen,
 				     struct si_shader_ctx_state *state,
 				     struct si_compiler_ctx_state *compiler_state,
 				     struct si_shader_key *key,
-				     int thread_index)
+				     int thread_index,
+				     bool start_only)
 {
 	struct si_shader_selector *sel = state->cso;
 	struct si_shader_selector *previous_stage_sel = NULL;
@@ -1796,6 +1897,9 @@ again:
 				goto current_not_ready;
 			}
 
+			if (start_only)
+				return 0;
+
 			util_queue_fence_wait(&current->ready);
 		}
 
@@ -1832,9 +1936,15 @@ current_not_ready:
 					goto again;
 				}
 
+				if (start_only)
+					return 0;
+
 				util_queue_fence_wait(&iter->ready);
 			}
 
+			if (start_only)
+				return 0;
+
 			if (iter->compilation_failed) {
 				return -1; /* skip the draw call */
 			}
@@ -1959,6 +2069,26 @@ current_not_ready:
 		goto again;
 	}
 
+	if (start_only) {
+		assert(thread_index < 0);
+
+		/* Compile it on a compiler thread, and add it as above. */
+		util_queue_add_job(&sscreen->shader_compiler_queue,
+				   shader, &shader->ready,
+				   si_build_shader_variant_async, NULL);
+
+		if (!sel->last_variant) {
+			sel->first_variant = shader;
+			sel->last_variant = shader;
+		} else {
+			sel->last_variant->next_variant = shader;
+			sel->last_variant = shader;
+		}
+
+		mtx_unlock(&sel->mutex);
+		return 0;
+	}
+
 	/* Reset the fence before adding to the variant list. */
 	util_queue_fence_reset(&shader->ready);
 
@@ -1992,7 +2122,22 @@ static int si_shader_select(struct pipe_context *ctx,
 
 	si_shader_selector_key(ctx, state->cso, &key);
 	return si_shader_select_with_key(sctx->screen, state, compiler_state,
-					 &key, -1);
+					 &key, -1, false);
+}
+
+/* Start compiling the variant of a shader the current state needs, if it
+ * doesn't exist yet. si_shader_select waits for it later.
+ */
+static void si_shader_select_start(struct pipe_context *ctx,
+				   struct si_shader_ctx_state *state,
+				   struct si_compiler_ctx_state *compiler_state)
+{
+	struct si_context *sctx = (struct si_context *)ctx;
+	struct si_shader_key key;
+
+	si_shader_selector_key(ctx, state->cso, &key);
+	si_shader_select_with_key(sctx->screen, state, compiler_state,
+				  &key, -1, true);
 }
 
 static void si_parse_next_shader_property(const struct tgsi_shader_info *info,
@@ -2265,6 +2410,11 @@ static void *si_create_shader_selector(struct pipe_context *ctx,
 			(sel->so.output[i].stream * 4);
 	}
 
+	sel->pos_passthrough_input = -1;
+	if (sel->type == PIPE_SHADER_VERTEX && sel->tokens)
+		sel->pos_passthrough_input =
+			si_get_vs_position_passthrough_input(sel->tokens);
+
 	/* The prolog is a no-op if there are no inputs. */
 	sel->vs_needs_prolog = sel->type == PIPE_SHADER_VERTEX &&
 			       sel->info.num_inputs &&
@@ -2675,6 +2825,10 @@ static void si_delete_shader(struct si_context *sctx, struct si_shader *shader)
 	if (shader->is_optimized) {
 		util_queue_drop_job(&sctx->screen->shader_compiler_queue_low_priority,
 				    &shader->ready);
+	} else {
+		/* See si_start_shader_variants. */
+		util_queue_drop_job(&sctx->screen->shader_compiler_queue,
+				    &shader->ready);
 	}
 
 	util_queue_fence_destroy(&shader->ready);
@@ -3328,6 +3482,38 @@ static void si_update_vgt_shader_config(struct si_context *sctx)
 	si_pm4_bind_state(sctx, vgt_shader_config, *pm4);
 }
 
+/* Start compiling the missing variants of all stages on the compiler
+ * threads at the same time, so that si_update_shaders only waits for the
+ * slowest of them instead of compiling them one after the other.
+ */
+static void si_start_shader_variants(struct si_context *sctx,
+				     struct si_compiler_ctx_state *compiler_state)
+{
+	struct pipe_context *ctx = (struct pipe_context*)sctx;
+
+	/* Shader dumps and synchronous debug messages are printed by the
+	 * draw thread. */
+	if (sctx->is_debug ||
+	    (sctx->debug.debug_message && !sctx->debug.async))
+		return;
+
+	if (sctx->tes_shader.cso) {
+		if (sctx->chip_class <= VI)
+			si_shader_select_start(ctx, &sctx->vs_shader, compiler_state);
+		if (sctx->tcs_shader.cso)
+			si_shader_select_start(ctx, &sctx->tcs_shader, compiler_state);
+		if (!sctx->gs_shader.cso || sctx->chip_class <= VI)
+			si_shader_select_start(ctx, &sctx->tes_shader, compiler_state);
+	} else if (!sctx->gs_shader.cso || sctx->chip_class <= VI) {
+		si_shader_select_start(ctx, &sctx->vs_shader, compiler_state);
+	}
+
+	if (sctx->gs_shader.cso)
+		si_shader_select_start(ctx, &sctx->gs_shader, compiler_state);
+	if (sctx->ps_shader.cso)
+		si_shader_select_start(ctx, &sctx->ps_shader, compiler_state);
+}
+
 bool si_update_shaders(struct si_context *sctx)
 {
 	struct pipe_context *ctx = (struct pipe_context*)sctx;
@@ -3344,6 +3530,8 @@ bool si_update_shaders(struct si_context *sctx)
 	compiler_state.debug = sctx->debug;
 	compiler_state.is_debug_context = sctx->is_debug;
 
+	si_start_shader_variants(sctx, &compiler_state);
+
 	/* Update stages before GS. */
 	if (sctx->tes_shader.cso) {
 		if (!sctx->tess_rings) {
@@ -3571,4 +3759,7 @@ void si_init_shader_functions(struct si_context *sctx)
 	sctx->b.delete_tes_state = si_delete_shader_selector;
 	sctx->b.delete_gs_state = si_delete_shader_selector;
 	sctx->b.delete_fs_state = si_delete_shader_selector;
+
+	sctx->b.get_shader_binary = si_export_shader_binary;
+	sctx->b.add_shader_binary = si_import_shader_binary;
 }
@@ -0,0 +1,578 @@
+/**************************************************************************
+ *
+ * Copyright 2019 VMware, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+ * IN NO EVENT SHALL VMWARE AND/OR ITS SUPPLIERS BE LIABLE FOR
+ * ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **************************************************************************/
+
+/**
+ * Tile-binned rasterization.
+ *
+ * When enabled with SOFTPIPE_NUM_THREADS, the primitives of each batch
+ * handed to us by the draw module are binned into screen tiles of
+ * TILE_SIZE x TILE_SIZE pixels instead of being rasterized right away.
+ * At the end of the batch, worker threads take the non-empty tiles one at
+ * a time and run setup and the quad pipeline for the tile's primitives,
+ * clipped to the tile, in submission order.
+ *
+ * Each thread has its own setup context, quad stages, fragment shader
+ * machine and tile caches, so nothing but read-only state is shared.
+ * A tile only ever sees its own primitives, in the same order and split
+ * into the same quad runs as when rasterizing directly (runs never cross
+ * a tile boundary), so the results are exactly the same.
+ */
+
+#include "util/u_atomic.h"
+#include "util/u_inlines.h"
+#include "util/u_math.h"
+#include "util/u_memory.h"
+#include "util/u_queue.h"
+#include "tgsi/tgsi_exec.h"
+#include "sp_bin.h"
+#include "sp_context.h"
+#include "sp_limits.h"
+#include "sp_quad_pipe.h"
+#include "sp_setup.h"
+#include "sp_state.h"
+#include "sp_tex_sample.h"
+#include "sp_tex_tile_cache.h"
+#include "sp_tile_cache.h"
+
+
+/**
+ * A binned primitive.  The vertices stay valid until the end of the batch.
+ */
+struct sp_bin_prim {
+   unsigned prim;               /**< PIPE_PRIM_POINTS, LINES or TRIANGLES */
+   const float (*v[3])[4];
+};
+
+
+/**
+ * Indices of the primitives overlapping a screen tile.
+ */
+struct sp_bin {
+   unsigned *prims;
+   unsigned count;
+   unsigned size;
+};
+
+
+struct sp_bin_thread {
+   struct sp_binner *binner;
+
+   struct setup_context *setup;
+   struct quad_stage *shade;
+   struct quad_stage *depth_test;
+   struct quad_stage *blend;
+
+   struct sp_quad_target target;
+   struct tgsi_exec_machine *fs_machine;
+   struct softpipe_tile_cache *cbuf_cache[PIPE_MAX_COLOR_BUFS];
+   struct softpipe_tile_cache *zsbuf_cache;
+   uint64_t occlusion_count;
+
+   /** Copy of the context's fragment sampler, sampling through tex_cache */
+   struct sp_tgsi_sampler *sampler;
+   struct softpipe_tex_tile_cache *tex_cache[PIPE_MAX_SHADER_SAMPLER_VIEWS];
+
+   struct util_queue_fence fence;
+};
+
+
+struct sp_binner {
+   struct softpipe_context *softpipe;
+
+   struct util_queue queue;
+   struct sp_bin_thread thread[SP_MAX_THREADS];
+   unsigned num_threads;
+
+   struct sp_bin_prim *prims;
+   unsigned num_prims;
+   unsigned max_prims;
+
+   /** Framebuffer size in tiles */
+   unsigned tiles_x, tiles_y;
+
+   struct sp_bin *bins;         /**< [max_bins] */
+   unsigned *used_tiles;        /**< [max_bins], tiles with a non-empty bin */
+   unsigned num_used_tiles;
+   unsigned max_bins;
+
+   /** Next entry of used_tiles for a thread to pick */
+   unsigned next_tile;
+};
+
+
+/**
+ * Get a thread's texture caches ready for the fragment sampler views.
+ */
+static boolean
+sp_bin_thread_alloc_tex_caches(struct sp_bin_thread *thread)
+{
+   struct softpipe_context *sp = thread->binner->softpipe;
+   unsigned i;
+
+   for (i = 0; i < sp->num_sampler_views[PIPE_SHADER_FRAGMENT]; i++) {
+      if (sp->sampler_views[PIPE_SHADER_FRAGMENT][i] &&
+          !thread->tex_cache[i]) {
+         thread->tex_cache[i] = sp_create_tex_tile_cache(&sp->pipe);
+         if (!thread->tex_cache[i])
+            return FALSE;
+      }
+   }
+
+   return TRUE;
+}
+
+
+/**
+ * Called when the setup context is prepared for a new batch of primitives.
+ * \return whether the batch is to be binned
+ */
+boolean
+sp_binner_begin(struct sp_binner *binner)
+{
+   struct softpipe_context *sp = binner->softpipe;
+   const struct pipe_framebuffer_state *fb = &sp->framebuffer;
+   unsigned num_bins, i;
+
+   assert(!binner->num_prims);
+
+   /* The statistics are counted as primitives get rasterized, and stores
+    * to memory would happen in a different order: leave those alone.
+    */
+   if (sp->active_statistics_queries ||
+       !sp->fs_variant ||
+       sp->fs_variant->info.writes_memory ||
+       !fb->width || !fb->height)
+      return FALSE;
+
+   binner->tiles_x = DIV_ROUND_UP(fb->width, TILE_SIZE);
+   binner->tiles_y = DIV_ROUND_UP(fb->height, TILE_SIZE);
+   num_bins = binner->tiles_x * binner->tiles_y;
+
+   if (num_bins > binner->max_bins) {
+      struct sp_bin *bins;
+      unsigned *used_tiles;
+
+      bins = REALLOC(binner->bins,
+                     binner->max_bins * sizeof(*bins),
+                     num_bins * sizeof(*bins));
+      if (!bins)
+         return FALSE;
+      memset(bins + binner->max_bins, 0,
+             (num_bins - binner->max_bins) * sizeof(*bins));
+      binner->bins = bins;
+
+      used_tiles = REALLOC(binner->used_tiles,
+                           binner->max_bins * sizeof(*used_tiles),
+                           num_bins * sizeof(*used_tiles));
+      if (!used_tiles)
+         return FALSE;
+      binner->used_tiles = used_tiles;
+
+      binner->max_bins = num_bins;
+   }
+
+   for (i = 0; i < binner->num_threads; i++) {
+      if (!sp_bin_thread_alloc_tex_caches(&binner->thread[i]))
+         return FALSE;
+   }
+
+   return TRUE;
+}
+
+
+/**
+ * Add a primitive to the bins of the tiles its bounding box overlaps.
+ */
+static void
+sp_bin_prim(struct sp_binner *binner, unsigned prim,
+            const float (*v0)[4],
+            const float (*v1)[4],
+            const float (*v2)[4],
+            float xmin, float ymin, float xmax, float ymax)
+{
+   const struct pipe_framebuffer_state *fb = &binner->softpipe->framebuffer;
+   struct sp_bin_prim *p;
+   unsigned index, x0, y0, x1, y1, tx, ty;
+
+   /* Be generous, the rasterization gets clipped to each tile anyway.
+    * This also throws away primitives with NaN coordinates.
+    */
+   xmin = floorf(xmin) - 1.0f;
+   ymin = floorf(ymin) - 1.0f;
+   xmax = ceilf(xmax) + 1.0f;
+   ymax = ceilf(ymax) + 1.0f;
+   if (!(xmax >= 0.0f && ymax >= 0.0f &&
+         xmin < (float) fb->width && ymin < (float) fb->height))
+      return;
+
+   if (binner->num_prims == binner->max_prims) {
+      unsigned max_prims = MAX2(binner->max_prims * 2, 256);
+      struct sp_bin_prim *prims =
+         REALLOC(binner->prims,
+                 binner->max_prims * sizeof(*prims),
+                 max_prims * sizeof(*prims));
+      if (!prims)
+         return;
+      binner->prims = prims;
+      binner->max_prims = max_prims;
+   }
+
+   index = binner->num_prims++;
+   p = &binner->prims[index];
+   p->prim = prim;
+   p->v[0] = v0;
+   p->v[1] = v1;
+   p->v[2] = v2;
+
+   x0 = (unsigned) MAX2(xmin, 0.0f) / TILE_SIZE;
+   y0 = (unsigned) MAX2(ymin, 0.0f) / TILE_SIZE;
+   x1 = (unsigned) MIN2(xmax, (float) (fb->width - 1)) / TILE_SIZE;
+   y1 = (unsigned) MIN2(ymax, (float) (fb->height - 1)) / TILE_SIZE;
+
+   for (ty = y0; ty <= y1; ty++) {
+      for (tx = x0; tx <= x1; tx++) {
+         const unsigned tile = ty * binner->tiles_x + tx;
+         struct sp_bin *bin = &binner->bins[tile];
+
+         if (bin->count == bin->size) {
+            unsigned size = MAX2(bin->size * 2, 16);
+            unsigned *prims = REALLOC(bin->prims,
+                                      bin->size * sizeof(*prims),
+                                      size * sizeof(*prims));
+            if (!prims)
+               continue;
+            bin->prims = prims;
+            bin->size = size;
+         }
+
+         if (!bin->count)
+            binner->used_tiles[binner->num_used_tiles++] = tile;
+
+         bin->prims[bin->count++] = index;
+      }
+   }
+}
+
+
+void
+sp_bin_point(struct sp_binner *binner,
+             const float (*v0)[4],
+             float size)
+{
+   const float half_size = 0.5f * size;
+
+   sp_bin_prim(binner, PIPE_PRIM_POINTS, v0, NULL, NULL,
+               v0[0][0] - half_size, v0[0][1] - half_size,
+               v0[0][0] + half_size, v0[0][1] + half_size);
+}
+
+
+void
+sp_bin_line(struct sp_binner *binner,
+            const float (*v0)[4],
+            const float (*v1)[4])
+{
+   sp_bin_prim(binner, PIPE_PRIM_LINES, v0, v1, NULL,
+               MIN2(v0[0][0], v1[0][0]), MIN2(v0[0][1], v1[0][1]),
+               MAX2(v0[0][0], v1[0][0]), MAX2(v0[0][1], v1[0][1]));
+}
+
+
+void
+sp_bin_tri(struct sp_binner *binner,
+           const float (*v0)[4],
+           const float (*v1)[4],
+           const float (*v2)[4])
+{
+   sp_bin_prim(binner, PIPE_PRIM_TRIANGLES, v0, v1, v2,
+               MIN3(v0[0][0], v1[0][0], v2[0][0]),
+               MIN3(v0[0][1], v1[0][1], v2[0][1]),
+               MAX3(v0[0][0], v1[0][0], v2[0][0]),
+               MAX3(v0[0][1], v1[0][1], v2[0][1]));
+}
+
+
+/**
+ * Point a thread's tile caches, sampler and quad stages at the current
+ * state.  Called from the context's thread before starting the thread.
+ */
+static void
+sp_bin_thread_begin(struct sp_bin_thread *thread,
+                    const struct setup_context *setup)
+{
+   struct softpipe_context *sp = thread->binner->softpipe;
+   struct quad_stage *first;
+   unsigned i;
+
+   for (i = 0; i < sp->framebuffer.nr_cbufs; i++)
+      sp_tile_cache_set_surface(thread->cbuf_cache[i],
+                                sp->framebuffer.cbufs[i]);
+   sp_tile_cache_set_surface(thread->zsbuf_cache, sp->framebuffer.zsbuf);
+
+   memcpy(thread->sampler, sp->tgsi.sampler[PIPE_SHADER_FRAGMENT],
+          sizeof(*thread->sampler));
+   for (i = 0; i < sp->num_sampler_views[PIPE_SHADER_FRAGMENT]; i++) {
+      struct pipe_sampler_view *view =
+         sp->sampler_views[PIPE_SHADER_FRAGMENT][i];
+
+      if (view) {
+         sp_tex_tile_cache_set_sampler_view(thread->tex_cache[i], view);
+         thread->sampler->sp_sview[i].cache = thread->tex_cache[i];
+      }
+   }
+
+   sp->fs_variant->prepare(sp->fs_variant,
+                           thread->fs_machine,
+                           (struct tgsi_sampler *) thread->sampler,
+                           (struct tgsi_image *)
+                           sp->tgsi.image[PIPE_SHADER_FRAGMENT],
+                           (struct tgsi_buffer *)
+                           sp->tgsi.buffer[PIPE_SHADER_FRAGMENT]);
+
+   thread->occlusion_count = 0;
+
+   first = sp_chain_quad_stages(sp, thread->shade, thread->depth_test,
+                                thread->blend);
+   sp_setup_prepare_binned(thread->setup, setup, first);
+}
+
+
+/**
+ * Thread function: rasterize tiles until there are none left.
+ */
+static void
+sp_bin_thread_execute(void *job, int thread_index)
+{
+   struct sp_bin_thread *thread = job;
+   struct sp_binner *binner = thread->binner;
+   unsigned i;
+
+   while ((i = p_atomic_inc_return(&binner->next_tile) - 1) <
+          binner->num_used_tiles) {
+      const unsigned tile = binner->used_tiles[i];
+      const struct sp_bin *bin = &binner->bins[tile];
+      unsigned j;
+
+      sp_setup_set_tile(thread->setup,
+                        (tile % binner->tiles_x) * TILE_SIZE,
+                        (tile / binner->tiles_x) * TILE_SIZE,
+                        TILE_SIZE);
+
+      for (j = 0; j < bin->count; j++) {
+         const struct sp_bin_prim *p = &binner->prims[bin->prims[j]];
+
+         switch (p->prim) {
+         case PIPE_PRIM_POINTS:
+            sp_setup_point(thread->setup, p->v[0]);
+            break;
+         case PIPE_PRIM_LINES:
+            sp_setup_line(thread->setup, p->v[0], p->v[1]);
+            break;
+         default:
+            sp_setup_tri(thread->setup, p->v[0], p->v[1], p->v[2]);
+            break;
+         }
+      }
+   }
+
+   /* Another thread may get these tiles in the next batch */
+   for (i = 0; i < PIPE_MAX_COLOR_BUFS; i++)
+      sp_flush_tile_cache(thread->cbuf_cache[i]);
+   sp_flush_tile_cache(thread->zsbuf_cache);
+}
+
+
+/**
+ * Release what sp_bin_thread_begin() set up, once the thread is done.
+ */
+static void
+sp_bin_thread_end(struct sp_bin_thread *thread)
+{
+   struct softpipe_context *sp = thread->binner->softpipe;
+   unsigned i;
+
+   sp->occlusion_count += thread->occlusion_count;
+
+   for (i = 0; i < PIPE_MAX_COLOR_BUFS; i++)
+      sp_tile_cache_set_surface(thread->cbuf_cache[i], NULL);
+   sp_tile_cache_set_surface(thread->zsbuf_cache, NULL);
+
+   for (i = 0; i < PIPE_MAX_SHADER_SAMPLER_VIEWS; i++) {
+      if (thread->tex_cache[i])
+         sp_tex_tile_cache_set_sampler_view(thread->tex_cache[i], NULL);
+   }
+}
+
+
+/**
+ * Rasterize the binned primitives of the batch, which \p setup was
+ * prepared for, and wait for it to be done.
+ */
+void
+sp_binner_flush(struct sp_binner *binner, struct setup_context *setup)
+{
+   struct softpipe_context *sp = binner->softpipe;
+   unsigned i;
+
+   if (binner->num_used_tiles == 1) {
+      /* Not worth handing it to the threads */
+      for (i = 0; i < binner->num_prims; i++) {
+         const struct sp_bin_prim *p = &binner->prims[i];
+
+         sp_setup_unbinned_prim(setup, p->prim, p->v[0], p->v[1], p->v[2]);
+      }
+   }
+   else if (binner->num_used_tiles) {
+      /* The threads read the framebuffer through their own tile caches */
+      for (i = 0; i < sp->framebuffer.nr_cbufs; i++)
+         sp_flush_tile_cache(sp->cbuf_cache[i]);
+      sp_flush_tile_cache(sp->zsbuf_cache);
+
+      binner->next_tile = 0;
+
+      for (i = 0; i < binner->num_threads; i++) {
+         struct sp_bin_thread *thread = &binner->thread[i];
+
+         sp_bin_thread_begin(thread, setup);
+         util_queue_add_job(&binner->queue, thread, &thread->fence,
+                            sp_bin_thread_execute, NULL);
+      }
+
+      for (i = 0; i < binner->num_threads; i++) {
+         struct sp_bin_thread *thread = &binner->thread[i];
+
+         util_queue_fence_wait(&thread->fence);
+         sp_bin_thread_end(thread);
+      }
+   }
+
+   for (i = 0; i < binner->num_used_tiles; i++)
+      binner->bins[binner->used_tiles[i]].count = 0;
+   binner->num_used_tiles = 0;
+   binner->num_prims = 0;
+}
+
+
+struct sp_binner *
+sp_binner_create(struct softpipe_context *sp, unsigned num_threads)
+{
+   struct sp_binner *binner = CALLOC_STRUCT(sp_binner);
+   unsigned i, j;
+
+   if (!binner)
+      return NULL;
+
+   binner->softpipe = sp;
+
+   if (!util_queue_init(&binner->queue, "sprast", num_threads, num_threads,
+                        0)) {
+      FREE(binner);
+      return NULL;
+   }
+
+   for (i = 0; i < num_threads; i++) {
+      struct sp_bin_thread *thread = &binner->thread[i];
+
+      binner->num_threads++;
+      thread->binner = binner;
+      util_queue_fence_init(&thread->fence);
+
+      thread->setup = sp_setup_create_context(sp);
+      thread->shade = sp_quad_shade_stage(sp);
+      thread->depth_test = sp_quad_depth_test_stage(sp);
+      thread->blend = sp_quad_blend_stage(sp);
+      thread->fs_machine = tgsi_exec_machine_create(PIPE_SHADER_FRAGMENT);
+      thread->sampler = sp_create_tgsi_sampler();
+      for (j = 0; j < PIPE_MAX_COLOR_BUFS; j++) {
+         thread->cbuf_cache[j] = sp_create_tile_cache(&sp->pipe);
+         if (!thread->cbuf_cache[j])
+            goto fail;
+      }
+      thread->zsbuf_cache = sp_create_tile_cache(&sp->pipe);
+
+      if (!thread->setup || !thread->shade || !thread->depth_test ||
+          !thread->blend || !thread->fs_machine || !thread->sampler ||
+          !thread->zsbuf_cache)
+         goto fail;
+
+      thread->target.fs_machine = thread->fs_machine;
+      thread->target.cbuf_cache = thread->cbuf_cache;
+      thread->target.zsbuf_cache = thread->zsbuf_cache;
+      thread->target.occlusion_count = &thread->occlusion_count;
+
+      thread->shade->target = &thread->target;
+      thread->depth_test->target = &thread->target;
+      thread->blend->target = &thread->target;
+   }
+
+   return binner;
+
+fail:
+   sp_binner_destroy(binner);
+   return NULL;
+}
+
+
+void
+sp_binner_destroy(struct sp_binner *binner)
+{
+   unsigned i, j;
+
+   util_queue_destroy(&binner->queue);
+
+   for (i = 0; i < binner->num_threads; i++) {
+      struct sp_bin_thread *thread = &binner->thread[i];
+
+      if (thread->setup)
+         sp_setup_destroy_context(thread->setup);
+      if (thread->shade)
+         thread->shade->destroy(thread->shade);
+      if (thread->depth_test)
+         thread->depth_test->destroy(thread->depth_test);
+      if (thread->blend)
+         thread->blend->destroy(thread->blend);
+      tgsi_exec_machine_destroy(thread->fs_machine);
+      FREE(thread->sampler);
+
+      for (j = 0; j < PIPE_MAX_COLOR_BUFS; j++)
+         sp_destroy_tile_cache(thread->cbuf_cache[j]);
+      sp_destroy_tile_cache(thread->zsbuf_cache);
+
+      for (j = 0; j < PIPE_MAX_SHADER_SAMPLER_VIEWS; j++)
+         sp_destroy_tex_tile_cache(thread->tex_cache[j]);
+
+      util_queue_fence_destroy(&thread->fence);
+   }
+
+   for (i = 0; i < binner->max_bins; i++)
+      FREE(binner->bins[i].prims);
+   FREE(binner->bins);
+   FREE(binner->used_tiles);
+   FREE(binner->prims);
+
+   FREE(binner);
+}
@@ -39,10 +39,12 @@
 #include "util/u_inlines.h"
 #include "util/u_upload_mgr.h"
 #include "tgsi/tgsi_exec.h"
+#include "sp_bin.h"
 #include "sp_buffer.h"
 #include "sp_clear.h"
 #include "sp_context.h"
 #include "sp_flush.h"
+#include "sp_limits.h"
 #include "sp_prim_vbuf.h"
 #include "sp_state.h"
 #include "sp_surface.h"
@@ -75,6 +77,9 @@ softpipe_destroy( struct pipe_context *pipe )
    if (softpipe->draw)
       draw_destroy( softpipe->draw );
 
+   if (softpipe->binner)
+      sp_binner_destroy(softpipe->binner);
+
    if (softpipe->quad.shade)
       softpipe->quad.shade->destroy( softpipe->quad.shade );
 
@@ -265,6 +270,11 @@ softpipe_create_context(struct pipe_screen *screen,
 
    softpipe->fs_machine = tgsi_exec_machine_create(PIPE_SHADER_FRAGMENT);
 
+   softpipe->quad.target.fs_machine = softpipe->fs_machine;
+   softpipe->quad.target.cbuf_cache = softpipe->cbuf_cache;
+   softpipe->quad.target.zsbuf_cache = softpipe->zsbuf_cache;
+   softpipe->quad.target.occlusion_count = &softpipe->occlusion_count;
+
    /* setup quad rendering stages */
    softpipe->quad.shade = sp_quad_shade_stage(softpipe);
    softpipe->quad.depth_test = sp_quad_depth_test_stage(softpipe);
@@ -319,6 +329,17 @@ softpipe_create_context(struct pipe_screen *screen,
    if (debug_get_bool_option( "SOFTPIPE_NO_RAST", FALSE ))
       softpipe->no_rast = TRUE;
 
+   /* Optional tile-binned rasterization on worker threads */
+   {
+      unsigned num_threads =
+         debug_get_num_option("SOFTPIPE_NUM_THREADS", 0);
+      if (num_threads) {
+         softpipe->binner = sp_binner_create(softpipe,
+                                             MIN2(num_threads,
+                                                  SP_MAX_THREADS));
+      }
+   }
+
    softpipe->vbuf_backend = sp_create_vbuf_backend(softpipe);
    if (!softpipe->vbuf_backend)
       goto fail;
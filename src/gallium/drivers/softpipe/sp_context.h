@@ -56,6 +56,7 @@ struct sp_fragment_shader;
 struct sp_vertex_shader;
 struct sp_velems_state;
 struct sp_so_state;
+struct sp_binner;
 
 struct softpipe_context {
    struct pipe_context pipe;  /**< base class */
@@ -167,6 +168,7 @@ struct softpipe_context {
       struct quad_stage *blend;
       struct quad_stage *pstipple;
       struct quad_stage *first; /**< points to one of the above stages */
+      struct sp_quad_target target;
    } quad;
 
    /** TGSI exec things */
@@ -189,6 +191,9 @@ struct softpipe_context {
 
    struct blitter_context *blitter;
 
+   /** Tile-binned rasterization threads, if enabled */
+   struct sp_binner *binner;
+
    boolean dirty_render_cache;
 
    struct softpipe_tile_cache *cbuf_cache[PIPE_MAX_COLOR_BUFS];
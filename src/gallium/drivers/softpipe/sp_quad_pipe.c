@@ -69,3 +69,27 @@ sp_build_quad_pipeline(struct softpipe_context *sp)
 #endif
 }
 
+
+/**
+ * Chain up another set of shade, depth test and blend stages in the same
+ * order sp_build_quad_pipeline() chose for the context's stages.
+ * \return the first stage
+ */
+struct quad_stage *
+sp_chain_quad_stages(const struct softpipe_context *sp,
+                     struct quad_stage *shade,
+                     struct quad_stage *depth_test,
+                     struct quad_stage *blend)
+{
+   if (sp->early_depth) {
+      depth_test->next = shade;
+      shade->next = blend;
+      return depth_test;
+   }
+   else {
+      shade->next = depth_test;
+      depth_test->next = blend;
+      return shade;
+   }
+}
+
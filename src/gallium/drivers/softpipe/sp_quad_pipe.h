@@ -31,11 +31,28 @@
 #ifndef SP_QUAD_PIPE_H
 #define SP_QUAD_PIPE_H
 
+#include "pipe/p_compiler.h"
+
 
 struct softpipe_context;
+struct softpipe_tile_cache;
+struct tgsi_exec_machine;
 struct quad_header;
 
 
+/**
+ * What the quad stages render with.  The context's stages use the context's
+ * fragment shader machine and framebuffer tile caches, while each tile
+ * rasterization thread has its own (see sp_bin.c).
+ */
+struct sp_quad_target {
+   struct tgsi_exec_machine *fs_machine;
+   struct softpipe_tile_cache **cbuf_cache;  /**< [PIPE_MAX_COLOR_BUFS] */
+   struct softpipe_tile_cache *zsbuf_cache;
+   uint64_t *occlusion_count;
+};
+
+
 /**
  * Fragment processing is performed on 2x2 blocks of pixels called "quads".
  * Quad processing is performed with a pipeline of stages represented by
@@ -43,6 +60,7 @@ struct quad_header;
  */
 struct quad_stage {
    struct softpipe_context *softpipe;
+   struct sp_quad_target *target;
 
    struct quad_stage *next;
 
@@ -69,4 +87,10 @@ struct quad_stage *sp_quad_output_stage( struct softpipe_context *softpipe );
 
 void sp_build_quad_pipeline(struct softpipe_context *sp);
 
+struct quad_stage *
+sp_chain_quad_stages(const struct softpipe_context *sp,
+                     struct quad_stage *shade,
+                     struct quad_stage *depth_test,
+                     struct quad_stage *blend);
+
 #endif /* SP_QUAD_PIPE_H */
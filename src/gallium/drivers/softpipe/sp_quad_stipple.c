@@ -73,6 +73,7 @@ sp_quad_polygon_stipple_stage( struct softpipe_context *softpipe )
    struct quad_stage *stage = CALLOC_STRUCT(quad_stage);
 
    stage->softpipe = softpipe;
+   stage->target = &softpipe->quad.target;
    stage->begin = stipple_begin;
    stage->run = stipple_quad;
    stage->destroy = stipple_destroy;
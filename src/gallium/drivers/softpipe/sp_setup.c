@@ -32,6 +32,7 @@
  * \author  Brian Paul
  */
 
+#include "sp_bin.h"
 #include "sp_context.h"
 #include "sp_quad.h"
 #include "sp_quad_pipe.h"
@@ -74,6 +75,16 @@ struct edge {
 struct setup_context {
    struct softpipe_context *softpipe;
 
+   /** First quad stage to feed */
+   struct quad_stage *first;
+
+   /** Per-viewport clip rects, the context's or tile_cliprect */
+   const struct pipe_scissor_state *cliprect;
+   struct pipe_scissor_state tile_cliprect[PIPE_MAX_VIEWPORTS];
+
+   /** Where the primitives go instead when they're being binned */
+   struct sp_binner *binner;
+
    /* Vertices are just an array of floats making up each attribute in
     * turn.  Currently fixed at 4 floats, but should change in time.
     * Codegen will help cope with this.
@@ -128,7 +139,7 @@ static inline void
 quad_clip(struct setup_context *setup, struct quad_header *quad)
 {
    unsigned viewport_index = quad[0].input.viewport_index;
-   const struct pipe_scissor_state *cliprect = &setup->softpipe->cliprect[viewport_index];
+   const struct pipe_scissor_state *cliprect = &setup->cliprect[viewport_index];
    const int minx = (int) cliprect->minx;
    const int maxx = (int) cliprect->maxx;
    const int miny = (int) cliprect->miny;
@@ -162,13 +173,11 @@ clip_emit_quad(struct setup_context *setup, struct quad_header *quad)
    quad_clip(setup, quad);
 
    if (quad->inout.mask) {
-      struct softpipe_context *sp = setup->softpipe;
-
 #if DEBUG_FRAGS
       setup->numFragsEmitted += util_bitcount(quad->inout.mask);
 #endif
 
-      sp->quad.first->run( sp->quad.first, &quad, 1 );
+      setup->first->run( setup->first, &quad, 1 );
    }
 }
 
@@ -203,7 +212,7 @@ flush_spans(struct setup_context *setup)
    const int xleft1 = setup->span.left[1];
    const int xright0 = setup->span.right[0];
    const int xright1 = setup->span.right[1];
-   struct quad_stage *pipe = setup->softpipe->quad.first;
+   struct quad_stage *pipe = setup->first;
 
    const int minleft = block_x(MIN2(xleft0, xleft1));
    const int maxright = MAX2(xright0, xright1);
@@ -702,7 +711,7 @@ subtriangle(struct setup_context *setup,
             int lines,
             unsigned viewport_index)
 {
-   const struct pipe_scissor_state *cliprect = &setup->softpipe->cliprect[viewport_index];
+   const struct pipe_scissor_state *cliprect = &setup->cliprect[viewport_index];
    const int minx = (int) cliprect->minx;
    const int maxx = (int) cliprect->maxx;
    const int miny = (int) cliprect->miny;
@@ -810,6 +819,11 @@ sp_setup_tri(struct setup_context *setup,
 
    if (setup->softpipe->no_rast || setup->softpipe->rasterizer->rasterizer_discard)
       return;
+
+   if (setup->binner) {
+      sp_bin_tri(setup->binner, v0, v1, v2);
+      return;
+   }
    
    det = calc_det(v0, v1, v2);
    /*
@@ -1099,6 +1113,11 @@ sp_setup_line(struct setup_context *setup,
    if (dx == 0 && dy == 0)
       return;
 
+   if (setup->binner) {
+      sp_bin_line(setup->binner, v0, v1);
+      return;
+   }
+
    if (!setup_line_coefficients(setup, v0, v1))
       return;
 
@@ -1243,6 +1262,11 @@ sp_setup_point(struct setup_context *setup,
    if (setup->softpipe->no_rast || setup->softpipe->rasterizer->rasterizer_discard)
       return;
 
+   if (setup->binner) {
+      sp_bin_point(setup->binner, v0, size);
+      return;
+   }
+
    assert(setup->softpipe->reduced_prim == PIPE_PRIM_POINTS);
 
    if (setup->softpipe->layer_slot > 0) {
@@ -1477,7 +1501,9 @@ sp_setup_prepare(struct setup_context *setup)
 
    setup->max_layer = max_layer;
 
-   sp->quad.first->begin( sp->quad.first );
+   setup->cliprect = sp->cliprect;
+   setup->first = sp->quad.first;
+   setup->first->begin( setup->first );
 
    if (sp->reduced_api_prim == PIPE_PRIM_TRIANGLES &&
        sp->rasterizer->fill_front == PIPE_POLYGON_MODE_FILL &&
@@ -1489,6 +1515,95 @@ sp_setup_prepare(struct setup_context *setup)
       /* 'draw' will do culling */
       setup->cull_face = PIPE_FACE_NONE;
    }
+
+   setup->binner = sp->binner && sp_binner_begin(sp->binner) ?
+                   sp->binner : NULL;
+}
+
+
+/**
+ * Called by vbuf code after each batch of primitives, before the vertices
+ * go away: rasterize whatever was binned.
+ */
+void
+sp_setup_flush(struct setup_context *setup)
+{
+   if (setup->binner)
+      sp_binner_flush(setup->binner, setup);
+}
+
+
+/**
+ * Rasterize the primitive directly, even if the batch is being binned.
+ */
+void
+sp_setup_unbinned_prim(struct setup_context *setup,
+                       unsigned prim,
+                       const float (*v0)[4],
+                       const float (*v1)[4],
+                       const float (*v2)[4])
+{
+   struct sp_binner *binner = setup->binner;
+
+   setup->binner = NULL;
+
+   switch (prim) {
+   case PIPE_PRIM_POINTS:
+      sp_setup_point(setup, v0);
+      break;
+   case PIPE_PRIM_LINES:
+      sp_setup_line(setup, v0, v1);
+      break;
+   default:
+      sp_setup_tri(setup, v0, v1, v2);
+      break;
+   }
+
+   setup->binner = binner;
+}
+
+
+/**
+ * Prepare the setup context of a tile rasterization thread for the batch
+ * of primitives \p src was prepared for, feeding the thread's own quad
+ * stages starting at \p first.
+ */
+void
+sp_setup_prepare_binned(struct setup_context *setup,
+                        const struct setup_context *src,
+                        struct quad_stage *first)
+{
+   setup->nr_vertex_attrs = src->nr_vertex_attrs;
+   setup->pixel_offset = src->pixel_offset;
+   setup->max_layer = src->max_layer;
+   setup->cull_face = src->cull_face;
+   setup->cliprect = setup->tile_cliprect;
+   setup->first = first;
+   setup->binner = NULL;
+
+   setup->first->begin( setup->first );
+}
+
+
+/**
+ * Restrict the rasterization to the screen tile at \p x, \p y, on top of
+ * the context's clip rects.
+ */
+void
+sp_setup_set_tile(struct setup_context *setup,
+                  unsigned x, unsigned y, unsigned size)
+{
+   const struct pipe_scissor_state *cliprect = setup->softpipe->cliprect;
+   unsigned i;
+
+   for (i = 0; i < PIPE_MAX_VIEWPORTS; i++) {
+      struct pipe_scissor_state *tile = &setup->tile_cliprect[i];
+
+      tile->minx = MAX2(cliprect[i].minx, x);
+      tile->miny = MAX2(cliprect[i].miny, y);
+      tile->maxx = MAX2(MIN2(cliprect[i].maxx, x + size), tile->minx);
+      tile->maxy = MAX2(MIN2(cliprect[i].maxy, y + size), tile->miny);
+   }
 }
 
 
@@ -1509,6 +1624,7 @@ sp_setup_create_context(struct softpipe_context *softpipe)
    unsigned i;
 
    setup->softpipe = softpipe;
+   setup->cliprect = softpipe->cliprect;
 
    for (i = 0; i < MAX_QUADS; i++) {
       setup->quad[i].coef = setup->coef;
@@ -29,6 +29,7 @@
 
 struct setup_context;
 struct softpipe_context;
+struct quad_stage;
 
 /**
  * Attribute interpolation mode
@@ -72,6 +73,23 @@ sp_clamp_viewport_idx(int idx)
 
 struct setup_context *sp_setup_create_context( struct softpipe_context *softpipe );
 void sp_setup_prepare( struct setup_context *setup );
+void sp_setup_flush( struct setup_context *setup );
+
+void
+sp_setup_unbinned_prim(struct setup_context *setup,
+                       unsigned prim,
+                       const float (*v0)[4],
+                       const float (*v1)[4],
+                       const float (*v2)[4]);
+
+void
+sp_setup_prepare_binned(struct setup_context *setup,
+                        const struct setup_context *src,
+                        struct quad_stage *first);
+
+void
+sp_setup_set_tile(struct setup_context *setup,
+                  unsigned x, unsigned y, unsigned size);
 void sp_setup_destroy_context( struct setup_context *setup );
 
 #endif
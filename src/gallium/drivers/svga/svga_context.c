@@ -75,6 +75,7 @@ svga_destroy(struct pipe_context *pipe)
    /* free HW constant buffers */
    for (shader = 0; shader < ARRAY_SIZE(svga->state.hw_draw.constbuf); shader++) {
       pipe_resource_reference(&svga->state.hw_draw.constbuf[shader], NULL);
+      FREE(svga->state.hw_draw.const0_shadow[shader]);
    }
 
    pipe->delete_blend_state(pipe, svga->noop_blend);
@@ -271,6 +272,10 @@ svga_context_create(struct pipe_screen *screen, void *priv, unsigned flags)
           sizeof(svga->state.hw_draw.default_constbuf_size));
    memset(svga->state.hw_draw.enabled_constbufs, 0,
           sizeof(svga->state.hw_draw.enabled_constbufs));
+   memset(svga->state.hw_draw.const0_shadow, 0,
+          sizeof(svga->state.hw_draw.const0_shadow));
+   memset(svga->state.hw_draw.const0_shadow_size, 0,
+          sizeof(svga->state.hw_draw.const0_shadow_size));
    svga->state.hw_draw.ib = NULL;
    svga->state.hw_draw.num_vbuffers = 0;
    memset(svga->state.hw_draw.vbuffers, 0,
@@ -404,6 +404,13 @@ struct svga_hw_draw_state
    /* used for rebinding */
    unsigned default_constbuf_size[PIPE_SHADER_TYPES];
 
+   /**
+    * Copy of the contents of the bound default constant buffer, per shader
+    * stage, used to skip uploading and rebinding the same constants again.
+    */
+   void *const0_shadow[PIPE_SHADER_TYPES];
+   unsigned const0_shadow_size[PIPE_SHADER_TYPES];
+
    boolean rasterizer_discard; /* set if rasterization is disabled */
    boolean has_backed_views;   /* set if any of the rtv/dsv is a backed surface view */
 };
@@ -30,6 +30,8 @@
 #include "util/u_screen.h"
 #include "util/u_string.h"
 #include "util/u_math.h"
+#include "util/disk_cache.h"
+#include "util/mesa-sha1.h"
 
 #include "os/os_process.h"
 
@@ -929,11 +931,37 @@ nop_host_log(struct svga_winsys_screen *sws, const char *message)
 }
 
 
+static void
+svga_disk_cache_create(struct svga_screen *svgascreen)
+{
+   struct mesa_sha1 ctx;
+   unsigned char sha1[20];
+   char cache_id[20 * 2 + 1];
+
+   _mesa_sha1_init(&ctx);
+   if (!disk_cache_get_function_identifier(svga_disk_cache_create, &ctx))
+      return;
+
+   _mesa_sha1_final(&ctx, sha1);
+   disk_cache_format_hex_id(cache_id, sha1, 20 * 2);
+
+   svgascreen->disk_shader_cache = disk_cache_create("svga", cache_id, 0);
+}
+
+
+static struct disk_cache *
+svga_get_disk_shader_cache(struct pipe_screen *screen)
+{
+   return svga_screen(screen)->disk_shader_cache;
+}
+
+
 static void
 svga_destroy_screen( struct pipe_screen *screen )
 {
    struct svga_screen *svgascreen = svga_screen(screen);
 
+   disk_cache_destroy(svgascreen->disk_shader_cache);
    svga_screen_cache_cleanup(svgascreen);
 
    mtx_destroy(&svgascreen->swc_mutex);
@@ -990,6 +1018,7 @@ svga_screen_create(struct svga_winsys_screen *sws)
    screen->fence_reference = svga_fence_reference;
    screen->fence_finish = svga_fence_finish;
    screen->fence_get_fd = svga_fence_get_fd;
+   screen->get_disk_shader_cache = svga_get_disk_shader_cache;
 
    screen->get_driver_query_info = svga_get_driver_query_info;
    svgascreen->sws = sws;
@@ -1146,6 +1175,10 @@ svga_screen_create(struct svga_winsys_screen *sws)
 
    svga_screen_cache_init(svgascreen);
 
+   /* Only the VGPU10 translator stores its shaders on disk. */
+   if (sws->have_vgpu10)
+      svga_disk_cache_create(svgascreen);
+
    if (debug_get_bool_option("SVGA_NO_LOGGING", FALSE) == TRUE) {
       svgascreen->sws->host_log = nop_host_log;
    } else {
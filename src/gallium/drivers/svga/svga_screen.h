@@ -40,6 +40,8 @@ struct SVGACmdMemory;
 /**
  * Subclass of pipe_screen
  */
+struct disk_cache;
+
 struct svga_screen
 {
    struct pipe_screen screen;
@@ -81,6 +83,9 @@ struct svga_screen
 
    struct svga_host_surface_cache cache;
 
+   /** On-disk cache of translated VGPU10 shaders, may be NULL */
+   struct disk_cache *disk_shader_cache;
+
    /** HUD counters */
    struct {
       /** Memory used by all resources (buffers and surfaces) */
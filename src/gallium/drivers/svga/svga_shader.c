@@ -23,12 +23,17 @@
  *
  **********************************************************/
 
+#include "compiler/blob.h"
+#include "tgsi/tgsi_parse.h"
+#include "util/disk_cache.h"
 #include "util/u_bitmask.h"
 #include "util/u_memory.h"
 #include "util/u_format.h"
 #include "svga_context.h"
 #include "svga_cmd.h"
+#include "svga_debug.h"
 #include "svga_format.h"
+#include "svga_screen.h"
 #include "svga_shader.h"
 #include "svga_resource_texture.h"
 
@@ -587,6 +592,143 @@ svga_destroy_shader_variant(struct svga_context *svga,
    svga->hud.num_shaders--;
 }
 
+static void
+blob_write_tokens(struct blob *blob, const struct tgsi_token *tokens)
+{
+   blob_write_bytes(blob, tokens,
+                    tgsi_num_tokens(tokens) * sizeof(struct tgsi_token));
+}
+
+
+/**
+ * Compute the disk cache key of a VGPU10 shader variant.
+ *
+ * Besides the shader's own tokens and the compile key, the translation
+ * links the shader against the inputs or outputs of the previous stage,
+ * so the tokens of that stage are part of the key as well.
+ * Returns FALSE if the variant shouldn't be looked up in the cache.
+ */
+boolean
+svga_shader_cache_key(const struct svga_context *svga,
+                      const struct svga_shader *shader,
+                      const struct svga_compile_key *key,
+                      enum pipe_shader_type unit,
+                      unsigned char *hash)
+{
+   struct disk_cache *cache =
+      svga_screen(svga->pipe.screen)->disk_shader_cache;
+   const struct svga_shader *linked = NULL;
+   struct blob blob;
+   boolean ok;
+
+   if (!cache || (SVGA_DEBUG & DEBUG_TGSI))
+      return FALSE;
+
+   if (unit == PIPE_SHADER_FRAGMENT)
+      linked = svga->curr.gs ? &svga->curr.gs->base : &svga->curr.vs->base;
+   else if (unit == PIPE_SHADER_GEOMETRY)
+      linked = &svga->curr.vs->base;
+
+   blob_init(&blob);
+   blob_write_uint32(&blob, unit);
+   blob_write_uint32(&blob, svga_have_sm4_1(svga));
+   blob_write_uint32(&blob, shader->stream_output != NULL);
+   blob_write_bytes(&blob, key, sizeof(*key));
+   blob_write_tokens(&blob, shader->tokens);
+   if (linked)
+      blob_write_tokens(&blob, linked->tokens);
+
+   ok = !blob.out_of_memory;
+   if (ok)
+      disk_cache_compute_key(cache, blob.data, blob.size, hash);
+   blob_finish(&blob);
+
+   return ok;
+}
+
+
+/**
+ * Create a shader variant from the disk cache, if it's there.
+ */
+struct svga_shader_variant *
+svga_shader_cache_get_variant(struct svga_context *svga,
+                              const struct svga_shader *shader,
+                              const struct svga_compile_key *key,
+                              enum pipe_shader_type unit,
+                              const unsigned char *hash)
+{
+   struct disk_cache *cache =
+      svga_screen(svga->pipe.screen)->disk_shader_cache;
+   struct svga_shader_variant *variant;
+   struct blob_reader blob;
+   unsigned *tokens;
+   size_t size;
+   void *data;
+
+   data = disk_cache_get(cache, hash, &size);
+   if (!data)
+      return NULL;
+
+   variant = svga_new_shader_variant(svga, unit);
+   if (!variant) {
+      free(data);
+      return NULL;
+   }
+
+   blob_reader_init(&blob, data, size);
+   variant->shader = shader;
+   memcpy(&variant->key, key, sizeof(*key));
+   variant->id = UTIL_BITMASK_INVALID_INDEX;
+   variant->nr_tokens = blob_read_uint32(&blob);
+   variant->extra_const_start = blob_read_uint32(&blob);
+   variant->pstipple_sampler_unit = blob_read_uint32(&blob);
+   variant->constant_color_output = blob_read_uint32(&blob);
+   variant->uses_flat_interp = blob_read_uint32(&blob);
+   variant->fs_shadow_compare_units = blob_read_uint32(&blob);
+
+   tokens = blob.overrun ? NULL : MALLOC(variant->nr_tokens * sizeof(unsigned));
+   if (tokens)
+      blob_copy_bytes(&blob, tokens, variant->nr_tokens * sizeof(unsigned));
+   variant->tokens = tokens;
+
+   if (!tokens || blob.overrun || blob.current != blob.end) {
+      svga_destroy_shader_variant(svga, variant);
+      variant = NULL;
+   }
+
+   free(data);
+   return variant;
+}
+
+
+/**
+ * Store a newly translated shader variant in the disk cache.
+ */
+void
+svga_shader_cache_put_variant(struct svga_context *svga,
+                              const struct svga_shader_variant *variant,
+                              const unsigned char *hash)
+{
+   struct disk_cache *cache =
+      svga_screen(svga->pipe.screen)->disk_shader_cache;
+   struct blob blob;
+
+   blob_init(&blob);
+   blob_write_uint32(&blob, variant->nr_tokens);
+   blob_write_uint32(&blob, variant->extra_const_start);
+   blob_write_uint32(&blob, variant->pstipple_sampler_unit);
+   blob_write_uint32(&blob, variant->constant_color_output);
+   blob_write_uint32(&blob, variant->uses_flat_interp);
+   blob_write_uint32(&blob, variant->fs_shadow_compare_units);
+   blob_write_bytes(&blob, variant->tokens,
+                    variant->nr_tokens * sizeof(unsigned));
+
+   if (!blob.out_of_memory)
+      disk_cache_put(cache, hash, blob.data, blob.size, NULL);
+   blob_finish(&blob);
+}
+
+
 /*
  * Rebind shaders.
  * Called at the beginning of every new command buffer to ensure that
@@ -294,6 +294,25 @@ svga_destroy_shader_variant(struct svga_context *svga,
 enum pipe_error
 svga_rebind_shaders(struct svga_context *svga);
 
+boolean
+svga_shader_cache_key(const struct svga_context *svga,
+                      const struct svga_shader *shader,
+                      const struct svga_compile_key *key,
+                      enum pipe_shader_type unit,
+                      unsigned char *hash);
+
+struct svga_shader_variant *
+svga_shader_cache_get_variant(struct svga_context *svga,
+                              const struct svga_shader *shader,
+                              const struct svga_compile_key *key,
+                              enum pipe_shader_type unit,
+                              const unsigned char *hash);
+
+void
+svga_shader_cache_put_variant(struct svga_context *svga,
+                              const struct svga_shader_variant *variant,
+                              const unsigned char *hash);
+
 /**
  * Check if a shader's bytecode exceeds the device limits.
  */
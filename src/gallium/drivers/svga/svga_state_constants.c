@@ -474,6 +474,63 @@ emit_consts_vgpu9(struct svga_context *svga, enum pipe_shader_type shader)
 
 
 
+/**
+ * Check whether the default constant buffer bound for the given stage
+ * already holds the given user constants and extra constants, in which
+ * case the state update doesn't need to upload and rebind anything.
+ * This is common when only the shader variant changed.
+ */
+static boolean
+const0_matches_shadow(const struct svga_context *svga,
+                      enum pipe_shader_type shader,
+                      const void *src_map, unsigned src_size,
+                      const void *extras, unsigned extra_offset,
+                      unsigned extra_size, unsigned new_buf_size)
+{
+   const char *shadow = svga->state.hw_draw.const0_shadow[shader];
+
+   return shadow &&
+          svga->state.hw_draw.constbuf[shader] &&
+          svga->state.hw_draw.const0_shadow_size[shader] == new_buf_size &&
+          (!src_size || memcmp(shadow, src_map, src_size) == 0) &&
+          (!extra_size ||
+           memcmp(shadow + extra_offset, extras, extra_size) == 0);
+}
+
+
+/**
+ * Remember the contents of the default constant buffer being uploaded.
+ * The copy is built from the sources rather than read back from the
+ * upload buffer.
+ */
+static void
+update_const0_shadow(struct svga_context *svga, enum pipe_shader_type shader,
+                     const void *src_map, unsigned src_size,
+                     const void *extras, unsigned extra_offset,
+                     unsigned extra_size, unsigned new_buf_size)
+{
+   struct svga_hw_draw_state *hw = &svga->state.hw_draw;
+   char *shadow;
+
+   if (hw->const0_shadow_size[shader] < new_buf_size) {
+      FREE(hw->const0_shadow[shader]);
+      hw->const0_shadow[shader] = MALLOC(new_buf_size);
+   }
+
+   shadow = hw->const0_shadow[shader];
+   if (!shadow) {
+      hw->const0_shadow_size[shader] = 0;
+      return;
+   }
+
+   if (src_size)
+      memcpy(shadow, src_map, src_size);
+   if (extra_size)
+      memcpy(shadow + extra_offset, extras, extra_size);
+   hw->const0_shadow_size[shader] = new_buf_size;
+}
+
+
 static enum pipe_error
 emit_constbuf_vgpu10(struct svga_context *svga, enum pipe_shader_type shader)
 {
@@ -549,6 +606,14 @@ emit_constbuf_vgpu10(struct svga_context *svga, enum pipe_shader_type shader)
     */
    new_buf_size = align(new_buf_size, 16);
 
+   if (const0_matches_shadow(svga, shader, src_map, cbuf->buffer_size,
+                             extras, extra_offset, extra_size,
+                             new_buf_size)) {
+      if (src_map)
+         pipe_buffer_unmap(&svga->pipe, src_transfer);
+      return PIPE_OK;
+   }
+
    /* Constant buffer size in the upload buffer must be in multiples of 256.
     * In order to maximize the chance of merging the upload buffer chunks
     * when svga_buffer_add_range() is called,
@@ -567,6 +632,10 @@ emit_constbuf_vgpu10(struct svga_context *svga, enum pipe_shader_type shader)
       return PIPE_ERROR_OUT_OF_MEMORY;
    }
 
+   /* Only trusted once the new buffer has been bound, see below. */
+   update_const0_shadow(svga, shader, src_map, cbuf->buffer_size,
+                        extras, extra_offset, extra_size, new_buf_size);
+
    if (src_map) {
       memcpy(dst_map, src_map, cbuf->buffer_size);
       pipe_buffer_unmap(&svga->pipe, src_transfer);
@@ -590,6 +659,7 @@ emit_constbuf_vgpu10(struct svga_context *svga, enum pipe_shader_type shader)
       dst_handle = svga_buffer_handle(svga, dst_buffer,
                                       PIPE_BIND_CONSTANT_BUFFER);
       if (!dst_handle) {
+         svga->state.hw_draw.const0_shadow_size[shader] = 0;
          pipe_resource_reference(&dst_buffer, NULL);
          return PIPE_ERROR_OUT_OF_MEMORY;
       }
@@ -609,6 +679,7 @@ emit_constbuf_vgpu10(struct svga_context *svga, enum pipe_shader_type shader)
                                                new_buf_size);
 
    if (ret != PIPE_OK) {
+      svga->state.hw_draw.const0_shadow_size[shader] = 0;
       pipe_resource_reference(&dst_buffer, NULL);
       return ret;
    }
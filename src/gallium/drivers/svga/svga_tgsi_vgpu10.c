@@ -47,6 +47,7 @@
 #include "util/u_memory.h"
 #include "util/u_bitmask.h"
 #include "util/u_debug.h"
+#include "util/disk_cache.h"
 #include "util/u_pstipple.h"
 
 #include "svga_context.h"
@@ -6909,13 +6910,13 @@ transform_fs_aapoint(const struct tgsi_token *tokens,
 }
 
 /**
- * This is the main entrypoint for the TGSI -> VPGU10 translator.
+ * Translate a TGSI shader into a new VGPU10 shader variant.
  */
-struct svga_shader_variant *
-svga_tgsi_vgpu10_translate(struct svga_context *svga,
-                           const struct svga_shader *shader,
-                           const struct svga_compile_key *key,
-                           enum pipe_shader_type unit)
+static struct svga_shader_variant *
+translate_vgpu10(struct svga_context *svga,
+                 const struct svga_shader *shader,
+                 const struct svga_compile_key *key,
+                 enum pipe_shader_type unit)
 {
    struct svga_shader_variant *variant = NULL;
    struct svga_shader_emitter_v10 *emit;
@@ -7120,3 +7121,33 @@ done:
    SVGA_STATS_TIME_POP(svga_sws(svga));
    return variant;
 }
+
+
+/**
+ * This is the main entrypoint for the TGSI to VGPU10 translator.
+ * Translated variants are kept in the disk cache, if there is one.
+ */
+struct svga_shader_variant *
+svga_tgsi_vgpu10_translate(struct svga_context *svga,
+                           const struct svga_shader *shader,
+                           const struct svga_compile_key *key,
+                           enum pipe_shader_type unit)
+{
+   struct svga_shader_variant *variant;
+   cache_key hash;
+   boolean use_cache;
+
+   use_cache = svga_shader_cache_key(svga, shader, key, unit, hash);
+   if (use_cache) {
+      variant = svga_shader_cache_get_variant(svga, shader, key, unit, hash);
+      if (variant)
+         return variant;
+   }
+
+   variant = translate_vgpu10(svga, shader, key, unit);
+
+   if (variant && use_cache)
+      svga_shader_cache_put_variant(svga, variant, hash);
+
+   return variant;
+}
@@ -100,6 +100,19 @@ KNOBS = [
         'category'  : 'perf',
     }],
 
+    ['SHARE_HW_THREADS', {
+        'type'      : 'bool',
+        'default'   : 'false',
+        'desc'      : ['Share the HW threads between concurrently live contexts.',
+                       '',
+                       'Each new context gets a fair share of the worker threads',
+                       '(all of them divided by the number of live sharing contexts),',
+                       'bound to the HW threads fewest other contexts\' workers use.',
+                       'Disables NUMA tile distribution.  Ignored if MAX_WORKER_THREADS',
+                       'is set.'],
+        'category'  : 'perf',
+    }],
+
     ['BASE_NUMA_NODE', {
         'type'      : 'uint32_t',
         'default'   : '0',
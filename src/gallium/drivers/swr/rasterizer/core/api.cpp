@@ -111,6 +111,7 @@ HANDLE SwrCreateContext(SWR_CREATECONTEXT_INFO* pCreateInfo)
         pContext->threadInfo.MAX_CORES_PER_NUMA_NODE = KNOB_MAX_CORES_PER_NUMA_NODE;
         pContext->threadInfo.MAX_THREADS_PER_CORE    = KNOB_MAX_THREADS_PER_CORE;
         pContext->threadInfo.SINGLE_THREADED         = KNOB_SINGLE_THREADED;
+        pContext->threadInfo.SHARE_HW_THREADS        = KNOB_SHARE_HW_THREADS;
     }
 
     if (pCreateInfo->pApiThreadInfo)
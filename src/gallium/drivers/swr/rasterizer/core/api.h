@@ -202,6 +202,7 @@ struct SWR_THREADING_INFO
     uint32_t MAX_CORES_PER_NUMA_NODE;
     uint32_t MAX_THREADS_PER_CORE;
     bool     SINGLE_THREADED;
+    bool     SHARE_HW_THREADS;
 };
 
 //////////////////////////////////////////////////////////////////////////
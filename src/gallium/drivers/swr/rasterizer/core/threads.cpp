@@ -29,6 +29,8 @@
 #include <utility>
 #include <fstream>
 #include <string>
+#include <mutex>
+#include <unordered_map>
 
 #if defined(__linux__) || defined(__gnu_linux__) || defined(__APPLE__)
 #include <pthread.h>
@@ -982,6 +984,18 @@ DWORD workerThreadInit(LPVOID pData)
 template <>
 DWORD workerThreadInit<false, false>(LPVOID pData) = delete;
 
+//////////////////////////////////////////////////////////////////////////
+/// Process-wide accounting of the HW threads the workers of live contexts
+/// are bound to, used when SHARE_HW_THREADS is set.
+static std::mutex                             gHWThreadUsageLock;
+static std::unordered_map<uint64_t, uint32_t> gHWThreadUsage;
+static uint32_t                               gNumSharingContexts = 0;
+
+static uint64_t HWThreadKey(const THREAD_DATA& threadData)
+{
+    return ((uint64_t)threadData.procGroupId << 32) | threadData.threadId;
+}
+
 static void InitPerThreadStats(SWR_CONTEXT* pContext, uint32_t numThreads)
 {
     // Initialize DRAW_CONTEXT's per-thread stats
@@ -1160,6 +1174,19 @@ void CreateThreadPool(SWR_CONTEXT* pContext, THREAD_POOL* pPool)
         }
     }
 
+    // Give each live context sharing HW threads a fair share of them.
+    // The lock is held until this context's workers have been placed.
+    std::unique_lock<std::mutex> usageLock(gHWThreadUsageLock, std::defer_lock);
+    pPool->isSharingHWThreads = pContext->threadInfo.SHARE_HW_THREADS &&
+                                !pContext->threadInfo.SINGLE_THREADED &&
+                                !pContext->threadInfo.MAX_WORKER_THREADS;
+    if (pPool->isSharingHWThreads)
+    {
+        usageLock.lock();
+        gNumSharingContexts++;
+        numThreads = std::max(1U, numThreads / gNumSharingContexts);
+    }
+
     InitPerThreadStats(pContext, numThreads);
 
     if (pContext->threadInfo.SINGLE_THREADED)
@@ -1247,8 +1274,9 @@ void CreateThreadPool(SWR_CONTEXT* pContext, THREAD_POOL* pPool)
     }
     else
     {
-        // numa distribution assumes workers on all nodes
-        bool useNuma = true;
+        // numa distribution assumes workers on all nodes, which a shared
+        // context doesn't necessarily get
+        bool useNuma = !pPool->isSharingHWThreads;
         if (numCoresPerNode * numHyperThreads == 1)
         {
             useNuma = false;
@@ -1263,8 +1291,8 @@ void CreateThreadPool(SWR_CONTEXT* pContext, THREAD_POOL* pPool)
             pPool->numaMask = 0;
         }
 
-        uint32_t workerId           = 0;
-        uint32_t numReservedThreads = numAPIReservedThreads;
+        std::vector<THREAD_DATA> workerThreads;
+        uint32_t                 numReservedThreads = numAPIReservedThreads;
         for (uint32_t n = 0; n < numNodes; ++n)
         {
             if ((n + pContext->threadInfo.BASE_NUMA_NODE) >= nodes.size())
@@ -1325,27 +1353,54 @@ void CreateThreadPool(SWR_CONTEXT* pContext, THREAD_POOL* pPool)
                         continue;
                     }
 
-                    SWR_ASSERT(workerId < numThreads);
+                    THREAD_DATA threadData = {};
+                    threadData.procGroupId = core.procGroup;
+                    threadData.threadId    = core.threadIds[t + pContext->threadInfo.BASE_THREAD];
+                    threadData.numaId = useNuma ? (n + pContext->threadInfo.BASE_NUMA_NODE) : 0;
+                    threadData.coreId = c + pContext->threadInfo.BASE_CORE;
+                    threadData.htId   = t + pContext->threadInfo.BASE_THREAD;
+                    threadData.pContext           = pContext;
+                    threadData.forceBindProcGroup = false;
 
-                    pPool->pThreadData[workerId].workerId    = workerId;
-                    pPool->pThreadData[workerId].procGroupId = core.procGroup;
-                    pPool->pThreadData[workerId].threadId =
-                        core.threadIds[t + pContext->threadInfo.BASE_THREAD];
-                    pPool->pThreadData[workerId].numaId =
-                        useNuma ? (n + pContext->threadInfo.BASE_NUMA_NODE) : 0;
-                    pPool->pThreadData[workerId].coreId   = c + pContext->threadInfo.BASE_CORE;
-                    pPool->pThreadData[workerId].htId     = t + pContext->threadInfo.BASE_THREAD;
-                    pPool->pThreadData[workerId].pContext = pContext;
-                    pPool->pThreadData[workerId].forceBindProcGroup = false;
+                    workerThreads.push_back(threadData);
+                }
+            }
+        }
 
-                    pContext->NumBEThreads++;
-                    pContext->NumFEThreads++;
+        if (pPool->isSharingHWThreads)
+        {
+            // Prefer the HW threads the fewest workers of other contexts are bound to
+            std::stable_sort(workerThreads.begin(),
+                             workerThreads.end(),
+                             [](const THREAD_DATA& a, const THREAD_DATA& b) {
+                                 return gHWThreadUsage[HWThreadKey(a)] <
+                                        gHWThreadUsage[HWThreadKey(b)];
+                             });
+        }
+        else
+        {
+            SWR_ASSERT(workerThreads.size() == numThreads);
+        }
 
-                    ++workerId;
-                }
+        uint32_t numWorkers = std::min(numThreads, (uint32_t)workerThreads.size());
+        for (uint32_t workerId = 0; workerId < numWorkers; ++workerId)
+        {
+            THREAD_DATA& threadData = pPool->pThreadData[workerId];
+            void*        pWorkerPrivateData = threadData.pWorkerPrivateData;
+
+            threadData                    = workerThreads[workerId];
+            threadData.pWorkerPrivateData = pWorkerPrivateData;
+            threadData.workerId           = workerId;
+
+            if (pPool->isSharingHWThreads)
+            {
+                gHWThreadUsage[HWThreadKey(threadData)]++;
             }
+
+            pContext->NumBEThreads++;
+            pContext->NumFEThreads++;
         }
-        SWR_ASSERT(workerId == pContext->NumWorkerThreads);
+        SWR_ASSERT(numWorkers == pContext->NumWorkerThreads);
     }
 }
 
@@ -1396,6 +1451,16 @@ void DestroyThreadPool(SWR_CONTEXT* pContext, THREAD_POOL* pPool)
 
     delete[] pPool->pThreads;
 
+    if (pPool->isSharingHWThreads)
+    {
+        std::lock_guard<std::mutex> usageLock(gHWThreadUsageLock);
+        for (uint32_t t = 0; t < pPool->numThreads; ++t)
+        {
+            gHWThreadUsage[HWThreadKey(pPool->pThreadData[t])]--;
+        }
+        gNumSharingContexts--;
+    }
+
     // Clean up data used by threads
     delete[] pPool->pThreadData;
     delete[] pPool->pApiThreadData;
@@ -60,6 +60,7 @@ struct THREAD_POOL
     void*        pWorkerPrivateDataArray; // All memory for worker private data
     uint32_t     numReservedThreads;      // Number of threads reserved for API use
     THREAD_DATA* pApiThreadData;
+    bool         isSharingHWThreads;      // Workers placed by SHARE_HW_THREADS
 };
 
 struct TileSet;
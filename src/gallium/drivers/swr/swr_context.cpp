@@ -503,6 +503,7 @@ swr_create_context(struct pipe_screen *p_screen, void *priv, unsigned flags)
    threadingInfo.MAX_CORES_PER_NUMA_NODE   = KNOB_MAX_CORES_PER_NUMA_NODE;
    threadingInfo.MAX_THREADS_PER_CORE      = KNOB_MAX_THREADS_PER_CORE;
    threadingInfo.SINGLE_THREADED           = KNOB_SINGLE_THREADED;
+   threadingInfo.SHARE_HW_THREADS          = KNOB_SHARE_HW_THREADS;
 
    // Use non-standard settings for KNL
    if (swr_screen(p_screen)->is_knl)
@@ -37,10 +37,14 @@
 #include "util/u_format_s3tc.h"
 #include "util/u_string.h"
 #include "util/u_screen.h"
+#include "util/disk_cache.h"
+#include "util/mesa-sha1.h"
+#include "gallivm/lp_bld_init.h"
 
 #include "state_tracker/sw_winsys.h"
 
 #include "jit_api.h"
+#include "llvm-c/ExecutionEngine.h"
 
 #include "memory/TilingFunctions.h"
 
@@ -1089,6 +1093,8 @@ swr_destroy_screen_internal(struct swr_screen **screen)
 
    JitDestroyContext((*screen)->hJitMgr);
 
+   disk_cache_destroy((*screen)->disk_shader_cache);
+
    if ((*screen)->pLibrary)
       util_dl_close((*screen)->pLibrary);
 
@@ -1154,6 +1160,90 @@ swr_validate_env_options(struct swr_screen *screen)
 }
 
 
+static struct disk_cache *
+swr_get_disk_shader_cache(struct pipe_screen *p_screen)
+{
+   return swr_screen(p_screen)->disk_shader_cache;
+}
+
+/*
+ * Create the disk cache for the object code of the JIT-compiled shaders.
+ * The cache is invalidated whenever swr or LLVM change, and by any CPU
+ * feature the JIT target is picked from.
+ */
+static void
+swr_disk_cache_create(struct swr_screen *screen)
+{
+   struct util_cpu_caps cpu_caps = util_cpu_caps;
+   struct mesa_sha1 ctx;
+   unsigned char sha1[20];
+   char cache_id[20 * 2 + 1];
+   unsigned llvm_version = HAVE_LLVM;
+   unsigned simd_width = KNOB_SIMD_WIDTH;
+
+   _mesa_sha1_init(&ctx);
+
+   if (!disk_cache_get_function_identifier((void *)swr_disk_cache_create,
+                                           &ctx) ||
+       !disk_cache_get_function_identifier((void *)LLVMLinkInMCJIT, &ctx))
+      return;
+
+   /* These don't affect code generation */
+   cpu_caps.nr_cpus = 0;
+   cpu_caps.cores_per_L3 = 0;
+
+   _mesa_sha1_update(&ctx, &llvm_version, sizeof(llvm_version));
+   _mesa_sha1_update(&ctx, &simd_width, sizeof(simd_width));
+   _mesa_sha1_update(&ctx, &cpu_caps, sizeof(cpu_caps));
+   _mesa_sha1_final(&ctx, sha1);
+   disk_cache_format_hex_id(cache_id, sha1, 20 * 2);
+
+   screen->disk_shader_cache = disk_cache_create("swr", cache_id, 0);
+}
+
+/*
+ * Look up the object code of a shader variant, and if found store it in
+ * cache, to be loaded by gallivm instead of compiling the variant.
+ */
+void
+swr_disk_cache_find_shader(struct swr_screen *screen,
+                           struct lp_cached_code *cache,
+                           const unsigned char ir_sha1_cache_key[20])
+{
+   cache_key key;
+
+   if (!screen->disk_shader_cache)
+      return;
+
+   disk_cache_compute_key(screen->disk_shader_cache, ir_sha1_cache_key,
+                          20, key);
+
+   cache->data = disk_cache_get(screen->disk_shader_cache, key,
+                                &cache->data_size);
+   if (!cache->data)
+      cache->data_size = 0;
+}
+
+/*
+ * Store the object code of a newly compiled shader variant.
+ */
+void
+swr_disk_cache_insert_shader(struct swr_screen *screen,
+                             struct lp_cached_code *cache,
+                             const unsigned char ir_sha1_cache_key[20])
+{
+   cache_key key;
+
+   if (!screen->disk_shader_cache || !cache->data_size || cache->dont_cache)
+      return;
+
+   disk_cache_compute_key(screen->disk_shader_cache, ir_sha1_cache_key,
+                          20, key);
+   disk_cache_put(screen->disk_shader_cache, key, cache->data,
+                  cache->data_size, NULL);
+}
+
+
 struct pipe_screen *
 swr_create_screen_internal(struct sw_winsys *winsys)
 {
@@ -1184,9 +1274,13 @@ swr_create_screen_internal(struct sw_winsys *winsys)
 
    screen->base.flush_frontbuffer = swr_flush_frontbuffer;
 
+   screen->base.get_disk_shader_cache = swr_get_disk_shader_cache;
+
    // Pass in "" for architecture for run-time determination
    screen->hJitMgr = JitCreateContext(KNOB_SIMD_WIDTH, "", "swr");
 
+   swr_disk_cache_create(screen);
+
    swr_fence_init(&screen->base);
 
    swr_validate_env_options(screen);
@@ -36,8 +36,10 @@
 #include "functionpasses/passes.h"
 
 #include "tgsi/tgsi_strings.h"
+#include "tgsi/tgsi_parse.h"
 #include "util/u_format.h"
 #include "util/u_prim.h"
+#include "util/mesa-sha1.h"
 #include "gallivm/lp_bld_init.h"
 #include "gallivm/lp_bld_flow.h"
 #include "gallivm/lp_bld_struct.h"
@@ -209,12 +211,31 @@ swr_generate_gs_key(struct swr_jit_gs_key &key,
    swr_generate_sampler_key(swr_gs->info, ctx, PIPE_SHADER_GEOMETRY, key);
 }
 
+/*
+ * Hash the shader tokens along with the variant key, to look the variant's
+ * object code up in the disk cache.
+ */
+static void
+swr_shader_sha1(const void *key, size_t key_size,
+                const struct tgsi_token *tokens,
+                unsigned char ir_sha1_cache_key[20])
+{
+   struct mesa_sha1 ctx;
+
+   _mesa_sha1_init(&ctx);
+   _mesa_sha1_update(&ctx, key, key_size);
+   _mesa_sha1_update(&ctx, tokens,
+                     tgsi_num_tokens(tokens) * sizeof(struct tgsi_token));
+   _mesa_sha1_final(&ctx, ir_sha1_cache_key);
+}
+
 struct BuilderSWR : public Builder {
-   BuilderSWR(JitManager *pJitMgr, const char *pName)
+   BuilderSWR(JitManager *pJitMgr, const char *pName,
+              struct lp_cached_code *cache = NULL)
       : Builder(pJitMgr)
    {
       pJitMgr->SetupNewModule();
-      gallivm = gallivm_create(pName, wrap(&JM()->mContext));
+      gallivm = gallivm_create(pName, wrap(&JM()->mContext), cache);
       pJitMgr->mpCurrentModule = unwrap(gallivm->module);
    }
 
@@ -717,11 +738,23 @@ BuilderSWR::CompileGS(struct swr_context *ctx, swr_jit_gs_key &key)
 PFN_GS_FUNC
 swr_compile_gs(struct swr_context *ctx, swr_jit_gs_key &key)
 {
+   struct swr_screen *screen = swr_screen(ctx->pipe.screen);
+   struct lp_cached_code cached = { 0 };
+   unsigned char ir_sha1_cache_key[20];
+
+   swr_shader_sha1(&key, sizeof(key), ctx->gs->pipe.tokens,
+                   ir_sha1_cache_key);
+   swr_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
+   bool needs_caching = !cached.data_size;
+
    BuilderSWR builder(
-      reinterpret_cast<JitManager *>(swr_screen(ctx->pipe.screen)->hJitMgr),
-      "GS");
+      reinterpret_cast<JitManager *>(screen->hJitMgr), "GS", &cached);
    PFN_GS_FUNC func = builder.CompileGS(ctx, key);
 
+   if (needs_caching)
+      swr_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
+   free(cached.data);
+
    ctx->gs->map.insert(std::make_pair(key, make_unique<VariantGS>(builder.gallivm, func)));
    return func;
 }
@@ -971,11 +1004,23 @@ swr_compile_vs(struct swr_context *ctx, swr_jit_vs_key &key)
    if (!ctx->vs->pipe.tokens)
       return NULL;
 
+   struct swr_screen *screen = swr_screen(ctx->pipe.screen);
+   struct lp_cached_code cached = { 0 };
+   unsigned char ir_sha1_cache_key[20];
+
+   swr_shader_sha1(&key, sizeof(key), ctx->vs->pipe.tokens,
+                   ir_sha1_cache_key);
+   swr_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
+   bool needs_caching = !cached.data_size;
+
    BuilderSWR builder(
-      reinterpret_cast<JitManager *>(swr_screen(ctx->pipe.screen)->hJitMgr),
-      "VS");
+      reinterpret_cast<JitManager *>(screen->hJitMgr), "VS", &cached);
    PFN_VERTEX_FUNC func = builder.CompileVS(ctx, key);
 
+   if (needs_caching)
+      swr_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
+   free(cached.data);
+
    ctx->vs->map.insert(std::make_pair(key, make_unique<VariantVS>(builder.gallivm, func)));
    return func;
 }
@@ -1421,11 +1466,23 @@ swr_compile_fs(struct swr_context *ctx, swr_jit_fs_key &key)
    if (!ctx->fs->pipe.tokens)
       return NULL;
 
+   struct swr_screen *screen = swr_screen(ctx->pipe.screen);
+   struct lp_cached_code cached = { 0 };
+   unsigned char ir_sha1_cache_key[20];
+
+   swr_shader_sha1(&key, sizeof(key), ctx->fs->pipe.tokens,
+                   ir_sha1_cache_key);
+   swr_disk_cache_find_shader(screen, &cached, ir_sha1_cache_key);
+   bool needs_caching = !cached.data_size;
+
    BuilderSWR builder(
-      reinterpret_cast<JitManager *>(swr_screen(ctx->pipe.screen)->hJitMgr),
-      "FS");
+      reinterpret_cast<JitManager *>(screen->hJitMgr), "FS", &cached);
    PFN_PIXEL_KERNEL func = builder.CompileFS(ctx, key);
 
+   if (needs_caching)
+      swr_disk_cache_insert_shader(screen, &cached, ir_sha1_cache_key);
+   free(cached.data);
+
    ctx->fs->map.insert(std::make_pair(key, make_unique<VariantFS>(builder.gallivm, func)));
    return func;
 }
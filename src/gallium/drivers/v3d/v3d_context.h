@@ -42,6 +42,7 @@
 
 struct v3d_job;
 struct v3d_bo;
+struct v3d_key;
 void v3d_job_add_bo(struct v3d_job *job, struct v3d_bo *bo);
 
 #include "v3d_bufmgr.h"
@@ -176,6 +177,10 @@ struct v3d_uncompiled_shader {
         uint16_t tf_specs[16];
         uint16_t tf_specs_psiz[16];
         uint32_t num_tf_specs;
+
+        /** SHA1 of the NIR, identifying the shader in the disk cache. */
+        unsigned char sha1[20];
+        bool has_sha1;
 };
 
 struct v3d_compiled_shader {
@@ -552,6 +557,16 @@ struct pipe_context *v3d_context_create(struct pipe_screen *pscreen,
                                         void *priv, unsigned flags);
 void v3d_program_init(struct pipe_context *pctx);
 void v3d_program_fini(struct pipe_context *pctx);
+void v3d_disk_cache_init(struct v3d_screen *screen);
+void v3d_disk_cache_hash_shader(struct v3d_uncompiled_shader *so);
+uint64_t *v3d_disk_cache_retrieve(struct v3d_context *v3d,
+                                  const struct v3d_key *key, size_t key_size,
+                                  struct v3d_compiled_shader *shader,
+                                  uint32_t *qpu_size);
+void v3d_disk_cache_store(struct v3d_context *v3d,
+                          const struct v3d_key *key, size_t key_size,
+                          const struct v3d_compiled_shader *shader,
+                          const uint64_t *qpu_insts, uint32_t qpu_size);
 void v3d_query_init(struct pipe_context *pctx);
 
 void v3d_simulator_init(struct v3d_screen *screen);
@@ -0,0 +1,251 @@
+/*
+ * Copyright © 2019 Broadcom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/**
+ * @file v3d_disk_cache.c
+ *
+ * Stores the compiled shader variants on disk, so that the same variants
+ * don't need to be compiled again the next time the application starts.
+ *
+ * A variant is looked up by the SHA1 of the NIR it was compiled from and by
+ * its compile key, and the cache entry holds its prog_data, uniform stream
+ * layout and QPU instructions.
+ */
+
+#include "compiler/blob.h"
+#include "compiler/nir/nir_serialize.h"
+#include "util/disk_cache.h"
+#include "util/mesa-sha1.h"
+#include "util/ralloc.h"
+
+#include "v3d_context.h"
+#include "compiler/v3d_compiler.h"
+
+/* V3D_DEBUG flags which change the generated code. */
+#define V3D_DEBUG_CODEGEN_FLAGS V3D_DEBUG_NO_TMU_PIPELINING
+
+void
+v3d_disk_cache_init(struct v3d_screen *screen)
+{
+        struct mesa_sha1 ctx;
+        unsigned char sha1[20];
+        char cache_id[20 * 2 + 1];
+
+        _mesa_sha1_init(&ctx);
+        if (!disk_cache_get_function_identifier(v3d_disk_cache_init, &ctx))
+                return;
+
+        _mesa_sha1_final(&ctx, sha1);
+        disk_cache_format_hex_id(cache_id, sha1, 20 * 2);
+
+        /* The device name carries the V3D version we compile for. */
+        screen->disk_cache =
+                disk_cache_create(screen->base.get_name(&screen->base),
+                                  cache_id,
+                                  V3D_DEBUG & V3D_DEBUG_CODEGEN_FLAGS);
+}
+
+/**
+ * Records the SHA1 of the (already lowered and optimized) NIR of a shader,
+ * which identifies it in the disk cache.
+ */
+void
+v3d_disk_cache_hash_shader(struct v3d_uncompiled_shader *so)
+{
+        struct blob blob;
+
+        blob_init(&blob);
+        nir_serialize(&blob, so->base.ir.nir, true);
+        if (!blob.out_of_memory)
+                _mesa_sha1_compute(blob.data, blob.size, so->sha1);
+        so->has_sha1 = !blob.out_of_memory;
+        blob_finish(&blob);
+}
+
+static bool
+v3d_disk_cache_compute_key(struct v3d_context *v3d,
+                           const struct v3d_key *key, size_t key_size,
+                           cache_key cache_key)
+{
+        struct disk_cache *cache = v3d->screen->disk_cache;
+        struct v3d_uncompiled_shader *so = key->shader_state;
+
+        /* The shader-db and dump options want to see the compile happen. */
+        if (!cache || !so->has_sha1 ||
+            (V3D_DEBUG & (V3D_DEBUG_SHADERDB | V3D_DEBUG_VIR |
+                          V3D_DEBUG_QPU | V3D_DEBUG_FS | V3D_DEBUG_VS |
+                          V3D_DEBUG_CS))) {
+                return false;
+        }
+
+        /* The shader_state pointer changes from run to run, and the NIR
+         * hash stands in for it.  The rest of the key is compared bytewise
+         * by the in-memory cache already, so it's stable.
+         */
+        struct v3d_key *ckey = malloc(key_size);
+        if (!ckey)
+                return false;
+        memcpy(ckey, key, key_size);
+        ckey->shader_state = NULL;
+
+        struct blob blob;
+        blob_init(&blob);
+        blob_write_bytes(&blob, so->sha1, sizeof(so->sha1));
+        blob_write_bytes(&blob, ckey, key_size);
+        free(ckey);
+
+        bool ok = !blob.out_of_memory;
+        if (ok)
+                disk_cache_compute_key(cache, blob.data, blob.size, cache_key);
+        blob_finish(&blob);
+
+        return ok;
+}
+
+static size_t
+v3d_prog_data_size(gl_shader_stage stage)
+{
+        switch (stage) {
+        case MESA_SHADER_VERTEX:
+                return sizeof(struct v3d_vs_prog_data);
+        case MESA_SHADER_FRAGMENT:
+                return sizeof(struct v3d_fs_prog_data);
+        case MESA_SHADER_COMPUTE:
+                return sizeof(struct v3d_compute_prog_data);
+        default:
+                unreachable("unsupported shader stage");
+        }
+}
+
+/**
+ * Looks up the compiled variant for \p key in the disk cache.
+ *
+ * On a hit, fills in the prog_data of \p shader and returns the QPU
+ * instructions (to be freed by the caller) and their size.  Returns NULL on
+ * a miss.
+ */
+uint64_t *
+v3d_disk_cache_retrieve(struct v3d_context *v3d,
+                        const struct v3d_key *key, size_t key_size,
+                        struct v3d_compiled_shader *shader,
+                        uint32_t *qpu_size)
+{
+        struct v3d_uncompiled_shader *so = key->shader_state;
+        nir_shader *s = so->base.ir.nir;
+        gl_shader_stage stage = s->info.stage;
+        cache_key cache_key;
+
+        if (!v3d_disk_cache_compute_key(v3d, key, key_size, cache_key))
+                return NULL;
+
+        size_t buffer_size;
+        void *buffer = disk_cache_get(v3d->screen->disk_cache, cache_key,
+                                      &buffer_size);
+        if (!buffer)
+                return NULL;
+
+        struct blob_reader blob;
+        blob_reader_init(&blob, buffer, buffer_size);
+
+        size_t prog_data_size = v3d_prog_data_size(stage);
+        const void *prog_data = blob_read_bytes(&blob, prog_data_size);
+        uint32_t ulist_count = blob_read_uint32(&blob);
+        const void *contents =
+                blob_read_bytes(&blob, ulist_count *
+                                sizeof(enum quniform_contents));
+        const void *data =
+                blob_read_bytes(&blob, ulist_count * sizeof(uint32_t));
+        uint32_t size = blob_read_uint32(&blob);
+        const void *qpu_insts = blob_read_bytes(&blob, size);
+
+        if (blob.overrun || blob.current != blob.end) {
+                free(buffer);
+                return NULL;
+        }
+
+        struct v3d_prog_data *pd = rzalloc_size(shader, prog_data_size);
+        memcpy(pd, prog_data, prog_data_size);
+
+        struct v3d_uniform_list *ulist = &pd->uniforms;
+        ulist->count = ulist_count;
+        ulist->contents = ralloc_array(pd, enum quniform_contents,
+                                       ulist_count);
+        memcpy(ulist->contents, contents,
+               ulist_count * sizeof(enum quniform_contents));
+        ulist->data = ralloc_array(pd, uint32_t, ulist_count);
+        memcpy(ulist->data, data, ulist_count * sizeof(uint32_t));
+
+        uint64_t *insts = malloc(size);
+        if (!insts) {
+                ralloc_free(pd);
+                free(buffer);
+                return NULL;
+        }
+        memcpy(insts, qpu_insts, size);
+
+        shader->prog_data.base = pd;
+        *qpu_size = size;
+
+        free(buffer);
+
+        return insts;
+}
+
+/**
+ * Stores a freshly compiled variant in the disk cache.
+ */
+void
+v3d_disk_cache_store(struct v3d_context *v3d,
+                     const struct v3d_key *key, size_t key_size,
+                     const struct v3d_compiled_shader *shader,
+                     const uint64_t *qpu_insts, uint32_t qpu_size)
+{
+        struct v3d_uncompiled_shader *so = key->shader_state;
+        nir_shader *s = so->base.ir.nir;
+        gl_shader_stage stage = s->info.stage;
+        const struct v3d_uniform_list *ulist =
+                &shader->prog_data.base->uniforms;
+        cache_key cache_key;
+
+        if (!v3d_disk_cache_compute_key(v3d, key, key_size, cache_key))
+                return;
+
+        struct blob blob;
+        blob_init(&blob);
+
+        blob_write_bytes(&blob, shader->prog_data.base,
+                         v3d_prog_data_size(stage));
+        blob_write_uint32(&blob, ulist->count);
+        blob_write_bytes(&blob, ulist->contents,
+                         ulist->count * sizeof(enum quniform_contents));
+        blob_write_bytes(&blob, ulist->data, ulist->count * sizeof(uint32_t));
+        blob_write_uint32(&blob, qpu_size);
+        blob_write_bytes(&blob, qpu_insts, qpu_size);
+
+        if (!blob.out_of_memory) {
+                disk_cache_put(v3d->screen->disk_cache, cache_key,
+                               blob.data, blob.size, NULL);
+        }
+
+        blob_finish(&blob);
+}
@@ -290,6 +290,9 @@ v3d_uncompiled_shader_create(struct pipe_context *pctx,
         so->base.type = PIPE_SHADER_IR_NIR;
         so->base.ir.nir = s;
 
+        if (v3d->screen->disk_cache)
+                v3d_disk_cache_hash_shader(so);
+
         if (V3D_DEBUG & (V3D_DEBUG_NIR |
                          v3d_debug_flag_for_shader_stage(s->info.stage))) {
                 fprintf(stderr, "%s prog %d NIR:\n",
@@ -351,12 +354,25 @@ v3d_get_compiled_shader(struct v3d_context *v3d,
         uint64_t *qpu_insts;
         uint32_t shader_size;
 
-        qpu_insts = v3d_compile(v3d->screen->compiler, key,
-                                &shader->prog_data.base, s,
-                                v3d_shader_debug_output,
-                                v3d,
-                                program_id, variant_id, &shader_size);
-        ralloc_steal(shader, shader->prog_data.base);
+        qpu_insts = v3d_disk_cache_retrieve(v3d, key, key_size, shader,
+                                            &shader_size);
+        if (!qpu_insts) {
+                int64_t begin = u_compile_stats_begin();
+
+                qpu_insts = v3d_compile(v3d->screen->compiler, key,
+                                        &shader->prog_data.base, s,
+                                        v3d_shader_debug_output,
+                                        v3d,
+                                        program_id, variant_id,
+                                        &shader_size);
+                u_compile_stats_end(&v3d->screen->compile_stats, begin);
+                ralloc_steal(shader, shader->prog_data.base);
+
+                if (shader_size) {
+                        v3d_disk_cache_store(v3d, key, key_size, shader,
+                                             qpu_insts, shader_size);
+                }
+        }
 
         v3d_set_shader_uniform_dirty_flags(shader);
 
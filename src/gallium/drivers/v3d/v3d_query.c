@@ -41,7 +41,7 @@ struct v3d_query
         enum pipe_query_type type;
         struct v3d_bo *bo;
 
-        uint32_t start, end;
+        uint64_t start, end;
 };
 
 static struct pipe_query *
@@ -70,6 +70,12 @@ v3d_begin_query(struct pipe_context *pctx, struct pipe_query *query)
         struct v3d_context *v3d = v3d_context(pctx);
         struct v3d_query *q = (struct v3d_query *)query;
 
+        if (u_compile_stats_is_query(q->type)) {
+                q->start = u_compile_stats_read(&v3d->screen->compile_stats,
+                                                q->type);
+                return true;
+        }
+
         switch (q->type) {
         case PIPE_QUERY_PRIMITIVES_GENERATED:
                 q->start = v3d->prims_generated;
@@ -96,6 +102,12 @@ v3d_end_query(struct pipe_context *pctx, struct pipe_query *query)
         struct v3d_context *v3d = v3d_context(pctx);
         struct v3d_query *q = (struct v3d_query *)query;
 
+        if (u_compile_stats_is_query(q->type)) {
+                q->end = u_compile_stats_read(&v3d->screen->compile_stats,
+                                              q->type);
+                return true;
+        }
+
         switch (q->type) {
         case PIPE_QUERY_PRIMITIVES_GENERATED:
                 q->end = v3d->prims_generated;
@@ -119,6 +131,12 @@ v3d_get_query_result(struct pipe_context *pctx, struct pipe_query *query,
         struct v3d_query *q = (struct v3d_query *)query;
         uint32_t result = 0;
 
+        if (u_compile_stats_is_query(q->type)) {
+                vresult->u64 = u_compile_stats_result(q->type, q->start,
+                                                      q->end);
+                return true;
+        }
+
         if (q->bo) {
                 /* XXX: Only flush the jobs using this BO. */
                 v3d_flush(pctx);
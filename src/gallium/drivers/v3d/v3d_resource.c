@@ -129,7 +129,8 @@ v3d_resource_transfer_unmap(struct pipe_context *pctx,
                                         v3d_layer_offset(&rsc->base,
                                                          ptrans->level,
                                                          ptrans->box.z + z);
-                                v3d_store_tiled_image(dst,
+                                v3d_store_tiled_image(&v3d->screen->tiling_queue,
+                                                      dst,
                                                       slice->stride,
                                                       (trans->map +
                                                        ptrans->stride *
@@ -279,7 +280,8 @@ v3d_resource_transfer_map(struct pipe_context *pctx,
                                         v3d_layer_offset(&rsc->base,
                                                          ptrans->level,
                                                          ptrans->box.z + z);
-                                v3d_load_tiled_image((trans->map +
+                                v3d_load_tiled_image(&v3d->screen->tiling_queue,
+                                                     (trans->map +
                                                       ptrans->stride *
                                                       ptrans->box.height * z),
                                                      ptrans->stride,
@@ -340,7 +342,8 @@ v3d_texture_subdata(struct pipe_context *pctx,
                 buf = v3d_bo_map(rsc->bo);
 
         for (int i = 0; i < box->depth; i++) {
-                v3d_store_tiled_image(buf +
+                v3d_store_tiled_image(&v3d_screen(prsc->screen)->tiling_queue,
+                                      buf +
                                       v3d_layer_offset(&rsc->base,
                                                        level,
                                                        box->z + i),
@@ -29,12 +29,14 @@
 #include "pipe/p_screen.h"
 #include "pipe/p_state.h"
 
+#include "util/u_cpu_detect.h"
 #include "util/u_debug.h"
 #include "util/u_memory.h"
 #include "util/u_format.h"
 #include "util/u_hash_table.h"
 #include "util/u_screen.h"
 #include "util/u_transfer_helper.h"
+#include "util/disk_cache.h"
 #include "util/ralloc.h"
 
 #include <xf86drm.h>
@@ -73,12 +75,16 @@ v3d_screen_destroy(struct pipe_screen *pscreen)
         util_hash_table_destroy(screen->bo_handles);
         v3d_bufmgr_destroy(pscreen);
         slab_destroy_parent(&screen->transfer_pool);
-        free(screen->ro);
+        if (util_queue_is_initialized(&screen->tiling_queue))
+                util_queue_destroy(&screen->tiling_queue);
+        if (screen->ro)
+                renderonly_destroy(screen->ro);
 
         if (using_v3d_simulator)
                 v3d_simulator_destroy(screen);
 
         v3d_compiler_free(screen->compiler);
+        disk_cache_destroy(screen->disk_cache);
         u_transfer_helper_destroy(pscreen->transfer_helper);
 
         close(screen->fd);
@@ -660,6 +666,37 @@ v3d_screen_query_dmabuf_modifiers(struct pipe_screen *pscreen,
        }
 }
 
+static int
+v3d_screen_get_driver_query_info(struct pipe_screen *pscreen, unsigned index,
+                                 struct pipe_driver_query_info *info)
+{
+        if (!info)
+                return U_COMPILE_STATS_NUM_QUERIES;
+
+        if (index >= U_COMPILE_STATS_NUM_QUERIES)
+                return 0;
+
+        u_compile_stats_query_info(index, 0, info);
+        return 1;
+}
+
+static int
+v3d_screen_get_driver_query_group_info(struct pipe_screen *pscreen,
+                                       unsigned index,
+                                       struct pipe_driver_query_group_info *info)
+{
+        if (!info)
+                return 1;
+
+        if (index >= 1)
+                return 0;
+
+        info->name = "Shader compiler";
+        info->max_active_queries = U_COMPILE_STATS_NUM_QUERIES;
+        info->num_queries = U_COMPILE_STATS_NUM_QUERIES;
+        return 1;
+}
+
 struct pipe_screen *
 v3d_screen_create(int fd, struct renderonly *ro)
 {
@@ -698,6 +735,15 @@ v3d_screen_create(int fd, struct renderonly *ro)
 
         slab_create_parent(&screen->transfer_pool, sizeof(struct v3d_transfer), 16);
 
+        /* The calling thread takes part in the tiling, so it only needs
+         * help from the other cores.
+         */
+        util_cpu_detect();
+        if (util_cpu_caps.nr_cpus > 1) {
+                util_queue_init(&screen->tiling_queue, "v3d_tiling", 16,
+                                MIN2(util_cpu_caps.nr_cpus - 1, 3), 0);
+        }
+
         screen->has_csd = false; /* until the UABI is enabled. */
 
         v3d_fence_init(screen);
@@ -713,6 +759,12 @@ v3d_screen_create(int fd, struct renderonly *ro)
         pscreen->get_device_vendor = v3d_screen_get_vendor;
         pscreen->get_compiler_options = v3d_screen_get_compiler_options;
         pscreen->query_dmabuf_modifiers = v3d_screen_query_dmabuf_modifiers;
+        pscreen->get_driver_query_info = v3d_screen_get_driver_query_info;
+        pscreen->get_driver_query_group_info =
+                v3d_screen_get_driver_query_group_info;
+
+        v3d_disk_cache_init(screen);
+        screen->compile_stats.disk_cache = screen->disk_cache;
 
         return pscreen;
 
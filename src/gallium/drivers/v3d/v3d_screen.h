@@ -30,6 +30,8 @@
 #include "state_tracker/drm_driver.h"
 #include "util/list.h"
 #include "util/slab.h"
+#include "util/u_queue.h"
+#include "util/u_compile_stats.h"
 #include "broadcom/common/v3d_debug.h"
 #include "broadcom/common/v3d_device_info.h"
 
@@ -59,6 +61,9 @@ struct v3d_screen {
 
         struct slab_parent_pool transfer_pool;
 
+        /** Threads helping with tiling/untiling of large transfers. */
+        struct util_queue tiling_queue;
+
         struct v3d_bo_cache {
                 /** List of struct v3d_bo freed, by age. */
                 struct list_head time_list;
@@ -70,6 +75,8 @@ struct v3d_screen {
         } bo_cache;
 
         const struct v3d_compiler *compiler;
+        struct disk_cache *disk_cache;
+        struct u_compile_stats compile_stats;
 
         struct util_hash_table *bo_handles;
         mtx_t bo_handles_mutex;
@@ -28,6 +28,7 @@
  */
 
 #include <stdint.h>
+#include "util/u_queue.h"
 #include "v3d_screen.h"
 #include "v3d_context.h"
 #include "v3d_tiling.h"
@@ -453,24 +454,135 @@ v3d_move_tiled_image(void *gpu, uint32_t gpu_stride,
         }
 }
 
+/* Boxes smaller than this are not worth splitting across threads. */
+#define V3D_TILING_THREADED_MIN_SIZE (512 * 1024)
+#define V3D_TILING_MAX_BANDS 4
+
+struct v3d_tiling_band {
+        void *gpu;
+        uint32_t gpu_stride;
+        void *cpu;
+        uint32_t cpu_stride;
+        enum v3d_tiling_mode tiling_format;
+        int cpp;
+        uint32_t image_h;
+        struct pipe_box box;
+        bool is_load;
+        struct util_queue_fence fence;
+};
+
+static void
+v3d_tiling_band_execute(void *data, int thread_index)
+{
+        struct v3d_tiling_band *band = data;
+
+        v3d_move_tiled_image(band->gpu, band->gpu_stride,
+                             band->cpu, band->cpu_stride,
+                             band->tiling_format,
+                             band->cpp,
+                             band->image_h,
+                             &band->box,
+                             band->is_load);
+}
+
+/* Splits large boxes into bands of rows which are moved in parallel by the
+ * tiling queue and the calling thread.  Every pixel has its own address in
+ * the tiled image, so the bands never touch the same bytes.
+ */
+static void
+v3d_move_tiled_image_threaded(struct util_queue *queue,
+                              void *gpu, uint32_t gpu_stride,
+                              void *cpu, uint32_t cpu_stride,
+                              enum v3d_tiling_mode tiling_format,
+                              int cpp,
+                              uint32_t image_h,
+                              const struct pipe_box *box,
+                              bool is_load)
+{
+        /* Keep the band boundaries on UIF block rows, so that only the
+         * edges of the box go through the unaligned path.
+         */
+        uint32_t band_align = v3d_utile_height(cpp) * 2;
+        uint32_t num_bands = 1;
+
+        if (queue && util_queue_is_initialized(queue) &&
+            box->width * box->height * cpp >= V3D_TILING_THREADED_MIN_SIZE) {
+                num_bands = MIN2(queue->num_threads + 1,
+                                 V3D_TILING_MAX_BANDS);
+        }
+
+        uint32_t band_h = align(DIV_ROUND_UP(box->height, num_bands),
+                                band_align);
+        if (num_bands == 1 || band_h >= box->height) {
+                v3d_move_tiled_image(gpu, gpu_stride, cpu, cpu_stride,
+                                     tiling_format, cpp, image_h, box,
+                                     is_load);
+                return;
+        }
+
+        struct v3d_tiling_band bands[V3D_TILING_MAX_BANDS];
+        uint32_t y1 = box->y;
+        uint32_t y2 = box->y + box->height;
+        uint32_t n = 0;
+
+        for (uint32_t y = y1; y < y2; n++) {
+                uint32_t band_y2 = MIN2(align(y + 1, band_h), y2);
+                struct v3d_tiling_band *band = &bands[n];
+
+                /* The last band takes the remainder. */
+                if (n == num_bands - 1)
+                        band_y2 = y2;
+
+                band->gpu = gpu;
+                band->gpu_stride = gpu_stride;
+                band->cpu = cpu + (y - y1) * cpu_stride;
+                band->cpu_stride = cpu_stride;
+                band->tiling_format = tiling_format;
+                band->cpp = cpp;
+                band->image_h = image_h;
+                band->box = *box;
+                band->box.y = y;
+                band->box.height = band_y2 - y;
+                band->is_load = is_load;
+
+                y = band_y2;
+        }
+
+        /* Queue all but the first band, which we move ourselves. */
+        for (uint32_t i = 1; i < n; i++) {
+                util_queue_fence_init(&bands[i].fence);
+                util_queue_add_job(queue, &bands[i], &bands[i].fence,
+                                   v3d_tiling_band_execute, NULL);
+        }
+
+        v3d_tiling_band_execute(&bands[0], 0);
+
+        for (uint32_t i = 1; i < n; i++) {
+                util_queue_fence_wait(&bands[i].fence);
+                util_queue_fence_destroy(&bands[i].fence);
+        }
+}
+
 /**
  * Loads pixel data from the start (microtile-aligned) box in \p src to the
  * start of \p dst according to the given tiling format.
  */
 void
-v3d_load_tiled_image(void *dst, uint32_t dst_stride,
+v3d_load_tiled_image(struct util_queue *queue,
+                     void *dst, uint32_t dst_stride,
                      void *src, uint32_t src_stride,
                      enum v3d_tiling_mode tiling_format, int cpp,
                      uint32_t image_h,
                      const struct pipe_box *box)
 {
-        v3d_move_tiled_image(src, src_stride,
-                             dst, dst_stride,
-                             tiling_format,
-                             cpp,
-                             image_h,
-                             box,
-                             true);
+        v3d_move_tiled_image_threaded(queue,
+                                      src, src_stride,
+                                      dst, dst_stride,
+                                      tiling_format,
+                                      cpp,
+                                      image_h,
+                                      box,
+                                      true);
 }
 
 /**
@@ -478,17 +590,19 @@ v3d_load_tiled_image(void *dst, uint32_t dst_stride,
  * \p dst according to the given tiling format.
  */
 void
-v3d_store_tiled_image(void *dst, uint32_t dst_stride,
+v3d_store_tiled_image(struct util_queue *queue,
+                      void *dst, uint32_t dst_stride,
                       void *src, uint32_t src_stride,
                       enum v3d_tiling_mode tiling_format, int cpp,
                       uint32_t image_h,
                       const struct pipe_box *box)
 {
-        v3d_move_tiled_image(dst, dst_stride,
-                             src, src_stride,
-                             tiling_format,
-                             cpp,
-                             image_h,
-                             box,
-                             false);
+        v3d_move_tiled_image_threaded(queue,
+                                      dst, dst_stride,
+                                      src, src_stride,
+                                      tiling_format,
+                                      cpp,
+                                      image_h,
+                                      box,
+                                      false);
 }
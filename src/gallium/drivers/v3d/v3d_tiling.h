@@ -24,15 +24,19 @@
 #ifndef VC5_TILING_H
 #define VC5_TILING_H
 
+struct util_queue;
+
 uint32_t v3d_utile_width(int cpp) ATTRIBUTE_CONST;
 uint32_t v3d_utile_height(int cpp) ATTRIBUTE_CONST;
 bool v3d_size_is_lt(uint32_t width, uint32_t height, int cpp) ATTRIBUTE_CONST;
-void v3d_load_tiled_image(void *dst, uint32_t dst_stride,
+void v3d_load_tiled_image(struct util_queue *queue,
+                          void *dst, uint32_t dst_stride,
                           void *src, uint32_t src_stride,
                           enum v3d_tiling_mode tiling_format, int cpp,
                           uint32_t image_h,
                           const struct pipe_box *box);
-void v3d_store_tiled_image(void *dst, uint32_t dst_stride,
+void v3d_store_tiled_image(struct util_queue *queue,
+                           void *dst, uint32_t dst_stride,
                            void *src, uint32_t src_stride,
                            enum v3d_tiling_mode tiling_format, int cpp,
                            uint32_t image_h,
@@ -119,6 +119,10 @@ struct vc4_uncompiled_shader {
         /** How many variants of this program were compiled, for shader-db. */
         uint32_t compiled_variant_count;
         struct pipe_shader_state base;
+
+        /** SHA1 of the NIR, identifying the shader in the disk cache. */
+        unsigned char sha1[20];
+        bool has_sha1;
 };
 
 struct vc4_fs_inputs {
@@ -463,6 +467,18 @@ struct pipe_context *vc4_context_create(struct pipe_screen *pscreen,
 void vc4_draw_init(struct pipe_context *pctx);
 void vc4_state_init(struct pipe_context *pctx);
 void vc4_program_init(struct pipe_context *pctx);
+void vc4_set_compiled_fs_inputs(struct vc4_context *vc4,
+                                struct vc4_compiled_shader *shader,
+                                struct vc4_fs_inputs *inputs);
+void vc4_disk_cache_init(struct vc4_screen *screen);
+void vc4_disk_cache_hash_shader(struct vc4_uncompiled_shader *so);
+struct vc4_compiled_shader *
+vc4_disk_cache_retrieve(struct vc4_context *vc4, enum qstage stage,
+                        const struct vc4_key *key, uint32_t key_size);
+void vc4_disk_cache_store(struct vc4_context *vc4, enum qstage stage,
+                          const struct vc4_key *key, uint32_t key_size,
+                          const struct vc4_compiled_shader *shader,
+                          const uint64_t *qpu_insts, uint32_t qpu_size);
 void vc4_program_fini(struct pipe_context *pctx);
 void vc4_query_init(struct pipe_context *pctx);
 void vc4_simulator_init(struct vc4_screen *screen);
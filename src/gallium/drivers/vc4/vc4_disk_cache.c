@@ -0,0 +1,285 @@
+/*
+ * Copyright © 2019 Broadcom
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/**
+ * @file vc4_disk_cache.c
+ *
+ * Stores the compiled shader variants on disk, so that the same variants
+ * don't need to be compiled again the next time the application starts.
+ *
+ * A variant is looked up by the SHA1 of the NIR it was compiled from and by
+ * its compile key, and the cache entry holds the QPU instructions along with
+ * everything vc4_get_compiled_shader() would have set up from the compile.
+ * The code still goes through the kernel's shader validation when it's
+ * loaded.
+ */
+
+#include "compiler/blob.h"
+#include "compiler/nir/nir_serialize.h"
+#include "util/disk_cache.h"
+#include "util/mesa-sha1.h"
+#include "util/ralloc.h"
+
+#include "vc4_context.h"
+#include "vc4_qir.h"
+
+/* Screen features which change the generated code. */
+#define VC4_CACHE_FLAG_CONTROL_FLOW (1 << 0)
+#define VC4_CACHE_FLAG_THREADED_FS  (1 << 1)
+
+void
+vc4_disk_cache_init(struct vc4_screen *screen)
+{
+        struct mesa_sha1 ctx;
+        unsigned char sha1[20];
+        char cache_id[20 * 2 + 1];
+        uint64_t driver_flags = 0;
+
+        _mesa_sha1_init(&ctx);
+        if (!disk_cache_get_function_identifier(vc4_disk_cache_init, &ctx))
+                return;
+
+        _mesa_sha1_final(&ctx, sha1);
+        disk_cache_format_hex_id(cache_id, sha1, 20 * 2);
+
+        if (screen->has_control_flow)
+                driver_flags |= VC4_CACHE_FLAG_CONTROL_FLOW;
+        if (screen->has_threaded_fs)
+                driver_flags |= VC4_CACHE_FLAG_THREADED_FS;
+
+        screen->disk_cache =
+                disk_cache_create(screen->base.get_name(&screen->base),
+                                  cache_id, driver_flags);
+}
+
+/**
+ * Records the SHA1 of the (already lowered and optimized) NIR of a shader,
+ * which identifies it in the disk cache.
+ */
+void
+vc4_disk_cache_hash_shader(struct vc4_uncompiled_shader *so)
+{
+        struct blob blob;
+
+        blob_init(&blob);
+        nir_serialize(&blob, so->base.ir.nir, true);
+        if (!blob.out_of_memory)
+                _mesa_sha1_compute(blob.data, blob.size, so->sha1);
+        so->has_sha1 = !blob.out_of_memory;
+        blob_finish(&blob);
+}
+
+static bool
+vc4_disk_cache_compute_key(struct vc4_context *vc4, enum qstage stage,
+                           const struct vc4_key *key, uint32_t key_size,
+                           cache_key cache_key)
+{
+        struct disk_cache *cache = vc4->screen->disk_cache;
+        struct vc4_uncompiled_shader *so = key->shader_state;
+
+        /* The shader-db and dump options want to see the compile happen. */
+        if (!cache || !so->has_sha1 ||
+            (vc4_debug & (VC4_DEBUG_SHADERDB | VC4_DEBUG_QIR |
+                          VC4_DEBUG_QPU))) {
+                return false;
+        }
+
+        /* The pointers in the key change from run to run: the NIR hash
+         * stands in for the shader_state, and the VS key's FS inputs are
+         * hashed by value.  The rest of the key is compared bytewise by the
+         * in-memory cache already, so it's stable.
+         */
+        void *ckey = malloc(key_size);
+        if (!ckey)
+                return false;
+        memcpy(ckey, key, key_size);
+        ((struct vc4_key *)ckey)->shader_state = NULL;
+
+        struct blob blob;
+        blob_init(&blob);
+        blob_write_bytes(&blob, so->sha1, sizeof(so->sha1));
+
+        if (stage == QSTAGE_VERT) {
+                struct vc4_vs_key *vs_key = ckey;
+                const struct vc4_fs_inputs *fs_inputs = vs_key->fs_inputs;
+
+                /* Coordinate shaders have no FS inputs. */
+                blob_write_uint32(&blob, fs_inputs != NULL);
+                if (fs_inputs) {
+                        blob_write_uint32(&blob, fs_inputs->num_inputs);
+                        blob_write_bytes(&blob, fs_inputs->input_slots,
+                                         fs_inputs->num_inputs *
+                                         sizeof(*fs_inputs->input_slots));
+                }
+                vs_key->fs_inputs = NULL;
+        }
+
+        blob_write_bytes(&blob, ckey, key_size);
+        free(ckey);
+
+        bool ok = !blob.out_of_memory;
+        if (ok)
+                disk_cache_compute_key(cache, blob.data, blob.size, cache_key);
+        blob_finish(&blob);
+
+        return ok;
+}
+
+/**
+ * Looks up the compiled variant for \p key in the disk cache, returning NULL
+ * on a miss.
+ */
+struct vc4_compiled_shader *
+vc4_disk_cache_retrieve(struct vc4_context *vc4, enum qstage stage,
+                        const struct vc4_key *key, uint32_t key_size)
+{
+        cache_key cache_key;
+
+        if (!vc4_disk_cache_compute_key(vc4, stage, key, key_size,
+                                        cache_key))
+                return NULL;
+
+        size_t buffer_size;
+        void *buffer = disk_cache_get(vc4->screen->disk_cache, cache_key,
+                                      &buffer_size);
+        if (!buffer)
+                return NULL;
+
+        struct blob_reader blob;
+        blob_reader_init(&blob, buffer, buffer_size);
+
+        struct vc4_compiled_shader *shader =
+                rzalloc(NULL, struct vc4_compiled_shader);
+
+        shader->color_inputs = blob_read_uint32(&blob);
+        shader->disable_early_z = blob_read_uint32(&blob);
+        shader->fs_threaded = blob_read_uint32(&blob);
+        blob_copy_bytes(&blob, shader->vattr_offsets,
+                        sizeof(shader->vattr_offsets));
+        shader->vattrs_live = blob_read_uint32(&blob);
+        uint32_t num_inputs = blob_read_uint32(&blob);
+
+        const void *input_slots = NULL;
+        if (stage == QSTAGE_FRAG) {
+                input_slots = blob_read_bytes(&blob, num_inputs *
+                                              sizeof(struct vc4_varying_slot));
+        }
+
+        struct vc4_shader_uniform_info *uinfo = &shader->uniforms;
+        uinfo->count = blob_read_uint32(&blob);
+        uinfo->num_texture_samples = blob_read_uint32(&blob);
+        const void *contents =
+                blob_read_bytes(&blob, uinfo->count *
+                                sizeof(enum quniform_contents));
+        const void *data =
+                blob_read_bytes(&blob, uinfo->count * sizeof(uint32_t));
+
+        uint32_t qpu_size = blob_read_uint32(&blob);
+        const void *qpu_insts = blob_read_bytes(&blob, qpu_size);
+
+        if (blob.overrun || blob.current != blob.end) {
+                ralloc_free(shader);
+                free(buffer);
+                return NULL;
+        }
+
+        uinfo->contents = ralloc_array(shader, enum quniform_contents,
+                                       uinfo->count);
+        memcpy(uinfo->contents, contents,
+               uinfo->count * sizeof(enum quniform_contents));
+        uinfo->data = ralloc_array(shader, uint32_t, uinfo->count);
+        memcpy(uinfo->data, data, uinfo->count * sizeof(uint32_t));
+        vc4_set_shader_uniform_dirty_flags(shader);
+
+        if (stage == QSTAGE_FRAG) {
+                struct vc4_fs_inputs inputs = {
+                        .num_inputs = num_inputs,
+                };
+
+                inputs.input_slots = ralloc_array(shader,
+                                                  struct vc4_varying_slot,
+                                                  num_inputs);
+                memcpy(inputs.input_slots, input_slots,
+                       num_inputs * sizeof(struct vc4_varying_slot));
+                vc4_set_compiled_fs_inputs(vc4, shader, &inputs);
+        } else {
+                shader->num_inputs = num_inputs;
+        }
+
+        shader->program_id = vc4->next_compiled_program_id++;
+        shader->bo = vc4_bo_alloc_shader(vc4->screen, qpu_insts, qpu_size);
+
+        free(buffer);
+
+        return shader;
+}
+
+/**
+ * Stores a freshly compiled variant in the disk cache.
+ */
+void
+vc4_disk_cache_store(struct vc4_context *vc4, enum qstage stage,
+                     const struct vc4_key *key, uint32_t key_size,
+                     const struct vc4_compiled_shader *shader,
+                     const uint64_t *qpu_insts, uint32_t qpu_size)
+{
+        const struct vc4_shader_uniform_info *uinfo = &shader->uniforms;
+        cache_key cache_key;
+
+        if (!vc4_disk_cache_compute_key(vc4, stage, key, key_size,
+                                        cache_key))
+                return;
+
+        struct blob blob;
+        blob_init(&blob);
+
+        blob_write_uint32(&blob, shader->color_inputs);
+        blob_write_uint32(&blob, shader->disable_early_z);
+        blob_write_uint32(&blob, shader->fs_threaded);
+        blob_write_bytes(&blob, shader->vattr_offsets,
+                         sizeof(shader->vattr_offsets));
+        blob_write_uint32(&blob, shader->vattrs_live);
+        blob_write_uint32(&blob, shader->num_inputs);
+
+        if (stage == QSTAGE_FRAG) {
+                blob_write_bytes(&blob, shader->fs_inputs->input_slots,
+                                 shader->num_inputs *
+                                 sizeof(struct vc4_varying_slot));
+        }
+
+        blob_write_uint32(&blob, uinfo->count);
+        blob_write_uint32(&blob, uinfo->num_texture_samples);
+        blob_write_bytes(&blob, uinfo->contents,
+                         uinfo->count * sizeof(enum quniform_contents));
+        blob_write_bytes(&blob, uinfo->data, uinfo->count * sizeof(uint32_t));
+
+        blob_write_uint32(&blob, qpu_size);
+        blob_write_bytes(&blob, qpu_insts, qpu_size);
+
+        if (!blob.out_of_memory) {
+                disk_cache_put(vc4->screen->disk_cache, cache_key,
+                               blob.data, blob.size, NULL);
+        }
+
+        blob_finish(&blob);
+}
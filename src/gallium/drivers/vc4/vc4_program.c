@@ -2452,6 +2452,9 @@ vc4_shader_state_create(struct pipe_context *pctx,
         so->base.type = PIPE_SHADER_IR_NIR;
         so->base.ir.nir = s;
 
+        if (vc4->screen->disk_cache)
+                vc4_disk_cache_hash_shader(so);
+
         if (vc4_debug & VC4_DEBUG_NIR) {
                 fprintf(stderr, "%s prog %d NIR:\n",
                         gl_shader_stage_name(s->info.stage),
@@ -2523,7 +2526,20 @@ vc4_setup_compiled_fs_inputs(struct vc4_context *vc4, struct vc4_compile *c,
                 inputs.input_slots[inputs.num_inputs] = *slot;
                 inputs.num_inputs++;
         }
-        shader->num_inputs = inputs.num_inputs;
+
+        vc4_set_compiled_fs_inputs(vc4, shader, &inputs);
+}
+
+/**
+ * Sets the FS inputs of the shader, taking ownership of \p inputs'
+ * input_slots (which must be ralloced).
+ */
+void
+vc4_set_compiled_fs_inputs(struct vc4_context *vc4,
+                           struct vc4_compiled_shader *shader,
+                           struct vc4_fs_inputs *inputs)
+{
+        shader->num_inputs = inputs->num_inputs;
 
         /* Add our set of inputs to the set of all inputs seen.  This way, we
          * can have a single pointer that identifies an FS inputs set,
@@ -2531,16 +2547,16 @@ vc4_setup_compiled_fs_inputs(struct vc4_context *vc4, struct vc4_compile *c,
          * new one is bound using separate shader objects) but the inputs
          * don't change.
          */
-        struct set_entry *entry = _mesa_set_search(vc4->fs_inputs_set, &inputs);
+        struct set_entry *entry = _mesa_set_search(vc4->fs_inputs_set, inputs);
         if (entry) {
                 shader->fs_inputs = entry->key;
-                ralloc_free(inputs.input_slots);
+                ralloc_free(inputs->input_slots);
         } else {
                 struct vc4_fs_inputs *alloc_inputs;
 
                 alloc_inputs = rzalloc(vc4->fs_inputs_set, struct vc4_fs_inputs);
-                memcpy(alloc_inputs, &inputs, sizeof(inputs));
-                ralloc_steal(alloc_inputs, inputs.input_slots);
+                memcpy(alloc_inputs, inputs, sizeof(*inputs));
+                ralloc_steal(alloc_inputs, inputs->input_slots);
                 _mesa_set_add(vc4->fs_inputs_set, alloc_inputs);
 
                 shader->fs_inputs = alloc_inputs;
@@ -2548,27 +2564,12 @@ vc4_setup_compiled_fs_inputs(struct vc4_context *vc4, struct vc4_compile *c,
 }
 
 static struct vc4_compiled_shader *
-vc4_get_compiled_shader(struct vc4_context *vc4, enum qstage stage,
-                        struct vc4_key *key)
+vc4_compile_shader(struct vc4_context *vc4, enum qstage stage,
+                   struct vc4_key *key, uint32_t key_size)
 {
-        struct hash_table *ht;
-        uint32_t key_size;
-        bool try_threading;
-
-        if (stage == QSTAGE_FRAG) {
-                ht = vc4->fs_cache;
-                key_size = sizeof(struct vc4_fs_key);
-                try_threading = vc4->screen->has_threaded_fs;
-        } else {
-                ht = vc4->vs_cache;
-                key_size = sizeof(struct vc4_vs_key);
-                try_threading = false;
-        }
-
         struct vc4_compiled_shader *shader;
-        struct hash_entry *entry = _mesa_hash_table_search(ht, key);
-        if (entry)
-                return entry->data;
+        bool try_threading = (stage == QSTAGE_FRAG &&
+                              vc4->screen->has_threaded_fs);
 
         struct vc4_compile *c = vc4_shader_ntq(vc4, stage, key, try_threading);
         /* If the FS failed to compile threaded, fall back to single threaded. */
@@ -2612,6 +2613,12 @@ vc4_get_compiled_shader(struct vc4_context *vc4, enum qstage stage,
 
         shader->fs_threaded = c->fs_threaded;
 
+        if (!shader->failed) {
+                vc4_disk_cache_store(vc4, stage, key, key_size, shader,
+                                     c->qpu_insts,
+                                     c->qpu_inst_count * sizeof(uint64_t));
+        }
+
         if ((vc4_debug & VC4_DEBUG_SHADERDB) && stage == QSTAGE_FRAG) {
                 fprintf(stderr, "SHADER-DB: %s prog %d/%d: %d FS threads\n",
                         qir_get_stage_name(c->stage),
@@ -2621,6 +2628,33 @@ vc4_get_compiled_shader(struct vc4_context *vc4, enum qstage stage,
 
         qir_compile_destroy(c);
 
+        return shader;
+}
+
+static struct vc4_compiled_shader *
+vc4_get_compiled_shader(struct vc4_context *vc4, enum qstage stage,
+                        struct vc4_key *key)
+{
+        struct hash_table *ht;
+        uint32_t key_size;
+
+        if (stage == QSTAGE_FRAG) {
+                ht = vc4->fs_cache;
+                key_size = sizeof(struct vc4_fs_key);
+        } else {
+                ht = vc4->vs_cache;
+                key_size = sizeof(struct vc4_vs_key);
+        }
+
+        struct vc4_compiled_shader *shader;
+        struct hash_entry *entry = _mesa_hash_table_search(ht, key);
+        if (entry)
+                return entry->data;
+
+        shader = vc4_disk_cache_retrieve(vc4, stage, key, key_size);
+        if (!shader)
+                shader = vc4_compile_shader(vc4, stage, key, key_size);
+
         struct vc4_key *dup_key;
         dup_key = rzalloc_size(shader, key_size); /* TODO: don't use rzalloc */
         memcpy(dup_key, key, key_size);
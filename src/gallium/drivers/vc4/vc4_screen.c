@@ -34,6 +34,7 @@
 #include "util/u_hash_table.h"
 #include "util/u_screen.h"
 #include "util/u_transfer_helper.h"
+#include "util/disk_cache.h"
 #include "util/ralloc.h"
 
 #include <xf86drm.h>
@@ -105,13 +106,15 @@ vc4_screen_destroy(struct pipe_screen *pscreen)
         util_hash_table_destroy(screen->bo_handles);
         vc4_bufmgr_destroy(pscreen);
         slab_destroy_parent(&screen->transfer_pool);
-        free(screen->ro);
+        if (screen->ro)
+                renderonly_destroy(screen->ro);
 
 #ifdef USE_VC4_SIMULATOR
         vc4_simulator_destroy(screen);
 #endif
 
         u_transfer_helper_destroy(pscreen->transfer_helper);
+        disk_cache_destroy(screen->disk_cache);
 
         close(screen->fd);
         ralloc_free(pscreen);
@@ -572,6 +575,8 @@ vc4_screen_create(int fd, struct renderonly *ro)
                 pscreen->get_driver_query_info = vc4_get_driver_query_info;
         }
 
+        vc4_disk_cache_init(screen);
+
         return pscreen;
 
 fail:
@@ -100,6 +100,8 @@ struct vc4_screen {
         bool has_perfmon_ioctl;
         bool has_syncobj;
 
+        struct disk_cache *disk_cache;
+
         struct vc4_simulator_file *sim_file;
 };
 
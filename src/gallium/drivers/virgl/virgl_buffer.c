@@ -27,6 +27,93 @@
 #include "virgl_resource.h"
 #include "virgl_screen.h"
 
+/*
+ * Whether the buffer is only bound in ways which pick up a new host resource
+ * on their own: vertex buffers are re-emitted when the vertex array is
+ * dirty, and index buffers are set on every draw.  Views, stream output
+ * targets and shader bindings keep the resource handle on the host, so
+ * constant and shader buffers only qualify while they aren't bound.
+ */
+static bool virgl_buffer_can_realloc(struct virgl_context *vctx,
+                                     struct virgl_resource *vbuf)
+{
+   const unsigned rebindable = PIPE_BIND_VERTEX_BUFFER |
+                               PIPE_BIND_INDEX_BUFFER |
+                               PIPE_BIND_CONSTANT_BUFFER |
+                               PIPE_BIND_SHADER_BUFFER;
+   struct pipe_resource *res = &vbuf->u.b;
+   struct virgl_transfer whole = { 0 };
+
+   if (res->bind & ~rebindable)
+      return false;
+
+   for (unsigned s = 0; s < PIPE_SHADER_TYPES; s++) {
+      for (unsigned i = 0; i < PIPE_MAX_CONSTANT_BUFFERS; i++) {
+         if (vctx->ubos[s][i] == res)
+            return false;
+      }
+      for (unsigned i = 0; i < PIPE_MAX_SHADER_BUFFERS; i++) {
+         if (vctx->ssbos[s][i] == res)
+            return false;
+      }
+   }
+
+   for (unsigned i = 0; i < PIPE_MAX_HW_ATOMIC_BUFFERS; i++) {
+      if (vctx->atomic_buffers[i] == res)
+         return false;
+   }
+
+   /* Pending transfers are written to the host resource at flush time,
+    * and must still go to the old one.
+    */
+   whole.base.resource = res;
+   u_box_1d(0, res->width0, &whole.base.box);
+   if (virgl_transfer_queue_is_queued(&vctx->queue, &whole))
+      return false;
+
+   return true;
+}
+
+/*
+ * Replaces the host resource of a busy buffer whose contents are discarded,
+ * so that mapping it doesn't have to flush and wait for the host.  This is
+ * what keeps streaming (ring) buffers mapped with invalidation fast.  The
+ * command buffers using the old resource hold their own references to it.
+ */
+static bool virgl_buffer_realloc(struct virgl_context *vctx,
+                                 struct virgl_resource *vbuf)
+{
+   struct virgl_screen *vs = virgl_screen(vctx->base.screen);
+   const struct pipe_resource *templ = &vbuf->u.b;
+   struct virgl_hw_res *hw_res;
+
+   hw_res = vs->vws->resource_create(vs->vws, templ->target,
+                                     templ->format,
+                                     pipe_to_virgl_bind(vs, templ->bind),
+                                     templ->width0,
+                                     templ->height0,
+                                     templ->depth0,
+                                     templ->array_size,
+                                     templ->last_level,
+                                     templ->nr_samples,
+                                     vbuf->metadata.total_size);
+   if (!hw_res)
+      return false;
+
+   vs->vws->resource_unref(vs->vws, vbuf->hw_res);
+   vbuf->hw_res = hw_res;
+   vbuf->clean_mask = (1 << VR_MAX_TEXTURE_2D_LEVELS) - 1;
+
+   for (unsigned i = 0; i < vctx->num_vertex_buffers; i++) {
+      if (vctx->vertex_buffer[i].buffer.resource == templ) {
+         vctx->vertex_array_dirty = TRUE;
+         break;
+      }
+   }
+
+   return true;
+}
+
 static void *virgl_buffer_transfer_map(struct pipe_context *ctx,
                                        struct pipe_resource *resource,
                                        unsigned level,
@@ -48,6 +135,11 @@ static void *virgl_buffer_transfer_map(struct pipe_context *ctx,
    else
       flush = virgl_res_needs_flush(vctx, trans);
 
+   if (flush && (usage & PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE) &&
+       virgl_buffer_can_realloc(vctx, vbuf) &&
+       virgl_buffer_realloc(vctx, vbuf))
+      flush = false;
+
    if (flush)
       ctx->flush(ctx, NULL, 0);
 
@@ -37,6 +37,7 @@
 #include "util/slab.h"
 #include "util/u_upload_mgr.h"
 #include "util/u_blitter.h"
+#include "util/hash_table.h"
 #include "tgsi/tgsi_text.h"
 #include "indices/u_primconvert.h"
 
@@ -272,96 +273,174 @@ static void virgl_surface_destroy(struct pipe_context *ctx,
    FREE(surf);
 }
 
+/* A blend, DSA or rasterizer state. States with the same contents share
+ * one host object.
+ */
+struct virgl_cso {
+   uint32_t handle;
+   unsigned refcount;
+   enum virgl_object_type type;
+   unsigned size;
+   union {
+      struct pipe_blend_state blend;
+      struct pipe_depth_stencil_alpha_state dsa;
+      struct pipe_rasterizer_state rs;
+   } state;
+};
+
+static uint32_t virgl_cso_hash(const void *key)
+{
+   const struct virgl_cso *cso = key;
+   return _mesa_hash_data(&cso->state, cso->size) ^ cso->type;
+}
+
+static bool virgl_cso_equal(const void *a, const void *b)
+{
+   const struct virgl_cso *cso_a = a;
+   const struct virgl_cso *cso_b = b;
+
+   return cso_a->type == cso_b->type &&
+          memcmp(&cso_a->state, &cso_b->state, cso_a->size) == 0;
+}
+
+static struct virgl_cso *virgl_cso_create(struct virgl_context *vctx,
+                                          enum virgl_object_type type,
+                                          const void *state, unsigned size)
+{
+   struct virgl_cso key, *cso;
+   struct hash_entry *entry;
+
+   key.type = type;
+   key.size = size;
+   memcpy(&key.state, state, size);
+
+   entry = _mesa_hash_table_search(vctx->cso_cache, &key);
+   if (entry) {
+      cso = entry->data;
+      cso->refcount++;
+      return cso;
+   }
+
+   cso = CALLOC_STRUCT(virgl_cso);
+   if (!cso)
+      return NULL;
+
+   *cso = key;
+   cso->handle = virgl_object_assign_handle();
+   cso->refcount = 1;
+
+   switch (type) {
+   case VIRGL_OBJECT_BLEND:
+      virgl_encode_blend_state(vctx, cso->handle, &cso->state.blend);
+      break;
+   case VIRGL_OBJECT_DSA:
+      virgl_encode_dsa_state(vctx, cso->handle, &cso->state.dsa);
+      break;
+   case VIRGL_OBJECT_RASTERIZER:
+      virgl_encode_rasterizer_state(vctx, cso->handle, &cso->state.rs);
+      break;
+   default:
+      unreachable("not a cached object type");
+   }
+
+   _mesa_hash_table_insert(vctx->cso_cache, cso, cso);
+   return cso;
+}
+
+static void virgl_cso_bind(struct virgl_context *vctx,
+                           enum virgl_object_type type,
+                           struct virgl_cso *cso)
+{
+   uint32_t handle = cso ? cso->handle : 0;
+
+   /* Handles aren't reused, so the same handle is the same object. */
+   if (vctx->bound_cso_handles[type] == handle)
+      return;
+
+   vctx->bound_cso_handles[type] = handle;
+   virgl_encode_bind_object(vctx, handle, type);
+}
+
+static void virgl_cso_release(struct virgl_context *vctx,
+                              struct virgl_cso *cso)
+{
+   if (--cso->refcount)
+      return;
+
+   _mesa_hash_table_remove_key(vctx->cso_cache, cso);
+   virgl_encode_delete_object(vctx, cso->handle, cso->type);
+   FREE(cso);
+}
+
 static void *virgl_create_blend_state(struct pipe_context *ctx,
                                               const struct pipe_blend_state *blend_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   uint32_t handle;
-   handle = virgl_object_assign_handle();
-
-   virgl_encode_blend_state(vctx, handle, blend_state);
-   return (void *)(unsigned long)handle;
-
+   return virgl_cso_create(vctx, VIRGL_OBJECT_BLEND, blend_state,
+                           sizeof(*blend_state));
 }
 
 static void virgl_bind_blend_state(struct pipe_context *ctx,
                                            void *blend_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   uint32_t handle = (unsigned long)blend_state;
-   virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_BLEND);
+   virgl_cso_bind(vctx, VIRGL_OBJECT_BLEND, blend_state);
 }
 
 static void virgl_delete_blend_state(struct pipe_context *ctx,
                                      void *blend_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   uint32_t handle = (unsigned long)blend_state;
-   virgl_encode_delete_object(vctx, handle, VIRGL_OBJECT_BLEND);
+   virgl_cso_release(vctx, blend_state);
 }
 
 static void *virgl_create_depth_stencil_alpha_state(struct pipe_context *ctx,
                                                    const struct pipe_depth_stencil_alpha_state *blend_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   uint32_t handle;
-   handle = virgl_object_assign_handle();
-
-   virgl_encode_dsa_state(vctx, handle, blend_state);
-   return (void *)(unsigned long)handle;
+   return virgl_cso_create(vctx, VIRGL_OBJECT_DSA, blend_state,
+                           sizeof(*blend_state));
 }
 
 static void virgl_bind_depth_stencil_alpha_state(struct pipe_context *ctx,
                                                 void *blend_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   uint32_t handle = (unsigned long)blend_state;
-   virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_DSA);
+   virgl_cso_bind(vctx, VIRGL_OBJECT_DSA, blend_state);
 }
 
 static void virgl_delete_depth_stencil_alpha_state(struct pipe_context *ctx,
                                                   void *dsa_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   uint32_t handle = (unsigned long)dsa_state;
-   virgl_encode_delete_object(vctx, handle, VIRGL_OBJECT_DSA);
+   virgl_cso_release(vctx, dsa_state);
 }
 
 static void *virgl_create_rasterizer_state(struct pipe_context *ctx,
                                                    const struct pipe_rasterizer_state *rs_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   struct virgl_rasterizer_state *vrs = CALLOC_STRUCT(virgl_rasterizer_state);
-
-   if (!vrs)
-      return NULL;
-   vrs->rs = *rs_state;
-   vrs->handle = virgl_object_assign_handle();
-
-   virgl_encode_rasterizer_state(vctx, vrs->handle, rs_state);
-   return (void *)vrs;
+   return virgl_cso_create(vctx, VIRGL_OBJECT_RASTERIZER, rs_state,
+                           sizeof(*rs_state));
 }
 
 static void virgl_bind_rasterizer_state(struct pipe_context *ctx,
                                                 void *rs_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   uint32_t handle = 0;
-   if (rs_state) {
-      struct virgl_rasterizer_state *vrs = rs_state;
-      vctx->rs_state = *vrs;
-      handle = vrs->handle;
+   struct virgl_cso *cso = rs_state;
+   if (cso) {
+      vctx->rs_state.rs = cso->state.rs;
+      vctx->rs_state.handle = cso->handle;
    }
-   virgl_encode_bind_object(vctx, handle, VIRGL_OBJECT_RASTERIZER);
+   virgl_cso_bind(vctx, VIRGL_OBJECT_RASTERIZER, cso);
 }
 
 static void virgl_delete_rasterizer_state(struct pipe_context *ctx,
                                          void *rs_state)
 {
    struct virgl_context *vctx = virgl_context(ctx);
-   struct virgl_rasterizer_state *vrs = rs_state;
-   virgl_encode_delete_object(vctx, vrs->handle, VIRGL_OBJECT_RASTERIZER);
-   FREE(vrs);
+   virgl_cso_release(vctx, rs_state);
 }
 
 static void virgl_set_framebuffer_state(struct pipe_context *ctx,
@@ -1192,6 +1271,11 @@ virgl_context_destroy( struct pipe_context *ctx )
    util_primconvert_destroy(vctx->primconvert);
    virgl_transfer_queue_fini(&vctx->queue);
 
+   /* The host objects went away with the sub context. */
+   hash_table_foreach(vctx->cso_cache, entry)
+      FREE(entry->data);
+   _mesa_hash_table_destroy(vctx->cso_cache, NULL);
+
    slab_destroy_child(&vctx->transfer_pool);
    FREE(vctx);
 }
@@ -1338,6 +1422,11 @@ struct pipe_context *virgl_context_create(struct pipe_screen *pscreen,
    vctx->encoded_transfers = (rs->vws->supports_encoded_transfers &&
                        (rs->caps.caps.v2.capability_bits & VIRGL_CAP_TRANSFER));
 
+   vctx->cso_cache = _mesa_hash_table_create(NULL, virgl_cso_hash,
+                                             virgl_cso_equal);
+   if (!vctx->cso_cache)
+      goto fail;
+
    /* Reserve some space for transfers. */
    if (vctx->encoded_transfers)
       vctx->cbuf->cdw = VIRGL_MAX_TBUF_DWORDS;
@@ -28,6 +28,7 @@
 #include "util/slab.h"
 #include "util/list.h"
 
+#include "virgl_protocol.h"
 #include "virgl_transfer_queue.h"
 
 struct pipe_screen;
@@ -76,6 +77,11 @@ struct virgl_context {
    boolean vertex_array_dirty;
 
    struct virgl_rasterizer_state rs_state;
+
+   /* Blend, DSA and rasterizer states by contents, see virgl_cso_create. */
+   struct hash_table *cso_cache;
+   uint32_t bound_cso_handles[VIRGL_MAX_OBJECTS];
+
    struct virgl_so_target so_targets[PIPE_MAX_SO_BUFFERS];
    unsigned num_so_targets;
 
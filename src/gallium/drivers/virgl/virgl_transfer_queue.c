@@ -99,6 +99,34 @@ static bool transfers_overlap(struct virgl_transfer *queued,
    return (tmp == TRUE);
 }
 
+/*
+ * Whether the union of the two boxes is exactly the area of both, which is
+ * the case for the neighbouring tiles of a texture update.
+ */
+static bool transfers_adjacent(struct virgl_transfer *queued,
+                               struct virgl_transfer *current)
+{
+   const struct pipe_box *a = &queued->base.box;
+   const struct pipe_box *b = &current->base.box;
+
+   if (queued->base.resource != current->base.resource)
+      return false;
+
+   if (queued->base.level != current->base.level)
+      return false;
+
+   if (a->z != b->z || a->depth != 1 || b->depth != 1)
+      return false;
+
+   if (a->y == b->y && a->height == b->height)
+      return a->x + a->width == b->x || b->x + b->width == a->x;
+
+   if (a->x == b->x && a->width == b->width)
+      return a->y + a->height == b->y || b->y + b->height == a->y;
+
+   return false;
+}
+
 static void set_true(UNUSED struct virgl_transfer_queue *queue,
                      struct list_action_args *args)
 {
@@ -137,6 +165,24 @@ static void replace_unmapped_transfer(struct virgl_transfer_queue *queue,
    queue->num_dwords -= (VIRGL_TRANSFER3D_SIZE + 1);
 }
 
+static void merge_adjacent_transfer(struct virgl_transfer_queue *queue,
+                                    struct list_action_args *args)
+{
+   struct virgl_transfer *current = args->current;
+   struct virgl_transfer *queued = args->queued;
+   bool *merged = args->data;
+
+   /* The union starts at the origin of one of the two boxes, which is the
+    * one with the smaller offset.
+    */
+   u_box_union_2d(&current->base.box, &current->base.box, &queued->base.box);
+   current->offset = MIN2(current->offset, queued->offset);
+
+   remove_transfer(queue, args);
+   queue->num_dwords -= (VIRGL_TRANSFER3D_SIZE + 1);
+   *merged = true;
+}
+
 static void transfer_put(struct virgl_transfer_queue *queue,
                          struct list_action_args *args)
 {
@@ -305,6 +351,21 @@ int virgl_transfer_queue_unmap(struct virgl_transfer_queue *queue,
       compare_and_perform_action(queue, &iter);
    }
 
+   /* Send neighbouring writes as one transfer. Merging may make the transfer
+    * adjacent to another queued one, so repeat until nothing changes.
+    */
+   bool merged;
+   do {
+      merged = false;
+      memset(&iter, 0, sizeof(iter));
+      iter.current = transfer;
+      iter.compare = transfers_adjacent;
+      iter.action = merge_adjacent_transfer;
+      iter.data = &merged;
+      iter.type = PENDING_LIST;
+      compare_and_perform_action(queue, &iter);
+   } while (merged);
+
    add_internal(queue, transfer);
    return 0;
 }
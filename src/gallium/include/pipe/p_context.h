@@ -245,6 +245,24 @@ struct pipe_context {
    void   (*bind_tes_state)(struct pipe_context *, void *);
    void   (*delete_tes_state)(struct pipe_context *, void *);
 
+   /**
+    * Program binary support (optional).
+    *
+    * get_shader_binary returns the driver's compiled code for the shader
+    * CSO \p shader_state of stage \p shader, in a buffer allocated with
+    * MALLOC that the caller frees, or NULL if there is nothing to return.
+    *
+    * Handing that buffer to add_shader_binary, in the same or another
+    * process running the same driver build, lets the driver skip the
+    * backend compile when the same shader is created again.  The driver
+    * must validate the contents, since they come from the application.
+    */
+   void * (*get_shader_binary)(struct pipe_context *,
+                               enum pipe_shader_type shader,
+                               void *shader_state, unsigned *size);
+   void   (*add_shader_binary)(struct pipe_context *,
+                               const void *binary, unsigned size);
+
    void * (*create_vertex_elements_state)(struct pipe_context *,
                                           unsigned num_elements,
                                           const struct pipe_vertex_element *);
@@ -569,6 +569,14 @@ enum pipe_query_type {
    PIPE_QUERY_GPU_FINISHED,
    PIPE_QUERY_PIPELINE_STATISTICS,
    PIPE_QUERY_PIPELINE_STATISTICS_SINGLE,
+   /* Screen-wide shader compiler counters, see util/u_compile_stats.h.
+    * Drivers advertise them through pipe_screen::get_driver_query_info.
+    */
+   PIPE_QUERY_SHADER_COMPILES,
+   PIPE_QUERY_SHADER_COMPILE_TIME,
+   PIPE_QUERY_SHADER_CACHE_HITS,
+   PIPE_QUERY_SHADER_CACHE_MISSES,
+   PIPE_QUERY_SHADER_COMPILE_QUEUE_DEPTH,
    PIPE_QUERY_TYPES,
    /* start of driver queries, see pipe_screen::get_driver_query_info */
    PIPE_QUERY_DRIVER_SPECIFIC = 256,
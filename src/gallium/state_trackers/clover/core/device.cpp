@@ -25,6 +25,7 @@
 #include "core/platform.hpp"
 #include "pipe/p_screen.h"
 #include "pipe/p_state.h"
+#include "util/disk_cache.h"
 #include "util/u_debug.h"
 
 using namespace clover;
@@ -40,10 +41,42 @@ namespace {
       pipe->get_compute_param(pipe, ir_format, cap, &v.front());
       return v;
    }
+
+   ///
+   /// Create the on-disk cache for the programs built for a device.  The
+   /// cache is keyed on the clover build and on the pipe driver build,
+   /// which provides the back-end compiler.
+   ///
+   disk_cache *
+   create_program_cache(pipe_screen *pipe) {
+#ifdef ENABLE_SHADER_CACHE
+      // Don't let the cache hide the CLOVER_DEBUG dumps.
+      if (debug_get_option("CLOVER_DEBUG", NULL))
+         return NULL;
+
+      mesa_sha1 ctx;
+      unsigned char sha1[20];
+      char id[41];
+
+      _mesa_sha1_init(&ctx);
+      if (!disk_cache_get_function_identifier(
+             reinterpret_cast<void *>(create_program_cache), &ctx) ||
+          !disk_cache_get_function_identifier(
+             reinterpret_cast<void *>(pipe->destroy), &ctx))
+         return NULL;
+      _mesa_sha1_final(&ctx, sha1);
+      _mesa_sha1_format(id, sha1);
+
+      const std::string name = std::string("clover_") + pipe->get_name(pipe);
+      return disk_cache_create(name.c_str(), id, 0);
+#else
+      return NULL;
+#endif
+   }
 }
 
 device::device(clover::platform &platform, pipe_loader_device *ldev) :
-   platform(platform), ldev(ldev) {
+   platform(platform), ldev(ldev), cache(NULL) {
    pipe = pipe_loader_create_screen(ldev);
    if (!pipe || !pipe->get_param(pipe, PIPE_CAP_COMPUTE) ||
        !supports_ir(PIPE_SHADER_IR_NATIVE)) {
@@ -51,9 +84,13 @@ device::device(clover::platform &platform, pipe_loader_device *ldev) :
          pipe->destroy(pipe);
       throw error(CL_INVALID_DEVICE);
    }
+
+   cache = create_program_cache(pipe);
 }
 
 device::~device() {
+   if (cache)
+      disk_cache_destroy(cache);
    if (pipe)
       pipe->destroy(pipe);
    if (ldev)
@@ -293,3 +330,8 @@ device::supported_extensions() const {
       + std::string(has_doubles() ? " cl_khr_fp64" : "")
       + std::string(has_halves() ? " cl_khr_fp16" : "");
 }
+
+disk_cache *
+device::program_cache() const {
+   return cache;
+}
@@ -20,11 +20,70 @@
 // OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#include <sstream>
+
 #include "core/program.hpp"
 #include "llvm/invocation.hpp"
+#include "util/disk_cache.h"
 
 using namespace clover;
 
+namespace {
+   ///
+   /// Look up the module built from the given inputs in the device's
+   /// program cache.
+   ///
+   bool
+   find_cached_module(const device &dev, const std::string &inputs,
+                      module &m) {
+      disk_cache *cache = dev.program_cache();
+      if (!cache)
+         return false;
+
+      cache_key key;
+      disk_cache_compute_key(cache, inputs.data(), inputs.size(), key);
+
+      size_t size;
+      char *data = static_cast<char *>(disk_cache_get(cache, key, &size));
+      if (!data)
+         return false;
+
+      std::istringstream s(std::string(data, size));
+      free(data);
+
+      try {
+         m = module::deserialize(s);
+         return !s.fail();
+      } catch (...) {
+         return false;
+      }
+   }
+
+   void
+   cache_module(const device &dev, const std::string &inputs,
+                const module &m) {
+      disk_cache *cache = dev.program_cache();
+      if (!cache)
+         return;
+
+      cache_key key;
+      disk_cache_compute_key(cache, inputs.data(), inputs.size(), key);
+
+      std::ostringstream s;
+      m.serialize(s);
+      const std::string data = s.str();
+      disk_cache_put(cache, key, data.data(), data.size(), NULL);
+   }
+
+   template<typename T>
+   void
+   append_sized(std::string &inputs, const T &x) {
+      const uint64_t sz = x.size();
+      inputs.append(reinterpret_cast<const char *>(&sz), sizeof(sz));
+      inputs.append(x.begin(), x.end());
+   }
+}
+
 program::program(clover::context &ctx, const std::string &source) :
    has_source(true), context(ctx), _devices(ctx.devices()), _source(source),
    _kernel_ref_counter(0) {
@@ -47,13 +106,27 @@ program::compile(const ref_vector<device> &devs, const std::string &opts,
    if (has_source) {
       _devices = devs;
 
+      std::string inputs = "compile";
+      append_sized(inputs, opts);
+      append_sized(inputs, _source);
+      for (auto &header : headers) {
+         append_sized(inputs, header.first);
+         append_sized(inputs, header.second);
+      }
+
       for (auto &dev : devs) {
          std::string log;
+         module m;
+
+         if (find_cached_module(dev, inputs, m)) {
+            _builds[&dev] = { m, opts, log };
+            continue;
+         }
 
          try {
             assert(dev.ir_format() == PIPE_SHADER_IR_NATIVE);
-            const module m = llvm::compile_program(_source, headers, dev, opts,
-                                                   log);
+            m = llvm::compile_program(_source, headers, dev, opts, log);
+            cache_module(dev, inputs, m);
             _builds[&dev] = { m, opts, log };
          } catch (...) {
             _builds[&dev] = { module(), opts, log };
@@ -74,9 +147,24 @@ program::link(const ref_vector<device> &devs, const std::string &opts,
          }, progs);
       std::string log = _builds[&dev].log;
 
+      std::string inputs = "link";
+      append_sized(inputs, opts);
+      for (auto &bin : ms) {
+         std::ostringstream s;
+         bin.serialize(s);
+         append_sized(inputs, s.str());
+      }
+
+      module m;
+      if (find_cached_module(dev, inputs, m)) {
+         _builds[&dev] = { m, opts, log };
+         continue;
+      }
+
       try {
          assert(dev.ir_format() == PIPE_SHADER_IR_NATIVE);
-         const module m = llvm::link_program(ms, dev, opts, log);
+         m = llvm::link_program(ms, dev, opts, log);
+         cache_module(dev, inputs, m);
          _builds[&dev] = { m, opts, log };
       } catch (...) {
          _builds[&dev] = { module(), opts, log };
@@ -20,6 +20,8 @@
 // OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#include <algorithm>
+
 #include "core/queue.hpp"
 #include "core/event.hpp"
 #include "pipe/p_screen.h"
@@ -72,10 +74,16 @@ command_queue::flush() {
    if (!queued_events.empty()) {
       pipe->flush(pipe, &fence, 0);
 
-      while (!queued_events.empty() &&
-             queued_events.front()().signalled()) {
-         queued_events.front()().fence(fence);
-         queued_events.pop_front();
+      // Events of an out-of-order queue may be signalled in any order,
+      // so don't stop at the first one still waiting for its
+      // dependencies.
+      for (auto it = queued_events.begin(); it != queued_events.end();) {
+         if ((*it)().signalled()) {
+            (*it)().fence(fence);
+            it = queued_events.erase(it);
+         } else {
+            ++it;
+         }
       }
 
       screen->fence_reference(screen, &fence, NULL);
@@ -92,11 +100,37 @@ command_queue::profiling_enabled() const {
    return props & CL_QUEUE_PROFILING_ENABLE;
 }
 
+bool
+command_queue::out_of_order() const {
+   return props & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+}
+
 void
 command_queue::sequence(hard_event &ev) {
    std::lock_guard<std::mutex> lock(queued_events_mutex);
-   if (!queued_events.empty())
-      queued_events.back()().chain(ev);
+
+   if (!out_of_order()) {
+      if (!queued_events.empty())
+         queued_events.back()().chain(ev);
+
+   } else if ((ev.command() == CL_COMMAND_BARRIER ||
+               ev.command() == CL_COMMAND_MARKER) && ev.deps.empty()) {
+      // A barrier or marker with an empty wait list waits for every
+      // command enqueued before it.
+      for (auto &qev : queued_events)
+         qev().chain(ev);
+
+   } else {
+      // Anything else only waits for its explicit dependencies and the
+      // last barrier, so independent commands can be started as soon
+      // as they're ready instead of behind a blocked one.
+      auto it = std::find_if(queued_events.rbegin(), queued_events.rend(),
+                             [](const intrusive_ref<hard_event> &qev) {
+                                return qev().command() == CL_COMMAND_BARRIER;
+                             });
+      if (it != queued_events.rend())
+         (*it)().chain(ev);
+   }
 
    queued_events.push_back(ev);
 }
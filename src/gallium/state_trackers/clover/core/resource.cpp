@@ -20,6 +20,8 @@
 // OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#include <unistd.h>
+
 #include "core/resource.hpp"
 #include "core/memory.hpp"
 #include "pipe/p_screen.h"
@@ -139,12 +141,24 @@ root_resource::root_resource(clover::device &dev, memory_obj &obj,
                 PIPE_BIND_COMPUTE_RESOURCE |
                 PIPE_BIND_GLOBAL);
 
-   if (obj.flags() & CL_MEM_USE_HOST_PTR && user_ptr_support) {
-      // Page alignment is normally required for this, just try, hope for the
-      // best and fall back if it fails.
-      pipe = dev.pipe->resource_from_user_memory(dev.pipe, &info, obj.host_ptr());
-      if (pipe)
+   if (obj.flags() & CL_MEM_USE_HOST_PTR && user_ptr_support &&
+       info.target == PIPE_BUFFER) {
+      // The kernel only accepts page-aligned user memory, so wrap the
+      // whole pages spanned by the host buffer and point the resource
+      // at the right offset within them.  Fall back to a copy if the
+      // driver still refuses the memory.
+      const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+      const uintptr_t ptr = (uintptr_t)obj.host_ptr();
+      const uintptr_t base = ptr & ~(page_size - 1);
+      pipe_resource user_info = info;
+
+      user_info.width0 = align(ptr - base + obj.size(), page_size);
+      pipe = dev.pipe->resource_from_user_memory(dev.pipe, &user_info,
+                                                 (void *)base);
+      if (pipe) {
+         offset[0] = ptr - base;
          return;
+      }
    }
 
    if (obj.flags() & (CL_MEM_ALLOC_HOST_PTR | CL_MEM_USE_HOST_PTR)) {
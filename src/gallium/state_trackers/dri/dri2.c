@@ -28,6 +28,7 @@
  *    <wallbraker@gmail.com> Chia-I Wu <olv@lunarg.com>
  */
 
+#include <sys/stat.h>
 #include <xf86drm.h>
 #include "GL/mesa_glinterop.h"
 #include "util/u_memory.h"
@@ -776,6 +777,143 @@ dri2_update_tex_buffer(struct dri_drawable *drawable,
    /* no-op */
 }
 
+/*
+ * dmabuf import cache.
+ *
+ * Compositors and video players import the same client buffers again every
+ * frame.  The resources of the last few dmabuf imports are kept, keyed on
+ * the identity of the dmabufs (a dmabuf keeps its inode for as long as it
+ * lives, and the cached resource keeps it alive) and the layout they were
+ * imported with, so that a re-import is a few fstat()s and a lookup instead
+ * of a resource_from_handle() per plane.
+ */
+
+#define DRI2_IMPORT_CACHE_SIZE 16
+
+struct dri2_import_key {
+   int width, height;
+   enum pipe_format format;
+   int num_handles;
+   uint64_t modifier;
+   struct {
+      dev_t dev;
+      ino_t ino;
+      unsigned stride;
+      unsigned offset;
+   } planes[3];
+};
+
+struct dri2_import_entry {
+   struct list_head link;
+   struct dri2_import_key key;
+   struct pipe_resource *texture;
+};
+
+static void
+dri2_import_cache_init(struct dri_screen *screen)
+{
+   (void) mtx_init(&screen->import_cache_mutex, mtx_plain);
+   list_inithead(&screen->import_cache);
+   screen->import_cache_size = 0;
+}
+
+static void
+dri2_import_cache_fini(struct dri_screen *screen)
+{
+   list_for_each_entry_safe(struct dri2_import_entry, entry,
+                            &screen->import_cache, link) {
+      pipe_resource_reference(&entry->texture, NULL);
+      FREE(entry);
+   }
+   list_inithead(&screen->import_cache);
+   screen->import_cache_size = 0;
+   mtx_destroy(&screen->import_cache_mutex);
+}
+
+static bool
+dri2_import_key_init(struct dri2_import_key *key,
+                     int width, int height, enum pipe_format pf,
+                     int num_handles, const struct winsys_handle *whandle)
+{
+   memset(key, 0, sizeof(*key));
+   key->width = width;
+   key->height = height;
+   key->format = pf;
+   key->num_handles = num_handles;
+   key->modifier = whandle[0].modifier;
+
+   if (num_handles > (int)ARRAY_SIZE(key->planes))
+      return false;
+
+   for (int i = 0; i < num_handles; i++) {
+      struct stat st;
+
+      if (whandle[i].type != WINSYS_HANDLE_TYPE_FD ||
+          whandle[i].modifier != key->modifier ||
+          fstat(whandle[i].handle, &st) != 0)
+         return false;
+
+      key->planes[i].dev = st.st_dev;
+      key->planes[i].ino = st.st_ino;
+      key->planes[i].stride = whandle[i].stride;
+      key->planes[i].offset = whandle[i].offset;
+   }
+
+   return true;
+}
+
+static struct pipe_resource *
+dri2_import_cache_lookup(struct dri_screen *screen,
+                         const struct dri2_import_key *key)
+{
+   struct pipe_resource *tex = NULL;
+
+   mtx_lock(&screen->import_cache_mutex);
+   list_for_each_entry(struct dri2_import_entry, entry,
+                       &screen->import_cache, link) {
+      if (memcmp(&entry->key, key, sizeof(*key)) == 0) {
+         pipe_resource_reference(&tex, entry->texture);
+         list_del(&entry->link);
+         list_add(&entry->link, &screen->import_cache);
+         break;
+      }
+   }
+   mtx_unlock(&screen->import_cache_mutex);
+
+   return tex;
+}
+
+static void
+dri2_import_cache_add(struct dri_screen *screen,
+                      const struct dri2_import_key *key,
+                      struct pipe_resource *tex)
+{
+   struct dri2_import_entry *entry = CALLOC_STRUCT(dri2_import_entry);
+
+   if (!entry)
+      return;
+
+   entry->key = *key;
+   pipe_resource_reference(&entry->texture, tex);
+
+   mtx_lock(&screen->import_cache_mutex);
+   list_add(&entry->link, &screen->import_cache);
+
+   /* Drop the least recently used import, which also releases the dmabuf
+    * if nobody else holds it anymore.
+    */
+   if (++screen->import_cache_size > DRI2_IMPORT_CACHE_SIZE) {
+      struct dri2_import_entry *last =
+         LIST_ENTRY(struct dri2_import_entry, screen->import_cache.prev, link);
+
+      list_del(&last->link);
+      screen->import_cache_size--;
+      pipe_resource_reference(&last->texture, NULL);
+      FREE(last);
+   }
+   mtx_unlock(&screen->import_cache_mutex);
+}
+
 static __DRIimage *
 dri2_create_image_from_winsys(__DRIscreen *_screen,
                               int width, int height, enum pipe_format pf,
@@ -786,9 +924,29 @@ dri2_create_image_from_winsys(__DRIscreen *_screen,
    struct pipe_screen *pscreen = screen->base.screen;
    __DRIimage *img;
    struct pipe_resource templ;
+   struct dri2_import_key key;
+   bool cacheable;
    unsigned tex_usage = 0;
    int i;
 
+   cacheable = dri2_import_key_init(&key, width, height, pf,
+                                    num_handles, whandle);
+   if (cacheable) {
+      struct pipe_resource *tex = dri2_import_cache_lookup(screen, &key);
+
+      if (tex) {
+         img = CALLOC_STRUCT(__DRIimageRec);
+         if (!img) {
+            pipe_resource_reference(&tex, NULL);
+            return NULL;
+         }
+
+         img->texture = tex;
+         img->loader_private = loaderPrivate;
+         return img;
+      }
+   }
+
    if (pscreen->is_format_supported(pscreen, pf, screen->target, 0, 0,
                                     PIPE_BIND_RENDER_TARGET))
       tex_usage |= PIPE_BIND_RENDER_TARGET;
@@ -864,6 +1022,9 @@ dri2_create_image_from_winsys(__DRIscreen *_screen,
    img->use = 0;
    img->loader_private = loaderPrivate;
 
+   if (cacheable)
+      dri2_import_cache_add(screen, &key, img->texture);
+
    return img;
 }
 
@@ -1916,6 +2077,7 @@ dri2_init_screen(__DRIscreen * sPriv)
    screen->sPriv = sPriv;
    screen->fd = sPriv->fd;
    (void) mtx_init(&screen->opencl_func_mutex, mtx_plain);
+   dri2_import_cache_init(screen);
 
    sPriv->driverPrivate = (void *)screen;
 
@@ -1976,6 +2138,7 @@ release_pipe:
    if (screen->dev)
       pipe_loader_release(&screen->dev, 1);
 
+   dri2_import_cache_fini(screen);
    FREE(screen);
    return NULL;
 }
@@ -2000,6 +2163,7 @@ dri_kms_init_screen(__DRIscreen * sPriv)
 
    screen->sPriv = sPriv;
    screen->fd = sPriv->fd;
+   dri2_import_cache_init(screen);
 
    sPriv->driverPrivate = (void *)screen;
 
@@ -2046,11 +2210,21 @@ release_pipe:
    if (screen->dev)
       pipe_loader_release(&screen->dev, 1);
 
+   dri2_import_cache_fini(screen);
    FREE(screen);
 #endif // GALLIUM_SOFTPIPE
    return NULL;
 }
 
+static void
+dri2_destroy_screen(__DRIscreen * sPriv)
+{
+   /* The cached imports have to go before the pipe_screen */
+   dri2_import_cache_fini(dri_screen(sPriv));
+
+   dri_destroy_screen(sPriv);
+}
+
 static boolean
 dri2_create_buffer(__DRIscreen * sPriv,
                    __DRIdrawable * dPriv,
@@ -2078,7 +2252,7 @@ dri2_create_buffer(__DRIscreen * sPriv,
  */
 const struct __DriverAPIRec galliumdrm_driver_api = {
    .InitScreen = dri2_init_screen,
-   .DestroyScreen = dri_destroy_screen,
+   .DestroyScreen = dri2_destroy_screen,
    .CreateContext = dri_create_context,
    .DestroyContext = dri_destroy_context,
    .CreateBuffer = dri2_create_buffer,
@@ -2099,7 +2273,7 @@ const struct __DriverAPIRec galliumdrm_driver_api = {
  */
 const struct __DriverAPIRec dri_kms_driver_api = {
    .InitScreen = dri_kms_init_screen,
-   .DestroyScreen = dri_destroy_screen,
+   .DestroyScreen = dri2_destroy_screen,
    .CreateContext = dri_create_context,
    .DestroyContext = dri_destroy_context,
    .CreateBuffer = dri2_create_buffer,
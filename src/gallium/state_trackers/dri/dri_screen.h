@@ -40,6 +40,7 @@
 #include "state_tracker/st_api.h"
 #include "state_tracker/opencl_interop.h"
 #include "os/os_thread.h"
+#include "util/list.h"
 #include "postprocess/filters.h"
 
 struct dri_context;
@@ -82,6 +83,11 @@ struct dri_screen
    /* hooks filled in by dri2 & drisw */
    __DRIimage * (*lookup_egl_image)(struct dri_screen *ctx, void *handle);
 
+   /* dmabuf imports, most recently used first (dri2 only) */
+   mtx_t import_cache_mutex;
+   struct list_head import_cache;
+   unsigned import_cache_size;
+
    /* OpenCL interop */
    mtx_t opencl_func_mutex;
    opencl_dri_event_add_ref_t opencl_dri_event_add_ref;
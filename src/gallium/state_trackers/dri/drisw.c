@@ -231,7 +231,8 @@ drisw_copy_to_front(__DRIdrawable * dPriv,
  */
 
 static void
-drisw_swap_buffers(__DRIdrawable *dPriv)
+drisw_swap_buffers_with_damage(__DRIdrawable *dPriv, int nrects,
+                               const int *rects)
 {
    struct dri_context *ctx = dri_get_current(dPriv->driScreenPriv);
    struct dri_drawable *drawable = dri_drawable(dPriv);
@@ -248,10 +249,39 @@ drisw_swap_buffers(__DRIdrawable *dPriv)
 
       ctx->st->flush(ctx->st, ST_FLUSH_FRONT, NULL);
 
-      drisw_copy_to_front(dPriv, ptex);
+      if (nrects == 0) {
+         drisw_copy_to_front(dPriv, ptex);
+         return;
+      }
+
+      /* Only put the damaged rectangles, flipped to the window's top-left
+       * origin and clipped against the back buffer.
+       */
+      for (int i = 0; i < nrects; i++) {
+         const int *rect = &rects[i * 4];
+         int x0 = MAX2(rect[0], 0);
+         int x1 = MIN2(rect[0] + rect[2], (int)ptex->width0);
+         int y0 = MAX2((int)ptex->height0 - rect[1] - rect[3], 0);
+         int y1 = MIN2((int)ptex->height0 - rect[1], (int)ptex->height0);
+         struct pipe_box box;
+
+         if (x0 >= x1 || y0 >= y1)
+            continue;
+
+         u_box_2d(x0, y0, x1 - x0, y1 - y0, &box);
+         drisw_present_texture(dPriv, ptex, &box);
+      }
+
+      drisw_invalidate_drawable(dPriv);
    }
 }
 
+static void
+drisw_swap_buffers(__DRIdrawable *dPriv)
+{
+   drisw_swap_buffers_with_damage(dPriv, 0, NULL);
+}
+
 static void
 drisw_copy_sub_buffer(__DRIdrawable *dPriv, int x, int y,
                       int w, int h)
@@ -413,6 +443,12 @@ static __DRIimageExtension driSWImageExtension = {
     .destroyImage = dri2_destroy_image,
 };
 
+static const __DRIswrastSwapDamageExtension driSWSwapDamageExtension = {
+   .base = { __DRI_SWRAST_SWAP_DAMAGE, 1 },
+
+   .swapBuffersWithDamage = drisw_swap_buffers_with_damage,
+};
+
 /*
  * Backend function for init_screen.
  */
@@ -425,6 +461,7 @@ static const __DRIextension *drisw_screen_extensions[] = {
    &dri2NoErrorExtension.base,
    &driSWImageExtension.base,
    &dri2FlushControlExtension.base,
+   &driSWSwapDamageExtension.base,
    NULL
 };
 
@@ -23,8 +23,13 @@
 #include "nine_queue.h"
 #include "os/os_thread.h"
 #include "util/macros.h"
+#include "util/u_atomic.h"
 #include "nine_helpers.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define NINE_CMD_BUF_INSTR (256)
 
 #define NINE_CMD_BUFS (32)
@@ -32,6 +37,9 @@
 
 #define NINE_QUEUE_SIZE (8192 * 16 + 128)
 
+/* How many times to poll a cmdbuf before going to sleep on it */
+#define NINE_QUEUE_SPIN_COUNT (4096)
+
 #define DBG_CHANNEL DBG_DEVICE
 
 /*
@@ -56,6 +64,11 @@
  * Constrains:
  * Only a single consumer and a single producer are supported.
  *
+ * Handing a cmdbuf over doesn't take any lock: each side polls the
+ * cmdbuf's full flag for a while, and only if that doesn't succeed
+ * it registers itself as waiting and sleeps on the condition variable.
+ * The other side takes the mutex to wake it up only in that case.
+ *
  */
 
 struct nine_cmdbuf {
@@ -72,12 +85,59 @@ struct nine_queue_pool {
     unsigned tail;
     unsigned cur_instr;
     BOOL worker_wait;
+    BOOL producer_wait;
     cnd_t event_pop;
     cnd_t event_push;
     mtx_t mutex_pop;
     mtx_t mutex_push;
 };
 
+/* Sets @flag with a full barrier, so that a following read of the
+ * other side's waiting flag can't be reordered before it. */
+static inline void
+nine_queue_set_flag(BOOL *flag, BOOL value)
+{
+    p_atomic_cmpxchg(flag, !value, value);
+}
+
+/* Waits for @flag to become @value, first by polling it, then by
+ * sleeping on @cond with @waiting set. */
+static void
+nine_queue_wait_flag(BOOL *flag, BOOL value, BOOL *waiting,
+                     cnd_t *cond, mtx_t *mutex)
+{
+    unsigned i;
+
+    for (i = 0; i < NINE_QUEUE_SPIN_COUNT; i++) {
+        if (p_atomic_read(flag) == value)
+            return;
+#ifdef __SSE2__
+        _mm_pause();
+#endif
+    }
+
+    mtx_lock(mutex);
+    nine_queue_set_flag(waiting, TRUE);
+    while (p_atomic_read(flag) != value)
+        cnd_wait(cond, mutex);
+    p_atomic_set(waiting, FALSE);
+    mtx_unlock(mutex);
+}
+
+/* Sets @flag to @value and wakes up the other side if it's sleeping. */
+static void
+nine_queue_signal_flag(BOOL *flag, BOOL value, BOOL *waiting,
+                       cnd_t *cond, mtx_t *mutex)
+{
+    nine_queue_set_flag(flag, value);
+
+    if (p_atomic_read(waiting)) {
+        mtx_lock(mutex);
+        cnd_signal(cond);
+        mtx_unlock(mutex);
+    }
+}
+
 /* Consumer functions: */
 void
 nine_queue_wait_flush(struct nine_queue_pool* ctx)
@@ -85,14 +145,10 @@ nine_queue_wait_flush(struct nine_queue_pool* ctx)
     struct nine_cmdbuf *cmdbuf = &ctx->pool[ctx->tail];
 
     /* wait for cmdbuf full */
-    mtx_lock(&ctx->mutex_push);
-    while (!cmdbuf->full)
-    {
-        DBG("waiting for full cmdbuf\n");
-        cnd_wait(&ctx->event_push, &ctx->mutex_push);
-    }
+    DBG("waiting for full cmdbuf\n");
+    nine_queue_wait_flag(&cmdbuf->full, TRUE, &ctx->worker_wait,
+                         &ctx->event_push, &ctx->mutex_push);
     DBG("got cmdbuf=%p\n", cmdbuf);
-    mtx_unlock(&ctx->mutex_push);
 
     cmdbuf->offset = 0;
     ctx->cur_instr = 0;
@@ -111,11 +167,9 @@ nine_queue_get(struct nine_queue_pool* ctx)
 
     if (ctx->cur_instr == cmdbuf->num_instr) {
         /* signal waiting producer */
-        mtx_lock(&ctx->mutex_pop);
         DBG("freeing cmdbuf=%p\n", cmdbuf);
-        cmdbuf->full = 0;
-        cnd_signal(&ctx->event_pop);
-        mtx_unlock(&ctx->mutex_pop);
+        nine_queue_signal_flag(&cmdbuf->full, FALSE, &ctx->producer_wait,
+                               &ctx->event_pop, &ctx->mutex_pop);
 
         ctx->tail = (ctx->tail + 1) & NINE_CMD_BUFS_MASK;
 
@@ -148,24 +202,18 @@ nine_queue_flush(struct nine_queue_pool* ctx)
         return;
 
     /* signal waiting worker */
-    mtx_lock(&ctx->mutex_push);
-    cmdbuf->full = 1;
-    cnd_signal(&ctx->event_push);
-    mtx_unlock(&ctx->mutex_push);
+    nine_queue_signal_flag(&cmdbuf->full, TRUE, &ctx->worker_wait,
+                           &ctx->event_push, &ctx->mutex_push);
 
     ctx->head = (ctx->head + 1) & NINE_CMD_BUFS_MASK;
 
     cmdbuf = &ctx->pool[ctx->head];
 
     /* wait for queue empty */
-    mtx_lock(&ctx->mutex_pop);
-    while (cmdbuf->full)
-    {
-        DBG("waiting for empty cmdbuf\n");
-        cnd_wait(&ctx->event_pop, &ctx->mutex_pop);
-    }
+    DBG("waiting for empty cmdbuf\n");
+    nine_queue_wait_flag(&cmdbuf->full, FALSE, &ctx->producer_wait,
+                         &ctx->event_pop, &ctx->mutex_pop);
     DBG("got empty cmdbuf=%p\n", cmdbuf);
-    mtx_unlock(&ctx->mutex_pop);
     cmdbuf->offset = 0;
     cmdbuf->num_instr = 0;
 }
@@ -246,8 +294,6 @@ nine_queue_create(void)
     cnd_init(&ctx->event_push);
     (void) mtx_init(&ctx->mutex_push, mtx_plain);
 
-    /* Block until first cmdbuf has been flushed. */
-    ctx->worker_wait = TRUE;
 
     return ctx;
 failed:
@@ -59,6 +59,10 @@ struct csmt_instruction {
     int (* func)(struct NineDevice9 *This, struct csmt_instruction *instr);
 };
 
+/* How many times to poll for a synchronous instruction to complete
+ * before going to sleep */
+#define NINE_CSMT_SPIN_COUNT (4096)
+
 struct csmt_context {
     thrd_t worker;
     struct nine_queue_pool* pool;
@@ -75,10 +79,19 @@ struct csmt_context {
 
 /* Wait for instruction to be processed.
  * Caller has to ensure that only one thread waits at time.
+ * The worker is usually done quickly, so poll for a while before
+ * going to sleep.
  */
 static void
 nine_csmt_wait_processed(struct csmt_context *ctx)
 {
+    unsigned i;
+
+    for (i = 0; i < NINE_CSMT_SPIN_COUNT; i++) {
+        if (p_atomic_read(&ctx->processed))
+            return;
+    }
+
     mtx_lock(&ctx->mutex_processed);
     while (!p_atomic_read(&ctx->processed)) {
         cnd_wait(&ctx->event_processed, &ctx->mutex_processed);
@@ -35,12 +35,13 @@
  * display target resource.  However, softpipe doesn't support "upside-down"
  * rendering which would be needed for the OSMESA_Y_UP=TRUE case.
  *
- * With llvmpipe we could only render directly into the user's buffer when its
- * width and height is a multiple of the tile size (64 pixels).
+ * With llvmpipe we render directly into the user's buffer when OSMESA_Y_UP
+ * is FALSE, its width and height are multiples of 4 and its row stride
+ * matches the one llvmpipe would pick for the texture.
  *
- * Because of these constraints we always render into ordinary resources then
- * copy the results to the user's buffer in the flush_front() function which
- * is called when the app calls glFlush/Finish.
+ * Otherwise we render into ordinary resources then copy the results to the
+ * user's buffer in the flush_front() function which is called when the app
+ * calls glFlush/Finish.
  *
  * In general, the OSMesa interface is pretty ugly and not a good match
  * for Gallium.  But we're interested in doing the best we can to preserve
@@ -87,6 +88,11 @@ struct osmesa_buffer
    struct pipe_resource *textures[ST_ATTACHMENT_COUNT];
 
    void *map;
+   unsigned stride;   /**< user buffer stride in bytes */
+   boolean y_up;
+
+   /** Is the front buffer texture wrapping the user's buffer? */
+   boolean zero_copy;
 
    struct osmesa_buffer *next;  /**< next in linked list */
 };
@@ -342,6 +348,19 @@ osmesa_st_framebuffer_flush_front(struct st_context_iface *stctx,
       pp_run(osmesa->pp, res, res, zsbuf);
    }
 
+   if (osbuffer->zero_copy && statt == ST_ATTACHMENT_FRONT_LEFT) {
+      struct pipe_screen *screen = pipe->screen;
+      struct pipe_fence_handle *fence = NULL;
+
+      /* The image is already in the user's buffer, just wait for it */
+      pipe->flush(pipe, &fence, 0);
+      if (fence) {
+         screen->fence_finish(screen, NULL, fence, PIPE_TIMEOUT_INFINITE);
+         screen->fence_reference(screen, &fence, NULL);
+      }
+      return TRUE;
+   }
+
    u_box_2d(0, 0, res->width0, res->height0, &box);
 
    map = pipe->transfer_map(pipe, res, 0, PIPE_TRANSFER_READ, &box,
@@ -353,13 +372,10 @@ osmesa_st_framebuffer_flush_front(struct st_context_iface *stctx,
    bpp = util_format_get_blocksize(osbuffer->visual.color_format);
    src = map;
    dst = osbuffer->map;
-   if (osmesa->user_row_length)
-      dst_stride = bpp * osmesa->user_row_length;
-   else
-      dst_stride = bpp * osbuffer->width;
+   dst_stride = osbuffer->stride;
    bytes = bpp * res->width0;
 
-   if (osmesa->y_up) {
+   if (osbuffer->y_up) {
       /* need to flip image upside down */
       dst = dst + (res->height0 - 1) * dst_stride;
       dst_stride = -dst_stride;
@@ -377,6 +393,72 @@ osmesa_st_framebuffer_flush_front(struct st_context_iface *stctx,
 }
 
 
+/**
+ * Try to create the front buffer texture on top of the user's buffer.
+ * This only works if the driver lays the texture out exactly like the
+ * user's buffer, which we check by mapping it.
+ */
+static struct pipe_resource *
+osmesa_create_user_texture(struct pipe_context *pipe,
+                           struct osmesa_buffer *osbuffer,
+                           const struct pipe_resource *templat)
+{
+   struct pipe_screen *screen = pipe->screen;
+   struct pipe_resource *res;
+   struct pipe_transfer *transfer;
+   struct pipe_box box;
+   void *map;
+
+   if (osbuffer->y_up || !screen->resource_from_user_memory)
+      return NULL;
+
+   res = screen->resource_from_user_memory(screen, templat, osbuffer->map);
+   if (!res)
+      return NULL;
+
+   u_box_2d(0, 0, res->width0, res->height0, &box);
+   map = pipe->transfer_map(pipe, res, 0,
+                            PIPE_TRANSFER_READ | PIPE_TRANSFER_UNSYNCHRONIZED,
+                            &box, &transfer);
+   if (map) {
+      boolean match = map == osbuffer->map &&
+                      transfer->stride == osbuffer->stride;
+      pipe->transfer_unmap(pipe, transfer);
+      if (match)
+         return res;
+   }
+
+   pipe_resource_reference(&res, NULL);
+   return NULL;
+}
+
+
+/**
+ * Update the user buffer parameters of \p osbuffer.  If they changed, the
+ * framebuffer has to be revalidated since the front buffer texture might
+ * wrap the user's buffer.
+ */
+static void
+osmesa_update_buffer(OSMesaContext osmesa, struct osmesa_buffer *osbuffer,
+                     void *map)
+{
+   unsigned bpp = util_format_get_blocksize(osbuffer->visual.color_format);
+   unsigned stride = bpp * (osmesa->user_row_length ?
+                            osmesa->user_row_length : osbuffer->width);
+   boolean y_up = osmesa->y_up;
+
+   if (osbuffer->map == map &&
+       osbuffer->stride == stride &&
+       osbuffer->y_up == y_up)
+      return;
+
+   osbuffer->map = map;
+   osbuffer->stride = stride;
+   osbuffer->y_up = y_up;
+   p_atomic_inc(&osbuffer->stfb->stamp);
+}
+
+
 /**
  * Called by the st manager to validate the framebuffer (allocate
  * its resources).
@@ -434,8 +516,15 @@ osmesa_st_framebuffer_validate(struct st_context_iface *stctx,
       templat.format = format;
       templat.bind = bind;
       pipe_resource_reference(&out[i], NULL);
-      out[i] = osbuffer->textures[statts[i]] =
-         screen->resource_create(screen, &templat);
+      out[i] = NULL;
+
+      if (statts[i] == ST_ATTACHMENT_FRONT_LEFT && stctx) {
+         out[i] = osmesa_create_user_texture(stctx->pipe, osbuffer, &templat);
+         osbuffer->zero_copy = out[i] != NULL;
+      }
+      if (!out[i])
+         out[i] = screen->resource_create(screen, &templat);
+      osbuffer->textures[statts[i]] = out[i];
    }
 
    return TRUE;
@@ -787,7 +876,7 @@ OSMesaMakeCurrent(OSMesaContext osmesa, void *buffer, GLenum type,
 
    osbuffer->width = width;
    osbuffer->height = height;
-   osbuffer->map = buffer;
+   osmesa_update_buffer(osmesa, osbuffer, buffer);
 
    /* XXX unused for now */
    (void) osmesa_destroy_buffer;
@@ -851,6 +940,10 @@ OSMesaPixelStore(GLint pname, GLint value)
       fprintf(stderr, "Invalid pname in OSMesaPixelStore()\n");
       return;
    }
+
+   if (osmesa->current_buffer)
+      osmesa_update_buffer(osmesa, osmesa->current_buffer,
+                           osmesa->current_buffer->map);
 }
 
 
@@ -28,6 +28,8 @@
 
 #include "pipe/p_screen.h"
 
+#include "state_tracker/drm_driver.h"
+
 #include "util/u_memory.h"
 #include "util/u_handle_table.h"
 #include "util/u_surface.h"
@@ -190,6 +192,63 @@ vlVaCreateImage(VADriverContextP ctx, VAImageFormat *format, int width, int heig
    return status;
 }
 
+/**
+ * The planes of a video buffer are separate resources, but drivers usually
+ * suballocate them from a single buffer object (see si_vid_join_surfaces).
+ * When that object is linear, mapping the first plane gives CPU access to all
+ * of them, and a multi-planar image can be derived without a copy.
+ */
+static bool
+vlVaDerivePlanes(vlVaDriver *drv, struct pipe_surface **surfaces,
+                 unsigned num_planes, VAImage *img)
+{
+   struct pipe_screen *screen = drv->pipe->screen;
+   unsigned handle = 0, base = 0, end = 0;
+   unsigned p;
+
+   if (!screen->resource_get_info)
+      return false;
+
+   for (p = 0; p < num_planes; p++) {
+      struct winsys_handle whandle;
+      struct pipe_resource *res;
+      unsigned stride = 0, offset = 0;
+
+      if (!surfaces[p] || !surfaces[p]->texture)
+         return false;
+
+      res = surfaces[p]->texture;
+      if (!(res->bind & PIPE_BIND_LINEAR))
+         return false;
+
+      memset(&whandle, 0, sizeof(whandle));
+      whandle.type = WINSYS_HANDLE_TYPE_KMS;
+      if (!screen->resource_get_handle(screen, drv->pipe, res, &whandle, 0))
+         return false;
+
+      screen->resource_get_info(screen, res, &stride, &offset);
+      if (!stride)
+         return false;
+
+      if (p == 0) {
+         handle = whandle.handle;
+         base = offset;
+      } else if (whandle.handle != handle || offset < end) {
+         /* not in the same object, or not after the previous plane */
+         return false;
+      }
+
+      img->pitches[p] = stride;
+      img->offsets[p] = offset - base;
+      end = offset + stride * res->height0;
+   }
+
+   img->num_planes = num_planes;
+   img->data_size = end - base;
+
+   return true;
+}
+
 VAStatus
 vlVaDeriveImage(VADriverContextP ctx, VASurfaceID surface, VAImage *image)
 {
@@ -204,6 +263,7 @@ vlVaDeriveImage(VADriverContextP ctx, VASurfaceID surface, VAImage *image)
    int i;
    unsigned stride = 0;
    unsigned offset = 0;
+   VAStatus status;
 
    if (!ctx)
       return VA_STATUS_ERROR_INVALID_CONTEXT;
@@ -218,21 +278,34 @@ vlVaDeriveImage(VADriverContextP ctx, VASurfaceID surface, VAImage *image)
    if (!screen)
       return VA_STATUS_ERROR_INVALID_CONTEXT;
 
+   mtx_lock(&drv->mutex);
    surf = handle_table_get(drv->htab, surface);
 
-   if (!surf || !surf->buffer)
+   if (!surf || !surf->buffer) {
+      mtx_unlock(&drv->mutex);
       return VA_STATUS_ERROR_INVALID_SURFACE;
+   }
 
-   if (surf->buffer->interlaced)
-     return VA_STATUS_ERROR_OPERATION_FAILED;
+   /* Fields are separate layers of the planes, so weave them once into a
+    * progressive buffer, which is then kept for later use of the surface.
+    */
+   status = vlVaSurfaceToProgressive(drv, surf);
+   if (status != VA_STATUS_SUCCESS) {
+      mtx_unlock(&drv->mutex);
+      return status;
+   }
 
    surfaces = surf->buffer->get_surfaces(surf->buffer);
-   if (!surfaces || !surfaces[0]->texture)
+   if (!surfaces || !surfaces[0]->texture) {
+      mtx_unlock(&drv->mutex);
       return VA_STATUS_ERROR_ALLOCATION_FAILED;
+   }
 
    img = CALLOC(1, sizeof(VAImage));
-   if (!img)
+   if (!img) {
+      mtx_unlock(&drv->mutex);
       return VA_STATUS_ERROR_ALLOCATION_FAILED;
+   }
 
    img->format.fourcc = PipeFormatToVaFourcc(surf->buffer->buffer_format);
    img->buf = VA_INVALID_ID;
@@ -250,7 +323,6 @@ vlVaDeriveImage(VADriverContextP ctx, VASurfaceID surface, VAImage *image)
       }
    }
 
-   mtx_lock(&drv->mutex);
    if (screen->resource_get_info) {
       screen->resource_get_info(screen, surfaces[0]->texture, &stride,
                                 &offset);
@@ -273,6 +345,18 @@ vlVaDeriveImage(VADriverContextP ctx, VASurfaceID surface, VAImage *image)
       assert(img->pitches[0] >= (w * 4));
       break;
 
+   case VA_FOURCC('N','V','1','2'):
+   case VA_FOURCC('P','0','1','0'):
+   case VA_FOURCC('P','0','1','6'):
+      if (!vlVaDerivePlanes(drv, surfaces, 2, img)) {
+         /* The planes can't be mapped as one buffer, vaGetImage or
+            vlVaExportSurfaceHandle have to be used instead. */
+         FREE(img);
+         mtx_unlock(&drv->mutex);
+         return VA_STATUS_ERROR_OPERATION_FAILED;
+      }
+      break;
+
    default:
       /* VaDeriveImage only supports contiguous planes. But there is now a
          more generic api vlVaExportSurfaceHandle. */
@@ -281,9 +365,11 @@ vlVaDeriveImage(VADriverContextP ctx, VASurfaceID surface, VAImage *image)
       return VA_STATUS_ERROR_OPERATION_FAILED;
    }
 
-   img->num_planes = 1;
-   img->offsets[0] = offset;
-   img->data_size  = img->pitches[0] * h;
+   if (img->num_planes == 0) {
+      img->num_planes = 1;
+      img->offsets[0] = offset;
+      img->data_size  = img->pitches[0] * h;
+   }
 
    img_buf = CALLOC(1, sizeof(vlVaBuffer));
    if (!img_buf) {
@@ -793,8 +793,6 @@ vlVaCreateSurfaces2(VADriverContextP ctx, unsigned int format,
          goto no_res;
       }
 
-      surf->templat = templat;
-
       switch (memory_type) {
       case VA_SURFACE_ATTRIB_MEM_TYPE_VA:
          /* The application will clear the TILING flag when the surface is
@@ -805,12 +803,18 @@ vlVaCreateSurfaces2(VADriverContextP ctx, unsigned int format,
              !(memory_attribute->flags & VA_SURFACE_EXTBUF_DESC_ENABLE_TILING))
             templat.bind = PIPE_BIND_LINEAR | PIPE_BIND_SHARED;
 
+         /* Keep the bind flags, so that reallocating the buffer (interlaced
+          * to progressive) doesn't lose the linear layout.
+          */
+         surf->templat = templat;
+
 	 vaStatus = vlVaHandleSurfaceAllocate(drv, surf, &templat);
          if (vaStatus != VA_STATUS_SUCCESS)
             goto free_surf;
          break;
 
       case VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME:
+         surf->templat = templat;
          vaStatus = surface_from_external_memory(ctx, surf, memory_attribute, i, &templat);
          if (vaStatus != VA_STATUS_SUCCESS)
             goto free_surf;
@@ -968,6 +972,42 @@ vlVaQueryVideoProcPipelineCaps(VADriverContextP ctx, VAContextID context,
    return VA_STATUS_SUCCESS;
 }
 
+/**
+ * Replace an interlaced surface buffer by a progressive one with the same
+ * content, so that its planes can be handed out as plain 2D images.
+ * Must be called with the driver mutex held.
+ */
+VAStatus
+vlVaSurfaceToProgressive(vlVaDriver *drv, vlVaSurface *surf)
+{
+   struct pipe_video_buffer *interlaced = surf->buffer;
+   struct u_rect src_rect, dst_rect;
+   VAStatus ret;
+
+   if (!interlaced->interlaced)
+      return VA_STATUS_SUCCESS;
+
+   surf->templat.interlaced = false;
+
+   ret = vlVaHandleSurfaceAllocate(drv, surf, &surf->templat);
+   if (ret != VA_STATUS_SUCCESS)
+      return VA_STATUS_ERROR_ALLOCATION_FAILED;
+
+   src_rect.x0 = dst_rect.x0 = 0;
+   src_rect.y0 = dst_rect.y0 = 0;
+   src_rect.x1 = dst_rect.x1 = surf->templat.width;
+   src_rect.y1 = dst_rect.y1 = surf->templat.height;
+
+   vl_compositor_yuv_deint_full(&drv->cstate, &drv->compositor,
+                                interlaced, surf->buffer,
+                                &src_rect, &dst_rect,
+                                VL_COMPOSITOR_WEAVE);
+
+   interlaced->destroy(interlaced);
+
+   return VA_STATUS_SUCCESS;
+}
+
 #if VA_CHECK_VERSION(1, 1, 0)
 VAStatus
 vlVaExportSurfaceHandle(VADriverContextP ctx,
@@ -982,14 +1022,13 @@ vlVaExportSurfaceHandle(VADriverContextP ctx,
    struct pipe_screen *screen;
    VAStatus ret;
    unsigned int usage;
+   uint32_t composed_format = 0;
    int i, p;
 
    VADRMPRIMESurfaceDescriptor *desc = descriptor;
 
    if (mem_type != VA_SURFACE_ATTRIB_MEM_TYPE_DRM_PRIME_2)
       return VA_STATUS_ERROR_UNSUPPORTED_MEMORY_TYPE;
-   if (flags & VA_EXPORT_SURFACE_COMPOSED_LAYERS)
-      return VA_STATUS_ERROR_INVALID_SURFACE;
 
    drv    = VL_VA_DRIVER(ctx);
    screen = VL_VA_PSCREEN(ctx);
@@ -1001,29 +1040,10 @@ vlVaExportSurfaceHandle(VADriverContextP ctx,
       return VA_STATUS_ERROR_INVALID_SURFACE;
    }
 
-   if (surf->buffer->interlaced) {
-      struct pipe_video_buffer *interlaced = surf->buffer;
-      struct u_rect src_rect, dst_rect;
-
-      surf->templat.interlaced = false;
-
-      ret = vlVaHandleSurfaceAllocate(drv, surf, &surf->templat);
-      if (ret != VA_STATUS_SUCCESS) {
-         mtx_unlock(&drv->mutex);
-         return VA_STATUS_ERROR_ALLOCATION_FAILED;
-      }
-
-      src_rect.x0 = dst_rect.x0 = 0;
-      src_rect.y0 = dst_rect.y0 = 0;
-      src_rect.x1 = dst_rect.x1 = surf->templat.width;
-      src_rect.y1 = dst_rect.y1 = surf->templat.height;
-
-      vl_compositor_yuv_deint_full(&drv->cstate, &drv->compositor,
-                                   interlaced, surf->buffer,
-                                   &src_rect, &dst_rect,
-                                   VL_COMPOSITOR_WEAVE);
-
-      interlaced->destroy(interlaced);
+   ret = vlVaSurfaceToProgressive(drv, surf);
+   if (ret != VA_STATUS_SUCCESS) {
+      mtx_unlock(&drv->mutex);
+      return ret;
    }
 
    surfaces = surf->buffer->get_surfaces(surf->buffer);
@@ -1036,6 +1056,33 @@ vlVaExportSurfaceHandle(VADriverContextP ctx,
    desc->width  = surf->buffer->width;
    desc->height = surf->buffer->height;
 
+   if (flags & VA_EXPORT_SURFACE_COMPOSED_LAYERS) {
+      /* All planes go into a single layer described by the fourcc of the
+       * whole image.
+       */
+      switch (desc->fourcc) {
+      case VA_FOURCC('N','V','1','2'):
+         composed_format = DRM_FORMAT_NV12;
+         break;
+      case VA_FOURCC('P','0','1','0'):
+         composed_format = DRM_FORMAT_P010;
+         break;
+      case VA_FOURCC('P','0','1','6'):
+         composed_format = DRM_FORMAT_P016;
+         break;
+      case VA_FOURCC('I','4','2','0'):
+         composed_format = DRM_FORMAT_YUV420;
+         break;
+      case VA_FOURCC('Y','V','1','2'):
+         composed_format = DRM_FORMAT_YVU420;
+         break;
+      default:
+         /* single plane formats, the layer format is the plane format */
+         composed_format = 0;
+         break;
+      }
+   }
+
    for (p = 0; p < VL_MAX_SURFACES; p++) {
       struct winsys_handle whandle;
       struct pipe_resource *resource;
@@ -1059,6 +1106,12 @@ vlVaExportSurfaceHandle(VADriverContextP ctx,
       case PIPE_FORMAT_R16G16_UNORM:
          drm_format = DRM_FORMAT_GR1616;
          break;
+      case PIPE_FORMAT_R8G8_R8B8_UNORM:
+         drm_format = DRM_FORMAT_YUYV;
+         break;
+      case PIPE_FORMAT_G8R8_B8R8_UNORM:
+         drm_format = DRM_FORMAT_UYVY;
+         break;
       case PIPE_FORMAT_B8G8R8A8_UNORM:
          drm_format = DRM_FORMAT_ARGB8888;
          break;
@@ -1089,15 +1142,24 @@ vlVaExportSurfaceHandle(VADriverContextP ctx,
       desc->objects[p].size = 0;
       desc->objects[p].drm_format_modifier = whandle.modifier;
 
-      desc->layers[p].drm_format      = drm_format;
-      desc->layers[p].num_planes      = 1;
-      desc->layers[p].object_index[0] = p;
-      desc->layers[p].offset[0]       = whandle.offset;
-      desc->layers[p].pitch[0]        = whandle.stride;
+      if (flags & VA_EXPORT_SURFACE_COMPOSED_LAYERS) {
+         desc->layers[0].drm_format      = composed_format ? composed_format :
+                                                             drm_format;
+         desc->layers[0].num_planes      = p + 1;
+         desc->layers[0].object_index[p] = p;
+         desc->layers[0].offset[p]       = whandle.offset;
+         desc->layers[0].pitch[p]        = whandle.stride;
+      } else {
+         desc->layers[p].drm_format      = drm_format;
+         desc->layers[p].num_planes      = 1;
+         desc->layers[p].object_index[0] = p;
+         desc->layers[p].offset[0]       = whandle.offset;
+         desc->layers[p].pitch[0]        = whandle.stride;
+      }
    }
 
    desc->num_objects = p;
-   desc->num_layers  = p;
+   desc->num_layers  = flags & VA_EXPORT_SURFACE_COMPOSED_LAYERS ? 1 : p;
 
    mtx_unlock(&drv->mutex);
 
@@ -250,25 +250,23 @@ xa_composite_check_accelerated(const struct xa_composite *comp)
 }
 
 static int
-bind_composite_blend_state(struct xa_context *ctx,
-			   const struct xa_composite *comp)
+composite_blend_state(const struct xa_composite *comp,
+		      struct pipe_blend_state *blend)
 {
     struct xa_composite_blend blend_opt;
-    struct pipe_blend_state blend;
 
     if (!blend_for_op(&blend_opt, comp->op, comp->src, comp->mask, comp->dst))
 	return -XA_ERR_INVAL;
 
-    memset(&blend, 0, sizeof(struct pipe_blend_state));
-    blend.rt[0].blend_enable = 1;
-    blend.rt[0].colormask = PIPE_MASK_RGBA;
+    memset(blend, 0, sizeof(struct pipe_blend_state));
+    blend->rt[0].blend_enable = 1;
+    blend->rt[0].colormask = PIPE_MASK_RGBA;
 
-    blend.rt[0].rgb_src_factor   = blend_opt.rgb_src;
-    blend.rt[0].alpha_src_factor = blend_opt.rgb_src;
-    blend.rt[0].rgb_dst_factor   = blend_opt.rgb_dst;
-    blend.rt[0].alpha_dst_factor = blend_opt.rgb_dst;
+    blend->rt[0].rgb_src_factor   = blend_opt.rgb_src;
+    blend->rt[0].alpha_src_factor = blend_opt.rgb_src;
+    blend->rt[0].rgb_dst_factor   = blend_opt.rgb_dst;
+    blend->rt[0].alpha_dst_factor = blend_opt.rgb_dst;
 
-    cso_set_blend(ctx->cso, &blend);
     return XA_ERR_NONE;
 }
 
@@ -376,10 +374,11 @@ xa_handle_src_pict(struct xa_context *ctx,
 }
 
 static int
-bind_shaders(struct xa_context *ctx, const struct xa_composite *comp)
+composite_shader_traits(struct xa_context *ctx,
+			const struct xa_composite *comp,
+			struct xa_composite_state *state)
 {
     unsigned vs_traits = 0, fs_traits = 0;
-    struct xa_shader shader;
     struct xa_picture *src_pic = comp->src;
     struct xa_picture *mask_pic = comp->mask;
     struct xa_picture *dst_pic = comp->dst;
@@ -436,77 +435,123 @@ bind_shaders(struct xa_context *ctx, const struct xa_composite *comp)
         ctx->srf->format == PIPE_FORMAT_R8_UNORM)
 	fs_traits |= FS_DST_LUMINANCE;
 
-    shader = xa_shaders_get(ctx->shaders, vs_traits, fs_traits);
-    cso_set_vertex_shader_handle(ctx->cso, shader.vs);
-    cso_set_fragment_shader_handle(ctx->cso, shader.fs);
+    state->vs_traits = vs_traits;
+    state->fs_traits = fs_traits;
+    if (ctx->has_solid_src || ctx->has_solid_mask)
+	memcpy(state->solid_color, ctx->solid_color,
+	       sizeof(state->solid_color));
     return XA_ERR_NONE;
 }
 
 static void
-bind_samplers(struct xa_context *ctx,
-	      const struct xa_composite *comp)
+composite_sampler_state(struct xa_context *ctx,
+			const struct xa_composite *comp,
+			struct xa_composite_state *state)
 {
-    struct pipe_sampler_state *samplers[PIPE_MAX_SAMPLERS];
-    struct pipe_sampler_state src_sampler, mask_sampler;
-    struct pipe_sampler_view view_templ;
-    struct pipe_sampler_view *src_view;
-    struct pipe_context *pipe = ctx->pipe;
     struct xa_picture *src_pic = comp->src;
     struct xa_picture *mask_pic = comp->mask;
     int num_samplers = 0;
 
-    xa_ctx_sampler_views_destroy(ctx);
-    memset(&src_sampler, 0, sizeof(struct pipe_sampler_state));
-    memset(&mask_sampler, 0, sizeof(struct pipe_sampler_state));
-
     if (src_pic && !ctx->has_solid_src) {
+	struct pipe_sampler_state *src_sampler = &state->samplers[0];
 	unsigned src_wrap = xa_repeat_to_gallium(src_pic->wrap);
 	int filter;
 
 	(void) xa_filter_to_gallium(src_pic->filter, &filter);
 
-	src_sampler.wrap_s = src_wrap;
-	src_sampler.wrap_t = src_wrap;
-	src_sampler.min_img_filter = filter;
-	src_sampler.mag_img_filter = filter;
-	src_sampler.min_mip_filter = PIPE_TEX_MIPFILTER_NEAREST;
-	src_sampler.normalized_coords = 1;
-	samplers[0] = &src_sampler;
-	u_sampler_view_default_template(&view_templ,
-					src_pic->srf->tex,+					src_pic->srf->tex->format);
-	src_view = pipe->create_sampler_view(pipe, src_pic->srf->tex,
-					     &view_templ);
-	ctx->bound_sampler_views[0] = src_view;
+	src_sampler->wrap_s = src_wrap;
+	src_sampler->wrap_t = src_wrap;
+	src_sampler->min_img_filter = filter;
+	src_sampler->mag_img_filter = filter;
+	src_sampler->min_mip_filter = PIPE_TEX_MIPFILTER_NEAREST;
+	src_sampler->normalized_coords = 1;
+	state->tex[0] = src_pic->srf->tex;
 	num_samplers++;
     }
 
     if (mask_pic && !ctx->has_solid_mask) {
+	struct pipe_sampler_state *mask_sampler =
+	    &state->samplers[num_samplers];
         unsigned mask_wrap = xa_repeat_to_gallium(mask_pic->wrap);
 	int filter;
 
 	(void) xa_filter_to_gallium(mask_pic->filter, &filter);
 
-	mask_sampler.wrap_s = mask_wrap;
-	mask_sampler.wrap_t = mask_wrap;
-	mask_sampler.min_img_filter = filter;
-	mask_sampler.mag_img_filter = filter;
-	src_sampler.min_mip_filter = PIPE_TEX_MIPFILTER_NEAREST;
-	mask_sampler.normalized_coords = 1;
-        samplers[num_samplers] = &mask_sampler;
-	u_sampler_view_default_template(&view_templ,
-					mask_pic->srf->tex,
-					mask_pic->srf->tex->format);
-	src_view = pipe->create_sampler_view(pipe, mask_pic->srf->tex,
-					     &view_templ);
-        ctx->bound_sampler_views[num_samplers] = src_view;
+	mask_sampler->wrap_s = mask_wrap;
+	mask_sampler->wrap_t = mask_wrap;
+	mask_sampler->min_img_filter = filter;
+	mask_sampler->mag_img_filter = filter;
+	mask_sampler->normalized_coords = 1;
+	state->tex[num_samplers] = mask_pic->srf->tex;
         num_samplers++;
     }
 
-    cso_set_samplers(ctx->cso, PIPE_SHADER_FRAGMENT, num_samplers,
-		     (const struct pipe_sampler_state **)samplers);
-    cso_set_sampler_views(ctx->cso, PIPE_SHADER_FRAGMENT, num_samplers,
-				   ctx->bound_sampler_views);
-    ctx->num_bound_samplers = num_samplers;
+    state->num_samplers = num_samplers;
+}
+
+static void
+bind_samplers(struct xa_context *ctx,
+	      const struct xa_composite_state *state)
+{
+    const struct pipe_sampler_state *samplers[XA_MAX_SAMPLERS];
+    struct pipe_sampler_view view_templ;
+    struct pipe_context *pipe = ctx->pipe;
+    unsigned i;
+
+    xa_ctx_sampler_views_destroy(ctx);
+
+    for (i = 0; i < state->num_samplers; i++) {
+	struct pipe_resource *tex = state->tex[i];
+
+	u_sampler_view_default_template(&view_templ, tex, tex->format);
+	ctx->bound_sampler_views[i] =
+	    pipe->create_sampler_view(pipe, tex, &view_templ);
+	samplers[i] = &state->samplers[i];
+    }
+
+    cso_set_samplers(ctx->cso, PIPE_SHADER_FRAGMENT, state->num_samplers,
+		     samplers);
+    cso_set_sampler_views(ctx->cso, PIPE_SHADER_FRAGMENT,
+			  state->num_samplers, ctx->bound_sampler_views);
+    ctx->num_bound_samplers = state->num_samplers;
+}
+
+/*
+ * Whether the operation can add its rectangles to the vertices of the
+ * previous one.  Not if it samples the destination, since it may read
+ * what the previous operation draws.
+ */
+static boolean
+composite_can_batch(const struct xa_context *ctx,
+		    const struct xa_composite_state *state)
+{
+    unsigned i;
+
+    if (!ctx->comp_pending ||
+	memcmp(&ctx->comp_state, state, sizeof(*state)) != 0)
+	return FALSE;
+
+    for (i = 0; i < state->num_samplers; i++) {
+	if (state->tex[i] == state->srf->texture)
+	    return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Draw what is left of the composite operations and forget their state,
+ * before something else binds its own.
+ */
+void
+xa_composite_batch_flush(struct xa_context *ctx)
+{
+    if (!ctx->comp_pending)
+	return;
+
+    renderer_draw_flush(ctx);
+    xa_ctx_sampler_views_destroy(ctx);
+    ctx->comp_pending = FALSE;
 }
 
 XA_EXPORT int
@@ -514,22 +559,41 @@ xa_composite_prepare(struct xa_context *ctx,
 		     const struct xa_composite *comp)
 {
     struct xa_surface *dst_srf = comp->dst->srf;
+    struct xa_composite_state state;
+    struct xa_shader shader;
     int ret;
 
     ret = xa_ctx_srf_create(ctx, dst_srf);
     if (ret != XA_ERR_NONE)
 	return ret;
 
-    ctx->dst = dst_srf;
-    renderer_bind_destination(ctx, ctx->srf);
+    memset(&state, 0, sizeof(state));
+    state.srf = ctx->srf;
 
-    ret = bind_composite_blend_state(ctx, comp);
+    ret = composite_blend_state(comp, &state.blend);
     if (ret != XA_ERR_NONE)
 	return ret;
-    ret = bind_shaders(ctx, comp);
+    ret = composite_shader_traits(ctx, comp, &state);
     if (ret != XA_ERR_NONE)
 	return ret;
-    bind_samplers(ctx, comp);
+    composite_sampler_state(ctx, comp, &state);
+
+    if (composite_can_batch(ctx, &state)) {
+	ctx->dst = dst_srf;
+	ctx->comp = comp;
+	return XA_ERR_NONE;
+    }
+
+    xa_composite_batch_flush(ctx);
+
+    ctx->dst = dst_srf;
+    renderer_bind_destination(ctx, ctx->srf);
+
+    cso_set_blend(ctx->cso, &state.blend);
+    shader = xa_shaders_get(ctx->shaders, state.vs_traits, state.fs_traits);
+    cso_set_vertex_shader_handle(ctx->cso, shader.vs);
+    cso_set_fragment_shader_handle(ctx->cso, shader.fs);
+    bind_samplers(ctx, &state);
 
     if (ctx->num_bound_samplers == 0 ) { /* solid fill */
 	renderer_begin_solid(ctx);
@@ -538,6 +602,9 @@ xa_composite_prepare(struct xa_context *ctx,
 	ctx->comp = comp;
     }
 
+    ctx->comp_state = state;
+    ctx->comp_pending = TRUE;
+
     xa_ctx_srf_destroy(ctx);
     return XA_ERR_NONE;
 }
@@ -571,12 +638,12 @@ xa_composite_rect(struct xa_context *ctx,
 XA_EXPORT void
 xa_composite_done(struct xa_context *ctx)
 {
-    renderer_draw_flush(ctx);
-
+    /* The vertices are drawn when an operation with different state
+     * comes along, or on flush.
+     */
     ctx->comp = NULL;
     ctx->has_solid_src = FALSE;
     ctx->has_solid_mask = FALSE;
-    xa_ctx_sampler_views_destroy(ctx);
 }
 
 static const struct xa_composite_allocation a = {
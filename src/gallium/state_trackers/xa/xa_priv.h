@@ -46,7 +46,7 @@
 #define XA_EXPORT
 #endif
 
-#define XA_VB_SIZE (100 * 4 * 3 * 4)
+#define XA_VB_SIZE (512 * 4 * 3 * 4)
 #define XA_LAST_SURFACE_TYPE (xa_type_yuv_component + 1)
 #define XA_MAX_SAMPLERS 3
 
@@ -79,6 +79,22 @@ struct xa_tracker {
     struct xa_context *default_ctx;
 };
 
+/*
+ * The state a composite operation binds.  Operations with the same state
+ * as the one whose vertices are still in the buffer add to the buffer
+ * instead of drawing it and binding everything again.
+ */
+struct xa_composite_state {
+    struct pipe_surface *srf;
+    struct pipe_blend_state blend;
+    unsigned vs_traits;
+    unsigned fs_traits;
+    unsigned num_samplers;
+    struct pipe_resource *tex[XA_MAX_SAMPLERS];
+    struct pipe_sampler_state samplers[XA_MAX_SAMPLERS];
+    float solid_color[4];
+};
+
 struct xa_context {
     struct xa_tracker *xa;
     struct pipe_context *pipe;
@@ -120,6 +136,10 @@ struct xa_context {
     unsigned int num_bound_samplers;
     struct pipe_sampler_view *bound_sampler_views[XA_MAX_SAMPLERS];
     const struct xa_composite *comp;
+
+    /* Composite state bound, and possibly vertices not drawn yet. */
+    struct xa_composite_state comp_state;
+    int comp_pending;
 };
 
 static inline void
@@ -224,6 +244,12 @@ void xa_shaders_destroy(struct xa_shaders *shaders);
 struct xa_shader xa_shaders_get(struct xa_shaders *shaders,
 				unsigned vs_traits, unsigned fs_traits);
 
+/*
+ * xa_composite.c
+ */
+void
+xa_composite_batch_flush(struct xa_context *ctx);
+
 /*
  * xa_context.c
  */
@@ -504,6 +504,9 @@ xa_surface_redefine(struct xa_surface *srf,
     if (copy_contents) {
 	struct pipe_context *pipe = xa->default_ctx->pipe;
 
+	/* Draw pending composite operations to the old texture first. */
+	renderer_draw_flush(xa->default_ctx);
+
 	u_box_origin_2d(xa_min(save_width, template->width0),
 			xa_min(save_height, template->height0), &src_box);
 	pipe->resource_copy_region(pipe, texture,
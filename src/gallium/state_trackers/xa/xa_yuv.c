@@ -127,6 +127,8 @@ xa_yuv_planar_blit(struct xa_context *r,
     if (dst_w == 0 || dst_h == 0)
 	return XA_ERR_NONE;
 
+    xa_composite_batch_flush(r);
+
     ret = xa_ctx_srf_create(r, dst);
     if (ret != XA_ERR_NONE)
 	return -XA_ERR_NORES;
@@ -0,0 +1,558 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ * CPU overhead benchmark for gallium drivers.
+ *
+ * Measures how many tiny draws per second the driver accepts while one
+ * piece of state changes between draws, and the throughput of buffer and
+ * texture uploads.  Everything goes straight to the pipe_context, without
+ * a state tracker or cso_context in between, so the numbers only reflect
+ * the driver (and the gallium auxiliary code it uses).
+ *
+ * Results are printed as CSV on stdout:
+ *
+ *    test,count,seconds,rate,unit
+ *
+ * Usage: drawoverhead [-t seconds] [test...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pipe/p_context.h"
+#include "pipe/p_defines.h"
+#include "pipe/p_screen.h"
+#include "pipe/p_shader_tokens.h"
+#include "pipe/p_state.h"
+#include "pipe-loader/pipe_loader.h"
+#include "tgsi/tgsi_text.h"
+#include "util/os_time.h"
+#include "util/u_box.h"
+#include "util/u_inlines.h"
+#include "util/u_memory.h"
+#include "util/u_sampler.h"
+#include "util/u_simple_shaders.h"
+
+#define FB_SIZE 64
+#define TEX_SIZE 256
+#define UPLOAD_SIZE (64 * 1024)
+
+/* How many iterations run between two looks at the clock */
+#define BATCH 64
+
+struct bench
+{
+   struct pipe_loader_device *dev;
+   struct pipe_screen *screen;
+   struct pipe_context *pipe;
+
+   void *blend;
+   void *dsa;
+   void *rast;
+   void *velems;
+   void *sampler;
+   void *vs;
+   void *fs[2];
+
+   struct pipe_resource *target;
+   struct pipe_surface *surf;
+   struct pipe_resource *vbuf[2];
+   struct pipe_resource *tex[2];
+   struct pipe_sampler_view *view[2];
+   struct pipe_resource *upload_buf;
+   struct pipe_resource *upload_tex;
+
+   float constants[2][4];
+   uint8_t *upload_data;
+};
+
+struct test
+{
+   const char *name;
+   /* Called before every draw, or instead of it if draw is false */
+   void (*run)(struct bench *b, unsigned i);
+   bool draw;
+   /* Bytes moved per iteration, the rate is then given in MB/s */
+   unsigned bytes;
+};
+
+static const char fs_text[2][512] = {
+   "FRAG\n"
+   "DCL IN[0], GENERIC[0], LINEAR\n"
+   "DCL OUT[0], COLOR\n"
+   "DCL SAMP[0]\n"
+   "DCL SVIEW[0], 2D, FLOAT\n"
+   "DCL CONST[0][0]\n"
+   "DCL TEMP[0]\n"
+   "TEX TEMP[0], IN[0], SAMP[0], 2D\n"
+   "MUL OUT[0], TEMP[0], CONST[0][0]\n"
+   "END\n",
+
+   "FRAG\n"
+   "DCL IN[0], GENERIC[0], LINEAR\n"
+   "DCL OUT[0], COLOR\n"
+   "DCL SAMP[0]\n"
+   "DCL SVIEW[0], 2D, FLOAT\n"
+   "DCL CONST[0][0]\n"
+   "DCL TEMP[0]\n"
+   "TEX TEMP[0], IN[0], SAMP[0], 2D\n"
+   "ADD OUT[0], TEMP[0], CONST[0][0]\n"
+   "END\n",
+};
+
+static void *
+create_fs(struct pipe_context *pipe, const char *text)
+{
+   struct tgsi_token tokens[1000];
+   struct pipe_shader_state state;
+
+   if (!tgsi_text_translate(text, tokens, ARRAY_SIZE(tokens))) {
+      fprintf(stderr, "drawoverhead: can't compile shader\n");
+      exit(1);
+   }
+   pipe_shader_state_from_tgsi(&state, tokens);
+   return pipe->create_fs_state(pipe, &state);
+}
+
+static struct pipe_resource *
+create_texture(struct pipe_screen *screen, unsigned size, unsigned bind)
+{
+   struct pipe_resource templ;
+
+   memset(&templ, 0, sizeof(templ));
+   templ.target = PIPE_TEXTURE_2D;
+   templ.format = PIPE_FORMAT_B8G8R8A8_UNORM; /* All drivers support this */
+   templ.width0 = size;
+   templ.height0 = size;
+   templ.depth0 = 1;
+   templ.array_size = 1;
+   templ.bind = bind;
+
+   return screen->resource_create(screen, &templ);
+}
+
+static void
+init_bench(struct bench *b)
+{
+   struct pipe_context *pipe;
+   unsigned i;
+
+   if (!pipe_loader_probe(&b->dev, 1)) {
+      fprintf(stderr, "drawoverhead: no device found\n");
+      exit(1);
+   }
+   b->screen = pipe_loader_create_screen(b->dev);
+   if (!b->screen) {
+      fprintf(stderr, "drawoverhead: can't create the screen\n");
+      exit(1);
+   }
+   b->pipe = pipe = b->screen->context_create(b->screen, NULL, 0);
+   if (!pipe) {
+      fprintf(stderr, "drawoverhead: can't create the context\n");
+      exit(1);
+   }
+
+   /* render target */
+   {
+      struct pipe_surface surf_tmpl;
+      struct pipe_framebuffer_state fb;
+
+      b->target = create_texture(b->screen, FB_SIZE, PIPE_BIND_RENDER_TARGET);
+
+      memset(&surf_tmpl, 0, sizeof(surf_tmpl));
+      surf_tmpl.format = b->target->format;
+      b->surf = pipe->create_surface(pipe, b->target, &surf_tmpl);
+
+      memset(&fb, 0, sizeof(fb));
+      fb.width = FB_SIZE;
+      fb.height = FB_SIZE;
+      fb.nr_cbufs = 1;
+      fb.cbufs[0] = b->surf;
+      pipe->set_framebuffer_state(pipe, &fb);
+   }
+
+   /* fixed function state */
+   {
+      struct pipe_blend_state blend;
+      struct pipe_depth_stencil_alpha_state dsa;
+      struct pipe_rasterizer_state rast;
+      struct pipe_sampler_state sampler;
+      struct pipe_viewport_state viewport;
+
+      memset(&blend, 0, sizeof(blend));
+      blend.rt[0].colormask = PIPE_MASK_RGBA;
+      b->blend = pipe->create_blend_state(pipe, &blend);
+      pipe->bind_blend_state(pipe, b->blend);
+
+      memset(&dsa, 0, sizeof(dsa));
+      b->dsa = pipe->create_depth_stencil_alpha_state(pipe, &dsa);
+      pipe->bind_depth_stencil_alpha_state(pipe, b->dsa);
+
+      memset(&rast, 0, sizeof(rast));
+      rast.cull_face = PIPE_FACE_NONE;
+      rast.half_pixel_center = 1;
+      rast.bottom_edge_rule = 1;
+      rast.depth_clip_near = 1;
+      rast.depth_clip_far = 1;
+      b->rast = pipe->create_rasterizer_state(pipe, &rast);
+      pipe->bind_rasterizer_state(pipe, b->rast);
+
+      memset(&sampler, 0, sizeof(sampler));
+      sampler.wrap_s = PIPE_TEX_WRAP_CLAMP_TO_EDGE;
+      sampler.wrap_t = PIPE_TEX_WRAP_CLAMP_TO_EDGE;
+      sampler.wrap_r = PIPE_TEX_WRAP_CLAMP_TO_EDGE;
+      sampler.min_mip_filter = PIPE_TEX_MIPFILTER_NONE;
+      sampler.min_img_filter = PIPE_TEX_FILTER_NEAREST;
+      sampler.mag_img_filter = PIPE_TEX_FILTER_NEAREST;
+      sampler.normalized_coords = 1;
+      b->sampler = pipe->create_sampler_state(pipe, &sampler);
+      pipe->bind_sampler_states(pipe, PIPE_SHADER_FRAGMENT, 0, 1,
+                                &b->sampler);
+
+      memset(&viewport, 0, sizeof(viewport));
+      viewport.scale[0] = FB_SIZE / 2.0f;
+      viewport.scale[1] = FB_SIZE / 2.0f;
+      viewport.scale[2] = 0.5f;
+      viewport.translate[0] = FB_SIZE / 2.0f;
+      viewport.translate[1] = FB_SIZE / 2.0f;
+      viewport.translate[2] = 0.5f;
+      pipe->set_viewport_states(pipe, 0, 1, &viewport);
+   }
+
+   /* vertices, a triangle covering a handful of pixels */
+   {
+      struct pipe_vertex_element velem[2];
+      static const float vertices[2][3][2][4] = {
+         {
+            { { -0.9f, -0.9f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } },
+            { { -0.8f, -0.9f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+            { { -0.9f, -0.8f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+         },
+         {
+            { {  0.8f,  0.8f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } },
+            { {  0.9f,  0.8f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+            { {  0.8f,  0.9f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+         },
+      };
+
+      for (i = 0; i < 2; i++) {
+         b->vbuf[i] = pipe_buffer_create(b->screen, PIPE_BIND_VERTEX_BUFFER,
+                                         PIPE_USAGE_DEFAULT,
+                                         sizeof(vertices[i]));
+         pipe_buffer_write(pipe, b->vbuf[i], 0, sizeof(vertices[i]),
+                           vertices[i]);
+      }
+
+      memset(velem, 0, sizeof(velem));
+      velem[0].src_offset = 0;
+      velem[0].src_format = PIPE_FORMAT_R32G32B32A32_FLOAT;
+      velem[1].src_offset = 4 * sizeof(float);
+      velem[1].src_format = PIPE_FORMAT_R32G32B32A32_FLOAT;
+      b->velems = pipe->create_vertex_elements_state(pipe, 2, velem);
+      pipe->bind_vertex_elements_state(pipe, b->velems);
+   }
+
+   /* shaders */
+   {
+      const enum tgsi_semantic semantic_names[] =
+         { TGSI_SEMANTIC_POSITION, TGSI_SEMANTIC_GENERIC };
+      const uint semantic_indexes[] = { 0, 0 };
+
+      b->vs = util_make_vertex_passthrough_shader(pipe, 2, semantic_names,
+                                                  semantic_indexes, FALSE);
+      pipe->bind_vs_state(pipe, b->vs);
+
+      for (i = 0; i < 2; i++)
+         b->fs[i] = create_fs(pipe, fs_text[i]);
+      pipe->bind_fs_state(pipe, b->fs[0]);
+   }
+
+   /* textures */
+   b->upload_data = CALLOC(1, MAX2(UPLOAD_SIZE, TEX_SIZE * TEX_SIZE * 4));
+   for (i = 0; i < 2; i++) {
+      struct pipe_sampler_view view_tmpl;
+      struct pipe_box box;
+
+      b->tex[i] = create_texture(b->screen, 4, PIPE_BIND_SAMPLER_VIEW);
+      u_box_origin_2d(4, 4, &box);
+      memset(b->upload_data, i ? 0xff : 0x80, 4 * 4 * 4);
+      pipe->texture_subdata(pipe, b->tex[i], 0, PIPE_TRANSFER_WRITE, &box,
+                            b->upload_data, 4 * 4, 0);
+
+      u_sampler_view_default_template(&view_tmpl, b->tex[i],
+                                      b->tex[i]->format);
+      b->view[i] = pipe->create_sampler_view(pipe, b->tex[i], &view_tmpl);
+   }
+   pipe->set_sampler_views(pipe, PIPE_SHADER_FRAGMENT, 0, 1, &b->view[0]);
+
+   /* constants */
+   for (i = 0; i < 4; i++) {
+      b->constants[0][i] = 0.5f;
+      b->constants[1][i] = 0.25f;
+   }
+
+   /* upload targets */
+   b->upload_buf = pipe_buffer_create(b->screen, PIPE_BIND_VERTEX_BUFFER,
+                                      PIPE_USAGE_STREAM, UPLOAD_SIZE);
+   b->upload_tex = create_texture(b->screen, TEX_SIZE,
+                                  PIPE_BIND_SAMPLER_VIEW);
+}
+
+static void
+close_bench(struct bench *b)
+{
+   struct pipe_context *pipe = b->pipe;
+   unsigned i;
+
+   for (i = 0; i < 2; i++) {
+      pipe_sampler_view_reference(&b->view[i], NULL);
+      pipe_resource_reference(&b->tex[i], NULL);
+      pipe_resource_reference(&b->vbuf[i], NULL);
+      pipe->delete_fs_state(pipe, b->fs[i]);
+   }
+   pipe->delete_vs_state(pipe, b->vs);
+   pipe->delete_vertex_elements_state(pipe, b->velems);
+   pipe->delete_sampler_state(pipe, b->sampler);
+   pipe->delete_rasterizer_state(pipe, b->rast);
+   pipe->delete_depth_stencil_alpha_state(pipe, b->dsa);
+   pipe->delete_blend_state(pipe, b->blend);
+
+   pipe_resource_reference(&b->upload_buf, NULL);
+   pipe_resource_reference(&b->upload_tex, NULL);
+   pipe_surface_reference(&b->surf, NULL);
+   pipe_resource_reference(&b->target, NULL);
+   FREE(b->upload_data);
+
+   pipe->destroy(pipe);
+   b->screen->destroy(b->screen);
+   pipe_loader_release(&b->dev, 1);
+}
+
+static void
+set_vertex_buffer(struct bench *b, unsigned i)
+{
+   struct pipe_vertex_buffer vb;
+
+   memset(&vb, 0, sizeof(vb));
+   vb.stride = 2 * 4 * sizeof(float);
+   vb.buffer.resource = b->vbuf[i & 1];
+   b->pipe->set_vertex_buffers(b->pipe, 0, 1, &vb);
+}
+
+static void
+set_texture(struct bench *b, unsigned i)
+{
+   b->pipe->set_sampler_views(b->pipe, PIPE_SHADER_FRAGMENT, 0, 1,
+                              &b->view[i & 1]);
+}
+
+static void
+set_shader(struct bench *b, unsigned i)
+{
+   b->pipe->bind_fs_state(b->pipe, b->fs[i & 1]);
+}
+
+static void
+set_uniforms(struct bench *b, unsigned i)
+{
+   struct pipe_constant_buffer cb;
+
+   memset(&cb, 0, sizeof(cb));
+   cb.buffer_size = sizeof(b->constants[0]);
+   cb.user_buffer = b->constants[i & 1];
+   b->pipe->set_constant_buffer(b->pipe, PIPE_SHADER_FRAGMENT, 0, &cb);
+}
+
+static void
+set_nothing(struct bench *b, unsigned i)
+{
+}
+
+static void
+set_all(struct bench *b, unsigned i)
+{
+   set_vertex_buffer(b, i);
+   set_texture(b, i);
+   set_shader(b, i);
+   set_uniforms(b, i);
+}
+
+static void
+map_buffer(struct bench *b, unsigned i)
+{
+   struct pipe_transfer *transfer;
+   void *map;
+
+   map = pipe_buffer_map(b->pipe, b->upload_buf,
+                         PIPE_TRANSFER_WRITE |
+                         PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE, &transfer);
+   memcpy(map, b->upload_data, UPLOAD_SIZE);
+   pipe_buffer_unmap(b->pipe, transfer);
+}
+
+static void
+buffer_subdata(struct bench *b, unsigned i)
+{
+   b->pipe->buffer_subdata(b->pipe, b->upload_buf,
+                           PIPE_TRANSFER_WRITE |
+                           PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE,
+                           0, UPLOAD_SIZE, b->upload_data);
+}
+
+static void
+texture_subdata(struct bench *b, unsigned i)
+{
+   struct pipe_box box;
+
+   u_box_origin_2d(TEX_SIZE, TEX_SIZE, &box);
+   b->pipe->texture_subdata(b->pipe, b->upload_tex, 0,
+                            PIPE_TRANSFER_WRITE |
+                            PIPE_TRANSFER_DISCARD_WHOLE_RESOURCE,
+                            &box, b->upload_data, TEX_SIZE * 4, 0);
+}
+
+static const struct test tests[] = {
+   { "draw",            set_nothing,       true,  0 },
+   { "vertex_buffer",   set_vertex_buffer, true,  0 },
+   { "texture",         set_texture,       true,  0 },
+   { "shader",          set_shader,        true,  0 },
+   { "uniform",         set_uniforms,      true,  0 },
+   { "all_state",       set_all,           true,  0 },
+   { "buffer_map",      map_buffer,        false, UPLOAD_SIZE },
+   { "buffer_subdata",  buffer_subdata,    false, UPLOAD_SIZE },
+   { "texture_subdata", texture_subdata,   false, TEX_SIZE * TEX_SIZE * 4 },
+};
+
+/* Put back the state the state change tests toggle */
+static void
+reset_state(struct bench *b)
+{
+   set_all(b, 0);
+}
+
+static void
+run_test(struct bench *b, const struct test *test, double seconds)
+{
+   struct pipe_context *pipe = b->pipe;
+   struct pipe_screen *screen = b->screen;
+   struct pipe_fence_handle *fence = NULL;
+   struct pipe_draw_info info;
+   union pipe_color_union color = { .f = { 0, 0, 0, 1 } };
+   int64_t start, end, duration = seconds * 1000000000.0;
+   unsigned count = 0, i;
+   double elapsed;
+
+   memset(&info, 0, sizeof(info));
+   info.mode = PIPE_PRIM_TRIANGLES;
+   info.count = 3;
+   info.instance_count = 1;
+   info.max_index = 2;
+
+   reset_state(b);
+   pipe->clear(pipe, PIPE_CLEAR_COLOR, &color, 0, 0);
+   pipe->flush(pipe, &fence, 0);
+   screen->fence_finish(screen, NULL, fence, PIPE_TIMEOUT_INFINITE);
+
+   start = os_time_get_nano();
+   do {
+      for (i = 0; i < BATCH; i++, count++) {
+         test->run(b, count);
+         if (test->draw)
+            pipe->draw_vbo(pipe, &info);
+      }
+   } while (os_time_get_nano() - start < duration);
+
+   /* Work the driver deferred is part of the cost */
+   pipe->flush(pipe, &fence, 0);
+   screen->fence_finish(screen, NULL, fence, PIPE_TIMEOUT_INFINITE);
+   end = os_time_get_nano();
+   screen->fence_reference(screen, &fence, NULL);
+
+   elapsed = (end - start) / 1000000000.0;
+   if (test->bytes) {
+      printf("%s,%u,%.3f,%.1f,MB/s\n", test->name, count, elapsed,
+             (double)count * test->bytes / (1024 * 1024) / elapsed);
+   } else {
+      printf("%s,%u,%.3f,%.0f,draws/s\n", test->name, count, elapsed,
+             count / elapsed);
+   }
+   fflush(stdout);
+}
+
+static void
+usage(void)
+{
+   unsigned i;
+
+   fprintf(stderr, "usage: drawoverhead [-t seconds] [test...]\n"
+                   "tests:");
+   for (i = 0; i < ARRAY_SIZE(tests); i++)
+      fprintf(stderr, " %s", tests[i].name);
+   fprintf(stderr, "\n");
+   exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+   struct bench b;
+   double seconds = 1.0;
+   bool selected[ARRAY_SIZE(tests)];
+   bool any_selected = false;
+   unsigned i;
+   int arg;
+
+   memset(selected, 0, sizeof(selected));
+   for (arg = 1; arg < argc; arg++) {
+      if (!strcmp(argv[arg], "-t")) {
+         if (++arg == argc)
+            usage();
+         seconds = atof(argv[arg]);
+         if (seconds <= 0)
+            usage();
+         continue;
+      }
+
+      for (i = 0; i < ARRAY_SIZE(tests); i++) {
+         if (!strcmp(argv[arg], tests[i].name))
+            break;
+      }
+      if (i == ARRAY_SIZE(tests))
+         usage();
+      selected[i] = any_selected = true;
+   }
+
+   memset(&b, 0, sizeof(b));
+   init_bench(&b);
+
+   printf("test,count,seconds,rate,unit\n");
+   for (i = 0; i < ARRAY_SIZE(tests); i++) {
+      if (!any_selected || selected[i])
+         run_test(&b, &tests[i], seconds);
+   }
+
+   close_bench(&b);
+   return 0;
+}
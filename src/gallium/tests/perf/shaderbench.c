@@ -0,0 +1,420 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+ * Shader compile benchmark for gallium drivers.
+ *
+ * Compiles every *.tgsi file of a directory (TGSI text, as printed by
+ * tgsi_dump or ST_DEBUG=tgsi) with the driver pipe-loader picks, from
+ * several threads at once, one pipe_context each.  Drivers which take NIR
+ * go through their usual TGSI to NIR path.
+ *
+ * For each shader, the time spent in the create_*_state hook is printed
+ * along with the statistics the driver reports through the
+ * PIPE_DEBUG_TYPE_SHADER_INFO messages shader-db uses (instruction counts,
+ * spills, ...), as CSV on stdout:
+ *
+ *    file,stage,compile_us,stats
+ *
+ * A per stage summary goes to stderr.  Drivers which only compile the
+ * shaders they report statistics for when asked to may need their
+ * shader-db debug option set, as with shader-db itself.
+ *
+ * Usage: shaderbench [-j threads] [-r repeat] directory
+ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c11/threads.h"
+#include "pipe/p_context.h"
+#include "pipe/p_defines.h"
+#include "pipe/p_screen.h"
+#include "pipe/p_shader_tokens.h"
+#include "pipe/p_state.h"
+#include "pipe-loader/pipe_loader.h"
+#include "tgsi/tgsi_parse.h"
+#include "tgsi/tgsi_text.h"
+#include "util/os_file.h"
+#include "util/os_time.h"
+#include "util/u_atomic.h"
+#include "util/u_memory.h"
+#include "util/u_string.h"
+
+#define MAX_TOKENS 65536
+#define MAX_STATS 1024
+
+struct shader
+{
+   char *name;
+   enum pipe_shader_type stage;
+   bool failed;
+   int64_t compile_ns;
+   char stats[MAX_STATS];
+};
+
+struct bench
+{
+   struct pipe_screen *screen;
+   struct shader *shaders;
+   unsigned num_shaders;
+   unsigned repeat;
+   const char *dir;
+
+   /* next shader to compile, shared by the threads */
+   unsigned next;
+};
+
+struct worker
+{
+   struct bench *bench;
+   struct pipe_context *pipe;
+   struct tgsi_token *tokens;
+
+   /* shader the driver messages are collected for */
+   struct shader *current;
+};
+
+static const char *stage_names[PIPE_SHADER_TYPES] = {
+   [PIPE_SHADER_VERTEX] = "VS",
+   [PIPE_SHADER_FRAGMENT] = "FS",
+   [PIPE_SHADER_GEOMETRY] = "GS",
+   [PIPE_SHADER_TESS_CTRL] = "TCS",
+   [PIPE_SHADER_TESS_EVAL] = "TES",
+   [PIPE_SHADER_COMPUTE] = "CS",
+};
+
+static void
+debug_message(void *data, unsigned *id, enum pipe_debug_type type,
+              const char *fmt, va_list args)
+{
+   struct worker *w = data;
+   struct shader *shader = w->current;
+   size_t len;
+
+   if (type != PIPE_DEBUG_TYPE_SHADER_INFO || !shader)
+      return;
+
+   /* several messages per shader are joined by "; " */
+   len = strlen(shader->stats);
+   if (len && len + 2 < sizeof(shader->stats)) {
+      strcpy(shader->stats + len, "; ");
+      len += 2;
+   }
+   util_vsnprintf(shader->stats + len, sizeof(shader->stats) - len, fmt, args);
+}
+
+static void *
+create_shader(struct pipe_context *pipe, enum pipe_shader_type stage,
+              const struct tgsi_token *tokens)
+{
+   struct pipe_shader_state state;
+
+   if (stage == PIPE_SHADER_COMPUTE) {
+      struct pipe_compute_state cs;
+
+      memset(&cs, 0, sizeof(cs));
+      cs.ir_type = PIPE_SHADER_IR_TGSI;
+      cs.prog = tokens;
+      return pipe->create_compute_state(pipe, &cs);
+   }
+
+   pipe_shader_state_from_tgsi(&state, tokens);
+
+   switch (stage) {
+   case PIPE_SHADER_VERTEX:
+      return pipe->create_vs_state(pipe, &state);
+   case PIPE_SHADER_FRAGMENT:
+      return pipe->create_fs_state(pipe, &state);
+   case PIPE_SHADER_GEOMETRY:
+      return pipe->create_gs_state ? pipe->create_gs_state(pipe, &state) : NULL;
+   case PIPE_SHADER_TESS_CTRL:
+      return pipe->create_tcs_state ? pipe->create_tcs_state(pipe, &state) : NULL;
+   case PIPE_SHADER_TESS_EVAL:
+      return pipe->create_tes_state ? pipe->create_tes_state(pipe, &state) : NULL;
+   default:
+      return NULL;
+   }
+}
+
+static void
+delete_shader(struct pipe_context *pipe, enum pipe_shader_type stage,
+              void *cso)
+{
+   switch (stage) {
+   case PIPE_SHADER_VERTEX:
+      pipe->delete_vs_state(pipe, cso);
+      break;
+   case PIPE_SHADER_FRAGMENT:
+      pipe->delete_fs_state(pipe, cso);
+      break;
+   case PIPE_SHADER_GEOMETRY:
+      pipe->delete_gs_state(pipe, cso);
+      break;
+   case PIPE_SHADER_TESS_CTRL:
+      pipe->delete_tcs_state(pipe, cso);
+      break;
+   case PIPE_SHADER_TESS_EVAL:
+      pipe->delete_tes_state(pipe, cso);
+      break;
+   case PIPE_SHADER_COMPUTE:
+      pipe->delete_compute_state(pipe, cso);
+      break;
+   default:
+      break;
+   }
+}
+
+static void
+compile_shader(struct worker *w, struct shader *shader)
+{
+   struct bench *b = w->bench;
+   char path[4096];
+   char *text;
+   unsigned i;
+
+   util_snprintf(path, sizeof(path), "%s/%s", b->dir, shader->name);
+   text = os_read_file(path);
+   if (!text || !tgsi_text_translate(text, w->tokens, MAX_TOKENS)) {
+      shader->failed = true;
+      free(text);
+      return;
+   }
+   free(text);
+
+   shader->stage = tgsi_get_processor_type(w->tokens);
+
+   for (i = 0; i < b->repeat; i++) {
+      int64_t start;
+      void *cso;
+
+      /* only keep the statistics of one of the runs */
+      shader->stats[0] = 0;
+      w->current = shader;
+
+      start = os_time_get_nano();
+      cso = create_shader(w->pipe, shader->stage, w->tokens);
+      shader->compile_ns += os_time_get_nano() - start;
+
+      w->current = NULL;
+
+      if (!cso) {
+         shader->failed = true;
+         return;
+      }
+      delete_shader(w->pipe, shader->stage, cso);
+   }
+}
+
+static int
+worker_thread(void *data)
+{
+   struct worker *w = data;
+   struct bench *b = w->bench;
+   unsigned i;
+
+   while ((i = p_atomic_inc_return(&b->next) - 1) < b->num_shaders)
+      compile_shader(w, &b->shaders[i]);
+
+   return 0;
+}
+
+static int
+compare_shaders(const void *a, const void *b)
+{
+   return strcmp(((const struct shader *)a)->name,
+                 ((const struct shader *)b)->name);
+}
+
+static void
+load_dir(struct bench *b)
+{
+   DIR *dir = opendir(b->dir);
+   struct dirent *entry;
+   unsigned size = 0;
+
+   if (!dir) {
+      fprintf(stderr, "shaderbench: can't open %s\n", b->dir);
+      exit(1);
+   }
+
+   while ((entry = readdir(dir))) {
+      size_t len = strlen(entry->d_name);
+
+      if (len <= 5 || strcmp(entry->d_name + len - 5, ".tgsi"))
+         continue;
+
+      if (b->num_shaders == size) {
+         size = MAX2(2 * size, 64);
+         b->shaders = realloc(b->shaders, size * sizeof(*b->shaders));
+      }
+      memset(&b->shaders[b->num_shaders], 0, sizeof(*b->shaders));
+      b->shaders[b->num_shaders++].name = strdup(entry->d_name);
+   }
+   closedir(dir);
+
+   /* keep the output comparable across runs */
+   qsort(b->shaders, b->num_shaders, sizeof(*b->shaders), compare_shaders);
+}
+
+static void
+print_csv_string(const char *s)
+{
+   putchar('"');
+   for (; *s; s++) {
+      if (*s == '"')
+         putchar('"');
+      putchar(*s == '\n' ? ' ' : *s);
+   }
+   putchar('"');
+}
+
+static void
+usage(void)
+{
+   fprintf(stderr, "usage: shaderbench [-j threads] [-r repeat] directory\n");
+   exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+   struct pipe_loader_device *dev;
+   struct bench b;
+   struct worker *workers;
+   thrd_t *threads;
+   unsigned num_threads = 1;
+   unsigned stage_count[PIPE_SHADER_TYPES] = { 0 };
+   int64_t stage_ns[PIPE_SHADER_TYPES] = { 0 };
+   unsigned failed = 0;
+   int64_t start, wall_ns;
+   unsigned i;
+   int arg;
+
+   memset(&b, 0, sizeof(b));
+   b.repeat = 1;
+
+   for (arg = 1; arg < argc; arg++) {
+      if (!strcmp(argv[arg], "-j") && arg + 1 < argc) {
+         num_threads = atoi(argv[++arg]);
+      } else if (!strcmp(argv[arg], "-r") && arg + 1 < argc) {
+         b.repeat = atoi(argv[++arg]);
+      } else if (argv[arg][0] != '-' && !b.dir) {
+         b.dir = argv[arg];
+      } else {
+         usage();
+      }
+   }
+   if (!b.dir || num_threads == 0 || b.repeat == 0)
+      usage();
+
+   load_dir(&b);
+   if (!b.num_shaders) {
+      fprintf(stderr, "shaderbench: no .tgsi files in %s\n", b.dir);
+      return 1;
+   }
+
+   if (!pipe_loader_probe(&dev, 1)) {
+      fprintf(stderr, "shaderbench: no device found\n");
+      return 1;
+   }
+   b.screen = pipe_loader_create_screen(dev);
+   if (!b.screen) {
+      fprintf(stderr, "shaderbench: can't create the screen\n");
+      return 1;
+   }
+
+   workers = CALLOC(num_threads, sizeof(*workers));
+   threads = CALLOC(num_threads, sizeof(*threads));
+
+   for (i = 0; i < num_threads; i++) {
+      /* not async: messages must arrive while the shader is current */
+      struct pipe_debug_callback cb = {
+         .async = false,
+         .debug_message = debug_message,
+         .data = &workers[i],
+      };
+
+      workers[i].bench = &b;
+      workers[i].tokens = CALLOC(MAX_TOKENS, sizeof(struct tgsi_token));
+      workers[i].pipe = b.screen->context_create(b.screen, NULL, 0);
+      if (!workers[i].pipe) {
+         fprintf(stderr, "shaderbench: can't create a context\n");
+         return 1;
+      }
+      if (workers[i].pipe->set_debug_callback)
+         workers[i].pipe->set_debug_callback(workers[i].pipe, &cb);
+   }
+
+   start = os_time_get_nano();
+   for (i = 0; i < num_threads; i++)
+      thrd_create(&threads[i], worker_thread, &workers[i]);
+   for (i = 0; i < num_threads; i++)
+      thrd_join(threads[i], NULL);
+   wall_ns = os_time_get_nano() - start;
+
+   printf("file,stage,compile_us,stats\n");
+   for (i = 0; i < b.num_shaders; i++) {
+      struct shader *shader = &b.shaders[i];
+
+      if (shader->failed) {
+         fprintf(stderr, "shaderbench: %s failed to compile\n", shader->name);
+         failed++;
+         continue;
+      }
+
+      stage_count[shader->stage]++;
+      stage_ns[shader->stage] += shader->compile_ns;
+
+      printf("%s,%s,%.1f,", shader->name, stage_names[shader->stage],
+             shader->compile_ns / 1000.0 / b.repeat);
+      print_csv_string(shader->stats);
+      printf("\n");
+   }
+
+   for (i = 0; i < PIPE_SHADER_TYPES; i++) {
+      if (stage_count[i]) {
+         fprintf(stderr, "%s: %u shaders, %.3f ms\n", stage_names[i],
+                 stage_count[i], stage_ns[i] / 1000000.0 / b.repeat);
+      }
+   }
+   fprintf(stderr, "%u shaders (%u failed), %u threads, %.3f s wall time\n",
+           b.num_shaders, failed, num_threads, wall_ns / 1000000000.0);
+
+   for (i = 0; i < num_threads; i++) {
+      workers[i].pipe->destroy(workers[i].pipe);
+      FREE(workers[i].tokens);
+   }
+   FREE(workers);
+   FREE(threads);
+   for (i = 0; i < b.num_shaders; i++)
+      free(b.shaders[i].name);
+   free(b.shaders);
+
+   b.screen->destroy(b.screen);
+   pipe_loader_release(&dev, 1);
+
+   return failed ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+/**************************************************************************
+ *
+ * Copyright 2019 VMware, Inc.
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+ * IN NO EVENT SHALL VMWARE AND/OR ITS SUPPLIERS BE LIABLE FOR
+ * ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ **************************************************************************/
+
+/*
+ * Checks that the SSE2 row kernels of the common formats (u_format_sse.c)
+ * give the same bits as the scalar code, and compares their speed.
+ */
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "util/os_time.h"
+#include "util/u_math.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_format.h"
+#include "util/u_memory.h"
+
+
+#define WIDTH 1021 /* not a multiple of four, so the scalar tail runs too */
+#define HEIGHT 64
+#define ITERATIONS 20
+
+
+enum test_func {
+   UNPACK_RGBA_FLOAT,
+   PACK_RGBA_FLOAT,
+   UNPACK_RGBA_8UNORM,
+   PACK_RGBA_8UNORM,
+};
+
+static const char *test_func_names[] = {
+   "unpack_rgba_float",
+   "pack_rgba_float",
+   "unpack_rgba_8unorm",
+   "pack_rgba_8unorm",
+};
+
+static const struct {
+   enum pipe_format format;
+   enum test_func func;
+} tests[] = {
+   { PIPE_FORMAT_R8G8B8A8_UNORM, UNPACK_RGBA_FLOAT },
+   { PIPE_FORMAT_R8G8B8A8_UNORM, PACK_RGBA_FLOAT },
+   { PIPE_FORMAT_B8G8R8A8_UNORM, UNPACK_RGBA_FLOAT },
+   { PIPE_FORMAT_B8G8R8A8_UNORM, PACK_RGBA_FLOAT },
+   { PIPE_FORMAT_B8G8R8A8_UNORM, UNPACK_RGBA_8UNORM },
+   { PIPE_FORMAT_B8G8R8A8_UNORM, PACK_RGBA_8UNORM },
+   { PIPE_FORMAT_R10G10B10A2_UNORM, UNPACK_RGBA_FLOAT },
+   { PIPE_FORMAT_R16G16B16A16_FLOAT, UNPACK_RGBA_FLOAT },
+};
+
+
+/* Floats which exercise all the clamping paths of float_to_ubyte(). */
+static const uint32_t special_floats[] = {
+   0x00000000, /* 0.0 */
+   0x80000000, /* -0.0 */
+   0x3f800000, /* 1.0 */
+   0x3f7fffff, /* largest below 1.0 */
+   0x3f000000, /* 0.5 */
+   0xbf800000, /* -1.0 */
+   0x40000000, /* 2.0 */
+   0x00000001, /* denorm */
+   0x7f800000, /* inf */
+   0xff800000, /* -inf */
+   0x7fc00000, /* NaN */
+   0xffc00000, /* -NaN */
+};
+
+
+static void
+fill_src(void *src, unsigned size, boolean floats)
+{
+   uint32_t *dw = src;
+   unsigned i;
+
+   for (i = 0; i < size / 4; i++) {
+      if (floats) {
+         union fi f;
+         if (rand() % 8 == 0)
+            f.ui = special_floats[rand() % ARRAY_SIZE(special_floats)];
+         else
+            f.f = (float)rand() / (float)RAND_MAX;
+         dw[i] = f.ui;
+      }
+      else {
+         dw[i] = (rand() & 0xffff) | ((uint32_t)rand() << 16);
+      }
+   }
+}
+
+
+static void
+run(const struct util_format_description *desc, enum test_func func,
+    void *dst, unsigned dst_stride, const void *src, unsigned src_stride)
+{
+   switch (func) {
+   case UNPACK_RGBA_FLOAT:
+      desc->unpack_rgba_float(dst, dst_stride, src, src_stride,
+                              WIDTH, HEIGHT);
+      break;
+   case PACK_RGBA_FLOAT:
+      desc->pack_rgba_float(dst, dst_stride, src, src_stride,
+                            WIDTH, HEIGHT);
+      break;
+   case UNPACK_RGBA_8UNORM:
+      desc->unpack_rgba_8unorm(dst, dst_stride, src, src_stride,
+                               WIDTH, HEIGHT);
+      break;
+   case PACK_RGBA_8UNORM:
+      desc->pack_rgba_8unorm(dst, dst_stride, src, src_stride,
+                             WIDTH, HEIGHT);
+      break;
+   }
+}
+
+
+static double
+time_run(const struct util_format_description *desc, enum test_func func,
+         void *dst, unsigned dst_stride, const void *src, unsigned src_stride)
+{
+   int64_t start = os_time_get_nano();
+   unsigned i;
+
+   for (i = 0; i < ITERATIONS; i++)
+      run(desc, func, dst, dst_stride, src, src_stride);
+
+   /* Mpixels per second */
+   return (double)WIDTH * HEIGHT * ITERATIONS * 1000.0 /
+          (double)MAX2(os_time_get_nano() - start, 1);
+}
+
+
+static boolean
+test_one(enum pipe_format format, enum test_func func)
+{
+   const struct util_format_description *desc =
+      util_format_description(format);
+   unsigned packed_stride = WIDTH * desc->block.bits / 8;
+   unsigned unpacked_stride = WIDTH * 4 *
+      (func == UNPACK_RGBA_FLOAT || func == PACK_RGBA_FLOAT ? 4 : 1);
+   boolean pack = func == PACK_RGBA_FLOAT || func == PACK_RGBA_8UNORM;
+   unsigned src_stride = pack ? unpacked_stride : packed_stride;
+   unsigned dst_stride = pack ? packed_stride : unpacked_stride;
+   void *src = MALLOC(src_stride * HEIGHT);
+   void *dst_sse = MALLOC(dst_stride * HEIGHT);
+   void *dst_c = MALLOC(dst_stride * HEIGHT);
+   double mpix_sse, mpix_c;
+   boolean success;
+
+   if (!src || !dst_sse || !dst_c) {
+      FREE(src);
+      FREE(dst_sse);
+      FREE(dst_c);
+      return FALSE;
+   }
+
+   fill_src(src, src_stride * HEIGHT, func == PACK_RGBA_FLOAT);
+   memset(dst_sse, 0xcd, dst_stride * HEIGHT);
+   memset(dst_c, 0xcd, dst_stride * HEIGHT);
+
+   run(desc, func, dst_sse, dst_stride, src, src_stride);
+   mpix_sse = time_run(desc, func, dst_sse, dst_stride, src, src_stride);
+
+   util_cpu_caps.has_sse2 = 0;
+   run(desc, func, dst_c, dst_stride, src, src_stride);
+   mpix_c = time_run(desc, func, dst_c, dst_stride, src, src_stride);
+   util_cpu_caps.has_sse2 = 1;
+
+   success = memcmp(dst_sse, dst_c, dst_stride * HEIGHT) == 0;
+
+   printf("%s %s: %s, scalar %.1f Mpix/s, sse2 %.1f Mpix/s\n",
+          desc->short_name, test_func_names[func],
+          success ? "ok" : "MISMATCH", mpix_c, mpix_sse);
+
+   FREE(src);
+   FREE(dst_sse);
+   FREE(dst_c);
+
+   return success;
+}
+
+
+int main(int argc, char **argv)
+{
+   boolean success = TRUE;
+   unsigned i;
+
+   util_cpu_detect();
+
+   if (!util_cpu_caps.has_sse2) {
+      printf("SSE2 not available, skipping\n");
+      return 0;
+   }
+
+   for (i = 0; i < ARRAY_SIZE(tests); i++)
+      success &= test_one(tests[i].format, tests[i].func);
+
+   return success ? 0 : 1;
+}
@@ -192,6 +192,7 @@ class TraceParser(XmlParser):
     def __init__(self, fp):
         XmlParser.__init__(self, fp)
         self.last_call_no = 0
+        self.blobs = {}
     
     def parse(self):
         self.element_start('trace')
@@ -303,10 +304,15 @@ class TraceParser(XmlParser):
         return Literal(value)
         
     def parse_bytes(self):
-        self.element_start('bytes')
+        attrs = self.element_start('bytes')
         value = self.character_data()
         self.element_end('bytes')
-        return Blob(value)
+        if 'ref' in attrs:
+            return self.blobs[attrs['ref']]
+        blob = Blob(value)
+        if 'id' in attrs:
+            self.blobs[attrs['id']] = blob
+        return blob
         
     def parse_array(self):
         self.element_start('array')
@@ -1278,6 +1278,87 @@ static bool amdgpu_add_sparse_backing_buffers(struct amdgpu_cs_context *cs)
    return true;
 }
 
+static struct util_queue *amdgpu_cs_queue(struct amdgpu_winsys *ws,
+                                          enum ring_type ring_type)
+{
+   switch (ring_type) {
+   case RING_GFX:
+      return &ws->cs_queues[AMDGPU_CS_QUEUE_GFX];
+   case RING_COMPUTE:
+      return &ws->cs_queues[AMDGPU_CS_QUEUE_COMPUTE];
+   case RING_DMA:
+      return &ws->cs_queues[AMDGPU_CS_QUEUE_DMA];
+   default:
+      return &ws->cs_queues[AMDGPU_CS_QUEUE_MM];
+   }
+}
+
+/* Get a kernel BO list handle for the buffer list of a submission.
+ *
+ * A BO list handle costs an extra ioctl, but the kernel doesn't have to look
+ * up all buffers again for each submission that uses it. So without
+ * "always_create", a handle is only created when the same buffers are
+ * submitted twice in a row, and it's kept until the buffer list changes.
+ * Otherwise, *bo_list is set to 0 and the list must be passed to the CS
+ * ioctl.
+ */
+static int amdgpu_cs_get_bo_list(struct amdgpu_cs *acs, unsigned num_handles,
+                                 struct drm_amdgpu_bo_list_entry *list,
+                                 const uint64_t *keys, bool always_create,
+                                 uint32_t *bo_list)
+{
+   struct amdgpu_bo_list_cache *cache = &acs->bo_list_cache;
+   struct amdgpu_winsys *ws = acs->ctx->ws;
+   int r = 0;
+
+   if (cache->num_keys == num_handles &&
+       memcmp(cache->keys, keys, num_handles * sizeof(*keys)) == 0) {
+      if (!cache->handle) {
+         r = amdgpu_bo_list_create_raw(ws->dev, num_handles, list,
+                                       &cache->handle);
+         if (r)
+            cache->handle = 0;
+      }
+      *bo_list = cache->handle;
+      return always_create ? r : 0;
+   }
+
+   /* The buffer list has changed. */
+   if (cache->handle) {
+      amdgpu_bo_list_destroy_raw(ws->dev, cache->handle);
+      cache->handle = 0;
+   }
+
+   if (num_handles > cache->max_keys) {
+      uint64_t *new_keys = REALLOC(cache->keys,
+                                   cache->max_keys * sizeof(*new_keys),
+                                   num_handles * sizeof(*new_keys));
+      if (new_keys) {
+         cache->keys = new_keys;
+         cache->max_keys = num_handles;
+      }
+   }
+
+   if (num_handles <= cache->max_keys) {
+      memcpy(cache->keys, keys, num_handles * sizeof(*keys));
+      cache->num_keys = num_handles;
+   } else {
+      cache->num_keys = 0;
+   }
+
+   if (always_create) {
+      r = amdgpu_bo_list_create_raw(ws->dev, num_handles, list,
+                                    &cache->handle);
+      if (r) {
+         cache->handle = 0;
+         cache->num_keys = 0;
+      }
+   }
+
+   *bo_list = cache->handle;
+   return r;
+}
+
 void amdgpu_cs_submit_ib(void *job, int thread_index)
 {
    struct amdgpu_cs *acs = (struct amdgpu_cs*)job;
@@ -1285,6 +1366,7 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
    struct amdgpu_cs_context *cs = acs->cst;
    int i, r;
    uint32_t bo_list = 0;
+   bool destroy_bo_list = false;
    uint64_t seq_no = 0;
    bool has_user_fence = amdgpu_cs_has_user_fence(cs);
    bool use_bo_list_create = ws->info.drm_minor < 27;
@@ -1312,6 +1394,7 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
 
       r = amdgpu_bo_list_create_raw(ws->dev, ws->num_buffers, list, &bo_list);
       simple_mtx_unlock(&ws->global_bo_list_lock);
+      destroy_bo_list = true;
       if (r) {
          fprintf(stderr, "amdgpu: buffer list creation failed (%d)\n", r);
          goto cleanup;
@@ -1325,6 +1408,7 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
 
       struct drm_amdgpu_bo_list_entry *list =
          alloca(cs->num_real_buffers * sizeof(struct drm_amdgpu_bo_list_entry));
+      uint64_t *keys = alloca(cs->num_real_buffers * sizeof(uint64_t));
 
       unsigned num_handles = 0;
       for (i = 0; i < cs->num_real_buffers; ++i) {
@@ -1337,17 +1421,20 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
 
          list[num_handles].bo_handle = buffer->bo->u.real.kms_handle;
          list[num_handles].bo_priority = (util_last_bit(buffer->u.real.priority_usage) - 1) / 2;
+         keys[num_handles] = (uint64_t)buffer->bo->unique_id << 32 |
+                             list[num_handles].bo_priority;
          ++num_handles;
       }
 
-      if (use_bo_list_create) {
-         /* Legacy path creating the buffer list handle and passing it to the CS ioctl. */
-         r = amdgpu_bo_list_create_raw(ws->dev, num_handles, list, &bo_list);
-         if (r) {
-            fprintf(stderr, "amdgpu: buffer list creation failed (%d)\n", r);
-            goto cleanup;
-         }
-      } else {
+      /* The legacy path always passes a buffer list handle to the CS ioctl. */
+      r = amdgpu_cs_get_bo_list(acs, num_handles, list, keys,
+                                use_bo_list_create, &bo_list);
+      if (r) {
+         fprintf(stderr, "amdgpu: buffer list creation failed (%d)\n", r);
+         goto cleanup;
+      }
+
+      if (!bo_list) {
          /* Standard path passing the buffer list via the CS ioctl. */
          bo_list_in.operation = ~0;
          bo_list_in.list_handle = ~0;
@@ -1367,7 +1454,7 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
       unsigned num_chunks = 0;
 
       /* BO list */
-      if (!use_bo_list_create) {
+      if (!bo_list) {
          chunks[num_chunks].chunk_id = AMDGPU_CHUNK_ID_BO_HANDLES;
          chunks[num_chunks].length_dw = sizeof(struct drm_amdgpu_bo_list_in) / 4;
          chunks[num_chunks].chunk_data = (uintptr_t)&bo_list_in;
@@ -1375,19 +1462,28 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
       }
 
       /* Fence dependencies. */
-      unsigned num_dependencies = cs->fence_dependencies.num;
-      if (num_dependencies) {
-         struct drm_amdgpu_cs_chunk_dep *dep_chunk =
-            alloca(num_dependencies * sizeof(*dep_chunk));
-
-         for (unsigned i = 0; i < num_dependencies; i++) {
-            struct amdgpu_fence *fence =
-               (struct amdgpu_fence*)cs->fence_dependencies.list[i];
+      unsigned num_dependencies = 0;
+      struct drm_amdgpu_cs_chunk_dep *dep_chunk =
+         alloca(cs->fence_dependencies.num * sizeof(*dep_chunk));
+
+      for (unsigned i = 0; i < cs->fence_dependencies.num; i++) {
+         struct amdgpu_fence *fence =
+            (struct amdgpu_fence*)cs->fence_dependencies.list[i];
+
+         /* Other rings are submitted by other threads, so the dependency
+          * may not have a sequence number yet. It was queued before this
+          * IB, so this can't deadlock. If its submission failed, there is
+          * nothing to wait for.
+          */
+         util_queue_fence_wait(&fence->submitted);
+         if (fence->signalled)
+            continue;
 
-            assert(util_queue_fence_is_signalled(&fence->submitted));
-            amdgpu_cs_chunk_fence_to_dep(&fence->fence, &dep_chunk[i]);
-         }
+         amdgpu_cs_chunk_fence_to_dep(&fence->fence,
+                                      &dep_chunk[num_dependencies++]);
+      }
 
+      if (num_dependencies) {
          chunks[num_chunks].chunk_id = AMDGPU_CHUNK_ID_DEPENDENCIES;
          chunks[num_chunks].length_dw = sizeof(dep_chunk[0]) / 4 * num_dependencies;
          chunks[num_chunks].chunk_data = (uintptr_t)dep_chunk;
@@ -1468,8 +1564,8 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
          fprintf(stderr, "amdgpu: The CS has been rejected, "
                  "see dmesg for more information (%i).\n", r);
 
-      acs->ctx->num_rejected_cs++;
-      ws->num_total_rejected_cs++;
+      p_atomic_inc(&acs->ctx->num_rejected_cs);
+      p_atomic_inc(&ws->num_total_rejected_cs);
    } else {
       /* Success. */
       uint64_t *user_fence = NULL;
@@ -1480,7 +1576,7 @@ void amdgpu_cs_submit_ib(void *job, int thread_index)
    }
 
    /* Cleanup. */
-   if (bo_list)
+   if (destroy_bo_list)
       amdgpu_bo_list_destroy_raw(ws->dev, bo_list);
 
 cleanup:
@@ -1609,8 +1705,8 @@ static int amdgpu_cs_flush(struct radeon_cmdbuf *rcs,
       cs->cst = cur;
 
       /* Submit. */
-      util_queue_add_job(&ws->cs_queue, cs, &cs->flush_completed,
-                         amdgpu_cs_submit_ib, NULL);
+      util_queue_add_job(amdgpu_cs_queue(ws, cs->ring_type), cs,
+                         &cs->flush_completed, amdgpu_cs_submit_ib, NULL);
       /* The submission has been queued, unlock the fence now. */
       simple_mtx_unlock(&ws->bo_fence_lock);
 
@@ -1647,6 +1743,9 @@ static void amdgpu_cs_destroy(struct radeon_cmdbuf *rcs)
    amdgpu_destroy_cs_context(&cs->csc1);
    amdgpu_destroy_cs_context(&cs->csc2);
    amdgpu_fence_reference(&cs->next_fence, NULL);
+   if (cs->bo_list_cache.handle)
+      amdgpu_bo_list_destroy_raw(cs->ctx->ws->dev, cs->bo_list_cache.handle);
+   FREE(cs->bo_list_cache.keys);
    FREE(cs);
 }
 
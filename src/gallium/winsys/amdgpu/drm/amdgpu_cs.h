@@ -119,6 +119,19 @@ struct amdgpu_cs_context {
    int                         error_code;
 };
 
+/* The buffer list of the previous submission of a CS. Only used by the
+ * submit thread.
+ */
+struct amdgpu_bo_list_cache {
+   /* unique_id << 32 | priority of each buffer */
+   uint64_t *keys;
+   unsigned num_keys;
+   unsigned max_keys;
+
+   /* Kernel BO list handle for this buffer list, or 0. */
+   uint32_t handle;
+};
+
 struct amdgpu_cs {
    struct amdgpu_ib main; /* must be first because this is inherited */
    struct amdgpu_ctx *ctx;
@@ -142,6 +155,8 @@ struct amdgpu_cs {
 
    struct util_queue_fence flush_completed;
    struct pipe_fence_handle *next_fence;
+
+   struct amdgpu_bo_list_cache bo_list_cache;
 };
 
 struct amdgpu_fence {
@@ -131,8 +131,10 @@ static void amdgpu_winsys_destroy(struct radeon_winsys *rws)
    if (ws->reserve_vmid)
       amdgpu_vm_unreserve_vmid(ws->dev, 0);
 
-   if (util_queue_is_initialized(&ws->cs_queue))
-      util_queue_destroy(&ws->cs_queue);
+   for (unsigned i = 0; i < AMDGPU_NUM_CS_QUEUES; i++) {
+      if (util_queue_is_initialized(&ws->cs_queues[i]))
+         util_queue_destroy(&ws->cs_queues[i]);
+   }
 
    simple_mtx_destroy(&ws->bo_fence_lock);
    for (unsigned i = 0; i < NUM_SLAB_ALLOCATORS; i++) {
@@ -223,7 +225,7 @@ static uint64_t amdgpu_query_value(struct radeon_winsys *rws,
       assert(0);
       return 0;
    case RADEON_CS_THREAD_TIME:
-      return util_queue_get_thread_time_nano(&ws->cs_queue, 0);
+      return util_queue_get_thread_time_nano(&ws->cs_queues[AMDGPU_CS_QUEUE_GFX], 0);
    }
    return 0;
 }
@@ -278,8 +280,10 @@ static void amdgpu_pin_threads_to_L3_cache(struct radeon_winsys *rws,
 {
    struct amdgpu_winsys *ws = (struct amdgpu_winsys*)rws;
 
-   util_pin_thread_to_L3(ws->cs_queue.threads[0], cache,
-                         util_cpu_caps.cores_per_L3);
+   for (unsigned i = 0; i < AMDGPU_NUM_CS_QUEUES; i++) {
+      util_pin_thread_to_L3(ws->cs_queues[i].threads[0], cache,
+                            util_cpu_caps.cores_per_L3);
+   }
 }
 
 PUBLIC struct radeon_winsys *
@@ -395,11 +399,20 @@ amdgpu_winsys_create(int fd, const struct pipe_screen_config *config,
    (void) simple_mtx_init(&ws->bo_fence_lock, mtx_plain);
    (void) simple_mtx_init(&ws->bo_export_table_lock, mtx_plain);
 
-   if (!util_queue_init(&ws->cs_queue, "cs", 8, 1,
-                        UTIL_QUEUE_INIT_RESIZE_IF_FULL)) {
-      amdgpu_winsys_destroy(&ws->base);
-      simple_mtx_unlock(&dev_tab_mutex);
-      return NULL;
+   static const char *cs_queue_names[AMDGPU_NUM_CS_QUEUES] = {
+      [AMDGPU_CS_QUEUE_GFX] = "gfx_cs",
+      [AMDGPU_CS_QUEUE_COMPUTE] = "comp_cs",
+      [AMDGPU_CS_QUEUE_DMA] = "sdma_cs",
+      [AMDGPU_CS_QUEUE_MM] = "mm_cs",
+   };
+
+   for (unsigned i = 0; i < AMDGPU_NUM_CS_QUEUES; i++) {
+      if (!util_queue_init(&ws->cs_queues[i], cs_queue_names[i], 8, 1,
+                           UTIL_QUEUE_INIT_RESIZE_IF_FULL)) {
+         amdgpu_winsys_destroy(&ws->base);
+         simple_mtx_unlock(&dev_tab_mutex);
+         return NULL;
+      }
    }
 
    /* Create the screen at the end. The winsys must be initialized
@@ -40,6 +40,14 @@ struct amdgpu_cs;
 
 #define NUM_SLAB_ALLOCATORS 3
 
+enum amdgpu_cs_queue_id {
+   AMDGPU_CS_QUEUE_GFX,
+   AMDGPU_CS_QUEUE_COMPUTE,
+   AMDGPU_CS_QUEUE_DMA,
+   AMDGPU_CS_QUEUE_MM, /* all multimedia rings */
+   AMDGPU_NUM_CS_QUEUES
+};
+
 struct amdgpu_winsys {
    struct radeon_winsys base;
    struct pipe_reference reference;
@@ -72,8 +80,8 @@ struct amdgpu_winsys {
 
    struct radeon_info info;
 
-   /* multithreaded IB submission */
-   struct util_queue cs_queue;
+   /* multithreaded IB submission, one thread per kind of ring */
+   struct util_queue cs_queues[AMDGPU_NUM_CS_QUEUES];
 
    struct amdgpu_gpu_info amdinfo;
    ADDR_HANDLE addrlib;
@@ -24,6 +24,8 @@
 #include <errno.h>
 
 #include "program/prog_instruction.h"
+#include "compiler/blob.h"
+#include "util/disk_cache.h"
 
 #include "blorp_priv.h"
 #include "compiler/brw_compiler.h"
@@ -35,6 +37,7 @@ blorp_init(struct blorp_context *blorp, void *driver_ctx,
 {
    blorp->driver_ctx = driver_ctx;
    blorp->isl_dev = isl_dev;
+   blorp->disk_cache = NULL;
 }
 
 void
@@ -51,6 +54,8 @@ blorp_batch_init(struct blorp_context *blorp,
    batch->blorp = blorp;
    batch->driver_batch = driver_batch;
    batch->flags = flags;
+   batch->state = NULL;
+   batch->dirty = 0;
 }
 
 void
@@ -240,6 +245,116 @@ blorp_compile_vs(struct blorp_context *blorp, void *mem_ctx,
    return program;
 }
 
+/* All BLORP keys start with the shader type, prefix them so that they can't
+ * collide with the driver's own entries in the disk cache.
+ */
+static void
+blorp_disk_cache_key(struct blorp_context *blorp,
+                     const void *key, uint32_t key_size,
+                     cache_key cache_key)
+{
+   struct blob blob;
+   blob_init(&blob);
+   blob_write_bytes(&blob, "blorp", 5);
+   blob_write_bytes(&blob, key, key_size);
+   disk_cache_compute_key(blorp->disk_cache, blob.data, blob.size, cache_key);
+   blob_finish(&blob);
+}
+
+/**
+ * Looks the shader up in the driver's cache and then in the disk cache.
+ * Shaders found on disk are handed to the driver's upload_shader so that
+ * later lookups find them in memory.
+ */
+bool
+blorp_lookup_shader(struct blorp_batch *batch,
+                    const void *key, uint32_t key_size,
+                    uint32_t *kernel_out, void *prog_data_out)
+{
+   struct blorp_context *blorp = batch->blorp;
+
+   if (blorp->lookup_shader(batch, key, key_size, kernel_out, prog_data_out))
+      return true;
+
+   if (!blorp->disk_cache)
+      return false;
+
+   cache_key cache_key;
+   blorp_disk_cache_key(blorp, key, key_size, cache_key);
+
+   size_t size;
+   void *data = disk_cache_get(blorp->disk_cache, cache_key, &size);
+   if (!data)
+      return false;
+
+   struct blob_reader blob;
+   blob_reader_init(&blob, data, size);
+   uint32_t kernel_size = blob_read_uint32(&blob);
+   uint32_t prog_data_size = blob_read_uint32(&blob);
+   const void *kernel = blob_read_bytes(&blob, kernel_size);
+   void *prog_data = malloc(prog_data_size);
+   if (prog_data)
+      blob_copy_bytes(&blob, prog_data, prog_data_size);
+
+   bool result = false;
+   if (prog_data && !blob.overrun && blob.current == blob.end) {
+      /* BLORP shaders have no uniforms, so the only pointers in the stage
+       * prog_data are NULL.  The gen4 SF program has no stage prog_data.
+       */
+      const enum blorp_shader_type *shader_type = key;
+      if (*shader_type != BLORP_SHADER_TYPE_GEN4_SF) {
+         struct brw_stage_prog_data *stage_prog_data = prog_data;
+         assert(stage_prog_data->nr_params == 0);
+         stage_prog_data->param = NULL;
+         stage_prog_data->pull_param = NULL;
+      }
+
+      result = blorp->upload_shader(batch, key, key_size, kernel, kernel_size,
+                                    prog_data, prog_data_size,
+                                    kernel_out, prog_data_out);
+   }
+
+   free(prog_data);
+   free(data);
+   return result;
+}
+
+/**
+ * Uploads a freshly compiled shader to the driver's cache and writes it to
+ * the disk cache.
+ */
+bool
+blorp_upload_shader(struct blorp_batch *batch,
+                    const void *key, uint32_t key_size,
+                    const void *kernel, uint32_t kernel_size,
+                    const struct brw_stage_prog_data *prog_data,
+                    uint32_t prog_data_size,
+                    uint32_t *kernel_out, void *prog_data_out)
+{
+   struct blorp_context *blorp = batch->blorp;
+
+   if (blorp->disk_cache) {
+      cache_key cache_key;
+      blorp_disk_cache_key(blorp, key, key_size, cache_key);
+
+      struct blob blob;
+      blob_init(&blob);
+      blob_write_uint32(&blob, kernel_size);
+      blob_write_uint32(&blob, prog_data_size);
+      blob_write_bytes(&blob, kernel, kernel_size);
+      blob_write_bytes(&blob, prog_data, prog_data_size);
+      if (!blob.out_of_memory) {
+         disk_cache_put(blorp->disk_cache, cache_key, blob.data, blob.size,
+                        NULL);
+      }
+      blob_finish(&blob);
+   }
+
+   return blorp->upload_shader(batch, key, key_size, kernel, kernel_size,
+                               prog_data, prog_data_size,
+                               kernel_out, prog_data_out);
+}
+
 struct blorp_sf_key {
    enum blorp_shader_type shader_type; /* Must be BLORP_SHADER_TYPE_GEN4_SF */
 
@@ -277,8 +392,8 @@ blorp_ensure_sf_program(struct blorp_batch *batch,
    memcpy(key.key.interp_mode, wm_prog_data->interp_mode,
           sizeof(key.key.interp_mode));
 
-   if (blorp->lookup_shader(batch, &key, sizeof(key),
-                            &params->sf_prog_kernel, &params->sf_prog_data))
+   if (blorp_lookup_shader(batch, &key, sizeof(key),
+                           &params->sf_prog_kernel, &params->sf_prog_data))
       return true;
 
    void *mem_ctx = ralloc_context(NULL);
@@ -294,9 +409,9 @@ blorp_ensure_sf_program(struct blorp_batch *batch,
                             &prog_data_tmp, &vue_map, &program_size);
 
    bool result =
-      blorp->upload_shader(batch, &key, sizeof(key), program, program_size,
-                           (void *)&prog_data_tmp, sizeof(prog_data_tmp),
-                           &params->sf_prog_kernel, &params->sf_prog_data);
+      blorp_upload_shader(batch, &key, sizeof(key), program, program_size,
+                          (void *)&prog_data_tmp, sizeof(prog_data_tmp),
+                          &params->sf_prog_kernel, &params->sf_prog_data);
 
    ralloc_free(mem_ctx);
 
@@ -30,6 +30,7 @@
 #include "isl/isl.h"
 
 struct brw_stage_prog_data;
+struct disk_cache;
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,6 +46,12 @@ struct blorp_context {
 
    const struct brw_compiler *compiler;
 
+   /**
+    * Optional on-disk cache backing lookup_shader and upload_shader.  It
+    * must be created for the device so that its keys are device specific.
+    */
+   struct disk_cache *disk_cache;
+
    bool (*lookup_shader)(struct blorp_batch *batch,
                          const void *key, uint32_t key_size,
                          uint32_t *kernel_out, void *prog_data_out);
@@ -79,10 +86,63 @@ enum blorp_batch_flags {
    BLORP_BATCH_NO_UPDATE_CLEAR_COLOR = (1 << 2),
 };
 
+/**
+ * Groups of hardware state which BLORP operations emit.
+ *
+ * After each operation, blorp_batch::dirty holds the groups BLORP wrote so
+ * that the driver only has to re-emit its own state for those.  The first
+ * few groups never depend on more than a small key and are also tracked in
+ * blorp_batch_state, which lets BLORP skip them in back-to-back operations.
+ */
+enum blorp_state_bits {
+   /* Tracked in blorp_batch_state */
+   BLORP_STATE_URB            = (1 << 0),
+   /** 3DSTATE_CONSTANT_*, all of which BLORP leaves empty */
+   BLORP_STATE_CONSTANTS      = (1 << 1),
+   /** 3DSTATE_HS, TE, DS, STREAMOUT, GS and CLIP */
+   BLORP_STATE_FF_DISABLES    = (1 << 2),
+   /** 3DSTATE_MULTISAMPLE and 3DSTATE_SAMPLE_MASK */
+   BLORP_STATE_MULTISAMPLE    = (1 << 3),
+   BLORP_STATE_CC_VIEWPORT    = (1 << 4),
+
+   /* Always emitted */
+   /** Vertex buffers 0 and 1 */
+   BLORP_STATE_VERTEX_BUFFERS = (1 << 5),
+   /**
+    * Vertex elements, VF setup, VS, SF, SBE, WM and PS along with the
+    * binding table and sampler pointers
+    */
+   BLORP_STATE_SHADERS        = (1 << 6),
+   /** Blend, color calculator and depth/stencil state */
+   BLORP_STATE_CC             = (1 << 7),
+   BLORP_STATE_DEPTH_BUFFER   = (1 << 8),
+};
+
+/**
+ * Driver-owned record of the state BLORP last emitted into a batch.
+ *
+ * Drivers which keep one of these per batch must clear the matching valid
+ * bits whenever they emit any of the packets of a tracked group themselves,
+ * and all of them whenever the hardware state becomes unknown.
+ */
+struct blorp_batch_state {
+   /** BLORP_STATE_* groups which still hold what BLORP emitted */
+   uint32_t valid;
+
+   uint32_t urb_entry_sizes;
+   uint32_t num_samples;
+};
+
 struct blorp_batch {
    struct blorp_context *blorp;
    void *driver_batch;
    enum blorp_batch_flags flags;
+
+   /** Optional, BLORP re-emits every group when this is NULL */
+   struct blorp_batch_state *state;
+
+   /** BLORP_STATE_* groups emitted by operations in this batch */
+   uint32_t dirty;
 };
 
 void blorp_batch_init(struct blorp_context *blorp, struct blorp_batch *batch,
@@ -1459,8 +1459,8 @@ brw_blorp_get_blit_kernel(struct blorp_batch *batch,
 {
    struct blorp_context *blorp = batch->blorp;
 
-   if (blorp->lookup_shader(batch, prog_key, sizeof(*prog_key),
-                            &params->wm_prog_kernel, &params->wm_prog_data))
+   if (blorp_lookup_shader(batch, prog_key, sizeof(*prog_key),
+                           &params->wm_prog_kernel, &params->wm_prog_data))
       return true;
 
    void *mem_ctx = ralloc_context(NULL);
@@ -1482,10 +1482,10 @@ brw_blorp_get_blit_kernel(struct blorp_batch *batch,
                               &prog_data);
 
    bool result =
-      blorp->upload_shader(batch, prog_key, sizeof(*prog_key),
-                           program, prog_data.base.program_size,
-                           &prog_data.base, sizeof(prog_data),
-                           &params->wm_prog_kernel, &params->wm_prog_data);
+      blorp_upload_shader(batch, prog_key, sizeof(*prog_key),
+                          program, prog_data.base.program_size,
+                          &prog_data.base, sizeof(prog_data),
+                          &params->wm_prog_kernel, &params->wm_prog_data);
 
    ralloc_free(mem_ctx);
    return result;
@@ -155,6 +155,38 @@ _blorp_combine_address(struct blorp_batch *batch, void *location,
         blorp_flush_range(batch, _dst, _blorp_cmd_length(state) * 4),   \
         _dst = NULL)
 
+/* Returns false if the driver tracks batch->state and the group still holds
+ * what a previous BLORP operation emitted, otherwise records the group as
+ * emitted.
+ */
+static bool
+blorp_state_needs_emit(struct blorp_batch *batch, uint32_t group)
+{
+   struct blorp_batch_state *state = batch->state;
+
+   if (state) {
+      if (state->valid & group)
+         return false;
+      state->valid |= group;
+   }
+
+   batch->dirty |= group;
+   return true;
+}
+
+/* Invalidates a tracked group if the key its packets were emitted for
+ * changed.
+ */
+static void
+blorp_state_set_key(struct blorp_batch *batch, uint32_t group,
+                    uint32_t *key, uint32_t value)
+{
+   if (*key != value) {
+      batch->state->valid &= ~group;
+      *key = value;
+   }
+}
+
 /* 3DSTATE_URB
  * 3DSTATE_URB_VS
  * 3DSTATE_URB_HS
@@ -206,7 +238,14 @@ emit_urb_config(struct blorp_batch *batch,
    const unsigned sf_entry_size =
       params->sf_prog_data ? params->sf_prog_data->urb_entry_size : 0;
 
-   blorp_emit_urb_config(batch, vs_entry_size, sf_entry_size);
+   if (batch->state) {
+      blorp_state_set_key(batch, BLORP_STATE_URB,
+                          &batch->state->urb_entry_sizes,
+                          vs_entry_size | (sf_entry_size << 16));
+   }
+
+   if (blorp_state_needs_emit(batch, BLORP_STATE_URB))
+      blorp_emit_urb_config(batch, vs_entry_size, sf_entry_size);
 }
 
 #if GEN_GEN >= 7
@@ -343,6 +382,8 @@ blorp_emit_vertex_buffers(struct blorp_batch *batch,
    uint32_t num_vbs = 2;
    memset(vb, 0, sizeof(vb));
 
+   batch->dirty |= BLORP_STATE_VERTEX_BUFFERS;
+
    struct blorp_address addrs[2] = {};
    uint32_t size;
    blorp_emit_vertex_data(batch, params, &addrs[0], &size);
@@ -1246,21 +1287,30 @@ blorp_emit_pipeline(struct blorp_batch *batch,
    (void)depth_stencil_state_offset;
 #endif
 
-   blorp_emit(batch, GENX(3DSTATE_CONSTANT_VS), vs);
+   if (blorp_state_needs_emit(batch, BLORP_STATE_CONSTANTS)) {
+      blorp_emit(batch, GENX(3DSTATE_CONSTANT_VS), vs);
 #if GEN_GEN >= 7
-   blorp_emit(batch, GENX(3DSTATE_CONSTANT_HS), hs);
-   blorp_emit(batch, GENX(3DSTATE_CONSTANT_DS), DS);
+      blorp_emit(batch, GENX(3DSTATE_CONSTANT_HS), hs);
+      blorp_emit(batch, GENX(3DSTATE_CONSTANT_DS), DS);
 #endif
-   blorp_emit(batch, GENX(3DSTATE_CONSTANT_GS), gs);
-   blorp_emit(batch, GENX(3DSTATE_CONSTANT_PS), ps);
+      blorp_emit(batch, GENX(3DSTATE_CONSTANT_GS), gs);
+      blorp_emit(batch, GENX(3DSTATE_CONSTANT_PS), ps);
+   }
 
    if (params->src.enabled)
       blorp_emit_sampler_state(batch);
 
-   blorp_emit_3dstate_multisample(batch, params);
+   if (batch->state) {
+      blorp_state_set_key(batch, BLORP_STATE_MULTISAMPLE,
+                          &batch->state->num_samples, params->num_samples);
+   }
+
+   if (blorp_state_needs_emit(batch, BLORP_STATE_MULTISAMPLE)) {
+      blorp_emit_3dstate_multisample(batch, params);
 
-   blorp_emit(batch, GENX(3DSTATE_SAMPLE_MASK), mask) {
-      mask.SampleMask = (1 << params->num_samples) - 1;
+      blorp_emit(batch, GENX(3DSTATE_SAMPLE_MASK), mask) {
+         mask.SampleMask = (1 << params->num_samples) - 1;
+      }
    }
 
    /* From the BSpec, 3D Pipeline > Geometry > Vertex Shader > State,
@@ -1274,22 +1324,28 @@ blorp_emit_pipeline(struct blorp_batch *batch,
     * We've already done one at the start of the BLORP operation.
     */
    blorp_emit_vs_config(batch, params);
+
+   if (blorp_state_needs_emit(batch, BLORP_STATE_FF_DISABLES)) {
 #if GEN_GEN >= 7
-   blorp_emit(batch, GENX(3DSTATE_HS), hs);
-   blorp_emit(batch, GENX(3DSTATE_TE), te);
-   blorp_emit(batch, GENX(3DSTATE_DS), DS);
-   blorp_emit(batch, GENX(3DSTATE_STREAMOUT), so);
+      blorp_emit(batch, GENX(3DSTATE_HS), hs);
+      blorp_emit(batch, GENX(3DSTATE_TE), te);
+      blorp_emit(batch, GENX(3DSTATE_DS), DS);
+      blorp_emit(batch, GENX(3DSTATE_STREAMOUT), so);
 #endif
-   blorp_emit(batch, GENX(3DSTATE_GS), gs);
+      blorp_emit(batch, GENX(3DSTATE_GS), gs);
 
-   blorp_emit(batch, GENX(3DSTATE_CLIP), clip) {
-      clip.PerspectiveDivideDisable = true;
+      blorp_emit(batch, GENX(3DSTATE_CLIP), clip) {
+         clip.PerspectiveDivideDisable = true;
+      }
    }
 
    blorp_emit_sf_config(batch, params);
    blorp_emit_ps_config(batch, params);
 
-   blorp_emit_cc_viewport(batch);
+   if (blorp_state_needs_emit(batch, BLORP_STATE_CC_VIEWPORT))
+      blorp_emit_cc_viewport(batch);
+
+   batch->dirty |= BLORP_STATE_SHADERS | BLORP_STATE_CC;
 }
 
 /******** This is the end of the pipeline setup code ********/
@@ -1545,6 +1601,8 @@ blorp_emit_depth_stencil_config(struct blorp_batch *batch,
 {
    const struct isl_device *isl_dev = batch->blorp->isl_dev;
 
+   batch->dirty |= BLORP_STATE_DEPTH_BUFFER;
+
    uint32_t *dw = blorp_emit_dwords(batch, isl_dev->ds.size / 4);
    if (dw == NULL)
       return;
@@ -1643,9 +1701,20 @@ blorp_emit_gen8_hiz_op(struct blorp_batch *batch,
     * Number of Multisamples in a rendering sequence.
     *
     * Since HIZ may be the first thing in a batch buffer, play safe and always
-    * emit 3DSTATE_MULTISAMPLE.
+    * emit 3DSTATE_MULTISAMPLE unless the driver tracks it.
     */
-   blorp_emit_3dstate_multisample(batch, params);
+   if (batch->state) {
+      blorp_state_set_key(batch, BLORP_STATE_MULTISAMPLE,
+                          &batch->state->num_samples, params->num_samples);
+   }
+
+   if (blorp_state_needs_emit(batch, BLORP_STATE_MULTISAMPLE)) {
+      blorp_emit_3dstate_multisample(batch, params);
+
+      blorp_emit(batch, GENX(3DSTATE_SAMPLE_MASK), mask) {
+         mask.SampleMask = (1 << params->num_samples) - 1;
+      }
+   }
 
    /* From the BDW PRM Volume 7, Depth Buffer Clear:
     *
@@ -1658,7 +1727,8 @@ blorp_emit_gen8_hiz_op(struct blorp_batch *batch,
    if (params->depth.enabled && params->hiz_op == ISL_AUX_OP_FAST_CLEAR) {
       assert(params->depth.clear_color.f32[0] >= 0.0f);
       assert(params->depth.clear_color.f32[0] <= 1.0f);
-      blorp_emit_cc_viewport(batch);
+      if (blorp_state_needs_emit(batch, BLORP_STATE_CC_VIEWPORT))
+         blorp_emit_cc_viewport(batch);
    }
 
    /* According to the SKL PRM formula for WM_INT::ThreadDispatchEnable, the
@@ -1669,6 +1739,7 @@ blorp_emit_gen8_hiz_op(struct blorp_batch *batch,
     * the 3DSTATE_WM packet, just emit a dummy one prior to 3DSTATE_WM_HZ_OP.
     */
    blorp_emit(batch, GENX(3DSTATE_WM), wm);
+   batch->dirty |= BLORP_STATE_SHADERS;
 
    /* If we can't alter the depth stencil config and multiple layers are
     * involved, the HiZ op will fail. This is because the op requires that a
@@ -363,6 +363,19 @@ bool
 blorp_ensure_sf_program(struct blorp_batch *batch,
                         struct blorp_params *params);
 
+bool
+blorp_lookup_shader(struct blorp_batch *batch,
+                    const void *key, uint32_t key_size,
+                    uint32_t *kernel_out, void *prog_data_out);
+
+bool
+blorp_upload_shader(struct blorp_batch *batch,
+                    const void *key, uint32_t key_size,
+                    const void *kernel, uint32_t kernel_size,
+                    const struct brw_stage_prog_data *prog_data,
+                    uint32_t prog_data_size,
+                    uint32_t *kernel_out, void *prog_data_out);
+
 /** \} */
 
 #ifdef __cplusplus
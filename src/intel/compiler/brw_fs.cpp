@@ -7976,6 +7976,12 @@ brw_compile_fs(const struct brw_compiler *compiler, void *log_data,
 
    cfg_t *simd8_cfg = NULL, *simd16_cfg = NULL, *simd32_cfg = NULL;
 
+   /* Wider variants only get compiled when they could be allocated without
+    * spilling, which can't happen once a narrower one had to spill or
+    * failed to compile.  Don't waste time running them in that case.
+    */
+   bool try_wider = true;
+
    fs_visitor v8(compiler, log_data, mem_ctx, key,
                  &prog_data->base, prog, shader, 8,
                  shader_time_index8);
@@ -7990,7 +7996,10 @@ brw_compile_fs(const struct brw_compiler *compiler, void *log_data,
       prog_data->reg_blocks_8 = brw_register_blocks(v8.grf_used);
    }
 
-   if (v8.max_dispatch_width >= 16 &&
+   if (v8.spilled_any_registers)
+      try_wider = false;
+
+   if (try_wider && v8.max_dispatch_width >= 16 &&
        likely(!(INTEL_DEBUG & DEBUG_NO16) || use_rep_send)) {
       /* Try a SIMD16 compile */
       fs_visitor v16(compiler, log_data, mem_ctx, key,
@@ -8001,6 +8010,7 @@ brw_compile_fs(const struct brw_compiler *compiler, void *log_data,
          compiler->shader_perf_log(log_data,
                                    "SIMD16 shader failed to compile: %s",
                                    v16.fail_msg);
+         try_wider = false;
       } else {
          simd16_cfg = v16.cfg;
          prog_data->dispatch_grf_start_reg_16 = v16.payload.num_regs;
@@ -8009,7 +8019,7 @@ brw_compile_fs(const struct brw_compiler *compiler, void *log_data,
    }
 
    /* Currently, the compiler only supports SIMD32 on SNB+ */
-   if (v8.max_dispatch_width >= 32 && !use_rep_send &&
+   if (try_wider && v8.max_dispatch_width >= 32 && !use_rep_send &&
        compiler->devinfo->gen >= 6 &&
        unlikely(INTEL_DEBUG & DEBUG_DO32)) {
       /* Try a SIMD32 compile */
@@ -8233,6 +8243,12 @@ brw_compile_cs(const struct brw_compiler *compiler, void *log_data,
    const char *fail_msg = NULL;
    unsigned promoted_constants = 0;
 
+   /* Only the narrowest variant that runs is allowed to spill.  Once one
+    * spilled or failed to compile, the wider ones can't succeed and we
+    * skip them.
+    */
+   bool try_wider = true;
+
    /* Now the main event: Visit the shader IR and generate our CS IR for it.
     */
    if (min_dispatch_width <= 8) {
@@ -8251,10 +8267,13 @@ brw_compile_cs(const struct brw_compiler *compiler, void *log_data,
          cs_set_simd_size(prog_data, 8);
          cs_fill_push_const_info(compiler->devinfo, prog_data);
          promoted_constants = v8->promoted_constants;
+
+         if (v8->spilled_any_registers)
+            try_wider = false;
       }
    }
 
-   if (likely(!(INTEL_DEBUG & DEBUG_NO16)) &&
+   if (likely(!(INTEL_DEBUG & DEBUG_NO16)) && try_wider &&
        !fail_msg && min_dispatch_width <= 16) {
       /* Try a SIMD16 compile */
       nir_shader *nir16 = compile_cs_to_nir(compiler, mem_ctx, key,
@@ -8269,6 +8288,7 @@ brw_compile_cs(const struct brw_compiler *compiler, void *log_data,
          compiler->shader_perf_log(log_data,
                                    "SIMD16 shader failed to compile: %s",
                                    v16->fail_msg);
+         try_wider = false;
          if (!cfg) {
             fail_msg =
                "Couldn't generate SIMD16 program and not "
@@ -8282,13 +8302,17 @@ brw_compile_cs(const struct brw_compiler *compiler, void *log_data,
          cs_set_simd_size(prog_data, 16);
          cs_fill_push_const_info(compiler->devinfo, prog_data);
          promoted_constants = v16->promoted_constants;
+
+         if (v16->spilled_any_registers)
+            try_wider = false;
       }
    }
 
    /* We should always be able to do SIMD32 for compute shaders */
    assert(!v16 || v16->max_dispatch_width >= 32);
 
-   if (!fail_msg && (min_dispatch_width > 16 || (INTEL_DEBUG & DEBUG_DO32))) {
+   if (!fail_msg && (min_dispatch_width > 16 ||
+                     (try_wider && (INTEL_DEBUG & DEBUG_DO32)))) {
       /* Try a SIMD32 compile */
       nir_shader *nir32 = compile_cs_to_nir(compiler, mem_ctx, key,
                                             src_shader, 32);
@@ -8303,7 +8327,7 @@ brw_compile_cs(const struct brw_compiler *compiler, void *log_data,
       if (!v32->run_cs(min_dispatch_width)) {
          compiler->shader_perf_log(log_data,
                                    "SIMD32 shader failed to compile: %s",
-                                   v16->fail_msg);
+                                   v32->fail_msg);
          if (!cfg) {
             fail_msg =
                "Couldn't generate SIMD32 program and not "
@@ -497,6 +497,77 @@ get_used_mrfs(fs_visitor *v, bool *mrf_used)
  * Sets interference between virtual GRFs and usage of the high GRFs for SEND
  * messages (treated as MRFs in code generation).
  */
+namespace {
+   struct vgrf_interval {
+      int start;
+      unsigned vgrf;
+   };
+
+   int
+   compare_vgrf_intervals(const void *a, const void *b)
+   {
+      const vgrf_interval *ia = (const vgrf_interval *)a;
+      const vgrf_interval *ib = (const vgrf_interval *)b;
+
+      if (ia->start != ib->start)
+         return ia->start < ib->start ? -1 : 1;
+      return ia->vgrf < ib->vgrf ? -1 : ia->vgrf > ib->vgrf;
+   }
+}
+
+/**
+ * Adds the interference between VGRFs whose live intervals overlap.
+ *
+ * Rather than testing each pair of VGRFs, which is quadratic in the number
+ * of VGRFs and gets rebuilt after each spill, this walks the VGRFs in the
+ * order their intervals start and only tests them against the ones still
+ * live at that point.  That set is bounded by the register pressure.
+ */
+static void
+setup_vgrf_interference(fs_visitor *v, struct ra_graph *g)
+{
+   const unsigned count = v->alloc.count;
+   vgrf_interval *intervals = new vgrf_interval[count];
+   unsigned *live = new unsigned[count];
+   unsigned live_count = 0;
+
+   for (unsigned i = 0; i < count; i++) {
+      intervals[i].start = v->virtual_grf_start[i];
+      intervals[i].vgrf = i;
+   }
+   qsort(intervals, count, sizeof(*intervals), compare_vgrf_intervals);
+
+   for (unsigned i = 0; i < count; i++) {
+      const unsigned vgrf = intervals[i].vgrf;
+      const int start = intervals[i].start;
+
+      /* Everything in the live set started no later than this VGRF, so the
+       * ones that ended by its start can't interfere with it or with any
+       * later VGRF.
+       */
+      unsigned n = 0;
+      for (unsigned j = 0; j < live_count; j++) {
+         if (v->virtual_grf_end[live[j]] > start)
+            live[n++] = live[j];
+      }
+      live_count = n;
+
+      for (unsigned j = 0; j < live_count; j++) {
+         if (v->virtual_grf_interferes(vgrf, live[j]))
+            ra_add_node_interference(g, vgrf, live[j]);
+      }
+
+      /* Unused VGRFs and ones that end where they start don't interfere
+       * with anything that starts later.
+       */
+      if (v->virtual_grf_end[vgrf] > start)
+         live[live_count++] = vgrf;
+   }
+
+   delete[] live;
+   delete[] intervals;
+}
+
 static void
 setup_mrf_hack_interference(fs_visitor *v, struct ra_graph *g,
                             int first_mrf_node, int *first_used_mrf)
@@ -578,14 +649,10 @@ fs_visitor::assign_regs(bool allow_spilling, bool spill_all)
       }
 
       ra_set_node_class(g, i, c);
-
-      for (unsigned j = 0; j < i; j++) {
-	 if (virtual_grf_interferes(i, j)) {
-	    ra_add_node_interference(g, i, j);
-	 }
-      }
    }
 
+   setup_vgrf_interference(this, g);
+
    /* Certain instructions can't safely use the same register for their
     * sources and destination.  Add interference.
     */
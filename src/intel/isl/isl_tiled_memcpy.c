@@ -36,7 +36,9 @@
 
 #include "isl_priv.h"
 
-#if defined(__SSSE3__)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
 #include <tmmintrin.h>
 #elif defined(__SSE2__)
 #include <emmintrin.h>
@@ -58,6 +60,12 @@ static const uint32_t ytile_width = 128;
 static const uint32_t ytile_height = 32;
 static const uint32_t ytile_span = 16;
 
+/* Uploads at least this big are written with non-temporal stores.  Nobody
+ * reads them back on the CPU, and they would only push everything else out
+ * of the cache.
+ */
+static const uint64_t streaming_store_min_size = 4 * 1024 * 1024;
+
 static inline uint32_t
 ror(uint32_t n, uint32_t d)
 {
@@ -117,6 +125,19 @@ rgba8_copy_16_aligned_src(void *dst, const void *src)
                                      *(__m128i *)rgba8_permutation));
 }
 
+#ifdef __AVX2__
+static inline void
+rgba8_copy_32(void *dst, const void *src)
+{
+   const __m256i permutation =
+      _mm256_broadcastsi128_si256(*(__m128i *)rgba8_permutation);
+
+   _mm256_storeu_si256(dst,
+                       _mm256_shuffle_epi8(_mm256_loadu_si256(src),
+                                           permutation));
+}
+#endif
+
 #elif defined(__SSE2__)
 static inline void
 rgba8_copy_16_aligned_dst(void *dst, const void *src)
@@ -163,10 +184,15 @@ rgba8_copy_aligned_dst(void *dst, const void *src, size_t bytes)
 
 #if defined(__SSSE3__) || defined(__SSE2__)
    if (bytes == 64) {
+#ifdef __AVX2__
+      rgba8_copy_32(dst +  0, src +  0);
+      rgba8_copy_32(dst + 32, src + 32);
+#else
       rgba8_copy_16_aligned_dst(dst +  0, src +  0);
       rgba8_copy_16_aligned_dst(dst + 16, src + 16);
       rgba8_copy_16_aligned_dst(dst + 32, src + 32);
       rgba8_copy_16_aligned_dst(dst + 48, src + 48);
+#endif
       return dst;
    }
 
@@ -193,10 +219,15 @@ rgba8_copy_aligned_src(void *dst, const void *src, size_t bytes)
 
 #if defined(__SSSE3__) || defined(__SSE2__)
    if (bytes == 64) {
+#ifdef __AVX2__
+      rgba8_copy_32(dst +  0, src +  0);
+      rgba8_copy_32(dst + 32, src + 32);
+#else
       rgba8_copy_16_aligned_src(dst +  0, src +  0);
       rgba8_copy_16_aligned_src(dst + 16, src + 16);
       rgba8_copy_16_aligned_src(dst + 32, src + 32);
       rgba8_copy_16_aligned_src(dst + 48, src + 48);
+#endif
       return dst;
    }
 
@@ -575,6 +606,14 @@ _memcpy_streaming_load(void *dest, const void *src, size_t count)
       _mm_storeu_si128((__m128i *)dest, val);
       return dest;
    } else if (count == 64) {
+#if defined(INLINE_AVX2)
+      /* 64-byte spans only occur in X tiles, where they are 64-byte aligned. */
+      __m256i val0 = _mm256_stream_load_si256(((__m256i *)src) + 0);
+      __m256i val1 = _mm256_stream_load_si256(((__m256i *)src) + 1);
+      _mm256_storeu_si256(((__m256i *)dest) + 0, val0);
+      _mm256_storeu_si256(((__m256i *)dest) + 1, val1);
+      return dest;
+#else
       __m128i val0 = _mm_stream_load_si128(((__m128i *)src) + 0);
       __m128i val1 = _mm_stream_load_si128(((__m128i *)src) + 1);
       __m128i val2 = _mm_stream_load_si128(((__m128i *)src) + 2);
@@ -584,6 +623,42 @@ _memcpy_streaming_load(void *dest, const void *src, size_t count)
       _mm_storeu_si128(((__m128i *)dest) + 2, val2);
       _mm_storeu_si128(((__m128i *)dest) + 3, val3);
       return dest;
+#endif
+   } else {
+      assert(count < 64); /* and (count < 16) for ytiled */
+      return memcpy(dest, src, count);
+   }
+}
+#endif
+
+#if defined(__SSE2__)
+/**
+ * Copy with non-temporal stores to a 16-byte aligned tiled destination.
+ */
+static ALWAYS_INLINE void *
+_memcpy_streaming_store(void *dest, const void *src, size_t count)
+{
+   if (count == 16) {
+      _mm_stream_si128((__m128i *)dest, _mm_loadu_si128((__m128i *)src));
+      return dest;
+   } else if (count == 64) {
+#if defined(__AVX2__)
+      /* 64-byte spans only occur in X tiles, where they are 64-byte aligned. */
+      __m256i val0 = _mm256_loadu_si256(((__m256i *)src) + 0);
+      __m256i val1 = _mm256_loadu_si256(((__m256i *)src) + 1);
+      _mm256_stream_si256(((__m256i *)dest) + 0, val0);
+      _mm256_stream_si256(((__m256i *)dest) + 1, val1);
+#else
+      __m128i val0 = _mm_loadu_si128(((__m128i *)src) + 0);
+      __m128i val1 = _mm_loadu_si128(((__m128i *)src) + 1);
+      __m128i val2 = _mm_loadu_si128(((__m128i *)src) + 2);
+      __m128i val3 = _mm_loadu_si128(((__m128i *)src) + 3);
+      _mm_stream_si128(((__m128i *)dest) + 0, val0);
+      _mm_stream_si128(((__m128i *)dest) + 1, val1);
+      _mm_stream_si128(((__m128i *)dest) + 2, val2);
+      _mm_stream_si128(((__m128i *)dest) + 3, val3);
+#endif
+      return dest;
    } else {
       assert(count < 64); /* and (count < 16) for ytiled */
       return memcpy(dest, src, count);
@@ -701,6 +776,61 @@ linear_to_ytiled_faster(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
                     dst, src, src_pitch, swizzle_bit, mem_copy, mem_copy);
 }
 
+#if defined(__SSE2__)
+/**
+ * Copy texture data from linear to X tile layout with non-temporal stores.
+ *
+ * Only for ISL_MEMCPY; the whole-tile case gets constant parameters like in
+ * \ref linear_to_xtiled_faster.
+ *
+ * \copydoc tile_copy_fn
+ */
+static FLATTEN void
+linear_to_xtiled_streaming(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
+                           uint32_t y0, uint32_t y1,
+                           char *dst, const char *src,
+                           int32_t src_pitch,
+                           uint32_t swizzle_bit,
+                           UNUSED isl_memcpy_type copy_type)
+{
+   assert(copy_type == ISL_MEMCPY);
+
+   if (x0 == 0 && x3 == xtile_width && y0 == 0 && y1 == xtile_height)
+      return linear_to_xtiled(0, 0, xtile_width, xtile_width, 0, xtile_height,
+                              dst, src, src_pitch, swizzle_bit,
+                              memcpy, _memcpy_streaming_store);
+
+   linear_to_xtiled(x0, x1, x2, x3, y0, y1,
+                    dst, src, src_pitch, swizzle_bit,
+                    memcpy, _memcpy_streaming_store);
+}
+
+/**
+ * Copy texture data from linear to Y tile layout with non-temporal stores.
+ *
+ * \copydoc linear_to_xtiled_streaming
+ */
+static FLATTEN void
+linear_to_ytiled_streaming(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3,
+                           uint32_t y0, uint32_t y1,
+                           char *dst, const char *src,
+                           int32_t src_pitch,
+                           uint32_t swizzle_bit,
+                           UNUSED isl_memcpy_type copy_type)
+{
+   assert(copy_type == ISL_MEMCPY);
+
+   if (x0 == 0 && x3 == ytile_width && y0 == 0 && y1 == ytile_height)
+      return linear_to_ytiled(0, 0, ytile_width, ytile_width, 0, ytile_height,
+                              dst, src, src_pitch, swizzle_bit,
+                              memcpy, _memcpy_streaming_store);
+
+   linear_to_ytiled(x0, x1, x2, x3, y0, y1,
+                    dst, src, src_pitch, swizzle_bit,
+                    memcpy, _memcpy_streaming_store);
+}
+#endif
+
 /**
  * Copy texture data from X tile layout to linear, faster.
  *
@@ -839,17 +969,31 @@ intel_linear_to_tiled(uint32_t xt1, uint32_t xt2,
    uint32_t xt, yt;
    uint32_t tw, th, span;
    uint32_t swizzle_bit = has_swizzling ? 1<<6 : 0;
+   bool streaming_store = false;
+
+#if defined(__SSE2__)
+   streaming_store = copy_type == ISL_MEMCPY &&
+      (uint64_t)(xt2 - xt1) * (yt2 - yt1) >= streaming_store_min_size;
+#endif
 
    if (tiling == ISL_TILING_X) {
       tw = xtile_width;
       th = xtile_height;
       span = xtile_span;
       tile_copy = linear_to_xtiled_faster;
+#if defined(__SSE2__)
+      if (streaming_store)
+         tile_copy = linear_to_xtiled_streaming;
+#endif
    } else if (tiling == ISL_TILING_Y0) {
       tw = ytile_width;
       th = ytile_height;
       span = ytile_span;
       tile_copy = linear_to_ytiled_faster;
+#if defined(__SSE2__)
+      if (streaming_store)
+         tile_copy = linear_to_ytiled_streaming;
+#endif
    } else {
       unreachable("unsupported tiling");
    }
@@ -902,6 +1046,14 @@ intel_linear_to_tiled(uint32_t xt1, uint32_t xt2,
                    copy_type);
       }
    }
+
+#if defined(__SSE2__)
+   /* Non-temporal stores are weakly ordered; make them visible before the
+    * caller unmaps the buffer and hands it to the GPU.
+    */
+   if (streaming_store)
+      _mm_sfence();
+#endif
 }
 
 /**
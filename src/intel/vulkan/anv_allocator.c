@@ -1284,6 +1284,7 @@ anv_state_stream_init(struct anv_state_stream *stream,
    stream->block = ANV_STATE_NULL;
 
    stream->block_list = NULL;
+   stream->free_list = NULL;
 
    /* Ensure that next + whatever > block_size.  This way the first call to
     * state_stream_alloc fetches a new block.
@@ -1305,9 +1306,54 @@ anv_state_stream_finish(struct anv_state_stream *stream)
       next = sb.next;
    }
 
+   anv_state_stream_trim(stream);
+
    VG(VALGRIND_DESTROY_MEMPOOL(stream));
 }
 
+/* Returns the blocks kept by anv_state_stream_reset to the state pool. */
+void
+anv_state_stream_trim(struct anv_state_stream *stream)
+{
+   struct anv_state_stream_block *next = stream->free_list;
+   while (next != NULL) {
+      struct anv_state_stream_block sb = VG_NOACCESS_READ(next);
+      VG(VALGRIND_MAKE_MEM_UNDEFINED(next, stream->block_size));
+      anv_state_pool_free_no_vg(stream->state_pool, sb.block);
+      next = sb.next;
+   }
+
+   stream->free_list = NULL;
+}
+
+/* Frees everything allocated from the stream, but keeps its blocks around
+ * for the next allocations instead of returning them to the state pool.
+ * This way a command buffer that gets recorded over and over again only
+ * touches the state pool, which is shared by all threads, to grow.
+ */
+void
+anv_state_stream_reset(struct anv_state_stream *stream)
+{
+   struct anv_state_stream_block *next = stream->block_list;
+   while (next != NULL) {
+      struct anv_state_stream_block sb = VG_NOACCESS_READ(next);
+      VG(VALGRIND_MEMPOOL_FREE(stream, sb._vg_ptr));
+      VG(VALGRIND_MAKE_MEM_NOACCESS(next, sb.block.alloc_size));
+
+      if (sb.block.alloc_size == stream->block_size) {
+         VG_NOACCESS_WRITE(&next->next, stream->free_list);
+         stream->free_list = next;
+      } else {
+         anv_state_pool_free_no_vg(stream->state_pool, sb.block);
+      }
+      next = sb.next;
+   }
+
+   stream->block = ANV_STATE_NULL;
+   stream->block_list = NULL;
+   stream->next = stream->block_size;
+}
+
 struct anv_state
 anv_state_stream_alloc(struct anv_state_stream *stream,
                        uint32_t size, uint32_t alignment)
@@ -1323,8 +1369,14 @@ anv_state_stream_alloc(struct anv_state_stream *stream,
       if (block_size < size)
          block_size = round_to_power_of_two(size);
 
-      stream->block = anv_state_pool_alloc_no_vg(stream->state_pool,
-                                                 block_size, PAGE_SIZE);
+      if (block_size == stream->block_size && stream->free_list) {
+         struct anv_state_stream_block *free_sb = stream->free_list;
+         stream->block = VG_NOACCESS_READ(&free_sb->block);
+         stream->free_list = VG_NOACCESS_READ(&free_sb->next);
+      } else {
+         stream->block = anv_state_pool_alloc_no_vg(stream->state_pool,
+                                                    block_size, PAGE_SIZE);
+      }
 
       struct anv_state_stream_block *sb = stream->block.map;
       VG_NOACCESS_WRITE(&sb->block, stream->block);
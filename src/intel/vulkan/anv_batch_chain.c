@@ -76,6 +76,7 @@ anv_reloc_list_init_clone(struct anv_reloc_list *list,
    }
 
    list->deps = _mesa_pointer_set_create(NULL);
+   list->last_dep = NULL;
 
    if (!list->deps) {
       vk_free(alloc, list->relocs);
@@ -161,7 +162,10 @@ anv_reloc_list_add(struct anv_reloc_list *list,
    int index;
 
    if (target_bo->flags & EXEC_OBJECT_PINNED) {
-      _mesa_set_add(list->deps, target_bo);
+      if (target_bo != list->last_dep) {
+         _mesa_set_add(list->deps, target_bo);
+         list->last_dep = target_bo;
+      }
       return VK_SUCCESS;
    }
 
@@ -361,6 +365,7 @@ anv_batch_bo_start(struct anv_batch_bo *bbo, struct anv_batch *batch,
    batch->relocs = &bbo->relocs;
    bbo->relocs.num_relocs = 0;
    _mesa_set_clear(bbo->relocs.deps, NULL);
+   bbo->relocs.last_dep = NULL;
 }
 
 static void
@@ -833,6 +838,7 @@ anv_cmd_buffer_reset_batch_bo_chain(struct anv_cmd_buffer *cmd_buffer)
 
    cmd_buffer->surface_relocs.num_relocs = 0;
    _mesa_set_clear(cmd_buffer->surface_relocs.deps, NULL);
+   cmd_buffer->surface_relocs.last_dep = NULL;
    cmd_buffer->last_ss_pool_center = 0;
 
    /* Reset the list of seen buffers */
@@ -95,6 +95,8 @@ anv_device_init_blorp(struct anv_device *device)
 {
    blorp_init(&device->blorp, device, &device->isl_dev);
    device->blorp.compiler = device->instance->physicalDevice.compiler;
+   if (device->instance->pipeline_cache_enabled)
+      device->blorp.disk_cache = device->instance->physicalDevice.disk_cache;
    device->blorp.lookup_shader = lookup_blorp_shader;
    device->blorp.upload_shader = upload_blorp_shader;
    switch (device->info.gen) {
@@ -616,13 +616,14 @@ void anv_DestroyPipelineLayout(
 /*
  * Descriptor pools.
  *
- * These are implemented using a big pool of memory and a free-list for the
- * host memory allocations and a state_stream and a free list for the buffer
- * view surface state. The spec allows us to fail to allocate due to
- * fragmentation in all cases but two: 1) after pool reset, allocating up
- * until the pool size with no freeing must succeed and 2) allocating and
+ * These are implemented using a big pool of memory and free-lists segregated
+ * by size for the host memory allocations and a state_stream and a free list
+ * for the buffer view surface state. The spec allows us to fail to allocate
+ * due to fragmentation in all cases but two: 1) after pool reset, allocating
+ * up until the pool size with no freeing must succeed and 2) allocating and
  * freeing only descriptor sets with the same layout. Case 1) is easy enogh,
- * and the free lists lets us recycle blocks for case 2).
+ * and the free lists lets us recycle blocks for case 2).  Allocating from
+ * the free lists only ever looks at list heads, so it is constant time.
  */
 
 /* The vma heap reserves 0 to mean NULL; we have to offset by some ammount to
@@ -633,6 +634,19 @@ void anv_DestroyPipelineLayout(
 
 #define EMPTY 1
 
+struct pool_free_list_entry {
+   uint32_t next;
+   uint32_t size;
+};
+
+static void
+anv_descriptor_pool_reset_free_lists(struct anv_descriptor_pool *pool)
+{
+   for (unsigned i = 0; i < ANV_DESCRIPTOR_POOL_FREE_LISTS; i++)
+      pool->free_lists[i] = EMPTY;
+   pool->free_list_mask = 0;
+}
+
 VkResult anv_CreateDescriptorPool(
     VkDevice                                    _device,
     const VkDescriptorPoolCreateInfo*           pCreateInfo,
@@ -707,7 +721,7 @@ VkResult anv_CreateDescriptorPool(
 
    pool->size = pool_size;
    pool->next = 0;
-   pool->free_list = EMPTY;
+   anv_descriptor_pool_reset_free_lists(pool);
 
    if (descriptor_bo_size > 0) {
       VkResult result = anv_bo_init_new(&pool->bo, device, descriptor_bo_size);
@@ -789,7 +803,7 @@ VkResult anv_ResetDescriptorPool(
    list_inithead(&pool->desc_sets);
 
    pool->next = 0;
-   pool->free_list = EMPTY;
+   anv_descriptor_pool_reset_free_lists(pool);
 
    if (pool->bo.size) {
       util_vma_heap_finish(&pool->bo_heap);
@@ -804,10 +818,19 @@ VkResult anv_ResetDescriptorPool(
    return VK_SUCCESS;
 }
 
-struct pool_free_list_entry {
-   uint32_t next;
-   uint32_t size;
-};
+static struct anv_descriptor_set *
+anv_descriptor_pool_pop_free_list(struct anv_descriptor_pool *pool,
+                                  unsigned list)
+{
+   struct pool_free_list_entry *entry =
+      (struct pool_free_list_entry *) (pool->data + pool->free_lists[list]);
+
+   pool->free_lists[list] = entry->next;
+   if (entry->next == EMPTY)
+      pool->free_list_mask &= ~(1u << list);
+
+   return (struct anv_descriptor_set *) entry;
+}
 
 static VkResult
 anv_descriptor_pool_alloc_set(struct anv_descriptor_pool *pool,
@@ -818,25 +841,35 @@ anv_descriptor_pool_alloc_set(struct anv_descriptor_pool *pool,
       *set = (struct anv_descriptor_set *) (pool->data + pool->next);
       pool->next += size;
       return VK_SUCCESS;
-   } else {
-      struct pool_free_list_entry *entry;
-      uint32_t *link = &pool->free_list;
-      for (uint32_t f = pool->free_list; f != EMPTY; f = entry->next) {
-         entry = (struct pool_free_list_entry *) (pool->data + f);
-         if (size <= entry->size) {
-            *link = entry->next;
-            *set = (struct anv_descriptor_set *) entry;
-            return VK_SUCCESS;
-         }
-         link = &entry->next;
-      }
+   }
 
-      if (pool->free_list != EMPTY) {
-         return vk_error(VK_ERROR_FRAGMENTED_POOL);
-      } else {
-         return vk_error(VK_ERROR_OUT_OF_POOL_MEMORY);
+   /* Sets are mostly freed and reallocated with the same layout, so first
+    * try the head of the list the requested size belongs to.  It's
+    * usually a previous set of the same size.
+    */
+   const unsigned list = util_logbase2(size);
+   if (pool->free_lists[list] != EMPTY) {
+      struct pool_free_list_entry *entry = (struct pool_free_list_entry *)
+         (pool->data + pool->free_lists[list]);
+      if (size <= entry->size) {
+         *set = anv_descriptor_pool_pop_free_list(pool, list);
+         return VK_SUCCESS;
       }
    }
+
+   /* Otherwise any entry of a list for larger sizes fits. */
+   const uint32_t larger = list + 1 < ANV_DESCRIPTOR_POOL_FREE_LISTS ?
+      pool->free_list_mask & ~BITFIELD_MASK(list + 1) : 0;
+   if (larger) {
+      *set = anv_descriptor_pool_pop_free_list(pool, ffs(larger) - 1);
+      return VK_SUCCESS;
+   }
+
+   if (pool->free_list_mask) {
+      return vk_error(VK_ERROR_FRAGMENTED_POOL);
+   } else {
+      return vk_error(VK_ERROR_OUT_OF_POOL_MEMORY);
+   }
 }
 
 static void
@@ -848,10 +881,12 @@ anv_descriptor_pool_free_set(struct anv_descriptor_pool *pool,
    if (index + set->size == pool->next) {
       pool->next = index;
    } else {
+      const unsigned list = util_logbase2(set->size);
       struct pool_free_list_entry *entry = (struct pool_free_list_entry *) set;
-      entry->next = pool->free_list;
+      entry->next = pool->free_lists[list];
       entry->size = set->size;
-      pool->free_list = (char *) entry - pool->data;
+      pool->free_lists[list] = index;
+      pool->free_list_mask |= 1u << list;
    }
 }
 
@@ -39,6 +39,7 @@
 #include "util/mesa-sha1.h"
 #include "util/os_file.h"
 #include "util/u_atomic.h"
+#include "util/u_cpu_detect.h"
 #include "util/u_string.h"
 #include "git_sha1.h"
 #include "vk_util.h"
@@ -2355,6 +2356,20 @@ VkResult anv_CreateDevice(
 
    anv_pipeline_cache_init(&device->default_pipeline_cache, device, true);
 
+   /* Application allocators have to be called from the thread of the API
+    * call, so only build pipelines from other threads with our own.
+    */
+   util_cpu_detect();
+   unsigned pipeline_threads =
+      env_var_as_unsigned("ANV_PIPELINE_THREADS",
+                          MIN2(util_cpu_caps.nr_cpus, 16));
+   memset(&device->pipeline_queue, 0, sizeof(device->pipeline_queue));
+   if (pipeline_threads > 1 &&
+       device->alloc.pfnAllocation == default_alloc_func) {
+      util_queue_init(&device->pipeline_queue, "anv_pipeline", 64,
+                      pipeline_threads, UTIL_QUEUE_INIT_RESIZE_IF_FULL);
+   }
+
    anv_device_init_blorp(device);
 
    anv_device_init_border_colors(device);
@@ -2408,6 +2423,9 @@ void anv_DestroyDevice(
 
    anv_device_finish_blorp(device);
 
+   if (util_queue_is_initialized(&device->pipeline_queue))
+      util_queue_destroy(&device->pipeline_queue);
+
    anv_pipeline_cache_finish(&device->default_pipeline_cache);
 
    anv_queue_finish(&device->queue);
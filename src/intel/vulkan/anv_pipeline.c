@@ -1742,3 +1742,101 @@ anv_pipeline_init(struct anv_pipeline *pipeline,
 
    return VK_SUCCESS;
 }
+
+struct anv_pipeline_job {
+   struct util_queue_fence fence;
+   anv_pipeline_create_func create;
+   VkDevice device;
+   struct anv_pipeline_cache *cache;
+   const void *create_info;
+   VkPipeline *pipeline;
+   VkResult result;
+};
+
+static void
+anv_pipeline_job_execute(void *data, int thread_index)
+{
+   struct anv_pipeline_job *job = data;
+
+   job->result = job->create(job->device, job->cache, job->create_info,
+                             NULL, job->pipeline);
+}
+
+/* Creates the pipelines of a vkCreate*Pipelines call.  When there are
+ * several and the device has a pipeline queue, they are compiled by the
+ * queue's threads while the calling thread takes care of the first one.
+ * Pipelines created with an application allocator are created one after
+ * the other on the calling thread.
+ */
+VkResult
+anv_create_pipelines(VkDevice _device,
+                     struct anv_pipeline_cache *cache,
+                     uint32_t count,
+                     const void *create_infos,
+                     size_t create_info_size,
+                     const VkAllocationCallbacks *alloc,
+                     VkPipeline *pipelines,
+                     anv_pipeline_create_func create)
+{
+   ANV_FROM_HANDLE(anv_device, device, _device);
+   struct anv_pipeline_job *jobs = NULL;
+   VkResult result = VK_SUCCESS;
+   unsigned i;
+
+   if (count > 1 && alloc == NULL &&
+       util_queue_is_initialized(&device->pipeline_queue))
+      jobs = calloc(count, sizeof(*jobs));
+
+   if (jobs == NULL) {
+      for (i = 0; i < count; i++) {
+         result = create(_device, cache,
+                         (const char *)create_infos + i * create_info_size,
+                         alloc, &pipelines[i]);
+
+         /* Bail out on the first error as it is not obvious what error
+          * should be reported upon 2 different failures. */
+         if (result != VK_SUCCESS)
+            break;
+      }
+
+      for (; i < count; i++)
+         pipelines[i] = VK_NULL_HANDLE;
+
+      return result;
+   }
+
+   for (i = 0; i < count; i++) {
+      jobs[i].create = create;
+      jobs[i].device = _device;
+      jobs[i].cache = cache;
+      jobs[i].create_info = (const char *)create_infos + i * create_info_size;
+      jobs[i].pipeline = &pipelines[i];
+
+      if (i > 0) {
+         util_queue_fence_init(&jobs[i].fence);
+         util_queue_add_job(&device->pipeline_queue, &jobs[i], &jobs[i].fence,
+                            anv_pipeline_job_execute, NULL);
+      }
+   }
+
+   anv_pipeline_job_execute(&jobs[0], 0);
+
+   /* All of the pipelines get built, so report the error of the first one
+    * that failed.
+    */
+   for (i = 0; i < count; i++) {
+      if (i > 0) {
+         util_queue_fence_wait(&jobs[i].fence);
+         util_queue_fence_destroy(&jobs[i].fence);
+      }
+
+      if (jobs[i].result != VK_SUCCESS) {
+         if (result == VK_SUCCESS)
+            result = jobs[i].result;
+         pipelines[i] = VK_NULL_HANDLE;
+      }
+   }
+
+   free(jobs);
+   return result;
+}
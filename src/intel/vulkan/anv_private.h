@@ -56,6 +56,7 @@
 #include "util/u_atomic.h"
 #include "util/u_vector.h"
 #include "util/u_math.h"
+#include "util/u_queue.h"
 #include "util/vma.h"
 #include "vk_alloc.h"
 #include "vk_debug_report.h"
@@ -777,6 +778,11 @@ struct anv_state_stream {
 
    /* List of all blocks allocated from this pool */
    struct anv_state_stream_block *block_list;
+
+   /* Blocks of block_size kept by anv_state_stream_reset, used before
+    * going back to the state pool for new ones.
+    */
+   struct anv_state_stream_block *free_list;
 };
 
 /* The block_pool functions exported for testing only.  The block pool should
@@ -808,6 +814,8 @@ void anv_state_stream_init(struct anv_state_stream *stream,
                            struct anv_state_pool *state_pool,
                            uint32_t block_size);
 void anv_state_stream_finish(struct anv_state_stream *stream);
+void anv_state_stream_reset(struct anv_state_stream *stream);
+void anv_state_stream_trim(struct anv_state_stream *stream);
 struct anv_state anv_state_stream_alloc(struct anv_state_stream *stream,
                                         uint32_t size, uint32_t alignment);
 
@@ -1133,6 +1141,11 @@ struct anv_device {
     struct anv_pipeline_cache                   default_pipeline_cache;
     struct blorp_context                        blorp;
 
+    /* Builds the pipelines of vkCreate*Pipelines calls in parallel. Only
+     * initialized when the device uses the default allocator.
+     */
+    struct util_queue                           pipeline_queue;
+
     struct anv_state                            border_colors;
 
     struct anv_queue                            queue;
@@ -1267,6 +1280,11 @@ struct anv_reloc_list {
    struct drm_i915_gem_relocation_entry *       relocs;
    struct anv_bo **                             reloc_bos;
    struct set *                                 deps;
+
+   /* The last BO added to deps.  Consecutive addresses in a batch mostly
+    * point into the same BO, remembering it saves a set lookup for each.
+    */
+   struct anv_bo *                              last_dep;
 };
 
 VkResult anv_reloc_list_init(struct anv_reloc_list *list,
@@ -1762,10 +1780,18 @@ struct anv_push_descriptor_set {
    struct anv_buffer_view buffer_views[MAX_PUSH_DESCRIPTORS];
 };
 
+#define ANV_DESCRIPTOR_POOL_FREE_LISTS 32
+
 struct anv_descriptor_pool {
    uint32_t size;
    uint32_t next;
-   uint32_t free_list;
+
+   /* Freed set allocations, segregated by size: free_lists[i] holds the
+    * ones with a size in [2^i, 2^(i+1)), and bit i of free_list_mask is set
+    * when it isn't empty.
+    */
+   uint32_t free_lists[ANV_DESCRIPTOR_POOL_FREE_LISTS];
+   uint32_t free_list_mask;
 
    struct anv_bo bo;
    struct util_vma_heap bo_heap;
@@ -2314,6 +2340,9 @@ struct anv_cmd_graphics_state {
 
    struct anv_dynamic_state dynamic;
 
+   /** 3D state last emitted by BLORP, see struct blorp_batch_state */
+   struct blorp_batch_state blorp;
+
    struct {
       struct anv_buffer *index_buffer;
       uint32_t index_type; /**< 3DSTATE_INDEX_BUFFER.IndexFormat */
@@ -2859,6 +2888,22 @@ anv_pipeline_compile_cs(struct anv_pipeline *pipeline,
                         const char *entrypoint,
                         const VkSpecializationInfo *spec_info);
 
+typedef VkResult (*anv_pipeline_create_func)(VkDevice device,
+                                             struct anv_pipeline_cache *cache,
+                                             const void *create_info,
+                                             const VkAllocationCallbacks *alloc,
+                                             VkPipeline *pipeline);
+
+VkResult
+anv_create_pipelines(VkDevice device,
+                     struct anv_pipeline_cache *cache,
+                     uint32_t count,
+                     const void *create_infos,
+                     size_t create_info_size,
+                     const VkAllocationCallbacks *alloc,
+                     VkPipeline *pipelines,
+                     anv_pipeline_create_func create);
+
 struct anv_format_plane {
    enum isl_format isl_format:16;
    struct isl_swizzle swizzle;
@@ -258,9 +258,36 @@ genX(blorp_exec)(struct blorp_batch *batch,
     */
    genX(cmd_buffer_enable_pma_fix)(cmd_buffer, false);
 
+   batch->state = &cmd_buffer->state.gfx.blorp;
+   batch->dirty = 0;
+
    blorp_exec(batch, params);
 
-   cmd_buffer->state.gfx.vb_dirty = ~0;
-   cmd_buffer->state.gfx.dirty = ~0;
-   cmd_buffer->state.push_constants_dirty = ~0;
+   /* Only re-emit the state BLORP actually overwrote */
+   if (batch->dirty & BLORP_STATE_VERTEX_BUFFERS)
+      cmd_buffer->state.gfx.vb_dirty |= 0x3;
+
+   if (batch->dirty & BLORP_STATE_CONSTANTS)
+      cmd_buffer->state.push_constants_dirty |= VK_SHADER_STAGE_ALL_GRAPHICS;
+
+   if (batch->dirty & (BLORP_STATE_URB |
+                       BLORP_STATE_FF_DISABLES |
+                       BLORP_STATE_MULTISAMPLE |
+                       BLORP_STATE_SHADERS |
+                       BLORP_STATE_CC))
+      cmd_buffer->state.gfx.dirty |= ANV_CMD_DIRTY_PIPELINE;
+
+   /* COLOR_CALC_STATE holds the blend constants and, before gen9, the
+    * stencil reference.
+    */
+   if (batch->dirty & BLORP_STATE_CC) {
+      cmd_buffer->state.gfx.dirty |= ANV_CMD_DIRTY_DYNAMIC_BLEND_CONSTANTS |
+                                     ANV_CMD_DIRTY_DYNAMIC_STENCIL_REFERENCE;
+   }
+
+   if (batch->dirty & BLORP_STATE_CC_VIEWPORT)
+      cmd_buffer->state.gfx.dirty |= ANV_CMD_DIRTY_DYNAMIC_VIEWPORT;
+
+   if (batch->dirty & BLORP_STATE_DEPTH_BUFFER)
+      cmd_buffer->state.gfx.dirty |= ANV_CMD_DIRTY_RENDER_TARGETS;
 }
@@ -1550,6 +1550,7 @@ genX(CmdExecuteCommands)(
     */
    primary->state.current_pipeline = UINT32_MAX;
    primary->state.current_l3_config = NULL;
+   primary->state.gfx.blorp.valid = 0;
 
    /* Each of the secondary command buffers will use its own state base
     * address.  We need to re-emit state base address for the primary after
@@ -1725,6 +1726,9 @@ genX(cmd_buffer_config_l3)(struct anv_cmd_buffer *cmd_buffer,
 #endif
 
    cmd_buffer->state.current_l3_config = cfg;
+
+   /* The URB layout depends on the L3 configuration */
+   cmd_buffer->state.gfx.blorp.valid &= ~BLORP_STATE_URB;
 }
 
 void
@@ -2679,6 +2683,9 @@ genX(cmd_buffer_flush_state)(struct anv_cmd_buffer *cmd_buffer)
    if (cmd_buffer->state.gfx.dirty & ANV_CMD_DIRTY_PIPELINE) {
       anv_batch_emit_batch(&cmd_buffer->batch, &pipeline->batch);
 
+      /* The pipeline batch overwrites everything BLORP tracks */
+      cmd_buffer->state.gfx.blorp.valid = 0;
+
       /* The exact descriptor layout is pulled from the pipeline, so we need
        * to re-emit binding tables on every pipeline change.
        */
@@ -2734,6 +2741,7 @@ genX(cmd_buffer_flush_state)(struct anv_cmd_buffer *cmd_buffer)
       dirty |= cmd_buffer->state.push_constants_dirty;
       dirty &= ANV_STAGE_MASK & VK_SHADER_STAGE_ALL_GRAPHICS;
       cmd_buffer_flush_push_constants(cmd_buffer, dirty);
+      cmd_buffer->state.gfx.blorp.valid &= ~BLORP_STATE_CONSTANTS;
    }
 
    if (dirty)
@@ -2746,6 +2754,7 @@ genX(cmd_buffer_flush_state)(struct anv_cmd_buffer *cmd_buffer)
                                   ANV_CMD_DIRTY_PIPELINE)) {
       gen8_cmd_buffer_emit_depth_viewport(cmd_buffer,
                                           pipeline->depth_clamp_enable);
+      cmd_buffer->state.gfx.blorp.valid &= ~BLORP_STATE_CC_VIEWPORT;
    }
 
    if (cmd_buffer->state.gfx.dirty & (ANV_CMD_DIRTY_DYNAMIC_SCISSOR |
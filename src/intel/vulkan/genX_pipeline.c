@@ -2146,6 +2146,18 @@ compute_pipeline_create(
    return pipeline->batch.status;
 }
 
+static VkResult
+genX(graphics_pipeline_create_cb)(
+    VkDevice                                    device,
+    struct anv_pipeline_cache *                 cache,
+    const void *                                create_info,
+    const VkAllocationCallbacks*                alloc,
+    VkPipeline*                                 pipeline)
+{
+   return genX(graphics_pipeline_create)(device, cache, create_info,
+                                         alloc, pipeline);
+}
+
 VkResult genX(CreateGraphicsPipelines)(
     VkDevice                                    _device,
     VkPipelineCache                             pipelineCache,
@@ -2156,25 +2168,22 @@ VkResult genX(CreateGraphicsPipelines)(
 {
    ANV_FROM_HANDLE(anv_pipeline_cache, pipeline_cache, pipelineCache);
 
-   VkResult result = VK_SUCCESS;
-
-   unsigned i;
-   for (i = 0; i < count; i++) {
-      result = genX(graphics_pipeline_create)(_device,
-                                              pipeline_cache,
-                                              &pCreateInfos[i],
-                                              pAllocator, &pPipelines[i]);
-
-      /* Bail out on the first error as it is not obvious what error should be
-       * report upon 2 different failures. */
-      if (result != VK_SUCCESS)
-         break;
-   }
-
-   for (; i < count; i++)
-      pPipelines[i] = VK_NULL_HANDLE;
+   return anv_create_pipelines(_device, pipeline_cache, count,
+                               pCreateInfos, sizeof(*pCreateInfos),
+                               pAllocator, pPipelines,
+                               genX(graphics_pipeline_create_cb));
+}
 
-   return result;
+static VkResult
+compute_pipeline_create_cb(
+    VkDevice                                    device,
+    struct anv_pipeline_cache *                 cache,
+    const void *                                create_info,
+    const VkAllocationCallbacks*                alloc,
+    VkPipeline*                                 pipeline)
+{
+   return compute_pipeline_create(device, cache, create_info,
+                                  alloc, pipeline);
 }
 
 VkResult genX(CreateComputePipelines)(
@@ -2187,22 +2196,8 @@ VkResult genX(CreateComputePipelines)(
 {
    ANV_FROM_HANDLE(anv_pipeline_cache, pipeline_cache, pipelineCache);
 
-   VkResult result = VK_SUCCESS;
-
-   unsigned i;
-   for (i = 0; i < count; i++) {
-      result = compute_pipeline_create(_device, pipeline_cache,
-                                       &pCreateInfos[i],
-                                       pAllocator, &pPipelines[i]);
-
-      /* Bail out on the first error as it is not obvious what error should be
-       * report upon 2 different failures. */
-      if (result != VK_SUCCESS)
-         break;
-   }
-
-   for (; i < count; i++)
-      pPipelines[i] = VK_NULL_HANDLE;
-
-   return result;
+   return anv_create_pipelines(_device, pipeline_cache, count,
+                               pCreateInfos, sizeof(*pCreateInfos),
+                               pAllocator, pPipelines,
+                               compute_pipeline_create_cb);
 }
@@ -101,6 +101,8 @@ class PrintCode(gl_XML.gl_print_base):
             out('_mesa_glthread_finish(ctx);')
             out('debug_print_sync("{0}");'.format(func.name))
             self.print_sync_call(func)
+            if func.marshal_call_after:
+                out(func.marshal_call_after)
         out('}')
         out('')
         out('')
@@ -135,6 +137,8 @@ class PrintCode(gl_XML.gl_print_base):
         if not func.fixed_params and not func.variable_params:
             out('(void) cmd;\n')
         out('_mesa_post_marshal_hook(ctx);')
+        if func.marshal_call_after:
+            out(func.marshal_call_after)
 
     def print_async_struct(self, func):
         out('struct marshal_cmd_{0}'.format(func.name))
@@ -254,6 +258,16 @@ class PrintCode(gl_XML.gl_print_base):
                     out('return;')
                 out('}')
 
+            if func.marshal_sync:
+                out('if ({0}) {{'.format(func.marshal_sync))
+                with indent():
+                    out('_mesa_glthread_finish(ctx);')
+                    self.print_sync_dispatch(func)
+                    if func.marshal_call_after:
+                        out(func.marshal_call_after)
+                    out('return;')
+                out('}')
+
             out('if (cmd_size <= MARSHAL_MAX_CMD_SIZE) {')
             with indent():
                 self.print_async_dispatch(func)
@@ -266,6 +280,8 @@ class PrintCode(gl_XML.gl_print_base):
         with indent():
             out('_mesa_glthread_finish(ctx);')
             self.print_sync_dispatch(func)
+            if func.marshal_call_after:
+                out(func.marshal_call_after)
 
         out('}')
 
@@ -286,8 +302,7 @@ class PrintCode(gl_XML.gl_print_base):
             out('const struct marshal_cmd_base *cmd_base = cmd;')
             out('switch (cmd_base->cmd_id) {')
             for func in api.functionIterateAll():
-                flavor = func.marshal_flavor()
-                if flavor in ('skip', 'sync'):
+                if not func.marshal_is_queued():
                     continue
                 out('case DISPATCH_CMD_{0}:'.format(func.name))
                 with indent():
@@ -58,6 +58,8 @@ class marshal_function(gl_XML.gl_function):
         # Store the "marshal" attribute, if present.
         self.marshal = element.get('marshal')
         self.marshal_fail = element.get('marshal_fail')
+        self.marshal_sync = element.get('marshal_sync')
+        self.marshal_call_after = element.get('marshal_call_after')
 
     def marshal_flavor(self):
         """Find out how this function should be marshalled between
@@ -84,3 +86,19 @@ class marshal_function(gl_XML.gl_function):
                 # written logic to handle this yet.  TODO: fix.
                 return 'sync'
         return 'async'
+
+    def marshal_is_queued(self):
+        """Find out whether calls to this function are queued as commands
+        for the worker thread.  Custom implementations of functions that
+        return a value or write through an output parameter are
+        synchronous, so no command is generated for them."""
+        flavor = self.marshal_flavor()
+        if flavor in ('skip', 'sync'):
+            return False
+        if flavor == 'custom':
+            if self.return_type != 'void':
+                return False
+            for p in self.parameters:
+                if p.is_output:
+                    return False
+        return True
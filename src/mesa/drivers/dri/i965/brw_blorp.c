@@ -75,6 +75,7 @@ brw_blorp_init(struct brw_context *brw)
    blorp_init(&brw->blorp, brw, &brw->isl_dev);
 
    brw->blorp.compiler = brw->screen->compiler;
+   brw->blorp.disk_cache = brw->screen->disk_cache;
 
    switch (devinfo->gen) {
    case 4:
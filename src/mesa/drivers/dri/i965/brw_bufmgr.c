@@ -274,6 +274,20 @@ memzone_for_address(uint64_t address)
    return BRW_MEMZONE_LOW_4G;
 }
 
+/**
+ * With a 32-bit PPGTT, the whole address space is below 4GB and only the
+ * BRW_MEMZONE_LOW_4G heap exists, so every buffer is allocated from it.
+ */
+static enum brw_memory_zone
+memzone_for_bufmgr(const struct brw_bufmgr *bufmgr,
+                   enum brw_memory_zone memzone)
+{
+   if (!(bufmgr->initial_kflags & EXEC_OBJECT_SUPPORTS_48B_ADDRESS))
+      return BRW_MEMZONE_LOW_4G;
+
+   return memzone;
+}
+
 static uint64_t
 bucket_vma_alloc(struct brw_bufmgr *bufmgr,
                  struct bo_cache_bucket *bucket,
@@ -403,6 +417,7 @@ vma_alloc(struct brw_bufmgr *bufmgr,
    assert(brw_using_softpin(bufmgr));
 
    alignment = ALIGN(alignment, PAGE_SIZE);
+   memzone = memzone_for_bufmgr(bufmgr, memzone);
 
    struct bo_cache_bucket *bucket = get_bucket_allocator(bufmgr, size);
    uint64_t addr;
@@ -505,6 +520,8 @@ bo_alloc_internal(struct brw_bufmgr *bufmgr,
    bool busy = false;
    bool zeroed = false;
 
+   memzone = memzone_for_bufmgr(bufmgr, memzone);
+
    if (flags & BO_ALLOC_BUSY)
       busy = true;
 
@@ -1320,7 +1337,8 @@ brw_bufmgr_destroy(struct brw_bufmgr *bufmgr)
 
    if (brw_using_softpin(bufmgr)) {
       for (int z = 0; z < BRW_MEMZONE_COUNT; z++) {
-         util_vma_heap_finish(&bufmgr->vma_allocator[z]);
+         if (memzone_for_bufmgr(bufmgr, z) == z)
+            util_vma_heap_finish(&bufmgr->vma_allocator[z]);
       }
    }
 
@@ -1749,6 +1767,18 @@ brw_bufmgr_init(struct gen_device_info *devinfo, int fd)
          free(bufmgr);
          return NULL;
       }
+   } else if (devinfo->gen >= 8 && gtt_size > 0 &&
+              gem_param(fd, I915_PARAM_HAS_EXEC_SOFTPIN) > 0 &&
+              gem_param(fd, I915_PARAM_HAS_ALIASING_PPGTT) > 1) {
+      /* A full but 32-bit PPGTT, as on Cherryview.  The address space is
+       * still private to the context, so we can assign addresses ourselves
+       * and skip relocations just the same; it simply all lives in the low
+       * heap.
+       */
+      bufmgr->initial_kflags |= EXEC_OBJECT_PINNED;
+
+      util_vma_heap_init(&bufmgr->vma_allocator[BRW_MEMZONE_LOW_4G],
+                         PAGE_SIZE, gtt_size - PAGE_SIZE);
    }
 
    init_cache_buckets(bufmgr);
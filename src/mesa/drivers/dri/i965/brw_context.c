@@ -58,6 +58,7 @@
 #include "brw_blorp.h"
 #include "brw_draw.h"
 #include "brw_state.h"
+#include "brw_wm.h"
 
 #include "intel_batchbuffer.h"
 #include "intel_buffer_objects.h"
@@ -981,6 +982,8 @@ brwCreateContext(gl_api api,
    brw->wm.base.stage = MESA_SHADER_FRAGMENT;
    brw->cs.base.stage = MESA_SHADER_COMPUTE;
 
+   list_inithead(&brw->wm.async_jobs);
+
    brw_init_driver_functions(brw, &functions);
 
    if (notify_reset)
@@ -1122,6 +1125,11 @@ brwCreateContext(gl_api api,
    if (INTEL_DEBUG & DEBUG_SHADER_TIME)
       brw_init_shader_time(brw);
 
+   /* Shader dumps and shader time want every compile on the draw path. */
+   brw->wm.async_compile = devinfo->gen >= 6 &&
+      util_queue_is_initialized(&screen->compile_queue) &&
+      !(INTEL_DEBUG & (DEBUG_WM | DEBUG_SHADER_TIME));
+
    _mesa_override_extensions(ctx);
    _mesa_compute_version(ctx);
 
@@ -1180,6 +1188,7 @@ intelDestroyContext(__DRIcontext * driContextPriv)
 
    blorp_finish(&brw->blorp);
 
+   brw_wm_async_fini(brw);
    brw_destroy_state(brw);
    brw_draw_destroy(brw);
 
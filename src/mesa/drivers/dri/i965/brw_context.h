@@ -43,6 +43,7 @@
 
 #include "isl/isl.h"
 #include "blorp/blorp.h"
+#include "util/list.h"
 
 #include <brw_bufmgr.h>
 
@@ -348,6 +349,12 @@ struct brw_ff_gs_prog_data {
 /** Number of texture sampler units */
 #define BRW_MAX_TEX_UNIT 32
 
+/**
+ * Number of recently drawn fragment programs recompiled in the background
+ * when a state change forces a recompile of the current one.
+ */
+#define BRW_WM_RECENT_PROGRAMS 8
+
 /** Max number of UBOs in a shader */
 #define BRW_MAX_UBO 14
 
@@ -1138,6 +1145,18 @@ struct brw_context
       struct brw_bo *multisampled_null_render_target_bo;
 
       float offset_clamp;
+
+      /**
+       * Fragment program variants being compiled ahead of time on the
+       * screen's compile queue, see brw_wm.c.
+       */
+      bool async_compile;
+      struct list_head async_jobs;
+      unsigned num_async_jobs;
+
+      /** The last fragment programs drawn with (referenced) */
+      struct gl_program *recent_programs[BRW_WM_RECENT_PROGRAMS];
+      unsigned recent_program_index;
    } wm;
 
    struct {
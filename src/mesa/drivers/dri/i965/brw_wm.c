@@ -68,41 +68,58 @@ assign_fs_binding_table_offsets(const struct gen_device_info *devinfo,
    prog_data->base.binding_table.size_bytes = next_binding_table_offset * 4;
 }
 
-static bool
-brw_codegen_wm_prog(struct brw_context *brw,
-                    struct brw_program *fp,
-                    struct brw_wm_prog_key *key,
-                    struct brw_vue_map *vue_map)
+/**
+ * Clone the program's NIR into \p mem_ctx and lay out its uniforms and
+ * binding table, everything brw_compile_fs() needs from the GL program.
+ */
+static nir_shader *
+setup_wm_prog(struct brw_context *brw,
+              struct brw_program *fp,
+              const struct brw_wm_prog_key *key,
+              void *mem_ctx,
+              struct brw_wm_prog_data *prog_data)
 {
    const struct gen_device_info *devinfo = &brw->screen->devinfo;
-   void *mem_ctx = ralloc_context(NULL);
-   struct brw_wm_prog_data prog_data;
-   const GLuint *program;
-   bool start_busy = false;
-   double start_time = 0;
 
    nir_shader *nir = nir_shader_clone(mem_ctx, fp->program.nir);
 
-   memset(&prog_data, 0, sizeof(prog_data));
+   memset(prog_data, 0, sizeof(*prog_data));
 
    /* Use ALT floating point mode for ARB programs so that 0^0 == 1. */
    if (fp->program.is_arb_asm)
-      prog_data.base.use_alt_mode = true;
+      prog_data->base.use_alt_mode = true;
 
-   assign_fs_binding_table_offsets(devinfo, &fp->program, key, &prog_data);
+   assign_fs_binding_table_offsets(devinfo, &fp->program, key, prog_data);
 
    if (!fp->program.is_arb_asm) {
       brw_nir_setup_glsl_uniforms(mem_ctx, nir, &fp->program,
-                                  &prog_data.base, true);
+                                  &prog_data->base, true);
       brw_nir_analyze_ubo_ranges(brw->screen->compiler, nir,
-                                 NULL, prog_data.base.ubo_ranges);
+                                 NULL, prog_data->base.ubo_ranges);
    } else {
-      brw_nir_setup_arb_uniforms(mem_ctx, nir, &fp->program, &prog_data.base);
+      brw_nir_setup_arb_uniforms(mem_ctx, nir, &fp->program, &prog_data->base);
 
       if (unlikely(INTEL_DEBUG & DEBUG_WM))
          brw_dump_arb_asm("fragment", &fp->program);
    }
 
+   return nir;
+}
+
+static bool
+brw_codegen_wm_prog(struct brw_context *brw,
+                    struct brw_program *fp,
+                    struct brw_wm_prog_key *key,
+                    struct brw_vue_map *vue_map)
+{
+   void *mem_ctx = ralloc_context(NULL);
+   struct brw_wm_prog_data prog_data;
+   const GLuint *program;
+   bool start_busy = false;
+   double start_time = 0;
+
+   nir_shader *nir = setup_wm_prog(brw, fp, key, mem_ctx, &prog_data);
+
    if (unlikely(brw->perf_debug)) {
       start_busy = (brw->batch.last_bo &&
                     brw_bo_busy(brw->batch.last_bo));
@@ -495,6 +512,225 @@ brw_wm_populate_key(struct brw_context *brw, struct brw_wm_prog_key *key)
    key->coherent_fb_fetch = ctx->Extensions.EXT_shader_framebuffer_fetch;
 }
 
+/**
+ * \name Background compiles
+ *
+ * Fragment programs are recompiled whenever state their key depends on
+ * changes, and such a recompile stalls the draw that triggers it.  Most of
+ * those are predictable: a program linked while some state is set is
+ * likely to be drawn with that state, and a state change that forces a
+ * recompile of one program forces it for the other programs drawn with it
+ * as well.  So we compile these variants on the screen's compile queue
+ * ahead of time, with the exact key the draw will look up, and move them
+ * into the program cache once they are done.  A draw that misses the cache
+ * while its variant is still in flight waits for it rather than compiling
+ * it a second time.
+ *
+ * Only the compile itself runs on the queue: the NIR is cloned and the
+ * uniforms are laid out up front, and the result is uploaded by the
+ * context's thread.
+ * @{
+ */
+
+#define BRW_WM_MAX_ASYNC_JOBS 16
+
+struct brw_wm_async_job {
+   struct list_head link;
+   struct util_queue_fence fence;
+
+   const struct brw_compiler *compiler;
+   void *mem_ctx;
+   nir_shader *nir;
+   struct brw_wm_prog_key key;
+   struct brw_wm_prog_data prog_data;
+   struct brw_vue_map vue_map;
+
+   const unsigned *program;
+};
+
+static void
+brw_wm_async_compile(void *data, int thread_index)
+{
+   struct brw_wm_async_job *job = data;
+   char *error_str = NULL;
+
+   /* There is no context to report to from here, errors are reported when
+    * the draw path compiles the program again.
+    */
+   job->program = brw_compile_fs(job->compiler, NULL, job->mem_ctx,
+                                 &job->key, &job->prog_data, job->nir,
+                                 NULL, -1, -1, -1, true, false,
+                                 &job->vue_map, &error_str);
+}
+
+static void
+brw_wm_free_async_job(struct brw_context *brw, struct brw_wm_async_job *job)
+{
+   list_del(&job->link);
+   brw->wm.num_async_jobs--;
+
+   util_queue_fence_destroy(&job->fence);
+   ralloc_free(job->mem_ctx);
+   free(job);
+}
+
+/**
+ * Wait for \p job and upload its program into the cache, making it the
+ * current fragment program.
+ */
+static bool
+brw_wm_finish_async_job(struct brw_context *brw, struct brw_wm_async_job *job)
+{
+   util_queue_fence_wait(&job->fence);
+
+   bool success = job->program != NULL;
+   if (success) {
+      brw_alloc_stage_scratch(brw, &brw->wm.base,
+                              job->prog_data.base.total_scratch);
+
+      /* The param and pull_param arrays will be freed by the shader cache. */
+      ralloc_steal(NULL, job->prog_data.base.param);
+      ralloc_steal(NULL, job->prog_data.base.pull_param);
+      brw_upload_cache(&brw->cache, BRW_CACHE_FS_PROG,
+                       &job->key, sizeof(struct brw_wm_prog_key),
+                       job->program, job->prog_data.base.program_size,
+                       &job->prog_data, sizeof(job->prog_data),
+                       &brw->wm.base.prog_offset, &brw->wm.base.prog_data);
+   }
+
+   brw_wm_free_async_job(brw, job);
+
+   return success;
+}
+
+static struct brw_wm_async_job *
+brw_wm_find_async_job(struct brw_context *brw,
+                      const struct brw_wm_prog_key *key)
+{
+   list_for_each_entry(struct brw_wm_async_job, job,
+                       &brw->wm.async_jobs, link) {
+      if (memcmp(&job->key, key, sizeof(*key)) == 0)
+         return job;
+   }
+
+   return NULL;
+}
+
+/** Move the programs of the jobs which are done into the cache. */
+static void
+brw_wm_collect_async_jobs(struct brw_context *brw)
+{
+   if (list_empty(&brw->wm.async_jobs))
+      return;
+
+   uint32_t old_prog_offset = brw->wm.base.prog_offset;
+   struct brw_stage_prog_data *old_prog_data = brw->wm.base.prog_data;
+
+   list_for_each_entry_safe(struct brw_wm_async_job, job,
+                            &brw->wm.async_jobs, link) {
+      if (util_queue_fence_is_signalled(&job->fence))
+         brw_wm_finish_async_job(brw, job);
+   }
+
+   brw->wm.base.prog_offset = old_prog_offset;
+   brw->wm.base.prog_data = old_prog_data;
+}
+
+/** Start compiling \p prog with \p key, unless that is already done. */
+static void
+brw_wm_queue_compile(struct brw_context *brw, struct gl_program *prog,
+                     const struct brw_wm_prog_key *key)
+{
+   uint32_t offset = 0;
+   void *prog_data = NULL;
+
+   if (brw->wm.num_async_jobs >= BRW_WM_MAX_ASYNC_JOBS)
+      return;
+
+   /* The VUE map of the draw isn't known ahead of time. */
+   if (key->input_slots_valid)
+      return;
+
+   if (brw_search_cache(&brw->cache, BRW_CACHE_FS_PROG, key, sizeof(*key),
+                        &offset, &prog_data, false) ||
+       brw_wm_find_async_job(brw, key))
+      return;
+
+   struct brw_wm_async_job *job = calloc(1, sizeof(*job));
+   if (!job)
+      return;
+
+   job->compiler = brw->screen->compiler;
+   job->mem_ctx = ralloc_context(NULL);
+   job->key = *key;
+   job->nir = setup_wm_prog(brw, brw_program(prog), key, job->mem_ctx,
+                            &job->prog_data);
+   util_queue_fence_init(&job->fence);
+
+   list_addtail(&job->link, &brw->wm.async_jobs);
+   brw->wm.num_async_jobs++;
+
+   util_queue_add_job(&brw->screen->compile_queue, job, &job->fence,
+                      brw_wm_async_compile, NULL);
+}
+
+/** The key \p prog would be drawn with in the current state */
+static void
+brw_wm_populate_state_key(struct brw_context *brw, struct gl_program *prog,
+                          struct brw_wm_prog_key *key)
+{
+   struct gl_program *current = brw->programs[MESA_SHADER_FRAGMENT];
+
+   brw->programs[MESA_SHADER_FRAGMENT] = prog;
+   brw_wm_populate_key(brw, key);
+   brw->programs[MESA_SHADER_FRAGMENT] = current;
+}
+
+/**
+ * Called on a cache miss of the current program.  If the program has been
+ * drawn with recently, the miss is due to a state change, so recompile the
+ * other recent programs for the new state as well.
+ */
+static void
+brw_wm_predict_recompiles(struct brw_context *brw, struct gl_program *prog)
+{
+   struct gl_program **recent = brw->wm.recent_programs;
+   bool seen = false;
+
+   for (unsigned i = 0; i < BRW_WM_RECENT_PROGRAMS; i++)
+      seen |= recent[i] == prog;
+
+   if (seen) {
+      for (unsigned i = 0; i < BRW_WM_RECENT_PROGRAMS; i++) {
+         struct brw_wm_prog_key key;
+
+         if (!recent[i] || recent[i] == prog)
+            continue;
+
+         brw_wm_populate_state_key(brw, recent[i], &key);
+         brw_wm_queue_compile(brw, recent[i], &key);
+      }
+   } else {
+      unsigned i = brw->wm.recent_program_index++ % BRW_WM_RECENT_PROGRAMS;
+      _mesa_reference_program(&brw->ctx, &recent[i], prog);
+   }
+}
+
+void
+brw_wm_async_fini(struct brw_context *brw)
+{
+   list_for_each_entry_safe(struct brw_wm_async_job, job,
+                            &brw->wm.async_jobs, link) {
+      util_queue_drop_job(&brw->screen->compile_queue, &job->fence);
+      brw_wm_free_async_job(brw, job);
+   }
+
+   for (unsigned i = 0; i < BRW_WM_RECENT_PROGRAMS; i++)
+      _mesa_reference_program(&brw->ctx, &brw->wm.recent_programs[i], NULL);
+}
+
+/** @} */
+
 void
 brw_upload_wm_prog(struct brw_context *brw)
 {
@@ -507,6 +743,8 @@ brw_upload_wm_prog(struct brw_context *brw)
 
    brw_wm_populate_key(brw, &key);
 
+   brw_wm_collect_async_jobs(brw);
+
    if (brw_search_cache(&brw->cache, BRW_CACHE_FS_PROG, &key, sizeof(key),
                         &brw->wm.base.prog_offset, &brw->wm.base.prog_data,
                         true))
@@ -518,6 +756,14 @@ brw_upload_wm_prog(struct brw_context *brw)
    fp = (struct brw_program *) brw->programs[MESA_SHADER_FRAGMENT];
    fp->id = key.program_string_id;
 
+   if (brw->wm.async_compile) {
+      struct brw_wm_async_job *job = brw_wm_find_async_job(brw, &key);
+      if (job && brw_wm_finish_async_job(brw, job))
+         return;
+
+      brw_wm_predict_recompiles(brw, &fp->program);
+   }
+
    MAYBE_UNUSED bool success = brw_codegen_wm_prog(brw, fp, &key,
                                                    &brw->vue_map_geom_out);
    assert(success);
@@ -589,6 +835,12 @@ brw_fs_precompile(struct gl_context *ctx, struct gl_program *prog)
 
    bool success = brw_codegen_wm_prog(brw, bfp, &key, &vue_map);
 
+   /* The variant the program will most likely be drawn with */
+   if (success && brw->wm.async_compile && ctx->DrawBuffer) {
+      brw_wm_populate_state_key(brw, prog, &key);
+      brw_wm_queue_compile(brw, prog, &key);
+   }
+
    brw->wm.base.prog_offset = old_prog_offset;
    brw->wm.base.prog_data = old_prog_data;
 
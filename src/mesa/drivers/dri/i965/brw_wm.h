@@ -44,6 +44,9 @@ extern "C" {
 void
 brw_upload_wm_prog(struct brw_context *brw);
 
+void
+brw_wm_async_fini(struct brw_context *brw);
+
 void
 brw_wm_populate_key(struct brw_context *brw,
                     struct brw_wm_prog_key *key);
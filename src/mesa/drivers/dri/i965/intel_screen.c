@@ -1693,6 +1693,9 @@ intelDestroyScreen(__DRIscreen * sPriv)
    brw_bufmgr_destroy(screen->bufmgr);
    driDestroyOptionInfo(&screen->optionCache);
 
+   if (util_queue_is_initialized(&screen->compile_queue))
+      util_queue_destroy(&screen->compile_queue);
+
    disk_cache_destroy(screen->disk_cache);
 
    ralloc_free(screen);
@@ -2441,6 +2444,10 @@ shader_debug_log_mesa(void *data, const char *fmt, ...)
    struct brw_context *brw = (struct brw_context *)data;
    va_list args;
 
+   /* Background compiles have no context to report to. */
+   if (brw == NULL)
+      return;
+
    va_start(args, fmt);
    GLuint msg_id = 0;
    _mesa_gl_vdebugf(&brw->ctx, &msg_id,
@@ -2465,7 +2472,7 @@ shader_perf_log_mesa(void *data, const char *fmt, ...)
       va_end(args_copy);
    }
 
-   if (brw->perf_debug) {
+   if (brw && brw->perf_debug) {
       GLuint msg_id = 0;
       _mesa_gl_vdebugf(&brw->ctx, &msg_id,
                        MESA_DEBUG_SOURCE_SHADER_COMPILER,
@@ -2800,6 +2807,14 @@ __DRIconfig **intelInitScreen2(__DRIscreen *dri_screen)
 
    brw_disk_cache_init(screen);
 
+   /* The jobs run on the process-wide thread pool, the thread count only
+    * limits how many of them run at once.  Failing to create the queue just
+    * leaves every compile on the draw path.
+    */
+   util_queue_init(&screen->compile_queue, "i965_sh", 64, 4,
+                   UTIL_QUEUE_INIT_RESIZE_IF_FULL |
+                   UTIL_QUEUE_INIT_SHARED);
+
    return (const __DRIconfig**) intel_screen_make_configs(dri_screen);
 }
 
@@ -36,6 +36,7 @@
 #include "brw_bufmgr.h"
 #include "dev/gen_device_info.h"
 #include "drm-uapi/i915_drm.h"
+#include "util/u_queue.h"
 #include "util/xmlconfig.h"
 
 #include "isl/isl.h"
@@ -120,6 +121,9 @@ struct intel_screen
    enum isl_format mesa_to_isl_render_format[MESA_FORMAT_COUNT];
 
    struct disk_cache *disk_cache;
+
+   /** Background shader compiles of all contexts of the screen */
+   struct util_queue compile_queue;
 };
 
 extern void intelDestroyContext(__DRIcontext * driContextPriv);
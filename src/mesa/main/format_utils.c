@@ -27,6 +27,8 @@
 #include "glformats.h"
 #include "format_pack.h"
 #include "format_unpack.h"
+#include "sse_swizzle.h"
+#include "x86/common_x86_asm.h"
 
 const mesa_array_format RGBA32_FLOAT =
    MESA_ARRAY_FORMAT(4, 1, 1, 1, 4, 0, 1, 2, 3);
@@ -1511,6 +1513,19 @@ _mesa_swizzle_and_convert(void *void_dst, enum mesa_array_format_datatype dst_ty
                                   swizzle, normalized, count))
       return;
 
+#if defined(USE_SSE41)
+   /* RGB(A) ubyte -> RGBA/BGRA is the common glTexImage upload case. */
+   if (cpu_has_sse4_1 &&
+       dst_type == MESA_ARRAY_FORMAT_TYPE_UBYTE && num_dst_channels == 4 &&
+       src_type == MESA_ARRAY_FORMAT_TYPE_UBYTE &&
+       (num_src_channels == 3 || num_src_channels == 4)) {
+      _mesa_sse_swizzle_ubyte_to_rgba(void_dst, void_src, num_src_channels,
+                                      swizzle, normalized ? UINT8_MAX : 1,
+                                      count);
+      return;
+   }
+#endif
+
    switch (dst_type) {
    case MESA_ARRAY_FORMAT_TYPE_FLOAT:
       convert_float(void_dst, num_dst_channels, void_src, src_type,
@@ -34,26 +34,78 @@
 
 #include "main/mtypes.h"
 #include "main/glthread.h"
+#include "main/context.h"
+#include "main/extensions.h"
+#include "main/macros.h"
 #include "main/marshal.h"
 #include "main/marshal_generated.h"
+#include "main/texobj.h"
+#include "main/texstate.h"
 #include "util/u_atomic.h"
 #include "util/u_thread.h"
+#include "util/u_trace.h"
 
 
+/**
+ * Frees the upload memory of a batch.  If \p keep_chunk is set, one chunk of
+ * the default size is kept for the next use of the batch.
+ */
+static void
+glthread_release_uploads(struct glthread_batch *batch, bool keep_chunk)
+{
+   struct glthread_upload_chunk *keep = NULL;
+
+   while (batch->uploads) {
+      struct glthread_upload_chunk *chunk = batch->uploads;
+      batch->uploads = chunk->next;
+
+      if (keep_chunk && !keep && chunk->size == MARSHAL_UPLOAD_CHUNK_SIZE) {
+         chunk->next = NULL;
+         chunk->used = 0;
+         keep = chunk;
+      } else {
+         free(chunk);
+      }
+   }
+
+   batch->uploads = keep;
+   batch->upload_used = 0;
+}
+
+/**
+ * Make the server dispatch current for unmarshalling. The worker thread
+ * keeps it bound between batches, so this only switches the table after
+ * ctx->CurrentServerDispatch changed or when a batch is executed on the
+ * application thread.
+ */
+static inline void
+glthread_bind_server_dispatch(struct gl_context *ctx)
+{
+   if (_glapi_get_dispatch() != ctx->CurrentServerDispatch)
+      _glapi_set_dispatch(ctx->CurrentServerDispatch);
+}
+
 static void
 glthread_unmarshal_batch(void *job, int thread_index)
 {
    struct glthread_batch *batch = (struct glthread_batch*)job;
    struct gl_context *ctx = batch->ctx;
    size_t pos = 0;
+   MESA_TRACE_FUNC();
 
-   _glapi_set_dispatch(ctx->CurrentServerDispatch);
+   glthread_bind_server_dispatch(ctx);
 
    while (pos < batch->used)
       pos += _mesa_unmarshal_dispatch_cmd(ctx, &batch->buffer[pos]);
 
    assert(pos == batch->used);
    batch->used = 0;
+
+   if (ctx->ErrorValue != GL_NO_ERROR)
+      p_atomic_set(&ctx->GLThread->error_pending, true);
+
+   if (batch->uploads)
+      glthread_release_uploads(batch, true);
 }
 
 static void
@@ -63,6 +115,7 @@ glthread_thread_initialization(void *job, int thread_index)
 
    ctx->Driver.SetBackgroundContext(ctx, &ctx->GLThread->stats);
    _glapi_set_context(ctx);
+   _glapi_set_dispatch(ctx->CurrentServerDispatch);
 }
 
 void
@@ -91,9 +144,13 @@ _mesa_glthread_init(struct gl_context *ctx)
       util_queue_fence_init(&glthread->batches[i].fence);
    }
 
+   glthread->batch_size = MARSHAL_MIN_BATCH_SIZE;
    glthread->stats.queue = &glthread->queue;
+   glthread->stats.batch_size = glthread->batch_size;
    ctx->CurrentClientDispatch = ctx->MarshalExec;
    ctx->GLThread = glthread;
+   _mesa_glthread_reload_client_arrays(ctx);
+   _mesa_glthread_reload_shadow_state(ctx);
 
    /* Execute the thread initialization function in the thread. */
    struct util_queue_fence fence;
@@ -115,8 +172,10 @@ _mesa_glthread_destroy(struct gl_context *ctx)
    _mesa_glthread_finish(ctx);
    util_queue_destroy(&glthread->queue);
 
-   for (unsigned i = 0; i < MARSHAL_MAX_BATCHES; i++)
+   for (unsigned i = 0; i < MARSHAL_MAX_BATCHES; i++) {
       util_queue_fence_destroy(&glthread->batches[i].fence);
+      glthread_release_uploads(&glthread->batches[i], false);
+   }
 
    free(glthread);
    ctx->GLThread = NULL;
@@ -142,8 +201,35 @@ _mesa_glthread_restore_dispatch(struct gl_context *ctx, const char *func)
    }
 }
 
-void
-_mesa_glthread_flush_batch(struct gl_context *ctx)
+/**
+ * Adapts the size of the next batches to how the worker thread keeps up,
+ * when a batch is submitted.
+ *
+ * If the previous batch is still being executed, the worker thread is the
+ * bottleneck, so batches that fill up grow to lower the per-batch overhead.
+ * If it has already been executed, the worker thread is idle until this
+ * batch arrives, so the batches shrink to hand over the calls sooner.
+ */
+static void
+glthread_adapt_batch_size(struct glthread_state *glthread, bool full)
+{
+   struct glthread_batch *last = &glthread->batches[glthread->last];
+
+   if (!util_queue_fence_is_signalled(&last->fence)) {
+      if (full) {
+         glthread->batch_size = MIN2(glthread->batch_size * 2,
+                                     MARSHAL_MAX_BATCH_SIZE);
+      }
+   } else {
+      glthread->batch_size = MAX2(glthread->batch_size / 2,
+                                  MARSHAL_MIN_BATCH_SIZE);
+   }
+
+   glthread->stats.batch_size = glthread->batch_size;
+}
+
+static void
+glthread_flush_batch(struct gl_context *ctx, bool full)
 {
    struct glthread_state *glthread = ctx->GLThread;
    if (!glthread)
@@ -165,6 +251,13 @@ _mesa_glthread_flush_batch(struct gl_context *ctx)
    }
 
    p_atomic_add(&glthread->stats.num_offloaded_items, next->used);
+   p_atomic_add(&glthread->stats.num_offloaded_capacity,
+                glthread->batch_size);
+   p_atomic_inc(&glthread->stats.num_batches);
+   if (full)
+      p_atomic_inc(&glthread->stats.num_full_batches);
+
+   glthread_adapt_batch_size(glthread, full);
 
    util_queue_add_job(&glthread->queue, next, &next->fence,
                       glthread_unmarshal_batch, NULL);
@@ -172,6 +265,22 @@ _mesa_glthread_flush_batch(struct gl_context *ctx)
    glthread->next = (glthread->next + 1) % MARSHAL_MAX_BATCHES;
 }
 
+void
+_mesa_glthread_flush_batch(struct gl_context *ctx)
+{
+   glthread_flush_batch(ctx, false);
+}
+
+/**
+ * Submits the batch being filled because the next command doesn't fit in it,
+ * or because it references a lot of upload memory.
+ */
+void
+_mesa_glthread_flush_full_batch(struct gl_context *ctx)
+{
+   glthread_flush_batch(ctx, true);
+}
+
 /**
  * Waits for all pending batches have been unmarshaled.
  *
@@ -210,7 +319,8 @@ _mesa_glthread_finish(struct gl_context *ctx)
        */
       struct _glapi_table *dispatch = _glapi_get_dispatch();
       glthread_unmarshal_batch(next, 0);
-      _glapi_set_dispatch(dispatch);
+      if (_glapi_get_dispatch() != dispatch)
+         _glapi_set_dispatch(dispatch);
 
       /* It's not a sync because we don't enqueue partial batches, but
        * it would be a sync if we did. So count it anyway.
@@ -221,3 +331,351 @@ _mesa_glthread_finish(struct gl_context *ctx)
    if (synced)
       p_atomic_inc(&glthread->stats.num_syncs);
 }
+
+/**
+ * Copies \p size bytes of user data to memory owned by the batch being
+ * filled, which stays valid until the batch has been executed.
+ *
+ * This is how draw calls sourcing from user vertex arrays and indices are
+ * marshalled without waiting for the worker thread: the application may
+ * reuse its memory as soon as the call returns.  Since the memory belongs to
+ * the batch, the command referencing it must be allocated before uploading,
+ * so that a batch flush can't happen in between.
+ *
+ * Returns NULL if out of memory.
+ */
+void *
+_mesa_glthread_upload(struct gl_context *ctx, const void *data, size_t size)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+   struct glthread_batch *next = &glthread->batches[glthread->next];
+   struct glthread_upload_chunk *chunk = next->uploads;
+   const size_t aligned_size = ALIGN(size, 8);
+
+   if (!chunk || chunk->used + aligned_size > chunk->size) {
+      const size_t chunk_size = MAX2(aligned_size, MARSHAL_UPLOAD_CHUNK_SIZE);
+
+      chunk = malloc(sizeof(*chunk) + chunk_size);
+      if (!chunk)
+         return NULL;
+
+      chunk->size = chunk_size;
+      chunk->used = 0;
+      chunk->next = next->uploads;
+      next->uploads = chunk;
+   }
+
+   void *ptr = &chunk->data[chunk->used];
+   memcpy(ptr, data, size);
+   chunk->used += aligned_size;
+   next->upload_used += aligned_size;
+   return ptr;
+}
+
+
+/**
+ * Reloads the main thread copy of the state answered by
+ * _mesa_glthread_GetIntegerv() from the context.
+ *
+ * This may only be called when the worker thread is idle.
+ */
+void
+_mesa_glthread_reload_shadow_state(struct gl_context *ctx)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+   struct glthread_shadow_state *shadow = &glthread->shadow;
+   const unsigned num_units = _mesa_max_tex_unit(ctx);
+
+   shadow->current_program =
+      ctx->Shader.ActiveProgram ? ctx->Shader.ActiveProgram->Name : 0;
+   shadow->active_texture = ctx->Texture.CurrentUnit;
+
+   for (unsigned u = 0; u < num_units; u++) {
+      for (unsigned t = 0; t < NUM_TEXTURE_TARGETS; t++)
+         shadow->textures[u][t] = ctx->Texture.Unit[u].CurrentTex[t]->Name;
+   }
+
+   shadow->array_buffer = ctx->Array.ArrayBufferObj->Name;
+   shadow->element_array_buffer = ctx->Array.DefaultVAO->IndexBufferObj->Name;
+   shadow->vertex_array = ctx->Array.VAO->Name;
+
+   shadow->draw_framebuffer = ctx->DrawBuffer ? ctx->DrawBuffer->Name : 0;
+   shadow->read_framebuffer = ctx->ReadBuffer ? ctx->ReadBuffer->Name : 0;
+   shadow->renderbuffer =
+      ctx->CurrentRenderbuffer ? ctx->CurrentRenderbuffer->Name : 0;
+
+   shadow->viewport[0] = IROUND(ctx->ViewportArray[0].X);
+   shadow->viewport[1] = IROUND(ctx->ViewportArray[0].Y);
+   shadow->viewport[2] = IROUND(ctx->ViewportArray[0].Width);
+   shadow->viewport[3] = IROUND(ctx->ViewportArray[0].Height);
+
+   shadow->scissor[0] = ctx->Scissor.ScissorArray[0].X;
+   shadow->scissor[1] = ctx->Scissor.ScissorArray[0].Y;
+   shadow->scissor[2] = ctx->Scissor.ScissorArray[0].Width;
+   shadow->scissor[3] = ctx->Scissor.ScissorArray[0].Height;
+
+   shadow->matrix_mode = ctx->Transform.MatrixMode;
+
+   glthread->inside_begin_end = _mesa_inside_begin_end(ctx);
+   glthread->shadow_dirty = false;
+}
+
+void
+_mesa_glthread_invalidate_shadow_state(struct gl_context *ctx)
+{
+   ctx->GLThread->shadow_dirty = true;
+}
+
+static int
+texture_binding_to_index(struct gl_context *ctx, GLenum pname)
+{
+   GLenum target;
+
+   switch (pname) {
+   case GL_TEXTURE_BINDING_1D:
+      target = GL_TEXTURE_1D;
+      break;
+   case GL_TEXTURE_BINDING_2D:
+      target = GL_TEXTURE_2D;
+      break;
+   case GL_TEXTURE_BINDING_3D:
+      target = GL_TEXTURE_3D;
+      break;
+   case GL_TEXTURE_BINDING_CUBE_MAP:
+      target = GL_TEXTURE_CUBE_MAP;
+      break;
+   case GL_TEXTURE_BINDING_RECTANGLE:
+      target = GL_TEXTURE_RECTANGLE;
+      break;
+   case GL_TEXTURE_BINDING_1D_ARRAY:
+      target = GL_TEXTURE_1D_ARRAY;
+      break;
+   case GL_TEXTURE_BINDING_2D_ARRAY:
+      target = GL_TEXTURE_2D_ARRAY;
+      break;
+   case GL_TEXTURE_BINDING_EXTERNAL_OES:
+      target = GL_TEXTURE_EXTERNAL_OES;
+      break;
+   case GL_TEXTURE_BINDING_CUBE_MAP_ARRAY:
+      target = GL_TEXTURE_CUBE_MAP_ARRAY;
+      break;
+   case GL_TEXTURE_BINDING_2D_MULTISAMPLE:
+      target = GL_TEXTURE_2D_MULTISAMPLE;
+      break;
+   case GL_TEXTURE_BINDING_2D_MULTISAMPLE_ARRAY:
+      target = GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+      break;
+   default:
+      return -1;
+   }
+
+   return _mesa_tex_target_to_index(ctx, target);
+}
+
+/**
+ * Answers glGetIntegerv() from the main thread copy of the state without
+ * synchronizing with the worker thread, if \p pname is tracked.
+ *
+ * The tracking assumes that the calls setting the state succeed, unless the
+ * error is trivial to detect.  When an application makes a call that fails
+ * for a reason we don't check (like binding an object name that was never
+ * generated), this returns the value it asked for instead of the one the
+ * context kept.
+ *
+ * \return false if the call has to be executed by the context instead.
+ */
+bool
+_mesa_glthread_GetIntegerv(struct gl_context *ctx, GLenum pname,
+                           GLint *params)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+   const struct glthread_shadow_state *shadow = &glthread->shadow;
+   int index;
+
+   if (glthread->shadow_dirty) {
+      _mesa_glthread_finish(ctx);
+      _mesa_glthread_reload_shadow_state(ctx);
+   }
+
+   /* Leave the GL_INVALID_OPERATION to the context. */
+   if (glthread->inside_begin_end)
+      return false;
+
+   switch (pname) {
+   case GL_CURRENT_PROGRAM:
+      if (ctx->API == API_OPENGLES)
+         return false;
+      *params = shadow->current_program;
+      return true;
+   case GL_ACTIVE_TEXTURE:
+      *params = GL_TEXTURE0 + shadow->active_texture;
+      return true;
+   case GL_ARRAY_BUFFER_BINDING:
+      *params = shadow->array_buffer;
+      return true;
+   case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+      /* This is vertex array object state. */
+      if (shadow->vertex_array)
+         return false;
+      *params = shadow->element_array_buffer;
+      return true;
+   case GL_VERTEX_ARRAY_BINDING:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         return false;
+      *params = shadow->vertex_array;
+      return true;
+   case GL_DRAW_FRAMEBUFFER_BINDING:
+      if (ctx->API == API_OPENGLES)
+         return false;
+      *params = shadow->draw_framebuffer;
+      return true;
+   case GL_READ_FRAMEBUFFER_BINDING:
+      if (!_mesa_is_desktop_gl(ctx) && !_mesa_is_gles3(ctx))
+         return false;
+      *params = shadow->read_framebuffer;
+      return true;
+   case GL_RENDERBUFFER_BINDING:
+      if (ctx->API == API_OPENGLES)
+         return false;
+      *params = shadow->renderbuffer;
+      return true;
+   case GL_VIEWPORT:
+      memcpy(params, shadow->viewport, sizeof(shadow->viewport));
+      return true;
+   case GL_SCISSOR_BOX:
+      memcpy(params, shadow->scissor, sizeof(shadow->scissor));
+      return true;
+   case GL_MATRIX_MODE:
+      if (ctx->API != API_OPENGL_COMPAT && ctx->API != API_OPENGLES)
+         return false;
+      *params = shadow->matrix_mode;
+      return true;
+   default:
+      index = texture_binding_to_index(ctx, pname);
+      if (index < 0)
+         return false;
+      *params = shadow->textures[shadow->active_texture][index];
+      return true;
+   }
+}
+
+void
+_mesa_glthread_UseProgram(struct gl_context *ctx, GLuint program)
+{
+   ctx->GLThread->shadow.current_program = program;
+}
+
+void
+_mesa_glthread_ActiveTexture(struct gl_context *ctx, GLenum texture)
+{
+   const GLuint unit = texture - GL_TEXTURE0;
+
+   if (unit < _mesa_max_tex_unit(ctx))
+      ctx->GLThread->shadow.active_texture = unit;
+}
+
+void
+_mesa_glthread_BindTexture(struct gl_context *ctx, GLenum target,
+                           GLuint texture)
+{
+   struct glthread_shadow_state *shadow = &ctx->GLThread->shadow;
+   const int index = _mesa_tex_target_to_index(ctx, target);
+
+   if (index >= 0)
+      shadow->textures[shadow->active_texture][index] = texture;
+}
+
+void
+_mesa_glthread_BindVertexArray(struct gl_context *ctx, GLuint array)
+{
+   ctx->GLThread->shadow.vertex_array = array;
+}
+
+void
+_mesa_glthread_BindFramebuffer(struct gl_context *ctx, GLenum target,
+                               GLuint framebuffer)
+{
+   struct glthread_shadow_state *shadow = &ctx->GLThread->shadow;
+
+   switch (target) {
+   case GL_FRAMEBUFFER:
+      shadow->draw_framebuffer = framebuffer;
+      shadow->read_framebuffer = framebuffer;
+      break;
+   case GL_DRAW_FRAMEBUFFER:
+      shadow->draw_framebuffer = framebuffer;
+      break;
+   case GL_READ_FRAMEBUFFER:
+      shadow->read_framebuffer = framebuffer;
+      break;
+   }
+}
+
+void
+_mesa_glthread_BindRenderbuffer(struct gl_context *ctx, GLenum target,
+                                GLuint renderbuffer)
+{
+   if (target == GL_RENDERBUFFER)
+      ctx->GLThread->shadow.renderbuffer = renderbuffer;
+}
+
+void
+_mesa_glthread_Viewport(struct gl_context *ctx, GLint x, GLint y,
+                        GLsizei width, GLsizei height)
+{
+   GLint *viewport = ctx->GLThread->shadow.viewport;
+
+   if (width < 0 || height < 0)
+      return;
+
+   /* Same as clamp_viewport() in viewport.c. */
+   if (_mesa_has_ARB_viewport_array(ctx) ||
+       _mesa_has_OES_viewport_array(ctx)) {
+      x = CLAMP(x, ctx->Const.ViewportBounds.Min,
+                ctx->Const.ViewportBounds.Max);
+      y = CLAMP(y, ctx->Const.ViewportBounds.Min,
+                ctx->Const.ViewportBounds.Max);
+   }
+
+   viewport[0] = x;
+   viewport[1] = y;
+   viewport[2] = MIN2(width, (GLsizei) ctx->Const.MaxViewportWidth);
+   viewport[3] = MIN2(height, (GLsizei) ctx->Const.MaxViewportHeight);
+}
+
+void
+_mesa_glthread_Scissor(struct gl_context *ctx, GLint x, GLint y,
+                       GLsizei width, GLsizei height)
+{
+   GLint *scissor = ctx->GLThread->shadow.scissor;
+
+   if (width < 0 || height < 0)
+      return;
+
+   scissor[0] = x;
+   scissor[1] = y;
+   scissor[2] = width;
+   scissor[3] = height;
+}
+
+void
+_mesa_glthread_MatrixMode(struct gl_context *ctx, GLenum mode)
+{
+   switch (mode) {
+   case GL_MODELVIEW:
+   case GL_PROJECTION:
+   case GL_TEXTURE:
+      ctx->GLThread->shadow.matrix_mode = mode;
+      break;
+   default:
+      /* The other modes depend on extensions and limits. */
+      ctx->GLThread->shadow_dirty = true;
+      break;
+   }
+}
+
+void
+_mesa_glthread_BeginEnd(struct gl_context *ctx, bool begin)
+{
+   ctx->GLThread->inside_begin_end = begin;
+}
@@ -24,16 +24,25 @@
 #ifndef _GLTHREAD_H
 #define _GLTHREAD_H
 
-/* The size of one batch and the maximum size of one call.
+/* The maximum size of one call.  Larger calls are executed synchronously,
+ * except for the buffer updates that carry their data out of line.
+ */
+#define MARSHAL_MAX_CMD_SIZE (8 * 1024)
+
+/* The range of the size of one batch.
  *
- * This should be as low as possible, so that:
+ * The size is adapted to the rate at which the worker thread keeps up with
+ * the calls, see glthread_adapt_batch_size().  Small batches are better
+ * when the worker thread is idle, so that:
  * - multiple synchronizations within a frame don't slow us down much
  * - a smaller number of calls per frame can still get decent parallelism
  * - the memory footprint of the queue is low, and with that comes a lower
  *   chance of experiencing CPU cache thrashing
- * but it should be high enough so that u_queue overhead remains negligible.
+ * while big batches keep the u_queue overhead negligible when the
+ * application submits calls faster than the worker thread executes them.
  */
-#define MARSHAL_MAX_CMD_SIZE (8 * 1024)
+#define MARSHAL_MIN_BATCH_SIZE MARSHAL_MAX_CMD_SIZE
+#define MARSHAL_MAX_BATCH_SIZE (64 * 1024)
 
 /* The number of batch slots in memory.
  *
@@ -43,13 +52,42 @@
  */
 #define MARSHAL_MAX_BATCHES 8
 
+/* The amount of user vertex array and index data that can be uploaded for
+ * the commands of one batch before the batch is submitted.  A single draw
+ * that needs to upload more than this is executed synchronously instead.
+ */
+#define MARSHAL_MAX_UPLOAD_SIZE (16 * 1024 * 1024)
+
+/* The size of the chunks the upload memory of a batch is allocated in. */
+#define MARSHAL_UPLOAD_CHUNK_SIZE (256 * 1024)
+
 #include <inttypes.h>
 #include <stdbool.h>
 #include "util/u_queue.h"
+#include "main/glheader.h"
+#include "main/config.h"
+#include "main/menums.h"
+#include "compiler/shader_enums.h"
 
 enum marshal_dispatch_cmd_id;
 struct gl_context;
 
+/**
+ * A piece of memory that user vertex arrays and indices are copied to by
+ * the main thread, so that the worker thread can draw from it after the
+ * application has reused its own memory.
+ */
+struct glthread_upload_chunk
+{
+   struct glthread_upload_chunk *next;
+
+   /** Number of bytes in data[] and the number of them used. */
+   size_t size;
+   size_t used;
+
+   uint8_t data[];
+};
+
 /** A single batch of commands queued up for execution. */
 struct glthread_batch
 {
@@ -62,8 +100,109 @@ struct glthread_batch
    /** Amount of data used by batch commands, in bytes. */
    size_t used;
 
+   /**
+    * Upload memory referenced by the batch commands, most recent chunk
+    * first.  It is released once the batch has been executed.
+    */
+   struct glthread_upload_chunk *uploads;
+
+   /** Amount of upload memory used by batch commands, in bytes. */
+   size_t upload_used;
+
    /** Data contained in the command buffer. */
-   uint8_t buffer[MARSHAL_MAX_CMD_SIZE];
+   uint8_t buffer[MARSHAL_MAX_BATCH_SIZE];
+};
+
+/** Main thread copy of the state of one vertex array. */
+struct glthread_attrib
+{
+   /** The user pointer, or the offset into the bound buffer object. */
+   const GLubyte *pointer;
+
+   /** The stride in bytes, never 0. */
+   GLsizei stride;
+
+   /** The size of one element in bytes. */
+   GLuint element_size;
+};
+
+/**
+ * Main thread copy of the vertex array state of the default vertex array
+ * object, which is what decides what glthread has to upload when a draw
+ * call uses user vertex arrays.
+ *
+ * Bit masks are indexed by gl_vert_attrib.
+ */
+struct glthread_client_arrays
+{
+   struct glthread_attrib attribs[VERT_ATTRIB_MAX];
+
+   /** Enabled vertex arrays. */
+   GLbitfield enabled;
+
+   /** Vertex arrays sourcing from user memory rather than a VBO. */
+   GLbitfield user;
+
+   /** Vertex arrays with a non-zero instance divisor. */
+   GLbitfield instanced;
+
+   /** Client active texture unit, relative to GL_TEXTURE0. */
+   unsigned client_active_texture;
+
+   /** GL_PRIMITIVE_RESTART and GL_PRIMITIVE_RESTART_FIXED_INDEX. */
+   bool primitive_restart;
+   bool primitive_restart_fixed_index;
+};
+
+/** An entry of the main thread copy of the client attrib stack. */
+struct glthread_client_attrib
+{
+   /** Whether GL_CLIENT_VERTEX_ARRAY_BIT was pushed. */
+   bool valid;
+
+   struct glthread_client_arrays arrays;
+   bool vertex_array_is_vbo;
+   bool element_array_is_vbo;
+   bool client_arrays_dirty;
+};
+
+/**
+ * Main thread copy of context state that applications commonly query, so
+ * that glGetIntegerv() can answer without synchronizing with the worker
+ * thread.  See _mesa_glthread_GetIntegerv().
+ */
+struct glthread_shadow_state
+{
+   /** glUseProgram() */
+   GLuint current_program;
+
+   /** glActiveTexture(), relative to GL_TEXTURE0. */
+   unsigned active_texture;
+
+   /** glBindTexture() of each texture unit, indexed by gl_texture_index. */
+   GLuint textures[MAX_COMBINED_TEXTURE_IMAGE_UNITS][NUM_TEXTURE_TARGETS];
+
+   /**
+    * glBindBuffer(GL_ARRAY_BUFFER) and the element array buffer of the
+    * default vertex array object.
+    */
+   GLuint array_buffer;
+   GLuint element_array_buffer;
+
+   /** glBindVertexArray() */
+   GLuint vertex_array;
+
+   /** glBindFramebuffer() and glBindRenderbuffer() */
+   GLuint draw_framebuffer;
+   GLuint read_framebuffer;
+   GLuint renderbuffer;
+
+   /** glViewport() and glScissor() of the first viewport. */
+   GLint viewport[4];
+   GLint scissor[4];
+
+   /** glMatrixMode() */
+   GLenum matrix_mode;
 };
 
 struct glthread_state
@@ -83,6 +222,12 @@ struct glthread_state
    /** Index of the batch being filled and about to be submitted. */
    unsigned next;
 
+   /**
+    * The size at which the batch being filled is submitted, between
+    * MARSHAL_MIN_BATCH_SIZE and MARSHAL_MAX_BATCH_SIZE.
+    */
+   size_t batch_size;
+
    /**
     * Tracks on the main thread side whether the current vertex array binding
     * is in a VBO.
@@ -94,6 +239,46 @@ struct glthread_state
     * buffer) binding is in a VBO.
     */
    bool element_array_is_vbo;
+
+   /**
+    * Tracks on the main thread side the vertex arrays of the default vertex
+    * array object and the primitive restart state.
+    *
+    * This is only used for compatibility and GLES contexts, which disable
+    * glthread on glBindVertexArray() and so always draw from the default
+    * vertex array object.
+    */
+   struct glthread_client_arrays arrays;
+
+   /**
+    * Set by the commands that change vertex array state in ways that aren't
+    * tracked on the main thread.  The tracked state is then reloaded from
+    * the context after synchronizing, see _mesa_glthread_reload_client_arrays.
+    */
+   bool client_arrays_dirty;
+
+   /** glPushClientAttrib() stack. */
+   struct glthread_client_attrib client_attrib_stack[MAX_CLIENT_ATTRIB_STACK_DEPTH];
+   unsigned client_attrib_stack_depth;
+
+   /**
+    * Tracks on the main thread side the state answered by
+    * _mesa_glthread_GetIntegerv().
+    *
+    * Calls that change it in ways that aren't tracked set shadow_dirty, and
+    * the state is then reloaded from the context after synchronizing.
+    */
+   struct glthread_shadow_state shadow;
+   bool shadow_dirty;
+
+   /** Whether we are between glBegin() and glEnd(). */
+   bool inside_begin_end;
+
+   /**
+    * Set by the worker thread when a batch left an error in the context,
+    * see _mesa_marshal_GetError().
+    */
+   bool error_pending;
 };
 
 void _mesa_glthread_init(struct gl_context *ctx);
@@ -101,6 +286,55 @@ void _mesa_glthread_destroy(struct gl_context *ctx);
 
 void _mesa_glthread_restore_dispatch(struct gl_context *ctx, const char *func);
 void _mesa_glthread_flush_batch(struct gl_context *ctx);
+void _mesa_glthread_flush_full_batch(struct gl_context *ctx);
 void _mesa_glthread_finish(struct gl_context *ctx);
+void *_mesa_glthread_upload(struct gl_context *ctx, const void *data,
+                            size_t size);
+
+void _mesa_glthread_reload_client_arrays(struct gl_context *ctx);
+void _mesa_glthread_validate_client_arrays(struct gl_context *ctx);
+void _mesa_glthread_invalidate_client_arrays(struct gl_context *ctx);
+void _mesa_glthread_AttribPointer(struct gl_context *ctx,
+                                  gl_vert_attrib attrib, GLint size,
+                                  GLenum type, GLsizei stride,
+                                  const void *pointer);
+void _mesa_glthread_TexCoordPointer(struct gl_context *ctx, GLint size,
+                                    GLenum type, GLsizei stride,
+                                    const void *pointer);
+void _mesa_glthread_VertexAttribPointer(struct gl_context *ctx, GLuint index,
+                                        GLint size, GLenum type,
+                                        GLsizei stride, const void *pointer);
+void _mesa_glthread_VertexAttribDivisor(struct gl_context *ctx, GLuint index,
+                                        GLuint divisor);
+void _mesa_glthread_ClientState(struct gl_context *ctx, GLenum array,
+                                bool enable);
+void _mesa_glthread_VertexAttribArray(struct gl_context *ctx, GLuint index,
+                                      bool enable);
+void _mesa_glthread_ClientActiveTexture(struct gl_context *ctx,
+                                        GLenum texture);
+void _mesa_glthread_EnableDisable(struct gl_context *ctx, GLenum cap,
+                                  bool enable);
+void _mesa_glthread_PushClientAttrib(struct gl_context *ctx, GLbitfield mask);
+void _mesa_glthread_PopClientAttrib(struct gl_context *ctx);
+
+void _mesa_glthread_reload_shadow_state(struct gl_context *ctx);
+void _mesa_glthread_invalidate_shadow_state(struct gl_context *ctx);
+bool _mesa_glthread_GetIntegerv(struct gl_context *ctx, GLenum pname,
+                                GLint *params);
+void _mesa_glthread_UseProgram(struct gl_context *ctx, GLuint program);
+void _mesa_glthread_ActiveTexture(struct gl_context *ctx, GLenum texture);
+void _mesa_glthread_BindTexture(struct gl_context *ctx, GLenum target,
+                                GLuint texture);
+void _mesa_glthread_BindVertexArray(struct gl_context *ctx, GLuint array);
+void _mesa_glthread_BindFramebuffer(struct gl_context *ctx, GLenum target,
+                                    GLuint framebuffer);
+void _mesa_glthread_BindRenderbuffer(struct gl_context *ctx, GLenum target,
+                                     GLuint renderbuffer);
+void _mesa_glthread_Viewport(struct gl_context *ctx, GLint x, GLint y,
+                             GLsizei width, GLsizei height);
+void _mesa_glthread_Scissor(struct gl_context *ctx, GLint x, GLint y,
+                            GLsizei width, GLsizei height);
+void _mesa_glthread_MatrixMode(struct gl_context *ctx, GLenum mode);
+void _mesa_glthread_BeginEnd(struct gl_context *ctx, bool begin);
 
 #endif /* _GLTHREAD_H*/
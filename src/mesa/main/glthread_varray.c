@@ -0,0 +1,301 @@
+/*
+ * Copyright © 2019 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/** @file glthread_varray.c
+ *
+ * Main thread tracking of the vertex array state, so that glthread knows
+ * which user vertex arrays a draw call has to upload.
+ *
+ * The tracking follows the GL calls that change the vertex arrays of the
+ * default vertex array object.  Calls that change it in ways we don't
+ * follow just mark the tracked state dirty, and it is reloaded from the
+ * context after synchronizing with the worker thread when it's needed.
+ * Calls that generate an error we can't easily detect are tracked as if they
+ * succeeded; the draw call then sources from the arrays the application
+ * asked for, in the memory it pointed to.
+ */
+
+#include "main/mtypes.h"
+#include "main/bufferobj.h"
+#include "main/glformats.h"
+#include "main/glthread.h"
+
+
+/**
+ * Reloads the tracked vertex array state from the context.
+ *
+ * This may only be called when the worker thread is idle, for example right
+ * after _mesa_glthread_finish().
+ */
+void
+_mesa_glthread_reload_client_arrays(struct gl_context *ctx)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+   struct glthread_client_arrays *arrays = &glthread->arrays;
+   const struct gl_vertex_array_object *vao = ctx->Array.VAO;
+
+   arrays->user = 0;
+   arrays->instanced = 0;
+
+   for (unsigned i = 0; i < VERT_ATTRIB_MAX; i++) {
+      const struct gl_array_attributes *array = &vao->VertexAttrib[i];
+      const struct gl_vertex_buffer_binding *binding =
+         &vao->BufferBinding[array->BufferBindingIndex];
+      struct glthread_attrib *attrib = &arrays->attribs[i];
+
+      attrib->pointer = array->Ptr;
+      attrib->stride = binding->Stride ? binding->Stride :
+                                         array->Format._ElementSize;
+      attrib->element_size = array->Format._ElementSize;
+
+      if (!_mesa_is_bufferobj(binding->BufferObj))
+         arrays->user |= VERT_BIT(i);
+      if (binding->InstanceDivisor)
+         arrays->instanced |= VERT_BIT(i);
+   }
+
+   arrays->enabled = vao->Enabled;
+   arrays->client_active_texture = ctx->Array.ActiveTexture;
+   arrays->primitive_restart = ctx->Array.PrimitiveRestart;
+   arrays->primitive_restart_fixed_index =
+      ctx->Array.PrimitiveRestartFixedIndex;
+
+   glthread->vertex_array_is_vbo =
+      _mesa_is_bufferobj(ctx->Array.ArrayBufferObj);
+   glthread->element_array_is_vbo =
+      _mesa_is_bufferobj(vao->IndexBufferObj);
+   glthread->client_arrays_dirty = false;
+}
+
+/**
+ * Makes sure the tracked vertex array state is up to date, synchronizing
+ * with the worker thread if it isn't.
+ */
+void
+_mesa_glthread_validate_client_arrays(struct gl_context *ctx)
+{
+   if (ctx->GLThread->client_arrays_dirty) {
+      _mesa_glthread_finish(ctx);
+      _mesa_glthread_reload_client_arrays(ctx);
+   }
+}
+
+void
+_mesa_glthread_invalidate_client_arrays(struct gl_context *ctx)
+{
+   ctx->GLThread->client_arrays_dirty = true;
+}
+
+void
+_mesa_glthread_AttribPointer(struct gl_context *ctx, gl_vert_attrib attrib,
+                             GLint size, GLenum type, GLsizei stride,
+                             const void *pointer)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+   struct glthread_client_arrays *arrays = &glthread->arrays;
+   struct glthread_attrib *a = &arrays->attribs[attrib];
+   const int element_size =
+      _mesa_bytes_per_vertex_attrib(size == GL_BGRA ? 4 : size, type);
+
+   /* Leave it to the context to tell what an invalid call did. */
+   if (size < 1 || (size > 4 && size != GL_BGRA) || element_size <= 0 ||
+       stride < 0) {
+      glthread->client_arrays_dirty = true;
+      return;
+   }
+
+   a->pointer = pointer;
+   a->stride = stride ? stride : element_size;
+   a->element_size = element_size;
+
+   if (glthread->vertex_array_is_vbo)
+      arrays->user &= ~VERT_BIT(attrib);
+   else
+      arrays->user |= VERT_BIT(attrib);
+}
+
+void
+_mesa_glthread_TexCoordPointer(struct gl_context *ctx, GLint size,
+                               GLenum type, GLsizei stride,
+                               const void *pointer)
+{
+   unsigned unit = ctx->GLThread->arrays.client_active_texture;
+
+   _mesa_glthread_AttribPointer(ctx, VERT_ATTRIB_TEX(unit), size, type,
+                                stride, pointer);
+}
+
+void
+_mesa_glthread_VertexAttribPointer(struct gl_context *ctx, GLuint index,
+                                   GLint size, GLenum type, GLsizei stride,
+                                   const void *pointer)
+{
+   if (index >= VERT_ATTRIB_GENERIC_MAX)
+      return;
+
+   _mesa_glthread_AttribPointer(ctx, VERT_ATTRIB_GENERIC(index), size, type,
+                                stride, pointer);
+}
+
+void
+_mesa_glthread_VertexAttribDivisor(struct gl_context *ctx, GLuint index,
+                                   GLuint divisor)
+{
+   struct glthread_client_arrays *arrays = &ctx->GLThread->arrays;
+
+   if (index >= VERT_ATTRIB_GENERIC_MAX)
+      return;
+
+   if (divisor)
+      arrays->instanced |= VERT_BIT_GENERIC(index);
+   else
+      arrays->instanced &= ~VERT_BIT_GENERIC(index);
+}
+
+void
+_mesa_glthread_ClientState(struct gl_context *ctx, GLenum array, bool enable)
+{
+   struct glthread_client_arrays *arrays = &ctx->GLThread->arrays;
+   gl_vert_attrib attrib;
+
+   switch (array) {
+   case GL_VERTEX_ARRAY:
+      attrib = VERT_ATTRIB_POS;
+      break;
+   case GL_NORMAL_ARRAY:
+      attrib = VERT_ATTRIB_NORMAL;
+      break;
+   case GL_COLOR_ARRAY:
+      attrib = VERT_ATTRIB_COLOR0;
+      break;
+   case GL_INDEX_ARRAY:
+      attrib = VERT_ATTRIB_COLOR_INDEX;
+      break;
+   case GL_TEXTURE_COORD_ARRAY:
+      attrib = VERT_ATTRIB_TEX(arrays->client_active_texture);
+      break;
+   case GL_EDGE_FLAG_ARRAY:
+      attrib = VERT_ATTRIB_EDGEFLAG;
+      break;
+   case GL_FOG_COORDINATE_ARRAY:
+      attrib = VERT_ATTRIB_FOG;
+      break;
+   case GL_SECONDARY_COLOR_ARRAY:
+      attrib = VERT_ATTRIB_COLOR1;
+      break;
+   case GL_POINT_SIZE_ARRAY_OES:
+      attrib = VERT_ATTRIB_POINT_SIZE;
+      break;
+   case GL_PRIMITIVE_RESTART_NV:
+      arrays->primitive_restart = enable;
+      return;
+   default:
+      return;
+   }
+
+   if (enable)
+      arrays->enabled |= VERT_BIT(attrib);
+   else
+      arrays->enabled &= ~VERT_BIT(attrib);
+}
+
+void
+_mesa_glthread_VertexAttribArray(struct gl_context *ctx, GLuint index,
+                                 bool enable)
+{
+   struct glthread_client_arrays *arrays = &ctx->GLThread->arrays;
+
+   if (index >= VERT_ATTRIB_GENERIC_MAX)
+      return;
+
+   if (enable)
+      arrays->enabled |= VERT_BIT_GENERIC(index);
+   else
+      arrays->enabled &= ~VERT_BIT_GENERIC(index);
+}
+
+void
+_mesa_glthread_ClientActiveTexture(struct gl_context *ctx, GLenum texture)
+{
+   const GLuint unit = texture - GL_TEXTURE0;
+
+   if (unit < MAX_TEXTURE_COORD_UNITS)
+      ctx->GLThread->arrays.client_active_texture = unit;
+}
+
+void
+_mesa_glthread_EnableDisable(struct gl_context *ctx, GLenum cap, bool enable)
+{
+   struct glthread_client_arrays *arrays = &ctx->GLThread->arrays;
+
+   switch (cap) {
+   case GL_PRIMITIVE_RESTART:
+      arrays->primitive_restart = enable;
+      break;
+   case GL_PRIMITIVE_RESTART_FIXED_INDEX:
+      arrays->primitive_restart_fixed_index = enable;
+      break;
+   }
+}
+
+void
+_mesa_glthread_PushClientAttrib(struct gl_context *ctx, GLbitfield mask)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+
+   if (glthread->client_attrib_stack_depth >= MAX_CLIENT_ATTRIB_STACK_DEPTH)
+      return;
+
+   struct glthread_client_attrib *top =
+      &glthread->client_attrib_stack[glthread->client_attrib_stack_depth++];
+
+   top->valid = (mask & GL_CLIENT_VERTEX_ARRAY_BIT) != 0;
+   if (top->valid) {
+      top->arrays = glthread->arrays;
+      top->vertex_array_is_vbo = glthread->vertex_array_is_vbo;
+      top->element_array_is_vbo = glthread->element_array_is_vbo;
+      top->client_arrays_dirty = glthread->client_arrays_dirty;
+   }
+}
+
+void
+_mesa_glthread_PopClientAttrib(struct gl_context *ctx)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+
+   if (glthread->client_attrib_stack_depth == 0)
+      return;
+
+   struct glthread_client_attrib *top =
+      &glthread->client_attrib_stack[--glthread->client_attrib_stack_depth];
+
+   if (top->valid) {
+      glthread->arrays = top->arrays;
+      glthread->vertex_array_is_vbo = top->vertex_array_is_vbo;
+      glthread->element_array_is_vbo = top->element_array_is_vbo;
+      glthread->client_arrays_dirty = top->client_arrays_dirty;
+
+      /* This restores the GL_ARRAY_BUFFER binding too. */
+      _mesa_glthread_invalidate_shadow_state(ctx);
+   }
+}
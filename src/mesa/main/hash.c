@@ -38,6 +38,8 @@
 #include "glheader.h"
 #include "hash.h"
 #include "util/hash_table.h"
+#include "util/u_atomic.h"
+#include "util/u_math.h"
 
 
 /**
@@ -94,12 +96,90 @@ _mesa_DeleteHashTable(struct _mesa_HashTable *table)
 
    _mesa_hash_table_destroy(table->ht, NULL);
 
+   struct _mesa_HashFlat *flat = table->Flat;
+   while (flat) {
+      struct _mesa_HashFlat *retired = flat->Retired;
+      free(flat);
+      flat = retired;
+   }
+
    mtx_destroy(&table->Mutex);
    free(table);
 }
 
 
 
+/**
+ * Lookup a key in the flat array without taking the mutex.
+ *
+ * \return true if the key is covered by the array, in which case \p data is
+ * the authoritative answer.
+ */
+static inline bool
+hash_flat_lookup(const struct _mesa_HashTable *table, GLuint key, void **data)
+{
+   struct _mesa_HashFlat *flat = p_atomic_read(&table->Flat);
+
+   if (!flat || key >= flat->Size)
+      return false;
+
+   *data = p_atomic_read(&flat->Entries[key]);
+   return true;
+}
+
+
+/**
+ * Update the flat array entry for a key, growing the array to cover it if
+ * need be.  Must be called with the mutex held.
+ */
+static void
+hash_flat_set(struct _mesa_HashTable *table, GLuint key, void *data)
+{
+   struct _mesa_HashFlat *flat = table->Flat;
+
+   if (key >= MESA_HASH_FLAT_MAX_KEYS)
+      return;
+
+   if (!flat || key >= flat->Size) {
+      /* Removing a key the array doesn't cover is a no-op. */
+      if (!data)
+         return;
+
+      GLuint size = MAX2(util_next_power_of_two(key + 1), 256);
+      struct _mesa_HashFlat *grown =
+         calloc(1, sizeof(*grown) + size * sizeof(void *));
+
+      /* The key just stays uncovered, lookups of it take the lock. */
+      if (!grown) {
+         _mesa_error_no_memory(__func__);
+         return;
+      }
+
+      grown->Size = size;
+      grown->Retired = flat;
+      grown->Entries = (void **) (grown + 1);
+
+      /* Fill it from the hash table rather than the old array, which might
+       * have missed keys if an earlier grow failed.
+       */
+      hash_table_foreach(table->ht, entry) {
+         GLuint k = (uintptr_t) entry->key;
+         if (k < size)
+            grown->Entries[k] = entry->data;
+      }
+      grown->Entries[DELETED_KEY_VALUE] = table->deleted_key_data;
+
+      /* Publish the filled-in array.  The old one stays allocated, readers
+       * that already loaded it see the same entries it had.
+       */
+      p_atomic_set(&table->Flat, grown);
+      flat = grown;
+   }
+
+   p_atomic_set(&flat->Entries[key], data);
+}
+
+
 /**
  * Lookup an entry in the hash table, without locking.
  * \sa _mesa_HashLookup
@@ -108,10 +188,14 @@ static inline void *
 _mesa_HashLookup_unlocked(struct _mesa_HashTable *table, GLuint key)
 {
    const struct hash_entry *entry;
+   void *data;
 
    assert(table);
    assert(key);
 
+   if (hash_flat_lookup(table, key, &data))
+      return data;
+
    if (key == DELETED_KEY_VALUE)
       return table->deleted_key_data;
 
@@ -127,6 +211,8 @@ _mesa_HashLookup_unlocked(struct _mesa_HashTable *table, GLuint key)
 
 /**
  * Lookup an entry in the hash table.
+ *
+ * Keys covered by the flat array are looked up without taking the mutex.
  * 
  * \param table the hash table.
  * \param key the key.
@@ -137,6 +223,13 @@ void *
 _mesa_HashLookup(struct _mesa_HashTable *table, GLuint key)
 {
    void *res;
+
+   assert(table);
+   assert(key);
+
+   if (hash_flat_lookup(table, key, &res))
+      return res;
+
    _mesa_HashLockMutex(table);
    res = _mesa_HashLookup_unlocked(table, key);
    _mesa_HashUnlockMutex(table);
@@ -174,6 +267,8 @@ _mesa_HashInsert_unlocked(struct _mesa_HashTable *table, GLuint key, void *data)
    if (key > table->MaxKey)
       table->MaxKey = key;
 
+   hash_flat_set(table, key, data);
+
    if (key == DELETED_KEY_VALUE) {
       table->deleted_key_data = data;
    } else {
@@ -244,6 +339,8 @@ _mesa_HashRemove_unlocked(struct _mesa_HashTable *table, GLuint key)
     */
    assert(!table->InDeleteAll);
 
+   hash_flat_set(table, key, NULL);
+
    if (key == DELETED_KEY_VALUE) {
       table->deleted_key_data = NULL;
    } else {
@@ -294,6 +391,10 @@ _mesa_HashDeleteAll(struct _mesa_HashTable *table,
       callback(DELETED_KEY_VALUE, table->deleted_key_data, userData);
       table->deleted_key_data = NULL;
    }
+   if (table->Flat) {
+      for (GLuint i = 0; i < table->Flat->Size; i++)
+         p_atomic_set(&table->Flat->Entries[i], NULL);
+   }
    table->InDeleteAll = GL_FALSE;
    _mesa_HashUnlockMutex(table);
 }
@@ -93,6 +93,29 @@ uint_key(GLuint id)
 }
 /** @} */
 
+/**
+ * Keys below this get mirrored in _mesa_HashTable::Flat, so that looking
+ * them up doesn't need the mutex.  glGen*() hands out small contiguous
+ * names, so in practice this covers nearly every lookup.
+ */
+#define MESA_HASH_FLAT_MAX_KEYS (1 << 16)
+
+/**
+ * Array indexed directly by key, mirroring the entries of the hash table
+ * with keys below \c Size.
+ *
+ * Readers load the array pointer and the entries with acquire semantics and
+ * never take the mutex.  Writers update entries and replace the array while
+ * holding the mutex.  A replaced array is not freed until the table is
+ * destroyed, since a reader may still be looking at it; the arrays double in
+ * size, so the retired ones never take up more than the live one.
+ */
+struct _mesa_HashFlat {
+   GLuint Size;
+   struct _mesa_HashFlat *Retired;       /**< previous, smaller array */
+   void **Entries;                       /**< allocated along with the struct */
+};
+
 /**
  * The hash table data structure.
  */
@@ -103,6 +126,8 @@ struct _mesa_HashTable {
    GLboolean InDeleteAll;                /**< Debug check */
    /** Value that would be in the table for DELETED_KEY_VALUE. */
    void *deleted_key_data;
+   /** Lock-free view of the small keys, may be NULL. */
+   struct _mesa_HashFlat *Flat;
 };
 
 extern struct _mesa_HashTable *_mesa_NewHashTable(void);
@@ -32,6 +32,8 @@
 #include "marshal.h"
 #include "dispatch.h"
 #include "marshal_generated.h"
+#include "util/bitscan.h"
+#include "util/u_atomic.h"
 
 struct marshal_cmd_Flush
 {
@@ -95,6 +97,7 @@ _mesa_marshal_Enable(GLenum cap)
                                             sizeof(*cmd));
       cmd->cap = cap;
       _mesa_post_marshal_hook(ctx);
+      _mesa_glthread_EnableDisable(ctx, cap, true);
       return;
    }
 
@@ -103,6 +106,553 @@ _mesa_marshal_Enable(GLenum cap)
    CALL_Enable(ctx->CurrentServerDispatch, (cap));
 }
 
+/**
+ * A user vertex array uploaded for a draw call.  The worker thread points
+ * the array at the uploaded copy for the duration of the draw.
+ */
+struct marshal_user_array
+{
+   GLuint attrib;
+   const GLubyte *pointer;
+};
+
+/**
+ * Describes the upload of the user vertex arrays of a draw call.  Arrays
+ * that are interleaved are uploaded together, as one range of memory.
+ */
+struct user_arrays_upload
+{
+   GLuint min_index;
+   GLuint max_index;
+
+   /** The arrays, sorted by pointer, and the range each of them is in. */
+   unsigned num_arrays;
+   gl_vert_attrib attribs[VERT_ATTRIB_MAX];
+   unsigned range[VERT_ATTRIB_MAX];
+
+   unsigned num_ranges;
+   struct {
+      /** Pointer of the first array in the range. */
+      const GLubyte *start;
+      GLsizei stride;
+      /** Number of bytes used by each vertex, from start. */
+      GLuint vertex_size;
+   } ranges[VERT_ATTRIB_MAX];
+};
+
+/**
+ * Returns the mask of the enabled user vertex arrays, which draw calls have
+ * to upload.
+ */
+static GLbitfield
+get_user_arrays(struct gl_context *ctx)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+
+   if (ctx->API == API_OPENGL_CORE)
+      return 0;
+
+   _mesa_glthread_validate_client_arrays(ctx);
+   return glthread->arrays.enabled & glthread->arrays.user;
+}
+
+static size_t
+get_range_size(const struct user_arrays_upload *upload, unsigned i)
+{
+   return (size_t)(upload->max_index - upload->min_index) *
+          upload->ranges[i].stride + upload->ranges[i].vertex_size;
+}
+
+/**
+ * Works out how to upload the vertices [min_index, max_index] of the user
+ * vertex arrays in \p mask.
+ *
+ * Returns false if the arrays can't be uploaded, and the draw call has to be
+ * executed synchronously.
+ */
+static bool
+prepare_user_arrays(struct gl_context *ctx, GLbitfield mask,
+                    GLuint min_index, GLuint max_index,
+                    struct user_arrays_upload *upload)
+{
+   const struct glthread_client_arrays *arrays = &ctx->GLThread->arrays;
+   uint64_t total_size = 0;
+
+   /* Instanced arrays aren't indexed by the vertex index. */
+   if (mask & arrays->instanced)
+      return false;
+
+   upload->min_index = min_index;
+   upload->max_index = max_index;
+   upload->num_arrays = 0;
+   upload->num_ranges = 0;
+
+   while (mask) {
+      const gl_vert_attrib attrib = u_bit_scan(&mask);
+      const GLubyte *pointer = arrays->attribs[attrib].pointer;
+      unsigned i = upload->num_arrays++;
+
+      /* Leave enabled arrays without data to the context. */
+      if (!pointer)
+         return false;
+
+      while (i > 0 &&
+             arrays->attribs[upload->attribs[i - 1]].pointer > pointer) {
+         upload->attribs[i] = upload->attribs[i - 1];
+         i--;
+      }
+      upload->attribs[i] = attrib;
+   }
+
+   for (unsigned i = 0; i < upload->num_arrays; i++) {
+      const struct glthread_attrib *a = &arrays->attribs[upload->attribs[i]];
+      unsigned r = upload->num_ranges - 1;
+
+      if (!upload->num_ranges ||
+          upload->ranges[r].stride != a->stride ||
+          a->pointer + a->element_size >
+          upload->ranges[r].start + upload->ranges[r].stride) {
+         r = upload->num_ranges++;
+         upload->ranges[r].start = a->pointer;
+         upload->ranges[r].stride = a->stride;
+         upload->ranges[r].vertex_size = 0;
+      }
+
+      upload->ranges[r].vertex_size =
+         MAX2(upload->ranges[r].vertex_size,
+              a->pointer - upload->ranges[r].start + a->element_size);
+      upload->range[i] = r;
+   }
+
+   for (unsigned i = 0; i < upload->num_ranges; i++) {
+      total_size += (uint64_t)(max_index - min_index) *
+                    upload->ranges[i].stride + upload->ranges[i].vertex_size;
+   }
+
+   return total_size <= MARSHAL_MAX_UPLOAD_SIZE;
+}
+
+/**
+ * Uploads the user vertex arrays prepared by prepare_user_arrays() to the
+ * batch being filled, and fills in \p out for the worker thread.
+ *
+ * Returns false if out of memory.
+ */
+static bool
+upload_user_arrays(struct gl_context *ctx,
+                   const struct user_arrays_upload *upload,
+                   struct marshal_user_array *out)
+{
+   const struct glthread_client_arrays *arrays = &ctx->GLThread->arrays;
+   const GLubyte *base[VERT_ATTRIB_MAX];
+
+   for (unsigned i = 0; i < upload->num_ranges; i++) {
+      const size_t offset =
+         (size_t)upload->min_index * upload->ranges[i].stride;
+      const GLubyte *copy =
+         _mesa_glthread_upload(ctx, upload->ranges[i].start + offset,
+                               get_range_size(upload, i));
+      if (!copy)
+         return false;
+
+      /* Where the start of the range would be if it was copied whole. */
+      base[i] = copy - offset;
+   }
+
+   for (unsigned i = 0; i < upload->num_arrays; i++) {
+      const unsigned r = upload->range[i];
+
+      out[i].attrib = upload->attribs[i];
+      out[i].pointer = base[r] + (arrays->attribs[upload->attribs[i]].pointer -
+                                  upload->ranges[r].start);
+   }
+
+   return true;
+}
+
+/**
+ * Uploads \p size bytes of user indices, or just passes \p indices through
+ * if \p size is 0.
+ *
+ * Returns false if out of memory.
+ */
+static bool
+upload_indices(struct gl_context *ctx, const GLvoid *indices, size_t size,
+               const GLvoid **out)
+{
+   *out = indices;
+   if (!size)
+      return true;
+
+   *out = _mesa_glthread_upload(ctx, indices, size);
+   return *out != NULL;
+}
+
+/**
+ * Removes the command that was allocated last, after an upload for it
+ * failed.
+ */
+static void
+discard_last_command(struct gl_context *ctx,
+                     const struct marshal_cmd_base *cmd_base)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+
+   glthread->batches[glthread->next].used -= cmd_base->cmd_size;
+}
+
+/**
+ * Submits the batch being filled once it references a lot of upload memory,
+ * so that the memory is released in a timely way.
+ */
+static void
+flush_if_upload_full(struct gl_context *ctx)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+
+   if (glthread->batches[glthread->next].upload_used >= MARSHAL_MAX_UPLOAD_SIZE)
+      _mesa_glthread_flush_full_batch(ctx);
+}
+
+/**
+ * Points the user vertex arrays at their uploaded copies, saving the
+ * application pointers to \p saved.
+ */
+static void
+bind_user_arrays(struct gl_context *ctx,
+                 const struct marshal_user_array *user_arrays,
+                 unsigned num_arrays, const GLubyte **saved)
+{
+   struct gl_vertex_array_object *vao = ctx->Array.VAO;
+
+   for (unsigned i = 0; i < num_arrays; i++) {
+      struct gl_array_attributes *array =
+         &vao->VertexAttrib[user_arrays[i].attrib];
+
+      saved[i] = array->Ptr;
+      array->Ptr = user_arrays[i].pointer;
+      vao->NewArrays |= vao->Enabled & VERT_BIT(user_arrays[i].attrib);
+   }
+}
+
+static void
+restore_user_arrays(struct gl_context *ctx,
+                    const struct marshal_user_array *user_arrays,
+                    unsigned num_arrays, const GLubyte **saved)
+{
+   struct gl_vertex_array_object *vao = ctx->Array.VAO;
+
+   for (unsigned i = 0; i < num_arrays; i++) {
+      vao->VertexAttrib[user_arrays[i].attrib].Ptr = saved[i];
+      vao->NewArrays |= vao->Enabled & VERT_BIT(user_arrays[i].attrib);
+   }
+}
+
+static unsigned
+get_index_size(GLenum type)
+{
+   switch (type) {
+   case GL_UNSIGNED_BYTE:
+      return 1;
+   case GL_UNSIGNED_SHORT:
+      return 2;
+   case GL_UNSIGNED_INT:
+      return 4;
+   default:
+      return 0;
+   }
+}
+
+static void
+get_index_range(GLenum type, const void *indices, GLsizei count,
+                GLuint *min_index, GLuint *max_index)
+{
+   GLuint min = ~0u, max = 0;
+
+   switch (type) {
+   case GL_UNSIGNED_BYTE:
+      for (GLsizei i = 0; i < count; i++) {
+         min = MIN2(min, ((const GLubyte *)indices)[i]);
+         max = MAX2(max, ((const GLubyte *)indices)[i]);
+      }
+      break;
+   case GL_UNSIGNED_SHORT:
+      for (GLsizei i = 0; i < count; i++) {
+         min = MIN2(min, ((const GLushort *)indices)[i]);
+         max = MAX2(max, ((const GLushort *)indices)[i]);
+      }
+      break;
+   case GL_UNSIGNED_INT:
+      for (GLsizei i = 0; i < count; i++) {
+         min = MIN2(min, ((const GLuint *)indices)[i]);
+         max = MAX2(max, ((const GLuint *)indices)[i]);
+      }
+      break;
+   default:
+      unreachable("invalid index type");
+   }
+
+   *min_index = min;
+   *max_index = max;
+}
+
+/**
+ * Works out the upload of the user vertex arrays and indices of an indexed
+ * draw call.  If the application gave the index range, \p min_index and
+ * \p max_index are that range, otherwise they are NULL.
+ *
+ * Returns false if the draw call has to be executed synchronously.
+ */
+static bool
+prepare_indexed_draw(struct gl_context *ctx, GLsizei count, GLenum type,
+                     const GLvoid *indices, const GLuint *min_index,
+                     const GLuint *max_index,
+                     struct user_arrays_upload *upload,
+                     size_t *indices_size)
+{
+   struct glthread_state *glthread = ctx->GLThread;
+   const GLbitfield user_arrays = get_user_arrays(ctx);
+   const unsigned index_size = get_index_size(type);
+   const bool user_indices = ctx->API != API_OPENGL_CORE &&
+                             !glthread->element_array_is_vbo;
+
+   upload->num_arrays = 0;
+   *indices_size = 0;
+
+   /* Let the context deal with calls that are errors or don't draw. */
+   if (count <= 0 || !index_size || (user_indices && !indices))
+      return true;
+
+   if (user_indices) {
+      *indices_size = (size_t)count * index_size;
+      if (*indices_size > MARSHAL_MAX_UPLOAD_SIZE)
+         return false;
+   }
+
+   if (!user_arrays)
+      return true;
+
+   if (min_index) {
+      if (*max_index < *min_index)
+         return true;
+
+      return prepare_user_arrays(ctx, user_arrays, *min_index, *max_index,
+                                 upload);
+   }
+
+   /* The index range of indices in a VBO or with primitive restart isn't
+    * known here.
+    */
+   if (!user_indices || glthread->arrays.primitive_restart ||
+       glthread->arrays.primitive_restart_fixed_index)
+      return false;
+
+   GLuint min, max;
+   get_index_range(type, indices, count, &min, &max);
+   return prepare_user_arrays(ctx, user_arrays, min, max, upload);
+}
+
+
+/* DrawArrays: marshalled asynchronously, uploading user vertex arrays */
+struct marshal_cmd_DrawArrays
+{
+   struct marshal_cmd_base cmd_base;
+   GLenum mode;
+   GLint first;
+   GLsizei count;
+   GLuint num_user_arrays;
+   struct marshal_user_array user_arrays[];
+};
+
+void
+_mesa_unmarshal_DrawArrays(struct gl_context *ctx,
+                           const struct marshal_cmd_DrawArrays *cmd)
+{
+   const GLubyte *saved[VERT_ATTRIB_MAX];
+
+   bind_user_arrays(ctx, cmd->user_arrays, cmd->num_user_arrays, saved);
+   CALL_DrawArrays(ctx->CurrentServerDispatch,
+                   (cmd->mode, cmd->first, cmd->count));
+   restore_user_arrays(ctx, cmd->user_arrays, cmd->num_user_arrays, saved);
+}
+
+void GLAPIENTRY
+_mesa_marshal_DrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   const GLbitfield user_arrays = get_user_arrays(ctx);
+   struct user_arrays_upload upload;
+   struct marshal_cmd_DrawArrays *cmd;
+   debug_print_marshal("DrawArrays");
+
+   upload.num_arrays = 0;
+   if (user_arrays && first >= 0 && count > 0 &&
+       !prepare_user_arrays(ctx, user_arrays, first,
+                            (GLuint)first + count - 1, &upload))
+      goto fallback_to_sync;
+
+   cmd = _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_DrawArrays,
+                                         sizeof(*cmd) + upload.num_arrays *
+                                         sizeof(cmd->user_arrays[0]));
+   cmd->mode = mode;
+   cmd->first = first;
+   cmd->count = count;
+   cmd->num_user_arrays = upload.num_arrays;
+
+   if (!upload_user_arrays(ctx, &upload, cmd->user_arrays)) {
+      discard_last_command(ctx, &cmd->cmd_base);
+      goto fallback_to_sync;
+   }
+
+   _mesa_post_marshal_hook(ctx);
+   flush_if_upload_full(ctx);
+   return;
+
+fallback_to_sync:
+   _mesa_glthread_finish(ctx);
+   debug_print_sync_fallback("DrawArrays");
+   CALL_DrawArrays(ctx->CurrentServerDispatch, (mode, first, count));
+}
+
+
+/* DrawElements: marshalled asynchronously, uploading user vertex arrays and
+ * indices
+ */
+struct marshal_cmd_DrawElements
+{
+   struct marshal_cmd_base cmd_base;
+   GLenum mode;
+   GLsizei count;
+   GLenum type;
+   const GLvoid *indices;
+   GLuint num_user_arrays;
+   struct marshal_user_array user_arrays[];
+};
+
+void
+_mesa_unmarshal_DrawElements(struct gl_context *ctx,
+                             const struct marshal_cmd_DrawElements *cmd)
+{
+   const GLubyte *saved[VERT_ATTRIB_MAX];
+
+   bind_user_arrays(ctx, cmd->user_arrays, cmd->num_user_arrays, saved);
+   CALL_DrawElements(ctx->CurrentServerDispatch,
+                     (cmd->mode, cmd->count, cmd->type, cmd->indices));
+   restore_user_arrays(ctx, cmd->user_arrays, cmd->num_user_arrays, saved);
+}
+
+void GLAPIENTRY
+_mesa_marshal_DrawElements(GLenum mode, GLsizei count, GLenum type,
+                           const GLvoid *indices)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   struct user_arrays_upload upload;
+   size_t indices_size;
+   struct marshal_cmd_DrawElements *cmd;
+   debug_print_marshal("DrawElements");
+
+   if (!prepare_indexed_draw(ctx, count, type, indices, NULL, NULL,
+                             &upload, &indices_size))
+      goto fallback_to_sync;
+
+   cmd = _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_DrawElements,
+                                         sizeof(*cmd) + upload.num_arrays *
+                                         sizeof(cmd->user_arrays[0]));
+   cmd->mode = mode;
+   cmd->count = count;
+   cmd->type = type;
+   cmd->indices = indices;
+   cmd->num_user_arrays = upload.num_arrays;
+
+   if (!upload_indices(ctx, indices, indices_size, &cmd->indices) ||
+       !upload_user_arrays(ctx, &upload, cmd->user_arrays)) {
+      discard_last_command(ctx, &cmd->cmd_base);
+      goto fallback_to_sync;
+   }
+
+   _mesa_post_marshal_hook(ctx);
+   flush_if_upload_full(ctx);
+   return;
+
+fallback_to_sync:
+   _mesa_glthread_finish(ctx);
+   debug_print_sync_fallback("DrawElements");
+   CALL_DrawElements(ctx->CurrentServerDispatch, (mode, count, type, indices));
+}
+
+
+/* DrawRangeElements: marshalled asynchronously, uploading user vertex arrays
+ * and indices
+ */
+struct marshal_cmd_DrawRangeElements
+{
+   struct marshal_cmd_base cmd_base;
+   GLenum mode;
+   GLuint start;
+   GLuint end;
+   GLsizei count;
+   GLenum type;
+   const GLvoid *indices;
+   GLuint num_user_arrays;
+   struct marshal_user_array user_arrays[];
+};
+
+void
+_mesa_unmarshal_DrawRangeElements(struct gl_context *ctx,
+                                  const struct marshal_cmd_DrawRangeElements *cmd)
+{
+   const GLubyte *saved[VERT_ATTRIB_MAX];
+
+   bind_user_arrays(ctx, cmd->user_arrays, cmd->num_user_arrays, saved);
+   CALL_DrawRangeElements(ctx->CurrentServerDispatch,
+                          (cmd->mode, cmd->start, cmd->end, cmd->count,
+                           cmd->type, cmd->indices));
+   restore_user_arrays(ctx, cmd->user_arrays, cmd->num_user_arrays, saved);
+}
+
+void GLAPIENTRY
+_mesa_marshal_DrawRangeElements(GLenum mode, GLuint start, GLuint end,
+                                GLsizei count, GLenum type,
+                                const GLvoid *indices)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   struct user_arrays_upload upload;
+   size_t indices_size;
+   struct marshal_cmd_DrawRangeElements *cmd;
+   debug_print_marshal("DrawRangeElements");
+
+   if (!prepare_indexed_draw(ctx, count, type, indices, &start, &end,
+                             &upload, &indices_size))
+      goto fallback_to_sync;
+
+   cmd = _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_DrawRangeElements,
+                                         sizeof(*cmd) + upload.num_arrays *
+                                         sizeof(cmd->user_arrays[0]));
+   cmd->mode = mode;
+   cmd->start = start;
+   cmd->end = end;
+   cmd->count = count;
+   cmd->type = type;
+   cmd->indices = indices;
+   cmd->num_user_arrays = upload.num_arrays;
+
+   if (!upload_indices(ctx, indices, indices_size, &cmd->indices) ||
+       !upload_user_arrays(ctx, &upload, cmd->user_arrays)) {
+      discard_last_command(ctx, &cmd->cmd_base);
+      goto fallback_to_sync;
+   }
+
+   _mesa_post_marshal_hook(ctx);
+   flush_if_upload_full(ctx);
+   return;
+
+fallback_to_sync:
+   _mesa_glthread_finish(ctx);
+   debug_print_sync_fallback("DrawRangeElements");
+   CALL_DrawRangeElements(ctx->CurrentServerDispatch,
+                          (mode, start, end, count, type, indices));
+}
+
 struct marshal_cmd_ShaderSource
 {
    struct marshal_cmd_base cmd_base;
@@ -206,10 +756,9 @@ struct marshal_cmd_BindBufferBase
 
 /** Tracks the current bindings for the vertex array and index array buffers.
  *
- * This is part of what we need to enable glthread on compat-GL contexts that
- * happen to use VBOs, without also supporting the full tracking of VBO vs
- * user vertex array bindings per attribute on each vertex array for
- * determining what to upload at draw call time.
+ * This is what tells whether the vertex arrays set by glVertexPointer() and
+ * friends, and the indices of draw calls, are in user memory and need to be
+ * uploaded at draw call time (see glthread_varray.c).
  *
  * Note that GL core makes it so that a buffer binding with an invalid handle
  * in the "buffer" parameter will throw an error, and then a
@@ -235,6 +784,7 @@ track_vbo_binding(struct gl_context *ctx, GLenum target, GLuint buffer)
    switch (target) {
    case GL_ARRAY_BUFFER:
       glthread->vertex_array_is_vbo = (buffer != 0);
+      glthread->shadow.array_buffer = buffer;
       break;
    case GL_ELEMENT_ARRAY_BUFFER:
       /* The current element array buffer binding is actually tracked in the
@@ -242,6 +792,8 @@ track_vbo_binding(struct gl_context *ctx, GLenum target, GLuint buffer)
        * change on vertex array object updates.
        */
       glthread->element_array_is_vbo = (buffer != 0);
+      if (!glthread->shadow.vertex_array)
+         glthread->shadow.element_array_buffer = buffer;
       break;
    }
 }
@@ -296,7 +848,10 @@ struct marshal_cmd_BufferData
    GLsizeiptr size;
    GLenum usage;
    bool data_null; /* If set, no data follows for "data" */
-   /* Next size bytes are GLubyte data[size] */
+   /* If set, the data is carried out of line, otherwise the next size
+    * bytes are GLubyte data[size]
+    */
+   const GLubyte *data;
 };
 
 void
@@ -310,6 +865,8 @@ _mesa_unmarshal_BufferData(struct gl_context *ctx,
 
    if (cmd->data_null)
       data = NULL;
+   else if (cmd->data)
+      data = cmd->data;
    else
       data = (const void *) (cmd + 1);
 
@@ -331,26 +888,38 @@ _mesa_marshal_BufferData(GLenum target, GLsizeiptr size, const GLvoid * data,
       return;
    }
 
+   const bool inline_data = cmd_size <= MARSHAL_MAX_CMD_SIZE;
+
    if (target != GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD &&
-       cmd_size <= MARSHAL_MAX_CMD_SIZE) {
+       (inline_data || size <= MARSHAL_MAX_UPLOAD_SIZE)) {
       struct marshal_cmd_BufferData *cmd =
          _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_BufferData,
-                                         cmd_size);
+                                         inline_data ? cmd_size :
+                                                       sizeof(*cmd));
 
       cmd->target = target;
       cmd->size = size;
       cmd->usage = usage;
       cmd->data_null = !data;
-      if (data) {
+      cmd->data = NULL;
+      if (data && inline_data) {
          char *variable_data = (char *) (cmd + 1);
          memcpy(variable_data, data, size);
+      } else if (data) {
+         cmd->data = _mesa_glthread_upload(ctx, data, size);
+         if (!cmd->data) {
+            discard_last_command(ctx, &cmd->cmd_base);
+            goto fallback_to_sync;
+         }
       }
       _mesa_post_marshal_hook(ctx);
-   } else {
-      _mesa_glthread_finish(ctx);
-      CALL_BufferData(ctx->CurrentServerDispatch,
-                      (target, size, data, usage));
+      flush_if_upload_full(ctx);
+      return;
    }
+
+fallback_to_sync:
+   _mesa_glthread_finish(ctx);
+   CALL_BufferData(ctx->CurrentServerDispatch, (target, size, data, usage));
 }
 
 /* BufferSubData: marshalled asynchronously */
@@ -360,7 +929,10 @@ struct marshal_cmd_BufferSubData
    GLenum target;
    GLintptr offset;
    GLsizeiptr size;
-   /* Next size bytes are GLubyte data[size] */
+   /* If set, the data is carried out of line, otherwise the next size
+    * bytes are GLubyte data[size]
+    */
+   const GLubyte *data;
 };
 
 void
@@ -370,7 +942,7 @@ _mesa_unmarshal_BufferSubData(struct gl_context *ctx,
    const GLenum target = cmd->target;
    const GLintptr offset = cmd->offset;
    const GLsizeiptr size = cmd->size;
-   const void *data = (const void *) (cmd + 1);
+   const void *data = cmd->data ? cmd->data : (const void *) (cmd + 1);
 
    CALL_BufferSubData(ctx->CurrentServerDispatch,
                       (target, offset, size, data));
@@ -390,22 +962,37 @@ _mesa_marshal_BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size,
       return;
    }
 
+   const bool inline_data = cmd_size <= MARSHAL_MAX_CMD_SIZE;
+
    if (target != GL_EXTERNAL_VIRTUAL_MEMORY_BUFFER_AMD &&
-       cmd_size <= MARSHAL_MAX_CMD_SIZE) {
+       (inline_data || size <= MARSHAL_MAX_UPLOAD_SIZE)) {
       struct marshal_cmd_BufferSubData *cmd =
          _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_BufferSubData,
-                                         cmd_size);
+                                         inline_data ? cmd_size :
+                                                       sizeof(*cmd));
       cmd->target = target;
       cmd->offset = offset;
       cmd->size = size;
-      char *variable_data = (char *) (cmd + 1);
-      memcpy(variable_data, data, size);
+      cmd->data = NULL;
+      if (inline_data) {
+         char *variable_data = (char *) (cmd + 1);
+         memcpy(variable_data, data, size);
+      } else {
+         cmd->data = _mesa_glthread_upload(ctx, data, size);
+         if (!cmd->data) {
+            discard_last_command(ctx, &cmd->cmd_base);
+            goto fallback_to_sync;
+         }
+      }
       _mesa_post_marshal_hook(ctx);
-   } else {
-      _mesa_glthread_finish(ctx);
-      CALL_BufferSubData(ctx->CurrentServerDispatch,
-                         (target, offset, size, data));
+      flush_if_upload_full(ctx);
+      return;
    }
+
+fallback_to_sync:
+   _mesa_glthread_finish(ctx);
+   CALL_BufferSubData(ctx->CurrentServerDispatch,
+                      (target, offset, size, data));
 }
 
 /* NamedBufferData: marshalled asynchronously */
@@ -416,7 +1003,10 @@ struct marshal_cmd_NamedBufferData
    GLsizei size;
    GLenum usage;
    bool data_null; /* If set, no data follows for "data" */
-   /* Next size bytes are GLubyte data[size] */
+   /* If set, the data is carried out of line, otherwise the next size
+    * bytes are GLubyte data[size]
+    */
+   const GLubyte *data;
 };
 
 void
@@ -430,6 +1020,8 @@ _mesa_unmarshal_NamedBufferData(struct gl_context *ctx,
 
    if (cmd->data_null)
       data = NULL;
+   else if (cmd->data)
+      data = cmd->data;
    else
       data = (const void *) (cmd + 1);
 
@@ -451,24 +1043,37 @@ _mesa_marshal_NamedBufferData(GLuint buffer, GLsizeiptr size,
       return;
    }
 
-   if (buffer > 0 && cmd_size <= MARSHAL_MAX_CMD_SIZE) {
+   const bool inline_data = cmd_size <= MARSHAL_MAX_CMD_SIZE;
+
+   if (buffer > 0 && (inline_data || size <= MARSHAL_MAX_UPLOAD_SIZE)) {
       struct marshal_cmd_NamedBufferData *cmd =
          _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_NamedBufferData,
-                                         cmd_size);
+                                         inline_data ? cmd_size :
+                                                       sizeof(*cmd));
       cmd->name = buffer;
       cmd->size = size;
       cmd->usage = usage;
       cmd->data_null = !data;
-      if (data) {
+      cmd->data = NULL;
+      if (data && inline_data) {
          char *variable_data = (char *) (cmd + 1);
          memcpy(variable_data, data, size);
+      } else if (data) {
+         cmd->data = _mesa_glthread_upload(ctx, data, size);
+         if (!cmd->data) {
+            discard_last_command(ctx, &cmd->cmd_base);
+            goto fallback_to_sync;
+         }
       }
       _mesa_post_marshal_hook(ctx);
-   } else {
-      _mesa_glthread_finish(ctx);
-      CALL_NamedBufferData(ctx->CurrentServerDispatch,
-                           (buffer, size, data, usage));
+      flush_if_upload_full(ctx);
+      return;
    }
+
+fallback_to_sync:
+   _mesa_glthread_finish(ctx);
+   CALL_NamedBufferData(ctx->CurrentServerDispatch,
+                        (buffer, size, data, usage));
 }
 
 /* NamedBufferSubData: marshalled asynchronously */
@@ -478,7 +1083,10 @@ struct marshal_cmd_NamedBufferSubData
    GLuint name;
    GLintptr offset;
    GLsizei size;
-   /* Next size bytes are GLubyte data[size] */
+   /* If set, the data is carried out of line, otherwise the next size
+    * bytes are GLubyte data[size]
+    */
+   const GLubyte *data;
 };
 
 void
@@ -488,7 +1096,7 @@ _mesa_unmarshal_NamedBufferSubData(struct gl_context *ctx,
    const GLuint name = cmd->name;
    const GLintptr offset = cmd->offset;
    const GLsizei size = cmd->size;
-   const void *data = (const void *) (cmd + 1);
+   const void *data = cmd->data ? cmd->data : (const void *) (cmd + 1);
 
    CALL_NamedBufferSubData(ctx->CurrentServerDispatch,
                            (name, offset, size, data));
@@ -508,21 +1116,36 @@ _mesa_marshal_NamedBufferSubData(GLuint buffer, GLintptr offset,
       return;
    }
 
-   if (buffer > 0 && cmd_size <= MARSHAL_MAX_CMD_SIZE) {
+   const bool inline_data = cmd_size <= MARSHAL_MAX_CMD_SIZE;
+
+   if (buffer > 0 && (inline_data || size <= MARSHAL_MAX_UPLOAD_SIZE)) {
       struct marshal_cmd_NamedBufferSubData *cmd =
          _mesa_glthread_allocate_command(ctx, DISPATCH_CMD_NamedBufferSubData,
-                                         cmd_size);
+                                         inline_data ? cmd_size :
+                                                       sizeof(*cmd));
       cmd->name = buffer;
       cmd->offset = offset;
       cmd->size = size;
-      char *variable_data = (char *) (cmd + 1);
-      memcpy(variable_data, data, size);
+      cmd->data = NULL;
+      if (inline_data) {
+         char *variable_data = (char *) (cmd + 1);
+         memcpy(variable_data, data, size);
+      } else {
+         cmd->data = _mesa_glthread_upload(ctx, data, size);
+         if (!cmd->data) {
+            discard_last_command(ctx, &cmd->cmd_base);
+            goto fallback_to_sync;
+         }
+      }
       _mesa_post_marshal_hook(ctx);
-   } else {
-      _mesa_glthread_finish(ctx);
-      CALL_NamedBufferSubData(ctx->CurrentServerDispatch,
-                              (buffer, offset, size, data));
+      flush_if_upload_full(ctx);
+      return;
    }
+
+fallback_to_sync:
+   _mesa_glthread_finish(ctx);
+   CALL_NamedBufferSubData(ctx->CurrentServerDispatch,
+                           (buffer, offset, size, data));
 }
 
 /* ClearBuffer* (all variants): marshalled asynchronously */
@@ -747,3 +1370,49 @@ _mesa_marshal_ClearBufferfi(GLenum buffer, GLint drawbuffer,
                          (buffer, drawbuffer, depth, stencil));
    }
 }
+
+
+/* GetIntegerv: answered on the main thread when possible */
+void GLAPIENTRY
+_mesa_marshal_GetIntegerv(GLenum pname, GLint *params)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   debug_print_marshal("GetIntegerv");
+
+   if (_mesa_glthread_GetIntegerv(ctx, pname, params))
+      return;
+
+   _mesa_glthread_finish(ctx);
+   debug_print_sync_fallback("GetIntegerv");
+   CALL_GetIntegerv(ctx->CurrentServerDispatch, (pname, params));
+}
+
+
+/* GetError: answered on the main thread for KHR_no_error contexts */
+GLenum GLAPIENTRY
+_mesa_marshal_GetError(void)
+{
+   GET_CURRENT_CONTEXT(ctx);
+   struct glthread_state *glthread = ctx->GLThread;
+   debug_print_marshal("GetError");
+
+   /* From Issue (3) of the KHR_no_error spec:
+    *
+    *    "Should glGetError() always return NO_ERROR or have undefined
+    *    results?
+    *
+    *    RESOLVED: It should for all errors except OUT_OF_MEMORY."
+    *
+    * So we only need to synchronize once the worker thread has left an
+    * error in the context.  An out of memory error of a command that is
+    * still queued is then returned by a later glGetError() call.
+    */
+   if (_mesa_is_no_error_enabled(ctx) &&
+       !p_atomic_read(&glthread->error_pending))
+      return GL_NO_ERROR;
+
+   _mesa_glthread_finish(ctx);
+   glthread->error_pending = false;
+   debug_print_sync_fallback("GetError");
+   return CALL_GetError(ctx->CurrentServerDispatch, ());
+}
@@ -57,8 +57,8 @@ _mesa_glthread_allocate_command(struct gl_context *ctx,
    struct marshal_cmd_base *cmd_base;
    const size_t aligned_size = ALIGN(size, 8);
 
-   if (unlikely(next->used + size > MARSHAL_MAX_CMD_SIZE)) {
-      _mesa_glthread_flush_batch(ctx);
+   if (unlikely(next->used + size > glthread->batch_size)) {
+      _mesa_glthread_flush_full_batch(ctx);
       next = &glthread->batches[glthread->next];
    }
 
@@ -70,21 +70,26 @@ _mesa_glthread_allocate_command(struct gl_context *ctx,
 }
 
 /**
- * Instead of conditionally handling marshaling previously-bound user vertex
- * array data in draw calls (deprecated and removed in GL core), we just
- * disable threading at the point where the user sets a user vertex array.
+ * User vertex arrays (deprecated and removed in GL core) are uploaded by
+ * glDrawArrays(), glDrawElements() and glDrawRangeElements().  Other draw
+ * calls are executed synchronously when they might source from one.
  */
 static inline bool
-_mesa_glthread_is_non_vbo_vertex_attrib_pointer(const struct gl_context *ctx)
+_mesa_glthread_has_non_vbo_vertex_arrays(struct gl_context *ctx)
 {
    struct glthread_state *glthread = ctx->GLThread;
 
-   return ctx->API != API_OPENGL_CORE && !glthread->vertex_array_is_vbo;
+   if (ctx->API == API_OPENGL_CORE)
+      return false;
+
+   _mesa_glthread_validate_client_arrays(ctx);
+   return (glthread->arrays.enabled & glthread->arrays.user) != 0;
 }
 
 /**
- * Instead of conditionally handling marshaling immediate index data in draw
- * calls (deprecated and removed in GL core), we just disable threading.
+ * Immediate index data (deprecated and removed in GL core) is uploaded by
+ * glDrawElements() and glDrawRangeElements().  For other draw calls, instead
+ * of conditionally handling marshaling it, we just disable threading.
  */
 static inline bool
 _mesa_glthread_is_non_vbo_draw_elements(const struct gl_context *ctx)
@@ -175,6 +180,9 @@ _mesa_glthread_is_compat_bind_vertex_array(const struct gl_context *ctx)
 }
 
 struct marshal_cmd_Enable;
+struct marshal_cmd_DrawArrays;
+struct marshal_cmd_DrawElements;
+struct marshal_cmd_DrawRangeElements;
 struct marshal_cmd_ShaderSource;
 struct marshal_cmd_Flush;
 struct marshal_cmd_BindBuffer;
@@ -195,6 +203,30 @@ _mesa_unmarshal_Enable(struct gl_context *ctx,
 void GLAPIENTRY
 _mesa_marshal_Enable(GLenum cap);
 
+void
+_mesa_unmarshal_DrawArrays(struct gl_context *ctx,
+                           const struct marshal_cmd_DrawArrays *cmd);
+
+void GLAPIENTRY
+_mesa_marshal_DrawArrays(GLenum mode, GLint first, GLsizei count);
+
+void
+_mesa_unmarshal_DrawElements(struct gl_context *ctx,
+                             const struct marshal_cmd_DrawElements *cmd);
+
+void GLAPIENTRY
+_mesa_marshal_DrawElements(GLenum mode, GLsizei count, GLenum type,
+                           const GLvoid *indices);
+
+void
+_mesa_unmarshal_DrawRangeElements(struct gl_context *ctx,
+                                  const struct marshal_cmd_DrawRangeElements *cmd);
+
+void GLAPIENTRY
+_mesa_marshal_DrawRangeElements(GLenum mode, GLuint start, GLuint end,
+                                GLsizei count, GLenum type,
+                                const GLvoid *indices);
+
 void GLAPIENTRY
 _mesa_marshal_ShaderSource(GLuint shader, GLsizei count,
                            const GLchar * const *string, const GLint *length);
@@ -281,4 +313,10 @@ void GLAPIENTRY
 _mesa_marshal_ClearBufferfi(GLenum buffer, GLint drawbuffer,
                             const GLfloat depth, const GLint stencil);
 
+void GLAPIENTRY
+_mesa_marshal_GetIntegerv(GLenum pname, GLint *params);
+
+GLenum GLAPIENTRY
+_mesa_marshal_GetError(void);
+
 #endif /* MARSHAL_H */
@@ -3193,6 +3193,13 @@ struct gl_shader_compiler_options
    /** Clamp UBO and SSBO block indices so they don't go out-of-bounds. */
    GLboolean ClampBlockIndicesToArrayBounds;
 
+   /**
+    * Skip the GLSL IR optimizations when compiling, and only run them on
+    * the linked IR.  For drivers which optimize again in NIR after
+    * glsl_to_nir, the compile-time pass mostly repeats work.
+    */
+   GLboolean OptimizeAtLinkOnly;
+
    const struct nir_shader_compiler_options *NirOptions;
 };
 
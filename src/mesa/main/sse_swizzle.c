@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "main/sse_swizzle.h"
+#include "main/formats.h"
+#include <smmintrin.h>
+
+/**
+ * Swizzle 3 or 4 channel ubyte pixels into 4 channel ubyte pixels, four
+ * pixels per pshufb.
+ *
+ * A swizzle entry below \p num_src_channels selects a source channel,
+ * MESA_FORMAT_SWIZZLE_ONE gives \p one and anything else gives 0.
+ */
+void
+_mesa_sse_swizzle_ubyte_to_rgba(uint8_t *dst, const uint8_t *src,
+                                int num_src_channels,
+                                const uint8_t swizzle[4], uint8_t one,
+                                int count)
+{
+   uint8_t shuffle[16], constant[16];
+   int i, p, c;
+
+   for (p = 0; p < 4; p++) {
+      for (c = 0; c < 4; c++) {
+         if (swizzle[c] < num_src_channels) {
+            shuffle[p * 4 + c] = p * num_src_channels + swizzle[c];
+            constant[p * 4 + c] = 0;
+         } else {
+            /* The high bit makes pshufb write a zero. */
+            shuffle[p * 4 + c] = 0x80;
+            constant[p * 4 + c] =
+               swizzle[c] == MESA_FORMAT_SWIZZLE_ONE ? one : 0;
+         }
+      }
+   }
+
+   const __m128i shuffle4 = _mm_loadu_si128((const __m128i *) shuffle);
+   const __m128i constant4 = _mm_loadu_si128((const __m128i *) constant);
+
+   /* Four RGB pixels only use 12 of the 16 bytes loaded, so stop early
+    * enough for the load not to run past the end of the source.
+    */
+   const int tail = num_src_channels == 3 ? 2 : 0;
+
+   for (i = 0; i + 4 + tail <= count; i += 4) {
+      __m128i pixels =
+         _mm_loadu_si128((const __m128i *) (src + i * num_src_channels));
+      pixels = _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle4), constant4);
+      _mm_storeu_si128((__m128i *) (dst + i * 4), pixels);
+   }
+
+   for (; i < count; i++) {
+      const uint8_t *s = src + i * num_src_channels;
+
+      for (c = 0; c < 4; c++) {
+         dst[i * 4 + c] = swizzle[c] < num_src_channels ?
+            s[swizzle[c]] : constant[c];
+      }
+   }
+}
@@ -36,6 +36,8 @@
 #include "texcompress_astc.h"
 #include "macros.h"
 #include "util/half_float.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_queue.h"
 #include <stdio.h>
 
 static bool VERBOSE_DECODE = false;
@@ -1814,33 +1816,61 @@ decode_error::type Block::calculate_colour_endpoints_size()
 }
 
 /**
- * Decode ASTC 2D LDR texture data.
- *
- * \param src_width in pixels
- * \param src_height in pixels
- * \param dst_stride in bytes
+ * Images with at least this many blocks are decoded in bands of block rows
+ * spread over a thread pool.  ASTC decoding is slow enough that this pays
+ * off already for fairly small images.
  */
-extern "C" void
-_mesa_unpack_astc_2d_ldr(uint8_t *dst_row,
-                         unsigned dst_stride,
-                         const uint8_t *src_row,
-                         unsigned src_stride,
-                         unsigned src_width,
-                         unsigned src_height,
-                         mesa_format format)
+#define ASTC_PARALLEL_MIN_BLOCKS 4096
+#define ASTC_MAX_BANDS 8
+
+struct astc_band {
+   struct util_queue_fence fence;
+   const Decoder *dec;
+   uint8_t *dst_row;
+   unsigned dst_stride;
+   const uint8_t *src_row;
+   unsigned src_stride;
+   unsigned src_width;
+   unsigned src_height;
+};
+
+static struct util_queue astc_queue;
+static unsigned astc_num_threads;
+static once_flag astc_queue_once = ONCE_FLAG_INIT;
+
+static void
+astc_queue_init(void)
 {
-   assert(_mesa_is_format_astc_2d(format));
-   bool srgb = _mesa_get_format_color_encoding(format) == GL_SRGB;
+   util_cpu_detect();
 
-   unsigned blk_w, blk_h;
-   _mesa_get_format_block_size(format, &blk_w, &blk_h);
+   unsigned num_threads = MIN2(util_cpu_caps.nr_cpus, ASTC_MAX_BANDS) - 1;
+   if (num_threads &&
+       util_queue_init(&astc_queue, "astc", ASTC_MAX_BANDS, num_threads,
+                       UTIL_QUEUE_INIT_RESIZE_IF_FULL))
+      astc_num_threads = num_threads;
+}
+
+/**
+ * Decode a band of block rows. src_height is in pixels and the band starts
+ * at a block row boundary.
+ */
+static void
+astc_decode_band(void *data, UNUSED int thread_index)
+{
+   const struct astc_band *band = (const struct astc_band *)data;
+   const Decoder &dec = *band->dec;
+   const unsigned blk_w = dec.block_w;
+   const unsigned blk_h = dec.block_h;
+   const unsigned src_width = band->src_width;
+   const unsigned src_height = band->src_height;
+   const unsigned dst_stride = band->dst_stride;
+   const uint8_t *src_row = band->src_row;
+   uint8_t *dst_row = band->dst_row;
 
    const unsigned block_size = 16;
    unsigned x_blocks = (src_width + blk_w - 1) / blk_w;
    unsigned y_blocks = (src_height + blk_h - 1) / blk_h;
 
-   Decoder dec(blk_w, blk_h, 1, srgb, true);
-
    for (unsigned y = 0; y < y_blocks; ++y) {
       for (unsigned x = 0; x < x_blocks; ++x) {
          /* Same size as the largest block. */
@@ -1865,7 +1895,75 @@ _mesa_unpack_astc_2d_ldr(uint8_t *dst_row,
             }
          }
       }
-      src_row += src_stride;
+      src_row += band->src_stride;
       dst_row += dst_stride * blk_h;
    }
 }
+
+/**
+ * Decode ASTC 2D LDR texture data.
+ *
+ * \param src_width in pixels
+ * \param src_height in pixels
+ * \param dst_stride in bytes
+ */
+extern "C" void
+_mesa_unpack_astc_2d_ldr(uint8_t *dst_row,
+                         unsigned dst_stride,
+                         const uint8_t *src_row,
+                         unsigned src_stride,
+                         unsigned src_width,
+                         unsigned src_height,
+                         mesa_format format)
+{
+   assert(_mesa_is_format_astc_2d(format));
+   bool srgb = _mesa_get_format_color_encoding(format) == GL_SRGB;
+
+   unsigned blk_w, blk_h;
+   _mesa_get_format_block_size(format, &blk_w, &blk_h);
+
+   unsigned x_blocks = (src_width + blk_w - 1) / blk_w;
+   unsigned y_blocks = (src_height + blk_h - 1) / blk_h;
+   unsigned num_bands = 1;
+
+   Decoder dec(blk_w, blk_h, 1, srgb, true);
+
+   if (x_blocks * y_blocks >= ASTC_PARALLEL_MIN_BLOCKS) {
+      call_once(&astc_queue_once, astc_queue_init);
+      num_bands = MIN2(astc_num_threads + 1, y_blocks);
+   }
+
+   struct astc_band bands[ASTC_MAX_BANDS];
+   const unsigned block_rows_per_band = DIV_ROUND_UP(y_blocks, num_bands);
+   unsigned y = 0;
+   unsigned i;
+
+   /* The first band is decoded by this thread, the others on the queue. */
+   for (i = 0; i < num_bands && y < y_blocks; i++) {
+      struct astc_band *band = &bands[i];
+      unsigned block_rows = MIN2(block_rows_per_band, y_blocks - y);
+
+      band->dec = &dec;
+      band->dst_row = dst_row + y * blk_h * dst_stride;
+      band->dst_stride = dst_stride;
+      band->src_row = src_row + y * src_stride;
+      band->src_stride = src_stride;
+      band->src_width = src_width;
+      band->src_height = MIN2(block_rows * blk_h, src_height - y * blk_h);
+      y += block_rows;
+
+      if (i > 0) {
+         util_queue_fence_init(&band->fence);
+         util_queue_add_job(&astc_queue, band, &band->fence,
+                            astc_decode_band, NULL);
+      }
+   }
+   num_bands = i;
+
+   astc_decode_band(&bands[0], 0);
+
+   for (i = 1; i < num_bands; i++) {
+      util_queue_fence_wait(&bands[i].fence);
+      util_queue_fence_destroy(&bands[i].fence);
+   }
+}
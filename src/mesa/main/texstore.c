@@ -76,6 +76,8 @@
 #include "pixeltransfer.h"
 #include "util/format_rgb9e5.h"
 #include "util/format_r11g11b10f.h"
+#include "util/u_cpu_detect.h"
+#include "util/u_queue.h"
 
 
 enum {
@@ -670,6 +672,113 @@ texstore_compressed(TEXSTORE_PARAMS)
                            srcFormat, srcType, srcAddr, srcPacking);
 }
 
+/**
+ * Uploads at least this large are converted in row bands spread over the
+ * texstore thread pool.  Below that the queueing overhead isn't worth it.
+ */
+#define TEXSTORE_PARALLEL_MIN_BYTES (4 * 1024 * 1024)
+#define TEXSTORE_MAX_BANDS 8
+
+struct texstore_band {
+   struct util_queue_fence fence;
+   void *dst;
+   uint32_t dst_format;
+   size_t dst_stride;
+   const void *src;
+   uint32_t src_format;
+   size_t src_stride;
+   size_t width, height;
+   uint8_t *rebase_swizzle;
+};
+
+static struct util_queue texstore_queue;
+static unsigned texstore_num_threads;
+static once_flag texstore_queue_once = ONCE_FLAG_INIT;
+
+static void
+texstore_queue_init(void)
+{
+   util_cpu_detect();
+
+   unsigned num_threads = MIN2(util_cpu_caps.nr_cpus, TEXSTORE_MAX_BANDS) - 1;
+   if (num_threads &&
+       util_queue_init(&texstore_queue, "texstore", TEXSTORE_MAX_BANDS,
+                       num_threads, UTIL_QUEUE_INIT_RESIZE_IF_FULL))
+      texstore_num_threads = num_threads;
+}
+
+static void
+texstore_convert_band(void *data, UNUSED int thread_index)
+{
+   struct texstore_band *band = data;
+
+   _mesa_format_convert(band->dst, band->dst_format, band->dst_stride,
+                        (void *) band->src, band->src_format,
+                        band->src_stride, band->width, band->height,
+                        band->rebase_swizzle);
+}
+
+/**
+ * Like _mesa_format_convert(), but large images are split into bands of
+ * rows which are converted on the texstore threads while the calling
+ * thread converts the first band itself.
+ */
+static void
+texstore_format_convert(void *dst, uint32_t dst_format, size_t dst_stride,
+                        const void *src, uint32_t src_format,
+                        size_t src_stride, size_t width, size_t height,
+                        uint8_t *rebase_swizzle)
+{
+   unsigned num_bands = 1;
+
+   if (height * dst_stride >= TEXSTORE_PARALLEL_MIN_BYTES) {
+      call_once(&texstore_queue_once, texstore_queue_init);
+      num_bands = MIN2(texstore_num_threads + 1, height);
+   }
+
+   if (num_bands <= 1) {
+      _mesa_format_convert(dst, dst_format, dst_stride, (void *) src,
+                           src_format, src_stride, width, height,
+                           rebase_swizzle);
+      return;
+   }
+
+   struct texstore_band bands[TEXSTORE_MAX_BANDS];
+   const size_t rows_per_band = DIV_ROUND_UP(height, num_bands);
+   size_t y = 0;
+   unsigned i;
+
+   for (i = 0; i < num_bands && y < height; i++) {
+      struct texstore_band *band = &bands[i];
+
+      band->dst = (uint8_t *) dst + y * dst_stride;
+      band->dst_format = dst_format;
+      band->dst_stride = dst_stride;
+      band->src = (const uint8_t *) src + y * src_stride;
+      band->src_format = src_format;
+      band->src_stride = src_stride;
+      band->width = width;
+      band->height = MIN2(rows_per_band, height - y);
+      band->rebase_swizzle = rebase_swizzle;
+      y += band->height;
+
+      if (i > 0) {
+         util_queue_fence_init(&band->fence);
+         util_queue_add_job(&texstore_queue, band, &band->fence,
+                            texstore_convert_band, NULL);
+      }
+   }
+   num_bands = i;
+
+   texstore_convert_band(&bands[0], 0);
+
+   for (i = 1; i < num_bands; i++) {
+      util_queue_fence_wait(&bands[i].fence);
+      util_queue_fence_destroy(&bands[i].fence);
+   }
+}
+
+
 static GLboolean
 texstore_rgba(TEXSTORE_PARAMS)
 {
@@ -810,10 +919,10 @@ texstore_rgba(TEXSTORE_PARAMS)
    }
 
    for (img = 0; img < srcDepth; img++) {
-      _mesa_format_convert(dstSlices[img], dstFormat, dstRowStride,
-                           src, srcMesaFormat, srcRowStride,
-                           srcWidth, srcHeight,
-                           needRebase ? rebaseSwizzle : NULL);
+      texstore_format_convert(dstSlices[img], dstFormat, dstRowStride,
+                              src, srcMesaFormat, srcRowStride,
+                              srcWidth, srcHeight,
+                              needRebase ? rebaseSwizzle : NULL);
       src += srcHeight * srcRowStride;
    }
 
@@ -1035,39 +1035,78 @@ _mesa_flush_vertices_for_uniforms(struct gl_context *ctx,
    ctx->NewDriverState |= new_driver_state;
 }
 
-static void
+/**
+ * Copy the values into the storage if they differ from what's already there.
+ *
+ * If \p flush is set, vertices are flushed before the storage is modified.
+ *
+ * \return true if the storage changed
+ */
+static bool
 copy_uniforms_to_storage(gl_constant_value *storage,
                          struct gl_uniform_storage *uni,
                          struct gl_context *ctx, GLsizei count,
                          const GLvoid *values, const int size_mul,
                          const unsigned offset, const unsigned components,
-                         enum glsl_base_type basicType)
+                         enum glsl_base_type basicType, bool flush)
 {
    if (!uni->type->is_boolean() && !uni->is_bindless) {
-      memcpy(storage, values,
-             sizeof(storage[0]) * components * count * size_mul);
+      const unsigned size = sizeof(storage[0]) * components * count * size_mul;
+
+      if (!memcmp(storage, values, size))
+         return false;
+
+      if (flush)
+         _mesa_flush_vertices_for_uniforms(ctx, uni);
+
+      memcpy(storage, values, size);
+      return true;
    } else if (uni->is_bindless) {
       const union gl_constant_value *src =
          (const union gl_constant_value *) values;
       GLuint64 *dst = (GLuint64 *)&storage->i;
       const unsigned elems = components * count;
+      unsigned i;
 
-      for (unsigned i = 0; i < elems; i++) {
+      /* Find the first element that's different. */
+      for (i = 0; i < elems; i++) {
+         if (dst[i] != (GLuint64)src[i].i)
+            break;
+      }
+      if (i == elems)
+         return false;
+
+      if (flush)
+         _mesa_flush_vertices_for_uniforms(ctx, uni);
+
+      for (; i < elems; i++) {
          dst[i] = src[i].i;
       }
+      return true;
    } else {
       const union gl_constant_value *src =
          (const union gl_constant_value *) values;
       union gl_constant_value *dst = storage;
       const unsigned elems = components * count;
+      bool changed = false;
 
       for (unsigned i = 0; i < elems; i++) {
+         int value;
+
          if (basicType == GLSL_TYPE_FLOAT) {
-            dst[i].i = src[i].f != 0.0f ? ctx->Const.UniformBooleanTrue : 0;
+            value = src[i].f != 0.0f ? ctx->Const.UniformBooleanTrue : 0;
          } else {
-            dst[i].i = src[i].i != 0    ? ctx->Const.UniformBooleanTrue : 0;
+            value = src[i].i != 0    ? ctx->Const.UniformBooleanTrue : 0;
+         }
+
+         if (dst[i].i != value) {
+            if (!changed && flush)
+               _mesa_flush_vertices_for_uniforms(ctx, uni);
+            changed = true;
+            dst[i].i = value;
          }
       }
+      return changed;
    }
 }
 
@@ -1125,29 +1164,38 @@ _mesa_uniform(GLint location, GLsizei count, const GLvoid *values,
       count = MIN2(count, (int) (uni->array_elements - offset));
    }
 
-   /* We check samplers for changes and flush if needed in the sampler
-    * handling code further down, so just skip them here.
-    */
-   if (!uni->type->is_sampler()) {
-       _mesa_flush_vertices_for_uniforms(ctx, uni);
-   }
-
    /* Store the data in the "actual type" backing storage for the uniform.
+    * Vertices are only flushed and constants only re-uploaded if the value
+    * actually changes, which is common for apps setting all their uniforms
+    * before each draw.
+    *
+    * We check samplers for changes and flush if needed in the sampler
+    * handling code further down, so don't flush for them here.
     */
+   const bool flush = !uni->type->is_sampler();
    gl_constant_value *storage;
    if (ctx->Const.PackedDriverUniformStorage &&
        (uni->is_bindless || !uni->type->contains_opaque())) {
+      bool changed = false;
+
       for (unsigned s = 0; s < uni->num_driver_storage; s++) {
          storage = (gl_constant_value *)
             uni->driver_storage[s].data + (size_mul * offset * components);
 
-         copy_uniforms_to_storage(storage, uni, ctx, count, values, size_mul,
-                                  offset, components, basicType);
+         if (copy_uniforms_to_storage(storage, uni, ctx, count, values,
+                                      size_mul, offset, components,
+                                      basicType, flush && !changed))
+            changed = true;
       }
+
+      if (!changed && flush)
+         return;
    } else {
       storage = &uni->storage[size_mul * components * offset];
-      copy_uniforms_to_storage(storage, uni, ctx, count, values, size_mul,
-                               offset, components, basicType);
+      if (!copy_uniforms_to_storage(storage, uni, ctx, count, values,
+                                    size_mul, offset, components, basicType,
+                                    flush) && flush)
+         return;
 
       _mesa_propagate_uniforms_to_driver_storage(uni, offset, count);
    }
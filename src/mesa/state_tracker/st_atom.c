@@ -37,6 +37,7 @@
 #include "st_program.h"
 #include "st_manager.h"
 #include "st_util.h"
+#include "util/u_trace.h"
 
 
 typedef void (*update_func_t)(struct st_context *st);
@@ -174,6 +175,7 @@ void st_validate_state( struct st_context *st, enum st_pipeline pipeline )
    struct gl_context *ctx = st->ctx;
    uint64_t dirty, pipeline_mask;
    uint32_t dirty_lo, dirty_hi;
+   MESA_TRACE_FUNC();
 
    /* Get Mesa driver state.
     *
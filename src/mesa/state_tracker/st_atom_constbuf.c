@@ -194,6 +194,11 @@ st_update_cs_constants(struct st_context *st)
       st_upload_constants(st, &cp->Base);
 }
 
+/**
+ * Bind the uniform buffers of a program.  Slots which still have the
+ * same binding as the last time are skipped, so that changing one binding
+ * point doesn't rebind every UBO of the stage.
+ */
 static void
 st_bind_ubos(struct st_context *st, struct gl_program *prog,
              enum pipe_shader_type shader_type)
@@ -204,6 +209,8 @@ st_bind_ubos(struct st_context *st, struct gl_program *prog,
    if (!prog)
       return;
 
+   assert(prog->info.num_ubos <= MAX_UNIFORM_BUFFERS);
+
    for (i = 0; i < prog->info.num_ubos; i++) {
       struct gl_buffer_binding *binding;
       struct st_buffer_object *st_obj;
@@ -229,7 +236,14 @@ st_bind_ubos(struct st_context *st, struct gl_program *prog,
          cb.buffer_size = 0;
       }
 
+      struct pipe_constant_buffer *bound = &st->state.ubos[shader_type][i];
+      if (bound->buffer == cb.buffer &&
+          bound->buffer_offset == cb.buffer_offset &&
+          bound->buffer_size == cb.buffer_size)
+         continue;
+
       cso_set_constant_buffer(st->cso_context, shader_type, 1 + i, &cb);
+      util_copy_constant_buffer(bound, &cb);
    }
 }
 
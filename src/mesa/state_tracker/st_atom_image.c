@@ -155,32 +155,52 @@ st_convert_image_from_unit(const struct st_context *st,
    st_convert_image(st, u, img, shader_access);
 }
 
+/**
+ * Bind the images of a program.  Only the range of slots whose view changed
+ * since the last time is passed to the driver.
+ */
 static void
 st_bind_images(struct st_context *st, struct gl_program *prog,
                enum pipe_shader_type shader_type)
 {
    unsigned i;
    struct pipe_image_view images[MAX_IMAGE_UNIFORMS];
-   struct gl_program_constants *c;
+   struct pipe_image_view *bound = st->state.images[shader_type];
+   unsigned num_images, old_num_images;
+   unsigned start = ~0u, end = 0;
 
    if (!prog || !st->pipe->set_shader_images)
       return;
 
-   c = &st->ctx->Const.Program[prog->info.stage];
+   num_images = prog->info.num_images;
+   old_num_images = st->state.num_images[shader_type];
 
-   for (i = 0; i < prog->info.num_images; i++) {
+   /* Zero the views, so that they can be compared with memcmp. */
+   memset(images, 0, sizeof(images));
+
+   for (i = 0; i < num_images; i++) {
       struct pipe_image_view *img = &images[i];
 
       st_convert_image_from_unit(st, img, prog->sh.ImageUnits[i],
                                  prog->sh.ImageAccess[i]);
    }
-   cso_set_shader_images(st->cso_context, shader_type, 0,
-                         prog->info.num_images, images);
-   /* clear out any stale shader images */
-   if (prog->info.num_images < c->MaxImageUniforms)
-      cso_set_shader_images(
-            st->cso_context, shader_type, prog->info.num_images,
-            c->MaxImageUniforms - prog->info.num_images, NULL);
+
+   /* The slots past num_images are cleared out, in case a previous program
+    * used more images.
+    */
+   for (i = 0; i < MAX2(num_images, old_num_images); i++) {
+      if (memcmp(&bound[i], &images[i], sizeof(images[i])) != 0) {
+         util_copy_image_view(&bound[i], &images[i]);
+         start = MIN2(start, i);
+         end = i + 1;
+      }
+   }
+   st->state.num_images[shader_type] = num_images;
+
+   if (start < end) {
+      cso_set_shader_images(st->cso_context, shader_type, start, end - start,
+                            &images[start]);
+   }
 }
 
 void st_bind_vs_images(struct st_context *st)
@@ -97,12 +97,19 @@ st_update_single_texture(struct st_context *st,
 
 
 
+/**
+ * Update the sampler views of a shader stage.  The views stay referenced in
+ * st->state.sampler_views, and only the range of slots which actually
+ * changed since the last update is passed to the driver.
+ */
 static void
 update_textures(struct st_context *st,
                 enum pipe_shader_type shader_stage,
-                const struct gl_program *prog,
-                struct pipe_sampler_view **sampler_views)
+                const struct gl_program *prog)
 {
+   struct pipe_sampler_view **sampler_views =
+      st->state.sampler_views[shader_stage];
+   GLbitfield changed = 0;
    const GLuint old_max = st->state.num_sampler_views[shader_stage];
    GLbitfield samplers_used = prog->SamplersUsed;
    GLbitfield texel_fetch_samplers = prog->info.textures_used_by_txf;
@@ -158,7 +165,10 @@ update_textures(struct st_context *st,
          num_textures = unit + 1;
       }
 
-      pipe_sampler_view_reference(&(sampler_views[unit]), sampler_view);
+      if (sampler_views[unit] != sampler_view) {
+         pipe_sampler_view_reference(&(sampler_views[unit]), sampler_view);
+         changed |= 1u << unit;
+      }
    }
 
    /* For any external samplers with multiplaner YUV, stuff the additional
@@ -174,7 +184,7 @@ update_textures(struct st_context *st,
       GLuint extra = 0;
       struct st_texture_object *stObj =
             st_get_texture_object(st->ctx, prog, unit);
-      struct pipe_sampler_view tmpl;
+      struct pipe_sampler_view tmpl, *extra_view;
 
       if (!stObj)
          continue;
@@ -188,18 +198,27 @@ update_textures(struct st_context *st,
          tmpl.format = PIPE_FORMAT_RG88_UNORM;
          tmpl.swizzle_g = PIPE_SWIZZLE_Y;   /* tmpl from Y plane is R8 */
          extra = u_bit_scan(&free_slots);
-         sampler_views[extra] =
+         extra_view =
                st->pipe->create_sampler_view(st->pipe, stObj->pt->next, &tmpl);
+         pipe_sampler_view_reference(&sampler_views[extra], NULL);
+         sampler_views[extra] = extra_view;
+         changed |= 1u << extra;
          break;
       case PIPE_FORMAT_IYUV:
          /* we need two additional R8 views: */
          tmpl.format = PIPE_FORMAT_R8_UNORM;
          extra = u_bit_scan(&free_slots);
-         sampler_views[extra] =
+         extra_view =
                st->pipe->create_sampler_view(st->pipe, stObj->pt->next, &tmpl);
+         pipe_sampler_view_reference(&sampler_views[extra], NULL);
+         sampler_views[extra] = extra_view;
+         changed |= 1u << extra;
          extra = u_bit_scan(&free_slots);
-         sampler_views[extra] =
+         extra_view =
                st->pipe->create_sampler_view(st->pipe, stObj->pt->next->next, &tmpl);
+         pipe_sampler_view_reference(&sampler_views[extra], NULL);
+         sampler_views[extra] = extra_view;
+         changed |= 1u << extra;
          break;
       default:
          break;
@@ -208,36 +227,32 @@ update_textures(struct st_context *st,
       num_textures = MAX2(num_textures, extra + 1);
    }
 
-   cso_set_sampler_views(st->cso_context,
-                         shader_stage,
-                         num_textures,
-                         sampler_views);
+   /* The fragment views go through cso_context, which saves and restores
+    * them around meta operations and skips unchanged bindings itself.
+    */
+   if (shader_stage == PIPE_SHADER_FRAGMENT) {
+      cso_set_sampler_views(st->cso_context,
+                            shader_stage,
+                            num_textures,
+                            sampler_views);
+   } else if (changed) {
+      unsigned start = ffs(changed) - 1;
+      unsigned count = util_last_bit(changed) - start;
+
+      st->pipe->set_sampler_views(st->pipe, shader_stage, start, count,
+                                  sampler_views + start);
+   }
    st->state.num_sampler_views[shader_stage] = num_textures;
 }
 
-/* Same as update_textures, but don't store the views in st_context. */
-static void
-update_textures_local(struct st_context *st,
-                      enum pipe_shader_type shader_stage,
-                      const struct gl_program *prog)
-{
-   struct pipe_sampler_view *local_views[PIPE_MAX_SAMPLERS] = {0};
-
-   update_textures(st, shader_stage, prog, local_views);
-
-   unsigned num = st->state.num_sampler_views[shader_stage];
-   for (unsigned i = 0; i < num; i++)
-      pipe_sampler_view_reference(&local_views[i], NULL);
-}
-
 void
 st_update_vertex_textures(struct st_context *st)
 {
    const struct gl_context *ctx = st->ctx;
 
    if (ctx->Const.Program[MESA_SHADER_VERTEX].MaxTextureImageUnits > 0) {
-      update_textures_local(st, PIPE_SHADER_VERTEX,
-                            ctx->VertexProgram._Current);
+      update_textures(st, PIPE_SHADER_VERTEX,
+                      ctx->VertexProgram._Current);
    }
 }
 
@@ -249,8 +264,7 @@ st_update_fragment_textures(struct st_context *st)
 
    update_textures(st,
                    PIPE_SHADER_FRAGMENT,
-                   ctx->FragmentProgram._Current,
-                   st->state.frag_sampler_views);
+                   ctx->FragmentProgram._Current);
 }
 
 
@@ -260,8 +274,8 @@ st_update_geometry_textures(struct st_context *st)
    const struct gl_context *ctx = st->ctx;
 
    if (ctx->GeometryProgram._Current) {
-      update_textures_local(st, PIPE_SHADER_GEOMETRY,
-                            ctx->GeometryProgram._Current);
+      update_textures(st, PIPE_SHADER_GEOMETRY,
+                      ctx->GeometryProgram._Current);
    }
 }
 
@@ -272,8 +286,8 @@ st_update_tessctrl_textures(struct st_context *st)
    const struct gl_context *ctx = st->ctx;
 
    if (ctx->TessCtrlProgram._Current) {
-      update_textures_local(st, PIPE_SHADER_TESS_CTRL,
-                            ctx->TessCtrlProgram._Current);
+      update_textures(st, PIPE_SHADER_TESS_CTRL,
+                      ctx->TessCtrlProgram._Current);
    }
 }
 
@@ -284,8 +298,8 @@ st_update_tesseval_textures(struct st_context *st)
    const struct gl_context *ctx = st->ctx;
 
    if (ctx->TessEvalProgram._Current) {
-      update_textures_local(st, PIPE_SHADER_TESS_EVAL,
-                            ctx->TessEvalProgram._Current);
+      update_textures(st, PIPE_SHADER_TESS_EVAL,
+                      ctx->TessEvalProgram._Current);
    }
 }
 
@@ -296,7 +310,7 @@ st_update_compute_textures(struct st_context *st)
    const struct gl_context *ctx = st->ctx;
 
    if (ctx->ComputeProgram._Current) {
-      update_textures_local(st, PIPE_SHADER_COMPUTE,
-                            ctx->ComputeProgram._Current);
+      update_textures(st, PIPE_SHADER_COMPUTE,
+                      ctx->ComputeProgram._Current);
    }
 }
@@ -45,6 +45,7 @@
 #include "pipe/p_defines.h"
 #include "pipe/p_screen.h"
 #include "util/u_gen_mipmap.h"
+#include "util/u_trace.h"
 
 
 void
@@ -52,6 +53,8 @@ st_flush(struct st_context *st,
          struct pipe_fence_handle **fence,
          unsigned flags)
 {
+   MESA_TRACE_FUNC();
+
    st_flush_bitmap_cache(st);
 
    /* We want to call this function periodically.
@@ -98,6 +98,7 @@ try_pbo_readpixels(struct st_context *st, struct st_renderbuffer *strb,
                    bool invert_y,
                    GLint x, GLint y, GLsizei width, GLsizei height,
                    enum pipe_format src_format, enum pipe_format dst_format,
+                   bool rgb_to_luminance,
                    const struct gl_pixelstore_attrib *pack, void *pixels)
 {
    struct pipe_context *pipe = st->pipe;
@@ -122,6 +123,7 @@ try_pbo_readpixels(struct st_context *st, struct st_renderbuffer *strb,
 
    /* Compute PBO addresses */
    addr.bytes_per_pixel = desc->block.bits / 8;
+   addr.elements_per_pixel = 1;
    addr.xoffset = x;
    addr.yoffset = y;
    addr.width = width;
@@ -235,7 +237,8 @@ try_pbo_readpixels(struct st_context *st, struct st_renderbuffer *strb,
 
    /* Set up the fragment shader */
    {
-      void *fs = st_pbo_get_download_fs(st, view_target, src_format, dst_format);
+      void *fs = st_pbo_get_download_fs(st, view_target, src_format, dst_format,
+                                        rgb_to_luminance);
       if (!fs)
          goto fail;
 
@@ -254,6 +257,77 @@ fail:
    return success;
 }
 
+/**
+ * ReadPixels into a PBO entirely on the GPU.
+ *
+ * Nothing is mapped, so unlike the blit-to-staging path this never waits
+ * for the GPU and it doesn't depend on prefer_blit_based_texture_transfer.
+ * Conversions handled by the download shader (sign changes, RGB to
+ * luminance) and by the image store (packing, clamping) don't need the
+ * CPU either.
+ */
+static bool
+try_pbo_download(struct st_context *st, struct gl_renderbuffer *rb,
+                 GLint x, GLint y, GLsizei width, GLsizei height,
+                 GLenum format, GLenum type,
+                 const struct gl_pixelstore_attrib *pack, void *pixels)
+{
+   struct gl_context *ctx = st->ctx;
+   struct pipe_screen *screen = st->pipe->screen;
+   struct st_renderbuffer *strb = st_renderbuffer(rb);
+   struct pipe_resource *src = strb->texture;
+   enum pipe_format src_format, dst_format;
+   bool rgb_to_luminance;
+
+   if (!st->pbo.download_enabled || !_mesa_is_bufferobj(pack->BufferObj))
+      return false;
+
+   if (!src || format == GL_DEPTH_STENCIL)
+      return false;
+
+   if (rb->_BaseFormat != _mesa_get_format_base_format(rb->Format))
+      return false;
+
+   rgb_to_luminance =
+      _mesa_need_rgb_to_luminance_conversion(rb->_BaseFormat,
+                                             _mesa_unpack_format_to_base_format(format));
+   if (rgb_to_luminance) {
+      /* Integer luminance packing clamps to the integer type range. */
+      if (_mesa_is_format_integer(rb->Format) ||
+          _mesa_get_readpixels_transfer_ops(ctx, rb->Format, format, type,
+                                            GL_TRUE))
+         return false;
+   } else if (_mesa_readpixels_needs_slow_path(ctx, format, type, GL_TRUE)) {
+      return false;
+   }
+
+   src_format = util_format_linear(src->format);
+   src_format = util_format_luminance_to_red(src_format);
+   src_format = util_format_intensity_to_red(src_format);
+
+   if (!src_format ||
+       !screen->is_format_supported(screen, src_format, src->target,
+                                    src->nr_samples, src->nr_storage_samples,
+                                    PIPE_BIND_SAMPLER_VIEW))
+      return false;
+
+   /* The destination is only ever written through a buffer image, so it
+    * doesn't have to be renderable.  Luminance formats have the same
+    * memory layout as the red ones, which image stores are more likely
+    * to support.
+    */
+   dst_format = st_choose_matching_format(st, 0, format, type,
+                                          pack->SwapBytes);
+   dst_format = util_format_luminance_to_red(dst_format);
+   if (dst_format == PIPE_FORMAT_NONE)
+      return false;
+
+   return try_pbo_readpixels(st, strb,
+                             st_fb_orientation(ctx->ReadBuffer) == Y_0_TOP,
+                             x, y, width, height, src_format, dst_format,
+                             rgb_to_luminance, pack, pixels);
+}
+
 /**
  * Create a staging texture and blit the requested region to it.
  */
@@ -420,6 +494,10 @@ st_ReadPixels(struct gl_context *ctx, GLint x, GLint y,
    st_validate_state(st, ST_PIPELINE_UPDATE_FRAMEBUFFER);
    st_flush_bitmap_cache(st);
 
+   if (try_pbo_download(st, rb, x, y, width, height, format, type,
+                        pack, pixels))
+      return;
+
    if (!st->prefer_blit_based_texture_transfer) {
       goto fallback;
    }
@@ -470,15 +548,6 @@ st_ReadPixels(struct gl_context *ctx, GLint x, GLint y,
       goto fallback;
    }
 
-   if (st->pbo.download_enabled && _mesa_is_bufferobj(pack->BufferObj)) {
-      if (try_pbo_readpixels(st, strb,
-                             st_fb_orientation(ctx->ReadBuffer) == Y_0_TOP,
-                             x, y, width, height,
-                             src_format, dst_format,
-                             pack, pixels))
-         return;
-   }
-
    if (needs_integer_signed_unsigned_conversion(ctx, format, type)) {
       goto fallback;
    }
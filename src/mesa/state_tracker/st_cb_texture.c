@@ -1193,19 +1193,79 @@ reinterpret_formats(enum pipe_format *src_format, enum pipe_format *dst_format)
    return true;
 }
 
+/**
+ * Return a single-channel format that can be used to read the channels of
+ * a 3-channel array format (such as R8G8B8) as separate buffer elements.
+ */
+static enum pipe_format
+get_rgb_element_format(struct pipe_screen *screen, enum pipe_format format)
+{
+   static const enum pipe_format candidates[] = {
+      PIPE_FORMAT_R8_UNORM,
+      PIPE_FORMAT_R8_SNORM,
+      PIPE_FORMAT_R8_UINT,
+      PIPE_FORMAT_R8_SINT,
+      PIPE_FORMAT_R16_UNORM,
+      PIPE_FORMAT_R16_SNORM,
+      PIPE_FORMAT_R16_UINT,
+      PIPE_FORMAT_R16_SINT,
+      PIPE_FORMAT_R16_FLOAT,
+      PIPE_FORMAT_R32_UINT,
+      PIPE_FORMAT_R32_SINT,
+      PIPE_FORMAT_R32_FLOAT,
+   };
+   const struct util_format_description *desc =
+      util_format_description(format);
+   unsigned i;
+
+   if (desc->layout != UTIL_FORMAT_LAYOUT_PLAIN ||
+       desc->nr_channels != 3 || !desc->is_array ||
+       desc->swizzle[0] != PIPE_SWIZZLE_X ||
+       desc->swizzle[1] != PIPE_SWIZZLE_Y ||
+       desc->swizzle[2] != PIPE_SWIZZLE_Z ||
+       desc->swizzle[3] != PIPE_SWIZZLE_1)
+      return PIPE_FORMAT_NONE;
+
+   for (i = 0; i < ARRAY_SIZE(candidates); i++) {
+      const struct util_format_channel_description *chan =
+         &util_format_description(candidates[i])->channel[0];
+
+      if (chan->type == desc->channel[0].type &&
+          chan->normalized == desc->channel[0].normalized &&
+          chan->pure_integer == desc->channel[0].pure_integer &&
+          chan->size == desc->channel[0].size) {
+         if (!screen->is_format_supported(screen, candidates[i], PIPE_BUFFER,
+                                          0, 0, PIPE_BIND_SAMPLER_VIEW))
+            return PIPE_FORMAT_NONE;
+         return candidates[i];
+      }
+   }
+
+   return PIPE_FORMAT_NONE;
+}
+
+
+/**
+ * \param view_format  format of the buffer view, which differs from
+ *                     src_format when each pixel is read as several
+ *                     elements (addr->elements_per_pixel > 1)
+ */
 static bool
 try_pbo_upload_common(struct gl_context *ctx,
                       struct pipe_surface *surface,
                       const struct st_pbo_addresses *addr,
-                      enum pipe_format src_format)
+                      enum pipe_format src_format,
+                      enum pipe_format view_format)
 {
    struct st_context *st = st_context(ctx);
    struct cso_context *cso = st->cso_context;
    struct pipe_context *pipe = st->pipe;
+   unsigned bytes_per_element = addr->bytes_per_pixel / addr->elements_per_pixel;
    bool success = false;
    void *fs;
 
-   fs = st_pbo_get_upload_fs(st, src_format, surface->format);
+   fs = st_pbo_get_upload_fs(st, src_format, surface->format,
+                             addr->elements_per_pixel > 1);
    if (!fs)
       return false;
 
@@ -1236,10 +1296,10 @@ try_pbo_upload_common(struct gl_context *ctx,
 
       memset(&templ, 0, sizeof(templ));
       templ.target = PIPE_BUFFER;
-      templ.format = src_format;
-      templ.u.buf.offset = addr->first_element * addr->bytes_per_pixel;
+      templ.format = view_format;
+      templ.u.buf.offset = addr->first_element * bytes_per_element;
       templ.u.buf.size = (addr->last_element - addr->first_element + 1) *
-                         addr->bytes_per_pixel;
+                         bytes_per_element;
       templ.swizzle_r = PIPE_SWIZZLE_X;
       templ.swizzle_g = PIPE_SWIZZLE_Y;
       templ.swizzle_b = PIPE_SWIZZLE_Z;
@@ -1309,7 +1369,7 @@ try_pbo_upload(struct gl_context *ctx, GLuint dims,
    struct pipe_screen *screen = pipe->screen;
    struct pipe_surface *surface = NULL;
    struct st_pbo_addresses addr;
-   enum pipe_format src_format;
+   enum pipe_format src_format, view_format;
    const struct util_format_description *desc;
    GLenum gl_target = texImage->TexObject->Target;
    bool success;
@@ -1361,10 +1421,26 @@ try_pbo_upload(struct gl_context *ctx, GLuint dims,
       }
    }
 
-   if (!src_format ||
-       !screen->is_format_supported(screen, src_format, PIPE_BUFFER, 0, 0,
-                                    PIPE_BIND_SAMPLER_VIEW)) {
+   if (!src_format)
       return false;
+
+   view_format = src_format;
+   addr.elements_per_pixel = 1;
+
+   if (!screen->is_format_supported(screen, src_format, PIPE_BUFFER, 0, 0,
+                                    PIPE_BIND_SAMPLER_VIEW)) {
+      /* 3-channel formats such as GL_RGB + GL_UNSIGNED_BYTE are usually not
+       * supported for texture buffers. Read them one channel at a time
+       * instead of falling back to texstore on the CPU.
+       */
+      if (st->pbo.rgba_only)
+         return false;
+
+      view_format = get_rgb_element_format(screen, src_format);
+      if (view_format == PIPE_FORMAT_NONE)
+         return false;
+
+      addr.elements_per_pixel = 3;
    }
 
    /* Compute buffer addresses */
@@ -1399,7 +1475,8 @@ try_pbo_upload(struct gl_context *ctx, GLuint dims,
          return false;
    }
 
-   success = try_pbo_upload_common(ctx, surface, &addr, src_format);
+   success = try_pbo_upload_common(ctx, surface, &addr, src_format,
+                                   view_format);
 
    pipe_surface_reference(&surface, NULL);
 
@@ -1756,6 +1833,7 @@ st_CompressedTexSubImage(struct gl_context *ctx, GLuint dims,
 
    /* Choose the pipe format for the upload. */
    addr.bytes_per_pixel = util_format_get_blocksize(dst->format);
+   addr.elements_per_pixel = 1;
    bw = util_format_get_blockwidth(dst->format);
    bh = util_format_get_blockheight(dst->format);
 
@@ -1829,7 +1907,8 @@ st_CompressedTexSubImage(struct gl_context *ctx, GLuint dims,
          goto fallback;
    }
 
-   success = try_pbo_upload_common(ctx, surface, &addr, copy_format);
+   success = try_pbo_upload_common(ctx, surface, &addr, copy_format,
+                                   copy_format);
 
    pipe_surface_reference(&surface, NULL);
 
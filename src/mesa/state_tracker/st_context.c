@@ -434,8 +434,15 @@ st_destroy_context_priv(struct st_context *st, bool destroy_pipe)
    st_destroy_bound_texture_handles(st);
    st_destroy_bound_image_handles(st);
 
-   for (i = 0; i < ARRAY_SIZE(st->state.frag_sampler_views); i++) {
-      pipe_sampler_view_reference(&st->state.frag_sampler_views[i], NULL);
+   for (i = 0; i < PIPE_SHADER_TYPES; i++) {
+      unsigned j;
+
+      for (j = 0; j < PIPE_MAX_SAMPLERS; j++)
+         pipe_sampler_view_reference(&st->state.sampler_views[i][j], NULL);
+      for (j = 0; j < MAX_UNIFORM_BUFFERS; j++)
+         pipe_resource_reference(&st->state.ubos[i][j].buffer, NULL);
+      for (j = 0; j < MAX_IMAGE_UNIFORMS; j++)
+         pipe_resource_reference(&st->state.images[i][j].resource, NULL);
    }
 
    /* free glReadPixels cache data */
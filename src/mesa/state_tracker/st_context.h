@@ -154,6 +154,9 @@ struct st_context
     */
    boolean shader_has_one_variant[MESA_SHADER_STAGES];
 
+   /** Set while creating the variants recorded in the shader cache. */
+   boolean loading_variant_keys;
+
    boolean needs_texcoord_semantic;
    boolean apply_texture_swizzle_to_border_color;
 
@@ -173,8 +176,14 @@ struct st_context
       struct pipe_rasterizer_state          rasterizer;
       struct pipe_sampler_state frag_samplers[PIPE_MAX_SAMPLERS];
       GLuint num_frag_samplers;
-      struct pipe_sampler_view *frag_sampler_views[PIPE_MAX_SAMPLERS];
+      /** Sampler views, uniform buffers and images as last bound, so that
+       * only the slots which changed get passed on to the driver.
+       */
+      struct pipe_sampler_view *sampler_views[PIPE_SHADER_TYPES][PIPE_MAX_SAMPLERS];
       GLuint num_sampler_views[PIPE_SHADER_TYPES];
+      struct pipe_constant_buffer ubos[PIPE_SHADER_TYPES][MAX_UNIFORM_BUFFERS];
+      struct pipe_image_view images[PIPE_SHADER_TYPES][MAX_IMAGE_UNIFORMS];
+      GLuint num_images[PIPE_SHADER_TYPES];
       struct pipe_clip_state clip;
       struct {
          void *ptr;
@@ -282,7 +291,8 @@ struct st_context
       void *vs;
       void *gs;
       void *upload_fs[3];
-      void *download_fs[3][PIPE_MAX_TEXTURE_TYPES];
+      void *upload_rgb_fs[3];
+      void *download_fs[4][PIPE_MAX_TEXTURE_TYPES];
       bool upload_enabled;
       bool download_enabled;
       bool rgba_only;
@@ -126,8 +126,11 @@ prepare_draw(struct st_context *st, struct gl_context *ctx)
 
    st_invalidate_readpix_cache(st);
 
-   /* Validate state. */
-   if ((st->dirty | ctx->NewDriverState) & ST_PIPELINE_RENDER_STATE_MASK ||
+   /* Validate state.  Draws with the same state as the previous one only get
+    * here: inactive shader states are skipped like st_validate_state does.
+    */
+   if ((st->dirty | (ctx->NewDriverState & st->active_states)) &
+       ST_PIPELINE_RENDER_STATE_MASK ||
        st->gfx_shaders_may_be_dirty) {
       st_validate_state(st, ST_PIPELINE_RENDER);
    }
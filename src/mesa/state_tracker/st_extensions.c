@@ -177,6 +177,14 @@ void st_init_limits(struct pipe_screen *screen,
       options = &c->ShaderCompilerOptions[stage];
       c->ShaderCompilerOptions[stage].NirOptions = nir_options;
 
+      /* NIR drivers optimize after glsl_to_nir, so the GLSL IR only needs
+       * the single pass at link time to trim the shader interface.
+       */
+      options->OptimizeAtLinkOnly =
+         screen->get_param(screen, PIPE_CAP_GLSL_OPTIMIZE_CONSERVATIVELY) &&
+         screen->get_shader_param(screen, sh, PIPE_SHADER_CAP_PREFERRED_IR) ==
+            PIPE_SHADER_IR_NIR;
+
       if (sh == PIPE_SHADER_COMPUTE) {
          if (!screen->get_param(screen, PIPE_CAP_COMPUTE))
             continue;
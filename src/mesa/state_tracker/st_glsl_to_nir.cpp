@@ -48,6 +48,7 @@
 #include "compiler/glsl/ir.h"
 #include "compiler/glsl/ir_optimization.h"
 #include "compiler/glsl/string_to_uint_map.h"
+#include "util/u_trace.h"
 
 static int
 type_size(const struct glsl_type *type)
@@ -745,6 +746,7 @@ st_link_nir(struct gl_context *ctx,
    struct st_context *st = st_context(ctx);
    struct pipe_screen *screen = st->pipe->screen;
    bool is_scalar[MESA_SHADER_STAGES];
+   MESA_TRACE_FUNC();
 
    unsigned last_stage = 0;
    for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
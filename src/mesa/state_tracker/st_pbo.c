@@ -49,6 +49,7 @@ enum st_pbo_conversion {
    ST_PBO_CONVERT_NONE = 0,
    ST_PBO_CONVERT_UINT_TO_SINT,
    ST_PBO_CONVERT_SINT_TO_UINT,
+   ST_PBO_CONVERT_RGB_TO_LUMINANCE,
 
    ST_NUM_PBO_CONVERSIONS
 };
@@ -64,19 +65,24 @@ st_pbo_addresses_setup(struct st_context *st,
                        struct pipe_resource *buf, intptr_t buf_offset,
                        struct st_pbo_addresses *addr)
 {
-   unsigned skip_pixels;
+   unsigned elements_per_pixel = addr->elements_per_pixel;
+   unsigned bytes_per_element = addr->bytes_per_pixel / elements_per_pixel;
+   unsigned skip_elements;
+
+   /* Convert to elements */
+   buf_offset *= elements_per_pixel;
 
    /* Check alignment against texture buffer requirements. */
    {
-      unsigned ofs = (buf_offset * addr->bytes_per_pixel) % st->ctx->Const.TextureBufferOffsetAlignment;
+      unsigned ofs = (buf_offset * bytes_per_element) % st->ctx->Const.TextureBufferOffsetAlignment;
       if (ofs != 0) {
-         if (ofs % addr->bytes_per_pixel != 0)
+         if (ofs % bytes_per_element != 0)
             return false;
 
-         skip_pixels = ofs / addr->bytes_per_pixel;
-         buf_offset -= skip_pixels;
+         skip_elements = ofs / bytes_per_element;
+         buf_offset -= skip_elements;
       } else {
-         skip_pixels = 0;
+         skip_elements = 0;
       }
    }
 
@@ -84,21 +90,30 @@ st_pbo_addresses_setup(struct st_context *st,
 
    addr->buffer = buf;
    addr->first_element = buf_offset;
-   addr->last_element = buf_offset + skip_pixels + addr->width - 1
-         + (addr->height - 1 + (addr->depth - 1) * addr->image_height) * addr->pixels_per_row;
+   addr->last_element = buf_offset + skip_elements
+         + (addr->width + (addr->height - 1 + (addr->depth - 1) * addr->image_height) *
+            addr->pixels_per_row) * elements_per_pixel - 1;
 
    if (addr->last_element - addr->first_element > st->ctx->Const.MaxTextureBufferSize - 1)
       return false;
 
    /* This should be ensured by Mesa before calling our callbacks */
-   assert((addr->last_element + 1) * addr->bytes_per_pixel <= buf->width0);
+   assert((addr->last_element + 1) * bytes_per_element <= buf->width0);
 
-   addr->constants.xoffset = -addr->xoffset + skip_pixels;
+   addr->constants.xoffset = -addr->xoffset;
    addr->constants.yoffset = -addr->yoffset;
    addr->constants.stride = addr->pixels_per_row;
    addr->constants.image_size = addr->pixels_per_row * addr->image_height;
    addr->constants.layer_offset = 0;
 
+   /* The shader multiplies the pixel address when there are several
+    * elements per pixel, so the skipped elements are added separately.
+    */
+   if (elements_per_pixel == 1)
+      addr->constants.xoffset += skip_elements;
+   else
+      addr->constants.layer_offset = skip_elements;
+
    return true;
 }
 
@@ -402,6 +417,15 @@ build_conversion(struct ureg_program *ureg, const struct ureg_dst *temp,
    case ST_PBO_CONVERT_UINT_TO_SINT:
       ureg_UMIN(ureg, *temp, ureg_src(*temp), ureg_imm1u(ureg, (1u << 31) - 1));
       break;
+   case ST_PBO_CONVERT_RGB_TO_LUMINANCE:
+      /* L = R + G + B, the same as _mesa_readpixels does it. */
+      ureg_ADD(ureg, ureg_writemask(*temp, TGSI_WRITEMASK_X),
+                     ureg_scalar(ureg_src(*temp), TGSI_SWIZZLE_X),
+                     ureg_scalar(ureg_src(*temp), TGSI_SWIZZLE_Y));
+      ureg_ADD(ureg, ureg_writemask(*temp, TGSI_WRITEMASK_X),
+                     ureg_scalar(ureg_src(*temp), TGSI_SWIZZLE_X),
+                     ureg_scalar(ureg_src(*temp), TGSI_SWIZZLE_Z));
+      break;
    default:
       /* no-op */
       break;
@@ -427,11 +451,34 @@ sampler_type_for_target(enum pipe_texture_target target)
    return glsl_sampler_type(dim[target], false, is_array, GLSL_TYPE_FLOAT);
 }
 
+static nir_ssa_def *
+build_txf_nir(nir_builder *b, nir_variable *tex_var, nir_ssa_def *texcoord)
+{
+   nir_deref_instr *tex_deref = nir_build_deref_var(b, tex_var);
+
+   nir_tex_instr *tex = nir_tex_instr_create(b->shader, 3);
+   tex->op = nir_texop_txf;
+   tex->sampler_dim = glsl_get_sampler_dim(tex_var->type);
+   tex->coord_components =
+      glsl_get_sampler_coordinate_components(tex_var->type);
+   tex->dest_type = nir_type_float;
+   tex->src[0].src_type = nir_tex_src_texture_deref;
+   tex->src[0].src = nir_src_for_ssa(&tex_deref->dest.ssa);
+   tex->src[1].src_type = nir_tex_src_sampler_deref;
+   tex->src[1].src = nir_src_for_ssa(&tex_deref->dest.ssa);
+   tex->src[2].src_type = nir_tex_src_coord;
+   tex->src[2].src = nir_src_for_ssa(texcoord);
+   nir_ssa_dest_init(&tex->instr, &tex->dest, 4, 32, NULL);
+   nir_builder_instr_insert(b, &tex->instr);
+   return &tex->dest.ssa;
+}
+
 static void *
 create_fs_nir(struct st_context *st,
               bool download,
               enum pipe_texture_target target,
-              enum st_pbo_conversion conversion)
+              enum st_pbo_conversion conversion,
+              bool rgb_elements)
 {
    struct pipe_screen *screen = st->pipe->screen;
    struct nir_builder b;
@@ -487,6 +534,7 @@ create_fs_nir(struct st_context *st,
    }
 
    nir_ssa_def *texcoord;
+   nir_ssa_def *skip_elements = NULL;
    if (download) {
       texcoord = nir_f2i32(&b, nir_channels(&b, coord, TGSI_WRITEMASK_XY));
 
@@ -508,6 +556,17 @@ create_fs_nir(struct st_context *st,
                                  nir_channel(&b, texcoord, 1),
                                  src_layer);
       }
+   } else if (rgb_elements) {
+      nir_variable *skip_var =
+         nir_variable_create(b.shader, nir_var_uniform,
+                             glsl_int_type(), "skip_elements");
+      b.shader->num_uniforms += 1;
+      skip_var->data.driver_location = 4;
+      skip_elements = nir_load_var(&b, skip_var);
+
+      /* texcoord = pbo_addr * 3 + skip_elements */
+      texcoord = nir_iadd(&b, nir_imul(&b, pbo_addr, nir_imm_int(&b, 3)),
+                          skip_elements);
    } else {
       texcoord = pbo_addr;
    }
@@ -518,28 +577,32 @@ create_fs_nir(struct st_context *st,
    tex_var->data.explicit_binding = true;
    tex_var->data.binding = 0;
 
-   nir_deref_instr *tex_deref = nir_build_deref_var(&b, tex_var);
+   nir_ssa_def *result = build_txf_nir(&b, tex_var, texcoord);
 
-   nir_tex_instr *tex = nir_tex_instr_create(b.shader, 3);
-   tex->op = nir_texop_txf;
-   tex->sampler_dim = glsl_get_sampler_dim(tex_var->type);
-   tex->coord_components =
-      glsl_get_sampler_coordinate_components(tex_var->type);
-   tex->dest_type = nir_type_float;
-   tex->src[0].src_type = nir_tex_src_texture_deref;
-   tex->src[0].src = nir_src_for_ssa(&tex_deref->dest.ssa);
-   tex->src[1].src_type = nir_tex_src_sampler_deref;
-   tex->src[1].src = nir_src_for_ssa(&tex_deref->dest.ssa);
-   tex->src[2].src_type = nir_tex_src_coord;
-   tex->src[2].src = nir_src_for_ssa(texcoord);
-   nir_ssa_dest_init(&tex->instr, &tex->dest, 4, 32, NULL);
-   nir_builder_instr_insert(&b, &tex->instr);
-   nir_ssa_def *result = &tex->dest.ssa;
+   if (skip_elements) {
+      /* Each channel is a separate element of the single-channel view. */
+      nir_ssa_def *g =
+         build_txf_nir(&b, tex_var, nir_iadd(&b, texcoord, nir_imm_int(&b, 1)));
+      nir_ssa_def *bl =
+         build_txf_nir(&b, tex_var, nir_iadd(&b, texcoord, nir_imm_int(&b, 2)));
+
+      result = nir_vec4(&b, nir_channel(&b, result, 0),
+                        nir_channel(&b, g, 0),
+                        nir_channel(&b, bl, 0),
+                        nir_channel(&b, result, 3));
+   }
 
    if (conversion == ST_PBO_CONVERT_SINT_TO_UINT)
       result = nir_imax(&b, result, zero);
    else if (conversion == ST_PBO_CONVERT_UINT_TO_SINT)
       result = nir_umin(&b, result, nir_imm_int(&b, (1u << 31) - 1));
+   else if (conversion == ST_PBO_CONVERT_RGB_TO_LUMINANCE)
+      result = nir_vec4(&b, nir_fadd(&b, nir_fadd(&b, nir_channel(&b, result, 0),
+                                                      nir_channel(&b, result, 1)),
+                                         nir_channel(&b, result, 2)),
+                        nir_channel(&b, result, 1),
+                        nir_channel(&b, result, 2),
+                        nir_channel(&b, result, 3));
 
    if (download) {
       nir_variable *img_var =
@@ -576,7 +639,8 @@ create_fs_nir(struct st_context *st,
 static void *
 create_fs_tgsi(struct st_context *st, bool download,
                enum pipe_texture_target target,
-               enum st_pbo_conversion conversion)
+               enum st_pbo_conversion conversion,
+               bool rgb_elements)
 {
    struct pipe_context *pipe = st->pipe;
    struct pipe_screen *screen = pipe->screen;
@@ -702,6 +766,44 @@ create_fs_tgsi(struct st_context *st, bool download,
       ureg_memory_insn(ureg, TGSI_OPCODE_STORE, &out, 1, op, 2, 0,
                              TGSI_TEXTURE_BUFFER, PIPE_FORMAT_NONE);
 
+      ureg_release_temporary(ureg, temp1);
+   } else if (rgb_elements) {
+      struct ureg_dst temp1 = ureg_DECL_temporary(ureg);
+      struct ureg_dst temp2 = ureg_DECL_temporary(ureg);
+
+      /* Note: const1.x = number of elements to skip */
+
+      /* temp0.x = temp0.x * 3 + const1.x */
+      ureg_UMAD(ureg, ureg_writemask(temp0, TGSI_WRITEMASK_X),
+                      ureg_scalar(ureg_src(temp0), TGSI_SWIZZLE_X),
+                      ureg_imm1u(ureg, 3),
+                      ureg_scalar(const1, TGSI_SWIZZLE_X));
+
+      /* temp2.xw = txf(sampler, temp0.x) */
+      ureg_TXF(ureg, temp1, TGSI_TEXTURE_BUFFER, ureg_src(temp0), sampler);
+      ureg_MOV(ureg, ureg_writemask(temp2, TGSI_WRITEMASK_XW), ureg_src(temp1));
+
+      /* temp2.y = txf(sampler, temp0.x + 1).x */
+      ureg_UADD(ureg, ureg_writemask(temp0, TGSI_WRITEMASK_X),
+                      ureg_scalar(ureg_src(temp0), TGSI_SWIZZLE_X),
+                      ureg_imm1u(ureg, 1));
+      ureg_TXF(ureg, temp1, TGSI_TEXTURE_BUFFER, ureg_src(temp0), sampler);
+      ureg_MOV(ureg, ureg_writemask(temp2, TGSI_WRITEMASK_Y),
+                     ureg_scalar(ureg_src(temp1), TGSI_SWIZZLE_X));
+
+      /* temp2.z = txf(sampler, temp0.x + 2).x */
+      ureg_UADD(ureg, ureg_writemask(temp0, TGSI_WRITEMASK_X),
+                      ureg_scalar(ureg_src(temp0), TGSI_SWIZZLE_X),
+                      ureg_imm1u(ureg, 1));
+      ureg_TXF(ureg, temp1, TGSI_TEXTURE_BUFFER, ureg_src(temp0), sampler);
+      ureg_MOV(ureg, ureg_writemask(temp2, TGSI_WRITEMASK_Z),
+                     ureg_scalar(ureg_src(temp1), TGSI_SWIZZLE_X));
+
+      build_conversion(ureg, &temp2, conversion);
+
+      ureg_MOV(ureg, out, ureg_src(temp2));
+
+      ureg_release_temporary(ureg, temp2);
       ureg_release_temporary(ureg, temp1);
    } else {
       /* out = txf(sampler, temp0.x) */
@@ -722,7 +824,8 @@ create_fs_tgsi(struct st_context *st, bool download,
 static void *
 create_fs(struct st_context *st, bool download,
           enum pipe_texture_target target,
-          enum st_pbo_conversion conversion)
+          enum st_pbo_conversion conversion,
+          bool rgb_elements)
 {
    struct pipe_screen *pscreen = st->pipe->screen;
    bool use_nir = PIPE_SHADER_IR_NIR ==
@@ -730,9 +833,9 @@ create_fs(struct st_context *st, bool download,
                                 PIPE_SHADER_CAP_PREFERRED_IR);
 
    if (use_nir)
-      return create_fs_nir(st, download, target, conversion);
+      return create_fs_nir(st, download, target, conversion, rgb_elements);
 
-   return create_fs_tgsi(st, download, target, conversion);
+   return create_fs_tgsi(st, download, target, conversion, rgb_elements);
 }
 
 static enum st_pbo_conversion
@@ -749,33 +852,45 @@ get_pbo_conversion(enum pipe_format src_format, enum pipe_format dst_format)
    return ST_PBO_CONVERT_NONE;
 }
 
+/* With rgb_elements, each pixel of a 3-channel format is read as 3 elements
+ * of a single-channel buffer view, for when the 3-channel format isn't
+ * supported for buffers.
+ */
 void *
 st_pbo_get_upload_fs(struct st_context *st,
                      enum pipe_format src_format,
-                     enum pipe_format dst_format)
+                     enum pipe_format dst_format,
+                     bool rgb_elements)
 {
-   STATIC_ASSERT(ARRAY_SIZE(st->pbo.upload_fs) == ST_NUM_PBO_CONVERSIONS);
+   /* RGB to luminance is only used for downloads. */
+   STATIC_ASSERT(ARRAY_SIZE(st->pbo.upload_fs) == ST_NUM_PBO_CONVERSIONS - 1);
+   STATIC_ASSERT(ARRAY_SIZE(st->pbo.upload_rgb_fs) == ST_NUM_PBO_CONVERSIONS - 1);
 
    enum st_pbo_conversion conversion = get_pbo_conversion(src_format, dst_format);
+   void **fs = rgb_elements ? &st->pbo.upload_rgb_fs[conversion]
+                            : &st->pbo.upload_fs[conversion];
 
-   if (!st->pbo.upload_fs[conversion])
-      st->pbo.upload_fs[conversion] = create_fs(st, false, 0, conversion);
+   if (!*fs)
+      *fs = create_fs(st, false, 0, conversion, rgb_elements);
 
-   return st->pbo.upload_fs[conversion];
+   return *fs;
 }
 
 void *
 st_pbo_get_download_fs(struct st_context *st, enum pipe_texture_target target,
                        enum pipe_format src_format,
-                       enum pipe_format dst_format)
+                       enum pipe_format dst_format,
+                       bool rgb_to_luminance)
 {
    STATIC_ASSERT(ARRAY_SIZE(st->pbo.download_fs) == ST_NUM_PBO_CONVERSIONS);
    assert(target < PIPE_MAX_TEXTURE_TYPES);
 
-   enum st_pbo_conversion conversion = get_pbo_conversion(src_format, dst_format);
+   enum st_pbo_conversion conversion = rgb_to_luminance ?
+      ST_PBO_CONVERT_RGB_TO_LUMINANCE :
+      get_pbo_conversion(src_format, dst_format);
 
    if (!st->pbo.download_fs[conversion][target])
-      st->pbo.download_fs[conversion][target] = create_fs(st, true, target, conversion);
+      st->pbo.download_fs[conversion][target] = create_fs(st, true, target, conversion, false);
 
    return st->pbo.download_fs[conversion][target];
 }
@@ -831,6 +946,10 @@ st_destroy_pbo_helpers(struct st_context *st)
          cso_delete_fragment_shader(st->cso_context, st->pbo.upload_fs[i]);
          st->pbo.upload_fs[i] = NULL;
       }
+      if (st->pbo.upload_rgb_fs[i]) {
+         cso_delete_fragment_shader(st->cso_context, st->pbo.upload_rgb_fs[i]);
+         st->pbo.upload_rgb_fs[i] = NULL;
+      }
    }
 
    for (i = 0; i < ARRAY_SIZE(st->pbo.download_fs); ++i) {
@@ -37,13 +37,20 @@ struct st_pbo_addresses {
 
    unsigned bytes_per_pixel;
 
+   /* Number of buffer elements per pixel. This is 3 when a 3-channel
+    * format is read through a single-channel buffer view, 1 otherwise.
+    */
+   unsigned elements_per_pixel;
+
    /* Everything below is filled in by st_pbo_from_pixelstore */
    unsigned pixels_per_row;
    unsigned image_height;
 
    /* Everything below is filled in by st_pbo_setup_buffer */
 
-   /* Buffer and view. */
+   /* Buffer and view. first_element and last_element are in units of
+    * buffer elements.
+    */
    struct pipe_resource *buffer; /* non-owning pointer */
    unsigned first_element;
    unsigned last_element;
@@ -54,6 +61,9 @@ struct st_pbo_addresses {
       int32_t yoffset;
       int32_t stride;
       int32_t image_size;
+      /* First layer for 3D downloads; number of buffer elements to skip
+       * when elements_per_pixel > 1.
+       */
       int32_t layer_offset;
    } constants;
 };
@@ -87,12 +97,14 @@ st_pbo_create_gs(struct st_context *st);
 void *
 st_pbo_get_upload_fs(struct st_context *st,
                      enum pipe_format src_format,
-                     enum pipe_format dst_format);
+                     enum pipe_format dst_format,
+                     bool rgb_elements);
 
 void *
 st_pbo_get_download_fs(struct st_context *st, enum pipe_texture_target target,
                        enum pipe_format src_format,
-                       enum pipe_format dst_format);
+                       enum pipe_format dst_format,
+                       bool rgb_to_luminance);
 
 extern void
 st_init_pbo_helpers(struct st_context *st);
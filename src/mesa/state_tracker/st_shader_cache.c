@@ -61,23 +61,108 @@ write_tgsi_to_cache(struct blob *blob, const struct tgsi_token *tokens,
 {
    blob_write_uint32(blob, num_tokens);
    blob_write_bytes(blob, tokens, num_tokens * sizeof(struct tgsi_token));
-   copy_blob_to_driver_cache_blob(blob, prog);
 }
 
 static void
 write_nir_to_cache(struct blob *blob, struct gl_program *prog)
 {
-   nir_serialize(blob, prog->nir);
-   copy_blob_to_driver_cache_blob(blob, prog);
+   nir_serialize(blob, prog->nir, false);
 }
 
 static void
-st_serialise_ir_program(struct gl_context *ctx, struct gl_program *prog,
-                        bool nir)
+write_driver_binary(struct pipe_context *pipe, enum pipe_shader_type type,
+                    void *driver_shader, struct blob *blob, unsigned *count)
 {
-   if (prog->driver_cache_blob)
+   unsigned size;
+   void *binary;
+
+   if (!driver_shader)
+      return;
+
+   binary = pipe->get_shader_binary(pipe, type, driver_shader, &size);
+   if (!binary)
       return;
 
+   blob_write_uint32(blob, size);
+   blob_write_bytes(blob, binary, size);
+   FREE(binary);
+   (*count)++;
+}
+
+/**
+ * Append the driver's compiled code for every variant of the program, so
+ * that loading a program binary only has to hand it back to the driver
+ * instead of running the backend compiler again.
+ */
+static void
+write_driver_binaries_to_cache(struct st_context *st, struct blob *blob,
+                               struct gl_program *prog)
+{
+   struct pipe_context *pipe = st->pipe;
+   enum pipe_shader_type type = pipe_shader_type_from_mesa(prog->info.stage);
+   unsigned count = 0;
+
+   if (!pipe->get_shader_binary) {
+      blob_write_uint32(blob, 0);
+      return;
+   }
+
+   intptr_t count_offset = blob_reserve_uint32(blob);
+
+   switch (prog->info.stage) {
+   case MESA_SHADER_VERTEX: {
+      struct st_vertex_program *stvp = (struct st_vertex_program *) prog;
+
+      for (struct st_vp_variant *v = stvp->variants; v; v = v->next)
+         write_driver_binary(pipe, type, v->driver_shader, blob, &count);
+      break;
+   }
+   case MESA_SHADER_TESS_CTRL:
+   case MESA_SHADER_TESS_EVAL:
+   case MESA_SHADER_GEOMETRY: {
+      struct st_common_program *stcp = (struct st_common_program *) prog;
+
+      for (struct st_basic_variant *v = stcp->variants; v; v = v->next)
+         write_driver_binary(pipe, type, v->driver_shader, blob, &count);
+      break;
+   }
+   case MESA_SHADER_FRAGMENT: {
+      struct st_fragment_program *stfp = (struct st_fragment_program *) prog;
+
+      for (struct st_fp_variant *v = stfp->variants; v; v = v->next)
+         write_driver_binary(pipe, type, v->driver_shader, blob, &count);
+      break;
+   }
+   case MESA_SHADER_COMPUTE: {
+      struct st_compute_program *stcp = (struct st_compute_program *) prog;
+
+      for (struct st_basic_variant *v = stcp->variants; v; v = v->next)
+         write_driver_binary(pipe, type, v->driver_shader, blob, &count);
+      break;
+   }
+   default:
+      unreachable("Unsupported stage");
+   }
+
+   blob_overwrite_uint32(blob, count_offset, count);
+}
+
+static void
+st_serialise_ir_program(struct gl_context *ctx, struct gl_program *prog,
+                        bool nir, bool driver_binaries)
+{
+   if (prog->driver_cache_blob) {
+      /* The blob stored in the disk cache doesn't carry the driver's
+       * compiled code, so it has to be rebuilt for a program binary.
+       */
+      if (!driver_binaries)
+         return;
+
+      ralloc_free(prog->driver_cache_blob);
+      prog->driver_cache_blob = NULL;
+      prog->driver_cache_blob_size = 0;
+   }
+
    struct blob blob;
    blob_init(&blob);
 
@@ -140,6 +225,12 @@ st_serialise_ir_program(struct gl_context *ctx, struct gl_program *prog,
       unreachable("Unsupported stage");
    }
 
+   if (driver_binaries)
+      write_driver_binaries_to_cache(st_context(ctx), &blob, prog);
+   else
+      blob_write_uint32(&blob, 0);
+
+   copy_blob_to_driver_cache_blob(&blob, prog);
    blob_finish(&blob);
 }
 
@@ -160,7 +251,7 @@ st_store_ir_in_disk_cache(struct st_context *st, struct gl_program *prog,
    if (memcmp(prog->sh.data->sha1, zero, sizeof(prog->sh.data->sha1)) == 0)
       return;
 
-   st_serialise_ir_program(st->ctx, prog, nir);
+   st_serialise_ir_program(st->ctx, prog, nir, false);
 
    if (st->ctx->_Shader->Flags & GLSL_CACHE_INFO) {
       fprintf(stderr, "putting %s state tracker IR in cache\n",
@@ -168,6 +259,126 @@ st_store_ir_in_disk_cache(struct st_context *st, struct gl_program *prog,
    }
 }
 
+/**
+ * The variant keys a program has been used with are stored in a separate
+ * cache entry next to its IR, so that the same variants can be created
+ * when the program is loaded from the cache again.
+ */
+static bool
+get_variant_keys_cache_key(struct st_context *st, struct gl_program *prog,
+                           cache_key key)
+{
+   static const char zero[sizeof(prog->sh.data->sha1)] = {0};
+   static const char tag[] = "st variant keys";
+   uint8_t data[sizeof(prog->sh.data->sha1) + 1 + sizeof(tag)];
+
+   if (!st->ctx->Cache || prog->is_arb_asm || !prog->sh.data ||
+       memcmp(prog->sh.data->sha1, zero, sizeof(zero)) == 0)
+      return false;
+
+   memcpy(data, prog->sh.data->sha1, sizeof(zero));
+   data[sizeof(zero)] = prog->info.stage;
+   memcpy(data + sizeof(zero) + 1, tag, sizeof(tag));
+
+   disk_cache_compute_key(st->ctx->Cache, data, sizeof(data), key);
+   return true;
+}
+
+/**
+ * Store the keys of the non-default variants of a program in the cache.
+ * Called whenever a new variant is created.
+ */
+void
+st_store_variant_keys_in_disk_cache(struct st_context *st,
+                                    struct gl_program *prog)
+{
+   cache_key key;
+   struct blob blob;
+
+   if (st->loading_variant_keys ||
+       (prog->info.stage != MESA_SHADER_VERTEX &&
+        prog->info.stage != MESA_SHADER_FRAGMENT) ||
+       !get_variant_keys_cache_key(st, prog, key))
+      return;
+
+   blob_init(&blob);
+
+   if (prog->info.stage == MESA_SHADER_VERTEX) {
+      struct st_vertex_program *stvp = (struct st_vertex_program *) prog;
+      struct st_vp_variant_key zero_key = {0};
+
+      for (struct st_vp_variant *v = stvp->variants; v; v = v->next) {
+         struct st_vp_variant_key k = v->key;
+
+         k.st = NULL;
+         if (memcmp(&k, &zero_key, sizeof(k)))
+            blob_write_bytes(&blob, &k, sizeof(k));
+      }
+   } else {
+      struct st_fragment_program *stfp = (struct st_fragment_program *) prog;
+      struct st_fp_variant_key zero_key = {0};
+
+      for (struct st_fp_variant *v = stfp->variants; v; v = v->next) {
+         struct st_fp_variant_key k = v->key;
+
+         k.st = NULL;
+         if (memcmp(&k, &zero_key, sizeof(k)))
+            blob_write_bytes(&blob, &k, sizeof(k));
+      }
+   }
+
+   if (blob.size && !blob.out_of_memory)
+      disk_cache_put(st->ctx->Cache, key, blob.data, blob.size, NULL);
+
+   blob_finish(&blob);
+}
+
+/**
+ * Create the variants recorded by st_store_variant_keys_in_disk_cache(), so
+ * that they don't have to be compiled at draw time.
+ */
+static void
+load_variants_from_disk_cache(struct st_context *st, struct gl_program *prog)
+{
+   cache_key key;
+   size_t size;
+   uint8_t *data;
+
+   if ((prog->info.stage != MESA_SHADER_VERTEX &&
+        prog->info.stage != MESA_SHADER_FRAGMENT) ||
+       !get_variant_keys_cache_key(st, prog, key))
+      return;
+
+   data = disk_cache_get(st->ctx->Cache, key, &size);
+   if (!data)
+      return;
+
+   st->loading_variant_keys = true;
+
+   if (prog->info.stage == MESA_SHADER_VERTEX) {
+      struct st_vertex_program *stvp = (struct st_vertex_program *) prog;
+      struct st_vp_variant_key k;
+
+      for (size_t i = 0; size % sizeof(k) == 0 && i < size; i += sizeof(k)) {
+         memcpy(&k, data + i, sizeof(k));
+         k.st = st->has_shareable_shaders ? NULL : st;
+         st_get_vp_variant(st, stvp, &k);
+      }
+   } else {
+      struct st_fragment_program *stfp = (struct st_fragment_program *) prog;
+      struct st_fp_variant_key k;
+
+      for (size_t i = 0; size % sizeof(k) == 0 && i < size; i += sizeof(k)) {
+         memcpy(&k, data + i, sizeof(k));
+         k.st = st->has_shareable_shaders ? NULL : st;
+         st_get_fp_variant(st, stfp, &k);
+      }
+   }
+
+   st->loading_variant_keys = false;
+   free(data);
+}
+
 static void
 read_stream_out_from_cache(struct blob_reader *blob_reader,
                            struct pipe_shader_state *tgsi)
@@ -187,6 +398,22 @@ read_tgsi_from_cache(struct blob_reader *blob_reader,
    blob_copy_bytes(blob_reader, (uint8_t *) *tokens, tokens_size);
 }
 
+static void
+read_driver_binaries_from_cache(struct st_context *st,
+                                struct blob_reader *blob_reader)
+{
+   struct pipe_context *pipe = st->pipe;
+   unsigned count = blob_read_uint32(blob_reader);
+
+   for (unsigned i = 0; i < count && !blob_reader->overrun; i++) {
+      unsigned size = blob_read_uint32(blob_reader);
+      const void *binary = blob_read_bytes(blob_reader, size);
+
+      if (binary && pipe->add_shader_binary)
+         pipe->add_shader_binary(pipe, binary, size);
+   }
+}
+
 static void
 st_deserialise_ir_program(struct gl_context *ctx,
                           struct gl_shader_program *shProg,
@@ -352,6 +579,11 @@ st_deserialise_ir_program(struct gl_context *ctx,
       unreachable("Unsupported stage");
    }
 
+   /* Give the driver its compiled code back before the variants below are
+    * created.
+    */
+   read_driver_binaries_from_cache(st, &blob_reader);
+
    /* Make sure we don't try to read more data than we wrote. This should
     * never happen in release builds but its useful to have this check to
     * catch development bugs.
@@ -394,6 +626,7 @@ st_load_ir_from_disk_cache(struct gl_context *ctx,
 
       struct gl_program *glprog = prog->_LinkedShaders[i]->Program;
       st_deserialise_ir_program(ctx, prog, glprog, nir);
+      load_variants_from_disk_cache(st_context(ctx), glprog);
 
       /* We don't need the cached blob anymore so free it */
       ralloc_free(glprog->driver_cache_blob);
@@ -412,7 +645,7 @@ st_load_ir_from_disk_cache(struct gl_context *ctx,
 void
 st_serialise_tgsi_program(struct gl_context *ctx, struct gl_program *prog)
 {
-   st_serialise_ir_program(ctx, prog, false);
+   st_serialise_ir_program(ctx, prog, false, false);
 }
 
 void
@@ -420,7 +653,7 @@ st_serialise_tgsi_program_binary(struct gl_context *ctx,
                                  struct gl_shader_program *shProg,
                                  struct gl_program *prog)
 {
-   st_serialise_ir_program(ctx, prog, false);
+   st_serialise_ir_program(ctx, prog, false, true);
 }
 
 void
@@ -434,7 +667,7 @@ st_deserialise_tgsi_program(struct gl_context *ctx,
 void
 st_serialise_nir_program(struct gl_context *ctx, struct gl_program *prog)
 {
-   st_serialise_ir_program(ctx, prog, true);
+   st_serialise_ir_program(ctx, prog, true, false);
 }
 
 void
@@ -442,7 +675,7 @@ st_serialise_nir_program_binary(struct gl_context *ctx,
                                 struct gl_shader_program *shProg,
                                 struct gl_program *prog)
 {
-   st_serialise_ir_program(ctx, prog, true);
+   st_serialise_ir_program(ctx, prog, true, true);
 }
 
 void
@@ -178,8 +178,15 @@ vbo_exec_bind_arrays(struct gl_context *ctx)
 
    GLintptr buffer_offset;
    if (_mesa_is_bufferobj(exec->vtx.bufferobj)) {
-      assert(exec->vtx.bufferobj->Mappings[MAP_INTERNAL].Pointer);
-      buffer_offset = exec->vtx.bufferobj->Mappings[MAP_INTERNAL].Offset;
+      const struct gl_buffer_mapping *map =
+         &exec->vtx.bufferobj->Mappings[MAP_INTERNAL];
+
+      assert(map->Pointer);
+      /* A persistent mapping covers the whole buffer, and buffer_map
+       * points into it at the start of the current batch.
+       */
+      buffer_offset = map->Offset +
+                      ((GLbyte *)exec->vtx.buffer_map - (GLbyte *)map->Pointer);
    } else {
       /* Ptr into ordinary app memory */
       buffer_offset = (GLbyte *)exec->vtx.buffer_map - (GLbyte *)NULL;
@@ -231,6 +238,18 @@ vbo_exec_bind_arrays(struct gl_context *ctx)
 }
 
 
+/**
+ * Whether the VBO is mapped persistently, in which case it stays mapped
+ * while drawing and "unmapping" only hands the written vertices over.
+ */
+static inline bool
+vbo_exec_vtx_is_persistent(const struct vbo_exec_context *exec)
+{
+   return exec->vtx.bufferobj->Mappings[MAP_INTERNAL].AccessFlags &
+          GL_MAP_PERSISTENT_BIT;
+}
+
+
 /**
  * Unmap the VBO.  This is called before drawing.
  */
@@ -240,6 +259,18 @@ vbo_exec_vtx_unmap(struct vbo_exec_context *exec)
    if (_mesa_is_bufferobj(exec->vtx.bufferobj)) {
       struct gl_context *ctx = exec->ctx;
 
+      if (vbo_exec_vtx_is_persistent(exec)) {
+         /* The mapping is coherent, so there's nothing to flush. */
+         exec->vtx.buffer_used += (exec->vtx.buffer_ptr -
+                                   exec->vtx.buffer_map) * sizeof(float);
+         assert(exec->vtx.buffer_used <= VBO_VERT_BUFFER_SIZE);
+
+         exec->vtx.buffer_map = NULL;
+         exec->vtx.buffer_ptr = NULL;
+         exec->vtx.max_vert = 0;
+         return;
+      }
+
       if (ctx->Driver.FlushMappedBufferRange) {
          GLintptr offset = exec->vtx.buffer_used -
                            exec->vtx.bufferobj->Mappings[MAP_INTERNAL].Offset;
@@ -266,6 +297,53 @@ vbo_exec_vtx_unmap(struct vbo_exec_context *exec)
 }
 
 
+/**
+ * Get storage for new vertices from a persistently and coherently mapped
+ * VBO.  The buffer is used as a ring: batches are appended after the ones
+ * already queued for drawing, and the storage is orphaned only once it is
+ * full, so there are no map calls per flush.  Reusing the orphaned storage
+ * once the GPU is done with it is up to the driver's buffer cache.
+ */
+static fi_type *
+vbo_exec_vtx_map_persistent(struct vbo_exec_context *exec)
+{
+   struct gl_context *ctx = exec->ctx;
+   struct gl_buffer_object *obj = exec->vtx.bufferobj;
+
+   if (_mesa_bufferobj_mapped(obj, MAP_INTERNAL)) {
+      if (VBO_VERT_BUFFER_SIZE > exec->vtx.buffer_used + 1024) {
+         return (fi_type *)((GLubyte *)obj->Mappings[MAP_INTERNAL].Pointer +
+                            exec->vtx.buffer_used);
+      }
+
+      ctx->Driver.UnmapBuffer(ctx, obj, MAP_INTERNAL);
+   }
+
+   exec->vtx.buffer_used = 0;
+
+   if (!ctx->Driver.BufferData(ctx, GL_ARRAY_BUFFER_ARB,
+                               VBO_VERT_BUFFER_SIZE,
+                               NULL, GL_STREAM_DRAW_ARB,
+                               GL_MAP_WRITE_BIT |
+                               GL_MAP_PERSISTENT_BIT |
+                               GL_MAP_COHERENT_BIT |
+                               GL_DYNAMIC_STORAGE_BIT |
+                               GL_CLIENT_STORAGE_BIT,
+                               obj)) {
+      _mesa_error(ctx, GL_OUT_OF_MEMORY, "VBO allocation");
+      return NULL;
+   }
+
+   return (fi_type *)ctx->Driver.MapBufferRange(ctx,
+                                                0, VBO_VERT_BUFFER_SIZE,
+                                                GL_MAP_WRITE_BIT |
+                                                GL_MAP_PERSISTENT_BIT |
+                                                GL_MAP_COHERENT_BIT |
+                                                GL_MAP_UNSYNCHRONIZED_BIT,
+                                                obj, MAP_INTERNAL);
+}
+
+
 /**
  * Map the vertex buffer to begin storing glVertex, glColor, etc data.
  */
@@ -286,7 +364,10 @@ vbo_exec_vtx_map(struct vbo_exec_context *exec)
    assert(!exec->vtx.buffer_map);
    assert(!exec->vtx.buffer_ptr);
 
-   if (VBO_VERT_BUFFER_SIZE > exec->vtx.buffer_used + 1024) {
+   if (ctx->Extensions.ARB_buffer_storage) {
+      exec->vtx.buffer_map = vbo_exec_vtx_map_persistent(exec);
+   }
+   else if (VBO_VERT_BUFFER_SIZE > exec->vtx.buffer_used + 1024) {
       /* The VBO exists and there's room for more */
       if (exec->vtx.bufferobj->Size > 0) {
          exec->vtx.buffer_map = (fi_type *)
@@ -304,7 +385,7 @@ vbo_exec_vtx_map(struct vbo_exec_context *exec)
       }
    }
 
-   if (!exec->vtx.buffer_map) {
+   if (!exec->vtx.buffer_map && !ctx->Extensions.ARB_buffer_storage) {
       /* Need to allocate a new VBO */
       exec->vtx.buffer_used = 0;
 
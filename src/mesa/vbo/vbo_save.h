@@ -75,6 +75,12 @@ struct vbo_save_vertex_list {
    GLuint prim_count;
 
    struct vbo_save_primitive_store *prim_store;
+
+   /* The primitives above rewritten as a single indexed GL_TRIANGLES draw,
+    * if they are all polygons.  merged_ib.obj is NULL if they couldn't be.
+    */
+   struct _mesa_prim merged_prim;
+   struct _mesa_index_buffer merged_ib;
 };
 
 
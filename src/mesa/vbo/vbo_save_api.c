@@ -368,6 +368,187 @@ merge_prims(struct _mesa_prim *prim_list,
 }
 
 
+/**
+ * Return the number of indices needed to draw a polygon primitive as a
+ * triangle list, or -1 if the primitive isn't made of polygons.
+ */
+static int
+triangle_list_index_count(const struct _mesa_prim *prim)
+{
+   const GLuint n = prim->count;
+
+   switch (prim->mode) {
+   case GL_TRIANGLES:
+      return n / 3 * 3;
+   case GL_TRIANGLE_STRIP:
+   case GL_TRIANGLE_FAN:
+   case GL_POLYGON:
+      return n >= 3 ? (n - 2) * 3 : 0;
+   case GL_QUADS:
+      return n / 4 * 6;
+   case GL_QUAD_STRIP:
+      return n >= 4 ? (n - 2) / 2 * 6 : 0;
+   default:
+      return -1;
+   }
+}
+
+
+/**
+ * Write the triangle list indices for a polygon primitive.
+ *
+ * The last vertex of each triangle is the one which provides the flat
+ * shaded values with GL_LAST_VERTEX_CONVENTION, and the triangles keep the
+ * winding of the primitive they come from.
+ */
+static GLuint *
+emit_triangle_list_indices(const struct _mesa_prim *prim, GLuint *out)
+{
+   const GLuint s = prim->start;
+   const GLuint n = prim->count;
+   GLuint i;
+
+   switch (prim->mode) {
+   case GL_TRIANGLES:
+      for (i = 0; i + 2 < n; i += 3) {
+         *out++ = s + i;
+         *out++ = s + i + 1;
+         *out++ = s + i + 2;
+      }
+      break;
+   case GL_TRIANGLE_STRIP:
+      for (i = 0; i + 2 < n; i++) {
+         *out++ = s + i + (i & 1);
+         *out++ = s + i + 1 - (i & 1);
+         *out++ = s + i + 2;
+      }
+      break;
+   case GL_TRIANGLE_FAN:
+      for (i = 1; i + 1 < n; i++) {
+         *out++ = s;
+         *out++ = s + i;
+         *out++ = s + i + 1;
+      }
+      break;
+   case GL_POLYGON:
+      /* The first vertex is the provoking one for polygons. */
+      for (i = 1; i + 1 < n; i++) {
+         *out++ = s + i;
+         *out++ = s + i + 1;
+         *out++ = s;
+      }
+      break;
+   case GL_QUADS:
+      for (i = 0; i + 3 < n; i += 4) {
+         *out++ = s + i;
+         *out++ = s + i + 1;
+         *out++ = s + i + 3;
+         *out++ = s + i + 1;
+         *out++ = s + i + 2;
+         *out++ = s + i + 3;
+      }
+      break;
+   case GL_QUAD_STRIP:
+      for (i = 0; i + 3 < n; i += 2) {
+         *out++ = s + i;
+         *out++ = s + i + 1;
+         *out++ = s + i + 3;
+         *out++ = s + i + 2;
+         *out++ = s + i;
+         *out++ = s + i + 3;
+      }
+      break;
+   default:
+      unreachable("not a polygon primitive");
+   }
+
+   return out;
+}
+
+
+/**
+ * Rewrite the primitives of a vertex list made only of triangles, quads and
+ * polygons as one indexed triangle list, so that replaying the list is one
+ * draw instead of one per glBegin/glEnd pair.  The index buffer is built
+ * once here; playback still uses the original primitives whenever the
+ * triangulation could be visible (see vbo_save_playback_vertex_list).
+ */
+static void
+merge_into_triangle_list(struct gl_context *ctx,
+                         struct vbo_save_vertex_list *node)
+{
+   struct vbo_save_context *save = &vbo_context(ctx)->save;
+   GLuint num_indices = 0, max_index;
+   GLuint *indices, *out;
+   unsigned index_size;
+
+   node->merged_ib.obj = NULL;
+
+   /* Edge flags only mean something for the edges of the original
+    * polygons.
+    */
+   if (node->vertex_count == 0 ||
+       (save->enabled & BITFIELD64_BIT(VBO_ATTRIB_EDGEFLAG)))
+      return;
+
+   for (GLuint i = 0; i < node->prim_count; i++) {
+      int count = triangle_list_index_count(&node->prims[i]);
+      if (count < 0)
+         return;
+      num_indices += count;
+   }
+
+   /* Nothing to gain from a single non-indexed triangle list. */
+   if (num_indices == 0 ||
+       (node->prim_count == 1 && node->prims[0].mode == GL_TRIANGLES))
+      return;
+
+   indices = malloc(num_indices * sizeof(GLuint));
+   if (!indices)
+      return;
+
+   out = indices;
+   for (GLuint i = 0; i < node->prim_count; i++)
+      out = emit_triangle_list_indices(&node->prims[i], out);
+   assert(out == indices + num_indices);
+
+   /* Narrow the indices in place if they fit. */
+   max_index = _vbo_save_get_max_index(node);
+   if (max_index <= 0xffff) {
+      GLushort *out16 = (GLushort *) indices;
+      for (GLuint i = 0; i < num_indices; i++)
+         out16[i] = indices[i];
+      index_size = sizeof(GLushort);
+   } else {
+      index_size = sizeof(GLuint);
+   }
+
+   struct gl_buffer_object *bo = ctx->Driver.NewBufferObject(ctx, VBO_BUF_ID);
+   if (bo && !ctx->Driver.BufferData(ctx, GL_ELEMENT_ARRAY_BUFFER_ARB,
+                                     num_indices * index_size, indices,
+                                     GL_STATIC_DRAW_ARB, 0, bo))
+      _mesa_reference_buffer_object(ctx, &bo, NULL);
+   free(indices);
+
+   if (!bo)
+      return;
+
+   node->merged_ib.count = num_indices;
+   node->merged_ib.index_size = index_size;
+   node->merged_ib.obj = bo;
+   node->merged_ib.ptr = NULL;
+
+   memset(&node->merged_prim, 0, sizeof(node->merged_prim));
+   node->merged_prim.mode = GL_TRIANGLES;
+   node->merged_prim.indexed = 1;
+   node->merged_prim.begin = 1;
+   node->merged_prim.end = 1;
+   node->merged_prim.start = 0;
+   node->merged_prim.count = num_indices;
+   node->merged_prim.num_instances = 1;
+}
+
+
 /**
  * Convert GL_LINE_LOOP primitive into GL_LINE_STRIP so that drivers
  * don't have to worry about handling the _mesa_prim::begin/end flags.
@@ -653,6 +834,8 @@ compile_vertex_list(struct gl_context *ctx)
       node->prims[i].start += start_offset;
    }
 
+   merge_into_triangle_list(ctx, node);
+
    /* Deal with GL_COMPILE_AND_EXECUTE:
     */
    if (ctx->ExecuteFlag) {
@@ -1856,6 +2039,8 @@ vbo_destroy_vertex_list(struct gl_context *ctx, void *data)
    if (--node->prim_store->refcount == 0)
       free(node->prim_store);
 
+   _mesa_reference_buffer_object(ctx, &node->merged_ib.obj, NULL);
+
    free(node->current_data);
    node->current_data = NULL;
 }
@@ -35,6 +35,7 @@
 #include "main/macros.h"
 #include "main/light.h"
 #include "main/state.h"
+#include "main/transformfeedback.h"
 #include "main/varray.h"
 #include "util/bitscan.h"
 
@@ -144,6 +145,38 @@ loopback_vertex_list(struct gl_context *ctx,
 }
 
 
+/**
+ * Whether the triangle list made from the list's polygons at compile time
+ * draws exactly what the original primitives would.  It doesn't when the
+ * triangulation shows up in the rendering: polygon edges in line/point
+ * mode, a different provoking vertex, primitive IDs, or a geometry shader
+ * or transform feedback seeing the triangles.
+ */
+static bool
+can_draw_merged_triangles(const struct gl_context *ctx,
+                          const struct vbo_save_vertex_list *node)
+{
+   if (!node->merged_ib.obj)
+      return false;
+
+   if (ctx->RenderMode != GL_RENDER ||
+       ctx->Polygon.FrontMode != GL_FILL ||
+       ctx->Polygon.BackMode != GL_FILL ||
+       ctx->Light.ProvokingVertex != GL_LAST_VERTEX_CONVENTION_EXT)
+      return false;
+
+   if (ctx->GeometryProgram._Current ||
+       _mesa_is_xfb_active_and_unpaused(ctx))
+      return false;
+
+   const struct gl_program *fp = ctx->FragmentProgram._Current;
+   if (fp && (fp->info.inputs_read & VARYING_BIT_PRIMITIVE_ID))
+      return false;
+
+   return true;
+}
+
+
 /**
  * Execute the buffer and save copied verts.
  * This is called from the display list code when executing
@@ -212,8 +245,14 @@ vbo_save_playback_vertex_list(struct gl_context *ctx, void *data)
       if (node->vertex_count > 0) {
          GLuint min_index = _vbo_save_get_min_index(node);
          GLuint max_index = _vbo_save_get_max_index(node);
-         ctx->Driver.Draw(ctx, node->prims, node->prim_count, NULL, GL_TRUE,
-                          min_index, max_index, NULL, 0, NULL);
+
+         if (can_draw_merged_triangles(ctx, node)) {
+            ctx->Driver.Draw(ctx, &node->merged_prim, 1, &node->merged_ib,
+                             GL_TRUE, min_index, max_index, NULL, 0, NULL);
+         } else {
+            ctx->Driver.Draw(ctx, node->prims, node->prim_count, NULL,
+                             GL_TRUE, min_index, max_index, NULL, 0, NULL);
+         }
       }
    }
 
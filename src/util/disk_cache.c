@@ -39,9 +39,17 @@
 #include <dirent.h>
 #include "zlib.h"
 
+#ifdef HAVE_ZSTD
+#include "zstd.h"
+#endif
+
 #include "util/crc32.h"
 #include "util/debug.h"
+#include "util/list.h"
+#include "util/os_time.h"
 #include "util/rand_xor.h"
+#include "util/set.h"
+#include "util/simple_mtx.h"
 #include "util/u_atomic.h"
 #include "util/u_queue.h"
 #include "util/mesa-sha1.h"
@@ -74,6 +82,72 @@
  */
 #define CACHE_VERSION 1
 
+/* Compression of cache entries, selected with MESA_GLSL_CACHE_COMPRESSION.
+ *
+ * Readers don't need to know which codec wrote an entry: zlib streams never
+ * start with the zstd frame magic, so entries of both kinds can live in the
+ * same cache.
+ */
+enum cache_codec {
+   CACHE_CODEC_ZLIB,
+   CACHE_CODEC_ZSTD,
+};
+
+/* Entries are compressed on the cache thread, off the critical path, but
+ * that thread still needs to keep up during warmup.
+ */
+#define CACHE_ZSTD_LEVEL 10
+
+/* The packed cache format (MESA_GLSL_CACHE_PACKED) replaces the file per
+ * entry layout with a few files in <cache dir>/packed:
+ *
+ * - index: a hash table of packed_index_entry, mmapped shared just like
+ *   the key index, so that a lookup is a probe of at most
+ *   PACKED_INDEX_PROBES contiguous slots without any syscalls.
+ *
+ * - data.<generation>: append-only file of entries, each one a
+ *   packed_entry_header followed by exactly what a loose cache file
+ *   contains. A compaction copies the entries still referenced by the
+ *   index into the next generation and drops the old file.
+ *
+ * All writers hold an exclusive flock on the index file. Readers don't
+ * lock, a torn index entry is caught by the key in the entry header and
+ * the crc of the data, and just ends up as a cache miss.
+ */
+#define PACKED_DIR_NAME "packed"
+#define PACKED_INDEX_MAGIC 0x6b63706d /* "mpck" */
+#define PACKED_INDEX_SLOTS (1 << 16)
+#define PACKED_INDEX_PROBES 16
+
+struct packed_index_header {
+   uint32_t magic;
+   uint32_t version;
+
+   /* Generation of the data file new entries are appended to. */
+   uint32_t generation;
+   uint32_t pad;
+
+   /* Size of the current data file, and how much of it is referenced by
+    * the index.
+    */
+   uint64_t data_size;
+   uint64_t live_size;
+};
+
+struct packed_index_entry {
+   uint8_t key[CACHE_KEY_SIZE];
+   uint32_t generation;
+   uint64_t offset;
+   /* Size including the packed_entry_header, 0 for an empty slot. */
+   uint32_t size;
+   uint32_t pad;
+};
+
+struct packed_entry_header {
+   uint8_t key[CACHE_KEY_SIZE];
+   uint32_t size;
+};
+
 struct disk_cache {
    /* The path to the cache directory. */
    char *path;
@@ -82,6 +156,16 @@ struct disk_cache {
    /* Thread queue for compressing and writing cache entries to disk */
    struct util_queue cache_queue;
 
+   /* Puts are batched: disk_cache_put() appends them here, and a single
+    * cache thread job writes out everything pending at the time it runs.
+    * Keys of all pending and in progress puts are in keys_in_flight, so that
+    * the same entry isn't written twice.
+    */
+   simple_mtx_t put_mutex;
+   struct list_head pending_puts;
+   struct set *keys_in_flight;
+   struct disk_cache_stats stats;
+
    /* Seed for rand, which is used to pick a random directory */
    uint64_t seed_xorshift128plus[2];
 
@@ -104,10 +188,34 @@ struct disk_cache {
 
    disk_cache_put_cb blob_put_cb;
    disk_cache_get_cb blob_get_cb;
+
+   enum cache_codec codec;
+#ifdef HAVE_ZSTD
+   /* Only ever used by the cache thread. */
+   ZSTD_CCtx *zstd_cctx;
+
+   /* Optional dictionary, from MESA_GLSL_CACHE_ZSTD_DICT. */
+   ZSTD_CDict *zstd_cdict;
+   ZSTD_DDict *zstd_ddict;
+#endif
+
+   /* Packed format state, see packed_cache_init(). */
+   bool packed;
+   int packed_index_fd;
+   uint8_t *packed_index_mmap;
+   size_t packed_index_mmap_size;
+   struct packed_index_header *packed_header;
+   struct packed_index_entry *packed_entries;
+
+   /* Read-only fd of the most recently read data file. */
+   simple_mtx_t packed_data_mutex;
+   int packed_data_fd;
+   uint32_t packed_data_generation;
 };
 
 struct disk_cache_put_job {
-   struct util_queue_fence fence;
+   /* Link in disk_cache::pending_puts. */
+   struct list_head link;
 
    struct disk_cache *cache;
 
@@ -182,6 +290,228 @@ concatenate_and_mkdir(void *ctx, const char *path, const char *name)
       return NULL;
 }
 
+/* Return the path of the packed data file of \p generation. The returned
+ * filename is malloc'ed, or NULL if out of memory.
+ */
+static char *
+packed_data_path(struct disk_cache *cache, uint32_t generation)
+{
+   char *filename;
+
+   if (asprintf(&filename, "%s/" PACKED_DIR_NAME "/data.%u", cache->path,
+                generation) == -1)
+      return NULL;
+
+   return filename;
+}
+
+static unsigned
+packed_index_slot(const cache_key key)
+{
+   const uint32_t *key_chunk = (const uint32_t *) key;
+   return CPU_TO_LE32(*key_chunk) & (PACKED_INDEX_SLOTS - 1);
+}
+
+/* Returns the packed index entry for \p key, or NULL if there is none.
+ *
+ * Slots are never chained, a key lives in one of the PACKED_INDEX_PROBES
+ * slots following its hash, so clearing a slot doesn't hide other keys.
+ */
+static struct packed_index_entry *
+packed_find_entry(struct disk_cache *cache, const cache_key key)
+{
+   unsigned slot = packed_index_slot(key);
+
+   for (unsigned i = 0; i < PACKED_INDEX_PROBES; i++) {
+      struct packed_index_entry *entry =
+         &cache->packed_entries[(slot + i) & (PACKED_INDEX_SLOTS - 1)];
+
+      if (entry->size && memcmp(entry->key, key, CACHE_KEY_SIZE) == 0)
+         return entry;
+   }
+
+   return NULL;
+}
+
+/* Open (or create) and map the packed index.
+ *
+ * Returns: true on success, in which case the packed format is used for all
+ *          entries of this cache.
+ */
+static bool
+packed_cache_init(struct disk_cache *cache, void *mem_ctx)
+{
+   struct packed_index_header *header;
+   struct stat sb;
+   uint8_t *index_mmap;
+   char *path;
+   int fd;
+
+   size_t size = sizeof(struct packed_index_header) +
+      PACKED_INDEX_SLOTS * sizeof(struct packed_index_entry);
+
+   path = concatenate_and_mkdir(mem_ctx, cache->path, PACKED_DIR_NAME);
+   if (path == NULL)
+      return false;
+
+   path = ralloc_asprintf(mem_ctx, "%s/index", path);
+   if (path == NULL)
+      return false;
+
+   fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+   if (fd == -1)
+      return false;
+
+   /* Keep other processes from using the index while it gets set up. */
+   if (flock(fd, LOCK_EX) == -1)
+      goto fail;
+
+   if (fstat(fd, &sb) == -1)
+      goto fail;
+
+   if (sb.st_size != size) {
+      if (ftruncate(fd, size) == -1)
+         goto fail;
+   }
+
+   index_mmap = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (index_mmap == MAP_FAILED)
+      goto fail;
+
+   header = (struct packed_index_header *) index_mmap;
+   if (header->magic != PACKED_INDEX_MAGIC ||
+       header->version != CACHE_VERSION) {
+      char *filename;
+
+      /* A new or incompatible index, start over. */
+      memset(index_mmap, 0, size);
+      header->magic = PACKED_INDEX_MAGIC;
+      header->version = CACHE_VERSION;
+
+      filename = packed_data_path(cache, 0);
+      if (filename) {
+         unlink(filename);
+         free(filename);
+      }
+   }
+
+   flock(fd, LOCK_UN);
+
+   cache->packed_index_fd = fd;
+   cache->packed_index_mmap = index_mmap;
+   cache->packed_index_mmap_size = size;
+   cache->packed_header = header;
+   cache->packed_entries = (struct packed_index_entry *) (header + 1);
+
+   simple_mtx_init(&cache->packed_data_mutex, mtx_plain);
+   cache->packed_data_fd = -1;
+
+   return true;
+
+ fail:
+   close(fd);
+   return false;
+}
+
+static ssize_t
+read_all(int fd, void *buf, size_t count)
+{
+   char *in = buf;
+   ssize_t read_ret;
+   size_t done;
+
+   for (done = 0; done < count; done += read_ret) {
+      read_ret = read(fd, in + done, count - done);
+      if (read_ret == -1 || read_ret == 0)
+         return -1;
+   }
+   return done;
+}
+
+#ifdef HAVE_ZSTD
+/* Load a zstd dictionary, e.g. one trained with "zstd --train" on the
+ * uncompressed payloads of existing cache entries.
+ */
+static void
+cache_zstd_load_dictionary(struct disk_cache *cache, const char *path)
+{
+   struct stat sb;
+   void *dict;
+   int fd;
+
+   fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd == -1)
+      return;
+
+   if (fstat(fd, &sb) == -1 || sb.st_size == 0) {
+      close(fd);
+      return;
+   }
+
+   dict = malloc(sb.st_size);
+   if (dict && read_all(fd, dict, sb.st_size) != -1) {
+      /* Both copy the dictionary. */
+      cache->zstd_cdict = ZSTD_createCDict(dict, sb.st_size, CACHE_ZSTD_LEVEL);
+      cache->zstd_ddict = ZSTD_createDDict(dict, sb.st_size);
+   }
+
+   free(dict);
+   close(fd);
+}
+#endif
+
+static void
+cache_codec_init(struct disk_cache *cache)
+{
+   const char *codec = getenv("MESA_GLSL_CACHE_COMPRESSION");
+
+#ifdef HAVE_ZSTD
+   if (codec == NULL || strcmp(codec, "zstd") == 0) {
+      const char *dict_path = getenv("MESA_GLSL_CACHE_ZSTD_DICT");
+
+      cache->zstd_cctx = ZSTD_createCCtx();
+      if (cache->zstd_cctx) {
+         cache->codec = CACHE_CODEC_ZSTD;
+         if (dict_path)
+            cache_zstd_load_dictionary(cache, dict_path);
+         return;
+      }
+   }
+#endif
+
+   if (codec && strcmp(codec, "zlib") != 0)
+      fprintf(stderr, "Unsupported shader cache compression \"%s\", "
+              "using zlib.\n", codec);
+
+   cache->codec = CACHE_CODEC_ZLIB;
+}
+
+static void
+cache_codec_fini(struct disk_cache *cache)
+{
+#ifdef HAVE_ZSTD
+   ZSTD_freeCCtx(cache->zstd_cctx);
+   ZSTD_freeCDict(cache->zstd_cdict);
+   ZSTD_freeDDict(cache->zstd_ddict);
+#endif
+}
+
+static uint32_t
+cache_key_hash(const void *key)
+{
+   uint32_t hash;
+
+   /* Keys are sha1 hashes already, any 32 bits of them will do. */
+   memcpy(&hash, key, sizeof(hash));
+   return hash;
+}
+
+static bool
+cache_key_equals(const void *a, const void *b)
+{
+   return memcmp(a, b, CACHE_KEY_SIZE) == 0;
+}
+
 #define DRV_KEY_CPY(_dst, _src, _src_size) \
 do {                                       \
    memcpy(_dst, _src, _src_size);          \
@@ -220,6 +550,13 @@ disk_cache_create(const char *gpu_name, const char *driver_id,
    if (cache == NULL)
       goto fail;
 
+   simple_mtx_init(&cache->put_mutex, mtx_plain);
+   list_inithead(&cache->pending_puts);
+   cache->keys_in_flight = _mesa_set_create(cache, cache_key_hash,
+                                            cache_key_equals);
+   if (cache->keys_in_flight == NULL)
+      goto fail;
+
    /* Assume failure. */
    cache->path_init_failed = true;
 
@@ -368,6 +705,11 @@ disk_cache_create(const char *gpu_name, const char *driver_id,
 
    cache->max_size = max_size;
 
+   if (env_var_as_boolean("MESA_GLSL_CACHE_PACKED", false))
+      cache->packed = packed_cache_init(cache, local);
+
+   cache_codec_init(cache);
+
    /* 1 thread was chosen because we don't really care about getting things
     * to disk quickly just that it's not blocking other tasks.
     *
@@ -377,7 +719,8 @@ disk_cache_create(const char *gpu_name, const char *driver_id,
    util_queue_init(&cache->cache_queue, "disk$", 32, 1,
                    UTIL_QUEUE_INIT_RESIZE_IF_FULL |
                    UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY |
-                   UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY);
+                   UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY |
+                   UTIL_QUEUE_INIT_SHARED);
 
    cache->path_init_failed = false;
 
@@ -424,8 +767,10 @@ disk_cache_create(const char *gpu_name, const char *driver_id,
    return cache;
 
  fail:
-   if (cache)
+   if (cache) {
+      simple_mtx_destroy(&cache->put_mutex);
       ralloc_free(cache);
+   }
    ralloc_free(local);
 
    return NULL;
@@ -436,9 +781,28 @@ disk_cache_destroy(struct disk_cache *cache)
 {
    if (cache && !cache->path_init_failed) {
       util_queue_destroy(&cache->cache_queue);
+      cache_codec_fini(cache);
       munmap(cache->index_mmap, cache->index_mmap_size);
+
+      /* Anything the queue didn't get to is lost. */
+      list_for_each_entry_safe(struct disk_cache_put_job, dc_job,
+                               &cache->pending_puts, link) {
+         free(dc_job->cache_item_metadata.keys);
+         free(dc_job);
+      }
+
+      if (cache->packed) {
+         munmap(cache->packed_index_mmap, cache->packed_index_mmap_size);
+         close(cache->packed_index_fd);
+         if (cache->packed_data_fd != -1)
+            close(cache->packed_data_fd);
+         simple_mtx_destroy(&cache->packed_data_mutex);
+      }
    }
 
+   if (cache)
+      simple_mtx_destroy(&cache->put_mutex);
+
    ralloc_free(cache);
 }
 
@@ -671,6 +1035,23 @@ disk_cache_remove(struct disk_cache *cache, const cache_key key)
 {
    struct stat sb;
 
+   if (cache->packed) {
+      struct packed_index_entry *entry;
+
+      if (flock(cache->packed_index_fd, LOCK_EX) == -1)
+         return;
+
+      entry = packed_find_entry(cache, key);
+      if (entry) {
+         p_atomic_add(&cache->packed_header->live_size,
+                      - (uint64_t)entry->size);
+         entry->size = 0;
+      }
+
+      flock(cache->packed_index_fd, LOCK_UN);
+      return;
+   }
+
    char *filename = get_cache_file(cache, key);
    if (filename == NULL) {
       return;
@@ -688,21 +1069,6 @@ disk_cache_remove(struct disk_cache *cache, const cache_key key)
       p_atomic_add(cache->size, - (uint64_t)sb.st_blocks * 512);
 }
 
-static ssize_t
-read_all(int fd, void *buf, size_t count)
-{
-   char *in = buf;
-   ssize_t read_ret;
-   size_t done;
-
-   for (done = 0; done < count; done += read_ret) {
-      read_ret = read(fd, in + done, count - done);
-      if (read_ret == -1 || read_ret == 0)
-         return -1;
-   }
-   return done;
-}
-
 static ssize_t
 write_all(int fd, const void *buf, size_t count)
 {
@@ -794,6 +1160,72 @@ deflate_and_write_to_disk(const void *in_data, size_t in_data_size, int dest,
    return compressed_size;
 }
 
+#ifdef HAVE_ZSTD
+static size_t
+zstd_compress_and_write_to_disk(struct disk_cache *cache,
+                                const void *in_data, size_t in_data_size,
+                                int dest)
+{
+   size_t out_size = ZSTD_compressBound(in_data_size);
+   size_t compressed_size;
+   void *out;
+
+   /* Unlike the zlib path this compresses in one go, cache entries are
+    * small enough for that.
+    */
+   out = malloc(out_size);
+   if (out == NULL)
+      return 0;
+
+   if (cache->zstd_cdict) {
+      compressed_size = ZSTD_compress_usingCDict(cache->zstd_cctx,
+                                                 out, out_size,
+                                                 in_data, in_data_size,
+                                                 cache->zstd_cdict);
+   } else {
+      compressed_size = ZSTD_compressCCtx(cache->zstd_cctx, out, out_size,
+                                          in_data, in_data_size,
+                                          CACHE_ZSTD_LEVEL);
+   }
+
+   if (ZSTD_isError(compressed_size) ||
+       write_all(dest, out, compressed_size) == -1)
+      compressed_size = 0;
+
+   free(out);
+   return compressed_size;
+}
+#endif
+
+/**
+ * Compresses cache entry with the codec of \p cache and writes it to disk.
+ * Returns the size of the data written to disk.
+ */
+static size_t
+compress_and_write_to_disk(struct disk_cache *cache,
+                           const void *in_data, size_t in_data_size,
+                           int dest, const char *filename)
+{
+   size_t compressed_size;
+
+#ifdef HAVE_ZSTD
+   if (cache->codec == CACHE_CODEC_ZSTD)
+      compressed_size = zstd_compress_and_write_to_disk(cache, in_data,
+                                                        in_data_size, dest);
+   else
+#endif
+      compressed_size = deflate_and_write_to_disk(in_data, in_data_size,
+                                                  dest, filename);
+
+   if (compressed_size) {
+      p_atomic_add(&cache->stats.written_compressed_size,
+                   (uint64_t)compressed_size);
+      p_atomic_add(&cache->stats.written_size, (uint64_t)in_data_size);
+   }
+
+   return compressed_size;
+}
+
 static struct disk_cache_put_job *
 create_put_job(struct disk_cache *cache, const cache_key key,
                const void *data, size_t size,
@@ -855,35 +1287,351 @@ struct cache_entry_file_data {
    uint32_t uncompressed_size;
 };
 
-static void
-cache_put(void *job, int thread_index)
+/**
+ * Writes a complete cache entry (everything a loose cache file contains) to
+ * \p fd at its current position. Returns the number of bytes written, or 0
+ * on failure.
+ */
+static size_t
+write_cache_entry(struct disk_cache_put_job *dc_job, int fd,
+                  const char *filename)
 {
-   assert(job);
+   size_t entry_size = 0;
+   ssize_t ret;
 
-   int fd = -1, fd_final = -1, err, ret;
-   unsigned i = 0;
-   char *filename = NULL, *filename_tmp = NULL;
-   struct disk_cache_put_job *dc_job = (struct disk_cache_put_job *) job;
+   /* Write the driver_keys_blob, this can be used find information about the
+    * mesa version that produced the entry or deal with hash collisions,
+    * should that ever become a real problem.
+    */
+   ret = write_all(fd, dc_job->cache->driver_keys_blob,
+                   dc_job->cache->driver_keys_blob_size);
+   if (ret == -1)
+      return 0;
+   entry_size += ret;
 
-   filename = get_cache_file(dc_job->cache, dc_job->key);
-   if (filename == NULL)
-      goto done;
+   /* Write the cache item metadata. This data can be used to deal with
+    * hash collisions, as well as providing useful information to 3rd party
+    * tools reading the cache files.
+    */
+   ret = write_all(fd, &dc_job->cache_item_metadata.type,
+                   sizeof(uint32_t));
+   if (ret == -1)
+      return 0;
+   entry_size += ret;
 
-   /* If the cache is too large, evict something else first. */
-   while (*dc_job->cache->size + dc_job->size > dc_job->cache->max_size &&
-          i < 8) {
-      evict_lru_item(dc_job->cache);
-      i++;
+   if (dc_job->cache_item_metadata.type == CACHE_ITEM_TYPE_GLSL) {
+      ret = write_all(fd, &dc_job->cache_item_metadata.num_keys,
+                      sizeof(uint32_t));
+      if (ret == -1)
+         return 0;
+      entry_size += ret;
+
+      ret = write_all(fd, dc_job->cache_item_metadata.keys[0],
+                      dc_job->cache_item_metadata.num_keys *
+                      sizeof(cache_key));
+      if (ret == -1)
+         return 0;
+      entry_size += ret;
    }
 
-   /* Write to a temporary file to allow for an atomic rename to the
-    * final destination filename, (to prevent any readers from seeing
-    * a partially written file).
+   /* Create CRC of the data. We will read this when restoring the cache and
+    * use it to check for corruption.
     */
-   if (asprintf(&filename_tmp, "%s.tmp", filename) == -1)
-      goto done;
-
-   fd = open(filename_tmp, O_WRONLY | O_CLOEXEC | O_CREAT, 0644);
+   struct cache_entry_file_data cf_data;
+   cf_data.crc32 = util_hash_crc32(dc_job->data, dc_job->size);
+   cf_data.uncompressed_size = dc_job->size;
+
+   ret = write_all(fd, &cf_data, sizeof(cf_data));
+   if (ret == -1)
+      return 0;
+   entry_size += ret;
+
+   /* Now, finally, write out the contents. */
+   size_t compressed_size = compress_and_write_to_disk(dc_job->cache,
+                                                       dc_job->data,
+                                                       dc_job->size,
+                                                       fd, filename);
+   if (compressed_size == 0)
+      return 0;
+
+   return entry_size + compressed_size;
+}
+
+/* Store an index entry for \p key, evicting whatever was in the first of
+ * its slots if they are all in use. Must be called with the index locked.
+ */
+static void
+packed_insert_entry(struct disk_cache *cache, const cache_key key,
+                    uint32_t generation, uint64_t offset, uint32_t size)
+{
+   unsigned slot = packed_index_slot(key);
+   struct packed_index_entry *entry = NULL;
+
+   for (unsigned i = 0; i < PACKED_INDEX_PROBES; i++) {
+      struct packed_index_entry *e =
+         &cache->packed_entries[(slot + i) & (PACKED_INDEX_SLOTS - 1)];
+
+      if (e->size == 0) {
+         entry = e;
+         break;
+      }
+   }
+
+   if (entry == NULL) {
+      entry = &cache->packed_entries[slot];
+      p_atomic_add(&cache->packed_header->live_size, - (uint64_t)entry->size);
+   }
+
+   /* Readers don't take the lock, so invalidate the slot while updating
+    * it. Anything they still manage to read torn fails the key check of
+    * the entry header.
+    */
+   entry->size = 0;
+   entry->generation = generation;
+   entry->offset = offset;
+   memcpy(entry->key, key, CACHE_KEY_SIZE);
+   entry->size = size;
+
+   p_atomic_add(&cache->packed_header->live_size, (uint64_t)size);
+}
+
+static int
+compare_packed_entry_offset(const void *a, const void *b)
+{
+   const struct packed_index_entry *entry_a =
+      *(const struct packed_index_entry **) a;
+   const struct packed_index_entry *entry_b =
+      *(const struct packed_index_entry **) b;
+
+   if (entry_a->offset < entry_b->offset)
+      return -1;
+   return entry_a->offset > entry_b->offset;
+}
+
+/* Copy all entries still referenced by the index into the next data file
+ * generation, and drop the current one.
+ *
+ * If more than half of max_size would be in use once \p needed bytes are
+ * added, the oldest entries are evicted, which also means a full cache
+ * only gets compacted every max_size / 2 bytes written.
+ *
+ * Must be called with the index locked.
+ */
+static void
+packed_cache_compact(struct disk_cache *cache, uint64_t needed)
+{
+   struct packed_index_header *header = cache->packed_header;
+   struct packed_index_entry **entries;
+   uint32_t generation = header->generation;
+   uint64_t live_size = header->live_size;
+   uint64_t offset = 0;
+   unsigned num_entries = 0, i;
+   char *old_filename = NULL, *new_filename = NULL;
+   int old_fd = -1, new_fd = -1;
+   uint8_t *buf = NULL;
+   size_t buf_size = 0;
+   bool failed = false;
+
+   entries = malloc(PACKED_INDEX_SLOTS * sizeof(*entries));
+   if (entries == NULL)
+      return;
+
+   for (i = 0; i < PACKED_INDEX_SLOTS; i++) {
+      if (cache->packed_entries[i].size)
+         entries[num_entries++] = &cache->packed_entries[i];
+   }
+
+   /* Entries are appended, so the file offset is their age. */
+   qsort(entries, num_entries, sizeof(*entries), compare_packed_entry_offset);
+
+   old_filename = packed_data_path(cache, generation);
+   new_filename = packed_data_path(cache, generation + 1);
+   if (old_filename == NULL || new_filename == NULL)
+      goto done;
+
+   old_fd = open(old_filename, O_RDONLY | O_CLOEXEC);
+   new_fd = open(new_filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+   if (new_fd == -1)
+      goto done;
+
+   for (i = 0; i < num_entries; i++) {
+      struct packed_index_entry *entry = entries[i];
+      uint32_t size = entry->size;
+
+      if (live_size + needed > cache->max_size / 2 ||
+          entry->generation != generation || old_fd == -1 || failed) {
+         live_size -= size;
+         entry->size = 0;
+         continue;
+      }
+
+      if (size > buf_size) {
+         uint8_t *new_buf = realloc(buf, size);
+         if (new_buf == NULL) {
+            live_size -= size;
+            entry->size = 0;
+            continue;
+         }
+         buf = new_buf;
+         buf_size = size;
+      }
+
+      if (pread(old_fd, buf, size, entry->offset) != size) {
+         live_size -= size;
+         entry->size = 0;
+         continue;
+      }
+
+      /* After a failed write the offsets of the new file are unknown, so
+       * all remaining entries are dropped.
+       */
+      if (write_all(new_fd, buf, size) == -1) {
+         failed = true;
+         live_size -= size;
+         entry->size = 0;
+         continue;
+      }
+
+      entry->size = 0;
+      entry->generation = generation + 1;
+      entry->offset = offset;
+      entry->size = size;
+      offset += size;
+   }
+
+   header->generation = generation + 1;
+   header->data_size = offset;
+   header->live_size = live_size;
+
+   unlink(old_filename);
+
+ done:
+   if (old_fd != -1)
+      close(old_fd);
+   if (new_fd != -1)
+      close(new_fd);
+   free(old_filename);
+   free(new_filename);
+   free(entries);
+   free(buf);
+}
+
+/* Once the data file is at least this large, it is compacted as soon as
+ * more than half of it is garbage.
+ */
+#define PACKED_COMPACT_MIN_SIZE (1024 * 1024)
+
+/* Append a batch of entries to the current data file, with a single lock
+ * of the index and open of the data file for all of them.
+ */
+static void
+packed_cache_put_batch(struct disk_cache *cache, struct list_head *jobs)
+{
+   struct packed_index_header *header = cache->packed_header;
+   struct packed_entry_header entry_header;
+   char *filename = NULL;
+   uint64_t batch_size = 0;
+   uint32_t generation;
+   off_t offset;
+   int fd = -1;
+
+   if (flock(cache->packed_index_fd, LOCK_EX) == -1)
+      return;
+
+   /* The uncompressed size is a good enough upper bound of what the
+    * entries are going to take.
+    */
+   list_for_each_entry(struct disk_cache_put_job, dc_job, jobs, link)
+      batch_size += dc_job->size;
+
+   if (header->data_size + batch_size > cache->max_size ||
+       (header->data_size > PACKED_COMPACT_MIN_SIZE &&
+        header->data_size > 2 * header->live_size))
+      packed_cache_compact(cache, batch_size);
+
+   generation = header->generation;
+   filename = packed_data_path(cache, generation);
+   if (filename == NULL)
+      goto done;
+
+   fd = open(filename, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+   if (fd == -1)
+      goto done;
+
+   offset = lseek(fd, 0, SEEK_END);
+   if (offset == -1)
+      goto done;
+
+   list_for_each_entry(struct disk_cache_put_job, dc_job, jobs, link) {
+      /* Another process might have written the same entry meanwhile. */
+      if (packed_find_entry(cache, dc_job->key))
+         continue;
+
+      /* Write the header with a zero size first, it's updated once the
+       * size of the compressed entry is known.
+       */
+      memcpy(entry_header.key, dc_job->key, CACHE_KEY_SIZE);
+      entry_header.size = 0;
+      if (write_all(fd, &entry_header, sizeof(entry_header)) == -1)
+         goto fail;
+
+      size_t entry_size = write_cache_entry(dc_job, fd, filename);
+      if (entry_size == 0)
+         goto fail;
+
+      entry_header.size = entry_size;
+      if (pwrite(fd, &entry_header, sizeof(entry_header), offset) !=
+          sizeof(entry_header))
+         goto fail;
+
+      packed_insert_entry(cache, dc_job->key, generation, offset,
+                          sizeof(entry_header) + entry_size);
+      offset += sizeof(entry_header) + entry_size;
+      header->data_size = offset;
+   }
+   goto done;
+
+ fail:
+   /* Drop the partially written entry, and give up on the rest of the
+    * batch. Should the truncate fail as well, it's just garbage that the
+    * next compaction gets rid of.
+    */
+   if (ftruncate(fd, offset) == -1)
+      header->data_size = lseek(fd, 0, SEEK_END);
+
+ done:
+   if (fd != -1)
+      close(fd);
+   free(filename);
+   flock(cache->packed_index_fd, LOCK_UN);
+}
+
+static void
+cache_put(struct disk_cache_put_job *dc_job)
+{
+   int fd = -1, fd_final = -1, err, ret;
+   unsigned i = 0;
+   char *filename = NULL, *filename_tmp = NULL;
+
+   filename = get_cache_file(dc_job->cache, dc_job->key);
+   if (filename == NULL)
+      goto done;
+
+   /* If the cache is too large, evict something else first. */
+   while (*dc_job->cache->size + dc_job->size > dc_job->cache->max_size &&
+          i < 8) {
+      evict_lru_item(dc_job->cache);
+      i++;
+   }
+
+   /* Write to a temporary file to allow for an atomic rename to the
+    * final destination filename, (to prevent any readers from seeing
+    * a partially written file).
+    */
+   if (asprintf(&filename_tmp, "%s.tmp", filename) == -1)
+      goto done;
+
+   fd = open(filename_tmp, O_WRONLY | O_CLOEXEC | O_CREAT, 0644);
 
    /* Make the two-character subdirectory within the cache as needed. */
    if (fd == -1) {
@@ -923,69 +1671,15 @@ cache_put(void *job, int thread_index)
     * by some other process.
     */
 
-   /* Write the driver_keys_blob, this can be used find information about the
-    * mesa version that produced the entry or deal with hash collisions,
-    * should that ever become a real problem.
-    */
-   ret = write_all(fd, dc_job->cache->driver_keys_blob,
-                   dc_job->cache->driver_keys_blob_size);
-   if (ret == -1) {
-      unlink(filename_tmp);
-      goto done;
-   }
-
-   /* Write the cache item metadata. This data can be used to deal with
-    * hash collisions, as well as providing useful information to 3rd party
-    * tools reading the cache files.
-    */
-   ret = write_all(fd, &dc_job->cache_item_metadata.type,
-                   sizeof(uint32_t));
-   if (ret == -1) {
-      unlink(filename_tmp);
-      goto done;
-   }
-
-   if (dc_job->cache_item_metadata.type == CACHE_ITEM_TYPE_GLSL) {
-      ret = write_all(fd, &dc_job->cache_item_metadata.num_keys,
-                      sizeof(uint32_t));
-      if (ret == -1) {
-         unlink(filename_tmp);
-         goto done;
-      }
-
-      ret = write_all(fd, dc_job->cache_item_metadata.keys[0],
-                      dc_job->cache_item_metadata.num_keys *
-                      sizeof(cache_key));
-      if (ret == -1) {
-         unlink(filename_tmp);
-         goto done;
-      }
-   }
-
-   /* Create CRC of the data. We will read this when restoring the cache and
-    * use it to check for corruption.
-    */
-   struct cache_entry_file_data cf_data;
-   cf_data.crc32 = util_hash_crc32(dc_job->data, dc_job->size);
-   cf_data.uncompressed_size = dc_job->size;
-
-   size_t cf_data_size = sizeof(cf_data);
-   ret = write_all(fd, &cf_data, cf_data_size);
-   if (ret == -1) {
+   size_t file_size = write_cache_entry(dc_job, fd, filename_tmp);
+   if (file_size == 0) {
       unlink(filename_tmp);
       goto done;
    }
 
-   /* Now, finally, write out the contents to the temporary file, then
-    * rename them atomically to the destination filename, and also
-    * perform an atomic increment of the total cache size.
+   /* Rename the temporary file atomically to the destination filename, and
+    * also perform an atomic increment of the total cache size.
     */
-   size_t file_size = deflate_and_write_to_disk(dc_job->data, dc_job->size,
-                                                fd, filename_tmp);
-   if (file_size == 0) {
-      unlink(filename_tmp);
-      goto done;
-   }
    ret = rename(filename_tmp, filename);
    if (ret == -1) {
       unlink(filename_tmp);
@@ -1013,11 +1707,70 @@ cache_put(void *job, int thread_index)
    free(filename);
 }
 
+struct disk_cache_batch_job {
+   struct util_queue_fence fence;
+
+   struct disk_cache *cache;
+};
+
+/* Write out all puts pending at the time the job runs. */
+static void
+cache_put_batch(void *job, int thread_index)
+{
+   struct disk_cache_batch_job *batch_job = (struct disk_cache_batch_job *) job;
+   struct disk_cache *cache = batch_job->cache;
+   struct list_head jobs;
+   uint64_t num_jobs = 0, batch_size = 0;
+
+   /* Take the whole list, puts arriving from now on queue a new batch. */
+   simple_mtx_lock(&cache->put_mutex);
+   list_replace(&cache->pending_puts, &jobs);
+   list_inithead(&cache->pending_puts);
+   simple_mtx_unlock(&cache->put_mutex);
+
+   if (list_empty(&jobs))
+      return;
+
+   if (cache->packed) {
+      packed_cache_put_batch(cache, &jobs);
+   } else {
+      list_for_each_entry(struct disk_cache_put_job, dc_job, &jobs, link)
+         cache_put(dc_job);
+   }
+
+   simple_mtx_lock(&cache->put_mutex);
+   list_for_each_entry_safe(struct disk_cache_put_job, dc_job, &jobs, link) {
+      _mesa_set_remove_key(cache->keys_in_flight, dc_job->key);
+      num_jobs++;
+      batch_size += dc_job->size;
+      destroy_put_job(dc_job, thread_index);
+   }
+   cache->stats.batches++;
+   cache->stats.written += num_jobs;
+   cache->stats.pending_size -= batch_size;
+   simple_mtx_unlock(&cache->put_mutex);
+}
+
+static void
+destroy_batch_job(void *job, int thread_index)
+{
+   free(job);
+}
+
+/* How much data may be waiting to be written before puts get dropped.
+ * A put is just a cache fill, so there's no point in blocking the
+ * application on it.
+ */
+#define MAX_PENDING_PUT_SIZE (64 * 1024 * 1024)
+
 void
 disk_cache_put(struct disk_cache *cache, const cache_key key,
                const void *data, size_t size,
                struct cache_item_metadata *cache_item_metadata)
 {
+   struct disk_cache_batch_job *batch_job = NULL;
+   bool queue_batch;
+
    if (cache->blob_put_cb) {
       cache->blob_put_cb(key, CACHE_KEY_SIZE, data, size);
       return;
@@ -1026,14 +1779,71 @@ disk_cache_put(struct disk_cache *cache, const cache_key key,
    if (cache->path_init_failed)
       return;
 
+   simple_mtx_lock(&cache->put_mutex);
+   cache->stats.puts++;
+   if (_mesa_set_search(cache->keys_in_flight, key)) {
+      cache->stats.coalesced++;
+      simple_mtx_unlock(&cache->put_mutex);
+      return;
+   }
+   if (cache->stats.pending_size + size > MAX_PENDING_PUT_SIZE) {
+      cache->stats.dropped++;
+      simple_mtx_unlock(&cache->put_mutex);
+      return;
+   }
+   simple_mtx_unlock(&cache->put_mutex);
+
    struct disk_cache_put_job *dc_job =
       create_put_job(cache, key, data, size, cache_item_metadata);
+   if (!dc_job)
+      return;
 
-   if (dc_job) {
-      util_queue_fence_init(&dc_job->fence);
-      util_queue_add_job(&cache->cache_queue, dc_job, &dc_job->fence,
-                         cache_put, destroy_put_job);
+   simple_mtx_lock(&cache->put_mutex);
+   /* Someone might have raced us between the two locks. */
+   if (_mesa_set_search(cache->keys_in_flight, key)) {
+      cache->stats.coalesced++;
+      simple_mtx_unlock(&cache->put_mutex);
+      destroy_put_job(dc_job, 0);
+      return;
+   }
+
+   /* Only the first put of a batch needs a queue job, the others are
+    * picked up by it.
+    */
+   queue_batch = list_empty(&cache->pending_puts);
+   list_addtail(&dc_job->link, &cache->pending_puts);
+   _mesa_set_add(cache->keys_in_flight, dc_job->key);
+   cache->stats.pending_size += size;
+   cache->stats.max_pending_size = MAX2(cache->stats.max_pending_size,
+                                        cache->stats.pending_size);
+
+   if (queue_batch) {
+      batch_job = malloc(sizeof(*batch_job));
+      if (!batch_job) {
+         /* Nothing would ever write out the list if we left it there. */
+         list_del(&dc_job->link);
+         _mesa_set_remove_key(cache->keys_in_flight, dc_job->key);
+         cache->stats.pending_size -= size;
+         cache->stats.dropped++;
+         simple_mtx_unlock(&cache->put_mutex);
+         destroy_put_job(dc_job, 0);
+         return;
+      }
+
+      batch_job->cache = cache;
+      util_queue_fence_init(&batch_job->fence);
+      util_queue_add_job(&cache->cache_queue, batch_job, &batch_job->fence,
+                         cache_put_batch, destroy_batch_job);
    }
+   simple_mtx_unlock(&cache->put_mutex);
+}
+
+void
+disk_cache_get_stats(struct disk_cache *cache, struct disk_cache_stats *stats)
+{
+   simple_mtx_lock(&cache->put_mutex);
+   *stats = cache->stats;
+   simple_mtx_unlock(&cache->put_mutex);
 }
 
 /**
@@ -1075,15 +1885,203 @@ inflate_cache_data(uint8_t *in_data, size_t in_data_size,
    return true;
 }
 
-void *
-disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
+/**
+ * Decompresses cache entry written by either codec, returns true if
+ * successful.
+ */
+static bool
+decompress_cache_data(struct disk_cache *cache,
+                      uint8_t *in_data, size_t in_data_size,
+                      uint8_t *out_data, size_t out_data_size)
+{
+   /* ZSTD_MAGICNUMBER, as stored in the frame header */
+   static const uint8_t zstd_magic[4] = { 0x28, 0xb5, 0x2f, 0xfd };
+   int64_t start = os_time_get_nano();
+   bool ret;
+
+   if (in_data_size >= sizeof(zstd_magic) &&
+       memcmp(in_data, zstd_magic, sizeof(zstd_magic)) == 0) {
+#ifdef HAVE_ZSTD
+      ZSTD_DCtx *dctx = ZSTD_createDCtx();
+      size_t size;
+
+      if (dctx == NULL)
+         return false;
+
+      /* A frame compressed with a dictionary we don't have fails here,
+       * which is just a cache miss.
+       */
+      if (cache->zstd_ddict) {
+         size = ZSTD_decompress_usingDDict(dctx, out_data, out_data_size,
+                                           in_data, in_data_size,
+                                           cache->zstd_ddict);
+      } else {
+         size = ZSTD_decompressDCtx(dctx, out_data, out_data_size,
+                                    in_data, in_data_size);
+      }
+      ZSTD_freeDCtx(dctx);
+
+      ret = !ZSTD_isError(size) && size == out_data_size;
+#else
+      ret = false;
+#endif
+   } else {
+      ret = inflate_cache_data(in_data, in_data_size,
+                               out_data, out_data_size);
+   }
+
+   if (ret) {
+      p_atomic_inc(&cache->stats.decoded);
+      p_atomic_add(&cache->stats.decoded_compressed_size,
+                   (uint64_t)in_data_size);
+      p_atomic_add(&cache->stats.decoded_size, (uint64_t)out_data_size);
+      p_atomic_add(&cache->stats.decode_time_ns,
+                   (uint64_t)(os_time_get_nano() - start));
+   }
+
+   return ret;
+}
+
+/**
+ * Checks and decompresses a cache entry, as written by write_cache_entry().
+ * Returns the malloc'ed uncompressed data, or NULL if the entry is corrupt.
+ */
+static void *
+parse_cache_entry(struct disk_cache *cache, const uint8_t *entry,
+                  size_t entry_size, size_t *size)
+{
+   const uint8_t *p = entry;
+   uint8_t *uncompressed_data;
+
+   size_t ck_size = cache->driver_keys_blob_size;
+   if (entry_size < ck_size + sizeof(uint32_t))
+      return NULL;
+
+   /* Check for extremely unlikely hash collisions */
+   if (memcmp(cache->driver_keys_blob, p, ck_size) != 0) {
+      assert(!"Mesa cache keys mismatch!");
+      return NULL;
+   }
+   p += ck_size;
+
+   uint32_t md_type;
+   memcpy(&md_type, p, sizeof(uint32_t));
+   p += sizeof(uint32_t);
+
+   if (md_type == CACHE_ITEM_TYPE_GLSL) {
+      uint32_t num_keys;
+      if (entry + entry_size - p < sizeof(uint32_t))
+         return NULL;
+      memcpy(&num_keys, p, sizeof(uint32_t));
+      p += sizeof(uint32_t);
+
+      /* The cache item metadata is currently just used for distributing
+       * precompiled shaders, they are not used by Mesa so just skip them for
+       * now.
+       * TODO: pass the metadata back to the caller and do some basic
+       * validation.
+       */
+      if (entry + entry_size - p < (size_t) num_keys * sizeof(cache_key))
+         return NULL;
+      p += num_keys * sizeof(cache_key);
+   }
+
+   /* Load the CRC that was created when the file was written. */
+   struct cache_entry_file_data cf_data;
+   if (entry + entry_size - p < sizeof(cf_data))
+      return NULL;
+   memcpy(&cf_data, p, sizeof(cf_data));
+   p += sizeof(cf_data);
+
+   /* Uncompress the cache data */
+   uncompressed_data = malloc(cf_data.uncompressed_size);
+   if (!uncompressed_data)
+      return NULL;
+
+   if (!decompress_cache_data(cache, (uint8_t *) p, entry + entry_size - p,
+                              uncompressed_data, cf_data.uncompressed_size)) {
+      free(uncompressed_data);
+      return NULL;
+   }
+
+   /* Check the data for corruption */
+   if (cf_data.crc32 != util_hash_crc32(uncompressed_data,
+                                        cf_data.uncompressed_size)) {
+      free(uncompressed_data);
+      return NULL;
+   }
+
+   if (size)
+      *size = cf_data.uncompressed_size;
+
+   return uncompressed_data;
+}
+
+static void *
+packed_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
+{
+   struct packed_index_entry *slot = packed_find_entry(cache, key);
+   struct packed_index_entry entry;
+   struct packed_entry_header *entry_header;
+   uint8_t *data;
+   void *result = NULL;
+   ssize_t ret = -1;
+
+   if (slot == NULL)
+      return NULL;
+
+   /* Copy the entry, a writer might be updating the slot. */
+   entry = *slot;
+   if (entry.size <= sizeof(*entry_header))
+      return NULL;
+
+   data = malloc(entry.size);
+   if (data == NULL)
+      return NULL;
+
+   /* Data files are append-only and replaced by compaction, so keeping
+    * the last one open is fine.
+    */
+   simple_mtx_lock(&cache->packed_data_mutex);
+   if (cache->packed_data_fd == -1 ||
+       cache->packed_data_generation != entry.generation) {
+      char *filename = packed_data_path(cache, entry.generation);
+
+      if (cache->packed_data_fd != -1)
+         close(cache->packed_data_fd);
+      cache->packed_data_fd = filename ?
+         open(filename, O_RDONLY | O_CLOEXEC) : -1;
+      cache->packed_data_generation = entry.generation;
+      free(filename);
+   }
+   if (cache->packed_data_fd != -1)
+      ret = pread(cache->packed_data_fd, data, entry.size, entry.offset);
+   simple_mtx_unlock(&cache->packed_data_mutex);
+
+   if (ret != entry.size)
+      goto done;
+
+   entry_header = (struct packed_entry_header *) data;
+   if (memcmp(entry_header->key, key, CACHE_KEY_SIZE) != 0 ||
+       entry_header->size != entry.size - sizeof(*entry_header))
+      goto done;
+
+   result = parse_cache_entry(cache, data + sizeof(*entry_header),
+                              entry_header->size, size);
+
+ done:
+   free(data);
+   return result;
+}
+
+static void *
+cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
 {
    int fd = -1, ret;
    struct stat sb;
    char *filename = NULL;
    uint8_t *data = NULL;
    uint8_t *uncompressed_data = NULL;
-   uint8_t *file_header = NULL;
 
    if (size)
       *size = 0;
@@ -1110,112 +2108,52 @@ disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
       return blob;
    }
 
+   if (cache->packed)
+      return packed_cache_get(cache, key, size);
+
    filename = get_cache_file(cache, key);
    if (filename == NULL)
-      goto fail;
+      goto done;
 
    fd = open(filename, O_RDONLY | O_CLOEXEC);
    if (fd == -1)
-      goto fail;
+      goto done;
 
    if (fstat(fd, &sb) == -1)
-      goto fail;
+      goto done;
 
    data = malloc(sb.st_size);
    if (data == NULL)
-      goto fail;
-
-   size_t ck_size = cache->driver_keys_blob_size;
-   file_header = malloc(ck_size);
-   if (!file_header)
-      goto fail;
-
-   if (sb.st_size < ck_size)
-      goto fail;
-
-   ret = read_all(fd, file_header, ck_size);
-   if (ret == -1)
-      goto fail;
-
-   /* Check for extremely unlikely hash collisions */
-   if (memcmp(cache->driver_keys_blob, file_header, ck_size) != 0) {
-      assert(!"Mesa cache keys mismatch!");
-      goto fail;
-   }
-
-   size_t cache_item_md_size = sizeof(uint32_t);
-   uint32_t md_type;
-   ret = read_all(fd, &md_type, cache_item_md_size);
-   if (ret == -1)
-      goto fail;
-
-   if (md_type == CACHE_ITEM_TYPE_GLSL) {
-      uint32_t num_keys;
-      cache_item_md_size += sizeof(uint32_t);
-      ret = read_all(fd, &num_keys, sizeof(uint32_t));
-      if (ret == -1)
-         goto fail;
-
-      /* The cache item metadata is currently just used for distributing
-       * precompiled shaders, they are not used by Mesa so just skip them for
-       * now.
-       * TODO: pass the metadata back to the caller and do some basic
-       * validation.
-       */
-      cache_item_md_size += num_keys * sizeof(cache_key);
-      ret = lseek(fd, num_keys * sizeof(cache_key), SEEK_CUR);
-      if (ret == -1)
-         goto fail;
-   }
-
-   /* Load the CRC that was created when the file was written. */
-   struct cache_entry_file_data cf_data;
-   size_t cf_data_size = sizeof(cf_data);
-   ret = read_all(fd, &cf_data, cf_data_size);
-   if (ret == -1)
-      goto fail;
+      goto done;
 
-   /* Load the actual cache data. */
-   size_t cache_data_size =
-      sb.st_size - cf_data_size - ck_size - cache_item_md_size;
-   ret = read_all(fd, data, cache_data_size);
+   ret = read_all(fd, data, sb.st_size);
    if (ret == -1)
-      goto fail;
-
-   /* Uncompress the cache data */
-   uncompressed_data = malloc(cf_data.uncompressed_size);
-   if (!inflate_cache_data(data, cache_data_size, uncompressed_data,
-                           cf_data.uncompressed_size))
-      goto fail;
-
-   /* Check the data for corruption */
-   if (cf_data.crc32 != util_hash_crc32(uncompressed_data,
-                                        cf_data.uncompressed_size))
-      goto fail;
-
-   free(data);
-   free(filename);
-   free(file_header);
-   close(fd);
-
-   if (size)
-      *size = cf_data.uncompressed_size;
+      goto done;
 
-   return uncompressed_data;
+   uncompressed_data = parse_cache_entry(cache, data, sb.st_size, size);
 
- fail:
+ done:
    if (data)
       free(data);
-   if (uncompressed_data)
-      free(uncompressed_data);
    if (filename)
       free(filename);
-   if (file_header)
-      free(file_header);
    if (fd != -1)
       close(fd);
 
-   return NULL;
+   return uncompressed_data;
+}
+
+void *
+disk_cache_get(struct disk_cache *cache, const cache_key key, size_t *size)
+{
+   void *data = cache_get(cache, key, size);
+
+   if (data)
+      p_atomic_inc(&cache->stats.hits);
+   else
+      p_atomic_inc(&cache->stats.misses);
+
+   return data;
 }
 
 void
@@ -24,15 +24,15 @@
 #ifndef DISK_CACHE_H
 #define DISK_CACHE_H
 
+#include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/stat.h>
 #ifdef HAVE_DLFCN_H
 #include <dlfcn.h>
 #include <stdio.h>
 #include "util/build_id.h"
 #endif
-#include <assert.h>
-#include <stdint.h>
-#include <stdbool.h>
-#include <sys/stat.h>
 #include "util/mesa-sha1.h"
 
 #ifdef __cplusplus
@@ -74,6 +74,46 @@ struct cache_item_metadata {
    uint32_t num_keys;
 };
 
+/**
+ * Counters of the write and read paths, see disk_cache_get_stats().
+ */
+struct disk_cache_stats {
+   /** Number of disk_cache_get() calls that found or missed the entry. */
+   uint64_t hits;
+   uint64_t misses;
+
+   /** Number of disk_cache_put() calls. */
+   uint64_t puts;
+
+   /** Puts dropped because the same key was still waiting to be written. */
+   uint64_t coalesced;
+
+   /** Puts dropped because too much data was waiting to be written. */
+   uint64_t dropped;
+
+   /** Number of batches written, and puts written by them. */
+   uint64_t batches;
+   uint64_t written;
+
+   /** Compressed and uncompressed bytes of the entries written. */
+   uint64_t written_compressed_size;
+   uint64_t written_size;
+
+   /**
+    * Entries decompressed by disk_cache_get(), their compressed and
+    * uncompressed bytes, and the time spent decompressing them in
+    * nanoseconds.
+    */
+   uint64_t decoded;
+   uint64_t decoded_compressed_size;
+   uint64_t decoded_size;
+   uint64_t decode_time_ns;
+
+   /** Bytes currently waiting to be written, and the maximum ever seen. */
+   uint64_t pending_size;
+   uint64_t max_pending_size;
+};
+
 struct disk_cache;
 
 static inline char *
@@ -246,6 +286,15 @@ void
 disk_cache_set_callbacks(struct disk_cache *cache, disk_cache_put_cb put,
                          disk_cache_get_cb get);
 
+/**
+ * Retrieve the write and read path counters of \cache.
+ *
+ * A steadily growing \c dropped count means the cache can't keep up with
+ * the rate of disk_cache_put() calls.
+ */
+void
+disk_cache_get_stats(struct disk_cache *cache, struct disk_cache_stats *stats);
+
 #else
 
 static inline struct disk_cache *
@@ -306,6 +355,13 @@ disk_cache_set_callbacks(struct disk_cache *cache, disk_cache_put_cb put,
    return;
 }
 
+static inline void
+disk_cache_get_stats(struct disk_cache *cache, struct disk_cache_stats *stats)
+{
+   struct disk_cache_stats zero = { 0 };
+   *stats = zero;
+}
+
 #endif /* ENABLE_SHADER_CACHE */
 
 #ifdef __cplusplus
@@ -0,0 +1,167 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/**
+ * Control byte helpers shared by hash_table.c and set.c.
+ *
+ * Next to its entry array, each table keeps one control byte per slot:
+ * HASH_CTRL_EMPTY, HASH_CTRL_DELETED, or the top 7 bits of the hash of the
+ * key stored in that slot.  Lookups compare a whole group of
+ * HASH_GROUP_WIDTH control bytes against the tag at once and only touch the
+ * entries whose tag matches, so a probe costs one 16-byte load instead of
+ * one cache miss per slot visited.
+ *
+ * Table sizes are powers of two.  Groups start at any slot and wrap around
+ * the end of the table, which is made possible by mirroring the first
+ * HASH_GROUP_WIDTH - 1 control bytes past the end of the control array.
+ * Tables smaller than a group mirror themselves several times over.
+ */
+
+#ifndef _HASH_GROUP_H
+#define _HASH_GROUP_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bitscan.h"
+#include "macros.h"
+#include "ralloc.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define HASH_GROUP_WIDTH 16
+
+#define HASH_CTRL_EMPTY   0x80
+#define HASH_CTRL_DELETED 0xfe
+
+/* Smallest table: 4 slots, 3 of which may be used */
+#define HASH_MIN_SIZE_LOG2 2
+#define HASH_MAX_SIZE_INDEX (31 - HASH_MIN_SIZE_LOG2)
+
+static inline uint32_t
+hash_size_for_index(uint32_t size_index)
+{
+   return 1u << (size_index + HASH_MIN_SIZE_LOG2);
+}
+
+/* Keep at least one eighth of the table, and always at least one slot,
+ * empty so that every probe sequence is guaranteed to terminate.
+ */
+static inline uint32_t
+hash_max_entries_for_size(uint32_t size)
+{
+   return size - MAX2(size / 8, 1);
+}
+
+static inline uint8_t
+hash_ctrl_tag(uint32_t hash)
+{
+   return hash >> 25;
+}
+
+static inline uint8_t *
+hash_ctrl_alloc(void *mem_ctx, uint32_t size)
+{
+   uint8_t *ctrl = ralloc_array(mem_ctx, uint8_t,
+                                size + HASH_GROUP_WIDTH - 1);
+   if (ctrl)
+      memset(ctrl, HASH_CTRL_EMPTY, size + HASH_GROUP_WIDTH - 1);
+   return ctrl;
+}
+
+static inline void
+hash_ctrl_set(uint8_t *ctrl, uint32_t size, uint32_t i, uint8_t value)
+{
+   ctrl[i] = value;
+   for (uint32_t j = i + size; j < size + HASH_GROUP_WIDTH - 1; j += size)
+      ctrl[j] = value;
+}
+
+/* Bitmask of the group's slots whose control byte is equal to value */
+static inline unsigned
+hash_group_match(const uint8_t *group, uint8_t value)
+{
+#ifdef __SSE2__
+   __m128i g = _mm_loadu_si128((const __m128i *)group);
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)value)));
+#else
+   unsigned mask = 0;
+   for (unsigned i = 0; i < HASH_GROUP_WIDTH; i++) {
+      if (group[i] == value)
+         mask |= 1u << i;
+   }
+   return mask;
+#endif
+}
+
+/* Bitmask of the group's empty or deleted slots */
+static inline unsigned
+hash_group_match_available(const uint8_t *group)
+{
+#ifdef __SSE2__
+   return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+   unsigned mask = 0;
+   for (unsigned i = 0; i < HASH_GROUP_WIDTH; i++) {
+      if (group[i] & 0x80)
+         mask |= 1u << i;
+   }
+   return mask;
+#endif
+}
+
+/**
+ * Triangular probing over groups.  With a power-of-two table size, this
+ * visits every group start modulo the number of groups exactly once in the
+ * first size / HASH_GROUP_WIDTH steps.
+ */
+struct hash_probe {
+   uint32_t pos;
+   uint32_t stride;
+   uint32_t mask;
+};
+
+static inline void
+hash_probe_init(struct hash_probe *probe, uint32_t hash, uint32_t size)
+{
+   probe->mask = size - 1;
+   probe->pos = hash & probe->mask;
+   probe->stride = 0;
+}
+
+static inline void
+hash_probe_next(struct hash_probe *probe)
+{
+   probe->stride += HASH_GROUP_WIDTH;
+   probe->pos = (probe->pos + probe->stride) & probe->mask;
+}
+
+static inline uint32_t
+hash_probe_slot(const struct hash_probe *probe, unsigned bit)
+{
+   return (probe->pos + bit) & probe->mask;
+}
+
+#endif /* _HASH_GROUP_H */
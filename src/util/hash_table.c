@@ -45,65 +45,13 @@
 #include <assert.h>
 
 #include "hash_table.h"
+#include "hash_group.h"
 #include "ralloc.h"
 #include "macros.h"
 #include "main/hash.h"
 
 static const uint32_t deleted_key_value;
 
-/**
- * From Knuth -- a good choice for hash/rehash values is p, p-2 where
- * p and p-2 are both prime.  These tables are sized to have an extra 10%
- * free to avoid exponential performance degradation as the hash table fills
- */
-static const struct {
-   uint32_t max_entries, size, rehash;
-} hash_sizes[] = {
-   { 2,			5,		3	  },
-   { 4,			7,		5	  },
-   { 8,			13,		11	  },
-   { 16,		19,		17	  },
-   { 32,		43,		41        },
-   { 64,		73,		71        },
-   { 128,		151,		149       },
-   { 256,		283,		281       },
-   { 512,		571,		569       },
-   { 1024,		1153,		1151      },
-   { 2048,		2269,		2267      },
-   { 4096,		4519,		4517      },
-   { 8192,		9013,		9011      },
-   { 16384,		18043,		18041     },
-   { 32768,		36109,		36107     },
-   { 65536,		72091,		72089     },
-   { 131072,		144409,		144407    },
-   { 262144,		288361,		288359    },
-   { 524288,		576883,		576881    },
-   { 1048576,		1153459,	1153457   },
-   { 2097152,		2307163,	2307161   },
-   { 4194304,		4613893,	4613891   },
-   { 8388608,		9227641,	9227639   },
-   { 16777216,		18455029,	18455027  },
-   { 33554432,		36911011,	36911009  },
-   { 67108864,		73819861,	73819859  },
-   { 134217728,		147639589,	147639587 },
-   { 268435456,		295279081,	295279079 },
-   { 536870912,		590559793,	590559791 },
-   { 1073741824,	1181116273,	1181116271},
-   { 2147483648ul,	2362232233ul,	2362232231ul}
-};
-
-static int
-entry_is_free(const struct hash_entry *entry)
-{
-   return entry->key == NULL;
-}
-
-static int
-entry_is_deleted(const struct hash_table *ht, struct hash_entry *entry)
-{
-   return entry->key == ht->deleted_key;
-}
-
 static int
 entry_is_present(const struct hash_table *ht, struct hash_entry *entry)
 {
@@ -118,17 +66,17 @@ _mesa_hash_table_init(struct hash_table *ht,
                                                   const void *b))
 {
    ht->size_index = 0;
-   ht->size = hash_sizes[ht->size_index].size;
-   ht->rehash = hash_sizes[ht->size_index].rehash;
-   ht->max_entries = hash_sizes[ht->size_index].max_entries;
+   ht->size = hash_size_for_index(ht->size_index);
+   ht->max_entries = hash_max_entries_for_size(ht->size);
    ht->key_hash_function = key_hash_function;
    ht->key_equals_function = key_equals_function;
    ht->table = rzalloc_array(mem_ctx, struct hash_entry, ht->size);
+   ht->ctrl = hash_ctrl_alloc(mem_ctx, ht->size);
    ht->entries = 0;
    ht->deleted_entries = 0;
    ht->deleted_key = &deleted_key_value;
 
-   return ht->table != NULL;
+   return ht->table != NULL && ht->ctrl != NULL;
 }
 
 struct hash_table *
@@ -173,6 +121,14 @@ _mesa_hash_table_clone(struct hash_table *src, void *dst_mem_ctx)
 
    memcpy(ht->table, src->table, ht->size * sizeof(struct hash_entry));
 
+   ht->ctrl = ralloc_array(ht, uint8_t, ht->size + HASH_GROUP_WIDTH - 1);
+   if (ht->ctrl == NULL) {
+      ralloc_free(ht);
+      return NULL;
+   }
+
+   memcpy(ht->ctrl, src->ctrl, ht->size + HASH_GROUP_WIDTH - 1);
+
    return ht;
 }
 
@@ -219,6 +175,8 @@ _mesa_hash_table_clear(struct hash_table *ht,
       entry->key = NULL;
    }
 
+   memset(ht->ctrl, HASH_CTRL_EMPTY, ht->size + HASH_GROUP_WIDTH - 1);
+
    ht->entries = 0;
    ht->deleted_entries = 0;
 }
@@ -242,26 +200,27 @@ _mesa_hash_table_set_deleted_key(struct hash_table *ht, const void *deleted_key)
 static struct hash_entry *
 hash_table_search(struct hash_table *ht, uint32_t hash, const void *key)
 {
-   uint32_t start_hash_address = hash % ht->size;
-   uint32_t hash_address = start_hash_address;
+   const uint8_t tag = hash_ctrl_tag(hash);
+   struct hash_probe probe;
 
-   do {
-      uint32_t double_hash;
+   hash_probe_init(&probe, hash, ht->size);
+   for (uint32_t i = 0; i < ht->size; i += HASH_GROUP_WIDTH) {
+      const uint8_t *group = ht->ctrl + probe.pos;
 
-      struct hash_entry *entry = ht->table + hash_address;
+      unsigned match = hash_group_match(group, tag);
+      while (match) {
+         struct hash_entry *entry =
+            ht->table + hash_probe_slot(&probe, u_bit_scan(&match));
 
-      if (entry_is_free(entry)) {
-         return NULL;
-      } else if (entry_is_present(ht, entry) && entry->hash == hash) {
-         if (ht->key_equals_function(key, entry->key)) {
+         if (entry->hash == hash && ht->key_equals_function(key, entry->key))
             return entry;
-         }
       }
 
-      double_hash = 1 + hash % ht->rehash;
+      if (hash_group_match(group, HASH_CTRL_EMPTY))
+         return NULL;
 
-      hash_address = (hash_address + double_hash) % ht->size;
-   } while (hash_address != start_hash_address);
+      hash_probe_next(&probe);
+   }
 
    return NULL;
 }
@@ -296,22 +255,31 @@ _mesa_hash_table_rehash(struct hash_table *ht, unsigned new_size_index)
 {
    struct hash_table old_ht;
    struct hash_entry *table;
+   uint8_t *ctrl;
 
-   if (new_size_index >= ARRAY_SIZE(hash_sizes))
+   if (new_size_index > HASH_MAX_SIZE_INDEX)
       return;
 
-   table = rzalloc_array(ralloc_parent(ht->table), struct hash_entry,
-                         hash_sizes[new_size_index].size);
+   void *mem_ctx = ralloc_parent(ht->table);
+   uint32_t size = hash_size_for_index(new_size_index);
+
+   table = rzalloc_array(mem_ctx, struct hash_entry, size);
    if (table == NULL)
       return;
 
+   ctrl = hash_ctrl_alloc(mem_ctx, size);
+   if (ctrl == NULL) {
+      ralloc_free(table);
+      return;
+   }
+
    old_ht = *ht;
 
    ht->table = table;
+   ht->ctrl = ctrl;
    ht->size_index = new_size_index;
-   ht->size = hash_sizes[ht->size_index].size;
-   ht->rehash = hash_sizes[ht->size_index].rehash;
-   ht->max_entries = hash_sizes[ht->size_index].max_entries;
+   ht->size = size;
+   ht->max_entries = hash_max_entries_for_size(size);
    ht->entries = 0;
    ht->deleted_entries = 0;
 
@@ -320,13 +288,13 @@ _mesa_hash_table_rehash(struct hash_table *ht, unsigned new_size_index)
    }
 
    ralloc_free(old_ht.table);
+   ralloc_free(old_ht.ctrl);
 }
 
 static struct hash_entry *
 hash_table_insert(struct hash_table *ht, uint32_t hash,
                   const void *key, void *data)
 {
-   uint32_t start_hash_address, hash_address;
    struct hash_entry *available_entry = NULL;
 
    assert(key != NULL);
@@ -337,19 +305,12 @@ hash_table_insert(struct hash_table *ht, uint32_t hash,
       _mesa_hash_table_rehash(ht, ht->size_index);
    }
 
-   start_hash_address = hash % ht->size;
-   hash_address = start_hash_address;
-   do {
-      struct hash_entry *entry = ht->table + hash_address;
-      uint32_t double_hash;
-
-      if (!entry_is_present(ht, entry)) {
-         /* Stash the first available entry we find */
-         if (available_entry == NULL)
-            available_entry = entry;
-         if (entry_is_free(entry))
-            break;
-      }
+   const uint8_t tag = hash_ctrl_tag(hash);
+   struct hash_probe probe;
+
+   hash_probe_init(&probe, hash, ht->size);
+   for (uint32_t i = 0; i < ht->size; i += HASH_GROUP_WIDTH) {
+      const uint8_t *group = ht->ctrl + probe.pos;
 
       /* Implement replacement when another insert happens
        * with a matching key.  This is a relatively common
@@ -362,23 +323,38 @@ hash_table_insert(struct hash_table *ht, uint32_t hash,
        * required to avoid memory leaks, perform a search
        * before inserting.
        */
-      if (!entry_is_deleted(ht, entry) &&
-          entry->hash == hash &&
-          ht->key_equals_function(key, entry->key)) {
-         entry->key = key;
-         entry->data = data;
-         return entry;
+      unsigned match = hash_group_match(group, tag);
+      while (match) {
+         struct hash_entry *entry =
+            ht->table + hash_probe_slot(&probe, u_bit_scan(&match));
+
+         if (entry->hash == hash && ht->key_equals_function(key, entry->key)) {
+            entry->key = key;
+            entry->data = data;
+            return entry;
+         }
       }
 
+      /* Stash the first available entry we find */
+      if (available_entry == NULL) {
+         unsigned available = hash_group_match_available(group);
+         if (available) {
+            available_entry =
+               ht->table + hash_probe_slot(&probe, ffs(available) - 1);
+         }
+      }
 
-      double_hash = 1 + hash % ht->rehash;
+      if (hash_group_match(group, HASH_CTRL_EMPTY))
+         break;
 
-      hash_address = (hash_address + double_hash) % ht->size;
-   } while (hash_address != start_hash_address);
+      hash_probe_next(&probe);
+   }
 
    if (available_entry) {
-      if (entry_is_deleted(ht, available_entry))
+      uint32_t slot = available_entry - ht->table;
+      if (ht->ctrl[slot] == HASH_CTRL_DELETED)
          ht->deleted_entries--;
+      hash_ctrl_set(ht->ctrl, ht->size, slot, tag);
       available_entry->hash = hash;
       available_entry->key = key;
       available_entry->data = data;
@@ -426,6 +402,7 @@ _mesa_hash_table_remove(struct hash_table *ht,
    if (!entry)
       return;
 
+   hash_ctrl_set(ht->ctrl, ht->size, entry - ht->table, HASH_CTRL_DELETED);
    entry->key = ht->deleted_key;
    ht->entries--;
    ht->deleted_entries++;
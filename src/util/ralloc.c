@@ -24,6 +24,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdint.h>
@@ -35,6 +36,8 @@ _CRTIMP int _vscprintf(const char *format, va_list argptr);
 #endif
 
 #include "ralloc.h"
+#include "simple_mtx.h"
+#include "u_atomic.h"
 
 #ifndef va_copy
 #ifdef __va_copy
@@ -76,6 +79,12 @@ struct
    struct ralloc_header *next;
 
    void (*destructor)(void *);
+
+   /* The pool that children of this block are allocated from, if any (see
+    * ralloc_pool_size), with the size class of the block itself in the low
+    * bits if the block was allocated from that pool.
+    */
+   uintptr_t pool;
 };
 
 typedef struct ralloc_header ralloc_header;
@@ -83,6 +92,143 @@ typedef struct ralloc_header ralloc_header;
 static void unlink_block(ralloc_header *info);
 static void unsafe_free(ralloc_header *info);
 
+/* Pools hand out blocks in multiples of POOL_CLASS_SIZE bytes, up to
+ * POOL_NUM_CLASSES - 1 of them. Bigger blocks are allocated with malloc.
+ * Pools are aligned to POOL_NUM_CLASSES so that the size class of a block
+ * fits in the low bits of ralloc_header::pool.
+ */
+#define POOL_CLASS_SIZE 16
+#define POOL_NUM_CLASSES 64
+#define POOL_CHUNK_SIZE (64 * 1024)
+
+struct ralloc_pool {
+   /* Number of blocks that point to the pool. */
+   unsigned refcount;
+
+   /* Protects the free lists and chunks, so that trees allocated from the
+    * same pool can be used by different threads, as long as each tree is
+    * only used by one thread at a time.
+    */
+   simple_mtx_t mutex;
+
+   /* Freed blocks of each size class, linked through their first bytes. */
+   void *free_list[POOL_NUM_CLASSES];
+
+   /* Chunks are linked through their first bytes, blocks are cut from the
+    * end of the current one.
+    */
+   void *chunks;
+   char *next, *end;
+
+   void *allocation;
+};
+
+static struct ralloc_pool *
+header_pool(const ralloc_header *info)
+{
+   return (struct ralloc_pool *) (info->pool & ~(uintptr_t)(POOL_NUM_CLASSES - 1));
+}
+
+static unsigned
+header_class(const ralloc_header *info)
+{
+   return info->pool & (POOL_NUM_CLASSES - 1);
+}
+
+/* Allocate a block of \p size bytes from \p pool, or with malloc if it's too
+ * big. The size class of the block, or 0 for malloc, is returned in
+ * \p size_class.
+ */
+static void *
+pool_alloc_block(struct ralloc_pool *pool, size_t size, unsigned *size_class)
+{
+   unsigned class = (size + POOL_CLASS_SIZE - 1) / POOL_CLASS_SIZE;
+
+   if (class >= POOL_NUM_CLASSES) {
+      *size_class = 0;
+      return malloc(size);
+   }
+
+   /* ralloc_header is never smaller than a pointer. */
+   assert(class > 0);
+   *size_class = class;
+
+   simple_mtx_lock(&pool->mutex);
+
+   void *block = pool->free_list[class];
+   if (block) {
+      pool->free_list[class] = *(void **) block;
+      simple_mtx_unlock(&pool->mutex);
+      return block;
+   }
+
+   size_t class_size = class * POOL_CLASS_SIZE;
+   if (pool->end - pool->next < (ptrdiff_t) class_size) {
+      char *chunk = malloc(POOL_CHUNK_SIZE);
+      if (unlikely(chunk == NULL)) {
+         simple_mtx_unlock(&pool->mutex);
+         return NULL;
+      }
+
+      *(void **) chunk = pool->chunks;
+      pool->chunks = chunk;
+      /* Keep the blocks aligned like the ralloc_header. */
+      pool->next = chunk + sizeof(ralloc_header);
+      pool->end = chunk + POOL_CHUNK_SIZE;
+   }
+
+   block = pool->next;
+   pool->next += class_size;
+   simple_mtx_unlock(&pool->mutex);
+   return block;
+}
+
+static void
+pool_free_block(struct ralloc_pool *pool, void *block, unsigned size_class)
+{
+   if (size_class == 0) {
+      free(block);
+      return;
+   }
+
+   simple_mtx_lock(&pool->mutex);
+   *(void **) block = pool->free_list[size_class];
+   pool->free_list[size_class] = block;
+   simple_mtx_unlock(&pool->mutex);
+}
+
+static void
+pool_unref(struct ralloc_pool *pool)
+{
+   assert(pool->refcount > 0);
+   if (!p_atomic_dec_zero(&pool->refcount))
+      return;
+
+   simple_mtx_destroy(&pool->mutex);
+   while (pool->chunks) {
+      void *chunk = pool->chunks;
+      pool->chunks = *(void **) chunk;
+      free(chunk);
+   }
+   free(pool->allocation);
+}
+
+static struct ralloc_pool *
+pool_create(void)
+{
+   void *allocation = calloc(1, sizeof(struct ralloc_pool) + POOL_NUM_CLASSES);
+   if (unlikely(allocation == NULL))
+      return NULL;
+
+   uintptr_t aligned = ((uintptr_t) allocation + POOL_NUM_CLASSES - 1) &
+                       ~(uintptr_t)(POOL_NUM_CLASSES - 1);
+   struct ralloc_pool *pool = (struct ralloc_pool *) aligned;
+
+   pool->allocation = allocation;
+   simple_mtx_init(&pool->mutex, mtx_plain);
+   return pool;
+}
+
 static ralloc_header *
 get_header(const void *ptr)
 {
@@ -113,12 +259,17 @@ ralloc_context(const void *ctx)
    return ralloc_size(ctx, 0);
 }
 
-void *
-ralloc_size(const void *ctx, size_t size)
+static void *
+alloc_block(ralloc_header *parent, struct ralloc_pool *pool, size_t size)
 {
-   void *block = malloc(size + sizeof(ralloc_header));
    ralloc_header *info;
-   ralloc_header *parent;
+   unsigned size_class = 0;
+   void *block;
+
+   if (pool)
+      block = pool_alloc_block(pool, size + sizeof(ralloc_header), &size_class);
+   else
+      block = malloc(size + sizeof(ralloc_header));
 
    if (unlikely(block == NULL))
       return NULL;
@@ -133,8 +284,10 @@ ralloc_size(const void *ctx, size_t size)
    info->prev = NULL;
    info->next = NULL;
    info->destructor = NULL;
+   info->pool = (uintptr_t) pool | size_class;
 
-   parent = ctx != NULL ? get_header(ctx) : NULL;
+   if (pool)
+      p_atomic_inc(&pool->refcount);
 
    add_child(parent, info);
 
@@ -145,6 +298,61 @@ ralloc_size(const void *ctx, size_t size)
    return PTR_FROM_HEADER(info);
 }
 
+void *
+ralloc_size(const void *ctx, size_t size)
+{
+   ralloc_header *parent = ctx != NULL ? get_header(ctx) : NULL;
+
+   return alloc_block(parent, parent ? header_pool(parent) : NULL, size);
+}
+
+void *
+ralloc_pool_size(const void *ctx, size_t size)
+{
+   struct ralloc_pool *pool = pool_create();
+   if (unlikely(pool == NULL))
+      return NULL;
+
+   /* The block itself is allocated with malloc and holds the first
+    * reference to the pool, which stays alive as long as any block
+    * allocated from it.
+    */
+   void *ptr = malloc(size + sizeof(ralloc_header));
+   if (unlikely(ptr == NULL)) {
+      simple_mtx_destroy(&pool->mutex);
+      free(pool->allocation);
+      return NULL;
+   }
+
+   ralloc_header *info = (ralloc_header *) ptr;
+   info->parent = NULL;
+   info->child = NULL;
+   info->prev = NULL;
+   info->next = NULL;
+   info->destructor = NULL;
+   info->pool = (uintptr_t) pool;
+   pool->refcount = 1;
+
+   add_child(ctx != NULL ? get_header(ctx) : NULL, info);
+
+#ifndef NDEBUG
+   info->canary = CANARY;
+#endif
+
+   return PTR_FROM_HEADER(info);
+}
+
+void *
+rzalloc_pool_size(const void *ctx, size_t size)
+{
+   void *ptr = ralloc_pool_size(ctx, size);
+
+   if (likely(ptr))
+      memset(ptr, 0, size);
+
+   return ptr;
+}
+
 void *
 rzalloc_size(const void *ctx, size_t size)
 {
@@ -163,7 +371,27 @@ resize(void *ptr, size_t size)
    ralloc_header *child, *old, *info;
 
    old = get_header(ptr);
-   info = realloc(old, size + sizeof(ralloc_header));
+
+   struct ralloc_pool *pool = header_pool(old);
+   unsigned old_class = header_class(old);
+
+   if (old_class) {
+      size_t old_size = old_class * POOL_CLASS_SIZE;
+      unsigned new_class;
+
+      if (size + sizeof(ralloc_header) <= old_size)
+         return ptr;
+
+      info = pool_alloc_block(pool, size + sizeof(ralloc_header), &new_class);
+      if (info == NULL)
+         return NULL;
+
+      memcpy(info, old, old_size);
+      info->pool = (uintptr_t) pool | new_class;
+      pool_free_block(pool, old, old_class);
+   } else {
+      info = realloc(old, size + sizeof(ralloc_header));
+   }
 
    if (info == NULL)
       return NULL;
@@ -271,7 +499,13 @@ unsafe_free(ralloc_header *info)
    if (info->destructor != NULL)
       info->destructor(PTR_FROM_HEADER(info));
 
-   free(info);
+   struct ralloc_pool *pool = header_pool(info);
+   if (pool) {
+      pool_free_block(pool, info, header_class(info));
+      pool_unref(pool);
+   } else {
+      free(info);
+   }
 }
 
 void
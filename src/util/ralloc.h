@@ -107,6 +107,35 @@ void *ralloc_size(const void *ctx, size_t size) MALLOCLIKE;
  */
 void *rzalloc_size(const void *ctx, size_t size) MALLOCLIKE;
 
+/**
+ * Allocate a new context, like ralloc_size, whose descendants are allocated
+ * from a memory pool instead of with malloc.
+ *
+ * Small blocks are cut from big chunks, and freed blocks are reused by the
+ * next allocations of the same size, so this is meant for contexts that
+ * own many small, short-lived allocations.  Everything else works as usual:
+ * descendants can be freed or stolen into other contexts.  The chunks are
+ * freed once the context and all blocks allocated from them are freed.
+ *
+ * The pool itself is thread-safe, but like any ralloc context each tree of
+ * allocations must only be used by one thread at a time.  Different threads
+ * can therefore work on different subtrees, after stealing them into
+ * contexts of their own.
+ */
+void *ralloc_pool_size(const void *ctx, size_t size) MALLOCLIKE;
+
+/**
+ * Allocate a zero-initialized pool context, see ralloc_pool_size.
+ */
+void *rzalloc_pool_size(const void *ctx, size_t size) MALLOCLIKE;
+
+/**
+ * \def rzalloc_pool(ctx, type)
+ * Allocate a new zero-initialized object whose descendants are allocated
+ * from a memory pool, see ralloc_pool_size.
+ */
+#define rzalloc_pool(ctx, type) ((type *) rzalloc_pool_size(ctx, sizeof(type)))
+
 /**
  * Resize a piece of ralloc-managed memory, preserving data.
  *
@@ -76,6 +76,7 @@
 #include "main/imports.h"
 #include "main/macros.h"
 #include "util/bitset.h"
+#include "util/bitscan.h"
 #include "register_allocate.h"
 
 #define NO_REG ~0U
@@ -174,6 +175,25 @@ struct ra_graph {
     */
    unsigned int stack_optimistic_start;
 
+   /**
+    * Scratch state of ra_simplify(), one bit or entry per node or per
+    * BITSET_WORD of nodes.
+    */
+   struct {
+      /** Nodes in the stack or with a fixed register. */
+      BITSET_WORD *done;
+
+      /** Nodes not done yet that pass pq_test(). */
+      BITSET_WORD *pq;
+
+      /**
+       * The lowest q_total of the nodes of each word that are not done, and
+       * the highest numbered node with it, or ~0 if all of them are.
+       */
+      unsigned int *min_q_total;
+      unsigned int *min_q_node;
+   } tmp;
+
    unsigned int (*select_reg_callback)(struct ra_graph *g, BITSET_WORD *regs,
                                        void *data);
    void *select_reg_callback_data;
@@ -426,9 +446,15 @@ ra_alloc_interference_graph(struct ra_regs *regs, unsigned int count)
 
    g->stack = rzalloc_array(g, unsigned int, count);
 
+   /* Keep the rows of the adjacency matrix in one allocation, rather than
+    * doing an allocation per node.
+    */
+   int bitset_count = BITSET_WORDS(count);
+   BITSET_WORD *adjacency =
+      rzalloc_array(g, BITSET_WORD, (size_t)count * bitset_count);
+
    for (i = 0; i < count; i++) {
-      int bitset_count = BITSET_WORDS(count);
-      g->nodes[i].adjacency = rzalloc_array(g, BITSET_WORD, bitset_count);
+      g->nodes[i].adjacency = adjacency + (size_t)i * bitset_count;
 
       g->nodes[i].adjacency_list_size = 4;
       g->nodes[i].adjacency_list =
@@ -477,6 +503,40 @@ pq_test(struct ra_graph *g, unsigned int n)
    return g->nodes[n].q_total < g->regs->classes[n_class]->p;
 }
 
+static void
+update_min_q(struct ra_graph *g, unsigned int n)
+{
+   unsigned int w = n / BITSET_WORDBITS;
+   unsigned int q_total = g->nodes[n].q_total;
+
+   if (q_total < g->tmp.min_q_total[w] ||
+       (q_total == g->tmp.min_q_total[w] && n > g->tmp.min_q_node[w])) {
+      g->tmp.min_q_total[w] = q_total;
+      g->tmp.min_q_node[w] = n;
+   }
+}
+
+static void
+compute_min_q(struct ra_graph *g, unsigned int w)
+{
+   BITSET_WORD todo = ~g->tmp.done[w];
+
+   g->tmp.min_q_total[w] = ~0;
+   g->tmp.min_q_node[w] = ~0;
+
+   while (todo) {
+      const int bit = util_last_bit(todo) - 1;
+      const unsigned int n = w * BITSET_WORDBITS + bit;
+      todo &= ~(1u << bit);
+
+      /* Going down, so the first node with the lowest q_total wins. */
+      if (g->nodes[n].q_total < g->tmp.min_q_total[w]) {
+         g->tmp.min_q_total[w] = g->nodes[n].q_total;
+         g->tmp.min_q_node[w] = n;
+      }
+   }
+}
+
 static void
 decrement_q(struct ra_graph *g, unsigned int n)
 {
@@ -490,10 +550,32 @@ decrement_q(struct ra_graph *g, unsigned int n)
       if (!g->nodes[n2].in_stack) {
          assert(g->nodes[n2].q_total >= g->regs->classes[n2_class]->q[n_class]);
          g->nodes[n2].q_total -= g->regs->classes[n2_class]->q[n_class];
+
+         if (!BITSET_TEST(g->tmp.done, n2)) {
+            if (pq_test(g, n2))
+               BITSET_SET(g->tmp.pq, n2);
+            update_min_q(g, n2);
+         }
       }
    }
 }
 
+static void
+push_node(struct ra_graph *g, unsigned int n)
+{
+   unsigned int w = n / BITSET_WORDBITS;
+
+   decrement_q(g, n);
+   g->stack[g->stack_count] = n;
+   g->stack_count++;
+   g->nodes[n].in_stack = true;
+
+   BITSET_SET(g->tmp.done, n);
+   BITSET_CLEAR(g->tmp.pq, n);
+   if (g->tmp.min_q_node[w] == n)
+      compute_min_q(g, w);
+}
+
 /**
  * Simplifies the interference graph by pushing all
  * trivially-colorable nodes into a stack of nodes to be colored,
@@ -503,51 +585,92 @@ decrement_q(struct ra_graph *g, unsigned int n)
  * we optimistically choose a node and push it on the stack. We heuristically
  * push the node with the lowest total q value, since it has the fewest
  * neighbors and therefore is most likely to be allocated.
+ *
+ * Each pass goes over the nodes from the last to the first one, and the
+ * order nodes get pushed in decides the allocation.  Rather than testing
+ * every node on every pass, which is quadratic once the graph needs many
+ * optimistic pushes, the nodes passing the pq test and the lowest q total
+ * of each word of nodes are kept up to date as q totals go down.  A pass
+ * then only looks at one word for every BITSET_WORDBITS nodes, and pushes
+ * the same nodes in the same order as testing them all would.
  */
 static void
 ra_simplify(struct ra_graph *g)
 {
    bool progress = true;
    unsigned int stack_optimistic_start = UINT_MAX;
+   const unsigned int words = BITSET_WORDS(g->count);
    int i;
 
-   while (progress) {
-      unsigned int best_optimistic_node = ~0;
-      unsigned int lowest_q_total = ~0;
+   g->tmp.done = calloc(MAX2(words, 1), sizeof(BITSET_WORD));
+   g->tmp.pq = calloc(MAX2(words, 1), sizeof(BITSET_WORD));
+   g->tmp.min_q_total = malloc(MAX2(words, 1) * sizeof(unsigned int));
+   g->tmp.min_q_node = malloc(MAX2(words, 1) * sizeof(unsigned int));
+
+   for (i = 0; i < g->count; i++) {
+      if (g->nodes[i].in_stack || g->nodes[i].reg != NO_REG)
+         BITSET_SET(g->tmp.done, i);
+      else if (pq_test(g, i))
+         BITSET_SET(g->tmp.pq, i);
+   }
+   /* The bits past the last node are set, so they're never visited. */
+   if (g->count % BITSET_WORDBITS)
+      g->tmp.done[words - 1] |= ~0u << (g->count % BITSET_WORDBITS);
+
+   for (i = 0; i < words; i++)
+      compute_min_q(g, i);
 
+   while (progress) {
       progress = false;
 
-      for (i = g->count - 1; i >= 0; i--) {
-	 if (g->nodes[i].in_stack || g->nodes[i].reg != NO_REG)
-	    continue;
-
-	 if (pq_test(g, i)) {
-	    decrement_q(g, i);
-	    g->stack[g->stack_count] = i;
-	    g->stack_count++;
-	    g->nodes[i].in_stack = true;
-	    progress = true;
-	 } else {
-	    unsigned int new_q_total = g->nodes[i].q_total;
-	    if (new_q_total < lowest_q_total) {
-	       best_optimistic_node = i;
-	       lowest_q_total = new_q_total;
-	    }
-	 }
+      for (int w = words - 1; w >= 0; w--) {
+         /* Pushing a node may let nodes below it in the same word pass the
+          * pq test, which the pass then visits too.  The ones above it wait
+          * for the next pass.
+          */
+         BITSET_WORD below = ~0u;
+         BITSET_WORD todo;
+
+         while ((todo = g->tmp.pq[w] & below)) {
+            const int bit = util_last_bit(todo) - 1;
+            below = (1u << bit) - 1;
+
+            push_node(g, w * BITSET_WORDBITS + bit);
+            progress = true;
+         }
       }
 
-      if (!progress && best_optimistic_node != ~0U) {
-         if (stack_optimistic_start == UINT_MAX)
-            stack_optimistic_start = g->stack_count;
+      /* A pass that didn't push anything didn't change any q total either,
+       * so the per word minimums are the ones the pass would have seen.
+       */
+      if (!progress) {
+         unsigned int best_optimistic_node = ~0;
+         unsigned int lowest_q_total = ~0;
+
+         for (int w = words - 1; w >= 0; w--) {
+            if (g->tmp.min_q_node[w] != ~0U &&
+                g->tmp.min_q_total[w] < lowest_q_total) {
+               best_optimistic_node = g->tmp.min_q_node[w];
+               lowest_q_total = g->tmp.min_q_total[w];
+            }
+         }
+
+         if (best_optimistic_node != ~0U) {
+            if (stack_optimistic_start == UINT_MAX)
+               stack_optimistic_start = g->stack_count;
 
-	 decrement_q(g, best_optimistic_node);
-	 g->stack[g->stack_count] = best_optimistic_node;
-	 g->stack_count++;
-	 g->nodes[best_optimistic_node].in_stack = true;
-	 progress = true;
+            push_node(g, best_optimistic_node);
+            progress = true;
+         }
       }
    }
 
+   free(g->tmp.done);
+   free(g->tmp.pq);
+   free(g->tmp.min_q_total);
+   free(g->tmp.min_q_node);
+   memset(&g->tmp, 0, sizeof(g->tmp));
+
    g->stack_optimistic_start = stack_optimistic_start;
 }
 
@@ -37,67 +37,14 @@
 #include <string.h>
 
 #include "hash_table.h"
+#include "hash_group.h"
 #include "macros.h"
 #include "ralloc.h"
 #include "set.h"
 
-/*
- * From Knuth -- a good choice for hash/rehash values is p, p-2 where
- * p and p-2 are both prime.  These tables are sized to have an extra 10%
- * free to avoid exponential performance degradation as the hash table fills
- */
-
 static const uint32_t deleted_key_value;
 static const void *deleted_key = &deleted_key_value;
 
-static const struct {
-   uint32_t max_entries, size, rehash;
-} hash_sizes[] = {
-   { 2,            5,            3            },
-   { 4,            7,            5            },
-   { 8,            13,           11           },
-   { 16,           19,           17           },
-   { 32,           43,           41           },
-   { 64,           73,           71           },
-   { 128,          151,          149          },
-   { 256,          283,          281          },
-   { 512,          571,          569          },
-   { 1024,         1153,         1151         },
-   { 2048,         2269,         2267         },
-   { 4096,         4519,         4517         },
-   { 8192,         9013,         9011         },
-   { 16384,        18043,        18041        },
-   { 32768,        36109,        36107        },
-   { 65536,        72091,        72089        },
-   { 131072,       144409,       144407       },
-   { 262144,       288361,       288359       },
-   { 524288,       576883,       576881       },
-   { 1048576,      1153459,      1153457      },
-   { 2097152,      2307163,      2307161      },
-   { 4194304,      4613893,      4613891      },
-   { 8388608,      9227641,      9227639      },
-   { 16777216,     18455029,     18455027     },
-   { 33554432,     36911011,     36911009     },
-   { 67108864,     73819861,     73819859     },
-   { 134217728,    147639589,    147639587    },
-   { 268435456,    295279081,    295279079    },
-   { 536870912,    590559793,    590559791    },
-   { 1073741824,   1181116273,   1181116271   },
-   { 2147483648ul, 2362232233ul, 2362232231ul }
-};
-
-static int
-entry_is_free(struct set_entry *entry)
-{
-   return entry->key == NULL;
-}
-
-static int
-entry_is_deleted(struct set_entry *entry)
-{
-   return entry->key == deleted_key;
-}
-
 static int
 entry_is_present(struct set_entry *entry)
 {
@@ -117,16 +64,16 @@ _mesa_set_create(void *mem_ctx,
       return NULL;
 
    ht->size_index = 0;
-   ht->size = hash_sizes[ht->size_index].size;
-   ht->rehash = hash_sizes[ht->size_index].rehash;
-   ht->max_entries = hash_sizes[ht->size_index].max_entries;
+   ht->size = hash_size_for_index(ht->size_index);
+   ht->max_entries = hash_max_entries_for_size(ht->size);
    ht->key_hash_function = key_hash_function;
    ht->key_equals_function = key_equals_function;
    ht->table = rzalloc_array(ht, struct set_entry, ht->size);
+   ht->ctrl = hash_ctrl_alloc(ht, ht->size);
    ht->entries = 0;
    ht->deleted_entries = 0;
 
-   if (ht->table == NULL) {
+   if (ht->table == NULL || ht->ctrl == NULL) {
       ralloc_free(ht);
       return NULL;
    }
@@ -153,6 +100,15 @@ _mesa_set_clone(struct set *set, void *dst_mem_ctx)
 
    memcpy(clone->table, set->table, clone->size * sizeof(struct set_entry));
 
+   clone->ctrl = ralloc_array(clone, uint8_t,
+                              clone->size + HASH_GROUP_WIDTH - 1);
+   if (clone->ctrl == NULL) {
+      ralloc_free(clone);
+      return NULL;
+   }
+
+   memcpy(clone->ctrl, set->ctrl, clone->size + HASH_GROUP_WIDTH - 1);
+
    return clone;
 }
 
@@ -189,12 +145,20 @@ _mesa_set_clear(struct set *set, void (*delete_function)(struct set_entry *entry
    if (!set)
       return;
 
-   set_foreach (set, entry) {
-      if (delete_function)
+   struct set_entry *entry;
+
+   for (entry = set->table; entry != set->table + set->size; entry++) {
+      if (entry->key == NULL)
+         continue;
+
+      if (delete_function != NULL && entry->key != deleted_key)
          delete_function(entry);
-      entry->key = deleted_key;
+
+      entry->key = NULL;
    }
 
+   memset(set->ctrl, HASH_CTRL_EMPTY, set->size + HASH_GROUP_WIDTH - 1);
+
    set->entries = set->deleted_entries = 0;
 }
 
@@ -206,26 +170,27 @@ _mesa_set_clear(struct set *set, void (*delete_function)(struct set_entry *entry
 static struct set_entry *
 set_search(const struct set *ht, uint32_t hash, const void *key)
 {
-   uint32_t hash_address;
+   const uint8_t tag = hash_ctrl_tag(hash);
+   struct hash_probe probe;
 
-   hash_address = hash % ht->size;
-   do {
-      uint32_t double_hash;
+   hash_probe_init(&probe, hash, ht->size);
+   for (uint32_t i = 0; i < ht->size; i += HASH_GROUP_WIDTH) {
+      const uint8_t *group = ht->ctrl + probe.pos;
 
-      struct set_entry *entry = ht->table + hash_address;
+      unsigned match = hash_group_match(group, tag);
+      while (match) {
+         struct set_entry *entry =
+            ht->table + hash_probe_slot(&probe, u_bit_scan(&match));
 
-      if (entry_is_free(entry)) {
-         return NULL;
-      } else if (entry_is_present(entry) && entry->hash == hash) {
-         if (ht->key_equals_function(key, entry->key)) {
+         if (entry->hash == hash && ht->key_equals_function(key, entry->key))
             return entry;
-         }
       }
 
-      double_hash = 1 + hash % ht->rehash;
+      if (hash_group_match(group, HASH_CTRL_EMPTY))
+         return NULL;
 
-      hash_address = (hash_address + double_hash) % ht->size;
-   } while (hash_address != hash % ht->size);
+      hash_probe_next(&probe);
+   }
 
    return NULL;
 }
@@ -254,22 +219,30 @@ set_rehash(struct set *ht, unsigned new_size_index)
 {
    struct set old_ht;
    struct set_entry *table;
+   uint8_t *ctrl;
 
-   if (new_size_index >= ARRAY_SIZE(hash_sizes))
+   if (new_size_index > HASH_MAX_SIZE_INDEX)
       return;
 
-   table = rzalloc_array(ht, struct set_entry,
-                         hash_sizes[new_size_index].size);
+   uint32_t size = hash_size_for_index(new_size_index);
+
+   table = rzalloc_array(ht, struct set_entry, size);
    if (table == NULL)
       return;
 
+   ctrl = hash_ctrl_alloc(ht, size);
+   if (ctrl == NULL) {
+      ralloc_free(table);
+      return;
+   }
+
    old_ht = *ht;
 
    ht->table = table;
+   ht->ctrl = ctrl;
    ht->size_index = new_size_index;
-   ht->size = hash_sizes[ht->size_index].size;
-   ht->rehash = hash_sizes[ht->size_index].rehash;
-   ht->max_entries = hash_sizes[ht->size_index].max_entries;
+   ht->size = size;
+   ht->max_entries = hash_max_entries_for_size(size);
    ht->entries = 0;
    ht->deleted_entries = 0;
 
@@ -278,6 +251,7 @@ set_rehash(struct set *ht, unsigned new_size_index)
    }
 
    ralloc_free(old_ht.table);
+   ralloc_free(old_ht.ctrl);
 }
 
 /**
@@ -289,7 +263,6 @@ set_rehash(struct set *ht, unsigned new_size_index)
 static struct set_entry *
 set_add(struct set *ht, uint32_t hash, const void *key)
 {
-   uint32_t hash_address;
    struct set_entry *available_entry = NULL;
 
    if (ht->entries >= ht->max_entries) {
@@ -298,18 +271,12 @@ set_add(struct set *ht, uint32_t hash, const void *key)
       set_rehash(ht, ht->size_index);
    }
 
-   hash_address = hash % ht->size;
-   do {
-      struct set_entry *entry = ht->table + hash_address;
-      uint32_t double_hash;
-
-      if (!entry_is_present(entry)) {
-         /* Stash the first available entry we find */
-         if (available_entry == NULL)
-            available_entry = entry;
-         if (entry_is_free(entry))
-            break;
-      }
+   const uint8_t tag = hash_ctrl_tag(hash);
+   struct hash_probe probe;
+
+   hash_probe_init(&probe, hash, ht->size);
+   for (uint32_t i = 0; i < ht->size; i += HASH_GROUP_WIDTH) {
+      const uint8_t *group = ht->ctrl + probe.pos;
 
       /* Implement replacement when another insert happens
        * with a matching key.  This is a relatively common
@@ -321,21 +288,37 @@ set_add(struct set *ht, uint32_t hash, const void *key)
        * If freeing of old keys is required to avoid memory leaks,
        * perform a search before inserting.
        */
-      if (!entry_is_deleted(entry) &&
-          entry->hash == hash &&
-          ht->key_equals_function(key, entry->key)) {
-         entry->key = key;
-         return entry;
+      unsigned match = hash_group_match(group, tag);
+      while (match) {
+         struct set_entry *entry =
+            ht->table + hash_probe_slot(&probe, u_bit_scan(&match));
+
+         if (entry->hash == hash && ht->key_equals_function(key, entry->key)) {
+            entry->key = key;
+            return entry;
+         }
       }
 
-      double_hash = 1 + hash % ht->rehash;
+      /* Stash the first available entry we find */
+      if (available_entry == NULL) {
+         unsigned available = hash_group_match_available(group);
+         if (available) {
+            available_entry =
+               ht->table + hash_probe_slot(&probe, ffs(available) - 1);
+         }
+      }
 
-      hash_address = (hash_address + double_hash) % ht->size;
-   } while (hash_address != hash % ht->size);
+      if (hash_group_match(group, HASH_CTRL_EMPTY))
+         break;
+
+      hash_probe_next(&probe);
+   }
 
    if (available_entry) {
-      if (entry_is_deleted(available_entry))
+      uint32_t slot = available_entry - ht->table;
+      if (ht->ctrl[slot] == HASH_CTRL_DELETED)
          ht->deleted_entries--;
+      hash_ctrl_set(ht->ctrl, ht->size, slot, tag);
       available_entry->hash = hash;
       available_entry->key = key;
       ht->entries++;
@@ -375,6 +358,7 @@ _mesa_set_remove(struct set *ht, struct set_entry *entry)
    if (!entry)
       return;
 
+   hash_ctrl_set(ht->ctrl, ht->size, entry - ht->table, HASH_CTRL_DELETED);
    entry->key = deleted_key;
    ht->entries--;
    ht->deleted_entries++;
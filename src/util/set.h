@@ -43,10 +43,11 @@ struct set_entry {
 struct set {
    void *mem_ctx;
    struct set_entry *table;
+   /* One control byte per entry, see hash_group.h */
+   uint8_t *ctrl;
    uint32_t (*key_hash_function)(const void *key);
    bool (*key_equals_function)(const void *a, const void *b);
    uint32_t size;
-   uint32_t rehash;
    uint32_t max_entries;
    uint32_t size_index;
    uint32_t entries;
@@ -230,6 +230,34 @@ slab_alloc(struct slab_child_pool *pool)
    return &elt[1];
 }
 
+/* Give back an element that doesn't belong to the calling child pool: put it
+ * on its owner's migrated list, or free it if its page is orphaned.
+ */
+static void
+slab_free_migrated(struct slab_parent_pool *parent,
+                   struct slab_element_header *elt)
+{
+   intptr_t owner_int;
+
+   mtx_lock(&parent->mutex);
+
+   /* Note: we _must_ re-read elt->owner here because the owning child pool
+    * may have been destroyed by another thread in the meantime.
+    */
+   owner_int = p_atomic_read(&elt->owner);
+
+   if (!(owner_int & 1)) {
+      struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
+      elt->next = owner->migrated;
+      owner->migrated = elt;
+      mtx_unlock(&parent->mutex);
+   } else {
+      mtx_unlock(&parent->mutex);
+
+      slab_free_orphaned(elt);
+   }
+}
+
 /**
  * Free an object allocated from the slab. Single-threaded (i.e. the caller
  * must ensure that no operation happens on the same child pool in another
@@ -242,7 +270,6 @@ slab_alloc(struct slab_child_pool *pool)
 void slab_free(struct slab_child_pool *pool, void *ptr)
 {
    struct slab_element_header *elt = ((struct slab_element_header*)ptr - 1);
-   intptr_t owner_int;
 
    CHECK_MAGIC(elt, SLAB_MAGIC_ALLOCATED);
    SET_MAGIC(elt, SLAB_MAGIC_FREE);
@@ -257,23 +284,7 @@ void slab_free(struct slab_child_pool *pool, void *ptr)
    }
 
    /* The slow case: migration or an orphaned page. */
-   mtx_lock(&pool->parent->mutex);
-
-   /* Note: we _must_ re-read elt->owner here because the owning child pool
-    * may have been destroyed by another thread in the meantime.
-    */
-   owner_int = p_atomic_read(&elt->owner);
-
-   if (!(owner_int & 1)) {
-      struct slab_child_pool *owner = (struct slab_child_pool *)owner_int;
-      elt->next = owner->migrated;
-      owner->migrated = elt;
-      mtx_unlock(&pool->parent->mutex);
-   } else {
-      mtx_unlock(&pool->parent->mutex);
-
-      slab_free_orphaned(elt);
-   }
+   slab_free_migrated(pool->parent, elt);
 }
 
 /**
@@ -315,3 +326,131 @@ slab_create(struct slab_mempool *mempool,
    slab_create_parent(&mempool->parent, item_size, num_items);
    slab_create_child(&mempool->child, &mempool->parent);
 }
+
+/* The implicit child pool of one thread in a slab_mt_pool. */
+struct slab_thread_cache {
+   struct slab_child_pool child;
+   struct slab_mt_pool *pool;
+   struct list_head link;
+};
+
+static void
+slab_thread_cache_destroy(struct slab_thread_cache *cache)
+{
+   slab_destroy_child(&cache->child);
+   free(cache);
+}
+
+/* Called on thread exit for every pool the thread has used. */
+static void
+slab_thread_cache_exit(void *data)
+{
+   struct slab_thread_cache *cache = data;
+   struct slab_mt_pool *pool = cache->pool;
+
+   mtx_lock(&pool->parent.mutex);
+   list_del(&cache->link);
+   mtx_unlock(&pool->parent.mutex);
+
+   slab_thread_cache_destroy(cache);
+}
+
+static struct slab_thread_cache *
+slab_get_thread_cache(struct slab_mt_pool *pool)
+{
+   struct slab_thread_cache *cache = tss_get(pool->thread_cache);
+
+   if (likely(cache))
+      return cache;
+
+   cache = malloc(sizeof(*cache));
+   if (!cache)
+      return NULL;
+
+   slab_create_child(&cache->child, &pool->parent);
+   cache->pool = pool;
+
+   mtx_lock(&pool->parent.mutex);
+   list_addtail(&cache->link, &pool->thread_caches);
+   mtx_unlock(&pool->parent.mutex);
+
+   tss_set(pool->thread_cache, cache);
+   return cache;
+}
+
+/**
+ * Create an allocator for same-sized objects that can be used from several
+ * threads at once.
+ *
+ * Each thread allocates from its own child pool, so the common case takes
+ * no lock.  Objects freed by a thread other than the allocating one are
+ * handed back to their owner through the child pool migration list.
+ *
+ * \param item_size     Size of one object.
+ * \param num_items     Number of objects to allocate at once.
+ */
+void
+slab_create_mt(struct slab_mt_pool *pool,
+               unsigned item_size,
+               unsigned num_items)
+{
+   slab_create_parent(&pool->parent, item_size, num_items);
+   tss_create(&pool->thread_cache, slab_thread_cache_exit);
+   list_inithead(&pool->thread_caches);
+}
+
+/**
+ * Destroy the allocator and the child pools of all threads.
+ *
+ * No thread may use the pool anymore at this point, and all objects should
+ * have been freed, otherwise the pages they live in are leaked.
+ */
+void
+slab_destroy_mt(struct slab_mt_pool *pool)
+{
+   /* tss_delete doesn't run the destructors, so tear down the caches of
+    * all threads that are still alive here.
+    */
+   tss_delete(pool->thread_cache);
+
+   list_for_each_entry_safe(struct slab_thread_cache, cache,
+                            &pool->thread_caches, link)
+      slab_thread_cache_destroy(cache);
+
+   slab_destroy_parent(&pool->parent);
+}
+
+/**
+ * Allocate an object.  Thread-safe.
+ */
+void *
+slab_alloc_mt(struct slab_mt_pool *pool)
+{
+   struct slab_thread_cache *cache = slab_get_thread_cache(pool);
+
+   return cache ? slab_alloc(&cache->child) : NULL;
+}
+
+/**
+ * Free an object allocated with slab_alloc_mt from any thread.  Thread-safe.
+ */
+void
+slab_free_mt(struct slab_mt_pool *pool, void *ptr)
+{
+   struct slab_thread_cache *cache = slab_get_thread_cache(pool);
+
+   if (likely(cache)) {
+      slab_free(&cache->child, ptr);
+      return;
+   }
+
+   /* Out of memory for a cache of our own: hand the object back to its
+    * owner directly.
+    */
+   struct slab_element_header *elt = ((struct slab_element_header*)ptr - 1);
+
+   CHECK_MAGIC(elt, SLAB_MAGIC_ALLOCATED);
+   SET_MAGIC(elt, SLAB_MAGIC_FREE);
+
+   slab_free_migrated(&pool->parent, elt);
+}
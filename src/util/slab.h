@@ -37,12 +37,23 @@
  *
  * For convenience and to ease the transition, there is also a set of wrapper
  * functions around a single parent-child pair.
+ *
+ * Finally, slab_mt_pool is a parent with one implicit child per thread,
+ * created the first time the thread uses the pool and destroyed when the
+ * thread exits.  It can be used from any number of threads without external
+ * locking, and objects may be freed by a different thread than the one
+ * that allocated them.
  */
 
 #ifndef SLAB_H
 #define SLAB_H
 
 #include "c11/threads.h"
+#include "list.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 struct slab_element_header;
 struct slab_page_header;
@@ -91,4 +102,25 @@ void slab_destroy(struct slab_mempool *mempool);
 void *slab_alloc_st(struct slab_mempool *mempool);
 void slab_free_st(struct slab_mempool *mempool, void *ptr);
 
+struct slab_mt_pool {
+   struct slab_parent_pool parent;
+
+   /* The calling thread's struct slab_thread_cache. */
+   tss_t thread_cache;
+
+   /* All thread caches, protected by the parent mutex. */
+   struct list_head thread_caches;
+};
+
+void slab_create_mt(struct slab_mt_pool *pool,
+                    unsigned item_size,
+                    unsigned num_items);
+void slab_destroy_mt(struct slab_mt_pool *pool);
+void *slab_alloc_mt(struct slab_mt_pool *pool);
+void slab_free_mt(struct slab_mt_pool *pool, void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
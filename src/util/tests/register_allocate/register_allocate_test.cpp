@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include "util/ralloc.h"
+#include "util/register_allocate.h"
+
+class ra_test : public ::testing::Test {
+protected:
+   ra_test();
+   ~ra_test();
+
+   void create_regs(unsigned count);
+   void check_allocation(const bool *interferes, unsigned count);
+
+   void *mem_ctx;
+   struct ra_regs *regs;
+   unsigned int reg_class;
+};
+
+ra_test::ra_test()
+{
+   mem_ctx = ralloc_context(NULL);
+   regs = NULL;
+   reg_class = 0;
+}
+
+ra_test::~ra_test()
+{
+   ralloc_free(mem_ctx);
+}
+
+void
+ra_test::create_regs(unsigned count)
+{
+   regs = ra_alloc_reg_set(mem_ctx, count, true);
+   reg_class = ra_alloc_reg_class(regs);
+   for (unsigned i = 0; i < count; i++)
+      ra_class_add_reg(regs, reg_class, i);
+   ra_set_finalize(regs, NULL);
+}
+
+static struct ra_graph *
+create_graph(struct ra_regs *regs, unsigned int reg_class,
+             const bool *interferes, unsigned count)
+{
+   struct ra_graph *g = ra_alloc_interference_graph(regs, count);
+
+   for (unsigned i = 0; i < count; i++) {
+      ra_set_node_class(g, i, reg_class);
+      for (unsigned j = 0; j < i; j++) {
+         if (interferes[i * count + j])
+            ra_add_node_interference(g, i, j);
+      }
+   }
+
+   return g;
+}
+
+void
+ra_test::check_allocation(const bool *interferes, unsigned count)
+{
+   struct ra_graph *g = create_graph(regs, reg_class, interferes, count);
+
+   ASSERT_TRUE(ra_allocate(g));
+
+   for (unsigned i = 0; i < count; i++) {
+      for (unsigned j = 0; j < i; j++) {
+         if (interferes[i * count + j]) {
+            EXPECT_NE(ra_get_node_reg(g, i), ra_get_node_reg(g, j));
+         }
+      }
+   }
+
+   ralloc_free(g);
+}
+
+TEST_F(ra_test, clique)
+{
+   const unsigned count = 4;
+   bool interferes[count * count];
+
+   for (unsigned i = 0; i < count * count; i++)
+      interferes[i] = true;
+
+   create_regs(count);
+   check_allocation(interferes, count);
+}
+
+TEST_F(ra_test, spill)
+{
+   const unsigned count = 5;
+   bool interferes[count * count];
+
+   for (unsigned i = 0; i < count * count; i++)
+      interferes[i] = true;
+
+   create_regs(count - 1);
+   struct ra_graph *g = create_graph(regs, reg_class, interferes, count);
+   for (unsigned i = 0; i < count; i++)
+      ra_set_node_spill_cost(g, i, i == 2 ? 1.0f : 10.0f);
+
+   EXPECT_FALSE(ra_allocate(g));
+   EXPECT_EQ(ra_get_best_spill_node(g), 2);
+
+   ralloc_free(g);
+}
+
+/* A large interval graph, like the ones the backends build from live
+ * ranges.  At most 31 intervals overlap at any point, so 32 registers are
+ * always enough, and it is large enough that allocating it grinds if
+ * simplifying the graph doesn't scale.
+ */
+TEST_F(ra_test, large_interval_graph)
+{
+   const unsigned count = 4000;
+   bool *interferes = new bool[count * count]();
+   unsigned *end = new unsigned[count];
+   uint32_t seed = 1;
+
+   for (unsigned i = 0; i < count; i++) {
+      seed = seed * 1103515245 + 12345;
+      end[i] = i + 1 + (seed >> 16) % 31;
+   }
+
+   for (unsigned i = 0; i < count; i++) {
+      for (unsigned j = 0; j < i; j++) {
+         if (i < end[j])
+            interferes[i * count + j] = true;
+      }
+   }
+
+   create_regs(32);
+   check_allocation(interferes, count);
+
+   delete[] end;
+   delete[] interferes;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright © 2019 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include "util/slab.h"
+
+#define NUM_THREADS 4
+#define NUM_OBJECTS 10000
+
+struct object {
+   unsigned thread;
+   unsigned index;
+};
+
+struct thread_data {
+   struct slab_mt_pool *pool;
+   unsigned thread;
+   unsigned first;
+   struct object *objects[NUM_THREADS * NUM_OBJECTS];
+   bool ok;
+};
+
+/* Allocate objects, check that nobody else writes to them, and free every
+ * other one of them, leaving the rest to be freed by another thread.
+ */
+static int
+alloc_thread(void *arg)
+{
+   struct thread_data *data = (struct thread_data *)arg;
+
+   data->ok = true;
+
+   for (unsigned i = 0; i < NUM_OBJECTS; i++) {
+      struct object *obj = (struct object *)slab_alloc_mt(data->pool);
+
+      if (!obj) {
+         data->ok = false;
+         return 0;
+      }
+
+      obj->thread = data->thread;
+      obj->index = i;
+      data->objects[data->first + i] = obj;
+   }
+
+   for (unsigned i = 0; i < NUM_OBJECTS; i++) {
+      struct object *obj = data->objects[data->first + i];
+
+      if (obj->thread != data->thread || obj->index != i)
+         data->ok = false;
+
+      if (i % 2) {
+         slab_free_mt(data->pool, obj);
+         data->objects[data->first + i] = NULL;
+      }
+   }
+
+   return 0;
+}
+
+/* Free all objects left behind by the allocating threads. */
+static int
+free_thread(void *arg)
+{
+   struct thread_data *data = (struct thread_data *)arg;
+
+   for (unsigned i = 0; i < NUM_THREADS * NUM_OBJECTS; i++) {
+      if (data->objects[i]) {
+         slab_free_mt(data->pool, data->objects[i]);
+         data->objects[i] = NULL;
+      }
+   }
+
+   return 0;
+}
+
+static void
+run_threads(struct slab_mt_pool *pool, struct thread_data *data)
+{
+   thrd_t threads[NUM_THREADS];
+
+   for (unsigned t = 0; t < NUM_THREADS; t++) {
+      data[t].pool = pool;
+      data[t].thread = t;
+      data[t].first = t * NUM_OBJECTS;
+      memset(data[t].objects, 0, sizeof(data[t].objects));
+      ASSERT_EQ(thrd_create(&threads[t], alloc_thread, &data[t]),
+                thrd_success);
+   }
+
+   for (unsigned t = 0; t < NUM_THREADS; t++) {
+      thrd_join(threads[t], NULL);
+      EXPECT_TRUE(data[t].ok);
+   }
+}
+
+TEST(slab_mt, cross_thread_free)
+{
+   struct slab_mt_pool pool;
+   static struct thread_data data[NUM_THREADS];
+
+   slab_create_mt(&pool, sizeof(struct object), 64);
+
+   /* The allocating threads have exited by the time the objects they left
+    * are freed, so this also covers orphaned pages.
+    */
+   for (unsigned round = 0; round < 2; round++) {
+      run_threads(&pool, data);
+
+      for (unsigned t = 0; t < NUM_THREADS; t++) {
+         thrd_t thread;
+
+         ASSERT_EQ(thrd_create(&thread, free_thread, &data[t]), thrd_success);
+         thrd_join(thread, NULL);
+      }
+   }
+
+   slab_destroy_mt(&pool);
+}
+
+TEST(slab_mt, reuse)
+{
+   struct slab_mt_pool pool;
+
+   slab_create_mt(&pool, sizeof(struct object), 64);
+
+   /* Objects freed by the thread that allocated them are handed out again. */
+   void *a = slab_alloc_mt(&pool);
+   ASSERT_TRUE(a);
+   slab_free_mt(&pool, a);
+
+   void *b = slab_alloc_mt(&pool);
+   EXPECT_EQ(a, b);
+   slab_free_mt(&pool, b);
+
+   slab_destroy_mt(&pool);
+}
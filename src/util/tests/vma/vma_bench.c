@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* Times util_vma_heap_alloc/free with many live allocations, the way a
+ * driver softpinning thousands of BOs uses the heap.
+ *
+ *    vma_bench [live_allocations [iterations]]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "util/os_time.h"
+#include "util/vma.h"
+
+#define PAGE_SIZE 4096
+
+struct bench_alloc {
+   uint64_t offset;
+   uint64_t size;
+};
+
+static uint32_t
+bench_rand(uint32_t *state)
+{
+   /* xorshift32 */
+   uint32_t x = *state;
+   x ^= x << 13;
+   x ^= x >> 17;
+   x ^= x << 5;
+   return *state = x;
+}
+
+static uint64_t
+bench_size(uint32_t *state)
+{
+   /* Mostly small BOs, with the occasional big one */
+   uint32_t r = bench_rand(state);
+   unsigned pages = (r % 16 == 0) ? 1 + r % 1024 : 1 + r % 16;
+   return (uint64_t)pages * PAGE_SIZE;
+}
+
+int
+main(int argc, char **argv)
+{
+   unsigned live = argc > 1 ? strtoul(argv[1], NULL, 0) : 20000;
+   unsigned iterations = argc > 2 ? strtoul(argv[2], NULL, 0) : 1000000;
+   struct bench_alloc *allocs = calloc(live, sizeof(*allocs));
+   struct util_vma_heap heap;
+   uint32_t state = 0x12345678;
+   int64_t start, fill_ns, churn_ns;
+
+   if (!live || !allocs)
+      return 1;
+
+   util_vma_heap_init(&heap, PAGE_SIZE, 1ull << 47);
+
+   start = os_time_get_nano();
+   for (unsigned i = 0; i < live; i++) {
+      allocs[i].size = bench_size(&state);
+      allocs[i].offset = util_vma_heap_alloc(&heap, allocs[i].size,
+                                             PAGE_SIZE);
+   }
+   fill_ns = os_time_get_nano() - start;
+
+   /* Free random allocations and replace them, which leaves the heap
+    * fragmented into many holes.
+    */
+   start = os_time_get_nano();
+   for (unsigned i = 0; i < iterations; i++) {
+      struct bench_alloc *a = &allocs[bench_rand(&state) % live];
+
+      if (a->offset)
+         util_vma_heap_free(&heap, a->offset, a->size);
+
+      a->size = bench_size(&state);
+      a->offset = util_vma_heap_alloc(&heap, a->size, PAGE_SIZE);
+   }
+   churn_ns = os_time_get_nano() - start;
+
+   printf("fill:  %u allocations in %.3f ms (%.1f ns each)\n",
+          live, fill_ns / 1e6, (double)fill_ns / live);
+   printf("churn: %u free+alloc in %.3f ms (%.1f ns each)\n",
+          iterations, churn_ns / 1e6, (double)churn_ns / iterations);
+
+   util_vma_heap_finish(&heap);
+   free(allocs);
+
+   return 0;
+}
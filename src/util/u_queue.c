@@ -28,14 +28,19 @@
 
 #include <time.h>
 
+#include "util/bitscan.h"
 #include "util/os_time.h"
 #include "util/u_string.h"
 #include "util/u_thread.h"
+#include "util/u_trace.h"
 #include "u_process.h"
+#include "u_cpu_detect.h"
 
 static void
 util_queue_kill_threads(struct util_queue *queue, unsigned keep_num_threads,
                         bool finish_locked);
+static void
+util_queue_pool_exit(void);
 
 /****************************************************************************
  * Wait for all queues to assert idle when exit() is called.
@@ -59,6 +64,8 @@ atexit_handler(void)
       util_queue_kill_threads(iter, 0, false);
    }
    mtx_unlock(&exit_mutex);
+
+   util_queue_pool_exit();
 }
 
 static void
@@ -224,6 +231,217 @@ util_queue_fence_destroy(struct util_queue_fence *fence)
 }
 #endif
 
+/****************************************************************************
+ * Thread pool shared by the UTIL_QUEUE_INIT_SHARED queues
+ *
+ * Each queue keeps its own ring of jobs.  Queues which have a job that may
+ * start are on the ready list of their priority class, and idle pool threads
+ * take the first job of the first queue of the highest class, then move the
+ * queue to the end of its list so that the queues of a class take turns.
+ * All of this, including the job rings of the shared queues, is protected
+ * by the pool lock.
+ */
+
+enum util_queue_priority {
+   UTIL_QUEUE_PRIORITY_HIGH,
+   UTIL_QUEUE_PRIORITY_NORMAL,
+   UTIL_QUEUE_PRIORITY_BACKGROUND,
+   UTIL_QUEUE_NUM_PRIORITIES,
+};
+
+static struct {
+   mtx_t lock;
+   cnd_t has_work_cond;
+   cnd_t exit_cond;
+   struct list_head ready[UTIL_QUEUE_NUM_PRIORITIES];
+   unsigned max_threads;
+   unsigned max_background_jobs;
+   unsigned num_threads;
+   unsigned num_idle;
+   unsigned num_background_jobs;
+   bool initialized;
+   bool exiting;
+} pool;
+
+static once_flag pool_once_flag = ONCE_FLAG_INIT;
+
+static void
+util_queue_pool_init(void)
+{
+   util_cpu_detect();
+
+   (void) mtx_init(&pool.lock, mtx_plain);
+   cnd_init(&pool.has_work_cond);
+   cnd_init(&pool.exit_cond);
+   for (unsigned i = 0; i < UTIL_QUEUE_NUM_PRIORITIES; i++)
+      list_inithead(&pool.ready[i]);
+
+   pool.max_threads = MAX2(util_cpu_caps.nr_cpus, 1);
+   pool.max_background_jobs = MAX2(pool.max_threads / 2, 1);
+   pool.initialized = true;
+}
+
+static inline bool
+util_queue_is_shared(struct util_queue *queue)
+{
+   return queue->flags & UTIL_QUEUE_INIT_SHARED;
+}
+
+static inline mtx_t *
+util_queue_lock(struct util_queue *queue)
+{
+   return util_queue_is_shared(queue) ? &pool.lock : &queue->lock;
+}
+
+static void
+util_queue_pool_make_ready(struct util_queue *queue);
+
+static struct util_queue *
+util_queue_pool_next(void)
+{
+   for (unsigned i = 0; i < UTIL_QUEUE_NUM_PRIORITIES; i++) {
+      if (i == UTIL_QUEUE_PRIORITY_BACKGROUND &&
+          pool.num_background_jobs >= pool.max_background_jobs)
+         continue;
+
+      if (!list_empty(&pool.ready[i]))
+         return list_first_entry(&pool.ready[i], struct util_queue, pool_link);
+   }
+   return NULL;
+}
+
+static int
+util_queue_pool_thread_func(void *input)
+{
+#ifdef HAVE_PTHREAD_SETAFFINITY
+   /* The threads work for everyone, don't inherit the thread affinity of
+    * the thread which happened to start them.
+    */
+   cpu_set_t cpuset;
+   CPU_ZERO(&cpuset);
+   for (unsigned i = 0; i < CPU_SETSIZE; i++)
+      CPU_SET(i, &cpuset);
+
+   pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+#endif
+
+   u_thread_setname("mesa:pool");
+   u_trace_set_thread_name("mesa:pool");
+
+   mtx_lock(&pool.lock);
+   while (1) {
+      struct util_queue *queue;
+      struct util_queue_job job;
+      unsigned thread_index;
+
+      while (!(queue = util_queue_pool_next()) && !pool.exiting)
+         cnd_wait(&pool.has_work_cond, &pool.lock);
+
+      if (!queue)
+         break;
+
+      job = queue->jobs[queue->read_idx];
+      memset(&queue->jobs[queue->read_idx], 0, sizeof(struct util_queue_job));
+      queue->read_idx = (queue->read_idx + 1) % queue->max_jobs;
+      queue->num_queued--;
+
+      thread_index = ffs(~queue->busy_thread_indices) - 1;
+      assert(thread_index < queue->num_threads);
+      queue->busy_thread_indices |= 1u << thread_index;
+      queue->num_running++;
+      if (queue->priority == UTIL_QUEUE_PRIORITY_BACKGROUND)
+         pool.num_background_jobs++;
+      pool.num_idle--;
+
+      /* Let the other queues of the class have the next turn. */
+      list_del(&queue->pool_link);
+      queue->in_pool = false;
+      util_queue_pool_make_ready(queue);
+
+      cnd_broadcast(&queue->has_space_cond);
+      mtx_unlock(&pool.lock);
+
+      if (job.job) {
+         MESA_TRACE_BEGIN("util_queue job");
+         job.execute(job.job, thread_index);
+         MESA_TRACE_END();
+         util_queue_fence_signal(job.fence);
+         if (job.cleanup)
+            job.cleanup(job.job, thread_index);
+      }
+
+      mtx_lock(&pool.lock);
+      queue->busy_thread_indices &= ~(1u << thread_index);
+      queue->num_running--;
+      if (queue->priority == UTIL_QUEUE_PRIORITY_BACKGROUND)
+         pool.num_background_jobs--;
+      pool.num_idle++;
+
+      util_queue_pool_make_ready(queue);
+
+      /* for util_queue_finish and util_queue_kill_threads */
+      cnd_broadcast(&queue->has_space_cond);
+   }
+
+   pool.num_idle--;
+   pool.num_threads--;
+   cnd_broadcast(&pool.exit_cond);
+   mtx_unlock(&pool.lock);
+   return 0;
+}
+
+/* Must be called with the pool lock held */
+static bool
+util_queue_pool_add_thread(void)
+{
+   thrd_t thread;
+
+   if (pool.num_threads == pool.max_threads)
+      return false;
+
+   thread = u_thread_create(util_queue_pool_thread_func, NULL);
+   if (!thread)
+      return false;
+
+   thrd_detach(thread);
+   pool.num_threads++;
+   pool.num_idle++;
+   return true;
+}
+
+/* Put the queue on its ready list if it has a job that may start.
+ * Must be called with the pool lock held.
+ */
+static void
+util_queue_pool_make_ready(struct util_queue *queue)
+{
+   if (queue->in_pool || queue->num_queued == 0 ||
+       queue->num_running >= queue->num_threads)
+      return;
+
+   list_addtail(&queue->pool_link, &pool.ready[queue->priority]);
+   queue->in_pool = true;
+
+   if (pool.num_idle == 0)
+      util_queue_pool_add_thread();
+   cnd_signal(&pool.has_work_cond);
+}
+
+/* Let the pool threads finish their current job and exit. */
+static void
+util_queue_pool_exit(void)
+{
+   if (!pool.initialized)
+      return;
+
+   mtx_lock(&pool.lock);
+   pool.exiting = true;
+   cnd_broadcast(&pool.has_work_cond);
+   while (pool.num_threads)
+      cnd_wait(&pool.exit_cond, &pool.lock);
+   mtx_unlock(&pool.lock);
+}
+
 /****************************************************************************
  * util_queue implementation
  */
@@ -259,6 +477,7 @@ util_queue_thread_func(void *input)
       char name[16];
       util_snprintf(name, sizeof(name), "%s%i", queue->name, thread_index);
       u_thread_setname(name);
+      u_trace_set_thread_name(name);
    }
 
    while (1) {
@@ -286,7 +505,9 @@ util_queue_thread_func(void *input)
       mtx_unlock(&queue->lock);
 
       if (job.job) {
+         MESA_TRACE_BEGIN("util_queue job");
          job.execute(job.job, thread_index);
+         MESA_TRACE_END();
          util_queue_fence_signal(job.fence);
          if (job.cleanup)
             job.cleanup(job.job, thread_index);
@@ -361,6 +582,15 @@ util_queue_adjust_num_threads(struct util_queue *queue, unsigned num_threads)
       return;
    }
 
+   if (util_queue_is_shared(queue)) {
+      mtx_lock(&pool.lock);
+      queue->num_threads = num_threads;
+      util_queue_pool_make_ready(queue);
+      mtx_unlock(&pool.lock);
+      mtx_unlock(&queue->finish_lock);
+      return;
+   }
+
    /* Create threads.
     *
     * We need to update num_threads first, because threads terminate
@@ -411,6 +641,18 @@ util_queue_init(struct util_queue *queue,
       util_snprintf(queue->name, sizeof(queue->name), "%s", name);
    }
 
+   if (flags & UTIL_QUEUE_INIT_SHARED) {
+      call_once(&pool_once_flag, util_queue_pool_init);
+      num_threads = MIN2(num_threads, 32);
+
+      if (flags & UTIL_QUEUE_INIT_HIGH_PRIORITY)
+         queue->priority = UTIL_QUEUE_PRIORITY_HIGH;
+      else if (flags & UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY)
+         queue->priority = UTIL_QUEUE_PRIORITY_BACKGROUND;
+      else
+         queue->priority = UTIL_QUEUE_PRIORITY_NORMAL;
+   }
+
    queue->flags = flags;
    queue->max_threads = num_threads;
    queue->num_threads = num_threads;
@@ -428,6 +670,20 @@ util_queue_init(struct util_queue *queue,
    cnd_init(&queue->has_queued_cond);
    cnd_init(&queue->has_space_cond);
 
+   if (flags & UTIL_QUEUE_INIT_SHARED) {
+      bool have_threads;
+
+      /* Make sure the jobs can run at all. */
+      mtx_lock(&pool.lock);
+      have_threads = pool.num_threads || util_queue_pool_add_thread();
+      mtx_unlock(&pool.lock);
+      if (!have_threads)
+         goto fail;
+
+      add_to_atexit_list(queue);
+      return true;
+   }
+
    queue->threads = (thrd_t*) calloc(num_threads, sizeof(thrd_t));
    if (!queue->threads)
       goto fail;
@@ -463,6 +719,38 @@ fail:
    return false;
 }
 
+/* Shared queues have no threads to kill, only fewer jobs may run at once.
+ * Down to zero, queued jobs are dropped and running ones waited for.
+ */
+static void
+util_queue_shared_kill_threads(struct util_queue *queue,
+                               unsigned keep_num_threads)
+{
+   mtx_lock(&pool.lock);
+   queue->num_threads = keep_num_threads;
+
+   if (keep_num_threads == 0) {
+      if (queue->in_pool) {
+         list_del(&queue->pool_link);
+         queue->in_pool = false;
+      }
+
+      for (unsigned i = queue->read_idx; i != queue->write_idx;
+           i = (i + 1) % queue->max_jobs) {
+         if (queue->jobs[i].job) {
+            util_queue_fence_signal(queue->jobs[i].fence);
+            queue->jobs[i].job = NULL;
+         }
+      }
+      queue->read_idx = queue->write_idx;
+      queue->num_queued = 0;
+
+      while (queue->num_running)
+         cnd_wait(&queue->has_space_cond, &pool.lock);
+   }
+   mtx_unlock(&pool.lock);
+}
+
 static void
 util_queue_kill_threads(struct util_queue *queue, unsigned keep_num_threads,
                         bool finish_locked)
@@ -474,7 +762,15 @@ util_queue_kill_threads(struct util_queue *queue, unsigned keep_num_threads,
       mtx_lock(&queue->finish_lock);
 
    if (keep_num_threads >= queue->num_threads) {
-      mtx_unlock(&queue->finish_lock);
+      if (!finish_locked)
+         mtx_unlock(&queue->finish_lock);
+      return;
+   }
+
+   if (util_queue_is_shared(queue)) {
+      util_queue_shared_kill_threads(queue, keep_num_threads);
+      if (!finish_locked)
+         mtx_unlock(&queue->finish_lock);
       return;
    }
 
@@ -516,10 +812,11 @@ util_queue_add_job(struct util_queue *queue,
                    util_queue_execute_func cleanup)
 {
    struct util_queue_job *ptr;
+   mtx_t *lock = util_queue_lock(queue);
 
-   mtx_lock(&queue->lock);
+   mtx_lock(lock);
    if (queue->num_threads == 0) {
-      mtx_unlock(&queue->lock);
+      mtx_unlock(lock);
       /* well no good option here, but any leaks will be
        * short-lived as things are shutting down..
        */
@@ -560,7 +857,7 @@ util_queue_add_job(struct util_queue *queue,
       } else {
          /* Wait until there is a free slot. */
          while (queue->num_queued == queue->max_jobs)
-            cnd_wait(&queue->has_space_cond, &queue->lock);
+            cnd_wait(&queue->has_space_cond, lock);
       }
    }
 
@@ -573,8 +870,11 @@ util_queue_add_job(struct util_queue *queue,
    queue->write_idx = (queue->write_idx + 1) % queue->max_jobs;
 
    queue->num_queued++;
-   cnd_signal(&queue->has_queued_cond);
-   mtx_unlock(&queue->lock);
+   if (util_queue_is_shared(queue))
+      util_queue_pool_make_ready(queue);
+   else
+      cnd_signal(&queue->has_queued_cond);
+   mtx_unlock(lock);
 }
 
 /**
@@ -595,7 +895,7 @@ util_queue_drop_job(struct util_queue *queue, struct util_queue_fence *fence)
    if (util_queue_fence_is_signalled(fence))
       return;
 
-   mtx_lock(&queue->lock);
+   mtx_lock(util_queue_lock(queue));
    for (unsigned i = queue->read_idx; i != queue->write_idx;
         i = (i + 1) % queue->max_jobs) {
       if (queue->jobs[i].fence == fence) {
@@ -608,7 +908,7 @@ util_queue_drop_job(struct util_queue *queue, struct util_queue_fence *fence)
          break;
       }
    }
-   mtx_unlock(&queue->lock);
+   mtx_unlock(util_queue_lock(queue));
 
    if (removed)
       util_queue_fence_signal(fence);
@@ -632,6 +932,17 @@ util_queue_finish(struct util_queue *queue)
    util_barrier barrier;
    struct util_queue_fence *fences;
 
+   /* The jobs of a shared queue may not all be able to run at once, so a
+    * barrier would deadlock.  Just wait for the queue to drain.
+    */
+   if (util_queue_is_shared(queue)) {
+      mtx_lock(&pool.lock);
+      while (queue->num_queued || queue->num_running)
+         cnd_wait(&queue->has_space_cond, &pool.lock);
+      mtx_unlock(&pool.lock);
+      return;
+   }
+
    /* If 2 threads were adding jobs for 2 different barries at the same time,
     * a deadlock would happen, because 1 barrier requires that all threads
     * wait for it exclusively.
@@ -660,8 +971,35 @@ int64_t
 util_queue_get_thread_time_nano(struct util_queue *queue, unsigned thread_index)
 {
    /* Allow some flexibility by not raising an error. */
-   if (thread_index >= queue->num_threads)
+   if (thread_index >= queue->num_threads || !queue->threads)
       return 0;
 
    return u_thread_get_time_nano(queue->threads[thread_index]);
 }
+
+int64_t
+util_queue_get_named_threads_time_nano(const char *name)
+{
+   struct util_queue *iter;
+   int64_t time = 0;
+
+   call_once(&atexit_once_flag, global_init);
+
+   mtx_lock(&exit_mutex);
+   LIST_FOR_EACH_ENTRY(iter, &queue_list, head) {
+      /* Skip the "process:" prefix added by util_queue_init. */
+      const char *queue_name = strrchr(iter->name, ':');
+      queue_name = queue_name ? queue_name + 1 : iter->name;
+
+      if (strncmp(queue_name, name, strlen(name)) != 0)
+         continue;
+
+      mtx_lock(&iter->finish_lock);
+      for (unsigned i = 0; iter->threads && i < iter->num_threads; i++)
+         time += u_thread_get_time_nano(iter->threads[i]);
+      mtx_unlock(&iter->finish_lock);
+   }
+   mtx_unlock(&exit_mutex);
+
+   return time;
+}
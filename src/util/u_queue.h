@@ -49,6 +49,20 @@ extern "C" {
 #define UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY      (1 << 0)
 #define UTIL_QUEUE_INIT_RESIZE_IF_FULL            (1 << 1)
 #define UTIL_QUEUE_INIT_SET_FULL_THREAD_AFFINITY  (1 << 2)
+/* Run the jobs on the process-wide thread pool shared by all such queues
+ * instead of threads of the queue's own.  num_threads is then the number of
+ * jobs of the queue that may run at the same time (at most 32), so a queue
+ * with 1 thread still executes its jobs one at a time, in order.  The
+ * thread_index passed to the callbacks stays below num_threads and is never
+ * used by two running jobs of the queue at once.
+ *
+ * The pool serves queues by priority class: UTIL_QUEUE_INIT_HIGH_PRIORITY
+ * for work something is about to wait for, UTIL_QUEUE_INIT_USE_MINIMUM_PRIORITY
+ * for background work, which never occupies more than half of the pool, and
+ * normal otherwise.  Queues of the same class take turns.
+ */
+#define UTIL_QUEUE_INIT_SHARED                    (1 << 3)
+#define UTIL_QUEUE_INIT_HIGH_PRIORITY             (1 << 4)
 
 #if defined(__GNUC__) && defined(HAVE_LINUX_FUTEX_H)
 #define UTIL_QUEUE_FENCE_FUTEX
@@ -216,6 +230,13 @@ struct util_queue {
 
    /* for cleanup at exit(), protected by exit_mutex */
    struct list_head head;
+
+   /* UTIL_QUEUE_INIT_SHARED only, protected by the pool lock */
+   unsigned priority;
+   unsigned num_running;
+   uint32_t busy_thread_indices;
+   bool in_pool;
+   struct list_head pool_link; /* in the pool's list of runnable queues */
 };
 
 bool util_queue_init(struct util_queue *queue,
@@ -246,11 +267,16 @@ util_queue_adjust_num_threads(struct util_queue *queue, unsigned num_threads);
 int64_t util_queue_get_thread_time_nano(struct util_queue *queue,
                                         unsigned thread_index);
 
+/* Return the CPU time used by all threads of all queues of the process
+ * whose name (without the process name) starts with "name".
+ */
+int64_t util_queue_get_named_threads_time_nano(const char *name);
+
 /* util_queue needs to be cleared to zeroes for this to work */
 static inline bool
 util_queue_is_initialized(struct util_queue *queue)
 {
-   return queue->threads != NULL;
+   return queue->jobs != NULL;
 }
 
 /* Convenient structure for monitoring the queue externally and passing
@@ -265,6 +291,18 @@ struct util_queue_monitoring
    unsigned num_offloaded_items;
    unsigned num_direct_items;
    unsigned num_syncs;
+
+   /* Batches submitted by the user of the queue, the number of them that
+    * were submitted because they were full (as opposed to flushed early),
+    * and the sum of their capacity in items.  The fill level of the batches
+    * is num_offloaded_items / num_offloaded_capacity.
+    */
+   unsigned num_batches;
+   unsigned num_full_batches;
+   unsigned num_offloaded_capacity;
+
+   /* The current batch capacity in items. */
+   unsigned batch_size;
 };
 
 #ifdef __cplusplus
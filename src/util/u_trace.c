@@ -0,0 +1,239 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include "c11/threads.h"
+#include "debug.h"
+#include "list.h"
+#include "os_time.h"
+#include "u_trace.h"
+
+struct u_trace_event {
+   const char *name;
+   int64_t ts_ns;
+   int64_t dur_ns;
+   char phase;
+};
+
+/* Ring of the last events of one thread.  Only the owning thread writes to
+ * it, and it lives until the end of the process so that the events of
+ * threads which have exited still get written out.
+ */
+struct u_trace_thread {
+   struct list_head link;
+   unsigned tid;
+   char name[32];
+   uint64_t count;
+   struct u_trace_event events[];
+};
+
+int u_trace_state = U_TRACE_UNKNOWN;
+
+static once_flag u_trace_once = ONCE_FLAG_INIT;
+static mtx_t u_trace_mutex;
+static tss_t u_trace_key;
+static struct list_head u_trace_threads;
+static unsigned u_trace_num_threads;
+static unsigned u_trace_ring_size;
+static char *u_trace_file;
+
+static void
+u_trace_init_once(void)
+{
+   const char *file = getenv("MESA_TRACE_FILE");
+
+   if (!file || !*file) {
+      u_trace_state = U_TRACE_OFF;
+      return;
+   }
+
+   u_trace_file = strdup(file);
+   u_trace_ring_size = MAX2(env_var_as_unsigned("MESA_TRACE_EVENTS", 65536), 1);
+   mtx_init(&u_trace_mutex, mtx_plain);
+   tss_create(&u_trace_key, NULL);
+   list_inithead(&u_trace_threads);
+   atexit(u_trace_flush);
+
+   u_trace_state = U_TRACE_ON;
+}
+
+bool
+u_trace_init(void)
+{
+   call_once(&u_trace_once, u_trace_init_once);
+   return u_trace_state == U_TRACE_ON;
+}
+
+static struct u_trace_thread *
+u_trace_get_thread(void)
+{
+   struct u_trace_thread *thread = tss_get(u_trace_key);
+
+   if (likely(thread))
+      return thread;
+
+   thread = calloc(1, sizeof(*thread) +
+                      u_trace_ring_size * sizeof(thread->events[0]));
+   if (!thread)
+      return NULL;
+
+   mtx_lock(&u_trace_mutex);
+   thread->tid = ++u_trace_num_threads;
+   list_addtail(&thread->link, &u_trace_threads);
+   mtx_unlock(&u_trace_mutex);
+
+   tss_set(u_trace_key, thread);
+   return thread;
+}
+
+static void
+u_trace_record(const char *name, char phase, int64_t ts_ns, int64_t dur_ns)
+{
+   struct u_trace_thread *thread = u_trace_get_thread();
+   struct u_trace_event *event;
+
+   if (!thread)
+      return;
+
+   event = &thread->events[thread->count % u_trace_ring_size];
+   event->name = name;
+   event->ts_ns = ts_ns;
+   event->dur_ns = dur_ns;
+   event->phase = phase;
+   thread->count++;
+}
+
+void
+u_trace_begin(const char *name)
+{
+   u_trace_record(name, 'B', os_time_get_nano(), 0);
+}
+
+void
+u_trace_end(void)
+{
+   u_trace_record(NULL, 'E', os_time_get_nano(), 0);
+}
+
+void
+u_trace_complete(const char *name, int64_t start_ns)
+{
+   u_trace_record(name, 'X', start_ns, os_time_get_nano() - start_ns);
+}
+
+int64_t
+u_trace_timestamp(void)
+{
+   return os_time_get_nano();
+}
+
+void
+u_trace_set_thread_name(const char *name)
+{
+   struct u_trace_thread *thread;
+
+   if (!u_trace_enabled())
+      return;
+
+   thread = u_trace_get_thread();
+   if (thread) {
+      strncpy(thread->name, name, sizeof(thread->name) - 1);
+      thread->name[sizeof(thread->name) - 1] = 0;
+   }
+}
+
+static void
+u_trace_write_string(FILE *f, const char *s)
+{
+   fputc('"', f);
+   for (; *s; s++) {
+      if (*s == '"' || *s == '\\')
+         fputc('\\', f);
+      fputc(*s, f);
+   }
+   fputc('"', f);
+}
+
+void
+u_trace_flush(void)
+{
+   int pid = getpid();
+   bool first = true;
+   FILE *f;
+
+   if (u_trace_state != U_TRACE_ON)
+      return;
+
+   f = fopen(u_trace_file, "w");
+   if (!f) {
+      fprintf(stderr, "Mesa: can't open trace file %s\n", u_trace_file);
+      return;
+   }
+
+   fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+   mtx_lock(&u_trace_mutex);
+   list_for_each_entry(struct u_trace_thread, thread, &u_trace_threads, link) {
+      uint64_t count = thread->count;
+      uint64_t i = count > u_trace_ring_size ? count - u_trace_ring_size : 0;
+
+      if (thread->name[0]) {
+         fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                 "\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n",
+                 pid, thread->tid);
+         u_trace_write_string(f, thread->name);
+         fprintf(f, "}}");
+         first = false;
+      }
+
+      for (; i < count; i++) {
+         const struct u_trace_event *event =
+            &thread->events[i % u_trace_ring_size];
+
+         fprintf(f, "%s{\"ph\":\"%c\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f",
+                 first ? "" : ",\n", event->phase, pid, thread->tid,
+                 event->ts_ns / 1000.0);
+         if (event->name) {
+            fprintf(f, ",\"name\":");
+            u_trace_write_string(f, event->name);
+         }
+         if (event->phase == 'X')
+            fprintf(f, ",\"dur\":%.3f", event->dur_ns / 1000.0);
+         fprintf(f, "}");
+         first = false;
+      }
+   }
+   mtx_unlock(&u_trace_mutex);
+
+   fprintf(f, "\n]}\n");
+   fclose(f);
+}
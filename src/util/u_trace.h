@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/**
+ * CPU timeline tracing.
+ *
+ * Code marks spans of CPU work with
+ *
+ *    MESA_TRACE_BEGIN("name");
+ *    ...
+ *    MESA_TRACE_END();
+ *
+ * or, for a span lasting until the end of the enclosing block,
+ * MESA_TRACE_SCOPE("name") and MESA_TRACE_FUNC().  Names must be string
+ * literals, or at least outlive the process.
+ *
+ * Tracing is enabled by setting MESA_TRACE_FILE to a file name.  Spans are
+ * then recorded into a ring buffer per thread, which only keeps the last
+ * MESA_TRACE_EVENTS (default 65536) events of each thread, and the rings
+ * are written out at exit in the JSON trace event format Perfetto and
+ * chrome://tracing load.  Threads named with u_thread_setname(), such as
+ * util_queue workers, show up under their name.
+ *
+ * When tracing is disabled, each macro costs one load and a branch which
+ * is never taken.
+ */
+
+#ifndef U_TRACE_H
+#define U_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "macros.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum u_trace_state {
+   U_TRACE_UNKNOWN = -1,
+   U_TRACE_OFF = 0,
+   U_TRACE_ON = 1,
+};
+
+extern int u_trace_state;
+
+/* Reads the environment the first time it's called */
+bool
+u_trace_init(void);
+
+static inline bool
+u_trace_enabled(void)
+{
+   if (likely(u_trace_state == U_TRACE_OFF))
+      return false;
+   return u_trace_state == U_TRACE_ON || u_trace_init();
+}
+
+void
+u_trace_begin(const char *name);
+
+void
+u_trace_end(void);
+
+void
+u_trace_complete(const char *name, int64_t start_ns);
+
+/* Timestamp for u_trace_complete(), 0 when tracing is disabled */
+int64_t
+u_trace_timestamp(void);
+
+void
+u_trace_set_thread_name(const char *name);
+
+/* Write out everything recorded so far */
+void
+u_trace_flush(void);
+
+#define MESA_TRACE_BEGIN(name) \
+   do { if (u_trace_enabled()) u_trace_begin(name); } while (0)
+
+#define MESA_TRACE_END() \
+   do { if (u_trace_enabled()) u_trace_end(); } while (0)
+
+#if defined(__GNUC__) && !defined(__cplusplus)
+
+struct u_trace_scope {
+   const char *name;
+   int64_t start_ns;
+};
+
+static inline void
+u_trace_scope_end(struct u_trace_scope *scope)
+{
+   if (scope->start_ns)
+      u_trace_complete(scope->name, scope->start_ns);
+}
+
+#define MESA_TRACE_CONCAT2(a, b) a ## b
+#define MESA_TRACE_CONCAT(a, b) MESA_TRACE_CONCAT2(a, b)
+
+#define MESA_TRACE_SCOPE(name) \
+   struct u_trace_scope MESA_TRACE_CONCAT(_u_trace_scope_, __LINE__) \
+      __attribute__((cleanup(u_trace_scope_end))) = \
+      { (name), u_trace_enabled() ? u_trace_timestamp() : 0 }
+
+#elif defined(__cplusplus)
+
+struct u_trace_scope {
+   const char *name;
+   int64_t start_ns;
+
+   u_trace_scope(const char *name) :
+      name(name), start_ns(u_trace_enabled() ? u_trace_timestamp() : 0) {}
+
+   ~u_trace_scope()
+   {
+      if (start_ns)
+         u_trace_complete(name, start_ns);
+   }
+};
+
+#define MESA_TRACE_CONCAT2(a, b) a ## b
+#define MESA_TRACE_CONCAT(a, b) MESA_TRACE_CONCAT2(a, b)
+
+#define MESA_TRACE_SCOPE(name) \
+   u_trace_scope MESA_TRACE_CONCAT(_u_trace_scope_, __LINE__)(name)
+
+#else
+
+/* Without cleanup attributes, scopes aren't traced */
+#define MESA_TRACE_SCOPE(name) do { } while (0)
+
+#endif
+
+#define MESA_TRACE_FUNC() MESA_TRACE_SCOPE(__func__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* U_TRACE_H */
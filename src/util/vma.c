@@ -26,58 +26,169 @@
 #include "util/u_math.h"
 #include "util/vma.h"
 
+/* Holes are kept in two red-black trees: one ordered by address, to find
+ * the neighbours of a freed range, and one ordered by size (then address),
+ * to find the best fitting hole for an allocation.  Both take O(log n) in
+ * the number of holes.
+ */
 struct util_vma_hole {
-   struct list_head link;
+   struct rb_node addr_node;
+   struct rb_node size_node;
    uint64_t offset;
    uint64_t size;
 };
 
+#define util_vma_hole_from_addr_node(_node) \
+   rb_node_data(struct util_vma_hole, _node, addr_node)
+
+#define util_vma_hole_from_size_node(_node) \
+   rb_node_data(struct util_vma_hole, _node, size_node)
+
 #define util_vma_foreach_hole(_hole, _heap) \
-   list_for_each_entry(struct util_vma_hole, _hole, &(_heap)->holes, link)
+   rb_tree_foreach(struct util_vma_hole, _hole, &(_heap)->holes_by_addr, \
+                   addr_node)
+
+static int
+util_vma_hole_addr_cmp(const struct rb_node *a, const struct rb_node *b)
+{
+   const struct util_vma_hole *ha = util_vma_hole_from_addr_node(a);
+   const struct util_vma_hole *hb = util_vma_hole_from_addr_node(b);
+
+   return ha->offset < hb->offset ? -1 : ha->offset > hb->offset;
+}
+
+static int
+util_vma_hole_size_cmp(const struct rb_node *a, const struct rb_node *b)
+{
+   const struct util_vma_hole *ha = util_vma_hole_from_size_node(a);
+   const struct util_vma_hole *hb = util_vma_hole_from_size_node(b);
+
+   if (ha->size != hb->size)
+      return ha->size < hb->size ? -1 : 1;
+
+   /* Of the holes of a size, prefer the highest one */
+   return ha->offset > hb->offset ? -1 : ha->offset < hb->offset;
+}
+
+static void
+util_vma_hole_insert(struct util_vma_heap *heap, struct util_vma_hole *hole)
+{
+   rb_tree_insert(&heap->holes_by_addr, &hole->addr_node,
+                  util_vma_hole_addr_cmp);
+   rb_tree_insert(&heap->holes_by_size, &hole->size_node,
+                  util_vma_hole_size_cmp);
+}
+
+static void
+util_vma_hole_remove(struct util_vma_heap *heap, struct util_vma_hole *hole)
+{
+   rb_tree_remove(&heap->holes_by_addr, &hole->addr_node);
+   rb_tree_remove(&heap->holes_by_size, &hole->size_node);
+   free(hole);
+}
+
+/* Change the range of a hole without moving it past another hole, which
+ * keeps its place in the address tree.
+ */
+static void
+util_vma_hole_resize(struct util_vma_heap *heap, struct util_vma_hole *hole,
+                     uint64_t offset, uint64_t size)
+{
+   rb_tree_remove(&heap->holes_by_size, &hole->size_node);
+   hole->offset = offset;
+   hole->size = size;
+   rb_tree_insert(&heap->holes_by_size, &hole->size_node,
+                  util_vma_hole_size_cmp);
+}
+
+/* The smallest hole of at least the given size */
+static struct util_vma_hole *
+util_vma_find_hole_by_size(struct util_vma_heap *heap, uint64_t size)
+{
+   struct rb_node *node = heap->holes_by_size.root;
+   struct rb_node *best = NULL;
+
+   while (node) {
+      if (util_vma_hole_from_size_node(node)->size >= size) {
+         best = node;
+         node = node->left;
+      } else {
+         node = node->right;
+      }
+   }
+
+   return best ? util_vma_hole_from_size_node(best) : NULL;
+}
+
+static struct util_vma_hole *
+util_vma_next_hole_by_size(struct util_vma_hole *hole)
+{
+   struct rb_node *next = rb_node_next(&hole->size_node);
+
+   return next ? util_vma_hole_from_size_node(next) : NULL;
+}
 
-#define util_vma_foreach_hole_safe(_hole, _heap) \
-   list_for_each_entry_safe(struct util_vma_hole, _hole, &(_heap)->holes, link)
+/* The highest hole starting at or below the given offset */
+static struct util_vma_hole *
+util_vma_find_hole_below(struct util_vma_heap *heap, uint64_t offset)
+{
+   struct rb_node *node = heap->holes_by_addr.root;
+   struct rb_node *best = NULL;
+
+   while (node) {
+      if (util_vma_hole_from_addr_node(node)->offset <= offset) {
+         best = node;
+         node = node->right;
+      } else {
+         node = node->left;
+      }
+   }
+
+   return best ? util_vma_hole_from_addr_node(best) : NULL;
+}
 
 void
 util_vma_heap_init(struct util_vma_heap *heap,
                    uint64_t start, uint64_t size)
 {
-   list_inithead(&heap->holes);
+   rb_tree_init(&heap->holes_by_addr);
+   rb_tree_init(&heap->holes_by_size);
    util_vma_heap_free(heap, start, size);
 }
 
 void
 util_vma_heap_finish(struct util_vma_heap *heap)
 {
-   util_vma_foreach_hole_safe(hole, heap)
-      free(hole);
+   struct rb_node *node;
+
+   while ((node = rb_tree_first(&heap->holes_by_addr)))
+      util_vma_hole_remove(heap, util_vma_hole_from_addr_node(node));
 }
 
 #ifndef NDEBUG
 static void
 util_vma_heap_validate(struct util_vma_heap *heap)
 {
-   uint64_t prev_offset = 0;
+   struct util_vma_hole *prev = NULL;
    util_vma_foreach_hole(hole, heap) {
       assert(hole->offset > 0);
       assert(hole->size > 0);
 
-      if (&hole->link == heap->holes.next) {
-         /* This must be the top-most hole.  Assert that, if it overflows, it
-          * overflows to 0, i.e. 2^64.
-          */
-         assert(hole->size + hole->offset == 0 ||
-                hole->size + hole->offset > hole->offset);
-      } else {
-         /* This is not the top-most hole so it must not overflow and, in
-          * fact, must be strictly lower than the top-most hole.  If
-          * hole->size + hole->offset == prev_offset, then we failed to join
-          * holes during a util_vma_heap_free.
+      if (prev) {
+         /* The previous hole is lower, so it must not overflow and must end
+          * strictly below this hole.  If it ends right at this hole, we
+          * failed to join holes during a util_vma_heap_free.
           */
-         assert(hole->size + hole->offset > hole->offset &&
-                hole->size + hole->offset < prev_offset);
+         assert(prev->size + prev->offset > prev->offset &&
+                prev->size + prev->offset < hole->offset);
       }
-      prev_offset = hole->offset;
+      prev = hole;
+   }
+
+   /* The top-most hole may only overflow to 0, i.e. 2^64. */
+   if (prev) {
+      assert(prev->size + prev->offset == 0 ||
+             prev->size + prev->offset > prev->offset);
    }
 }
 #else
@@ -94,10 +205,11 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
 
    util_vma_heap_validate(heap);
 
-   util_vma_foreach_hole_safe(hole, heap) {
-      if (size > hole->size)
-         continue;
-
+   /* Best fit: start with the smallest hole which is big enough and move up
+    * to bigger ones only if alignment gets in the way.
+    */
+   for (struct util_vma_hole *hole = util_vma_find_hole_by_size(heap, size);
+        hole; hole = util_vma_next_hole_by_size(hole)) {
       /* Compute the offset as the highest address where a chunk of the given
        * size can be without going over the top of the hole.
        *
@@ -116,8 +228,7 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
 
       if (offset == hole->offset && size == hole->size) {
          /* Just get rid of the hole. */
-         list_del(&hole->link);
-         free(hole);
+         util_vma_hole_remove(heap, hole);
          util_vma_heap_validate(heap);
          return offset;
       }
@@ -126,15 +237,15 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
       uint64_t waste = (hole->size - size) - (offset - hole->offset);
       if (waste == 0) {
          /* We allocated at the top.  Shrink the hole down. */
-         hole->size -= size;
+         util_vma_hole_resize(heap, hole, hole->offset, hole->size - size);
          util_vma_heap_validate(heap);
          return offset;
       }
 
       if (offset == hole->offset) {
          /* We allocated at the bottom. Shrink the hole up. */
-         hole->offset += size;
-         hole->size -= size;
+         util_vma_hole_resize(heap, hole, hole->offset + size,
+                              hole->size - size);
          util_vma_heap_validate(heap);
          return offset;
       }
@@ -149,12 +260,8 @@ util_vma_heap_alloc(struct util_vma_heap *heap,
       /* Adjust the hole to be the amount of space left at he bottom of the
        * original hole.
        */
-      hole->size = offset - hole->offset;
-
-      /* Place the new hole before the old hole so that the list is in order
-       * from high to low.
-       */
-      list_addtail(&high_hole->link, &hole->link);
+      util_vma_hole_resize(heap, hole, hole->offset, offset - hole->offset);
+      util_vma_hole_insert(heap, high_hole);
 
       util_vma_heap_validate(heap);
 
@@ -185,14 +292,16 @@ util_vma_heap_free(struct util_vma_heap *heap,
    util_vma_heap_validate(heap);
 
    /* Find immediately higher and lower holes if they exist. */
-   struct util_vma_hole *high_hole = NULL, *low_hole = NULL;
-   util_vma_foreach_hole(hole, heap) {
-      if (hole->offset <= offset) {
-         low_hole = hole;
-         break;
-      }
-      high_hole = hole;
-   }
+   struct util_vma_hole *high_hole = NULL, *low_hole;
+   struct rb_node *high_node;
+
+   low_hole = util_vma_find_hole_below(heap, offset);
+   if (low_hole)
+      high_node = rb_node_next(&low_hole->addr_node);
+   else
+      high_node = rb_tree_first(&heap->holes_by_addr);
+   if (high_node)
+      high_hole = util_vma_hole_from_addr_node(high_node);
 
    if (high_hole)
       assert(offset + size <= high_hole->offset);
@@ -206,16 +315,17 @@ util_vma_heap_free(struct util_vma_heap *heap,
 
    if (low_adjacent && high_adjacent) {
       /* Merge the two holes */
-      low_hole->size += size + high_hole->size;
-      list_del(&high_hole->link);
-      free(high_hole);
+      uint64_t high_size = high_hole->size;
+      util_vma_hole_remove(heap, high_hole);
+      util_vma_hole_resize(heap, low_hole, low_hole->offset,
+                           low_hole->size + size + high_size);
    } else if (low_adjacent) {
       /* Merge into the low hole */
-      low_hole->size += size;
+      util_vma_hole_resize(heap, low_hole, low_hole->offset,
+                           low_hole->size + size);
    } else if (high_adjacent) {
       /* Merge into the high hole */
-      high_hole->offset = offset;
-      high_hole->size += size;
+      util_vma_hole_resize(heap, high_hole, offset, high_hole->size + size);
    } else {
       /* Neither hole is adjacent; make a new one */
       struct util_vma_hole *hole = calloc(1, sizeof(*hole));
@@ -223,11 +333,7 @@ util_vma_heap_free(struct util_vma_heap *heap,
       hole->offset = offset;
       hole->size = size;
 
-      /* Add it after the high hole so we maintain high-to-low ordering */
-      if (high_hole)
-         list_add(&hole->link, &high_hole->link);
-      else
-         list_add(&hole->link, &heap->holes);
+      util_vma_hole_insert(heap, hole);
    }
 
    util_vma_heap_validate(heap);
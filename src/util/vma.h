@@ -26,14 +26,16 @@
 
 #include <stdint.h>
 
-#include "list.h"
+#include "rb_tree.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct util_vma_heap {
-   struct list_head holes;
+   /* Free holes, indexed by address and by size */
+   struct rb_tree holes_by_addr;
+   struct rb_tree holes_by_size;
 };
 
 void util_vma_heap_init(struct util_vma_heap *heap,
@@ -39,7 +39,11 @@
 #include <errno.h>
 #include <dirent.h>
 #include <fnmatch.h>
+#include <sys/stat.h>
 #include "xmlconfig.h"
+#include "debug.h"
+#include "mesa-sha1.h"
+#include "u_dynarray.h"
 #include "u_process.h"
 
 /* For systems like Hurd */
@@ -702,6 +706,9 @@ struct OptConfData {
     uint32_t inDevice;
     uint32_t inApp;
     uint32_t inOption;
+    /* Matching option assignments as "name\0value\0" pairs, recorded for
+     * the parsed config cache.  NULL if not recording. */
+    struct util_dynarray *record;
 };
 
 /** \brief Elements in configuration files. */
@@ -755,6 +762,26 @@ parseAppAttr(struct OptConfData *data, const XML_Char **attr)
         data->ignoringApp = data->inApp;
 }
 
+/** \brief Set an option from a configuration file.
+ *
+ * Returns false if the value is illegal. */
+static bool
+setOptionValue(driOptionCache *cache, const char *name, const char *value)
+{
+    uint32_t opt = findOption (cache, name);
+    if (cache->info[opt].name == NULL)
+        /* don't warn, drirc defines options for all drivers,
+         * but not all drivers support them */
+        return true;
+    else if (getenv (cache->info[opt].name)) {
+        /* don't use XML_WARNING, we want the user to see this! */
+        fprintf (stderr, "ATTENTION: option value of option %s ignored.\n",
+                 cache->info[opt].name);
+        return true;
+    }
+    return parseValue (&cache->values[opt], cache->info[opt].type, value);
+}
+
 /** \brief Parse attributes of an option element. */
 static void
 parseOptConfAttr(struct OptConfData *data, const XML_Char **attr)
@@ -769,17 +796,13 @@ parseOptConfAttr(struct OptConfData *data, const XML_Char **attr)
     if (!name) XML_WARNING1 ("name attribute missing in option.");
     if (!value) XML_WARNING1 ("value attribute missing in option.");
     if (name && value) {
-        driOptionCache *cache = data->cache;
-        uint32_t opt = findOption (cache, name);
-        if (cache->info[opt].name == NULL)
-            /* don't use XML_WARNING, drirc defines options for all drivers,
-             * but not all drivers support them */
-            return;
-        else if (getenv (cache->info[opt].name))
-          /* don't use XML_WARNING, we want the user to see this! */
-            fprintf (stderr, "ATTENTION: option value of option %s ignored.\n",
-                     cache->info[opt].name);
-        else if (!parseValue (&cache->values[opt], cache->info[opt].type, value))
+        if (data->record) {
+            size_t name_len = strlen (name) + 1, value_len = strlen (value) + 1;
+            char *rec = util_dynarray_grow (data->record, name_len + value_len);
+            memcpy (rec, name, name_len);
+            memcpy (rec + name_len, value, value_len);
+        }
+        if (!setOptionValue (data->cache, name, value))
             XML_WARNING ("illegal option value: %s.", value);
     }
 }
@@ -959,9 +982,9 @@ scandir_filter(const struct dirent *ent)
     return 1;
 }
 
-/** \brief Parse configuration files in a directory */
+/** \brief List the configuration files of a directory */
 static void
-parseConfigDir(struct OptConfData *data, const char *dirname)
+listConfigDir(struct util_dynarray *files, const char *dirname)
 {
     int i, count;
     struct dirent **entries = NULL;
@@ -976,7 +999,7 @@ parseConfigDir(struct OptConfData *data, const char *dirname)
         snprintf(filename, PATH_MAX, "%s/%s", dirname, entries[i]->d_name);
         free(entries[i]);
 
-        parseOneConfigFile(data, filename);
+        util_dynarray_append(files, char *, strdup(filename));
     }
 
     free(entries);
@@ -990,6 +1013,168 @@ parseConfigDir(struct OptConfData *data, const char *dirname)
 #define DATADIR "/usr/share"
 #endif
 
+/*
+ * Parsed configuration cache.
+ *
+ * Parsing the configuration files with expat is by far the most expensive
+ * part of driParseConfigFiles.  Its only result is the list of option
+ * assignments that apply to this driver, screen and executable, so that
+ * list is stored in a small file under $XDG_CACHE_HOME/mesa_driconf, named
+ * after those parameters.  The file also stores a hash of the path, size,
+ * inode and mtime of every configuration file: when any of them changes,
+ * the files are parsed again and the cache rewritten.
+ *
+ * Cached assignments are applied with the same setOptionValue as parsed
+ * ones, so environment overrides and unsupported options behave the same.
+ * Set MESA_DRICONF_CACHE_DISABLE to always parse the files.
+ */
+#define CONF_CACHE_MAGIC "MESADRC1"
+
+struct ConfCacheHeader {
+    char magic[8];
+    unsigned char stamp[20];
+    uint32_t size;
+};
+
+static char *
+confCacheDir(void)
+{
+    char *xdg_cache_home = getenv("XDG_CACHE_HOME");
+    char *home = getenv("HOME");
+    char path[PATH_MAX];
+
+    if (xdg_cache_home && xdg_cache_home[0]) {
+        snprintf(path, PATH_MAX, "%s/mesa_driconf", xdg_cache_home);
+    } else if (home && home[0]) {
+        snprintf(path, PATH_MAX, "%s/.cache", home);
+        mkdir(path, 0755);
+        snprintf(path, PATH_MAX, "%s/.cache/mesa_driconf", home);
+    } else {
+        return NULL;
+    }
+
+    if (mkdir(path, 0755) == -1 && errno != EEXIST)
+        return NULL;
+
+    return strdup(path);
+}
+
+static void
+confCacheStamp(const struct util_dynarray *files, unsigned char stamp[20])
+{
+    struct mesa_sha1 ctx;
+
+    _mesa_sha1_init(&ctx);
+    util_dynarray_foreach(files, char *, filename) {
+        struct stat st;
+        uint64_t id[4] = { 0, };
+
+        if (stat(*filename, &st) == 0) {
+            id[0] = st.st_size;
+            id[1] = st.st_ino;
+            id[2] = st.st_mtim.tv_sec;
+            id[3] = st.st_mtim.tv_nsec;
+        }
+        _mesa_sha1_update(&ctx, *filename, strlen(*filename) + 1);
+        _mesa_sha1_update(&ctx, id, sizeof(id));
+    }
+    _mesa_sha1_final(&ctx, stamp);
+}
+
+static void
+confCachePath(char *path, const char *dir, const struct OptConfData *data)
+{
+    struct mesa_sha1 ctx;
+    unsigned char sha1[20];
+    char sha1_str[41];
+
+    _mesa_sha1_init(&ctx);
+    _mesa_sha1_update(&ctx, data->driverName, strlen(data->driverName) + 1);
+    if (data->kernelDriverName)
+        _mesa_sha1_update(&ctx, data->kernelDriverName,
+                          strlen(data->kernelDriverName) + 1);
+    _mesa_sha1_update(&ctx, &data->screenNum, sizeof(data->screenNum));
+    _mesa_sha1_update(&ctx, data->execName, strlen(data->execName) + 1);
+    _mesa_sha1_final(&ctx, sha1);
+    _mesa_sha1_format(sha1_str, sha1);
+
+    snprintf(path, PATH_MAX, "%s/%s", dir, sha1_str);
+}
+
+/** \brief Apply the cached assignments, returns false on a miss */
+static bool
+confCacheApply(driOptionCache *cache, const char *path,
+               const unsigned char stamp[20])
+{
+    struct ConfCacheHeader header;
+    struct stat st;
+    char *values;
+    bool ok = false;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) == -1)
+        return false;
+
+    if (fstat(fd, &st) == -1 ||
+        read(fd, &header, sizeof(header)) != sizeof(header) ||
+        memcmp(header.magic, CONF_CACHE_MAGIC, sizeof(header.magic)) ||
+        memcmp(header.stamp, stamp, sizeof(header.stamp)) ||
+        header.size != st.st_size - sizeof(header)) {
+        close(fd);
+        return false;
+    }
+
+    values = malloc(header.size + 1);
+    if (values && read(fd, values, header.size) == header.size &&
+        (header.size == 0 || values[header.size - 1] == '\0')) {
+        const char *name = values, *end = values + header.size;
+
+        /* A trailing name without a value is ignored */
+        while (name < end) {
+            const char *value = name + strlen(name) + 1;
+            if (value >= end)
+                break;
+            if (!setOptionValue(cache, name, value))
+                __driUtilMessage("Illegal value %s of option %s in %s.",
+                                 value, name, path);
+            name = value + strlen(value) + 1;
+        }
+        ok = true;
+    }
+
+    free(values);
+    close(fd);
+    return ok;
+}
+
+static void
+confCacheWrite(const char *path, const unsigned char stamp[20],
+               const struct util_dynarray *record)
+{
+    struct ConfCacheHeader header;
+    char tmp[PATH_MAX];
+    bool ok;
+    int fd;
+
+    memcpy(header.magic, CONF_CACHE_MAGIC, sizeof(header.magic));
+    memcpy(header.stamp, stamp, sizeof(header.stamp));
+    header.size = record->size;
+
+    /* Write a private file and rename it, so that concurrent readers only
+     * ever see complete files.
+     */
+    snprintf(tmp, PATH_MAX, "%s.%d", path, (int)getpid());
+    if ((fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) == -1)
+        return;
+
+    ok = write(fd, &header, sizeof(header)) == sizeof(header) &&
+         write(fd, record->data, record->size) == record->size;
+    close(fd);
+
+    if (!ok || rename(tmp, path) == -1)
+        unlink(tmp);
+}
+
 void
 driParseConfigFiles(driOptionCache *cache, const driOptionCache *info,
                     int screenNum, const char *driverName,
@@ -997,6 +1182,10 @@ driParseConfigFiles(driOptionCache *cache, const driOptionCache *info,
 {
     char *home;
     struct OptConfData userData;
+    struct util_dynarray files, record;
+    char *cache_dir = NULL;
+    char cache_path[PATH_MAX];
+    unsigned char stamp[20];
 
     initOptionCache (cache, info);
 
@@ -1005,16 +1194,48 @@ driParseConfigFiles(driOptionCache *cache, const driOptionCache *info,
     userData.driverName = driverName;
     userData.kernelDriverName = kernelDriverName;
     userData.execName = util_get_process_name();
+    userData.record = NULL;
 
-    parseConfigDir(&userData, DATADIR "/drirc.d");
-    parseOneConfigFile(&userData, SYSCONFDIR "/drirc");
+    util_dynarray_init(&files, NULL);
+    listConfigDir(&files, DATADIR "/drirc.d");
+    util_dynarray_append(&files, char *, strdup(SYSCONFDIR "/drirc"));
 
     if ((home = getenv ("HOME"))) {
         char filename[PATH_MAX];
 
         snprintf(filename, PATH_MAX, "%s/.drirc", home);
-        parseOneConfigFile(&userData, filename);
+        util_dynarray_append(&files, char *, strdup(filename));
     }
+
+    /* Don't let setuid processes write to the user's cache */
+    if (geteuid() == getuid() &&
+        !env_var_as_boolean("MESA_DRICONF_CACHE_DISABLE", false))
+        cache_dir = confCacheDir();
+
+    if (cache_dir) {
+        confCacheStamp(&files, stamp);
+        confCachePath(cache_path, cache_dir, &userData);
+
+        if (confCacheApply(cache, cache_path, stamp))
+            goto done;
+
+        util_dynarray_init(&record, NULL);
+        userData.record = &record;
+    }
+
+    util_dynarray_foreach(&files, char *, filename)
+        parseOneConfigFile(&userData, *filename);
+
+    if (cache_dir) {
+        confCacheWrite(cache_path, stamp, &record);
+        util_dynarray_fini(&record);
+    }
+
+done:
+    free(cache_dir);
+    util_dynarray_foreach(&files, char *, filename)
+        free(*filename);
+    util_dynarray_fini(&files);
 }
 
 void
@@ -31,6 +31,7 @@
 #include "imgui.h"
 
 #include "overlay_params.h"
+#include "overlay_trace.h"
 
 #include "util/debug.h"
 #include "util/hash_table.h"
@@ -50,6 +51,8 @@ struct instance_data {
    struct overlay_params params;
    bool pipeline_statistics_enabled;
 
+   struct overlay_trace *trace;
+
    bool first_line_printed;
 };
 
@@ -57,6 +60,45 @@ struct frame_stat {
    uint64_t stats[OVERLAY_PARAM_ENABLED_MAX];
 };
 
+/* Render passes and dispatches timed per command buffer with gpu_passes */
+#define OVERLAY_MAX_PASSES 64
+
+/* Number of frames to wait before reading back per pass timestamps, so that
+ * we don't have to wait for the GPU.
+ */
+#define OVERLAY_PASS_LATENCY 3
+
+enum overlay_pass_type {
+   OVERLAY_PASS_RENDER,
+   OVERLAY_PASS_DISPATCH,
+};
+
+struct overlay_pass {
+   enum overlay_pass_type type;
+   VkExtent2D extent; /* Render area of render passes */
+   uint64_t duration; /* ns, once read back */
+};
+
+/* Timestamps written around the render passes and dispatches of one
+ * recording of a primary command buffer, a pair of queries per pass.
+ */
+struct pass_queries {
+   struct list_head link; /* device_data::free/pending_pass_queries */
+   struct list_head all_link; /* device_data::all_pass_queries */
+
+   VkQueryPool pool;
+   uint32_t n_passes;
+   struct overlay_pass passes[OVERLAY_MAX_PASSES];
+
+   uint64_t submit_frame;
+   uint64_t timestamp_mask;
+
+   /* Submitted and waiting for read back */
+   bool pending;
+   /* The command buffer is done with it, recycle it after read back */
+   bool retired;
+};
+
 /* Mapped from VkDevice */
 struct queue_data;
 struct device_data {
@@ -77,6 +119,19 @@ struct device_data {
 
    /* For a single frame */
    struct frame_stat frame_stats;
+
+   uint64_t n_frames;
+
+   /* gpu_passes */
+   simple_mtx_t pass_queries_mutex;
+   struct list_head all_pass_queries;
+   struct list_head free_pass_queries;
+   struct list_head pending_pass_queries;
+
+   /* Passes of the last frame read back */
+   uint64_t passes_frame;
+   uint32_t n_passes;
+   struct overlay_pass passes[OVERLAY_MAX_PASSES];
 };
 
 /* Mapped from VkCommandBuffer */
@@ -90,6 +145,8 @@ struct command_buffer_data {
    VkQueryPool timestamp_query_pool;
    uint32_t query_index;
 
+   struct pass_queries *pass_queries;
+
    struct frame_stat stats;
 
    struct list_head link; /* link into queue_data::running_command_buffer */
@@ -330,6 +387,10 @@ static void destroy_instance_data(struct instance_data *data)
 {
    if (data->params.output_file)
       fclose(data->params.output_file);
+   if (data->trace)
+      overlay_trace_destroy(data->trace);
+   if (data->params.trace_file)
+      fclose(data->params.trace_file);
    unmap_object(HKEY(data->instance));
    ralloc_free(data);
 }
@@ -363,6 +424,10 @@ static struct device_data *new_device_data(VkDevice device, struct instance_data
    struct device_data *data = rzalloc(NULL, struct device_data);
    data->instance = instance;
    data->device = device;
+   simple_mtx_init(&data->pass_queries_mutex, mtx_plain);
+   list_inithead(&data->all_pass_queries);
+   list_inithead(&data->free_pass_queries);
+   list_inithead(&data->pending_pass_queries);
    map_object(HKEY(data->device), data);
    return data;
 }
@@ -448,8 +513,15 @@ static void device_unmap_queues(struct device_data *data)
       destroy_queue(data->queues[i]);
 }
 
+static void destroy_device_pass_queries(struct device_data *data)
+{
+   list_for_each_entry(struct pass_queries, queries, &data->all_pass_queries, all_link)
+      data->vtable.DestroyQueryPool(data->device, queries->pool, NULL);
+}
+
 static void destroy_device_data(struct device_data *data)
 {
+   simple_mtx_destroy(&data->pass_queries_mutex);
    unmap_object(HKEY(data->device));
    ralloc_free(data);
 }
@@ -474,8 +546,139 @@ static struct command_buffer_data *new_command_buffer_data(VkCommandBuffer cmd_b
    return data;
 }
 
+static struct pass_queries *get_pass_queries(struct device_data *device_data)
+{
+   struct pass_queries *queries = NULL;
+
+   simple_mtx_lock(&device_data->pass_queries_mutex);
+   if (!list_empty(&device_data->free_pass_queries)) {
+      queries = list_first_entry(&device_data->free_pass_queries,
+                                 struct pass_queries, link);
+      list_del(&queries->link);
+   }
+   simple_mtx_unlock(&device_data->pass_queries_mutex);
+
+   if (!queries) {
+      VkQueryPoolCreateInfo pool_info = {
+         VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+         NULL,
+         0,
+         VK_QUERY_TYPE_TIMESTAMP,
+         OVERLAY_MAX_PASSES * 2,
+         0,
+      };
+      VkQueryPool pool;
+      VkResult err =
+         device_data->vtable.CreateQueryPool(device_data->device, &pool_info,
+                                             NULL, &pool);
+      if (err != VK_SUCCESS)
+         return NULL;
+
+      simple_mtx_lock(&device_data->pass_queries_mutex);
+      queries = rzalloc(device_data, struct pass_queries);
+      queries->pool = pool;
+      list_addtail(&queries->all_link, &device_data->all_pass_queries);
+      simple_mtx_unlock(&device_data->pass_queries_mutex);
+   }
+
+   queries->n_passes = 0;
+   queries->retired = false;
+   return queries;
+}
+
+static void put_pass_queries(struct device_data *device_data,
+                             struct pass_queries *queries)
+{
+   simple_mtx_lock(&device_data->pass_queries_mutex);
+   /* A submission may still be waiting to be read back */
+   if (queries->pending)
+      queries->retired = true;
+   else
+      list_add(&queries->link, &device_data->free_pass_queries);
+   simple_mtx_unlock(&device_data->pass_queries_mutex);
+}
+
+/* Reads back the pass timestamps of frames old enough to have completed on
+ * the GPU, without waiting for those which haven't.
+ */
+static void read_pass_queries(struct device_data *device_data)
+{
+   uint64_t results[OVERLAY_MAX_PASSES * 2][2];
+
+   simple_mtx_lock(&device_data->pass_queries_mutex);
+   list_for_each_entry_safe(struct pass_queries, queries,
+                            &device_data->pending_pass_queries, link) {
+      if (queries->submit_frame + OVERLAY_PASS_LATENCY > device_data->n_frames)
+         continue;
+
+      VkResult err =
+         device_data->vtable.GetQueryPoolResults(device_data->device, queries->pool,
+                                                 0, queries->n_passes * 2,
+                                                 sizeof(results), results,
+                                                 sizeof(results[0]),
+                                                 VK_QUERY_RESULT_64_BIT |
+                                                 VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+      if (err == VK_NOT_READY)
+         continue;
+      check_vk_result(err);
+
+      /* Only keep the passes of the most recent frame. */
+      if (queries->submit_frame > device_data->passes_frame) {
+         device_data->passes_frame = queries->submit_frame;
+         device_data->n_passes = 0;
+      }
+      if (queries->submit_frame == device_data->passes_frame) {
+         for (uint32_t p = 0; p < queries->n_passes &&
+                 device_data->n_passes < ARRAY_SIZE(device_data->passes); p++) {
+            struct overlay_pass *pass = &device_data->passes[device_data->n_passes++];
+            *pass = queries->passes[p];
+            pass->duration =
+               ((results[p * 2 + 1][0] & queries->timestamp_mask) -
+                (results[p * 2][0] & queries->timestamp_mask)) *
+               device_data->properties.limits.timestampPeriod;
+         }
+      }
+
+      list_del(&queries->link);
+      queries->pending = false;
+      if (queries->retired)
+         list_add(&queries->link, &device_data->free_pass_queries);
+   }
+   simple_mtx_unlock(&device_data->pass_queries_mutex);
+}
+
+static void begin_pass(struct command_buffer_data *cmd_buffer_data,
+                       enum overlay_pass_type type, VkExtent2D extent)
+{
+   struct pass_queries *queries = cmd_buffer_data->pass_queries;
+   if (!queries || queries->n_passes == OVERLAY_MAX_PASSES)
+      return;
+
+   queries->passes[queries->n_passes].type = type;
+   queries->passes[queries->n_passes].extent = extent;
+   cmd_buffer_data->device->vtable.CmdWriteTimestamp(cmd_buffer_data->cmd_buffer,
+                                                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                                     queries->pool,
+                                                     queries->n_passes * 2);
+}
+
+static void end_pass(struct command_buffer_data *cmd_buffer_data)
+{
+   struct pass_queries *queries = cmd_buffer_data->pass_queries;
+   if (!queries || queries->n_passes == OVERLAY_MAX_PASSES)
+      return;
+
+   cmd_buffer_data->device->vtable.CmdWriteTimestamp(cmd_buffer_data->cmd_buffer,
+                                                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                                     queries->pool,
+                                                     queries->n_passes * 2 + 1);
+   queries->n_passes++;
+}
+
 static void destroy_command_buffer_data(struct command_buffer_data *data)
 {
+   if (data->pass_queries)
+      put_pass_queries(data->device, data->pass_queries);
    unmap_object(HKEY(data->cmd_buffer));
    list_delinit(&data->link);
    ralloc_free(data);
@@ -578,6 +781,12 @@ static void snapshot_swapchain_frame(struct swapchain_data *data)
       data->accumulated_stats.stats[s] += device_data->frame_stats.stats[s] + data->frame_stats.stats[s];
    }
 
+   if (instance_data->trace) {
+      overlay_trace_frame(instance_data->trace, HKEY(data->swapchain),
+                          data->n_frames, now,
+                          data->frames_stats[f_idx].stats);
+   }
+
    if (data->last_fps_update) {
       double elapsed = (double)(now - data->last_fps_update); /* us */
       if (elapsed >= instance_data->params.fps_sampling_period) {
@@ -762,6 +971,21 @@ static void compute_swapchain_display(struct swapchain_data *data)
                      data->stats_min.stats[s], data->stats_max.stats[s]);
       }
    }
+   if (instance_data->params.gpu_passes) {
+      simple_mtx_lock(&device_data->pass_queries_mutex);
+      ImGui::Text("GPU passes (frame %" PRIu64 "):", device_data->passes_frame);
+      for (uint32_t p = 0; p < device_data->n_passes; p++) {
+         const struct overlay_pass *pass = &device_data->passes[p];
+         if (pass->type == OVERLAY_PASS_RENDER) {
+            ImGui::Text("  %u: render pass %ux%u: %.3fms", p,
+                        pass->extent.width, pass->extent.height,
+                        pass->duration / 1000000.0);
+         } else {
+            ImGui::Text("  %u: dispatch: %.3fms", p, pass->duration / 1000000.0);
+         }
+      }
+      simple_mtx_unlock(&device_data->pass_queries_mutex);
+   }
    data->window_size = ImVec2(data->window_size.x, ImGui::GetCursorPosY() + 10.0f);
    ImGui::End();
    ImGui::EndFrame();
@@ -1579,6 +1803,10 @@ static VkResult overlay_QueuePresentKHR(
    uint32_t query_results[OVERLAY_QUERY_COUNT];
 
    device_data->frame_stats.stats[OVERLAY_PARAM_ENABLED_frame]++;
+   device_data->n_frames++;
+
+   if (instance_data->params.gpu_passes)
+      read_pass_queries(device_data);
 
    if (list_length(&queue_data->running_command_buffer) > 0) {
       /* Before getting the query results, make sure the operations have
@@ -1820,7 +2048,9 @@ static void overlay_CmdDispatch(
    struct command_buffer_data *cmd_buffer_data = FIND_CMD_BUFFER_DATA(commandBuffer);
    cmd_buffer_data->stats.stats[OVERLAY_PARAM_ENABLED_dispatch]++;
    struct device_data *device_data = cmd_buffer_data->device;
+   begin_pass(cmd_buffer_data, OVERLAY_PASS_DISPATCH, VkExtent2D());
    device_data->vtable.CmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+   end_pass(cmd_buffer_data);
 }
 
 static void overlay_CmdDispatchIndirect(
@@ -1831,7 +2061,53 @@ static void overlay_CmdDispatchIndirect(
    struct command_buffer_data *cmd_buffer_data = FIND_CMD_BUFFER_DATA(commandBuffer);
    cmd_buffer_data->stats.stats[OVERLAY_PARAM_ENABLED_dispatch_indirect]++;
    struct device_data *device_data = cmd_buffer_data->device;
+   begin_pass(cmd_buffer_data, OVERLAY_PASS_DISPATCH, VkExtent2D());
    device_data->vtable.CmdDispatchIndirect(commandBuffer, buffer, offset);
+   end_pass(cmd_buffer_data);
+}
+
+static void overlay_CmdBeginRenderPass(
+    VkCommandBuffer                             commandBuffer,
+    const VkRenderPassBeginInfo*                pRenderPassBegin,
+    VkSubpassContents                           contents)
+{
+   struct command_buffer_data *cmd_buffer_data = FIND_CMD_BUFFER_DATA(commandBuffer);
+   struct device_data *device_data = cmd_buffer_data->device;
+   begin_pass(cmd_buffer_data, OVERLAY_PASS_RENDER,
+              pRenderPassBegin->renderArea.extent);
+   device_data->vtable.CmdBeginRenderPass(commandBuffer, pRenderPassBegin, contents);
+}
+
+static void overlay_CmdBeginRenderPass2KHR(
+    VkCommandBuffer                             commandBuffer,
+    const VkRenderPassBeginInfo*                pRenderPassBegin,
+    const VkSubpassBeginInfoKHR*                pSubpassBeginInfo)
+{
+   struct command_buffer_data *cmd_buffer_data = FIND_CMD_BUFFER_DATA(commandBuffer);
+   struct device_data *device_data = cmd_buffer_data->device;
+   begin_pass(cmd_buffer_data, OVERLAY_PASS_RENDER,
+              pRenderPassBegin->renderArea.extent);
+   device_data->vtable.CmdBeginRenderPass2KHR(commandBuffer, pRenderPassBegin,
+                                              pSubpassBeginInfo);
+}
+
+static void overlay_CmdEndRenderPass(
+    VkCommandBuffer                             commandBuffer)
+{
+   struct command_buffer_data *cmd_buffer_data = FIND_CMD_BUFFER_DATA(commandBuffer);
+   struct device_data *device_data = cmd_buffer_data->device;
+   device_data->vtable.CmdEndRenderPass(commandBuffer);
+   end_pass(cmd_buffer_data);
+}
+
+static void overlay_CmdEndRenderPass2KHR(
+    VkCommandBuffer                             commandBuffer,
+    const VkSubpassEndInfoKHR*                  pSubpassEndInfo)
+{
+   struct command_buffer_data *cmd_buffer_data = FIND_CMD_BUFFER_DATA(commandBuffer);
+   struct device_data *device_data = cmd_buffer_data->device;
+   device_data->vtable.CmdEndRenderPass2KHR(commandBuffer, pSubpassEndInfo);
+   end_pass(cmd_buffer_data);
 }
 
 static void overlay_CmdBindPipeline(
@@ -1895,10 +2171,25 @@ static VkResult overlay_BeginCommandBuffer(
       return result;
    }
 
+   /* Timestamps from a previous recording belong to the previous recording.
+    * Those may still have to be read back, so use new ones.
+    */
+   if (cmd_buffer_data->pass_queries) {
+      put_pass_queries(device_data, cmd_buffer_data->pass_queries);
+      cmd_buffer_data->pass_queries = NULL;
+   }
+
    /* Otherwise record a begin query as first command. */
    VkResult result = device_data->vtable.BeginCommandBuffer(commandBuffer, pBeginInfo);
 
    if (result == VK_SUCCESS) {
+      if (device_data->instance->params.gpu_passes)
+         cmd_buffer_data->pass_queries = get_pass_queries(device_data);
+      if (cmd_buffer_data->pass_queries) {
+         device_data->vtable.CmdResetQueryPool(commandBuffer,
+                                               cmd_buffer_data->pass_queries->pool,
+                                               0, OVERLAY_MAX_PASSES * 2);
+      }
       if (cmd_buffer_data->pipeline_query_pool) {
          device_data->vtable.CmdResetQueryPool(commandBuffer,
                                                cmd_buffer_data->pipeline_query_pool,
@@ -1955,6 +2246,11 @@ static VkResult overlay_ResetCommandBuffer(
 
    memset(&cmd_buffer_data->stats, 0, sizeof(cmd_buffer_data->stats));
 
+   if (cmd_buffer_data->pass_queries) {
+      put_pass_queries(device_data, cmd_buffer_data->pass_queries);
+      cmd_buffer_data->pass_queries = NULL;
+   }
+
    return device_data->vtable.ResetCommandBuffer(commandBuffer, flags);
 }
 
@@ -2091,6 +2387,19 @@ static VkResult overlay_QueueSubmit(
          for (uint32_t st = 0; st < OVERLAY_PARAM_ENABLED_MAX; st++)
             device_data->frame_stats.stats[st] += cmd_buffer_data->stats.stats[st];
 
+         /* Queue the pass timestamps for read back a few frames from now. */
+         struct pass_queries *queries = cmd_buffer_data->pass_queries;
+         if (queries && queries->n_passes > 0) {
+            simple_mtx_lock(&device_data->pass_queries_mutex);
+            queries->submit_frame = device_data->n_frames;
+            queries->timestamp_mask = queue_data->timestamp_mask;
+            if (!queries->pending) {
+               queries->pending = true;
+               list_addtail(&queries->link, &device_data->pending_pass_queries);
+            }
+            simple_mtx_unlock(&device_data->pass_queries_mutex);
+         }
+
          /* Attach the command buffer to the queue so we remember to read its
           * pipeline statistics & timestamps at QueuePresent().
           */
@@ -2169,6 +2478,7 @@ static void overlay_DestroyDevice(
 {
    struct device_data *device_data = FIND_DEVICE_DATA(device);
    device_unmap_queues(device_data);
+   destroy_device_pass_queries(device_data);
    device_data->vtable.DestroyDevice(device, pAllocator);
    destroy_device_data(device_data);
 }
@@ -2204,6 +2514,11 @@ static VkResult overlay_CreateInstance(
 
    parse_overlay_env(&instance_data->params, getenv("VK_LAYER_MESA_OVERLAY_CONFIG"));
 
+   if (instance_data->params.trace_file) {
+      instance_data->trace = overlay_trace_create(instance_data->params.trace_file,
+                                                  &instance_data->params);
+   }
+
    for (int i = OVERLAY_PARAM_ENABLED_vertices;
         i <= OVERLAY_PARAM_ENABLED_compute_invocations; i++) {
       if (instance_data->params.enabled[i]) {
@@ -2244,6 +2559,10 @@ static const struct {
    ADD_HOOK(CmdDrawIndexedIndirect),
    ADD_HOOK(CmdDispatch),
    ADD_HOOK(CmdDispatchIndirect),
+   ADD_HOOK(CmdBeginRenderPass),
+   ADD_HOOK(CmdBeginRenderPass2KHR),
+   ADD_HOOK(CmdEndRenderPass),
+   ADD_HOOK(CmdEndRenderPass2KHR),
    ADD_HOOK(CmdDrawIndirectCountKHR),
    ADD_HOOK(CmdDrawIndexedIndirectCountKHR),
 
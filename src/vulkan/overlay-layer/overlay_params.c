@@ -47,6 +47,12 @@ parse_output_file(const char *str)
    return fopen(str, "w+");
 }
 
+static FILE *
+parse_trace_file(const char *str)
+{
+   return fopen(str, "wb");
+}
+
 static uint32_t
 parse_fps_sampling_period(const char *str)
 {
@@ -59,6 +65,12 @@ parse_no_display(const char *str)
    return strtol(str, NULL, 0) != 0;
 }
 
+static bool
+parse_gpu_passes(const char *str)
+{
+   return strtol(str, NULL, 0) != 0;
+}
+
 static unsigned
 parse_unsigned(const char *str)
 {
@@ -81,7 +93,9 @@ parse_help(const char *str)
    fprintf(stderr, "\tposition=top-left|top-right|bottom-left|bottom-right\n");
    fprintf(stderr, "\tfps_sampling_period=number-of-milliseconds\n");
    fprintf(stderr, "\tno_display=0|1\n");
+   fprintf(stderr, "\tgpu_passes=0|1\n");
    fprintf(stderr, "\toutput_file=/path/to/output.txt\n");
+   fprintf(stderr, "\ttrace_file=/path/to/output.trace\n");
    fprintf(stderr, "\twidth=width-in-pixels\n");
    fprintf(stderr, "\theight=height-in-pixels\n");
 
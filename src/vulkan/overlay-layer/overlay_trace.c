@@ -0,0 +1,223 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "c11/threads.h"
+
+#include "overlay_params.h"
+#include "overlay_trace.h"
+
+/* Frames are appended to the current chunk under a short lock, and full
+ * chunks are written out by a background thread.  If the disk can't keep
+ * up and all chunks are full, frames are dropped rather than stalling the
+ * application.
+ */
+#define TRACE_CHUNK_SIZE (64 * 1024)
+#define TRACE_N_CHUNKS 8
+
+/* How long a partially filled chunk may wait before being written (s) */
+#define TRACE_FLUSH_PERIOD 1
+
+struct trace_chunk {
+   size_t size;
+   uint8_t data[TRACE_CHUNK_SIZE];
+};
+
+struct overlay_trace {
+   FILE *file;
+
+   unsigned n_stats;
+   uint8_t stats[OVERLAY_PARAM_ENABLED_MAX];
+   size_t record_size;
+
+   mtx_t mutex;
+   cnd_t cond;
+   thrd_t thread;
+   bool quit;
+
+   struct trace_chunk *current;
+
+   /* Chunks waiting to be written, oldest first */
+   struct trace_chunk *full[TRACE_N_CHUNKS];
+   unsigned first_full, n_full;
+
+   struct trace_chunk *free_chunks[TRACE_N_CHUNKS];
+   unsigned n_free;
+
+   uint64_t dropped_frames;
+
+   struct trace_chunk chunks[TRACE_N_CHUNKS];
+};
+
+/* Must be called with the mutex held */
+static void
+trace_queue_current(struct overlay_trace *trace)
+{
+   if (!trace->current)
+      return;
+
+   if (trace->current->size == 0) {
+      trace->free_chunks[trace->n_free++] = trace->current;
+   } else {
+      unsigned i = (trace->first_full + trace->n_full) % TRACE_N_CHUNKS;
+      trace->full[i] = trace->current;
+      trace->n_full++;
+      cnd_signal(&trace->cond);
+   }
+   trace->current = NULL;
+}
+
+static int
+trace_thread(void *data)
+{
+   struct overlay_trace *trace = data;
+
+   mtx_lock(&trace->mutex);
+   for (;;) {
+      while (trace->n_full == 0 && !trace->quit) {
+         struct timespec ts;
+         timespec_get(&ts, TIME_UTC);
+         ts.tv_sec += TRACE_FLUSH_PERIOD;
+
+         if (cnd_timedwait(&trace->cond, &trace->mutex, &ts) == thrd_busy)
+            trace_queue_current(trace);
+      }
+
+      if (trace->n_full == 0)
+         break;
+
+      struct trace_chunk *chunk = trace->full[trace->first_full];
+      trace->first_full = (trace->first_full + 1) % TRACE_N_CHUNKS;
+      trace->n_full--;
+      mtx_unlock(&trace->mutex);
+
+      fwrite(chunk->data, 1, chunk->size, trace->file);
+      fflush(trace->file);
+
+      mtx_lock(&trace->mutex);
+      trace->free_chunks[trace->n_free++] = chunk;
+   }
+   mtx_unlock(&trace->mutex);
+
+   return 0;
+}
+
+struct overlay_trace *
+overlay_trace_create(FILE *file, const struct overlay_params *params)
+{
+   struct overlay_trace *trace = calloc(1, sizeof(*trace));
+   if (!trace)
+      return NULL;
+
+   trace->file = file;
+
+   /* fps is averaged over fps_sampling_period, it has no per-frame value */
+   for (unsigned s = 0; s < OVERLAY_PARAM_ENABLED_MAX; s++) {
+      if (params->enabled[s] && s != OVERLAY_PARAM_ENABLED_fps)
+         trace->stats[trace->n_stats++] = s;
+   }
+   trace->record_size = (3 + trace->n_stats) * sizeof(uint64_t);
+
+   uint32_t version = OVERLAY_TRACE_VERSION;
+   uint32_t n_stats = trace->n_stats;
+   fwrite(OVERLAY_TRACE_MAGIC, 1, 8, file);
+   fwrite(&version, sizeof(version), 1, file);
+   fwrite(&n_stats, sizeof(n_stats), 1, file);
+   for (unsigned i = 0; i < trace->n_stats; i++) {
+      char name[OVERLAY_TRACE_NAME_SIZE] = { 0, };
+      strncpy(name, overlay_param_names[trace->stats[i]], sizeof(name) - 1);
+      fwrite(name, 1, sizeof(name), file);
+   }
+   fflush(file);
+
+   for (unsigned i = 0; i < TRACE_N_CHUNKS; i++)
+      trace->free_chunks[trace->n_free++] = &trace->chunks[i];
+
+   mtx_init(&trace->mutex, mtx_plain);
+   cnd_init(&trace->cond);
+   if (thrd_create(&trace->thread, trace_thread, trace) != thrd_success) {
+      cnd_destroy(&trace->cond);
+      mtx_destroy(&trace->mutex);
+      free(trace);
+      return NULL;
+   }
+
+   return trace;
+}
+
+void
+overlay_trace_frame(struct overlay_trace *trace, uint64_t swapchain,
+                    uint64_t frame, uint64_t timestamp,
+                    const uint64_t *stats)
+{
+   mtx_lock(&trace->mutex);
+
+   if (trace->current &&
+       trace->current->size + trace->record_size > TRACE_CHUNK_SIZE)
+      trace_queue_current(trace);
+
+   if (!trace->current) {
+      if (trace->n_free == 0) {
+         trace->dropped_frames++;
+         mtx_unlock(&trace->mutex);
+         return;
+      }
+      trace->current = trace->free_chunks[--trace->n_free];
+      trace->current->size = 0;
+   }
+
+   uint64_t *record =
+      (uint64_t *) (trace->current->data + trace->current->size);
+   record[0] = swapchain;
+   record[1] = frame;
+   record[2] = timestamp;
+   for (unsigned i = 0; i < trace->n_stats; i++)
+      record[3 + i] = stats[trace->stats[i]];
+   trace->current->size += trace->record_size;
+
+   mtx_unlock(&trace->mutex);
+}
+
+void
+overlay_trace_destroy(struct overlay_trace *trace)
+{
+   mtx_lock(&trace->mutex);
+   trace_queue_current(trace);
+   trace->quit = true;
+   cnd_signal(&trace->cond);
+   mtx_unlock(&trace->mutex);
+
+   thrd_join(trace->thread, NULL);
+
+   if (trace->dropped_frames) {
+      fprintf(stderr, "mesa-overlay: %" PRIu64 " frames dropped from the "
+              "trace, the disk couldn't keep up\n", trace->dropped_frames);
+   }
+
+   cnd_destroy(&trace->cond);
+   mtx_destroy(&trace->mutex);
+   free(trace);
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2019 Intel Corporation
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef OVERLAY_TRACE_H
+#define OVERLAY_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Binary per-frame trace, written by a background thread.
+ *
+ * The file starts with a header:
+ *
+ *    char     magic[8];      "MESAOVLT"
+ *    uint32_t version;       OVERLAY_TRACE_VERSION
+ *    uint32_t n_stats;
+ *    char     names[n_stats][OVERLAY_TRACE_NAME_SIZE];
+ *
+ * followed by one record per presented frame:
+ *
+ *    uint64_t swapchain;     VkSwapchainKHR handle
+ *    uint64_t frame;         frame number within the swapchain
+ *    uint64_t timestamp;     present time in us
+ *    uint64_t stats[n_stats];
+ *
+ * All values are in host byte order.  overlay_trace.py converts traces to
+ * CSV or to the JSON trace format Perfetto and chrome://tracing load.
+ */
+
+#define OVERLAY_TRACE_MAGIC "MESAOVLT"
+#define OVERLAY_TRACE_VERSION 1
+#define OVERLAY_TRACE_NAME_SIZE 32
+
+struct overlay_params;
+struct overlay_trace;
+
+struct overlay_trace *
+overlay_trace_create(FILE *file, const struct overlay_params *params);
+
+void
+overlay_trace_frame(struct overlay_trace *trace, uint64_t swapchain,
+                    uint64_t frame, uint64_t timestamp,
+                    const uint64_t *stats);
+
+void
+overlay_trace_destroy(struct overlay_trace *trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OVERLAY_TRACE_H */
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Copyright © 2019 Intel Corporation
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice (including the next
+# paragraph) shall be included in all copies or substantial portions of the
+# Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+# IN THE SOFTWARE.
+
+"""
+Convert a trace written by the overlay layer's trace_file option to CSV,
+or to the JSON trace event format that Perfetto and chrome://tracing load.
+The file format is described in overlay_trace.h.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b'MESAOVLT'
+VERSION = 1
+NAME_SIZE = 32
+
+UNITS = {
+    'frame_timing': 'us',
+    'acquire_timing': 'us',
+    'gpu_timing': 'ns',
+}
+
+
+def read_trace(f):
+    header = f.read(16)
+    if len(header) < 16 or header[:8] != MAGIC:
+        sys.exit('not an overlay trace')
+    version, n_stats = struct.unpack('=II', header[8:])
+    if version != VERSION:
+        sys.exit('unsupported trace version {}'.format(version))
+
+    names = []
+    for _ in range(n_stats):
+        names.append(f.read(NAME_SIZE).split(b'\0')[0].decode('ascii'))
+
+    record = struct.Struct('={}Q'.format(3 + n_stats))
+    frames = []
+    while True:
+        data = f.read(record.size)
+        if len(data) < record.size:
+            break
+        frames.append(record.unpack(data))
+
+    return names, frames
+
+
+def write_csv(names, frames, out):
+    columns = ['swapchain', 'frame', 'timestamp(us)']
+    for name in names:
+        unit = UNITS.get(name)
+        columns.append('{}({})'.format(name, unit) if unit else name)
+    out.write(', '.join(columns) + '\n')
+    for frame in frames:
+        out.write('0x{:x}, '.format(frame[0]) +
+                  ', '.join(str(v) for v in frame[1:]) + '\n')
+
+
+def write_json(names, frames, out):
+    events = []
+    swapchains = {}
+    for frame in frames:
+        pid = swapchains.setdefault(frame[0], len(swapchains) + 1)
+        ts = frame[2]
+        stats = dict(zip(names, frame[3:]))
+
+        if 'frame_timing' in stats:
+            events.append({'name': 'frame {}'.format(frame[1]), 'ph': 'X',
+                           'pid': pid, 'tid': 0,
+                           'ts': ts - stats['frame_timing'],
+                           'dur': stats['frame_timing']})
+        for name, value in stats.items():
+            events.append({'name': name, 'ph': 'C', 'pid': pid, 'ts': ts,
+                           'args': {UNITS.get(name, 'value'): value}})
+
+    for swapchain, pid in swapchains.items():
+        events.append({'name': 'process_name', 'ph': 'M', 'pid': pid,
+                       'args': {'name': 'swapchain 0x{:x}'.format(swapchain)}})
+
+    json.dump({'traceEvents': events, 'displayTimeUnit': 'ms'}, out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--format', choices=['csv', 'json'], default='csv')
+    parser.add_argument('trace')
+    args = parser.parse_args()
+
+    with open(args.trace, 'rb') as f:
+        names, frames = read_trace(f)
+
+    if args.format == 'csv':
+        write_csv(names, frames, sys.stdout)
+    else:
+        write_json(names, frames, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
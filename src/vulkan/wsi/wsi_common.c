@@ -24,9 +24,11 @@
 #include "wsi_common_private.h"
 #include "drm-uapi/drm_fourcc.h"
 #include "util/macros.h"
+#include "util/u_trace.h"
 #include "util/xmlconfig.h"
 #include "vk_util.h"
 
+#include <errno.h>
 #include <time.h>
 #include <unistd.h>
 #include <xf86drm.h>
@@ -185,6 +187,71 @@ wsi_device_matches_drm_fd(const struct wsi_device *wsi, int drm_fd)
    return match;
 }
 
+/**
+ * Returns true if the device can render to at least one of the given
+ * modifiers other than LINEAR.
+ *
+ * The modifier lists come from the display side, so a match means both
+ * GPUs share a tiling layout and images can be handed over as they are
+ * rendered, without a PRIME blit to a linear copy.  LINEAR alone doesn't
+ * count: rendering straight to linear is generally slower than the blit.
+ */
+bool
+wsi_device_supports_tiled_modifier(const struct wsi_swapchain *chain,
+                                   VkFormat format,
+                                   uint32_t num_modifier_lists,
+                                   const uint32_t *num_modifiers,
+                                   const uint64_t *const *modifiers)
+{
+   const struct wsi_device *wsi = chain->wsi;
+
+   if (!wsi->supports_modifiers || num_modifier_lists == 0)
+      return false;
+
+   struct wsi_format_modifier_properties_list modifier_props_list = {
+      .sType = VK_STRUCTURE_TYPE_WSI_FORMAT_MODIFIER_PROPERTIES_LIST_MESA,
+      .pNext = NULL,
+   };
+   VkFormatProperties2 format_props = {
+      .sType = VK_STRUCTURE_TYPE_FORMAT_PROPERTIES_2,
+      .pNext = &modifier_props_list,
+   };
+   wsi->GetPhysicalDeviceFormatProperties2KHR(wsi->pdevice, format,
+                                              &format_props);
+   if (modifier_props_list.modifier_count == 0)
+      return false;
+
+   struct wsi_format_modifier_properties *modifier_props =
+      vk_alloc(&chain->alloc,
+               sizeof(*modifier_props) * modifier_props_list.modifier_count,
+               8, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+   if (!modifier_props)
+      return false;
+
+   modifier_props_list.modifier_properties = modifier_props;
+   wsi->GetPhysicalDeviceFormatProperties2KHR(wsi->pdevice, format,
+                                              &format_props);
+
+   bool found = false;
+   for (uint32_t l = 0; l < num_modifier_lists && !found; l++) {
+      for (uint32_t i = 0; i < num_modifiers[l] && !found; i++) {
+         if (modifiers[l][i] == DRM_FORMAT_MOD_LINEAR)
+            continue;
+
+         for (uint32_t j = 0; j < modifier_props_list.modifier_count; j++) {
+            if (modifier_props[j].modifier == modifiers[l][i]) {
+               found = true;
+               break;
+            }
+         }
+      }
+   }
+
+   vk_free(&chain->alloc, modifier_props);
+
+   return found;
+}
+
 VkResult
 wsi_swapchain_init(const struct wsi_device *wsi,
                    struct wsi_swapchain *chain,
@@ -207,6 +274,11 @@ wsi_swapchain_init(const struct wsi_device *wsi,
    if (!chain->cmd_pools)
       return VK_ERROR_OUT_OF_HOST_MEMORY;
 
+   pthread_mutex_init(&chain->timing_mutex, NULL);
+
+   /* Until the backend knows better */
+   chain->refresh_duration = 1000000000ull / 60;
+
    for (uint32_t i = 0; i < wsi->queue_family_count; i++) {
       const VkCommandPoolCreateInfo cmd_pool_info = {
          .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
@@ -291,6 +363,113 @@ wsi_swapchain_finish(struct wsi_swapchain *chain)
                                      &chain->alloc);
    }
    vk_free(&chain->alloc, chain->cmd_pools);
+
+   pthread_mutex_destroy(&chain->timing_mutex);
+}
+
+/**
+ * Called by the backends when an image has been put on screen at
+ * actual_present_time.  present_time is what the application passed for
+ * that present through VkPresentTimesInfoGOOGLE, if anything, and
+ * refresh_duration is the current refresh cycle if the backend knows it,
+ * or 0.
+ */
+void
+wsi_swapchain_record_present(struct wsi_swapchain *chain,
+                             const VkPresentTimeGOOGLE *present_time,
+                             uint64_t actual_present_time,
+                             uint64_t refresh_duration)
+{
+   pthread_mutex_lock(&chain->timing_mutex);
+
+   if (refresh_duration)
+      chain->refresh_duration = refresh_duration;
+   chain->last_present_time = actual_present_time;
+
+   if (present_time) {
+      if (chain->timing_count == WSI_PRESENT_TIMING_HISTORY) {
+         chain->timing_first =
+            (chain->timing_first + 1) % WSI_PRESENT_TIMING_HISTORY;
+         chain->timing_count--;
+      }
+
+      uint32_t i = (chain->timing_first + chain->timing_count) %
+                   WSI_PRESENT_TIMING_HISTORY;
+      chain->timings[i] = (VkPastPresentationTimingGOOGLE) {
+         .presentID = present_time->presentID,
+         .desiredPresentTime = present_time->desiredPresentTime,
+         .actualPresentTime = actual_present_time,
+         /* None of the backends can tell whether the image could have been
+          * shown any earlier, so don't claim it could.
+          */
+         .earliestPresentTime = actual_present_time,
+         .presentMargin = 0,
+      };
+      chain->timing_count++;
+   }
+
+   pthread_mutex_unlock(&chain->timing_mutex);
+}
+
+/**
+ * Returns the number of refresh cycles after the last present seen on
+ * screen at which an image can be shown without being shown before
+ * desired_present_time, or 0 if any refresh will do.
+ */
+uint64_t
+wsi_swapchain_refreshes_until(struct wsi_swapchain *chain,
+                              uint64_t desired_present_time)
+{
+   uint64_t cycles = 0;
+
+   pthread_mutex_lock(&chain->timing_mutex);
+   if (chain->last_present_time &&
+       desired_present_time > chain->last_present_time) {
+      cycles = DIV_ROUND_UP(desired_present_time - chain->last_present_time,
+                            chain->refresh_duration);
+   }
+   pthread_mutex_unlock(&chain->timing_mutex);
+
+   return cycles;
+}
+
+/**
+ * For backends which can't target a refresh cycle: sleeps until the
+ * refresh cycle before the one at which desired_present_time is reached,
+ * so that an image submitted afterwards isn't shown too early.
+ */
+void
+wsi_swapchain_wait_for_present_time(struct wsi_swapchain *chain,
+                                    uint64_t desired_present_time)
+{
+   uint64_t submit_time = 0;
+
+   pthread_mutex_lock(&chain->timing_mutex);
+   if (chain->last_present_time &&
+       desired_present_time > chain->last_present_time) {
+      uint64_t refresh = chain->refresh_duration;
+      uint64_t cycles =
+         DIV_ROUND_UP(desired_present_time - chain->last_present_time,
+                      refresh);
+
+      /* Stay clear of the vblank itself, we would rather be one refresh
+       * late than one early.
+       */
+      if (cycles > 1) {
+         submit_time = chain->last_present_time + (cycles - 1) * refresh +
+                       refresh / 4;
+      }
+   }
+   pthread_mutex_unlock(&chain->timing_mutex);
+
+   if (submit_time <= wsi_common_get_current_time())
+      return;
+
+   struct timespec ts = {
+      .tv_sec = submit_time / 1000000000ull,
+      .tv_nsec = submit_time % 1000000000ull,
+   };
+   while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
 }
 
 static uint32_t
@@ -1002,9 +1181,12 @@ wsi_common_queue_present(const struct wsi_device *wsi,
                          const VkPresentInfoKHR *pPresentInfo)
 {
    VkResult final_result = VK_SUCCESS;
+   MESA_TRACE_FUNC();
 
    const VkPresentRegionsKHR *regions =
       vk_find_struct_const(pPresentInfo->pNext, PRESENT_REGIONS_KHR);
+   const VkPresentTimesInfoGOOGLE *present_times =
+      vk_find_struct_const(pPresentInfo->pNext, PRESENT_TIMES_INFO_GOOGLE);
 
    for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++) {
       WSI_FROM_HANDLE(wsi_swapchain, swapchain, pPresentInfo->pSwapchains[i]);
@@ -1074,9 +1256,13 @@ wsi_common_queue_present(const struct wsi_device *wsi,
       if (regions && regions->pRegions)
          region = &regions->pRegions[i];
 
+      const VkPresentTimeGOOGLE *present_time = NULL;
+      if (present_times && present_times->pTimes)
+         present_time = &present_times->pTimes[i];
+
       result = swapchain->queue_present(swapchain,
                                         pPresentInfo->pImageIndices[i],
-                                        region);
+                                        region, present_time);
       if (result != VK_SUCCESS)
          goto fail_present;
 
@@ -1101,6 +1287,54 @@ wsi_common_queue_present(const struct wsi_device *wsi,
    return final_result;
 }
 
+VkResult
+wsi_common_get_refresh_cycle_duration(
+   VkSwapchainKHR _swapchain,
+   VkRefreshCycleDurationGOOGLE *pDisplayTimingProperties)
+{
+   WSI_FROM_HANDLE(wsi_swapchain, swapchain, _swapchain);
+
+   pthread_mutex_lock(&swapchain->timing_mutex);
+   pDisplayTimingProperties->refreshDuration = swapchain->refresh_duration;
+   pthread_mutex_unlock(&swapchain->timing_mutex);
+
+   return VK_SUCCESS;
+}
+
+VkResult
+wsi_common_get_past_presentation_timing(
+   VkSwapchainKHR _swapchain,
+   uint32_t *pPresentationTimingCount,
+   VkPastPresentationTimingGOOGLE *pPresentationTimings)
+{
+   WSI_FROM_HANDLE(wsi_swapchain, swapchain, _swapchain);
+   VkResult result = VK_SUCCESS;
+
+   pthread_mutex_lock(&swapchain->timing_mutex);
+
+   if (!pPresentationTimings) {
+      *pPresentationTimingCount = swapchain->timing_count;
+   } else {
+      /* Timings are only reported once, so drop what we return */
+      uint32_t count = MIN2(*pPresentationTimingCount,
+                            swapchain->timing_count);
+      for (uint32_t i = 0; i < count; i++) {
+         pPresentationTimings[i] = swapchain->timings[swapchain->timing_first];
+         swapchain->timing_first =
+            (swapchain->timing_first + 1) % WSI_PRESENT_TIMING_HISTORY;
+      }
+      swapchain->timing_count -= count;
+      *pPresentationTimingCount = count;
+
+      if (swapchain->timing_count > 0)
+         result = VK_INCOMPLETE;
+   }
+
+   pthread_mutex_unlock(&swapchain->timing_mutex);
+
+   return result;
+}
+
 uint64_t
 wsi_common_get_current_time(void)
 {
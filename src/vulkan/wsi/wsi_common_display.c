@@ -122,6 +122,8 @@ struct wsi_display_image {
    uint32_t                     fb_id;
    uint32_t                     buffer[4];
    uint64_t                     flip_sequence;
+   bool                         timed;
+   VkPresentTimeGOOGLE          present_time;
 };
 
 struct wsi_display_swapchain {
@@ -1022,6 +1024,7 @@ wsi_display_image_init(VkDevice device_h,
    image->chain = chain;
    image->state = WSI_IMAGE_IDLE;
    image->fb_id = 0;
+   image->timed = false;
 
    int ret = drmModeAddFB2(wsi->fd,
                            create_info->imageExtent.width,
@@ -1125,6 +1128,9 @@ wsi_display_page_flip_handler2(int fd,
 
    wsi_display_debug("image %ld displayed at %d\n",
                      image - &(image->chain->images[0]), frame);
+   wsi_swapchain_record_present(&chain->base,
+                                image->timed ? &image->present_time : NULL,
+                                sec * 1000000000ull + usec * 1000ull, 0);
    image->state = WSI_IMAGE_DISPLAYING;
    wsi_display_idle_old_displaying(image);
    VkResult result = _wsi_display_queue_next(&(chain->base));
@@ -1667,6 +1673,10 @@ _wsi_display_queue_next(struct wsi_swapchain *drv_chain)
             /* Assume that the mode set is synchronous and that any
              * previous image is now idle.
              */
+            wsi_swapchain_record_present(&chain->base,
+                                         image->timed ?
+                                         &image->present_time : NULL,
+                                         wsi_common_get_current_time(), 0);
             image->state = WSI_IMAGE_DISPLAYING;
             wsi_display_idle_old_displaying(image);
             connector->active = true;
@@ -1691,7 +1701,8 @@ _wsi_display_queue_next(struct wsi_swapchain *drv_chain)
 static VkResult
 wsi_display_queue_present(struct wsi_swapchain *drv_chain,
                           uint32_t image_index,
-                          const VkPresentRegionKHR *damage)
+                          const VkPresentRegionKHR *damage,
+                          const VkPresentTimeGOOGLE *present_time)
 {
    struct wsi_display_swapchain *chain =
       (struct wsi_display_swapchain *) drv_chain;
@@ -1706,6 +1717,16 @@ wsi_display_queue_present(struct wsi_swapchain *drv_chain,
    assert(image->state == WSI_IMAGE_DRAWING);
    wsi_display_debug("present %d\n", image_index);
 
+   /* Flips always land on the next vblank, so hold the image back until
+    * the one before the requested time.
+    */
+   image->timed = present_time != NULL;
+   if (present_time) {
+      image->present_time = *present_time;
+      wsi_swapchain_wait_for_present_time(drv_chain,
+                                          present_time->desiredPresentTime);
+   }
+
    pthread_mutex_lock(&wsi->wait_mutex);
 
    image->flip_sequence = ++chain->flip_sequence;
@@ -1765,6 +1786,11 @@ wsi_display_surface_create_swapchain(
 
    chain->surface = (VkIcdSurfaceDisplay *) icd_surface;
 
+   wsi_display_mode *display_mode =
+      wsi_display_mode_from_handle(chain->surface->displayMode);
+   chain->base.refresh_duration =
+      (uint64_t) (1000000000.0 / wsi_display_mode_refresh(display_mode));
+
    for (uint32_t image = 0; image < chain->base.image_count; image++) {
       result = wsi_display_image_init(device, &chain->base,
                                       create_info, allocator,
@@ -25,6 +25,8 @@
 
 #include "wsi_common.h"
 
+#include <pthread.h>
+
 struct wsi_image {
    VkImage image;
    VkDeviceMemory memory;
@@ -43,6 +45,11 @@ struct wsi_image {
    int fds[4];
 };
 
+/* Number of past presents whose timing we remember for
+ * vkGetPastPresentationTimingGOOGLE.  Older entries are dropped.
+ */
+#define WSI_PRESENT_TIMING_HISTORY 16
+
 struct wsi_swapchain {
    const struct wsi_device *wsi;
 
@@ -66,12 +73,31 @@ struct wsi_swapchain {
                                   uint32_t *image_index);
    VkResult (*queue_present)(struct wsi_swapchain *swap_chain,
                              uint32_t image_index,
-                             const VkPresentRegionKHR *damage);
+                             const VkPresentRegionKHR *damage,
+                             const VkPresentTimeGOOGLE *present_time);
+
+   /* VK_GOOGLE_display_timing state.  The backends feed it through
+    * wsi_swapchain_record_present() as presents land on screen, possibly
+    * from their own threads, hence the lock.
+    */
+   pthread_mutex_t timing_mutex;
+   uint64_t refresh_duration;
+   uint64_t last_present_time;
+   uint32_t timing_first;
+   uint32_t timing_count;
+   VkPastPresentationTimingGOOGLE timings[WSI_PRESENT_TIMING_HISTORY];
 };
 
 bool
 wsi_device_matches_drm_fd(const struct wsi_device *wsi, int drm_fd);
 
+bool
+wsi_device_supports_tiled_modifier(const struct wsi_swapchain *chain,
+                                   VkFormat format,
+                                   uint32_t num_modifier_lists,
+                                   const uint32_t *num_modifiers,
+                                   const uint64_t *const *modifiers);
+
 VkResult
 wsi_swapchain_init(const struct wsi_device *wsi,
                    struct wsi_swapchain *chain,
@@ -85,6 +111,20 @@ wsi_swapchain_get_present_mode(struct wsi_device *wsi,
 
 void wsi_swapchain_finish(struct wsi_swapchain *chain);
 
+void
+wsi_swapchain_record_present(struct wsi_swapchain *chain,
+                             const VkPresentTimeGOOGLE *present_time,
+                             uint64_t actual_present_time,
+                             uint64_t refresh_duration);
+
+uint64_t
+wsi_swapchain_refreshes_until(struct wsi_swapchain *chain,
+                              uint64_t desired_present_time);
+
+void
+wsi_swapchain_wait_for_present_time(struct wsi_swapchain *chain,
+                                    uint64_t desired_present_time);
+
 VkResult
 wsi_create_native_image(const struct wsi_swapchain *chain,
                         const VkSwapchainCreateInfoKHR *pCreateInfo,
@@ -30,6 +30,7 @@
 #include <errno.h>
 #include <string.h>
 #include <pthread.h>
+#include <time.h>
 
 #include "drm-uapi/drm_fourcc.h"
 
@@ -38,8 +39,10 @@
 #include "wsi_common_wayland.h"
 #include "wayland-drm-client-protocol.h"
 #include "linux-dmabuf-unstable-v1-client-protocol.h"
+#include "presentation-time-client-protocol.h"
 
 #include <util/hash_table.h>
+#include <util/list.h>
 #include <util/u_vector.h>
 
 #define typed_memcpy(dest, src, count) ({ \
@@ -74,6 +77,10 @@ struct wsi_wl_display {
    struct wsi_wl_display_drm                    drm;
    struct wsi_wl_display_dmabuf                 dmabuf;
 
+   /* Used for VK_GOOGLE_display_timing, if the compositor has it */
+   struct wp_presentation *                     wp_presentation;
+   uint32_t                                     presentation_clock_id;
+
    struct wsi_wayland *wsi_wl;
 
    /* Points to formats in wsi_wl_display_drm or wsi_wl_display_dmabuf */
@@ -313,6 +320,19 @@ static const struct zwp_linux_dmabuf_v1_listener dmabuf_listener = {
    dmabuf_handle_modifier,
 };
 
+static void
+presentation_handle_clock_id(void *data, struct wp_presentation *presentation,
+                             uint32_t clk_id)
+{
+   struct wsi_wl_display *display = data;
+
+   display->presentation_clock_id = clk_id;
+}
+
+static const struct wp_presentation_listener presentation_listener = {
+   presentation_handle_clock_id,
+};
+
 static void
 registry_handle_global(void *data, struct wl_registry *registry,
                        uint32_t name, const char *interface, uint32_t version)
@@ -332,6 +352,11 @@ registry_handle_global(void *data, struct wl_registry *registry,
          wl_registry_bind(registry, name, &zwp_linux_dmabuf_v1_interface, 3);
       zwp_linux_dmabuf_v1_add_listener(display->dmabuf.wl_dmabuf,
                                        &dmabuf_listener, display);
+   } else if (strcmp(interface, "wp_presentation") == 0) {
+      display->wp_presentation =
+         wl_registry_bind(registry, name, &wp_presentation_interface, 1);
+      wp_presentation_add_listener(display->wp_presentation,
+                                   &presentation_listener, display);
    }
 }
 
@@ -358,6 +383,8 @@ wsi_wl_display_finish(struct wsi_wl_display *display)
       wl_drm_destroy(display->drm.wl_drm);
    if (display->dmabuf.wl_dmabuf)
       zwp_linux_dmabuf_v1_destroy(display->dmabuf.wl_dmabuf);
+   if (display->wp_presentation)
+      wp_presentation_destroy(display->wp_presentation);
    if (display->wl_display_wrapper)
       wl_proxy_wrapper_destroy(display->wl_display_wrapper);
    if (display->queue)
@@ -415,8 +442,11 @@ wsi_wl_display_init(struct wsi_wayland *wsi_wl,
    /* Round-trip to get wl_drms and zwp_linux_dmabuf_v1 globals */
    wl_display_roundtrip_queue(display->wl_display, display->queue);
 
-   /* Round-trip again to get formats, modifiers and capabilities */
-   if (display->drm.wl_drm || display->dmabuf.wl_dmabuf)
+   /* Round-trip again to get formats, modifiers, capabilities and the
+    * presentation clock
+    */
+   if (display->drm.wl_drm || display->dmabuf.wl_dmabuf ||
+       display->wp_presentation)
       wl_display_roundtrip_queue(display->wl_display, display->queue);
 
    /* We need prime support for wl_drm */
@@ -736,6 +766,11 @@ struct wsi_wl_swapchain {
    VkPresentModeKHR                             present_mode;
    bool                                         fifo_ready;
 
+   /* wsi_wl_present_feedback for presents the compositor hasn't reported
+    * on yet
+    */
+   struct list_head                             present_feedbacks;
+
    struct wsi_wl_image                          images[0];
 };
 WSI_DEFINE_NONDISP_HANDLE_CASTS(wsi_wl_swapchain, VkSwapchainKHR)
@@ -814,10 +849,75 @@ static const struct wl_callback_listener frame_listener = {
    frame_handle_done,
 };
 
+struct wsi_wl_present_feedback {
+   struct wsi_wl_swapchain *                    chain;
+   struct wp_presentation_feedback *            feedback;
+   bool                                         timed;
+   VkPresentTimeGOOGLE                          present_time;
+   struct list_head                             link;
+};
+
+static void
+wsi_wl_present_feedback_destroy(struct wsi_wl_present_feedback *feedback)
+{
+   list_del(&feedback->link);
+   wp_presentation_feedback_destroy(feedback->feedback);
+   vk_free(&feedback->chain->base.alloc, feedback);
+}
+
+static void
+presentation_handle_sync_output(void *data,
+                                struct wp_presentation_feedback *feedback,
+                                struct wl_output *output)
+{
+}
+
+static void
+presentation_handle_presented(void *data,
+                              struct wp_presentation_feedback *wp_feedback,
+                              uint32_t tv_sec_hi, uint32_t tv_sec_lo,
+                              uint32_t tv_nsec, uint32_t refresh,
+                              uint32_t seq_hi, uint32_t seq_lo,
+                              uint32_t flags)
+{
+   struct wsi_wl_present_feedback *feedback = data;
+   struct wsi_wl_swapchain *chain = feedback->chain;
+
+   /* Vulkan timestamps are CLOCK_MONOTONIC, which is what compositors use in
+    * practice.  Don't report anything rather than mix clocks.
+    */
+   if (chain->display->presentation_clock_id == CLOCK_MONOTONIC) {
+      uint64_t tv_sec = ((uint64_t) tv_sec_hi << 32) | tv_sec_lo;
+      wsi_swapchain_record_present(&chain->base,
+                                   feedback->timed ?
+                                   &feedback->present_time : NULL,
+                                   tv_sec * 1000000000ull + tv_nsec,
+                                   refresh);
+   }
+
+   wsi_wl_present_feedback_destroy(feedback);
+}
+
+static void
+presentation_handle_discarded(void *data,
+                              struct wp_presentation_feedback *wp_feedback)
+{
+   struct wsi_wl_present_feedback *feedback = data;
+
+   wsi_wl_present_feedback_destroy(feedback);
+}
+
+static const struct wp_presentation_feedback_listener feedback_listener = {
+   presentation_handle_sync_output,
+   presentation_handle_presented,
+   presentation_handle_discarded,
+};
+
 static VkResult
 wsi_wl_swapchain_queue_present(struct wsi_swapchain *wsi_chain,
                                uint32_t image_index,
-                               const VkPresentRegionKHR *damage)
+                               const VkPresentRegionKHR *damage,
+                               const VkPresentTimeGOOGLE *present_time)
 {
    struct wsi_wl_swapchain *chain = (struct wsi_wl_swapchain *)wsi_chain;
 
@@ -830,6 +930,14 @@ wsi_wl_swapchain_queue_present(struct wsi_swapchain *wsi_chain,
       }
    }
 
+   /* There is no way to tell the compositor when to show the buffer, so
+    * hold on to it until the refresh cycle before the requested time.
+    */
+   if (present_time) {
+      wsi_swapchain_wait_for_present_time(&chain->base,
+                                          present_time->desiredPresentTime);
+   }
+
    assert(image_index < chain->base.image_count);
    wl_surface_attach(chain->surface, chain->images[image_index].buffer, 0, 0);
 
@@ -852,6 +960,24 @@ wsi_wl_swapchain_queue_present(struct wsi_swapchain *wsi_chain,
       chain->fifo_ready = false;
    }
 
+   if (chain->display->wp_presentation) {
+      struct wsi_wl_present_feedback *feedback =
+         vk_alloc(&chain->base.alloc, sizeof(*feedback), 8,
+                  VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+      if (feedback) {
+         feedback->chain = chain;
+         feedback->timed = present_time != NULL;
+         if (present_time)
+            feedback->present_time = *present_time;
+         feedback->feedback =
+            wp_presentation_feedback(chain->display->wp_presentation,
+                                     chain->surface);
+         wp_presentation_feedback_add_listener(feedback->feedback,
+                                               &feedback_listener, feedback);
+         list_addtail(&feedback->link, &chain->present_feedbacks);
+      }
+   }
+
    chain->images[image_index].busy = true;
    wl_surface_commit(chain->surface);
    wl_display_flush(chain->display->wl_display);
@@ -960,6 +1086,10 @@ wsi_wl_swapchain_destroy(struct wsi_swapchain *wsi_chain,
       }
    }
 
+   list_for_each_entry_safe(struct wsi_wl_present_feedback, feedback,
+                            &chain->present_feedbacks, link)
+      wsi_wl_present_feedback_destroy(feedback);
+
    if (chain->frame)
       wl_callback_destroy(chain->frame);
    if (chain->surface)
@@ -1016,6 +1146,7 @@ wsi_wl_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
    chain->surface = NULL;
    chain->drm_wrapper = NULL;
    chain->frame = NULL;
+   list_inithead(&chain->present_feedbacks);
 
    bool alpha = pCreateInfo->compositeAlpha ==
                       VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR;
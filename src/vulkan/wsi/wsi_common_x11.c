@@ -710,6 +710,15 @@ struct x11_image {
    bool                                      busy;
    struct xshmfence *                        shm_fence;
    uint32_t                                  sync_fence;
+
+   /* VK_GOOGLE_display_timing parameters as queued by the application, and
+    * as sent along with the last PresentPixmap of this image.
+    */
+   bool                                      timed;
+   VkPresentTimeGOOGLE                       present_time;
+   bool                                      sent_timed;
+   VkPresentTimeGOOGLE                       sent_time;
+   uint32_t                                  sent_serial;
 };
 
 struct x11_swapchain {
@@ -727,6 +736,7 @@ struct x11_swapchain {
    xcb_special_event_t *                        special_event;
    uint64_t                                     send_sbc;
    uint64_t                                     last_present_msc;
+   uint64_t                                     last_present_ust;
    uint32_t                                     stamp;
 
    bool                                         threaded;
@@ -736,6 +746,11 @@ struct x11_swapchain {
    struct wsi_queue                             acquire_queue;
    pthread_t                                    queue_manager;
 
+   /* Written to by x11_queue_present to wake the present thread up in
+    * modes other than FIFO, where it otherwise sleeps on the X connection.
+    */
+   int                                          wakeup_pipe[2];
+
    struct x11_image                             images[0];
 };
 WSI_DEFINE_NONDISP_HANDLE_CASTS(x11_swapchain, VkSwapchainKHR)
@@ -785,6 +800,39 @@ x11_get_wsi_image(struct wsi_swapchain *wsi_chain, uint32_t image_index)
    return &chain->images[image_index].base;
 }
 
+/**
+ * Hand the timing of a completed present over to VK_GOOGLE_display_timing.
+ * X11 doesn't tell us the refresh rate, so work it out from the distance
+ * between consecutive presents.
+ */
+static void
+x11_record_present(struct x11_swapchain *chain,
+                   xcb_present_complete_notify_event_t *complete)
+{
+   uint64_t refresh_duration = 0;
+   if (chain->last_present_ust && complete->ust > chain->last_present_ust &&
+       complete->msc > chain->last_present_msc) {
+      refresh_duration = (complete->ust - chain->last_present_ust) * 1000 /
+                         (complete->msc - chain->last_present_msc);
+   }
+   chain->last_present_ust = complete->ust;
+
+   const VkPresentTimeGOOGLE *present_time = NULL;
+   for (unsigned i = 0; i < chain->base.image_count; i++) {
+      struct x11_image *image = &chain->images[i];
+      if (image->sent_timed && image->sent_serial == complete->serial) {
+         present_time = &image->sent_time;
+         image->sent_timed = false;
+         break;
+      }
+   }
+
+   if (complete->ust) {
+      wsi_swapchain_record_present(&chain->base, present_time,
+                                   complete->ust * 1000, refresh_duration);
+   }
+}
+
 /**
  * Process an X11 Present event. Does not update chain->status.
  */
@@ -820,8 +868,10 @@ x11_handle_dri3_present_event(struct x11_swapchain *chain,
 
    case XCB_PRESENT_EVENT_COMPLETE_NOTIFY: {
       xcb_present_complete_notify_event_t *complete = (void *) event;
-      if (complete->kind == XCB_PRESENT_COMPLETE_KIND_PIXMAP)
+      if (complete->kind == XCB_PRESENT_COMPLETE_KIND_PIXMAP) {
+         x11_record_present(chain, complete);
          chain->last_present_msc = complete->msc;
+      }
 
       VkResult result = VK_SUCCESS;
 
@@ -953,6 +1003,28 @@ x11_acquire_next_image_from_queue(struct x11_swapchain *chain,
    return chain->status;
 }
 
+/**
+ * Returns the MSC to present the image at: min_msc, or later if the
+ * application asked for the image not to be shown before a given time.
+ */
+static uint64_t
+x11_present_target_msc(struct x11_swapchain *chain, uint32_t image_index,
+                       uint64_t min_msc)
+{
+   struct x11_image *image = &chain->images[image_index];
+
+   if (!image->timed)
+      return min_msc;
+
+   uint64_t cycles =
+      wsi_swapchain_refreshes_until(&chain->base,
+                                    image->present_time.desiredPresentTime);
+   if (cycles == 0)
+      return min_msc;
+
+   return MAX2(min_msc, chain->last_present_msc + cycles);
+}
+
 static VkResult
 x11_present_to_x11(struct x11_swapchain *chain, uint32_t image_index,
                    uint32_t target_msc)
@@ -990,6 +1062,9 @@ x11_present_to_x11(struct x11_swapchain *chain, uint32_t image_index,
    xshmfence_reset(image->shm_fence);
 
    ++chain->send_sbc;
+   image->sent_timed = image->timed;
+   image->sent_time = image->present_time;
+   image->sent_serial = (uint32_t) chain->send_sbc;
    xcb_void_cookie_t cookie =
       xcb_present_pixmap(chain->conn,
                          chain->window,
@@ -1033,22 +1108,42 @@ x11_acquire_next_image(struct wsi_swapchain *anv_chain,
    }
 }
 
+static void
+x11_wake_present_thread(struct x11_swapchain *chain)
+{
+   if (chain->base.present_mode == VK_PRESENT_MODE_FIFO_KHR)
+      return;
+
+   /* The pipe is non-blocking: if it is full, the thread has plenty of
+    * wakeups pending already.
+    */
+   MAYBE_UNUSED ssize_t ret = write(chain->wakeup_pipe[1], "", 1);
+}
+
 static VkResult
 x11_queue_present(struct wsi_swapchain *anv_chain,
                   uint32_t image_index,
-                  const VkPresentRegionKHR *damage)
+                  const VkPresentRegionKHR *damage,
+                  const VkPresentTimeGOOGLE *present_time)
 {
    struct x11_swapchain *chain = (struct x11_swapchain *)anv_chain;
+   struct x11_image *image = &chain->images[image_index];
 
    /* If the swapchain is in an error state, don't go any further. */
    if (chain->status < 0)
       return chain->status;
 
+   image->timed = present_time != NULL;
+   if (present_time)
+      image->present_time = *present_time;
+
    if (chain->threaded) {
       wsi_queue_push(&chain->present_queue, image_index);
+      x11_wake_present_thread(chain);
       return chain->status;
    } else {
-      return x11_present_to_x11(chain, image_index, 0);
+      return x11_present_to_x11(chain, image_index,
+                                x11_present_target_msc(chain, image_index, 0));
    }
 }
 
@@ -1079,7 +1174,9 @@ x11_manage_fifo_queues(void *state)
          return NULL;
       }
 
-      uint64_t target_msc = chain->last_present_msc + 1;
+      uint64_t target_msc =
+         x11_present_target_msc(chain, image_index,
+                                chain->last_present_msc + 1);
       result = x11_present_to_x11(chain, image_index, target_msc);
       if (result < 0)
          goto fail;
@@ -1106,6 +1203,78 @@ fail:
    return NULL;
 }
 
+/* Present thread for all modes but FIFO.  Presents are sent as soon as the
+ * application queues them, and Present events are handled in the background
+ * so that neither vkQueuePresentKHR nor vkAcquireNextImageKHR ever has to
+ * talk to the X server.
+ */
+static void *
+x11_manage_async_queues(void *state)
+{
+   struct x11_swapchain *chain = state;
+   VkResult result = VK_SUCCESS;
+
+   assert(chain->base.present_mode != VK_PRESENT_MODE_FIFO_KHR);
+
+   while (chain->status >= 0) {
+      /* Handle whatever the server has sent us so far.  This is what hands
+       * idle images back to the acquire queue.
+       */
+      xcb_generic_event_t *event;
+      while ((event = xcb_poll_for_special_event(chain->conn,
+                                                 chain->special_event))) {
+         result = x11_handle_dri3_present_event(chain, (void *)event);
+         free(event);
+         if (result < 0)
+            goto fail;
+         x11_swapchain_result(chain, result);
+      }
+
+      uint32_t image_index = 0;
+      result = wsi_queue_pull(&chain->present_queue, &image_index, 0);
+      if (result == VK_TIMEOUT) {
+         /* Nothing to present.  Sleep until either the application queues
+          * a present or the server sends us something.  Another thread
+          * reading from the same connection may queue our events in xcb
+          * without the fd waking us up, so don't sleep forever.
+          */
+         struct pollfd pfds[2] = {
+            { .fd = xcb_get_file_descriptor(chain->conn), .events = POLLIN },
+            { .fd = chain->wakeup_pipe[0], .events = POLLIN },
+         };
+         if (poll(pfds, 2, 100) < 0 && errno != EINTR) {
+            result = VK_ERROR_OUT_OF_DATE_KHR;
+            goto fail;
+         }
+
+         if (pfds[1].revents & POLLIN) {
+            char buf[16];
+            while (read(chain->wakeup_pipe[0], buf, sizeof(buf)) > 0);
+         }
+         continue;
+      } else if (result < 0) {
+         goto fail;
+      } else if (chain->status < 0) {
+         /* The status can change underneath us if the swapchain is destroyed
+          * from another thread.
+          */
+         return NULL;
+      }
+
+      result = x11_present_to_x11(chain, image_index,
+                                  x11_present_target_msc(chain,
+                                                         image_index, 0));
+      if (result < 0)
+         goto fail;
+   }
+
+fail:
+   x11_swapchain_result(chain, result);
+   wsi_queue_push(&chain->acquire_queue, UINT32_MAX);
+
+   return NULL;
+}
+
 static VkResult
 x11_image_init(VkDevice device_h, struct x11_swapchain *chain,
                const VkSwapchainCreateInfoKHR *pCreateInfo,
@@ -1194,6 +1363,8 @@ x11_image_init(VkDevice device_h, struct x11_swapchain *chain,
                           fence_fd);
 
    image->busy = false;
+   image->timed = false;
+   image->sent_timed = false;
    xshmfence_trigger(image->shm_fence);
 
    return VK_SUCCESS;
@@ -1315,9 +1486,14 @@ x11_swapchain_destroy(struct wsi_swapchain *anv_chain,
       chain->status = VK_ERROR_OUT_OF_DATE_KHR;
       /* Push a UINT32_MAX to wake up the manager */
       wsi_queue_push(&chain->present_queue, UINT32_MAX);
+      x11_wake_present_thread(chain);
       pthread_join(chain->queue_manager, NULL);
       wsi_queue_destroy(&chain->acquire_queue);
       wsi_queue_destroy(&chain->present_queue);
+      if (chain->base.present_mode != VK_PRESENT_MODE_FIFO_KHR) {
+         close(chain->wakeup_pipe[0]);
+         close(chain->wakeup_pipe[1]);
+      }
    }
 
    for (uint32_t i = 0; i < chain->base.image_count; i++)
@@ -1417,6 +1593,7 @@ x11_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
    chain->extent = pCreateInfo->imageExtent;
    chain->send_sbc = 0;
    chain->last_present_msc = 0;
+   chain->last_present_ust = 0;
    chain->threaded = false;
    chain->status = VK_SUCCESS;
    chain->has_dri3_modifiers = wsi_conn->has_dri3_modifiers;
@@ -1472,6 +1649,17 @@ x11_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
                                  modifiers, num_modifiers, &num_tranches,
                                  pAllocator);
 
+   /* Even when we're not on the display GPU, the X server may be able to
+    * import our images directly if it advertises a tiled modifier we can
+    * render to, in which case there's no need for a PRIME blit.
+    */
+   if (chain->base.use_prime_blit &&
+       wsi_device_supports_tiled_modifier(&chain->base,
+                                          pCreateInfo->imageFormat,
+                                          num_tranches, num_modifiers,
+                                          (const uint64_t *const *)modifiers))
+      chain->base.use_prime_blit = false;
+
    uint32_t image = 0;
    for (; image < chain->base.image_count; image++) {
       result = x11_image_init(device, chain, pCreateInfo, pAllocator,
@@ -1482,7 +1670,13 @@ x11_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
          goto fail_init_images;
    }
 
-   if (chain->base.present_mode == VK_PRESENT_MODE_FIFO_KHR) {
+   /* Every present mode goes through a present thread, so that the
+    * application never waits on the X server.  FIFO needs one to wait for
+    * vblanks anyway, other modes need a way to wake it up.  If we can't get
+    * that, fall back to presenting and polling from the calling thread.
+    */
+   bool fifo = chain->base.present_mode == VK_PRESENT_MODE_FIFO_KHR;
+   if (fifo || pipe2(chain->wakeup_pipe, O_CLOEXEC | O_NONBLOCK) == 0) {
       chain->threaded = true;
 
       /* Initialize our queues.  We make them base.image_count + 1 because we will
@@ -1492,24 +1686,26 @@ x11_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
       int ret;
       ret = wsi_queue_init(&chain->acquire_queue, chain->base.image_count + 1);
       if (ret) {
-         goto fail_init_images;
+         goto fail_init_pipe;
       }
 
       ret = wsi_queue_init(&chain->present_queue, chain->base.image_count + 1);
       if (ret) {
          wsi_queue_destroy(&chain->acquire_queue);
-         goto fail_init_images;
+         goto fail_init_pipe;
       }
 
       for (unsigned i = 0; i < chain->base.image_count; i++)
          wsi_queue_push(&chain->acquire_queue, i);
 
       ret = pthread_create(&chain->queue_manager, NULL,
-                           x11_manage_fifo_queues, chain);
+                           fifo ? x11_manage_fifo_queues :
+                                  x11_manage_async_queues,
+                           chain);
       if (ret) {
          wsi_queue_destroy(&chain->present_queue);
          wsi_queue_destroy(&chain->acquire_queue);
-         goto fail_init_images;
+         goto fail_init_pipe;
       }
    }
 
@@ -1526,6 +1722,12 @@ x11_surface_create_swapchain(VkIcdSurfaceBase *icd_surface,
 
    return VK_SUCCESS;
 
+fail_init_pipe:
+   if (chain->base.present_mode != VK_PRESENT_MODE_FIFO_KHR) {
+      close(chain->wakeup_pipe[0]);
+      close(chain->wakeup_pipe[1]);
+   }
+
 fail_init_images:
    for (uint32_t j = 0; j < image; j++)
       x11_image_finish(chain, pAllocator, &chain->images[j]);